@@ -110,18 +110,21 @@ class DesktopBackgroundController::WallpaperLoader
       DesktopBackgroundController::WallpaperLoader>;
 
   // Loads a JPEG image from |path|, a trusted file -- note that the image
-  // is not loaded in a sandboxed process. Returns an empty pointer on
-  // error.
+  // is not loaded in a sandboxed process. Unless |min_size| is empty, the
+  // image may be scaled down to no less than it while being decoded. Returns
+  // an empty pointer on error.
   static scoped_ptr<SkBitmap> LoadSkBitmapFromJPEGFile(
-      const base::FilePath& path) {
+      const base::FilePath& path,
+      const gfx::Size& min_size) {
     std::string data;
     if (!file_util::ReadFileToString(path, &data)) {
       LOG(ERROR) << "Unable to read data from " << path.value();
       return scoped_ptr<SkBitmap>();
     }
 
-    scoped_ptr<SkBitmap> bitmap(gfx::JPEGCodec::Decode(
-        reinterpret_cast<const unsigned char*>(data.data()), data.size()));
+    scoped_ptr<SkBitmap> bitmap(gfx::JPEGCodec::DecodeToSize(
+        reinterpret_cast<const unsigned char*>(data.data()), data.size(),
+        min_size));
     if (!bitmap)
       LOG(ERROR) << "Unable to decode JPEG data from " << path.value();
     return bitmap.Pass();
@@ -131,8 +134,17 @@ class DesktopBackgroundController::WallpaperLoader
     if (cancel_flag_.IsSet())
       return;
 
-    if (!file_path_.empty())
-      file_bitmap_ = LoadSkBitmapFromJPEGFile(file_path_);
+    if (!file_path_.empty()) {
+      // Stretched and cropped wallpapers are scaled to the displays anyway,
+      // there's no need to decode them any larger. A display added later
+      // that is larger reloads the wallpaper.
+      gfx::Size min_size;
+      if (file_layout_ == WALLPAPER_LAYOUT_STRETCH ||
+          file_layout_ == WALLPAPER_LAYOUT_CENTER_CROPPED) {
+        min_size = GetRootWindowsSize();
+      }
+      file_bitmap_ = LoadSkBitmapFromJPEGFile(file_path_, min_size);
+    }
 
     if (cancel_flag_.IsSet())
       return;
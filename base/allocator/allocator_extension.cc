@@ -5,6 +5,7 @@
 #include "base/allocator/allocator_extension.h"
 
 #include "base/logging.h"
+#include "base/memory/object_pool.h"
 
 namespace base {
 namespace allocator {
@@ -12,8 +13,15 @@ namespace allocator {
 bool GetAllocatorWasteSize(size_t* size) {
   thunks::GetAllocatorWasteSizeFunction get_allocator_waste_size_function =
       thunks::GetGetAllocatorWasteSizeFunction();
-  return get_allocator_waste_size_function != NULL &&
-         get_allocator_waste_size_function(size);
+  if (get_allocator_waste_size_function == NULL ||
+      !get_allocator_waste_size_function(size)) {
+    return false;
+  }
+  size_t thread_cache_size;
+  size_t central_cache_size;
+  ObjectPool::GetCachedSize(&thread_cache_size, &central_cache_size);
+  *size += thread_cache_size + central_cache_size;
+  return true;
 }
 
 void GetStats(char* buffer, int buffer_length) {
@@ -26,12 +34,18 @@ void GetStats(char* buffer, int buffer_length) {
 }
 
 void ReleaseFreeMemory() {
+  ObjectPool::ReleaseFreeMemory();
   thunks::ReleaseFreeMemoryFunction release_free_memory_function =
       thunks::GetReleaseFreeMemoryFunction();
   if (release_free_memory_function)
     release_free_memory_function();
 }
 
+void GetObjectPoolCachedSize(size_t* thread_cache_size,
+                             size_t* central_cache_size) {
+  ObjectPool::GetCachedSize(thread_cache_size, central_cache_size);
+}
+
 void SetGetAllocatorWasteSizeFunction(
     thunks::GetAllocatorWasteSizeFunction get_allocator_waste_size_function) {
   DCHECK_EQ(thunks::GetGetAllocatorWasteSizeFunction(),
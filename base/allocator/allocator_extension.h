@@ -32,9 +32,18 @@ BASE_EXPORT bool GetAllocatorWasteSize(size_t* size);
 BASE_EXPORT void GetStats(char* buffer, int buffer_length);
 
 // Request that the allocator release any free memory it knows about to the
-// system.
+// system. This includes the blocks cached by base::ObjectPool on the calling
+// thread and in its central lists.
 BASE_EXPORT void ReleaseFreeMemory();
 
+// Report the number of bytes that base::ObjectPool keeps in freed blocks for
+// reuse, in the caches of all threads and in its central lists. These are
+// also included in GetAllocatorWasteSize().
+//
+// |thread_cache_size| and |central_cache_size| must be not NULL.
+BASE_EXPORT void GetObjectPoolCachedSize(size_t* thread_cache_size,
+                                         size_t* central_cache_size);
+
 
 // These settings allow specifying a callback used to implement the allocator
 // extension functions.  These are optional, but if set they must only be set
@@ -464,6 +464,7 @@
         'callback_unittest.nc',
         'cancelable_callback_unittest.cc',
         'command_line_unittest.cc',
+        'compact_value_unittest.cc',
         'containers/hash_tables_unittest.cc',
         'containers/linked_list_unittest.cc',
         'containers/mru_cache_unittest.cc',
@@ -503,6 +504,7 @@
         'ios/device_util_unittest.mm',
         'json/json_parser_unittest.cc',
         'json/json_reader_unittest.cc',
+        'json/json_stream_reader_unittest.cc',
         'json/json_value_converter_unittest.cc',
         'json/json_value_serializer_unittest.cc',
         'json/json_writer_unittest.cc',
@@ -520,6 +522,7 @@
         'memory/aligned_memory_unittest.cc',
         'memory/discardable_memory_unittest.cc',
         'memory/linked_ptr_unittest.cc',
+        'memory/object_pool_unittest.cc',
         'memory/ref_counted_memory_unittest.cc',
         'memory/ref_counted_unittest.cc',
         'memory/scoped_ptr_unittest.cc',
@@ -945,6 +948,30 @@
         }],
       ],  # target_conditions
     },
+    {
+      'target_name': 'base_perftests',
+      'type': '<(gtest_target_type)',
+      'dependencies': [
+        'base',
+        'test_support_base',
+        'test_support_perf',
+        '../testing/gtest.gyp:gtest',
+      ],
+      'sources': [
+        'debug/trace_event_perftest.cc',
+        'json/json_stream_reader_perftest.cc',
+        'message_loop/message_loop_perftest.cc',
+        'strings/utf_string_conversions_perftest.cc',
+        'threading/sequenced_worker_pool_perftest.cc',
+      ],
+      'conditions': [
+        ['OS == "android" and gtest_target_type == "shared_library"', {
+          'dependencies': [
+            '../testing/android/native_test.gyp:native_test_native_code',
+          ],
+        }],
+      ],
+    },
     {
       'target_name': 'test_support_perf',
       'type': 'static_library',
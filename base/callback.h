@@ -389,6 +389,12 @@ class Callback<R(void)> : public internal::CallbackBase {
     return CallbackBase::Equals(other);
   }
 
+  // Exchanges this callback with |other| without copying it. Can be used to
+  // move a callback into a container.
+  void Swap(Callback* other) {
+    CallbackBase::Swap(other);
+  }
+
   R Run() const {
     PolymorphicInvoke f =
         reinterpret_cast<PolymorphicInvoke>(polymorphic_invoke_);
@@ -429,6 +435,12 @@ class Callback<R(A1)> : public internal::CallbackBase {
     return CallbackBase::Equals(other);
   }
 
+  // Exchanges this callback with |other| without copying it. Can be used to
+  // move a callback into a container.
+  void Swap(Callback* other) {
+    CallbackBase::Swap(other);
+  }
+
   R Run(typename internal::CallbackParamTraits<A1>::ForwardType a1) const {
     PolymorphicInvoke f =
         reinterpret_cast<PolymorphicInvoke>(polymorphic_invoke_);
@@ -470,6 +482,12 @@ class Callback<R(A1, A2)> : public internal::CallbackBase {
     return CallbackBase::Equals(other);
   }
 
+  // Exchanges this callback with |other| without copying it. Can be used to
+  // move a callback into a container.
+  void Swap(Callback* other) {
+    CallbackBase::Swap(other);
+  }
+
   R Run(typename internal::CallbackParamTraits<A1>::ForwardType a1,
         typename internal::CallbackParamTraits<A2>::ForwardType a2) const {
     PolymorphicInvoke f =
@@ -514,6 +532,12 @@ class Callback<R(A1, A2, A3)> : public internal::CallbackBase {
     return CallbackBase::Equals(other);
   }
 
+  // Exchanges this callback with |other| without copying it. Can be used to
+  // move a callback into a container.
+  void Swap(Callback* other) {
+    CallbackBase::Swap(other);
+  }
+
   R Run(typename internal::CallbackParamTraits<A1>::ForwardType a1,
         typename internal::CallbackParamTraits<A2>::ForwardType a2,
         typename internal::CallbackParamTraits<A3>::ForwardType a3) const {
@@ -561,6 +585,12 @@ class Callback<R(A1, A2, A3, A4)> : public internal::CallbackBase {
     return CallbackBase::Equals(other);
   }
 
+  // Exchanges this callback with |other| without copying it. Can be used to
+  // move a callback into a container.
+  void Swap(Callback* other) {
+    CallbackBase::Swap(other);
+  }
+
   R Run(typename internal::CallbackParamTraits<A1>::ForwardType a1,
         typename internal::CallbackParamTraits<A2>::ForwardType a2,
         typename internal::CallbackParamTraits<A3>::ForwardType a3,
@@ -612,6 +642,12 @@ class Callback<R(A1, A2, A3, A4, A5)> : public internal::CallbackBase {
     return CallbackBase::Equals(other);
   }
 
+  // Exchanges this callback with |other| without copying it. Can be used to
+  // move a callback into a container.
+  void Swap(Callback* other) {
+    CallbackBase::Swap(other);
+  }
+
   R Run(typename internal::CallbackParamTraits<A1>::ForwardType a1,
         typename internal::CallbackParamTraits<A2>::ForwardType a2,
         typename internal::CallbackParamTraits<A3>::ForwardType a3,
@@ -666,6 +702,12 @@ class Callback<R(A1, A2, A3, A4, A5, A6)> : public internal::CallbackBase {
     return CallbackBase::Equals(other);
   }
 
+  // Exchanges this callback with |other| without copying it. Can be used to
+  // move a callback into a container.
+  void Swap(Callback* other) {
+    CallbackBase::Swap(other);
+  }
+
   R Run(typename internal::CallbackParamTraits<A1>::ForwardType a1,
         typename internal::CallbackParamTraits<A2>::ForwardType a2,
         typename internal::CallbackParamTraits<A3>::ForwardType a3,
@@ -723,6 +765,12 @@ class Callback<R(A1, A2, A3, A4, A5, A6, A7)> : public internal::CallbackBase {
     return CallbackBase::Equals(other);
   }
 
+  // Exchanges this callback with |other| without copying it. Can be used to
+  // move a callback into a container.
+  void Swap(Callback* other) {
+    CallbackBase::Swap(other);
+  }
+
   R Run(typename internal::CallbackParamTraits<A1>::ForwardType a1,
         typename internal::CallbackParamTraits<A2>::ForwardType a2,
         typename internal::CallbackParamTraits<A3>::ForwardType a3,
@@ -4,6 +4,8 @@
 
 #include "base/callback_internal.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
 
 namespace base {
@@ -25,6 +27,11 @@ bool CallbackBase::Equals(const CallbackBase& other) const {
          polymorphic_invoke_ == other.polymorphic_invoke_;
 }
 
+void CallbackBase::Swap(CallbackBase* other) {
+  bind_state_.swap(other->bind_state_);
+  std::swap(polymorphic_invoke_, other->polymorphic_invoke_);
+}
+
 CallbackBase::CallbackBase(BindStateBase* bind_state)
     : bind_state_(bind_state),
       polymorphic_invoke_(NULL) {
@@ -11,6 +11,7 @@
 #include <stddef.h>
 
 #include "base/base_export.h"
+#include "base/memory/object_pool.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 
@@ -26,7 +27,12 @@ namespace internal {
 // DoInvoke function to perform the function execution.  This allows
 // us to shield the Callback class from the types of the bound argument via
 // "type erasure."
-class BindStateBase : public RefCountedThreadSafe<BindStateBase> {
+//
+// A BindState is allocated by every Bind(), and is usually freed on another
+// thread once a posted task has run, so BindStates come from the ObjectPool
+// rather than the general allocator.
+class BindStateBase : public RefCountedThreadSafe<BindStateBase>,
+                      public PoolAllocated {
  protected:
   friend class RefCountedThreadSafe<BindStateBase>;
   virtual ~BindStateBase() {}
@@ -52,6 +58,10 @@ class BASE_EXPORT CallbackBase {
   // Returns true if this callback equals |other|. |other| may be null.
   bool Equals(const CallbackBase& other) const;
 
+  // Exchanges the state of this callback with |other|. Unlike a copy, this
+  // does not touch the reference count of the BindState.
+  void Swap(CallbackBase* other);
+
   // Allow initializing of |bind_state_| via the constructor to avoid default
   // initialization of the scoped_refptr.  We do not also initialize
   // |polymorphic_invoke_| here because doing a normal assignment in the
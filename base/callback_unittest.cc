@@ -124,6 +124,22 @@ TEST_F(CallbackTest, Reset) {
   EXPECT_TRUE(callback_a_.Equals(null_callback_));
 }
 
+TEST_F(CallbackTest, Swap) {
+  Callback<void(void)> callback_c = callback_b_;
+  ASSERT_TRUE(callback_c.Equals(callback_b_));
+
+  // Swapping with a null callback moves the state over.
+  callback_a_.Swap(&null_callback_);
+  EXPECT_TRUE(callback_a_.is_null());
+  EXPECT_FALSE(null_callback_.is_null());
+
+  // Swapping two callbacks exchanges them.
+  null_callback_.Swap(&callback_c);
+  EXPECT_TRUE(null_callback_.Equals(callback_b_));
+  EXPECT_FALSE(callback_c.is_null());
+  EXPECT_FALSE(callback_c.Equals(callback_b_));
+}
+
 struct TestForReentrancy {
   TestForReentrancy()
       : cb_already_run(false),
@@ -0,0 +1,468 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/compact_value.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/json/json_stream_reader.h"
+#include "base/logging.h"
+#include "base/memory/scoped_vector.h"
+
+namespace base {
+
+namespace {
+
+// The first block of a document is small so that tiny documents stay cheap;
+// the following ones grow with the document up to |kMaxBlockSize|.
+const size_t kMinBlockSize = 1024;
+const size_t kMaxBlockSize = 64 * 1024;
+
+// Every allocation is rounded up to this, which suits all node types.
+const size_t kAlignment = 8;
+
+}  // namespace
+
+struct CompactValue::Member {
+  const char* key;
+  uint32 key_size;
+  CompactValue value;
+
+  StringPiece GetKey() const { return StringPiece(key, key_size); }
+
+  static bool KeyLess(const Member& a, const Member& b) {
+    return a.GetKey() < b.GetKey();
+  }
+  static bool KeyIsLess(const Member& member, const StringPiece& key) {
+    return member.GetKey() < key;
+  }
+};
+
+// CompactValue ////////////////////////////////////////////////////////////////
+
+bool CompactValue::GetAsBoolean(bool* out_value) const {
+  if (type_ != Value::TYPE_BOOLEAN)
+    return false;
+  if (out_value)
+    *out_value = boolean_;
+  return true;
+}
+
+bool CompactValue::GetAsInteger(int* out_value) const {
+  if (type_ != Value::TYPE_INTEGER)
+    return false;
+  if (out_value)
+    *out_value = integer_;
+  return true;
+}
+
+bool CompactValue::GetAsDouble(double* out_value) const {
+  if (type_ == Value::TYPE_DOUBLE) {
+    if (out_value)
+      *out_value = double_;
+    return true;
+  }
+  if (type_ == Value::TYPE_INTEGER) {
+    if (out_value)
+      *out_value = integer_;
+    return true;
+  }
+  return false;
+}
+
+bool CompactValue::GetAsString(StringPiece* out_value) const {
+  if (type_ != Value::TYPE_STRING)
+    return false;
+  if (out_value)
+    out_value->set(data_, size_);
+  return true;
+}
+
+bool CompactValue::GetAsString(std::string* out_value) const {
+  if (type_ != Value::TYPE_STRING)
+    return false;
+  if (out_value)
+    out_value->assign(data_, size_);
+  return true;
+}
+
+bool CompactValue::GetAsBinary(StringPiece* out_value) const {
+  if (type_ != Value::TYPE_BINARY)
+    return false;
+  if (out_value)
+    out_value->set(data_, size_);
+  return true;
+}
+
+size_t CompactValue::GetSize() const {
+  if (type_ != Value::TYPE_LIST && type_ != Value::TYPE_DICTIONARY)
+    return 0;
+  return size_;
+}
+
+const CompactValue* CompactValue::GetListItem(size_t index) const {
+  if (type_ != Value::TYPE_LIST || index >= size_)
+    return NULL;
+  return &items_[index];
+}
+
+StringPiece CompactValue::GetMemberKey(size_t index) const {
+  DCHECK(IsType(Value::TYPE_DICTIONARY));
+  DCHECK_LT(index, size_);
+  return members_[index].GetKey();
+}
+
+const CompactValue& CompactValue::GetMemberValue(size_t index) const {
+  DCHECK(IsType(Value::TYPE_DICTIONARY));
+  DCHECK_LT(index, size_);
+  return members_[index].value;
+}
+
+const CompactValue* CompactValue::FindKey(const StringPiece& key) const {
+  if (type_ != Value::TYPE_DICTIONARY)
+    return NULL;
+  const Member* end = members_ + size_;
+  const Member* member =
+      std::lower_bound(members_, end, key, Member::KeyIsLess);
+  if (member == end || member->GetKey() != key)
+    return NULL;
+  return &member->value;
+}
+
+Value* CompactValue::ToValue() const {
+  switch (type_) {
+    case Value::TYPE_NULL:
+      return Value::CreateNullValue();
+    case Value::TYPE_BOOLEAN:
+      return new FundamentalValue(boolean_);
+    case Value::TYPE_INTEGER:
+      return new FundamentalValue(integer_);
+    case Value::TYPE_DOUBLE:
+      return new FundamentalValue(double_);
+    case Value::TYPE_STRING:
+      return new StringValue(std::string(data_, size_));
+    case Value::TYPE_BINARY:
+      return BinaryValue::CreateWithCopiedBuffer(data_, size_);
+    case Value::TYPE_DICTIONARY: {
+      DictionaryValue* dictionary = new DictionaryValue;
+      for (uint32 i = 0; i < size_; ++i) {
+        dictionary->SetWithoutPathExpansion(members_[i].GetKey().as_string(),
+                                            members_[i].value.ToValue());
+      }
+      return dictionary;
+    }
+    case Value::TYPE_LIST: {
+      ListValue* list = new ListValue;
+      for (uint32 i = 0; i < size_; ++i)
+        list->Append(items_[i].ToValue());
+      return list;
+    }
+  }
+  NOTREACHED();
+  return NULL;
+}
+
+// CompactValueDocument::JSONBuilder ///////////////////////////////////////////
+
+// Builds a document from the events of a JSONStreamReader. The children of the
+// open containers are collected in per-depth vectors, which are reused across
+// siblings, and copied into the document once the container is complete.
+class CompactValueDocument::JSONBuilder : public JSONStreamReader::Delegate {
+ public:
+  explicit JSONBuilder(CompactValueDocument* document)
+      : document_(document),
+        depth_(0) {
+  }
+  virtual ~JSONBuilder() {}
+
+  // JSONStreamReader::Delegate:
+  virtual bool OnDictionaryBegin() OVERRIDE {
+    BeginContainer(Value::TYPE_DICTIONARY);
+    return true;
+  }
+
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+    CompactValue::Member member;
+    member.key = document_->CopyData(key);
+    member.key_size = static_cast<uint32>(key.size());
+    frames_[depth_ - 1]->members.push_back(member);
+    return true;
+  }
+
+  virtual bool OnDictionaryEnd() OVERRIDE {
+    Frame* frame = frames_[--depth_];
+    std::vector<CompactValue::Member>& members = frame->members;
+
+    // Sort by key, keeping the last of the members that share a key as
+    // DictionaryValue does.
+    std::stable_sort(members.begin(), members.end(),
+                     CompactValue::Member::KeyLess);
+    size_t size = 0;
+    for (size_t i = 0; i < members.size(); ++i) {
+      if (i + 1 < members.size() &&
+          members[i].GetKey() == members[i + 1].GetKey()) {
+        continue;
+      }
+      members[size++] = members[i];
+    }
+
+    CompactValue value;
+    value.type_ = Value::TYPE_DICTIONARY;
+    value.size_ = static_cast<uint32>(size);
+    value.members_ = CopyArray(members, size);
+    AddValue(value);
+    return true;
+  }
+
+  virtual bool OnListBegin() OVERRIDE {
+    BeginContainer(Value::TYPE_LIST);
+    return true;
+  }
+
+  virtual bool OnListEnd() OVERRIDE {
+    Frame* frame = frames_[--depth_];
+    CompactValue value;
+    value.type_ = Value::TYPE_LIST;
+    value.size_ = static_cast<uint32>(frame->items.size());
+    value.items_ = CopyArray(frame->items, frame->items.size());
+    AddValue(value);
+    return true;
+  }
+
+  virtual bool OnString(const StringPiece& string) OVERRIDE {
+    CompactValue value;
+    value.type_ = Value::TYPE_STRING;
+    value.size_ = static_cast<uint32>(string.size());
+    value.data_ = document_->CopyData(string);
+    AddValue(value);
+    return true;
+  }
+
+  virtual bool OnInteger(int integer) OVERRIDE {
+    CompactValue value;
+    value.type_ = Value::TYPE_INTEGER;
+    value.size_ = 0;
+    value.integer_ = integer;
+    AddValue(value);
+    return true;
+  }
+
+  virtual bool OnDouble(double real) OVERRIDE {
+    CompactValue value;
+    value.type_ = Value::TYPE_DOUBLE;
+    value.size_ = 0;
+    value.double_ = real;
+    AddValue(value);
+    return true;
+  }
+
+  virtual bool OnBoolean(bool boolean) OVERRIDE {
+    CompactValue value;
+    value.type_ = Value::TYPE_BOOLEAN;
+    value.size_ = 0;
+    value.boolean_ = boolean;
+    AddValue(value);
+    return true;
+  }
+
+  virtual bool OnNull() OVERRIDE {
+    CompactValue value;
+    value.type_ = Value::TYPE_NULL;
+    value.size_ = 0;
+    value.data_ = NULL;
+    AddValue(value);
+    return true;
+  }
+
+ private:
+  // The children collected so far for an open container.
+  struct Frame {
+    Value::Type type;
+    std::vector<CompactValue> items;
+    std::vector<CompactValue::Member> members;
+  };
+
+  void BeginContainer(Value::Type type) {
+    if (depth_ == frames_.size())
+      frames_.push_back(new Frame);
+    Frame* frame = frames_[depth_++];
+    frame->type = type;
+    frame->items.clear();
+    frame->members.clear();
+  }
+
+  // Adds |value| to the innermost open container, or makes it the root.
+  void AddValue(const CompactValue& value) {
+    if (depth_ == 0) {
+      document_->root_ = value;
+      return;
+    }
+    Frame* frame = frames_[depth_ - 1];
+    if (frame->type == Value::TYPE_DICTIONARY) {
+      DCHECK(!frame->members.empty());
+      frame->members.back().value = value;
+    } else {
+      frame->items.push_back(value);
+    }
+  }
+
+  // Copies the first |size| elements of |from| into the document.
+  template <typename T>
+  const T* CopyArray(const std::vector<T>& from, size_t size) {
+    if (!size)
+      return NULL;
+    T* to = static_cast<T*>(document_->Allocate(size * sizeof(T)));
+    std::copy(from.begin(), from.begin() + size, to);
+    return to;
+  }
+
+  CompactValueDocument* document_;
+
+  // |frames_[0]| to |frames_[depth_ - 1]| hold the open containers.
+  ScopedVector<Frame> frames_;
+  size_t depth_;
+
+  DISALLOW_COPY_AND_ASSIGN(JSONBuilder);
+};
+
+// CompactValueDocument ////////////////////////////////////////////////////////
+
+CompactValueDocument::CompactValueDocument()
+    : next_(NULL),
+      remaining_(0),
+      allocated_bytes_(0) {
+  root_.type_ = Value::TYPE_NULL;
+  root_.size_ = 0;
+  root_.data_ = NULL;
+}
+
+CompactValueDocument::CompactValueDocument(const Value& value)
+    : next_(NULL),
+      remaining_(0),
+      allocated_bytes_(0) {
+  CopyValue(value, &root_);
+}
+
+CompactValueDocument::~CompactValueDocument() {
+  for (size_t i = 0; i < blocks_.size(); ++i)
+    delete[] blocks_[i];
+}
+
+// static
+CompactValueDocument* CompactValueDocument::ReadJSON(
+    const StringPiece& json,
+    int options,
+    int* error_code_out,
+    std::string* error_msg_out) {
+  scoped_ptr<CompactValueDocument> document(new CompactValueDocument);
+  JSONBuilder builder(document.get());
+  JSONStreamReader reader(options);
+  if (reader.Read(json, &builder))
+    return document.release();
+
+  if (error_code_out)
+    *error_code_out = reader.error_code();
+  if (error_msg_out)
+    *error_msg_out = reader.GetErrorMessage();
+  return NULL;
+}
+
+void* CompactValueDocument::Allocate(size_t size) {
+  size = (size + kAlignment - 1) & ~(kAlignment - 1);
+  if (size > remaining_) {
+    // Requests larger than a block get a block of their own. The rest of
+    // the current block is abandoned.
+    size_t block_size = std::min(kMaxBlockSize,
+                                 std::max(kMinBlockSize, allocated_bytes_));
+    block_size = std::max(block_size, size);
+    next_ = new char[block_size];
+    blocks_.push_back(next_);
+    remaining_ = block_size;
+    allocated_bytes_ += block_size;
+  }
+  void* result = next_;
+  next_ += size;
+  remaining_ -= size;
+  return result;
+}
+
+const char* CompactValueDocument::CopyData(const StringPiece& data) {
+  if (data.empty())
+    return NULL;
+  char* copy = static_cast<char*>(Allocate(data.size()));
+  memcpy(copy, data.data(), data.size());
+  return copy;
+}
+
+void CompactValueDocument::CopyValue(const Value& from, CompactValue* to) {
+  to->type_ = from.GetType();
+  to->size_ = 0;
+  switch (from.GetType()) {
+    case Value::TYPE_NULL:
+      to->data_ = NULL;
+      break;
+    case Value::TYPE_BOOLEAN:
+      from.GetAsBoolean(&to->boolean_);
+      break;
+    case Value::TYPE_INTEGER:
+      from.GetAsInteger(&to->integer_);
+      break;
+    case Value::TYPE_DOUBLE:
+      from.GetAsDouble(&to->double_);
+      break;
+    case Value::TYPE_STRING: {
+      std::string string;
+      from.GetAsString(&string);
+      to->size_ = static_cast<uint32>(string.size());
+      to->data_ = CopyData(string);
+      break;
+    }
+    case Value::TYPE_BINARY: {
+      const BinaryValue& binary = static_cast<const BinaryValue&>(from);
+      to->size_ = static_cast<uint32>(binary.GetSize());
+      to->data_ = CopyData(StringPiece(binary.GetBuffer(), binary.GetSize()));
+      break;
+    }
+    case Value::TYPE_DICTIONARY: {
+      const DictionaryValue& dictionary =
+          static_cast<const DictionaryValue&>(from);
+      to->size_ = static_cast<uint32>(dictionary.size());
+      to->members_ = NULL;
+      if (!dictionary.size())
+        break;
+      // DictionaryValue iterates in key order already.
+      CompactValue::Member* members = static_cast<CompactValue::Member*>(
+          Allocate(dictionary.size() * sizeof(CompactValue::Member)));
+      CompactValue::Member* member = members;
+      for (DictionaryValue::Iterator it(dictionary); !it.IsAtEnd();
+           it.Advance(), ++member) {
+        member->key = CopyData(it.key());
+        member->key_size = static_cast<uint32>(it.key().size());
+        CopyValue(it.value(), &member->value);
+      }
+      to->members_ = members;
+      break;
+    }
+    case Value::TYPE_LIST: {
+      const ListValue& list = static_cast<const ListValue&>(from);
+      to->size_ = static_cast<uint32>(list.GetSize());
+      to->items_ = NULL;
+      if (list.empty())
+        break;
+      CompactValue* items = static_cast<CompactValue*>(
+          Allocate(list.GetSize() * sizeof(CompactValue)));
+      CompactValue* item = items;
+      for (ListValue::const_iterator it = list.begin(); it != list.end();
+           ++it, ++item) {
+        CopyValue(**it, item);
+      }
+      to->items_ = items;
+      break;
+    }
+  }
+}
+
+}  // namespace base
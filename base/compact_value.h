@@ -0,0 +1,157 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// A read-only, compact alternative to the Value tree of base/values.h.
+//
+// A Value tree spends a heap node on every scalar and a std::map node on every
+// dictionary member, which makes large documents slow to build and
+// cache-hostile to walk. A CompactValueDocument instead stores the whole tree
+// in a few large blocks owned by the document: scalars are stored inline in
+// their parent, and the members of a dictionary or list are kept in one
+// contiguous array, dictionaries sorted by key so that lookups are a binary
+// search. The memory is released all at once with the document.
+//
+// Documents are immutable. They can be built from JSON directly, without
+// allocating any Value, or from an existing Value, and converted back with
+// ToValue() wherever the Value API is needed, e.g. to use JSONWriter or the IPC
+// ParamTraits for DictionaryValue.
+//
+//   scoped_ptr<CompactValueDocument> document(
+//       CompactValueDocument::ReadJSON(json, JSON_PARSE_RFC, NULL, NULL));
+//   const CompactValue* name = document->root().FindKey("name");
+//   StringPiece name_string;
+//   if (name && name->GetAsString(&name_string))
+//     ...
+
+#ifndef BASE_COMPACT_VALUE_H_
+#define BASE_COMPACT_VALUE_H_
+
+#include <string>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/strings/string_piece.h"
+#include "base/values.h"
+
+namespace base {
+
+class CompactValueDocument;
+
+// A node of a CompactValueDocument. CompactValues are only ever handed out by
+// reference or pointer into their document, and are valid for as long as the
+// document is.
+class BASE_EXPORT CompactValue {
+ public:
+  Value::Type GetType() const { return type_; }
+  bool IsType(Value::Type type) const { return type == type_; }
+
+  // These mirror the accessors of Value: if this node can be converted into
+  // the given type, the value is returned through |out_value| and true is
+  // returned; otherwise, false is returned and |out_value| is unchanged.
+  // As with Value, an integer can be read as a double. The StringPiece
+  // returned by GetAsString() and GetAsBinary() points into the document.
+  bool GetAsBoolean(bool* out_value) const;
+  bool GetAsInteger(int* out_value) const;
+  bool GetAsDouble(double* out_value) const;
+  bool GetAsString(StringPiece* out_value) const;
+  bool GetAsString(std::string* out_value) const;
+  bool GetAsBinary(StringPiece* out_value) const;
+
+  // Returns the number of items of a list or members of a dictionary, and 0
+  // for any other type.
+  size_t GetSize() const;
+
+  // Returns the |index|th item of a list, or NULL if this is not a list or
+  // |index| is out of range.
+  const CompactValue* GetListItem(size_t index) const;
+
+  // Give access to the |index|th member of a dictionary, in key order.
+  // This must be a dictionary and |index| must be less than GetSize().
+  StringPiece GetMemberKey(size_t index) const;
+  const CompactValue& GetMemberValue(size_t index) const;
+
+  // Returns the value of the member of a dictionary whose key is |key|, or
+  // NULL if there is none or this is not a dictionary. Keys are not
+  // expanded as paths.
+  const CompactValue* FindKey(const StringPiece& key) const;
+
+  // Returns a Value tree with the same contents. The caller owns the result.
+  Value* ToValue() const;
+
+ private:
+  friend class CompactValueDocument;
+
+  struct Member;
+
+  Value::Type type_;
+
+  // The length of a string or binary value, or the number of items or
+  // members of a list or dictionary.
+  uint32 size_;
+
+  union {
+    bool boolean_;
+    int integer_;
+    double double_;
+    const char* data_;
+    const CompactValue* items_;
+    const Member* members_;
+  };
+};
+
+class BASE_EXPORT CompactValueDocument {
+ public:
+  // Builds a document holding a copy of |value|.
+  explicit CompactValueDocument(const Value& value);
+  ~CompactValueDocument();
+
+  // Parses |json| according to |options| (see JSONParserOptions) and builds a
+  // document from it without creating any Value. Returns NULL if |json| is
+  // not properly formed, in which case |error_code_out| and |error_msg_out|
+  // are populated if specified. The caller owns the result.
+  static CompactValueDocument* ReadJSON(const StringPiece& json,
+                                        int options,
+                                        int* error_code_out,
+                                        std::string* error_msg_out);
+
+  const CompactValue& root() const { return root_; }
+
+  // Returns a Value tree with the same contents as root(). The caller owns
+  // the result.
+  Value* ToValue() const { return root_.ToValue(); }
+
+  // Returns the size of the blocks holding the nodes and strings of this
+  // document.
+  size_t allocated_bytes() const { return allocated_bytes_; }
+
+ private:
+  class JSONBuilder;
+
+  CompactValueDocument();
+
+  // Returns |size| bytes from the document's blocks, suitably aligned for any
+  // node.
+  void* Allocate(size_t size);
+
+  // Copies |data| into the document and returns the copy.
+  const char* CopyData(const StringPiece& data);
+
+  // Copies |from| into |to|, recursively.
+  void CopyValue(const Value& from, CompactValue* to);
+
+  // Memory is handed out of the last of |blocks_|, from |next_| on.
+  std::vector<char*> blocks_;
+  char* next_;
+  size_t remaining_;
+  size_t allocated_bytes_;
+
+  CompactValue root_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompactValueDocument);
+};
+
+}  // namespace base
+
+#endif  // BASE_COMPACT_VALUE_H_
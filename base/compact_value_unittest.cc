@@ -0,0 +1,157 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/compact_value.h"
+
+#include <string>
+
+#include "base/json/json_reader.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/stringprintf.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const char kTestJSON[] =
+    "{\"name\": \"compact\", \"count\": 3, \"ratio\": 0.5, \"on\": true,"
+    " \"nothing\": null, \"list\": [1, \"two\", [], {}, [false]],"
+    " \"nested\": {\"b\": {\"c\": \"\\u00e9\"}, \"a\": \"\"}}";
+
+}  // namespace
+
+TEST(CompactValueTest, ReadJSON) {
+  scoped_ptr<CompactValueDocument> document(
+      CompactValueDocument::ReadJSON(kTestJSON, JSON_PARSE_RFC, NULL, NULL));
+  ASSERT_TRUE(document.get());
+
+  const CompactValue& root = document->root();
+  ASSERT_TRUE(root.IsType(Value::TYPE_DICTIONARY));
+  EXPECT_EQ(7U, root.GetSize());
+
+  // Members are in key order.
+  EXPECT_EQ("count", root.GetMemberKey(0));
+  EXPECT_EQ("ratio", root.GetMemberKey(6));
+
+  StringPiece name;
+  ASSERT_TRUE(root.FindKey("name"));
+  EXPECT_TRUE(root.FindKey("name")->GetAsString(&name));
+  EXPECT_EQ("compact", name);
+
+  int count = 0;
+  EXPECT_TRUE(root.FindKey("count")->GetAsInteger(&count));
+  EXPECT_EQ(3, count);
+  double ratio = 0;
+  EXPECT_TRUE(root.FindKey("ratio")->GetAsDouble(&ratio));
+  EXPECT_EQ(0.5, ratio);
+  EXPECT_TRUE(root.FindKey("count")->GetAsDouble(&ratio));
+  EXPECT_EQ(3, ratio);
+  bool on = false;
+  EXPECT_TRUE(root.FindKey("on")->GetAsBoolean(&on));
+  EXPECT_TRUE(on);
+  EXPECT_TRUE(root.FindKey("nothing")->IsType(Value::TYPE_NULL));
+  EXPECT_FALSE(root.FindKey("missing"));
+  EXPECT_FALSE(root.FindKey("nested.a"));
+
+  const CompactValue* list = root.FindKey("list");
+  ASSERT_TRUE(list);
+  EXPECT_EQ(5U, list->GetSize());
+  EXPECT_TRUE(list->GetListItem(1)->GetAsString(&name));
+  EXPECT_EQ("two", name);
+  EXPECT_EQ(0U, list->GetListItem(2)->GetSize());
+  EXPECT_TRUE(list->GetListItem(3)->IsType(Value::TYPE_DICTIONARY));
+  EXPECT_FALSE(list->GetListItem(5));
+
+  std::string c;
+  EXPECT_TRUE(root.FindKey("nested")->FindKey("b")->FindKey("c")->GetAsString(
+      &c));
+  EXPECT_EQ("\xC3\xA9", c);
+}
+
+TEST(CompactValueTest, ReadJSONMatchesJSONReader) {
+  scoped_ptr<CompactValueDocument> document(
+      CompactValueDocument::ReadJSON(kTestJSON, JSON_PARSE_RFC, NULL, NULL));
+  scoped_ptr<Value> expected(JSONReader::Read(kTestJSON));
+  ASSERT_TRUE(document.get());
+  ASSERT_TRUE(expected.get());
+  scoped_ptr<Value> actual(document->ToValue());
+  EXPECT_TRUE(actual->Equals(expected.get()));
+}
+
+TEST(CompactValueTest, DuplicateKeys) {
+  scoped_ptr<CompactValueDocument> document(CompactValueDocument::ReadJSON(
+      "{\"a\": 1, \"b\": 2, \"a\": 3}", JSON_PARSE_RFC, NULL, NULL));
+  ASSERT_TRUE(document.get());
+  EXPECT_EQ(2U, document->root().GetSize());
+  int a = 0;
+  EXPECT_TRUE(document->root().FindKey("a")->GetAsInteger(&a));
+  EXPECT_EQ(3, a);
+}
+
+TEST(CompactValueTest, Errors) {
+  int error_code = 0;
+  std::string error_message;
+  EXPECT_FALSE(CompactValueDocument::ReadJSON(
+      "{\"a\": [1, 2,]}", JSON_PARSE_RFC, &error_code, &error_message));
+  EXPECT_EQ(JSONReader::JSON_TRAILING_COMMA, error_code);
+  EXPECT_FALSE(error_message.empty());
+}
+
+TEST(CompactValueTest, FromValue) {
+  DictionaryValue dictionary;
+  dictionary.SetString("string", "value");
+  dictionary.SetInteger("nested.integer", 42);
+  dictionary.Set("binary", BinaryValue::CreateWithCopiedBuffer("\0\1\2", 3));
+  ListValue* list = new ListValue;
+  list->AppendDouble(1.5);
+  list->Append(Value::CreateNullValue());
+  dictionary.Set("list", list);
+
+  CompactValueDocument document(dictionary);
+  const CompactValue& root = document.root();
+  EXPECT_EQ(4U, root.GetSize());
+
+  int integer = 0;
+  EXPECT_TRUE(root.FindKey("nested")->FindKey("integer")->GetAsInteger(
+      &integer));
+  EXPECT_EQ(42, integer);
+  StringPiece binary;
+  EXPECT_TRUE(root.FindKey("binary")->GetAsBinary(&binary));
+  EXPECT_EQ(StringPiece("\0\1\2", 3), binary);
+  EXPECT_FALSE(root.FindKey("binary")->GetAsString(&binary));
+
+  scoped_ptr<Value> round_trip(document.ToValue());
+  EXPECT_TRUE(round_trip->Equals(&dictionary));
+
+  CompactValueDocument scalar_document(FundamentalValue(true));
+  bool boolean = false;
+  EXPECT_TRUE(scalar_document.root().GetAsBoolean(&boolean));
+  EXPECT_TRUE(boolean);
+}
+
+TEST(CompactValueTest, LargeDocument) {
+  std::string json("[");
+  for (int i = 0; i < 10000; ++i) {
+    StringAppendF(&json, "%s{\"id\": %d, \"name\": \"item %d\"}",
+                  i ? "," : "", i, i);
+  }
+  json.append("]");
+
+  scoped_ptr<CompactValueDocument> document(
+      CompactValueDocument::ReadJSON(json, JSON_PARSE_RFC, NULL, NULL));
+  ASSERT_TRUE(document.get());
+  ASSERT_EQ(10000U, document->root().GetSize());
+  int id = 0;
+  EXPECT_TRUE(document->root().GetListItem(9999)->FindKey("id")->GetAsInteger(
+      &id));
+  EXPECT_EQ(9999, id);
+
+  scoped_ptr<Value> expected(JSONReader::Read(json));
+  scoped_ptr<Value> actual(document->ToValue());
+  EXPECT_TRUE(actual->Equals(expected.get()));
+}
+
+}  // namespace base
@@ -8,11 +8,13 @@
 
 #include <algorithm>
 
+#include "base/basictypes.h"
 #include "build/build_config.h"
 
 #if defined(ARCH_CPU_X86_FAMILY)
 #if defined(_MSC_VER)
 #include <intrin.h>
+#include <immintrin.h>  // For _xgetbv()
 #endif
 #endif
 
@@ -33,6 +35,8 @@ CPU::CPU()
     has_ssse3_(false),
     has_sse41_(false),
     has_sse42_(false),
+    has_avx_(false),
+    has_pclmul_(false),
     has_non_stop_time_stamp_counter_(false),
     cpu_vendor_("unknown") {
   Initialize();
@@ -82,6 +86,20 @@ void __cpuidex(int cpu_info[4], int info_type, int info_index) {
 }
 
 #endif
+
+// _xgetbv returns the value of an Intel Extended Control Register (XCR).
+// Currently only XCR0 is defined by Intel so |xcr| should always be zero.
+uint64 _xgetbv(uint32 xcr) {
+  uint32 eax, edx;
+
+  __asm__ volatile (
+    ".byte 0x0f, 0x01, 0xd0\n"  // xgetbv, for assemblers that don't know it.
+    : "=a"(eax), "=d"(edx)
+    : "c"(xcr)
+  );
+  return (static_cast<uint64>(edx) << 32) | eax;
+}
+
 #endif  // _MSC_VER
 #endif  // ARCH_CPU_X86_FAMILY
 
@@ -120,7 +138,13 @@ void CPU::Initialize() {
     has_ssse3_ = (cpu_info[2] & 0x00000200) != 0;
     has_sse41_ = (cpu_info[2] & 0x00080000) != 0;
     has_sse42_ = (cpu_info[2] & 0x00100000) != 0;
-    has_avx_ = (cpu_info[2] & 0x10000000) != 0;
+    has_pclmul_ = (cpu_info[2] & 0x00000002) != 0;
+    // AVX instructions fault unless the OS saves the YMM registers on
+    // context switches, which it reports through OSXSAVE and XCR0.
+    has_avx_ =
+        (cpu_info[2] & 0x10000000) != 0 &&
+        (cpu_info[2] & 0x08000000) != 0 &&
+        (_xgetbv(0) & 6) == 6;
   }
 
   // Get the brand string of the cpu.
@@ -28,6 +28,7 @@
 #include "base/threading/platform_thread.h"
 #include "base/threading/thread_id_name_manager.h"
 #include "base/threading/thread_local.h"
+#include "base/threading/thread_local_storage.h"
 #include "base/time/time.h"
 
 #if defined(OS_WIN)
@@ -53,6 +54,9 @@ namespace debug {
 const size_t kTraceEventBufferSize = 500000;
 const size_t kTraceEventBatchSize = 1000;
 const size_t kTraceEventInitialBufferSize = 1024;
+// Number of events a thread buffers locally before handing them over to the
+// shared trace buffer.
+const size_t kTraceEventThreadLocalBufferSize = 64;
 
 #define MAX_CATEGORY_GROUPS 100
 
@@ -84,6 +88,11 @@ int g_category_index = g_num_builtin_categories; // Skip default categories.
 LazyInstance<ThreadLocalPointer<const char> >::Leaky
     g_current_thread_name = LAZY_INSTANCE_INITIALIZER;
 
+// The TraceLog::ThreadLocalEventBuffer of the current thread. A TLS slot is
+// used rather than a ThreadLocalPointer so that the buffered events are handed
+// over when the thread exits.
+ThreadLocalStorage::StaticSlot g_thread_local_event_buffer = TLS_INITIALIZER;
+
 const char kRecordUntilFull[] = "record-until-full";
 const char kRecordContinuously[] = "record-continuously";
 const char kEnableSampling[] = "enable-sampling";
@@ -763,6 +772,66 @@ void TraceLog::NotificationHelper::SendNotificationIfAny() {
     callback_copy_.Run(notification_);
 }
 
+class TraceLog::ThreadLocalEventBuffer {
+ public:
+  ThreadLocalEventBuffer() : trace_log_(NULL) {
+    events_.reserve(kTraceEventThreadLocalBufferSize);
+  }
+
+  // The TraceLog this buffer is registered with, or NULL. Only the owning
+  // thread attaches the buffer, so it can read this without locking.
+  TraceLog* trace_log() const { return trace_log_; }
+
+  void Attach(TraceLog* trace_log) {
+    AutoLock lock(lock_);
+    trace_log_ = trace_log;
+  }
+
+  // Called when the TraceLog is deleted; the owning thread re-registers the
+  // buffer with the next TraceLog instance it records events on.
+  void Detach() {
+    AutoLock lock(lock_);
+    trace_log_ = NULL;
+    events_.clear();
+  }
+
+  // Appends |event| unless thread-local buffering has been disabled, in which
+  // case false is returned and the caller records |event| itself. Once the
+  // buffer is full its events are swapped into |full_chunk|, so that the
+  // caller can pass them on to the TraceLog without holding |lock_|.
+  bool AddEvent(const TraceEvent& event, std::vector<TraceEvent>* full_chunk) {
+    AutoLock lock(lock_);
+    // Checking the flag under |lock_| guarantees that no event is added after
+    // FlushThreadLocalEventBuffersWhileLocked() has cleared the flag and
+    // collected this buffer.
+    if (!trace_log_ || !subtle::NoBarrier_Load(
+            &trace_log_->thread_local_event_buffers_enabled_)) {
+      return false;
+    }
+    events_.push_back(event);
+    if (events_.size() >= kTraceEventThreadLocalBufferSize) {
+      full_chunk->swap(events_);
+      events_.reserve(kTraceEventThreadLocalBufferSize);
+    }
+    return true;
+  }
+
+  // Moves all buffered events to the end of |events|.
+  void TakeEvents(std::vector<TraceEvent>* events) {
+    AutoLock lock(lock_);
+    events->insert(events->end(), events_.begin(), events_.end());
+    events_.clear();
+  }
+
+ private:
+  TraceLog* trace_log_;
+  // Only contended while the events are being collected by another thread.
+  Lock lock_;
+  std::vector<TraceEvent> events_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadLocalEventBuffer);
+};
+
 // static
 TraceLog* TraceLog::GetInstance() {
   return Singleton<TraceLog, LeakySingletonTraits<TraceLog> >::get();
@@ -803,7 +872,11 @@ TraceLog::TraceLog()
       watch_category_(NULL),
       trace_options_(RECORD_UNTIL_FULL),
       sampling_thread_handle_(0),
-      category_filter_(CategoryFilter::kDefaultCategoryFilterString) {
+      category_filter_(CategoryFilter::kDefaultCategoryFilterString),
+      thread_local_event_buffers_enabled_(0) {
+  if (!g_thread_local_event_buffer.initialized())
+    g_thread_local_event_buffer.Initialize(&OnThreadLocalEventBufferThreadExit);
+
   // Trace is enabled or disabled on one thread while other threads are
   // accessing the enabled flag. We don't care whether edge-case events are
   // traced or not, so we allow races on the enabled flag to keep the trace
@@ -839,6 +912,10 @@ TraceLog::TraceLog()
 }
 
 TraceLog::~TraceLog() {
+  // Threads may outlive this TraceLog (see DeleteForTesting()). They keep
+  // their buffers, which must forget about this instance.
+  for (size_t i = 0; i < thread_local_event_buffers_.size(); ++i)
+    thread_local_event_buffers_[i]->Detach();
 }
 
 const unsigned char* TraceLog::GetCategoryGroupEnabled(
@@ -974,6 +1051,7 @@ void TraceLog::SetEnabled(const CategoryFilter& category_filter,
 
     category_filter_ = CategoryFilter(category_filter);
     UpdateCategoryGroupEnabledFlags();
+    UpdateThreadLocalEventBuffersEnabledWhileLocked();
 
     if (options & ENABLE_SAMPLING) {
       sampling_thread_.reset(new TraceSamplingThread);
@@ -1016,6 +1094,7 @@ const CategoryFilter& TraceLog::GetCurrentCategoryFilter() {
 
 void TraceLog::SetDisabled() {
   std::vector<EnabledStateObserver*> observer_list;
+  NotificationHelper notifier(this);
   {
     AutoLock lock(lock_);
     DCHECK(enable_count_ > 0);
@@ -1042,11 +1121,14 @@ void TraceLog::SetDisabled() {
     watch_category_ = NULL;
     watch_event_name_ = "";
     UpdateCategoryGroupEnabledFlags();
+    UpdateThreadLocalEventBuffersEnabledWhileLocked();
+    FlushThreadLocalEventBuffersWhileLocked(&notifier);
     AddMetadataEvents();
 
     dispatching_to_observer_list_ = true;
     observer_list = enabled_state_observer_list_;
   }
+  notifier.SendNotificationIfAny();
 
   // Dispatch to observers outside the lock in case the observer triggers a
   // trace event.
@@ -1108,18 +1190,96 @@ TraceBuffer* TraceLog::GetTraceBuffer() {
 void TraceLog::SetEventCallback(EventCallback cb) {
   AutoLock lock(lock_);
   event_callback_ = cb;
+  UpdateThreadLocalEventBuffersEnabledWhileLocked();
 };
 
+TraceLog::ThreadLocalEventBuffer* TraceLog::GetThreadLocalEventBuffer() {
+  ThreadLocalEventBuffer* buffer =
+      static_cast<ThreadLocalEventBuffer*>(g_thread_local_event_buffer.Get());
+  if (buffer && buffer->trace_log() == this)
+    return buffer;
+
+  if (!buffer) {
+    buffer = new ThreadLocalEventBuffer;
+    g_thread_local_event_buffer.Set(buffer);
+  }
+  AutoLock lock(lock_);
+  buffer->Attach(this);
+  thread_local_event_buffers_.push_back(buffer);
+  return buffer;
+}
+
+// static
+void TraceLog::OnThreadLocalEventBufferThreadExit(void* value) {
+  ThreadLocalEventBuffer* buffer = static_cast<ThreadLocalEventBuffer*>(value);
+  if (buffer->trace_log())
+    buffer->trace_log()->RemoveThreadLocalEventBuffer(buffer);
+  delete buffer;
+}
+
+void TraceLog::RemoveThreadLocalEventBuffer(ThreadLocalEventBuffer* buffer) {
+  NotificationHelper notifier(this);
+  {
+    AutoLock lock(lock_);
+    std::vector<ThreadLocalEventBuffer*>::iterator it =
+        std::find(thread_local_event_buffers_.begin(),
+                  thread_local_event_buffers_.end(),
+                  buffer);
+    if (it != thread_local_event_buffers_.end())
+      thread_local_event_buffers_.erase(it);
+
+    std::vector<TraceEvent> events;
+    buffer->TakeEvents(&events);
+    AddEventsWhileLocked(&events, &notifier);
+  }
+  notifier.SendNotificationIfAny();
+}
+
+void TraceLog::UpdateThreadLocalEventBuffersEnabledWhileLocked() {
+  lock_.AssertAcquired();
+  // Echoing to the console, watch events and the event callback all have to
+  // see each event as it is recorded.
+  bool enabled = enable_count_ && !(trace_options_ & ECHO_TO_CONSOLE) &&
+      !watch_category_ && !event_callback_;
+  subtle::NoBarrier_Store(&thread_local_event_buffers_enabled_,
+                          enabled ? 1 : 0);
+}
+
+void TraceLog::FlushThreadLocalEventBuffersWhileLocked(
+    NotificationHelper* notifier) {
+  lock_.AssertAcquired();
+  std::vector<TraceEvent> events;
+  for (size_t i = 0; i < thread_local_event_buffers_.size(); ++i)
+    thread_local_event_buffers_[i]->TakeEvents(&events);
+  AddEventsWhileLocked(&events, notifier);
+}
+
+void TraceLog::AddEventsWhileLocked(std::vector<TraceEvent>* events,
+                                    NotificationHelper* notifier) {
+  lock_.AssertAcquired();
+  if (events->empty() || logged_events_->IsFull())
+    return;
+
+  for (size_t i = 0; i < events->size() && !logged_events_->IsFull(); ++i)
+    logged_events_->AddEvent((*events)[i]);
+
+  if (logged_events_->IsFull())
+    notifier->AddNotificationWhileLocked(TRACE_BUFFER_FULL);
+}
+
 void TraceLog::Flush(const TraceLog::OutputCallback& cb) {
   // Ignore memory allocations from here down.
   INTERNAL_TRACE_MEMORY(TRACE_DISABLED_BY_DEFAULT("memory"),
                         TRACE_MEMORY_IGNORE);
   scoped_ptr<TraceBuffer> previous_logged_events;
+  NotificationHelper notifier(this);
   {
     AutoLock lock(lock_);
+    FlushThreadLocalEventBuffersWhileLocked(&notifier);
     previous_logged_events.swap(logged_events_);
     logged_events_.reset(GetTraceBuffer());
   }  // release lock
+  notifier.SendNotificationIfAny();
 
   while (previous_logged_events->HasMoreEvents()) {
     scoped_refptr<RefCountedString> json_events_str_ptr =
@@ -1231,6 +1391,21 @@ void TraceLog::AddTraceEventWithThreadIdAndTimestamp(
       num_args, arg_names, arg_types, arg_values,
       convertable_values, flags);
 
+  // Fast path: record into the calling thread's buffer and only take |lock_|
+  // once for every kTraceEventThreadLocalBufferSize events.
+  if (subtle::NoBarrier_Load(&thread_local_event_buffers_enabled_)) {
+    ThreadLocalEventBuffer* buffer = GetThreadLocalEventBuffer();
+    std::vector<TraceEvent> full_chunk;
+    if (buffer->AddEvent(trace_event, &full_chunk)) {
+      if (!full_chunk.empty()) {
+        AutoLock lock(lock_);
+        AddEventsWhileLocked(&full_chunk, &notifier);
+      }
+      notifier.SendNotificationIfAny();
+      return;
+    }
+  }
+
   do {
     AutoLock lock(lock_);
 
@@ -1317,15 +1492,22 @@ void TraceLog::SetWatchEvent(const std::string& category_name,
   const unsigned char* category = GetCategoryGroupEnabled(
       category_name.c_str());
   size_t notify_count = 0;
+  NotificationHelper flush_notifier(this);
   {
     AutoLock lock(lock_);
     watch_category_ = category;
     watch_event_name_ = event_name;
 
+    // Watched events are matched as they are recorded, so stop buffering
+    // them per thread and collect what has been buffered so far.
+    UpdateThreadLocalEventBuffersEnabledWhileLocked();
+    FlushThreadLocalEventBuffersWhileLocked(&flush_notifier);
+
     // First, search existing events for watch event because we want to catch
     // it even if it has already occurred.
     notify_count = logged_events_->CountEnabledByName(category, event_name);
   }  // release lock
+  flush_notifier.SendNotificationIfAny();
 
   // Send notification for each event found.
   for (size_t i = 0; i < notify_count; ++i) {
@@ -1341,6 +1523,7 @@ void TraceLog::CancelWatchEvent() {
   AutoLock lock(lock_);
   watch_category_ = NULL;
   watch_event_name_ = "";
+  UpdateThreadLocalEventBuffersEnabledWhileLocked();
 }
 
 namespace {
@@ -1431,6 +1614,16 @@ void TraceLog::DeleteForTesting() {
   DeleteTraceLogForTesting::Delete();
 }
 
+size_t TraceLog::GetEventsSize() {
+  NotificationHelper notifier(this);
+  {
+    AutoLock lock(lock_);
+    FlushThreadLocalEventBuffersWhileLocked(&notifier);
+  }
+  notifier.SendNotificationIfAny();
+  return logged_events_->Size();
+}
+
 void TraceLog::SetProcessID(int process_id) {
   process_id_ = process_id;
   // Create a FNV hash from the process ID for XORing.
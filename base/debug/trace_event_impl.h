@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 
+#include "base/atomicops.h"
 #include "base/callback.h"
 #include "base/containers/hash_tables.h"
 #include "base/gtest_prod_util.h"
@@ -442,8 +443,9 @@ class BASE_EXPORT TraceLog {
   // Allows deleting our singleton instance.
   static void DeleteForTesting();
 
-  // Allow tests to inspect TraceEvents.
-  size_t GetEventsSize() const { return logged_events_->Size(); }
+  // Allow tests to inspect TraceEvents. GetEventsSize() first collects the
+  // events still sitting in thread-local buffers.
+  size_t GetEventsSize();
   const TraceEvent& GetEventAt(size_t index) const {
     return logged_events_->GetEventAt(index);
   }
@@ -525,6 +527,11 @@ class BASE_EXPORT TraceLog {
     int notification_;
   };
 
+  // Per-thread chunk of trace events, only handed over to |logged_events_|
+  // once it fills up or the events are collected, so that recording an event
+  // normally does not touch any state shared with other threads.
+  class ThreadLocalEventBuffer;
+
   TraceLog();
   ~TraceLog();
   const unsigned char* GetCategoryGroupEnabledInternal(const char* name);
@@ -546,8 +553,22 @@ class BASE_EXPORT TraceLog {
 
   TraceBuffer* GetTraceBuffer();
 
-  // TODO(nduca): switch to per-thread trace buffers to reduce thread
-  // synchronization.
+  // Returns the calling thread's event buffer, creating and registering it
+  // on first use.
+  ThreadLocalEventBuffer* GetThreadLocalEventBuffer();
+  // Called on thread exit with the exiting thread's ThreadLocalEventBuffer.
+  static void OnThreadLocalEventBufferThreadExit(void* buffer);
+  void RemoveThreadLocalEventBuffer(ThreadLocalEventBuffer* buffer);
+
+  // Enables thread-local buffering unless an option or observer needs every
+  // event to go through |lock_| as it is recorded.
+  void UpdateThreadLocalEventBuffersEnabledWhileLocked();
+  // Moves the events held by every thread-local buffer to |logged_events_|.
+  void FlushThreadLocalEventBuffersWhileLocked(NotificationHelper* notifier);
+  // Appends |events| to |logged_events_|, dropping whatever does not fit.
+  void AddEventsWhileLocked(std::vector<TraceEvent>* events,
+                            NotificationHelper* notifier);
+
   // This lock protects TraceLog member accesses from arbitrary threads.
   Lock lock_;
   int enable_count_;
@@ -586,6 +607,12 @@ class BASE_EXPORT TraceLog {
 
   CategoryFilter category_filter_;
 
+  // Non-zero while events may be recorded into thread-local buffers. Only
+  // written while holding |lock_|.
+  subtle::Atomic32 thread_local_event_buffers_enabled_;
+  // Buffers of all threads that have recorded events, guarded by |lock_|.
+  std::vector<ThreadLocalEventBuffer*> thread_local_event_buffers_;
+
   DISALLOW_COPY_AND_ASSIGN(TraceLog);
 };
 
@@ -12,6 +12,7 @@
 #include "base/message_loop/message_loop.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
 #include "base/threading/thread_local_storage.h"
 
 namespace base {
@@ -43,6 +44,48 @@ class MemoryDumpHolder : public base::debug::ConvertableToTraceFormat {
   DISALLOW_COPY_AND_ASSIGN(MemoryDumpHolder);
 };
 
+/////////////////////////////////////////////////////////////////////////////
+// Holds the subsystem totals of a memory dump until the tracing system needs
+// to serialize them.
+class SubsystemTotalsHolder : public base::debug::ConvertableToTraceFormat {
+ public:
+  explicit SubsystemTotalsHolder(const SubsystemMemoryTotals& totals)
+      : totals_(totals) {}
+  virtual ~SubsystemTotalsHolder() {}
+
+  // base::debug::ConvertableToTraceFormat overrides:
+  virtual void AppendAsTraceFormat(std::string* out) const OVERRIDE {
+    out->append("{");
+    for (SubsystemMemoryTotals::const_iterator it = totals_.begin();
+         it != totals_.end(); ++it) {
+      if (it != totals_.begin())
+        out->append(", ");
+      out->append("\"");
+      out->append(it->first);
+      out->append("\": ");
+      out->append(Int64ToString(it->second));
+    }
+    out->append("}");
+  }
+
+ private:
+  SubsystemMemoryTotals totals_;
+
+  DISALLOW_COPY_AND_ASSIGN(SubsystemTotalsHolder);
+};
+
+// The subsystem totals of the last memory dump in this process.
+struct LastSubsystemTotals {
+  LastSubsystemTotals() : valid(false) {}
+
+  Lock lock;
+  bool valid;
+  SubsystemMemoryTotals totals;
+};
+
+LazyInstance<LastSubsystemTotals>::Leaky g_last_subsystem_totals =
+    LAZY_INSTANCE_INITIALIZER;
+
 /////////////////////////////////////////////////////////////////////////////
 // Records a stack of TRACE_MEMORY events. One per thread is required.
 struct TraceMemoryStack {
@@ -123,6 +166,33 @@ int GetPseudoStack(int skip_count_ignored, void** stack_out) {
   return static_cast<int>(count);
 }
 
+// Splits heap profiler data in |input| into |lines|, leaving out the list of
+// mapped libraries at the end. Returns the number of lines.
+size_t GetHeapProfileLines(const char* input, std::vector<std::string>* lines) {
+  std::string input_string;
+  const char* mapped_libraries = strstr(input, "MAPPED_LIBRARIES");
+  if (mapped_libraries) {
+    input_string.assign(input, mapped_libraries - input);
+  } else {
+    input_string.assign(input);
+  }
+  return Tokenize(input_string, "\n", lines);
+}
+
+// Converts a "stack address" from a heap profile |token| into the trace name
+// it points to. Returns false if |token| is not an address.
+bool GetTraceNameFromAddress(const std::string& token,
+                             const char** trace_name) {
+  uint64 address = 0;
+  if (!base::HexStringToUInt64(token, &address))
+    return false;
+  // This is ugly but otherwise tcmalloc would need to gain a special output
+  // serializer for pseudo-stacks. Note that this cast also handles 64-bit to
+  // 32-bit conversion if necessary. Tests use a null address.
+  *trace_name = address ? reinterpret_cast<const char*>(address) : "null";
+  return true;
+}
+
 }  // namespace
 
 //////////////////////////////////////////////////////////////////////////////
@@ -136,6 +206,7 @@ TraceMemoryController::TraceMemoryController(
       heap_profiler_start_function_(heap_profiler_start_function),
       heap_profiler_stop_function_(heap_profiler_stop_function),
       get_heap_profile_function_(get_heap_profile_function),
+      continuous_(false),
       weak_factory_(this) {
   // Force the "memory" category to show up in the trace viewer.
   TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("memory"), "init");
@@ -144,6 +215,7 @@ TraceMemoryController::TraceMemoryController(
 }
 
 TraceMemoryController::~TraceMemoryController() {
+  continuous_ = false;
   if (dump_timer_.IsRunning())
     StopProfiling();
   TraceLog::GetInstance()->RemoveEnabledStateObserver(this);
@@ -201,6 +273,17 @@ void TraceMemoryController::DumpMemoryProfile() {
   // MemoryDumpHolder takes ownership of this string. See GetHeapProfile() in
   // tcmalloc for details.
   char* dump = get_heap_profile_function_();
+  SubsystemMemoryTotals totals;
+  GetHeapProfileSubsystemTotals(dump, &totals);
+  scoped_ptr<SubsystemTotalsHolder> totals_holder(
+      new SubsystemTotalsHolder(totals));
+  {
+    LastSubsystemTotals* last = g_last_subsystem_totals.Pointer();
+    AutoLock lock(last->lock);
+    last->totals.swap(totals);
+    last->valid = true;
+  }
+
   scoped_ptr<MemoryDumpHolder> dump_holder(new MemoryDumpHolder(dump));
   const int kSnapshotId = 1;
   TRACE_EVENT_OBJECT_SNAPSHOT_WITH_ID(
@@ -208,12 +291,20 @@ void TraceMemoryController::DumpMemoryProfile() {
       "memory::Heap",
       kSnapshotId,
       dump_holder.PassAs<base::debug::ConvertableToTraceFormat>());
+  TRACE_EVENT_OBJECT_SNAPSHOT_WITH_ID(
+      TRACE_DISABLED_BY_DEFAULT("memory"),
+      "memory::Subsystems",
+      kSnapshotId,
+      totals_holder.PassAs<base::debug::ConvertableToTraceFormat>());
 }
 
 void TraceMemoryController::StopProfiling() {
   // Watch for the tracing framework sending disabled more than once.
   if (!dump_timer_.IsRunning())
     return;
+  // Continuous profiling outlives tracing sessions.
+  if (continuous_)
+    return;
   DVLOG(1) << "Stopping trace memory";
   dump_timer_.Stop();
   ScopedTraceMemory::set_enabled(false);
@@ -222,6 +313,12 @@ void TraceMemoryController::StopProfiling() {
   heap_profiler_stop_function_();
 }
 
+void TraceMemoryController::StartContinuousProfiling() {
+  DVLOG(1) << "Starting continuous trace memory";
+  continuous_ = true;
+  StartProfiling();
+}
+
 bool TraceMemoryController::IsTimerRunningForTest() const {
   return dump_timer_.IsRunning();
 }
@@ -300,16 +397,8 @@ void AppendHeapProfileAsTraceFormat(const char* input, std::string* output) {
   // ...
   //
   // Skip input after MAPPED_LIBRARIES.
-  std::string input_string;
-  const char* mapped_libraries = strstr(input, "MAPPED_LIBRARIES");
-  if (mapped_libraries) {
-    input_string.assign(input, mapped_libraries - input);
-  } else {
-    input_string.assign(input);
-  }
-
   std::vector<std::string> lines;
-  size_t line_count = Tokenize(input_string, "\n", &lines);
+  size_t line_count = GetHeapProfileLines(input, &lines);
   if (line_count == 0) {
     DLOG(WARNING) << "No lines found";
     return;
@@ -388,14 +477,9 @@ bool AppendHeapProfileLineAsTraceFormat(const std::string& line,
   const std::string kSingleQuote = "'";
   for (size_t t = 4; t < tokens.size(); ++t) {
     // Each stack address is a pointer to a constant trace name string.
-    uint64 address = 0;
-    if (!base::HexStringToUInt64(tokens[t], &address))
+    const char* trace_name;
+    if (!GetTraceNameFromAddress(tokens[t], &trace_name))
       break;
-    // This is ugly but otherwise tcmalloc would need to gain a special output
-    // serializer for pseudo-stacks. Note that this cast also handles 64-bit to
-    // 32-bit conversion if necessary. Tests use a null address.
-    const char* trace_name =
-        address ? reinterpret_cast<const char*>(address) : "null";
 
     // Some trace name strings have double quotes, convert them to single.
     std::string trace_name_string(trace_name);
@@ -410,5 +494,53 @@ bool AppendHeapProfileLineAsTraceFormat(const std::string& line,
   return true;
 }
 
+void GetHeapProfileSubsystemTotals(const char* input,
+                                   SubsystemMemoryTotals* output) {
+  output->clear();
+  std::vector<std::string> lines;
+  size_t line_count = GetHeapProfileLines(input, &lines);
+
+  // Skip the initial summary line. Each following line is a stack, in the
+  // format described in AppendHeapProfileLineAsTraceFormat(), with the
+  // outermost trace name first.
+  const size_t kPrefixLength = strlen(TRACE_MEMORY_SUBSYSTEM_PREFIX);
+  for (size_t i = 1; i < line_count; ++i) {
+    std::vector<std::string> tokens;
+    Tokenize(lines[i], " :[]@", &tokens);
+    int64 current_bytes = 0;
+    if (tokens.size() < 4 || !StringToInt64(tokens[1], &current_bytes) ||
+        current_bytes == 0) {
+      continue;
+    }
+
+    std::string subsystem = "other";
+    bool ignored = false;
+    for (size_t t = 4; t < tokens.size(); ++t) {
+      const char* trace_name;
+      if (!GetTraceNameFromAddress(tokens[t], &trace_name))
+        break;
+      if (strcmp(trace_name, TRACE_MEMORY_IGNORE) == 0) {
+        ignored = true;
+        break;
+      }
+      if (strncmp(trace_name, TRACE_MEMORY_SUBSYSTEM_PREFIX,
+                  kPrefixLength) == 0) {
+        subsystem = trace_name + kPrefixLength;
+      }
+    }
+    if (!ignored)
+      (*output)[subsystem] += current_bytes;
+  }
+}
+
+bool GetLastSubsystemMemoryTotals(SubsystemMemoryTotals* output) {
+  LastSubsystemTotals* last = g_last_subsystem_totals.Pointer();
+  AutoLock lock(last->lock);
+  if (!last->valid)
+    return false;
+  *output = last->totals;
+  return true;
+}
+
 }  // namespace debug
 }  // namespace base
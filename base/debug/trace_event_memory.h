@@ -5,6 +5,9 @@
 #ifndef BASE_DEBUG_TRACE_EVENT_MEMORY_H_
 #define BASE_DEBUG_TRACE_EVENT_MEMORY_H_
 
+#include <map>
+#include <string>
+
 #include "base/base_export.h"
 #include "base/debug/trace_event_impl.h"
 #include "base/gtest_prod_util.h"
@@ -59,6 +62,11 @@ class BASE_EXPORT TraceMemoryController
   // If memory tracing is enabled, dumps a memory profile to the tracing system.
   void StopProfiling();
 
+  // Keeps heap memory profiling running whether or not tracing is enabled, so
+  // that per-subsystem totals stay available from
+  // GetLastSubsystemMemoryTotals(). Must be called on the primary thread.
+  void StartContinuousProfiling();
+
  private:
   FRIEND_TEST_ALL_PREFIXES(TraceMemoryTest, TraceMemoryController);
 
@@ -76,6 +84,9 @@ class BASE_EXPORT TraceMemoryController
   // Timer to schedule memory profile dumps.
   RepeatingTimer<TraceMemoryController> dump_timer_;
 
+  // True if profiling should not stop when tracing is disabled.
+  bool continuous_;
+
   WeakPtrFactory<TraceMemoryController> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(TraceMemoryController);
@@ -125,6 +136,21 @@ BASE_EXPORT void AppendHeapProfileTotalsAsTraceFormat(const std::string& line,
 BASE_EXPORT bool AppendHeapProfileLineAsTraceFormat(const std::string& line,
                                                     std::string* output);
 
+// Bytes currently allocated, by subsystem name. Allocations made outside any
+// TRACE_MEMORY_SUBSYSTEM scope are counted under "other".
+typedef std::map<std::string, int64> SubsystemMemoryTotals;
+
+// Sums the current bytes of tcmalloc's heap profiler data with pseudo-stacks
+// in |input| by the innermost subsystem of each stack, and replaces |output|.
+// Stacks under TRACE_MEMORY_IGNORE are skipped. Visible for testing.
+BASE_EXPORT void GetHeapProfileSubsystemTotals(const char* input,
+                                               SubsystemMemoryTotals* output);
+
+// Replaces |output| with the subsystem totals of the last memory profile
+// dumped by a TraceMemoryController in this process. Returns false if no
+// profile has been dumped yet. May be called on any thread.
+BASE_EXPORT bool GetLastSubsystemMemoryTotals(SubsystemMemoryTotals* output);
+
 }  // namespace debug
 }  // namespace base
 
@@ -149,4 +175,15 @@ BASE_EXPORT bool AppendHeapProfileLineAsTraceFormat(const std::string& line,
 // visualizer skips them. Must match the value in heap.js.
 #define TRACE_MEMORY_IGNORE "trace-memory-ignore"
 
+// Prefix of the trace names that mark subsystems. See TRACE_MEMORY_SUBSYSTEM.
+#define TRACE_MEMORY_SUBSYSTEM_PREFIX "subsystem:"
+
+// Attributes the heap allocations made in the current scope to |subsystem|,
+// which must be a literal string, e.g. TRACE_MEMORY_SUBSYSTEM("net"). When
+// scopes nest, allocations go to the innermost subsystem. Does nothing unless
+// heap memory profiling is running.
+#define TRACE_MEMORY_SUBSYSTEM(subsystem) \
+  INTERNAL_TRACE_MEMORY(TRACE_DISABLED_BY_DEFAULT("memory"), \
+                        TRACE_MEMORY_SUBSYSTEM_PREFIX subsystem)
+
 #endif  // BASE_DEBUG_TRACE_EVENT_MEMORY_H_
@@ -63,6 +63,14 @@ TEST_F(TraceMemoryTest, TraceMemoryController) {
   message_loop.RunUntilIdle();
   EXPECT_FALSE(controller->IsTimerRunningForTest());
 
+  // Continuous profiling keeps running when tracing is disabled.
+  controller->StartContinuousProfiling();
+  message_loop.RunUntilIdle();
+  EXPECT_TRUE(controller->IsTimerRunningForTest());
+  controller->StopProfiling();
+  message_loop.RunUntilIdle();
+  EXPECT_TRUE(controller->IsTimerRunningForTest());
+
   // Deleting the observer removes it from the TraceLog observer list.
   controller.reset();
   EXPECT_EQ(0u, TraceLog::GetInstance()->GetObserverCountForTest());
@@ -207,5 +215,41 @@ TEST_F(TraceMemoryTest, AppendHeapProfileAsTraceFormat) {
   EXPECT_EQ(kExpectedOutput, output);
 }
 
+TEST_F(TraceMemoryTest, GetHeapProfileSubsystemTotals) {
+  // Empty input gives empty output.
+  SubsystemMemoryTotals empty_output;
+  GetHeapProfileSubsystemTotals("", &empty_output);
+  EXPECT_TRUE(empty_output.empty());
+
+  // Allocations go to the innermost subsystem of each stack, or to "other".
+  // Stacks under TRACE_MEMORY_IGNORE and stacks with no current allocations
+  // are skipped.
+  const char kNet[] = TRACE_MEMORY_SUBSYSTEM_PREFIX "net";
+  const char kHistory[] = TRACE_MEMORY_SUBSYSTEM_PREFIX "history";
+  const char kName[] = "name";
+  const char kIgnore[] = TRACE_MEMORY_IGNORE;
+  std::ostringstream input;
+  input << "heap profile:    357:    55227 [ 14653:  2624014] @ heapprofile\n"
+        << "   95:    40940 [   649:   114260] @\n"
+        << "   10:     1000 [    10:     1000] @ " << &kNet << "\n"
+        << "   20:     2000 [    20:     2000] @ " << &kNet << " " << &kName
+        << "\n"
+        << "   30:     3000 [    30:     3000] @ " << &kNet << " "
+        << &kHistory << " " << &kName << "\n"
+        << "   40:     4000 [    40:     4000] @ " << &kNet << " "
+        << &kIgnore << "\n"
+        << "    0:        0 [   132:     4236] @ " << &kHistory << "\n"
+        << "   77:    32546 [   742:   106234] @ 0x0 0x0\n"
+        << "\n"
+        << "MAPPED_LIBRARIES:\n"
+        << "1be411fc1000-1be4139e4000 rw-p 00000000 00:00 0\n";
+  SubsystemMemoryTotals output;
+  GetHeapProfileSubsystemTotals(input.str().c_str(), &output);
+  EXPECT_EQ(3u, output.size());
+  EXPECT_EQ(3000, output["net"]);
+  EXPECT_EQ(3000, output["history"]);
+  EXPECT_EQ(40940 + 32546, output["other"]);
+}
+
 }  // namespace debug
 }  // namespace base
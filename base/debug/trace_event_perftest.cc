@@ -0,0 +1,72 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/bind.h"
+#include "base/debug/trace_event.h"
+#include "base/memory/scoped_vector.h"
+#include "base/perftimer.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace debug {
+
+namespace {
+
+const int kEventsPerThread = 50000;
+
+void DiscardTraceData(const scoped_refptr<RefCountedString>& events_str) {
+}
+
+void AddTraceEvents(WaitableEvent* start, WaitableEvent* done) {
+  start->Wait();
+  for (int i = 0; i < kEventsPerThread; ++i)
+    TRACE_EVENT_INSTANT1("perf", "event", TRACE_EVENT_SCOPE_THREAD, "i", i);
+  done->Signal();
+}
+
+// Measures how many events per second each of |num_threads| threads manages
+// to record while they all trace at the same time.
+void RunAddTraceEventTest(int num_threads) {
+  TraceLog* trace_log = TraceLog::GetInstance();
+  trace_log->SetEnabled(CategoryFilter("perf"), TraceLog::RECORD_UNTIL_FULL);
+
+  WaitableEvent start(true, false);
+  ScopedVector<Thread> threads;
+  ScopedVector<WaitableEvent> done_events;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(new Thread(StringPrintf("Tracer%d", i)));
+    done_events.push_back(new WaitableEvent(false, false));
+    ASSERT_TRUE(threads.back()->Start());
+    threads.back()->message_loop()->PostTask(
+        FROM_HERE, Bind(&AddTraceEvents, &start, done_events.back()));
+  }
+
+  PerfTimer timer;
+  start.Signal();
+  for (int i = 0; i < num_threads; ++i)
+    done_events[i]->Wait();
+  TimeDelta elapsed = timer.Elapsed();
+
+  threads.clear();
+  trace_log->SetDisabled();
+  trace_log->Flush(Bind(&DiscardTraceData));
+
+  std::string name = StringPrintf("TraceEvent_AddTraceEvent_%d_threads",
+                                  num_threads);
+  LogPerfResult(name.c_str(), kEventsPerThread / elapsed.InSecondsF(),
+                "events/s/thread");
+}
+
+}  // namespace
+
+TEST(TraceEventPerfTest, AddTraceEvent) {
+  for (int threads = 1; threads <= 8; threads *= 2)
+    RunAddTraceEventTest(threads);
+}
+
+}  // namespace debug
+}  // namespace base
@@ -1353,6 +1353,41 @@ TEST_F(TraceEventTestFixture, DataCapturedManyThreads) {
                                            num_threads, num_events);
 }
 
+// Test that events still buffered by threads that are alive when tracing is
+// disabled end up in the trace.
+TEST_F(TraceEventTestFixture, DataCapturedOnLiveThreads) {
+  BeginTrace();
+
+  const int num_threads = 4;
+  // Deliberately not a multiple of the thread-local buffer size.
+  const int num_events = 1001;
+  Thread* threads[num_threads];
+  WaitableEvent* task_complete_events[num_threads];
+  for (int i = 0; i < num_threads; i++) {
+    threads[i] = new Thread(StringPrintf("Thread %d", i).c_str());
+    task_complete_events[i] = new WaitableEvent(false, false);
+    threads[i]->Start();
+    threads[i]->message_loop()->PostTask(
+        FROM_HERE, base::Bind(&TraceManyInstantEvents,
+                              i, num_events, task_complete_events[i]));
+  }
+
+  for (int i = 0; i < num_threads; i++) {
+    task_complete_events[i]->Wait();
+  }
+
+  EndTraceAndFlush();
+
+  for (int i = 0; i < num_threads; i++) {
+    threads[i]->Stop();
+    delete threads[i];
+    delete task_complete_events[i];
+  }
+
+  ValidateInstantEventPresentOnEveryThread(trace_parsed_,
+                                           num_threads, num_events);
+}
+
 // Test that thread and process names show up in the trace
 TEST_F(TraceEventTestFixture, ThreadNames) {
   // Create threads before we enable tracing to make sure
@@ -497,7 +497,7 @@ TEST_F(FilePathWatcherTest, MoveParent) {
   DeleteDelegateOnFileThread(subdir_delegate.release());
 }
 
-#if defined(OS_WIN)
+#if defined(OS_WIN) || defined(OS_LINUX) || defined(OS_ANDROID)
 TEST_F(FilePathWatcherTest, RecursiveWatch) {
   FilePathWatcher watcher;
   FilePath dir(temp_dir_.path().AppendASCII("dir"));
@@ -537,9 +537,11 @@ TEST_F(FilePathWatcherTest, RecursiveWatch) {
   ASSERT_TRUE(WriteFile(child_dir_file1, "content"));
   ASSERT_TRUE(WaitForEvents());
 
+#if defined(OS_WIN)
   // Modify "$dir/subdir/subdir_child_dir/child_dir_file1" attributes.
   ASSERT_TRUE(file_util::MakeFileUnreadable(child_dir_file1));
   ASSERT_TRUE(WaitForEvents());
+#endif
 
   // Delete "$dir/subdir/subdir_file1".
   ASSERT_TRUE(base::DeleteFile(subdir_file1, false));
@@ -548,6 +550,19 @@ TEST_F(FilePathWatcherTest, RecursiveWatch) {
   // Delete "$dir/subdir/subdir_child_dir/child_dir_file1".
   ASSERT_TRUE(base::DeleteFile(child_dir_file1, false));
   ASSERT_TRUE(WaitForEvents());
+
+  // Move "$dir/subdir" away, then create a new tree in its place and write
+  // into it, to check that the watches follow the tree.
+  FilePath moved_subdir(temp_dir_.path().AppendASCII("moved_subdir"));
+  ASSERT_TRUE(base::Move(subdir, moved_subdir));
+  ASSERT_TRUE(WaitForEvents());
+
+  FilePath new_child_dir(subdir.AppendASCII("new_child_dir"));
+  ASSERT_TRUE(file_util::CreateDirectory(new_child_dir));
+  ASSERT_TRUE(WaitForEvents());
+
+  ASSERT_TRUE(WriteFile(new_child_dir.AppendASCII("file"), "content"));
+  ASSERT_TRUE(WaitForEvents());
   DeleteDelegateOnFileThread(delegate.release());
 }
 #else
@@ -555,7 +570,7 @@ TEST_F(FilePathWatcherTest, RecursiveWatch) {
   FilePathWatcher watcher;
   FilePath dir(temp_dir_.path().AppendASCII("dir"));
   scoped_ptr<TestDelegate> delegate(new TestDelegate(collector()));
-  // Non-Windows implementaion does not support recursive watching.
+  // The kqueue implementation does not support recursive watching.
   ASSERT_FALSE(SetupWatch(dir, &watcher, delegate.get(), true));
   DeleteDelegateOnFileThread(delegate.release());
 }
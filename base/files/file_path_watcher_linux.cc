@@ -12,6 +12,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <map>
 #include <set>
 #include <utility>
 #include <vector>
@@ -19,6 +20,7 @@
 #include "base/bind.h"
 #include "base/containers/hash_tables.h"
 #include "base/file_util.h"
+#include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
 #include "base/lazy_instance.h"
 #include "base/location.h"
@@ -29,6 +31,8 @@
 #include "base/posix/eintr_wrapper.h"
 #include "base/synchronization/lock.h"
 #include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 
 namespace base {
 
@@ -36,6 +40,10 @@ namespace {
 
 class FilePathWatcherImpl;
 
+// Changes under a recursive watch are reported at most once per this interval,
+// since a single operation on a large tree can generate a flood of events.
+const int kRecursiveNotifyDelayMs = 50;
+
 // Singleton to manage all inotify watches.
 // TODO(tony): It would be nice if this wasn't a singleton.
 // http://crbug.com/38174
@@ -55,6 +63,10 @@ class InotifyReader {
   void OnInotifyEvent(const inotify_event* event);
 
  private:
+  // Tells every watcher that the kernel's event queue overflowed and events
+  // have been lost.
+  void OnQueueOverflow();
+
   friend struct ::base::DefaultLazyInstanceTraits<InotifyReader>;
 
   typedef std::set<FilePathWatcherImpl*> WatcherSet;
@@ -91,10 +103,15 @@ class FilePathWatcherImpl : public FilePathWatcher::PlatformDelegate,
   // Called for each event coming from the watch. |fired_watch| identifies the
   // watch that fired, |child| indicates what has changed, and is relative to
   // the currently watched path for |fired_watch|. The flag |created| is true if
-  // the object appears.
+  // the object appears, and |is_dir| is true if it is a directory.
   void OnFilePathChanged(InotifyReader::Watch fired_watch,
                          const FilePath::StringType& child,
-                         bool created);
+                         bool created,
+                         bool is_dir);
+
+  // Called when inotify dropped events. Rechecks all the watches, since any of
+  // them may have missed a change.
+  void OnQueueOverflow();
 
   // Start watching |path| for changes and notify |delegate| on each change.
   // Returns true if watch for |path| has been added successfully.
@@ -136,9 +153,30 @@ class FilePathWatcherImpl : public FilePathWatcher::PlatformDelegate,
   // that exists. Updates |watched_path_|. Returns true on success.
   bool UpdateWatches() WARN_UNUSED_RESULT;
 
+  // For recursive watches, brings the watches on |dir| and the directories
+  // below it in line with what is on disk. |dir| is |target_| or one of its
+  // descendants, and need not exist. Only that subtree is scanned.
+  void UpdateRecursiveWatches(const FilePath& dir);
+
+  // Starts, or updates, the recursive watch on the directory |path|.
+  void AddRecursiveWatch(const FilePath& path);
+
+  // Stops the recursive watch on |path|, if there is one.
+  void RemoveRecursiveWatch(const FilePath& path);
+
+  // Reports a change of |target_|. Changes under a recursive watch are
+  // coalesced, see kRecursiveNotifyDelayMs.
+  void ReportChange();
+
+  // Runs |callback_| for a change, unless the watch has been cancelled.
+  void RunCallback();
+
   // Callback to notify upon changes.
   FilePathWatcher::Callback callback_;
 
+  // Whether the directories below |target_| are watched too.
+  bool recursive_;
+
   // The file or directory we're supposed to watch.
   FilePath target_;
 
@@ -147,6 +185,16 @@ class FilePathWatcherImpl : public FilePathWatcher::PlatformDelegate,
   // |target_| and always stores an empty next component name in |subdir_|.
   WatchVector watches_;
 
+  // For recursive watches, the watches on the directories below |target_|,
+  // indexed both ways. |target_| itself is covered by |watches_|. The paths
+  // are kept sorted so that the directories below a path are a contiguous
+  // range.
+  base::hash_map<InotifyReader::Watch, FilePath> recursive_paths_by_watch_;
+  std::map<FilePath, InotifyReader::Watch> recursive_watches_by_path_;
+
+  // Pending coalesced report of a change under a recursive watch.
+  base::Timer notify_timer_;
+
   DISALLOW_COPY_AND_ASSIGN(FilePathWatcherImpl);
 };
 
@@ -282,24 +330,53 @@ void InotifyReader::OnInotifyEvent(const inotify_event* event) {
   if (event->mask & IN_IGNORED)
     return;
 
+  if (event->mask & IN_Q_OVERFLOW) {
+    OnQueueOverflow();
+    return;
+  }
+
   FilePath::StringType child(event->len ? event->name : FILE_PATH_LITERAL(""));
   base::AutoLock auto_lock(lock_);
 
-  for (WatcherSet::iterator watcher = watchers_[event->wd].begin();
-       watcher != watchers_[event->wd].end();
+  base::hash_map<Watch, WatcherSet>::iterator watchers =
+      watchers_.find(event->wd);
+  if (watchers == watchers_.end())
+    return;
+
+  for (WatcherSet::iterator watcher = watchers->second.begin();
+       watcher != watchers->second.end();
        ++watcher) {
     (*watcher)->OnFilePathChanged(event->wd,
                                   child,
-                                  event->mask & (IN_CREATE | IN_MOVED_TO));
+                                  event->mask & (IN_CREATE | IN_MOVED_TO),
+                                  event->mask & IN_ISDIR);
   }
 }
 
-FilePathWatcherImpl::FilePathWatcherImpl() {
+void InotifyReader::OnQueueOverflow() {
+  base::AutoLock auto_lock(lock_);
+
+  // A watcher usually has several watches, but should only recheck once.
+  WatcherSet all_watchers;
+  for (base::hash_map<Watch, WatcherSet>::iterator it = watchers_.begin();
+       it != watchers_.end(); ++it) {
+    all_watchers.insert(it->second.begin(), it->second.end());
+  }
+  for (WatcherSet::iterator watcher = all_watchers.begin();
+       watcher != all_watchers.end(); ++watcher) {
+    (*watcher)->OnQueueOverflow();
+  }
+}
+
+FilePathWatcherImpl::FilePathWatcherImpl()
+    : recursive_(false),
+      notify_timer_(false, false) {
 }
 
 void FilePathWatcherImpl::OnFilePathChanged(InotifyReader::Watch fired_watch,
                                             const FilePath::StringType& child,
-                                            bool created) {
+                                            bool created,
+                                            bool is_dir) {
   if (!message_loop()->BelongsToCurrentThread()) {
     // Switch to message_loop_ to access watches_ safely.
     message_loop()->PostTask(FROM_HERE,
@@ -307,11 +384,25 @@ void FilePathWatcherImpl::OnFilePathChanged(InotifyReader::Watch fired_watch,
                    this,
                    fired_watch,
                    child,
-                   created));
+                   created,
+                   is_dir));
     return;
   }
 
   DCHECK(MessageLoopForIO::current());
+  if (callback_.is_null())
+    return;
+
+  // A directory below |target_| changed. Only the subtree of a child
+  // directory that came or went needs its watches updated.
+  base::hash_map<InotifyReader::Watch, FilePath>::const_iterator recursive =
+      recursive_paths_by_watch_.find(fired_watch);
+  if (recursive != recursive_paths_by_watch_.end()) {
+    if (is_dir && !child.empty())
+      UpdateRecursiveWatches(recursive->second.Append(child));
+    ReportChange();
+    return;
+  }
 
   // Find the entry in |watches_| that corresponds to |fired_watch|.
   WatchVector::const_iterator watch_entry(watches_.begin());
@@ -341,6 +432,17 @@ void FilePathWatcherImpl::OnFilePathChanged(InotifyReader::Watch fired_watch,
         return;
       }
 
+      // For recursive watches, a directory coming or going inside |target_|
+      // only needs its own subtree rescanned.
+      if (recursive_) {
+        if (change_on_target_path) {
+          UpdateRecursiveWatches(target_);
+        } else if (is_dir && !child.empty() && watch_entry->subdir_.empty() &&
+                   watch_entry->linkname_.empty()) {
+          UpdateRecursiveWatches(target_.Append(child));
+        }
+      }
+
       // Report the following events:
       //  - The target or a direct child of the target got changed (in case the
       //    watched path refers to a directory).
@@ -352,7 +454,7 @@ void FilePathWatcherImpl::OnFilePathChanged(InotifyReader::Watch fired_watch,
       if (target_changed ||
           (change_on_target_path && !created) ||
           (change_on_target_path && PathExists(target_))) {
-        callback_.Run(target_, false);
+        ReportChange();
         return;
       }
     }
@@ -364,15 +466,11 @@ bool FilePathWatcherImpl::Watch(const FilePath& path,
                                 const FilePathWatcher::Callback& callback) {
   DCHECK(target_.empty());
   DCHECK(MessageLoopForIO::current());
-  if (recursive) {
-    // Recursive watch is not supported on this platform.
-    NOTIMPLEMENTED();
-    return false;
-  }
 
   set_message_loop(base::MessageLoopProxy::current().get());
   callback_ = callback;
   target_ = path;
+  recursive_ = recursive;
   MessageLoop::current()->AddDestructionObserver(this);
 
   std::vector<FilePath::StringType> comps;
@@ -384,7 +482,32 @@ bool FilePathWatcherImpl::Watch(const FilePath& path,
 
   watches_.push_back(WatchEntry(InotifyReader::kInvalidWatch,
                                 FilePath::StringType()));
-  return UpdateWatches();
+  if (!UpdateWatches())
+    return false;
+  if (recursive_)
+    UpdateRecursiveWatches(target_);
+  return true;
+}
+
+void FilePathWatcherImpl::OnQueueOverflow() {
+  if (!message_loop()->BelongsToCurrentThread()) {
+    message_loop()->PostTask(FROM_HERE,
+        base::Bind(&FilePathWatcherImpl::OnQueueOverflow, this));
+    return;
+  }
+
+  if (callback_.is_null())
+    return;
+
+  if (!UpdateWatches()) {
+    callback_.Run(target_, true /* error */);
+    return;
+  }
+  if (recursive_)
+    UpdateRecursiveWatches(target_);
+
+  // Whatever was lost may have been a change to |target_|.
+  ReportChange();
 }
 
 void FilePathWatcherImpl::Cancel() {
@@ -413,12 +536,22 @@ void FilePathWatcherImpl::CancelOnMessageLoopThread() {
     callback_.Reset();
   }
 
+  notify_timer_.Stop();
+
   for (WatchVector::iterator watch_entry(watches_.begin());
        watch_entry != watches_.end(); ++watch_entry) {
     if (watch_entry->watch_ != InotifyReader::kInvalidWatch)
       g_inotify_reader.Get().RemoveWatch(watch_entry->watch_, this);
   }
   watches_.clear();
+
+  for (base::hash_map<InotifyReader::Watch, FilePath>::iterator it =
+           recursive_paths_by_watch_.begin();
+       it != recursive_paths_by_watch_.end(); ++it) {
+    g_inotify_reader.Get().RemoveWatch(it->first, this);
+  }
+  recursive_paths_by_watch_.clear();
+  recursive_watches_by_path_.clear();
   target_.clear();
 }
 
@@ -478,6 +611,107 @@ bool FilePathWatcherImpl::UpdateWatches() {
   return true;
 }
 
+void FilePathWatcherImpl::UpdateRecursiveWatches(const FilePath& dir) {
+  DCHECK(recursive_);
+  DCHECK(dir == target_ || target_.IsParent(dir));
+
+  // Walk the directories at and below |dir|, watching each one before
+  // listing it, so that a directory created while the walk is going on is
+  // either listed or reported by the watch on its parent. |target_| itself is
+  // watched through |watches_|.
+  std::set<FilePath> found;
+  std::vector<FilePath> pending(1, dir);
+  while (!pending.empty()) {
+    FilePath current = pending.back();
+    pending.pop_back();
+    if (!DirectoryExists(current))
+      continue;
+    if (current != target_) {
+      AddRecursiveWatch(current);
+      found.insert(current);
+    }
+    // Symbolic links are not followed, which also keeps loops out.
+    FileEnumerator enumerator(
+        current, false,
+        FileEnumerator::DIRECTORIES | FileEnumerator::SHOW_SYM_LINKS);
+    for (FilePath child = enumerator.Next(); !child.empty();
+         child = enumerator.Next()) {
+      pending.push_back(child);
+    }
+  }
+
+  // Drop the watches of directories in the subtree that are gone. The paths
+  // below |dir| all start with |dir| and a separator, so they sort together,
+  // although not necessarily right after |dir| itself.
+  if (!found.count(dir))
+    RemoveRecursiveWatch(dir);
+  std::map<FilePath, InotifyReader::Watch>::iterator it =
+      recursive_watches_by_path_.lower_bound(dir.AsEndingWithSeparator());
+  while (it != recursive_watches_by_path_.end() && dir.IsParent(it->first)) {
+    const FilePath path = (it++)->first;
+    if (!found.count(path))
+      RemoveRecursiveWatch(path);
+  }
+}
+
+void FilePathWatcherImpl::AddRecursiveWatch(const FilePath& path) {
+  InotifyReader::Watch watch = g_inotify_reader.Get().AddWatch(path, this);
+  std::map<FilePath, InotifyReader::Watch>::iterator existing =
+      recursive_watches_by_path_.find(path);
+  if (existing != recursive_watches_by_path_.end()) {
+    if (existing->second == watch)
+      return;
+    // A different directory took the place of the one that was watched.
+    RemoveRecursiveWatch(path);
+  }
+  if (watch == InotifyReader::kInvalidWatch)
+    return;
+
+  // Adding a watch on a directory that is already watched returns its
+  // existing descriptor. If it is known under another path, the directory
+  // was moved there.
+  base::hash_map<InotifyReader::Watch, FilePath>::iterator moved =
+      recursive_paths_by_watch_.find(watch);
+  if (moved != recursive_paths_by_watch_.end())
+    recursive_watches_by_path_.erase(moved->second);
+  recursive_watches_by_path_[path] = watch;
+  recursive_paths_by_watch_[watch] = path;
+}
+
+void FilePathWatcherImpl::RemoveRecursiveWatch(const FilePath& path) {
+  std::map<FilePath, InotifyReader::Watch>::iterator it =
+      recursive_watches_by_path_.find(path);
+  if (it == recursive_watches_by_path_.end())
+    return;
+  InotifyReader::Watch watch = it->second;
+  recursive_watches_by_path_.erase(it);
+
+  // Leave the watch alone if the directory is now known by another path.
+  base::hash_map<InotifyReader::Watch, FilePath>::iterator by_watch =
+      recursive_paths_by_watch_.find(watch);
+  if (by_watch == recursive_paths_by_watch_.end() || by_watch->second != path)
+    return;
+  recursive_paths_by_watch_.erase(by_watch);
+  g_inotify_reader.Get().RemoveWatch(watch, this);
+}
+
+void FilePathWatcherImpl::ReportChange() {
+  if (!recursive_) {
+    callback_.Run(target_, false);
+    return;
+  }
+  if (!notify_timer_.IsRunning()) {
+    notify_timer_.Start(
+        FROM_HERE, TimeDelta::FromMilliseconds(kRecursiveNotifyDelayMs),
+        base::Bind(&FilePathWatcherImpl::RunCallback, this));
+  }
+}
+
+void FilePathWatcherImpl::RunCallback() {
+  if (!callback_.is_null())
+    callback_.Run(target_, false);
+}
+
 }  // namespace
 
 FilePathWatcher::FilePathWatcher() {
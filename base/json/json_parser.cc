@@ -212,25 +212,7 @@ Value* JSONParser::Parse(const StringPiece& input) {
   } else {
     start_pos_ = input.data();
   }
-  pos_ = start_pos_;
-  end_pos_ = start_pos_ + input.length();
-  index_ = 0;
-  line_number_ = 1;
-  index_last_line_ = 0;
-
-  error_code_ = JSONReader::JSON_NO_ERROR;
-  error_line_ = 0;
-  error_column_ = 0;
-
-  // When the input JSON string starts with a UTF-8 Byte-Order-Mark
-  // <0xEF 0xBB 0xBF>, advance the start position to avoid the
-  // ParseNextToken function mis-treating a Unicode BOM as an invalid
-  // character and returning NULL.
-  if (CanConsume(3) && static_cast<uint8>(*pos_) == 0xEF &&
-      static_cast<uint8>(*(pos_ + 1)) == 0xBB &&
-      static_cast<uint8>(*(pos_ + 2)) == 0xBF) {
-    NextNChars(3);
-  }
+  StartInput(start_pos_, input.length());
 
   // Parse the first and any nested tokens.
   scoped_ptr<Value> root(ParseNextToken());
@@ -238,12 +220,8 @@ Value* JSONParser::Parse(const StringPiece& input) {
     return NULL;
 
   // Make sure the input stream is at an end.
-  if (GetNextToken() != T_END_OF_INPUT) {
-    if (!CanConsume(1) || (NextChar() && GetNextToken() != T_END_OF_INPUT)) {
-      ReportError(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, 1);
-      return NULL;
-    }
-  }
+  if (!ConsumeEndOfInput())
+    return NULL;
 
   // Dictionaries and lists can contain JSONStringValues, so wrap them in a
   // hidden root.
@@ -264,6 +242,18 @@ Value* JSONParser::Parse(const StringPiece& input) {
   return root.release();
 }
 
+bool JSONParser::ParseWithDelegate(const StringPiece& input,
+                                   JSONStreamReader::Delegate* delegate) {
+  // Strings are handed to |delegate| as StringPieces that only need to live
+  // for the duration of the callback, so the input is never copied.
+  StartInput(input.data(), input.length());
+
+  if (!StreamNextToken(delegate))
+    return false;
+
+  return ConsumeEndOfInput();
+}
+
 JSONReader::JsonParseError JSONParser::error_code() const {
   return error_code_;
 }
@@ -336,6 +326,40 @@ const std::string& JSONParser::StringBuilder::AsString() {
 
 // JSONParser private //////////////////////////////////////////////////////////
 
+void JSONParser::StartInput(const char* start, size_t length) {
+  start_pos_ = start;
+  pos_ = start_pos_;
+  end_pos_ = start_pos_ + length;
+  index_ = 0;
+  stack_depth_ = 0;
+  line_number_ = 1;
+  index_last_line_ = 0;
+
+  error_code_ = JSONReader::JSON_NO_ERROR;
+  error_line_ = 0;
+  error_column_ = 0;
+
+  // When the input JSON string starts with a UTF-8 Byte-Order-Mark
+  // <0xEF 0xBB 0xBF>, advance the start position to avoid the
+  // ParseNextToken function mis-treating a Unicode BOM as an invalid
+  // character and returning NULL.
+  if (CanConsume(3) && static_cast<uint8>(*pos_) == 0xEF &&
+      static_cast<uint8>(*(pos_ + 1)) == 0xBB &&
+      static_cast<uint8>(*(pos_ + 2)) == 0xBF) {
+    NextNChars(3);
+  }
+}
+
+bool JSONParser::ConsumeEndOfInput() {
+  if (GetNextToken() != T_END_OF_INPUT) {
+    if (!CanConsume(1) || (NextChar() && GetNextToken() != T_END_OF_INPUT)) {
+      ReportError(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, 1);
+      return false;
+    }
+  }
+  return true;
+}
+
 inline bool JSONParser::CanConsume(int length) {
   return pos_ + length <= end_pos_;
 }
@@ -804,6 +828,24 @@ void JSONParser::DecodeUTF8(const int32& point, StringBuilder* dest) {
 }
 
 Value* JSONParser::ConsumeNumber() {
+  StringPiece num_string;
+  if (!ConsumeNumberRaw(&num_string))
+    return NULL;
+
+  int num_int;
+  if (StringToInt(num_string, &num_int))
+    return new FundamentalValue(num_int);
+
+  double num_double;
+  if (base::StringToDouble(num_string.as_string(), &num_double) &&
+      IsFinite(num_double)) {
+    return new FundamentalValue(num_double);
+  }
+
+  return NULL;
+}
+
+bool JSONParser::ConsumeNumberRaw(StringPiece* out) {
   const char* num_start = pos_;
   const int start_index = index_;
   int end_index = start_index;
@@ -813,7 +855,7 @@ Value* JSONParser::ConsumeNumber() {
 
   if (!ReadInt(false)) {
     ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-    return NULL;
+    return false;
   }
   end_index = index_;
 
@@ -821,12 +863,12 @@ Value* JSONParser::ConsumeNumber() {
   if (*pos_ == '.') {
     if (!CanConsume(1)) {
       ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-      return NULL;
+      return false;
     }
     NextChar();
     if (!ReadInt(true)) {
       ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-      return NULL;
+      return false;
     }
     end_index = index_;
   }
@@ -838,7 +880,7 @@ Value* JSONParser::ConsumeNumber() {
       NextChar();
     if (!ReadInt(true)) {
       ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-      return NULL;
+      return false;
     }
     end_index = index_;
   }
@@ -858,25 +900,14 @@ Value* JSONParser::ConsumeNumber() {
       break;
     default:
       ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-      return NULL;
+      return false;
   }
 
   pos_ = exit_pos;
   index_ = exit_index;
 
-  StringPiece num_string(num_start, end_index - start_index);
-
-  int num_int;
-  if (StringToInt(num_string, &num_int))
-    return new FundamentalValue(num_int);
-
-  double num_double;
-  if (base::StringToDouble(num_string.as_string(), &num_double) &&
-      IsFinite(num_double)) {
-    return new FundamentalValue(num_double);
-  }
-
-  return NULL;
+  out->set(num_start, end_index - start_index);
+  return true;
 }
 
 bool JSONParser::ReadInt(bool allow_leading_zeros) {
@@ -900,43 +931,175 @@ bool JSONParser::ReadInt(bool allow_leading_zeros) {
 
 Value* JSONParser::ConsumeLiteral() {
   switch (*pos_) {
-    case 't': {
-      const char* kTrueLiteral = "true";
-      const int kTrueLen = static_cast<int>(strlen(kTrueLiteral));
-      if (!CanConsume(kTrueLen - 1) ||
-          !StringsAreEqual(pos_, kTrueLiteral, kTrueLen)) {
-        ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-        return NULL;
+    case 't':
+      return ConsumeLiteralRaw("true") ? new FundamentalValue(true) : NULL;
+    case 'f':
+      return ConsumeLiteralRaw("false") ? new FundamentalValue(false) : NULL;
+    case 'n':
+      return ConsumeLiteralRaw("null") ? Value::CreateNullValue() : NULL;
+    default:
+      ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
+      return NULL;
+  }
+}
+
+bool JSONParser::ConsumeLiteralRaw(const char* literal) {
+  const int length = static_cast<int>(strlen(literal));
+  if (!CanConsume(length - 1) || !StringsAreEqual(pos_, literal, length)) {
+    ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+    return false;
+  }
+  NextNChars(length - 1);
+  return true;
+}
+
+bool JSONParser::StreamNextToken(JSONStreamReader::Delegate* delegate) {
+  return StreamToken(GetNextToken(), delegate);
+}
+
+bool JSONParser::StreamToken(Token token,
+                             JSONStreamReader::Delegate* delegate) {
+  switch (token) {
+    case T_OBJECT_BEGIN:
+      return StreamDictionary(delegate);
+    case T_ARRAY_BEGIN:
+      return StreamList(delegate);
+    case T_STRING: {
+      StringBuilder string;
+      if (!ConsumeStringRaw(&string))
+        return false;
+      if (string.CanBeStringPiece())
+        return delegate->OnString(string.AsStringPiece());
+      return delegate->OnString(string.AsString());
+    }
+    case T_NUMBER: {
+      StringPiece num_string;
+      if (!ConsumeNumberRaw(&num_string))
+        return false;
+
+      int num_int;
+      if (StringToInt(num_string, &num_int))
+        return delegate->OnInteger(num_int);
+
+      // Like ConsumeNumber, a number that is out of the range of a double
+      // fails the parse without further error information.
+      double num_double;
+      if (base::StringToDouble(num_string.as_string(), &num_double) &&
+          IsFinite(num_double)) {
+        return delegate->OnDouble(num_double);
       }
-      NextNChars(kTrueLen - 1);
-      return new FundamentalValue(true);
+      return false;
     }
-    case 'f': {
-      const char* kFalseLiteral = "false";
-      const int kFalseLen = static_cast<int>(strlen(kFalseLiteral));
-      if (!CanConsume(kFalseLen - 1) ||
-          !StringsAreEqual(pos_, kFalseLiteral, kFalseLen)) {
-        ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-        return NULL;
+    case T_BOOL_TRUE:
+      return ConsumeLiteralRaw("true") && delegate->OnBoolean(true);
+    case T_BOOL_FALSE:
+      return ConsumeLiteralRaw("false") && delegate->OnBoolean(false);
+    case T_NULL:
+      return ConsumeLiteralRaw("null") && delegate->OnNull();
+    default:
+      ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
+      return false;
+  }
+}
+
+bool JSONParser::StreamDictionary(JSONStreamReader::Delegate* delegate) {
+  if (*pos_ != '{') {
+    ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
+    return false;
+  }
+
+  StackMarker depth_check(&stack_depth_);
+  if (depth_check.IsTooDeep()) {
+    ReportError(JSONReader::JSON_TOO_MUCH_NESTING, 1);
+    return false;
+  }
+
+  if (!delegate->OnDictionaryBegin())
+    return false;
+
+  NextChar();
+  Token token = GetNextToken();
+  while (token != T_OBJECT_END) {
+    if (token != T_STRING) {
+      ReportError(JSONReader::JSON_UNQUOTED_DICTIONARY_KEY, 1);
+      return false;
+    }
+
+    StringBuilder key;
+    if (!ConsumeStringRaw(&key))
+      return false;
+    bool keep_going = key.CanBeStringPiece() ?
+        delegate->OnDictionaryKey(key.AsStringPiece()) :
+        delegate->OnDictionaryKey(key.AsString());
+    if (!keep_going)
+      return false;
+
+    NextChar();
+    token = GetNextToken();
+    if (token != T_OBJECT_PAIR_SEPARATOR) {
+      ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+      return false;
+    }
+
+    NextChar();
+    if (!StreamNextToken(delegate))
+      return false;
+
+    NextChar();
+    token = GetNextToken();
+    if (token == T_LIST_SEPARATOR) {
+      NextChar();
+      token = GetNextToken();
+      if (token == T_OBJECT_END && !(options_ & JSON_ALLOW_TRAILING_COMMAS)) {
+        ReportError(JSONReader::JSON_TRAILING_COMMA, 1);
+        return false;
       }
-      NextNChars(kFalseLen - 1);
-      return new FundamentalValue(false);
+    } else if (token != T_OBJECT_END) {
+      ReportError(JSONReader::JSON_SYNTAX_ERROR, 0);
+      return false;
     }
-    case 'n': {
-      const char* kNullLiteral = "null";
-      const int kNullLen = static_cast<int>(strlen(kNullLiteral));
-      if (!CanConsume(kNullLen - 1) ||
-          !StringsAreEqual(pos_, kNullLiteral, kNullLen)) {
-        ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-        return NULL;
+  }
+
+  return delegate->OnDictionaryEnd();
+}
+
+bool JSONParser::StreamList(JSONStreamReader::Delegate* delegate) {
+  if (*pos_ != '[') {
+    ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
+    return false;
+  }
+
+  StackMarker depth_check(&stack_depth_);
+  if (depth_check.IsTooDeep()) {
+    ReportError(JSONReader::JSON_TOO_MUCH_NESTING, 1);
+    return false;
+  }
+
+  if (!delegate->OnListBegin())
+    return false;
+
+  NextChar();
+  Token token = GetNextToken();
+  while (token != T_ARRAY_END) {
+    if (!StreamToken(token, delegate))
+      return false;
+
+    NextChar();
+    token = GetNextToken();
+    if (token == T_LIST_SEPARATOR) {
+      NextChar();
+      token = GetNextToken();
+      if (token == T_ARRAY_END && !(options_ & JSON_ALLOW_TRAILING_COMMAS)) {
+        ReportError(JSONReader::JSON_TRAILING_COMMA, 1);
+        return false;
       }
-      NextNChars(kNullLen - 1);
-      return Value::CreateNullValue();
+    } else if (token != T_ARRAY_END) {
+      ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+      return false;
     }
-    default:
-      ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
-      return NULL;
   }
+
+  return delegate->OnListEnd();
 }
 
 // static
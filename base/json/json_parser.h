@@ -11,6 +11,7 @@
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/json/json_reader.h"
+#include "base/json/json_stream_reader.h"
 #include "base/strings/string_piece.h"
 
 #if !defined(OS_CHROMEOS)
@@ -66,6 +67,12 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // result as a Value owned by the caller.
   Value* Parse(const StringPiece& input);
 
+  // Parses the input string according to the set options, reporting each
+  // token to |delegate| instead of building a Value. Returns false if the
+  // input is malformed or |delegate| stopped the parse.
+  bool ParseWithDelegate(const StringPiece& input,
+                         JSONStreamReader::Delegate* delegate);
+
   // Returns the error code.
   JSONReader::JsonParseError error_code() const;
 
@@ -143,6 +150,14 @@ class BASE_EXPORT_PRIVATE JSONParser {
     std::string* string_;
   };
 
+  // Winds the parser to the start of |length| bytes at |start|, resetting the
+  // position and error state and skipping over a UTF-8 byte-order mark.
+  void StartInput(const char* start, size_t length);
+
+  // Called after the root token has been consumed. Returns true if only
+  // whitespace and comments remain, and reports an error otherwise.
+  bool ConsumeEndOfInput();
+
   // Quick check that the stream has capacity to consume |length| more bytes.
   bool CanConsume(int length);
 
@@ -202,6 +217,10 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // Assuming that the parser is wound to the start of a valid JSON number,
   // this parses and converts it to either an int or double value.
   Value* ConsumeNumber();
+  // Validates the number the parser is wound to and stores its text in
+  // |out| without converting it. Returns false on failure with error
+  // information set.
+  bool ConsumeNumberRaw(StringPiece* out);
   // Helper that reads characters that are ints. Returns true if a number was
   // read and false on error.
   bool ReadInt(bool allow_leading_zeros);
@@ -209,6 +228,18 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // Consumes the literal values of |true|, |false|, and |null|, assuming the
   // parser is wound to the first character of any of those.
   Value* ConsumeLiteral();
+  // Consumes |literal|, which the parser must be wound to the first character
+  // of. Returns false on a mismatch with error information set.
+  bool ConsumeLiteralRaw(const char* literal);
+
+  // The streaming counterparts of ParseNextToken, ParseToken,
+  // ConsumeDictionary and ConsumeList. They share the tokenizer and Consume
+  // invariants above, but report to |delegate| instead of building Values.
+  // They return false on error or when |delegate| asks to stop.
+  bool StreamNextToken(JSONStreamReader::Delegate* delegate);
+  bool StreamToken(Token token, JSONStreamReader::Delegate* delegate);
+  bool StreamDictionary(JSONStreamReader::Delegate* delegate);
+  bool StreamList(JSONStreamReader::Delegate* delegate);
 
   // Compares two string buffers of a given length.
   static bool StringsAreEqual(const char* left, const char* right, size_t len);
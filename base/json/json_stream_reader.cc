@@ -0,0 +1,202 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/json/json_stream_reader.h"
+
+#include <vector>
+
+#include "base/json/json_parser.h"
+#include "base/logging.h"
+#include "base/values.h"
+
+namespace base {
+
+namespace {
+
+// Builds Values for the selected members of a root dictionary. Nesting inside
+// the members that are not selected is only counted, so skipping them does
+// not allocate.
+class DictionaryMemberCollector : public JSONStreamReader::Delegate {
+ public:
+  DictionaryMemberCollector(const std::set<std::string>& keys,
+                            DictionaryValue* output)
+      : keys_(keys),
+        output_(output),
+        skip_member_(false),
+        skip_depth_(0) {
+  }
+  virtual ~DictionaryMemberCollector() {}
+
+  // JSONStreamReader::Delegate:
+  virtual bool OnDictionaryBegin() OVERRIDE {
+    if (containers_.empty()) {
+      containers_.push_back(output_);
+      return true;
+    }
+    if (IsSkipping()) {
+      ++skip_depth_;
+      return true;
+    }
+    DictionaryValue* dictionary = new DictionaryValue;
+    AddValue(dictionary);
+    containers_.push_back(dictionary);
+    return true;
+  }
+
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+    if (skip_depth_ > 0)
+      return true;
+    if (containers_.size() == 1) {
+      key.CopyToString(&key_);
+      skip_member_ = keys_.find(key_) == keys_.end();
+      return true;
+    }
+    if (!IsSkipping())
+      key.CopyToString(&key_);
+    return true;
+  }
+
+  virtual bool OnDictionaryEnd() OVERRIDE {
+    return EndContainer();
+  }
+
+  virtual bool OnListBegin() OVERRIDE {
+    // The root must be a dictionary.
+    if (containers_.empty())
+      return false;
+    if (IsSkipping()) {
+      ++skip_depth_;
+      return true;
+    }
+    ListValue* list = new ListValue;
+    AddValue(list);
+    containers_.push_back(list);
+    return true;
+  }
+
+  virtual bool OnListEnd() OVERRIDE {
+    return EndContainer();
+  }
+
+  virtual bool OnString(const StringPiece& value) OVERRIDE {
+    if (containers_.empty())
+      return false;
+    if (!IsSkipping())
+      AddValue(new StringValue(value.as_string()));
+    return true;
+  }
+
+  virtual bool OnInteger(int value) OVERRIDE {
+    if (containers_.empty())
+      return false;
+    if (!IsSkipping())
+      AddValue(new FundamentalValue(value));
+    return true;
+  }
+
+  virtual bool OnDouble(double value) OVERRIDE {
+    if (containers_.empty())
+      return false;
+    if (!IsSkipping())
+      AddValue(new FundamentalValue(value));
+    return true;
+  }
+
+  virtual bool OnBoolean(bool value) OVERRIDE {
+    if (containers_.empty())
+      return false;
+    if (!IsSkipping())
+      AddValue(new FundamentalValue(value));
+    return true;
+  }
+
+  virtual bool OnNull() OVERRIDE {
+    if (containers_.empty())
+      return false;
+    if (!IsSkipping())
+      AddValue(Value::CreateNullValue());
+    return true;
+  }
+
+ private:
+  // Whether the current token belongs to a member that was not selected.
+  bool IsSkipping() const {
+    return skip_depth_ > 0 || (containers_.size() == 1 && skip_member_);
+  }
+
+  bool EndContainer() {
+    if (skip_depth_ > 0) {
+      --skip_depth_;
+      return true;
+    }
+    DCHECK(!containers_.empty());
+    containers_.pop_back();
+    return true;
+  }
+
+  // Adds |value| to the innermost container being built, which takes
+  // ownership.
+  void AddValue(Value* value) {
+    Value* container = containers_.back();
+    if (container->IsType(Value::TYPE_DICTIONARY)) {
+      static_cast<DictionaryValue*>(container)->SetWithoutPathExpansion(
+          key_, value);
+    } else {
+      static_cast<ListValue*>(container)->Append(value);
+    }
+  }
+
+  const std::set<std::string>& keys_;
+  DictionaryValue* output_;
+
+  // The containers being built, starting with |output_|. Weak; each one is
+  // owned by the previous.
+  std::vector<Value*> containers_;
+
+  // The key of the dictionary member whose value comes next.
+  std::string key_;
+
+  // Whether the current member of the root is not selected.
+  bool skip_member_;
+
+  // How many containers deep the parser is inside a member that is not
+  // selected.
+  int skip_depth_;
+
+  DISALLOW_COPY_AND_ASSIGN(DictionaryMemberCollector);
+};
+
+}  // namespace
+
+JSONStreamReader::JSONStreamReader(int options)
+    : parser_(new internal::JSONParser(options)) {
+}
+
+JSONStreamReader::~JSONStreamReader() {
+}
+
+bool JSONStreamReader::Read(const StringPiece& json, Delegate* delegate) {
+  return parser_->ParseWithDelegate(json, delegate);
+}
+
+// static
+bool JSONStreamReader::ReadDictionaryMembers(
+    const StringPiece& json,
+    int options,
+    const std::set<std::string>& keys,
+    DictionaryValue* output) {
+  DictionaryMemberCollector collector(keys, output);
+  internal::JSONParser parser(options);
+  return parser.ParseWithDelegate(json, &collector);
+}
+
+JSONReader::JsonParseError JSONStreamReader::error_code() const {
+  return parser_->error_code();
+}
+
+std::string JSONStreamReader::GetErrorMessage() const {
+  return parser_->GetErrorMessage();
+}
+
+}  // namespace base
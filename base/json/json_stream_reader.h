@@ -0,0 +1,103 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// An event-driven JSON parser. Where JSONReader builds a Value tree for the
+// whole input, JSONStreamReader reports the input token by token to a
+// Delegate, in document order, and keeps nothing once a token has been
+// reported. Both share the same tokenizer, so they accept exactly the same
+// inputs and report the same errors; see json_reader.h for the deviations
+// from the RFC.
+//
+// This is meant for large inputs of which only a small part is needed, where
+// allocating a Value for every node would dominate the cost of parsing.
+
+#ifndef BASE_JSON_JSON_STREAM_READER_H_
+#define BASE_JSON_JSON_STREAM_READER_H_
+
+#include <set>
+#include <string>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/json/json_reader.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/string_piece.h"
+
+namespace base {
+class DictionaryValue;
+
+namespace internal {
+class JSONParser;
+}
+
+class BASE_EXPORT JSONStreamReader {
+ public:
+  // Receives the tokens of the input. Every method returns true to continue
+  // parsing or false to stop it, in which case Read() returns false without
+  // setting an error. The StringPieces passed in are only valid for the
+  // duration of the call.
+  class BASE_EXPORT Delegate {
+   public:
+    // A dictionary is reported as OnDictionaryBegin(), then an
+    // OnDictionaryKey() followed by the events of the value for each member,
+    // then OnDictionaryEnd().
+    virtual bool OnDictionaryBegin() = 0;
+    virtual bool OnDictionaryKey(const StringPiece& key) = 0;
+    virtual bool OnDictionaryEnd() = 0;
+
+    // A list is reported as OnListBegin(), the events of each element, then
+    // OnListEnd().
+    virtual bool OnListBegin() = 0;
+    virtual bool OnListEnd() = 0;
+
+    virtual bool OnString(const StringPiece& value) = 0;
+    virtual bool OnInteger(int value) = 0;
+    virtual bool OnDouble(double value) = 0;
+    virtual bool OnBoolean(bool value) = 0;
+    virtual bool OnNull() = 0;
+
+   protected:
+    virtual ~Delegate() {}
+  };
+
+  // Constructs a reader with the given JSONParserOptions.
+  // JSON_DETACHABLE_CHILDREN has no effect since no Values are built.
+  explicit JSONStreamReader(int options);
+  ~JSONStreamReader();
+
+  // Parses |json|, reporting its tokens to |delegate|. Returns true if the
+  // whole input was parsed. Returns false if |json| is not properly formed,
+  // in which case error_code() and GetErrorMessage() describe the problem,
+  // or if |delegate| stopped the parse, in which case error_code() is
+  // JSON_NO_ERROR. In both cases |delegate| may already have seen part of the
+  // input.
+  bool Read(const StringPiece& json, Delegate* delegate);
+
+  // Parses |json|, whose root must be a dictionary, and copies into |output|
+  // the members whose key is in |keys|. All other members are tokenized and
+  // skipped without building any Value. Returns false if |json| is not
+  // properly formed or its root is not a dictionary; |output| may have been
+  // partially filled in that case.
+  static bool ReadDictionaryMembers(const StringPiece& json,
+                                    int options,
+                                    const std::set<std::string>& keys,
+                                    DictionaryValue* output);
+
+  // Returns the error code if the last call to Read() failed.
+  // Returns JSON_NO_ERROR otherwise.
+  JSONReader::JsonParseError error_code() const;
+
+  // Converts error_code() to a human-readable string, including line and
+  // column numbers if appropriate.
+  std::string GetErrorMessage() const;
+
+ private:
+  scoped_ptr<internal::JSONParser> parser_;
+
+  DISALLOW_COPY_AND_ASSIGN(JSONStreamReader);
+};
+
+}  // namespace base
+
+#endif  // BASE_JSON_JSON_STREAM_READER_H_
@@ -0,0 +1,144 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/json/json_reader.h"
+#include "base/json/json_stream_reader.h"
+#include "base/json/json_value_converter.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "base/strings/stringprintf.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const int kNumItems = 40000;
+const int kIterations = 5;
+
+// The small part of the generated document that callers care about.
+struct Header {
+  int version;
+  std::string name;
+
+  Header() : version(0) {}
+
+  static void RegisterJSONConverter(JSONValueConverter<Header>* converter) {
+    converter->RegisterIntField("version", &Header::version);
+    converter->RegisterStringField("name", &Header::name);
+  }
+};
+
+// Returns a document of a few megabytes: a small header followed by a large
+// list of records.
+std::string GenerateDocument() {
+  std::string json("{\"version\": 3, \"name\": \"perftest\", \"items\": [");
+  for (int i = 0; i < kNumItems; ++i) {
+    if (i)
+      json.push_back(',');
+    StringAppendF(&json,
+                  "{\"id\": %d, \"title\": \"Item number %d\", "
+                  "\"score\": %d.25, \"enabled\": %s, \"tags\": "
+                  "[\"alpha\", \"beta\", \"gamma\\u00e9\"], \"parent\": null}",
+                  i, i, i, i % 2 ? "true" : "false");
+  }
+  json.append("]}");
+  return json;
+}
+
+// Counts tokens without keeping anything.
+class CountingDelegate : public JSONStreamReader::Delegate {
+ public:
+  CountingDelegate() : count_(0) {}
+  virtual ~CountingDelegate() {}
+
+  int count() const { return count_; }
+
+  // JSONStreamReader::Delegate:
+  virtual bool OnDictionaryBegin() OVERRIDE { return Count(); }
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+    return Count();
+  }
+  virtual bool OnDictionaryEnd() OVERRIDE { return Count(); }
+  virtual bool OnListBegin() OVERRIDE { return Count(); }
+  virtual bool OnListEnd() OVERRIDE { return Count(); }
+  virtual bool OnString(const StringPiece& value) OVERRIDE { return Count(); }
+  virtual bool OnInteger(int value) OVERRIDE { return Count(); }
+  virtual bool OnDouble(double value) OVERRIDE { return Count(); }
+  virtual bool OnBoolean(bool value) OVERRIDE { return Count(); }
+  virtual bool OnNull() OVERRIDE { return Count(); }
+
+ private:
+  bool Count() {
+    ++count_;
+    return true;
+  }
+
+  int count_;
+};
+
+void LogThroughput(const char* name, size_t bytes, const TimeDelta& elapsed) {
+  LogPerfResult(name,
+                bytes * kIterations / (1024.0 * 1024.0) / elapsed.InSecondsF(),
+                "MB/s");
+}
+
+}  // namespace
+
+TEST(JSONStreamReaderPerfTest, Parse) {
+  const std::string json = GenerateDocument();
+  LogPerfResult("JSON_document_size", json.size() / 1024.0, "kb");
+
+  {
+    PerfTimer timer;
+    for (int i = 0; i < kIterations; ++i) {
+      scoped_ptr<Value> value(JSONReader::Read(json));
+      ASSERT_TRUE(value.get());
+    }
+    LogThroughput("JSONReader_Read", json.size(), timer.Elapsed());
+  }
+
+  {
+    PerfTimer timer;
+    for (int i = 0; i < kIterations; ++i) {
+      JSONStreamReader reader(JSON_PARSE_RFC);
+      CountingDelegate delegate;
+      ASSERT_TRUE(reader.Read(json, &delegate));
+      ASSERT_LT(kNumItems, delegate.count());
+    }
+    LogThroughput("JSONStreamReader_Read", json.size(), timer.Elapsed());
+  }
+}
+
+TEST(JSONStreamReaderPerfTest, Convert) {
+  const std::string json = GenerateDocument();
+  JSONValueConverter<Header> converter;
+
+  {
+    PerfTimer timer;
+    for (int i = 0; i < kIterations; ++i) {
+      scoped_ptr<Value> value(JSONReader::Read(json));
+      Header header;
+      ASSERT_TRUE(value.get() && converter.Convert(*value, &header));
+      ASSERT_EQ(3, header.version);
+    }
+    LogThroughput("JSONValueConverter_Convert", json.size(), timer.Elapsed());
+  }
+
+  {
+    PerfTimer timer;
+    for (int i = 0; i < kIterations; ++i) {
+      Header header;
+      ASSERT_TRUE(converter.ConvertFromJSON(json, &header));
+      ASSERT_EQ(3, header.version);
+    }
+    LogThroughput("JSONValueConverter_ConvertFromJSON", json.size(),
+                  timer.Elapsed());
+  }
+}
+
+}  // namespace base
@@ -0,0 +1,164 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/json/json_stream_reader.h"
+
+#include <set>
+#include <string>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+// Records the events it receives as a compact string, optionally stopping
+// the parse after a given number of them.
+class RecordingDelegate : public JSONStreamReader::Delegate {
+ public:
+  explicit RecordingDelegate(int max_events)
+      : max_events_(max_events),
+        num_events_(0) {
+  }
+  virtual ~RecordingDelegate() {}
+
+  const std::string& events() const { return events_; }
+
+  // JSONStreamReader::Delegate:
+  virtual bool OnDictionaryBegin() OVERRIDE { return Record("{"); }
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+    return Record(key.as_string() + ":");
+  }
+  virtual bool OnDictionaryEnd() OVERRIDE { return Record("}"); }
+  virtual bool OnListBegin() OVERRIDE { return Record("["); }
+  virtual bool OnListEnd() OVERRIDE { return Record("]"); }
+  virtual bool OnString(const StringPiece& value) OVERRIDE {
+    return Record("s(" + value.as_string() + ")");
+  }
+  virtual bool OnInteger(int value) OVERRIDE {
+    return Record("i(" + IntToString(value) + ")");
+  }
+  virtual bool OnDouble(double value) OVERRIDE {
+    return Record("d(" + DoubleToString(value) + ")");
+  }
+  virtual bool OnBoolean(bool value) OVERRIDE {
+    return Record(value ? "true" : "false");
+  }
+  virtual bool OnNull() OVERRIDE { return Record("null"); }
+
+ private:
+  bool Record(const std::string& event) {
+    if (!events_.empty())
+      events_.push_back(' ');
+    events_.append(event);
+    return ++num_events_ != max_events_;
+  }
+
+  const int max_events_;
+  int num_events_;
+  std::string events_;
+};
+
+}  // namespace
+
+TEST(JSONStreamReaderTest, Events) {
+  JSONStreamReader reader(JSON_PARSE_RFC);
+  RecordingDelegate delegate(-1);
+  EXPECT_TRUE(reader.Read(
+      "{\"a\": [1, -2.5, \"x\\ty\"], \"b\": {\"c\": true, \"d\": null},"
+      " \"e\": false, \"f\": []}",
+      &delegate));
+  EXPECT_EQ(JSONReader::JSON_NO_ERROR, reader.error_code());
+  EXPECT_EQ("{ a: [ i(1) d(-2.5) s(x\ty) ] b: { c: true d: null } "
+            "e: false f: [ ] }",
+            delegate.events());
+}
+
+TEST(JSONStreamReaderTest, Scalars) {
+  JSONStreamReader reader(JSON_PARSE_RFC);
+  {
+    RecordingDelegate delegate(-1);
+    EXPECT_TRUE(reader.Read("  \"\\u00e9\"  ", &delegate));
+    EXPECT_EQ("s(\xC3\xA9)", delegate.events());
+  }
+  {
+    RecordingDelegate delegate(-1);
+    EXPECT_TRUE(reader.Read("\xEF\xBB\xBF" "42 // comment", &delegate));
+    EXPECT_EQ("i(42)", delegate.events());
+  }
+}
+
+TEST(JSONStreamReaderTest, Errors) {
+  JSONStreamReader reader(JSON_PARSE_RFC);
+  RecordingDelegate delegate(-1);
+  EXPECT_FALSE(reader.Read("[1, 2,]", &delegate));
+  EXPECT_EQ(JSONReader::JSON_TRAILING_COMMA, reader.error_code());
+  EXPECT_FALSE(reader.GetErrorMessage().empty());
+
+  EXPECT_FALSE(reader.Read("{foo: 1}", &delegate));
+  EXPECT_EQ(JSONReader::JSON_UNQUOTED_DICTIONARY_KEY, reader.error_code());
+
+  EXPECT_FALSE(reader.Read("[1] 2", &delegate));
+  EXPECT_EQ(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, reader.error_code());
+
+  EXPECT_FALSE(reader.Read(std::string(200, '[') + std::string(200, ']'),
+                           &delegate));
+  EXPECT_EQ(JSONReader::JSON_TOO_MUCH_NESTING, reader.error_code());
+
+  JSONStreamReader relaxed_reader(JSON_ALLOW_TRAILING_COMMAS);
+  EXPECT_TRUE(relaxed_reader.Read("[1, 2,]", &delegate));
+}
+
+TEST(JSONStreamReaderTest, DelegateStops) {
+  JSONStreamReader reader(JSON_PARSE_RFC);
+  RecordingDelegate delegate(3);
+  EXPECT_FALSE(reader.Read("[1, 2, 3, 4]", &delegate));
+  EXPECT_EQ(JSONReader::JSON_NO_ERROR, reader.error_code());
+  EXPECT_EQ("[ i(1) i(2)", delegate.events());
+}
+
+TEST(JSONStreamReaderTest, ReadDictionaryMembers) {
+  std::set<std::string> keys;
+  keys.insert("wanted");
+  keys.insert("also_wanted");
+  keys.insert("missing");
+
+  DictionaryValue dictionary;
+  EXPECT_TRUE(JSONStreamReader::ReadDictionaryMembers(
+      "{\"skipped\": {\"wanted\": [1, {\"x\": 2}]},"
+      " \"wanted\": {\"list\": [1, \"two\", [null]], \"dict\": {\"y\": 3}},"
+      " \"also_skipped\": [[], {}],"
+      " \"also_wanted\": 4.5}",
+      JSON_PARSE_RFC, keys, &dictionary));
+
+  EXPECT_EQ(2U, dictionary.size());
+  EXPECT_FALSE(dictionary.HasKey("skipped"));
+  EXPECT_FALSE(dictionary.HasKey("also_skipped"));
+  double also_wanted = 0;
+  EXPECT_TRUE(dictionary.GetDouble("also_wanted", &also_wanted));
+  EXPECT_EQ(4.5, also_wanted);
+
+  const ListValue* list = NULL;
+  ASSERT_TRUE(dictionary.GetList("wanted.list", &list));
+  ASSERT_EQ(3U, list->GetSize());
+  std::string two;
+  EXPECT_TRUE(list->GetString(1, &two));
+  EXPECT_EQ("two", two);
+  int y = 0;
+  EXPECT_TRUE(dictionary.GetInteger("wanted.dict.y", &y));
+  EXPECT_EQ(3, y);
+
+  // The root has to be a dictionary.
+  DictionaryValue failed;
+  EXPECT_FALSE(JSONStreamReader::ReadDictionaryMembers(
+      "[{\"wanted\": 1}]", JSON_PARSE_RFC, keys, &failed));
+  EXPECT_FALSE(JSONStreamReader::ReadDictionaryMembers(
+      "\"wanted\"", JSON_PARSE_RFC, keys, &failed));
+  EXPECT_FALSE(JSONStreamReader::ReadDictionaryMembers(
+      "{\"wanted\": 1", JSON_PARSE_RFC, keys, &failed));
+}
+
+}  // namespace base
@@ -5,10 +5,12 @@
 #ifndef BASE_JSON_JSON_VALUE_CONVERTER_H_
 #define BASE_JSON_JSON_VALUE_CONVERTER_H_
 
+#include <set>
 #include <string>
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/json/json_stream_reader.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/scoped_vector.h"
@@ -46,6 +48,11 @@
 //   JSONValueConverter<Message> converter;
 //   converter.Convert(json, &message);
 //
+// If you start from a JSON string rather than a Value, ConvertFromJSON() parses
+// it with JSONStreamReader and only builds Values for the registered fields,
+// which is much cheaper when the input holds a lot of other data.
+//   converter.ConvertFromJSON(json_string, &message);
+//
 // Convert() returns false when it fails.  Here "fail" means that the value is
 // structurally different from expected, such like a string value appears
 // for an int field.  Do not report failures for missing fields.
@@ -516,6 +523,27 @@ class JSONValueConverter {
     return true;
   }
 
+  // Parses |json| and converts it like Convert(). Only the members of the
+  // root dictionary that hold registered fields are turned into Values; the
+  // rest of the input is skipped while it is parsed. Returns false if |json|
+  // is not a properly formed JSON dictionary or Convert() fails.
+  bool ConvertFromJSON(const StringPiece& json, StructType* output) const {
+    std::set<std::string> keys;
+    for (size_t i = 0; i < fields_.size(); ++i) {
+      // Field paths are expanded by Convert(), so keep the whole root member
+      // a dotted path starts with.
+      const std::string& path = fields_[i]->field_path();
+      keys.insert(path.substr(0, path.find('.')));
+    }
+
+    DictionaryValue dictionary;
+    if (!JSONStreamReader::ReadDictionaryMembers(json, JSON_PARSE_RFC, keys,
+                                                 &dictionary)) {
+      return false;
+    }
+    return Convert(dictionary, output);
+  }
+
  private:
   ScopedVector<internal::FieldConverterBase<StructType> > fields_;
 
@@ -253,4 +253,37 @@ TEST(JSONValueConverterTest, RepeatedValueErrorInTheMiddle) {
   // No check the values as mentioned above.
 }
 
+TEST(JSONValueConverterTest, ConvertFromJSON) {
+  const char normal_data[] =
+      "{\n"
+      "  \"foo\": 1.0,\n"
+      "  \"unused\": {\"deep\": [1, 2, {\"bar\": \"unused\"}]},\n"
+      "  \"child\": {\n"
+      "    \"foo\": 1,\n"
+      "    \"bar\": \"bar\",\n"
+      "    \"extra\": [true, null],\n"
+      "    \"baz\": true\n"
+      "  },\n"
+      "  \"children\": [{\"foo\": 2, \"bar\": \"foobar\"}]\n"
+      "}\n";
+
+  NestedMessage message;
+  base::JSONValueConverter<NestedMessage> converter;
+  EXPECT_TRUE(converter.ConvertFromJSON(normal_data, &message));
+
+  EXPECT_EQ(1.0, message.foo);
+  EXPECT_EQ(1, message.child.foo);
+  EXPECT_EQ("bar", message.child.bar);
+  EXPECT_TRUE(message.child.baz);
+  ASSERT_EQ(1U, message.children.size());
+  EXPECT_EQ(2, message.children[0]->foo);
+  EXPECT_EQ("foobar", message.children[0]->bar);
+
+  // Malformed input and non-dictionary roots fail.
+  NestedMessage failed;
+  EXPECT_FALSE(converter.ConvertFromJSON("{\"foo\": 1.0,", &failed));
+  EXPECT_FALSE(converter.ConvertFromJSON("[{\"foo\": 1.0}]", &failed));
+  EXPECT_FALSE(converter.ConvertFromJSON("{\"foo\": \"bar\"}", &failed));
+}
+
 }  // namespace base
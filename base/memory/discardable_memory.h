@@ -8,6 +8,7 @@
 #include "base/base_export.h"
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "build/build_config.h"
 
 namespace base {
 
@@ -103,12 +104,25 @@ class BASE_EXPORT DiscardableMemory {
   void ReleaseFileDescriptor();
 #endif  // OS_ANDROID
 
+#if defined(OS_LINUX)
+  // Discards the pages of unlocked memory, least recently unlocked first,
+  // until no more than |bytes| of unlocked memory are left.
+  static void PurgeUnlockedMemory(size_t bytes);
+#endif  // OS_LINUX
+
   void* memory_;
   size_t size_;
   bool is_locked_;
 #if defined(OS_ANDROID)
   int fd_;
 #endif  // OS_ANDROID
+#if defined(OS_LINUX)
+  // True if the pages were discarded while the memory was unlocked.
+  bool is_purged_;
+  // The order in which the memory was unlocked, which is the order it gets
+  // purged in. Zero while it is locked.
+  uint64 unlock_sequence_;
+#endif  // OS_LINUX
 
   DISALLOW_COPY_AND_ASSIGN(DiscardableMemory);
 };
@@ -0,0 +1,141 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/discardable_memory.h"
+
+#include <sys/mman.h>
+
+#include <map>
+
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/synchronization/lock.h"
+
+// The kernel has no way to hand memory back to the process and say later
+// whether it took it, so the process keeps its own budget of unlocked memory.
+// Unlocking memory past the budget discards the pages of the memory that was
+// unlocked longest ago with MADV_DONTNEED, which gives them back to the system
+// right away. The mapping stays in place, and reads as zeros once the memory
+// is locked again.
+
+namespace {
+
+// Unlocked memory beyond this is purged.
+const size_t kMaxUnlockedBytes = 64 * 1024 * 1024;
+
+struct UnlockedMemory {
+  UnlockedMemory() : bytes(0), next_sequence(1) {}
+
+  base::Lock lock;
+  // Unlocked memory, by the order it was unlocked in.
+  std::map<uint64, base::DiscardableMemory*> by_sequence;
+  size_t bytes;
+  uint64 next_sequence;
+};
+
+base::LazyInstance<UnlockedMemory>::Leaky g_unlocked_memory =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+namespace base {
+
+// static
+bool DiscardableMemory::Supported() {
+  return true;
+}
+
+DiscardableMemory::~DiscardableMemory() {
+  if (!memory_)
+    return;
+  if (!is_locked_) {
+    UnlockedMemory* unlocked = g_unlocked_memory.Pointer();
+    AutoLock lock(unlocked->lock);
+    if (unlock_sequence_) {
+      unlocked->by_sequence.erase(unlock_sequence_);
+      unlocked->bytes -= size_;
+    }
+  }
+  if (munmap(memory_, size_) != 0)
+    DPLOG(ERROR) << "Failed to unmap memory.";
+}
+
+bool DiscardableMemory::InitializeAndLock(size_t size) {
+  DCHECK(!memory_);
+  void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    DLOG(ERROR) << "mmap() failed";
+    return false;
+  }
+
+  memory_ = memory;
+  size_ = size;
+  is_locked_ = true;
+  return true;
+}
+
+LockDiscardableMemoryStatus DiscardableMemory::Lock() {
+  DCHECK(!is_locked_);
+
+  UnlockedMemory* unlocked = g_unlocked_memory.Pointer();
+  AutoLock lock(unlocked->lock);
+  if (unlock_sequence_) {
+    unlocked->by_sequence.erase(unlock_sequence_);
+    unlocked->bytes -= size_;
+    unlock_sequence_ = 0;
+  }
+
+  is_locked_ = true;
+  if (is_purged_) {
+    is_purged_ = false;
+    return DISCARDABLE_MEMORY_PURGED;
+  }
+  return DISCARDABLE_MEMORY_SUCCESS;
+}
+
+void DiscardableMemory::Unlock() {
+  DCHECK(is_locked_);
+
+  UnlockedMemory* unlocked = g_unlocked_memory.Pointer();
+  AutoLock lock(unlocked->lock);
+  unlock_sequence_ = unlocked->next_sequence++;
+  unlocked->by_sequence[unlock_sequence_] = this;
+  unlocked->bytes += size_;
+  is_locked_ = false;
+
+  if (unlocked->bytes > kMaxUnlockedBytes)
+    PurgeUnlockedMemory(kMaxUnlockedBytes);
+}
+
+// static
+void DiscardableMemory::PurgeUnlockedMemory(size_t bytes) {
+  UnlockedMemory* unlocked = g_unlocked_memory.Pointer();
+  unlocked->lock.AssertAcquired();
+
+  while (unlocked->bytes > bytes) {
+    DCHECK(!unlocked->by_sequence.empty());
+    DiscardableMemory* oldest = unlocked->by_sequence.begin()->second;
+    unlocked->by_sequence.erase(unlocked->by_sequence.begin());
+    unlocked->bytes -= oldest->size_;
+    oldest->unlock_sequence_ = 0;
+
+    if (madvise(oldest->memory_, oldest->size_, MADV_DONTNEED) != 0)
+      DPLOG(ERROR) << "Failed to purge memory.";
+    oldest->is_purged_ = true;
+  }
+}
+
+// static
+bool DiscardableMemory::PurgeForTestingSupported() {
+  return true;
+}
+
+// static
+void DiscardableMemory::PurgeForTesting() {
+  AutoLock lock(g_unlocked_memory.Get().lock);
+  PurgeUnlockedMemory(0);
+}
+
+}  // namespace base
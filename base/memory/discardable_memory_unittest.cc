@@ -7,7 +7,7 @@
 
 namespace base {
 
-#if defined(OS_ANDROID) || defined(OS_MACOSX)
+#if defined(OS_ANDROID) || defined(OS_MACOSX) || defined(OS_LINUX)
 // Test Lock() and Unlock() functionalities.
 TEST(DiscardableMemoryTest, LockAndUnLock) {
   ASSERT_TRUE(DiscardableMemory::Supported());
@@ -39,7 +39,7 @@ TEST(DiscardableMemoryTest, DeleteWhileLocked) {
   ASSERT_TRUE(memory.InitializeAndLock(size));
 }
 
-#if defined(OS_MACOSX)
+#if defined(OS_MACOSX) || defined(OS_LINUX)
 // Test forced purging.
 TEST(DiscardableMemoryTest, Purge) {
   ASSERT_TRUE(DiscardableMemory::Supported());
@@ -54,7 +54,36 @@ TEST(DiscardableMemoryTest, Purge) {
   DiscardableMemory::PurgeForTesting();
   EXPECT_EQ(DISCARDABLE_MEMORY_PURGED, memory.Lock());
 }
-#endif  // OS_MACOSX
+#endif  // OS_MACOSX || OS_LINUX
+
+#if defined(OS_LINUX)
+// Test that unlocking too much memory purges the memory that was unlocked
+// first, and leaves the rest.
+TEST(DiscardableMemoryTest, PurgeLeastRecentlyUnlocked) {
+  ASSERT_TRUE(DiscardableMemory::Supported());
+
+  const size_t size = 1024 * 1024;
+  const size_t count = 96;
+
+  DiscardableMemory memory[count];
+  for (size_t i = 0; i < count; ++i) {
+    ASSERT_TRUE(memory[i].InitializeAndLock(size));
+    static_cast<char*>(memory[i].Memory())[0] = 1;
+    memory[i].Unlock();
+  }
+
+  EXPECT_EQ(DISCARDABLE_MEMORY_SUCCESS, memory[count - 1].Lock());
+  EXPECT_EQ(1, static_cast<char*>(memory[count - 1].Memory())[0]);
+  EXPECT_EQ(DISCARDABLE_MEMORY_PURGED, memory[0].Lock());
+  EXPECT_EQ(0, static_cast<char*>(memory[0].Memory())[0]);
+
+  // Locked memory is never purged.
+  DiscardableMemory::PurgeForTesting();
+  EXPECT_EQ(1, static_cast<char*>(memory[count - 1].Memory())[0]);
+  memory[0].Unlock();
+  memory[count - 1].Unlock();
+}
+#endif  // OS_LINUX
 
 #endif  // OS_*
 
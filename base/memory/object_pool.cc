@@ -0,0 +1,286 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/object_pool.h"
+
+#include <algorithm>
+
+#include "base/atomicops.h"
+#include "base/lazy_instance.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/thread_local_storage.h"
+
+namespace base {
+
+namespace {
+
+// Sizes up to 128 bytes are rounded up to a multiple of 16, larger ones to a
+// power of two.
+const size_t kClassSizes[] = {
+  16, 32, 48, 64, 80, 96, 112, 128, 256, 512, 1024, 2048, 4096,
+};
+const size_t kNumClasses = arraysize(kClassSizes);
+const size_t kNumLinearClasses = 8;
+
+// A thread caches at most this many bytes of each size class before handing
+// half of them over to the central lists.
+const size_t kThreadCacheBytesPerClass = 32 * 1024;
+
+// Beyond this, the blocks of a size class freed to the central lists go back
+// to the general allocator.
+const size_t kCentralCacheBytesPerClass = 256 * 1024;
+
+size_t GetSizeClass(size_t size) {
+  if (size <= kClassSizes[kNumLinearClasses - 1])
+    return size ? (size - 1) / kClassSizes[0] : 0;
+  size_t size_class = kNumLinearClasses;
+  while (kClassSizes[size_class] < size)
+    ++size_class;
+  return size_class;
+}
+
+size_t GetMaxThreadCacheLength(size_t size_class) {
+  return std::max<size_t>(2, kThreadCacheBytesPerClass /
+                                 kClassSizes[size_class]);
+}
+
+// Free blocks are linked through their first word.
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+struct FreeList {
+  FreeList() : head(NULL), length(0) {}
+
+  void Push(void* ptr) {
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = head;
+    head = block;
+    ++length;
+  }
+
+  void* Pop() {
+    FreeBlock* block = head;
+    head = block->next;
+    --length;
+    return block;
+  }
+
+  // Returns all the blocks to the general allocator.
+  void Clear() {
+    while (head)
+      ::operator delete(Pop());
+  }
+
+  FreeBlock* head;
+  size_t length;
+};
+
+struct ThreadCache {
+  ThreadCache() : cached_bytes(0), previous(NULL), next(NULL) {}
+
+  FreeList lists[kNumClasses];
+
+  // The size of the blocks in |lists|. Only written by the owning thread.
+  subtle::AtomicWord cached_bytes;
+
+  // All the live thread caches are linked together, under Pool::lock_, so
+  // that their sizes can be reported.
+  ThreadCache* previous;
+  ThreadCache* next;
+};
+
+void AddCachedBytes(ThreadCache* cache, ptrdiff_t bytes) {
+  subtle::NoBarrier_Store(&cache->cached_bytes,
+                          subtle::NoBarrier_Load(&cache->cached_bytes) + bytes);
+}
+
+class Pool {
+ public:
+  Pool() : slot_(&OnThreadExit), central_bytes_(0), thread_caches_(NULL) {}
+
+  void* Allocate(size_t size) {
+    size_t size_class = GetSizeClass(size);
+    ThreadCache* cache = GetThreadCache();
+    FreeList* list = &cache->lists[size_class];
+    if (!list->head) {
+      FetchFromCentral(cache, size_class);
+      if (!list->head)
+        return ::operator new(kClassSizes[size_class]);
+    }
+    AddCachedBytes(cache, -static_cast<ptrdiff_t>(kClassSizes[size_class]));
+    return list->Pop();
+  }
+
+  void Free(void* ptr, size_t size) {
+    size_t size_class = GetSizeClass(size);
+    ThreadCache* cache = GetThreadCache();
+    FreeList* list = &cache->lists[size_class];
+    list->Push(ptr);
+    AddCachedBytes(cache, kClassSizes[size_class]);
+    if (list->length > GetMaxThreadCacheLength(size_class))
+      ReleaseToCentral(cache, size_class, list->length / 2);
+  }
+
+  void GetCachedSize(size_t* thread_cache_size, size_t* central_cache_size) {
+    AutoLock lock(lock_);
+    *thread_cache_size = 0;
+    for (ThreadCache* cache = thread_caches_; cache; cache = cache->next)
+      *thread_cache_size += subtle::NoBarrier_Load(&cache->cached_bytes);
+    *central_cache_size = central_bytes_;
+  }
+
+  void ReleaseFreeMemory() {
+    ThreadCache* cache = static_cast<ThreadCache*>(slot_.Get());
+    if (cache) {
+      for (size_t i = 0; i < kNumClasses; ++i)
+        cache->lists[i].Clear();
+      subtle::NoBarrier_Store(&cache->cached_bytes, 0);
+    }
+
+    FreeList released[kNumClasses];
+    {
+      AutoLock lock(lock_);
+      for (size_t i = 0; i < kNumClasses; ++i)
+        std::swap(released[i], central_[i]);
+      central_bytes_ = 0;
+    }
+    for (size_t i = 0; i < kNumClasses; ++i)
+      released[i].Clear();
+  }
+
+ private:
+  static void OnThreadExit(void* value);
+
+  ThreadCache* GetThreadCache() {
+    ThreadCache* cache = static_cast<ThreadCache*>(slot_.Get());
+    if (!cache) {
+      cache = new ThreadCache;
+      slot_.Set(cache);
+      AutoLock lock(lock_);
+      cache->next = thread_caches_;
+      if (thread_caches_)
+        thread_caches_->previous = cache;
+      thread_caches_ = cache;
+    }
+    return cache;
+  }
+
+  // Moves up to half of a thread's share of blocks of |size_class| from the
+  // central list to |cache|.
+  void FetchFromCentral(ThreadCache* cache, size_t size_class) {
+    FreeList* list = &cache->lists[size_class];
+    size_t count = GetMaxThreadCacheLength(size_class) / 2;
+    {
+      AutoLock lock(lock_);
+      FreeList* central = &central_[size_class];
+      count = std::min(count, central->length);
+      for (size_t i = 0; i < count; ++i)
+        list->Push(central->Pop());
+      central_bytes_ -= count * kClassSizes[size_class];
+    }
+    AddCachedBytes(cache, count * kClassSizes[size_class]);
+  }
+
+  // Moves |count| blocks of |size_class| from |cache| to the central list,
+  // and the ones that do not fit there to the general allocator.
+  void ReleaseToCentral(ThreadCache* cache, size_t size_class, size_t count) {
+    FreeList* list = &cache->lists[size_class];
+    const size_t block_size = kClassSizes[size_class];
+    FreeList released;
+    {
+      AutoLock lock(lock_);
+      FreeList* central = &central_[size_class];
+      for (size_t i = 0; i < count; ++i) {
+        if ((central->length + 1) * block_size <= kCentralCacheBytesPerClass) {
+          central->Push(list->Pop());
+          central_bytes_ += block_size;
+        } else {
+          released.Push(list->Pop());
+        }
+      }
+    }
+    AddCachedBytes(cache, -static_cast<ptrdiff_t>(count * block_size));
+    released.Clear();
+  }
+
+  void DestroyThreadCache(ThreadCache* cache) {
+    for (size_t i = 0; i < kNumClasses; ++i)
+      ReleaseToCentral(cache, i, cache->lists[i].length);
+    {
+      AutoLock lock(lock_);
+      if (cache->previous)
+        cache->previous->next = cache->next;
+      else
+        thread_caches_ = cache->next;
+      if (cache->next)
+        cache->next->previous = cache->previous;
+    }
+    delete cache;
+  }
+
+  // Holds the ThreadCache of each thread.
+  ThreadLocalStorage::Slot slot_;
+
+  // Protects all the members below.
+  Lock lock_;
+
+  FreeList central_[kNumClasses];
+
+  // The size of the blocks in |central_|.
+  size_t central_bytes_;
+
+  ThreadCache* thread_caches_;
+
+  DISALLOW_COPY_AND_ASSIGN(Pool);
+};
+
+LazyInstance<Pool>::Leaky g_pool = LAZY_INSTANCE_INITIALIZER;
+
+// static
+void Pool::OnThreadExit(void* value) {
+  g_pool.Get().DestroyThreadCache(static_cast<ThreadCache*>(value));
+}
+
+}  // namespace
+
+// static
+void* ObjectPool::Allocate(size_t size) {
+#if defined(ADDRESS_SANITIZER)
+  // Reusing blocks would hide use-after-free bugs from ASan.
+  return ::operator new(size);
+#else
+  if (size > kMaxSize)
+    return ::operator new(size);
+  return g_pool.Get().Allocate(size);
+#endif
+}
+
+// static
+void ObjectPool::Free(void* ptr, size_t size) {
+#if defined(ADDRESS_SANITIZER)
+  ::operator delete(ptr);
+#else
+  if (!ptr)
+    return;
+  if (size > kMaxSize) {
+    ::operator delete(ptr);
+    return;
+  }
+  g_pool.Get().Free(ptr, size);
+#endif
+}
+
+// static
+void ObjectPool::GetCachedSize(size_t* thread_cache_size,
+                               size_t* central_cache_size) {
+  g_pool.Get().GetCachedSize(thread_cache_size, central_cache_size);
+}
+
+// static
+void ObjectPool::ReleaseFreeMemory() {
+  g_pool.Get().ReleaseFreeMemory();
+}
+
+}  // namespace base
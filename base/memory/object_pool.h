@@ -0,0 +1,134 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// ObjectPool is a size-class allocator for small objects that are allocated
+// and freed at very high rates, such as task queue nodes and IO buffers.
+//
+// Each thread keeps a cache of freed blocks per size class, so that most
+// allocations and frees are a pointer swap with no lock and no atomic
+// operation. When a thread's cache for a class grows too large, or runs
+// empty, a batch of blocks is moved to or from a central list under a lock.
+// Blocks come from, and are eventually returned to, the general allocator,
+// so ObjectPool::ReleaseFreeMemory() gives cached memory back to it.
+//
+// Types usually opt in by deriving from PoolAllocated, which routes their
+// operator new and delete through the pool:
+//
+//   class Foo : public base::RefCountedThreadSafe<Foo>,
+//               public base::PoolAllocated {
+//     ...
+//   };
+//
+// Standard containers can use PoolAllocator<T>.
+//
+// Blocks may be freed on any thread, not only the one that allocated them.
+
+#ifndef BASE_MEMORY_OBJECT_POOL_H_
+#define BASE_MEMORY_OBJECT_POOL_H_
+
+#include <stddef.h>
+
+#include <limits>
+#include <new>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/logging.h"
+
+namespace base {
+
+class BASE_EXPORT ObjectPool {
+ public:
+  // Requests larger than this are passed through to the general allocator.
+  static const size_t kMaxSize = 4096;
+
+  // Returns a block of at least |size| bytes, aligned for any type. Never
+  // returns NULL.
+  static void* Allocate(size_t size);
+
+  // Frees a block returned by Allocate(). |size| must be the size that was
+  // passed to Allocate().
+  static void Free(void* ptr, size_t size);
+
+  // Returns the number of bytes the pool is holding on to in freed blocks,
+  // in the caches of all threads and in the central lists.
+  static void GetCachedSize(size_t* thread_cache_size,
+                            size_t* central_cache_size);
+
+  // Returns the blocks cached by the calling thread and by the central lists
+  // to the general allocator. The caches of other threads are left alone.
+  static void ReleaseFreeMemory();
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(ObjectPool);
+};
+
+// Deriving from PoolAllocated makes a class, and the classes derived from it,
+// allocated from the ObjectPool. If the class is deleted through a pointer to
+// a base class, that base must have a virtual destructor so that the pool is
+// handed back the size it allocated.
+class PoolAllocated {
+ public:
+  static void* operator new(size_t size) {
+    return ObjectPool::Allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    ObjectPool::Free(ptr, size);
+  }
+
+ protected:
+  PoolAllocated() {}
+  ~PoolAllocated() {}
+};
+
+// A standard allocator backed by the ObjectPool, for containers that free and
+// allocate nodes or chunks constantly, e.g.
+//   std::deque<Foo, PoolAllocator<Foo> >.
+template <typename T>
+class PoolAllocator {
+ public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+
+  template <typename U>
+  struct rebind {
+    typedef PoolAllocator<U> other;
+  };
+
+  PoolAllocator() {}
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U>&) {}
+
+  pointer address(reference value) const { return &value; }
+  const_pointer address(const_reference value) const { return &value; }
+
+  pointer allocate(size_type count, const void* hint = 0) {
+    CHECK_LE(count, max_size());
+    return static_cast<pointer>(ObjectPool::Allocate(count * sizeof(T)));
+  }
+  void deallocate(pointer ptr, size_type count) {
+    ObjectPool::Free(ptr, count * sizeof(T));
+  }
+
+  size_type max_size() const {
+    return std::numeric_limits<size_type>::max() / sizeof(T);
+  }
+
+  void construct(pointer ptr, const T& value) { new(ptr) T(value); }
+  void destroy(pointer ptr) { ptr->~T(); }
+
+  template <typename U>
+  bool operator==(const PoolAllocator<U>&) const { return true; }
+  template <typename U>
+  bool operator!=(const PoolAllocator<U>&) const { return false; }
+};
+
+}  // namespace base
+
+#endif  // BASE_MEMORY_OBJECT_POOL_H_
@@ -0,0 +1,179 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/object_pool.h"
+
+#include <string.h>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+class PooledBase : public PoolAllocated {
+ public:
+  PooledBase() : value_(1) {}
+  virtual ~PooledBase() {}
+
+  int value() const { return value_; }
+
+ private:
+  int value_;
+};
+
+class PooledDerived : public PooledBase {
+ public:
+  PooledDerived() {
+    memset(padding_, 0xAA, sizeof(padding_));
+  }
+  virtual ~PooledDerived() {}
+
+ private:
+  char padding_[200];
+};
+
+size_t GetTotalCachedSize() {
+  size_t thread_cache_size = 0;
+  size_t central_cache_size = 0;
+  ObjectPool::GetCachedSize(&thread_cache_size, &central_cache_size);
+  return thread_cache_size + central_cache_size;
+}
+
+void AllocateAndFree(size_t size, int count) {
+  std::vector<void*> blocks;
+  for (int i = 0; i < count; ++i) {
+    blocks.push_back(ObjectPool::Allocate(size));
+    memset(blocks.back(), i, size);
+  }
+  for (int i = 0; i < count; ++i)
+    ObjectPool::Free(blocks[i], size);
+}
+
+}  // namespace
+
+TEST(ObjectPoolTest, AllocateAndFree) {
+  std::vector<void*> blocks;
+  for (size_t size = 0; size <= ObjectPool::kMaxSize + 64; size += 7) {
+    void* block = ObjectPool::Allocate(size);
+    ASSERT_TRUE(block);
+    EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(block) % sizeof(double));
+    memset(block, 0x55, size);
+    blocks.push_back(block);
+  }
+  size_t size = 0;
+  for (size_t i = 0; i < blocks.size(); ++i, size += 7)
+    ObjectPool::Free(blocks[i], size);
+  ObjectPool::Free(NULL, 16);
+}
+
+#if !defined(ADDRESS_SANITIZER)
+TEST(ObjectPoolTest, ReusesBlocks) {
+  void* block = ObjectPool::Allocate(20);
+  ObjectPool::Free(block, 20);
+  // 20 and 30 bytes are in the same size class.
+  void* same_block = ObjectPool::Allocate(30);
+  EXPECT_EQ(block, same_block);
+  ObjectPool::Free(same_block, 30);
+
+  ObjectPool::ReleaseFreeMemory();
+  size_t thread_cache_size = 0;
+  size_t central_cache_size = 0;
+  ObjectPool::GetCachedSize(&thread_cache_size, &central_cache_size);
+  EXPECT_EQ(0U, central_cache_size);
+
+  // Blocks larger than kMaxSize are not cached.
+  block = ObjectPool::Allocate(ObjectPool::kMaxSize + 1);
+  ObjectPool::Free(block, ObjectPool::kMaxSize + 1);
+  size_t new_thread_cache_size = 0;
+  ObjectPool::GetCachedSize(&new_thread_cache_size, &central_cache_size);
+  EXPECT_EQ(thread_cache_size, new_thread_cache_size);
+}
+
+TEST(ObjectPoolTest, ThreadCacheOverflowsToCentralList) {
+  ObjectPool::ReleaseFreeMemory();
+  AllocateAndFree(64, 10000);
+  size_t thread_cache_size = 0;
+  size_t central_cache_size = 0;
+  ObjectPool::GetCachedSize(&thread_cache_size, &central_cache_size);
+  EXPECT_LT(0U, central_cache_size);
+  // The central lists are bounded too.
+  EXPECT_GT(10000U * 64, central_cache_size);
+
+  ObjectPool::ReleaseFreeMemory();
+  ObjectPool::GetCachedSize(&thread_cache_size, &central_cache_size);
+  EXPECT_EQ(0U, central_cache_size);
+}
+
+TEST(ObjectPoolTest, ThreadExitReturnsCache) {
+  ObjectPool::ReleaseFreeMemory();
+  size_t thread_cache_size = 0;
+  size_t central_cache_size = 0;
+  ObjectPool::GetCachedSize(&thread_cache_size, &central_cache_size);
+  EXPECT_EQ(0U, central_cache_size);
+
+  Thread thread("ObjectPoolTest");
+  ASSERT_TRUE(thread.Start());
+  thread.message_loop()->PostTask(FROM_HERE, Bind(&AllocateAndFree, 128, 8));
+  thread.Stop();
+
+  ObjectPool::GetCachedSize(&thread_cache_size, &central_cache_size);
+  EXPECT_LE(8U * 128, central_cache_size);
+  ObjectPool::ReleaseFreeMemory();
+}
+#endif  // !defined(ADDRESS_SANITIZER)
+
+TEST(ObjectPoolTest, FreeOnAnotherThread) {
+  const size_t kSize = 100;
+  std::vector<void*> blocks;
+  for (int i = 0; i < 1000; ++i)
+    blocks.push_back(ObjectPool::Allocate(kSize));
+
+  Thread thread("ObjectPoolTest");
+  ASSERT_TRUE(thread.Start());
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    thread.message_loop()->PostTask(FROM_HERE,
+                                    Bind(&ObjectPool::Free, blocks[i], kSize));
+  }
+  thread.message_loop()->PostTask(FROM_HERE, Bind(&AllocateAndFree, kSize, 10));
+  thread.Stop();
+
+  AllocateAndFree(kSize, 1000);
+}
+
+TEST(ObjectPoolTest, PoolAllocated) {
+  scoped_ptr<PooledBase> base(new PooledBase);
+  scoped_ptr<PooledBase> derived(new PooledDerived);
+  EXPECT_EQ(1, derived->value());
+  size_t cached_size = GetTotalCachedSize();
+  base.reset();
+  derived.reset();
+#if !defined(ADDRESS_SANITIZER)
+  // Both blocks were given back to the pool, with the right size.
+  EXPECT_LE(cached_size + sizeof(PooledBase) + sizeof(PooledDerived),
+            GetTotalCachedSize());
+#endif
+}
+
+TEST(ObjectPoolTest, PoolAllocator) {
+  std::deque<std::string, PoolAllocator<std::string> > queue;
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 1000; ++i)
+      queue.push_back(std::string(i % 50, 'x'));
+    for (int i = 0; i < 1000; ++i) {
+      EXPECT_EQ(static_cast<size_t>(i % 50), queue.front().size());
+      queue.pop_front();
+    }
+  }
+  EXPECT_TRUE(queue.empty());
+}
+
+}  // namespace base
@@ -6,15 +6,132 @@
 
 #include "base/debug/trace_event.h"
 #include "base/location.h"
+#include "base/memory/object_pool.h"
 #include "base/message_loop/message_loop.h"
 #include "base/synchronization/waitable_event.h"
+#include "base/threading/platform_thread.h"
 
 namespace base {
 namespace internal {
 
-IncomingTaskQueue::IncomingTaskQueue(MessageLoop* message_loop)
+// An intrusive multi-producer single-consumer queue, as described by Dmitry
+// Vyukov. Push() is wait-free for producers; Pop() may only be called from
+// one thread at a time. Pop() returns NULL both when the queue is empty and
+// when a producer has published a node but not linked it yet. Nodes come
+// from the ObjectPool, since one is allocated for every posted task and freed
+// on another thread.
+class IncomingTaskQueue::LockFreeQueue {
+ public:
+  struct Node : public PoolAllocated {
+    explicit Node(const PendingTask& pending_task)
+        : next(0),
+          task(pending_task) {
+    }
+
+    subtle::AtomicWord next;
+    PendingTask task;
+  };
+
+  LockFreeQueue()
+      : stub_(PendingTask(FROM_HERE, Closure())) {
+    head_ = reinterpret_cast<subtle::AtomicWord>(&stub_);
+    tail_ = &stub_;
+  }
+
+  ~LockFreeQueue() {
+    Node* node;
+    while ((node = Pop()) != NULL)
+      delete node;
+  }
+
+  void Push(Node* node) {
+    subtle::NoBarrier_Store(&node->next, 0);
+    // Make the contents of |node| visible before it can be reached.
+    subtle::MemoryBarrier();
+    Node* prev = reinterpret_cast<Node*>(subtle::NoBarrier_AtomicExchange(
+        &head_, reinterpret_cast<subtle::AtomicWord>(node)));
+    subtle::Release_Store(&prev->next,
+                          reinterpret_cast<subtle::AtomicWord>(node));
+  }
+
+  Node* Pop() {
+    Node* tail = tail_;
+    Node* next = LoadNext(tail);
+    if (tail == &stub_) {
+      if (!next)
+        return NULL;
+      tail_ = next;
+      tail = next;
+      next = LoadNext(next);
+    }
+    if (next) {
+      tail_ = next;
+      return tail;
+    }
+    Node* head = reinterpret_cast<Node*>(subtle::Acquire_Load(&head_));
+    if (tail != head)
+      return NULL;  // A producer is between its exchange and its link.
+    Push(&stub_);
+    next = LoadNext(tail);
+    if (next) {
+      tail_ = next;
+      return tail;
+    }
+    return NULL;
+  }
+
+ private:
+  static Node* LoadNext(Node* node) {
+    return reinterpret_cast<Node*>(subtle::Acquire_Load(&node->next));
+  }
+
+  // Most recently pushed node. Written by producers.
+  subtle::AtomicWord head_;
+
+  // Oldest node. Only touched by the consumer.
+  Node* tail_;
+
+  Node stub_;
+
+  DISALLOW_COPY_AND_ASSIGN(LockFreeQueue);
+};
+
+namespace {
+
+// Merges |tasks| into |work_queue|. Both are in posting order, and so is the
+// result, so that a delayed task does not reach the MessageLoop ahead of the
+// tasks posted before it. Sequence numbers are compared by difference to
+// support roll-over.
+void MergeInPostOrder(TaskQueue* tasks, TaskQueue* work_queue) {
+  if (work_queue->empty()) {
+    work_queue->Swap(tasks);
+    return;
+  }
+  TaskQueue merged;
+  while (!tasks->empty() || !work_queue->empty()) {
+    TaskQueue* next = work_queue;
+    if (work_queue->empty() ||
+        (!tasks->empty() &&
+         tasks->front().sequence_num - work_queue->front().sequence_num < 0)) {
+      next = tasks;
+    }
+    merged.push(next->front());
+    next->pop();
+  }
+  work_queue->Swap(&merged);
+}
+
+}  // namespace
+
+IncomingTaskQueue::IncomingTaskQueue(MessageLoop* message_loop,
+                                     bool lock_free)
     : message_loop_(message_loop),
-      next_sequence_num_(0) {
+      lock_free_queue_size_(0),
+      lock_free_posters_(0),
+      accepting_tasks_(1),
+      incoming_queue_has_tasks_(0) {
+  if (lock_free)
+    lock_free_queue_.reset(new LockFreeQueue());
 }
 
 bool IncomingTaskQueue::AddToIncomingQueue(
@@ -22,6 +139,9 @@ bool IncomingTaskQueue::AddToIncomingQueue(
     const Closure& task,
     TimeDelta delay,
     bool nestable) {
+  if (lock_free_queue_ && delay == TimeDelta())
+    return PostPendingTaskLockFree(from_here, task, nestable);
+
   AutoLock locked(incoming_queue_lock_);
   PendingTask pending_task(
       from_here, task, CalculateDelayedRuntime(delay), nestable);
@@ -31,6 +151,9 @@ bool IncomingTaskQueue::AddToIncomingQueue(
 bool IncomingTaskQueue::TryAddToIncomingQueue(
     const tracked_objects::Location& from_here,
     const Closure& task) {
+  if (lock_free_queue_)
+    return PostPendingTaskLockFree(from_here, task, true);
+
   if (!incoming_queue_lock_.Try()) {
     // Reset |task|.
     Closure local_task = task;
@@ -53,7 +176,8 @@ bool IncomingTaskQueue::IsHighResolutionTimerEnabledForTesting() {
 
 bool IncomingTaskQueue::IsIdleForTesting() {
   AutoLock lock(incoming_queue_lock_);
-  return incoming_queue_.empty();
+  return incoming_queue_.empty() &&
+      subtle::Acquire_Load(&lock_free_queue_size_) == 0;
 }
 
 void IncomingTaskQueue::LockWaitUnLockForTesting(WaitableEvent* caller_wait,
@@ -67,6 +191,22 @@ void IncomingTaskQueue::ReloadWorkQueue(TaskQueue* work_queue) {
   // Make sure no tasks are lost.
   DCHECK(work_queue->empty());
 
+  if (lock_free_queue_) {
+    ReloadFromLockFreeQueue(work_queue);
+    // Only delayed tasks are posted under the lock, so avoid taking it when
+    // none are waiting.
+    if (subtle::Acquire_Load(&incoming_queue_has_tasks_)) {
+      TaskQueue locked_tasks;
+      {
+        AutoLock lock(incoming_queue_lock_);
+        incoming_queue_.Swap(&locked_tasks);  // Constant time
+        subtle::NoBarrier_Store(&incoming_queue_has_tasks_, 0);
+      }
+      MergeInPostOrder(&locked_tasks, work_queue);
+    }
+    return;
+  }
+
   // Acquire all we can from the inter-thread queue with one lock acquisition.
   AutoLock lock(incoming_queue_lock_);
   if (!incoming_queue_.empty())
@@ -86,6 +226,13 @@ void IncomingTaskQueue::WillDestroyCurrentMessageLoop() {
   }
 #endif
 
+  // Stop new lock-free posters and wait for the ones already running to stop
+  // using |message_loop_|. Their critical sections are a few instructions
+  // long, so spinning here is cheap.
+  subtle::Release_Store(&accepting_tasks_, 0);
+  while (subtle::Acquire_Load(&lock_free_posters_) != 0)
+    PlatformThread::YieldCurrentThread();
+
   AutoLock lock(incoming_queue_lock_);
   message_loop_ = NULL;
 }
@@ -150,14 +297,15 @@ bool IncomingTaskQueue::PostPendingTask(PendingTask* pending_task) {
   // Initialize the sequence number. The sequence number is used for delayed
   // tasks (to faciliate FIFO sorting when two tasks have the same
   // delayed_run_time value) and for identifying the task in about:tracing.
-  pending_task->sequence_num = next_sequence_num_++;
+  pending_task->sequence_num = next_sequence_num_.GetNext();
 
   TRACE_EVENT_FLOW_BEGIN0("task", "MessageLoop::PostTask",
       TRACE_ID_MANGLE(message_loop_->GetTaskTraceID(*pending_task)));
 
   bool was_empty = incoming_queue_.empty();
-  incoming_queue_.push(*pending_task);
-  pending_task->task.Reset();
+  incoming_queue_.MoveAndPush(pending_task);
+  if (lock_free_queue_)
+    subtle::Release_Store(&incoming_queue_has_tasks_, 1);
 
   // Wake up the pump.
   message_loop_->ScheduleWork(was_empty);
@@ -165,5 +313,65 @@ bool IncomingTaskQueue::PostPendingTask(PendingTask* pending_task) {
   return true;
 }
 
+bool IncomingTaskQueue::PostPendingTaskLockFree(
+    const tracked_objects::Location& from_here,
+    const Closure& task,
+    bool nestable) {
+  DCHECK(lock_free_queue_);
+
+  // Registering as a poster before checking |accepting_tasks_| guarantees
+  // that WillDestroyCurrentMessageLoop() waits for us if it has not cleared
+  // the flag yet.
+  subtle::Barrier_AtomicIncrement(&lock_free_posters_, 1);
+  if (!subtle::Acquire_Load(&accepting_tasks_)) {
+    subtle::Barrier_AtomicIncrement(&lock_free_posters_, -1);
+    return false;
+  }
+
+  // Add |task| once the node exists, so that it is copied only once.
+  LockFreeQueue::Node* node = new LockFreeQueue::Node(
+      PendingTask(from_here, Closure(), TimeTicks(), nestable));
+  node->task.task = task;
+  node->task.sequence_num = next_sequence_num_.GetNext();
+
+  TRACE_EVENT_FLOW_BEGIN0("task", "MessageLoop::PostTask",
+      TRACE_ID_MANGLE(message_loop_->GetTaskTraceID(node->task)));
+
+  bool was_empty =
+      subtle::Barrier_AtomicIncrement(&lock_free_queue_size_, 1) == 1;
+  lock_free_queue_->Push(node);
+
+  // Wake up the pump.
+  message_loop_->ScheduleWork(was_empty);
+
+  subtle::Barrier_AtomicIncrement(&lock_free_posters_, -1);
+  return true;
+}
+
+void IncomingTaskQueue::ReloadFromLockFreeQueue(TaskQueue* work_queue) {
+  // Every task counted in |lock_free_queue_size_| is either linked already or
+  // will be linked within a few instructions by its poster. Returning an
+  // empty |work_queue| while the count is non-zero would strand tasks whose
+  // posters did not wake the pump, so wait for at least one of them.
+  subtle::Atomic32 pending = subtle::Acquire_Load(&lock_free_queue_size_);
+  subtle::Atomic32 popped = 0;
+  while (popped < pending) {
+    LockFreeQueue::Node* node = lock_free_queue_->Pop();
+    if (!node) {
+      // Anything still in flight is picked up by the next reload, which
+      // MessageLoop::DoWork() performs whenever this one returned tasks.
+      if (popped)
+        break;
+      PlatformThread::YieldCurrentThread();
+      continue;
+    }
+    work_queue->MoveAndPush(&node->task);
+    delete node;
+    ++popped;
+  }
+  if (popped)
+    subtle::Barrier_AtomicIncrement(&lock_free_queue_size_, -popped);
+}
+
 }  // namespace internal
 }  // namespace base
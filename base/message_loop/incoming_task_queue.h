@@ -5,8 +5,11 @@
 #ifndef BASE_MESSAGE_LOOP_INCOMING_TASK_QUEUE_H_
 #define BASE_MESSAGE_LOOP_INCOMING_TASK_QUEUE_H_
 
+#include "base/atomic_sequence_num.h"
+#include "base/atomicops.h"
 #include "base/base_export.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/pending_task.h"
 #include "base/synchronization/lock.h"
 #include "base/time/time.h"
@@ -21,10 +24,17 @@ namespace internal {
 // Implements a queue of tasks posted to the message loop running on the current
 // thread. This class takes care of synchronizing posting tasks from different
 // threads and together with MessageLoop ensures clean shutdown.
+//
+// When |lock_free| is true, immediate tasks are posted through an intrusive
+// multi-producer single-consumer queue that never takes
+// |incoming_queue_lock_|. Delayed tasks still go through the locked queue,
+// because computing their run time touches state that is not thread-safe on
+// some platforms. Immediate tasks keep FIFO order per posting thread, and
+// sequence numbers are shared by both paths.
 class BASE_EXPORT IncomingTaskQueue
     : public RefCountedThreadSafe<IncomingTaskQueue> {
  public:
-  explicit IncomingTaskQueue(MessageLoop* message_loop);
+  IncomingTaskQueue(MessageLoop* message_loop, bool lock_free);
 
   // Appends a task to the incoming queue. Posting of all tasks is routed though
   // AddToIncomingQueue() or TryAddToIncomingQueue() to make sure that posting
@@ -40,7 +50,8 @@ class BASE_EXPORT IncomingTaskQueue
 
   // Same as AddToIncomingQueue() except that it will avoid blocking if the lock
   // is already held, and will in that case (when the lock is contended) fail to
-  // add the task, and will return false.
+  // add the task, and will return false. In lock-free mode this never fails
+  // because of contention.
   bool TryAddToIncomingQueue(const tracked_objects::Location& from_here,
                              const Closure& task);
 
@@ -51,6 +62,9 @@ class BASE_EXPORT IncomingTaskQueue
   // Returns true if the message loop is "idle". Provided for testing.
   bool IsIdleForTesting();
 
+  // Returns true if immediate tasks bypass |incoming_queue_lock_|.
+  bool is_lock_free() const { return lock_free_queue_.get() != NULL; }
+
   // Takes the incoming queue lock, signals |caller_wait| and waits until
   // |caller_signal| is signalled.
   void LockWaitUnLockForTesting(WaitableEvent* caller_wait,
@@ -65,6 +79,8 @@ class BASE_EXPORT IncomingTaskQueue
 
  private:
   friend class RefCountedThreadSafe<IncomingTaskQueue>;
+  class LockFreeQueue;
+
   virtual ~IncomingTaskQueue();
 
   // Calculates the time at which a PendingTask should run.
@@ -76,12 +92,23 @@ class BASE_EXPORT IncomingTaskQueue
   // does not retain |pending_task->task| beyond this function call.
   bool PostPendingTask(PendingTask* pending_task);
 
+  // Lock-free counterpart of PostPendingTask() used for immediate tasks when
+  // |lock_free_queue_| is set.
+  bool PostPendingTaskLockFree(const tracked_objects::Location& from_here,
+                               const Closure& task,
+                               bool nestable);
+
+  // Moves the tasks that are fully linked into |lock_free_queue_| to
+  // |work_queue|. Must be called from the thread that is running the loop.
+  void ReloadFromLockFreeQueue(TaskQueue* work_queue);
+
 #if defined(OS_WIN)
   TimeTicks high_resolution_timer_expiration_;
 #endif
 
-  // The lock that protects access to |incoming_queue_|, |message_loop_| and
-  // |next_sequence_num_|.
+  // The lock that protects access to |incoming_queue_| and |message_loop_|.
+  // In lock-free mode |message_loop_| may also be read without the lock by a
+  // poster that has registered itself in |lock_free_posters_|.
   base::Lock incoming_queue_lock_;
 
   // An incoming queue of tasks that are acquired under a mutex for processing
@@ -92,8 +119,27 @@ class BASE_EXPORT IncomingTaskQueue
   // Points to the message loop that owns |this|.
   MessageLoop* message_loop_;
 
-  // The next sequence number to use for delayed tasks.
-  int next_sequence_num_;
+  // The next sequence number to use for posted tasks.
+  AtomicSequenceNumber next_sequence_num_;
+
+  // Set in lock-free mode only. Receives every immediate task.
+  scoped_ptr<LockFreeQueue> lock_free_queue_;
+
+  // Number of tasks pushed to |lock_free_queue_| that have not yet been moved
+  // to a work queue. Incremented before a task is linked into the queue, so a
+  // poster that moves it from zero is the one that wakes the pump.
+  subtle::Atomic32 lock_free_queue_size_;
+
+  // Number of threads currently inside PostPendingTaskLockFree(). Together
+  // with |accepting_tasks_| this keeps |message_loop_| alive for them.
+  subtle::Atomic32 lock_free_posters_;
+
+  // Cleared by WillDestroyCurrentMessageLoop().
+  subtle::Atomic32 accepting_tasks_;
+
+  // Set when |incoming_queue_| may be non-empty, so that lock-free mode only
+  // takes the lock in ReloadWorkQueue() when delayed tasks are waiting.
+  subtle::Atomic32 incoming_queue_has_tasks_;
 
   DISALLOW_COPY_AND_ASSIGN(IncomingTaskQueue);
 };
@@ -86,6 +86,8 @@ const LinearHistogram::DescriptionPair event_descriptions_[] = {
 
 bool enable_histogrammer_ = false;
 
+bool enable_lock_free_incoming_queue_ = false;
+
 MessageLoop::MessagePumpFactory* message_pump_for_ui_factory_ = NULL;
 
 // Returns true if MessagePump::ScheduleWork() must be called one
@@ -147,7 +149,8 @@ MessageLoop::MessageLoop(Type type)
   DCHECK(!current()) << "should only have one message loop per thread";
   lazy_tls_ptr.Pointer()->Set(this);
 
-  incoming_task_queue_ = new internal::IncomingTaskQueue(this);
+  incoming_task_queue_ = new internal::IncomingTaskQueue(
+      this, enable_lock_free_incoming_queue_);
   message_loop_proxy_ =
       new internal::MessageLoopProxyImpl(incoming_task_queue_);
   thread_task_runner_handle_.reset(
@@ -253,6 +256,11 @@ void MessageLoop::EnableHistogrammer(bool enable) {
   enable_histogrammer_ = enable;
 }
 
+// static
+void MessageLoop::EnableLockFreeIncomingQueue(bool enable) {
+  enable_lock_free_incoming_queue_ = enable;
+}
+
 // static
 bool MessageLoop::InitMessagePumpForUIFactory(MessagePumpFactory* factory) {
   if (message_pump_for_ui_factory_)
@@ -452,8 +460,7 @@ bool MessageLoop::ProcessNextDelayedNonNestableTask() {
   if (deferred_non_nestable_work_queue_.empty())
     return false;
 
-  PendingTask pending_task = deferred_non_nestable_work_queue_.front();
-  deferred_non_nestable_work_queue_.pop();
+  PendingTask pending_task = deferred_non_nestable_work_queue_.MoveAndPop();
 
   RunTask(pending_task);
   return true;
@@ -606,8 +613,7 @@ bool MessageLoop::DoWork() {
 
     // Execute oldest task.
     do {
-      PendingTask pending_task = work_queue_.front();
-      work_queue_.pop();
+      PendingTask pending_task = work_queue_.MoveAndPop();
       if (!pending_task.delayed_run_time.is_null()) {
         AddToDelayedWorkQueue(pending_task);
         // If we changed the topmost task, then it is time to reschedule.
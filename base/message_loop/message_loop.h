@@ -142,6 +142,12 @@ class BASE_EXPORT MessageLoop : public MessagePump::Delegate {
 
   static void EnableHistogrammer(bool enable_histogrammer);
 
+  // Makes MessageLoops constructed afterwards post immediate tasks through a
+  // lock-free incoming queue instead of taking a lock for every post. This is
+  // useful for loops that receive tasks from many threads, such as the IO
+  // thread.
+  static void EnableLockFreeIncomingQueue(bool enable);
+
   typedef MessagePump* (MessagePumpFactory)();
   // Uses the given base::MessagePumpForUIFactory to override the default
   // MessagePump implementation for 'TYPE_UI'. Returns true if the factory
@@ -0,0 +1,137 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/bind.h"
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop/message_loop.h"
+#include "base/perftimer.h"
+#include "base/run_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const int kTasksPerProducer = 20000;
+
+// Counts the tasks run on the consumer thread and signals |done| once the
+// expected number has been reached.
+class TaskCounter {
+ public:
+  TaskCounter(int expected, WaitableEvent* done)
+      : expected_(expected),
+        count_(0),
+        done_(done) {
+  }
+
+  void Run() {
+    if (++count_ == expected_)
+      done_->Signal();
+  }
+
+ private:
+  const int expected_;
+  int count_;
+  WaitableEvent* done_;
+};
+
+void PostTasks(WaitableEvent* start,
+               MessageLoop* target,
+               TaskCounter* counter,
+               int num_tasks) {
+  start->Wait();
+  for (int i = 0; i < num_tasks; ++i)
+    target->PostTask(FROM_HERE, Bind(&TaskCounter::Run, Unretained(counter)));
+}
+
+// Measures how many tasks per second |num_producers| threads manage to post
+// to, and have run on, a single IO thread.
+void RunPostTaskTest(int num_producers, bool lock_free) {
+  MessageLoop::EnableLockFreeIncomingQueue(lock_free);
+  Thread consumer("Consumer");
+  ASSERT_TRUE(consumer.StartWithOptions(
+      Thread::Options(MessageLoop::TYPE_IO, 0)));
+  MessageLoop::EnableLockFreeIncomingQueue(false);
+
+  const int total_tasks = num_producers * kTasksPerProducer;
+  WaitableEvent start(true, false);
+  WaitableEvent done(false, false);
+  TaskCounter counter(total_tasks, &done);
+
+  ScopedVector<Thread> producers;
+  for (int i = 0; i < num_producers; ++i) {
+    producers.push_back(new Thread(StringPrintf("Producer%d", i)));
+    ASSERT_TRUE(producers.back()->Start());
+    producers.back()->message_loop()->PostTask(
+        FROM_HERE,
+        Bind(&PostTasks, &start, consumer.message_loop(), &counter,
+             kTasksPerProducer));
+  }
+
+  PerfTimer timer;
+  start.Signal();
+  done.Wait();
+  TimeDelta elapsed = timer.Elapsed();
+
+  producers.clear();
+  consumer.Stop();
+
+  std::string name = StringPrintf("MessageLoop_PostTask_%s_%d_producers",
+                                  lock_free ? "lock_free" : "locked",
+                                  num_producers);
+  LogPerfResult(name.c_str(), total_tasks / elapsed.InSecondsF(), "posts/s");
+}
+
+void Increment(int* count) {
+  ++*count;
+}
+
+}  // namespace
+
+// Binding a small callback and dropping it. This is mostly the cost of
+// allocating and freeing the bound state.
+TEST(MessageLoopPerfTest, BindAndDestroy) {
+  const int kCallbacks = 1000000;
+  int count = 0;
+  PerfTimer timer;
+  for (int i = 0; i < kCallbacks; ++i) {
+    Closure callback = Bind(&Increment, &count);
+  }
+  LogPerfResult("Callback_BindAndDestroy",
+                kCallbacks / timer.Elapsed().InSecondsF(), "binds/s");
+}
+
+// Posting to and running on the current thread, without any thread switches,
+// measures the overhead each task has in Bind() and in the task queues.
+TEST(MessageLoopPerfTest, PostTaskSameThread) {
+  const int kBatches = 100;
+  const int kTasksPerBatch = 10000;
+  MessageLoop loop;
+  int count = 0;
+  PerfTimer timer;
+  for (int batch = 0; batch < kBatches; ++batch) {
+    for (int i = 0; i < kTasksPerBatch; ++i)
+      loop.PostTask(FROM_HERE, Bind(&Increment, &count));
+    RunLoop().RunUntilIdle();
+  }
+  TimeDelta elapsed = timer.Elapsed();
+  EXPECT_EQ(kBatches * kTasksPerBatch, count);
+  LogPerfResult("MessageLoop_PostTask_same_thread",
+                kBatches * kTasksPerBatch / elapsed.InSecondsF(), "posts/s");
+}
+
+TEST(MessageLoopPerfTest, PostTaskLocked) {
+  for (int producers = 1; producers <= 32; producers *= 2)
+    RunPostTaskTest(producers, false);
+}
+
+TEST(MessageLoopPerfTest, PostTaskLockFree) {
+  for (int producers = 1; producers <= 32; producers *= 2)
+    RunPostTaskTest(producers, true);
+}
+
+}  // namespace base
@@ -9,6 +9,7 @@
 #include "base/compiler_specific.h"
 #include "base/logging.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/scoped_vector.h"
 #include "base/message_loop/message_loop.h"
 #include "base/message_loop/message_loop_proxy_impl.h"
 #include "base/pending_task.h"
@@ -2101,4 +2102,132 @@ TEST(MessageLoopTest, RecursivePosts) {
   RunTest_RecursivePosts(MessageLoop::TYPE_IO, kNumTimes);
 }
 
+namespace {
+
+// Enables the lock-free incoming queue for MessageLoops created during the
+// lifetime of this object.
+class ScopedLockFreeIncomingQueue {
+ public:
+  ScopedLockFreeIncomingQueue() {
+    MessageLoop::EnableLockFreeIncomingQueue(true);
+  }
+  ~ScopedLockFreeIncomingQueue() {
+    MessageLoop::EnableLockFreeIncomingQueue(false);
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ScopedLockFreeIncomingQueue);
+};
+
+class OrderRecorder {
+ public:
+  explicit OrderRecorder(int num_producers)
+      : last_seen_(num_producers, -1),
+        num_received_(0),
+        out_of_order_(0) {
+  }
+
+  void Record(int producer, int index) {
+    if (last_seen_[producer] + 1 != index)
+      ++out_of_order_;
+    last_seen_[producer] = index;
+    ++num_received_;
+  }
+
+  int num_received() const { return num_received_; }
+  int out_of_order() const { return out_of_order_; }
+
+ private:
+  std::vector<int> last_seen_;
+  int num_received_;
+  int out_of_order_;
+};
+
+void PostOrderedTasks(MessageLoop* target,
+                      OrderRecorder* recorder,
+                      int producer,
+                      int num_tasks) {
+  for (int i = 0; i < num_tasks; ++i) {
+    target->PostTask(FROM_HERE, Bind(&OrderRecorder::Record,
+                                     Unretained(recorder), producer, i));
+  }
+}
+
+// Like RunTest_PostTask(), except that the lock-free queue never takes the
+// incoming queue lock, so TryPostTask() succeeds even while another thread
+// holds it.
+void RunTest_PostTaskLockFree(MessageLoop::Type message_loop_type) {
+  MessageLoop loop(message_loop_type);
+
+  scoped_refptr<Foo> foo(new Foo());
+  std::string a("a"), b("b"), c("c"), d("d");
+  loop.PostTask(FROM_HERE, Bind(&Foo::Test0, foo.get()));
+  loop.PostTask(FROM_HERE, Bind(&Foo::Test1ConstRef, foo.get(), a));
+  loop.PostTask(FROM_HERE, Bind(&Foo::Test1Ptr, foo.get(), &b));
+  loop.PostTask(FROM_HERE, Bind(&Foo::Test1Int, foo.get(), 100));
+  loop.PostTask(FROM_HERE, Bind(&Foo::Test2Ptr, foo.get(), &a, &c));
+  EXPECT_TRUE(loop.TryPostTask(FROM_HERE, Bind(
+      &Foo::Test2Mixed, foo.get(), a, &d)));
+
+  WaitableEvent wait(true, false);
+  WaitableEvent signal(true, false);
+  Thread thread("RunTest_PostTaskLockFree_helper");
+  thread.Start();
+  thread.message_loop()->PostTask(
+      FROM_HERE,
+      Bind(&MessageLoop::LockWaitUnLockForTesting, Unretained(&loop),
+           &wait, &signal));
+  wait.Wait();
+  EXPECT_TRUE(loop.TryPostTask(FROM_HERE, Bind(
+      &Foo::Test2Mixed, foo.get(), a, &d)));
+  signal.Signal();
+
+  loop.PostTask(FROM_HERE, Bind(&MessageLoop::Quit, Unretained(&loop)));
+  loop.Run();
+
+  EXPECT_EQ(106, foo->test_count());
+  EXPECT_EQ("abacadad", foo->result());
+}
+
+}  // namespace
+
+TEST(MessageLoopTest, LockFreeIncomingQueuePostTask) {
+  ScopedLockFreeIncomingQueue lock_free;
+  RunTest_PostTaskLockFree(MessageLoop::TYPE_DEFAULT);
+  RunTest_PostTaskLockFree(MessageLoop::TYPE_UI);
+  RunTest_PostTaskLockFree(MessageLoop::TYPE_IO);
+}
+
+TEST(MessageLoopTest, LockFreeIncomingQueueDelayedTasks) {
+  ScopedLockFreeIncomingQueue lock_free;
+  RunTest_PostDelayedTask_InPostOrder(MessageLoop::TYPE_DEFAULT);
+  RunTest_PostDelayedTask_InPostOrder_3(MessageLoop::TYPE_DEFAULT);
+  RunTest_NonNestableInNestedLoop(MessageLoop::TYPE_DEFAULT, true);
+}
+
+TEST(MessageLoopTest, LockFreeIncomingQueueManyProducers) {
+  const int kNumProducers = 8;
+  const int kTasksPerProducer = 2000;
+
+  ScopedLockFreeIncomingQueue lock_free;
+  MessageLoop loop(MessageLoop::TYPE_DEFAULT);
+  OrderRecorder recorder(kNumProducers);
+
+  ScopedVector<Thread> producers;
+  for (int i = 0; i < kNumProducers; ++i) {
+    producers.push_back(new Thread("LockFreeProducer"));
+    ASSERT_TRUE(producers.back()->Start());
+    producers.back()->message_loop()->PostTask(
+        FROM_HERE,
+        Bind(&PostOrderedTasks, &loop, &recorder, i, kTasksPerProducer));
+  }
+  // Joining the producers guarantees every task has been posted.
+  producers.clear();
+
+  RunLoop().RunUntilIdle();
+  EXPECT_EQ(kNumProducers * kTasksPerProducer, recorder.num_received());
+  EXPECT_EQ(0, recorder.out_of_order());
+  EXPECT_TRUE(loop.IsIdleForTesting());
+}
+
 }  // namespace base
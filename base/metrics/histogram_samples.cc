@@ -4,6 +4,7 @@
 
 #include "base/metrics/histogram_samples.h"
 
+#include "base/atomicops.h"
 #include "base/compiler_specific.h"
 #include "base/pickle.h"
 
@@ -63,8 +64,8 @@ HistogramSamples::HistogramSamples() : sum_(0), redundant_count_(0) {}
 HistogramSamples::~HistogramSamples() {}
 
 void HistogramSamples::Add(const HistogramSamples& other) {
-  sum_ += other.sum();
-  redundant_count_ += other.redundant_count();
+  IncreaseSum(other.sum());
+  IncreaseRedundantCount(other.redundant_count());
   bool success = AddSubtractImpl(other.Iterator().get(), ADD);
   DCHECK(success);
 }
@@ -75,16 +76,16 @@ bool HistogramSamples::AddFromPickle(PickleIterator* iter) {
 
   if (!iter->ReadInt64(&sum) || !iter->ReadInt(&redundant_count))
     return false;
-  sum_ += sum;
-  redundant_count_ += redundant_count;
+  IncreaseSum(sum);
+  IncreaseRedundantCount(redundant_count);
 
   SampleCountPickleIterator pickle_iter(iter);
   return AddSubtractImpl(&pickle_iter, ADD);
 }
 
 void HistogramSamples::Subtract(const HistogramSamples& other) {
-  sum_ -= other.sum();
-  redundant_count_ -= other.redundant_count();
+  IncreaseSum(-other.sum());
+  IncreaseRedundantCount(-other.redundant_count());
   bool success = AddSubtractImpl(other.Iterator().get(), SUBTRACT);
   DCHECK(success);
 }
@@ -109,11 +110,18 @@ bool HistogramSamples::Serialize(Pickle* pickle) const {
 }
 
 void HistogramSamples::IncreaseSum(int64 diff) {
+#if defined(ARCH_CPU_64_BITS)
+  subtle::NoBarrier_AtomicIncrement(
+      reinterpret_cast<volatile subtle::Atomic64*>(&sum_), diff);
+#else
+  // There are no 64-bit atomics on 32-bit platforms; a racing update of the
+  // sum is accepted there, like any other mismatch |redundant_count_| catches.
   sum_ += diff;
+#endif
 }
 
 void HistogramSamples::IncreaseRedundantCount(HistogramBase::Count diff) {
-  redundant_count_ += diff;
+  subtle::NoBarrier_AtomicIncrement(&redundant_count_, diff);
 }
 
 SampleCountIterator::~SampleCountIterator() {}
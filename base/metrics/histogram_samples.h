@@ -46,6 +46,8 @@ class BASE_EXPORT HistogramSamples {
   enum Operator { ADD, SUBTRACT };
   virtual bool AddSubtractImpl(SampleCountIterator* iter, Operator op) = 0;
 
+  // These are thread safe, so that samples can be recorded from any thread
+  // without locking. (On 32-bit platforms updates of the sum may race.)
   void IncreaseSum(int64 diff);
   void IncreaseRedundantCount(HistogramBase::Count diff);
 
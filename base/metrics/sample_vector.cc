@@ -4,6 +4,7 @@
 
 #include "base/metrics/sample_vector.h"
 
+#include "base/atomicops.h"
 #include "base/logging.h"
 #include "base/metrics/bucket_ranges.h"
 
@@ -24,7 +25,7 @@ SampleVector::~SampleVector() {}
 
 void SampleVector::Accumulate(Sample value, Count count) {
   size_t bucket_index = GetBucketIndex(value);
-  counts_[bucket_index] += count;
+  subtle::NoBarrier_AtomicIncrement(&counts_[bucket_index], count);
   IncreaseSum(count * value);
   IncreaseRedundantCount(count);
 }
@@ -65,7 +66,8 @@ bool SampleVector::AddSubtractImpl(SampleCountIterator* iter,
     if (min == bucket_ranges_->range(index) &&
         max == bucket_ranges_->range(index + 1)) {
       // Sample matches this bucket!
-      counts_[index] += (op ==  HistogramSamples::ADD) ? count : -count;
+      subtle::NoBarrier_AtomicIncrement(
+          &counts_[index], (op == HistogramSamples::ADD) ? count : -count);
       iter->Next();
     } else if (min > bucket_ranges_->range(index)) {
       // Sample is larger than current bucket range. Try next.
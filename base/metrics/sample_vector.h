@@ -46,6 +46,8 @@ class BASE_EXPORT_PRIVATE SampleVector : public HistogramSamples {
  private:
   FRIEND_TEST_ALL_PREFIXES(HistogramTest, CorruptSampleCounts);
 
+  // Updated with atomic increments, so that several threads can accumulate
+  // samples into the same histogram without a lock.
   std::vector<HistogramBase::Count> counts_;
 
   // Shares the same BucketRanges with Histogram object.
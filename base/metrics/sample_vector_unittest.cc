@@ -4,10 +4,14 @@
 
 #include <vector>
 
+#include "base/bind.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/metrics/bucket_ranges.h"
 #include "base/metrics/histogram.h"
 #include "base/metrics/sample_vector.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/thread.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 using std::vector;
@@ -42,6 +46,37 @@ TEST(SampleVectorTest, AccumulateTest) {
   EXPECT_EQ(samples.TotalCount(), samples.redundant_count());
 }
 
+void AccumulateMany(SampleVector* samples, int num_samples) {
+  for (int i = 0; i < num_samples; ++i)
+    samples->Accumulate(i % 10, 1);
+}
+
+// Samples accumulated concurrently from several threads must not get lost.
+TEST(SampleVectorTest, AccumulateFromManyThreads) {
+  // Custom buckets: [0, 5) [5, 10)
+  BucketRanges ranges(3);
+  ranges.set_range(0, 0);
+  ranges.set_range(1, 5);
+  ranges.set_range(2, 10);
+  SampleVector samples(&ranges);
+
+  const int kNumThreads = 4;
+  const int kSamplesPerThread = 100000;
+  ScopedVector<Thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.push_back(new Thread(StringPrintf("Accumulator%d", i)));
+    ASSERT_TRUE(threads.back()->Start());
+    threads.back()->message_loop()->PostTask(
+        FROM_HERE, Bind(&AccumulateMany, &samples, kSamplesPerThread));
+  }
+  threads.clear();  // Joins the threads.
+
+  EXPECT_EQ(kNumThreads * kSamplesPerThread / 2, samples.GetCountAtIndex(0));
+  EXPECT_EQ(kNumThreads * kSamplesPerThread / 2, samples.GetCountAtIndex(1));
+  EXPECT_EQ(kNumThreads * kSamplesPerThread, samples.redundant_count());
+  EXPECT_EQ(samples.TotalCount(), samples.redundant_count());
+}
+
 TEST(SampleVectorTest, AddSubtractTest) {
   // Custom buckets: [0, 1) [1, 2) [2, 3) [3, INT_MAX)
   BucketRanges ranges(5);
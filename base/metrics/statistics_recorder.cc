@@ -5,7 +5,9 @@
 #include "base/metrics/statistics_recorder.h"
 
 #include "base/at_exit.h"
+#include "base/atomicops.h"
 #include "base/debug/leak_annotations.h"
+#include "base/hash.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram.h"
@@ -19,6 +21,55 @@ namespace {
 // Initialize histogram statistics gathering system.
 base::LazyInstance<base::StatisticsRecorder>::Leaky g_statistics_recorder_ =
     LAZY_INSTANCE_INITIALIZER;
+
+// Registered histograms are also published in this insert-only, open
+// addressing hash table so that FindHistogram() can find them without taking
+// StatisticsRecorder::lock_. Slots are only written while holding the lock,
+// and are never reused until the StatisticsRecorder is destroyed. Histograms
+// are leaked, so a reader never sees a dangling pointer. Must be a power of 2.
+const size_t kLookupTableSize = 4096;
+// Past this many entries, newly registered histograms are only found through
+// the locked map, which keeps the probe sequences short.
+const size_t kLookupTableMaxEntries = kLookupTableSize / 4 * 3;
+
+base::subtle::AtomicWord g_lookup_table[kLookupTableSize];
+size_t g_lookup_table_entries = 0;  // Protected by StatisticsRecorder::lock_.
+
+base::HistogramBase* LookupTableFind(const std::string& name) {
+  size_t index = base::Hash(name) & (kLookupTableSize - 1);
+  for (size_t probes = 0; probes < kLookupTableSize; ++probes) {
+    base::HistogramBase* histogram = reinterpret_cast<base::HistogramBase*>(
+        base::subtle::Acquire_Load(&g_lookup_table[index]));
+    if (!histogram)
+      return NULL;
+    if (histogram->histogram_name() == name)
+      return histogram;
+    index = (index + 1) & (kLookupTableSize - 1);
+  }
+  return NULL;
+}
+
+// Must be called with StatisticsRecorder::lock_ held.
+void LookupTableInsert(base::HistogramBase* histogram) {
+  if (g_lookup_table_entries >= kLookupTableMaxEntries)
+    return;
+  size_t index =
+      base::Hash(histogram->histogram_name()) & (kLookupTableSize - 1);
+  while (base::subtle::NoBarrier_Load(&g_lookup_table[index]))
+    index = (index + 1) & (kLookupTableSize - 1);
+  base::subtle::Release_Store(
+      &g_lookup_table[index],
+      reinterpret_cast<base::subtle::AtomicWord>(histogram));
+  ++g_lookup_table_entries;
+}
+
+// Must be called with StatisticsRecorder::lock_ held.
+void LookupTableClear() {
+  for (size_t i = 0; i < kLookupTableSize; ++i)
+    base::subtle::NoBarrier_Store(&g_lookup_table[i], 0);
+  g_lookup_table_entries = 0;
+}
+
 }  // namespace
 
 namespace base {
@@ -62,6 +113,7 @@ HistogramBase* StatisticsRecorder::RegisterOrDeleteDuplicate(
       HistogramMap::iterator it = histograms_->find(name);
       if (histograms_->end() == it) {
         (*histograms_)[name] = histogram;
+        LookupTableInsert(histogram);
         ANNOTATE_LEAKING_OBJECT_PTR(histogram);  // see crbug.com/79322
         histogram_to_return = histogram;
       } else if (histogram == it->second) {
@@ -204,6 +256,11 @@ void StatisticsRecorder::GetBucketRanges(
 HistogramBase* StatisticsRecorder::FindHistogram(const std::string& name) {
   if (lock_ == NULL)
     return NULL;
+  // Histograms are looked up far more often than they are registered.
+  HistogramBase* histogram = LookupTableFind(name);
+  if (histogram)
+    return histogram;
+
   base::AutoLock auto_lock(*lock_);
   if (histograms_ == NULL)
     return NULL;
@@ -277,6 +334,7 @@ StatisticsRecorder::~StatisticsRecorder() {
     ranges_deleter.reset(ranges_);
     histograms_ = NULL;
     ranges_ = NULL;
+    LookupTableClear();
   }
   // We are going to leak the histograms and the ranges.
 }
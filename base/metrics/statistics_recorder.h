@@ -62,7 +62,8 @@ class BASE_EXPORT StatisticsRecorder {
   static void GetBucketRanges(std::vector<const BucketRanges*>* output);
 
   // Find a histogram by name. It matches the exact name. This method is thread
-  // safe.  It returns NULL if a matching histogram is not found.
+  // safe, and usually lock-free once the histogram has been registered.  It
+  // returns NULL if a matching histogram is not found.
   static HistogramBase* FindHistogram(const std::string& name);
 
   // GetSnapshot copies some of the pointers to registered histograms into the
@@ -7,6 +7,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram.h"
 #include "base/metrics/statistics_recorder.h"
+#include "base/strings/stringprintf.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace base {
@@ -149,6 +150,41 @@ TEST_F(StatisticsRecorderTest, FindHistogram) {
   EXPECT_TRUE(StatisticsRecorder::FindHistogram("TestHistogram") == NULL);
 }
 
+TEST_F(StatisticsRecorderTest, FindHistogramAfterReset) {
+  HistogramBase* histogram = Histogram::FactoryGet(
+      "TestHistogram", 1, 1000, 10, HistogramBase::kNoFlags);
+  EXPECT_EQ(histogram, StatisticsRecorder::FindHistogram("TestHistogram"));
+
+  // A new StatisticsRecorder does not know about histograms registered with
+  // the previous one.
+  UninitializeStatisticsRecorder();
+  EXPECT_TRUE(StatisticsRecorder::FindHistogram("TestHistogram") == NULL);
+  InitializeStatisticsRecorder();
+  EXPECT_TRUE(StatisticsRecorder::FindHistogram("TestHistogram") == NULL);
+
+  HistogramBase* new_histogram = Histogram::FactoryGet(
+      "TestHistogram", 1, 1000, 10, HistogramBase::kNoFlags);
+  EXPECT_NE(histogram, new_histogram);
+  EXPECT_EQ(new_histogram, StatisticsRecorder::FindHistogram("TestHistogram"));
+}
+
+TEST_F(StatisticsRecorderTest, FindManyHistograms) {
+  // More histograms than the lock-free lookup table holds; the rest must be
+  // found through the map.
+  const int kNumHistograms = 5000;
+  std::vector<HistogramBase*> histograms;
+  for (int i = 0; i < kNumHistograms; ++i) {
+    histograms.push_back(Histogram::FactoryGet(
+        StringPrintf("TestHistogram%d", i), 1, 1000, 10,
+        HistogramBase::kNoFlags));
+  }
+  for (int i = 0; i < kNumHistograms; ++i) {
+    EXPECT_EQ(histograms[i], StatisticsRecorder::FindHistogram(
+        StringPrintf("TestHistogram%d", i)));
+  }
+  EXPECT_TRUE(StatisticsRecorder::FindHistogram("TestHistogram") == NULL);
+}
+
 TEST_F(StatisticsRecorderTest, GetSnapshot) {
   Histogram::FactoryGet("TestHistogram1", 1, 1000, 10, Histogram::kNoFlags);
   Histogram::FactoryGet("TestHistogram2", 1, 1000, 10, Histogram::kNoFlags);
@@ -57,4 +57,20 @@ void TaskQueue::Swap(TaskQueue* queue) {
   c.swap(queue->c);  // Calls std::deque::swap.
 }
 
+void TaskQueue::MoveAndPush(PendingTask* pending_task) {
+  Closure task;
+  task.Swap(&pending_task->task);
+  push(*pending_task);
+  back().task.Swap(&task);
+}
+
+PendingTask TaskQueue::MoveAndPop() {
+  Closure task;
+  task.Swap(&front().task);
+  PendingTask pending_task = front();
+  pop();
+  pending_task.task.Swap(&task);
+  return pending_task;
+}
+
 }  // namespace base
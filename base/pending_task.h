@@ -5,11 +5,13 @@
 #ifndef PENDING_TASK_H_
 #define PENDING_TASK_H_
 
+#include <deque>
 #include <queue>
 
 #include "base/base_export.h"
 #include "base/callback.h"
 #include "base/location.h"
+#include "base/memory/object_pool.h"
 #include "base/time/time.h"
 #include "base/tracking_info.h"
 
@@ -46,10 +48,22 @@ struct BASE_EXPORT PendingTask : public TrackingInfo {
 };
 
 // Wrapper around std::queue specialized for PendingTask which adds a Swap
-// helper method.
-class BASE_EXPORT TaskQueue : public std::queue<PendingTask> {
+// helper method. The chunks of the queue come from the ObjectPool, as they are
+// allocated and freed continuously while tasks flow through the queue.
+class BASE_EXPORT TaskQueue
+    : public std::queue<PendingTask,
+                        std::deque<PendingTask, PoolAllocator<PendingTask> > > {
  public:
   void Swap(TaskQueue* queue);
+
+  // Adds |pending_task| to the back of the queue, moving its task rather than
+  // copying it, which leaves |pending_task->task| null. Saves the atomic
+  // reference count updates of copying the Closure and then dropping it.
+  void MoveAndPush(PendingTask* pending_task);
+
+  // Removes the front of the queue and returns it, moving its task out rather
+  // than copying it.
+  PendingTask MoveAndPop();
 };
 
 // PendingTasks are sorted by their |delayed_run_time| property.
@@ -15,9 +15,14 @@ const int Pickle::kPayloadUnit = 64;
 
 static const size_t kCapacityReadOnly = static_cast<size_t>(-1);
 
+// Source of the padding that follows external data in GetSegments().
+static const char kZeroPadding[sizeof(uint32)] = { 0 };
+
 PickleIterator::PickleIterator(const Pickle& pickle)
     : read_ptr_(pickle.payload()),
       read_end_ptr_(pickle.end_of_payload()) {
+  // External data is not contiguous with the payload.
+  CHECK(!pickle.has_external_data());
 }
 
 template <typename Type>
@@ -154,7 +159,8 @@ Pickle::Pickle()
     : header_(NULL),
       header_size_(sizeof(Header)),
       capacity_(0),
-      variable_buffer_offset_(0) {
+      variable_buffer_offset_(0),
+      external_size_(0) {
   Resize(kPayloadUnit);
   header_->payload_size = 0;
 }
@@ -163,7 +169,8 @@ Pickle::Pickle(int header_size)
     : header_(NULL),
       header_size_(AlignInt(header_size, sizeof(uint32))),
       capacity_(0),
-      variable_buffer_offset_(0) {
+      variable_buffer_offset_(0),
+      external_size_(0) {
   DCHECK_GE(static_cast<size_t>(header_size), sizeof(Header));
   DCHECK_LE(header_size, kPayloadUnit);
   Resize(kPayloadUnit);
@@ -174,7 +181,8 @@ Pickle::Pickle(const char* data, int data_len)
     : header_(reinterpret_cast<Header*>(const_cast<char*>(data))),
       header_size_(0),
       capacity_(kCapacityReadOnly),
-      variable_buffer_offset_(0) {
+      variable_buffer_offset_(0),
+      external_size_(0) {
   if (data_len >= static_cast<int>(sizeof(Header)))
     header_size_ = data_len - header_->payload_size;
 
@@ -193,8 +201,10 @@ Pickle::Pickle(const Pickle& other)
     : header_(NULL),
       header_size_(other.header_size_),
       capacity_(0),
-      variable_buffer_offset_(other.variable_buffer_offset_) {
-  size_t payload_size = header_size_ + other.header_->payload_size;
+      variable_buffer_offset_(other.variable_buffer_offset_),
+      external_data_(other.external_data_),
+      external_size_(other.external_size_) {
+  size_t payload_size = header_size_ + other.inline_payload_size();
   bool resized = Resize(payload_size);
   CHECK(resized);  // Realloc failed.
   memcpy(header_, other.header_, payload_size);
@@ -219,11 +229,13 @@ Pickle& Pickle::operator=(const Pickle& other) {
     header_ = NULL;
     header_size_ = other.header_size_;
   }
-  bool resized = Resize(other.header_size_ + other.header_->payload_size);
+  bool resized = Resize(other.header_size_ + other.inline_payload_size());
   CHECK(resized);  // Realloc failed.
   memcpy(header_, other.header_,
-         other.header_size_ + other.header_->payload_size);
+         other.header_size_ + other.inline_payload_size());
   variable_buffer_offset_ = other.variable_buffer_offset_;
+  external_data_ = other.external_data_;
+  external_size_ = other.external_size_;
   return *this;
 }
 
@@ -289,6 +301,7 @@ char* Pickle::BeginWriteData(int length) {
 
 void Pickle::TrimWriteData(int new_length) {
   DCHECK_NE(variable_buffer_offset_, 0U);
+  DCHECK(!has_external_data());
 
   // Fetch the the variable buffer size
   int* cur_length = reinterpret_cast<int*>(
@@ -304,9 +317,100 @@ void Pickle::TrimWriteData(int new_length) {
   *cur_length = new_length;
 }
 
+bool Pickle::WriteDataNoCopy(
+    const scoped_refptr<base::RefCountedMemory>& data) {
+  DCHECK_NE(kCapacityReadOnly, capacity_) << "oops: pickle is readonly";
+
+  size_t length = data->size();
+  size_t padded_length = AlignInt(length, sizeof(uint32));
+  if (length > static_cast<size_t>(kint32max) ||
+      padded_length + sizeof(int) > kuint32max - header_->payload_size) {
+    return false;
+  }
+  if (!WriteInt(static_cast<int>(length)))
+    return false;
+
+  // The length was just written, so the inline payload is uint32-aligned.
+  ExternalData external;
+  external.offset = inline_payload_size();
+  external.data = data;
+  external_data_.push_back(external);
+
+  external_size_ += padded_length;
+  header_->payload_size += static_cast<uint32>(padded_length);
+  return true;
+}
+
+void Pickle::Flatten() {
+  if (external_data_.empty())
+    return;
+
+  size_t inline_size = inline_payload_size();
+  size_t payload_size = header_->payload_size;
+  bool resized = Resize(header_size_ + payload_size);
+  CHECK(resized);  // Realloc failed.
+
+  // Walk backwards, moving each run of inline bytes to its final position and
+  // copying the external data that precedes it in front of it.
+  char* payload = mutable_payload();
+  size_t src_end = inline_size;
+  size_t dest_end = payload_size;
+  for (size_t i = external_data_.size(); i > 0; --i) {
+    const ExternalData& external = external_data_[i - 1];
+    size_t run = src_end - external.offset;
+    dest_end -= run;
+    memmove(payload + dest_end, payload + external.offset, run);
+
+    size_t length = external.data->size();
+    dest_end -= AlignInt(length, sizeof(uint32));
+    if (length)
+      memcpy(payload + dest_end, external.data->front(), length);
+    EndWrite(payload + dest_end, static_cast<int>(length));
+    src_end = external.offset;
+  }
+  DCHECK_EQ(src_end, dest_end);
+
+  external_data_.clear();
+  external_size_ = 0;
+}
+
+void Pickle::GetSegments(std::vector<Segment>* segments) const {
+  const char* start = reinterpret_cast<const char*>(header_);
+  size_t inline_begin = 0;
+  for (size_t i = 0; i < external_data_.size(); ++i) {
+    const ExternalData& external = external_data_[i];
+    size_t inline_end = header_size_ + external.offset;
+    if (inline_end > inline_begin) {
+      Segment segment = { start + inline_begin, inline_end - inline_begin };
+      segments->push_back(segment);
+    }
+    inline_begin = inline_end;
+
+    size_t length = external.data->size();
+    if (length) {
+      Segment segment = {
+        reinterpret_cast<const char*>(external.data->front()), length };
+      segments->push_back(segment);
+    }
+    size_t padding = AlignInt(length, sizeof(uint32)) - length;
+    if (padding) {
+      Segment segment = { kZeroPadding, padding };
+      segments->push_back(segment);
+    }
+  }
+
+  size_t inline_end = header_size_ + inline_payload_size();
+  if (inline_end > inline_begin) {
+    Segment segment = { start + inline_begin, inline_end - inline_begin };
+    segments->push_back(segment);
+  }
+}
+
 char* Pickle::BeginWrite(size_t length) {
-  // write at a uint32-aligned offset from the beginning of the header
-  size_t offset = AlignInt(header_->payload_size, sizeof(uint32));
+  // write at a uint32-aligned offset from the beginning of the header. The
+  // external data size is itself aligned, so the inline offset is too.
+  size_t offset =
+      AlignInt(header_->payload_size, sizeof(uint32)) - external_size_;
 
   size_t new_size = offset + length;
   size_t needed_size = header_size_ + new_size;
@@ -317,7 +421,7 @@ char* Pickle::BeginWrite(size_t length) {
   DCHECK_LE(length, kuint32max);
 #endif
 
-  header_->payload_size = static_cast<uint32>(new_size);
+  header_->payload_size = static_cast<uint32>(new_size + external_size_);
   return mutable_payload() + offset;
 }
 
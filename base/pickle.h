@@ -6,12 +6,14 @@
 #define BASE_PICKLE_H__
 
 #include <string>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/gtest_prod_util.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/strings/string16.h"
 
 class Pickle;
@@ -129,10 +131,13 @@ class BASE_EXPORT Pickle {
   // Performs a deep copy.
   Pickle& operator=(const Pickle& other);
 
-  // Returns the size of the Pickle's data.
+  // Returns the size of the Pickle's data, including any data written with
+  // WriteDataNoCopy().
   size_t size() const { return header_size_ + header_->payload_size; }
 
-  // Returns the data for this Pickle.
+  // Returns the data for this Pickle. If the Pickle has external data, only
+  // the part that precedes the first external segment is contiguous with the
+  // header; use GetSegments() or Flatten() to get at the rest.
   const void* data() const { return header_; }
 
   // For compatibility, these older style read methods pass through to the
@@ -257,6 +262,33 @@ class BASE_EXPORT Pickle {
   // not been changed.
   void TrimWriteData(int length);
 
+  // Same as WriteData, but only takes a reference to |data| instead of
+  // copying it into the Pickle. The bytes are gathered from |data| when the
+  // Pickle is sent (see GetSegments()), which saves a copy for large blobs.
+  // The resulting wire format is identical to WriteData's, so the reader uses
+  // ReadData as usual. A Pickle with external data cannot be read from until
+  // Flatten() has been called on it.
+  bool WriteDataNoCopy(const scoped_refptr<base::RefCountedMemory>& data);
+
+  // Returns true if WriteDataNoCopy() has been used since the last Flatten().
+  bool has_external_data() const { return !external_data_.empty(); }
+
+  // Copies all external data into the Pickle's own buffer, so that data()
+  // spans size() bytes again. Does nothing if there is no external data.
+  void Flatten();
+
+  // A contiguous run of bytes belonging to the Pickle.
+  struct Segment {
+    const char* data;
+    size_t size;
+  };
+
+  // Appends the runs of bytes that make up the serialized Pickle, in order,
+  // to |segments|. Their sizes add up to size(). Without external data this
+  // is the single segment {data(), size()}. The segments are only valid until
+  // the next write operation on this Pickle.
+  void GetSegments(std::vector<Segment>* segments) const;
+
   // Payload follows after allocation of Header (header size is customizable).
   struct Header {
     uint32 payload_size;  // Specifies the size of the payload.
@@ -284,7 +316,7 @@ class BASE_EXPORT Pickle {
   }
 
   // Returns the address of the byte immediately following the currently valid
-  // header + payload.
+  // header + payload. Only meaningful if there is no external data.
   const char* end_of_payload() const {
     // This object may be invalid.
     return header_ ? payload() + payload_size() : NULL;
@@ -339,6 +371,22 @@ class BASE_EXPORT Pickle {
   size_t capacity_;
   size_t variable_buffer_offset_;  // IF non-zero, then offset to a buffer.
 
+  // Data referenced by WriteDataNoCopy(). |offset| is where the data belongs
+  // in the inline payload, i.e. how many inline payload bytes precede it.
+  struct ExternalData {
+    size_t offset;
+    scoped_refptr<base::RefCountedMemory> data;
+  };
+  std::vector<ExternalData> external_data_;
+  // Number of bytes, padding included, that are counted in payload_size but
+  // are not stored inline.
+  size_t external_size_;
+
+  // Returns the number of payload bytes stored in the Pickle's own buffer.
+  size_t inline_payload_size() const {
+    return header_->payload_size - external_size_;
+  }
+
   FRIEND_TEST_ALL_PREFIXES(PickleTest, Resize);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNext);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNextWithIncompleteHeader);
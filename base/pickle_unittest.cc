@@ -3,8 +3,10 @@
 // found in the LICENSE file.
 
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/pickle.h"
 #include "base/strings/string16.h"
@@ -340,3 +342,117 @@ TEST(PickleTest, ReadBytes) {
   memcpy(&outdata, outdata_char, sizeof(outdata));
   EXPECT_EQ(data, outdata);
 }
+
+namespace {
+
+// Concatenates the segments of |pickle| into a single string.
+std::string GatherSegments(const Pickle& pickle) {
+  std::vector<Pickle::Segment> segments;
+  pickle.GetSegments(&segments);
+  std::string result;
+  for (size_t i = 0; i < segments.size(); ++i)
+    result.append(segments[i].data, segments[i].size);
+  return result;
+}
+
+std::string PickleBytes(const Pickle& pickle) {
+  return std::string(static_cast<const char*>(pickle.data()), pickle.size());
+}
+
+}  // namespace
+
+// Check that data written with WriteDataNoCopy serializes exactly like data
+// written with WriteData.
+TEST(PickleTest, WriteDataNoCopy) {
+  scoped_refptr<base::RefCountedMemory> blob(
+      new base::RefCountedStaticMemory(
+          reinterpret_cast<const unsigned char*>(teststr.data()),
+          teststr.size()));
+
+  Pickle expected;
+  EXPECT_TRUE(expected.WriteInt(testint));
+  EXPECT_TRUE(expected.WriteData(teststr.data(), teststr.size()));
+  EXPECT_TRUE(expected.WriteBool(testbool2));
+  EXPECT_TRUE(expected.WriteData(teststr.data(), teststr.size()));
+  EXPECT_TRUE(expected.WriteData(teststr.data(), teststr.size()));
+  EXPECT_TRUE(expected.WriteUInt16(testuint16));
+
+  Pickle pickle;
+  EXPECT_TRUE(pickle.WriteInt(testint));
+  EXPECT_TRUE(pickle.WriteDataNoCopy(blob));
+  EXPECT_TRUE(pickle.WriteBool(testbool2));
+  EXPECT_TRUE(pickle.WriteDataNoCopy(blob));
+  EXPECT_TRUE(pickle.WriteDataNoCopy(blob));
+  EXPECT_TRUE(pickle.WriteUInt16(testuint16));
+  EXPECT_TRUE(pickle.has_external_data());
+  EXPECT_EQ(expected.size(), pickle.size());
+
+  std::vector<Pickle::Segment> segments;
+  pickle.GetSegments(&segments);
+  // The external data is referenced, not copied.
+  bool found_blob = false;
+  for (size_t i = 0; i < segments.size(); ++i)
+    found_blob |= segments[i].data == teststr.data();
+  EXPECT_TRUE(found_blob);
+  EXPECT_EQ(PickleBytes(expected), GatherSegments(pickle));
+
+  // Copies keep referencing the external data.
+  Pickle copy(pickle);
+  EXPECT_TRUE(copy.has_external_data());
+  EXPECT_EQ(PickleBytes(expected), GatherSegments(copy));
+
+  pickle.Flatten();
+  EXPECT_FALSE(pickle.has_external_data());
+  EXPECT_EQ(PickleBytes(expected), PickleBytes(pickle));
+
+  PickleIterator iter(pickle);
+  int outint;
+  EXPECT_TRUE(pickle.ReadInt(&iter, &outint));
+  EXPECT_EQ(testint, outint);
+  const char* outdata;
+  int outdatalen;
+  EXPECT_TRUE(pickle.ReadData(&iter, &outdata, &outdatalen));
+  EXPECT_EQ(teststr, std::string(outdata, outdatalen));
+}
+
+// Check that writes after external data land after it, and that a Pickle
+// without external data has a single segment.
+TEST(PickleTest, WriteDataNoCopyThenWrite) {
+  Pickle pickle;
+  EXPECT_TRUE(pickle.WriteInt(testint));
+  std::vector<Pickle::Segment> segments;
+  pickle.GetSegments(&segments);
+  ASSERT_EQ(1U, segments.size());
+  EXPECT_EQ(pickle.data(), segments[0].data);
+  EXPECT_EQ(pickle.size(), segments[0].size);
+
+  std::string large(10000, 'x');
+  EXPECT_TRUE(pickle.WriteDataNoCopy(base::RefCountedString::TakeString(
+      &large)));
+  // Enough inline writes to force the buffer to grow.
+  for (int i = 0; i < 100; ++i)
+    EXPECT_TRUE(pickle.WriteString(teststr));
+  EXPECT_TRUE(pickle.WriteDataNoCopy(
+      new base::RefCountedStaticMemory(NULL, 0)));
+  EXPECT_TRUE(pickle.WriteInt(testint));
+
+  pickle.Flatten();
+  PickleIterator iter(pickle);
+  int outint;
+  EXPECT_TRUE(pickle.ReadInt(&iter, &outint));
+  EXPECT_EQ(testint, outint);
+  const char* outdata;
+  int outdatalen;
+  EXPECT_TRUE(pickle.ReadData(&iter, &outdata, &outdatalen));
+  EXPECT_EQ(std::string(10000, 'x'), std::string(outdata, outdatalen));
+  for (int i = 0; i < 100; ++i) {
+    std::string outstr;
+    EXPECT_TRUE(pickle.ReadString(&iter, &outstr));
+    EXPECT_EQ(teststr, outstr);
+  }
+  EXPECT_TRUE(pickle.ReadData(&iter, &outdata, &outdatalen));
+  EXPECT_EQ(0, outdatalen);
+  EXPECT_TRUE(pickle.ReadInt(&iter, &outint));
+  EXPECT_EQ(testint, outint);
+  EXPECT_FALSE(pickle.ReadInt(&iter, &outint));
+}
@@ -5,15 +5,20 @@
 #include "base/prefs/json_pref_store.h"
 
 #include <algorithm>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/callback.h"
+#include "base/critical_closure.h"
 #include "base/file_util.h"
 #include "base/json/json_file_value_serializer.h"
+#include "base/json/json_reader.h"
 #include "base/json/json_string_value_serializer.h"
+#include "base/json/json_writer.h"
 #include "base/memory/ref_counted.h"
 #include "base/message_loop/message_loop_proxy.h"
 #include "base/sequenced_task_runner.h"
+#include "base/strings/string_split.h"
 #include "base/threading/sequenced_worker_pool.h"
 #include "base/values.h"
 
@@ -21,6 +26,66 @@ namespace {
 
 // Some extensions we'll tack on to copies of the Preferences files.
 const base::FilePath::CharType* kBadExtension = FILE_PATH_LITERAL("bad");
+const base::FilePath::CharType* kJournalExtension =
+    FILE_PATH_LITERAL("journal");
+
+// Once the journal has grown past this many bytes, the next commit rewrites
+// the whole file instead.
+const size_t kMaxJournalSize = 512 * 1024;
+
+base::FilePath GetJournalPath(const base::FilePath& path) {
+  return path.AddExtension(kJournalExtension);
+}
+
+// Appends |data| to the journal of |path|, creating it if needed.
+void AppendToJournal(const base::FilePath& path, const std::string& data) {
+  base::FilePath journal_path = GetJournalPath(path);
+  int size = static_cast<int>(data.size());
+  int written = base::PathExists(journal_path) ?
+      file_util::AppendToFile(journal_path, data.data(), size) :
+      file_util::WriteFile(journal_path, data.data(), size);
+  if (written != size)
+    DLOG(WARNING) << "failed to append to " << journal_path.value();
+}
+
+// Replaces the file at |path| with |data| and, only if that succeeded,
+// deletes its journal, whose entries |data| is expected to include.
+void WriteFileAndDeleteJournal(const base::FilePath& path,
+                               const std::string& data) {
+  if (base::ImportantFileWriter::WriteFileAtomically(path, data))
+    base::DeleteFile(GetJournalPath(path), false);
+}
+
+// Applies the entries of the journal of |path| to |prefs|. Each line of the
+// journal holds a JSON list with a preference name, followed by its new value
+// unless it was removed. Lines that cannot be parsed, such as one cut short by
+// a crash, are skipped. Returns false if there is no journal.
+bool ReplayJournal(const base::FilePath& path, base::DictionaryValue* prefs) {
+  std::string data;
+  if (!file_util::ReadFileToString(GetJournalPath(path), &data))
+    return false;
+
+  std::vector<std::string> lines;
+  base::SplitString(data, '\n', &lines);
+  for (size_t i = 0; i < lines.size(); ++i) {
+    if (lines[i].empty())
+      continue;
+    scoped_ptr<base::Value> entry(base::JSONReader::Read(lines[i]));
+    base::ListValue* list = NULL;
+    std::string key;
+    if (!entry.get() || !entry->GetAsList(&list) ||
+        !list->GetString(0, &key)) {
+      DVLOG(1) << "Skipping bad journal entry: " << lines[i];
+      continue;
+    }
+    scoped_ptr<base::Value> value;
+    if (list->Remove(1, &value))
+      prefs->Set(key, value.release());
+    else
+      prefs->Remove(key, NULL);
+  }
+  return true;
+}
 
 // Differentiates file loading between origin thread and passed
 // (aka file) thread.
@@ -69,6 +134,7 @@ class FileThreadDeserializer
     JSONFileValueSerializer serializer(path);
     base::Value* value = serializer.Deserialize(&error_code, &error_msg);
     HandleErrors(value, path, error_code, error_msg, error);
+    ApplyJournal(path, value, *error);
     *no_dir = !base::PathExists(path.DirName());
     return value;
   }
@@ -79,6 +145,12 @@ class FileThreadDeserializer
                            const std::string& error_msg,
                            PersistentPrefStore::PrefReadError* error);
 
+  // Replays the journal of |path|, if any, onto |value| and folds it into the
+  // file, or deletes the journal if the file it belongs to is gone.
+  static void ApplyJournal(const base::FilePath& path,
+                           base::Value* value,
+                           PersistentPrefStore::PrefReadError error);
+
  private:
   friend class base::RefCountedThreadSafe<FileThreadDeserializer>;
   ~FileThreadDeserializer() {}
@@ -138,6 +210,40 @@ void FileThreadDeserializer::HandleErrors(
   }
 }
 
+// static
+void FileThreadDeserializer::ApplyJournal(
+    const base::FilePath& path,
+    base::Value* value,
+    PersistentPrefStore::PrefReadError error) {
+  switch (error) {
+    case PersistentPrefStore::PREF_READ_ERROR_NONE: {
+      base::DictionaryValue* prefs = static_cast<base::DictionaryValue*>(value);
+      if (!ReplayJournal(path, prefs))
+        return;
+      // Write the replayed preferences back so that the journal does not
+      // have to be replayed again. If the process dies before the journal is
+      // deleted, replaying it onto the new file is harmless.
+      std::string data;
+      JSONStringValueSerializer serializer(&data);
+      serializer.set_pretty_print(true);
+      if (serializer.Serialize(*prefs))
+        WriteFileAndDeleteJournal(path, data);
+      break;
+    }
+    case PersistentPrefStore::PREF_READ_ERROR_NO_FILE:
+    case PersistentPrefStore::PREF_READ_ERROR_JSON_PARSE:
+    case PersistentPrefStore::PREF_READ_ERROR_JSON_REPEAT:
+      // The entries cannot be replayed without the file they were made
+      // against, and must not be replayed onto a later one.
+      base::DeleteFile(GetJournalPath(path), false);
+      break;
+    default:
+      // The file could not be read but is still there. Keep the journal for
+      // when it can be.
+      break;
+  }
+}
+
 }  // namespace
 
 scoped_refptr<base::SequencedTaskRunner> JsonPrefStore::GetTaskRunnerForFile(
@@ -158,7 +264,28 @@ JsonPrefStore::JsonPrefStore(const base::FilePath& filename,
       read_only_(false),
       writer_(filename, sequenced_task_runner),
       initialized_(false),
-      read_error_(PREF_READ_ERROR_OTHER) {}
+      read_error_(PREF_READ_ERROR_OTHER),
+      incremental_writes_(false),
+      journal_size_(0),
+      has_file_(false) {}
+
+void JsonPrefStore::SetIncrementalWritesEnabled(bool enabled) {
+  if (enabled == incremental_writes_)
+    return;
+  incremental_writes_ = enabled;
+  if (read_only_)
+    return;
+
+  if (enabled) {
+    // A whole file write scheduled earlier must not happen after journal
+    // entries have been written, or replaying them after a crash would
+    // revert any later change the file holds.
+    if (writer_.HasPendingWrite())
+      writer_.DoScheduledWrite();
+  } else if (journal_size_ || !dirty_keys_.empty()) {
+    CompactJournal();
+  }
+}
 
 bool JsonPrefStore::GetValue(const std::string& key,
                              const base::Value** result) const {
@@ -211,8 +338,7 @@ void JsonPrefStore::SetValueSilently(const std::string& key,
   prefs_->Get(key, &old_value);
   if (!old_value || !value->Equals(old_value)) {
     prefs_->Set(key, new_value.release());
-    if (!read_only_)
-      writer_.ScheduleWrite(this);
+    ScheduleWrite(key);
   }
 }
 
@@ -263,14 +389,17 @@ void JsonPrefStore::ReadPrefsAsync(ReadErrorDelegate *error_delegate) {
 }
 
 void JsonPrefStore::CommitPendingWrite() {
-  if (writer_.HasPendingWrite() && !read_only_)
+  if (read_only_)
+    return;
+  if (writer_.HasPendingWrite())
     writer_.DoScheduledWrite();
+  if (journal_timer_.IsRunning())
+    CommitJournal();
 }
 
 void JsonPrefStore::ReportValueChanged(const std::string& key) {
   FOR_EACH_OBSERVER(PrefStore::Observer, observers_, OnPrefValueChanged(key));
-  if (!read_only_)
-    writer_.ScheduleWrite(this);
+  ScheduleWrite(key);
 }
 
 void JsonPrefStore::OnFileRead(base::Value* value_owned,
@@ -278,6 +407,7 @@ void JsonPrefStore::OnFileRead(base::Value* value_owned,
                                bool no_dir) {
   scoped_ptr<base::Value> value(value_owned);
   read_error_ = error;
+  has_file_ = error == PREF_READ_ERROR_NONE;
 
   if (no_dir) {
     FOR_EACH_OBSERVER(PrefStore::Observer,
@@ -356,3 +486,85 @@ bool JsonPrefStore::SerializeData(std::string* output) {
 
   return serializer.Serialize(*(copy.get()));
 }
+
+void JsonPrefStore::ScheduleWrite(const std::string& key) {
+  if (read_only_)
+    return;
+
+  if (!incremental_writes_) {
+    writer_.ScheduleWrite(this);
+    return;
+  }
+
+  dirty_keys_.insert(key);
+  if (!journal_timer_.IsRunning()) {
+    journal_timer_.Start(FROM_HERE, writer_.commit_interval(), this,
+                         &JsonPrefStore::CommitJournal);
+  }
+}
+
+void JsonPrefStore::CommitJournal() {
+  journal_timer_.Stop();
+  if (dirty_keys_.empty())
+    return;
+
+  // Journal entries can only be replayed onto an existing file.
+  if (!has_file_ || journal_size_ >= kMaxJournalSize) {
+    CompactJournal();
+    return;
+  }
+
+  AppendDirtyKeysToJournal();
+}
+
+void JsonPrefStore::CompactJournal() {
+  journal_timer_.Stop();
+
+  // The journal has to hold every change the new file holds before the file
+  // is written. Otherwise, if the journal cannot be deleted afterwards,
+  // replaying its older entries would revert those changes.
+  if (has_file_)
+    AppendDirtyKeysToJournal();
+  dirty_keys_.clear();
+
+  std::string data;
+  if (!SerializeData(&data)) {
+    DLOG(WARNING) << "failed to serialize data to be saved in "
+                  << path_.value().c_str();
+    return;
+  }
+
+  sequenced_task_runner_->PostTask(
+      FROM_HERE,
+      base::MakeCriticalClosure(
+          base::Bind(&WriteFileAndDeleteJournal, path_, data)));
+  has_file_ = true;
+  journal_size_ = 0;
+}
+
+void JsonPrefStore::AppendDirtyKeysToJournal() {
+  if (dirty_keys_.empty())
+    return;
+
+  // Start on a new line in case the last append was cut short.
+  std::string data("\n");
+  for (std::set<std::string>::const_iterator it = dirty_keys_.begin();
+       it != dirty_keys_.end(); ++it) {
+    base::ListValue entry;
+    entry.AppendString(*it);
+    const base::Value* value = NULL;
+    if (prefs_->Get(*it, &value))
+      entry.Append(value->DeepCopy());
+
+    std::string line;
+    base::JSONWriter::Write(&entry, &line);
+    data.append(line);
+    data.push_back('\n');
+  }
+  dirty_keys_.clear();
+
+  sequenced_task_runner_->PostTask(
+      FROM_HERE,
+      base::MakeCriticalClosure(base::Bind(&AppendToJournal, path_, data)));
+  journal_size_ += data.size();
+}
@@ -17,6 +17,7 @@
 #include "base/observer_list.h"
 #include "base/prefs/base_prefs_export.h"
 #include "base/prefs/persistent_pref_store.h"
+#include "base/timer/timer.h"
 
 namespace base {
 class DictionaryValue;
@@ -28,6 +29,16 @@ class Value;
 
 
 // A writable PrefStore implementation that is used for user preferences.
+//
+// By default every commit rewrites the whole preferences file with
+// ImportantFileWriter. With incremental writes enabled, commits instead append
+// the preferences that changed since the last commit to a journal next to the
+// file, one JSON entry per line, and the file itself is only rewritten once
+// the journal has grown large. The journal is replayed and folded back into
+// the file when the preferences are read. The file is always replaced
+// atomically, and the journal is only deleted once a file that includes all
+// of its entries has been written, so a crash at any point loses at most the
+// changes that were not committed yet.
 class BASE_PREFS_EXPORT JsonPrefStore
     : public PersistentPrefStore,
       public base::ImportantFileWriter::DataSerializer {
@@ -43,6 +54,11 @@ class BASE_PREFS_EXPORT JsonPrefStore
   JsonPrefStore(const base::FilePath& pref_filename,
                 base::SequencedTaskRunner* sequenced_task_runner);
 
+  // Switches commits between rewriting the whole file (the default) and
+  // appending changed preferences to the journal; see the class comment.
+  // Disabling incremental writes folds the journal into the file right away.
+  void SetIncrementalWritesEnabled(bool enabled);
+
   // PrefStore overrides:
   virtual bool GetValue(const std::string& key,
                         const base::Value** result) const OVERRIDE;
@@ -78,6 +94,21 @@ class BASE_PREFS_EXPORT JsonPrefStore
   // ImportantFileWriter::DataSerializer overrides:
   virtual bool SerializeData(std::string* output) OVERRIDE;
 
+  // Schedules a commit of |key|, through |writer_| or the journal depending
+  // on |incremental_writes_|.
+  void ScheduleWrite(const std::string& key);
+
+  // Appends the preferences in |dirty_keys_| to the journal, then compacts it
+  // if it has grown too large.
+  void CommitJournal();
+
+  // Appends any preferences in |dirty_keys_| to the journal, rewrites the
+  // whole file and deletes the journal.
+  void CompactJournal();
+
+  // Posts the append of |dirty_keys_| to the journal and clears them.
+  void AppendDirtyKeysToJournal();
+
   base::FilePath path_;
   const scoped_refptr<base::SequencedTaskRunner> sequenced_task_runner_;
 
@@ -97,6 +128,22 @@ class BASE_PREFS_EXPORT JsonPrefStore
 
   std::set<std::string> keys_need_empty_value_;
 
+  // Whether commits go to the journal instead of rewriting the file.
+  bool incremental_writes_;
+
+  // The preferences that changed since the journal was last written.
+  std::set<std::string> dirty_keys_;
+
+  // Batches journal writes like |writer_| batches whole file writes.
+  base::OneShotTimer<JsonPrefStore> journal_timer_;
+
+  // The number of bytes appended to the journal since it was last deleted.
+  size_t journal_size_;
+
+  // Whether the preferences file exists, so that the journal has something
+  // to be replayed onto.
+  bool has_file_;
+
   DISALLOW_COPY_AND_ASSIGN(JsonPrefStore);
 };
 
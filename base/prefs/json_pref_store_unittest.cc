@@ -6,6 +6,7 @@
 
 #include "base/file_util.h"
 #include "base/files/scoped_temp_dir.h"
+#include "base/json/json_reader.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/path_service.h"
@@ -24,6 +25,9 @@ namespace {
 
 const char kHomePage[] = "homepage";
 
+const char kIncrementalContents[] =
+    "{\"homepage\": \"http://www.cnn.com\", \"tabs\": {\"max_tabs\": 20}}";
+
 class MockPrefStoreObserver : public PrefStore::Observer {
  public:
   MOCK_METHOD1(OnPrefValueChanged, void (const std::string&));
@@ -53,6 +57,20 @@ class JsonPrefStoreTest : public testing::Test {
   base::FilePath data_dir_;
   // A message loop that we can use as the file thread message loop.
   MessageLoop message_loop_;
+
+  // Writes kIncrementalContents to |pref_file_| and returns a store for it.
+  scoped_refptr<JsonPrefStore> CreateIncrementalStore() {
+    pref_file_ = temp_dir_.path().AppendASCII("write.json");
+    journal_file_ = temp_dir_.path().AppendASCII("write.json.journal");
+    EXPECT_EQ(static_cast<int>(strlen(kIncrementalContents)),
+              file_util::WriteFile(pref_file_, kIncrementalContents,
+                                   strlen(kIncrementalContents)));
+    return new JsonPrefStore(pref_file_,
+                             message_loop_.message_loop_proxy().get());
+  }
+
+  base::FilePath pref_file_;
+  base::FilePath journal_file_;
 };
 
 // Test fallback behavior for a nonexistent file.
@@ -284,4 +302,122 @@ TEST_F(JsonPrefStoreTest, NeedsEmptyValue) {
   EXPECT_TRUE(TextContentsEqual(golden_output_file, pref_file));
 }
 
+TEST_F(JsonPrefStoreTest, IncrementalWrites) {
+  {
+    scoped_refptr<JsonPrefStore> pref_store = CreateIncrementalStore();
+    pref_store->SetIncrementalWritesEnabled(true);
+    ASSERT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE,
+              pref_store->ReadPrefs());
+
+    pref_store->SetValue(kHomePage, new StringValue("http://www.google.com"));
+    pref_store->SetValue("tabs.max_tabs", new FundamentalValue(10));
+    pref_store->SetValue("tabs.new_windows_in_tabs",
+                         new FundamentalValue(true));
+    pref_store->RemoveValue("tabs.new_windows_in_tabs");
+    pref_store->CommitPendingWrite();
+    RunLoop().RunUntilIdle();
+
+    // Only the journal was written.
+    std::string contents;
+    ASSERT_TRUE(file_util::ReadFileToString(pref_file_, &contents));
+    EXPECT_EQ(kIncrementalContents, contents);
+    EXPECT_TRUE(PathExists(journal_file_));
+  }
+  RunLoop().RunUntilIdle();
+
+  // Reading replays the journal and folds it into the file.
+  scoped_refptr<JsonPrefStore> pref_store =
+      new JsonPrefStore(pref_file_, message_loop_.message_loop_proxy().get());
+  ASSERT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE,
+            pref_store->ReadPrefs());
+  EXPECT_FALSE(PathExists(journal_file_));
+
+  const Value* actual = NULL;
+  std::string homepage;
+  ASSERT_TRUE(pref_store->GetValue(kHomePage, &actual));
+  EXPECT_TRUE(actual->GetAsString(&homepage));
+  EXPECT_EQ("http://www.google.com", homepage);
+  int max_tabs = 0;
+  ASSERT_TRUE(pref_store->GetValue("tabs.max_tabs", &actual));
+  EXPECT_TRUE(actual->GetAsInteger(&max_tabs));
+  EXPECT_EQ(10, max_tabs);
+  EXPECT_FALSE(pref_store->GetValue("tabs.new_windows_in_tabs", NULL));
+
+  std::string contents;
+  ASSERT_TRUE(file_util::ReadFileToString(pref_file_, &contents));
+  EXPECT_NE(std::string::npos, contents.find("http://www.google.com"));
+}
+
+TEST_F(JsonPrefStoreTest, JournalWithBadEntries) {
+  scoped_refptr<JsonPrefStore> pref_store = CreateIncrementalStore();
+  const char kJournal[] =
+      "[\"homepage\"]\n"
+      "[\"tabs.max_tabs\", 5\n"
+      "[\"tabs.new_windows_in_tabs\", true]\n";
+  ASSERT_EQ(static_cast<int>(strlen(kJournal)),
+            file_util::WriteFile(journal_file_, kJournal, strlen(kJournal)));
+
+  ASSERT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE,
+            pref_store->ReadPrefs());
+  EXPECT_FALSE(PathExists(journal_file_));
+
+  // The removal and the last entry were applied, the torn entry was not.
+  const Value* actual = NULL;
+  EXPECT_FALSE(pref_store->GetValue(kHomePage, &actual));
+  int max_tabs = 0;
+  ASSERT_TRUE(pref_store->GetValue("tabs.max_tabs", &actual));
+  EXPECT_TRUE(actual->GetAsInteger(&max_tabs));
+  EXPECT_EQ(20, max_tabs);
+  bool new_windows_in_tabs = false;
+  ASSERT_TRUE(pref_store->GetValue("tabs.new_windows_in_tabs", &actual));
+  EXPECT_TRUE(actual->GetAsBoolean(&new_windows_in_tabs));
+  EXPECT_TRUE(new_windows_in_tabs);
+}
+
+TEST_F(JsonPrefStoreTest, DisablingIncrementalWritesCompacts) {
+  scoped_refptr<JsonPrefStore> pref_store = CreateIncrementalStore();
+  pref_store->SetIncrementalWritesEnabled(true);
+  ASSERT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE,
+            pref_store->ReadPrefs());
+
+  pref_store->SetValue(kHomePage, new StringValue("http://www.google.com"));
+  pref_store->CommitPendingWrite();
+  RunLoop().RunUntilIdle();
+  EXPECT_TRUE(PathExists(journal_file_));
+
+  pref_store->SetValue("tabs.max_tabs", new FundamentalValue(10));
+  pref_store->SetIncrementalWritesEnabled(false);
+  RunLoop().RunUntilIdle();
+  EXPECT_FALSE(PathExists(journal_file_));
+
+  std::string contents;
+  ASSERT_TRUE(file_util::ReadFileToString(pref_file_, &contents));
+  scoped_ptr<Value> written(JSONReader::Read(contents));
+  ASSERT_TRUE(written.get());
+  DictionaryValue* dictionary = NULL;
+  ASSERT_TRUE(written->GetAsDictionary(&dictionary));
+  std::string homepage;
+  EXPECT_TRUE(dictionary->GetString(kHomePage, &homepage));
+  EXPECT_EQ("http://www.google.com", homepage);
+  int max_tabs = 0;
+  EXPECT_TRUE(dictionary->GetInteger("tabs.max_tabs", &max_tabs));
+  EXPECT_EQ(10, max_tabs);
+}
+
+TEST_F(JsonPrefStoreTest, JournalWithoutFileIsDeleted) {
+  base::FilePath pref_file = temp_dir_.path().AppendASCII("missing.json");
+  base::FilePath journal_file =
+      temp_dir_.path().AppendASCII("missing.json.journal");
+  const char kJournal[] = "[\"homepage\", \"http://www.google.com\"]\n";
+  ASSERT_EQ(static_cast<int>(strlen(kJournal)),
+            file_util::WriteFile(journal_file, kJournal, strlen(kJournal)));
+
+  scoped_refptr<JsonPrefStore> pref_store =
+      new JsonPrefStore(pref_file, message_loop_.message_loop_proxy().get());
+  EXPECT_EQ(PersistentPrefStore::PREF_READ_ERROR_NO_FILE,
+            pref_store->ReadPrefs());
+  EXPECT_FALSE(PathExists(journal_file));
+  EXPECT_FALSE(pref_store->GetValue(kHomePage, NULL));
+}
+
 }  // namespace base
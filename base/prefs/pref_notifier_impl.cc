@@ -5,15 +5,19 @@
 #include "base/prefs/pref_notifier_impl.h"
 
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 #include "base/prefs/pref_service.h"
 #include "base/stl_util.h"
+#include "base/time/time.h"
 
 PrefNotifierImpl::PrefNotifierImpl()
-    : pref_service_(NULL) {
+    : pref_service_(NULL),
+      batch_depth_(0) {
 }
 
 PrefNotifierImpl::PrefNotifierImpl(PrefService* service)
-    : pref_service_(service) {
+    : pref_service_(service),
+      batch_depth_(0) {
 }
 
 PrefNotifierImpl::~PrefNotifierImpl() {
@@ -28,6 +32,8 @@ PrefNotifierImpl::~PrefNotifierImpl() {
     }
   }
 
+  DCHECK_EQ(0, batch_depth_) << "Pref notification batch not ended";
+
   // Same for initialization observers.
   if (!init_observers_.empty())
     LOG(WARNING) << "Init observer found at shutdown.";
@@ -74,8 +80,42 @@ void PrefNotifierImpl::AddInitObserver(base::Callback<void(bool)> obs) {
   init_observers_.push_back(obs);
 }
 
+void PrefNotifierImpl::BeginBatch() {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  ++batch_depth_;
+}
+
+void PrefNotifierImpl::EndBatch() {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  DCHECK_GT(batch_depth_, 0);
+  if (--batch_depth_ > 0)
+    return;
+
+  // Observers may change prefs again, which then notifies as usual.
+  std::vector<std::string> paths;
+  paths.swap(batched_paths_);
+  batched_path_set_.clear();
+
+  base::TimeTicks start_time = base::TimeTicks::Now();
+  for (size_t i = 0; i < paths.size(); ++i)
+    FireObservers(paths[i]);
+  UMA_HISTOGRAM_TIMES("Settings.PrefBatchNotificationTime",
+                      base::TimeTicks::Now() - start_time);
+  UMA_HISTOGRAM_COUNTS_10000("Settings.PrefBatchChangedPrefs",
+                             paths.size());
+}
+
 void PrefNotifierImpl::OnPreferenceChanged(const std::string& path) {
+  if (batch_depth_ > 0) {
+    if (batched_path_set_.insert(path).second)
+      batched_paths_.push_back(path);
+    return;
+  }
+
+  base::TimeTicks start_time = base::TimeTicks::Now();
   FireObservers(path);
+  UMA_HISTOGRAM_TIMES("Settings.PrefNotificationTime",
+                      base::TimeTicks::Now() - start_time);
 }
 
 void PrefNotifierImpl::OnInitializationCompleted(bool succeeded) {
@@ -7,6 +7,7 @@
 
 #include <list>
 #include <string>
+#include <vector>
 
 #include "base/callback.h"
 #include "base/compiler_specific.h"
@@ -39,6 +40,13 @@ class BASE_PREFS_EXPORT PrefNotifierImpl
 
   void SetPrefService(PrefService* pref_service);
 
+  // Between BeginBatch() and the matching EndBatch(), changed prefs are only
+  // recorded. The outermost EndBatch() then fires the observers of each pref
+  // that changed once, in the order the prefs first changed. Batches may be
+  // nested.
+  void BeginBatch();
+  void EndBatch();
+
  protected:
   // PrefNotifier overrides.
   virtual void OnPreferenceChanged(const std::string& pref_name) OVERRIDE;
@@ -65,6 +73,14 @@ class BASE_PREFS_EXPORT PrefNotifierImpl
   PrefObserverMap pref_observers_;
   PrefInitObserverList init_observers_;
 
+  // The number of batches that have begun but not ended.
+  int batch_depth_;
+
+  // The prefs that changed during the current batch, in the order they first
+  // changed, and the same as a set.
+  std::vector<std::string> batched_paths_;
+  base::hash_set<std::string> batched_path_set_;
+
   base::ThreadChecker thread_checker_;
 
   DISALLOW_COPY_AND_ASSIGN(PrefNotifierImpl);
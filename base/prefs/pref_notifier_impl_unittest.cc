@@ -224,4 +224,38 @@ TEST_F(PrefNotifierTest, FireObservers) {
   notifier.RemovePrefObserver(kUnchangedPref, &obs2_);
 }
 
+TEST_F(PrefNotifierTest, BatchedNotifications) {
+  TestingPrefNotifierImpl notifier(&pref_service_);
+  notifier.AddPrefObserver(kChangedPref, &obs1_);
+  notifier.AddPrefObserver(kUnchangedPref, &obs2_);
+
+  // Nothing fires until the outermost batch ends, and then only once per
+  // changed pref.
+  EXPECT_CALL(obs1_, OnPreferenceChanged(_, _)).Times(0);
+  EXPECT_CALL(obs2_, OnPreferenceChanged(_, _)).Times(0);
+  notifier.BeginBatch();
+  notifier.OnPreferenceChanged(kChangedPref);
+  notifier.BeginBatch();
+  notifier.OnPreferenceChanged(kChangedPref);
+  notifier.EndBatch();
+  Mock::VerifyAndClearExpectations(&obs1_);
+  Mock::VerifyAndClearExpectations(&obs2_);
+
+  EXPECT_CALL(obs1_, OnPreferenceChanged(&pref_service_, kChangedPref));
+  EXPECT_CALL(obs2_, OnPreferenceChanged(_, _)).Times(0);
+  notifier.EndBatch();
+  Mock::VerifyAndClearExpectations(&obs1_);
+  Mock::VerifyAndClearExpectations(&obs2_);
+
+  // Outside of a batch, every change fires again.
+  EXPECT_CALL(obs1_, OnPreferenceChanged(&pref_service_, kChangedPref))
+      .Times(2);
+  notifier.OnPreferenceChanged(kChangedPref);
+  notifier.OnPreferenceChanged(kChangedPref);
+  Mock::VerifyAndClearExpectations(&obs1_);
+
+  notifier.RemovePrefObserver(kChangedPref, &obs1_);
+  notifier.RemovePrefObserver(kUnchangedPref, &obs2_);
+}
+
 }  // namespace
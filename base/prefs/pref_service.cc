@@ -494,6 +494,20 @@ void PrefService::UpdateCommandLinePrefStore(PrefStore* command_line_store) {
   pref_value_store_->UpdateCommandLinePrefStore(command_line_store);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// PrefService::ScopedBatchUpdate
+
+PrefService::ScopedBatchUpdate::ScopedBatchUpdate(PrefService* service)
+    : service_(service) {
+  DCHECK(service_->CalledOnValidThread());
+  service_->pref_notifier_->BeginBatch();
+}
+
+PrefService::ScopedBatchUpdate::~ScopedBatchUpdate() {
+  DCHECK(service_->CalledOnValidThread());
+  service_->pref_notifier_->EndBatch();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // PrefService::Preference
 
@@ -138,6 +138,22 @@ class BASE_PREFS_EXPORT PrefService : public base::NonThreadSafe {
     const PrefService* pref_service_;
   };
 
+  // While an instance of this class exists, pref change notifications are
+  // held back. When the last one goes away, each observer is notified once
+  // for every pref that changed. Use this around bulk changes, such as those
+  // coming from sync, so that observers don't redo their work for each
+  // intermediate value.
+  class BASE_PREFS_EXPORT ScopedBatchUpdate {
+   public:
+    explicit ScopedBatchUpdate(PrefService* service);
+    ~ScopedBatchUpdate();
+
+   private:
+    PrefService* service_;
+
+    DISALLOW_COPY_AND_ASSIGN(ScopedBatchUpdate);
+  };
+
   // You may wish to use PrefServiceBuilder or one of its subclasses
   // for simplified construction.
   PrefService(
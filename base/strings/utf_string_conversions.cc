@@ -4,14 +4,167 @@
 
 #include "base/strings/utf_string_conversions.h"
 
+#include <string.h>
+
 #include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversion_utils.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && \
+    (defined(__SSE2__) || defined(_M_X64) || \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define UTF_CONVERSIONS_USE_SSE2
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+#define UTF_CONVERSIONS_USE_NEON
+#include <arm_neon.h>
+#endif
 
 namespace base {
 
 namespace {
 
+// ASCII fast path -------------------------------------------------------------
+
+// Most of the text converted is ASCII, or has long runs of it: URLs, headers,
+// markup. Those runs are found and copied a block of characters at a time,
+// with SSE2 or NEON where available, and everything else goes through the
+// per-code-point conversion below.
+
+const size_t kBlockLength = 16;
+
+template<typename CHAR>
+inline bool IsASCII(CHAR c) {
+  return !(static_cast<uint32>(c) & ~0x7FU);
+}
+
+#if defined(UTF_CONVERSIONS_USE_SSE2)
+
+inline bool IsASCIIBlock(const char* src) {
+  __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  return !_mm_movemask_epi8(chars);
+}
+
+inline bool IsASCIIBlock(const char16* src) {
+  const __m128i* block = reinterpret_cast<const __m128i*>(src);
+  __m128i chars = _mm_or_si128(_mm_loadu_si128(block),
+                               _mm_loadu_si128(block + 1));
+  __m128i non_ascii = _mm_and_si128(chars, _mm_set1_epi16(0xFF80));
+  return _mm_movemask_epi8(_mm_cmpeq_epi16(non_ascii, _mm_setzero_si128())) ==
+      0xFFFF;
+}
+
+inline void CopyASCIIBlock(const char* src, char16* dest) {
+  __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  __m128i* block = reinterpret_cast<__m128i*>(dest);
+  _mm_storeu_si128(block, _mm_unpacklo_epi8(chars, _mm_setzero_si128()));
+  _mm_storeu_si128(block + 1, _mm_unpackhi_epi8(chars, _mm_setzero_si128()));
+}
+
+inline void CopyASCIIBlock(const char16* src, char* dest) {
+  const __m128i* block = reinterpret_cast<const __m128i*>(src);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                   _mm_packus_epi16(_mm_loadu_si128(block),
+                                    _mm_loadu_si128(block + 1)));
+}
+
+#elif defined(UTF_CONVERSIONS_USE_NEON)
+
+inline bool IsASCIIBlock(const char* src) {
+  uint8x16_t chars = vld1q_u8(reinterpret_cast<const uint8*>(src));
+  uint8x8_t folded = vorr_u8(vget_low_u8(chars), vget_high_u8(chars));
+  return !(vget_lane_u64(vreinterpret_u64_u8(folded), 0) &
+           GG_UINT64_C(0x8080808080808080));
+}
+
+inline bool IsASCIIBlock(const char16* src) {
+  const uint16* units = reinterpret_cast<const uint16*>(src);
+  uint16x8_t chars = vorrq_u16(vld1q_u16(units), vld1q_u16(units + 8));
+  uint16x4_t folded = vorr_u16(vget_low_u16(chars), vget_high_u16(chars));
+  return !(vget_lane_u64(vreinterpret_u64_u16(folded), 0) &
+           GG_UINT64_C(0xFF80FF80FF80FF80));
+}
+
+inline void CopyASCIIBlock(const char* src, char16* dest) {
+  uint8x16_t chars = vld1q_u8(reinterpret_cast<const uint8*>(src));
+  uint16* units = reinterpret_cast<uint16*>(dest);
+  vst1q_u16(units, vmovl_u8(vget_low_u8(chars)));
+  vst1q_u16(units + 8, vmovl_u8(vget_high_u8(chars)));
+}
+
+inline void CopyASCIIBlock(const char16* src, char* dest) {
+  const uint16* units = reinterpret_cast<const uint16*>(src);
+  vst1q_u8(reinterpret_cast<uint8*>(dest),
+           vcombine_u8(vmovn_u16(vld1q_u16(units)),
+                       vmovn_u16(vld1q_u16(units + 8))));
+}
+
+#endif
+
+#if !defined(UTF_CONVERSIONS_USE_SSE2) && !defined(UTF_CONVERSIONS_USE_NEON)
+
+// Without SIMD, blocks of 8-bit characters are still checked a word at a time.
+inline bool IsASCIIBlock(const char* src) {
+  const uintptr_t kNonASCIIMask =
+      static_cast<uintptr_t>(GG_UINT64_C(0x8080808080808080));
+  uintptr_t chars = 0;
+  for (size_t i = 0; i < kBlockLength; i += sizeof(uintptr_t)) {
+    uintptr_t word;
+    memcpy(&word, src + i, sizeof(word));
+    chars |= word;
+  }
+  return !(chars & kNonASCIIMask);
+}
+
+#endif
+
+// Characters of other types, e.g. 32-bit wchar_t, are checked and copied one
+// by one; the loops are simple enough for the compiler to vectorize.
+template<typename CHAR>
+inline bool IsASCIIBlock(const CHAR* src) {
+  uint32 chars = 0;
+  for (size_t i = 0; i < kBlockLength; ++i)
+    chars |= static_cast<uint32>(src[i]);
+  return IsASCII(chars);
+}
+
+template<typename SRC_CHAR, typename DEST_CHAR>
+inline void CopyASCIIBlock(const SRC_CHAR* src, DEST_CHAR* dest) {
+  for (size_t i = 0; i < kBlockLength; ++i)
+    dest[i] = static_cast<DEST_CHAR>(src[i]);
+}
+
+// Returns the length of the run of ASCII characters at the start of |src|.
+template<typename CHAR>
+size_t ASCIIPrefixLength(const CHAR* src, size_t src_len) {
+  size_t length = 0;
+  while (length + kBlockLength <= src_len && IsASCIIBlock(src + length))
+    length += kBlockLength;
+  while (length < src_len && IsASCII(src[length]))
+    ++length;
+  return length;
+}
+
+// Appends |src|, which must be ASCII, to |output|.
+template<typename SRC_CHAR, typename DEST_STRING>
+void AppendASCII(const SRC_CHAR* src, size_t src_len, DEST_STRING* output) {
+  typedef typename DEST_STRING::value_type DEST_CHAR;
+  if (src_len < kBlockLength) {
+    for (size_t i = 0; i < src_len; ++i)
+      output->push_back(static_cast<DEST_CHAR>(src[i]));
+    return;
+  }
+  size_t offset = output->size();
+  output->resize(offset + src_len);
+  DEST_CHAR* dest = &(*output)[offset];
+  size_t i = 0;
+  for (; i + kBlockLength <= src_len; i += kBlockLength)
+    CopyASCIIBlock(src + i, dest + i);
+  for (; i < src_len; ++i)
+    dest[i] = static_cast<DEST_CHAR>(src[i]);
+}
+
 // Generalized Unicode converter -----------------------------------------------
 
 // Converts the given source Unicode character type to the given destination
@@ -26,6 +179,14 @@ bool ConvertUnicode(const SRC_CHAR* src,
   bool success = true;
   int32 src_len32 = static_cast<int32>(src_len);
   for (int32 i = 0; i < src_len32; i++) {
+    size_t ascii_length = ASCIIPrefixLength(src + i, src_len32 - i);
+    if (ascii_length) {
+      AppendASCII(src + i, ascii_length, output);
+      i += static_cast<int32>(ascii_length);
+      if (i == src_len32)
+        break;
+    }
+
     uint32 code_point;
     if (ReadUnicodeCharacter(src, src_len32, &i, &code_point)) {
       WriteUnicodeCharacter(code_point, output);
@@ -0,0 +1,140 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/perftimer.h"
+#include "base/strings/string16.h"
+#include "base/strings/utf_string_conversion_utils.h"
+#include "base/strings/utf_string_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const int kIterations = 200;
+
+// Excerpts of the kind of text that crosses the IPC boundary: markup and URLs
+// with English text, text with a few accented characters, and CJK text with
+// ASCII markup.
+const char kEnglishPage[] =
+    "<div class=\"mw-body\" id=\"content\"><h1 id=\"firstHeading\">Web browser"
+    "</h1><p>A <b>web browser</b> is a software application for retrieving, "
+    "presenting and traversing information resources on the World Wide Web. "
+    "An information resource is identified by a Uniform Resource Identifier "
+    "(URI/URL) and may be a web page, image, video or other piece of content."
+    " <a href=\"https://en.wikipedia.org/wiki/Hyperlink\" title=\"Hyperlink\">"
+    "Hyperlinks</a> present in resources enable users easily to navigate "
+    "their browsers to related resources.</p>\n";
+
+const char kFrenchPage[] =
+    "<p>Un <b>navigateur web</b> est un logiciel con\xc3\xa7u pour consulter "
+    "et afficher le World Wide Web. Techniquement, c'est au minimum un client"
+    " HTTP. Il existe de nombreux navigateurs web, pour toutes sortes de "
+    "mat\xc3\xa9riels et de syst\xc3\xa8mes d'exploitation. Ils sont "
+    "g\xc3\xa9n\xc3\xa9ralement gratuits ; d\xc3\xa9velopp\xc3\xa9s par des "
+    "entreprises ou des communaut\xc3\xa9s.</p>\n";
+
+const char kChinesePage[] =
+    "<p><b>\xe7\xbd\x91\xe9\xa1\xb5\xe6\xb5\x8f\xe8\xa7\x88\xe5\x99\xa8</b>"
+    "\xe6\x98\xaf\xe4\xb8\x80\xe7\xa7\x8d\xe7\x94\xa8\xe4\xba\x8e\xe6\xa3\x80"
+    "\xe7\xb4\xa2\xe5\xb9\xb6\xe5\xb1\x95\xe7\xa4\xba<a href=\"/wiki/WWW\">"
+    "\xe4\xb8\x87\xe7\xbb\xb4\xe7\xbd\x91</a>\xe4\xbf\xa1\xe6\x81\xaf\xe8\xb5"
+    "\x84\xe6\xba\x90\xe7\x9a\x84\xe5\xba\x94\xe7\x94\xa8\xe7\xa8\x8b\xe5\xba"
+    "\x8f\xe3\x80\x82</p>\n";
+
+std::string Repeat(const char* text, int count) {
+  std::string result;
+  for (int i = 0; i < count; ++i)
+    result.append(text);
+  return result;
+}
+
+// The conversion one code point at a time, for comparison.
+string16 UTF8ToUTF16PerCodePoint(const std::string& utf8) {
+  string16 output;
+  PrepareForUTF16Or32Output(utf8.data(), utf8.length(), &output);
+  int32 length = static_cast<int32>(utf8.length());
+  for (int32 i = 0; i < length; ++i) {
+    uint32 code_point;
+    if (!ReadUnicodeCharacter(utf8.data(), length, &i, &code_point))
+      code_point = 0xFFFD;
+    WriteUnicodeCharacter(code_point, &output);
+  }
+  return output;
+}
+
+std::string UTF16ToUTF8PerCodePoint(const string16& utf16) {
+  std::string output;
+  PrepareForUTF8Output(utf16.data(), utf16.length(), &output);
+  int32 length = static_cast<int32>(utf16.length());
+  for (int32 i = 0; i < length; ++i) {
+    uint32 code_point;
+    if (!ReadUnicodeCharacter(utf16.data(), length, &i, &code_point))
+      code_point = 0xFFFD;
+    WriteUnicodeCharacter(code_point, &output);
+  }
+  return output;
+}
+
+void LogThroughput(const std::string& name,
+                   size_t bytes,
+                   const TimeDelta& elapsed) {
+  LogPerfResult(name.c_str(),
+                bytes * kIterations / (1024.0 * 1024.0) / elapsed.InSecondsF(),
+                "MB/s");
+}
+
+void RunTest(const char* name, const char* text) {
+  const std::string utf8 = Repeat(text, 100);
+  const string16 utf16 = UTF8ToUTF16(utf8);
+  ASSERT_EQ(UTF8ToUTF16PerCodePoint(utf8), utf16);
+  ASSERT_EQ(UTF16ToUTF8PerCodePoint(utf16), utf8);
+
+  {
+    PerfTimer timer;
+    for (int i = 0; i < kIterations; ++i)
+      UTF8ToUTF16PerCodePoint(utf8);
+    LogThroughput(std::string("UTF8ToUTF16_per_code_point_") + name,
+                  utf8.size(), timer.Elapsed());
+  }
+  {
+    PerfTimer timer;
+    for (int i = 0; i < kIterations; ++i)
+      UTF8ToUTF16(utf8);
+    LogThroughput(std::string("UTF8ToUTF16_") + name, utf8.size(),
+                  timer.Elapsed());
+  }
+  {
+    PerfTimer timer;
+    for (int i = 0; i < kIterations; ++i)
+      UTF16ToUTF8PerCodePoint(utf16);
+    LogThroughput(std::string("UTF16ToUTF8_per_code_point_") + name,
+                  utf8.size(), timer.Elapsed());
+  }
+  {
+    PerfTimer timer;
+    for (int i = 0; i < kIterations; ++i)
+      UTF16ToUTF8(utf16);
+    LogThroughput(std::string("UTF16ToUTF8_") + name, utf8.size(),
+                  timer.Elapsed());
+  }
+}
+
+}  // namespace
+
+TEST(UTFStringConversionsPerfTest, English) {
+  RunTest("english", kEnglishPage);
+}
+
+TEST(UTFStringConversionsPerfTest, French) {
+  RunTest("french", kFrenchPage);
+}
+
+TEST(UTFStringConversionsPerfTest, Chinese) {
+  RunTest("chinese", kChinesePage);
+}
+
+}  // namespace base
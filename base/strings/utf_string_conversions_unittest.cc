@@ -208,4 +208,52 @@ TEST(UTFStringConversionsTest, ConvertMultiString) {
   EXPECT_EQ(expected, converted);
 }
 
+// Long runs of ASCII are converted in blocks; check that non-ASCII characters
+// are found and converted wherever they fall relative to a block.
+TEST(UTFStringConversionsTest, ConvertMixedASCII) {
+  static const struct {
+    const char* utf8;
+    const char16 utf16[3];
+    bool valid;
+  } kNonASCII[] = {
+    // "é"
+    { "\xc3\xa9", { 0xe9, 0 }, true },
+    // "网"
+    { "\xe7\xbd\x91", { 0x7f51, 0 }, true },
+    // U+10300, outside the BMP.
+    { "\xf0\x90\x8c\x80", { 0xd800, 0xdf00, 0 }, true },
+    // A lone continuation byte.
+    { "\x80", { 0xfffd, 0 }, false },
+  };
+  const std::string ascii("The quick brown fox jumps over the lazy dog\t\n");
+  for (size_t i = 0; i < arraysize(kNonASCII); ++i) {
+    for (size_t prefix = 0; prefix <= 40; ++prefix) {
+      std::string utf8 = ascii.substr(0, prefix) + kNonASCII[i].utf8 +
+          ascii.substr(prefix) + kNonASCII[i].utf8;
+      string16 expected = ASCIIToUTF16(ascii.substr(0, prefix)) +
+          kNonASCII[i].utf16 + ASCIIToUTF16(ascii.substr(prefix)) +
+          kNonASCII[i].utf16;
+
+      string16 utf16;
+      EXPECT_EQ(kNonASCII[i].valid,
+                UTF8ToUTF16(utf8.data(), utf8.length(), &utf16));
+      EXPECT_EQ(expected, utf16);
+      if (!kNonASCII[i].valid)
+        continue;
+
+      std::string round_trip;
+      EXPECT_TRUE(UTF16ToUTF8(utf16.data(), utf16.length(), &round_trip));
+      EXPECT_EQ(utf8, round_trip);
+      EXPECT_EQ(utf8, WideToUTF8(UTF8ToWide(utf8)));
+    }
+  }
+
+  // Unpaired surrogates in the middle of ASCII are replaced.
+  string16 utf16 = ASCIIToUTF16(ascii);
+  utf16[20] = 0xd800;
+  std::string utf8;
+  EXPECT_FALSE(UTF16ToUTF8(utf16.data(), utf16.length(), &utf8));
+  EXPECT_EQ(ascii.substr(0, 20) + "\xef\xbf\xbd" + ascii.substr(21), utf8);
+}
+
 }  // base
@@ -16,6 +16,15 @@ SequencedWorkerPoolOwner::SequencedWorkerPoolOwner(
       pool_(new SequencedWorkerPool(max_threads, thread_name_prefix, this)),
       has_work_call_count_(0) {}
 
+SequencedWorkerPoolOwner::SequencedWorkerPoolOwner(
+    size_t max_threads,
+    const std::string& thread_name_prefix,
+    SequencedWorkerPool::SchedulerBackend backend)
+    : constructor_message_loop_(MessageLoop::current()),
+      pool_(new SequencedWorkerPool(
+          max_threads, thread_name_prefix, backend, this)),
+      has_work_call_count_(0) {}
+
 SequencedWorkerPoolOwner::~SequencedWorkerPoolOwner() {
   pool_ = NULL;
   MessageLoop::current()->Run();
@@ -49,11 +49,13 @@ bool TraceEvent::SetFromJSON(const base::Value* event_value) {
                      phase == TRACE_EVENT_PHASE_ASYNC_STEP ||
                      phase == TRACE_EVENT_PHASE_ASYNC_END);
 
-  if (require_origin && !dictionary->GetInteger("pid", &thread.process_id)) {
+  // Metadata events may leave out the pid and tid, but thread names need them
+  // when present.
+  if (!dictionary->GetInteger("pid", &thread.process_id) && require_origin) {
     LOG(ERROR) << "pid is missing from TraceEvent JSON";
     return false;
   }
-  if (require_origin && !dictionary->GetInteger("tid", &thread.thread_id)) {
+  if (!dictionary->GetInteger("tid", &thread.thread_id) && require_origin) {
     LOG(ERROR) << "tid is missing from TraceEvent JSON";
     return false;
   }
@@ -805,6 +807,19 @@ const std::string& TraceAnalyzer::GetThreadName(
   return thread_names_[thread];
 }
 
+size_t TraceAnalyzer::FindThreads(
+    const std::string& name,
+    std::vector<TraceEvent::ProcessThreadID>* output) {
+  CHECK(output);
+  output->clear();
+  std::map<TraceEvent::ProcessThreadID, std::string>::const_iterator it;
+  for (it = thread_names_.begin(); it != thread_names_.end(); ++it) {
+    if (it->second == name)
+      output->push_back(it->first);
+  }
+  return output->size();
+}
+
 void TraceAnalyzer::ParseMetadata() {
   for (size_t i = 0; i < raw_events_.size(); ++i) {
     TraceEvent& this_event = raw_events_[i];
@@ -874,6 +889,35 @@ bool GetRateStats(const TraceEventVector& events,
   return true;
 }
 
+double GetBusyTime(const TraceEventVector& events) {
+  std::vector<std::pair<double, double> > intervals;
+  for (size_t i = 0; i < events.size(); ++i) {
+    const TraceEvent* event = events.at(i);
+    if (!event->has_other_event())
+      continue;
+    intervals.push_back(std::make_pair(
+        event->timestamp,
+        std::max(event->timestamp, event->other_event->timestamp)));
+  }
+  std::sort(intervals.begin(), intervals.end());
+
+  // Merge the sorted intervals as they are summed up.
+  double busy_time = 0.0;
+  double current_begin = 0.0;
+  double current_end = 0.0;
+  for (size_t i = 0; i < intervals.size(); ++i) {
+    if (i == 0 || intervals[i].first > current_end) {
+      busy_time += current_end - current_begin;
+      current_begin = intervals[i].first;
+      current_end = intervals[i].second;
+    } else {
+      current_end = std::max(current_end, intervals[i].second);
+    }
+  }
+  busy_time += current_end - current_begin;
+  return busy_time;
+}
+
 bool FindFirstOf(const TraceEventVector& events,
                  const Query& query,
                  size_t position,
@@ -602,6 +602,10 @@ class TraceAnalyzer {
 
   const std::string& GetThreadName(const TraceEvent::ProcessThreadID& thread);
 
+  // Find all threads named |name| and replace output vector.
+  size_t FindThreads(const std::string& name,
+                     std::vector<TraceEvent::ProcessThreadID>* output);
+
  private:
   TraceAnalyzer();
 
@@ -642,6 +646,12 @@ bool GetRateStats(const TraceEventVector& events,
                   RateStats* stats,
                   const RateStatsOptions* options);
 
+// Calculate the time in microseconds during which at least one of the events
+// was in progress. An event lasts until its associated event (see
+// TraceAnalyzer::AssociateBeginEndEvents), and events without one are
+// ignored. Overlapping and nested events are only counted once.
+double GetBusyTime(const TraceEventVector& events);
+
 // Starting from |position|, find the first event that matches |query|.
 // Returns true if found, false otherwise.
 bool FindFirstOf(const TraceEventVector& events,
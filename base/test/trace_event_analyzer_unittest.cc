@@ -717,6 +717,62 @@ TEST_F(TraceEventAnalyzerTest, RateStats) {
   ASSERT_FALSE(GetRateStats(few_event_ptrs, &stats, &options));
 }
 
+// Test GetBusyTime.
+TEST_F(TraceEventAnalyzerTest, BusyTime) {
+  std::vector<TraceEvent> begins(5);
+  std::vector<TraceEvent> ends(5);
+  TraceEventVector event_ptrs;
+  const double kTimes[][2] = {
+    { 0.0, 10.0 },
+    { 2.0, 5.0 },    // Nested in the first event.
+    { 8.0, 15.0 },   // Overlaps the first event.
+    { 20.0, 25.0 },
+    { 25.0, 30.0 },  // Starts as the previous event ends.
+  };
+  for (size_t i = 0; i < arraysize(kTimes); ++i) {
+    begins[i].timestamp = kTimes[i][0];
+    ends[i].timestamp = kTimes[i][1];
+    begins[i].other_event = &ends[i];
+    event_ptrs.push_back(&begins[i]);
+  }
+
+  EXPECT_EQ(25.0, GetBusyTime(event_ptrs));
+
+  // Events without an associated event are ignored.
+  TraceEvent instant;
+  instant.timestamp = 50.0;
+  event_ptrs.push_back(&instant);
+  EXPECT_EQ(25.0, GetBusyTime(event_ptrs));
+
+  EXPECT_EQ(0.0, GetBusyTime(TraceEventVector()));
+}
+
+// Test FindThreads.
+TEST_F(TraceEventAnalyzerTest, FindThreads) {
+  scoped_ptr<TraceAnalyzer> analyzer(TraceAnalyzer::Create(
+      "[{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":2,"
+      "\"ts\":0,\"cat\":\"__metadata\",\"args\":{\"name\":\"main\"}},"
+      "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":3,"
+      "\"ts\":0,\"cat\":\"__metadata\",\"args\":{\"name\":\"io\"}},"
+      "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":4,\"tid\":5,"
+      "\"ts\":0,\"cat\":\"__metadata\",\"args\":{\"name\":\"main\"}}]"));
+  ASSERT_TRUE(analyzer.get());
+
+  std::vector<TraceEvent::ProcessThreadID> threads;
+  ASSERT_EQ(2u, analyzer->FindThreads("main", &threads));
+  EXPECT_EQ(1, threads[0].process_id);
+  EXPECT_EQ(2, threads[0].thread_id);
+  EXPECT_EQ(4, threads[1].process_id);
+  EXPECT_EQ(5, threads[1].thread_id);
+
+  ASSERT_EQ(1u, analyzer->FindThreads("io", &threads));
+  EXPECT_EQ(1, threads[0].process_id);
+  EXPECT_EQ(3, threads[0].thread_id);
+
+  EXPECT_EQ(0u, analyzer->FindThreads("gpu", &threads));
+  EXPECT_TRUE(threads.empty());
+}
+
 // Test FindFirstOf and FindLastOf.
 TEST_F(TraceEventAnalyzerTest, FindOf) {
   size_t num_events = 100;
@@ -4,6 +4,7 @@
 
 #include "base/threading/sequenced_worker_pool.h"
 
+#include <deque>
 #include <list>
 #include <map>
 #include <set>
@@ -11,6 +12,7 @@
 #include <vector>
 
 #include "base/atomic_sequence_num.h"
+#include "base/atomicops.h"
 #include "base/callback.h"
 #include "base/compiler_specific.h"
 #include "base/critical_closure.h"
@@ -18,6 +20,7 @@
 #include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/memory/linked_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/message_loop/message_loop_proxy.h"
 #include "base/stl_util.h"
 #include "base/strings/stringprintf.h"
@@ -252,8 +255,19 @@ class SequencedWorkerPool::Worker : public SimpleThread {
     return running_shutdown_behavior_;
   }
 
+  SequencedWorkerPool* worker_pool() const {
+    return worker_pool_.get();
+  }
+
+  // The 1-based number this worker was created with. Unique within its pool
+  // and never greater than the pool's maximum number of threads.
+  int thread_number() const {
+    return thread_number_;
+  }
+
  private:
   scoped_refptr<SequencedWorkerPool> worker_pool_;
+  const int thread_number_;
   SequenceToken running_sequence_;
   WorkerShutdown running_shutdown_behavior_;
 
@@ -268,6 +282,7 @@ class SequencedWorkerPool::Inner {
   // by it).
   Inner(SequencedWorkerPool* worker_pool, size_t max_threads,
         const std::string& thread_name_prefix,
+        SchedulerBackend backend,
         TestingObserver* observer);
 
   ~Inner();
@@ -318,6 +333,68 @@ class SequencedWorkerPool::Inner {
     CLEANUP_DONE,
   };
 
+  // An entry in a work-stealing deque. Either an unsequenced |task|, or, when
+  // |sequence_token_id| is nonzero, a marker telling the worker to run the
+  // oldest task of that sequence from |sequences_|.
+  struct WorkItem {
+    WorkItem() : sequence_token_id(0) {}
+
+    int sequence_token_id;
+    SequencedTask task;
+  };
+
+  // A deque owned by one worker. The owner takes items from the front, other
+  // workers steal from the back.
+  struct WorkerQueue {
+    Lock lock;
+    std::deque<WorkItem> items;
+  };
+
+  // Shared by both backends. Called from within the lock, returns true if a
+  // task with |shutdown_behavior| may still be posted after Shutdown().
+  bool LockedCanPostAfterShutdown(WorkerShutdown shutdown_behavior);
+
+  // Work-stealing counterpart of PostTask() for tasks without a delay.
+  bool PostWorkStealingTask(const std::string* optional_token_name,
+                            SequencedTask* sequenced);
+
+  // Queues |task| for the work-stealing workers. The task must already be
+  // accounted for in |ws_outstanding_tasks_| and, if it blocks shutdown, in
+  // |ws_blocking_pending_|.
+  void EnqueueWorkStealingTask(const SequencedTask& task);
+
+  // Pushes |item| onto a worker deque: the calling worker's own if it belongs
+  // to this pool, otherwise one picked round-robin. Wakes or starts a worker.
+  void PushWorkItem(const WorkItem& item);
+
+  // Wakes an idle work-stealing worker, or starts a new one if none is idle
+  // and the pool is not at its maximum size.
+  void WakeWorkStealingWorker();
+
+  // Takes an item from the deque at |index|, or steals one from another
+  // worker. Returns false if all deques are empty.
+  bool TakeWorkItem(size_t index, WorkItem* item);
+
+  // Runs (or, during shutdown, discards) the task behind |item|. Sequences
+  // that still have tasks afterwards are put back on the front of the deque
+  // at |index|, so they stay on this worker.
+  void RunWorkItem(Worker* this_worker, size_t index, WorkItem* item);
+
+  // Moves delayed tasks whose time has come into the work-stealing deques.
+  // Returns true if any were moved. Otherwise sets |*has_delayed_work| and,
+  // if set, |*wait_time| to the delay until the next one is due.
+  bool MoveDueDelayedTasks(bool* has_delayed_work, TimeDelta* wait_time);
+
+  // Runs the worker loop of the work-stealing backend.
+  void WorkStealingThreadLoop(Worker* this_worker);
+
+  // Called after a work-stealing task finished or was discarded.
+  void DidFinishWorkStealingTask(WorkerShutdown shutdown_behavior,
+                                 bool was_running);
+
+  // Work-stealing version of CleanupForTesting().
+  void CleanupWorkStealingForTesting();
+
   // Called from within the lock, this converts the given token name into a
   // token ID, creating a new one if necessary.
   int LockedGetNamedTokenID(const std::string& name);
@@ -397,6 +474,12 @@ class SequencedWorkerPool::Inner {
   // GetSequenceToken unique across SequencedWorkerPool instances.
   static base::StaticAtomicSequenceNumber g_last_sequence_number_;
 
+  // The work-stealing worker running on the current thread, if any.
+  static base::LazyInstance<base::ThreadLocalPointer<Worker> >
+      g_current_worker_;
+
+  const SchedulerBackend backend_;
+
   // This lock protects |everything in this class|. Do not read or modify
   // anything without holding this lock. Do not block while holding this
   // lock.
@@ -454,7 +537,8 @@ class SequencedWorkerPool::Inner {
   std::set<int> current_sequences_;
 
   // An ID for each posted task to distinguish the task from others in traces.
-  int trace_id_;
+  // Atomic so the work-stealing backend can assign it without the lock.
+  AtomicSequenceNumber trace_id_;
 
   // Set when Shutdown is called and no further tasks should be
   // allowed, though we may still be running existing tasks.
@@ -471,6 +555,43 @@ class SequencedWorkerPool::Inner {
 
   TestingObserver* const testing_observer_;
 
+  // Work-stealing state. None of it is guarded by |lock_|.
+
+  // One deque per potential worker, indexed by thread number - 1. Allocated
+  // up front so that thieves can walk it without locking.
+  ScopedVector<WorkerQueue> worker_queues_;
+
+  // Pending tasks of every sequence that has a marker queued or running.
+  // A sequence is erased once it runs out of tasks, so at most one marker per
+  // sequence exists at any time.
+  Lock sequences_lock_;
+  std::map<int, std::deque<SequencedTask> > sequences_;
+
+  // Sleeping workers wait on |idle_cv_|.
+  Lock idle_lock_;
+  ConditionVariable idle_cv_;
+
+  subtle::Atomic32 ws_idle_workers_;
+  subtle::Atomic32 ws_started_workers_;
+  subtle::Atomic32 ws_next_queue_;
+
+  // Items in |worker_queues_|.
+  subtle::Atomic32 ws_queued_items_;
+
+  // Tasks that were posted but have not finished or been discarded yet,
+  // including tasks waiting in |sequences_|. Used by FlushForTesting().
+  subtle::Atomic32 ws_outstanding_tasks_;
+
+  // BLOCK_SHUTDOWN tasks that have not started yet, and tasks that block
+  // shutdown and are running now. The equivalents of
+  // |blocking_shutdown_pending_task_count_| and
+  // |blocking_shutdown_thread_count_|.
+  subtle::Atomic32 ws_blocking_pending_;
+  subtle::Atomic32 ws_blocking_running_;
+
+  // Mirrors |shutdown_called_| for readers that do not hold |lock_|.
+  subtle::Atomic32 ws_shutdown_called_;
+
   DISALLOW_COPY_AND_ASSIGN(Inner);
 };
 
@@ -483,6 +604,7 @@ SequencedWorkerPool::Worker::Worker(
     : SimpleThread(
           prefix + StringPrintf("Worker%d", thread_number).c_str()),
       worker_pool_(worker_pool),
+      thread_number_(thread_number),
       running_shutdown_behavior_(CONTINUE_ON_SHUTDOWN) {
   Start();
 }
@@ -511,8 +633,10 @@ SequencedWorkerPool::Inner::Inner(
     SequencedWorkerPool* worker_pool,
     size_t max_threads,
     const std::string& thread_name_prefix,
+    SchedulerBackend backend,
     TestingObserver* observer)
     : worker_pool_(worker_pool),
+      backend_(backend),
       lock_(),
       has_work_cv_(&lock_),
       can_shutdown_cv_(&lock_),
@@ -523,13 +647,26 @@ SequencedWorkerPool::Inner::Inner(
       blocking_shutdown_thread_count_(0),
       next_sequence_task_number_(0),
       blocking_shutdown_pending_task_count_(0),
-      trace_id_(0),
       shutdown_called_(false),
       max_blocking_tasks_after_shutdown_(0),
       cleanup_state_(CLEANUP_DONE),
       cleanup_idlers_(0),
       cleanup_cv_(&lock_),
-      testing_observer_(observer) {}
+      testing_observer_(observer),
+      idle_cv_(&idle_lock_),
+      ws_idle_workers_(0),
+      ws_started_workers_(0),
+      ws_next_queue_(0),
+      ws_queued_items_(0),
+      ws_outstanding_tasks_(0),
+      ws_blocking_pending_(0),
+      ws_blocking_running_(0),
+      ws_shutdown_called_(0) {
+  if (backend_ == WORK_STEALING) {
+    for (size_t i = 0; i < max_threads_; ++i)
+      worker_queues_.push_back(new WorkerQueue);
+  }
+}
 
 SequencedWorkerPool::Inner::~Inner() {
   // You must call Shutdown() before destroying the pool.
@@ -575,23 +712,17 @@ bool SequencedWorkerPool::Inner::PostTask(
       base::MakeCriticalClosure(task) : task;
   sequenced.time_to_run = TimeTicks::Now() + delay;
 
+  if (backend_ == WORK_STEALING && delay == TimeDelta())
+    return PostWorkStealingTask(optional_token_name, &sequenced);
+
   int create_thread_id = 0;
   {
     AutoLock lock(lock_);
-    if (shutdown_called_) {
-      if (shutdown_behavior != BLOCK_SHUTDOWN ||
-          LockedCurrentThreadShutdownBehavior() == CONTINUE_ON_SHUTDOWN) {
-        return false;
-      }
-      if (max_blocking_tasks_after_shutdown_ <= 0) {
-        DLOG(WARNING) << "BLOCK_SHUTDOWN task disallowed";
-        return false;
-      }
-      max_blocking_tasks_after_shutdown_ -= 1;
-    }
+    if (shutdown_called_ && !LockedCanPostAfterShutdown(shutdown_behavior))
+      return false;
 
     // The trace_id is used for identifying the task in about:tracing.
-    sequenced.trace_id = trace_id_++;
+    sequenced.trace_id = trace_id_.GetNext();
 
     TRACE_EVENT_FLOW_BEGIN0("task", "SequencedWorkerPool::PostTask",
         TRACE_ID_MANGLE(GetTaskTraceID(sequenced, static_cast<void*>(this))));
@@ -606,7 +737,14 @@ bool SequencedWorkerPool::Inner::PostTask(
     if (shutdown_behavior == BLOCK_SHUTDOWN)
       blocking_shutdown_pending_task_count_++;
 
-    create_thread_id = PrepareToStartAdditionalThreadIfHelpful();
+    if (backend_ == GLOBAL_QUEUE)
+      create_thread_id = PrepareToStartAdditionalThreadIfHelpful();
+  }
+
+  // A delayed task changes how long idle work-stealing workers should sleep.
+  if (backend_ == WORK_STEALING) {
+    WakeWorkStealingWorker();
+    return true;
   }
 
   // Actually start the additional thread or signal an existing one now that
@@ -636,6 +774,10 @@ bool SequencedWorkerPool::Inner::IsRunningSequenceOnCurrentThread(
 // See https://code.google.com/p/chromium/issues/detail?id=168415
 void SequencedWorkerPool::Inner::CleanupForTesting() {
   DCHECK(!RunsTasksOnCurrentThread());
+  if (backend_ == WORK_STEALING) {
+    CleanupWorkStealingForTesting();
+    return;
+  }
   base::ThreadRestrictions::ScopedAllowWait allow_wait;
   AutoLock lock(lock_);
   CHECK_EQ(CLEANUP_DONE, cleanup_state_);
@@ -651,7 +793,10 @@ void SequencedWorkerPool::Inner::CleanupForTesting() {
 }
 
 void SequencedWorkerPool::Inner::SignalHasWorkForTesting() {
-  SignalHasWork();
+  if (backend_ == WORK_STEALING)
+    WakeWorkStealingWorker();
+  else
+    SignalHasWork();
 }
 
 void SequencedWorkerPool::Inner::Shutdown(
@@ -666,6 +811,14 @@ void SequencedWorkerPool::Inner::Shutdown(
     shutdown_called_ = true;
     max_blocking_tasks_after_shutdown_ = max_new_blocking_tasks_after_shutdown;
 
+    if (backend_ == WORK_STEALING) {
+      // Workers that pick up a task after this point see the flag; workers
+      // that picked one up before are visible in |ws_blocking_running_|.
+      subtle::Barrier_AtomicIncrement(&ws_shutdown_called_, 1);
+      AutoLock idle_lock(idle_lock_);
+      idle_cv_.Broadcast();
+    }
+
     // Tickle the threads. This will wake up a waiting one so it will know that
     // it can exit, which in turn will wake up any other waiting ones.
     SignalHasWork();
@@ -703,6 +856,11 @@ bool SequencedWorkerPool::Inner::IsShutdownInProgress() {
 }
 
 void SequencedWorkerPool::Inner::ThreadLoop(Worker* this_worker) {
+  if (backend_ == WORK_STEALING) {
+    WorkStealingThreadLoop(this_worker);
+    return;
+  }
+
   {
     AutoLock lock(lock_);
     DCHECK(thread_being_created_);
@@ -875,6 +1033,22 @@ int SequencedWorkerPool::Inner::LockedGetNamedTokenID(
   return result.id_;
 }
 
+bool SequencedWorkerPool::Inner::LockedCanPostAfterShutdown(
+    WorkerShutdown shutdown_behavior) {
+  lock_.AssertAcquired();
+  DCHECK(shutdown_called_);
+  if (shutdown_behavior != BLOCK_SHUTDOWN ||
+      LockedCurrentThreadShutdownBehavior() == CONTINUE_ON_SHUTDOWN) {
+    return false;
+  }
+  if (max_blocking_tasks_after_shutdown_ <= 0) {
+    DLOG(WARNING) << "BLOCK_SHUTDOWN task disallowed";
+    return false;
+  }
+  max_blocking_tasks_after_shutdown_ -= 1;
+  return true;
+}
+
 int64 SequencedWorkerPool::Inner::LockedGetNextSequenceTaskNumber() {
   lock_.AssertAcquired();
   // We assume that we never create enough tasks to wrap around.
@@ -1113,12 +1287,377 @@ bool SequencedWorkerPool::Inner::CanShutdown() const {
   // See PrepareToStartAdditionalThreadIfHelpful for how thread creation works.
   return !thread_being_created_ &&
          blocking_shutdown_thread_count_ == 0 &&
-         blocking_shutdown_pending_task_count_ == 0;
+         blocking_shutdown_pending_task_count_ == 0 &&
+         subtle::Acquire_Load(&ws_blocking_pending_) == 0 &&
+         subtle::Acquire_Load(&ws_blocking_running_) == 0;
+}
+
+bool SequencedWorkerPool::Inner::PostWorkStealingTask(
+    const std::string* optional_token_name,
+    SequencedTask* sequenced) {
+  // Named tokens live in a map guarded by the lock. Callers that care about
+  // contention should look the token up once with GetNamedSequenceToken().
+  if (optional_token_name) {
+    AutoLock lock(lock_);
+    sequenced->sequence_token_id = LockedGetNamedTokenID(*optional_token_name);
+  }
+
+  // Account for the task before checking for shutdown, so Shutdown() either
+  // sees the task or the task sees Shutdown().
+  const bool blocks_shutdown = sequenced->shutdown_behavior == BLOCK_SHUTDOWN;
+  if (blocks_shutdown)
+    subtle::Barrier_AtomicIncrement(&ws_blocking_pending_, 1);
+  if (subtle::Acquire_Load(&ws_shutdown_called_)) {
+    AutoLock lock(lock_);
+    if (!LockedCanPostAfterShutdown(sequenced->shutdown_behavior)) {
+      if (blocks_shutdown) {
+        subtle::Barrier_AtomicIncrement(&ws_blocking_pending_, -1);
+        can_shutdown_cv_.Signal();
+      }
+      return false;
+    }
+  }
+
+  // The trace_id is used for identifying the task in about:tracing.
+  sequenced->trace_id = trace_id_.GetNext();
+  TRACE_EVENT_FLOW_BEGIN0("task", "SequencedWorkerPool::PostTask",
+      TRACE_ID_MANGLE(GetTaskTraceID(*sequenced, static_cast<void*>(this))));
+
+  subtle::Barrier_AtomicIncrement(&ws_outstanding_tasks_, 1);
+  EnqueueWorkStealingTask(*sequenced);
+  return true;
+}
+
+void SequencedWorkerPool::Inner::EnqueueWorkStealingTask(
+    const SequencedTask& task) {
+  WorkItem item;
+  if (task.sequence_token_id) {
+    AutoLock lock(sequences_lock_);
+    std::pair<std::map<int, std::deque<SequencedTask> >::iterator, bool>
+        result = sequences_.insert(
+            std::make_pair(task.sequence_token_id,
+                           std::deque<SequencedTask>()));
+    result.first->second.push_back(task);
+    // If the sequence was already known, its marker is queued or running and
+    // will get to this task in order.
+    if (!result.second)
+      return;
+    item.sequence_token_id = task.sequence_token_id;
+  } else {
+    item.task = task;
+  }
+  PushWorkItem(item);
+}
+
+void SequencedWorkerPool::Inner::PushWorkItem(const WorkItem& item) {
+  DCHECK(!worker_queues_.empty());
+  size_t index;
+  Worker* current_worker = g_current_worker_.Get().Get();
+  if (current_worker && current_worker->worker_pool() == worker_pool_) {
+    index = current_worker->thread_number() - 1;
+  } else {
+    // Spread over the workers that exist. Before the first one has started
+    // everything goes to the first deque, which it will own.
+    subtle::Atomic32 started = subtle::Acquire_Load(&ws_started_workers_);
+    subtle::Atomic32 next = subtle::NoBarrier_AtomicIncrement(&ws_next_queue_,
+                                                               1);
+    index = started > 0 ? static_cast<size_t>(next & 0x7fffffff) % started : 0;
+  }
+
+  WorkerQueue* queue = worker_queues_[index];
+  {
+    AutoLock lock(queue->lock);
+    queue->items.push_back(item);
+  }
+  subtle::Barrier_AtomicIncrement(&ws_queued_items_, 1);
+  WakeWorkStealingWorker();
+}
+
+void SequencedWorkerPool::Inner::WakeWorkStealingWorker() {
+  if (subtle::Acquire_Load(&ws_idle_workers_) > 0) {
+    AutoLock lock(idle_lock_);
+    idle_cv_.Signal();
+  } else if (static_cast<size_t>(subtle::Acquire_Load(&ws_started_workers_)) <
+             max_threads_) {
+    // All started workers are busy. Start another one unless one is already
+    // on its way; see PrepareToStartAdditionalThreadIfHelpful().
+    int create_thread_id = 0;
+    {
+      AutoLock lock(lock_);
+      if (!shutdown_called_ &&
+          !thread_being_created_ &&
+          threads_.size() < max_threads_) {
+        thread_being_created_ = true;
+        create_thread_id = static_cast<int>(threads_.size() + 1);
+      }
+    }
+    if (create_thread_id)
+      FinishStartingAdditionalThread(create_thread_id);
+  }
+
+  if (testing_observer_)
+    testing_observer_->OnHasWork();
+}
+
+bool SequencedWorkerPool::Inner::TakeWorkItem(size_t index, WorkItem* item) {
+  if (subtle::Acquire_Load(&ws_queued_items_) == 0)
+    return false;
+
+  const size_t num_queues = worker_queues_.size();
+  for (size_t i = 0; i < num_queues; ++i) {
+    WorkerQueue* queue = worker_queues_[(index + i) % num_queues];
+    AutoLock lock(queue->lock);
+    if (queue->items.empty())
+      continue;
+    if (i == 0) {
+      *item = queue->items.front();
+      queue->items.pop_front();
+    } else {
+      *item = queue->items.back();
+      queue->items.pop_back();
+    }
+    subtle::Barrier_AtomicIncrement(&ws_queued_items_, -1);
+    return true;
+  }
+  return false;
+}
+
+void SequencedWorkerPool::Inner::RunWorkItem(Worker* this_worker,
+                                             size_t index,
+                                             WorkItem* item) {
+  SequencedTask task;
+  if (item->sequence_token_id) {
+    AutoLock lock(sequences_lock_);
+    std::deque<SequencedTask>& pending = sequences_[item->sequence_token_id];
+    DCHECK(!pending.empty());
+    task = pending.front();
+    pending.pop_front();
+  } else {
+    task = item->task;
+    item->task.task = Closure();
+  }
+
+  // Moving a task from pending to running must never make both counters look
+  // empty to Shutdown().
+  const bool blocks_shutdown = task.shutdown_behavior != CONTINUE_ON_SHUTDOWN;
+  if (blocks_shutdown)
+    subtle::Barrier_AtomicIncrement(&ws_blocking_running_, 1);
+  if (task.shutdown_behavior == BLOCK_SHUTDOWN)
+    subtle::Barrier_AtomicIncrement(&ws_blocking_pending_, -1);
+
+  bool run = task.shutdown_behavior == BLOCK_SHUTDOWN ||
+      !subtle::Acquire_Load(&ws_shutdown_called_);
+  if (run) {
+    TRACE_EVENT_FLOW_END0("task", "SequencedWorkerPool::PostTask",
+        TRACE_ID_MANGLE(GetTaskTraceID(task, static_cast<void*>(this))));
+    TRACE_EVENT2("task", "SequencedWorkerPool::ThreadLoop",
+                 "src_file", task.posted_from.file_name(),
+                 "src_func", task.posted_from.function_name());
+
+    this_worker->set_running_task_info(
+        SequenceToken(task.sequence_token_id), task.shutdown_behavior);
+
+    tracked_objects::TrackedTime start_time =
+        tracked_objects::ThreadData::NowForStartOfRun(task.birth_tally);
+
+    task.task.Run();
+
+    tracked_objects::ThreadData::TallyRunOnNamedThreadIfTracking(task,
+        start_time, tracked_objects::ThreadData::NowForEndOfRun());
+  }
+
+  // As in ThreadLoop(), destroy the closure while the sequence is still
+  // marked as running so sequence checks in destructors keep working. A task
+  // discarded at shutdown is destroyed in order, after the tasks before it.
+  task.task = Closure();
+  this_worker->set_running_task_info(SequenceToken(), CONTINUE_ON_SHUTDOWN);
+
+  if (item->sequence_token_id) {
+    bool more_tasks = true;
+    {
+      AutoLock lock(sequences_lock_);
+      std::map<int, std::deque<SequencedTask> >::iterator found =
+          sequences_.find(item->sequence_token_id);
+      DCHECK(found != sequences_.end());
+      if (found->second.empty()) {
+        sequences_.erase(found);
+        more_tasks = false;
+      }
+    }
+    if (more_tasks) {
+      // Keep the sequence on this worker: it is next in line here, and only
+      // gets stolen if this worker is slow to come back to it.
+      WorkerQueue* queue = worker_queues_[index];
+      {
+        AutoLock lock(queue->lock);
+        queue->items.push_front(*item);
+      }
+      subtle::Barrier_AtomicIncrement(&ws_queued_items_, 1);
+    }
+  }
+
+  DidFinishWorkStealingTask(task.shutdown_behavior, blocks_shutdown);
+}
+
+void SequencedWorkerPool::Inner::DidFinishWorkStealingTask(
+    WorkerShutdown shutdown_behavior,
+    bool was_running) {
+  bool shutdown_may_proceed = false;
+  if (was_running) {
+    shutdown_may_proceed =
+        subtle::Barrier_AtomicIncrement(&ws_blocking_running_, -1) == 0 &&
+        subtle::Acquire_Load(&ws_shutdown_called_);
+  }
+  bool pool_is_idle =
+      subtle::Barrier_AtomicIncrement(&ws_outstanding_tasks_, -1) == 0;
+
+  // Both conditions are rare, so the lock stays off the hot path.
+  if (shutdown_may_proceed || pool_is_idle) {
+    AutoLock lock(lock_);
+    if (shutdown_may_proceed)
+      can_shutdown_cv_.Signal();
+    if (pool_is_idle)
+      cleanup_cv_.Broadcast();
+  }
+}
+
+bool SequencedWorkerPool::Inner::MoveDueDelayedTasks(bool* has_delayed_work,
+                                                     TimeDelta* wait_time) {
+  *has_delayed_work = false;
+  std::vector<SequencedTask> due_tasks;
+  std::vector<Closure> delete_these_outside_lock;
+  {
+    AutoLock lock(lock_);
+    if (pending_tasks_.empty())
+      return false;
+
+    const TimeTicks current_time = TimeTicks::Now();
+    while (!pending_tasks_.empty()) {
+      PendingTaskSet::iterator i = pending_tasks_.begin();
+      if (i->time_to_run > current_time) {
+        *has_delayed_work = true;
+        *wait_time = i->time_to_run - current_time;
+        break;
+      }
+      if (i->shutdown_behavior == BLOCK_SHUTDOWN) {
+        // Hand the accounting over to the work-stealing counters; increment
+        // first so CanShutdown() never sees a gap.
+        subtle::Barrier_AtomicIncrement(&ws_blocking_pending_, 1);
+        blocking_shutdown_pending_task_count_--;
+      } else if (shutdown_called_) {
+        delete_these_outside_lock.push_back(i->task);
+        pending_tasks_.erase(i);
+        continue;
+      }
+      due_tasks.push_back(*i);
+      pending_tasks_.erase(i);
+    }
+  }
+
+  for (size_t i = 0; i < due_tasks.size(); ++i) {
+    subtle::Barrier_AtomicIncrement(&ws_outstanding_tasks_, 1);
+    EnqueueWorkStealingTask(due_tasks[i]);
+  }
+  return !due_tasks.empty() || !delete_these_outside_lock.empty();
+}
+
+void SequencedWorkerPool::Inner::WorkStealingThreadLoop(Worker* this_worker) {
+  {
+    AutoLock lock(lock_);
+    DCHECK(thread_being_created_);
+    thread_being_created_ = false;
+    std::pair<ThreadMap::iterator, bool> result =
+        threads_.insert(
+            std::make_pair(this_worker->tid(), make_linked_ptr(this_worker)));
+    DCHECK(result.second);
+  }
+  g_current_worker_.Get().Set(this_worker);
+  subtle::Barrier_AtomicIncrement(&ws_started_workers_, 1);
+
+  const size_t index = this_worker->thread_number() - 1;
+  DCHECK_LT(index, worker_queues_.size());
+
+  while (true) {
+#if defined(OS_MACOSX)
+    base::mac::ScopedNSAutoreleasePool autorelease_pool;
+#endif
+
+    WorkItem item;
+    if (TakeWorkItem(index, &item)) {
+      // There may be more work available, so wake up or start another
+      // worker before running a task that could take arbitrarily long.
+      if (subtle::Acquire_Load(&ws_queued_items_) > 0)
+        WakeWorkStealingWorker();
+      RunWorkItem(this_worker, index, &item);
+      continue;
+    }
+
+    bool has_delayed_work;
+    TimeDelta wait_time;
+    if (MoveDueDelayedTasks(&has_delayed_work, &wait_time))
+      continue;
+
+    // Like the global queue backend, leave once nothing that blocks
+    // shutdown is left to start.
+    if (subtle::Acquire_Load(&ws_shutdown_called_) &&
+        subtle::Acquire_Load(&ws_blocking_pending_) == 0) {
+      break;
+    }
+
+    AutoLock lock(idle_lock_);
+    subtle::Barrier_AtomicIncrement(&ws_idle_workers_, 1);
+    // Posters bump |ws_queued_items_| before looking at |ws_idle_workers_|,
+    // so re-checking here under |idle_lock_| cannot miss a wake-up. During
+    // shutdown, exiting workers wake the next one in turn.
+    bool may_exit = subtle::Acquire_Load(&ws_shutdown_called_) &&
+        subtle::Acquire_Load(&ws_blocking_pending_) == 0;
+    if (subtle::Acquire_Load(&ws_queued_items_) == 0 && !may_exit) {
+      base::ThreadRestrictions::ScopedAllowWait allow_wait;
+      if (has_delayed_work)
+        idle_cv_.TimedWait(wait_time);
+      else
+        idle_cv_.Wait();
+    }
+    subtle::Barrier_AtomicIncrement(&ws_idle_workers_, -1);
+  }
+
+  g_current_worker_.Get().Set(NULL);
+
+  // Wake up the next worker so it knows it should exit as well, and possibly
+  // unblock shutdown.
+  {
+    AutoLock lock(idle_lock_);
+    idle_cv_.Signal();
+  }
+  AutoLock lock(lock_);
+  can_shutdown_cv_.Signal();
+}
+
+void SequencedWorkerPool::Inner::CleanupWorkStealingForTesting() {
+  // Delayed tasks are deleted rather than run; see FlushForTesting().
+  std::vector<Closure> delete_these_outside_lock;
+  base::ThreadRestrictions::ScopedAllowWait allow_wait;
+  AutoLock lock(lock_);
+  if (shutdown_called_)
+    return;
+  for (PendingTaskSet::iterator i = pending_tasks_.begin();
+       i != pending_tasks_.end(); ++i) {
+    delete_these_outside_lock.push_back(i->task);
+    if (i->shutdown_behavior == BLOCK_SHUTDOWN)
+      blocking_shutdown_pending_task_count_--;
+  }
+  pending_tasks_.clear();
+  while (subtle::Acquire_Load(&ws_outstanding_tasks_) != 0)
+    cleanup_cv_.Wait();
 }
 
 base::StaticAtomicSequenceNumber
 SequencedWorkerPool::Inner::g_last_sequence_number_;
 
+// static
+base::LazyInstance<base::ThreadLocalPointer<SequencedWorkerPool::Worker> >
+    SequencedWorkerPool::Inner::g_current_worker_ = LAZY_INSTANCE_INITIALIZER;
+
 // SequencedWorkerPool --------------------------------------------------------
 
 // static
@@ -1138,15 +1677,27 @@ SequencedWorkerPool::SequencedWorkerPool(
     size_t max_threads,
     const std::string& thread_name_prefix)
     : constructor_message_loop_(MessageLoopProxy::current()),
-      inner_(new Inner(this, max_threads, thread_name_prefix, NULL)) {
+      inner_(new Inner(this, max_threads, thread_name_prefix, GLOBAL_QUEUE,
+                       NULL)) {
+}
+
+SequencedWorkerPool::SequencedWorkerPool(
+    size_t max_threads,
+    const std::string& thread_name_prefix,
+    TestingObserver* observer)
+    : constructor_message_loop_(MessageLoopProxy::current()),
+      inner_(new Inner(this, max_threads, thread_name_prefix, GLOBAL_QUEUE,
+                       observer)) {
 }
 
 SequencedWorkerPool::SequencedWorkerPool(
     size_t max_threads,
     const std::string& thread_name_prefix,
+    SchedulerBackend backend,
     TestingObserver* observer)
     : constructor_message_loop_(MessageLoopProxy::current()),
-      inner_(new Inner(this, max_threads, thread_name_prefix, observer)) {
+      inner_(new Inner(this, max_threads, thread_name_prefix, backend,
+                       observer)) {
 }
 
 SequencedWorkerPool::~SequencedWorkerPool() {}
@@ -139,6 +139,21 @@ class BASE_EXPORT SequencedWorkerPool : public TaskRunner {
     int id_;
   };
 
+  // Selects how worker threads find the next task to run.
+  enum SchedulerBackend {
+    // All pending tasks live in a single time-ordered set guarded by the pool
+    // lock. Every post and every task start takes that lock.
+    GLOBAL_QUEUE,
+
+    // Each worker owns a deque of immediate tasks and idle workers steal from
+    // the other deques. All tasks of a sequence are queued behind a single
+    // work item, so a sequence stays with the worker that is running it until
+    // it has no more tasks. Delayed tasks and shutdown bookkeeping still use
+    // the pool lock, but only when they are actually involved. Intended for
+    // pools with many threads that run many short tasks.
+    WORK_STEALING,
+  };
+
   // Allows tests to perform certain actions.
   class TestingObserver {
    public:
@@ -168,6 +183,13 @@ class BASE_EXPORT SequencedWorkerPool : public TaskRunner {
                       const std::string& thread_name_prefix,
                       TestingObserver* observer);
 
+  // Like above, but selecting the scheduler |backend|. |observer| may be
+  // NULL and is not owned.
+  SequencedWorkerPool(size_t max_threads,
+                      const std::string& thread_name_prefix,
+                      SchedulerBackend backend,
+                      TestingObserver* observer);
+
   // Returns a unique token that can be used to sequence tasks posted to
   // PostSequencedWorkerTask(). Valid tokens are always nonzero.
   SequenceToken GetSequenceToken();
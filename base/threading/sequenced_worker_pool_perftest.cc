@@ -0,0 +1,131 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/bind.h"
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop/message_loop.h"
+#include "base/perftimer.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/test/sequenced_worker_pool_owner.h"
+#include "base/threading/sequenced_worker_pool.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const size_t kNumWorkerThreads = 16;
+const int kNumPosterThreads = 4;
+const int kTasksPerPoster = 25000;
+const int kNumSequences = 64;
+
+// Signals |done| once |expected| tasks have run.
+class CompletionCounter {
+ public:
+  CompletionCounter(int expected, WaitableEvent* done)
+      : remaining_(expected),
+        done_(done) {
+  }
+
+  void TaskDone() {
+    AutoLock lock(lock_);
+    if (--remaining_ == 0)
+      done_->Signal();
+  }
+
+ private:
+  Lock lock_;
+  int remaining_;
+  WaitableEvent* done_;
+};
+
+// A task that does a small, fixed amount of work, so that scheduling overhead
+// dominates.
+void SmallTask(CompletionCounter* counter) {
+  volatile int sink = 0;
+  for (int i = 0; i < 200; ++i)
+    sink += i;
+  counter->TaskDone();
+}
+
+void PostTasks(SequencedWorkerPool* pool,
+               const std::vector<SequencedWorkerPool::SequenceToken>* tokens,
+               CompletionCounter* counter,
+               WaitableEvent* start,
+               int num_tasks) {
+  start->Wait();
+  for (int i = 0; i < num_tasks; ++i) {
+    Closure task = Bind(&SmallTask, Unretained(counter));
+    if (tokens->empty())
+      pool->PostWorkerTask(FROM_HERE, task);
+    else
+      pool->PostSequencedWorkerTask((*tokens)[i % tokens->size()],
+                                    FROM_HERE, task);
+  }
+}
+
+void RunThroughputTest(SequencedWorkerPool::SchedulerBackend backend,
+                       bool sequenced) {
+  MessageLoop message_loop;
+  SequencedWorkerPoolOwner pool_owner(kNumWorkerThreads, "PerfTest", backend);
+  SequencedWorkerPool* pool = pool_owner.pool().get();
+
+  std::vector<SequencedWorkerPool::SequenceToken> tokens;
+  if (sequenced) {
+    for (int i = 0; i < kNumSequences; ++i)
+      tokens.push_back(pool->GetSequenceToken());
+  }
+
+  const int total_tasks = kNumPosterThreads * kTasksPerPoster;
+  WaitableEvent start(true, false);
+  WaitableEvent done(false, false);
+  CompletionCounter counter(total_tasks, &done);
+
+  ScopedVector<Thread> posters;
+  for (int i = 0; i < kNumPosterThreads; ++i) {
+    posters.push_back(new Thread(StringPrintf("Poster%d", i)));
+    ASSERT_TRUE(posters.back()->Start());
+    posters.back()->message_loop()->PostTask(
+        FROM_HERE,
+        Bind(&PostTasks, pool, &tokens, &counter, &start, kTasksPerPoster));
+  }
+
+  PerfTimer timer;
+  start.Signal();
+  done.Wait();
+  TimeDelta elapsed = timer.Elapsed();
+
+  posters.clear();
+  pool->Shutdown();
+
+  std::string name = StringPrintf(
+      "SequencedWorkerPool_%s_%s",
+      backend == SequencedWorkerPool::WORK_STEALING ?
+          "work_stealing" : "global_queue",
+      sequenced ? "sequenced" : "unsequenced");
+  LogPerfResult(name.c_str(), total_tasks / elapsed.InSecondsF(), "tasks/s");
+}
+
+}  // namespace
+
+TEST(SequencedWorkerPoolPerfTest, UnsequencedGlobalQueue) {
+  RunThroughputTest(SequencedWorkerPool::GLOBAL_QUEUE, false);
+}
+
+TEST(SequencedWorkerPoolPerfTest, UnsequencedWorkStealing) {
+  RunThroughputTest(SequencedWorkerPool::WORK_STEALING, false);
+}
+
+TEST(SequencedWorkerPoolPerfTest, SequencedGlobalQueue) {
+  RunThroughputTest(SequencedWorkerPool::GLOBAL_QUEUE, true);
+}
+
+TEST(SequencedWorkerPoolPerfTest, SequencedWorkStealing) {
+  RunThroughputTest(SequencedWorkerPool::WORK_STEALING, true);
+}
+
+}  // namespace base
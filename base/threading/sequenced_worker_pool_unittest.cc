@@ -179,7 +179,8 @@ class TestTracker : public base::RefCountedThreadSafe<TestTracker> {
 class SequencedWorkerPoolTest : public testing::Test {
  public:
   SequencedWorkerPoolTest()
-      : tracker_(new TestTracker) {
+      : backend_(SequencedWorkerPool::GLOBAL_QUEUE),
+        tracker_(new TestTracker) {
     ResetPool();
   }
 
@@ -199,7 +200,8 @@ class SequencedWorkerPoolTest : public testing::Test {
   // Destroys the SequencedWorkerPool instance, blocking until it is fully shut
   // down, and creates a new instance.
   void ResetPool() {
-    pool_owner_.reset(new SequencedWorkerPoolOwner(kNumWorkerThreads, "test"));
+    pool_owner_.reset(
+        new SequencedWorkerPoolOwner(kNumWorkerThreads, "test", backend_));
   }
 
   void SetWillWaitForShutdownCallback(const Closure& callback) {
@@ -243,7 +245,16 @@ class SequencedWorkerPoolTest : public testing::Test {
     return pool_owner_->has_work_call_count();
   }
 
+ protected:
+  explicit SequencedWorkerPoolTest(
+      SequencedWorkerPool::SchedulerBackend backend)
+      : backend_(backend),
+        tracker_(new TestTracker) {
+    ResetPool();
+  }
+
  private:
+  const SequencedWorkerPool::SchedulerBackend backend_;
   MessageLoop message_loop_;
   scoped_ptr<SequencedWorkerPoolOwner> pool_owner_;
   const scoped_refptr<TestTracker> tracker_;
@@ -796,6 +807,155 @@ TEST_F(SequencedWorkerPoolTest, FlushForTesting) {
   pool()->FlushForTesting();
 }
 
+class SequencedWorkerPoolWorkStealingTest : public SequencedWorkerPoolTest {
+ public:
+  SequencedWorkerPoolWorkStealingTest()
+      : SequencedWorkerPoolTest(SequencedWorkerPool::WORK_STEALING) {}
+};
+
+void PostSequencedFastTasks(const scoped_refptr<SequencedWorkerPool>& pool,
+                            SequencedWorkerPool::SequenceToken token,
+                            const scoped_refptr<TestTracker>& tracker,
+                            int first_id,
+                            int num_tasks) {
+  for (int i = 0; i < num_tasks; ++i) {
+    pool->PostSequencedWorkerTask(
+        token, FROM_HERE,
+        base::Bind(&TestTracker::FastTask, tracker, first_id + i));
+  }
+}
+
+TEST_F(SequencedWorkerPoolWorkStealingTest, LotsOfTasks) {
+  pool()->PostWorkerTask(FROM_HERE,
+                         base::Bind(&TestTracker::SlowTask, tracker(), 0));
+
+  const size_t kNumTasks = 200;
+  for (size_t i = 1; i < kNumTasks; i++) {
+    pool()->PostWorkerTask(FROM_HERE,
+                           base::Bind(&TestTracker::FastTask, tracker(), i));
+  }
+
+  std::vector<int> result = tracker()->WaitUntilTasksComplete(kNumTasks);
+  EXPECT_EQ(kNumTasks, result.size());
+}
+
+// Tests that tasks of one sequence run in order even when they are posted
+// from worker threads of the pool, which push to their own deques.
+TEST_F(SequencedWorkerPoolWorkStealingTest, SequenceOrderFromWorkers) {
+  EnsureAllWorkersCreated();
+
+  const int kNumSequences = 4;
+  const int kTasksPerSequence = 50;
+  std::vector<SequencedWorkerPool::SequenceToken> tokens;
+  for (int i = 0; i < kNumSequences; ++i) {
+    tokens.push_back(pool()->GetSequenceToken());
+    pool()->PostWorkerTask(
+        FROM_HERE,
+        base::Bind(&PostSequencedFastTasks, pool(), tokens[i],
+                   make_scoped_refptr(tracker()), i * 1000,
+                   kTasksPerSequence));
+  }
+
+  std::vector<int> result =
+      tracker()->WaitUntilTasksComplete(kNumSequences * kTasksPerSequence);
+  ASSERT_EQ(static_cast<size_t>(kNumSequences * kTasksPerSequence),
+            result.size());
+  std::vector<int> last_seen(kNumSequences, -1);
+  for (size_t i = 0; i < result.size(); ++i) {
+    int sequence = result[i] / 1000;
+    int index = result[i] % 1000;
+    EXPECT_EQ(last_seen[sequence] + 1, index);
+    last_seen[sequence] = index;
+  }
+}
+
+// Tests that a sequence never runs on two workers at once.
+TEST_F(SequencedWorkerPoolWorkStealingTest, Sequence) {
+  ThreadBlocker blocker;
+  SequencedWorkerPool::SequenceToken token = pool()->GetSequenceToken();
+  pool()->PostSequencedWorkerTask(
+      token, FROM_HERE,
+      base::Bind(&TestTracker::BlockTask, tracker(), 100, &blocker));
+  pool()->PostSequencedWorkerTask(
+      token, FROM_HERE,
+      base::Bind(&TestTracker::FastTask, tracker(), 101));
+  tracker()->WaitUntilTasksBlocked(1);
+
+  // Unsequenced work keeps flowing while the sequence is blocked.
+  pool()->PostWorkerTask(FROM_HERE,
+                         base::Bind(&TestTracker::FastTask, tracker(), 1));
+  std::vector<int> result = tracker()->WaitUntilTasksComplete(1);
+  ASSERT_EQ(1u, result.size());
+  EXPECT_EQ(1, result[0]);
+
+  blocker.Unblock(1);
+  result = tracker()->WaitUntilTasksComplete(3);
+  ASSERT_EQ(3u, result.size());
+  EXPECT_EQ(100, result[1]);
+  EXPECT_EQ(101, result[2]);
+}
+
+// Tests that unrun tasks are discarded according to their shutdown mode.
+TEST_F(SequencedWorkerPoolWorkStealingTest, DiscardOnShutdown) {
+  EnsureAllWorkersCreated();
+  ThreadBlocker blocker;
+  for (size_t i = 0; i < kNumWorkerThreads; i++) {
+    pool()->PostWorkerTask(FROM_HERE,
+                           base::Bind(&TestTracker::BlockTask,
+                                      tracker(), i, &blocker));
+  }
+  tracker()->WaitUntilTasksBlocked(kNumWorkerThreads);
+
+  pool()->PostWorkerTaskWithShutdownBehavior(
+      FROM_HERE,
+      base::Bind(&TestTracker::FastTask, tracker(), 100),
+      SequencedWorkerPool::CONTINUE_ON_SHUTDOWN);
+  pool()->PostWorkerTaskWithShutdownBehavior(
+      FROM_HERE,
+      base::Bind(&TestTracker::FastTask, tracker(), 101),
+      SequencedWorkerPool::SKIP_ON_SHUTDOWN);
+  pool()->PostWorkerTaskWithShutdownBehavior(
+      FROM_HERE,
+      base::Bind(&TestTracker::FastTask, tracker(), 102),
+      SequencedWorkerPool::BLOCK_SHUTDOWN);
+
+  SetWillWaitForShutdownCallback(
+      base::Bind(&EnsureTasksToCompleteCountAndUnblock,
+                 scoped_refptr<TestTracker>(tracker()), 0,
+                 &blocker, kNumWorkerThreads));
+  pool()->Shutdown();
+
+  std::vector<int> result =
+      tracker()->WaitUntilTasksComplete(kNumWorkerThreads + 1);
+  ASSERT_EQ(kNumWorkerThreads + 1, result.size());
+  EXPECT_TRUE(std::find(result.begin(), result.end(), 102) != result.end());
+  EXPECT_TRUE(std::find(result.begin(), result.end(), 100) == result.end());
+  EXPECT_TRUE(std::find(result.begin(), result.end(), 101) == result.end());
+
+  // Tasks posted after shutdown are rejected.
+  EXPECT_FALSE(pool()->PostWorkerTask(
+      FROM_HERE, base::Bind(&TestTracker::FastTask, tracker(), 103)));
+}
+
+TEST_F(SequencedWorkerPoolWorkStealingTest, FlushForTesting) {
+  pool()->PostDelayedTask(FROM_HERE, base::Bind(&TestTracker::FastTask,
+                                                tracker(), 0),
+                          TimeDelta::FromMinutes(5));
+  pool()->PostWorkerTask(FROM_HERE,
+                         base::Bind(&TestTracker::SlowTask, tracker(), 0));
+  const size_t kNumFastTasks = 20;
+  for (size_t i = 0; i < kNumFastTasks; i++) {
+    pool()->PostWorkerTask(FROM_HERE,
+                           base::Bind(&TestTracker::FastTask, tracker(), 0));
+  }
+
+  pool()->FlushForTesting();
+  EXPECT_EQ(1 + kNumFastTasks, tracker()->GetTasksCompletedCount());
+
+  // Should be fine to call on an idle instance with nothing pending.
+  pool()->FlushForTesting();
+}
+
 TEST(SequencedWorkerPoolRefPtrTest, ShutsDownCleanWithContinueOnShutdown) {
   MessageLoop loop;
   scoped_refptr<SequencedWorkerPool> pool(new SequencedWorkerPool(3, "Pool"));
@@ -931,6 +1091,52 @@ INSTANTIATE_TYPED_TEST_CASE_P(
     SequencedWorkerPoolSequencedTaskRunner, SequencedTaskRunnerTest,
     SequencedWorkerPoolSequencedTaskRunnerTestDelegate);
 
+class SequencedWorkerPoolWorkStealingSequencedTaskRunnerTestDelegate {
+ public:
+  SequencedWorkerPoolWorkStealingSequencedTaskRunnerTestDelegate() {}
+
+  ~SequencedWorkerPoolWorkStealingSequencedTaskRunnerTestDelegate() {
+  }
+
+  void StartTaskRunner() {
+    pool_owner_.reset(new SequencedWorkerPoolOwner(
+        10, "SequencedWorkerPoolWorkStealingSequencedTaskRunnerTest",
+        SequencedWorkerPool::WORK_STEALING));
+    task_runner_ = pool_owner_->pool()->GetSequencedTaskRunner(
+        pool_owner_->pool()->GetSequenceToken());
+  }
+
+  scoped_refptr<SequencedTaskRunner> GetTaskRunner() {
+    return task_runner_;
+  }
+
+  void StopTaskRunner() {
+    // Make sure all tasks are run before shutting down. Delayed tasks are
+    // not run, they're simply deleted.
+    pool_owner_->pool()->FlushForTesting();
+    pool_owner_->pool()->Shutdown();
+    // Don't reset |pool_owner_| here, as the test may still hold a
+    // reference to the pool.
+  }
+
+  bool TaskRunnerHandlesNonZeroDelays() const {
+    return true;
+  }
+
+ private:
+  MessageLoop message_loop_;
+  scoped_ptr<SequencedWorkerPoolOwner> pool_owner_;
+  scoped_refptr<SequencedTaskRunner> task_runner_;
+};
+
+INSTANTIATE_TYPED_TEST_CASE_P(
+    SequencedWorkerPoolWorkStealingSequencedTaskRunner, TaskRunnerTest,
+    SequencedWorkerPoolWorkStealingSequencedTaskRunnerTestDelegate);
+
+INSTANTIATE_TYPED_TEST_CASE_P(
+    SequencedWorkerPoolWorkStealingSequencedTaskRunner, SequencedTaskRunnerTest,
+    SequencedWorkerPoolWorkStealingSequencedTaskRunnerTestDelegate);
+
 }  // namespace
 
 }  // namespace base
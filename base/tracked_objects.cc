@@ -7,6 +7,8 @@
 #include <math.h>
 #include <stdlib.h>
 
+#include <algorithm>
+
 #include "base/compiler_specific.h"
 #include "base/debug/leak_annotations.h"
 #include "base/format_macros.h"
@@ -100,6 +102,22 @@ void DeathData::RecordDeath(const int32 queue_duration,
   }
 }
 
+void DeathData::RecordSampledDeath(const int32 queue_duration,
+                                   const int32 run_duration,
+                                   int32 sampling_interval,
+                                   int32 random_number) {
+  RecordDeath(queue_duration, run_duration, random_number);
+  // RecordDeath() added the durations once; add them for the runs that this
+  // one stands in for.
+  queue_duration_sum_ += queue_duration * (sampling_interval - 1);
+  run_duration_sum_ += run_duration * (sampling_interval - 1);
+}
+
+void DeathData::RecordUntimedDeath() {
+  if (count_ < INT_MAX)
+    ++count_;
+}
+
 int DeathData::count() const { return count_; }
 
 int32 DeathData::run_duration_sum() const { return run_duration_sum_; }
@@ -234,10 +252,14 @@ base::LazyInstance<base::Lock>::Leaky
 // static
 ThreadData::Status ThreadData::status_ = ThreadData::UNINITIALIZED;
 
+// static
+int32 ThreadData::sampling_interval_ = 1;
+
 ThreadData::ThreadData(const std::string& suggested_name)
     : next_(NULL),
       next_retired_worker_(NULL),
       worker_thread_number_(0),
+      runs_until_sample_(0),
       incarnation_count_for_pool_(-1) {
   DCHECK_GE(suggested_name.size(), 0u);
   thread_name_ = suggested_name;
@@ -248,6 +270,7 @@ ThreadData::ThreadData(int thread_number)
     : next_(NULL),
       next_retired_worker_(NULL),
       worker_thread_number_(thread_number),
+      runs_until_sample_(0),
       incarnation_count_for_pool_(-1)  {
   CHECK_GT(thread_number, 0);
   base::StringAppendF(&thread_name_, "WorkerThread-%d", thread_number);
@@ -402,6 +425,7 @@ Births* ThreadData::TallyABirth(const Location& location) {
 }
 
 void ThreadData::TallyADeath(const Births& birth,
+                             bool timed,
                              int32 queue_duration,
                              int32 run_duration) {
   // Stir in some randomness, plus add constant in case durations are zero.
@@ -424,7 +448,14 @@ void ThreadData::TallyADeath(const Births& birth,
     base::AutoLock lock(map_lock_);  // Lock as the map may get relocated now.
     death_data = &death_map_[&birth];
   }  // Release lock ASAP.
-  death_data->RecordDeath(queue_duration, run_duration, random_number_);
+  if (!timed) {
+    death_data->RecordUntimedDeath();
+  } else if (sampling_interval_ > 1) {
+    death_data->RecordSampledDeath(queue_duration, run_duration,
+                                   sampling_interval_, random_number_);
+  } else {
+    death_data->RecordDeath(queue_duration, run_duration, random_number_);
+  }
 
   if (!kTrackParentChildLinks)
     return;
@@ -469,7 +500,8 @@ void ThreadData::TallyRunOnNamedThreadIfTracking(
   // of start_of_run or end_of_run is zero.  In that case, we didn't bother to
   // get a time value since we "weren't tracking" and we were trying to be
   // efficient by not calling for a genuine time value. For simplicity, we'll
-  // use a default zero duration when we can't calculate a true value.
+  // use a default zero duration when we can't calculate a true value.  A null
+  // start_of_run also marks a run that was not sampled, which is only counted.
   int32 queue_duration = 0;
   int32 run_duration = 0;
   if (!start_of_run.is_null()) {
@@ -478,7 +510,8 @@ void ThreadData::TallyRunOnNamedThreadIfTracking(
     if (!end_of_run.is_null())
       run_duration = (end_of_run - start_of_run).InMilliseconds();
   }
-  current_thread_data->TallyADeath(*birth, queue_duration, run_duration);
+  current_thread_data->TallyADeath(*birth, !start_of_run.is_null(),
+                                   queue_duration, run_duration);
 }
 
 // static
@@ -516,7 +549,8 @@ void ThreadData::TallyRunOnWorkerThreadIfTracking(
     if (!end_of_run.is_null())
       run_duration = (end_of_run - start_of_run).InMilliseconds();
   }
-  current_thread_data->TallyADeath(*birth, queue_duration, run_duration);
+  current_thread_data->TallyADeath(*birth, !start_of_run.is_null(),
+                                   queue_duration, run_duration);
 }
 
 // static
@@ -541,7 +575,8 @@ void ThreadData::TallyRunInAScopedRegionIfTracking(
   int32 run_duration = 0;
   if (!start_of_run.is_null() && !end_of_run.is_null())
     run_duration = (end_of_run - start_of_run).InMilliseconds();
-  current_thread_data->TallyADeath(*birth, queue_duration, run_duration);
+  current_thread_data->TallyADeath(*birth, !start_of_run.is_null(),
+                                   queue_duration, run_duration);
 }
 
 // static
@@ -733,14 +768,58 @@ TrackedTime ThreadData::NowForStartOfRun(const Births* parent) {
     if (current_thread_data)
       current_thread_data->parent_stack_.push(parent);
   }
+  if (kTrackAllTaskObjects && sampling_interval_ > 1 && TrackingStatus()) {
+    ThreadData* current_thread_data = Get();
+    if (current_thread_data && !current_thread_data->StartSampledRun())
+      return TrackedTime();  // Counted, but not timed.
+  }
   return Now();
 }
 
 // static
 TrackedTime ThreadData::NowForEndOfRun() {
+  if (kTrackAllTaskObjects && sampling_interval_ > 1) {
+    ThreadData* current_thread_data = Get();
+    if (current_thread_data && !current_thread_data->EndSampledRun())
+      return TrackedTime();
+  }
   return Now();
 }
 
+// static
+void ThreadData::SetSamplingInterval(int32 sampling_interval) {
+  DCHECK_GE(sampling_interval, 1);
+  // Runs that are open on any thread during the change might have their start
+  // and end times decided differently, and be counted without times.
+  sampling_interval_ = std::max(sampling_interval, 1);
+}
+
+// static
+int32 ThreadData::sampling_interval() {
+  return sampling_interval_;
+}
+
+bool ThreadData::StartSampledRun() {
+  bool sampled = false;
+  if (runs_until_sample_ <= 0) {
+    sampled = true;
+    runs_until_sample_ = sampling_interval_;
+  }
+  --runs_until_sample_;
+  sampled_runs_.push_back(sampled);
+  return sampled;
+}
+
+bool ThreadData::EndSampledRun() {
+  // The run may have started before sampling was turned on, or while we
+  // weren't tracking.  Time it, as we would have without sampling.
+  if (sampled_runs_.empty())
+    return true;
+  const bool sampled = sampled_runs_.back();
+  sampled_runs_.pop_back();
+  return sampled;
+}
+
 // static
 void ThreadData::SetAlternateTimeSource(NowFunction* now_function) {
   DCHECK(now_function);
@@ -794,6 +873,7 @@ void ThreadData::ShutdownSingleThreadedCleanup(bool leak) {
   // Put most global static back in pristine shape.
   worker_thread_data_creation_count_ = 0;
   cleanup_count_ = 0;
+  sampling_interval_ = 1;
   tls_index_.Set(NULL);
   status_ = DORMANT_DURING_TESTS;  // Almost UNINITIALIZED.
 
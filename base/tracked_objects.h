@@ -271,6 +271,19 @@ class BASE_EXPORT DeathData {
                    const int32 run_duration,
                    int random_number);
 
+  // Update stats for a task destruction that was picked, one in
+  // |sampling_interval|, to have its times measured.  The durations are
+  // scaled up in the sums so that averages stay unbiased, while the max and
+  // sample values are left as measured.
+  void RecordSampledDeath(const int32 queue_duration,
+                          const int32 run_duration,
+                          int32 sampling_interval,
+                          int random_number);
+
+  // Update stats for a task destruction whose times were not measured,
+  // because it was not sampled.  Only the count changes.
+  void RecordUntimedDeath();
+
   // Metrics accessors, used only for serialization and in tests.
   int count() const;
   int32 run_duration_sum() const;
@@ -461,9 +474,19 @@ class BASE_EXPORT ThreadData {
   // accumulated outside of execution of tracked runs.
   // The task that will be tracked is passed in as |parent| so that parent-child
   // relationships can be (optionally) calculated.
+  // When a sampling interval is set, only one in that many runs on each thread
+  // gets real times, and the others get null times, which the Tally*()
+  // functions count without timing.
   static TrackedTime NowForStartOfRun(const Births* parent);
   static TrackedTime NowForEndOfRun();
 
+  // Times only one in |sampling_interval| runs on each thread, rather than
+  // every run, which takes two clock reads off most tasks when profiling is
+  // left on.  The sums of durations are scaled up to compensate.  An interval
+  // of 1, the default, times every run.
+  static void SetSamplingInterval(int32 sampling_interval);
+  static int32 sampling_interval();
+
   // Provide a time function that does nothing (runs fast) when we don't have
   // the profiler enabled.  It will generally be optimized away when it is
   // ifdef'ed to be small enough (allowing the profiler to be "compiled out" of
@@ -517,8 +540,17 @@ class BASE_EXPORT ThreadData {
   // In this thread's data, record a new birth.
   Births* TallyABirth(const Location& location);
 
-  // Find a place to record a death on this thread.
-  void TallyADeath(const Births& birth, int32 queue_duration, int32 duration);
+  // Find a place to record a death on this thread.  If |timed| is false,
+  // the durations were not measured, and only the count is recorded.
+  void TallyADeath(const Births& birth,
+                   bool timed,
+                   int32 queue_duration,
+                   int32 duration);
+
+  // Decides whether the run that is starting on this thread gets timed, and
+  // remembers the decision for the matching EndSampledRun().
+  bool StartSampledRun();
+  bool EndSampledRun();
 
   // Snapshot (under a lock) the profiled data for the tasks in each ThreadData
   // instance.  Also updates the |birth_counts| tally for each task to keep
@@ -614,6 +646,9 @@ class BASE_EXPORT ThreadData {
   // We set status_ to SHUTDOWN when we shut down the tracking service.
   static Status status_;
 
+  // One in this many runs on each thread is timed.
+  static int32 sampling_interval_;
+
   // Link to next instance (null terminated list). Used to globally track all
   // registered instances (corresponds to all registered threads where we keep
   // data).
@@ -669,6 +704,14 @@ class BASE_EXPORT ThreadData {
   // significant additional cost).
   ParentStack parent_stack_;
 
+  // Whether each of the runs that are currently open on this thread was picked
+  // for timing, innermost last.  Like parent_stack_, this is usually one deep.
+  // Only used when sampling_interval_ is above 1.
+  std::vector<bool> sampled_runs_;
+
+  // The number of runs to start on this thread before the next timed one.
+  int32 runs_until_sample_;
+
   // A random number that we used to select decide which sample to keep as a
   // representative sample in each DeathData instance.  We can't start off with
   // much randomness (because we can't call RandInt() on all our threads), so
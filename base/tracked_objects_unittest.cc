@@ -578,4 +578,53 @@ TEST_F(TrackedObjectsTest, DifferentLives) {
   EXPECT_EQ(base::GetCurrentProcId(), process_data.process_id);
 }
 
+TEST_F(TrackedObjectsTest, SampledLives) {
+  if (!ThreadData::InitializeAndSetTrackingStatus(
+          ThreadData::PROFILING_CHILDREN_ACTIVE))
+    return;
+
+  const int kSamplingInterval = 4;
+  ThreadData::SetSamplingInterval(kSamplingInterval);
+
+  const char kFunction[] = "SampledLives";
+  Location location(kFunction, kFile, kLineNumber, NULL);
+  TallyABirth(location, kMainThreadName);
+
+  const base::TimeTicks kTimePosted = base::TimeTicks() +
+      base::TimeDelta::FromMilliseconds(1);
+  const base::TimeTicks kDelayedStartTime = base::TimeTicks();
+  const TrackedTime kStartOfRun = TrackedTime() +
+      Duration::FromMilliseconds(5);
+  const TrackedTime kEndOfRun = TrackedTime() + Duration::FromMilliseconds(7);
+
+  // Only one run in each kSamplingInterval is timed.
+  for (int i = 0; i < 2 * kSamplingInterval; ++i) {
+    // TrackingInfo will call TallyABirth() during construction.
+    base::TrackingInfo pending_task(location, kDelayedStartTime);
+    pending_task.time_posted = kTimePosted;  // Overwrite implied Now().
+
+    const TrackedTime start_of_run = ThreadData::NowForStartOfRun(
+        pending_task.birth_tally);
+    const TrackedTime end_of_run = ThreadData::NowForEndOfRun();
+    EXPECT_EQ(i % kSamplingInterval == 0, !start_of_run.is_null());
+    EXPECT_EQ(start_of_run.is_null(), end_of_run.is_null());
+
+    // Substitute fixed times for the sampled runs.
+    if (start_of_run.is_null()) {
+      ThreadData::TallyRunOnNamedThreadIfTracking(pending_task,
+          start_of_run, end_of_run);
+    } else {
+      ThreadData::TallyRunOnNamedThreadIfTracking(pending_task,
+          kStartOfRun, kEndOfRun);
+    }
+  }
+
+  // Every run is counted, and the sums of the two timed runs are scaled up to
+  // stand in for all of them.
+  ProcessDataSnapshot process_data;
+  ThreadData::Snapshot(false, &process_data);
+  ExpectSimpleProcessData(process_data, kFunction, kMainThreadName,
+                          kMainThreadName, 2 * kSamplingInterval, 2, 4);
+}
+
 }  // namespace tracked_objects
@@ -342,6 +342,7 @@
             '../chrome/chrome.gyp:performance_browser_tests',
             '../chrome/chrome.gyp:performance_ui_tests',
             '../chrome/chrome.gyp:sync_performance_tests',
+            '../gpu/gpu.gyp:gpu_perftests',
           ],
         }, # target_name: chromium_builder_perf
         {
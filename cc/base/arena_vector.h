@@ -0,0 +1,163 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_BASE_ARENA_VECTOR_H_
+#define CC_BASE_ARENA_VECTOR_H_
+
+#include <new>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "cc/base/scoped_ptr_vector.h"
+
+namespace cc {
+
+// A vector of pointers to objects of |BaseType|, or of types derived from it,
+// which owns the objects like a ScopedPtrVector. Objects made with
+// AllocateAndConstruct() are placed in blocks that hold many objects of the
+// same type next to each other, instead of being allocated one at a time, and
+// are all destroyed together with the vector. Objects that were allocated on
+// their own can still be added with push_back().
+template <typename BaseType>
+class ArenaVector {
+ public:
+  // The elements can't be changed through iterators; new objects have to be
+  // added with methods of the ArenaVector.
+  typedef typename std::vector<BaseType*>::const_iterator const_iterator;
+  typedef const_iterator iterator;
+  typedef typename std::vector<BaseType*>::const_reverse_iterator
+      const_reverse_iterator;
+  typedef const_reverse_iterator reverse_iterator;
+
+  ArenaVector() {}
+
+  ~ArenaVector() { clear(); }
+
+  size_t size() const { return data_.size(); }
+
+  BaseType* at(size_t index) const {
+    DCHECK(index < size());
+    return data_[index];
+  }
+
+  BaseType* operator[](size_t index) const { return at(index); }
+
+  BaseType* front() const {
+    DCHECK(!empty());
+    return at(0);
+  }
+
+  BaseType* back() const {
+    DCHECK(!empty());
+    return at(size() - 1);
+  }
+
+  bool empty() const { return data_.empty(); }
+
+  void reserve(size_t size) { data_.reserve(size); }
+
+  void clear() {
+    data_.clear();
+    separately_allocated_.clear();
+    for (size_t i = 0; i < blocks_.size(); ++i) {
+      Block& block = blocks_[i];
+      for (size_t j = 0; j < block.size; ++j)
+        block.destroy(block.data + j * block.object_size);
+      delete[] block.data;
+    }
+    blocks_.clear();
+    open_blocks_.clear();
+  }
+
+  // Takes ownership of an object that was allocated on its own.
+  void push_back(scoped_ptr<BaseType> item) {
+    data_.push_back(item.get());
+    separately_allocated_.push_back(item.Pass());
+  }
+
+  // Default-constructs a |DerivedType| in the vector's storage, appends it,
+  // and returns it.
+  template <typename DerivedType>
+  DerivedType* AllocateAndConstruct() {
+    DerivedType* object = new (Allocate(sizeof(DerivedType),
+                                        &DestroyObject<DerivedType>))
+        DerivedType;
+    data_.push_back(object);
+    return object;
+  }
+
+  const_iterator begin() const { return data_.begin(); }
+  const_iterator end() const { return data_.end(); }
+  const_reverse_iterator rbegin() const { return data_.rbegin(); }
+  const_reverse_iterator rend() const { return data_.rend(); }
+
+ private:
+  typedef void (*DestroyFunction)(void* object);
+
+  // Holds up to |capacity| objects of one type, of which the first |size| are
+  // constructed. The type is told apart by its |destroy| function.
+  struct Block {
+    char* data;
+    size_t object_size;
+    size_t capacity;
+    size_t size;
+    DestroyFunction destroy;
+  };
+
+  enum { kInitialBlockCapacity = 16 };
+
+  template <typename DerivedType>
+  static void DestroyObject(void* object) {
+    static_cast<DerivedType*>(object)->~DerivedType();
+  }
+
+  void* Allocate(size_t object_size, DestroyFunction destroy) {
+    // There are only ever a few types, so a search is quick enough. The size
+    // is compared as well in case the linker merged the destroy functions of
+    // two types.
+    size_t type = 0;
+    while (type < open_blocks_.size() &&
+           (blocks_[open_blocks_[type]].destroy != destroy ||
+            blocks_[open_blocks_[type]].object_size != object_size))
+      ++type;
+
+    bool is_new_type = type == open_blocks_.size();
+    if (is_new_type || blocks_[open_blocks_[type]].size ==
+                           blocks_[open_blocks_[type]].capacity) {
+      // Blocks double in size, which keeps the number of allocations
+      // logarithmic in the number of objects of the type.
+      Block block;
+      block.object_size = object_size;
+      block.capacity = is_new_type ?
+          kInitialBlockCapacity : 2 * blocks_[open_blocks_[type]].capacity;
+      block.size = 0;
+      block.destroy = destroy;
+      // Like a single object from operator new, the block is suitably
+      // aligned for any type, and so is every object in it.
+      block.data = new char[block.object_size * block.capacity];
+      blocks_.push_back(block);
+      if (is_new_type)
+        open_blocks_.push_back(blocks_.size() - 1);
+      else
+        open_blocks_[type] = blocks_.size() - 1;
+    }
+
+    Block& block = blocks_[open_blocks_[type]];
+    return block.data + block.object_size * block.size++;
+  }
+
+  std::vector<BaseType*> data_;
+  ScopedPtrVector<BaseType> separately_allocated_;
+  std::vector<Block> blocks_;
+  // The index in |blocks_| of the newest block of each type.
+  std::vector<size_t> open_blocks_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArenaVector);
+};
+
+}  // namespace cc
+
+#endif  // CC_BASE_ARENA_VECTOR_H_
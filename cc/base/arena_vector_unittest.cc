@@ -0,0 +1,110 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/base/arena_vector.h"
+
+#include "base/compiler_specific.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace cc {
+namespace {
+
+class Base {
+ public:
+  virtual ~Base() {}
+  virtual int value() const = 0;
+};
+
+// Counts how many of its instances are alive.
+class Small : public Base {
+ public:
+  Small() : value_(0) { ++count_; }
+  virtual ~Small() { --count_; }
+  virtual int value() const OVERRIDE { return value_; }
+
+  int value_;
+  static int count_;
+};
+
+int Small::count_ = 0;
+
+class Large : public Base {
+ public:
+  Large() : value_(0) { ++count_; }
+  virtual ~Large() { --count_; }
+  virtual int value() const OVERRIDE { return value_; }
+
+  int value_;
+  double padding_[8];
+  static int count_;
+};
+
+int Large::count_ = 0;
+
+TEST(ArenaVectorTest, KeepsOrderAcrossTypes) {
+  ArenaVector<Base> v;
+  for (int i = 0; i < 100; ++i) {
+    if (i % 3) {
+      Small* small = v.AllocateAndConstruct<Small>();
+      small->value_ = i;
+    } else {
+      Large* large = v.AllocateAndConstruct<Large>();
+      large->value_ = i;
+    }
+  }
+
+  ASSERT_EQ(100u, v.size());
+  for (size_t i = 0; i < v.size(); ++i)
+    EXPECT_EQ(static_cast<int>(i), v[i]->value());
+  EXPECT_EQ(0, v.front()->value());
+  EXPECT_EQ(99, v.back()->value());
+}
+
+TEST(ArenaVectorTest, MixesWithPushBack) {
+  ArenaVector<Base> v;
+  v.AllocateAndConstruct<Small>()->value_ = 1;
+  scoped_ptr<Large> large(new Large);
+  large->value_ = 2;
+  v.push_back(large.PassAs<Base>());
+  v.AllocateAndConstruct<Small>()->value_ = 3;
+
+  ASSERT_EQ(3u, v.size());
+  int expected = 3;
+  for (ArenaVector<Base>::const_reverse_iterator it = v.rbegin();
+       it != v.rend();
+       ++it)
+    EXPECT_EQ(expected--, (*it)->value());
+}
+
+TEST(ArenaVectorTest, DestroysAllObjects) {
+  {
+    ArenaVector<Base> v;
+    for (int i = 0; i < 1000; ++i)
+      v.AllocateAndConstruct<Small>();
+    v.push_back(make_scoped_ptr(new Large).PassAs<Base>());
+    v.AllocateAndConstruct<Large>();
+    EXPECT_EQ(1000, Small::count_);
+    EXPECT_EQ(2, Large::count_);
+
+    v.clear();
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(0, Small::count_);
+    EXPECT_EQ(0, Large::count_);
+
+    v.AllocateAndConstruct<Small>();
+    EXPECT_EQ(1, Small::count_);
+  }
+  EXPECT_EQ(0, Small::count_);
+}
+
+TEST(ArenaVectorTest, ObjectsOfATypeAreContiguous) {
+  ArenaVector<Base> v;
+  Small* first = v.AllocateAndConstruct<Small>();
+  v.AllocateAndConstruct<Large>();
+  Small* second = v.AllocateAndConstruct<Small>();
+  EXPECT_EQ(first + 1, second);
+}
+
+}  // namespace
+}  // namespace cc
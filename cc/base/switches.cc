@@ -128,6 +128,18 @@ const char kUIShowNonOccludingRects[] = "ui-show-nonoccluding-rects";
 // Enable the codepath that uses images within TileManager.
 const char kUseMapImage[] = "use-map-image";
 
+// Compresses tiles that won't be needed soon into textures that take less
+// memory, when the GPU supports it.
+const char kCompressLowPriorityTiles[] = "compress-low-priority-tiles";
+
+// Rasterizes simple tiles with Ganesh on the compositor's offscreen context,
+// straight into their textures.
+const char kEnableGpuRasterization[] = "enable-gpu-rasterization";
+
+// Delays draws until a deadline in each frame, which gives the main thread a
+// chance to commit in time for the frame.
+const char kEnableDeadlineScheduling[] = "enable-deadline-scheduling";
+
 // Prevents the layer tree unit tests from timing out.
 const char kCCLayerTreeTestNoTimeout[] = "cc-layer-tree-test-no-timeout";
 
@@ -38,6 +38,9 @@ CC_EXPORT extern const char kEnablePinchVirtualViewport[];
 CC_EXPORT extern const char kEnablePartialSwap[];
 CC_EXPORT extern const char kStrictLayerPropertyChangeChecking[];
 CC_EXPORT extern const char kUseMapImage[];
+CC_EXPORT extern const char kCompressLowPriorityTiles[];
+CC_EXPORT extern const char kEnableGpuRasterization[];
+CC_EXPORT extern const char kEnableDeadlineScheduling[];
 
 // Switches for both the renderer and ui compositors.
 CC_EXPORT extern const char kUIDisablePartialSwap[];
@@ -13,16 +13,20 @@ RenderingStats::RenderingStats()
       total_commit_count(0),
       total_pixels_painted(0),
       total_pixels_recorded(0),
+      total_pixels_invalidated(0),
+      total_pixels_rerecorded(0),
       total_pixels_rasterized(0),
       num_impl_thread_scrolls(0),
       num_main_thread_scrolls(0),
       num_layers_drawn(0),
+      num_draw_calls(0),
       num_missing_tiles(0),
       total_deferred_image_decode_count(0),
       total_deferred_image_cache_hit_count(0),
       total_image_gathering_count(0),
       total_tiles_analyzed(0),
-      solid_color_tiles_analyzed(0) {}
+      solid_color_tiles_analyzed(0),
+      total_tiles_gpu_rasterized(0) {}
 
 void RenderingStats::EnumerateFields(Enumerator* enumerator) const {
   enumerator->AddInt64("numAnimationFrames", animation_frame_count);
@@ -44,10 +48,13 @@ void RenderingStats::EnumerateFields(Enumerator* enumerator) const {
   enumerator->AddInt64("totalCommitCount", total_commit_count);
   enumerator->AddInt64("totalPixelsPainted", total_pixels_painted);
   enumerator->AddInt64("totalPixelsRecorded", total_pixels_recorded);
+  enumerator->AddInt64("totalPixelsInvalidated", total_pixels_invalidated);
+  enumerator->AddInt64("totalPixelsRerecorded", total_pixels_rerecorded);
   enumerator->AddInt64("totalPixelsRasterized", total_pixels_rasterized);
   enumerator->AddInt64("numImplThreadScrolls", num_impl_thread_scrolls);
   enumerator->AddInt64("numMainThreadScrolls", num_main_thread_scrolls);
   enumerator->AddInt64("numLayersDrawn", num_layers_drawn);
+  enumerator->AddInt64("numDrawCalls", num_draw_calls);
   enumerator->AddInt64("numMissingTiles", num_missing_tiles);
   enumerator->AddInt64("totalDeferredImageDecodeCount",
                        total_deferred_image_decode_count);
@@ -64,6 +71,11 @@ void RenderingStats::EnumerateFields(Enumerator* enumerator) const {
                         total_image_gathering_time.InSecondsF());
   enumerator->AddDouble("totalTileAnalysisTimeInSeconds",
                         total_tile_analysis_time.InSecondsF());
+  enumerator->AddInt64("totalTilesGpuRasterized", total_tiles_gpu_rasterized);
+  enumerator->AddDouble("totalGpuRasterizeTimeInSeconds",
+                        total_gpu_rasterize_time.InSecondsF());
+  enumerator->AddDouble("totalQuadCullingTimeInSeconds",
+                        total_quad_culling_time.InSecondsF());
 }
 
 void RenderingStats::Add(const RenderingStats& other) {
@@ -80,10 +92,13 @@ void RenderingStats::Add(const RenderingStats& other) {
   total_commit_count += other.total_commit_count;
   total_pixels_painted += other.total_pixels_painted;
   total_pixels_recorded += other.total_pixels_recorded;
+  total_pixels_invalidated += other.total_pixels_invalidated;
+  total_pixels_rerecorded += other.total_pixels_rerecorded;
   total_pixels_rasterized += other.total_pixels_rasterized;
   num_impl_thread_scrolls += other.num_impl_thread_scrolls;
   num_main_thread_scrolls += other.num_main_thread_scrolls;
   num_layers_drawn += other.num_layers_drawn;
+  num_draw_calls += other.num_draw_calls;
   num_missing_tiles += other.num_missing_tiles;
   total_deferred_image_decode_count += other.total_deferred_image_decode_count;
   total_deferred_image_cache_hit_count +=
@@ -94,6 +109,9 @@ void RenderingStats::Add(const RenderingStats& other) {
   total_tiles_analyzed += other.total_tiles_analyzed;
   solid_color_tiles_analyzed += other.solid_color_tiles_analyzed;
   total_tile_analysis_time += other.total_tile_analysis_time;
+  total_tiles_gpu_rasterized += other.total_tiles_gpu_rasterized;
+  total_gpu_rasterize_time += other.total_gpu_rasterize_time;
+  total_quad_culling_time += other.total_quad_culling_time;
 }
 
 }  // namespace cc
@@ -24,19 +24,25 @@ struct CC_EXPORT RenderingStats {
   int64 total_commit_count;
   int64 total_pixels_painted;
   int64 total_pixels_recorded;
+  int64 total_pixels_invalidated;
+  int64 total_pixels_rerecorded;
   int64 total_pixels_rasterized;
   int64 num_impl_thread_scrolls;
   int64 num_main_thread_scrolls;
   int64 num_layers_drawn;
+  int64 num_draw_calls;
   int64 num_missing_tiles;
   int64 total_deferred_image_decode_count;
   int64 total_deferred_image_cache_hit_count;
   int64 total_image_gathering_count;
   int64 total_tiles_analyzed;
   int64 solid_color_tiles_analyzed;
+  int64 total_tiles_gpu_rasterized;
   base::TimeDelta total_deferred_image_decode_time;
   base::TimeDelta total_image_gathering_time;
   base::TimeDelta total_tile_analysis_time;
+  base::TimeDelta total_gpu_rasterize_time;
+  base::TimeDelta total_quad_culling_time;
   // Note: when adding new members, please remember to update EnumerateFields
   // and Add in rendering_stats.cc.
 
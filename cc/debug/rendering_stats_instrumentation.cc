@@ -89,6 +89,16 @@ void RenderingStatsInstrumentation::AddRecord(base::TimeDelta duration,
   rendering_stats_.total_pixels_recorded += pixels;
 }
 
+void RenderingStatsInstrumentation::AddInvalidation(int64 invalidated_pixels,
+                                                    int64 rerecorded_pixels) {
+  if (!record_rendering_stats_)
+    return;
+
+  base::AutoLock scoped_lock(lock_);
+  rendering_stats_.total_pixels_invalidated += invalidated_pixels;
+  rendering_stats_.total_pixels_rerecorded += rerecorded_pixels;
+}
+
 void RenderingStatsInstrumentation::AddRaster(base::TimeDelta total_duration,
                                               base::TimeDelta best_duration,
                                               int64 pixels,
@@ -131,6 +141,14 @@ void RenderingStatsInstrumentation::AddLayersDrawn(int64 amount) {
   rendering_stats_.num_layers_drawn += amount;
 }
 
+void RenderingStatsInstrumentation::AddDrawCalls(int64 amount) {
+  if (!record_rendering_stats_)
+    return;
+
+  base::AutoLock scoped_lock(lock_);
+  rendering_stats_.num_draw_calls += amount;
+}
+
 void RenderingStatsInstrumentation::AddMissingTiles(int64 amount) {
   if (!record_rendering_stats_)
     return;
@@ -180,4 +198,21 @@ void RenderingStatsInstrumentation::AddAnalysisResult(
     rendering_stats_.solid_color_tiles_analyzed++;
 }
 
+void RenderingStatsInstrumentation::AddGpuRaster(base::TimeDelta duration) {
+  if (!record_rendering_stats_)
+    return;
+
+  base::AutoLock scoped_lock(lock_);
+  rendering_stats_.total_gpu_rasterize_time += duration;
+  rendering_stats_.total_tiles_gpu_rasterized++;
+}
+
+void RenderingStatsInstrumentation::AddQuadCulling(base::TimeDelta duration) {
+  if (!record_rendering_stats_)
+    return;
+
+  base::AutoLock scoped_lock(lock_);
+  rendering_stats_.total_quad_culling_time += duration;
+}
+
 }  // namespace cc
@@ -39,6 +39,9 @@ class CC_EXPORT RenderingStatsInstrumentation {
   void AddCommit(base::TimeDelta duration);
   void AddPaint(base::TimeDelta duration, int64 pixels);
   void AddRecord(base::TimeDelta duration, int64 pixels);
+  // |invalidated_pixels| of recorded content caused |rerecorded_pixels| to be
+  // recorded again.
+  void AddInvalidation(int64 invalidated_pixels, int64 rerecorded_pixels);
   void AddRaster(base::TimeDelta total_duraction,
                  base::TimeDelta best_duration,
                  int64 pixels,
@@ -48,6 +51,7 @@ class CC_EXPORT RenderingStatsInstrumentation {
   void IncrementMainThreadScrolls();
 
   void AddLayersDrawn(int64 amount);
+  void AddDrawCalls(int64 amount);
   void AddMissingTiles(int64 amount);
 
   void AddDeferredImageDecode(base::TimeDelta duration);
@@ -56,6 +60,8 @@ class CC_EXPORT RenderingStatsInstrumentation {
   void IncrementDeferredImageCacheHitCount();
 
   void AddAnalysisResult(base::TimeDelta duration, bool is_solid_color);
+  void AddGpuRaster(base::TimeDelta duration);
+  void AddQuadCulling(base::TimeDelta duration);
 
  protected:
   RenderingStatsInstrumentation();
@@ -27,6 +27,10 @@
 
 namespace cc {
 
+SubtreeDrawPropertiesCache::SubtreeDrawPropertiesCache() : is_valid(false) {}
+
+SubtreeDrawPropertiesCache::~SubtreeDrawPropertiesCache() {}
+
 LayerImpl::LayerImpl(LayerTreeImpl* tree_impl, int id)
     : parent_(NULL),
       mask_layer_id_(-1),
@@ -58,7 +62,10 @@ LayerImpl::LayerImpl(LayerTreeImpl* tree_impl, int id)
       compositing_reasons_(kCompositingReasonUnknown),
       current_draw_mode_(DRAW_MODE_NONE),
       horizontal_scrollbar_layer_(NULL),
-      vertical_scrollbar_layer_(NULL) {
+      vertical_scrollbar_layer_(NULL),
+      draw_properties_are_stale_(true),
+      contents_scale_is_stale_(false),
+      descendant_draw_properties_are_stale_(false) {
   DCHECK_GT(layer_id_, 0);
   DCHECK(layer_tree_impl_);
   layer_tree_impl_->RegisterLayer(this);
@@ -79,6 +86,7 @@ void LayerImpl::AddChild(scoped_ptr<LayerImpl> child) {
   child->set_parent(this);
   DCHECK_EQ(layer_tree_impl(), child->layer_tree_impl());
   children_.push_back(child.Pass());
+  children_.back()->MarkDrawPropertiesStale();
   layer_tree_impl()->set_needs_update_draw_properties();
 }
 
@@ -89,6 +97,7 @@ scoped_ptr<LayerImpl> LayerImpl::RemoveChild(LayerImpl* child) {
     if (*it == child) {
       scoped_ptr<LayerImpl> ret = children_.take(it);
       children_.erase(it);
+      MarkDrawPropertiesStale();
       layer_tree_impl()->set_needs_update_draw_properties();
       return ret.Pass();
     }
@@ -101,6 +110,7 @@ void LayerImpl::ClearChildList() {
     return;
 
   children_.clear();
+  MarkDrawPropertiesStale();
   layer_tree_impl()->set_needs_update_draw_properties();
 }
 
@@ -506,11 +516,13 @@ bool LayerImpl::LayerSurfacePropertyChanged() const {
 
 void LayerImpl::NoteLayerSurfacePropertyChanged() {
   layer_surface_property_changed_ = true;
+  MarkDrawPropertiesStale();
   layer_tree_impl()->set_needs_update_draw_properties();
 }
 
 void LayerImpl::NoteLayerPropertyChanged() {
   layer_property_changed_ = true;
+  MarkDrawPropertiesStale();
   layer_tree_impl()->set_needs_update_draw_properties();
 }
 
@@ -520,11 +532,40 @@ void LayerImpl::NoteLayerPropertyChangedForSubtree() {
 }
 
 void LayerImpl::NoteLayerPropertyChangedForDescendants() {
+  MarkDrawPropertiesStale();
   layer_tree_impl()->set_needs_update_draw_properties();
   for (size_t i = 0; i < children_.size(); ++i)
     children_[i]->NoteLayerPropertyChangedForSubtree();
 }
 
+void LayerImpl::MarkDrawPropertiesStale() {
+  draw_properties_are_stale_ = true;
+  MarkAncestorsHaveStaleDescendant();
+}
+
+void LayerImpl::MarkContentsScaleStale() {
+  contents_scale_is_stale_ = true;
+  MarkAncestorsHaveStaleDescendant();
+}
+
+void LayerImpl::MarkAncestorsHaveStaleDescendant() {
+  for (LayerImpl* ancestor = parent_;
+       ancestor && !ancestor->descendant_draw_properties_are_stale_;
+       ancestor = ancestor->parent_)
+    ancestor->descendant_draw_properties_are_stale_ = true;
+}
+
+bool LayerImpl::DrawPropertiesCanChangeUnnoticed() const {
+  // Animations coming and going change whether the layer is treated as
+  // animating, copy requests are taken without a notification, and a scroll
+  // offset delegate can move the layer at any time.
+  return layer_animation_controller_->has_any_animation() ||
+         HasCopyRequest() ||
+         scroll_offset_delegate_ ||
+         HasDelegatedContent() ||
+         HasContributingDelegatedRenderPasses();
+}
+
 const char* LayerImpl::LayerTypeAsString() const {
   return "cc::LayerImpl";
 }
@@ -634,6 +675,14 @@ void LayerImpl::SetDrawsContent(bool draws_content) {
   NoteLayerPropertyChanged();
 }
 
+void LayerImpl::SetForceRenderSurface(bool force) {
+  if (force_render_surface_ == force)
+    return;
+
+  force_render_surface_ = force;
+  MarkDrawPropertiesStale();
+}
+
 void LayerImpl::SetHideLayerAndSubtree(bool hide) {
   if (hide_layer_and_subtree_ == hide)
     return;
@@ -754,6 +803,31 @@ void LayerImpl::SetPosition(gfx::PointF position) {
   NoteLayerPropertyChangedForSubtree();
 }
 
+void LayerImpl::SetIsContainerForFixedPositionLayers(bool container) {
+  if (is_container_for_fixed_position_layers_ == container)
+    return;
+
+  is_container_for_fixed_position_layers_ = container;
+  MarkDrawPropertiesStale();
+}
+
+void LayerImpl::SetFixedContainerSizeDelta(gfx::Vector2dF delta) {
+  if (fixed_container_size_delta_ == delta)
+    return;
+
+  fixed_container_size_delta_ = delta;
+  MarkDrawPropertiesStale();
+}
+
+void LayerImpl::SetPositionConstraint(
+    const LayerPositionConstraint& constraint) {
+  if (position_constraint_ == constraint)
+    return;
+
+  position_constraint_ = constraint;
+  MarkDrawPropertiesStale();
+}
+
 void LayerImpl::SetPreserves3d(bool preserves3_d) {
   if (preserves_3d_ == preserves3_d)
     return;
@@ -762,6 +836,14 @@ void LayerImpl::SetPreserves3d(bool preserves3_d) {
   NoteLayerPropertyChangedForSubtree();
 }
 
+void LayerImpl::SetUseParentBackfaceVisibility(bool use) {
+  if (use_parent_backface_visibility_ == use)
+    return;
+
+  use_parent_backface_visibility_ = use;
+  MarkDrawPropertiesStale();
+}
+
 void LayerImpl::SetSublayerTransform(const gfx::Transform& sublayer_transform) {
   if (sublayer_transform_ == sublayer_transform)
     return;
@@ -873,6 +955,14 @@ void LayerImpl::SetScrollOffsetDelegate(
     scroll_offset_delegate_->SetTotalScrollOffset(total_offset);
 }
 
+void LayerImpl::SetScrollable(bool scrollable) {
+  if (scrollable_ == scrollable)
+    return;
+
+  scrollable_ = scrollable;
+  MarkDrawPropertiesStale();
+}
+
 void LayerImpl::SetScrollOffset(gfx::Vector2d scroll_offset) {
   if (scroll_offset_ == scroll_offset)
     return;
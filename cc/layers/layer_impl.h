@@ -49,6 +49,24 @@ class Layer;
 
 struct AppendQuadsData;
 
+// What a CalculateDrawProperties pass got out of a layer's subtree. While no
+// draw properties in the subtree are stale, the next pass replays this instead
+// of walking the subtree again.
+struct CC_EXPORT SubtreeDrawPropertiesCache {
+  SubtreeDrawPropertiesCache();
+  ~SubtreeDrawPropertiesCache();
+
+  // False until the subtree has been walked, and whenever the pass didn't get
+  // to the layer's children.
+  bool is_valid;
+  gfx::Rect drawable_content_rect;
+  // The layers the subtree added to its target's layer list, and to the
+  // render surface layer list.
+  LayerImplList layer_list;
+  LayerImplList render_surface_layer_list;
+  LayerImplList layers_with_updated_tile_priorities;
+};
+
 enum DrawMode {
   DRAW_MODE_NONE,
   DRAW_MODE_HARDWARE,
@@ -138,7 +156,7 @@ class CC_EXPORT LayerImpl : LayerAnimationValueObserver {
   bool hide_layer_and_subtree() const { return hide_layer_and_subtree_; }
 
   bool force_render_surface() const { return force_render_surface_; }
-  void SetForceRenderSurface(bool force) { force_render_surface_ = force; }
+  void SetForceRenderSurface(bool force);
 
   void SetAnchorPoint(gfx::PointF anchor_point);
   gfx::PointF anchor_point() const { return anchor_point_; }
@@ -177,24 +195,18 @@ class CC_EXPORT LayerImpl : LayerAnimationValueObserver {
   void SetPosition(gfx::PointF position);
   gfx::PointF position() const { return position_; }
 
-  void SetIsContainerForFixedPositionLayers(bool container) {
-    is_container_for_fixed_position_layers_ = container;
-  }
+  void SetIsContainerForFixedPositionLayers(bool container);
   // This is a non-trivial function in Layer.
   bool IsContainerForFixedPositionLayers() const {
     return is_container_for_fixed_position_layers_;
   }
 
-  void SetFixedContainerSizeDelta(gfx::Vector2dF delta) {
-    fixed_container_size_delta_ = delta;
-  }
+  void SetFixedContainerSizeDelta(gfx::Vector2dF delta);
   gfx::Vector2dF fixed_container_size_delta() const {
     return fixed_container_size_delta_;
   }
 
-  void SetPositionConstraint(const LayerPositionConstraint& constraint) {
-    position_constraint_ = constraint;
-  }
+  void SetPositionConstraint(const LayerPositionConstraint& constraint);
   const LayerPositionConstraint& position_constraint() const {
     return position_constraint_;
   }
@@ -202,9 +214,7 @@ class CC_EXPORT LayerImpl : LayerAnimationValueObserver {
   void SetPreserves3d(bool preserves_3d);
   bool preserves_3d() const { return preserves_3d_; }
 
-  void SetUseParentBackfaceVisibility(bool use) {
-    use_parent_backface_visibility_ = use;
-  }
+  void SetUseParentBackfaceVisibility(bool use);
   bool use_parent_backface_visibility() const {
     return use_parent_backface_visibility_;
   }
@@ -241,6 +251,36 @@ class CC_EXPORT LayerImpl : LayerAnimationValueObserver {
     return draw_properties_;
   }
 
+  // Marks the draw properties of this layer and its subtree as stale, so that
+  // the next CalculateDrawProperties recomputes them instead of reusing the
+  // ones from the last pass. Unlike NoteLayerPropertyChanged(), this doesn't
+  // ask the tree for an update.
+  void MarkDrawPropertiesStale();
+  // For changes that can only affect the contents scale of the layer: the
+  // layer is recomputed, but its descendants only if the contents scale turns
+  // out different.
+  void MarkContentsScaleStale();
+  // Whether the draw properties of the layer can change without the layer
+  // hearing about it, in which case they are recomputed on every pass.
+  bool DrawPropertiesCanChangeUnnoticed() const;
+  bool draw_properties_are_stale() const { return draw_properties_are_stale_; }
+  bool contents_scale_is_stale() const { return contents_scale_is_stale_; }
+  bool descendant_draw_properties_are_stale() const {
+    return descendant_draw_properties_are_stale_;
+  }
+  // Called by CalculateDrawProperties once it is done with the layer.
+  void ResetDrawPropertiesStaleness(bool descendants_are_stale) {
+    draw_properties_are_stale_ = false;
+    contents_scale_is_stale_ = false;
+    descendant_draw_properties_are_stale_ = descendants_are_stale;
+  }
+  SubtreeDrawPropertiesCache& subtree_draw_properties_cache() {
+    return subtree_draw_properties_cache_;
+  }
+  const SubtreeDrawPropertiesCache& subtree_draw_properties_cache() const {
+    return subtree_draw_properties_cache_;
+  }
+
   // The following are shortcut accessors to get various information from
   // draw_properties_
   const gfx::Transform& draw_transform() const {
@@ -327,7 +367,7 @@ class CC_EXPORT LayerImpl : LayerAnimationValueObserver {
   // initial scroll
   gfx::Vector2dF ScrollBy(gfx::Vector2dF scroll);
 
-  void SetScrollable(bool scrollable) { scrollable_ = scrollable; }
+  void SetScrollable(bool scrollable);
   bool scrollable() const { return scrollable_; }
 
   void ApplySentScrollDeltas();
@@ -469,6 +509,7 @@ class CC_EXPORT LayerImpl : LayerAnimationValueObserver {
 
  private:
   void UpdateScrollbarPositions();
+  void MarkAncestorsHaveStaleDescendant();
 
   virtual const char* LayerTypeAsString() const;
 
@@ -576,6 +617,15 @@ class CC_EXPORT LayerImpl : LayerAnimationValueObserver {
   // hierarchy before layers can be drawn.
   DrawProperties<LayerImpl, RenderSurfaceImpl> draw_properties_;
 
+  // Set when something that feeds into the draw properties of the layer, or of
+  // one of its descendants, changed since the last CalculateDrawProperties.
+  // An ancestor of a layer with any of these set always has the last one set,
+  // which lets the Mark*Stale() functions stop early.
+  bool draw_properties_are_stale_;
+  bool contents_scale_is_stale_;
+  bool descendant_draw_properties_are_stale_;
+  SubtreeDrawPropertiesCache subtree_draw_properties_cache_;
+
   DISALLOW_COPY_AND_ASSIGN(LayerImpl);
 };
 
@@ -101,6 +101,10 @@ void PictureLayerImpl::PushPropertiesTo(LayerImpl* base_layer) {
   // always get pushed during PictureLayer::PushPropertiesTo.
   layer_impl->invalidation_.Swap(&invalidation_);
   invalidation_.Clear();
+
+  // The contents scale depends on the tilings and raster scales that were
+  // just handed over, not only on the layer's draw properties.
+  layer_impl->MarkContentsScaleStale();
 }
 
 void PictureLayerImpl::AppendQuads(QuadSink* quad_sink,
@@ -370,6 +374,7 @@ void PictureLayerImpl::DidLoseOutputSurface() {
     tilings_->RemoveAllTilings();
 
   ResetRasterScale();
+  MarkContentsScaleStale();
 }
 
 void PictureLayerImpl::CalculateContentsScale(
@@ -534,6 +539,7 @@ void PictureLayerImpl::SyncFromActiveLayer() {
 
 void PictureLayerImpl::SyncFromActiveLayer(const PictureLayerImpl* other) {
   UpdateLCDTextStatus(other->is_using_lcd_text_);
+  MarkContentsScaleStale();
 
   if (!DrawsContent()) {
     ResetRasterScale();
@@ -4,6 +4,7 @@
 
 #include "cc/output/direct_renderer.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -55,10 +56,19 @@ static gfx::Transform window_matrix(int x, int y, int width, int height) {
 
 namespace cc {
 
+namespace {
+
+// Output surfaces rarely have more back buffers than this. Older buffers are
+// drawn in full.
+const size_t kMaxBufferAge = 4;
+
+}  // namespace
+
 DirectRenderer::DrawingFrame::DrawingFrame()
     : root_render_pass(NULL),
       current_render_pass(NULL),
-      current_texture(NULL) {}
+      current_texture(NULL),
+      draw_damage_only(false) {}
 
 DirectRenderer::DrawingFrame::~DrawingFrame() {}
 
@@ -200,10 +210,6 @@ void DirectRenderer::DrawFrame(RenderPassList* render_passes_in_draw_order) {
 
   DrawingFrame frame;
   frame.root_render_pass = root_render_pass;
-  frame.root_damage_rect =
-      Capabilities().using_partial_swap && client_->AllowPartialSwap() ?
-      root_render_pass->damage_rect : root_render_pass->output_rect;
-  frame.root_damage_rect.Intersect(gfx::Rect(client_->DeviceViewport().size()));
 
   EnsureBackbuffer();
 
@@ -213,6 +219,8 @@ void DirectRenderer::DrawFrame(RenderPassList* render_passes_in_draw_order) {
   output_surface_->Reshape(client_->DeviceViewport().size(),
                            client_->DeviceScaleFactor());
 
+  ComputeRootDamage(&frame);
+
   BeginDrawingFrame(&frame);
   for (size_t i = 0; i < render_passes_in_draw_order->size(); ++i) {
     RenderPass* pass = render_passes_in_draw_order->at(i);
@@ -235,6 +243,45 @@ void DirectRenderer::DrawFrame(RenderPassList* render_passes_in_draw_order) {
   render_passes_in_draw_order->clear();
 }
 
+void DirectRenderer::ComputeRootDamage(DrawingFrame* frame) {
+  gfx::Rect viewport_rect(client_->DeviceViewport().size());
+  gfx::RectF damage_rect = frame->root_render_pass->damage_rect;
+  damage_rect.Intersect(viewport_rect);
+
+  // Resizing the surface loses the contents of its buffers.
+  if (viewport_rect.size() != previous_viewport_size_) {
+    previous_root_damage_rects_.clear();
+    previous_viewport_size_ = viewport_rect.size();
+  }
+
+  frame->root_damage_rect = frame->root_render_pass->output_rect;
+  frame->draw_damage_only = false;
+  if (client_->AllowPartialSwap()) {
+    if (Capabilities().using_partial_swap) {
+      // Only the damage is swapped to the front buffer, which holds the
+      // previous frame.
+      frame->root_damage_rect = damage_rect;
+      frame->draw_damage_only = true;
+    } else {
+      // The whole back buffer is swapped, so besides this frame's damage,
+      // everything that changed since the buffer was last drawn is redrawn.
+      size_t buffer_age = std::max(output_surface_->BufferAge(), 0);
+      if (buffer_age > 0 &&
+          buffer_age <= previous_root_damage_rects_.size() + 1) {
+        frame->root_damage_rect = damage_rect;
+        for (size_t i = 0; i < buffer_age - 1; ++i)
+          frame->root_damage_rect.Union(previous_root_damage_rects_[i]);
+        frame->draw_damage_only = true;
+      }
+    }
+  }
+  frame->root_damage_rect.Intersect(viewport_rect);
+
+  previous_root_damage_rects_.push_front(damage_rect);
+  if (previous_root_damage_rects_.size() >= kMaxBufferAge)
+    previous_root_damage_rects_.pop_back();
+}
+
 gfx::RectF DirectRenderer::ComputeScissorRectForRenderPass(
     const DrawingFrame* frame) {
   gfx::RectF render_pass_scissor = frame->current_render_pass->output_rect;
@@ -292,8 +339,7 @@ void DirectRenderer::DrawRenderPass(DrawingFrame* frame,
   if (!UseRenderPass(frame, render_pass))
     return;
 
-  bool using_scissor_as_optimization =
-      Capabilities().using_partial_swap && client_->AllowPartialSwap();
+  bool using_scissor_as_optimization = frame->draw_damage_only;
   gfx::RectF render_pass_scissor;
 
   if (using_scissor_as_optimization) {
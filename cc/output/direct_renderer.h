@@ -5,6 +5,8 @@
 #ifndef CC_OUTPUT_DIRECT_RENDERER_H_
 #define CC_OUTPUT_DIRECT_RENDERER_H_
 
+#include <deque>
+
 #include "base/basictypes.h"
 #include "base/callback.h"
 #include "cc/base/cc_export.h"
@@ -41,6 +43,9 @@ class CC_EXPORT DirectRenderer : public Renderer {
     const ScopedResource* current_texture;
 
     gfx::RectF root_damage_rect;
+    // Whether only |root_damage_rect| is drawn, leaving the rest of the
+    // framebuffer as it was.
+    bool draw_damage_only;
 
     gfx::Transform projection_matrix;
     gfx::Transform window_matrix;
@@ -85,6 +90,7 @@ class CC_EXPORT DirectRenderer : public Renderer {
                           gfx::Size surface_size);
   gfx::Rect MoveFromDrawToWindowSpace(const gfx::RectF& draw_rect) const;
 
+  void ComputeRootDamage(DrawingFrame* frame);
   static gfx::RectF ComputeScissorRectForRenderPass(const DrawingFrame* frame);
   void SetScissorStateForQuad(const DrawingFrame* frame, const DrawQuad& quad);
   void SetScissorStateForQuadWithRenderPassScissor(
@@ -136,6 +142,11 @@ class CC_EXPORT DirectRenderer : public Renderer {
  private:
   gfx::Vector2d enlarge_pass_texture_amount_;
 
+  // The damage of the most recent frames, newest first, which tells what a
+  // back buffer last drawn a few frames ago is missing.
+  std::deque<gfx::RectF> previous_root_damage_rects_;
+  gfx::Size previous_viewport_size_;
+
   DISALLOW_COPY_AND_ASSIGN(DirectRenderer);
 };
 
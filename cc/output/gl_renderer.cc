@@ -159,6 +159,7 @@ GLRenderer::GLRenderer(RendererClient* client,
       is_scissor_enabled_(false),
       stencil_shadow_(false),
       blend_shadow_(false),
+      draw_call_count_(0),
       highp_threshold_min_(highp_threshold_min),
       highp_threshold_cache_(0),
       offscreen_context_labelled_(false),
@@ -329,6 +330,8 @@ void GLRenderer::ClearFramebuffer(DrawingFrame* frame) {
 }
 
 void GLRenderer::BeginDrawingFrame(DrawingFrame* frame) {
+  draw_call_count_ = 0;
+
   if (client_->DeviceViewport().IsEmpty())
     return;
 
@@ -339,6 +342,10 @@ void GLRenderer::BeginDrawingFrame(DrawingFrame* frame) {
   ReinitializeGLState();
 }
 
+int GLRenderer::DrawCallsInLastFrame() const {
+  return draw_call_count_;
+}
+
 void GLRenderer::DoNoOp() {
   GLC(context_, context_->bindFramebuffer(GL_FRAMEBUFFER, 0));
   GLC(context_, context_->flush());
@@ -349,6 +356,8 @@ void GLRenderer::DoDrawQuad(DrawingFrame* frame, const DrawQuad* quad) {
   if (quad->material != DrawQuad::TEXTURE_CONTENT) {
     FlushTextureQuadCache();
   }
+  if (quad->material != DrawQuad::SOLID_COLOR)
+    FlushSolidColorQuadCache();
 
   switch (quad->material) {
     case DrawQuad::INVALID:
@@ -468,6 +477,7 @@ void GLRenderer::DrawDebugBorderQuad(const DrawingFrame* frame,
   // indices.
   GLC(Context(),
       Context()->drawElements(GL_LINE_LOOP, 4, GL_UNSIGNED_SHORT, 0));
+  ++draw_call_count_;
 }
 
 static inline SkBitmap ApplyFilters(GLRenderer* renderer,
@@ -1241,11 +1251,16 @@ void GLRenderer::DrawSolidColorQuad(const DrawingFrame* frame,
   bool use_aa = !quad->force_anti_aliasing_off && SetupQuadForAntialiasing(
       device_transform, quad, &local_quad, edge);
 
+  // Without anti-aliasing, the quad only needs its transform and color, and
+  // can be drawn together with its neighbours.
+  if (!use_aa) {
+    EnqueueSolidColorQuad(frame, quad, alpha);
+    return;
+  }
+  FlushSolidColorQuadCache();
+
   SolidColorProgramUniforms uniforms;
-  if (use_aa)
-    SolidColorUniformLocation(GetSolidColorProgramAA(), &uniforms);
-  else
-    SolidColorUniformLocation(GetSolidColorProgram(), &uniforms);
+  SolidColorUniformLocation(GetSolidColorProgramAA(), &uniforms);
   SetUseProgram(uniforms.program);
 
   GLC(Context(),
@@ -1254,21 +1269,18 @@ void GLRenderer::DrawSolidColorQuad(const DrawingFrame* frame,
                            (SkColorGetG(color) * (1.0f / 255.0f)) * alpha,
                            (SkColorGetB(color) * (1.0f / 255.0f)) * alpha,
                            alpha));
-  if (use_aa) {
-    float viewport[4] = {
-      static_cast<float>(viewport_.x()),
-      static_cast<float>(viewport_.y()),
-      static_cast<float>(viewport_.width()),
-      static_cast<float>(viewport_.height()),
-    };
-    GLC(Context(),
-        Context()->uniform4fv(uniforms.viewport_location, 1, viewport));
-    GLC(Context(), Context()->uniform3fv(uniforms.edge_location, 8, edge));
-  }
+  float viewport[4] = {
+    static_cast<float>(viewport_.x()),
+    static_cast<float>(viewport_.y()),
+    static_cast<float>(viewport_.width()),
+    static_cast<float>(viewport_.height()),
+  };
+  GLC(Context(),
+      Context()->uniform4fv(uniforms.viewport_location, 1, viewport));
+  GLC(Context(), Context()->uniform3fv(uniforms.edge_location, 8, edge));
 
-  // Enable blending when the quad properties require it or if we decided
-  // to use antialiasing.
-  SetBlendEnabled(quad->ShouldDrawWithBlending() || use_aa);
+  // Antialiasing always needs blending.
+  SetBlendEnabled(true);
 
   // Normalize to tile_rect.
   local_quad.Scale(1.0f / tile_rect.width(), 1.0f / tile_rect.height());
@@ -1810,6 +1822,7 @@ void GLRenderer::FlushTextureQuadCache() {
                              6 * draw_cache_.matrix_data.size(),
                              GL_UNSIGNED_SHORT,
                              0));
+  ++draw_call_count_;
 
   // Clear the cache.
   draw_cache_.program_id = 0;
@@ -1883,6 +1896,73 @@ void GLRenderer::EnqueueTextureQuad(const DrawingFrame* frame,
   draw_cache_.matrix_data.push_back(m);
 }
 
+void GLRenderer::FlushSolidColorQuadCache() {
+  SolidColorQuadDrawCache& cache = solid_color_draw_cache_;
+  if (cache.program_id == 0)
+    return;
+
+  SetBlendEnabled(cache.needs_blending);
+  SetUseProgram(cache.program_id);
+
+  GLC(context_,
+      context_->uniformMatrix4fv(
+          cache.matrix_location,
+          static_cast<int>(cache.matrix_data.size()),
+          false,
+          reinterpret_cast<float*>(&cache.matrix_data.front())));
+  GLC(context_,
+      context_->uniform4fv(
+          cache.color_location,
+          static_cast<int>(cache.color_data.size()),
+          reinterpret_cast<float*>(&cache.color_data.front())));
+
+  GLC(context_,
+      context_->drawElements(GL_TRIANGLES,
+                             6 * cache.matrix_data.size(),
+                             GL_UNSIGNED_SHORT,
+                             0));
+  ++draw_call_count_;
+
+  cache.program_id = 0;
+  cache.matrix_data.resize(0);
+  cache.color_data.resize(0);
+}
+
+void GLRenderer::EnqueueSolidColorQuad(const DrawingFrame* frame,
+                                       const SolidColorDrawQuad* quad,
+                                       float alpha) {
+  const SolidColorProgram* program = GetSolidColorProgram();
+  SolidColorQuadDrawCache& cache = solid_color_draw_cache_;
+
+  // The shared geometry holds 8 quads.
+  if (cache.program_id != static_cast<int>(program->program()) ||
+      cache.needs_blending != quad->ShouldDrawWithBlending() ||
+      cache.matrix_data.size() >= 8) {
+    FlushSolidColorQuadCache();
+    cache.program_id = program->program();
+    cache.needs_blending = quad->ShouldDrawWithBlending();
+    cache.matrix_location = program->vertex_shader().matrix_location();
+    cache.color_location = program->vertex_shader().color_location();
+  }
+
+  gfx::Transform quad_rect_matrix;
+  QuadRectTransform(
+      &quad_rect_matrix, quad->quadTransform(), quad->visible_rect);
+  quad_rect_matrix = frame->projection_matrix * quad_rect_matrix;
+  Float16 m;
+  quad_rect_matrix.matrix().asColMajorf(m.data);
+  cache.matrix_data.push_back(m);
+
+  SkColor color = quad->color;
+  Float4 premultiplied_color = { {
+    (SkColorGetR(color) * (1.0f / 255.0f)) * alpha,
+    (SkColorGetG(color) * (1.0f / 255.0f)) * alpha,
+    (SkColorGetB(color) * (1.0f / 255.0f)) * alpha,
+    alpha
+  } };
+  cache.color_data.push_back(premultiplied_color);
+}
+
 void GLRenderer::DrawIOSurfaceQuad(const DrawingFrame* frame,
                                    const IOSurfaceDrawQuad* quad) {
   SetBlendEnabled(quad->ShouldDrawWithBlending());
@@ -1939,7 +2019,12 @@ void GLRenderer::FinishDrawingFrame(DrawingFrame* frame) {
   blend_shadow_ = false;
 }
 
-void GLRenderer::FinishDrawingQuadList() { FlushTextureQuadCache(); }
+void GLRenderer::FinishDrawingQuadList() { FlushQuadDrawCaches(); }
+
+void GLRenderer::FlushQuadDrawCaches() {
+  FlushTextureQuadCache();
+  FlushSolidColorQuadCache();
+}
 
 bool GLRenderer::FlippedFramebuffer() const { return true; }
 
@@ -1947,7 +2032,7 @@ void GLRenderer::EnsureScissorTestEnabled() {
   if (is_scissor_enabled_)
     return;
 
-  FlushTextureQuadCache();
+  FlushQuadDrawCaches();
   GLC(context_, context_->enable(GL_SCISSOR_TEST));
   is_scissor_enabled_ = true;
 }
@@ -1956,7 +2041,7 @@ void GLRenderer::EnsureScissorTestDisabled() {
   if (!is_scissor_enabled_)
     return;
 
-  FlushTextureQuadCache();
+  FlushQuadDrawCaches();
   GLC(context_, context_->disable(GL_SCISSOR_TEST));
   is_scissor_enabled_ = false;
 }
@@ -2039,6 +2124,7 @@ void GLRenderer::DrawQuadGeometry(const DrawingFrame* frame,
       context_->uniformMatrix4fv(matrix_location, 1, false, &gl_matrix[0]));
 
   GLC(context_, context_->drawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0));
+  ++draw_call_count_;
 }
 
 void GLRenderer::CopyTextureToFramebuffer(const DrawingFrame* frame,
@@ -2552,7 +2638,7 @@ void GLRenderer::SetScissorTestRect(gfx::Rect scissor_rect) {
     return;
 
   scissor_rect_ = scissor_rect;
-  FlushTextureQuadCache();
+  FlushQuadDrawCaches();
   GLC(context_,
       context_->scissor(scissor_rect.x(),
                         scissor_rect.y(),
@@ -71,6 +71,8 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
 
   virtual void SetDiscardBackBufferWhenNotVisible(bool discard) OVERRIDE;
 
+  virtual int DrawCallsInLastFrame() const OVERRIDE;
+
   static void DebugGLCall(WebKit::WebGraphicsContext3D* context,
                           const char* command,
                           const char* file,
@@ -147,6 +149,11 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
   void EnqueueTextureQuad(const DrawingFrame* frame,
                           const TextureDrawQuad* quad);
   void FlushTextureQuadCache();
+  void EnqueueSolidColorQuad(const DrawingFrame* frame,
+                             const SolidColorDrawQuad* quad,
+                             float alpha);
+  void FlushSolidColorQuadCache();
+  void FlushQuadDrawCaches();
   void DrawIOSurfaceQuad(const DrawingFrame* frame,
                          const IOSurfaceDrawQuad* quad);
   void DrawTileQuad(const DrawingFrame* frame, const TileDrawQuad* quad);
@@ -307,8 +314,8 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
   // Special purpose / effects shaders.
   typedef ProgramBinding<VertexShaderPos, FragmentShaderColor>
       DebugBorderProgram;
-  typedef ProgramBinding<VertexShaderQuad, FragmentShaderColor>
-      SolidColorProgram;
+  typedef ProgramBinding<VertexShaderPosColorTransform,
+                         FragmentShaderVaryingColor> SolidColorProgram;
   typedef ProgramBinding<VertexShaderQuadAA, FragmentShaderColorAA>
       SolidColorProgramAA;
 
@@ -445,6 +452,8 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
   bool blend_shadow_;
   unsigned program_shadow_;
   TexturedQuadDrawCache draw_cache_;
+  SolidColorQuadDrawCache solid_color_draw_cache_;
+  int draw_call_count_;
   int highp_threshold_min_;
   int highp_threshold_cache_;
   bool offscreen_context_labelled_;
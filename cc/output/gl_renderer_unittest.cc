@@ -1135,6 +1135,102 @@ TEST(GLRendererTest2, ScissorAndViewportWithinNonreshapableSurface) {
   renderer.DrawFrame(mock_client.render_passes_in_draw_order());
 }
 
+class BufferAgeOutputSurface : public FakeOutputSurface {
+ public:
+  explicit BufferAgeOutputSurface(
+      scoped_ptr<WebKit::WebGraphicsContext3D> context3d)
+      : FakeOutputSurface(context3d.Pass(), false), buffer_age_(0) {}
+
+  virtual int BufferAge() const OVERRIDE { return buffer_age_; }
+  void set_buffer_age(int buffer_age) { buffer_age_ = buffer_age; }
+
+ private:
+  int buffer_age_;
+};
+
+class LargeViewportRendererClient : public FakeRendererClient {
+ public:
+  virtual gfx::Rect DeviceViewport() const OVERRIDE {
+    return gfx::Rect(100, 100);
+  }
+};
+
+// Records the part of the framebuffer that the last draw could touch.
+class DrawnRectRecordingContext : public TestWebGraphicsContext3D {
+ public:
+  DrawnRectRecordingContext() : scissor_enabled_(false) {}
+
+  virtual void enable(WGC3Denum cap) {
+    if (cap == GL_SCISSOR_TEST)
+      scissor_enabled_ = true;
+  }
+
+  virtual void disable(WGC3Denum cap) {
+    if (cap == GL_SCISSOR_TEST)
+      scissor_enabled_ = false;
+  }
+
+  virtual void scissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+    scissor_rect_ = gfx::Rect(x, y, width, height);
+  }
+
+  virtual void drawElements(WGC3Denum mode,
+                            WGC3Dsizei count,
+                            WGC3Denum type,
+                            WGC3Dintptr offset) {
+    last_drawn_rect_ = scissor_enabled_ ? scissor_rect_ : gfx::Rect(100, 100);
+  }
+
+  gfx::Rect last_drawn_rect() const { return last_drawn_rect_; }
+
+ private:
+  bool scissor_enabled_;
+  gfx::Rect scissor_rect_;
+  gfx::Rect last_drawn_rect_;
+};
+
+TEST(GLRendererTest2, RedrawsDamageSinceBackbufferWasLastDrawn) {
+  LargeViewportRendererClient mock_client;
+  scoped_ptr<BufferAgeOutputSurface> output_surface(new BufferAgeOutputSurface(
+      scoped_ptr<WebKit::WebGraphicsContext3D>(new DrawnRectRecordingContext)));
+  DrawnRectRecordingContext* context =
+      static_cast<DrawnRectRecordingContext*>(output_surface->context3d());
+  scoped_ptr<ResourceProvider> resource_provider(
+      ResourceProvider::Create(output_surface.get(), 0));
+  FakeRendererGL renderer(
+      &mock_client, output_surface.get(), resource_provider.get());
+  EXPECT_TRUE(renderer.Initialize());
+  EXPECT_FALSE(renderer.Capabilities().using_partial_swap);
+
+  gfx::Rect viewport_rect(mock_client.DeviceViewport());
+  const gfx::Rect kDamage[] = { gfx::Rect(0, 0, 10, 10),
+                                gfx::Rect(20, 20, 10, 10),
+                                gfx::Rect(50, 50, 10, 10),
+                                gfx::Rect(50, 50, 10, 10) };
+  const int kBufferAge[] = { 0, 2, 1, 5 };
+  // In window space, which is flipped vertically.
+  const gfx::Rect kExpectedDrawnRect[] = { viewport_rect,
+                                           gfx::Rect(0, 70, 30, 30),
+                                           gfx::Rect(50, 40, 10, 10),
+                                           viewport_rect };
+  for (size_t i = 0; i < arraysize(kDamage); ++i) {
+    ScopedPtrVector<RenderPass>& render_passes =
+        *mock_client.render_passes_in_draw_order();
+    render_passes.clear();
+    TestRenderPass* root_pass = AddRenderPass(
+        &render_passes, RenderPass::Id(1, 0), viewport_rect, gfx::Transform());
+    root_pass->damage_rect = kDamage[i];
+    AddQuad(root_pass, viewport_rect, SK_ColorGREEN);
+
+    output_surface->set_buffer_age(kBufferAge[i]);
+    renderer.DecideRenderPassAllocationsForFrame(
+        *mock_client.render_passes_in_draw_order());
+    renderer.DrawFrame(mock_client.render_passes_in_draw_order());
+    EXPECT_EQ(kExpectedDrawnRect[i].ToString(),
+              context->last_drawn_rect().ToString()) << "frame " << i;
+  }
+}
+
 TEST_F(GLRendererShaderTest, DrawRenderPassQuadShaderPermutations) {
   gfx::Rect viewport_rect(mock_client_.DeviceViewport());
   ScopedPtrVector<RenderPass>* render_passes =
@@ -1490,6 +1586,32 @@ TEST_F(MockOutputSurfaceTest, DrawFrameAndSwap) {
   renderer_.SwapBuffers();
 }
 
+TEST_F(MockOutputSurfaceTest, BatchesSolidColorQuads) {
+  gfx::Rect viewport_rect(DeviceViewport());
+  ScopedPtrVector<RenderPass>* render_passes = render_passes_in_draw_order();
+  render_passes->clear();
+
+  RenderPass::Id render_pass_id(1, 0);
+  TestRenderPass* render_pass = AddRenderPass(
+      render_passes, render_pass_id, viewport_rect, gfx::Transform());
+  AddQuad(render_pass, gfx::Rect(0, 0, 50, 50), SK_ColorGREEN);
+  AddQuad(render_pass, gfx::Rect(50, 0, 50, 50), SK_ColorBLUE);
+  AddQuad(render_pass, gfx::Rect(0, 50, 100, 50), SK_ColorRED);
+
+  EXPECT_CALL(output_surface_, EnsureBackbuffer()).WillRepeatedly(Return());
+  EXPECT_CALL(output_surface_,
+              Reshape(DeviceViewport().size(), DeviceScaleFactor())).Times(1);
+  EXPECT_CALL(output_surface_, BindFramebuffer()).Times(1);
+
+  // The quads don't need anti-aliasing, so they're drawn with a single call.
+  EXPECT_CALL(*Context(), drawElements(_, _, _, _)).Times(1);
+
+  renderer_.DecideRenderPassAllocationsForFrame(
+      *render_passes_in_draw_order());
+  renderer_.DrawFrame(render_passes_in_draw_order());
+  EXPECT_EQ(1, renderer_.DrawCallsInLastFrame());
+}
+
 TEST_F(MockOutputSurfaceTest, DrawFrameAndResizeAndSwap) {
   DrawFrame();
   EXPECT_CALL(output_surface_, SwapBuffers(_)).Times(1);
@@ -406,6 +406,10 @@ void OutputSurface::BindFramebuffer() {
   context3d_->bindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
+int OutputSurface::BufferAge() const {
+  return 0;
+}
+
 void OutputSurface::SwapBuffers(cc::CompositorFrame* frame) {
   if (frame->software_frame_data) {
     PostSwapBuffersComplete();
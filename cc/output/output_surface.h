@@ -113,6 +113,12 @@ class CC_EXPORT OutputSurface : public FrameRateControllerClient {
 
   virtual void BindFramebuffer();
 
+  // Returns how many frames ago the back buffer that is about to be drawn was
+  // last drawn, like EGL_EXT_buffer_age: 1 if it holds the previous frame, 2
+  // if it holds the one before, and so on. 0 means its contents are unknown,
+  // and the whole frame has to be drawn.
+  virtual int BufferAge() const;
+
   // The implementation may destroy or steal the contents of the CompositorFrame
   // passed in (though it will not take ownership of the CompositorFrame
   // itself).
@@ -14,4 +14,8 @@ bool Renderer::IsContextLost() {
   return false;
 }
 
+int Renderer::DrawCallsInLastFrame() const {
+  return 0;
+}
+
 }  // namespace cc
@@ -77,6 +77,10 @@ class CC_EXPORT Renderer {
 
   virtual void SetDiscardBackBufferWhenNotVisible(bool discard) = 0;
 
+  // The number of draw calls the last DrawFrame() made, for renderers that
+  // make them.
+  virtual int DrawCallsInLastFrame() const;
+
  protected:
   explicit Renderer(RendererClient* client)
       : client_(client) {}
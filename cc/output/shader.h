@@ -129,6 +129,28 @@ class VertexShaderPosTexTransform {
   DISALLOW_COPY_AND_ASSIGN(VertexShaderPosTexTransform);
 };
 
+// Draws up to 8 quads of a solid color at once, like VertexShaderPosTexTransform
+// does for textured quads.
+class VertexShaderPosColorTransform {
+ public:
+  VertexShaderPosColorTransform();
+
+  void Init(WebKit::WebGraphicsContext3D* context,
+            unsigned program,
+            bool using_bind_uniform,
+            int* base_uniform_index);
+  std::string GetShaderString() const;
+
+  int matrix_location() const { return matrix_location_; }
+  int color_location() const { return color_location_; }
+
+ private:
+  int matrix_location_;
+  int color_location_;
+
+  DISALLOW_COPY_AND_ASSIGN(VertexShaderPosColorTransform);
+};
+
 class VertexShaderQuad {
  public:
   VertexShaderQuad();
@@ -717,6 +739,16 @@ class FragmentShaderColorAA {
   DISALLOW_COPY_AND_ASSIGN(FragmentShaderColorAA);
 };
 
+class FragmentShaderVaryingColor {
+ public:
+  std::string GetShaderString(TexCoordPrecision precision) const;
+
+  void Init(WebKit::WebGraphicsContext3D* context,
+            unsigned program,
+            bool using_bind_uniform,
+            int* base_uniform_index) {}
+};
+
 class FragmentShaderCheckerboard {
  public:
   FragmentShaderCheckerboard();
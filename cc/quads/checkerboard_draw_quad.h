@@ -15,6 +15,7 @@ namespace cc {
 class CC_EXPORT CheckerboardDrawQuad : public DrawQuad {
  public:
   static scoped_ptr<CheckerboardDrawQuad> Create();
+  CheckerboardDrawQuad();
 
   void SetNew(const SharedQuadState* shared_quad_state,
               gfx::Rect rect,
@@ -36,7 +37,6 @@ class CC_EXPORT CheckerboardDrawQuad : public DrawQuad {
 
  private:
   virtual void ExtendValue(base::DictionaryValue* value) const OVERRIDE;
-  CheckerboardDrawQuad();
 };
 
 }  // namespace cc
@@ -15,6 +15,7 @@ namespace cc {
 class CC_EXPORT DebugBorderDrawQuad : public DrawQuad {
  public:
   static scoped_ptr<DebugBorderDrawQuad> Create();
+  DebugBorderDrawQuad();
 
   void SetNew(const SharedQuadState* shared_quad_state,
               gfx::Rect rect,
@@ -38,7 +39,6 @@ class CC_EXPORT DebugBorderDrawQuad : public DrawQuad {
   static const DebugBorderDrawQuad* MaterialCast(const DrawQuad*);
 
  private:
-  DebugBorderDrawQuad();
   virtual void ExtendValue(base::DictionaryValue* value) const OVERRIDE;
 };
 
@@ -20,6 +20,7 @@ class CC_EXPORT IOSurfaceDrawQuad : public DrawQuad {
   };
 
   static scoped_ptr<IOSurfaceDrawQuad> Create();
+  IOSurfaceDrawQuad();
 
   void SetNew(const SharedQuadState* shared_quad_state,
               gfx::Rect rect,
@@ -47,7 +48,6 @@ class CC_EXPORT IOSurfaceDrawQuad : public DrawQuad {
   static const IOSurfaceDrawQuad* MaterialCast(const DrawQuad*);
 
  private:
-  IOSurfaceDrawQuad();
   virtual void ExtendValue(base::DictionaryValue* value) const OVERRIDE;
 };
 
@@ -10,6 +10,7 @@
 #include "base/basictypes.h"
 #include "base/callback.h"
 #include "base/containers/hash_tables.h"
+#include "cc/base/arena_vector.h"
 #include "cc/base/cc_export.h"
 #include "cc/base/scoped_ptr_hash_map.h"
 #include "cc/base/scoped_ptr_vector.h"
@@ -30,19 +31,19 @@ class DrawQuad;
 class CopyOutputRequest;
 class SharedQuadState;
 
-// A list of DrawQuad objects, sorted internally in front-to-back order.
-class QuadList : public ScopedPtrVector<DrawQuad> {
+// A list of DrawQuad objects, sorted internally in front-to-back order. Quads
+// made with AllocateAndConstruct() are stored next to the other quads of their
+// type, which saves an allocation per quad in frames with many of them.
+class QuadList : public ArenaVector<DrawQuad> {
  public:
   typedef reverse_iterator BackToFrontIterator;
   typedef const_reverse_iterator ConstBackToFrontIterator;
 
-  inline BackToFrontIterator BackToFrontBegin() { return rbegin(); }
-  inline BackToFrontIterator BackToFrontEnd() { return rend(); }
   inline ConstBackToFrontIterator BackToFrontBegin() const { return rbegin(); }
   inline ConstBackToFrontIterator BackToFrontEnd() const { return rend(); }
 };
 
-typedef ScopedPtrVector<SharedQuadState> SharedQuadStateList;
+typedef ArenaVector<SharedQuadState> SharedQuadStateList;
 
 class CC_EXPORT RenderPass {
  public:
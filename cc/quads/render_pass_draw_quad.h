@@ -18,6 +18,7 @@ namespace cc {
 class CC_EXPORT RenderPassDrawQuad : public DrawQuad {
  public:
   static scoped_ptr<RenderPassDrawQuad> Create();
+  RenderPassDrawQuad();
   virtual ~RenderPassDrawQuad();
 
   void SetNew(const SharedQuadState* shared_quad_state,
@@ -71,7 +72,6 @@ class CC_EXPORT RenderPassDrawQuad : public DrawQuad {
   static const RenderPassDrawQuad* MaterialCast(const DrawQuad*);
 
  private:
-  RenderPassDrawQuad();
   virtual void ExtendValue(base::DictionaryValue* value) const OVERRIDE;
 };
 
@@ -19,6 +19,7 @@ namespace cc {
 class CC_EXPORT SharedQuadState {
  public:
   static scoped_ptr<SharedQuadState> Create();
+  SharedQuadState();
   ~SharedQuadState();
 
   scoped_ptr<SharedQuadState> Copy() const;
@@ -41,9 +42,6 @@ class CC_EXPORT SharedQuadState {
   gfx::Rect clip_rect;
   bool is_clipped;
   float opacity;
-
- private:
-  SharedQuadState();
 };
 
 }  // namespace cc
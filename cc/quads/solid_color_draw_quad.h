@@ -15,6 +15,7 @@ namespace cc {
 class CC_EXPORT SolidColorDrawQuad : public DrawQuad {
  public:
   static scoped_ptr<SolidColorDrawQuad> Create();
+  SolidColorDrawQuad();
 
   void SetNew(const SharedQuadState* shared_quad_state,
               gfx::Rect rect,
@@ -38,7 +39,6 @@ class CC_EXPORT SolidColorDrawQuad : public DrawQuad {
   static const SolidColorDrawQuad* MaterialCast(const DrawQuad*);
 
  private:
-  SolidColorDrawQuad();
   virtual void ExtendValue(base::DictionaryValue* value) const OVERRIDE;
 };
 
@@ -15,6 +15,7 @@ namespace cc {
 class CC_EXPORT StreamVideoDrawQuad : public DrawQuad {
  public:
   static scoped_ptr<StreamVideoDrawQuad> Create();
+  StreamVideoDrawQuad();
 
   void SetNew(const SharedQuadState* shared_quad_state,
               gfx::Rect rect,
@@ -39,7 +40,6 @@ class CC_EXPORT StreamVideoDrawQuad : public DrawQuad {
   static const StreamVideoDrawQuad* MaterialCast(const DrawQuad*);
 
  private:
-  StreamVideoDrawQuad();
   virtual void ExtendValue(base::DictionaryValue* value) const OVERRIDE;
 };
 
@@ -15,6 +15,7 @@ namespace cc {
 class CC_EXPORT TextureDrawQuad : public DrawQuad {
  public:
   static scoped_ptr<TextureDrawQuad> Create();
+  TextureDrawQuad();
 
   void SetNew(const SharedQuadState* shared_quad_state,
               gfx::Rect rect,
@@ -56,7 +57,6 @@ class CC_EXPORT TextureDrawQuad : public DrawQuad {
   bool PerformClipping();
 
  private:
-  TextureDrawQuad();
   virtual void ExtendValue(base::DictionaryValue* value) const OVERRIDE;
 };
 
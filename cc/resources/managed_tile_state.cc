@@ -57,7 +57,8 @@ scoped_ptr<base::Value> ManagedTileBinPriorityAsValue(
 }
 
 ManagedTileState::ManagedTileState()
-    : raster_mode(LOW_QUALITY_RASTER_MODE),
+    // The worst mode, which lets TileManager::DetermineRasterMode() pick any.
+    : raster_mode(COMPRESSED_RASTER_MODE),
       gpu_memmgr_stats_bin(NEVER_BIN),
       resolution(NON_IDEAL_RESOLUTION),
       required_for_activation(false),
@@ -22,6 +22,38 @@ const float kResetThreshold = 0.7f;
 // picture that intersects the visible layer rect expanded by this distance
 // will be recorded.
 const int kPixelDistanceToRecord = 8000;
+// Number of updates for which a cell remembers whether it was invalidated.
+const int kInvalidationHistoryLength = 8;
+// Cells that were invalidated in at least this many of the remembered updates
+// record their invalidations on a grid of smaller cells, so that repeated
+// invalidations of the same content replace each other's pictures instead of
+// being merged into ever larger ones.
+const int kFrequentInvalidationCount = 3;
+const int kFineCellSize = 64;
+// Maximum number of pictures that can overlap in a frequently invalidated
+// cell before we collapse them into a larger one.
+const size_t kMaxOverlappingFineGrained = 8;
+// Maximum number of cells per update whose stacked pictures are merged into
+// a single one again, once their invalidations have stopped.
+const int kMaxMergesPerUpdate = 2;
+
+int CountInvalidations(uint32 history) {
+  int count = 0;
+  for (; history; history >>= 1)
+    count += history & 1;
+  return count;
+}
+
+gfx::Rect SnapToFineCells(gfx::Rect rect) {
+  int left = rect.x() / kFineCellSize * kFineCellSize;
+  int top = rect.y() / kFineCellSize * kFineCellSize;
+  int right =
+      (rect.right() + kFineCellSize - 1) / kFineCellSize * kFineCellSize;
+  int bottom =
+      (rect.bottom() + kFineCellSize - 1) / kFineCellSize * kFineCellSize;
+  return gfx::Rect(left, top, right - left, bottom - top);
+}
+
 }  // namespace
 
 namespace cc {
@@ -42,6 +74,24 @@ bool PicturePile::Update(
   background_color_ = background_color;
   contents_opaque_ = contents_opaque;
 
+  // Age the invalidation history; cells that haven't been invalidated for
+  // as long as it's remembered are forgotten.
+  const uint32 history_mask = (1u << kInvalidationHistoryLength) - 1;
+  for (InvalidationHistoryMap::iterator it = invalidation_history_.begin();
+       it != invalidation_history_.end();) {
+    it->second = (it->second << 1) & history_mask;
+    if (it->second)
+      ++it;
+    else
+      invalidation_history_.erase(it++);
+  }
+
+  Region recorded_invalidation = invalidation;
+  recorded_invalidation.Intersect(recorded_region_);
+  int64 invalidated_pixels = 0;
+  for (Region::Iterator i(recorded_invalidation); i.has_rect(); i.next())
+    invalidated_pixels += i.rect().size().GetArea();
+
   gfx::Rect interest_rect = visible_layer_rect;
   interest_rect.Inset(
       -kPixelDistanceToRecord,
@@ -74,6 +124,15 @@ bool PicturePile::Update(
       PictureList& pic_list = find->second;
       // Leave empty pic_lists empty in case there are multiple invalidations.
       if (!pic_list.empty()) {
+        uint32& history = invalidation_history_[iter.index()];
+        history |= 1;
+        bool fine_grained =
+            CountInvalidations(history) >= kFrequentInvalidationCount;
+        if (fine_grained) {
+          tile_invalidation =
+              gfx::IntersectRects(SnapToFineCells(tile_invalidation), tile);
+        }
+
         // Inflate all recordings from invalidations with a margin so that when
         // scaled down to at least min_contents_scale, any final pixel touched
         // by an invalidation can be fully rasterized by this picture.
@@ -82,18 +141,32 @@ bool PicturePile::Update(
         DCHECK_GE(tile_invalidation.width(), buffer_pixels() * 2 + 1);
         DCHECK_GE(tile_invalidation.height(), buffer_pixels() * 2 + 1);
 
-        InvalidateRect(pic_list, tile_invalidation);
+        InvalidateRect(pic_list, tile_invalidation, fine_grained);
         modified_pile = true;
       }
     }
   }
 
   int repeat_count = std::max(1, slow_down_raster_scale_factor_for_debug_);
+  int merges = 0;
+  int64 rerecorded_pixels = 0;
 
   // Walk through all pictures in the rect of interest and record.
   for (TilingData::Iterator iter(&tiling_, interest_rect); iter; ++iter) {
-    // Create a picture in this list if it doesn't exist.
     PictureList& pic_list = picture_list_map_[iter.index()];
+    InvalidationHistoryMap::const_iterator history =
+        invalidation_history_.find(iter.index());
+
+    // Stacked pictures all have to be rasterized. Once a cell is no longer
+    // being invalidated, merge them by recording the cell again as a single
+    // picture, a few cells at a time to spread out the cost.
+    if (pic_list.size() > 1 && history == invalidation_history_.end() &&
+        merges < kMaxMergesPerUpdate) {
+      pic_list.clear();
+      ++merges;
+    }
+
+    // Create a picture in this list if it doesn't exist.
     if (pic_list.empty()) {
       // Inflate the base picture with a margin, similar to invalidations, so
       // that when scaled down to at least min_contents_scale, the enclosed
@@ -112,6 +185,8 @@ bool PicturePile::Update(
          pic != pic_list.end(); ++pic) {
       if (!(*pic)->HasRecording()) {
         modified_pile = true;
+        if (history != invalidation_history_.end() && (history->second & 1))
+          rerecorded_pixels += (*pic)->LayerRect().size().GetArea();
         TRACE_EVENT0(benchmark_instrumentation::kCategory,
                      benchmark_instrumentation::kRecordLoop);
         for (int i = 0; i < repeat_count; i++)
@@ -124,6 +199,9 @@ bool PicturePile::Update(
 
   UpdateRecordedRegion();
 
+  stats_instrumentation->AddInvalidation(invalidated_pixels,
+                                         rerecorded_pixels);
+
   return modified_pile;
 }
 
@@ -139,7 +217,8 @@ class FullyContainedPredicate {
 
 void PicturePile::InvalidateRect(
     PictureList& picture_list,
-    gfx::Rect invalidation) {
+    gfx::Rect invalidation,
+    bool fine_grained) {
   DCHECK(!picture_list.empty());
   DCHECK(!invalidation.IsEmpty());
 
@@ -153,7 +232,9 @@ void PicturePile::InvalidateRect(
   }
 
   gfx::Rect picture_rect = invalidation;
-  if (overlaps.size() >= kMaxOverlapping) {
+  size_t max_overlapping =
+      fine_grained ? kMaxOverlappingFineGrained : kMaxOverlapping;
+  if (overlaps.size() >= max_overlapping) {
     for (size_t j = 0; j < overlaps.size(); j++)
       picture_rect.Union((*overlaps[j])->LayerRect());
   }
@@ -48,9 +48,17 @@ class CC_EXPORT PicturePile : public PicturePileBase {
 
   // Add an invalidation to this picture list.  If the list needs to be
   // entirely recreated, leave it empty.  Do not call this on an empty list.
+  // |fine_grained| lets more pictures overlap before they are collapsed, for
+  // cells that are invalidated often.
   void InvalidateRect(
       PictureList& picture_list,
-      gfx::Rect invalidation);
+      gfx::Rect invalidation,
+      bool fine_grained);
+
+  // For each cell that was invalidated recently, a bit per update, with the
+  // lowest bit for the most recent one.
+  typedef base::hash_map<PictureListMapKey, uint32> InvalidationHistoryMap;
+  InvalidationHistoryMap invalidation_history_;
 
   DISALLOW_COPY_AND_ASSIGN(PicturePile);
 };
@@ -302,11 +302,14 @@ void PicturePileImpl::AnalyzeInRect(gfx::Rect content_rect,
 
   analysis->is_solid_color = canvas.GetColorIfSolid(&analysis->solid_color);
   analysis->has_text = canvas.HasText();
+  analysis->suitable_for_gpu_rasterization =
+      canvas.SuitableForGpuRasterization();
 }
 
 PicturePileImpl::Analysis::Analysis()
     : is_solid_color(false),
-      has_text(false) {
+      has_text(false),
+      suitable_for_gpu_rasterization(false) {
 }
 
 PicturePileImpl::Analysis::~Analysis() {
@@ -76,6 +76,9 @@ class CC_EXPORT PicturePileImpl : public PicturePileBase {
 
     bool is_solid_color;
     bool has_text;
+    // False if the tile draws anything that Ganesh would rasterize in
+    // software anyway.
+    bool suitable_for_gpu_rasterization;
     SkColor solid_color;
   };
 
@@ -207,5 +207,62 @@ TEST(PicturePileTest, InvalidateOnTileBoundaryInflated) {
   }
 }
 
+TEST(PicturePileTest, FrequentInvalidationsReplaceEachOther) {
+  FakeContentLayerClient client;
+  FakeRenderingStatsInstrumentation stats_instrumentation;
+  scoped_refptr<TestPicturePile> pile = new TestPicturePile;
+  SkColor background_color = SK_ColorBLUE;
+
+  float min_scale = 0.125;
+  gfx::Size layer_size = pile->tiling().max_texture_size();
+  pile->Resize(layer_size);
+  pile->SetTileGridSize(gfx::Size(1000, 1000));
+  pile->SetMinContentsScale(min_scale);
+
+  // Update the whole layer.
+  pile->Update(&client,
+               background_color,
+               false,
+               gfx::Rect(layer_size),
+               gfx::Rect(layer_size),
+               &stats_instrumentation);
+
+  // Invalidate slightly different rects near the same spot, like a blinking
+  // caret would. Once the tile is known to be invalidated often, the pictures
+  // cover the same cells and replace each other instead of piling up.
+  for (int i = 0; i < 6; ++i) {
+    gfx::Rect invalidate_rect(100 + 3 * i, 100 + 2 * i, 4, 4);
+    pile->Update(&client,
+                 background_color,
+                 false,
+                 invalidate_rect,
+                 gfx::Rect(layer_size),
+                 &stats_instrumentation);
+  }
+
+  TestPicturePile::PictureList& picture_list =
+      pile->picture_list_map().find(
+          TestPicturePile::PictureListMapKey(0, 0))->second;
+  EXPECT_EQ(2u, picture_list.size());
+
+  gfx::Rect expected_rect(64, 64, 64, 64);
+  expected_rect.Inset(-pile->buffer_pixels(), -pile->buffer_pixels());
+  EXPECT_EQ(expected_rect.ToString(),
+            picture_list.back()->LayerRect().ToString());
+
+  // Once the invalidations stop, the pictures are merged into one again.
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(2u, picture_list.size());
+    pile->Update(&client,
+                 background_color,
+                 false,
+                 Region(),
+                 gfx::Rect(layer_size),
+                 &stats_instrumentation);
+  }
+  EXPECT_EQ(1u, picture_list.size());
+  EXPECT_TRUE(picture_list.front()->HasRecording());
+}
+
 }  // namespace
 }  // namespace cc
@@ -9,6 +9,8 @@
 #include "base/values.h"
 #include "cc/debug/traced_value.h"
 #include "cc/resources/resource.h"
+#include "cc/resources/texture_compressor_etc1.h"
+#include "third_party/khronos/GLES2/gl2ext.h"
 #include "third_party/skia/include/core/SkDevice.h"
 
 namespace cc {
@@ -44,6 +46,10 @@ class PixelBufferWorkerPoolTaskImpl : public internal::WorkerPoolTask {
     bitmap.setPixels(buffer_);
     SkDevice device(bitmap);
     needs_upload_ = task_->RunOnWorkerThread(&device, thread_index);
+    // Compressed textures are uploaded from the same buffer, which is large
+    // enough to compress the tile in place.
+    if (needs_upload_ && task_->resource()->format() == GL_ETC1_RGB8_OES)
+      CompressToETC1(buffer_, task_->resource()->size(), buffer_);
   }
   virtual void CompleteOnOriginThread() OVERRIDE {
     // |needs_upload_| must be be false if task didn't run.
@@ -611,6 +617,12 @@ void PixelBufferRasterWorkerPool::OnRasterTaskCompleted(
       }
     }
 
+    // Tiles left for GPU rasterization are drawn into their texture now.
+    // If that fails the tile is treated like a canceled one and rasterized
+    // again later.
+    if (!was_canceled && task->needs_gpu_raster())
+      was_canceled = !RunGpuRasterTask(task.get());
+
     task->DidRun(was_canceled);
     DCHECK(std::find(completed_tasks_.begin(),
                      completed_tasks_.end(),
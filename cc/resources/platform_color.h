@@ -44,6 +44,10 @@ class PlatformColor {
   // Return true if the given texture format has the same component order
   // as the color on this platform.
   static bool SameComponentOrder(GLenum texture_format) {
+    // Compressed textures are encoded from the color components by name, so
+    // they always come out in the GL order.
+    if (texture_format == GL_ETC1_RGB8_OES)
+      return true;
     switch (Format()) {
       case SOURCE_FORMAT_RGBA8:
         return texture_format == GL_RGBA;
@@ -6,92 +6,176 @@
 
 #include <algorithm>
 
+#include "base/logging.h"
 #include "cc/resources/managed_tile_state.h"
 #include "cc/resources/tile.h"
 
 namespace cc {
 
-class BinComparator {
- public:
-  bool operator()(const scoped_refptr<Tile>& a,
-                  const scoped_refptr<Tile>& b) const {
-    const ManagedTileState& ams = a->managed_state();
-    const ManagedTileState& bms = b->managed_state();
+bool PrioritizedTileSet::SortKey::operator==(const SortKey& other) const {
+  return low_priority_bin == other.low_priority_bin &&
+         required_for_activation == other.required_for_activation &&
+         resolution == other.resolution &&
+         time_to_needed_in_seconds == other.time_to_needed_in_seconds &&
+         distance_to_visible_in_pixels ==
+             other.distance_to_visible_in_pixels &&
+         y == other.y &&
+         x == other.x;
+}
 
-    if (ams.bin[LOW_PRIORITY_BIN] != bms.bin[LOW_PRIORITY_BIN])
-      return ams.bin[LOW_PRIORITY_BIN] < bms.bin[LOW_PRIORITY_BIN];
+bool PrioritizedTileSet::SortKey::operator<(const SortKey& other) const {
+  if (low_priority_bin != other.low_priority_bin)
+    return low_priority_bin < other.low_priority_bin;
 
-    if (ams.required_for_activation != bms.required_for_activation)
-      return ams.required_for_activation;
+  if (required_for_activation != other.required_for_activation)
+    return required_for_activation;
 
-    if (ams.resolution != bms.resolution)
-      return ams.resolution < bms.resolution;
+  if (resolution != other.resolution)
+    return resolution < other.resolution;
 
-    if (ams.time_to_needed_in_seconds !=  bms.time_to_needed_in_seconds)
-      return ams.time_to_needed_in_seconds < bms.time_to_needed_in_seconds;
+  if (time_to_needed_in_seconds != other.time_to_needed_in_seconds)
+    return time_to_needed_in_seconds < other.time_to_needed_in_seconds;
 
-    if (ams.distance_to_visible_in_pixels !=
-        bms.distance_to_visible_in_pixels) {
-      return ams.distance_to_visible_in_pixels <
-             bms.distance_to_visible_in_pixels;
-    }
+  if (distance_to_visible_in_pixels != other.distance_to_visible_in_pixels)
+    return distance_to_visible_in_pixels < other.distance_to_visible_in_pixels;
 
-    gfx::Rect a_rect = a->content_rect();
-    gfx::Rect b_rect = b->content_rect();
-    if (a_rect.y() != b_rect.y())
-      return a_rect.y() < b_rect.y();
-    return a_rect.x() < b_rect.x();
-  }
-};
+  if (y != other.y)
+    return y < other.y;
+  return x < other.x;
+}
 
 namespace {
 
-typedef std::vector<scoped_refptr<Tile> > TileVector;
-
-void SortBinTiles(ManagedTileBin bin, TileVector* tiles) {
-  switch (bin) {
-    case NOW_AND_READY_TO_DRAW_BIN:
-      break;
-    case NOW_BIN:
-    case SOON_BIN:
-    case EVENTUALLY_AND_ACTIVE_BIN:
-    case EVENTUALLY_BIN:
-    case NEVER_AND_ACTIVE_BIN:
-    case NEVER_BIN:
-      std::sort(tiles->begin(), tiles->end(), BinComparator());
-      break;
-    default:
-      NOTREACHED();
-  }
-}
+struct IsRemoved {
+  template <typename T>
+  bool operator()(const T& entry) const { return !entry.tile; }
+};
 
 }  // namespace
 
-PrioritizedTileSet::PrioritizedTileSet() {}
+PrioritizedTileSet::PrioritizedTileSet() {
+  for (int bin = 0; bin < NUM_BINS; ++bin) {
+    sorted_size_[bin] = 0;
+    has_removed_entries_[bin] = false;
+  }
+}
 
 PrioritizedTileSet::~PrioritizedTileSet() {}
 
 void PrioritizedTileSet::InsertTile(Tile* tile, ManagedTileBin bin) {
-  tiles_[bin].push_back(make_scoped_refptr(tile));
+  SortKey key = SortKeyForTile(tile);
+
+  std::pair<PositionMap::iterator, bool> result =
+      positions_.insert(std::make_pair(tile->id(), Position()));
+  Position& position = result.first->second;
+  if (!result.second) {
+    const Entry& entry = tiles_[position.bin][position.index];
+    DCHECK_EQ(tile, entry.tile);
+    if (position.bin == bin && entry.key == key)
+      return;
+    ForgetEntry(position);
+  }
+
+  Entry entry = { tile, key };
+  position.bin = bin;
+  position.index = tiles_[bin].size();
+  tiles_[bin].push_back(entry);
+}
+
+void PrioritizedTileSet::RemoveTile(Tile* tile) {
+  PositionMap::iterator it = positions_.find(tile->id());
+  if (it == positions_.end())
+    return;
+
+  DCHECK_EQ(tile, tiles_[it->second.bin][it->second.index].tile);
+  ForgetEntry(it->second);
+  positions_.erase(it);
 }
 
 void PrioritizedTileSet::Clear() {
-  for (int bin = 0; bin < NUM_BINS; ++bin)
+  for (int bin = 0; bin < NUM_BINS; ++bin) {
     tiles_[bin].clear();
+    sorted_size_[bin] = 0;
+    has_removed_entries_[bin] = false;
+  }
+  positions_.clear();
 }
 
 void PrioritizedTileSet::Sort() {
   for (int bin = 0; bin < NUM_BINS; ++bin)
-    SortBinTiles(static_cast<ManagedTileBin>(bin), &tiles_[bin]);
+    SortBin(static_cast<ManagedTileBin>(bin));
+}
+
+// static
+PrioritizedTileSet::SortKey PrioritizedTileSet::SortKeyForTile(
+    const Tile* tile) {
+  const ManagedTileState& mts = tile->managed_state();
+  SortKey key;
+  key.low_priority_bin = mts.bin[LOW_PRIORITY_BIN];
+  key.required_for_activation = mts.required_for_activation;
+  key.resolution = mts.resolution;
+  key.time_to_needed_in_seconds = mts.time_to_needed_in_seconds;
+  key.distance_to_visible_in_pixels = mts.distance_to_visible_in_pixels;
+  key.y = tile->content_rect().y();
+  key.x = tile->content_rect().x();
+  return key;
+}
+
+void PrioritizedTileSet::ForgetEntry(const Position& position) {
+  // Removing the entry outright would shift or reorder the rest of the bin;
+  // the hole is closed up by the next Sort() instead.
+  tiles_[position.bin][position.index].tile = NULL;
+  has_removed_entries_[position.bin] = true;
+}
+
+void PrioritizedTileSet::SortBin(ManagedTileBin bin) {
+  std::vector<Entry>& tiles = tiles_[bin];
+  size_t sorted_size = sorted_size_[bin];
+  if (sorted_size == tiles.size() && !has_removed_entries_[bin])
+    return;
+
+  // Entries in front of |first_moved| keep their index.
+  size_t first_moved = sorted_size;
+  if (has_removed_entries_[bin]) {
+    // Closing up the holes keeps the remaining entries in order.
+    std::vector<Entry>::iterator first_removed =
+        std::find_if(tiles.begin(), tiles.end(), IsRemoved());
+    size_t first_removed_index = first_removed - tiles.begin();
+    if (first_removed_index < sorted_size) {
+      sorted_size -= std::count_if(first_removed,
+                                   tiles.begin() + sorted_size,
+                                   IsRemoved());
+      first_moved = first_removed_index;
+    }
+    tiles.erase(std::remove_if(first_removed, tiles.end(), IsRemoved()),
+                tiles.end());
+    has_removed_entries_[bin] = false;
+  }
+
+  // Tiles that are ready to draw are used in any order.
+  if (bin != NOW_AND_READY_TO_DRAW_BIN && sorted_size < tiles.size()) {
+    std::vector<Entry>::iterator middle = tiles.begin() + sorted_size;
+    std::sort(middle, tiles.end());
+    std::vector<Entry>::iterator merge_point =
+        std::upper_bound(tiles.begin(), middle, *middle);
+    first_moved = std::min<size_t>(first_moved, merge_point - tiles.begin());
+    std::inplace_merge(merge_point, middle, tiles.end());
+  }
+  sorted_size_[bin] = tiles.size();
+
+  for (size_t i = first_moved; i < tiles.size(); ++i) {
+    Position& position = positions_[tiles[i].tile->id()];
+    DCHECK_EQ(bin, position.bin);
+    position.index = i;
+  }
 }
 
 PrioritizedTileSet::PriorityIterator::PriorityIterator(
     PrioritizedTileSet* tile_set)
     : tile_set_(tile_set),
       current_bin_(NOW_AND_READY_TO_DRAW_BIN),
-      iterator_(tile_set->tiles_[current_bin_].begin()) {
-  if (iterator_ == tile_set_->tiles_[current_bin_].end())
-    AdvanceList();
+      index_(0) {
+  SkipRemovedTiles();
 }
 
 PrioritizedTileSet::PriorityIterator::~PriorityIterator() {}
@@ -99,28 +183,35 @@ PrioritizedTileSet::PriorityIterator::~PriorityIterator() {}
 PrioritizedTileSet::PriorityIterator&
 PrioritizedTileSet::PriorityIterator::operator++() {
   // We can't increment past the end of the tiles.
-  DCHECK(iterator_ != tile_set_->tiles_[current_bin_].end());
+  DCHECK_LT(index_, tile_set_->tiles_[current_bin_].size());
 
-  ++iterator_;
-  if (iterator_ == tile_set_->tiles_[current_bin_].end())
-    AdvanceList();
+  ++index_;
+  SkipRemovedTiles();
   return *this;
 }
 
 Tile* PrioritizedTileSet::PriorityIterator::operator*() {
-  DCHECK(iterator_ != tile_set_->tiles_[current_bin_].end());
-  return iterator_->get();
+  DCHECK_LT(index_, tile_set_->tiles_[current_bin_].size());
+  return tile_set_->tiles_[current_bin_][index_].tile;
+}
+
+void PrioritizedTileSet::PriorityIterator::SkipRemovedTiles() {
+  while (true) {
+    const std::vector<Entry>& tiles = tile_set_->tiles_[current_bin_];
+    while (index_ < tiles.size() && !tiles[index_].tile)
+      ++index_;
+    if (index_ < tiles.size() || current_bin_ == NEVER_BIN)
+      return;
+    AdvanceList();
+  }
 }
 
 void PrioritizedTileSet::PriorityIterator::AdvanceList() {
-  DCHECK(iterator_ == tile_set_->tiles_[current_bin_].end());
+  DCHECK_EQ(index_, tile_set_->tiles_[current_bin_].size());
+  DCHECK_NE(NEVER_BIN, current_bin_);
 
-  while (current_bin_ != NEVER_BIN) {
-    current_bin_ = static_cast<ManagedTileBin>(current_bin_ + 1);
-    iterator_ = tile_set_->tiles_[current_bin_].begin();
-    if (iterator_ != tile_set_->tiles_[current_bin_].end())
-      break;
-  }
+  current_bin_ = static_cast<ManagedTileBin>(current_bin_ + 1);
+  index_ = 0;
 }
 
 }  // namespace cc
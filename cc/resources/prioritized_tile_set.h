@@ -7,21 +7,31 @@
 
 #include <vector>
 
-#include "base/memory/ref_counted.h"
-#include "base/memory/scoped_ptr.h"
+#include "base/containers/hash_tables.h"
 #include "cc/base/cc_export.h"
 #include "cc/resources/managed_tile_state.h"
+#include "cc/resources/tile.h"
 
 namespace cc {
-class Tile;
 
+// Keeps tiles binned and sorted by priority from one frame to the next, so
+// that only the tiles whose bin or priority changed have to be moved. The set
+// doesn't keep its tiles alive; a tile has to be removed before it goes away.
 class CC_EXPORT PrioritizedTileSet {
  public:
   PrioritizedTileSet();
   ~PrioritizedTileSet();
 
+  // Puts |tile| into |bin|, using its current managed state for ordering
+  // within the bin. Nothing is done if the tile is already there and its
+  // priority hasn't changed.
   void InsertTile(Tile* tile, ManagedTileBin bin);
+  void RemoveTile(Tile* tile);
   void Clear();
+
+  // Brings the bins that changed since the last call back into order. Only
+  // tiles that have been inserted since then are sorted; they are merged
+  // with the tiles that kept their place.
   void Sort();
 
   class CC_EXPORT PriorityIterator {
@@ -33,22 +43,64 @@ class CC_EXPORT PrioritizedTileSet {
     Tile* operator->() { return *(*this); }
     Tile* operator*();
     operator bool() const {
-      return iterator_ != tile_set_->tiles_[current_bin_].end();
+      return index_ < tile_set_->tiles_[current_bin_].size();
     }
 
    private:
+    // Skips tiles removed since the last Sort(), then moves on to the next
+    // non-empty bin if the current one is done.
+    void SkipRemovedTiles();
     void AdvanceList();
 
     PrioritizedTileSet* tile_set_;
     ManagedTileBin current_bin_;
-    std::vector<scoped_refptr<Tile> >::iterator iterator_;
+    size_t index_;
   };
 
  private:
   friend class PriorityIterator;
 
-  typedef scoped_refptr<Tile> TileRef;
-  std::vector<TileRef> tiles_[NUM_BINS];
+  // A copy of the parts of a tile's managed state that order it within its
+  // bin, which keeps sorting from having to go through every tile.
+  struct SortKey {
+    bool operator==(const SortKey& other) const;
+    bool operator<(const SortKey& other) const;
+
+    ManagedTileBin low_priority_bin;
+    bool required_for_activation;
+    TileResolution resolution;
+    float time_to_needed_in_seconds;
+    float distance_to_visible_in_pixels;
+    int y;
+    int x;
+  };
+
+  struct Entry {
+    bool operator<(const Entry& other) const { return key < other.key; }
+
+    // NULL once the tile has left the bin.
+    Tile* tile;
+    SortKey key;
+  };
+
+  struct Position {
+    ManagedTileBin bin;
+    size_t index;
+  };
+
+  static SortKey SortKeyForTile(const Tile* tile);
+  void ForgetEntry(const Position& position);
+  void SortBin(ManagedTileBin bin);
+
+  std::vector<Entry> tiles_[NUM_BINS];
+
+  // The number of entries at the front of each bin that were in order after
+  // the last Sort(), and whether any entry of the bin has been removed since.
+  size_t sorted_size_[NUM_BINS];
+  bool has_removed_entries_[NUM_BINS];
+
+  typedef base::hash_map<Tile::Id, Position> PositionMap;
+  PositionMap positions_;
 };
 
 }  // namespace cc
@@ -62,10 +62,14 @@ class PrioritizedTileSetTest : public testing::Test {
         picture_pile_(FakePicturePileImpl::CreatePile()) {}
 
   scoped_refptr<Tile> CreateTile() {
+    return CreateTileWithContentRect(gfx::Rect());
+  }
+
+  scoped_refptr<Tile> CreateTileWithContentRect(const gfx::Rect& rect) {
     return make_scoped_refptr(new Tile(tile_manager_.get(),
                                        picture_pile_.get(),
                                        settings_.default_tile_size,
-                                       gfx::Rect(),
+                                       rect,
                                        gfx::Rect(),
                                        1.0,
                                        0,
@@ -465,6 +469,101 @@ TEST_F(PrioritizedTileSetTest, MultipleIterators) {
   EXPECT_FALSE(empty_it);
 }
 
+TEST_F(PrioritizedTileSetTest, MoveTileToOtherBin) {
+  scoped_refptr<Tile> first = CreateTile();
+  scoped_refptr<Tile> second = CreateTile();
+
+  PrioritizedTileSet set;
+  set.InsertTile(first, NOW_BIN);
+  set.InsertTile(second, SOON_BIN);
+  set.Sort();
+
+  // Inserting a tile again moves it.
+  set.InsertTile(first, EVENTUALLY_BIN);
+  set.InsertTile(second, SOON_BIN);
+  set.Sort();
+
+  PrioritizedTileSet::PriorityIterator it(&set);
+  EXPECT_TRUE(*it == second.get());
+  ++it;
+  EXPECT_TRUE(*it == first.get());
+  ++it;
+  EXPECT_FALSE(it);
+}
+
+TEST_F(PrioritizedTileSetTest, RemoveTile) {
+  scoped_refptr<Tile> first = CreateTileWithContentRect(gfx::Rect(0, 0, 1, 1));
+  scoped_refptr<Tile> second =
+      CreateTileWithContentRect(gfx::Rect(0, 1, 1, 1));
+  scoped_refptr<Tile> third = CreateTileWithContentRect(gfx::Rect(0, 2, 1, 1));
+
+  PrioritizedTileSet set;
+  set.InsertTile(third, NOW_BIN);
+  set.InsertTile(first, NOW_BIN);
+  set.InsertTile(second, NOW_BIN);
+  set.Sort();
+
+  // Removed tiles are skipped, even before the set is sorted again.
+  set.RemoveTile(second);
+  PrioritizedTileSet::PriorityIterator it(&set);
+  EXPECT_TRUE(*it == first.get());
+  ++it;
+  EXPECT_TRUE(*it == third.get());
+  ++it;
+  EXPECT_FALSE(it);
+
+  set.RemoveTile(first);
+  set.Sort();
+  PrioritizedTileSet::PriorityIterator sorted_it(&set);
+  EXPECT_TRUE(*sorted_it == third.get());
+  ++sorted_it;
+  EXPECT_FALSE(sorted_it);
+
+  // Removing a tile that isn't in the set does nothing.
+  set.RemoveTile(second);
+  set.RemoveTile(third);
+  set.Sort();
+  PrioritizedTileSet::PriorityIterator empty_it(&set);
+  EXPECT_FALSE(empty_it);
+}
+
+TEST_F(PrioritizedTileSetTest, InsertIntoSortedBin) {
+  std::vector<scoped_refptr<Tile> > tiles;
+  for (int i = 0; i < 10; ++i)
+    tiles.push_back(CreateTileWithContentRect(gfx::Rect(0, i, 1, 1)));
+
+  PrioritizedTileSet set;
+  for (int i = 0; i < 10; i += 2)
+    set.InsertTile(tiles[i], SOON_BIN);
+  set.Sort();
+
+  // New tiles are merged with the ones that were already in order.
+  for (int i = 9; i > 0; i -= 2)
+    set.InsertTile(tiles[i], SOON_BIN);
+  set.RemoveTile(tiles[4]);
+  set.Sort();
+
+  int i = 0;
+  for (PrioritizedTileSet::PriorityIterator it(&set); it; ++it) {
+    if (i == 4)
+      ++i;
+    ASSERT_LT(i, 10);
+    EXPECT_TRUE(*it == tiles[i].get());
+    ++i;
+  }
+  EXPECT_EQ(10, i);
+
+  // Tiles keep their place when inserted again without any change.
+  for (int i = 0; i < 10; ++i) {
+    if (i != 4)
+      set.InsertTile(tiles[i], SOON_BIN);
+  }
+  set.RemoveTile(tiles[0]);
+  set.Sort();
+  PrioritizedTileSet::PriorityIterator it(&set);
+  EXPECT_TRUE(*it == tiles[1].get());
+}
+
 }  // namespace
 }  // namespace cc
 
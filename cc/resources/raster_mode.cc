@@ -21,6 +21,9 @@ scoped_ptr<base::Value> RasterModeAsValue(RasterMode raster_mode) {
     case LOW_QUALITY_RASTER_MODE:
       return scoped_ptr<base::Value>(
           base::Value::CreateStringValue("LOW_QUALITY_RASTER_MODE"));
+    case COMPRESSED_RASTER_MODE:
+      return scoped_ptr<base::Value>(
+          base::Value::CreateStringValue("COMPRESSED_RASTER_MODE"));
     case NUM_RASTER_MODES:
     default:
       NOTREACHED() << "Unrecognized RasterMode value " << raster_mode;
@@ -15,13 +15,16 @@ namespace cc {
 
 // Low quality implies no lcd test;
 // high quality implies lcd text.
+// Compressed implies no lcd text, and a texture in the tile manager's
+// compressed format, which takes less memory but loses some detail.
 // Note that the order of these matters, from "better" to "worse" in terms of
 // quality.
 enum RasterMode {
   HIGH_QUALITY_NO_LCD_RASTER_MODE = 0,
   HIGH_QUALITY_RASTER_MODE = 1,
   LOW_QUALITY_RASTER_MODE = 2,
-  NUM_RASTER_MODES = 3
+  COMPRESSED_RASTER_MODE = 3,
+  NUM_RASTER_MODES = 4
 };
 
 scoped_ptr<base::Value> RasterModeAsValue(RasterMode mode);
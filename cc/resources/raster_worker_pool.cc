@@ -10,9 +10,16 @@
 #include "cc/debug/benchmark_instrumentation.h"
 #include "cc/debug/devtools_instrumentation.h"
 #include "cc/debug/traced_value.h"
+#include "cc/output/context_provider.h"
 #include "cc/resources/picture_pile_impl.h"
+#include "cc/resources/resource.h"
+#include "cc/resources/resource_provider.h"
 #include "skia/ext/lazy_pixel_ref.h"
 #include "skia/ext/paint_simplifier.h"
+#include "third_party/WebKit/public/platform/WebGraphicsContext3D.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+#include "third_party/skia/include/gpu/GrTexture.h"
+#include "third_party/skia/include/gpu/SkGpuDevice.h"
 
 namespace cc {
 
@@ -41,6 +48,7 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
                            gfx::Rect content_rect,
                            float contents_scale,
                            RasterMode raster_mode,
+                           bool use_gpu_rasterization,
                            bool is_tile_in_pending_tree_now_bin,
                            TileResolution tile_resolution,
                            int layer_id,
@@ -54,6 +62,7 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
         content_rect_(content_rect),
         contents_scale_(contents_scale),
         raster_mode_(raster_mode),
+        use_gpu_rasterization_(use_gpu_rasterization),
         is_tile_in_pending_tree_now_bin_(is_tile_in_pending_tree_now_bin),
         tile_resolution_(tile_resolution),
         layer_id_(layer_id),
@@ -112,21 +121,7 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
 
     SkCanvas canvas(device);
 
-    skia::RefPtr<SkDrawFilter> draw_filter;
-    switch (raster_mode_) {
-      case LOW_QUALITY_RASTER_MODE:
-        draw_filter = skia::AdoptRef(new skia::PaintSimplifier);
-        break;
-      case HIGH_QUALITY_NO_LCD_RASTER_MODE:
-        draw_filter = skia::AdoptRef(new DisableLCDTextFilter);
-        break;
-      case HIGH_QUALITY_RASTER_MODE:
-        break;
-      case NUM_RASTER_MODES:
-      default:
-        NOTREACHED();
-    }
-
+    skia::RefPtr<SkDrawFilter> draw_filter = CreateDrawFilter();
     canvas.setDrawFilter(draw_filter.get());
 
     if (rendering_stats_->record_rendering_stats()) {
@@ -156,8 +151,41 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
   virtual bool RunOnWorkerThread(SkDevice* device, unsigned thread_index)
       OVERRIDE {
     RunAnalysisOnThread(thread_index);
+    // Tiles that Ganesh can draw well are left for the origin thread, which
+    // draws them straight into their texture.
+    if (use_gpu_rasterization_ &&
+        !analysis_.is_solid_color &&
+        !analysis_.has_text &&
+        analysis_.suitable_for_gpu_rasterization) {
+      set_needs_gpu_raster();
+      return false;
+    }
     return RunRasterOnThread(device, thread_index);
   }
+  virtual bool RunOnOriginThread(SkDevice* device) OVERRIDE {
+    TRACE_EVENT1("cc",
+                 "RasterWorkerPoolTaskImpl::RunOnOriginThread",
+                 "data",
+                 TracedValue::FromValue(DataAsValue().release()));
+
+    devtools_instrumentation::ScopedLayerTask raster_task(
+        devtools_instrumentation::kRasterTask, layer_id_);
+
+    DCHECK(picture_pile_.get());
+    DCHECK(device);
+    DCHECK(needs_gpu_raster());
+
+    SkCanvas canvas(device);
+
+    skia::RefPtr<SkDrawFilter> draw_filter = CreateDrawFilter();
+    canvas.setDrawFilter(draw_filter.get());
+
+    base::TimeTicks start_time = rendering_stats_->StartRecording();
+    picture_pile_->RasterToBitmap(
+        &canvas, content_rect_, contents_scale_, NULL);
+    rendering_stats_->AddGpuRaster(rendering_stats_->EndRecording(start_time));
+    return true;
+  }
   virtual void CompleteOnOriginThread() OVERRIDE {
     reply_.Run(analysis_, !HasFinishedRunning() || WasCanceled());
   }
@@ -166,6 +194,22 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
   virtual ~RasterWorkerPoolTaskImpl() {}
 
  private:
+  skia::RefPtr<SkDrawFilter> CreateDrawFilter() const {
+    switch (raster_mode_) {
+      case LOW_QUALITY_RASTER_MODE:
+        return skia::AdoptRef<SkDrawFilter>(new skia::PaintSimplifier);
+      case HIGH_QUALITY_NO_LCD_RASTER_MODE:
+      case COMPRESSED_RASTER_MODE:
+        return skia::AdoptRef<SkDrawFilter>(new DisableLCDTextFilter);
+      case HIGH_QUALITY_RASTER_MODE:
+        return skia::RefPtr<SkDrawFilter>();
+      case NUM_RASTER_MODES:
+      default:
+        NOTREACHED();
+    }
+    return skia::RefPtr<SkDrawFilter>();
+  }
+
   scoped_ptr<base::Value> DataAsValue() const {
     scoped_ptr<base::DictionaryValue> res(new base::DictionaryValue());
     res->Set("tile_id", TracedValue::CreateIDRef(tile_id_).release());
@@ -182,6 +226,7 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
   gfx::Rect content_rect_;
   float contents_scale_;
   RasterMode raster_mode_;
+  bool use_gpu_rasterization_;
   bool is_tile_in_pending_tree_now_bin_;
   TileResolution tile_resolution_;
   int layer_id_;
@@ -275,6 +320,7 @@ RasterWorkerPoolTask::RasterWorkerPoolTask(
     : did_run_(false),
       did_complete_(false),
       was_canceled_(false),
+      needs_gpu_raster_(false),
       resource_(resource) {
   dependencies_.swap(*dependencies);
 }
@@ -372,6 +418,7 @@ RasterWorkerPool::RasterTask RasterWorkerPool::CreateRasterTask(
     gfx::Rect content_rect,
     float contents_scale,
     RasterMode raster_mode,
+    bool use_gpu_rasterization,
     bool is_tile_in_pending_tree_now_bin,
     TileResolution tile_resolution,
     int layer_id,
@@ -386,6 +433,7 @@ RasterWorkerPool::RasterTask RasterWorkerPool::CreateRasterTask(
                                    content_rect,
                                    contents_scale,
                                    raster_mode,
+                                   use_gpu_rasterization,
                                    is_tile_in_pending_tree_now_bin,
                                    tile_resolution,
                                    layer_id,
@@ -460,6 +508,57 @@ scoped_refptr<internal::WorkerPoolTask>
                      weak_ptr_factory_.GetWeakPtr())));
 }
 
+bool RasterWorkerPool::RunGpuRasterTask(internal::RasterWorkerPoolTask* task) {
+  TRACE_EVENT0("cc", "RasterWorkerPool::RunGpuRasterTask");
+
+  DCHECK(task->needs_gpu_raster());
+
+  ContextProvider* offscreen_contexts =
+      resource_provider_->offscreen_context_provider();
+  if (!offscreen_contexts || !offscreen_contexts->GrContext())
+    return false;
+
+  ResourceProvider::ScopedWriteLockGL lock(resource_provider_,
+                                           task->resource()->id());
+
+  // Flush the compositor context to ensure that the texture is available in
+  // the shared context. Do this after locking/allocating the texture.
+  resource_provider_->Flush();
+
+  // Make sure skia uses the correct GL context.
+  offscreen_contexts->Context3d()->makeContextCurrent();
+
+  // Wrap the tile's texture in a Ganesh render target.
+  GrBackendTextureDesc backend_texture_description;
+  backend_texture_description.fFlags = kRenderTarget_GrBackendTextureFlag;
+  backend_texture_description.fWidth = task->resource()->size().width();
+  backend_texture_description.fHeight = task->resource()->size().height();
+  backend_texture_description.fConfig = kSkia8888_GrPixelConfig;
+  backend_texture_description.fTextureHandle = lock.texture_id();
+  backend_texture_description.fOrigin = kTopLeft_GrSurfaceOrigin;
+  skia::RefPtr<GrTexture> texture =
+      skia::AdoptRef(offscreen_contexts->GrContext()->wrapBackendTexture(
+          backend_texture_description));
+
+  bool did_raster = false;
+  if (texture) {
+    SkGpuDevice device(offscreen_contexts->GrContext(), texture.get());
+    did_raster = task->RunOnOriginThread(&device);
+
+    // Flush skia context so that all the rendered stuff appears on the
+    // texture.
+    offscreen_contexts->GrContext()->flush();
+  }
+
+  // Flush the GL context so rendering results from this context are
+  // visible in the compositor's context.
+  offscreen_contexts->Context3d()->flush();
+
+  // Use the compositor's GL context again.
+  resource_provider_->GraphicsContext3D()->makeContextCurrent();
+  return did_raster;
+}
+
 void RasterWorkerPool::OnRasterFinished(
     const internal::WorkerPoolTask* source) {
   TRACE_EVENT0("cc", "RasterWorkerPool::OnRasterFinished");
@@ -37,6 +37,10 @@ class CC_EXPORT RasterWorkerPoolTask
   // the content of |device| is undefined and the resource doesn't
   // need to be initialized.
   virtual bool RunOnWorkerThread(SkDevice* device, unsigned thread_index) = 0;
+  // Rasterizes into a GPU-backed |device| when RunOnWorkerThread() left the
+  // task with needs_gpu_raster() set. Returns true if |device| was written
+  // to.
+  virtual bool RunOnOriginThread(SkDevice* device) = 0;
   virtual void CompleteOnOriginThread() = 0;
 
   void DidRun(bool was_canceled);
@@ -48,6 +52,7 @@ class CC_EXPORT RasterWorkerPoolTask
 
   const Resource* resource() const { return resource_; }
   const TaskVector& dependencies() const { return dependencies_; }
+  bool needs_gpu_raster() const { return needs_gpu_raster_; }
 
  protected:
   friend class base::RefCounted<RasterWorkerPoolTask>;
@@ -55,10 +60,13 @@ class CC_EXPORT RasterWorkerPoolTask
   RasterWorkerPoolTask(const Resource* resource, TaskVector* dependencies);
   virtual ~RasterWorkerPoolTask();
 
+  void set_needs_gpu_raster() { needs_gpu_raster_ = true; }
+
  private:
   bool did_run_;
   bool did_complete_;
   bool was_canceled_;
+  bool needs_gpu_raster_;
   const Resource* resource_;
   TaskVector dependencies_;
 };
@@ -190,6 +198,7 @@ class CC_EXPORT RasterWorkerPool : public WorkerPool {
       gfx::Rect content_rect,
       float contents_scale,
       RasterMode raster_mode,
+      bool use_gpu_rasterization,
       bool is_tile_in_pending_tree_now_bin,
       TileResolution tile_resolution,
       int layer_id,
@@ -244,6 +253,12 @@ class CC_EXPORT RasterWorkerPool : public WorkerPool {
   scoped_refptr<internal::WorkerPoolTask>
       CreateRasterRequiredForActivationFinishedTask();
 
+  // Rasterizes |task| straight into its resource using the offscreen
+  // context's GrContext. Returns false if that isn't possible, e.g. because
+  // there is no offscreen context, in which case the resource is left
+  // uninitialized.
+  bool RunGpuRasterTask(internal::RasterWorkerPoolTask* task);
+
   scoped_ptr<base::Value> ScheduledStateAsValue() const;
 
   static internal::GraphNode* CreateGraphNodeForTask(
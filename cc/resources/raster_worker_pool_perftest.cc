@@ -5,6 +5,7 @@
 #include "cc/resources/raster_worker_pool.h"
 
 #include "base/time/time.h"
+#include "cc/base/completion_event.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace cc {
@@ -25,6 +26,35 @@ class PerfWorkerPoolTaskImpl : public internal::WorkerPoolTask {
   virtual ~PerfWorkerPoolTaskImpl() {}
 };
 
+class PerfControlWorkerPoolTaskImpl : public internal::WorkerPoolTask {
+ public:
+  PerfControlWorkerPoolTaskImpl() : did_start_(new CompletionEvent),
+                                    can_finish_(new CompletionEvent) {}
+
+  // Overridden from internal::WorkerPoolTask:
+  virtual void RunOnWorkerThread(unsigned thread_index) OVERRIDE {
+    did_start_->Signal();
+    can_finish_->Wait();
+  }
+  virtual void CompleteOnOriginThread() OVERRIDE {}
+
+  void WaitForTaskToStartRunning() {
+    did_start_->Wait();
+  }
+
+  void AllowTaskToFinish() {
+    can_finish_->Signal();
+  }
+
+ private:
+  virtual ~PerfControlWorkerPoolTaskImpl() {}
+
+  scoped_ptr<CompletionEvent> did_start_;
+  scoped_ptr<CompletionEvent> can_finish_;
+
+  DISALLOW_COPY_AND_ASSIGN(PerfControlWorkerPoolTaskImpl);
+};
+
 class PerfRasterWorkerPool : public RasterWorkerPool {
  public:
   PerfRasterWorkerPool() : RasterWorkerPool(NULL, 1) {}
@@ -62,8 +92,32 @@ class PerfRasterWorkerPool : public RasterWorkerPool {
   }
 
   void BuildTaskGraph() {
-    unsigned priority = 0;
     TaskGraph graph;
+    BuildTaskGraph(&graph);
+  }
+
+  void ScheduleTaskGraph() {
+    TaskGraph graph;
+    BuildTaskGraph(&graph);
+    SetTaskGraph(&graph);
+  }
+
+  // Runs |control_task| alone, which keeps the worker busy until the task is
+  // allowed to finish.
+  void ScheduleControlTask(internal::WorkerPoolTask* control_task) {
+    TaskGraph graph;
+    CreateGraphNodeForTask(control_task, 0u, &graph);
+    SetTaskGraph(&graph);
+  }
+
+  void CancelTasks() {
+    TaskGraph empty;
+    SetTaskGraph(&empty);
+  }
+
+ private:
+  void BuildTaskGraph(TaskGraph* graph) {
+    unsigned priority = 0;
 
     scoped_refptr<internal::WorkerPoolTask>
         raster_required_for_activation_finished_task(
@@ -72,14 +126,14 @@ class PerfRasterWorkerPool : public RasterWorkerPool {
         CreateGraphNodeForTask(
             raster_required_for_activation_finished_task.get(),
             priority++,
-            &graph);
+            graph);
 
     scoped_refptr<internal::WorkerPoolTask> raster_finished_task(
         CreateRasterFinishedTask());
     internal::GraphNode* raster_finished_node =
         CreateGraphNodeForTask(raster_finished_task.get(),
                                priority++,
-                               &graph);
+                               graph);
 
     for (RasterTaskVector::const_iterator it = raster_tasks().begin();
          it != raster_tasks().end(); ++it) {
@@ -94,7 +148,7 @@ class PerfRasterWorkerPool : public RasterWorkerPool {
             CreateGraphNodeForRasterTask(perf_task,
                                          task->dependencies(),
                                          priority++,
-                                         &graph);
+                                         graph);
 
         if (IsRasterTaskRequiredForActivation(task)) {
           raster_required_for_activation_finished_node->add_dependency();
@@ -108,7 +162,6 @@ class PerfRasterWorkerPool : public RasterWorkerPool {
     }
   }
 
- private:
   TaskMap perf_tasks_;
 
   DISALLOW_COPY_AND_ASSIGN(PerfRasterWorkerPool);
@@ -124,6 +177,7 @@ class RasterWorkerPoolPerfTest : public testing::Test {
   }
   virtual void TearDown() OVERRIDE {
     raster_worker_pool_->Shutdown();
+    raster_worker_pool_->CheckForCompletedTasks();
   }
 
   void EndTest() {
@@ -183,6 +237,7 @@ class RasterWorkerPoolPerfTest : public testing::Test {
               1.0,
               HIGH_QUALITY_RASTER_MODE,
               false,
+              false,
               TileResolution(),
               1,
               NULL,
@@ -209,6 +264,31 @@ class RasterWorkerPoolPerfTest : public testing::Test {
     AfterTest(test_name);
   }
 
+  // Schedules the same set of tasks over and over while they are waiting for
+  // the worker, the common case when new frames keep coming in while tasks
+  // from the previous frame have yet to run.
+  void RunScheduleUnchangedTasksTest(const std::string test_name,
+                                     unsigned num_raster_tasks,
+                                     unsigned num_image_decode_tasks) {
+    start_time_ = base::TimeTicks();
+    num_runs_ = 0;
+    RasterWorkerPool::RasterTask::Queue tasks;
+    CreateTasks(&tasks, num_raster_tasks, num_image_decode_tasks);
+    raster_worker_pool_->SetRasterTasks(&tasks);
+    scoped_refptr<PerfControlWorkerPoolTaskImpl> control_task(
+        new PerfControlWorkerPoolTaskImpl);
+    raster_worker_pool_->ScheduleControlTask(control_task.get());
+    control_task->WaitForTaskToStartRunning();
+    do {
+      raster_worker_pool_->ScheduleTaskGraph();
+    } while (DidRun());
+    raster_worker_pool_->CancelTasks();
+    raster_worker_pool_->CheckForCompletedTasks();
+    control_task->AllowTaskToFinish();
+
+    AfterTest(test_name);
+  }
+
  protected:
   static void OnRasterTaskCompleted(const PicturePileImpl::Analysis& analysis,
                                     bool was_canceled) {}
@@ -235,6 +315,15 @@ TEST_F(RasterWorkerPoolPerfTest, BuildTaskGraph) {
   RunBuildTaskGraphTest("build_task_graph_1000_16", 1000, 16);
 }
 
+TEST_F(RasterWorkerPoolPerfTest, ScheduleUnchangedTasks) {
+  RunScheduleUnchangedTasksTest("schedule_unchanged_tasks_10_0", 10, 0);
+  RunScheduleUnchangedTasksTest("schedule_unchanged_tasks_100_0", 100, 0);
+  RunScheduleUnchangedTasksTest("schedule_unchanged_tasks_1000_0", 1000, 0);
+  RunScheduleUnchangedTasksTest("schedule_unchanged_tasks_10_4", 10, 4);
+  RunScheduleUnchangedTasksTest("schedule_unchanged_tasks_100_4", 100, 4);
+  RunScheduleUnchangedTasksTest("schedule_unchanged_tasks_1000_4", 1000, 4);
+}
+
 }  // namespace
 
 }  // namespace cc
@@ -37,6 +37,10 @@ class TestRasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
     did_raster_ = true;
     return true;
   }
+  virtual bool RunOnOriginThread(SkDevice* device) OVERRIDE {
+    NOTREACHED();
+    return false;
+  }
   virtual void CompleteOnOriginThread() OVERRIDE {
     reply_.Run(PicturePileImpl::Analysis(), !HasFinishedRunning(), did_raster_);
   }
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "cc/resources/resource.h"
+#include "cc/resources/texture_compressor_etc1.h"
 #include "third_party/khronos/GLES2/gl2ext.h"
 
 namespace cc {
@@ -32,6 +33,8 @@ size_t Resource::BytesPerPixel(GLenum format) {
 }
 
 size_t Resource::MemorySizeBytes(gfx::Size size, GLenum format) {
+  if (format == GL_ETC1_RGB8_OES)
+    return ETC1SizeInBytes(size);
   return BytesPerPixel(format) * size.width() * size.height();
 }
 
@@ -53,6 +53,8 @@ class CC_EXPORT ResourcePool {
     return resource_count_ - unused_resources_.size();
   }
 
+  ResourceProvider* resource_provider() const { return resource_provider_; }
+
  protected:
   explicit ResourcePool(ResourceProvider* resource_provider);
 
@@ -9,11 +9,13 @@
 
 #include "base/containers/hash_tables.h"
 #include "base/debug/alias.h"
+#include "base/metrics/histogram.h"
 #include "base/stl_util.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "cc/output/gl_renderer.h"  // For the GLC() macro.
 #include "cc/resources/platform_color.h"
+#include "cc/resources/texture_compressor_etc1.h"
 #include "cc/resources/transferable_resource.h"
 #include "cc/scheduler/texture_uploader.h"
 #include "gpu/GLES2/gl2extchromium.h"
@@ -88,7 +90,8 @@ ResourceProvider::Resource::Resource()
       image_id(0),
       texture_pool(0),
       hint(TextureUsageAny),
-      type(static_cast<ResourceType>(0)) {}
+      type(static_cast<ResourceType>(0)),
+      rastered_into_image(false) {}
 
 ResourceProvider::Resource::~Resource() {}
 
@@ -120,7 +123,8 @@ ResourceProvider::Resource::Resource(
       image_id(0),
       texture_pool(texture_pool),
       hint(hint),
-      type(GLTexture) {}
+      type(GLTexture),
+      rastered_into_image(false) {}
 
 ResourceProvider::Resource::Resource(
     uint8_t* pixels, gfx::Size size, GLenum format, GLenum filter)
@@ -145,7 +149,8 @@ ResourceProvider::Resource::Resource(
       image_id(0),
       texture_pool(0),
       hint(TextureUsageAny),
-      type(Bitmap) {}
+      type(Bitmap),
+      rastered_into_image(false) {}
 
 ResourceProvider::Child::Child() {}
 
@@ -508,6 +513,7 @@ const ResourceProvider::Resource* ResourceProvider::LockForRead(ResourceId id) {
   DCHECK(resource->allocated);
 
   LazyCreate(resource);
+  RecordRasterToDrawLatency(resource);
 
   if (resource->external) {
     if (!resource->gl_id && resource->mailbox.IsTexture()) {
@@ -685,7 +691,8 @@ ResourceProvider::ResourceProvider(OutputSurface* output_surface,
       use_texture_usage_hint_(false),
       use_shallow_flush_(false),
       max_texture_size_(0),
-      best_texture_format_(0) {}
+      best_texture_format_(0),
+      best_compressed_texture_format_(0) {}
 
 void ResourceProvider::InitializeSoftware() {
   DCHECK(thread_checker_.CalledOnValidThread());
@@ -696,6 +703,7 @@ void ResourceProvider::InitializeSoftware() {
   default_resource_type_ = Bitmap;
   max_texture_size_ = INT_MAX / 2;
   best_texture_format_ = GL_RGBA;
+  best_compressed_texture_format_ = 0;
 }
 
 bool ResourceProvider::InitializeGL() {
@@ -717,6 +725,7 @@ bool ResourceProvider::InitializeGL() {
   base::SplitString(extensions_string, ' ', &extensions);
   bool use_map_sub = false;
   bool use_bgra = false;
+  bool use_etc1 = false;
   for (size_t i = 0; i < extensions.size(); ++i) {
     if (extensions[i] == "GL_EXT_texture_storage")
       use_texture_storage_ext_ = true;
@@ -728,6 +737,8 @@ bool ResourceProvider::InitializeGL() {
       use_shallow_flush_ = true;
     else if (extensions[i] == "GL_EXT_texture_format_BGRA8888")
       use_bgra = true;
+    else if (extensions[i] == "GL_OES_compressed_ETC1_RGB8_texture")
+      use_etc1 = true;
   }
 
   texture_uploader_ =
@@ -735,6 +746,7 @@ bool ResourceProvider::InitializeGL() {
   GLC(context3d, context3d->getIntegerv(GL_MAX_TEXTURE_SIZE,
                                         &max_texture_size_));
   best_texture_format_ = PlatformColor::BestTextureFormat(use_bgra);
+  best_compressed_texture_format_ = use_etc1 ? GL_ETC1_RGB8_OES : 0;
 
   return true;
 }
@@ -932,6 +944,7 @@ bool ResourceProvider::TransferResource(WebGraphicsContext3D* context,
   DCHECK(source->allocated);
   if (source->exported)
     return false;
+  RecordRasterToDrawLatency(source);
   resource->id = id;
   resource->format = source->format;
   resource->filter = source->filter;
@@ -1088,6 +1101,24 @@ void ResourceProvider::UnmapPixelBuffer(ResourceId id) {
     context3d->unmapBufferCHROMIUM(GL_PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM);
     context3d->bindBuffer(GL_PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM, 0);
   }
+
+  resource->raster_finished_time = base::TimeTicks::Now();
+  resource->rastered_into_image = false;
+}
+
+void ResourceProvider::RecordRasterToDrawLatency(Resource* resource) {
+  if (resource->raster_finished_time.is_null())
+    return;
+
+  // Pixel buffers still have to be uploaded after raster, which images
+  // don't, so the two are recorded separately.
+  base::TimeDelta latency =
+      base::TimeTicks::Now() - resource->raster_finished_time;
+  if (resource->rastered_into_image)
+    UMA_HISTOGRAM_TIMES("Renderer.RasterToDrawLatency.Image", latency);
+  else
+    UMA_HISTOGRAM_TIMES("Renderer.RasterToDrawLatency.PixelBuffer", latency);
+  resource->raster_finished_time = base::TimeTicks();
 }
 
 void ResourceProvider::BindForSampling(ResourceProvider::ResourceId resource_id,
@@ -1173,7 +1204,18 @@ void ResourceProvider::BeginSetPixels(ResourceId id) {
     context3d->beginQueryEXT(
         GL_ASYNC_PIXEL_TRANSFERS_COMPLETED_CHROMIUM,
         resource->gl_upload_query_id);
-    if (allocate) {
+    if (resource->format == GL_ETC1_RGB8_OES) {
+      // The pixel buffer holds the tile compressed in place, and compressed
+      // textures can only be uploaded whole.
+      context3d->compressedTexImage2D(GL_TEXTURE_2D,
+                                      0, /* level */
+                                      resource->format,
+                                      resource->size.width(),
+                                      resource->size.height(),
+                                      0, /* border */
+                                      ETC1SizeInBytes(resource->size),
+                                      NULL);
+    } else if (allocate) {
       context3d->asyncTexImage2DCHROMIUM(GL_TEXTURE_2D,
                                          0, /* level */
                                          resource->format,
@@ -1305,6 +1347,9 @@ void ResourceProvider::LazyAllocate(Resource* resource) {
   WebGraphicsContext3D* context3d = output_surface_->context3d();
   gfx::Size& size = resource->size;
   GLenum format = resource->format;
+  // Compressed textures are allocated by BeginSetPixels() along with their
+  // contents.
+  DCHECK_NE(static_cast<GLenum>(GL_ETC1_RGB8_OES), format);
   GLC(context3d, context3d->bindTexture(GL_TEXTURE_2D, resource->gl_id));
   if (use_texture_storage_ext_ && IsTextureFormatSupportedForStorage(format)) {
     GLenum storage_format = TextureToStorageFormat(format);
@@ -1414,6 +1459,9 @@ void ResourceProvider::UnmapImage(ResourceId id) {
     DCHECK(context3d);
     context3d->unmapImageCHROMIUM(resource->image_id);
   }
+
+  resource->raster_finished_time = base::TimeTicks::Now();
+  resource->rastered_into_image = true;
 }
 
 int ResourceProvider::GetImageStride(ResourceId id) {
@@ -15,6 +15,7 @@
 #include "base/containers/hash_tables.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/threading/thread_checker.h"
+#include "base/time/time.h"
 #include "cc/base/cc_export.h"
 #include "cc/output/context_provider.h"
 #include "cc/output/output_surface.h"
@@ -66,6 +67,11 @@ class CC_EXPORT ResourceProvider {
   WebKit::WebGraphicsContext3D* GraphicsContext3D();
   int max_texture_size() const { return max_texture_size_; }
   GLenum best_texture_format() const { return best_texture_format_; }
+  // Returns the compressed format that BeginSetPixels() can upload, or 0 if
+  // there is none.
+  GLenum best_compressed_texture_format() const {
+    return best_compressed_texture_format_;
+  }
   size_t num_resources() const { return resources_.size(); }
 
   // Checks whether a resource is in use by a consumer.
@@ -371,6 +377,12 @@ class CC_EXPORT ResourceProvider {
     GLenum texture_pool;
     TextureUsageHint hint;
     ResourceType type;
+    // When raster last finished writing the pixels, until they are first
+    // drawn. Null otherwise.
+    base::TimeTicks raster_finished_time;
+    // Whether the pixels were rastered straight into the image, rather than
+    // into a pixel buffer that still had to be uploaded.
+    bool rastered_into_image;
   };
   typedef base::hash_map<ResourceId, Resource> ResourceMap;
   struct Child {
@@ -393,6 +405,8 @@ class CC_EXPORT ResourceProvider {
   void CleanUpGLIfNeeded();
 
   const Resource* LockForRead(ResourceId id);
+  // Records how long it took from raster to the first draw of |resource|.
+  void RecordRasterToDrawLatency(Resource* resource);
   void UnlockForRead(ResourceId id);
   const Resource* LockForWrite(ResourceId id);
   void UnlockForWrite(ResourceId id);
@@ -436,6 +450,7 @@ class CC_EXPORT ResourceProvider {
   scoped_ptr<TextureUploader> texture_uploader_;
   int max_texture_size_;
   GLenum best_texture_format_;
+  GLenum best_compressed_texture_format_;
 
   scoped_refptr<cc::ContextProvider> offscreen_context_provider_;
 
@@ -0,0 +1,276 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/resources/texture_compressor_etc1.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "base/logging.h"
+#include "third_party/skia/include/core/SkColorPriv.h"
+
+namespace cc {
+
+namespace {
+
+const int kBlockSize = 4;
+const int kPixelsPerBlock = kBlockSize * kBlockSize;
+const size_t kBytesPerBlock = 8;
+
+// The small and the large intensity modifier of each of the ETC1 codeword
+// tables. Pixels can also use the negated modifiers.
+const int kModifierTables[8][2] = {
+  { 2, 8 },
+  { 5, 17 },
+  { 9, 29 },
+  { 13, 42 },
+  { 18, 60 },
+  { 24, 80 },
+  { 33, 106 },
+  { 47, 183 }
+};
+
+struct Color {
+  int r;
+  int g;
+  int b;
+};
+
+int Clamp(int value) {
+  return std::min(std::max(value, 0), 255);
+}
+
+// Base colors are stored with 4 or 5 bits per channel, and are expanded to 8
+// bits by repeating their high bits.
+int Quantize(int value, int max) {
+  return (value * max + 127) / 255;
+}
+
+int Expand4(int value) {
+  return (value << 4) | value;
+}
+
+int Expand5(int value) {
+  return (value << 3) | (value >> 2);
+}
+
+// Pixels are stored column by column, the order of the pixel indices of a
+// block. A selector picks one of the four modifiers of a table: 0 and 1 are
+// the small and the large one, 2 and 3 their negations.
+int PixelIndex(int x, int y) {
+  return x * kBlockSize + y;
+}
+
+int Modifier(int table, int selector) {
+  int modifier = kModifierTables[table][selector & 1];
+  return selector & 2 ? -modifier : modifier;
+}
+
+// A block is split into two subblocks of 2x4 pixels side by side, or of 4x2
+// pixels on top of each other if the block is flipped.
+bool IsInSubblock(int index, bool flip, int subblock) {
+  int x = index / kBlockSize;
+  int y = index % kBlockSize;
+  return ((flip ? y : x) >= kBlockSize / 2) == (subblock == 1);
+}
+
+Color AverageOfSubblock(const Color* pixels, bool flip, int subblock) {
+  Color sum = { 0, 0, 0 };
+  for (int i = 0; i < kPixelsPerBlock; ++i) {
+    if (!IsInSubblock(i, flip, subblock))
+      continue;
+    sum.r += pixels[i].r;
+    sum.g += pixels[i].g;
+    sum.b += pixels[i].b;
+  }
+  const int count = kPixelsPerBlock / 2;
+  Color average = { (sum.r + count / 2) / count,
+                    (sum.g + count / 2) / count,
+                    (sum.b + count / 2) / count };
+  return average;
+}
+
+// Picks the table, and the selector of each pixel, that best fit the pixels
+// of a subblock with color |base|. Returns the squared error.
+int EncodeSubblock(const Color* pixels,
+                   bool flip,
+                   int subblock,
+                   const Color& base,
+                   int* best_table,
+                   int* selectors) {
+  // A modifier moves all channels by the same amount, so the best one for a
+  // pixel is, short of clamping, the one closest to the pixel's average
+  // distance from the base color. That is much cheaper than trying all four.
+  int offsets[kPixelsPerBlock];
+  for (int i = 0; i < kPixelsPerBlock; ++i) {
+    offsets[i] = pixels[i].r + pixels[i].g + pixels[i].b -
+                 base.r - base.g - base.b;
+  }
+
+  int best_error = std::numeric_limits<int>::max();
+  for (int table = 0; table < 8; ++table) {
+    // Three times the midpoint between the small and the large modifier.
+    int threshold =
+        3 * (kModifierTables[table][0] + kModifierTables[table][1]) / 2;
+    int table_selectors[kPixelsPerBlock];
+    int error = 0;
+    for (int i = 0; i < kPixelsPerBlock && error < best_error; ++i) {
+      if (!IsInSubblock(i, flip, subblock))
+        continue;
+      int selector = offsets[i] < 0 ? 2 : 0;
+      if (abs(offsets[i]) > threshold)
+        selector |= 1;
+      int modifier = Modifier(table, selector);
+      int dr = Clamp(base.r + modifier) - pixels[i].r;
+      int dg = Clamp(base.g + modifier) - pixels[i].g;
+      int db = Clamp(base.b + modifier) - pixels[i].b;
+      error += dr * dr + dg * dg + db * db;
+      table_selectors[i] = selector;
+    }
+    if (error >= best_error)
+      continue;
+    best_error = error;
+    *best_table = table;
+    for (int i = 0; i < kPixelsPerBlock; ++i) {
+      if (IsInSubblock(i, flip, subblock))
+        selectors[i] = table_selectors[i];
+    }
+  }
+  return best_error;
+}
+
+uint64 PackBlock(bool differential,
+                 bool flip,
+                 const Color* base,
+                 const int* tables,
+                 const int* selectors) {
+  uint64 bits = 0;
+  if (differential) {
+    bits |= static_cast<uint64>(base[0].r) << 59;
+    bits |= static_cast<uint64>((base[1].r - base[0].r) & 7) << 56;
+    bits |= static_cast<uint64>(base[0].g) << 51;
+    bits |= static_cast<uint64>((base[1].g - base[0].g) & 7) << 48;
+    bits |= static_cast<uint64>(base[0].b) << 43;
+    bits |= static_cast<uint64>((base[1].b - base[0].b) & 7) << 40;
+    bits |= static_cast<uint64>(1) << 33;
+  } else {
+    bits |= static_cast<uint64>(base[0].r) << 60;
+    bits |= static_cast<uint64>(base[1].r) << 56;
+    bits |= static_cast<uint64>(base[0].g) << 52;
+    bits |= static_cast<uint64>(base[1].g) << 48;
+    bits |= static_cast<uint64>(base[0].b) << 44;
+    bits |= static_cast<uint64>(base[1].b) << 40;
+  }
+  bits |= static_cast<uint64>(tables[0]) << 37;
+  bits |= static_cast<uint64>(tables[1]) << 34;
+  if (flip)
+    bits |= static_cast<uint64>(1) << 32;
+
+  // The high bits of all the selectors come first, then the low bits.
+  for (int i = 0; i < kPixelsPerBlock; ++i) {
+    bits |= static_cast<uint64>(selectors[i] >> 1) << (i + 16);
+    bits |= static_cast<uint64>(selectors[i] & 1) << i;
+  }
+  return bits;
+}
+
+// Tries both subblock layouts, and keeps the encoding with the smallest
+// error. Differential base colors have more precision, but must be close to
+// each other; individual base colors are only used when they aren't.
+uint64 EncodeBlock(const Color* pixels) {
+  int best_error = std::numeric_limits<int>::max();
+  uint64 best_bits = 0;
+  for (int flip = 0; flip < 2; ++flip) {
+    Color average[2] = { AverageOfSubblock(pixels, flip, 0),
+                         AverageOfSubblock(pixels, flip, 1) };
+
+    for (int differential = 1; differential >= 0; --differential) {
+      int max = differential ? 31 : 15;
+      Color base[2];
+      Color expanded[2];
+      for (int subblock = 0; subblock < 2; ++subblock) {
+        base[subblock].r = Quantize(average[subblock].r, max);
+        base[subblock].g = Quantize(average[subblock].g, max);
+        base[subblock].b = Quantize(average[subblock].b, max);
+        int (*expand)(int) = differential ? Expand5 : Expand4;
+        expanded[subblock].r = expand(base[subblock].r);
+        expanded[subblock].g = expand(base[subblock].g);
+        expanded[subblock].b = expand(base[subblock].b);
+      }
+      if (differential) {
+        int dr = base[1].r - base[0].r;
+        int dg = base[1].g - base[0].g;
+        int db = base[1].b - base[0].b;
+        if (std::min(dr, std::min(dg, db)) < -4 ||
+            std::max(dr, std::max(dg, db)) > 3) {
+          continue;
+        }
+      }
+
+      int tables[2];
+      int selectors[kPixelsPerBlock];
+      int error = 0;
+      for (int subblock = 0; subblock < 2; ++subblock) {
+        error += EncodeSubblock(pixels,
+                                flip,
+                                subblock,
+                                expanded[subblock],
+                                &tables[subblock],
+                                selectors);
+      }
+      if (error < best_error) {
+        best_error = error;
+        best_bits = PackBlock(differential, flip, base, tables, selectors);
+      }
+      break;
+    }
+  }
+  return best_bits;
+}
+
+}  // namespace
+
+size_t ETC1SizeInBytes(gfx::Size size) {
+  size_t blocks_wide = (size.width() + kBlockSize - 1) / kBlockSize;
+  size_t blocks_high = (size.height() + kBlockSize - 1) / kBlockSize;
+  return blocks_wide * blocks_high * kBytesPerBlock;
+}
+
+void CompressToETC1(const uint8_t* pixels, gfx::Size size, uint8_t* output) {
+  DCHECK(!size.IsEmpty());
+
+  const int width = size.width();
+  const int height = size.height();
+  for (int block_y = 0; block_y < height; block_y += kBlockSize) {
+    for (int block_x = 0; block_x < width; block_x += kBlockSize) {
+      // Partial blocks repeat the last row and column of the texture.
+      Color block[kPixelsPerBlock];
+      for (int y = 0; y < kBlockSize; ++y) {
+        int pixel_y = std::min(block_y + y, height - 1);
+        for (int x = 0; x < kBlockSize; ++x) {
+          int pixel_x = std::min(block_x + x, width - 1);
+          uint32_t pixel;
+          memcpy(&pixel,
+                 pixels + 4 * (pixel_y * width + pixel_x),
+                 sizeof(pixel));
+          Color& color = block[PixelIndex(x, y)];
+          color.r = SkGetPackedR32(pixel);
+          color.g = SkGetPackedG32(pixel);
+          color.b = SkGetPackedB32(pixel);
+        }
+      }
+
+      // Blocks are stored as big-endian 64-bit words.
+      uint64 bits = EncodeBlock(block);
+      for (size_t i = 0; i < kBytesPerBlock; ++i)
+        output[i] = static_cast<uint8_t>(bits >> (56 - 8 * i));
+      output += kBytesPerBlock;
+    }
+  }
+}
+
+}  // namespace cc
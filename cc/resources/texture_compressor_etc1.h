@@ -0,0 +1,30 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_RESOURCES_TEXTURE_COMPRESSOR_ETC1_H_
+#define CC_RESOURCES_TEXTURE_COMPRESSOR_ETC1_H_
+
+#include "base/basictypes.h"
+#include "cc/base/cc_export.h"
+#include "ui/gfx/size.h"
+
+namespace cc {
+
+// Returns the number of bytes of an ETC1 texture of |size|. Every block of
+// 4x4 pixels, including the partial ones at the right and bottom edges, takes
+// 8 bytes.
+CC_EXPORT size_t ETC1SizeInBytes(gfx::Size size);
+
+// Compresses the pixels of |size| at |pixels|, in Skia's 32-bit color format,
+// into an ETC1 texture at |output|. ETC1 has no alpha, so the pixels should
+// be opaque. |output| may be |pixels|: each block is read before it's written,
+// and the compressed data never overtakes the pixels that are still to be
+// read.
+CC_EXPORT void CompressToETC1(const uint8_t* pixels,
+                              gfx::Size size,
+                              uint8_t* output);
+
+}  // namespace cc
+
+#endif  // CC_RESOURCES_TEXTURE_COMPRESSOR_ETC1_H_
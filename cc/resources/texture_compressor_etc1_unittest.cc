@@ -0,0 +1,199 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/resources/texture_compressor_etc1.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkColorPriv.h"
+
+namespace cc {
+namespace {
+
+struct RGB {
+  int r;
+  int g;
+  int b;
+};
+
+// Decodes pixel (x, y) of an ETC1 texture of |size| the way the GPU does.
+RGB DecodePixel(const std::vector<uint8_t>& data,
+                gfx::Size size,
+                int x,
+                int y) {
+  static const int kModifierTables[8][2] = {
+    { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 },
+    { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+  };
+
+  int blocks_wide = (size.width() + 3) / 4;
+  size_t offset = 8 * ((y / 4) * blocks_wide + x / 4);
+  uint64 bits = 0;
+  for (int i = 0; i < 8; ++i)
+    bits = (bits << 8) | data[offset + i];
+
+  int block_x = x % 4;
+  int block_y = y % 4;
+  bool flip = (bits >> 32) & 1;
+  int subblock = (flip ? block_y : block_x) >= 2;
+
+  int base[3];
+  for (int channel = 0; channel < 3; ++channel) {
+    int shift = 56 - 8 * channel;
+    if ((bits >> 33) & 1) {
+      int value = (bits >> (shift + 3)) & 31;
+      if (subblock) {
+        int delta = (bits >> shift) & 7;
+        value += delta >= 4 ? delta - 8 : delta;
+      }
+      base[channel] = (value << 3) | (value >> 2);
+    } else {
+      int value = (bits >> (subblock ? shift : shift + 4)) & 15;
+      base[channel] = (value << 4) | value;
+    }
+  }
+
+  int table = (bits >> (subblock ? 34 : 37)) & 7;
+  int index = block_x * 4 + block_y;
+  int msb = (bits >> (index + 16)) & 1;
+  int lsb = (bits >> index) & 1;
+  int modifier = kModifierTables[table][lsb];
+  if (msb)
+    modifier = -modifier;
+
+  RGB rgb;
+  rgb.r = std::min(std::max(base[0] + modifier, 0), 255);
+  rgb.g = std::min(std::max(base[1] + modifier, 0), 255);
+  rgb.b = std::min(std::max(base[2] + modifier, 0), 255);
+  return rgb;
+}
+
+class ETC1Image {
+ public:
+  explicit ETC1Image(gfx::Size size)
+      : size_(size),
+        pixels_(4 * size.GetArea()) {}
+
+  void SetPixel(int x, int y, int r, int g, int b) {
+    uint32_t pixel = SkPackARGB32(255, r, g, b);
+    memcpy(&pixels_[4 * (y * size_.width() + x)], &pixel, sizeof(pixel));
+  }
+
+  RGB GetPixel(int x, int y) const {
+    uint32_t pixel;
+    memcpy(&pixel, &pixels_[4 * (y * size_.width() + x)], sizeof(pixel));
+    RGB rgb;
+    rgb.r = SkGetPackedR32(pixel);
+    rgb.g = SkGetPackedG32(pixel);
+    rgb.b = SkGetPackedB32(pixel);
+    return rgb;
+  }
+
+  // Returns the largest difference in any channel of any pixel between the
+  // image and its compressed version.
+  int MaxError() const {
+    std::vector<uint8_t> compressed(ETC1SizeInBytes(size_));
+    CompressToETC1(&pixels_[0], size_, &compressed[0]);
+
+    int max_error = 0;
+    for (int y = 0; y < size_.height(); ++y) {
+      for (int x = 0; x < size_.width(); ++x) {
+        RGB expected = GetPixel(x, y);
+        RGB actual = DecodePixel(compressed, size_, x, y);
+        max_error = std::max(max_error, abs(expected.r - actual.r));
+        max_error = std::max(max_error, abs(expected.g - actual.g));
+        max_error = std::max(max_error, abs(expected.b - actual.b));
+      }
+    }
+    return max_error;
+  }
+
+  const std::vector<uint8_t>& pixels() const { return pixels_; }
+
+ private:
+  gfx::Size size_;
+  std::vector<uint8_t> pixels_;
+};
+
+TEST(TextureCompressorETC1Test, SizeInBytes) {
+  EXPECT_EQ(8u, ETC1SizeInBytes(gfx::Size(1, 1)));
+  EXPECT_EQ(8u, ETC1SizeInBytes(gfx::Size(4, 4)));
+  EXPECT_EQ(32u, ETC1SizeInBytes(gfx::Size(5, 5)));
+  EXPECT_EQ(32768u, ETC1SizeInBytes(gfx::Size(256, 256)));
+}
+
+TEST(TextureCompressorETC1Test, SolidColor) {
+  const int kColors[][3] = {
+    { 0, 0, 0 }, { 255, 255, 255 }, { 255, 0, 0 }, { 30, 140, 200 }
+  };
+  for (size_t i = 0; i < arraysize(kColors); ++i) {
+    ETC1Image image(gfx::Size(8, 8));
+    for (int y = 0; y < 8; ++y) {
+      for (int x = 0; x < 8; ++x)
+        image.SetPixel(x, y, kColors[i][0], kColors[i][1], kColors[i][2]);
+    }
+    EXPECT_LE(image.MaxError(), 6) << "color " << i;
+  }
+}
+
+TEST(TextureCompressorETC1Test, Gradients) {
+  ETC1Image horizontal(gfx::Size(16, 16));
+  ETC1Image vertical(gfx::Size(16, 16));
+  for (int y = 0; y < 16; ++y) {
+    for (int x = 0; x < 16; ++x) {
+      horizontal.SetPixel(x, y, x * 16, 128, 255 - x * 16);
+      vertical.SetPixel(x, y, 64, y * 16, y * 8);
+    }
+  }
+  EXPECT_LE(horizontal.MaxError(), 16);
+  EXPECT_LE(vertical.MaxError(), 16);
+}
+
+// Subblocks of very different colors still get their own base color.
+TEST(TextureCompressorETC1Test, TwoColors) {
+  ETC1Image side_by_side(gfx::Size(4, 4));
+  ETC1Image on_top(gfx::Size(4, 4));
+  for (int y = 0; y < 4; ++y) {
+    for (int x = 0; x < 4; ++x) {
+      side_by_side.SetPixel(x, y, x < 2 ? 255 : 0, 0, x < 2 ? 0 : 255);
+      on_top.SetPixel(x, y, 0, y < 2 ? 255 : 0, 0);
+    }
+  }
+  EXPECT_LE(side_by_side.MaxError(), 6);
+  EXPECT_LE(on_top.MaxError(), 6);
+}
+
+TEST(TextureCompressorETC1Test, PartialBlocks) {
+  gfx::Size size(6, 3);
+  ETC1Image image(size);
+  for (int y = 0; y < size.height(); ++y) {
+    for (int x = 0; x < size.width(); ++x)
+      image.SetPixel(x, y, 200, 100, x < 4 ? 50 : 0);
+  }
+  EXPECT_LE(image.MaxError(), 6);
+}
+
+TEST(TextureCompressorETC1Test, InPlace) {
+  gfx::Size size(13, 9);
+  ETC1Image image(size);
+  for (int y = 0; y < size.height(); ++y) {
+    for (int x = 0; x < size.width(); ++x)
+      image.SetPixel(x, y, x * 19, y * 27, (x * y * 7) & 255);
+  }
+
+  std::vector<uint8_t> expected(ETC1SizeInBytes(size));
+  CompressToETC1(&image.pixels()[0], size, &expected[0]);
+
+  std::vector<uint8_t> buffer(image.pixels());
+  CompressToETC1(&buffer[0], size, &buffer[0]);
+  EXPECT_EQ(0, memcmp(&expected[0], &buffer[0], expected.size()));
+}
+
+}  // namespace
+}  // namespace cc
@@ -126,10 +126,6 @@ class CC_EXPORT Tile : public base::RefCounted<Tile> {
   ManagedTileState& managed_state() { return managed_state_; }
   const ManagedTileState& managed_state() const { return managed_state_; }
 
-  inline size_t bytes_consumed_if_allocated() const {
-    return 4 * tile_size_.width() * tile_size_.height();
-  }
-
   // Normal private methods.
   friend class base::RefCounted<Tile>;
   ~Tile();
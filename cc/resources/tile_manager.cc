@@ -14,8 +14,10 @@
 #include "base/metrics/histogram.h"
 #include "cc/debug/devtools_instrumentation.h"
 #include "cc/debug/traced_value.h"
+#include "cc/output/context_provider.h"
 #include "cc/resources/image_raster_worker_pool.h"
 #include "cc/resources/pixel_buffer_raster_worker_pool.h"
+#include "cc/resources/resource_provider.h"
 #include "cc/resources/tile.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "ui/gfx/rect_conversions.h"
@@ -120,7 +122,22 @@ scoped_ptr<TileManager> TileManager::Create(
     ResourceProvider* resource_provider,
     size_t num_raster_threads,
     RenderingStatsInstrumentation* rendering_stats_instrumentation,
-    bool use_map_image) {
+    bool use_map_image,
+    bool use_compressed_textures,
+    bool use_gpu_rasterization) {
+  // Compressed tiles are rasterized into a pixel buffer and compressed in
+  // place before the upload, which images mapped straight into the texture
+  // don't allow.
+  GLenum compressed_texture_format = 0;
+  if (use_compressed_textures && !use_map_image) {
+    compressed_texture_format =
+        resource_provider->best_compressed_texture_format();
+  }
+  // GPU rasterized tiles skip the pixel buffer, and are drawn straight into
+  // the texture on the compositor thread.
+  use_gpu_rasterization &=
+      !use_map_image &&
+      resource_provider->default_resource_type() == ResourceProvider::GLTexture;
   return make_scoped_ptr(
       new TileManager(client,
                       resource_provider,
@@ -131,7 +148,9 @@ scoped_ptr<TileManager> TileManager::Create(
                           resource_provider, num_raster_threads),
                       num_raster_threads,
                       rendering_stats_instrumentation,
-                      resource_provider->best_texture_format()));
+                      resource_provider->best_texture_format(),
+                      compressed_texture_format,
+                      use_gpu_rasterization));
 }
 
 TileManager::TileManager(
@@ -140,7 +159,9 @@ TileManager::TileManager(
     scoped_ptr<RasterWorkerPool> raster_worker_pool,
     size_t num_raster_threads,
     RenderingStatsInstrumentation* rendering_stats_instrumentation,
-    GLenum texture_format)
+    GLenum texture_format,
+    GLenum compressed_texture_format,
+    bool use_gpu_rasterization)
     : client_(client),
       resource_pool_(ResourcePool::Create(resource_provider)),
       raster_worker_pool_(raster_worker_pool.Pass()),
@@ -150,7 +171,9 @@ TileManager::TileManager(
       ever_exceeded_memory_budget_(false),
       rendering_stats_instrumentation_(rendering_stats_instrumentation),
       did_initialize_visible_tile_(false),
-      texture_format_(texture_format) {
+      texture_format_(texture_format),
+      compressed_texture_format_(compressed_texture_format),
+      use_gpu_rasterization_(use_gpu_rasterization) {
   raster_worker_pool_->SetClient(this);
 }
 
@@ -159,8 +182,6 @@ TileManager::~TileManager() {
   // our memory usage to drop to zero.
   global_state_ = GlobalStateThatImpactsTilePriority();
 
-  // Clear |prioritized_tiles_| so that tiles kept alive by it can be freed.
-  prioritized_tiles_.Clear();
   DCHECK_EQ(0u, tiles_.size());
 
   TileVector empty;
@@ -190,6 +211,7 @@ void TileManager::RegisterTile(Tile* tile) {
 
 void TileManager::UnregisterTile(Tile* tile) {
   FreeResourcesForTile(tile);
+  prioritized_tiles_.RemoveTile(tile);
 
   DCHECK(tiles_.find(tile->id()) != tiles_.end());
   tiles_.erase(tile->id());
@@ -326,6 +348,7 @@ void TileManager::GetTilesWithAssignedBins(PrioritizedTileSet* tiles) {
 
     if (mts.is_in_never_bin_on_both_trees()) {
       FreeResourcesForTile(tile);
+      tiles->RemoveTile(tile);
       continue;
     }
 
@@ -338,7 +361,8 @@ void TileManager::GetTilesWithAssignedBins(PrioritizedTileSet* tiles) {
                                   ? NOW_AND_READY_TO_DRAW_BIN
                                   : mts.bin[HIGH_PRIORITY_BIN];
 
-    // Insert the tile into a priority set.
+    // Insert the tile into a priority set, or move it within the set if its
+    // priority changed since the last time.
     tiles->InsertTile(tile, priority_bin);
   }
 }
@@ -353,9 +377,8 @@ void TileManager::GetPrioritizedTileSet(PrioritizedTileSet* tiles) {
 void TileManager::ManageTiles() {
   TRACE_EVENT0("cc", "TileManager::ManageTiles");
 
-  // Clear |prioritized_tiles_| so that tiles kept alive by it can be freed.
-  prioritized_tiles_.Clear();
-
+  // |prioritized_tiles_| is kept from the last time, so that only tiles whose
+  // priority changed need to be moved.
   GetPrioritizedTileSet(&prioritized_tiles_);
 
   TileVector tiles_that_need_to_be_rasterized;
@@ -407,7 +430,7 @@ void TileManager::GetMemoryStats(
         !tile_version.requires_resource())
       continue;
 
-    size_t tile_bytes = tile->bytes_consumed_if_allocated();
+    size_t tile_bytes = BytesConsumedIfAllocated(tile, mts.raster_mode);
     if ((mts.gpu_memmgr_stats_bin == NOW_BIN) ||
         (mts.gpu_memmgr_stats_bin == NOW_AND_READY_TO_DRAW_BIN))
       *memory_required_bytes += tile_bytes;
@@ -461,6 +484,8 @@ RasterMode TileManager::DetermineRasterMode(const Tile* tile) const {
   RasterMode raster_mode = HIGH_QUALITY_RASTER_MODE;
   if (tile->managed_state().resolution == LOW_RESOLUTION)
     raster_mode = LOW_QUALITY_RASTER_MODE;
+  else if (CanCompressTile(tile))
+    raster_mode = COMPRESSED_RASTER_MODE;
   else if (tile->can_use_lcd_text())
     raster_mode = HIGH_QUALITY_RASTER_MODE;
   else if (mts.tile_versions[current_mode].has_text_ ||
@@ -470,6 +495,47 @@ RasterMode TileManager::DetermineRasterMode(const Tile* tile) const {
   return std::min(raster_mode, current_mode);
 }
 
+bool TileManager::CanCompressTile(const Tile* tile) const {
+  if (!compressed_texture_format_)
+    return false;
+
+  // Only tiles that are a while away from being needed are worth the loss
+  // in quality. The compressed format has no alpha, so the tile must also
+  // be opaque.
+  const ManagedTileState& mts = tile->managed_state();
+  return !mts.required_for_activation &&
+         mts.bin[HIGH_PRIORITY_BIN] >= EVENTUALLY_AND_ACTIVE_BIN &&
+         tile->opaque_rect().Contains(tile->content_rect());
+}
+
+bool TileManager::CanRasterizeOnGpu(RasterMode mode) const {
+  if (!use_gpu_rasterization_)
+    return false;
+
+  // Compressed tiles are uploaded from the pixel buffer. A task that finds
+  // no offscreen context when it completes is canceled, so only ask for GPU
+  // rasterization while there is one.
+  ContextProvider* offscreen_contexts =
+      resource_pool_->resource_provider()->offscreen_context_provider();
+  return mode != COMPRESSED_RASTER_MODE &&
+         offscreen_contexts &&
+         offscreen_contexts->GrContext();
+}
+
+GLenum TileManager::TextureFormatForRasterMode(RasterMode mode) const {
+  if (mode == COMPRESSED_RASTER_MODE) {
+    DCHECK(compressed_texture_format_);
+    return compressed_texture_format_;
+  }
+  return texture_format_;
+}
+
+size_t TileManager::BytesConsumedIfAllocated(const Tile* tile,
+                                             RasterMode mode) const {
+  return Resource::MemorySizeBytes(tile->tile_size_.size(),
+                                   TextureFormatForRasterMode(mode));
+}
+
 void TileManager::AssignGpuMemoryToTiles(
     PrioritizedTileSet* tiles,
     TileVector* tiles_that_need_to_be_rasterized) {
@@ -486,7 +552,7 @@ void TileManager::AssignGpuMemoryToTiles(
     const ManagedTileState& mts = tile->managed_state();
     for (int mode = 0; mode < NUM_RASTER_MODES; ++mode) {
       if (mts.tile_versions[mode].resource_) {
-        bytes_releasable += tile->bytes_consumed_if_allocated();
+        bytes_releasable += mts.tile_versions[mode].resource_->bytes();
         resources_releasable++;
       }
     }
@@ -545,7 +611,7 @@ void TileManager::AssignGpuMemoryToTiles(
     // It costs to maintain a resource.
     for (int mode = 0; mode < NUM_RASTER_MODES; ++mode) {
       if (mts.tile_versions[mode].resource_) {
-        tile_bytes += tile->bytes_consumed_if_allocated();
+        tile_bytes += mts.tile_versions[mode].resource_->bytes();
         tile_resources++;
       }
     }
@@ -557,7 +623,7 @@ void TileManager::AssignGpuMemoryToTiles(
       // If we don't have the required version, and it's not in flight
       // then we'll have to pay to create a new task.
       if (!tile_version.resource_ && tile_version.raster_task_.is_null()) {
-        tile_bytes += tile->bytes_consumed_if_allocated();
+        tile_bytes += BytesConsumedIfAllocated(tile, mts.raster_mode);
         tile_resources++;
       }
     }
@@ -727,8 +793,9 @@ RasterWorkerPool::RasterTask TileManager::CreateRasterTask(Tile* tile) {
   ManagedTileState& mts = tile->managed_state();
 
   scoped_ptr<ResourcePool::Resource> resource =
-      resource_pool_->AcquireResource(tile->tile_size_.size(),
-                                      texture_format_);
+      resource_pool_->AcquireResource(
+          tile->tile_size_.size(),
+          TextureFormatForRasterMode(mts.raster_mode));
   const Resource* const_resource = resource.get();
 
   // Create and queue all image decode tasks that this tile depends on.
@@ -761,6 +828,7 @@ RasterWorkerPool::RasterTask TileManager::CreateRasterTask(Tile* tile) {
       tile->content_rect(),
       tile->contents_scale(),
       mts.raster_mode,
+      CanRasterizeOnGpu(mts.raster_mode),
       mts.tree_bin[PENDING_TREE] == NOW_BIN,
       mts.resolution,
       tile->layer_id(),
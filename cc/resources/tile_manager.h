@@ -52,7 +52,9 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient {
       ResourceProvider* resource_provider,
       size_t num_raster_threads,
       RenderingStatsInstrumentation* rendering_stats_instrumentation,
-      bool use_map_image);
+      bool use_map_image,
+      bool use_compressed_textures,
+      bool use_gpu_rasterization);
   virtual ~TileManager();
 
   const GlobalStateThatImpactsTilePriority& GlobalState() const {
@@ -85,7 +87,9 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient {
               scoped_ptr<RasterWorkerPool> raster_worker_pool,
               size_t num_raster_threads,
               RenderingStatsInstrumentation* rendering_stats_instrumentation,
-              GLenum texture_format);
+              GLenum texture_format,
+              GLenum compressed_texture_format,
+              bool use_gpu_rasterization);
 
   // Methods called by Tile
   friend class Tile;
@@ -124,6 +128,10 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient {
       bool was_canceled);
 
   RasterMode DetermineRasterMode(const Tile* tile) const;
+  bool CanCompressTile(const Tile* tile) const;
+  bool CanRasterizeOnGpu(RasterMode mode) const;
+  GLenum TextureFormatForRasterMode(RasterMode mode) const;
+  size_t BytesConsumedIfAllocated(const Tile* tile, RasterMode mode) const;
   void CleanUpUnusedImageDecodeTasks();
   void FreeResourceForTile(Tile* tile, RasterMode mode);
   void FreeResourcesForTile(Tile* tile);
@@ -156,6 +164,12 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient {
 
   GLenum texture_format_;
 
+  // The format of tiles in COMPRESSED_RASTER_MODE, or 0 if tiles aren't
+  // compressed.
+  GLenum compressed_texture_format_;
+
+  bool use_gpu_rasterization_;
+
   typedef base::hash_map<uint32_t, RasterWorkerPool::Task> PixelRefTaskMap;
   typedef base::hash_map<int, PixelRefTaskMap> LayerPixelRefTaskMap;
   LayerPixelRefTaskMap image_decode_tasks_;
@@ -117,6 +117,37 @@ class TileManagerPerfTest : public testing::Test {
     AfterTest(test_name);
   }
 
+  // Like RunManageTilesTest, but |changed_tile_count| tiles get a new
+  // priority before each run, the way tiles move in and out of the viewport
+  // during a fling.
+  void RunManageTilesWithChangesTest(const std::string test_name,
+                                     unsigned tile_count,
+                                     unsigned changed_tile_count) {
+    start_time_ = base::TimeTicks();
+    num_runs_ = 0;
+    TileVector tiles;
+    CreateTiles(tile_count, &tiles);
+    TilePriority priorities[] = {
+      TilePriorityForNowBin(),
+      TilePriorityForSoonBin(),
+      TilePriorityForEventualBin(),
+      TilePriority()
+    };
+    size_t next_tile = 0;
+    do {
+      for (unsigned i = 0; i < changed_tile_count; ++i) {
+        const TilePriority& priority =
+            priorities[(next_tile + num_runs_) % arraysize(priorities)];
+        tiles[next_tile]->SetPriority(ACTIVE_TREE, priority);
+        tiles[next_tile]->SetPriority(PENDING_TREE, priority);
+        next_tile = (next_tile + 1) % tiles.size();
+      }
+      tile_manager_->ManageTiles();
+    } while (DidRun());
+
+    AfterTest(test_name);
+  }
+
  private:
   FakeTileManagerClient tile_manager_client_;
   LayerTreeSettings settings_;
@@ -136,6 +167,14 @@ TEST_F(TileManagerPerfTest, ManageTiles) {
   RunManageTilesTest("manage_tiles_10000", 10000);
 }
 
+TEST_F(TileManagerPerfTest, ManageTilesWithChanges) {
+  RunManageTilesWithChangesTest("manage_tiles_10000_changed_10", 10000, 10);
+  RunManageTilesWithChangesTest("manage_tiles_10000_changed_100", 10000, 100);
+  RunManageTilesWithChangesTest("manage_tiles_10000_changed_1000",
+                                10000,
+                                1000);
+}
+
 }  // namespace
 
 }  // namespace cc
@@ -5,7 +5,6 @@
 #include "cc/resources/worker_pool.h"
 
 #include <algorithm>
-#include <queue>
 
 #include "base/bind.h"
 #include "base/containers/hash_tables.h"
@@ -111,6 +110,22 @@ class WorkerPool::Inner : public base::DelegateSimpleThread::Delegate {
     }
   };
 
+  // Ordered set of tasks that are ready to run, kept as a heap with the
+  // next task to run at the front.
+  typedef std::vector<internal::GraphNode*> TaskQueue;
+
+  static void PushTask(TaskQueue* queue, internal::GraphNode* node);
+  static internal::GraphNode* PopTask(TaskQueue* queue);
+
+  // Returns true if the front of |a| should run before the front of |b|.
+  // Empty queues come last.
+  static bool RunsBefore(const TaskQueue& a, const TaskQueue& b);
+
+  // Takes the next task for the worker with |thread_index| to run, or returns
+  // NULL if no task is ready. The worker's own queue wins ties, and when the
+  // worker has nothing else to do it steals the best task of another worker.
+  internal::GraphNode* TakeReadyToRunTask(unsigned thread_index);
+
   // Overridden from base::DelegateSimpleThread:
   virtual void Run() OVERRIDE;
 
@@ -134,12 +149,16 @@ class WorkerPool::Inner : public base::DelegateSimpleThread::Delegate {
   // This set contains all pending tasks.
   GraphNodeMap pending_tasks_;
 
-  // Ordered set of tasks that are ready to run.
-  typedef std::priority_queue<internal::GraphNode*,
-                              std::vector<internal::GraphNode*>,
-                              PriorityComparator> TaskQueue;
+  // Tasks that are ready to run and not yet claimed by a worker.
   TaskQueue ready_to_run_tasks_;
 
+  // Tasks that became ready when a worker finished one of their
+  // dependencies, indexed by that worker's thread index. The worker runs
+  // them next unless something more important shows up, so that e.g. a
+  // raster task runs on the thread that decoded its images. Idle workers
+  // steal from the other queues.
+  std::vector<TaskQueue> worker_ready_to_run_tasks_;
+
   // This set contains all currently running tasks.
   GraphNodeMap running_tasks_;
 
@@ -156,7 +175,8 @@ WorkerPool::Inner::Inner(
     : lock_(),
       has_ready_to_run_tasks_cv_(&lock_),
       next_thread_index_(0),
-      shutdown_(false) {
+      shutdown_(false),
+      worker_ready_to_run_tasks_(num_threads) {
   base::AutoLock lock(lock_);
 
   while (workers_.size() < num_threads) {
@@ -182,6 +202,8 @@ WorkerPool::Inner::~Inner() {
 
   DCHECK_EQ(0u, pending_tasks_.size());
   DCHECK_EQ(0u, ready_to_run_tasks_.size());
+  for (size_t i = 0; i < worker_ready_to_run_tasks_.size(); ++i)
+    DCHECK_EQ(0u, worker_ready_to_run_tasks_[i].size());
   DCHECK_EQ(0u, running_tasks_.size());
   DCHECK_EQ(0u, completed_tasks_.size());
 }
@@ -214,6 +236,8 @@ void WorkerPool::Inner::SetTaskGraph(TaskGraph* graph) {
   GraphNodeMap new_pending_tasks;
   GraphNodeMap new_running_tasks;
   TaskQueue new_ready_to_run_tasks;
+  std::vector<TaskQueue> new_worker_ready_to_run_tasks(
+      worker_ready_to_run_tasks_.size());
 
   new_pending_tasks.swap(*graph);
 
@@ -249,7 +273,19 @@ void WorkerPool::Inner::SetTaskGraph(TaskGraph* graph) {
       new_running_tasks.set(task, new_pending_tasks.take_and_erase(task));
     }
 
-    // Build new "ready to run" tasks queue.
+    // Tasks that are still ready to run keep their place in the queue of the
+    // worker that made them ready.
+    base::hash_map<internal::WorkerPoolTask*, size_t> ready_task_workers;
+    for (size_t i = 0; i < worker_ready_to_run_tasks_.size(); ++i) {
+      const TaskQueue& queue = worker_ready_to_run_tasks_[i];
+      for (TaskQueue::const_iterator it = queue.begin(); it != queue.end();
+           ++it) {
+        ready_task_workers[(*it)->task()] = i;
+      }
+    }
+
+    // Build new "ready to run" tasks queues. They are only made into heaps
+    // once they are complete, which is linear in the number of tasks.
     // TODO(reveman): Create this queue when building the task graph instead.
     for (GraphNodeMap::iterator it = new_pending_tasks.begin();
          it != new_pending_tasks.end(); ++it) {
@@ -264,13 +300,29 @@ void WorkerPool::Inner::SetTaskGraph(TaskGraph* graph) {
       // Note: This is only for debugging purposes.
       task->DidSchedule();
 
-      if (!node->num_dependencies())
-        new_ready_to_run_tasks.push(node);
+      if (!node->num_dependencies()) {
+        base::hash_map<internal::WorkerPoolTask*, size_t>::iterator
+            worker_it = ready_task_workers.find(task);
+        if (worker_it != ready_task_workers.end())
+          new_worker_ready_to_run_tasks[worker_it->second].push_back(node);
+        else
+          new_ready_to_run_tasks.push_back(node);
+      }
 
       // Erase the task from old pending tasks.
       pending_tasks_.erase(task);
     }
 
+    std::make_heap(new_ready_to_run_tasks.begin(),
+                   new_ready_to_run_tasks.end(),
+                   PriorityComparator());
+    bool has_ready_to_run_tasks = !new_ready_to_run_tasks.empty();
+    for (size_t i = 0; i < new_worker_ready_to_run_tasks.size(); ++i) {
+      TaskQueue& queue = new_worker_ready_to_run_tasks[i];
+      std::make_heap(queue.begin(), queue.end(), PriorityComparator());
+      has_ready_to_run_tasks |= !queue.empty();
+    }
+
     completed_tasks_.reserve(completed_tasks_.size() + pending_tasks_.size());
 
     // The items left in |pending_tasks_| need to be canceled.
@@ -284,15 +336,16 @@ void WorkerPool::Inner::SetTaskGraph(TaskGraph* graph) {
     // Note: old tasks are intentionally destroyed after releasing |lock_|.
     pending_tasks_.swap(new_pending_tasks);
     running_tasks_.swap(new_running_tasks);
-    std::swap(ready_to_run_tasks_, new_ready_to_run_tasks);
+    ready_to_run_tasks_.swap(new_ready_to_run_tasks);
+    worker_ready_to_run_tasks_.swap(new_worker_ready_to_run_tasks);
 
-    // If |ready_to_run_tasks_| is empty, it means we either have
-    // running tasks, or we have no pending tasks.
-    DCHECK(!ready_to_run_tasks_.empty() ||
+    // If no task is ready to run, it means we either have running tasks, or
+    // we have no pending tasks.
+    DCHECK(has_ready_to_run_tasks ||
            (pending_tasks_.empty() || !running_tasks_.empty()));
 
     // If there is more work available, wake up worker thread.
-    if (!ready_to_run_tasks_.empty())
+    if (has_ready_to_run_tasks)
       has_ready_to_run_tasks_cv_.Signal();
   }
 }
@@ -304,6 +357,50 @@ void WorkerPool::Inner::CollectCompletedTasks(TaskVector* completed_tasks) {
   completed_tasks->swap(completed_tasks_);
 }
 
+// static
+void WorkerPool::Inner::PushTask(TaskQueue* queue, internal::GraphNode* node) {
+  queue->push_back(node);
+  std::push_heap(queue->begin(), queue->end(), PriorityComparator());
+}
+
+// static
+internal::GraphNode* WorkerPool::Inner::PopTask(TaskQueue* queue) {
+  DCHECK(!queue->empty());
+  std::pop_heap(queue->begin(), queue->end(), PriorityComparator());
+  internal::GraphNode* node = queue->back();
+  queue->pop_back();
+  return node;
+}
+
+// static
+bool WorkerPool::Inner::RunsBefore(const TaskQueue& a, const TaskQueue& b) {
+  if (a.empty())
+    return false;
+  if (b.empty())
+    return true;
+  return PriorityComparator()(b.front(), a.front());
+}
+
+internal::GraphNode* WorkerPool::Inner::TakeReadyToRunTask(
+    unsigned thread_index) {
+  TaskQueue* own_tasks = &worker_ready_to_run_tasks_[thread_index];
+  TaskQueue* queue = own_tasks;
+  if (RunsBefore(ready_to_run_tasks_, *queue))
+    queue = &ready_to_run_tasks_;
+
+  if (queue->empty()) {
+    // Steal the most important task that another worker has queued.
+    for (size_t i = 0; i < worker_ready_to_run_tasks_.size(); ++i) {
+      if (RunsBefore(worker_ready_to_run_tasks_[i], *queue))
+        queue = &worker_ready_to_run_tasks_[i];
+    }
+    if (queue->empty())
+      return NULL;
+  }
+
+  return PopTask(queue);
+}
+
 void WorkerPool::Inner::Run() {
   base::AutoLock lock(lock_);
 
@@ -311,7 +408,8 @@ void WorkerPool::Inner::Run() {
   int thread_index = next_thread_index_++;
 
   while (true) {
-    if (ready_to_run_tasks_.empty()) {
+    internal::GraphNode* ready_node = TakeReadyToRunTask(thread_index);
+    if (!ready_node) {
       // Exit when shutdown is set and no more tasks are pending.
       if (shutdown_ && pending_tasks_.empty())
         break;
@@ -321,10 +419,7 @@ void WorkerPool::Inner::Run() {
       continue;
     }
 
-    // Take top priority task from |ready_to_run_tasks_|.
-    scoped_refptr<internal::WorkerPoolTask> task(
-        ready_to_run_tasks_.top()->task());
-    ready_to_run_tasks_.pop();
+    scoped_refptr<internal::WorkerPoolTask> task(ready_node->task());
 
     // Move task from |pending_tasks_| to |running_tasks_|.
     DCHECK(pending_tasks_.contains(task.get()));
@@ -357,10 +452,12 @@ void WorkerPool::Inner::Run() {
         internal::GraphNode* dependent_node = *it;
 
         dependent_node->remove_dependency();
-        // Task is ready if it has no dependencies. Add it to
-        // |ready_to_run_tasks_|.
-        if (!dependent_node->num_dependencies())
-          ready_to_run_tasks_.push(dependent_node);
+        // Task is ready if it has no dependencies. Queue it for this
+        // worker.
+        if (!dependent_node->num_dependencies()) {
+          PushTask(&worker_ready_to_run_tasks_[thread_index],
+                   dependent_node);
+        }
       }
     }
 
@@ -4,9 +4,13 @@
 
 #include "cc/scheduler/scheduler.h"
 
+#include <algorithm>
+
 #include "base/auto_reset.h"
+#include "base/bind.h"
 #include "base/debug/trace_event.h"
 #include "base/logging.h"
+#include "base/message_loop/message_loop.h"
 
 namespace cc {
 
@@ -167,15 +171,84 @@ void Scheduler::SetupNextBeginFrameIfNeeded() {
 
 void Scheduler::BeginFrame(const BeginFrameArgs& args) {
   TRACE_EVENT0("cc", "Scheduler::BeginFrame");
+  // A deadline that hasn't run yet is overdue by now.
+  if (settings_.deadline_scheduling_enabled &&
+      state_machine_.inside_begin_frame())
+    OnBeginFrameDeadline();
+
   DCHECK(!has_pending_begin_frame_);
   has_pending_begin_frame_ = true;
   safe_to_expect_begin_frame_ = true;
   last_begin_frame_args_ = args;
   state_machine_.DidEnterBeginFrame(args);
+
+  if (!settings_.deadline_scheduling_enabled) {
+    ProcessScheduledActions();
+    state_machine_.DidLeaveBeginFrame();
+    return;
+  }
+
+  // Commits and activations can happen right away; the draw waits for the
+  // deadline, unless ProcessScheduledActions() finds nothing worth waiting
+  // for and posts an earlier one.
+  ProcessScheduledActions();
+  if (state_machine_.inside_begin_frame() &&
+      !state_machine_.inside_begin_frame_deadline() &&
+      begin_frame_deadline_closure_.IsCancelled())
+    PostBeginFrameDeadline(AdjustedBeginFrameDeadline(args));
+}
+
+void Scheduler::OnBeginFrameDeadline() {
+  TRACE_EVENT0("cc", "Scheduler::OnBeginFrameDeadline");
+  DCHECK(settings_.deadline_scheduling_enabled);
+  begin_frame_deadline_closure_.Cancel();
+  TRACE_EVENT_INSTANT1("cc", "Scheduler::BeginFrameDeadlineLateness",
+                       TRACE_EVENT_SCOPE_THREAD,
+                       "lateness_us",
+                       (base::TimeTicks::Now() -
+                        last_begin_frame_args_.deadline).InMicroseconds());
+  state_machine_.OnBeginFrameDeadline();
   ProcessScheduledActions();
   state_machine_.DidLeaveBeginFrame();
 }
 
+base::TimeTicks Scheduler::AdjustedBeginFrameDeadline(
+    const BeginFrameArgs& args) const {
+  base::TimeDelta draw_duration = client_->DrawDurationEstimate();
+  base::TimeDelta commit_duration =
+      client_->BeginFrameToCommitDurationEstimate() +
+      client_->CommitToActivateDurationEstimate();
+  bool high_latency = state_machine_.MainThreadIsInHighLatencyMode();
+  TRACE_COUNTER_ID1("cc", "MainThreadHighLatency", this, high_latency);
+  TRACE_EVENT_INSTANT2("cc", "Scheduler::AdjustedBeginFrameDeadline",
+                       TRACE_EVENT_SCOPE_THREAD,
+                       "draw_estimate_us",
+                       draw_duration.InMicroseconds(),
+                       "commit_to_activate_estimate_us",
+                       commit_duration.InMicroseconds());
+
+  // Draw right away when the main thread is behind, or when it is unlikely to
+  // get a commit activated before the time needed to draw runs out. Waiting
+  // would only delay the frame that is already there.
+  base::TimeTicks draw_deadline = args.deadline - draw_duration;
+  if (high_latency ||
+      args.frame_time + commit_duration > draw_deadline)
+    return base::TimeTicks();
+  return draw_deadline;
+}
+
+void Scheduler::PostBeginFrameDeadline(base::TimeTicks deadline) {
+  base::TimeDelta delay = std::max(deadline - base::TimeTicks::Now(),
+                                   base::TimeDelta());
+  TRACE_EVENT1("cc", "Scheduler::PostBeginFrameDeadline",
+               "delay_us", delay.InMicroseconds());
+  begin_frame_deadline_closure_.Reset(
+      base::Bind(&Scheduler::OnBeginFrameDeadline,
+                 weak_factory_.GetWeakPtr()));
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE, begin_frame_deadline_closure_.callback(), delay);
+}
+
 void Scheduler::DrawAndSwapIfPossible() {
   ScheduledActionDrawAndSwapResult result =
       client_->ScheduledActionDrawAndSwapIfPossible();
@@ -233,6 +306,9 @@ void Scheduler::ProcessScheduledActions() {
     action = state_machine_.NextAction();
   }
 
+  if (state_machine_.ShouldTriggerBeginFrameDeadlineEarly())
+    PostBeginFrameDeadline(base::TimeTicks());
+
   SetupNextBeginFrameIfNeeded();
   client_->DidAnticipatedDrawTimeChange(AnticipatedDrawTime());
 }
@@ -8,6 +8,7 @@
 #include <string>
 
 #include "base/basictypes.h"
+#include "base/cancelable_callback.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/time/time.h"
 #include "cc/base/cc_export.h"
@@ -104,6 +105,7 @@ class CC_EXPORT Scheduler {
   base::TimeTicks LastBeginFrameOnImplThreadTime();
 
   void BeginFrame(const BeginFrameArgs& args);
+  void OnBeginFrameDeadline();
 
   std::string StateAsStringForTesting() { return state_machine_.ToString(); }
 
@@ -111,6 +113,8 @@ class CC_EXPORT Scheduler {
   Scheduler(SchedulerClient* client,
             const SchedulerSettings& scheduler_settings);
 
+  base::TimeTicks AdjustedBeginFrameDeadline(const BeginFrameArgs& args) const;
+  void PostBeginFrameDeadline(base::TimeTicks deadline);
   void SetupNextBeginFrameIfNeeded();
   void DrawAndSwapIfPossible();
   void DrawAndSwapForced();
@@ -126,6 +130,7 @@ class CC_EXPORT Scheduler {
   // workaround.
   bool safe_to_expect_begin_frame_;
   BeginFrameArgs last_begin_frame_args_;
+  base::CancelableClosure begin_frame_deadline_closure_;
 
   SchedulerStateMachine state_machine_;
   bool inside_process_scheduled_actions_;
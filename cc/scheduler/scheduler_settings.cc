@@ -10,7 +10,8 @@ SchedulerSettings::SchedulerSettings()
     : impl_side_painting(false),
       timeout_and_draw_when_animation_checkerboards(true),
       using_synchronous_renderer_compositor(false),
-      throttle_frame_production(true) {}
+      throttle_frame_production(true),
+      deadline_scheduling_enabled(false) {}
 
 SchedulerSettings::~SchedulerSettings() {}
 
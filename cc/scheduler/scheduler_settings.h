@@ -18,6 +18,7 @@ class CC_EXPORT SchedulerSettings {
   bool timeout_and_draw_when_animation_checkerboards;
   bool using_synchronous_renderer_compositor;
   bool throttle_frame_production;
+  bool deadline_scheduling_enabled;
 };
 
 }  // namespace cc
@@ -31,6 +31,7 @@ SchedulerStateMachine::SchedulerStateMachine(const SchedulerSettings& settings)
       expect_immediate_begin_frame_for_main_thread_(false),
       main_thread_needs_layer_textures_(false),
       inside_begin_frame_(false),
+      inside_begin_frame_deadline_(false),
       visible_(false),
       can_start_(false),
       can_draw_(false),
@@ -85,6 +86,8 @@ std::string SchedulerStateMachine::ToString() {
                       main_thread_needs_layer_textures_);
   base::StringAppendF(&str, "inside_begin_frame_ = %d; ",
       inside_begin_frame_);
+  base::StringAppendF(&str, "inside_begin_frame_deadline_ = %d; ",
+      inside_begin_frame_deadline_);
   base::StringAppendF(&str, "last_frame_time_ = %" PRId64 "; ",
       (last_begin_frame_args_.frame_time - base::TimeTicks())
           .InMilliseconds());
@@ -157,6 +160,8 @@ bool SchedulerStateMachine::ShouldDraw() const {
     return false;
   if (!inside_begin_frame_)
     return false;
+  if (settings_.deadline_scheduling_enabled && !inside_begin_frame_deadline_)
+    return false;
   if (HasDrawnThisFrame())
     return false;
   if (output_surface_state_ != OUTPUT_SURFACE_ACTIVE)
@@ -397,6 +402,34 @@ void SchedulerStateMachine::DidEnterBeginFrame(const BeginFrameArgs& args) {
 
 void SchedulerStateMachine::DidLeaveBeginFrame() {
   inside_begin_frame_ = false;
+  inside_begin_frame_deadline_ = false;
+}
+
+void SchedulerStateMachine::OnBeginFrameDeadline() {
+  DCHECK(settings_.deadline_scheduling_enabled);
+  DCHECK(inside_begin_frame_);
+  inside_begin_frame_deadline_ = true;
+}
+
+bool SchedulerStateMachine::ShouldTriggerBeginFrameDeadlineEarly() const {
+  if (!settings_.deadline_scheduling_enabled)
+    return false;
+  if (!inside_begin_frame_ || inside_begin_frame_deadline_)
+    return false;
+
+  // A commit that started in an earlier frame isn't worth waiting for.
+  if (MainThreadIsInHighLatencyMode())
+    return true;
+
+  // Otherwise wait for the commit, or the activation, that may still make it
+  // into this frame.
+  return !CommitPending() && !has_pending_tree_;
+}
+
+bool SchedulerStateMachine::MainThreadIsInHighLatencyMode() const {
+  return CommitPending() &&
+         last_frame_number_where_begin_frame_sent_to_main_thread_ <
+             current_frame_number_;
 }
 
 void SchedulerStateMachine::SetVisible(bool visible) { visible_ = visible; }
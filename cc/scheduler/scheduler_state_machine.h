@@ -84,6 +84,24 @@ class CC_EXPORT SchedulerStateMachine {
   void DidLeaveBeginFrame();
   bool inside_begin_frame() const { return inside_begin_frame_; }
 
+  // With deadline scheduling, draws wait for the deadline of the BeginFrame,
+  // which gives the main thread until then to commit. This indicates that the
+  // deadline was reached; draws may happen until DidLeaveBeginFrame().
+  void OnBeginFrameDeadline();
+  bool inside_begin_frame_deadline() const {
+    return inside_begin_frame_deadline_;
+  }
+
+  // With deadline scheduling, indicates that nothing that could still be
+  // drawn in this frame is on its way, so there is no point in waiting for
+  // the deadline.
+  bool ShouldTriggerBeginFrameDeadlineEarly() const;
+
+  // Indicates that the main thread is still busy with a BeginFrame sent in an
+  // earlier frame. Draws then stop waiting for it, and its frames are shown a
+  // frame later than they would otherwise be.
+  bool MainThreadIsInHighLatencyMode() const;
+
   // Indicates whether the LayerTreeHostImpl is visible.
   void SetVisible(bool visible);
 
@@ -193,6 +211,7 @@ class CC_EXPORT SchedulerStateMachine {
   bool expect_immediate_begin_frame_for_main_thread_;
   bool main_thread_needs_layer_textures_;
   bool inside_begin_frame_;
+  bool inside_begin_frame_deadline_;
   BeginFrameArgs last_begin_frame_args_;
   bool visible_;
   bool can_start_;
@@ -1387,5 +1387,74 @@ TEST(SchedulerStateMachineTest, AcquireTexturesWithAbort) {
   EXPECT_FALSE(state.DrawSuspendedUntilCommit());
 }
 
+TEST(SchedulerStateMachineTest, DeadlineSchedulingDrawsAtDeadline) {
+  SchedulerSettings scheduler_settings;
+  scheduler_settings.deadline_scheduling_enabled = true;
+  StateMachine state(scheduler_settings);
+  state.SetCanStart();
+  state.UpdateState(state.NextAction());
+  state.DidCreateAndInitializeOutputSurface();
+  state.SetVisible(true);
+  state.SetCanDraw(true);
+  state.SetNeedsRedraw(true);
+
+  state.DidEnterBeginFrame(BeginFrameArgs::CreateForTesting());
+  EXPECT_EQ(SchedulerStateMachine::ACTION_NONE, state.NextAction());
+
+  // Nothing is on its way from the main thread, so the deadline can be
+  // triggered right away.
+  EXPECT_TRUE(state.ShouldTriggerBeginFrameDeadlineEarly());
+
+  state.OnBeginFrameDeadline();
+  EXPECT_FALSE(state.ShouldTriggerBeginFrameDeadlineEarly());
+  EXPECT_EQ(SchedulerStateMachine::ACTION_DRAW_IF_POSSIBLE,
+            state.NextAction());
+  state.UpdateState(state.NextAction());
+  state.DidDrawIfPossibleCompleted(true);
+  EXPECT_EQ(SchedulerStateMachine::ACTION_NONE, state.NextAction());
+
+  state.DidLeaveBeginFrame();
+  EXPECT_FALSE(state.inside_begin_frame_deadline());
+}
+
+TEST(SchedulerStateMachineTest, DeadlineSchedulingHighLatencyMode) {
+  SchedulerSettings scheduler_settings;
+  scheduler_settings.deadline_scheduling_enabled = true;
+  StateMachine state(scheduler_settings);
+  state.SetCanStart();
+  state.UpdateState(state.NextAction());
+  state.DidCreateAndInitializeOutputSurface();
+  state.SetVisible(true);
+  state.SetCanDraw(true);
+  state.SetNeedsCommit();
+
+  state.DidEnterBeginFrame(BeginFrameArgs::CreateForTesting());
+  EXPECT_EQ(SchedulerStateMachine::ACTION_SEND_BEGIN_FRAME_TO_MAIN_THREAD,
+            state.NextAction());
+  state.UpdateState(state.NextAction());
+
+  // The commit may still make it into this frame.
+  EXPECT_FALSE(state.MainThreadIsInHighLatencyMode());
+  EXPECT_FALSE(state.ShouldTriggerBeginFrameDeadlineEarly());
+  state.OnBeginFrameDeadline();
+  EXPECT_EQ(SchedulerStateMachine::ACTION_NONE, state.NextAction());
+  state.DidLeaveBeginFrame();
+
+  // The main thread missed the frame, so the next one doesn't wait for it.
+  state.DidEnterBeginFrame(BeginFrameArgs::CreateForTesting());
+  EXPECT_TRUE(state.MainThreadIsInHighLatencyMode());
+  EXPECT_TRUE(state.ShouldTriggerBeginFrameDeadlineEarly());
+
+  state.FinishCommit();
+  EXPECT_EQ(SchedulerStateMachine::ACTION_COMMIT, state.NextAction());
+  state.UpdateState(state.NextAction());
+  EXPECT_FALSE(state.MainThreadIsInHighLatencyMode());
+  EXPECT_TRUE(state.RedrawPending());
+
+  state.OnBeginFrameDeadline();
+  EXPECT_EQ(SchedulerStateMachine::ACTION_DRAW_IF_POSSIBLE,
+            state.NextAction());
+}
+
 }  // namespace
 }  // namespace cc
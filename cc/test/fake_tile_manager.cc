@@ -27,7 +27,9 @@ FakeTileManager::FakeTileManager(TileManagerClient* client)
                   make_scoped_ptr<RasterWorkerPool>(new FakeRasterWorkerPool),
                   1,
                   NULL,
-                  GL_RGBA) {}
+                  GL_RGBA,
+                  0,
+                  false) {}
 
 FakeTileManager::FakeTileManager(TileManagerClient* client,
                                  ResourceProvider* resource_provider)
@@ -36,7 +38,9 @@ FakeTileManager::FakeTileManager(TileManagerClient* client,
                   make_scoped_ptr<RasterWorkerPool>(new FakeRasterWorkerPool),
                   1,
                   NULL,
-                  resource_provider->best_texture_format()) {}
+                  resource_provider->best_texture_format(),
+                  0,
+                  false) {}
 
 FakeTileManager::~FakeTileManager() {}
 
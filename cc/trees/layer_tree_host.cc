@@ -344,6 +344,13 @@ void LayerTreeHost::FinishCommitOnImplThread(LayerTreeHostImpl* host_impl) {
                                          min_page_scale_factor_,
                                          max_page_scale_factor_);
   sync_tree->SetPageScaleDelta(page_scale_delta / sent_page_scale_delta);
+  // Frames drawn by the impl thread alone have no commit to stamp.
+  if (!latency_info_.FindLatency(ui::INPUT_EVENT_LATENCY_DRAW_COMPONENT,
+                                 0,
+                                 NULL)) {
+    latency_info_.AddFirstLatencyNumber(
+        ui::INPUT_EVENT_LATENCY_COMMIT_COMPONENT);
+  }
   sync_tree->SetLatencyInfo(latency_info_);
   latency_info_.Clear();
 
@@ -675,6 +682,7 @@ bool LayerTreeHost::InitializeOutputSurfaceIfNeeded() {
 
 bool LayerTreeHost::UpdateLayers(ResourceUpdateQueue* queue,
                                  size_t memory_allocation_limit_bytes) {
+  TRACE_MEMORY_SUBSYSTEM("cc");
   DCHECK(!output_surface_lost_);
 
   if (!root_layer())
@@ -958,6 +966,8 @@ void LayerTreeHost::PaintLayerContents(
       root_layer_->render_surface()->content_rect(), record_metrics_for_frame);
   occlusion_tracker.set_minimum_tracking_size(
       settings_.minimum_occlusion_tracking_size);
+  occlusion_tracker.set_maximum_tracking_rects(
+      settings_.maximum_occlusion_tracking_rects);
 
   PrioritizeTextures(render_surface_layer_list,
                      occlusion_tracker.overdraw_metrics());
@@ -113,7 +113,8 @@ class CC_EXPORT LayerTreeHost : NON_EXPORTED_BASE(public RateLimiterClient) {
 
   void set_needs_filter_context() { needs_filter_context_ = true; }
   bool needs_offscreen_context() const {
-    return needs_filter_context_;
+    // GPU rasterization draws tiles with the offscreen context's GrContext.
+    return needs_filter_context_ || settings_.gpu_rasterization;
   }
 
   // LayerTreeHost interface to Proxy.
@@ -302,6 +302,12 @@ static inline void UpdateTilePrioritiesForLayer(Layer* layer) {}
 
 static inline void SavePaintPropertiesLayer(LayerImpl* layer) {}
 
+static inline void MarkDrawPropertiesStale(LayerImpl* layer) {
+  layer->MarkDrawPropertiesStale();
+}
+
+static inline void MarkDrawPropertiesStale(Layer* layer) {}
+
 static inline void SavePaintPropertiesLayer(Layer* layer) {
   layer->SavePaintProperties();
 
@@ -774,6 +780,9 @@ static inline void RemoveSurfaceForEarlyExit(
   // layers from the end of the list.
   while (render_surface_layer_list->back() != layer_to_remove) {
     render_surface_layer_list->back()->ClearRenderSurface();
+    // What the last pass got out of the subtree of the layer still has it
+    // owning a surface.
+    MarkDrawPropertiesStale(render_surface_layer_list->back());
     render_surface_layer_list->pop_back();
   }
   DCHECK_EQ(render_surface_layer_list->back(), layer_to_remove);
@@ -840,6 +849,16 @@ static void PreCalculateMetaInformation(
   if (layer->HasCopyRequest())
     recursive_data->layer_or_descendant_has_copy_request = true;
 
+  // What the subtree looks like decides whether the layer gets a render
+  // surface, which its descendants' draw properties depend on.
+  if (layer->draw_properties().num_descendants_that_draw_content !=
+          num_descendants_that_draw_content ||
+      layer->draw_properties().descendants_can_clip_selves !=
+          descendants_can_clip_selves ||
+      layer->draw_properties().layer_or_descendant_has_copy_request !=
+          recursive_data->layer_or_descendant_has_copy_request)
+    MarkDrawPropertiesStale(layer);
+
   layer->draw_properties().num_descendants_that_draw_content =
       num_descendants_that_draw_content;
   layer->draw_properties().descendants_can_clip_selves =
@@ -863,6 +882,9 @@ struct SubtreeGlobals {
   float page_scale_factor;
   LayerType* page_scale_application_layer;
   bool can_adjust_raster_scales;
+  // Every layer UpdateTilePrioritiesForLayer() was called on, in order. Only
+  // kept for LayerImpl trees.
+  std::vector<LayerType*>* layers_with_updated_tile_priorities;
 };
 
 template<typename LayerType, typename RenderSurfaceType>
@@ -902,14 +924,168 @@ struct DataForRecursion {
   bool in_subtree_of_page_scale_application_layer;
   bool subtree_can_use_lcd_text;
   bool subtree_is_visible_from_ancestor;
+
+  // Set when the draw properties of an ancestor were recomputed from changed
+  // inputs, in which case none of its descendants can keep theirs.
+  bool ancestor_draw_properties_are_stale;
 };
 
+// Where the lists a CalculateDrawProperties pass builds ended when it got to a
+// layer, which tells what the layer's subtree added to them.
+struct SubtreeListPositions {
+  size_t render_surface_layer_list;
+  size_t layer_list;
+  size_t layers_with_updated_tile_priorities;
+};
+
+// A layer's own draw properties are stale if they never got computed, or if
+// the last pass didn't get to its children.
+static inline bool DrawPropertiesAreStale(LayerImpl* layer) {
+  return layer->draw_properties_are_stale() ||
+         !layer->subtree_draw_properties_cache().is_valid;
+}
+
+static inline bool DrawPropertiesAreStale(Layer* layer) {
+  return true;
+}
+
+static inline bool CanReuseDrawPropertiesOfSubtree(
+    LayerImpl* layer,
+    bool ancestor_draw_properties_are_stale) {
+  return !ancestor_draw_properties_are_stale &&
+         !DrawPropertiesAreStale(layer) &&
+         !layer->contents_scale_is_stale() &&
+         !layer->descendant_draw_properties_are_stale();
+}
+
+// The main thread recomputes everything; its render surfaces don't outlive a
+// pass, and its layers have to save their paint properties on each one.
+static inline bool CanReuseDrawPropertiesOfSubtree(
+    Layer* layer,
+    bool ancestor_draw_properties_are_stale) {
+  return false;
+}
+
+// Adds what the last pass got out of |layer|'s subtree to the lists being
+// built, as if the subtree had been walked again.
+static void ReuseDrawPropertiesOfSubtree(
+    LayerImpl* layer,
+    const SubtreeGlobals<LayerImpl>& globals,
+    LayerImplList* render_surface_layer_list,
+    LayerImplList* layer_list,
+    gfx::Rect* drawable_content_rect_of_subtree) {
+  const SubtreeDrawPropertiesCache& cache =
+      layer->subtree_draw_properties_cache();
+  render_surface_layer_list->insert(render_surface_layer_list->end(),
+                                    cache.render_surface_layer_list.begin(),
+                                    cache.render_surface_layer_list.end());
+  layer_list->insert(
+      layer_list->end(), cache.layer_list.begin(), cache.layer_list.end());
+
+  // Tile priorities also depend on the time and the tile manager's state, so
+  // they are updated on every pass.
+  for (size_t i = 0; i < cache.layers_with_updated_tile_priorities.size(); ++i)
+    UpdateTilePrioritiesForLayer(cache.layers_with_updated_tile_priorities[i]);
+  globals.layers_with_updated_tile_priorities->insert(
+      globals.layers_with_updated_tile_priorities->end(),
+      cache.layers_with_updated_tile_priorities.begin(),
+      cache.layers_with_updated_tile_priorities.end());
+
+  *drawable_content_rect_of_subtree = cache.drawable_content_rect;
+}
+
+static void ReuseDrawPropertiesOfSubtree(
+    Layer* layer,
+    const SubtreeGlobals<Layer>& globals,
+    RenderSurfaceLayerList* render_surface_layer_list,
+    RenderSurfaceLayerList* layer_list,
+    gfx::Rect* drawable_content_rect_of_subtree) {
+  NOTREACHED();
+}
+
+static void RecordDrawPropertiesOfSubtree(
+    LayerImpl* layer,
+    const SubtreeGlobals<LayerImpl>& globals,
+    const LayerImplList& render_surface_layer_list,
+    const LayerImplList& layer_list,
+    const SubtreeListPositions& start,
+    gfx::Rect drawable_content_rect_of_subtree) {
+  SubtreeDrawPropertiesCache& cache = layer->subtree_draw_properties_cache();
+  cache.is_valid = true;
+  cache.drawable_content_rect = drawable_content_rect_of_subtree;
+  cache.render_surface_layer_list.assign(
+      render_surface_layer_list.begin() + start.render_surface_layer_list,
+      render_surface_layer_list.end());
+  cache.layer_list.assign(layer_list.begin() + start.layer_list,
+                          layer_list.end());
+  cache.layers_with_updated_tile_priorities.assign(
+      globals.layers_with_updated_tile_priorities->begin() +
+          start.layers_with_updated_tile_priorities,
+      globals.layers_with_updated_tile_priorities->end());
+
+  // Whatever was marked stale while the layer was being computed, such as
+  // its content bounds, is now up to date. Only descendants the pass didn't
+  // get to can still be stale.
+  bool descendants_are_stale = false;
+  for (size_t i = 0; i < layer->children().size(); ++i) {
+    LayerImpl* child = layer->children()[i];
+    if (child->draw_properties_are_stale() ||
+        child->contents_scale_is_stale() ||
+        child->descendant_draw_properties_are_stale())
+      descendants_are_stale = true;
+  }
+  layer->ResetDrawPropertiesStaleness(descendants_are_stale);
+
+  if (layer->DrawPropertiesCanChangeUnnoticed())
+    layer->MarkDrawPropertiesStale();
+}
+
+static void RecordDrawPropertiesOfSubtree(
+    Layer* layer,
+    const SubtreeGlobals<Layer>& globals,
+    const RenderSurfaceLayerList& render_surface_layer_list,
+    const RenderSurfaceLayerList& layer_list,
+    const SubtreeListPositions& start,
+    gfx::Rect drawable_content_rect_of_subtree) {}
+
+static void ClearDrawPropertiesStaleness(LayerImpl* layer) {
+  bool had_stale_descendants = layer->descendant_draw_properties_are_stale();
+  layer->ResetDrawPropertiesStaleness(false);
+  if (!had_stale_descendants)
+    return;
+  for (size_t i = 0; i < layer->children().size(); ++i)
+    ClearDrawPropertiesStaleness(layer->children()[i]);
+}
+
+// When a pass doesn't get to a layer's children, the layer's draw properties
+// are recomputed in full, descendants included, the next time a pass does.
+// Until then, the staleness of the subtree doesn't matter, and clearing it
+// keeps its ancestors from being recomputed on every pass.
+static void ForgetDrawPropertiesOfSubtree(LayerImpl* layer) {
+  layer->subtree_draw_properties_cache().is_valid = false;
+  ClearDrawPropertiesStaleness(layer);
+}
+
+static void ForgetDrawPropertiesOfSubtree(Layer* layer) {}
+
+template <typename LayerType,
+          typename LayerListType,
+          typename RenderSurfaceType>
+static void CalculateDrawPropertiesForSubtree(
+    LayerType* layer,
+    const SubtreeGlobals<LayerType>& globals,
+    const DataForRecursion<LayerType, RenderSurfaceType>& data_from_ancestor,
+    LayerListType* render_surface_layer_list,
+    LayerListType* layer_list,
+    gfx::Rect* drawable_content_rect_of_subtree);
+
 // Recursively walks the layer tree starting at the given node and computes all
-// the necessary transformations, clip rects, render surfaces, etc.
+// the necessary transformations, clip rects, render surfaces, etc. Returns
+// false if it didn't get to the layer's children.
 template <typename LayerType,
           typename LayerListType,
           typename RenderSurfaceType>
-static void CalculateDrawPropertiesInternal(
+static bool CalculateDrawPropertiesInternal(
     LayerType* layer,
     const SubtreeGlobals<LayerType>& globals,
     const DataForRecursion<LayerType, RenderSurfaceType>& data_from_ancestor,
@@ -1066,7 +1242,7 @@ static void CalculateDrawPropertiesInternal(
 
   // The root layer cannot skip CalcDrawProperties.
   if (!IsRootLayer(layer) && SubtreeShouldBeSkipped(layer, layer_is_visible))
-    return;
+    return false;
 
   // As this function proceeds, these are the properties for the current
   // layer that actually get computed. To avoid unnecessary copies
@@ -1152,6 +1328,9 @@ static void CalculateDrawPropertiesInternal(
       ? std::max(combined_transform_scales.x(),
                  combined_transform_scales.y())
       : layer_scale_factors;
+  float last_contents_scale_x = layer->contents_scale_x();
+  float last_contents_scale_y = layer->contents_scale_y();
+  gfx::Size last_content_bounds = layer->content_bounds();
   UpdateLayerContentsScale(
       layer,
       globals.can_adjust_raster_scales,
@@ -1161,6 +1340,15 @@ static void CalculateDrawPropertiesInternal(
           globals.page_scale_factor : 1.f,
       animating_transform_to_screen);
 
+  // The layer's transforms, and so its descendants, also depend on its
+  // contents scale.
+  data_for_children.ancestor_draw_properties_are_stale =
+      data_from_ancestor.ancestor_draw_properties_are_stale ||
+      DrawPropertiesAreStale(layer) ||
+      layer->contents_scale_x() != last_contents_scale_x ||
+      layer->contents_scale_y() != last_contents_scale_y ||
+      layer->content_bounds() != last_content_bounds;
+
   // The draw_transform that gets computed below is effectively the layer's
   // draw_transform, unless the layer itself creates a render_surface. In that
   // case, the render_surface re-parents the transforms.
@@ -1213,7 +1401,7 @@ static void CalculateDrawPropertiesInternal(
     // subtree
     if (!layer->double_sided() && TransformToParentIsKnown(layer) &&
         IsSurfaceBackFaceVisible(layer, combined_transform))
-      return;
+      return false;
 
     RenderSurfaceType* render_surface = CreateOrReuseRenderSurface(layer);
 
@@ -1472,9 +1660,9 @@ static void CalculateDrawPropertiesInternal(
         LayerTreeHostCommon::get_child_as_raw_ptr(layer->children(), i);
     gfx::Rect drawable_content_rect_of_child_subtree;
     gfx::Transform identity_matrix;
-    CalculateDrawPropertiesInternal<LayerType,
-                                    LayerListType,
-                                    RenderSurfaceType>(
+    CalculateDrawPropertiesForSubtree<LayerType,
+                                      LayerListType,
+                                      RenderSurfaceType>(
         child,
         globals,
         data_for_children,
@@ -1492,7 +1680,7 @@ static void CalculateDrawPropertiesInternal(
   if (layer->render_surface() && !IsRootLayer(layer) &&
       layer->render_surface()->layer_list().empty()) {
     RemoveSurfaceForEarlyExit(layer, render_surface_layer_list);
-    return;
+    return true;
   }
 
   // Compute the total drawable_content_rect for this subtree (the rect is in
@@ -1567,7 +1755,7 @@ static void CalculateDrawPropertiesInternal(
 
     if (clipped_content_rect.IsEmpty()) {
       RemoveSurfaceForEarlyExit(layer, render_surface_layer_list);
-      return;
+      return true;
     }
 
     render_surface->SetContentRect(clipped_content_rect);
@@ -1618,10 +1806,12 @@ static void CalculateDrawPropertiesInternal(
 
   UpdateTilePrioritiesForLayer(layer);
   SavePaintPropertiesLayer(layer);
+  if (globals.layers_with_updated_tile_priorities)
+    globals.layers_with_updated_tile_priorities->push_back(layer);
 
   // If neither this layer nor any of its children were added, early out.
   if (sorting_start_index == descendants.size())
-    return;
+    return true;
 
   // If preserves-3d then sort all the descendants in 3D so that they can be
   // drawn from back to front. If the preserves-3d property is also set on the
@@ -1645,6 +1835,58 @@ static void CalculateDrawPropertiesInternal(
     layer->render_target()->render_surface()->
         AddContributingDelegatedRenderPassLayer(layer);
   }
+  return true;
+}
+
+// Computes the draw properties of |layer|'s subtree, or reuses the ones from
+// the last pass if nothing that feeds into them changed since.
+template <typename LayerType,
+          typename LayerListType,
+          typename RenderSurfaceType>
+static void CalculateDrawPropertiesForSubtree(
+    LayerType* layer,
+    const SubtreeGlobals<LayerType>& globals,
+    const DataForRecursion<LayerType, RenderSurfaceType>& data_from_ancestor,
+    LayerListType* render_surface_layer_list,
+    LayerListType* layer_list,
+    gfx::Rect* drawable_content_rect_of_subtree) {
+  if (CanReuseDrawPropertiesOfSubtree(
+          layer, data_from_ancestor.ancestor_draw_properties_are_stale)) {
+    ReuseDrawPropertiesOfSubtree(layer,
+                                 globals,
+                                 render_surface_layer_list,
+                                 layer_list,
+                                 drawable_content_rect_of_subtree);
+    return;
+  }
+
+  SubtreeListPositions start;
+  start.render_surface_layer_list = render_surface_layer_list->size();
+  start.layer_list = layer_list->size();
+  start.layers_with_updated_tile_priorities =
+      globals.layers_with_updated_tile_priorities ?
+          globals.layers_with_updated_tile_priorities->size() : 0;
+
+  bool visited_children =
+      CalculateDrawPropertiesInternal<LayerType,
+                                      LayerListType,
+                                      RenderSurfaceType>(
+          layer,
+          globals,
+          data_from_ancestor,
+          render_surface_layer_list,
+          layer_list,
+          drawable_content_rect_of_subtree);
+  if (!visited_children) {
+    ForgetDrawPropertiesOfSubtree(layer);
+    return;
+  }
+  RecordDrawPropertiesOfSubtree(layer,
+                                globals,
+                                *render_surface_layer_list,
+                                *layer_list,
+                                start,
+                                *drawable_content_rect_of_subtree);
 }
 
 void LayerTreeHostCommon::CalculateDrawProperties(
@@ -1670,6 +1912,7 @@ void LayerTreeHostCommon::CalculateDrawProperties(
   globals.page_scale_factor = inputs->page_scale_factor;
   globals.page_scale_application_layer = inputs->page_scale_application_layer;
   globals.can_adjust_raster_scales = inputs->can_adjust_raster_scales;
+  globals.layers_with_updated_tile_priorities = NULL;
 
   DataForRecursion<Layer, RenderSurface> data_for_recursion;
   data_for_recursion.parent_matrix = scaled_device_transform;
@@ -1684,11 +1927,14 @@ void LayerTreeHostCommon::CalculateDrawProperties(
   data_for_recursion.in_subtree_of_page_scale_application_layer = false;
   data_for_recursion.subtree_can_use_lcd_text = inputs->can_use_lcd_text;
   data_for_recursion.subtree_is_visible_from_ancestor = true;
+  data_for_recursion.ancestor_draw_properties_are_stale = true;
 
   PreCalculateMetaInformationRecursiveData recursive_data;
   PreCalculateMetaInformation(inputs->root_layer, &recursive_data);
 
-  CalculateDrawPropertiesInternal<Layer, RenderSurfaceLayerList, RenderSurface>(
+  CalculateDrawPropertiesForSubtree<Layer,
+                                    RenderSurfaceLayerList,
+                                    RenderSurface>(
       inputs->root_layer,
       globals,
       data_for_recursion,
@@ -1715,6 +1961,7 @@ void LayerTreeHostCommon::CalculateDrawProperties(
   scaled_device_transform.Scale(inputs->device_scale_factor,
                                 inputs->device_scale_factor);
   LayerImplList dummy_layer_list;
+  LayerImplList layers_with_updated_tile_priorities;
   LayerSorter layer_sorter;
 
   // The root layer's render_surface should receive the device viewport as the
@@ -1728,6 +1975,8 @@ void LayerTreeHostCommon::CalculateDrawProperties(
   globals.page_scale_factor = inputs->page_scale_factor;
   globals.page_scale_application_layer = inputs->page_scale_application_layer;
   globals.can_adjust_raster_scales = inputs->can_adjust_raster_scales;
+  globals.layers_with_updated_tile_priorities =
+      &layers_with_updated_tile_priorities;
 
   DataForRecursion<LayerImpl, RenderSurfaceImpl> data_for_recursion;
   data_for_recursion.parent_matrix = scaled_device_transform;
@@ -1742,11 +1991,15 @@ void LayerTreeHostCommon::CalculateDrawProperties(
   data_for_recursion.in_subtree_of_page_scale_application_layer = false;
   data_for_recursion.subtree_can_use_lcd_text = inputs->can_use_lcd_text;
   data_for_recursion.subtree_is_visible_from_ancestor = true;
+  data_for_recursion.ancestor_draw_properties_are_stale =
+      !inputs->can_reuse_draw_properties;
 
   PreCalculateMetaInformationRecursiveData recursive_data;
   PreCalculateMetaInformation(inputs->root_layer, &recursive_data);
 
-  CalculateDrawPropertiesInternal<LayerImpl, LayerImplList, RenderSurfaceImpl>(
+  CalculateDrawPropertiesForSubtree<LayerImpl,
+                                    LayerImplList,
+                                    RenderSurfaceImpl>(
       inputs->root_layer,
       globals,
       data_for_recursion,
@@ -50,7 +50,8 @@ class CC_EXPORT LayerTreeHostCommon {
           max_texture_size(max_texture_size),
           can_use_lcd_text(can_use_lcd_text),
           can_adjust_raster_scales(can_adjust_raster_scales),
-          render_surface_layer_list(render_surface_layer_list) {}
+          render_surface_layer_list(render_surface_layer_list),
+          can_reuse_draw_properties(false) {}
 
     LayerType* root_layer;
     gfx::Size device_viewport_size;
@@ -62,6 +63,10 @@ class CC_EXPORT LayerTreeHostCommon {
     bool can_use_lcd_text;
     bool can_adjust_raster_scales;
     RenderSurfaceLayerListType* render_surface_layer_list;
+    // Lets subtrees of a LayerImpl tree whose draw properties aren't stale
+    // keep the ones from the last pass. Only valid when the other inputs are
+    // the same as then.
+    bool can_reuse_draw_properties;
   };
 
   template <typename LayerType, typename RenderSurfaceLayerListType>
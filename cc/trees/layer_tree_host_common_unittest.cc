@@ -4272,6 +4272,114 @@ TEST_F(LayerTreeHostCommonTest,
 }
 
 
+TEST_F(LayerTreeHostCommonTest, ReusesDrawPropertiesOfUnchangedSubtrees) {
+  FakeImplProxy proxy;
+  FakeLayerTreeHostImpl host_impl(&proxy);
+  scoped_ptr<LayerImpl> root = LayerImpl::Create(host_impl.active_tree(), 1);
+  scoped_ptr<LayerImpl> child1 = LayerImpl::Create(host_impl.active_tree(), 2);
+  scoped_ptr<LayerImpl> child2 = LayerImpl::Create(host_impl.active_tree(), 3);
+  scoped_ptr<LayerImpl> grand_child =
+      LayerImpl::Create(host_impl.active_tree(), 4);
+
+  gfx::Transform identity_matrix;
+  SetLayerPropertiesForTesting(root.get(),
+                               identity_matrix,
+                               identity_matrix,
+                               gfx::PointF(),
+                               gfx::PointF(),
+                               gfx::Size(100, 100),
+                               false);
+  SetLayerPropertiesForTesting(child1.get(),
+                               identity_matrix,
+                               identity_matrix,
+                               gfx::PointF(),
+                               gfx::PointF(10.f, 10.f),
+                               gfx::Size(20, 20),
+                               false);
+  SetLayerPropertiesForTesting(child2.get(),
+                               identity_matrix,
+                               identity_matrix,
+                               gfx::PointF(),
+                               gfx::PointF(50.f, 50.f),
+                               gfx::Size(20, 20),
+                               false);
+  SetLayerPropertiesForTesting(grand_child.get(),
+                               identity_matrix,
+                               identity_matrix,
+                               gfx::PointF(),
+                               gfx::PointF(5.f, 5.f),
+                               gfx::Size(10, 10),
+                               false);
+  child1->SetDrawsContent(true);
+  child2->SetDrawsContent(true);
+  grand_child->SetDrawsContent(true);
+
+  LayerImpl* child1_ptr = child1.get();
+  LayerImpl* child2_ptr = child2.get();
+  LayerImpl* grand_child_ptr = grand_child.get();
+  child2->AddChild(grand_child.Pass());
+  root->AddChild(child1.Pass());
+  root->AddChild(child2.Pass());
+
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    ASSERT_EQ(1u, render_surface_layer_list.size());
+    ASSERT_EQ(3u, root->render_surface()->layer_list().size());
+  }
+
+  // Nothing changed, so the second pass comes up with the same lists.
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.can_reuse_draw_properties = true;
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    ASSERT_EQ(1u, render_surface_layer_list.size());
+    ASSERT_EQ(3u, root->render_surface()->layer_list().size());
+    EXPECT_EQ(child1_ptr, root->render_surface()->layer_list()[0]);
+    EXPECT_EQ(child2_ptr, root->render_surface()->layer_list()[1]);
+    EXPECT_EQ(grand_child_ptr, root->render_surface()->layer_list()[2]);
+  }
+
+  // Moving a layer updates its descendants as well.
+  child2_ptr->SetPosition(gfx::PointF(60.f, 60.f));
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.can_reuse_draw_properties = true;
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    ASSERT_EQ(3u, root->render_surface()->layer_list().size());
+  }
+
+  gfx::Transform expected_child1_transform;
+  expected_child1_transform.Translate(10.0, 10.0);
+  gfx::Transform expected_grand_child_transform;
+  expected_grand_child_transform.Translate(65.0, 65.0);
+  EXPECT_TRANSFORMATION_MATRIX_EQ(expected_child1_transform,
+                                  child1_ptr->draw_transform());
+  EXPECT_TRANSFORMATION_MATRIX_EQ(expected_grand_child_transform,
+                                  grand_child_ptr->draw_transform());
+  EXPECT_RECT_EQ(gfx::Rect(65, 65, 10, 10),
+                 grand_child_ptr->drawable_content_rect());
+
+  // Hiding a layer drops its subtree from the lists.
+  child2_ptr->SetOpacity(0.f);
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.can_reuse_draw_properties = true;
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    ASSERT_EQ(1u, root->render_surface()->layer_list().size());
+    EXPECT_EQ(child1_ptr, root->render_surface()->layer_list()[0]);
+  }
+}
+
+
 TEST_F(LayerTreeHostCommonTest, HitTestingForEmptyLayerList) {
   // Hit testing on an empty render_surface_layer_list should return a null
   // pointer.
@@ -8,6 +8,7 @@
 
 #include "base/basictypes.h"
 #include "base/containers/hash_tables.h"
+#include "base/debug/trace_event_memory.h"
 #include "base/json/json_writer.h"
 #include "base/metrics/histogram.h"
 #include "base/stl_util.h"
@@ -636,6 +637,8 @@ bool LayerTreeHostImpl::CalculateRenderPasses(FrameData* frame) {
       record_metrics_for_frame);
   occlusion_tracker.set_minimum_tracking_size(
       settings_.minimum_occlusion_tracking_size);
+  occlusion_tracker.set_maximum_tracking_rects(
+      settings_.maximum_occlusion_tracking_rects);
 
   if (debug_state_.show_occluding_rects) {
     occlusion_tracker.set_occluding_screen_space_rects_container(
@@ -666,6 +669,10 @@ bool LayerTreeHostImpl::CalculateRenderPasses(FrameData* frame) {
 
   const DrawMode draw_mode = GetDrawMode(output_surface_.get());
 
+  // Covers making the quads, and culling them against the occlusion.
+  base::TimeTicks quad_culling_start_time =
+      rendering_stats_instrumentation_->StartRecording();
+
   LayerIteratorType end =
       LayerIteratorType::End(frame->render_surface_layer_list);
   for (LayerIteratorType it =
@@ -789,6 +796,9 @@ bool LayerTreeHostImpl::CalculateRenderPasses(FrameData* frame) {
                             occlusion_tracker);
   }
 
+  rendering_stats_instrumentation_->AddQuadCulling(
+      rendering_stats_instrumentation_->EndRecording(quad_culling_start_time));
+
   if (draw_frame)
     occlusion_tracker.overdraw_metrics()->RecordMetrics(this);
   else
@@ -984,6 +994,7 @@ bool LayerTreeHostImpl::PrepareToDraw(FrameData* frame,
                "LayerTreeHostImpl::PrepareToDraw",
                "SourceFrameNumber",
                active_tree_->source_frame_number());
+  TRACE_MEMORY_SUBSYSTEM("cc");
 
   if (need_to_update_visible_tiles_before_draw_) {
     DCHECK(tile_manager_);
@@ -1191,6 +1202,8 @@ CompositorFrameMetadata LayerTreeHostImpl::MakeCompositorFrameMetadata() const {
   metadata.min_page_scale_factor = active_tree_->min_page_scale_factor();
   metadata.max_page_scale_factor = active_tree_->max_page_scale_factor();
   metadata.latency_info = active_tree_->GetLatencyInfo();
+  metadata.latency_info.AddFirstLatencyNumber(
+      ui::INPUT_EVENT_LATENCY_DRAW_COMPONENT);
   if (top_controls_manager_) {
     metadata.location_bar_offset =
         gfx::Vector2dF(0.f, top_controls_manager_->controls_top_offset());
@@ -1225,6 +1238,7 @@ static void LayerTreeHostImplDidBeginTracingCallback(LayerImpl* layer) {
 void LayerTreeHostImpl::DrawLayers(FrameData* frame,
                                    base::TimeTicks frame_begin_time) {
   TRACE_EVENT0("cc", "LayerTreeHostImpl::DrawLayers");
+  TRACE_MEMORY_SUBSYSTEM("cc");
   DCHECK(CanDraw());
 
   if (frame->has_no_damage) {
@@ -1293,6 +1307,8 @@ void LayerTreeHostImpl::DrawLayers(FrameData* frame,
     temp_software_renderer->DrawFrame(&frame->render_passes);
   } else {
     renderer_->DrawFrame(&frame->render_passes);
+    rendering_stats_instrumentation_->AddDrawCalls(
+        renderer_->DrawCallsInLastFrame());
   }
   // The render passes should be consumed by the renderer.
   DCHECK(frame->render_passes.empty());
@@ -1605,7 +1621,9 @@ void LayerTreeHostImpl::CreateAndSetTileManager(
                                       resource_provider,
                                       settings_.num_raster_threads,
                                       rendering_stats_instrumentation_,
-                                      using_map_image);
+                                      using_map_image,
+                                      settings_.compress_low_priority_tiles,
+                                      settings_.gpu_rasterization);
   UpdateTileManagerMemoryPolicy(ActualManagedMemoryPolicy());
   need_to_update_visible_tiles_before_draw_ = false;
 }
@@ -8,6 +8,7 @@
 #include "base/files/file_path.h"
 #include "base/path_service.h"
 #include "base/strings/string_piece.h"
+#include "base/strings/stringprintf.h"
 #include "cc/layers/content_layer.h"
 #include "cc/layers/nine_patch_layer.h"
 #include "cc/layers/solid_color_layer.h"
@@ -211,6 +212,72 @@ TEST_F(ScrollingLayerTreePerfTest, LongScrollablePage) {
   RunTest(false, false, false);
 }
 
+// Builds a page of |num_layers| small layers, in rows of ten under a container
+// layer each, and changes the opacity of the last one on the impl thread every
+// frame, so that every frame updates the draw properties of the tree.
+class LayerTreeHostPerfTestTreeSize : public LayerTreeHostPerfTest {
+ public:
+  LayerTreeHostPerfTestTreeSize() : num_layers_(0), leaf_id_(0) {}
+
+  void RunWithNumLayers(int num_layers) {
+    num_layers_ = num_layers;
+    test_name_ = base::StringPrintf("tree_size_%d", num_layers);
+    RunTest(false, false, false);
+  }
+
+  virtual void BuildTree() OVERRIDE {
+    gfx::Size viewport = gfx::Size(720, 1038);
+    layer_tree_host()->SetViewportSize(viewport);
+    scoped_refptr<Layer> root = Layer::Create();
+    root->SetBounds(viewport);
+
+    scoped_refptr<Layer> row;
+    for (int i = 0; i < num_layers_; ++i) {
+      if (i % 10 == 0) {
+        row = Layer::Create();
+        row->SetPosition(gfx::PointF(0.f, 60.f * (i / 10)));
+        row->SetBounds(gfx::Size(viewport.width(), 50));
+        root->AddChild(row);
+      }
+      scoped_refptr<SolidColorLayer> layer = SolidColorLayer::Create();
+      layer->SetPosition(gfx::PointF(70.f * (i % 10), 0.f));
+      layer->SetBounds(gfx::Size(50, 50));
+      layer->SetBackgroundColor(SK_ColorBLUE);
+      layer->SetIsDrawable(true);
+      row->AddChild(layer);
+      leaf_id_ = layer->id();
+    }
+    layer_tree_host()->SetRootLayer(root);
+  }
+
+  virtual void DrawLayersOnThread(LayerTreeHostImpl* impl) OVERRIDE {
+    LayerImpl* leaf = impl->active_tree()->LayerById(leaf_id_);
+    if (leaf)
+      leaf->SetOpacity(leaf->opacity() == 1.f ? 0.5f : 1.f);
+    LayerTreeHostPerfTest::DrawLayersOnThread(impl);
+  }
+
+ private:
+  int num_layers_;
+  int leaf_id_;
+};
+
+TEST_F(LayerTreeHostPerfTestTreeSize, HundredLayers) {
+  RunWithNumLayers(100);
+}
+
+TEST_F(LayerTreeHostPerfTestTreeSize, FiveHundredLayers) {
+  RunWithNumLayers(500);
+}
+
+TEST_F(LayerTreeHostPerfTestTreeSize, TwoThousandLayers) {
+  RunWithNumLayers(2000);
+}
+
+TEST_F(LayerTreeHostPerfTestTreeSize, FiveThousandLayers) {
+  RunWithNumLayers(5000);
+}
+
 class ImplSidePaintingPerfTest : public LayerTreeHostPerfTestJsonReader {
  protected:
   // Run test with impl-side painting.
@@ -36,6 +36,12 @@ LayerTreeImpl::LayerTreeImpl(LayerTreeHostImpl* layer_tree_host_impl)
       contents_textures_purged_(false),
       viewport_size_invalid_(false),
       needs_update_draw_properties_(true),
+      draw_properties_are_reusable_(false),
+      last_device_scale_factor_(0),
+      last_page_scale_factor_(0),
+      last_min_page_scale_factor_(0),
+      last_page_scale_application_layer_(NULL),
+      last_max_texture_size_(0),
       needs_full_tree_sync_(true) {
 }
 
@@ -67,6 +73,7 @@ void LayerTreeImpl::SetRootLayer(scoped_ptr<LayerImpl> layer) {
   root_layer_ = layer.Pass();
   currently_scrolling_layer_ = NULL;
   root_scroll_layer_ = NULL;
+  draw_properties_are_reusable_ = false;
 
   layer_tree_host_impl_->OnCanDrawStateChangedForTree();
 }
@@ -308,7 +315,26 @@ void LayerTreeImpl::UpdateDrawProperties() {
         settings().can_use_lcd_text,
         settings().layer_transforms_should_scale_layer_contents,
         &render_surface_layer_list_);
+    inputs.can_reuse_draw_properties =
+        draw_properties_are_reusable_ &&
+        inputs.device_viewport_size == last_device_viewport_size_ &&
+        inputs.device_transform == last_device_transform_ &&
+        inputs.device_scale_factor == last_device_scale_factor_ &&
+        inputs.page_scale_factor == last_page_scale_factor_ &&
+        min_page_scale_factor_ == last_min_page_scale_factor_ &&
+        inputs.page_scale_application_layer ==
+            last_page_scale_application_layer_ &&
+        inputs.max_texture_size == last_max_texture_size_;
     LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+
+    draw_properties_are_reusable_ = true;
+    last_device_viewport_size_ = inputs.device_viewport_size;
+    last_device_transform_ = inputs.device_transform;
+    last_device_scale_factor_ = inputs.device_scale_factor;
+    last_page_scale_factor_ = inputs.page_scale_factor;
+    last_min_page_scale_factor_ = min_page_scale_factor_;
+    last_page_scale_application_layer_ = inputs.page_scale_application_layer;
+    last_max_texture_size_ = inputs.max_texture_size;
   }
 
   DCHECK(!needs_update_draw_properties_) <<
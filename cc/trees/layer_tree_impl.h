@@ -244,6 +244,17 @@ class CC_EXPORT LayerTreeImpl {
   bool viewport_size_invalid_;
   bool needs_update_draw_properties_;
 
+  // What the last draw properties update was computed for. Layers can only
+  // keep the draw properties from it while these stay the same.
+  bool draw_properties_are_reusable_;
+  gfx::Size last_device_viewport_size_;
+  gfx::Transform last_device_transform_;
+  float last_device_scale_factor_;
+  float last_page_scale_factor_;
+  float last_min_page_scale_factor_;
+  LayerImpl* last_page_scale_application_layer_;
+  int last_max_texture_size_;
+
   // In impl-side painting mode, this is true when the tree may contain
   // structural differences relative to the active tree.
   bool needs_full_tree_sync_;
@@ -17,6 +17,7 @@ LayerTreeSettings::LayerTreeSettings()
       allow_antialiasing(true),
       throttle_frame_production(true),
       begin_frame_scheduling_enabled(false),
+      deadline_scheduling_enabled(false),
       using_synchronous_renderer_compositor(false),
       per_tile_painting_enabled(false),
       partial_swap_enabled(false),
@@ -47,6 +48,7 @@ LayerTreeSettings::LayerTreeSettings()
       default_tile_size(gfx::Size(256, 256)),
       max_untiled_layer_size(gfx::Size(512, 512)),
       minimum_occlusion_tracking_size(gfx::Size(160, 160)),
+      maximum_occlusion_tracking_rects(32),
       use_pinch_zoom_scrollbars(false),
       use_pinch_virtual_viewport(false),
       // At 256x256 tiles, 128 tiles cover an area of 2048x4096 pixels.
@@ -56,6 +58,8 @@ LayerTreeSettings::LayerTreeSettings()
       force_direct_layer_drawing(false),
       strict_layer_property_change_checking(false),
       use_map_image(false),
+      compress_low_priority_tiles(false),
+      gpu_rasterization(false),
       compositor_name("ChromiumCompositor"),
       ignore_root_layer_flings(false) {
   // TODO(danakj): Renable surface caching when we can do it more realiably.
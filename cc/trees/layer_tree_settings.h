@@ -24,6 +24,7 @@ class CC_EXPORT LayerTreeSettings {
   bool allow_antialiasing;
   bool throttle_frame_production;
   bool begin_frame_scheduling_enabled;
+  bool deadline_scheduling_enabled;
   bool using_synchronous_renderer_compositor;
   bool per_tile_painting_enabled;
   bool partial_swap_enabled;
@@ -54,6 +55,7 @@ class CC_EXPORT LayerTreeSettings {
   gfx::Size default_tile_size;
   gfx::Size max_untiled_layer_size;
   gfx::Size minimum_occlusion_tracking_size;
+  size_t maximum_occlusion_tracking_rects;
   bool use_pinch_zoom_scrollbars;
   bool use_pinch_virtual_viewport;
   size_t max_tiles_for_interest_area;
@@ -62,6 +64,8 @@ class CC_EXPORT LayerTreeSettings {
   bool force_direct_layer_drawing;  // With Skia GPU backend.
   bool strict_layer_property_change_checking;
   bool use_map_image;
+  bool compress_low_priority_tiles;
+  bool gpu_rasterization;
   std::string compositor_name;
   bool ignore_root_layer_flings;
 
@@ -22,6 +22,7 @@ OcclusionTrackerBase<LayerType, RenderSurfaceType>::OcclusionTrackerBase(
     gfx::Rect screen_space_clip_rect, bool record_metrics_for_frame)
     : screen_space_clip_rect_(screen_space_clip_rect),
       overdraw_metrics_(OverdrawMetrics::Create(record_metrics_for_frame)),
+      maximum_tracking_rects_(0),
       prevent_occlusion_(false),
       occluding_screen_space_rects_(NULL),
       non_occluding_screen_space_rects_(NULL) {}
@@ -87,8 +88,7 @@ static Region TransformSurfaceOpaqueRegion(const Region& region,
   if (!transform.Preserves2dAxisAlignment())
     return Region();
 
-  // TODO(danakj): If the Region is too complex, degrade gracefully here by
-  // skipping rects in it.
+  // The region's complexity is bounded by SimplifyOcclusionAtTopOfStack().
   Region transformed_region;
   for (Region::Iterator rects(region); rects.has_rect(); rects.next()) {
     bool clipped;
@@ -216,6 +216,7 @@ void OcclusionTrackerBase<LayerType, RenderSurfaceType>::EnterRenderTarget(
           false,
           gfx::Rect(),
           old_target_to_new_target_transform));
+  SimplifyOcclusionAtTopOfStack();
 }
 
 template <typename LayerType, typename RenderSurfaceType>
@@ -380,6 +381,7 @@ void OcclusionTrackerBase<LayerType, RenderSurfaceType>::LeaveToRenderTarget(
       stack_.back().occlusion_from_outside_target.Clear();
     }
   }
+  SimplifyOcclusionAtTopOfStack();
 
   if (!old_target->background_filters().HasFilterThatMovesPixels())
     return;
@@ -476,6 +478,8 @@ void OcclusionTrackerBase<LayerType, RenderSurfaceType>::
     occluding_screen_space_rects_->push_back(screen_space_rect);
   }
 
+  SimplifyOcclusionAtTopOfStack();
+
   if (!non_occluding_screen_space_rects_)
     return;
 
@@ -506,6 +510,40 @@ void OcclusionTrackerBase<LayerType, RenderSurfaceType>::
   }
 }
 
+
+static bool HasLargerArea(gfx::Rect a, gfx::Rect b) {
+  return a.size().GetArea() > b.size().GetArea();
+}
+
+// Keeps only the |max_rects| largest rects of |region|. What remains is part
+// of the original region, so it never occludes anything that was visible.
+static void ReduceRegionToLargestRects(Region* region, size_t max_rects) {
+  if (!max_rects ||
+      region->GetRegionComplexity() <= static_cast<int>(max_rects))
+    return;
+
+  std::vector<gfx::Rect> rects;
+  for (Region::Iterator it(*region); it.has_rect(); it.next())
+    rects.push_back(it.rect());
+  if (rects.size() <= max_rects)
+    return;
+
+  std::partial_sort(
+      rects.begin(), rects.begin() + max_rects, rects.end(), HasLargerArea);
+  region->Clear();
+  for (size_t i = 0; i < max_rects; ++i)
+    region->Union(rects[i]);
+}
+
+template <typename LayerType, typename RenderSurfaceType>
+void OcclusionTrackerBase<LayerType, RenderSurfaceType>::
+    SimplifyOcclusionAtTopOfStack() {
+  ReduceRegionToLargestRects(&stack_.back().occlusion_from_inside_target,
+                             maximum_tracking_rects_);
+  ReduceRegionToLargestRects(&stack_.back().occlusion_from_outside_target,
+                             maximum_tracking_rects_);
+}
+
 template <typename LayerType, typename RenderSurfaceType>
 bool OcclusionTrackerBase<LayerType, RenderSurfaceType>::Occluded(
     const LayerType* render_target,
@@ -97,6 +97,13 @@ class CC_EXPORT OcclusionTrackerBase {
     minimum_tracking_size_ = size;
   }
 
+  // Bounds the number of rects that make up the tracked occlusion, trading
+  // accuracy for the speed of occlusion queries on pages with many occluders.
+  // When there are more, only the largest rects are kept. 0 means no bound.
+  void set_maximum_tracking_rects(size_t max_rects) {
+    maximum_tracking_rects_ = max_rects;
+  }
+
   // The following is used for visualization purposes.
   void set_occluding_screen_space_rects_container(
       std::vector<gfx::Rect>* rects) {
@@ -152,9 +159,14 @@ class CC_EXPORT OcclusionTrackerBase {
   // Add the layer's occlusion to the tracked state.
   void MarkOccludedBehindLayer(const LayerType* layer);
 
+  // Drops the smallest rects of the occlusion at the top of the stack to keep
+  // it within |maximum_tracking_rects_|.
+  void SimplifyOcclusionAtTopOfStack();
+
   gfx::Rect screen_space_clip_rect_;
   scoped_ptr<class OverdrawMetrics> overdraw_metrics_;
   gfx::Size minimum_tracking_size_;
+  size_t maximum_tracking_rects_;
   bool prevent_occlusion_;
 
   // This is used for visualizing the occlusion tracking process.
@@ -4380,6 +4380,62 @@ class OcclusionTrackerTestMinimumTrackingSize
 
 ALL_OCCLUSIONTRACKER_TEST(OcclusionTrackerTestMinimumTrackingSize);
 
+template <class Types>
+class OcclusionTrackerTestMaximumTrackingRects
+    : public OcclusionTrackerTest<Types> {
+ protected:
+  explicit OcclusionTrackerTestMaximumTrackingRects(bool opaque_layers)
+      : OcclusionTrackerTest<Types>(opaque_layers) {}
+  void RunMyTest() {
+    typename Types::ContentLayerType* parent = this->CreateRoot(
+        this->identity_matrix, gfx::PointF(), gfx::Size(400, 400));
+    typename Types::LayerType* large =
+        this->CreateDrawingLayer(parent,
+                                 this->identity_matrix,
+                                 gfx::PointF(),
+                                 gfx::Size(200, 100),
+                                 true);
+    typename Types::LayerType* medium =
+        this->CreateDrawingLayer(parent,
+                                 this->identity_matrix,
+                                 gfx::PointF(0.f, 150.f),
+                                 gfx::Size(100, 50),
+                                 true);
+    typename Types::LayerType* small =
+        this->CreateDrawingLayer(parent,
+                                 this->identity_matrix,
+                                 gfx::PointF(0.f, 250.f),
+                                 gfx::Size(50, 20),
+                                 true);
+    this->CalcDrawEtc(parent);
+
+    TestOcclusionTrackerWithClip<typename Types::LayerType,
+                                 typename Types::RenderSurfaceType> occlusion(
+        gfx::Rect(0, 0, 1000, 1000));
+    occlusion.set_maximum_tracking_rects(2);
+
+    this->VisitLayer(medium, &occlusion);
+    this->VisitLayer(small, &occlusion);
+
+    Region expected_occlusion = gfx::Rect(0, 150, 100, 50);
+    expected_occlusion.Union(gfx::Rect(0, 250, 50, 20));
+    EXPECT_EQ(expected_occlusion.ToString(),
+              occlusion.occlusion_from_inside_target().ToString());
+
+    // With a third rect, the smallest one is dropped.
+    this->VisitLayer(large, &occlusion);
+
+    expected_occlusion = gfx::Rect(0, 0, 200, 100);
+    expected_occlusion.Union(gfx::Rect(0, 150, 100, 50));
+    EXPECT_EQ(gfx::Rect().ToString(),
+              occlusion.occlusion_from_outside_target().ToString());
+    EXPECT_EQ(expected_occlusion.ToString(),
+              occlusion.occlusion_from_inside_target().ToString());
+  }
+};
+
+ALL_OCCLUSIONTRACKER_TEST(OcclusionTrackerTestMaximumTrackingRects);
+
 template <class Types>
 class OcclusionTrackerTestViewportClipIsExternalOcclusion
     : public OcclusionTrackerTest<Types> {
@@ -64,11 +64,10 @@ static inline bool AppendQuadInternal(
       SkColor color = DebugColors::CulledTileBorderColor();
       float width = DebugColors::CulledTileBorderWidth(
           layer ? layer->layer_tree_impl() : NULL);
-      scoped_ptr<DebugBorderDrawQuad> debug_border_quad =
-          DebugBorderDrawQuad::Create();
+      DebugBorderDrawQuad* debug_border_quad =
+          quad_list->AllocateAndConstruct<DebugBorderDrawQuad>();
       debug_border_quad->SetNew(
           draw_quad->shared_quad_state, draw_quad->visible_rect, color, width);
-      quad_list->push_back(debug_border_quad.PassAs<DrawQuad>());
     }
 
     // Pass the quad after we're done using it.
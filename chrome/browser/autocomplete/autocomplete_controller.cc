@@ -7,9 +7,11 @@
 #include <set>
 #include <string>
 
+#include "base/bind.h"
 #include "base/command_line.h"
 #include "base/format_macros.h"
 #include "base/logging.h"
+#include "base/message_loop/message_loop.h"
 #include "base/metrics/histogram.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
@@ -145,6 +147,9 @@ AutocompleteController::AutocompleteController(
       done_(true),
       in_start_(false),
       in_zero_suggest_(false),
+      minimal_changes_(false),
+      next_provider_to_start_(0),
+      weak_ptr_factory_(this),
       profile_(profile) {
   // AND with the disabled providers, if any.
   provider_types &= ~OmniboxFieldTrial::GetDisabledProviderTypes();
@@ -235,24 +240,19 @@ void AutocompleteController::Start(const AutocompleteInput& input) {
   expire_timer_.Stop();
   stop_timer_.Stop();
 
+  // Drop any providers deferred by the previous query.
+  weak_ptr_factory_.InvalidateWeakPtrs();
+
   // Start the new query.
   in_zero_suggest_ = false;
   in_start_ = true;
+  minimal_changes_ = minimal_changes;
+  next_provider_to_start_ = 0;
   base::TimeTicks start_time = base::TimeTicks::Now();
-  for (ACProviders::iterator i(providers_.begin()); i != providers_.end();
-       ++i) {
-    // TODO(mpearson): Remove timing code once bugs 178705 / 237703 / 168933
-    // are resolved.
-    base::TimeTicks provider_start_time = base::TimeTicks::Now();
-    (*i)->Start(input_, minimal_changes);
-    if (input.matches_requested() != AutocompleteInput::ALL_MATCHES)
-      DCHECK((*i)->done());
-    base::TimeTicks provider_end_time = base::TimeTicks::Now();
-    std::string name = std::string("Omnibox.ProviderTime.") + (*i)->GetName();
-    base::HistogramBase* counter = base::Histogram::FactoryGet(
-        name, 1, 5000, 20, base::Histogram::kUmaTargetedHistogramFlag);
-    counter->Add(static_cast<int>(
-        (provider_end_time - provider_start_time).InMilliseconds()));
+  const size_t deferred_providers = StartProviders();
+  if (input.matches_requested() == AutocompleteInput::ALL_MATCHES) {
+    UMA_HISTOGRAM_COUNTS_100("Omnibox.DeferredProviders",
+                             static_cast<int>(deferred_providers));
   }
   if (input.matches_requested() == AutocompleteInput::ALL_MATCHES &&
       (input.text().length() < 6)) {
@@ -287,6 +287,8 @@ void AutocompleteController::Start(const AutocompleteInput& input) {
 }
 
 void AutocompleteController::Stop(bool clear_result) {
+  weak_ptr_factory_.InvalidateWeakPtrs();
+  next_provider_to_start_ = providers_.size();
   for (ACProviders::const_iterator i(providers_.begin()); i != providers_.end();
        ++i) {
     (*i)->Stop(clear_result);
@@ -603,6 +605,10 @@ void AutocompleteController::NotifyChanged(bool notify_default_match) {
 }
 
 void AutocompleteController::CheckIfDone() {
+  if (next_provider_to_start_ < providers_.size()) {
+    done_ = false;
+    return;
+  }
   for (ACProviders::const_iterator i(providers_.begin()); i != providers_.end();
        ++i) {
     if (!(*i)->done()) {
@@ -613,6 +619,65 @@ void AutocompleteController::CheckIfDone() {
   done_ = true;
 }
 
+size_t AutocompleteController::StartProviders() {
+  // How long the providers' synchronous passes may take before the remaining
+  // providers are left for a separate task, so that the popup can paint the
+  // matches found so far.
+  const int kSynchronousPassDeadlineMS = 20;
+
+  // Queries that don't ask for all matches expect every provider to be done
+  // when Start() returns, so they ignore the deadline.
+  const bool use_deadline =
+      input_.matches_requested() == AutocompleteInput::ALL_MATCHES;
+  const base::TimeTicks deadline = base::TimeTicks::Now() +
+      base::TimeDelta::FromMilliseconds(kSynchronousPassDeadlineMS);
+  bool started_provider = false;
+  for (; next_provider_to_start_ < providers_.size();
+       ++next_provider_to_start_) {
+    AutocompleteProvider* provider = providers_[next_provider_to_start_];
+    // Always start at least one provider so that the query makes progress.
+    base::TimeTicks provider_start_time = base::TimeTicks::Now();
+    if (use_deadline && started_provider && provider_start_time >= deadline)
+      break;
+    started_provider = true;
+
+    // TODO(mpearson): Remove timing code once bugs 178705 / 237703 / 168933
+    // are resolved.
+    provider->Start(input_, minimal_changes_);
+    if (!use_deadline)
+      DCHECK(provider->done());
+    base::TimeTicks provider_end_time = base::TimeTicks::Now();
+    std::string name = std::string("Omnibox.ProviderTime.") +
+        provider->GetName();
+    base::HistogramBase* counter = base::Histogram::FactoryGet(
+        name, 1, 5000, 20, base::Histogram::kUmaTargetedHistogramFlag);
+    counter->Add(static_cast<int>(
+        (provider_end_time - provider_start_time).InMilliseconds()));
+  }
+
+  const size_t deferred_providers =
+      providers_.size() - next_provider_to_start_;
+  if (deferred_providers) {
+    // Clear the deferred providers' matches for the previous input, so they
+    // don't show up next to the new ones until the providers have run.
+    for (size_t i = next_provider_to_start_; i < providers_.size(); ++i)
+      providers_[i]->Stop(true);
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE,
+        base::Bind(&AutocompleteController::StartDeferredProviders,
+                   weak_ptr_factory_.GetWeakPtr()));
+  }
+  return deferred_providers;
+}
+
+void AutocompleteController::StartDeferredProviders() {
+  in_start_ = true;
+  StartProviders();
+  in_start_ = false;
+  CheckIfDone();
+  UpdateResult(false, false);
+}
+
 void AutocompleteController::StartExpireTimer() {
   // Amount of time (in ms) between when the user stops typing and
   // when we remove any copied entries. We do this from the time the
@@ -8,6 +8,7 @@
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/gtest_prod_util.h"
+#include "base/memory/weak_ptr.h"
 #include "base/strings/string16.h"
 #include "base/time/time.h"
 #include "base/timer/timer.h"
@@ -180,6 +181,15 @@ class AutocompleteController : public AutocompleteProviderListener {
   // Updates |done_| to be accurate with respect to current providers' statuses.
   void CheckIfDone();
 
+  // Starts the providers from |next_provider_to_start_| on until the
+  // synchronous pass deadline passes, and posts a task to start the rest.
+  // Returns the number of providers left to start.
+  size_t StartProviders();
+
+  // Starts the providers StartProviders() left for later and updates the
+  // result with their synchronous matches.
+  void StartDeferredProviders();
+
   // Starts |expire_timer_|.
   void StartExpireTimer();
 
@@ -238,6 +248,16 @@ class AutocompleteController : public AutocompleteProviderListener {
   // Has StartZeroSuggest() been called but not Start()?
   bool in_zero_suggest_;
 
+  // Whether the current query's input changed only minimally from the last
+  // one, and the index of the first provider that hasn't been started for it
+  // yet. Providers that would push the synchronous pass past its deadline are
+  // started in a separate task, and contribute to the next update.
+  bool minimal_changes_;
+  size_t next_provider_to_start_;
+
+  // Used to start deferred providers; invalidated when a new query starts.
+  base::WeakPtrFactory<AutocompleteController> weak_ptr_factory_;
+
   Profile* profile_;
 
   DISALLOW_COPY_AND_ASSIGN(AutocompleteController);
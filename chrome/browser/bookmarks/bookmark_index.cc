@@ -6,7 +6,6 @@
 
 #include <algorithm>
 #include <iterator>
-#include <list>
 
 #include "base/i18n/case_conversion.h"
 #include "base/strings/string16.h"
@@ -17,39 +16,15 @@
 #include "chrome/browser/history/query_parser.h"
 #include "chrome/browser/history/url_database.h"
 
-// Used when finding the set of bookmarks that match a query. Each match
-// represents a set of terms (as an interator into the Index) matching the
-// query as well as the set of nodes that contain those terms in their titles.
-struct BookmarkIndex::Match {
-  // List of terms matching the query.
-  std::list<Index::const_iterator> terms;
+namespace {
 
-  // The set of nodes matching the terms. As an optimization this is empty
-  // when we match only one term, and is filled in when we get more than one
-  // term. We can do this as when we have only one matching term we know
-  // the set of matching nodes is terms.front()->second.
-  //
-  // Use nodes_begin() and nodes_end() to get an iterator over the set as
-  // it handles the necessary switching between nodes and terms.front().
-  NodeSet nodes;
+typedef std::vector<const BookmarkNode*> NodeVector;
 
-  // Returns an iterator to the beginning of the matching nodes. See
-  // description of nodes for why this should be used over nodes.begin().
-  NodeSet::const_iterator nodes_begin() const;
-
-  // Returns an iterator to the beginning of the matching nodes. See
-  // description of nodes for why this should be used over nodes.end().
-  NodeSet::const_iterator nodes_end() const;
-};
-
-BookmarkIndex::NodeSet::const_iterator
-    BookmarkIndex::Match::nodes_begin() const {
-  return nodes.empty() ? terms.front()->second.begin() : nodes.begin();
+bool NodeVectorSizeLess(const NodeVector* a, const NodeVector* b) {
+  return a->size() < b->size();
 }
 
-BookmarkIndex::NodeSet::const_iterator BookmarkIndex::Match::nodes_end() const {
-  return nodes.empty() ? terms.front()->second.end() : nodes.end();
-}
+}  // namespace
 
 BookmarkIndex::BookmarkIndex(content::BrowserContext* browser_context)
     : browser_context_(browser_context) {
@@ -83,11 +58,29 @@ void BookmarkIndex::GetBookmarksWithTitlesMatching(
   if (terms.empty())
     return;
 
-  Matches matches;
+  // Look up the nodes for each term, then intersect them starting with the
+  // shortest lists so that the intermediate results stay small.
+  std::vector<NodeVector> term_nodes(terms.size());
+  std::vector<const NodeVector*> sorted_term_nodes(terms.size());
   for (size_t i = 0; i < terms.size(); ++i) {
-    if (!GetBookmarksWithTitleMatchingTerm(terms[i], i == 0, &matches))
+    if (!GetBookmarksWithTitleMatchingTerm(terms[i], &term_nodes[i]))
       return;
+    sorted_term_nodes[i] = &term_nodes[i];
   }
+  std::sort(sorted_term_nodes.begin(), sorted_term_nodes.end(),
+            &NodeVectorSizeLess);
+
+  NodeVector matches(*sorted_term_nodes[0]);
+  for (size_t i = 1; i < sorted_term_nodes.size() && !matches.empty(); ++i) {
+    NodeVector intersection;
+    std::set_intersection(matches.begin(), matches.end(),
+                          sorted_term_nodes[i]->begin(),
+                          sorted_term_nodes[i]->end(),
+                          std::back_inserter(intersection));
+    matches.swap(intersection);
+  }
+  if (matches.empty())
+    return;
 
   NodeTypedCountPairs node_typed_counts;
   SortMatches(matches, &node_typed_counts);
@@ -109,7 +102,7 @@ void BookmarkIndex::GetBookmarksWithTitlesMatching(
     AddMatchToResults(i->first, &parser, query_nodes.get(), results);
 }
 
-void BookmarkIndex::SortMatches(const Matches& matches,
+void BookmarkIndex::SortMatches(const NodeVector& nodes,
                                 NodeTypedCountPairs* node_typed_counts) const {
   HistoryService* const history_service = browser_context_ ?
       HistoryServiceFactory::GetForProfile(
@@ -119,30 +112,16 @@ void BookmarkIndex::SortMatches(const Matches& matches,
   history::URLDatabase* url_db = history_service ?
       history_service->InMemoryDatabase() : NULL;
 
-  for (Matches::const_iterator i = matches.begin(); i != matches.end(); ++i)
-    ExtractBookmarkNodePairs(url_db, *i, node_typed_counts);
-
-  std::sort(node_typed_counts->begin(), node_typed_counts->end(),
-            &NodeTypedCountPairSortFunc);
-  // Eliminate duplicates.
-  node_typed_counts->erase(std::unique(node_typed_counts->begin(),
-                                       node_typed_counts->end()),
-                           node_typed_counts->end());
-}
-
-void BookmarkIndex::ExtractBookmarkNodePairs(
-    history::URLDatabase* url_db,
-    const Match& match,
-    NodeTypedCountPairs* node_typed_counts) const {
-
-  for (NodeSet::const_iterator i = match.nodes_begin();
-       i != match.nodes_end(); ++i) {
+  node_typed_counts->reserve(nodes.size());
+  for (NodeVector::const_iterator i = nodes.begin(); i != nodes.end(); ++i) {
     history::URLRow url;
     if (url_db)
       url_db->GetRowForURL((*i)->url(), &url);
-    NodeTypedCountPair pair(*i, url.typed_count());
-    node_typed_counts->push_back(pair);
+    node_typed_counts->push_back(NodeTypedCountPair(*i, url.typed_count()));
   }
+
+  std::sort(node_typed_counts->begin(), node_typed_counts->end(),
+            &NodeTypedCountPairSortFunc);
 }
 
 void BookmarkIndex::AddMatchToResults(
@@ -163,9 +142,9 @@ void BookmarkIndex::AddMatchToResults(
   }
 }
 
-bool BookmarkIndex::GetBookmarksWithTitleMatchingTerm(const string16& term,
-                                                      bool first_term,
-                                                      Matches* matches) {
+bool BookmarkIndex::GetBookmarksWithTitleMatchingTerm(
+    const string16& term,
+    NodeVector* nodes) const {
   Index::const_iterator i = index_.lower_bound(term);
   if (i == index_.end())
     return false;
@@ -174,75 +153,36 @@ bool BookmarkIndex::GetBookmarksWithTitleMatchingTerm(const string16& term,
     // Term is too short for prefix match, compare using exact match.
     if (i->first != term)
       return false;  // No bookmarks with this term.
-
-    if (first_term) {
-      Match match;
-      match.terms.push_back(i);
-      matches->push_back(match);
-      return true;
-    }
-    CombineMatchesInPlace(i, matches);
-  } else if (first_term) {
-    // This is the first term and we're doing a prefix match. Loop through
-    // index adding all entries that start with term to matches.
-    while (i != index_.end() &&
-           i->first.size() >= term.size() &&
-           term.compare(0, term.size(), i->first, 0, term.size()) == 0) {
-      Match match;
-      match.terms.push_back(i);
-      matches->push_back(match);
-      ++i;
-    }
-  } else {
-    // Prefix match and not the first term. Loop through index combining
-    // current matches in matches with term, placing result in result.
-    Matches result;
-    while (i != index_.end() &&
-           i->first.size() >= term.size() &&
-           term.compare(0, term.size(), i->first, 0, term.size()) == 0) {
-      CombineMatches(i, *matches, &result);
-      ++i;
-    }
-    matches->swap(result);
+    *nodes = i->second;
+    return true;
   }
-  return !matches->empty();
-}
 
-void BookmarkIndex::CombineMatchesInPlace(const Index::const_iterator& index_i,
-                                          Matches* matches) {
-  for (size_t i = 0; i < matches->size(); ) {
-    Match* match = &((*matches)[i]);
-    NodeSet intersection;
-    std::set_intersection(match->nodes_begin(), match->nodes_end(),
-                          index_i->second.begin(), index_i->second.end(),
-                          std::inserter(intersection, intersection.begin()));
-    if (intersection.empty()) {
-      matches->erase(matches->begin() + i);
-    } else {
-      match->terms.push_back(index_i);
-      match->nodes.swap(intersection);
-      ++i;
-    }
+  // Prefix match. The words starting with |term| are adjacent in the index;
+  // merge their lists into one sorted, de-duped list. A single matching word,
+  // the common case for longer terms, needs no merging.
+  Index::const_iterator first = i;
+  size_t total_nodes = 0;
+  while (i != index_.end() &&
+         i->first.size() >= term.size() &&
+         term.compare(0, term.size(), i->first, 0, term.size()) == 0) {
+    total_nodes += i->second.size();
+    ++i;
   }
-}
-
-void BookmarkIndex::CombineMatches(const Index::const_iterator& index_i,
-                                   const Matches& current_matches,
-                                   Matches* result) {
-  for (size_t i = 0; i < current_matches.size(); ++i) {
-    const Match& match = current_matches[i];
-    NodeSet intersection;
-    std::set_intersection(match.nodes_begin(), match.nodes_end(),
-                          index_i->second.begin(), index_i->second.end(),
-                          std::inserter(intersection, intersection.begin()));
-    if (!intersection.empty()) {
-      result->push_back(Match());
-      Match& combined_match = result->back();
-      combined_match.terms = match.terms;
-      combined_match.terms.push_back(index_i);
-      combined_match.nodes.swap(intersection);
-    }
+  if (first == i)
+    return false;
+  Index::const_iterator last = i;
+  Index::const_iterator second = first;
+  if (++second == last) {
+    *nodes = first->second;
+    return true;
   }
+  nodes->clear();
+  nodes->reserve(total_nodes);
+  for (i = first; i != last; ++i)
+    nodes->insert(nodes->end(), i->second.begin(), i->second.end());
+  std::sort(nodes->begin(), nodes->end());
+  nodes->erase(std::unique(nodes->begin(), nodes->end()), nodes->end());
+  return true;
 }
 
 std::vector<string16> BookmarkIndex::ExtractQueryWords(const string16& query) {
@@ -258,7 +198,12 @@ std::vector<string16> BookmarkIndex::ExtractQueryWords(const string16& query) {
 
 void BookmarkIndex::RegisterNode(const string16& term,
                                  const BookmarkNode* node) {
-  index_[term].insert(node);
+  NodeVector& nodes = index_[term];
+  NodeVector::iterator i = std::lower_bound(nodes.begin(), nodes.end(), node);
+  // The node is already registered if its title has the same term more than
+  // once.
+  if (i == nodes.end() || *i != node)
+    nodes.insert(i, node);
 }
 
 void BookmarkIndex::UnregisterNode(const string16& term,
@@ -269,7 +214,10 @@ void BookmarkIndex::UnregisterNode(const string16& term,
     // example, a bookmark with the title 'foo foo' would end up here.
     return;
   }
-  i->second.erase(node);
+  NodeVector::iterator node_i =
+      std::lower_bound(i->second.begin(), i->second.end(), node);
+  if (node_i != i->second.end() && *node_i == node)
+    i->second.erase(node_i);
   if (i->second.empty())
     index_.erase(i);
 }
@@ -6,7 +6,6 @@
 #define CHROME_BROWSER_BOOKMARKS_BOOKMARK_INDEX_H_
 
 #include <map>
-#include <set>
 #include <vector>
 
 #include "base/basictypes.h"
@@ -29,9 +28,12 @@ class URLDatabase;
 // look up. BookmarkIndex is owned and maintained by BookmarkModel, you
 // shouldn't need to interact directly with BookmarkIndex.
 //
-// BookmarkIndex maintains the index (index_) as a map of sets. The map (type
-// Index) maps from a lower case string to the set (type NodeSet) of
-// BookmarkNodes that contain that string in their title.
+// BookmarkIndex maintains the index (index_) as a map of posting lists. The
+// map (type Index) maps from a lower case string to the vector (type
+// NodeVector) of BookmarkNodes that contain that string in their title. The
+// vectors are kept sorted so that the lists of several terms can be merged and
+// intersected in linear time, and since the map is sorted by string all the
+// words starting with a given prefix are adjacent.
 class BookmarkIndex {
  public:
   explicit BookmarkIndex(content::BrowserContext* browser_context);
@@ -50,30 +52,20 @@ class BookmarkIndex {
       std::vector<BookmarkTitleMatch>* results);
 
  private:
-  typedef std::set<const BookmarkNode*> NodeSet;
-  typedef std::map<string16, NodeSet> Index;
-
-  struct Match;
-  typedef std::vector<Match> Matches;
+  typedef std::vector<const BookmarkNode*> NodeVector;
+  typedef std::map<string16, NodeVector> Index;
 
   // Pairs BookmarkNodes and the number of times the nodes' URLs were typed.
-  // Used to sort Matches in decreasing order of typed count.
+  // Used to sort matches in decreasing order of typed count.
   typedef std::pair<const BookmarkNode*, int> NodeTypedCountPair;
   typedef std::vector<NodeTypedCountPair> NodeTypedCountPairs;
 
-  // Extracts |matches.nodes| into NodeTypedCountPairs, sorts the pairs in
-  // decreasing order of typed count, and then de-dupes the matches.
-  void SortMatches(const Matches& matches,
+  // Retrieves the typed count of each of |nodes| from the in-memory database
+  // and fills |node_typed_counts| with the nodes, sorted in decreasing order
+  // of typed count.
+  void SortMatches(const NodeVector& nodes,
                    NodeTypedCountPairs* node_typed_counts) const;
 
-  // Extracts BookmarkNodes from |match| and retrieves typed counts for each
-  // node from the in-memory database. Inserts pairs containing the node and
-  // typed count into the vector |node_typed_counts|. |node_typed_counts| is
-  // sorted in decreasing order of typed count.
-  void ExtractBookmarkNodePairs(history::URLDatabase* url_db,
-                                const Match& match,
-                                NodeTypedCountPairs* node_typed_counts) const;
-
   // Sort function for NodeTypedCountPairs. We sort in decreasing order of typed
   // count so that the best matches will always be added to the results.
   static bool NodeTypedCountPairSortFunc(const NodeTypedCountPair& a,
@@ -87,33 +79,11 @@ class BookmarkIndex {
                          const std::vector<QueryNode*>& query_nodes,
                          std::vector<BookmarkTitleMatch>* results);
 
-  // Populates |matches| for the specified term. If |first_term| is true, this
-  // is the first term in the query. Returns true if there is at least one node
-  // matching the term.
+  // Sets |nodes| to the sorted set of nodes with a title word matching |term|,
+  // either exactly or, if |term| is long enough, as a prefix. Returns true if
+  // there is at least one such node.
   bool GetBookmarksWithTitleMatchingTerm(const string16& term,
-                                         bool first_term,
-                                         Matches* matches);
-
-  // Iterates over |matches| updating each Match's nodes to contain the
-  // intersection of the Match's current nodes and the nodes at |index_i|.
-  // If the intersection is empty, the Match is removed.
-  //
-  // This is invoked from GetBookmarksWithTitleMatchingTerm.
-  void CombineMatchesInPlace(const Index::const_iterator& index_i,
-                             Matches* matches);
-
-  // Iterates over |current_matches| calculating the intersection between the
-  // Match's nodes and the nodes at |index_i|. If the intersection between the
-  // two is non-empty, a new match is added to |result|.
-  //
-  // This differs from CombineMatchesInPlace in that if the intersection is
-  // non-empty the result is added to result, not combined in place. This
-  // variant is used for prefix matching.
-  //
-  // This is invoked from GetBookmarksWithTitleMatchingTerm.
-  void CombineMatches(const Index::const_iterator& index_i,
-                      const Matches& current_matches,
-                      Matches* result);
+                                         NodeVector* nodes) const;
 
   // Returns the set of query words from |query|.
   std::vector<string16> ExtractQueryWords(const string16& query);
@@ -11,7 +11,9 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
 #include "chrome/browser/bookmarks/bookmark_model.h"
 #include "chrome/browser/bookmarks/bookmark_model_factory.h"
 #include "chrome/browser/bookmarks/bookmark_title_match.h"
@@ -310,3 +312,39 @@ TEST_F(BookmarkIndexTest, GetResultsSortedByTypedCount) {
   EXPECT_EQ(data[0].url, matches[0].node->url());
   EXPECT_EQ(data[3].url, matches[1].node->url());
 }
+
+// Exercises an index large enough that prefix terms match many words, and logs
+// how long building and querying it takes.
+TEST_F(BookmarkIndexTest, ManyBookmarks) {
+  const int kBookmarkCount = 10000;
+  std::vector<std::string> titles;
+  for (int i = 0; i < kBookmarkCount; ++i)
+    titles.push_back(base::StringPrintf("title%d group%d", i, i % 10));
+  base::TimeTicks start_time = base::TimeTicks::Now();
+  AddBookmarksWithTitles(titles);
+  VLOG(1) << "Indexed " << kBookmarkCount << " bookmarks in "
+          << (base::TimeTicks::Now() - start_time).InMillisecondsF() << "ms";
+
+  // "title45" prefixes title45, title450-459 and title4500-4599, of which
+  // title453 and title4503, title4513, ..., title4593 are in group3.
+  start_time = base::TimeTicks::Now();
+  std::vector<BookmarkTitleMatch> matches;
+  model_->GetBookmarksWithTitlesMatching(ASCIIToUTF16("group3 title45"), 1000,
+                                         &matches);
+  VLOG(1) << "Queried in "
+          << (base::TimeTicks::Now() - start_time).InMillisecondsF() << "ms";
+  EXPECT_EQ(11U, matches.size());
+
+  // "tit" prefixes every title, so only the group limits the results.
+  matches.clear();
+  model_->GetBookmarksWithTitlesMatching(ASCIIToUTF16("tit group7"),
+                                         kBookmarkCount, &matches);
+  EXPECT_EQ(static_cast<size_t>(kBookmarkCount / 10), matches.size());
+
+  // Removing a bookmark updates the index incrementally.
+  model_->Remove(model_->other_node(), 453);
+  matches.clear();
+  model_->GetBookmarksWithTitlesMatching(ASCIIToUTF16("group3 title45"), 1000,
+                                         &matches);
+  EXPECT_EQ(10U, matches.size());
+}
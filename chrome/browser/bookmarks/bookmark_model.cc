@@ -810,8 +810,10 @@ void BookmarkModel::DoneLoading(BookmarkLoadDetails* details_delete_me) {
 
   {
     base::AutoLock url_lock(url_lock_);
-    // Update nodes_ordered_by_url_set_ from the nodes.
-    PopulateNodesByURL(&root_);
+    // Update nodes_ordered_by_url_set_ from the nodes. They were sorted on the
+    // background thread, so this inserts each of them in constant time.
+    nodes_ordered_by_url_set_.insert(details->url_nodes()->begin(),
+                                     details->url_nodes()->end());
   }
 
   loaded_ = true;
@@ -1032,15 +1034,6 @@ void BookmarkModel::Observe(int type,
   }
 }
 
-void BookmarkModel::PopulateNodesByURL(BookmarkNode* node) {
-  // NOTE: this is called with url_lock_ already held. As such, this doesn't
-  // explicitly grab the lock.
-  if (node->is_url())
-    nodes_ordered_by_url_set_.insert(node);
-  for (int i = 0; i < node->child_count(); ++i)
-    PopulateNodesByURL(node->GetChild(i));
-}
-
 int64 BookmarkModel::generate_next_node_id() {
   return next_node_id_++;
 }
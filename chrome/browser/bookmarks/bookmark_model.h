@@ -440,9 +440,6 @@ class BookmarkModel : public content::NotificationObserver,
   // BookmarkModel takes ownership of |details|.
   void DoneLoading(BookmarkLoadDetails* details);
 
-  // Populates |nodes_ordered_by_url_set_| from root.
-  void PopulateNodesByURL(BookmarkNode* node);
-
   // Removes the node from its parent, but does not delete it. No notifications
   // are sent. |removed_urls| is populated with the urls which no longer have
   // any bookmarks associated with them.
@@ -4,6 +4,8 @@
 
 #include "chrome/browser/bookmarks/bookmark_storage.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/file_util.h"
@@ -31,15 +33,23 @@ const base::FilePath::CharType kBackupExtension[] = FILE_PATH_LITERAL("bak");
 // How often we save.
 const int kSaveDelayMS = 2500;
 
+// How often we save once the bookmarks file has grown past
+// |kLargeFileBytes|. Every save rewrites the whole file, so a large file is
+// given longer for changes to coalesce into a single write.
+const int kLargeFileSaveDelayMS = 10000;
+const size_t kLargeFileBytes = 1024 * 1024;
+
 void BackupCallback(const base::FilePath& path) {
   base::FilePath backup_path = path.ReplaceExtension(kBackupExtension);
   base::CopyFile(path, backup_path);
 }
 
-// Adds node to the model's index, recursing through all children as well.
+// Adds node to the model's index and to the list of URL nodes, recursing
+// through all children as well.
 void AddBookmarksToIndex(BookmarkLoadDetails* details,
                          BookmarkNode* node) {
   if (node->is_url()) {
+    details->url_nodes()->push_back(node);
     if (node->url().is_valid())
       details->index()->Add(node);
   } else {
@@ -48,6 +58,10 @@ void AddBookmarksToIndex(BookmarkLoadDetails* details,
   }
 }
 
+bool NodeURLLess(const BookmarkNode* a, const BookmarkNode* b) {
+  return a->url() < b->url();
+}
+
 void LoadCallback(const base::FilePath& path,
                   BookmarkStorage* storage,
                   BookmarkLoadDetails* details) {
@@ -55,15 +69,23 @@ void LoadCallback(const base::FilePath& path,
       scoped_timer("Startup.SlowStartupBookmarksLoad");
   bool bookmark_file_exists = base::PathExists(path);
   if (bookmark_file_exists) {
+    int64 file_size = 0;
+    if (file_util::GetFileSize(path, &file_size)) {
+      UMA_HISTOGRAM_MEMORY_KB("Bookmarks.FileSizeKB",
+                              static_cast<int>(file_size / 1024));
+    }
+
+    TimeTicks start_time = TimeTicks::Now();
     JSONFileValueSerializer serializer(path);
     scoped_ptr<Value> root(serializer.Deserialize(NULL, NULL));
+    UMA_HISTOGRAM_TIMES("Bookmarks.ParseTime", TimeTicks::Now() - start_time);
 
     if (root.get()) {
       // Building the index can take a while, so we do it on the background
       // thread.
       int64 max_node_id = 0;
       BookmarkCodec codec;
-      TimeTicks start_time = TimeTicks::Now();
+      start_time = TimeTicks::Now();
       codec.Decode(details->bb_node(), details->other_folder_node(),
                    details->mobile_folder_node(), &max_node_id, *root.get());
       details->set_max_id(std::max(max_node_id, details->max_id()));
@@ -80,6 +102,16 @@ void LoadCallback(const base::FilePath& path,
       AddBookmarksToIndex(details, details->mobile_folder_node());
       UMA_HISTOGRAM_TIMES("Bookmarks.CreateBookmarkIndexTime",
                           TimeTicks::Now() - start_time);
+
+      // Sort the URL nodes here too, so that the model only has to copy them
+      // into its set when it takes over the tree on the UI thread.
+      start_time = TimeTicks::Now();
+      std::sort(details->url_nodes()->begin(), details->url_nodes()->end(),
+                &NodeURLLess);
+      UMA_HISTOGRAM_TIMES("Bookmarks.SortNodesByURLTime",
+                          TimeTicks::Now() - start_time);
+      UMA_HISTOGRAM_COUNTS("Bookmarks.URLNodeCount",
+                           static_cast<int>(details->url_nodes()->size()));
     }
   }
 
@@ -152,11 +184,19 @@ void BookmarkStorage::BookmarkModelDeleted() {
 }
 
 bool BookmarkStorage::SerializeData(std::string* output) {
+  TimeTicks start_time = TimeTicks::Now();
   BookmarkCodec codec;
   scoped_ptr<Value> value(codec.Encode(model_));
   JSONStringValueSerializer serializer(output);
   serializer.set_pretty_print(true);
-  return serializer.Serialize(*(value.get()));
+  if (!serializer.Serialize(*(value.get())))
+    return false;
+  UMA_HISTOGRAM_TIMES("Bookmarks.SerializeTime", TimeTicks::Now() - start_time);
+
+  writer_.set_commit_interval(base::TimeDelta::FromMilliseconds(
+      output->size() >= kLargeFileBytes ? kLargeFileSaveDelayMS
+                                        : kSaveDelayMS));
+  return true;
 }
 
 void BookmarkStorage::OnLoadFinished() {
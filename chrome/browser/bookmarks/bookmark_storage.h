@@ -5,12 +5,15 @@
 #ifndef CHROME_BROWSER_BOOKMARKS_BOOKMARK_STORAGE_H_
 #define CHROME_BROWSER_BOOKMARKS_BOOKMARK_STORAGE_H_
 
+#include <vector>
+
 #include "base/files/important_file_writer.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 
 class BookmarkIndex;
 class BookmarkModel;
+class BookmarkNode;
 class BookmarkPermanentNode;
 
 namespace base {
@@ -24,7 +27,7 @@ class BrowserContext;
 // BookmarkLoadDetails is used by BookmarkStorage when loading bookmarks.
 // BookmarkModel creates a BookmarkLoadDetails and passes it (including
 // ownership) to BookmarkStorage. BookmarkStorage loads the bookmarks (and
-// index) in the background thread, then calls back to the BookmarkModel (on
+// index, and the list of nodes ordered by URL) in the background thread, then calls back to the BookmarkModel (on
 // the main thread) when loading is done, passing ownership back to the
 // BookmarkModel. While loading BookmarkModel does not maintain references to
 // the contents of the BookmarkLoadDetails, this ensures we don't have any
@@ -55,6 +58,9 @@ class BookmarkLoadDetails {
   BookmarkIndex* index() { return index_.get(); }
   BookmarkIndex* release_index() { return index_.release(); }
 
+  // The URL nodes of the loaded tree, sorted by URL.
+  std::vector<BookmarkNode*>* url_nodes() { return &url_nodes_; }
+
   const std::string& model_meta_info() { return model_meta_info_; }
   void set_model_meta_info(const std::string& meta_info) {
     model_meta_info_ = meta_info;
@@ -88,6 +94,7 @@ class BookmarkLoadDetails {
   scoped_ptr<BookmarkPermanentNode> other_folder_node_;
   scoped_ptr<BookmarkPermanentNode> mobile_folder_node_;
   scoped_ptr<BookmarkIndex> index_;
+  std::vector<BookmarkNode*> url_nodes_;
   std::string model_meta_info_;
   int64 max_id_;
   std::string computed_checksum_;
@@ -13,6 +13,7 @@
 
 #include "base/at_exit.h"
 #include "base/bind.h"
+#include "base/bind_helpers.h"
 #include "base/command_line.h"
 #include "base/debug/debugger.h"
 #include "base/debug/trace_event.h"
@@ -93,6 +94,7 @@
 #include "chrome/browser/renderer_host/chrome_render_view_host_observer.h"
 #include "chrome/browser/service/service_process_control.h"
 #include "chrome/browser/shell_integration.h"
+#include "chrome/browser/startup_task_graph.h"
 #include "chrome/browser/three_d_api_observer.h"
 #include "chrome/browser/translate/translate_manager.h"
 #include "chrome/browser/ui/app_list/app_list_service.h"
@@ -197,6 +199,10 @@ using content::BrowserThread;
 
 namespace {
 
+// How long the startup work that can wait for the first tab waits if the
+// initial page doesn't finish loading.
+const int kDeferredStartupTasksDelaySeconds = 10;
+
 // This function provides some ways to test crash and assertion handling
 // behavior of the program.
 void HandleTestParameters(const CommandLine& command_line) {
@@ -485,10 +491,11 @@ void LaunchDevToolsHandlerIfNeeded(const CommandLine& command_line) {
 }
 
 // Heap allocated class that listens for first page load, kicks off stat
-// recording and then deletes itself.
+// recording and the deferred startup tasks, and then deletes itself.
 class LoadCompleteListener : public content::NotificationObserver {
  public:
-  LoadCompleteListener() {
+  explicit LoadCompleteListener(StartupTaskGraph* startup_task_graph)
+      : startup_task_graph_(startup_task_graph) {
     registrar_.Add(this,
                    content::NOTIFICATION_LOAD_COMPLETED_MAIN_FRAME,
                    content::NotificationService::AllSources());
@@ -501,14 +508,34 @@ class LoadCompleteListener : public content::NotificationObserver {
                        const content::NotificationDetails& details) OVERRIDE {
     DCHECK_EQ(content::NOTIFICATION_LOAD_COMPLETED_MAIN_FRAME, type);
     startup_metric_utils::OnInitialPageLoadComplete();
+    if (startup_task_graph_.get())
+      startup_task_graph_->RunDeferredTasks();
     delete this;
   }
 
  private:
+  scoped_refptr<StartupTaskGraph> startup_task_graph_;
   content::NotificationRegistrar registrar_;
   DISALLOW_COPY_AND_ASSIGN(LoadCompleteListener);
 };
 
+void RecordLanguageUsageMetrics(Profile* profile) {
+  LanguageUsageMetrics::RecordAcceptLanguages(
+      profile->GetPrefs()->GetString(prefs::kAcceptLanguages));
+  LanguageUsageMetrics::RecordApplicationLanguage(
+      g_browser_process->GetApplicationLocale());
+}
+
+#if !defined(OS_ANDROID)
+void StartVariationsServiceFetches(
+    chrome_variations::VariationsService* variations_service) {
+  variations_service->StartRepeatedVariationsSeedFetch();
+#if defined(OS_WIN)
+  variations_service->StartGoogleUpdateRegistrySync();
+#endif
+}
+#endif
+
 void RenderViewHostCreated(content::RenderViewHost* render_view_host) {
   content::SiteInstance* site_instance = render_view_host->GetSiteInstance();
   Profile* profile = Profile::FromBrowserContext(
@@ -704,7 +731,7 @@ void ChromeBrowserMainParts::RecordBrowserStartupTime() {
   startup_metric_utils::OnBrowserStartupComplete(is_first_run);
 
   // Deletes self.
-  new LoadCompleteListener();
+  new LoadCompleteListener(startup_task_graph_.get());
 }
 
 // This code is specific to the Windows-only PreReadExperiment field-trial.
@@ -859,6 +886,16 @@ int ChromeBrowserMainParts::PreCreateThreadsImpl() {
     tracked_objects::ThreadData::InitializeAndSetTrackingStatus(status);
   }
 
+  if (parsed_command_line().HasSwitch(switches::kProfilingSamplingInterval)) {
+    // Child processes pick the interval up along with the tracking status.
+    int sampling_interval;
+    if (base::StringToInt(parsed_command_line().GetSwitchValueASCII(
+            switches::kProfilingSamplingInterval), &sampling_interval) &&
+        sampling_interval >= 1) {
+      tracked_objects::ThreadData::SetSamplingInterval(sampling_interval);
+    }
+  }
+
   if (parsed_command_line().HasSwitch(switches::kProfilingOutputFile)) {
     tracking_objects_.set_output_file_path(
         parsed_command_line().GetSwitchValuePath(
@@ -1437,10 +1474,16 @@ int ChromeBrowserMainParts::PreMainMessageLoopRunImpl() {
   browser_process_->metrics_service()->RecordBreakpadHasDebugger(
       base::debug::BeingDebugged());
 
-  LanguageUsageMetrics::RecordAcceptLanguages(
-      profile_->GetPrefs()->GetString(prefs::kAcceptLanguages));
-  LanguageUsageMetrics::RecordApplicationLanguage(
-      browser_process_->GetApplicationLocale());
+  // Work that isn't needed to show the first tab is added to the startup
+  // task graph, which runs it off the UI thread or after the initial page
+  // has loaded.
+  startup_task_graph_ = new StartupTaskGraph;
+  startup_task_graph_->AddTask("LanguageUsageMetrics",
+                               std::vector<std::string>(),
+                               StartupTaskGraph::UI_THREAD,
+                               StartupTaskGraph::AFTER_FIRST_PAINT,
+                               base::Bind(&RecordLanguageUsageMetrics,
+                                          profile_));
 
   // The extension service may be available at this point. If the command line
   // specifies --uninstall-extension, attempt the uninstall extension startup
@@ -1540,11 +1583,17 @@ int ChromeBrowserMainParts::PreMainMessageLoopRunImpl() {
     // available while the browser is running.  We need to save the last
     // modified time of the exe, so we can compare to determine if there is
     // an upgrade while the browser is kept alive by a persistent extension.
-    upgrade_util::SaveLastModifiedTimeOfExe();
+    startup_task_graph_->AddTask(
+        "SaveLastModifiedTimeOfExe", std::vector<std::string>(),
+        StartupTaskGraph::BLOCKING_POOL, StartupTaskGraph::AFTER_FIRST_PAINT,
+        base::Bind(&upgrade_util::SaveLastModifiedTimeOfExe));
 #endif
 
     // Record now as the last successful chrome start.
-    GoogleUpdateSettings::SetLastRunTime();
+    startup_task_graph_->AddTask(
+        "SetLastRunTime", std::vector<std::string>(),
+        StartupTaskGraph::BLOCKING_POOL, StartupTaskGraph::AFTER_FIRST_PAINT,
+        base::Bind(base::IgnoreResult(&GoogleUpdateSettings::SetLastRunTime)));
 
 #if defined(OS_MACOSX)
     // Call Recycle() here as late as possible, before going into the loop
@@ -1564,16 +1613,19 @@ int ChromeBrowserMainParts::PreMainMessageLoopRunImpl() {
       chrome_variations::VariationsService* variations_service =
           browser_process_->variations_service();
       if (variations_service) {
-        variations_service->StartRepeatedVariationsSeedFetch();
-
-#if defined(OS_WIN)
-        variations_service->StartGoogleUpdateRegistrySync();
-#endif
+        startup_task_graph_->AddTask(
+            "VariationsServiceFetches", std::vector<std::string>(),
+            StartupTaskGraph::UI_THREAD, StartupTaskGraph::AFTER_FIRST_PAINT,
+            base::Bind(&StartVariationsServiceFetches, variations_service));
       }
 
       if (translate_manager_ != NULL) {
-        translate_manager_->FetchLanguageListFromTranslateServer(
-            profile_->GetPrefs());
+        startup_task_graph_->AddTask(
+            "FetchTranslateLanguageList", std::vector<std::string>(),
+            StartupTaskGraph::UI_THREAD, StartupTaskGraph::AFTER_FIRST_PAINT,
+            base::Bind(&TranslateManager::FetchLanguageListFromTranslateServer,
+                       base::Unretained(translate_manager_),
+                       profile_->GetPrefs()));
       }
     }
 
@@ -1586,6 +1638,10 @@ int ChromeBrowserMainParts::PreMainMessageLoopRunImpl() {
 
   PostBrowserStart();
 
+  startup_task_graph_->RunStartupTasks();
+  startup_task_graph_->RunDeferredTasksAfter(
+      base::TimeDelta::FromSeconds(kDeferredStartupTasksDelaySeconds));
+
   if (parameters().ui_task) {
     // We end the startup timer here if we have parameters to run, because we
     // never start to run the main loop (where we normally stop the timer).
@@ -27,6 +27,7 @@ class MetricsService;
 class PrefService;
 class Profile;
 class StartupBrowserCreator;
+class StartupTaskGraph;
 class StartupTimeBomb;
 class ShutdownWatcherHelper;
 class ThreeDAPIObserver;
@@ -187,6 +188,10 @@ class ChromeBrowserMainParts : public content::BrowserMainParts {
   ProcessSingleton::NotifyResult notify_result_;
   scoped_ptr<ThreeDAPIObserver> three_d_observer_;
 
+  // Startup work that runs concurrently or after the first tab is shown.
+  // Created in PreMainMessageLoopRunImpl.
+  scoped_refptr<StartupTaskGraph> startup_task_graph_;
+
   // Initialized in SetupMetricsAndFieldTrials.
   scoped_refptr<FieldTrialSynchronizer> field_trial_synchronizer_;
 
@@ -150,9 +150,11 @@ std::string DeriveCommandLine(const GURL& start_url,
       // content/browser/renderer_host/render_process_host_impl.cc.
       cc::switches::kBackgroundColorInsteadOfCheckerboard,
       cc::switches::kCompositeToMailbox,
+      cc::switches::kCompressLowPriorityTiles,
       cc::switches::kDisableCompositedAntialiasing,
       cc::switches::kDisableImplSidePainting,
       cc::switches::kDisableThreadedAnimation,
+      cc::switches::kEnableGpuRasterization,
       cc::switches::kEnableImplSidePainting,
       cc::switches::kEnablePartialSwap,
       cc::switches::kEnablePerTilePainting,
@@ -12,6 +12,7 @@
 #include "chrome/browser/extensions/api/declarative_webrequest/request_stage.h"
 #include "chrome/browser/extensions/api/declarative_webrequest/webrequest_condition_attribute.h"
 #include "chrome/browser/extensions/api/declarative_webrequest/webrequest_constants.h"
+#include "content/public/browser/resource_request_info.h"
 #include "extensions/common/matcher/url_matcher_factory.h"
 #include "net/url_request/url_request.h"
 
@@ -77,10 +78,22 @@ WebRequestCondition::WebRequestCondition(
     : url_matcher_conditions_(url_matcher_conditions),
       first_party_url_matcher_conditions_(first_party_url_matcher_conditions),
       condition_attributes_(condition_attributes),
-      applicable_request_stages_(~0) {
+      applicable_request_stages_(~0),
+      resource_types_(~0) {
   for (WebRequestConditionAttributes::const_iterator i =
        condition_attributes_.begin(); i != condition_attributes_.end(); ++i) {
     applicable_request_stages_ &= (*i)->GetStages();
+    if ((*i)->GetType() !=
+        WebRequestConditionAttribute::CONDITION_RESOURCE_TYPE) {
+      continue;
+    }
+    const std::vector<ResourceType::Type>& types =
+        static_cast<const WebRequestConditionAttributeResourceType*>(
+            i->get())->types();
+    int allowed_types = 0;
+    for (size_t j = 0; j < types.size(); ++j)
+      allowed_types |= 1 << types[j];
+    resource_types_ &= allowed_types;
   }
 }
 
@@ -112,6 +125,14 @@ bool WebRequestCondition::IsFulfilled(
   return true;
 }
 
+// static
+int WebRequestCondition::GetResourceTypeBit(const net::URLRequest* request) {
+  COMPILE_ASSERT(ResourceType::LAST_TYPE < 31, too_many_resource_types);
+  const content::ResourceRequestInfo* info =
+      content::ResourceRequestInfo::ForRequest(request);
+  return 1 << (info ? info->GetResourceType() : ResourceType::LAST_TYPE);
+}
+
 void WebRequestCondition::GetURLMatcherConditionSets(
     URLMatcherConditionSet::Vector* condition_sets) const {
   if (url_matcher_conditions_.get())
@@ -94,6 +94,15 @@ class WebRequestCondition {
   // tested.
   int stages() const { return applicable_request_stages_; }
 
+  // Returns a bit vector with a 1 for each resource type of requests the
+  // condition can match, see GetResourceTypeBit().
+  int resource_types() const { return resource_types_; }
+
+  // Returns the bit that represents the resource type of |request| in
+  // resource_types(). Requests without a resource type get a bit of their
+  // own, which is only set for conditions without a resource type attribute.
+  static int GetResourceTypeBit(const net::URLRequest* request);
+
  private:
   // URL attributes of this condition.
   scoped_refptr<URLMatcherConditionSet> url_matcher_conditions_;
@@ -106,6 +115,9 @@ class WebRequestCondition {
   // |condition_attributes_| can be evaluated.
   int applicable_request_stages_;
 
+  // Bit vector of the resource types allowed by |condition_attributes_|.
+  int resource_types_;
+
   DISALLOW_COPY_AND_ASSIGN(WebRequestCondition);
 };
 
@@ -103,6 +103,8 @@ class WebRequestConditionAttributeResourceType
   virtual std::string GetName() const OVERRIDE;
   virtual bool Equals(const WebRequestConditionAttribute* other) const OVERRIDE;
 
+  const std::vector<ResourceType::Type>& types() const { return types_; }
+
  private:
   explicit WebRequestConditionAttributeResourceType(
       const std::vector<ResourceType::Type>& types);
@@ -58,11 +58,21 @@ std::set<const WebRequestRule*> WebRequestRulesRegistry::GetMatches(
       request_data.data->request->first_party_for_cookies());
 
   // 1st phase -- add all rules with some conditions without UrlFilter
-  // attributes.
-  for (RuleSet::const_iterator it = rules_with_untriggered_conditions_.begin();
-       it != rules_with_untriggered_conditions_.end(); ++it) {
-    if ((*it)->conditions().IsFulfilled(-1, request_data))
-      result.insert(*it);
+  // attributes. Only the rules whose conditions can be tested in this stage
+  // and allow the request's resource type are evaluated.
+  UntriggeredRulesIndex::const_iterator stage_rules =
+      untriggered_rules_by_stage_.find(request_data_without_ids.stage);
+  if (stage_rules != untriggered_rules_by_stage_.end()) {
+    const int resource_type_bit = WebRequestCondition::GetResourceTypeBit(
+        request_data_without_ids.request);
+    const std::vector<UntriggeredRule>& candidates = stage_rules->second;
+    for (std::vector<UntriggeredRule>::const_iterator it = candidates.begin();
+         it != candidates.end(); ++it) {
+      if ((it->resource_types & resource_type_bit) &&
+          it->rule->conditions().IsFulfilled(-1, request_data)) {
+        result.insert(it->rule);
+      }
+    }
   }
 
   // 2nd phase -- add all rules with some conditions triggered by URL matches.
@@ -223,6 +233,7 @@ std::string WebRequestRulesRegistry::AddRulesImpl(
       rules_with_untriggered_conditions_.insert(i->second.get());
   }
   url_matcher_.AddConditionSets(all_new_condition_sets);
+  UpdateUntriggeredRulesIndex();
 
   ClearCacheOnNavigation();
 
@@ -262,6 +273,7 @@ std::string WebRequestRulesRegistry::RemoveRulesImpl(
 
   // Clear URLMatcher based on condition_set_ids that are not needed any more.
   url_matcher_.RemoveConditionSets(remove_from_url_matcher);
+  UpdateUntriggeredRulesIndex();
 
   ClearCacheOnNavigation();
 
@@ -279,6 +291,7 @@ std::string WebRequestRulesRegistry::RemoveAllRulesImpl(
     CleanUpAfterRule(it->second.get(), &remove_from_url_matcher);
   }
   url_matcher_.RemoveConditionSets(remove_from_url_matcher);
+  UpdateUntriggeredRulesIndex();
 
   webrequest_rules_.erase(extension_id);
   ClearCacheOnNavigation();
@@ -299,6 +312,37 @@ void WebRequestRulesRegistry::CleanUpAfterRule(
   rules_with_untriggered_conditions_.erase(rule);
 }
 
+void WebRequestRulesRegistry::UpdateUntriggeredRulesIndex() {
+  untriggered_rules_by_stage_.clear();
+  for (RuleSet::const_iterator it = rules_with_untriggered_conditions_.begin();
+       it != rules_with_untriggered_conditions_.end(); ++it) {
+    // Collect the conditions that the URLMatcher doesn't trigger.
+    std::vector<const WebRequestCondition*> conditions_without_urls;
+    const WebRequestConditionSet::Conditions& conditions =
+        (*it)->conditions().conditions();
+    for (WebRequestConditionSet::Conditions::const_iterator condition =
+             conditions.begin();
+         condition != conditions.end(); ++condition) {
+      URLMatcherConditionSet::Vector url_condition_sets;
+      (*condition)->GetURLMatcherConditionSets(&url_condition_sets);
+      if (url_condition_sets.empty())
+        conditions_without_urls.push_back(condition->get());
+    }
+
+    for (int stage = ON_BEFORE_REQUEST; stage <= ON_ERROR; stage <<= 1) {
+      UntriggeredRule untriggered_rule = { *it, 0 };
+      for (size_t i = 0; i < conditions_without_urls.size(); ++i) {
+        if (conditions_without_urls[i]->stages() & stage) {
+          untriggered_rule.resource_types |=
+              conditions_without_urls[i]->resource_types();
+        }
+      }
+      if (untriggered_rule.resource_types)
+        untriggered_rules_by_stage_[stage].push_back(untriggered_rule);
+    }
+  }
+}
+
 bool WebRequestRulesRegistry::IsEmpty() const {
   // Easy first.
   if (!rule_triggers_.empty() && url_matcher_.IsEmpty())
@@ -71,6 +71,12 @@ typedef DeclarativeRule<WebRequestCondition, WebRequestAction> WebRequestRule;
 // will respond with the URLMatcherConditionSet::ID. We can map this
 // to the WebRequestRule and check whether also the other conditions (in this
 // example 'scheme': 'http') are fulfilled.
+//
+// Rules with conditions that have no URL attributes can't be found by the
+// URLMatcher. These are indexed by the request stages in which their
+// conditions can be evaluated, together with a bit vector of the resource
+// types the conditions allow, so that only the rules that may match a request
+// have their condition attributes evaluated.
 class WebRequestRulesRegistry : public RulesRegistryWithCache {
  public:
   // For testing, |ui_part| can be NULL. In that case it constructs the
@@ -133,6 +139,16 @@ class WebRequestRulesRegistry : public RulesRegistryWithCache {
   typedef std::set<URLMatcherConditionSet::ID> URLMatches;
   typedef std::set<const WebRequestRule*> RuleSet;
 
+  // A rule with conditions without URL attributes, and the resource types
+  // those of its conditions that can be tested in some request stage allow.
+  struct UntriggeredRule {
+    const WebRequestRule* rule;
+    int resource_types;
+  };
+  // Maps a RequestStage to the rules with conditions without URL attributes
+  // that can be tested during that stage.
+  typedef std::map<int, std::vector<UntriggeredRule> > UntriggeredRulesIndex;
+
   // This bundles all consistency checkers. Returns true in case of consistency
   // and MUST set |error| otherwise.
   static bool Checker(const Extension* extension,
@@ -162,6 +178,10 @@ class WebRequestRulesRegistry : public RulesRegistryWithCache {
       const WebRequestRule* rule,
       std::vector<URLMatcherConditionSet::ID>* remove_from_url_matcher);
 
+  // Rebuilds |untriggered_rules_by_stage_| from
+  // |rules_with_untriggered_conditions_|.
+  void UpdateUntriggeredRulesIndex();
+
   // This is a helper function to GetMatches. Rules triggered by |url_matches|
   // get added to |result| if one of their conditions is fulfilled.
   // |request_data| gets passed to IsFulfilled of the rules' condition sets.
@@ -178,6 +198,9 @@ class WebRequestRulesRegistry : public RulesRegistryWithCache {
   // separately.
   std::set<const WebRequestRule*> rules_with_untriggered_conditions_;
 
+  // |rules_with_untriggered_conditions_| indexed by request stage.
+  UntriggeredRulesIndex untriggered_rules_by_stage_;
+
   std::map<WebRequestRule::ExtensionId, RulesMap> webrequest_rules_;
 
   URLMatcher url_matcher_;
@@ -4,11 +4,13 @@
 
 #include "chrome/browser/extensions/event_router.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "base/bind.h"
 #include "base/command_line.h"
 #include "base/message_loop/message_loop.h"
+#include "base/metrics/histogram.h"
 #include "base/stl_util.h"
 #include "base/values.h"
 #include "base/version.h"
@@ -67,6 +69,21 @@ void DispatchOnInstalledEvent(
 
 void DoNothing(ExtensionHost* host) {}
 
+// Events sent to a renderer process within this interval of the previous ones
+// are batched into a single IPC. This is about one frame.
+const int kEventBatchIntervalMs = 16;
+
+// Returns the arguments to event_bindings.dispatchEvent for an event.
+ListValue* CreateDispatchEventArgs(const std::string& event_name,
+                                   const ListValue& event_args,
+                                   const EventFilteringInfo& info) {
+  ListValue* args = new ListValue();
+  args->Append(Value::CreateStringValue(event_name));
+  args->Append(event_args.DeepCopy());
+  args->Append(info.AsValue().release());
+  return args;
+}
+
 // A dictionary of event names to lists of filters that this extension has
 // registered from its lazy background page.
 const char kFilteredEvents[] = "filtered_events";
@@ -170,7 +187,11 @@ void EventRouter::DispatchEvent(IPC::Sender* ipc_sender,
 EventRouter::EventRouter(Profile* profile, ExtensionPrefs* extension_prefs)
     : profile_(profile),
       listeners_(this),
-      dispatch_chrome_updated_event_(false) {
+      dispatch_chrome_updated_event_(false),
+      num_events_sent_(0),
+      num_event_ipcs_sent_(0),
+      metrics_interval_start_(base::TimeTicks::Now()),
+      weak_ptr_factory_(this) {
   registrar_.Add(this, content::NOTIFICATION_RENDERER_PROCESS_TERMINATED,
                  content::NotificationService::AllSources());
   registrar_.Add(this, content::NOTIFICATION_RENDERER_PROCESS_CLOSED,
@@ -196,6 +217,10 @@ EventRouter::EventRouter(Profile* profile, ExtensionPrefs* extension_prefs)
 
 EventRouter::~EventRouter() {}
 
+EventRouter::EventBatch::EventBatch() {}
+
+EventRouter::EventBatch::~EventBatch() {}
+
 void EventRouter::AddEventListener(const std::string& event_name,
                                    content::RenderProcessHost* process,
                                    const std::string& extension_id) {
@@ -619,12 +644,94 @@ void EventRouter::DispatchEventToProcess(const std::string& extension_id,
                                       event->event_args.get());
   }
 
-  DispatchExtensionMessage(process, listener_profile, extension->id(),
-                           event->event_name, event->event_args.get(),
-                           event->user_gesture, event->filter_info);
+  SendEventToProcess(process, listener_profile, extension->id(), event);
   IncrementInFlightEvents(listener_profile, extension);
 }
 
+void EventRouter::SendEventToProcess(content::RenderProcessHost* process,
+                                     Profile* profile,
+                                     const std::string& extension_id,
+                                     const linked_ptr<Event>& event) {
+  linked_ptr<EventBatch>& batch = event_batches_[process->GetID()];
+  if (!batch.get())
+    batch.reset(new EventBatch);
+
+  base::TimeTicks now = base::TimeTicks::Now();
+  base::TimeDelta batch_interval =
+      base::TimeDelta::FromMilliseconds(kEventBatchIntervalMs);
+  if (event->user_gesture == USER_GESTURE_ENABLED ||
+      (batch->extension_ids.empty() &&
+       now - batch->last_send_time >= batch_interval)) {
+    // Send the batched events first so that the renderer sees the events in
+    // the order they were dispatched.
+    SendEventBatch(process->GetID());
+    DispatchExtensionMessage(process, profile, extension_id,
+                             event->event_name, event->event_args.get(),
+                             event->user_gesture, event->filter_info);
+    batch->last_send_time = now;
+    RecordEventsSent(1);
+    return;
+  }
+
+  if (ActivityLog::IsLogEnabledOnAnyProfile()) {
+    LogExtensionEventMessage(
+        profile, extension_id, event->event_name,
+        scoped_ptr<ListValue>(event->event_args->DeepCopy()));
+  }
+
+  // The event arguments are copied, since a WillDispatchCallback may change
+  // them for the next listener.
+  batch->extension_ids.push_back(extension_id);
+  batch->events.Append(CreateDispatchEventArgs(
+      event->event_name, *event->event_args, event->filter_info));
+  if (batch->extension_ids.size() == 1) {
+    base::TimeDelta delay =
+        std::max(batch_interval - (now - batch->last_send_time),
+                 base::TimeDelta());
+    base::MessageLoop::current()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(&EventRouter::SendEventBatch,
+                   weak_ptr_factory_.GetWeakPtr(), process->GetID()),
+        delay);
+  }
+}
+
+void EventRouter::SendEventBatch(int process_id) {
+  EventBatchMap::iterator it = event_batches_.find(process_id);
+  if (it == event_batches_.end() || it->second->extension_ids.empty())
+    return;
+
+  EventBatch* batch = it->second.get();
+  content::RenderProcessHost* process =
+      content::RenderProcessHost::FromID(process_id);
+  if (process) {
+    process->Send(new ExtensionMsg_DispatchEvents(batch->extension_ids,
+                                                  batch->events));
+    UMA_HISTOGRAM_COUNTS_100("Extensions.EventBatchSize",
+                             batch->extension_ids.size());
+    RecordEventsSent(batch->extension_ids.size());
+  }
+  batch->extension_ids.clear();
+  batch->events.Clear();
+  batch->last_send_time = base::TimeTicks::Now();
+}
+
+void EventRouter::RecordEventsSent(size_t num_events) {
+  num_events_sent_ += static_cast<int>(num_events);
+  ++num_event_ipcs_sent_;
+
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (now - metrics_interval_start_ < base::TimeDelta::FromMinutes(1))
+    return;
+  UMA_HISTOGRAM_COUNTS_10000("Extensions.EventsSentPerMinute",
+                             num_events_sent_);
+  UMA_HISTOGRAM_COUNTS_10000("Extensions.EventIPCsSentPerMinute",
+                             num_event_ipcs_sent_);
+  num_events_sent_ = 0;
+  num_event_ipcs_sent_ = 0;
+  metrics_interval_start_ = now;
+}
+
 bool EventRouter::CanDispatchEventToProfile(Profile* profile,
                                             const Extension* extension,
                                             const linked_ptr<Event>& event) {
@@ -744,6 +851,7 @@ void EventRouter::Observe(int type,
           content::Source<content::RenderProcessHost>(source).ptr();
       // Remove all event listeners associated with this renderer.
       listeners_.RemoveListenersForProcess(renderer);
+      event_batches_.erase(renderer->GetID());
       break;
     }
     case chrome::NOTIFICATION_EXTENSIONS_READY: {
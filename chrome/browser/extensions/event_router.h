@@ -9,12 +9,15 @@
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/callback.h"
 #include "base/compiler_specific.h"
 #include "base/containers/hash_tables.h"
 #include "base/memory/linked_ptr.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "chrome/browser/extensions/event_listener_map.h"
 #include "content/public/browser/notification_observer.h"
@@ -214,6 +217,22 @@ class EventRouter : public content::NotificationObserver,
                               content::RenderProcessHost* process,
                               const linked_ptr<Event>& event);
 
+  // Sends |event| to |process|. If another event was sent to the process less
+  // than a batching interval ago, the event is added to the process's
+  // EventBatch instead, which is sent as a single IPC once the interval is
+  // over. Events with a user gesture are never held back.
+  void SendEventToProcess(content::RenderProcessHost* process,
+                          Profile* profile,
+                          const std::string& extension_id,
+                          const linked_ptr<Event>& event);
+
+  // Sends the events batched for the renderer process |process_id|.
+  void SendEventBatch(int process_id);
+
+  // Counts |num_events| events sent in one IPC, and records the counts of
+  // events and IPCs once a minute.
+  void RecordEventsSent(size_t num_events);
+
   // Returns false when the event is scoped to a profile and the listening
   // extension does not have access to events from that profile. Also fills
   // |event_args| with the proper arguments to send, which may differ if
@@ -279,6 +298,32 @@ class EventRouter : public content::NotificationObserver,
   // upon loading an extension.
   bool dispatch_chrome_updated_event_;
 
+  // The events held back for a renderer process, see SendEventToProcess().
+  struct EventBatch {
+    EventBatch();
+    ~EventBatch();
+
+    // The extension each event in |events| is for.
+    std::vector<std::string> extension_ids;
+
+    // The arguments to event_bindings.dispatchEvent for each event.
+    base::ListValue events;
+
+    // When events were last sent to the process.
+    base::TimeTicks last_send_time;
+  };
+
+  // Maps renderer process IDs to their batches.
+  typedef std::map<int, linked_ptr<EventBatch> > EventBatchMap;
+  EventBatchMap event_batches_;
+
+  // The events and IPCs sent since |metrics_interval_start_|.
+  int num_events_sent_;
+  int num_event_ipcs_sent_;
+  base::TimeTicks metrics_interval_start_;
+
+  base::WeakPtrFactory<EventRouter> weak_ptr_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(EventRouter);
 };
 
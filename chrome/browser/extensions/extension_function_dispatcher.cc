@@ -5,6 +5,7 @@
 #include "chrome/browser/extensions/extension_function_dispatcher.h"
 
 #include "base/bind.h"
+#include "base/debug/trace_event_memory.h"
 #include "base/json/json_string_value_serializer.h"
 #include "base/lazy_instance.h"
 #include "base/logging.h"
@@ -267,6 +268,7 @@ void ExtensionFunctionDispatcher::DispatchOnIOThread(
     base::WeakPtr<ChromeRenderMessageFilter> ipc_sender,
     int routing_id,
     const ExtensionHostMsg_Request_Params& params) {
+  TRACE_MEMORY_SUBSYSTEM("extensions");
   const Extension* extension =
       extension_info_map->extensions().GetByID(params.extension_id);
   Profile* profile_cast = static_cast<Profile*>(profile);
@@ -363,6 +365,7 @@ void ExtensionFunctionDispatcher::DispatchWithCallback(
     const ExtensionHostMsg_Request_Params& params,
     RenderViewHost* render_view_host,
     const ExtensionFunction::ResponseCallback& callback) {
+  TRACE_MEMORY_SUBSYSTEM("extensions");
   // TODO(yzshen): There is some shared logic between this method and
   // DispatchOnIOThread(). It is nice to deduplicate.
   ExtensionService* service = profile()->GetExtensionService();
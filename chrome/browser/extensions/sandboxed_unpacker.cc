@@ -119,6 +119,12 @@ void RecordSuccessfulUnpackTimeHistograms(
 
 // Work horse for FindWritableTempLocation. Creates a temp file in the folder
 // and uses NormalizeFilePath to check if the path is junction free.
+// Writes |size| bytes from |data| to |file|. Returns false if not all of them
+// could be written.
+bool WriteToFile(FILE* file, const void* data, size_t size) {
+  return fwrite(data, 1, size, file) == size;
+}
+
 bool VerifyJunctionFreeLocation(base::FilePath* temp_dir) {
   if (temp_dir->empty())
     return false;
@@ -267,24 +273,17 @@ void SandboxedUnpacker::Start() {
   PATH_LENGTH_HISTOGRAM("Extensions.SandboxUnpackUnpackedCrxPathLength",
                         extension_root_);
 
-  // Extract the public key and validate the package.
-  if (!ValidateSignature())
-    return;  // ValidateSignature() already reported the error.
-
-  // Copy the crx file into our working directory.
+  // The crx file is copied into our working directory.
   base::FilePath temp_crx_path = temp_dir_.path().Append(crx_path_.BaseName());
   PATH_LENGTH_HISTOGRAM("Extensions.SandboxUnpackTempCrxPathLength",
                         temp_crx_path);
 
-  if (!base::CopyFile(crx_path_, temp_crx_path)) {
-    // Failed to copy extension file to temporary directory.
-    ReportFailure(
-        FAILED_TO_COPY_EXTENSION_FILE_TO_TEMP_DIRECTORY,
-        l10n_util::GetStringFUTF16(
-            IDS_EXTENSION_PACKAGE_INSTALL_ERROR,
-            ASCIIToUTF16("FAILED_TO_COPY_EXTENSION_FILE_TO_TEMP_DIRECTORY")));
-    return;
-  }
+  // Extract the public key and validate the package, copying it on the way.
+  base::TimeTicks validate_start_time = base::TimeTicks::Now();
+  if (!ValidateSignature(temp_crx_path))
+    return;  // ValidateSignature() already reported the error.
+  UMA_HISTOGRAM_TIMES("Extensions.SandboxUnpackValidateAndCopyTime",
+                      base::TimeTicks::Now() - validate_start_time);
 
   // The utility process will have access to the directory passed to
   // SandboxedUnpacker.  That directory should not contain a symlink or NTFS
@@ -303,6 +302,7 @@ void SandboxedUnpacker::Start() {
   PATH_LENGTH_HISTOGRAM("Extensions.SandboxUnpackLinkFreeCrxPathLength",
                         link_free_crx_path);
 
+  utility_start_time_ = base::TimeTicks::Now();
   BrowserThread::PostTask(
       BrowserThread::IO, FROM_HERE,
       base::Bind(
@@ -356,6 +356,10 @@ void SandboxedUnpacker::OnUnpackExtensionSucceeded(
   CHECK(unpacker_io_task_runner_->RunsTasksOnCurrentThread());
   got_response_ = true;
 
+  base::TimeTicks rewrite_start_time = base::TimeTicks::Now();
+  UMA_HISTOGRAM_TIMES("Extensions.SandboxUnpackUtilityProcessTime",
+                      rewrite_start_time - utility_start_time_);
+
   scoped_ptr<DictionaryValue> final_manifest(RewriteManifestFile(manifest));
   if (!final_manifest)
     return;
@@ -401,6 +405,9 @@ void SandboxedUnpacker::OnUnpackExtensionSucceeded(
   if (!RewriteCatalogFiles())
     return;
 
+  UMA_HISTOGRAM_TIMES("Extensions.SandboxUnpackRewriteTime",
+                      base::TimeTicks::Now() - rewrite_start_time);
+
   ReportSuccess(manifest, install_icon);
 }
 
@@ -414,7 +421,8 @@ void SandboxedUnpacker::OnUnpackExtensionFailed(const string16& error) {
            error));
 }
 
-bool SandboxedUnpacker::ValidateSignature() {
+bool SandboxedUnpacker::ValidateSignature(
+    const base::FilePath& temp_crx_path) {
   ScopedStdioHandle file(file_util::OpenFile(crx_path_, "rb"));
 
   if (!file.get()) {
@@ -444,6 +452,12 @@ bool SandboxedUnpacker::ValidateSignature() {
     return false;
   }
 
+  ScopedStdioHandle temp_crx_file(file_util::OpenFile(temp_crx_path, "wb"));
+  if (!temp_crx_file.get()) {
+    ReportCopyFailure();
+    return false;
+  }
+
   // Read and verify the header.
   // TODO(erikkay): Yuck.  I'm not a big fan of this kind of code, but it
   // appears that we don't have any endian/alignment aware serialization
@@ -508,6 +522,10 @@ bool SandboxedUnpacker::ValidateSignature() {
     }
     return false;
   }
+  if (!WriteToFile(temp_crx_file.get(), &header, sizeof(header))) {
+    ReportCopyFailure();
+    return false;
+  }
 
   std::vector<uint8> key;
   key.resize(header.key_size);
@@ -553,9 +571,28 @@ bool SandboxedUnpacker::ValidateSignature() {
     return false;
   }
 
-  unsigned char buf[1 << 12];
-  while ((len = fread(buf, 1, sizeof(buf), file.get())) > 0)
+  if (!WriteToFile(temp_crx_file.get(), &key.front(), key.size()) ||
+      !WriteToFile(temp_crx_file.get(), &signature.front(),
+                   signature.size())) {
+    ReportCopyFailure();
+    return false;
+  }
+
+  // Hash the rest of the file and copy it in the same pass.
+  unsigned char buf[1 << 16];
+  while ((len = fread(buf, 1, sizeof(buf), file.get())) > 0) {
     verifier.VerifyUpdate(buf, len);
+    if (!WriteToFile(temp_crx_file.get(), buf, len)) {
+      ReportCopyFailure();
+      return false;
+    }
+  }
+
+  // Check that the buffered data made it to disk.
+  if (!file_util::CloseFile(temp_crx_file.Take())) {
+    ReportCopyFailure();
+    return false;
+  }
 
   if (!verifier.VerifyFinal()) {
     // Signature verification failed
@@ -576,6 +613,15 @@ bool SandboxedUnpacker::ValidateSignature() {
   return true;
 }
 
+void SandboxedUnpacker::ReportCopyFailure() {
+  // Failed to copy extension file to temporary directory.
+  ReportFailure(
+      FAILED_TO_COPY_EXTENSION_FILE_TO_TEMP_DIRECTORY,
+      l10n_util::GetStringFUTF16(
+          IDS_EXTENSION_PACKAGE_INSTALL_ERROR,
+          ASCIIToUTF16("FAILED_TO_COPY_EXTENSION_FILE_TO_TEMP_DIRECTORY")));
+}
+
 void SandboxedUnpacker::ReportFailure(FailureReason reason,
                                       const string16& error) {
   UMA_HISTOGRAM_ENUMERATION("Extensions.SandboxUnpackFailureReason",
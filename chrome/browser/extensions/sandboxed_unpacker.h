@@ -160,7 +160,9 @@ class SandboxedUnpacker : public content::UtilityProcessHostClient {
   virtual bool CreateTempDirectory();
 
   // Validates the signature of the extension and extract the key to
-  // |public_key_|. Returns true if the signature validates, false otherwise.
+  // |public_key_|. The CRX is copied to |temp_crx_path| while it is read, so
+  // that it is only read once. Returns true if the signature validates and
+  // the copy succeeded, false otherwise.
   //
   // NOTE: Having this method here is a bit ugly. This code should really live
   // in extensions::Unpacker as it is not specific to sandboxed unpacking. It
@@ -168,7 +170,10 @@ class SandboxedUnpacker : public content::UtilityProcessHostClient {
   // we could still have this method statically on extensions::Unpacker so that
   // code just for unpacking is there and code just for sandboxing of unpacking
   // is here.
-  bool ValidateSignature();
+  bool ValidateSignature(const base::FilePath& temp_crx_path);
+
+  // Reports that the CRX couldn't be copied to the temporary directory.
+  void ReportCopyFailure();
 
   // Starts the utility process that unpacks our extension.
   void StartProcessOnIOThread(const base::FilePath& temp_crx_path);
@@ -229,6 +234,10 @@ class SandboxedUnpacker : public content::UtilityProcessHostClient {
   // Time at which unpacking started. Used to compute the time unpacking takes.
   base::TimeTicks unpack_start_time_;
 
+  // Time at which the utility process was asked to unpack the extension. Used
+  // to compute the time each stage of unpacking takes.
+  base::TimeTicks utility_start_time_;
+
   // Location to use for the unpacked extension.
   Manifest::Location location_;
 
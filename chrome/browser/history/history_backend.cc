@@ -176,6 +176,7 @@ HistoryBackend::HistoryBackend(const base::FilePath& history_dir,
       id_(id),
       history_dir_(history_dir),
       scheduled_kill_db_(false),
+      pages_added_since_commit_(0),
       expirer_(this, bookmark_service),
       recent_redirects_(kMaxRedirectCount),
       backend_destroy_message_loop_(NULL),
@@ -554,6 +555,7 @@ void HistoryBackend::AddPage(const HistoryAddPageArgs& request) {
   if (page_collector_)
     page_collector_->AddPageURL(request.url, request.time);
 
+  ++pages_added_since_commit_;
   ScheduleCommit();
 }
 
@@ -772,20 +774,31 @@ std::pair<URLID, VisitID> HistoryBackend::AddPageVisit(
   URLRow url_info(url);
   URLID url_id = db_->GetRowForURL(url, &url_info);
   if (url_id) {
-    // Update of an existing row.
+    // Update of an existing row. Reloads and visits recorded out of order
+    // often leave the row as it was, in which case it isn't written again.
+    bool row_changed = false;
     if (content::PageTransitionStripQualifier(transition) !=
-        content::PAGE_TRANSITION_RELOAD)
+        content::PAGE_TRANSITION_RELOAD) {
       url_info.set_visit_count(url_info.visit_count() + 1);
-    if (typed_increment)
+      row_changed = true;
+    }
+    if (typed_increment) {
       url_info.set_typed_count(url_info.typed_count() + typed_increment);
-    if (url_info.last_visit() < time)
+      row_changed = true;
+    }
+    if (url_info.last_visit() < time) {
       url_info.set_last_visit(time);
+      row_changed = true;
+    }
 
     // Only allow un-hiding of pages, never hiding.
-    if (!new_hidden)
+    if (!new_hidden && url_info.hidden()) {
       url_info.set_hidden(false);
+      row_changed = true;
+    }
 
-    db_->UpdateURLRow(url_id, url_info);
+    if (row_changed)
+      db_->UpdateURLRow(url_id, url_info);
   } else {
     // Addition of a new row.
     url_info.set_visit_count(1);
@@ -2528,6 +2541,12 @@ void HistoryBackend::Commit() {
   // some cases) but it hasn't been important yet.
   CancelScheduledCommit();
 
+  if (pages_added_since_commit_) {
+    UMA_HISTOGRAM_COUNTS_100("History.PagesAddedPerCommit",
+                             pages_added_since_commit_);
+    pages_added_since_commit_ = 0;
+  }
+
   db_->CommitTransaction();
   DCHECK(db_->transaction_nesting() == 0) << "Somebody left a transaction open";
   db_->BeginTransaction();
@@ -888,6 +888,10 @@ class HistoryBackend : public base::RefCountedThreadSafe<HistoryBackend>,
   // scheduled commit at a time (see ScheduleCommit).
   scoped_refptr<CommitLaterTask> scheduled_commit_;
 
+  // The number of pages added since the last commit. Each commit syncs the
+  // database to disk, so this tells how many page loads share each sync.
+  int pages_added_since_commit_;
+
   // Maps recent redirect destination pages to the chain of redirects that
   // brought us to there. Pages that did not have redirects or were not the
   // final redirect in a chain will not be in this list, as well as pages that
@@ -24,6 +24,7 @@
 #include "base/callback.h"
 #include "base/command_line.h"
 #include "base/compiler_specific.h"
+#include "base/debug/trace_event_memory.h"
 #include "base/location.h"
 #include "base/memory/ref_counted.h"
 #include "base/message_loop/message_loop.h"
@@ -73,6 +74,26 @@ namespace {
 
 static const char* kHistoryThreadName = "Chrome_HistoryThread";
 
+// The history thread. Heap memory profiling attributes everything allocated
+// on it to history, as long as profiling was running when the thread started.
+class HistoryThread : public base::Thread {
+ public:
+  HistoryThread() : base::Thread(kHistoryThreadName) {}
+  virtual ~HistoryThread() {
+    Stop();
+  }
+
+ protected:
+  // base::Thread:
+  virtual void Run(base::MessageLoop* message_loop) OVERRIDE {
+    TRACE_MEMORY_SUBSYSTEM("history");
+    base::Thread::Run(message_loop);
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HistoryThread);
+};
+
 template<typename PODType> void DerefPODType(
     const base::Callback<void(PODType)>& callback, PODType* pod_value) {
   callback.Run(*pod_value);
@@ -201,7 +222,7 @@ class HistoryService::BackendDelegate : public HistoryBackend::Delegate {
 // history thread.
 HistoryService::HistoryService()
     : weak_ptr_factory_(this),
-      thread_(new base::Thread(kHistoryThreadName)),
+      thread_(new HistoryThread),
       profile_(NULL),
       backend_loaded_(false),
       current_backend_id_(-1),
@@ -212,7 +233,7 @@ HistoryService::HistoryService()
 
 HistoryService::HistoryService(Profile* profile)
     : weak_ptr_factory_(this),
-      thread_(new base::Thread(kHistoryThreadName)),
+      thread_(new HistoryThread),
       profile_(profile),
       visitedlink_master_(new visitedlink::VisitedLinkMaster(
           profile, this, true)),
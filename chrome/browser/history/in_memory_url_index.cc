@@ -6,7 +6,9 @@
 
 #include "base/debug/trace_event.h"
 #include "base/file_util.h"
+#include "base/metrics/histogram.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
 #include "chrome/browser/bookmarks/bookmark_model.h"
 #include "chrome/browser/bookmarks/bookmark_model_factory.h"
 #include "chrome/browser/bookmarks/bookmark_service.h"
@@ -27,6 +29,10 @@ using in_memory_url_index::InMemoryURLIndexCacheItem;
 
 namespace history {
 
+// The number of journal entries after which the whole cache file is rewritten
+// rather than replaying ever more changes at startup.
+static const size_t kMaxJournalEntries = 1000;
+
 // Called by DoSaveToCacheFile to delete any old cache file at |path| when
 // there is no private data to save. Runs on the FILE thread.
 void DeleteCacheFile(const base::FilePath& path) {
@@ -100,7 +106,8 @@ InMemoryURLIndex::InMemoryURLIndex(Profile* profile,
       save_cache_observer_(NULL),
       shutdown_(false),
       restored_(false),
-      needs_to_be_cached_(false) {
+      needs_to_be_cached_(false),
+      journal_entry_count_(0) {
   InitializeSchemeWhitelist(&scheme_whitelist_);
   if (profile) {
     // TODO(mrossetti): Register for language change notifications.
@@ -120,7 +127,8 @@ InMemoryURLIndex::InMemoryURLIndex()
       save_cache_observer_(NULL),
       shutdown_(false),
       restored_(false),
-      needs_to_be_cached_(false) {
+      needs_to_be_cached_(false),
+      journal_entry_count_(0) {
   InitializeSchemeWhitelist(&scheme_whitelist_);
 }
 
@@ -142,7 +150,10 @@ void InMemoryURLIndex::ShutDown() {
   if (!GetCacheFilePath(&path))
     return;
   private_data_->CancelPendingUpdates();
-  URLIndexPrivateData::WritePrivateDataToCacheFileTask(private_data_, path);
+  base::FilePath journal_path;
+  GetJournalFilePath(&journal_path);
+  URLIndexPrivateData::WritePrivateDataToCacheFileTask(private_data_, path,
+                                                       journal_path);
   needs_to_be_cached_ = false;
 }
 
@@ -157,16 +168,28 @@ bool InMemoryURLIndex::GetCacheFilePath(base::FilePath* file_path) {
   return true;
 }
 
+bool InMemoryURLIndex::GetJournalFilePath(base::FilePath* file_path) {
+  base::FilePath cache_path;
+  if (!GetCacheFilePath(&cache_path))
+    return false;
+  *file_path = cache_path.InsertBeforeExtensionASCII(" Journal");
+  return true;
+}
+
 // Querying --------------------------------------------------------------------
 
 ScoredHistoryMatches InMemoryURLIndex::HistoryItemsForTerms(
     const string16& term_string,
     size_t cursor_position) {
-  return private_data_->HistoryItemsForTerms(
+  base::TimeTicks beginning_time = base::TimeTicks::Now();
+  ScoredHistoryMatches matches = private_data_->HistoryItemsForTerms(
       term_string,
       cursor_position,
       languages_,
       BookmarkModelFactory::GetForProfile(profile_));
+  UMA_HISTOGRAM_TIMES("History.InMemoryURLIndexSearchTime",
+                      base::TimeTicks::Now() - beginning_time);
+  return matches;
 }
 
 // Updating --------------------------------------------------------------------
@@ -206,31 +229,75 @@ void InMemoryURLIndex::OnURLVisited(const URLVisitedDetails* details) {
   HistoryService* service =
       HistoryServiceFactory::GetForProfile(profile_,
                                            Profile::EXPLICIT_ACCESS);
-  needs_to_be_cached_ |= private_data_->UpdateURL(
-      service, details->row, languages_, scheme_whitelist_);
+  if (private_data_->UpdateURL(service, details->row, languages_,
+                               scheme_whitelist_)) {
+    needs_to_be_cached_ = true;
+    PostAppendToJournalTask(
+        std::vector<HistoryID>(1, static_cast<HistoryID>(details->row.id())),
+        false);
+  }
 }
 
 void InMemoryURLIndex::OnURLsModified(const URLsModifiedDetails* details) {
   HistoryService* service =
       HistoryServiceFactory::GetForProfile(profile_,
                                            Profile::EXPLICIT_ACCESS);
+  std::vector<HistoryID> updated_ids;
   for (URLRows::const_iterator row = details->changed_urls.begin();
-       row != details->changed_urls.end(); ++row)
-    needs_to_be_cached_ |=
-        private_data_->UpdateURL(service, *row, languages_, scheme_whitelist_);
+       row != details->changed_urls.end(); ++row) {
+    if (private_data_->UpdateURL(service, *row, languages_, scheme_whitelist_))
+      updated_ids.push_back(static_cast<HistoryID>(row->id()));
+  }
+  if (!updated_ids.empty()) {
+    needs_to_be_cached_ = true;
+    PostAppendToJournalTask(updated_ids, false);
+  }
 }
 
 void InMemoryURLIndex::OnURLsDeleted(const URLsDeletedDetails* details) {
   if (details->all_history) {
     ClearPrivateData();
     needs_to_be_cached_ = true;
+    PostAppendToJournalTask(std::vector<HistoryID>(), true);
   } else {
+    std::vector<HistoryID> deleted_ids;
     for (URLRows::const_iterator row = details->rows.begin();
-         row != details->rows.end(); ++row)
-      needs_to_be_cached_ |= private_data_->DeleteURL(row->url());
+         row != details->rows.end(); ++row) {
+      if (private_data_->DeleteURL(row->url()))
+        deleted_ids.push_back(static_cast<HistoryID>(row->id()));
+    }
+    if (!deleted_ids.empty()) {
+      needs_to_be_cached_ = true;
+      PostAppendToJournalTask(deleted_ids, false);
+    }
   }
 }
 
+void InMemoryURLIndex::PostAppendToJournalTask(
+    const std::vector<HistoryID>& history_ids,
+    bool cleared) {
+  // Changes made before the index is restored are lost along with the data
+  // they were made to, so there is nothing to record.
+  base::FilePath journal_path;
+  if (!restored_ || !GetJournalFilePath(&journal_path) || shutdown_)
+    return;
+  if (journal_entry_count_ >= kMaxJournalEntries) {
+    PostSaveToCacheFileTask();
+    return;
+  }
+  std::vector<std::string> entries;
+  if (cleared)
+    entries.push_back(URLIndexPrivateData::GetJournalEntryForClear());
+  for (std::vector<HistoryID>::const_iterator iter = history_ids.begin();
+       iter != history_ids.end(); ++iter)
+    entries.push_back(private_data_->GetJournalEntryForRow(*iter));
+  journal_entry_count_ += entries.size();
+  content::BrowserThread::PostTask(
+      content::BrowserThread::FILE, FROM_HERE,
+      base::Bind(&URLIndexPrivateData::AppendToJournalFileTask,
+                 journal_path, entries));
+}
+
 // Restoring from Cache --------------------------------------------------------
 
 void InMemoryURLIndex::PostRestoreFromCacheFileTask() {
@@ -238,7 +305,9 @@ void InMemoryURLIndex::PostRestoreFromCacheFileTask() {
   TRACE_EVENT0("browser", "InMemoryURLIndex::PostRestoreFromCacheFileTask");
 
   base::FilePath path;
-  if (!GetCacheFilePath(&path) || shutdown_) {
+  base::FilePath journal_path;
+  if (!GetCacheFilePath(&path) || !GetJournalFilePath(&journal_path) ||
+      shutdown_) {
     restored_ = true;
     if (restore_cache_observer_)
       restore_cache_observer_->OnCacheRestoreFinished(false);
@@ -248,7 +317,8 @@ void InMemoryURLIndex::PostRestoreFromCacheFileTask() {
   content::BrowserThread::PostTaskAndReplyWithResult
       <scoped_refptr<URLIndexPrivateData> >(
       content::BrowserThread::FILE, FROM_HERE,
-      base::Bind(&URLIndexPrivateData::RestoreFromFile, path, languages_),
+      base::Bind(&URLIndexPrivateData::RestoreFromFile, path, journal_path,
+                 languages_),
       base::Bind(&InMemoryURLIndex::OnCacheLoadDone, AsWeakPtr()));
 }
 
@@ -264,10 +334,15 @@ void InMemoryURLIndex::OnCacheLoadDone(
     // it exists, and then rebuild from the history database if it's available,
     // otherwise wait until the history database loaded and then rebuild.
     base::FilePath path;
-    if (!GetCacheFilePath(&path) || shutdown_)
+    base::FilePath journal_path;
+    if (!GetCacheFilePath(&path) || !GetJournalFilePath(&journal_path) ||
+        shutdown_)
       return;
     content::BrowserThread::PostBlockingPoolTask(
         FROM_HERE, base::Bind(DeleteCacheFile, path));
+    content::BrowserThread::PostTask(
+        content::BrowserThread::FILE, FROM_HERE,
+        base::Bind(DeleteCacheFile, journal_path));
     HistoryService* service =
         HistoryServiceFactory::GetForProfileWithoutCreating(profile_);
     if (service && service->backend_loaded()) {
@@ -318,8 +393,11 @@ void InMemoryURLIndex::RebuildFromHistory(HistoryDatabase* history_db) {
 
 void InMemoryURLIndex::PostSaveToCacheFileTask() {
   base::FilePath path;
-  if (!GetCacheFilePath(&path))
+  base::FilePath journal_path;
+  if (!GetCacheFilePath(&path) || !GetJournalFilePath(&journal_path))
     return;
+  // The cache file is about to include every change made so far.
+  journal_entry_count_ = 0;
   // If there is anything in our private data then make a copy of it and tell
   // it to save itself to a file.
   if (private_data_.get() && !private_data_->Empty()) {
@@ -330,13 +408,17 @@ void InMemoryURLIndex::PostSaveToCacheFileTask() {
     content::BrowserThread::PostTaskAndReplyWithResult<bool>(
         content::BrowserThread::FILE, FROM_HERE,
         base::Bind(&URLIndexPrivateData::WritePrivateDataToCacheFileTask,
-                   private_data_copy, path),
+                   private_data_copy, path, journal_path),
         base::Bind(&InMemoryURLIndex::OnCacheSaveDone, AsWeakPtr()));
   } else {
-    // If there is no data in our index then delete any existing cache file.
-    content::BrowserThread::PostBlockingPoolTask(
-        FROM_HERE,
+    // If there is no data in our index then delete any existing cache file
+    // and the journal of changes to it.
+    content::BrowserThread::PostTask(
+        content::BrowserThread::FILE, FROM_HERE,
         base::Bind(DeleteCacheFile, path));
+    content::BrowserThread::PostTask(
+        content::BrowserThread::FILE, FROM_HERE,
+        base::Bind(DeleteCacheFile, journal_path));
   }
 }
 
@@ -184,6 +184,18 @@ class InMemoryURLIndex : public content::NotificationObserver,
   // provided as a hook for unit testing.)
   bool GetCacheFilePath(base::FilePath* file_path);
 
+  // Constructs the path of the journal file, which records the changes made
+  // to the index since the cache file was written, next to the cache file.
+  // Returns false if there is no cache file path.
+  bool GetJournalFilePath(base::FilePath* file_path);
+
+  // Records the current state of the rows with |history_ids| in the journal
+  // file, or that the index was cleared if |cleared|, so that the changes
+  // survive a restart without rewriting the whole cache file. Once the
+  // journal grows long enough the cache file is rewritten instead.
+  void PostAppendToJournalTask(const std::vector<HistoryID>& history_ids,
+                               bool cleared);
+
   // Restores the index's private data from the cache file stored in the
   // profile directory.
   void PostRestoreFromCacheFileTask();
@@ -289,6 +301,10 @@ class InMemoryURLIndex : public content::NotificationObserver,
   // http://crbug.com/83659
   bool needs_to_be_cached_;
 
+  // The number of entries appended to the journal file since the cache file
+  // was last written.
+  size_t journal_entry_count_;
+
   DISALLOW_COPY_AND_ASSIGN(InMemoryURLIndex);
 };
 
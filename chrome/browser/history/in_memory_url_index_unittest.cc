@@ -1057,6 +1057,65 @@ TEST_F(InMemoryURLIndexTest, CacheSaveRestore) {
   ExpectPrivateDataEqual(*old_data.get(), new_data);
 }
 
+TEST_F(InMemoryURLIndexTest, CacheJournalReplay) {
+  base::ScopedTempDir temp_directory;
+  ASSERT_TRUE(temp_directory.CreateUniqueTempDir());
+  set_history_dir(temp_directory.path());
+  base::FilePath journal_path = temp_directory.path().Append(
+      FILE_PATH_LITERAL("History Provider Cache Journal"));
+
+  // Save then restore our private data so that the index starts out
+  // restored from the cache file.
+  CacheFileSaverObserver save_observer(&message_loop_);
+  url_index_->set_save_cache_observer(&save_observer);
+  PostSaveToCacheFileTask();
+  message_loop_.Run();
+  EXPECT_TRUE(save_observer.succeeded_);
+  HistoryIndexRestoreObserver restore_observer(
+      base::Bind(&base::MessageLoop::Quit, base::Unretained(&message_loop_)));
+  url_index_->set_restore_cache_observer(&restore_observer);
+  PostRestoreFromCacheFileTask();
+  message_loop_.Run();
+  EXPECT_TRUE(restore_observer.succeeded());
+
+  // Add a row and delete another one through notifications, which record the
+  // changes in the journal rather than rewriting the cache file.
+  URLRow new_row(GURL("http://www.brokeandaloneinmanitoba.com/"), 87654321);
+  new_row.set_last_visit(base::Time::Now());
+  URLsModifiedDetails modified_details;
+  modified_details.changed_urls.push_back(new_row);
+  Observe(chrome::NOTIFICATION_HISTORY_URLS_MODIFIED,
+          content::Source<InMemoryURLIndexTest>(this),
+          content::Details<history::HistoryDetails>(&modified_details));
+  ScoredHistoryMatches matches = url_index_->HistoryItemsForTerms(
+      ASCIIToUTF16("DrudgeReport"), string16::npos);
+  ASSERT_EQ(1U, matches.size());
+  URLsDeletedDetails deleted_details;
+  deleted_details.all_history = false;
+  deleted_details.rows.push_back(matches[0].url_info);
+  Observe(chrome::NOTIFICATION_HISTORY_URLS_DELETED,
+          content::Source<InMemoryURLIndexTest>(this),
+          content::Details<history::HistoryDetails>(&deleted_details));
+  message_loop_.RunUntilIdle();
+  EXPECT_TRUE(base::PathExists(journal_path));
+
+  // Restoring replays the journal on top of the cache file.
+  ClearPrivateData();
+  PostRestoreFromCacheFileTask();
+  message_loop_.Run();
+  EXPECT_TRUE(restore_observer.succeeded());
+  EXPECT_EQ(1U, url_index_->HistoryItemsForTerms(
+      ASCIIToUTF16("brokeandalone"), string16::npos).size());
+  EXPECT_TRUE(url_index_->HistoryItemsForTerms(
+      ASCIIToUTF16("DrudgeReport"), string16::npos).empty());
+
+  // Saving the cache file again folds the journal into it.
+  PostSaveToCacheFileTask();
+  message_loop_.Run();
+  EXPECT_TRUE(save_observer.succeeded_);
+  EXPECT_FALSE(base::PathExists(journal_path));
+}
+
 TEST_F(InMemoryURLIndexTest, RebuildFromHistoryIfCacheOld) {
   base::ScopedTempDir temp_directory;
   ASSERT_TRUE(temp_directory.CreateUniqueTempDir());
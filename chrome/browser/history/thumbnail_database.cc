@@ -4,6 +4,8 @@
 
 #include "chrome/browser/history/thumbnail_database.h"
 
+#include <string.h>
+
 #include <algorithm>
 #include <string>
 
@@ -11,6 +13,7 @@
 #include "base/debug/alias.h"
 #include "base/file_util.h"
 #include "base/format_macros.h"
+#include "base/hash.h"
 #include "base/memory/ref_counted_memory.h"
 #include "base/metrics/histogram.h"
 #include "base/rand_util.h"
@@ -55,21 +58,32 @@
 //                    the link tag. The FAVICON type is used for the default
 //                    favicon.ico favicon.
 //
-// favicon_bitmaps    This table contains the PNG encoded bitmap data of the
-//                    favicons. There is a separate row for every size in a
-//                    multi resolution bitmap. The bitmap data is associated
-//                    to the favicon via the |icon_id| field which matches
-//                    the |id| field in the appropriate row in the |favicons|
-//                    table.
+// favicon_bitmaps    This table contains the bitmaps of the favicons. There
+//                    is a separate row for every size in a multi resolution
+//                    bitmap. The bitmap is associated to the favicon via the
+//                    |icon_id| field which matches the |id| field in the
+//                    appropriate row in the |favicons| table.
 //
 //  id                Unique ID.
 //  icon_id           The ID of the favicon that the bitmap is associated to.
 //  last_updated      The time at which this favicon was inserted into the
 //                    table. This is used to determine if it needs to be
 //                    redownloaded from the web.
-//  image_data        PNG encoded data of the favicon.
-//  width             Pixel width of |image_data|.
-//  height            Pixel height of |image_data|.
+//  image_data        Unused since version 8. PNG encoded data of the favicon
+//                    in earlier versions.
+//  width             Pixel width of the bitmap.
+//  height            Pixel height of the bitmap.
+//  image_data_id     The ID of the row of |favicon_bitmap_data| holding the
+//                    PNG encoded data of the bitmap, or 0 if there is none.
+//
+// favicon_bitmap_data This table contains the PNG encoded data of the favicon
+//                    bitmaps. Many sites use identical icons, so bitmaps with
+//                    the same bytes share a single row, which is deleted when
+//                    the last bitmap referring to it is.
+//
+//  id                Unique ID.
+//  hash              Hash of |image_data|, used to find identical data.
+//  image_data        PNG encoded data of one or more favicon bitmaps.
 
 namespace {
 
@@ -278,8 +292,8 @@ void DatabaseErrorCallback(sql::Connection* db,
 namespace history {
 
 // Version number of the database.
-static const int kCurrentVersionNumber = 7;
-static const int kCompatibleVersionNumber = 7;
+static const int kCurrentVersionNumber = 8;
+static const int kCompatibleVersionNumber = 8;
 
 // Use 90 quality (out of 100) which is pretty high, because we're very
 // sensitive to artifacts for these small sized, highly detailed images.
@@ -339,6 +353,7 @@ sql::InitStatus ThumbnailDatabase::Init(
       !InitThumbnailTable() ||
       !InitFaviconBitmapsTable(&db_, false) ||
       !InitFaviconBitmapsIndex() ||
+      !InitFaviconBitmapDataTable(&db_) ||
       !InitFaviconsTable(&db_, false) ||
       !InitFaviconsIndex() ||
       !InitIconMappingTable(&db_, false) ||
@@ -401,9 +416,20 @@ sql::InitStatus ThumbnailDatabase::Init(
       return CantUpgradeToVersion(cur_version);
   }
 
+  if (cur_version == 7) {
+    ++cur_version;
+    if (!UpgradeToVersion8())
+      return CantUpgradeToVersion(cur_version);
+  }
+
   LOG_IF(WARNING, cur_version < kCurrentVersionNumber) <<
       "Thumbnail database version " << cur_version << " is too old to handle.";
 
+  if (!InitFaviconBitmapDataIndices()) {
+    db_.Close();
+    return sql::INIT_FAILURE;
+  }
+
   // Initialization is complete.
   if (!transaction.Commit()) {
     db_.Close();
@@ -547,7 +573,8 @@ bool ThumbnailDatabase::InitFaviconBitmapsTable(sql::Connection* db,
                "last_updated INTEGER DEFAULT 0,"
                "image_data BLOB,"
                "width INTEGER DEFAULT 0,"
-               "height INTEGER DEFAULT 0)");
+               "height INTEGER DEFAULT 0,"
+               "image_data_id INTEGER DEFAULT 0)");
     if (!db->Execute(sql.c_str()))
       return false;
   }
@@ -560,6 +587,76 @@ bool ThumbnailDatabase::InitFaviconBitmapsIndex() {
                      "favicon_bitmaps(icon_id)");
 }
 
+bool ThumbnailDatabase::InitFaviconBitmapDataTable(sql::Connection* db) {
+  if (!db->DoesTableExist("favicon_bitmap_data")) {
+    if (!db->Execute("CREATE TABLE favicon_bitmap_data ("
+                     "id INTEGER PRIMARY KEY,"
+                     "hash INTEGER NOT NULL,"
+                     "image_data BLOB)"))
+      return false;
+  }
+  return true;
+}
+
+bool ThumbnailDatabase::InitFaviconBitmapDataIndices() {
+  return
+      db_.Execute("CREATE INDEX IF NOT EXISTS favicon_bitmap_data_hash ON "
+                  "favicon_bitmap_data(hash)") &&
+      db_.Execute("CREATE INDEX IF NOT EXISTS favicon_bitmaps_image_data_id ON "
+                  "favicon_bitmaps(image_data_id)");
+}
+
+int64 ThumbnailDatabase::AddFaviconBitmapData(
+    const scoped_refptr<base::RefCountedMemory>& bitmap_data) {
+  if (!bitmap_data.get() || !bitmap_data->size())
+    return 0;
+
+  const char* bytes = reinterpret_cast<const char*>(bitmap_data->front());
+  const size_t size = bitmap_data->size();
+  const int64 hash = base::Hash(bytes, size);
+
+  // Reuse the data of an identical bitmap. The hash only narrows down the
+  // candidates, their bytes still have to match.
+  sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
+      "SELECT id, image_data FROM favicon_bitmap_data WHERE hash=?"));
+  statement.BindInt64(0, hash);
+  while (statement.Step()) {
+    if (static_cast<size_t>(statement.ColumnByteLength(1)) == size &&
+        memcmp(statement.ColumnBlob(1), bytes, size) == 0)
+      return statement.ColumnInt64(0);
+  }
+
+  statement.Assign(db_.GetCachedStatement(SQL_FROM_HERE,
+      "INSERT INTO favicon_bitmap_data (hash, image_data) VALUES (?, ?)"));
+  statement.BindInt64(0, hash);
+  statement.BindBlob(1, bytes, static_cast<int>(size));
+  if (!statement.Run())
+    return 0;
+  return db_.GetLastInsertRowId();
+}
+
+bool ThumbnailDatabase::DeleteFaviconBitmapDataIfUnused(int64 data_id) {
+  if (!data_id)
+    return true;
+  sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
+      "DELETE FROM favicon_bitmap_data WHERE id=? AND NOT EXISTS "
+      "(SELECT 1 FROM favicon_bitmaps WHERE image_data_id=?)"));
+  statement.BindInt64(0, data_id);
+  statement.BindInt64(1, data_id);
+  return statement.Run();
+}
+
+void ThumbnailDatabase::GetFaviconBitmapDataIDs(
+    chrome::FaviconID icon_id,
+    std::vector<int64>* data_ids) {
+  sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
+      "SELECT DISTINCT image_data_id FROM favicon_bitmaps "
+      "WHERE icon_id=? AND image_data_id != 0"));
+  statement.BindInt64(0, icon_id);
+  while (statement.Step())
+    data_ids->push_back(statement.ColumnInt64(0));
+}
+
 bool ThumbnailDatabase::IsFaviconDBStructureIncorrect() {
   return !db_.IsSQLValid("SELECT id, url, icon_type FROM favicons");
 }
@@ -723,7 +820,10 @@ bool ThumbnailDatabase::GetFaviconBitmaps(
     std::vector<FaviconBitmap>* favicon_bitmaps) {
   DCHECK(icon_id);
   sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
-      "SELECT id, last_updated, image_data, width, height FROM favicon_bitmaps "
+      "SELECT favicon_bitmaps.id, last_updated, favicon_bitmap_data.image_data, "
+      "width, height FROM favicon_bitmaps "
+      "LEFT JOIN favicon_bitmap_data "
+      "ON favicon_bitmaps.image_data_id = favicon_bitmap_data.id "
       "WHERE icon_id=?"));
   statement.BindInt64(0, icon_id);
 
@@ -757,8 +857,11 @@ bool ThumbnailDatabase::GetFaviconBitmap(
     gfx::Size* pixel_size) {
   DCHECK(bitmap_id);
   sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
-      "SELECT last_updated, image_data, width, height FROM favicon_bitmaps "
-      "WHERE id=?"));
+      "SELECT last_updated, favicon_bitmap_data.image_data, width, height "
+      "FROM favicon_bitmaps "
+      "LEFT JOIN favicon_bitmap_data "
+      "ON favicon_bitmaps.image_data_id = favicon_bitmap_data.id "
+      "WHERE favicon_bitmaps.id=?"));
   statement.BindInt64(0, bitmap_id);
 
   if (!statement.Step())
@@ -786,16 +889,15 @@ FaviconBitmapID ThumbnailDatabase::AddFaviconBitmap(
     base::Time time,
     const gfx::Size& pixel_size) {
   DCHECK(icon_id);
+  int64 data_id = AddFaviconBitmapData(icon_data);
+  if (!data_id && icon_data.get() && icon_data->size())
+    return 0;
+
   sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
-      "INSERT INTO favicon_bitmaps (icon_id, image_data, last_updated, width, "
-      "height) VALUES (?, ?, ?, ?, ?)"));
+      "INSERT INTO favicon_bitmaps (icon_id, image_data_id, last_updated, "
+      "width, height) VALUES (?, ?, ?, ?, ?)"));
   statement.BindInt64(0, icon_id);
-  if (icon_data.get() && icon_data->size()) {
-    statement.BindBlob(1, icon_data->front(),
-                       static_cast<int>(icon_data->size()));
-  } else {
-    statement.BindNull(1);
-  }
+  statement.BindInt64(1, data_id);
   statement.BindInt64(2, time.ToInternalValue());
   statement.BindInt(3, pixel_size.width());
   statement.BindInt(4, pixel_size.height());
@@ -811,17 +913,24 @@ bool ThumbnailDatabase::SetFaviconBitmap(
     base::Time time) {
   DCHECK(bitmap_id);
   sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
-      "UPDATE favicon_bitmaps SET image_data=?, last_updated=? WHERE id=?"));
-  if (bitmap_data.get() && bitmap_data->size()) {
-    statement.BindBlob(0, bitmap_data->front(),
-                       static_cast<int>(bitmap_data->size()));
-  } else {
-    statement.BindNull(0);
-  }
+      "SELECT image_data_id FROM favicon_bitmaps WHERE id=?"));
+  statement.BindInt64(0, bitmap_id);
+  int64 old_data_id = statement.Step() ? statement.ColumnInt64(0) : 0;
+
+  int64 data_id = AddFaviconBitmapData(bitmap_data);
+  if (!data_id && bitmap_data.get() && bitmap_data->size())
+    return false;
+
+  statement.Assign(db_.GetCachedStatement(SQL_FROM_HERE,
+      "UPDATE favicon_bitmaps SET image_data_id=?, last_updated=? WHERE id=?"));
+  statement.BindInt64(0, data_id);
   statement.BindInt64(1, time.ToInternalValue());
   statement.BindInt64(2, bitmap_id);
+  if (!statement.Run())
+    return false;
 
-  return statement.Run();
+  return old_data_id == data_id ||
+         DeleteFaviconBitmapDataIfUnused(old_data_id);
 }
 
 bool ThumbnailDatabase::SetFaviconBitmapLastUpdateTime(
@@ -837,17 +946,32 @@ bool ThumbnailDatabase::SetFaviconBitmapLastUpdateTime(
 
 bool ThumbnailDatabase::DeleteFaviconBitmapsForFavicon(
     chrome::FaviconID icon_id) {
+  std::vector<int64> data_ids;
+  GetFaviconBitmapDataIDs(icon_id, &data_ids);
+
   sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
       "DELETE FROM favicon_bitmaps WHERE icon_id=?"));
   statement.BindInt64(0, icon_id);
-  return statement.Run();
+  if (!statement.Run())
+    return false;
+
+  for (size_t i = 0; i < data_ids.size(); ++i) {
+    if (!DeleteFaviconBitmapDataIfUnused(data_ids[i]))
+      return false;
+  }
+  return true;
 }
 
 bool ThumbnailDatabase::DeleteFaviconBitmap(FaviconBitmapID bitmap_id) {
   sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
+      "SELECT image_data_id FROM favicon_bitmaps WHERE id=?"));
+  statement.BindInt64(0, bitmap_id);
+  int64 data_id = statement.Step() ? statement.ColumnInt64(0) : 0;
+
+  statement.Assign(db_.GetCachedStatement(SQL_FROM_HERE,
       "DELETE FROM favicon_bitmaps WHERE id=?"));
   statement.BindInt64(0, bitmap_id);
-  return statement.Run();
+  return statement.Run() && DeleteFaviconBitmapDataIfUnused(data_id);
 }
 
 bool ThumbnailDatabase::SetFaviconOutOfDate(chrome::FaviconID icon_id) {
@@ -932,10 +1056,7 @@ bool ThumbnailDatabase::DeleteFavicon(chrome::FaviconID id) {
   if (!statement.Run())
     return false;
 
-  statement.Assign(db_.GetCachedStatement(SQL_FROM_HERE,
-      "DELETE FROM favicon_bitmaps WHERE icon_id = ?"));
-  statement.BindInt64(0, id);
-  return statement.Run();
+  return DeleteFaviconBitmapsForFavicon(id);
 }
 
 bool ThumbnailDatabase::GetIconMappingsForPageURL(
@@ -1116,10 +1237,16 @@ bool ThumbnailDatabase::CommitTemporaryTables() {
       return false;
   }
 
+  // Delete the data of bitmaps which weren't copied to the temporary tables.
+  if (!db_.Execute("DELETE FROM favicon_bitmap_data WHERE id NOT IN "
+                   "(SELECT image_data_id FROM favicon_bitmaps)"))
+    return false;
+
   // The renamed tables needs indices (the temporary tables don't have any).
   return InitIconMappingIndex() &&
          InitFaviconsIndex() &&
-         InitFaviconBitmapsIndex();
+         InitFaviconBitmapsIndex() &&
+         InitFaviconBitmapDataIndices();
 }
 
 IconMappingID ThumbnailDatabase::AddToTemporaryIconMappingTable(
@@ -1143,9 +1270,9 @@ ThumbnailDatabase::CopyFaviconAndFaviconBitmapsToTemporaryTables(
   chrome::FaviconID new_favicon_id = db_.GetLastInsertRowId();
 
   statement.Assign(db_.GetCachedStatement(SQL_FROM_HERE,
-      "INSERT INTO temp_favicon_bitmaps (icon_id, last_updated, image_data, "
-      "width, height) "
-      "SELECT ?, last_updated, image_data, width, height "
+      "INSERT INTO temp_favicon_bitmaps (icon_id, last_updated, "
+      "image_data_id, width, height) "
+      "SELECT ?, last_updated, image_data_id, width, height "
       "FROM favicon_bitmaps WHERE icon_id = ?"));
   statement.BindInt64(0, new_favicon_id);
   statement.BindInt64(1, source);
@@ -1168,6 +1295,7 @@ bool ThumbnailDatabase::RenameAndDropThumbnails(
     return false;
 
   if (!InitFaviconBitmapsTable(&favicons, false) ||
+      !InitFaviconBitmapDataTable(&favicons) ||
       !InitFaviconsTable(&favicons, false) ||
       !InitIconMappingTable(&favicons, false)) {
     favicons.Close();
@@ -1202,10 +1330,12 @@ bool ThumbnailDatabase::RenameAndDropThumbnails(
     }
   }
 
-  // Move favicons and favicon_bitmaps to new DB.
+  // Move favicons, favicon_bitmaps and their data to new DB.
   bool successfully_moved_data =
      db_.Execute("INSERT OR REPLACE INTO new_favicons.favicon_bitmaps "
                  "SELECT * FROM favicon_bitmaps") &&
+     db_.Execute("INSERT OR REPLACE INTO new_favicons.favicon_bitmap_data "
+                 "SELECT * FROM favicon_bitmap_data") &&
      db_.Execute("INSERT OR REPLACE INTO new_favicons.favicons "
                  "SELECT * FROM favicons");
   if (!successfully_moved_data) {
@@ -1232,7 +1362,8 @@ bool ThumbnailDatabase::RenameAndDropThumbnails(
   if (!meta_table_.Init(&db_, kCurrentVersionNumber, kCompatibleVersionNumber))
     return false;
 
-  if (!InitFaviconBitmapsIndex() || !InitFaviconsIndex())
+  if (!InitFaviconBitmapsIndex() || !InitFaviconBitmapDataIndices() ||
+      !InitFaviconsIndex())
     return false;
 
   // Reopen the transaction.
@@ -1358,4 +1489,44 @@ bool ThumbnailDatabase::UpgradeToVersion7() {
   return true;
 }
 
+bool ThumbnailDatabase::UpgradeToVersion8() {
+  if (!db_.DoesColumnExist("favicon_bitmaps", "image_data_id") &&
+      !db_.Execute("ALTER TABLE favicon_bitmaps "
+                   "ADD image_data_id INTEGER DEFAULT 0"))
+    return false;
+
+  std::vector<FaviconBitmapID> bitmap_ids;
+  sql::Statement statement(db_.GetUniqueStatement(
+      "SELECT id FROM favicon_bitmaps WHERE image_data IS NOT NULL"));
+  while (statement.Step())
+    bitmap_ids.push_back(statement.ColumnInt64(0));
+  if (!statement.Succeeded())
+    return false;
+
+  for (size_t i = 0; i < bitmap_ids.size(); ++i) {
+    statement.Assign(db_.GetUniqueStatement(
+        "SELECT image_data FROM favicon_bitmaps WHERE id=?"));
+    statement.BindInt64(0, bitmap_ids[i]);
+    if (!statement.Step())
+      return false;
+    scoped_refptr<base::RefCountedBytes> data(new base::RefCountedBytes());
+    statement.ColumnBlobAsVector(0, &data->data());
+
+    int64 data_id = AddFaviconBitmapData(data);
+    if (!data_id && data->size())
+      return false;
+    statement.Assign(db_.GetUniqueStatement(
+        "UPDATE favicon_bitmaps SET image_data_id=?, image_data=NULL "
+        "WHERE id=?"));
+    statement.BindInt64(0, data_id);
+    statement.BindInt64(1, bitmap_ids[i]);
+    if (!statement.Run())
+      return false;
+  }
+
+  meta_table_.SetVersionNumber(8);
+  meta_table_.SetCompatibleVersionNumber(std::min(8, kCompatibleVersionNumber));
+  return true;
+}
+
 }  // namespace history
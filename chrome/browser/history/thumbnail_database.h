@@ -322,6 +322,8 @@ class ThumbnailDatabase {
   FRIEND_TEST_ALL_PREFIXES(ThumbnailDatabaseTest, UpgradeToVersion5);
   FRIEND_TEST_ALL_PREFIXES(ThumbnailDatabaseTest, UpgradeToVersion6);
   FRIEND_TEST_ALL_PREFIXES(ThumbnailDatabaseTest, UpgradeToVersion7);
+  FRIEND_TEST_ALL_PREFIXES(ThumbnailDatabaseTest, UpgradeToVersion8);
+  FRIEND_TEST_ALL_PREFIXES(ThumbnailDatabaseTest, SharedFaviconBitmapData);
   FRIEND_TEST_ALL_PREFIXES(HistoryBackendTest, MigrationIconMapping);
 
   // Creates the thumbnail table, returning true if the table already exists
@@ -346,6 +348,10 @@ class ThumbnailDatabase {
   // Removes sizes column.
   bool UpgradeToVersion7();
 
+  // Moves the bitmap data to the favicon_bitmap_data table, storing
+  // identical bitmaps once.
+  bool UpgradeToVersion8();
+
   // Migrates the icon mapping data from URL database to Thumbnail database.
   // Return whether the migration succeeds.
   bool MigrateIconMappingData(URLDatabase* url_db);
@@ -376,6 +382,30 @@ class ThumbnailDatabase {
   // table with no index).
   bool InitFaviconBitmapsIndex();
 
+  // Creates the favicon_bitmap_data table, return true if the table already
+  // exists or was successfully created.
+  bool InitFaviconBitmapDataTable(sql::Connection* db);
+
+  // Creates the indices used to find bitmap data by hash and the bitmaps
+  // sharing it. This is called once the favicon_bitmaps table has its
+  // image_data_id column, which databases older than version 8 lack until
+  // they're upgraded.
+  bool InitFaviconBitmapDataIndices();
+
+  // Returns the ID of the row of favicon_bitmap_data holding |bitmap_data|,
+  // adding it if no bitmap with the same bytes is stored yet. Returns 0 if
+  // |bitmap_data| is empty or on failure.
+  int64 AddFaviconBitmapData(
+      const scoped_refptr<base::RefCountedMemory>& bitmap_data);
+
+  // Deletes the row of favicon_bitmap_data with |data_id| if no favicon
+  // bitmap refers to it any more.
+  bool DeleteFaviconBitmapDataIfUnused(int64 data_id);
+
+  // Returns the IDs of the bitmap data of the favicon bitmaps of |icon_id|.
+  void GetFaviconBitmapDataIDs(chrome::FaviconID icon_id,
+                               std::vector<int64>* data_ids);
+
   // Creates the icon_map table, return true if the table already exists or was
   // successfully created.
   bool InitIconMappingTable(sql::Connection* db, bool is_temporary);
@@ -470,6 +470,60 @@ TEST_F(ThumbnailDatabaseTest, UpgradeToVersion7) {
   EXPECT_EQ(chrome::TOUCH_ICON, statement.ColumnInt(2));
 }
 
+// Test upgrading database to version 8.
+TEST_F(ThumbnailDatabaseTest, UpgradeToVersion8) {
+  ThumbnailDatabase db;
+  ASSERT_EQ(sql::INIT_OK, db.Init(file_name_, NULL, NULL));
+  db.BeginTransaction();
+
+  EXPECT_TRUE(db.db_.Execute("DROP TABLE favicon_bitmaps"));
+  EXPECT_TRUE(db.db_.Execute("CREATE TABLE favicon_bitmaps ("
+                             "id INTEGER PRIMARY KEY,"
+                             "icon_id INTEGER NOT NULL,"
+                             "last_updated INTEGER DEFAULT 0,"
+                             "image_data BLOB,"
+                             "width INTEGER DEFAULT 0,"
+                             "height INTEGER DEFAULT 0)"));
+
+  std::vector<unsigned char> data(blob1, blob1 + sizeof(blob1));
+  scoped_refptr<base::RefCountedBytes> bitmap_data(
+      new base::RefCountedBytes(data));
+
+  // Two icons with the same bitmap.
+  sql::Statement statement;
+  for (int icon_id = 1; icon_id <= 2; ++icon_id) {
+    statement.Assign(db.db_.GetCachedStatement(SQL_FROM_HERE,
+        "INSERT INTO favicon_bitmaps (icon_id, image_data, width, height) "
+        "VALUES (?, ?, 16, 16)"));
+    statement.BindInt(0, icon_id);
+    statement.BindBlob(1, bitmap_data->front(),
+                       static_cast<int>(bitmap_data->size()));
+    EXPECT_TRUE(statement.Run());
+  }
+
+  EXPECT_TRUE(db.UpgradeToVersion8());
+
+  EXPECT_TRUE(db.db_.DoesColumnExist("favicon_bitmaps", "image_data_id"));
+
+  statement.Assign(db.db_.GetCachedStatement(SQL_FROM_HERE,
+      "SELECT COUNT(*) FROM favicon_bitmaps WHERE image_data IS NOT NULL"));
+  ASSERT_TRUE(statement.Step());
+  EXPECT_EQ(0, statement.ColumnInt(0));
+
+  statement.Assign(db.db_.GetCachedStatement(SQL_FROM_HERE,
+      "SELECT COUNT(*) FROM favicon_bitmap_data"));
+  ASSERT_TRUE(statement.Step());
+  EXPECT_EQ(1, statement.ColumnInt(0));
+
+  std::vector<FaviconBitmap> favicon_bitmaps;
+  EXPECT_TRUE(db.GetFaviconBitmaps(2, &favicon_bitmaps));
+  ASSERT_EQ(1u, favicon_bitmaps.size());
+  ASSERT_TRUE(favicon_bitmaps[0].bitmap_data.get());
+  EXPECT_EQ(bitmap_data->size(), favicon_bitmaps[0].bitmap_data->size());
+  EXPECT_TRUE(std::equal(data.begin(), data.end(),
+                         favicon_bitmaps[0].bitmap_data->front()));
+}
+
 // Test that only data moved to a temporary table is left in the main table
 // once the temporary table is committed.
 TEST_F(ThumbnailDatabaseTest, TemporaryTables) {
@@ -545,6 +599,43 @@ TEST_F(ThumbnailDatabaseTest, DeleteFavicon) {
   EXPECT_FALSE(db.GetFaviconBitmaps(id, NULL));
 }
 
+// Tests that identical bitmaps share their data, which is deleted with the
+// last bitmap using it.
+TEST_F(ThumbnailDatabaseTest, SharedFaviconBitmapData) {
+  ThumbnailDatabase db;
+  ASSERT_EQ(sql::INIT_OK, db.Init(file_name_, NULL, NULL));
+  db.BeginTransaction();
+
+  std::vector<unsigned char> data(blob1, blob1 + sizeof(blob1));
+  scoped_refptr<base::RefCountedBytes> favicon(new base::RefCountedBytes(data));
+
+  base::Time last_updated = base::Time::Now();
+  chrome::FaviconID id1 =
+      db.AddFavicon(GURL("http://google.com/favicon.ico"), chrome::FAVICON);
+  db.AddFaviconBitmap(id1, favicon, last_updated, kSmallSize);
+  chrome::FaviconID id2 =
+      db.AddFavicon(GURL("http://www.google.com/favicon.ico"), chrome::FAVICON);
+  db.AddFaviconBitmap(id2, favicon, last_updated, kSmallSize);
+
+  sql::Statement statement(db.db_.GetUniqueStatement(
+      "SELECT COUNT(*) FROM favicon_bitmap_data"));
+  ASSERT_TRUE(statement.Step());
+  EXPECT_EQ(1, statement.ColumnInt(0));
+
+  EXPECT_TRUE(db.DeleteFavicon(id1));
+  std::vector<FaviconBitmap> favicon_bitmaps;
+  EXPECT_TRUE(db.GetFaviconBitmaps(id2, &favicon_bitmaps));
+  ASSERT_EQ(1u, favicon_bitmaps.size());
+  ASSERT_TRUE(favicon_bitmaps[0].bitmap_data.get());
+  EXPECT_EQ(sizeof(blob1), favicon_bitmaps[0].bitmap_data->size());
+
+  EXPECT_TRUE(db.DeleteFavicon(id2));
+  statement.Assign(db.db_.GetUniqueStatement(
+      "SELECT COUNT(*) FROM favicon_bitmap_data"));
+  ASSERT_TRUE(statement.Step());
+  EXPECT_EQ(0, statement.ColumnInt(0));
+}
+
 TEST_F(ThumbnailDatabaseTest, GetIconMappingsForPageURLForReturnOrder) {
   ThumbnailDatabase db;
   ASSERT_EQ(sql::INIT_OK, db.Init(file_name_, NULL, NULL));
@@ -41,6 +41,7 @@
 using google::protobuf::RepeatedField;
 using google::protobuf::RepeatedPtrField;
 using in_memory_url_index::InMemoryURLIndexCacheItem;
+using in_memory_url_index::InMemoryURLIndexJournalEntry;
 
 namespace {
 static const size_t kMaxVisitsToStoreInCache = 10u;
@@ -69,6 +70,74 @@ typedef imui::InMemoryURLIndexCacheItem_WordStartsMapItem WordStartsMapItem;
 typedef imui::InMemoryURLIndexCacheItem_WordStartsMapItem_WordStartsMapEntry
     WordStartsMapEntry;
 
+namespace {
+
+// Journal entries are preceded by their size in this many bytes.
+static const size_t kJournalEntrySizeBytes = 4;
+
+// Encodes the row with |history_id| and its recent visits into |map_entry|.
+void SaveHistoryInfoMapEntry(HistoryID history_id,
+                             const HistoryInfoMapValue& value,
+                             HistoryInfoMapEntry* map_entry) {
+  map_entry->set_history_id(history_id);
+  const URLRow& url_row(value.url_row);
+  map_entry->set_visit_count(url_row.visit_count());
+  map_entry->set_typed_count(url_row.typed_count());
+  map_entry->set_last_visit(url_row.last_visit().ToInternalValue());
+  map_entry->set_url(url_row.url().spec());
+  map_entry->set_title(UTF16ToUTF8(url_row.title()));
+  const VisitInfoVector& visits(value.visits);
+  for (VisitInfoVector::const_iterator visit_iter = visits.begin();
+       visit_iter != visits.end(); ++visit_iter) {
+    HistoryInfoMapEntry_VisitInfo* visit_info = map_entry->add_visits();
+    visit_info->set_visit_time(visit_iter->first.ToInternalValue());
+    visit_info->set_transition_type(visit_iter->second);
+  }
+}
+
+// Decodes the row and its recent visits from |map_entry| into |value|.
+void RestoreHistoryInfoMapEntry(const HistoryInfoMapEntry& map_entry,
+                                HistoryInfoMapValue* value) {
+  GURL url(map_entry.url());
+  URLRow url_row(url, map_entry.history_id());
+  url_row.set_visit_count(map_entry.visit_count());
+  url_row.set_typed_count(map_entry.typed_count());
+  url_row.set_last_visit(base::Time::FromInternalValue(map_entry.last_visit()));
+  if (map_entry.has_title()) {
+    string16 title(UTF8ToUTF16(map_entry.title()));
+    url_row.set_title(title);
+  }
+  value->url_row = url_row;
+
+  VisitInfoVector visits;
+  visits.reserve(map_entry.visits_size());
+  for (int i = 0; i < map_entry.visits_size(); ++i) {
+    visits.push_back(std::make_pair(
+        base::Time::FromInternalValue(map_entry.visits(i).visit_time()),
+        static_cast<content::PageTransition>(map_entry.visits(i).
+                                             transition_type())));
+  }
+  value->visits = visits;
+}
+
+// Returns |entry| serialized and preceded by its size, ready to be appended
+// to the journal file.
+std::string SerializeJournalEntry(const InMemoryURLIndexJournalEntry& entry) {
+  std::string data;
+  if (!entry.SerializeToString(&data)) {
+    LOG(WARNING) << "Failed to serialize an InMemoryURLIndex journal entry.";
+    return std::string();
+  }
+  uint32 size = data.size();
+  std::string record;
+  record.reserve(kJournalEntrySizeBytes + size);
+  for (size_t i = 0; i < kJournalEntrySizeBytes; ++i)
+    record.push_back(static_cast<char>((size >> (8 * i)) & 0xFF));
+  return record + data;
+}
+
+}  // namespace
+
 
 // Algorithm Functions ---------------------------------------------------------
 
@@ -192,22 +261,19 @@ ScoredHistoryMatches URLIndexPrivateData::HistoryItemsForTerms(
   // approach.
   ResetSearchTermCache();
 
-  HistoryIDSet history_id_set = HistoryIDSetFromWords(lower_words);
+  HistoryIDVector history_ids = HistoryIDsFromWords(lower_words);
 
   // Trim the candidate pool if it is large. Note that we do not filter out
   // items that do not contain the search terms as proper substrings -- doing
   // so is the performance-costly operation we are trying to avoid in order
   // to maintain omnibox responsiveness.
   const size_t kItemsToScoreLimit = 500;
-  pre_filter_item_count_ = history_id_set.size();
+  pre_filter_item_count_ = history_ids.size();
   // If we trim the results set we do not want to cache the results for next
   // time as the user's ultimately desired result could easily be eliminated
   // in this early rough filter.
   bool was_trimmed = (pre_filter_item_count_ > kItemsToScoreLimit);
   if (was_trimmed) {
-    HistoryIDVector history_ids;
-    std::copy(history_id_set.begin(), history_id_set.end(),
-              std::back_inserter(history_ids));
     // Trim down the set by sorting by typed-count, visit-count, and last
     // visit.
     HistoryItemFactorGreater
@@ -216,10 +282,8 @@ ScoredHistoryMatches URLIndexPrivateData::HistoryItemsForTerms(
                       history_ids.begin() + kItemsToScoreLimit,
                       history_ids.end(),
                       item_factor_functor);
-    history_id_set.clear();
-    std::copy(history_ids.begin(), history_ids.begin() + kItemsToScoreLimit,
-              std::inserter(history_id_set, history_id_set.end()));
-    post_filter_item_count_ = history_id_set.size();
+    history_ids.resize(kItemsToScoreLimit);
+    post_filter_item_count_ = history_ids.size();
   }
 
   // Pass over all of the candidates filtering out any without a proper
@@ -244,7 +308,7 @@ ScoredHistoryMatches URLIndexPrivateData::HistoryItemsForTerms(
     // but this is such a rare edge case that it's not worth the time.
     return scored_items;
   }
-  scored_items = std::for_each(history_id_set.begin(), history_id_set.end(),
+  scored_items = std::for_each(history_ids.begin(), history_ids.end(),
       AddHistoryMatch(*this, languages, bookmark_service, lower_raw_string,
                       lower_raw_terms, base::Time::Now())).ScoredMatches();
 
@@ -394,6 +458,7 @@ bool URLIndexPrivateData::DeleteURL(const GURL& url) {
 // static
 scoped_refptr<URLIndexPrivateData> URLIndexPrivateData::RestoreFromFile(
     const base::FilePath& file_path,
+    const base::FilePath& journal_path,
     const std::string& languages) {
   base::TimeTicks beginning_time = base::TimeTicks::Now();
   if (!base::PathExists(file_path))
@@ -414,6 +479,7 @@ scoped_refptr<URLIndexPrivateData> URLIndexPrivateData::RestoreFromFile(
 
   if (!restored_data->RestorePrivateData(index_cache, languages))
     return NULL;
+  restored_data->ReplayJournal(journal_path, languages);
 
   UMA_HISTOGRAM_TIMES("History.InMemoryURLIndexRestoreCacheTime",
                       base::TimeTicks::Now() - beginning_time);
@@ -464,10 +530,52 @@ scoped_refptr<URLIndexPrivateData> URLIndexPrivateData::RebuildFromHistory(
 // static
 bool URLIndexPrivateData::WritePrivateDataToCacheFileTask(
     scoped_refptr<URLIndexPrivateData> private_data,
-    const base::FilePath& file_path) {
+    const base::FilePath& file_path,
+    const base::FilePath& journal_path) {
   DCHECK(private_data.get());
   DCHECK(!file_path.empty());
-  return private_data->SaveToFile(file_path);
+  if (!private_data->SaveToFile(file_path))
+    return false;
+  base::DeleteFile(journal_path, false);
+  return true;
+}
+
+std::string URLIndexPrivateData::GetJournalEntryForRow(
+    HistoryID history_id) const {
+  InMemoryURLIndexJournalEntry entry;
+  HistoryInfoMap::const_iterator row_pos = history_info_map_.find(history_id);
+  if (row_pos != history_info_map_.end()) {
+    SaveHistoryInfoMapEntry(history_id, row_pos->second,
+                            entry.mutable_indexed_row());
+  } else {
+    entry.set_removed_history_id(history_id);
+  }
+  return SerializeJournalEntry(entry);
+}
+
+// static
+std::string URLIndexPrivateData::GetJournalEntryForClear() {
+  InMemoryURLIndexJournalEntry entry;
+  entry.set_cleared(true);
+  return SerializeJournalEntry(entry);
+}
+
+// static
+void URLIndexPrivateData::AppendToJournalFileTask(
+    const base::FilePath& journal_path,
+    const std::vector<std::string>& entries) {
+  std::string data;
+  for (std::vector<std::string>::const_iterator iter = entries.begin();
+       iter != entries.end(); ++iter)
+    data += *iter;
+  if (data.empty())
+    return;
+  int size = data.size();
+  int written = base::PathExists(journal_path) ?
+      file_util::AppendToFile(journal_path, data.c_str(), size) :
+      file_util::WriteFile(journal_path, data.c_str(), size);
+  if (written != size)
+    LOG(WARNING) << "Failed to write " << journal_path.value();
 }
 
 void URLIndexPrivateData::CancelPendingUpdates() {
@@ -511,14 +619,14 @@ void URLIndexPrivateData::Clear() {
 
 URLIndexPrivateData::~URLIndexPrivateData() {}
 
-HistoryIDSet URLIndexPrivateData::HistoryIDSetFromWords(
+HistoryIDVector URLIndexPrivateData::HistoryIDsFromWords(
     const String16Vector& unsorted_words) {
   // Break the terms down into individual terms (words), get the candidate
   // set for each term, and intersect each to get a final candidate list.
   // Note that a single 'term' from the user's perspective might be
   // a string like "http://www.somewebsite.com" which, from our perspective,
   // is four words: 'http', 'www', 'somewebsite', and 'com'.
-  HistoryIDSet history_id_set;
+  HistoryIDVector history_ids;
   String16Vector words(unsorted_words);
   // Sort the words into the longest first as such are likely to narrow down
   // the results quicker. Also, single character words are the most expensive
@@ -527,29 +635,30 @@ HistoryIDSet URLIndexPrivateData::HistoryIDSetFromWords(
   for (String16Vector::iterator iter = words.begin(); iter != words.end();
        ++iter) {
     string16 uni_word = *iter;
-    HistoryIDSet term_history_set = HistoryIDsForTerm(uni_word);
-    if (term_history_set.empty()) {
-      history_id_set.clear();
+    HistoryIDVector term_history_ids = HistoryIDsForTerm(uni_word);
+    if (term_history_ids.empty()) {
+      history_ids.clear();
       break;
     }
     if (iter == words.begin()) {
-      history_id_set.swap(term_history_set);
+      history_ids.swap(term_history_ids);
     } else {
-      HistoryIDSet new_history_id_set;
-      std::set_intersection(history_id_set.begin(), history_id_set.end(),
-                            term_history_set.begin(), term_history_set.end(),
-                            std::inserter(new_history_id_set,
-                                          new_history_id_set.begin()));
-      history_id_set.swap(new_history_id_set);
+      HistoryIDVector new_history_ids;
+      new_history_ids.reserve(
+          std::min(history_ids.size(), term_history_ids.size()));
+      std::set_intersection(history_ids.begin(), history_ids.end(),
+                            term_history_ids.begin(), term_history_ids.end(),
+                            std::back_inserter(new_history_ids));
+      history_ids.swap(new_history_ids);
     }
   }
-  return history_id_set;
+  return history_ids;
 }
 
-HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
+HistoryIDVector URLIndexPrivateData::HistoryIDsForTerm(
     const string16& term) {
   if (term.empty())
-    return HistoryIDSet();
+    return HistoryIDVector();
 
   // TODO(mrossetti): Consider optimizing for very common terms such as
   // 'http[s]', 'www', 'com', etc. Or collect the top 100 more frequently
@@ -578,15 +687,15 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
       size_t prefix_length = best_prefix->first.length();
       if (prefix_length == term_length) {
         best_prefix->second.used_ = true;
-        return best_prefix->second.history_id_set_;
+        return best_prefix->second.history_ids_;
       }
 
       // Otherwise we have a handy starting point.
       // If there are no history results for this prefix then we can bail early
       // as there will be no history results for the full term.
-      if (best_prefix->second.history_id_set_.empty()) {
+      if (best_prefix->second.history_ids_.empty()) {
         search_term_cache_[term] = SearchTermCacheItem();
-        return HistoryIDSet();
+        return HistoryIDVector();
       }
       word_id_set = best_prefix->second.word_id_set_;
       prefix_chars = Char16SetFromString16(best_prefix->first);
@@ -606,7 +715,7 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
       // We might come up empty on the leftovers.
       if (leftover_set.empty()) {
         search_term_cache_[term] = SearchTermCacheItem();
-        return HistoryIDSet();
+        return HistoryIDVector();
       }
       // Or there may not have been a prefix from which to start.
       if (prefix_chars.empty()) {
@@ -634,9 +743,10 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
     word_id_set = WordIDSetForTermChars(Char16SetFromString16(term));
   }
 
-  // If any words resulted then we can compose a set of history IDs by unioning
-  // the sets from each word.
-  HistoryIDSet history_id_set;
+  // If any words resulted then we can compose a list of history IDs by
+  // unioning the sets from each word. Appending them all and then sorting
+  // once is much cheaper than inserting each into a set.
+  HistoryIDVector history_ids;
   if (!word_id_set.empty()) {
     for (WordIDSet::iterator word_id_iter = word_id_set.begin();
          word_id_iter != word_id_set.end(); ++word_id_iter) {
@@ -644,18 +754,21 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
       WordIDHistoryMap::iterator word_iter = word_id_history_map_.find(word_id);
       if (word_iter != word_id_history_map_.end()) {
         HistoryIDSet& word_history_id_set(word_iter->second);
-        history_id_set.insert(word_history_id_set.begin(),
-                              word_history_id_set.end());
+        history_ids.insert(history_ids.end(), word_history_id_set.begin(),
+                           word_history_id_set.end());
       }
     }
+    std::sort(history_ids.begin(), history_ids.end());
+    history_ids.erase(std::unique(history_ids.begin(), history_ids.end()),
+                      history_ids.end());
   }
 
   // Record a new cache entry for this word if the term is longer than
   // a single character.
   if (term_length > 1)
-    search_term_cache_[term] = SearchTermCacheItem(word_id_set, history_id_set);
+    search_term_cache_[term] = SearchTermCacheItem(word_id_set, history_ids);
 
-  return history_id_set;
+  return history_ids;
 }
 
 WordIDSet URLIndexPrivateData::WordIDSetForTermChars(
@@ -991,25 +1104,12 @@ void URLIndexPrivateData::SaveHistoryInfoMap(
     return;
   HistoryInfoMapItem* map_item = cache->mutable_history_info_map();
   map_item->set_item_count(history_info_map_.size());
+  // Note: We only save information that contributes to the index so there
+  // is no need to save search_term_cache_ (not persistent).
   for (HistoryInfoMap::const_iterator iter = history_info_map_.begin();
        iter != history_info_map_.end(); ++iter) {
-    HistoryInfoMapEntry* map_entry = map_item->add_history_info_map_entry();
-    map_entry->set_history_id(iter->first);
-    const URLRow& url_row(iter->second.url_row);
-    // Note: We only save information that contributes to the index so there
-    // is no need to save search_term_cache_ (not persistent).
-    map_entry->set_visit_count(url_row.visit_count());
-    map_entry->set_typed_count(url_row.typed_count());
-    map_entry->set_last_visit(url_row.last_visit().ToInternalValue());
-    map_entry->set_url(url_row.url().spec());
-    map_entry->set_title(UTF16ToUTF8(url_row.title()));
-    const VisitInfoVector& visits(iter->second.visits);
-    for (VisitInfoVector::const_iterator visit_iter = visits.begin();
-         visit_iter != visits.end(); ++visit_iter) {
-      HistoryInfoMapEntry_VisitInfo* visit_info = map_entry->add_visits();
-      visit_info->set_visit_time(visit_iter->first.ToInternalValue());
-      visit_info->set_transition_type(visit_iter->second);
-    }
+    SaveHistoryInfoMapEntry(iter->first, iter->second,
+                            map_item->add_history_info_map_entry());
   }
 }
 
@@ -1174,28 +1274,8 @@ bool URLIndexPrivateData::RestoreHistoryInfoMap(
       entries(list_item.history_info_map_entry());
   for (RepeatedPtrField<HistoryInfoMapEntry>::const_iterator iter =
        entries.begin(); iter != entries.end(); ++iter) {
-    HistoryID history_id = iter->history_id();
-    GURL url(iter->url());
-    URLRow url_row(url, history_id);
-    url_row.set_visit_count(iter->visit_count());
-    url_row.set_typed_count(iter->typed_count());
-    url_row.set_last_visit(base::Time::FromInternalValue(iter->last_visit()));
-    if (iter->has_title()) {
-      string16 title(UTF8ToUTF16(iter->title()));
-      url_row.set_title(title);
-    }
-    history_info_map_[history_id].url_row = url_row;
-
-    // Restore visits list.
-    VisitInfoVector visits;
-    visits.reserve(iter->visits_size());
-    for (int i = 0; i < iter->visits_size(); ++i) {
-      visits.push_back(std::make_pair(
-          base::Time::FromInternalValue(iter->visits(i).visit_time()),
-          static_cast<content::PageTransition>(iter->visits(i).
-                                               transition_type())));
-    }
-    history_info_map_[history_id].visits = visits;
+    RestoreHistoryInfoMapEntry(*iter,
+                               &history_info_map_[iter->history_id()]);
   }
   return true;
 }
@@ -1247,6 +1327,51 @@ bool URLIndexPrivateData::RestoreWordStartsMap(
   return true;
 }
 
+void URLIndexPrivateData::ReplayJournal(const base::FilePath& journal_path,
+                                        const std::string& languages) {
+  std::string data;
+  if (journal_path.empty() || !base::PathExists(journal_path) ||
+      !file_util::ReadFileToString(journal_path, &data))
+    return;
+
+  int replayed_entries = 0;
+  size_t offset = 0;
+  while (data.size() - offset >= kJournalEntrySizeBytes) {
+    uint32 size = 0;
+    for (size_t i = 0; i < kJournalEntrySizeBytes; ++i)
+      size |= static_cast<uint32>(static_cast<uint8>(data[offset + i]))
+          << (8 * i);
+    offset += kJournalEntrySizeBytes;
+    InMemoryURLIndexJournalEntry entry;
+    if (size > data.size() - offset ||
+        !entry.ParseFromArray(data.data() + offset, size))
+      break;
+    offset += size;
+    ++replayed_entries;
+
+    if (entry.cleared()) {
+      base::Time last_time_rebuilt = last_time_rebuilt_from_history_;
+      Clear();
+      last_time_rebuilt_from_history_ = last_time_rebuilt;
+      continue;
+    }
+    HistoryID history_id = entry.has_indexed_row() ?
+        entry.indexed_row().history_id() : entry.removed_history_id();
+    HistoryInfoMap::iterator row_pos = history_info_map_.find(history_id);
+    if (row_pos != history_info_map_.end())
+      RemoveRowFromIndex(row_pos->second.url_row);
+    if (!entry.has_indexed_row())
+      continue;
+    HistoryInfoMapValue& value(history_info_map_[history_id]);
+    RestoreHistoryInfoMapEntry(entry.indexed_row(), &value);
+    RowWordStarts word_starts;
+    AddRowWordsToIndex(value.url_row, &word_starts, languages);
+    word_starts_map_[history_id] = word_starts;
+  }
+  UMA_HISTOGRAM_COUNTS_10000("History.InMemoryURLJournalEntries",
+                             replayed_entries);
+}
+
 // static
 bool URLIndexPrivateData::URLSchemeIsWhitelisted(
     const GURL& gurl,
@@ -1259,9 +1384,9 @@ bool URLIndexPrivateData::URLSchemeIsWhitelisted(
 
 URLIndexPrivateData::SearchTermCacheItem::SearchTermCacheItem(
     const WordIDSet& word_id_set,
-    const HistoryIDSet& history_id_set)
+    const HistoryIDVector& history_ids)
     : word_id_set_(word_id_set),
-      history_id_set_(history_id_set),
+      history_ids_(history_ids),
       used_(true) {}
 
 URLIndexPrivateData::SearchTermCacheItem::SearchTermCacheItem()
@@ -7,6 +7,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "base/files/file_path.h"
 #include "base/gtest_prod_util.h"
@@ -106,12 +107,14 @@ class URLIndexPrivateData
   bool DeleteURL(const GURL& url);
 
   // Constructs a new object by restoring its contents from the cache file
-  // at |path|. Returns the new URLIndexPrivateData which on success will
-  // contain the restored data but upon failure will be empty.  |languages|
-  // is used to break URLs and page titles into words.  This function
-  // should be run on the the file thread.
+  // at |path| and then applying the changes recorded in the journal file at
+  // |journal_path|, if there is one. Returns the new URLIndexPrivateData
+  // which on success will contain the restored data but upon failure will be
+  // empty.  |languages| is used to break URLs and page titles into words.
+  // This function should be run on the the file thread.
   static scoped_refptr<URLIndexPrivateData> RestoreFromFile(
       const base::FilePath& path,
+      const base::FilePath& journal_path,
       const std::string& languages);
 
   // Constructs a new object by rebuilding its contents from the history
@@ -125,9 +128,26 @@ class URLIndexPrivateData
       const std::set<std::string>& scheme_whitelist);
 
   // Writes |private_data| as a cache file to |file_path| and returns success.
+  // On success the journal file at |journal_path|, whose changes are now
+  // part of the cache file, is deleted.
   static bool WritePrivateDataToCacheFileTask(
       scoped_refptr<URLIndexPrivateData> private_data,
-      const base::FilePath& file_path);
+      const base::FilePath& file_path,
+      const base::FilePath& journal_path);
+
+  // Returns a serialized journal entry recording the current state of the
+  // row with |history_id|: the row itself if it is indexed, otherwise its
+  // removal from the index.
+  std::string GetJournalEntryForRow(HistoryID history_id) const;
+
+  // Returns a serialized journal entry recording that the index was cleared.
+  static std::string GetJournalEntryForClear();
+
+  // Appends the serialized journal |entries| to the journal file at
+  // |journal_path|, creating it if needed. This function should be run on
+  // the file thread.
+  static void AppendToJournalFileTask(const base::FilePath& journal_path,
+                                      const std::vector<std::string>& entries);
 
   // Stops all pending updates to recent visits fields.  This should be
   // called during shutdown.
@@ -150,6 +170,7 @@ class URLIndexPrivateData
   friend class AddHistoryMatch;
   friend class ::HistoryQuickProviderTest;
   friend class InMemoryURLIndexTest;
+  FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, CacheJournalReplay);
   FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, CacheSaveRestore);
   FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, HugeResultSet);
   FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, ReadVisitsFromHistory);
@@ -171,7 +192,7 @@ class URLIndexPrivateData
   // no longer needed.
   //
   // Items stored in the search term cache. If a search term exactly matches one
-  // in the cache then we can quickly supply the proper |history_id_set_| (and
+  // in the cache then we can quickly supply the proper |history_ids_| (and
   // marking the cache item as being |used_|. If we find a prefix for a search
   // term in the cache (which is very likely to occur as the user types each
   // term into the omnibox) then we can short-circuit the index search for those
@@ -179,14 +200,14 @@ class URLIndexPrivateData
   // not mark the item as being |used_|.
   struct SearchTermCacheItem {
     SearchTermCacheItem(const WordIDSet& word_id_set,
-                        const HistoryIDSet& history_id_set);
+                        const HistoryIDVector& history_ids);
     // Creates a cache item for a term which has no results.
     SearchTermCacheItem();
 
     ~SearchTermCacheItem();
 
     WordIDSet word_id_set_;
-    HistoryIDSet history_id_set_;
+    HistoryIDVector history_ids_;  // Sorted.
     bool used_;  // True if this item has been used for the current term search.
   };
   typedef std::map<string16, SearchTermCacheItem> SearchTermCacheMap;
@@ -233,13 +254,14 @@ class URLIndexPrivateData
 
   // URL History indexing support functions.
 
-  // Composes a set of history item IDs by intersecting the set for each word
-  // in |unsorted_words|.
-  HistoryIDSet HistoryIDSetFromWords(const String16Vector& unsorted_words);
+  // Composes a sorted vector of history item IDs by intersecting the IDs for
+  // each word in |unsorted_words|. Sorted vectors are used for the candidates
+  // rather than sets as they are built and intersected on every keystroke.
+  HistoryIDVector HistoryIDsFromWords(const String16Vector& unsorted_words);
 
-  // Helper function to HistoryIDSetFromWords which composes a set of history
-  // ids for the given term given in |term|.
-  HistoryIDSet HistoryIDsForTerm(const string16& term);
+  // Helper function to HistoryIDsFromWords which composes a sorted vector of
+  // history ids for the given term given in |term|.
+  HistoryIDVector HistoryIDsForTerm(const string16& term);
 
   // Given a set of Char16s, finds words containing those characters.
   WordIDSet WordIDSetForTermChars(const Char16Set& term_chars);
@@ -319,6 +341,14 @@ class URLIndexPrivateData
   bool RestoreWordStartsMap(const imui::InMemoryURLIndexCacheItem& cache,
                             const std::string& languages);
 
+  // Applies the changes recorded in the journal file at |journal_path| to
+  // the data restored from the cache file. Replay stops at the first entry
+  // that can't be read, which is the last one if the browser exited while
+  // appending it. |languages| will be used to break URLs and page titles
+  // into words.
+  void ReplayJournal(const base::FilePath& journal_path,
+                     const std::string& languages);
+
   // Determines if |gurl| has a whitelisted scheme and returns true if so.
   static bool URLSchemeIsWhitelisted(const GURL& gurl,
                                      const std::set<std::string>& whitelist);
@@ -515,7 +515,8 @@ void IOThread::InitAsync() {
   globals_->system_network_delegate.reset(network_delegate);
   globals_->host_resolver = CreateGlobalHostResolver(net_log_);
   UpdateDnsClientEnabled();
-  globals_->cert_verifier.reset(net::CertVerifier::CreateDefault());
+  globals_->cert_verifier.reset(
+      net::CertVerifier::CreateDefaultWithSharedCache());
   globals_->transport_security_state.reset(new net::TransportSecurityState());
   globals_->ssl_config_service = GetSSLConfigService();
   if (command_line.HasSwitch(switches::kSpdyProxyAuthOrigin)) {
@@ -108,7 +108,8 @@ class ExperimentURLRequestContext : public net::URLRequestContext {
 
     // The rest of the dependencies are standard, and don't depend on the
     // experiment being run.
-    storage_.set_cert_verifier(net::CertVerifier::CreateDefault());
+    storage_.set_cert_verifier(
+        net::CertVerifier::CreateDefaultWithSharedCache());
     storage_.set_transport_security_state(new net::TransportSecurityState);
     storage_.set_ssl_config_service(new net::SSLConfigServiceDefaults);
     storage_.set_http_auth_handler_factory(
@@ -249,6 +249,20 @@ HttpServerPropertiesManager::GetPipelineCapabilityMap() const {
   return http_server_properties_impl_->GetPipelineCapabilityMap();
 }
 
+bool HttpServerPropertiesManager::IsIPv6Broken(
+    const net::HostPortPair& server) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  return http_server_properties_impl_->IsIPv6Broken(server);
+}
+
+void HttpServerPropertiesManager::SetIPv6Broken(
+    const net::HostPortPair& server,
+    bool broken) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  // Not persisted, so the preferences need no update.
+  http_server_properties_impl_->SetIPv6Broken(server, broken);
+}
+
 //
 // Update the HttpServerPropertiesImpl's cache with data from preferences.
 //
@@ -152,6 +152,11 @@ class HttpServerPropertiesManager
 
   virtual net::PipelineCapabilityMap GetPipelineCapabilityMap() const OVERRIDE;
 
+  virtual bool IsIPv6Broken(const net::HostPortPair& server) OVERRIDE;
+
+  virtual void SetIPv6Broken(const net::HostPortPair& server,
+                             bool broken) OVERRIDE;
+
  protected:
   // --------------------
   // SPDY related methods
@@ -37,8 +37,10 @@
 #include "net/base/host_port_pair.h"
 #include "net/base/net_errors.h"
 #include "net/base/net_log.h"
+#include "net/dns/host_cache.h"
 #include "net/dns/host_resolver.h"
 #include "net/dns/single_request_host_resolver.h"
+#include "net/socket/client_socket_pool_manager.h"
 #include "net/url_request/url_request_context_getter.h"
 
 using base::TimeDelta;
@@ -293,6 +295,8 @@ void Predictor::RegisterProfilePrefs(
                              user_prefs::PrefRegistrySyncable::UNSYNCABLE_PREF);
   registry->RegisterListPref(prefs::kDnsPrefetchingHostReferralList,
                              user_prefs::PrefRegistrySyncable::UNSYNCABLE_PREF);
+  registry->RegisterListPref(prefs::kDnsPrefetchingHostCache,
+                             user_prefs::PrefRegistrySyncable::UNSYNCABLE_PREF);
 }
 
 // --------------------- Start UI methods. ------------------------------------
@@ -315,12 +319,17 @@ void Predictor::InitNetworkPredictor(PrefService* user_prefs,
       static_cast<base::ListValue*>(user_prefs->GetList(
           prefs::kDnsPrefetchingHostReferralList)->DeepCopy());
 
+  base::ListValue* host_cache_list =
+      static_cast<base::ListValue*>(user_prefs->GetList(
+          prefs::kDnsPrefetchingHostCache)->DeepCopy());
+
   // Now that we have the statistics in memory, wipe them from the Preferences
   // file. They will be serialized back on a clean shutdown. This way we only
   // have to worry about clearing our in-memory state when Clearing Browsing
   // Data.
   user_prefs->ClearPref(prefs::kDnsPrefetchingStartupList);
   user_prefs->ClearPref(prefs::kDnsPrefetchingHostReferralList);
+  user_prefs->ClearPref(prefs::kDnsPrefetchingHostCache);
 
   BrowserThread::PostTask(
       BrowserThread::IO,
@@ -328,7 +337,7 @@ void Predictor::InitNetworkPredictor(PrefService* user_prefs,
       base::Bind(
           &Predictor::FinalizeInitializationOnIOThread,
           base::Unretained(this),
-          urls, referral_list,
+          urls, referral_list, host_cache_list,
           io_thread, predictor_enabled));
 }
 
@@ -781,6 +790,13 @@ void Predictor::DeserializeReferrersThenDelete(
   delete referral_list;
 }
 
+void Predictor::RestoreHostCacheThenDelete(base::ListValue* host_cache_list) {
+  net::HostCache* host_cache = host_resolver_->GetHostCache();
+  if (host_cache)
+    host_cache->RestoreFromListValue(*host_cache_list);
+  delete host_cache_list;
+}
+
 void Predictor::DiscardInitialNavigationHistory() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   if (initial_observer_.get())
@@ -790,6 +806,7 @@ void Predictor::DiscardInitialNavigationHistory() {
 void Predictor::FinalizeInitializationOnIOThread(
     const UrlList& startup_urls,
     base::ListValue* referral_list,
+    base::ListValue* host_cache_list,
     IOThread* io_thread,
     bool predictor_enabled) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
@@ -799,6 +816,12 @@ void Predictor::FinalizeInitializationOnIOThread(
   host_resolver_ = io_thread->globals()->host_resolver.get();
   preconnect_usage_.reset(new PreconnectUsage());
 
+  // Let the socket pools top up preconnects to the number of sockets each
+  // origin has needed at once before, so a navigation does not wait on
+  // connects for its subresources.
+  if (preconnect_enabled_)
+    net::ClientSocketPoolManager::set_preconnect_learned_demand_enabled(true);
+
   // base::WeakPtrFactory instances need to be created and destroyed
   // on the same thread. The predictor lives on the IO thread and will die
   // from there so now that we're on the IO thread we need to properly
@@ -806,6 +829,10 @@ void Predictor::FinalizeInitializationOnIOThread(
   // TODO(groby): Check if WeakPtrFactory has the same constraint.
   weak_factory_.reset(new base::WeakPtrFactory<Predictor>(this));
 
+  // Restore the host cache first, so that the startup prefetches can be
+  // served from it.
+  RestoreHostCacheThenDelete(host_cache_list);
+
   // Prefetch these hostnames on startup.
   DnsPrefetchMotivatedList(startup_urls, UrlInfo::STARTUP_LIST_MOTIVATED);
   DeserializeReferrersThenDelete(referral_list);
@@ -869,6 +896,7 @@ void Predictor::DnsPrefetchMotivatedList(
 static void SaveDnsPrefetchStateForNextStartupAndTrimOnIOThread(
     base::ListValue* startup_list,
     base::ListValue* referral_list,
+    base::ListValue* host_cache_list,
     base::WaitableEvent* completion,
     Predictor* predictor) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
@@ -878,7 +906,7 @@ static void SaveDnsPrefetchStateForNextStartupAndTrimOnIOThread(
     return;
   }
   predictor->SaveDnsPrefetchStateForNextStartupAndTrim(
-      startup_list, referral_list, completion);
+      startup_list, referral_list, host_cache_list, completion);
 }
 
 void Predictor::SaveStateForNextStartupAndTrim(PrefService* prefs) {
@@ -890,10 +918,13 @@ void Predictor::SaveStateForNextStartupAndTrim(PrefService* prefs) {
   ListPrefUpdate update_startup_list(prefs, prefs::kDnsPrefetchingStartupList);
   ListPrefUpdate update_referral_list(prefs,
                                       prefs::kDnsPrefetchingHostReferralList);
+  ListPrefUpdate update_host_cache_list(prefs,
+                                        prefs::kDnsPrefetchingHostCache);
   if (BrowserThread::CurrentlyOn(BrowserThread::IO)) {
     SaveDnsPrefetchStateForNextStartupAndTrimOnIOThread(
         update_startup_list.Get(),
         update_referral_list.Get(),
+        update_host_cache_list.Get(),
         &completion,
         this);
   } else {
@@ -904,6 +935,7 @@ void Predictor::SaveStateForNextStartupAndTrim(PrefService* prefs) {
             &SaveDnsPrefetchStateForNextStartupAndTrimOnIOThread,
             update_startup_list.Get(),
             update_referral_list.Get(),
+            update_host_cache_list.Get(),
             &completion,
             this));
 
@@ -921,6 +953,7 @@ void Predictor::SaveStateForNextStartupAndTrim(PrefService* prefs) {
 void Predictor::SaveDnsPrefetchStateForNextStartupAndTrim(
     base::ListValue* startup_list,
     base::ListValue* referral_list,
+    base::ListValue* host_cache_list,
     base::WaitableEvent* completion) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   if (initial_observer_.get())
@@ -931,6 +964,12 @@ void Predictor::SaveDnsPrefetchStateForNextStartupAndTrim(
   TrimReferrersNow();
   SerializeReferrers(referral_list);
 
+  host_cache_list->Clear();
+  net::HostCache* host_cache =
+      host_resolver_ ? host_resolver_->GetHostCache() : NULL;
+  if (host_cache)
+    host_cache->GetAsListValue(host_cache_list);
+
   completion->Signal();
 }
 
@@ -192,11 +192,17 @@ class Predictor {
 
   void DeserializeReferrersThenDelete(base::ListValue* referral_list);
 
+  // Adds the host resolutions saved by SaveDnsPrefetchStateForNextStartupAndTrim
+  // in a previous session to the host cache, so that the first requests after
+  // startup don't wait for DNS.
+  void RestoreHostCacheThenDelete(base::ListValue* host_cache_list);
+
   void DiscardInitialNavigationHistory();
 
   void FinalizeInitializationOnIOThread(
       const std::vector<GURL>& urls_to_prefetch,
       base::ListValue* referral_list,
+      base::ListValue* host_cache_list,
       IOThread* io_thread,
       bool predictor_enabled);
 
@@ -220,6 +226,7 @@ class Predictor {
   void SaveDnsPrefetchStateForNextStartupAndTrim(
       base::ListValue* startup_list,
       base::ListValue* referral_list,
+      base::ListValue* host_cache_list,
       base::WaitableEvent* completion);
 
   // May be called from either the IO or UI thread and will PostTask
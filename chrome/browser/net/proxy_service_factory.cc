@@ -15,6 +15,7 @@
 #include "net/base/net_log.h"
 #include "net/proxy/dhcp_proxy_script_fetcher_factory.h"
 #include "net/proxy/proxy_config_service.h"
+#include "net/proxy/proxy_resolver_v8_tracing.h"
 #include "net/proxy/proxy_script_fetcher_impl.h"
 #include "net/proxy/proxy_service.h"
 #include "net/proxy/proxy_service_v8.h"
@@ -143,6 +144,10 @@ net::ProxyService* ProxyServiceFactory::CreateProxyService(
     dhcp_proxy_script_fetcher = dhcp_factory.Create(context);
 #endif
 
+    // Enterprise PAC scripts are often costly to run, and most only look at
+    // the host of the URL.
+    net::ProxyResolverV8Tracing::set_result_cache_enabled(true);
+
     proxy_service = net::CreateProxyServiceUsingV8ProxyResolver(
         proxy_config_service,
         new net::ProxyScriptFetcherImpl(context),
@@ -152,6 +152,14 @@ bool IsSpeculativeResourcePrefetchingEnabled(
     config->min_resource_confidence_to_trigger_prefetch = 0.9f;
     config->min_resource_hits_to_trigger_prefetch = 3;
     return true;
+  } else if (trial == "PrefetchingWarmCacheOnly") {
+    config->mode |= ResourcePrefetchPredictorConfig::URL_LEARNING;
+    config->mode |= ResourcePrefetchPredictorConfig::HOST_LEARNING;
+    config->mode |= ResourcePrefetchPredictorConfig::URL_PREFETCHING;
+    config->mode |= ResourcePrefetchPredictorConfig::HOST_PRFETCHING;
+
+    config->warm_cache_only = true;
+    return true;
   }
 
   return false;
@@ -210,7 +218,8 @@ ResourcePrefetchPredictorConfig::ResourcePrefetchPredictorConfig()
       min_resource_confidence_to_trigger_prefetch(0.8f),
       min_resource_hits_to_trigger_prefetch(3),
       max_prefetches_inflight_per_navigation(24),
-      max_prefetches_inflight_per_host_per_navigation(3) {
+      max_prefetches_inflight_per_host_per_navigation(3),
+      warm_cache_only(false) {
 }
 
 ResourcePrefetchPredictorConfig::~ResourcePrefetchPredictorConfig() {
@@ -109,6 +109,11 @@ struct ResourcePrefetchPredictorConfig {
   // Maximum number of prefetches that can be inflight for a host for a single
   // navigation.
   int max_prefetches_inflight_per_host_per_navigation;
+
+  // If true, prefetches only warm the HTTP cache: they are issued at IDLE
+  // priority as LOAD_PREFETCH requests, and responses that were served or
+  // revalidated from the cache are not read.
+  bool warm_cache_only;
 };
 
 }  // namespace predictors
@@ -1043,6 +1043,9 @@ void ResourcePrefetchPredictor::ReportAccuracyStats(
   // 'a_' -> actual, 'p_' -> predicted.
   int p_cache_a_cache = 0, p_cache_a_network = 0, p_cache_a_notused = 0,
       p_network_a_cache = 0, p_network_a_network = 0, p_network_a_notused = 0;
+  // The time spent fetching resources from the network that the navigation
+  // then found in the cache, i.e. an estimate of the time prefetching saved.
+  base::TimeDelta saved_fetch_time;
 
   for (ResourcePrefetcher::RequestVector::iterator it = prefetched->begin();
        it != prefetched->end(); ++it) {
@@ -1089,13 +1092,15 @@ void ResourcePrefetchPredictor::ReportAccuracyStats(
 
       case ResourcePrefetcher::Request::PREFETCH_STATUS_FROM_NETWORK:
           if (req->usage_status ==
-              ResourcePrefetcher::Request::USAGE_STATUS_FROM_CACHE)
+              ResourcePrefetcher::Request::USAGE_STATUS_FROM_CACHE) {
             ++p_network_a_cache;
-          else if (req->usage_status ==
-                   ResourcePrefetcher::Request::USAGE_STATUS_FROM_NETWORK)
+            saved_fetch_time += req->fetch_duration;
+          } else if (req->usage_status ==
+                     ResourcePrefetcher::Request::USAGE_STATUS_FROM_NETWORK) {
             ++p_network_a_network;
-          else
+          } else {
             ++p_network_a_notused;
+          }
         break;
 
       case ResourcePrefetcher::Request::PREFETCH_STATUS_NOT_STARTED:
@@ -1148,6 +1153,14 @@ void ResourcePrefetchPredictor::ReportAccuracyStats(
       prefetch_not_started * 100.0 / (prefetch_not_started + total_prefetched));
 
 #undef RPP_HISTOGRAM_PERCENTAGE
+
+  base::HistogramBase* saved_time_histogram = base::Histogram::FactoryTimeGet(
+      "ResourcePrefetchPredictor." + histogram_type + "PrefetchSavedFetchTime",
+      base::TimeDelta::FromMilliseconds(1), base::TimeDelta::FromMinutes(1),
+      50, base::Histogram::kUmaTargetedHistogramFlag);
+  saved_time_histogram->AddTime(saved_fetch_time);
+  UMA_HISTOGRAM_MEDIUM_TIMES("ResourcePrefetchPredictor.PrefetchSavedFetchTime",
+                             saved_fetch_time);
 }
 
 void ResourcePrefetchPredictor::ReportPredictedAccuracyStats(
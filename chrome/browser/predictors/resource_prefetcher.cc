@@ -9,6 +9,7 @@
 #include "base/stl_util.h"
 #include "content/public/browser/browser_thread.h"
 #include "net/base/io_buffer.h"
+#include "net/base/load_flags.h"
 
 namespace {
 
@@ -28,7 +29,9 @@ ResourcePrefetcher::Request::Request(const GURL& i_resource_url)
 ResourcePrefetcher::Request::Request(const Request& other)
     : resource_url(other.resource_url),
       prefetch_status(other.prefetch_status),
-      usage_status(other.usage_status) {
+      usage_status(other.usage_status),
+      start_time(other.start_time),
+      fetch_duration(other.fetch_duration) {
 }
 
 ResourcePrefetcher::ResourcePrefetcher(
@@ -120,6 +123,7 @@ void ResourcePrefetcher::TryToLaunchPrefetchRequests() {
 
 void ResourcePrefetcher::SendRequest(Request* request) {
   request->prefetch_status = Request::PREFETCH_STATUS_STARTED;
+  request->start_time = base::TimeTicks::Now();
 
   net::URLRequest* url_request =
       new net::URLRequest(request->resource_url,
@@ -131,7 +135,14 @@ void ResourcePrefetcher::SendRequest(Request* request) {
   url_request->set_method("GET");
   url_request->set_first_party_for_cookies(navigation_id_.main_frame_url);
   url_request->SetReferrer(navigation_id_.main_frame_url.spec());
-  url_request->SetPriority(net::LOW);
+  if (config_.warm_cache_only) {
+    // Only fill the cache, behind any request the navigation itself makes.
+    url_request->set_load_flags(net::LOAD_PREFETCH |
+                                net::LOAD_DO_NOT_PROMPT_FOR_LOGIN);
+    url_request->SetPriority(net::IDLE);
+  } else {
+    url_request->SetPriority(net::LOW);
+  }
   StartURLRequest(url_request);
 }
 
@@ -154,6 +165,8 @@ void ResourcePrefetcher::FinishRequest(net::URLRequest* request,
     host_inflight_counts_.erase(host);
 
   request_it->second->prefetch_status = status;
+  request_it->second->fetch_duration =
+      base::TimeTicks::Now() - request_it->second->start_time;
   inflight_requests_.erase(request_it);
 
   delete request;
@@ -220,6 +233,13 @@ void ResourcePrefetcher::OnResponseStarted(net::URLRequest* request) {
     return;
   }
 
+  // A response served or revalidated from the cache leaves the cache warm
+  // already, so its body doesn't need to be read.
+  if (config_.warm_cache_only && request->was_cached()) {
+    FinishRequest(request, Request::PREFETCH_STATUS_FROM_CACHE);
+    return;
+  }
+
   // TODO(shishir): Do not read cached entries, or ones that are not cacheable.
   ReadFullResponse(request);
 }
@@ -13,6 +13,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/scoped_vector.h"
 #include "base/threading/non_thread_safe.h"
+#include "base/time/time.h"
 #include "chrome/browser/predictors/resource_prefetch_common.h"
 #include "net/url_request/url_request.h"
 #include "url/gurl.h"
@@ -64,6 +65,10 @@ class ResourcePrefetcher : public base::NonThreadSafe,
     GURL resource_url;
     PrefetchStatus prefetch_status;
     UsageStatus usage_status;
+
+    // When the prefetch was started, and how long it took to finish.
+    base::TimeTicks start_time;
+    base::TimeDelta fetch_duration;
   };
   typedef ScopedVector<Request> RequestVector;
 
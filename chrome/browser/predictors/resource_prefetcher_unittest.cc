@@ -9,11 +9,13 @@
 #include "chrome/browser/predictors/resource_prefetcher_manager.h"
 #include "chrome/test/base/testing_profile.h"
 #include "content/public/test/test_browser_thread.h"
+#include "net/base/load_flags.h"
 #include "net/url_request/url_request.h"
 #include "net/url_request/url_request_test_util.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+using testing::AllOf;
 using testing::Eq;
 using testing::Property;
 
@@ -343,4 +345,51 @@ TEST_F(ResourcePrefetcherTest, TestPrefetcherStopped) {
   delete requests_ptr;
 }
 
+TEST_F(ResourcePrefetcherTest, TestWarmCacheOnly) {
+  config_.warm_cache_only = true;
+
+  scoped_ptr<ResourcePrefetcher::RequestVector> requests(
+      new ResourcePrefetcher::RequestVector);
+  requests->push_back(new ResourcePrefetcher::Request(GURL(
+      "http://www.google.com/resource1.html")));
+
+  NavigationID navigation_id;
+  navigation_id.render_process_id = 1;
+  navigation_id.render_view_id = 2;
+  navigation_id.main_frame_url = GURL("http://www.google.com");
+
+  // Needed later for comparison.
+  ResourcePrefetcher::RequestVector* requests_ptr = requests.get();
+
+  prefetcher_.reset(new TestResourcePrefetcher(&prefetcher_delegate_,
+                                               config_,
+                                               navigation_id,
+                                               PREFETCH_KEY_TYPE_URL,
+                                               requests.Pass()));
+
+  // The request is a low priority prefetch.
+  EXPECT_CALL(*prefetcher_,
+              StartURLRequest(AllOf(
+                  Property(&net::URLRequest::original_url,
+                           Eq(GURL("http://www.google.com/resource1.html"))),
+                  Property(&net::URLRequest::load_flags,
+                           Eq(net::LOAD_PREFETCH |
+                              net::LOAD_DO_NOT_PROMPT_FOR_LOGIN)),
+                  Property(&net::URLRequest::priority, Eq(net::IDLE)))));
+
+  prefetcher_->Start();
+  CheckPrefetcherState(1, 0, 1);
+
+  EXPECT_CALL(prefetcher_delegate_,
+              ResourcePrefetcherFinished(Eq(prefetcher_.get()),
+                                         Eq(requests_ptr)));
+
+  OnResponse("http://www.google.com/resource1.html");
+  CheckPrefetcherState(0, 0, 0);
+  EXPECT_EQ(Request::PREFETCH_STATUS_FROM_CACHE,
+            (*requests_ptr)[0]->prefetch_status);
+
+  delete requests_ptr;
+}
+
 }  // namespace predictors
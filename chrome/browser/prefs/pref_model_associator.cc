@@ -359,6 +359,8 @@ syncer::SyncError PrefModelAssociator::ProcessSyncChanges(
     return error;
   }
   base::AutoReset<bool> processing_changes(&processing_syncer_changes_, true);
+  // Tell the pref observers about the changes once they have all been made.
+  PrefService::ScopedBatchUpdate batch_update(pref_service_);
   syncer::SyncChangeList::const_iterator iter;
   for (iter = change_list.begin(); iter != change_list.end(); ++iter) {
     DCHECK_EQ(type_, iter->sync_data().GetDataType());
@@ -19,6 +19,10 @@ struct Config {
   // Maximum memory use for a prerendered page until it is killed.
   size_t max_bytes;
 
+  // Prerenders are not started when they are expected to leave less than this
+  // much physical memory available to the system. Zero disables the check.
+  size_t min_available_bytes;
+
   // Number of simultaneous prerender pages from link elements allowed. Enforced
   // by PrerenderLinkManager.
   size_t max_link_concurrency;
@@ -671,10 +671,11 @@ void PrerenderContents::DestroyWhenUsingTooManyResources() {
     return;
 
   size_t private_bytes, shared_bytes;
-  if (metrics->GetMemoryBytes(&private_bytes, &shared_bytes) &&
-      private_bytes > prerender_manager_->config().max_bytes) {
+  if (!metrics->GetMemoryBytes(&private_bytes, &shared_bytes))
+    return;
+  prerender_manager_->RecordPrerenderMemoryUse(prerender_url_, private_bytes);
+  if (private_bytes > prerender_manager_->config().max_bytes)
     Destroy(FINAL_STATUS_MEMORY_LIMIT_EXCEEDED);
-  }
 }
 
 WebContents* PrerenderContents::ReleasePrerenderContents() {
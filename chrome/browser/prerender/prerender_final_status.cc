@@ -56,6 +56,7 @@ const char* kFinalStatusNames[] = {
   "Register Protocol Handler",
   "Creating Audio Stream",
   "Page Being Captured",
+  "Low Memory",
   "Max",
 };
 COMPILE_ASSERT(arraysize(kFinalStatusNames) == FINAL_STATUS_MAX + 1,
@@ -57,6 +57,7 @@ enum FinalStatus {
   FINAL_STATUS_REGISTER_PROTOCOL_HANDLER = 42,
   FINAL_STATUS_CREATING_AUDIO_STREAM = 43,
   FINAL_STATUS_PAGE_BEING_CAPTURED = 44,
+  FINAL_STATUS_LOW_MEMORY = 45,
   FINAL_STATUS_MAX,
 };
 
@@ -16,6 +16,7 @@
 #include "base/metrics/histogram.h"
 #include "base/prefs/pref_service.h"
 #include "base/stl_util.h"
+#include "base/sys_info.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/time/time.h"
 #include "base/values.h"
@@ -75,6 +76,13 @@ namespace {
 // Time interval at which periodic cleanups are performed.
 const int kPeriodicCleanupIntervalMs = 1000;
 
+// The number of hosts whose prerender memory use is remembered.
+const size_t kMaxHostMemoryUseEntries = 100;
+
+// The memory a prerender is assumed to need when none has been measured for
+// its host yet.
+const size_t kDefaultPrerenderBytes = 32 * 1024 * 1024;
+
 // Valid HTTP methods for prerendering.
 const char* const kValidHttpMethods[] = {
   "GET",
@@ -234,6 +242,7 @@ PrerenderManager::PrerenderManager(Profile* profile,
       prerender_contents_factory_(PrerenderContents::CreateFactory()),
       last_prerender_start_time_(GetCurrentTimeTicks() -
           base::TimeDelta::FromMilliseconds(kMinTimeBetweenPrerendersMs)),
+      host_memory_use_(kMaxHostMemoryUseEntries),
       prerender_history_(new PrerenderHistory(kHistoryLength)),
       histograms_(new PrerenderHistograms()) {
   // There are some assumptions that the PrerenderManager is on the UI thread.
@@ -955,6 +964,17 @@ void PrerenderManager::AddCondition(const PrerenderCondition* condition) {
   prerender_conditions_.push_back(condition);
 }
 
+void PrerenderManager::RecordPrerenderMemoryUse(const GURL& url,
+                                                size_t private_bytes) {
+  DCHECK(CalledOnValidThread());
+  base::MRUCache<std::string, size_t>::iterator it =
+      host_memory_use_.Get(url.host());
+  if (it == host_memory_use_.end())
+    host_memory_use_.Put(url.host(), private_bytes);
+  else
+    it->second = std::max(it->second, private_bytes);
+}
+
 void PrerenderManager::RecordNavigation(const GURL& url) {
   DCHECK(CalledOnValidThread());
 
@@ -1139,6 +1159,13 @@ PrerenderHandle* PrerenderManager::AddPrerender(
     return NULL;
   }
 
+  // Don't start a prerender the system can't afford, or one that would be
+  // killed for exceeding max_bytes as its host's earlier prerenders were.
+  if (!DoesMemoryAllowPrerender(url)) {
+    RecordFinalStatus(origin, experiment, FINAL_STATUS_LOW_MEMORY);
+    return NULL;
+  }
+
   PrerenderContents* prerender_contents = CreatePrerenderContents(
       url, referrer, origin, experiment);
   DCHECK(prerender_contents);
@@ -1255,6 +1282,10 @@ base::TimeTicks PrerenderManager::GetCurrentTimeTicks() const {
   return base::TimeTicks::Now();
 }
 
+int64 PrerenderManager::GetAvailablePhysicalMemory() const {
+  return base::SysInfo::AmountOfAvailablePhysicalMemory();
+}
+
 PrerenderContents* PrerenderManager::CreatePrerenderContents(
     const GURL& url,
     const content::Referrer& referrer,
@@ -1312,6 +1343,22 @@ PrerenderManager::FindIteratorForPrerenderContents(
   return active_prerenders_.end();
 }
 
+bool PrerenderManager::DoesMemoryAllowPrerender(const GURL& url) {
+  DCHECK(CalledOnValidThread());
+  size_t expected_bytes = kDefaultPrerenderBytes;
+  base::MRUCache<std::string, size_t>::iterator it =
+      host_memory_use_.Peek(url.host());
+  if (it != host_memory_use_.end()) {
+    if (it->second > config_.max_bytes)
+      return false;
+    expected_bytes = it->second;
+  }
+  if (config_.min_available_bytes == 0)
+    return true;
+  return GetAvailablePhysicalMemory() >=
+      static_cast<int64>(expected_bytes + config_.min_available_bytes);
+}
+
 bool PrerenderManager::DoesRateLimitAllowPrerender(Origin origin) const {
   DCHECK(CalledOnValidThread());
   base::TimeDelta elapsed_time =
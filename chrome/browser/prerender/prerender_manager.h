@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "base/containers/hash_tables.h"
+#include "base/containers/mru_cache.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/scoped_vector.h"
@@ -296,6 +297,11 @@ class PrerenderManager : public base::SupportsWeakPtr<PrerenderManager>,
   // provided URL.
   void RecordNavigation(const GURL& url);
 
+  // Records that the prerender of |url| was measured using |private_bytes| of
+  // memory. Later prerenders from the same host are only started if the
+  // largest such measurement fits in the memory available.
+  void RecordPrerenderMemoryUse(const GURL& url, size_t private_bytes);
+
   // Updates the LoggedInPredictor state to reflect that a login has likely
   // on the URL provided.
   void RecordLikelyLoginOnURL(const GURL& url);
@@ -315,6 +321,10 @@ class PrerenderManager : public base::SupportsWeakPtr<PrerenderManager>,
   virtual base::Time GetCurrentTime() const;
   virtual base::TimeTicks GetCurrentTimeTicks() const;
 
+  // Returns the physical memory currently available to the system. Virtual so
+  // that tests can simulate memory pressure.
+  virtual int64 GetAvailablePhysicalMemory() const;
+
   scoped_refptr<predictors::LoggedInPredictorTable>
   logged_in_predictor_table() {
     return logged_in_predictor_table_;
@@ -509,6 +519,10 @@ class PrerenderManager : public base::SupportsWeakPtr<PrerenderManager>,
 
   bool DoesRateLimitAllowPrerender(Origin origin) const;
 
+  // Returns true if the system has enough memory available to prerender |url|,
+  // given how much memory prerenders from its host have used before.
+  bool DoesMemoryAllowPrerender(const GURL& url);
+
   // Deletes old WebContents that have been replaced by prerendered ones.  This
   // is needed because they're replaced in a callback from the old WebContents,
   // so cannot immediately be deleted.
@@ -615,6 +629,10 @@ class PrerenderManager : public base::SupportsWeakPtr<PrerenderManager>,
   // Track time of last prerender to limit prerender spam.
   base::TimeTicks last_prerender_start_time_;
 
+  // The largest private memory use measured for a prerender from each of the
+  // most recently prerendered hosts.
+  base::MRUCache<std::string, size_t> host_memory_use_;
+
   std::list<content::WebContents*> old_web_contents_list_;
 
   ScopedVector<OnCloseWebContentsDeleter> on_close_web_contents_deleters_;
@@ -94,6 +94,7 @@ class UnitTestPrerenderManager : public PrerenderManager {
       : PrerenderManager(profile, prerender_tracker),
         time_(Time::Now()),
         time_ticks_(TimeTicks::Now()),
+        available_physical_memory_(kint64max),
         prerender_tracker_(prerender_tracker) {
     set_rate_limit_enabled(false);
   }
@@ -190,6 +191,10 @@ class UnitTestPrerenderManager : public PrerenderManager {
     mutable_config().rate_limit_enabled = enabled;
   }
 
+  void set_available_physical_memory(int64 bytes) {
+    available_physical_memory_ = bytes;
+  }
+
   PrerenderContents* next_prerender_contents() {
     return next_prerender_contents_.get();
   }
@@ -203,6 +208,10 @@ class UnitTestPrerenderManager : public PrerenderManager {
     return time_ticks_;
   }
 
+  virtual int64 GetAvailablePhysicalMemory() const OVERRIDE {
+    return available_physical_memory_;
+  }
+
  private:
   void SetNextPrerenderContents(DummyPrerenderContents* prerender_contents) {
     CHECK(!next_prerender_contents_.get());
@@ -225,6 +234,7 @@ class UnitTestPrerenderManager : public PrerenderManager {
 
   Time time_;
   TimeTicks time_ticks_;
+  int64 available_physical_memory_;
   scoped_ptr<PrerenderContents> next_prerender_contents_;
   // PrerenderContents with an |expected_final_status| of FINAL_STATUS_USED,
   // tracked so they will be automatically deleted.
@@ -768,6 +778,34 @@ TEST_F(PrerenderTest, RecentlyVisited) {
   EXPECT_FALSE(prerender_contents->prerendering_has_started());
 }
 
+// Ensure that we don't start prerendering when the system is low on memory.
+TEST_F(PrerenderTest, LowMemoryTest) {
+  GURL url("http://www.google.com/");
+  prerender_manager()->set_available_physical_memory(
+      prerender_manager()->config().min_available_bytes);
+
+  DummyPrerenderContents* prerender_contents =
+      prerender_manager()->CreateNextPrerenderContents(
+          url, FINAL_STATUS_MANAGER_SHUTDOWN);
+  EXPECT_FALSE(AddSimplePrerender(url));
+  EXPECT_FALSE(prerender_contents->prerendering_has_started());
+}
+
+// Ensure that we don't prerender pages from a host whose earlier prerenders
+// used more than the memory limit.
+TEST_F(PrerenderTest, HostMemoryUseTest) {
+  GURL url("http://www.google.com/");
+  prerender_manager()->RecordPrerenderMemoryUse(
+      GURL("http://www.google.com/heavy"),
+      prerender_manager()->config().max_bytes + 1);
+
+  DummyPrerenderContents* prerender_contents =
+      prerender_manager()->CreateNextPrerenderContents(
+          url, FINAL_STATUS_MANAGER_SHUTDOWN);
+  EXPECT_FALSE(AddSimplePrerender(url));
+  EXPECT_FALSE(prerender_contents->prerendering_has_started());
+}
+
 TEST_F(PrerenderTest, NotSoRecentlyVisited) {
   GURL url("http://www.google.com/");
 
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <math.h>
 
+#include "base/bits.h"
 #include "base/file_util.h"
 #include "base/logging.h"
 #include "base/md5.h"
@@ -19,8 +20,11 @@ namespace {
 // md5 -qs chrome/browser/safe_browsing/prefix_set.cc | colrm 9
 static uint32 kMagic = 0x864088dd;
 
+// Version 1 stored 16-bit deltas, version 2 stores Rice-coded deltas.
+static uint32 kVersion1 = 0x1;
+
 // Current version the code writes out.
-static uint32 kVersion = 0x1;
+static uint32 kVersion = 0x2;
 
 typedef struct {
   uint32 magic;
@@ -29,29 +33,230 @@ typedef struct {
   uint32 deltas_size;
 } FileHeader;
 
+// Deltas whose unary part would be longer than this are not encoded,
+// a new index entry is started instead.  An index entry costs 64 bits,
+// so longer codes would not save space.
+static const uint32 kMaxQuotient = 32;
+
+// |rice_parameter_| is at most this, so that the verbatim bits of a
+// delta fit in 32 bits.
+static const uint32 kMaxRiceParameter = 31;
+
 // For |std::upper_bound()| to find a prefix w/in a vector of pairs.
-bool PrefixLess(const std::pair<SBPrefix,size_t>& a,
-                const std::pair<SBPrefix,size_t>& b) {
+bool PrefixLess(const std::pair<SBPrefix,uint32>& a,
+                const std::pair<SBPrefix,uint32>& b) {
   return a.first < b.first;
 }
 
+// Appends Rice codes to a vector of words, low bits first.
+class RiceWriter {
+ public:
+  RiceWriter(uint32 rice_parameter, std::vector<uint32>* words)
+      : rice_parameter_(rice_parameter),
+        words_(words),
+        bits_(0) {
+  }
+
+  uint32 bits() const { return bits_; }
+
+  void Write(uint32 value) {
+    for (uint32 q = value >> rice_parameter_; q; --q)
+      WriteBits(1, 1);
+    WriteBits(0, 1);
+    if (rice_parameter_)
+      WriteBits(value & ((1u << rice_parameter_) - 1), rice_parameter_);
+  }
+
+ private:
+  void WriteBits(uint32 value, uint32 count) {
+    const uint32 offset = bits_ % 32;
+    if (!offset)
+      words_->push_back(0);
+    words_->back() |= value << offset;
+    if (offset + count > 32)
+      words_->push_back(value >> (32 - offset));
+    bits_ += count;
+  }
+
+  const uint32 rice_parameter_;
+  std::vector<uint32>* words_;
+  uint32 bits_;
+};
+
+// Reads Rice codes from |words| between bit offsets |begin| and |end|.
+// Never reads past |end|, even if the data is corrupt.
+class RiceReader {
+ public:
+  RiceReader(uint32 rice_parameter, const std::vector<uint32>& words,
+             uint32 begin, uint32 end)
+      : rice_parameter_(rice_parameter),
+        words_(words),
+        pos_(begin),
+        end_(end) {
+  }
+
+  // Reads the next value into |value|.  Returns false if there are no
+  // more complete codes.
+  bool Read(uint32* value) {
+    uint32 q = 0;
+    while (true) {
+      if (pos_ >= end_)
+        return false;
+      const uint32 bit = (words_[pos_ / 32] >> (pos_ % 32)) & 1;
+      ++pos_;
+      if (!bit)
+        break;
+      ++q;
+    }
+    if (end_ - pos_ < rice_parameter_)
+      return false;
+    *value = (q << rice_parameter_) | ReadBits(rice_parameter_);
+    return true;
+  }
+
+ private:
+  uint32 ReadBits(uint32 count) {
+    if (!count)
+      return 0;
+    const uint32 offset = pos_ % 32;
+    uint64 bits = words_[pos_ / 32] >> offset;
+    if (offset + count > 32)
+      bits |= static_cast<uint64>(words_[pos_ / 32 + 1]) << (32 - offset);
+    pos_ += count;
+    return static_cast<uint32>(bits & ((GG_UINT64_C(1) << count) - 1));
+  }
+
+  const uint32 rice_parameter_;
+  const std::vector<uint32>& words_;
+  uint32 pos_;
+  const uint32 end_;
+};
+
+// Reads |count| items from |fp| into |v|, adding them to |context|.
+template <class T>
+bool ReadToVector(FILE* fp, size_t count, std::vector<T>* v,
+                  base::MD5Context* context) {
+  if (!count)
+    return true;
+
+  // Herb Sutter indicates that vectors are guaranteed to be
+  // contiuguous, so reading to where element 0 lives is valid.
+  v->resize(count);
+  if (fread(&((*v)[0]), sizeof((*v)[0]), count, fp) != count)
+    return false;
+  base::MD5Update(context,
+                  base::StringPiece(reinterpret_cast<char*>(&((*v)[0])),
+                                    sizeof((*v)[0]) * count));
+  return true;
+}
+
+// Writes the items of |v| to |fp|, adding them to |context|.
+template <class T>
+bool WriteVector(const std::vector<T>& v, FILE* fp,
+                 base::MD5Context* context) {
+  if (v.empty())
+    return true;
+
+  // As for reads, the standard guarantees the ability to access the
+  // contents of the vector by a pointer to an element.
+  if (fwrite(&(v[0]), sizeof(v[0]), v.size(), fp) != v.size())
+    return false;
+  base::MD5Update(context,
+                  base::StringPiece(reinterpret_cast<const char*>(&(v[0])),
+                                    sizeof(v[0]) * v.size()));
+  return true;
+}
+
+// Reads the digest at the end of |fp| and compares it to |context|.
+bool ReadAndCheckDigest(FILE* fp, base::MD5Context* context) {
+  base::MD5Digest calculated_digest;
+  base::MD5Final(&calculated_digest, context);
+
+  base::MD5Digest file_digest;
+  if (fread(&file_digest, sizeof(file_digest), 1, fp) != 1)
+    return false;
+
+  return 0 == memcmp(&file_digest, &calculated_digest, sizeof(file_digest));
+}
+
+// Reads the rest of a version 1 file, whose header has been read into
+// |context|, into |prefixes|.  Version 1 stored |index_| with a native
+// |size_t| offset into 16-bit deltas.
+bool ReadVersion1(FILE* fp, const FileHeader& header, int64 size_64,
+                  base::MD5Context* context, std::vector<SBPrefix>* prefixes) {
+  std::vector<std::pair<SBPrefix,size_t> > index;
+  const size_t index_bytes = sizeof(index[0]) * header.index_size;
+
+  std::vector<uint16> deltas;
+  const size_t deltas_bytes = sizeof(deltas[0]) * header.deltas_size;
+
+  // Check for bogus sizes before allocating any space.
+  const size_t expected_bytes = sizeof(header) + index_bytes + deltas_bytes +
+      sizeof(base::MD5Digest);
+  if (static_cast<int64>(expected_bytes) != size_64)
+    return false;
+
+  if (!ReadToVector(fp, header.index_size, &index, context) ||
+      !ReadToVector(fp, header.deltas_size, &deltas, context) ||
+      !ReadAndCheckDigest(fp, context)) {
+    return false;
+  }
+
+  prefixes->reserve(index.size() + deltas.size());
+  for (size_t ii = 0; ii < index.size(); ++ii) {
+    // The deltas for this |index| entry run to the next index entry,
+    // or the end of the deltas.
+    const size_t deltas_begin = std::min(index[ii].second, deltas.size());
+    const size_t deltas_end = (ii + 1 < index.size()) ?
+        std::min(index[ii + 1].second, deltas.size()) : deltas.size();
+
+    SBPrefix current = index[ii].first;
+    prefixes->push_back(current);
+    for (size_t di = deltas_begin; di < deltas_end; ++di) {
+      current += deltas[di];
+      prefixes->push_back(current);
+    }
+  }
+
+  // Only a corrupt file could be out of order.
+  for (size_t i = 1; i < prefixes->size(); ++i) {
+    if ((*prefixes)[i] < (*prefixes)[i - 1])
+      return false;
+  }
+  return true;
+}
+
 }  // namespace
 
 namespace safe_browsing {
 
-PrefixSet::PrefixSet(const std::vector<SBPrefix>& sorted_prefixes) {
+PrefixSet::PrefixSet(const std::vector<SBPrefix>& sorted_prefixes)
+    : deltas_bits_(0),
+      rice_parameter_(0) {
   if (sorted_prefixes.size()) {
+    // Rice coding is best when 2^|rice_parameter_| is about 0.69 times
+    // the average delta.  Outliers are moved to |index_| anyway, so
+    // the span of the prefixes is a good enough estimate.
+    const uint32 span = sorted_prefixes.back() - sorted_prefixes.front();
+    const uint32 average_delta = span / sorted_prefixes.size();
+    const int log_delta =
+        base::bits::Log2Floor(static_cast<uint32>(average_delta * 0.69));
+    rice_parameter_ = std::min(static_cast<uint32>(std::max(log_delta, 0)),
+                               kMaxRiceParameter);
+
     // Estimate the resulting vector sizes.  There will be strictly
     // more than |min_runs| entries in |index_|, but there generally
     // aren't many forced breaks.
     const size_t min_runs = sorted_prefixes.size() / kMaxRun;
     index_.reserve(min_runs);
-    deltas_.reserve(sorted_prefixes.size() - min_runs);
+    deltas_.reserve(sorted_prefixes.size() * (rice_parameter_ + 2) / 32);
+    RiceWriter writer(rice_parameter_, &deltas_);
 
     // Lead with the first prefix.
     SBPrefix prev_prefix = sorted_prefixes[0];
     size_t run_length = 0;
-    index_.push_back(std::make_pair(prev_prefix, deltas_.size()));
+    size_t delta_count = 0;
+    index_.push_back(std::make_pair(prev_prefix, writer.bits()));
 
     for (size_t i = 1; i < sorted_prefixes.size(); ++i) {
       // Skip duplicates.
@@ -62,28 +267,28 @@ PrefixSet::PrefixSet(const std::vector<SBPrefix>& sorted_prefixes) {
       // sorted_prefixes could be more than INT_MAX apart.
       DCHECK_GT(sorted_prefixes[i], prev_prefix);
       const unsigned delta = sorted_prefixes[i] - prev_prefix;
-      const uint16 delta16 = static_cast<uint16>(delta);
 
-      // New index ref if the delta doesn't fit, or if too many
-      // consecutive deltas have been encoded.
-      if (delta != static_cast<unsigned>(delta16) || run_length >= kMaxRun) {
-        index_.push_back(std::make_pair(sorted_prefixes[i], deltas_.size()));
+      // New index ref if the delta is too large to be worth encoding,
+      // or if too many consecutive deltas have been encoded.
+      if ((delta >> rice_parameter_) > kMaxQuotient || run_length >= kMaxRun) {
+        index_.push_back(std::make_pair(sorted_prefixes[i], writer.bits()));
         run_length = 0;
       } else {
         // Continue the run of deltas.
-        deltas_.push_back(delta16);
-        DCHECK_EQ(static_cast<unsigned>(deltas_.back()), delta);
+        writer.Write(delta);
+        ++delta_count;
         ++run_length;
       }
 
       prev_prefix = sorted_prefixes[i];
     }
+    deltas_bits_ = writer.bits();
 
     // Send up some memory-usage stats.  Bits because fractional bytes
     // are weird.
     const size_t bits_used = index_.size() * sizeof(index_[0]) * CHAR_BIT +
         deltas_.size() * sizeof(deltas_[0]) * CHAR_BIT;
-    const size_t unique_prefixes = index_.size() + deltas_.size();
+    const size_t unique_prefixes = index_.size() + delta_count;
     static const size_t kMaxBitsPerPrefix = sizeof(SBPrefix) * CHAR_BIT;
     UMA_HISTOGRAM_ENUMERATION("SB2.PrefixSetBitsPerPrefix",
                               bits_used / unique_prefixes,
@@ -91,8 +296,12 @@ PrefixSet::PrefixSet(const std::vector<SBPrefix>& sorted_prefixes) {
   }
 }
 
-PrefixSet::PrefixSet(std::vector<std::pair<SBPrefix,size_t> > *index,
-                     std::vector<uint16> *deltas) {
+PrefixSet::PrefixSet(std::vector<std::pair<SBPrefix,uint32> > *index,
+                     std::vector<uint32> *deltas,
+                     uint32 deltas_bits,
+                     uint32 rice_parameter)
+    : deltas_bits_(deltas_bits),
+      rice_parameter_(rice_parameter) {
   DCHECK(index && deltas);
   index_.swap(*index);
   deltas_.swap(*deltas);
@@ -105,9 +314,9 @@ bool PrefixSet::Exists(SBPrefix prefix) const {
     return false;
 
   // Find the first position after |prefix| in |index_|.
-  std::vector<std::pair<SBPrefix,size_t> >::const_iterator
+  std::vector<std::pair<SBPrefix,uint32> >::const_iterator
       iter = std::upper_bound(index_.begin(), index_.end(),
-                              std::pair<SBPrefix,size_t>(prefix, 0),
+                              std::pair<SBPrefix,uint32>(prefix, 0),
                               PrefixLess);
 
   // |prefix| comes before anything that's in the set.
@@ -115,7 +324,7 @@ bool PrefixSet::Exists(SBPrefix prefix) const {
     return false;
 
   // Capture the upper bound of our target entry's deltas.
-  const size_t bound = (iter == index_.end() ? deltas_.size() : iter->second);
+  const uint32 bound = (iter == index_.end() ? deltas_bits_ : iter->second);
 
   // Back up to the entry our target is in.
   --iter;
@@ -126,26 +335,28 @@ bool PrefixSet::Exists(SBPrefix prefix) const {
     return true;
 
   // Scan forward accumulating deltas while a match is possible.
-  for (size_t di = iter->second; di < bound && current < prefix; ++di) {
-    current += deltas_[di];
+  RiceReader reader(rice_parameter_, deltas_, iter->second, bound);
+  uint32 delta;
+  while (current < prefix && reader.Read(&delta)) {
+    current += delta;
   }
 
   return current == prefix;
 }
 
 void PrefixSet::GetPrefixes(std::vector<SBPrefix>* prefixes) const {
-  prefixes->reserve(index_.size() + deltas_.size());
-
   for (size_t ii = 0; ii < index_.size(); ++ii) {
     // The deltas for this |index_| entry run to the next index entry,
     // or the end of the deltas.
-    const size_t deltas_end =
-        (ii + 1 < index_.size()) ? index_[ii + 1].second : deltas_.size();
+    const uint32 deltas_end =
+        (ii + 1 < index_.size()) ? index_[ii + 1].second : deltas_bits_;
 
     SBPrefix current = index_[ii].first;
     prefixes->push_back(current);
-    for (size_t di = index_[ii].second; di < deltas_end; ++di) {
-      current += deltas_[di];
+    RiceReader reader(rice_parameter_, deltas_, index_[ii].second, deltas_end);
+    uint32 delta;
+    while (reader.Read(&delta)) {
+      current += delta;
       prefixes->push_back(current);
     }
   }
@@ -169,19 +380,7 @@ PrefixSet* PrefixSet::LoadFile(const base::FilePath& filter_name) {
   if (read != 1)
     return NULL;
 
-  if (header.magic != kMagic || header.version != kVersion)
-    return NULL;
-
-  std::vector<std::pair<SBPrefix,size_t> > index;
-  const size_t index_bytes = sizeof(index[0]) * header.index_size;
-
-  std::vector<uint16> deltas;
-  const size_t deltas_bytes = sizeof(deltas[0]) * header.deltas_size;
-
-  // Check for bogus sizes before allocating any space.
-  const size_t expected_bytes =
-      sizeof(header) + index_bytes + deltas_bytes + sizeof(MD5Digest);
-  if (static_cast<int64>(expected_bytes) != size_64)
+  if (header.magic != kMagic)
     return NULL;
 
   // The file looks valid, start building the digest.
@@ -190,43 +389,55 @@ PrefixSet* PrefixSet::LoadFile(const base::FilePath& filter_name) {
   base::MD5Update(&context, base::StringPiece(reinterpret_cast<char*>(&header),
                                               sizeof(header)));
 
-  // Read the index vector.  Herb Sutter indicates that vectors are
-  // guaranteed to be contiuguous, so reading to where element 0 lives
-  // is valid.
-  if (header.index_size) {
-    index.resize(header.index_size);
-    read = fread(&(index[0]), sizeof(index[0]), index.size(), file.get());
-    if (read != index.size())
+  // Convert version 1 files, which the next |WriteFile()| replaces.
+  if (header.version == kVersion1) {
+    std::vector<SBPrefix> prefixes;
+    if (!ReadVersion1(file.get(), header, size_64, &context, &prefixes))
       return NULL;
-    base::MD5Update(&context,
-                    base::StringPiece(reinterpret_cast<char*>(&(index[0])),
-                                      index_bytes));
+    return new PrefixSet(prefixes);
   }
 
-  // Read vector of deltas.
-  if (header.deltas_size) {
-    deltas.resize(header.deltas_size);
-    read = fread(&(deltas[0]), sizeof(deltas[0]), deltas.size(), file.get());
-    if (read != deltas.size())
-      return NULL;
-    base::MD5Update(&context,
-                    base::StringPiece(reinterpret_cast<char*>(&(deltas[0])),
-                                      deltas_bytes));
-  }
+  if (header.version != kVersion)
+    return NULL;
 
-  base::MD5Digest calculated_digest;
-  base::MD5Final(&calculated_digest, &context);
+  uint32 rice_parameter;
+  read = fread(&rice_parameter, sizeof(rice_parameter), 1, file.get());
+  if (read != 1 || rice_parameter > kMaxRiceParameter)
+    return NULL;
+  base::MD5Update(&context,
+                  base::StringPiece(reinterpret_cast<char*>(&rice_parameter),
+                                    sizeof(rice_parameter)));
 
-  base::MD5Digest file_digest;
-  read = fread(&file_digest, sizeof(file_digest), 1, file.get());
-  if (read != 1)
+  std::vector<std::pair<SBPrefix,uint32> > index;
+  const size_t index_bytes = sizeof(index[0]) * header.index_size;
+
+  std::vector<uint32> deltas;
+  const size_t deltas_words =
+      (static_cast<size_t>(header.deltas_size) + 31) / 32;
+  const size_t deltas_bytes = sizeof(deltas[0]) * deltas_words;
+
+  // Check for bogus sizes before allocating any space.
+  const size_t expected_bytes = sizeof(header) + sizeof(rice_parameter) +
+      index_bytes + deltas_bytes + sizeof(MD5Digest);
+  if (static_cast<int64>(expected_bytes) != size_64)
     return NULL;
 
-  if (0 != memcmp(&file_digest, &calculated_digest, sizeof(file_digest)))
+  if (!ReadToVector(file.get(), header.index_size, &index, &context) ||
+      !ReadToVector(file.get(), deltas_words, &deltas, &context) ||
+      !ReadAndCheckDigest(file.get(), &context)) {
     return NULL;
+  }
+
+  // |Exists()| relies on the offsets being in range and in order.
+  for (size_t i = 0; i < index.size(); ++i) {
+    if (index[i].second > header.deltas_size ||
+        (i > 0 && index[i].second < index[i - 1].second)) {
+      return NULL;
+    }
+  }
 
   // Steals contents of |index| and |deltas| via swap().
-  return new PrefixSet(&index, &deltas);
+  return new PrefixSet(&index, &deltas, header.deltas_size, rice_parameter);
 }
 
 bool PrefixSet::WriteFile(const base::FilePath& filter_name) const {
@@ -234,11 +445,10 @@ bool PrefixSet::WriteFile(const base::FilePath& filter_name) const {
   header.magic = kMagic;
   header.version = kVersion;
   header.index_size = static_cast<uint32>(index_.size());
-  header.deltas_size = static_cast<uint32>(deltas_.size());
+  header.deltas_size = deltas_bits_;
 
   // Sanity check that the 32-bit values never mess things up.
-  if (static_cast<size_t>(header.index_size) != index_.size() ||
-      static_cast<size_t>(header.deltas_size) != deltas_.size()) {
+  if (static_cast<size_t>(header.index_size) != index_.size()) {
     NOTREACHED();
     return false;
   }
@@ -258,30 +468,17 @@ bool PrefixSet::WriteFile(const base::FilePath& filter_name) const {
   base::MD5Update(&context, base::StringPiece(reinterpret_cast<char*>(&header),
                                               sizeof(header)));
 
-  // As for reads, the standard guarantees the ability to access the
-  // contents of the vector by a pointer to an element.
-  if (index_.size()) {
-    const size_t index_bytes = sizeof(index_[0]) * index_.size();
-    written = fwrite(&(index_[0]), sizeof(index_[0]), index_.size(),
-                     file.get());
-    if (written != index_.size())
-      return false;
-    base::MD5Update(&context,
-                    base::StringPiece(
-                        reinterpret_cast<const char*>(&(index_[0])),
-                        index_bytes));
-  }
+  written = fwrite(&rice_parameter_, sizeof(rice_parameter_), 1, file.get());
+  if (written != 1)
+    return false;
+  base::MD5Update(&context,
+                  base::StringPiece(
+                      reinterpret_cast<const char*>(&rice_parameter_),
+                      sizeof(rice_parameter_)));
 
-  if (deltas_.size()) {
-    const size_t deltas_bytes = sizeof(deltas_[0]) * deltas_.size();
-    written = fwrite(&(deltas_[0]), sizeof(deltas_[0]), deltas_.size(),
-                     file.get());
-    if (written != deltas_.size())
-      return false;
-    base::MD5Update(&context,
-                    base::StringPiece(
-                        reinterpret_cast<const char*>(&(deltas_[0])),
-                        deltas_bytes));
+  if (!WriteVector(index_, file.get(), &context) ||
+      !WriteVector(deltas_, file.get(), &context)) {
+    return false;
   }
 
   base::MD5Digest digest;
@@ -3,48 +3,46 @@
 // found in the LICENSE file.
 //
 // A read-only set implementation for |SBPrefix| items.  Prefixes are
-// sorted and stored as 16-bit deltas from the previous prefix.  An
+// sorted and stored as Rice-coded deltas from the previous prefix.  An
 // index structure provides quick random access, and also handles
-// cases where 16 bits cannot encode a delta.
+// cases where a delta is too large to encode efficiently.
 //
-// For example, the sequence {20, 25, 41, 65432, 150000, 160000} would
-// be stored as:
+// A delta |d| is Rice coded with parameter |k| as |d >> k| in unary
+// (that many 1 bits followed by a 0 bit), followed by the low |k| bits
+// of |d|.  |k| is chosen from the average distance between prefixes, so
+// that most deltas need around |k + 2| bits.  Deltas are packed into
+// 32-bit words, low bits first.
+//
+// For example, with |k| of 4 the sequence {20, 25, 41, 70, 150000}
+// would be stored as:
 //  A pair {20, 0} in |index_|.
-//  5, 16, 65391 in |deltas_|.
-//  A pair {150000, 3} in |index_|.
-//  10000 in |deltas_|.
-// |index_.size()| will be 2, |deltas_.size()| will be 4.
+//  5 as 0 0101, 16 as 10 0000, 29 as 10 1101 in |deltas_| (17 bits).
+//  A pair {150000, 17} in |index_|.
+// |index_.size()| will be 2, |deltas_bits_| will be 17.
 //
 // This structure is intended for storage of sparse uniform sets of
-// prefixes of a certain size.  As of this writing, my safe-browsing
-// database contains:
-//   653132 add prefixes
-//   6446 are duplicates (from different chunks)
-//   24301 w/in 2^8 of the prior prefix
-//   622337 w/in 2^16 of the prior prefix
-//   47 further than 2^16 from the prior prefix
-// For this input, the memory usage is approximately 2 bytes per
-// prefix, a bit over 1.2M.  The bloom filter used 25 bits per prefix,
-// a bit over 1.9M on this data.
-//
-// Experimenting with random selections of the above data, storage
-// size drops almost linearly as prefix count drops, until the index
-// overhead starts to become a problem a bit under 200k prefixes.  The
-// memory footprint gets worse than storing the raw prefix data around
-// 75k prefixes.  Fortunately, the actual memory footprint also falls.
-// If the prefix count increases the memory footprint should increase
-// approximately linearly.  The worst-case would be 2^16 items all
-// 2^16 apart, which would need 512k (versus 256k to store the raw
-// data).
+// prefixes of a certain size.  The gaps between uniformly distributed
+// prefixes are geometrically distributed, for which Rice coding is
+// close to optimal.  For the 650k prefixes of the browse list, this
+// needs around 15 bits per prefix including the index, where the
+// earlier 16-bit deltas needed a bit over 16.  Sparser sets gain more,
+// as deltas over 2^16 no longer need an index entry each: for 50k
+// random prefixes usage drops from about 38 to about 18 bits per
+// prefix.
 //
 // The on-disk format looks like:
 //         4 byte magic number
 //         4 byte version number
 //         4 byte |index_.size()|
-//         4 byte |deltas_.size()|
+//         4 byte |deltas_bits_|
+//         4 byte |rice_parameter_|
 //     n * 8 byte |&index_[0]..&index_[n]|
-//     m * 2 byte |&deltas_[0]..&deltas_[m]|
+//     m * 4 byte |&deltas_[0]..&deltas_[m]|
 //        16 byte digest
+//
+// Version 1 files, which stored 16-bit deltas with a native-width
+// index and no |rice_parameter_|, can still be read, and are converted
+// to the current format when loaded.
 
 #ifndef CHROME_BROWSER_SAFE_BROWSING_PREFIX_SET_H_
 #define CHROME_BROWSER_SAFE_BROWSING_PREFIX_SET_H_
@@ -83,19 +81,26 @@ class PrefixSet {
 
   // Helper for |LoadFile()|.  Steals the contents of |index| and
   // |deltas| using |swap()|.
-  PrefixSet(std::vector<std::pair<SBPrefix,size_t> > *index,
-            std::vector<uint16> *deltas);
+  PrefixSet(std::vector<std::pair<SBPrefix,uint32> > *index,
+            std::vector<uint32> *deltas,
+            uint32 deltas_bits,
+            uint32 rice_parameter);
 
-  // Top-level index of prefix to offset in |deltas_|.  Each pair
+  // Top-level index of prefix to bit offset in |deltas_|.  Each pair
   // indicates a base prefix and where the deltas from that prefix
   // begin in |deltas_|.  The deltas for a pair end at the next pair's
-  // index into |deltas_|.
-  std::vector<std::pair<SBPrefix,size_t> > index_;
+  // offset into |deltas_|, or at |deltas_bits_| for the last pair.
+  std::vector<std::pair<SBPrefix,uint32> > index_;
+
+  // Rice-coded deltas which are added to the prefix in |index_| to
+  // generate prefixes.
+  std::vector<uint32> deltas_;
+
+  // Number of bits of |deltas_| in use.
+  uint32 deltas_bits_;
 
-  // Deltas which are added to the prefix in |index_| to generate
-  // prefixes.  Deltas are only valid between consecutive items from
-  // |index_|, or the end of |deltas_| for the last |index_| pair.
-  std::vector<uint16> deltas_;
+  // Number of low bits of each delta stored verbatim.
+  uint32 rice_parameter_;
 
   DISALLOW_COPY_AND_ASSIGN(PrefixSet);
 };
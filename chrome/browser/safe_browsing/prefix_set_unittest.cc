@@ -13,6 +13,7 @@
 #include "base/md5.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/rand_util.h"
+#include "base/time/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/platform_test.h"
 
@@ -20,12 +21,13 @@ namespace {
 
 class PrefixSetTest : public PlatformTest {
  protected:
-  // Constants for the v1 format.
+  // Constants for the v2 format.
   static const size_t kMagicOffset = 0 * sizeof(uint32);
   static const size_t kVersionOffset = 1 * sizeof(uint32);
   static const size_t kIndexSizeOffset = 2 * sizeof(uint32);
   static const size_t kDeltasSizeOffset = 3 * sizeof(uint32);
-  static const size_t kPayloadOffset = 4 * sizeof(uint32);
+  static const size_t kRiceParameterOffset = 4 * sizeof(uint32);
+  static const size_t kPayloadOffset = 5 * sizeof(uint32);
 
   // Generate a set of random prefixes to share between tests.  For
   // most tests this generation was a large fraction of the test time.
@@ -144,6 +146,46 @@ class PrefixSetTest : public PlatformTest {
     ASSERT_EQ(new_size_64, size_64);
   }
 
+  // Write |prefixes| to |filename| in the v1 format, which stored
+  // 16-bit deltas.
+  static bool WriteVersion1File(const base::FilePath& filename,
+                                const std::vector<SBPrefix>& prefixes) {
+    std::vector<std::pair<SBPrefix,size_t> > index;
+    std::vector<uint16> deltas;
+    for (size_t i = 0; i < prefixes.size(); ++i) {
+      if (i > 0 && prefixes[i] == prefixes[i - 1])
+        continue;
+      const unsigned delta = i > 0 ? prefixes[i] - prefixes[i - 1] : 0;
+      if (i == 0 || delta > 0xFFFF)
+        index.push_back(std::make_pair(prefixes[i], deltas.size()));
+      else
+        deltas.push_back(static_cast<uint16>(delta));
+    }
+
+    const uint32 header[] = {
+      0x864088dd,
+      1,
+      static_cast<uint32>(index.size()),
+      static_cast<uint32>(deltas.size()),
+    };
+    std::string contents(reinterpret_cast<const char*>(header),
+                         sizeof(header));
+    if (!index.empty()) {
+      contents.append(reinterpret_cast<const char*>(&index[0]),
+                      sizeof(index[0]) * index.size());
+    }
+    if (!deltas.empty()) {
+      contents.append(reinterpret_cast<const char*>(&deltas[0]),
+                      sizeof(deltas[0]) * deltas.size());
+    }
+    base::MD5Digest digest;
+    base::MD5Sum(contents.data(), contents.size(), &digest);
+    contents.append(reinterpret_cast<const char*>(&digest), sizeof(digest));
+
+    const int size = static_cast<int>(contents.size());
+    return file_util::WriteFile(filename, contents.data(), size) == size;
+  }
+
   // Tests should not modify this shared resource.
   static std::vector<SBPrefix> shared_prefixes_;
 
@@ -350,6 +392,57 @@ TEST_F(PrefixSetTest, ReadWrite) {
   }
 }
 
+// Test that files in the v1 format are read, and written back out in
+// the current format.
+TEST_F(PrefixSetTest, ReadVersion1) {
+  ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  base::FilePath filename = temp_dir_.path().AppendASCII("PrefixSetTest");
+  ASSERT_TRUE(WriteVersion1File(filename, shared_prefixes_));
+
+  scoped_ptr<safe_browsing::PrefixSet>
+      prefix_set(safe_browsing::PrefixSet::LoadFile(filename));
+  ASSERT_TRUE(prefix_set.get());
+  CheckPrefixes(*prefix_set, shared_prefixes_);
+
+  int64 version1_size;
+  ASSERT_TRUE(file_util::GetFileSize(filename, &version1_size));
+  ASSERT_TRUE(prefix_set->WriteFile(filename));
+  int64 version2_size;
+  ASSERT_TRUE(file_util::GetFileSize(filename, &version2_size));
+  EXPECT_LT(version2_size, version1_size);
+
+  prefix_set.reset(safe_browsing::PrefixSet::LoadFile(filename));
+  ASSERT_TRUE(prefix_set.get());
+  CheckPrefixes(*prefix_set, shared_prefixes_);
+}
+
+// Measure the speed of |Exists()|, for hits and misses.
+TEST_F(PrefixSetTest, ExistsPerformance) {
+  safe_browsing::PrefixSet prefix_set(shared_prefixes_);
+
+  const size_t kLookups = 1000 * 1000;
+  std::vector<SBPrefix> lookups;
+  lookups.reserve(kLookups);
+  for (size_t i = 0; i < kLookups; ++i) {
+    if (i % 2)
+      lookups.push_back(shared_prefixes_[i % shared_prefixes_.size()]);
+    else
+      lookups.push_back(static_cast<SBPrefix>(base::RandUint64()));
+  }
+
+  size_t hits = 0;
+  base::TimeTicks start = base::TimeTicks::HighResNow();
+  for (size_t i = 0; i < kLookups; ++i) {
+    if (prefix_set.Exists(lookups[i]))
+      ++hits;
+  }
+  base::TimeDelta elapsed = base::TimeTicks::HighResNow() - start;
+  EXPECT_GE(hits, kLookups / 2);
+
+  printf("*RESULT prefix_set_exists: %.1f ns/lookup\n",
+         elapsed.InMicrosecondsF() * 1000 / kLookups);
+}
+
 // Check that |CleanChecksum()| makes an acceptable checksum.
 TEST_F(PrefixSetTest, CorruptionHelpers) {
   base::FilePath filename;
@@ -408,13 +501,26 @@ TEST_F(PrefixSetTest, CorruptionIndexSize) {
   ASSERT_FALSE(prefix_set.get());
 }
 
-// Bad |deltas_| size is caught by the sanity check.
+// Bad |deltas_| size is caught by the sanity check.  The size is in
+// bits, so add a word's worth.
 TEST_F(PrefixSetTest, CorruptionDeltasSize) {
   base::FilePath filename;
   ASSERT_TRUE(GetPrefixSetFile(&filename));
 
   ASSERT_NO_FATAL_FAILURE(
-      ModifyAndCleanChecksum(filename, kDeltasSizeOffset, 1));
+      ModifyAndCleanChecksum(filename, kDeltasSizeOffset, 32));
+  scoped_ptr<safe_browsing::PrefixSet>
+      prefix_set(safe_browsing::PrefixSet::LoadFile(filename));
+  ASSERT_FALSE(prefix_set.get());
+}
+
+// Bad |rice_parameter_| is caught by the sanity check.
+TEST_F(PrefixSetTest, CorruptionRiceParameter) {
+  base::FilePath filename;
+  ASSERT_TRUE(GetPrefixSetFile(&filename));
+
+  ASSERT_NO_FATAL_FAILURE(
+      ModifyAndCleanChecksum(filename, kRiceParameterOffset, 100));
   scoped_ptr<safe_browsing::PrefixSet>
       prefix_set(safe_browsing::PrefixSet::LoadFile(filename));
   ASSERT_FALSE(prefix_set.get());
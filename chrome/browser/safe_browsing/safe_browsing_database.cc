@@ -1336,6 +1336,10 @@ void SafeBrowsingDatabaseNew::UpdateBrowseStore() {
     prefixes.push_back(iter->prefix);
   }
 
+  // |add_prefixes| is no longer needed, free it before building the
+  // filter to lower the peak memory use of the update.
+  SBAddPrefixes().swap(add_prefixes);
+
   std::sort(prefixes.begin(), prefixes.end());
   scoped_ptr<safe_browsing::PrefixSet>
       prefix_set(new safe_browsing::PrefixSet(prefixes));
@@ -1361,7 +1365,7 @@ void SafeBrowsingDatabaseNew::UpdateBrowseStore() {
 
   DVLOG(1) << "SafeBrowsingDatabaseImpl built prefix set in "
            << (base::TimeTicks::Now() - before).InMilliseconds()
-           << " ms total.  prefix count: " << add_prefixes.size();
+           << " ms total.  prefix count: " << prefixes.size();
   UMA_HISTOGRAM_LONG_TIMES("SB2.BuildFilter", base::TimeTicks::Now() - before);
 
   // Persist the prefix set to disk.  Since only this thread changes
@@ -4,6 +4,8 @@
 
 #include "chrome/browser/safe_browsing/safe_browsing_store_file.h"
 
+#include <algorithm>
+
 #include "base/md5.h"
 #include "base/metrics/histogram.h"
 
@@ -102,6 +104,31 @@ bool ReadToContainer(CT* values, size_t count, FILE* fp,
   return true;
 }
 
+// Read |count| items into |values| from |fp| like |ReadToContainer()|,
+// merging in the items of |new_values|.  If the items in |fp| and
+// |new_values| are both sorted by |less|, the result is too, without
+// having to sort the whole of |values| again.  Only the items read from
+// |fp| are folded into the checksum in |context|.  Returns true on
+// success.
+template <typename CT, typename LessT>
+bool ReadAndMergeContainer(CT* values, size_t count, const CT& new_values,
+                           LessT less, FILE* fp,
+                           base::MD5Context* context) {
+  typename CT::const_iterator new_iter = new_values.begin();
+  for (size_t i = 0; i < count; ++i) {
+    typename CT::value_type value;
+    if (!ReadItem(&value, fp, context))
+      return false;
+
+    for (; new_iter != new_values.end() && less(*new_iter, value); ++new_iter)
+      values->push_back(*new_iter);
+    values->push_back(value);
+  }
+
+  values->insert(values->end(), new_iter, new_values.end());
+  return true;
+}
+
 // Write all of |values| to |fp|, and fold the data into the checksum
 // in |context|, if non-NULL.  Returns true on succsess.
 template <typename CT>
@@ -489,58 +516,12 @@ bool SafeBrowsingStoreFile::DoUpdate(
   std::vector<SBAddFullHash> add_full_hashes;
   std::vector<SBSubFullHash> sub_full_hashes;
 
-  // Read original data into the vectors.
-  if (!empty_) {
-    DCHECK(file_.get());
-
-    if (!FileRewind(file_.get()))
-      return OnCorruptDatabase();
-
-    base::MD5Context context;
-    base::MD5Init(&context);
-
-    // Read the file header and make sure it looks right.
-    FileHeader header;
-    if (!ReadAndVerifyHeader(filename_, file_.get(), &header, &context))
-      return OnCorruptDatabase();
-
-    // Re-read the chunks-seen data to get to the later data in the
-    // file and calculate the checksum.  No new elements should be
-    // added to the sets.
-    if (!ReadToContainer(&add_chunks_cache_, header.add_chunk_count,
-                         file_.get(), &context) ||
-        !ReadToContainer(&sub_chunks_cache_, header.sub_chunk_count,
-                         file_.get(), &context))
-      return OnCorruptDatabase();
-
-    if (!ReadToContainer(&add_prefixes, header.add_prefix_count,
-                         file_.get(), &context) ||
-        !ReadToContainer(&sub_prefixes, header.sub_prefix_count,
-                         file_.get(), &context) ||
-        !ReadToContainer(&add_full_hashes, header.add_hash_count,
-                         file_.get(), &context) ||
-        !ReadToContainer(&sub_full_hashes, header.sub_hash_count,
-                         file_.get(), &context))
-      return OnCorruptDatabase();
-
-    // Calculate the digest to this point.
-    base::MD5Digest calculated_digest;
-    base::MD5Final(&calculated_digest, &context);
-
-    // Read the stored checksum and verify it.
-    base::MD5Digest file_digest;
-    if (!ReadItem(&file_digest, file_.get(), NULL))
-      return OnCorruptDatabase();
-
-    if (0 != memcmp(&file_digest, &calculated_digest, sizeof(file_digest))) {
-      RecordFormatEvent(FORMAT_EVENT_UPDATE_CHECKSUM_FAILURE);
-      return OnCorruptDatabase();
-    }
-
-    // Close the file so we can later rename over it.
-    file_.reset();
-  }
-  DCHECK(!file_.get());
+  // The chunks accumulated in |new_file_|, usually much smaller than the
+  // data in |file_|.
+  SBAddPrefixes new_add_prefixes;
+  SBSubPrefixes new_sub_prefixes;
+  std::vector<SBAddFullHash> new_add_full_hashes;
+  std::vector<SBSubFullHash> new_sub_full_hashes;
 
   // Rewind the temporary storage.
   if (!FileRewind(new_file_.get()))
@@ -557,7 +538,7 @@ bool SafeBrowsingStoreFile::DoUpdate(
   UMA_HISTOGRAM_COUNTS("SB2.DatabaseUpdateKilobytes",
                        std::max(static_cast<int>(size / 1024), 1));
 
-  // Append the accumulated chunks onto the vectors read from |file_|.
+  // Read the accumulated chunks.
   for (int i = 0; i < chunks_written_; ++i) {
     ChunkHeader header;
 
@@ -578,27 +559,99 @@ bool SafeBrowsingStoreFile::DoUpdate(
     if (expected_size > size)
       return false;
 
-    // TODO(shess): If the vectors were kept sorted, then this code
-    // could use std::inplace_merge() to merge everything together in
-    // sorted order.  That might still be slower than just sorting at
-    // the end if there were a large number of chunks.  In that case
-    // some sort of recursive binary merge might be in order (merge
-    // chunks pairwise, merge those chunks pairwise, and so on, then
-    // merge the result with the main list).
-    if (!ReadToContainer(&add_prefixes, header.add_prefix_count,
+    if (!ReadToContainer(&new_add_prefixes, header.add_prefix_count,
                          new_file_.get(), NULL) ||
-        !ReadToContainer(&sub_prefixes, header.sub_prefix_count,
+        !ReadToContainer(&new_sub_prefixes, header.sub_prefix_count,
                          new_file_.get(), NULL) ||
-        !ReadToContainer(&add_full_hashes, header.add_hash_count,
+        !ReadToContainer(&new_add_full_hashes, header.add_hash_count,
                          new_file_.get(), NULL) ||
-        !ReadToContainer(&sub_full_hashes, header.sub_hash_count,
+        !ReadToContainer(&new_sub_full_hashes, header.sub_hash_count,
                          new_file_.get(), NULL))
       return false;
   }
 
   // Append items from |pending_adds|.
-  add_full_hashes.insert(add_full_hashes.end(),
-                         pending_adds.begin(), pending_adds.end());
+  new_add_full_hashes.insert(new_add_full_hashes.end(),
+                             pending_adds.begin(), pending_adds.end());
+
+  // The data in |file_| was sorted by |SBProcessSubs()| before it was
+  // written.  Sorting only the new items and merging them in while
+  // reading |file_| keeps the result sorted, so |SBProcessSubs()| does
+  // not have to sort everything again, and nothing but the result is
+  // held in memory.
+  std::sort(new_add_prefixes.begin(), new_add_prefixes.end(),
+            SBAddPrefixLess<SBAddPrefix,SBAddPrefix>);
+  std::sort(new_sub_prefixes.begin(), new_sub_prefixes.end(),
+            SBAddPrefixLess<SBSubPrefix,SBSubPrefix>);
+  std::sort(new_add_full_hashes.begin(), new_add_full_hashes.end(),
+            SBAddPrefixHashLess<SBAddFullHash,SBAddFullHash>);
+  std::sort(new_sub_full_hashes.begin(), new_sub_full_hashes.end(),
+            SBAddPrefixHashLess<SBSubFullHash,SBSubFullHash>);
+
+  if (empty_) {
+    add_prefixes.swap(new_add_prefixes);
+    sub_prefixes.swap(new_sub_prefixes);
+    add_full_hashes.swap(new_add_full_hashes);
+    sub_full_hashes.swap(new_sub_full_hashes);
+  } else {
+    DCHECK(file_.get());
+
+    if (!FileRewind(file_.get()))
+      return OnCorruptDatabase();
+
+    base::MD5Context context;
+    base::MD5Init(&context);
+
+    // Read the file header and make sure it looks right.
+    FileHeader header;
+    if (!ReadAndVerifyHeader(filename_, file_.get(), &header, &context))
+      return OnCorruptDatabase();
+
+    // Re-read the chunks-seen data to get to the later data in the
+    // file and calculate the checksum.  No new elements should be
+    // added to the sets.
+    if (!ReadToContainer(&add_chunks_cache_, header.add_chunk_count,
+                         file_.get(), &context) ||
+        !ReadToContainer(&sub_chunks_cache_, header.sub_chunk_count,
+                         file_.get(), &context))
+      return OnCorruptDatabase();
+
+    if (!ReadAndMergeContainer(&add_prefixes, header.add_prefix_count,
+                               new_add_prefixes,
+                               SBAddPrefixLess<SBAddPrefix,SBAddPrefix>,
+                               file_.get(), &context) ||
+        !ReadAndMergeContainer(&sub_prefixes, header.sub_prefix_count,
+                               new_sub_prefixes,
+                               SBAddPrefixLess<SBSubPrefix,SBSubPrefix>,
+                               file_.get(), &context) ||
+        !ReadAndMergeContainer(
+            &add_full_hashes, header.add_hash_count, new_add_full_hashes,
+            SBAddPrefixHashLess<SBAddFullHash,SBAddFullHash>,
+            file_.get(), &context) ||
+        !ReadAndMergeContainer(
+            &sub_full_hashes, header.sub_hash_count, new_sub_full_hashes,
+            SBAddPrefixHashLess<SBSubFullHash,SBSubFullHash>,
+            file_.get(), &context))
+      return OnCorruptDatabase();
+
+    // Calculate the digest to this point.
+    base::MD5Digest calculated_digest;
+    base::MD5Final(&calculated_digest, &context);
+
+    // Read the stored checksum and verify it.
+    base::MD5Digest file_digest;
+    if (!ReadItem(&file_digest, file_.get(), NULL))
+      return OnCorruptDatabase();
+
+    if (0 != memcmp(&file_digest, &calculated_digest, sizeof(file_digest))) {
+      RecordFormatEvent(FORMAT_EVENT_UPDATE_CHECKSUM_FAILURE);
+      return OnCorruptDatabase();
+    }
+
+    // Close the file so we can later rename over it.
+    file_.reset();
+  }
+  DCHECK(!file_.get());
 
   // Check how often a prefix was checked which wasn't in the
   // database.
@@ -193,4 +193,37 @@ TEST_F(SafeBrowsingStoreFileTest, CheckValidityChecksum) {
   EXPECT_TRUE(store_->CancelUpdate());
 }
 
+// Test that updates are merged into the stored data in sorted order.
+TEST_F(SafeBrowsingStoreFileTest, MergeUpdates) {
+  const int kChunks[] = { 3, 1, 5 };
+  SBAddPrefixes add_prefixes_result;
+  std::vector<SBAddFullHash> add_full_hashes_result;
+
+  // Each update adds a chunk which sorts between or before the
+  // existing ones, with prefixes written in descending order.
+  for (size_t i = 0; i < arraysize(kChunks); ++i) {
+    ASSERT_TRUE(store_->BeginUpdate());
+    EXPECT_TRUE(store_->BeginChunk());
+    store_->SetAddChunk(kChunks[i]);
+    for (SBPrefix prefix = 10; prefix > 0; --prefix)
+      EXPECT_TRUE(store_->WriteAddPrefix(kChunks[i], prefix * 1000 + i));
+    EXPECT_TRUE(store_->FinishChunk());
+
+    add_prefixes_result.clear();
+    add_full_hashes_result.clear();
+    EXPECT_TRUE(store_->FinishUpdate(std::vector<SBAddFullHash>(),
+                                     std::set<SBPrefix>(),
+                                     &add_prefixes_result,
+                                     &add_full_hashes_result));
+    EXPECT_EQ(10 * (i + 1), add_prefixes_result.size());
+  }
+
+  for (size_t i = 1; i < add_prefixes_result.size(); ++i) {
+    EXPECT_TRUE(SBAddPrefixLess(add_prefixes_result[i - 1],
+                                add_prefixes_result[i]));
+  }
+  EXPECT_EQ(1, add_prefixes_result.front().chunk_id);
+  EXPECT_EQ(5, add_prefixes_result.back().chunk_id);
+}
+
 }  // namespace
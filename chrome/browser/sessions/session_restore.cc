@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <list>
+#include <map>
 #include <set>
 #include <string>
 
@@ -80,11 +81,19 @@ std::set<SessionRestoreImpl*>* active_session_restorers = NULL;
 // Initial delay (see class decription for details).
 static const int kInitialDelayTimerMS = 100;
 
+// The most tabs, including the selected ones, that are loaded at once.
+static const size_t kMaxParallelTabLoads = 3;
+
 // TabLoader is responsible for loading tabs after session restore creates
 // tabs. New tabs are loaded after the current tab finishes loading, or a delay
 // is reached (initially kInitialDelayTimerMS). If the delay is reached before
 // a tab finishes loading a new tab is loaded and the time of the delay
-// doubled.
+// doubled. No more than kMaxParallelTabLoads tabs are loaded at once, and the
+// most recently used tabs are loaded first.
+//
+// Once SessionRestore::num_tabs_to_load_ non-selected tabs have been loaded
+// the rest are left with just their navigation entries, and only get a
+// renderer when they are selected.
 //
 // TabLoader keeps a reference to itself when it's loading. When it has finished
 // loading, it drops the reference. If another profile is restored while the
@@ -102,8 +111,9 @@ class TabLoader : public content::NotificationObserver,
   // starting timestamp is set to |restore_started|.
   static TabLoader* GetTabLoader(base::TimeTicks restore_started);
 
-  // Schedules a tab for loading.
-  void ScheduleLoad(NavigationController* controller);
+  // Schedules a tab for loading. Tabs are loaded in order of |last_active|,
+  // most recent first.
+  void ScheduleLoad(NavigationController* controller, base::Time last_active);
 
   // Notifies the loader that a tab has been scheduled for loading through
   // some other mechanism.
@@ -120,6 +130,7 @@ class TabLoader : public content::NotificationObserver,
   typedef std::set<NavigationController*> TabsLoading;
   typedef std::list<NavigationController*> TabsToLoad;
   typedef std::set<RenderWidgetHost*> RenderWidgetHostSet;
+  typedef std::map<NavigationController*, base::Time> LastActiveTimes;
 
   explicit TabLoader(base::TimeTicks restore_started);
   virtual ~TabLoader();
@@ -128,6 +139,10 @@ class TabLoader : public content::NotificationObserver,
   // otherwise |force_load_timer_| is restarted.
   void LoadNextTab();
 
+  // Stops scheduling the tabs that haven't started loading yet. They load
+  // when they are selected.
+  void DeferRemainingTabs();
+
   // NotificationObserver method. Removes the specified tab and loads the next
   // tab.
   virtual void Observe(int type,
@@ -176,6 +191,21 @@ class TabLoader : public content::NotificationObserver,
   // The tabs we need to load.
   TabsToLoad tabs_to_load_;
 
+  // When each of |tabs_to_load_| was last active.
+  LastActiveTimes last_active_times_;
+
+  // The selected tabs that are loading, used to record how long it takes for
+  // the first of them to become usable.
+  TabsLoading selected_tabs_loading_;
+
+  // Have we recorded the time for a selected tab to load?
+  bool got_selected_tab_load_;
+
+  // The number of non-selected tabs we've started loading, and the number we
+  // left to be loaded when they're selected.
+  size_t background_tabs_loaded_;
+  size_t tabs_deferred_;
+
   // The renderers we have started loading into.
   RenderWidgetHostSet render_widget_hosts_loading_;
 
@@ -207,11 +237,20 @@ TabLoader* TabLoader::GetTabLoader(base::TimeTicks restore_started) {
   return shared_tab_loader;
 }
 
-void TabLoader::ScheduleLoad(NavigationController* controller) {
+void TabLoader::ScheduleLoad(NavigationController* controller,
+                             base::Time last_active) {
   DCHECK(controller);
   DCHECK(find(tabs_to_load_.begin(), tabs_to_load_.end(), controller) ==
          tabs_to_load_.end());
-  tabs_to_load_.push_back(controller);
+  // Keep |tabs_to_load_| ordered most recently active first, with tabs of the
+  // same age in the order they were scheduled.
+  TabsToLoad::iterator insert_before = tabs_to_load_.begin();
+  while (insert_before != tabs_to_load_.end() &&
+         last_active_times_[*insert_before] >= last_active) {
+    ++insert_before;
+  }
+  tabs_to_load_.insert(insert_before, controller);
+  last_active_times_[controller] = last_active;
   RegisterForNotifications(controller);
 }
 
@@ -220,6 +259,7 @@ void TabLoader::TabIsLoading(NavigationController* controller) {
   DCHECK(find(tabs_loading_.begin(), tabs_loading_.end(), controller) ==
          tabs_loading_.end());
   tabs_loading_.insert(controller);
+  selected_tabs_loading_.insert(controller);
   RenderWidgetHost* render_widget_host = GetRenderWidgetHost(controller);
   DCHECK(render_widget_host);
   render_widget_hosts_loading_.insert(render_widget_host);
@@ -255,6 +295,9 @@ TabLoader::TabLoader(base::TimeTicks restore_started)
     : force_load_delay_(kInitialDelayTimerMS),
       loading_(false),
       got_first_paint_(false),
+      got_selected_tab_load_(false),
+      background_tabs_loaded_(0),
+      tabs_deferred_(0),
       tab_count_(0),
       restore_started_(restore_started),
       max_parallel_tab_loads_(0) {
@@ -268,13 +311,24 @@ TabLoader::~TabLoader() {
 }
 
 void TabLoader::LoadNextTab() {
-  if (!tabs_to_load_.empty()) {
+  if (SessionRestore::num_tabs_to_load_ &&
+      background_tabs_loaded_ >= SessionRestore::num_tabs_to_load_) {
+    DeferRemainingTabs();
+  }
+
+  if (!tabs_to_load_.empty() && tabs_loading_.size() < kMaxParallelTabLoads) {
     NavigationController* tab = tabs_to_load_.front();
     DCHECK(tab);
     tabs_loading_.insert(tab);
     if (tabs_loading_.size() > max_parallel_tab_loads_)
       max_parallel_tab_loads_ = tabs_loading_.size();
     tabs_to_load_.pop_front();
+    last_active_times_.erase(tab);
+    ++background_tabs_loaded_;
+    if (SessionRestore::num_tabs_to_load_ &&
+        background_tabs_loaded_ >= SessionRestore::num_tabs_to_load_) {
+      DeferRemainingTabs();
+    }
     tab->LoadIfNecessary();
     content::WebContents* contents = tab->GetWebContents();
     if (contents) {
@@ -312,6 +366,15 @@ void TabLoader::LoadNextTab() {
   }
 }
 
+void TabLoader::DeferRemainingTabs() {
+  while (!tabs_to_load_.empty()) {
+    // The tab stays in its unloaded state, and NavigationController loads it
+    // when its WebContents is first shown.
+    RemoveTab(tabs_to_load_.front());
+    ++tabs_deferred_;
+  }
+}
+
 void TabLoader::Observe(int type,
                         const content::NotificationSource& source,
                         const content::NotificationDetails& details) {
@@ -340,6 +403,17 @@ void TabLoader::Observe(int type,
     case content::NOTIFICATION_LOAD_STOP: {
       NavigationController* tab =
           content::Source<NavigationController>(source).ptr();
+      if (!got_selected_tab_load_ &&
+          selected_tabs_loading_.find(tab) != selected_tabs_loading_.end()) {
+        // The page the user sees is loaded and can be used.
+        got_selected_tab_load_ = true;
+        UMA_HISTOGRAM_CUSTOM_TIMES(
+            "SessionRestore.SelectedTabLoaded",
+            base::TimeTicks::Now() - restore_started_,
+            base::TimeDelta::FromMilliseconds(10),
+            base::TimeDelta::FromSeconds(100),
+            100);
+      }
       render_widget_hosts_to_paint_.insert(GetRenderWidgetHost(tab));
       HandleTabClosedOrLoaded(tab);
       break;
@@ -420,6 +494,8 @@ void TabLoader::RemoveTab(NavigationController* tab) {
   TabsLoading::iterator i = tabs_loading_.find(tab);
   if (i != tabs_loading_.end())
     tabs_loading_.erase(i);
+  selected_tabs_loading_.erase(tab);
+  last_active_times_.erase(tab);
 
   TabsToLoad::iterator j =
       find(tabs_to_load_.begin(), tabs_to_load_.end(), tab);
@@ -482,6 +558,7 @@ void TabLoader::HandleTabClosedOrLoaded(NavigationController* tab) {
 
     UMA_HISTOGRAM_COUNTS_100("SessionRestore.ParallelTabLoads",
                              max_parallel_tab_loads_);
+    UMA_HISTOGRAM_COUNTS_1000("SessionRestore.DeferredTabs", tabs_deferred_);
   }
 }
 
@@ -1061,7 +1138,7 @@ class SessionRestoreImpl : public content::NotificationObserver {
     }
 
     if (schedule_load)
-      tab_loader_->ScheduleLoad(&web_contents->GetController());
+      tab_loader_->ScheduleLoad(&web_contents->GetController(), tab.timestamp);
     return web_contents;
   }
 
@@ -1262,6 +1339,9 @@ bool SessionRestore::IsRestoring(const Profile* profile) {
   return false;
 }
 
+// static
+size_t SessionRestore::num_tabs_to_load_ = 16;
+
 // static
 bool SessionRestore::IsRestoringSynchronously() {
   if (!active_session_restorers)
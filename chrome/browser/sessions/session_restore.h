@@ -78,7 +78,8 @@ class SessionRestore {
   static bool IsRestoringSynchronously();
 
   // The max number of non-selected tabs SessionRestore loads when restoring
-  // a session. A value of 0 indicates all tabs are loaded at once.
+  // a session. The others are loaded when they are first selected. A value of
+  // 0 indicates all tabs are loaded.
   static size_t num_tabs_to_load_;
 
  private:
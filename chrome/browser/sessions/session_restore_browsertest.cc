@@ -4,6 +4,7 @@
 
 #include <vector>
 
+#include "base/auto_reset.h"
 #include "base/command_line.h"
 #include "base/files/file_path.h"
 #include "base/process/launch.h"
@@ -760,6 +761,43 @@ IN_PROC_BROWSER_TEST_F(SessionRestoreTest, TwoTabsSecondSelected) {
             new_browser->tab_strip_model()->GetWebContentsAt(0)->GetURL());
 }
 
+// Makes sure that only SessionRestore::num_tabs_to_load_ background tabs are
+// loaded on restore, and that the others load when they are selected.
+IN_PROC_BROWSER_TEST_F(SessionRestoreTest, LazyLoadsBackgroundTabs) {
+  base::AutoReset<size_t> num_tabs_to_load(&SessionRestore::num_tabs_to_load_,
+                                           1);
+  ui_test_utils::NavigateToURL(browser(), url1_);
+  ui_test_utils::NavigateToURLWithDisposition(
+      browser(), url2_, NEW_FOREGROUND_TAB,
+      ui_test_utils::BROWSER_TEST_WAIT_FOR_NAVIGATION);
+  ui_test_utils::NavigateToURLWithDisposition(
+      browser(), url3_, NEW_FOREGROUND_TAB,
+      ui_test_utils::BROWSER_TEST_WAIT_FOR_NAVIGATION);
+
+  Browser* new_browser = QuitBrowserAndRestore(browser(), 3);
+  TabStripModel* tab_strip = new_browser->tab_strip_model();
+  ASSERT_EQ(3, tab_strip->count());
+  ASSERT_EQ(2, tab_strip->active_index());
+
+  // One of the two background tabs was loaded, the other was deferred.
+  int deferred_index = -1;
+  for (int i = 0; i < 2; ++i) {
+    if (tab_strip->GetWebContentsAt(i)->GetController().NeedsReload()) {
+      EXPECT_EQ(-1, deferred_index);
+      deferred_index = i;
+    }
+  }
+  ASSERT_NE(-1, deferred_index);
+
+  content::WebContents* deferred_tab =
+      tab_strip->GetWebContentsAt(deferred_index);
+  content::TestNavigationObserver observer(deferred_tab);
+  tab_strip->ActivateTabAt(deferred_index, true);
+  observer.Wait();
+  EXPECT_FALSE(deferred_tab->GetController().NeedsReload());
+  EXPECT_EQ(deferred_index == 0 ? url1_ : url2_, deferred_tab->GetURL());
+}
+
 // Creates two tabs, closes one, quits and makes sure only one tab is restored.
 IN_PROC_BROWSER_TEST_F(SessionRestoreTest, ClosedTabStaysClosed) {
   ui_test_utils::NavigateToURL(browser(), url1_);
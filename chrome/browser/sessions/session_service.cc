@@ -79,8 +79,10 @@ static const SessionCommand::id_type kCommandSetTabUserAgentOverride = 18;
 static const SessionCommand::id_type kCommandSessionStorageAssociated = 19;
 static const SessionCommand::id_type kCommandSetActiveWindow = 20;
 
-// Every kWritesPerReset commands triggers recreating the file.
-static const int kWritesPerReset = 250;
+// The file is recreated from the open browsers once the commands appended to
+// it since it was last recreated are larger than what it was recreated with,
+// and at least kMinBytesPerReset.
+static const int64 kMinBytesPerReset = 256 * 1024;
 
 namespace {
 
@@ -1478,7 +1480,8 @@ void SessionService::ScheduleCommand(SessionCommand* command) {
   // Don't schedule a reset on tab closed/window closed. Otherwise we may
   // lose tabs/windows we want to restore from if we exit right after this.
   if (!pending_reset() && pending_window_close_ids_.empty() &&
-      commands_since_reset() >= kWritesPerReset &&
+      command_bytes_since_reset() >=
+          std::max(kMinBytesPerReset, last_reset_bytes()) &&
       (command->id() != kCommandTabClosed &&
        command->id() != kCommandWindowClosed)) {
     ScheduleReset();
@@ -0,0 +1,154 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/startup_task_graph.h"
+
+#include "base/bind.h"
+#include "base/debug/trace_event.h"
+#include "base/logging.h"
+#include "chrome/common/startup_metric_utils.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
+
+StartupTaskGraph::Task::Task()
+    : thread(UI_THREAD),
+      priority(BEFORE_FIRST_PAINT),
+      pending_dependencies(0),
+      started(false),
+      finished(false) {
+}
+
+StartupTaskGraph::Task::~Task() {
+}
+
+StartupTaskGraph::StartupTaskGraph()
+    : running_(false),
+      deferred_tasks_allowed_(false) {
+}
+
+StartupTaskGraph::~StartupTaskGraph() {
+}
+
+void StartupTaskGraph::AddTask(const std::string& name,
+                               const std::vector<std::string>& dependencies,
+                               TaskThread thread,
+                               TaskPriority priority,
+                               const base::Closure& task) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  DCHECK(tasks_.find(name) == tasks_.end()) << "Duplicate task " << name;
+
+  Task& new_task = tasks_[name];
+  new_task.thread = thread;
+  new_task.priority = priority;
+  new_task.closure = task;
+  for (size_t i = 0; i < dependencies.size(); ++i) {
+    TaskMap::iterator it = tasks_.find(dependencies[i]);
+    if (it == tasks_.end()) {
+      NOTREACHED() << name << " depends on unknown task " << dependencies[i];
+      continue;
+    }
+    DCHECK(priority == AFTER_FIRST_PAINT ||
+           it->second.priority == BEFORE_FIRST_PAINT)
+        << name << " can't wait for deferred task " << dependencies[i];
+    if (it->second.finished)
+      continue;
+    it->second.dependents.push_back(name);
+    ++new_task.pending_dependencies;
+  }
+  task_order_.push_back(name);
+
+  if (running_)
+    RunReadyTasks();
+}
+
+void StartupTaskGraph::RunStartupTasks() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  running_ = true;
+  RunReadyTasks();
+}
+
+void StartupTaskGraph::RunDeferredTasks() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (deferred_tasks_allowed_)
+    return;
+  deferred_tasks_allowed_ = true;
+  if (running_)
+    RunReadyTasks();
+}
+
+void StartupTaskGraph::RunDeferredTasksAfter(base::TimeDelta delay) {
+  BrowserThread::PostDelayedTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&StartupTaskGraph::RunDeferredTasks, this),
+      delay);
+}
+
+bool StartupTaskGraph::IsTaskFinished(const std::string& name) const {
+  TaskMap::const_iterator it = tasks_.find(name);
+  return it != tasks_.end() && it->second.finished;
+}
+
+void StartupTaskGraph::RunReadyTasks() {
+  // Index rather than iterate, as a task may add others while it runs.
+  for (size_t i = 0; i < task_order_.size(); ++i) {
+    const std::string name = task_order_[i];
+    Task& task = tasks_[name];
+    if (task.started || task.pending_dependencies > 0)
+      continue;
+    if (task.priority == AFTER_FIRST_PAINT && !deferred_tasks_allowed_)
+      continue;
+
+    task.started = true;
+    if (task.thread == BLOCKING_POOL) {
+      BrowserThread::PostBlockingPoolTaskAndReply(
+          FROM_HERE,
+          base::Bind(&StartupTaskGraph::RunTask, name, task.closure),
+          base::Bind(&StartupTaskGraph::OnBlockingPoolTaskFinished, this,
+                     name));
+    } else if (task.priority == AFTER_FIRST_PAINT) {
+      BrowserThread::PostTask(
+          BrowserThread::UI, FROM_HERE,
+          base::Bind(&StartupTaskGraph::RunPostedTask, this, name,
+                     task.closure));
+    } else {
+      RunTask(name, task.closure);
+      OnTaskFinished(name);
+    }
+  }
+}
+
+void StartupTaskGraph::OnTaskFinished(const std::string& name) {
+  Task& task = tasks_[name];
+  DCHECK(task.started);
+  task.finished = true;
+  task.closure.Reset();
+  for (size_t i = 0; i < task.dependents.size(); ++i) {
+    Task& dependent = tasks_[task.dependents[i]];
+    DCHECK_GT(dependent.pending_dependencies, 0);
+    --dependent.pending_dependencies;
+  }
+  task.dependents.clear();
+}
+
+void StartupTaskGraph::RunPostedTask(const std::string& name,
+                                     const base::Closure& closure) {
+  RunTask(name, closure);
+  OnTaskFinished(name);
+  RunReadyTasks();
+}
+
+void StartupTaskGraph::OnBlockingPoolTaskFinished(const std::string& name) {
+  OnTaskFinished(name);
+  RunReadyTasks();
+}
+
+// static
+void StartupTaskGraph::RunTask(const std::string& name,
+                               const base::Closure& closure) {
+  TRACE_EVENT1("startup", "StartupTaskGraph::RunTask", "name", name);
+  startup_metric_utils::ScopedSlowStartupUMA scoped_timer(
+      "Startup.SlowStartupTask." + name);
+  closure.Run();
+}
@@ -0,0 +1,127 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_STARTUP_TASK_GRAPH_H_
+#define CHROME_BROWSER_STARTUP_TASK_GRAPH_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/time/time.h"
+
+// StartupTaskGraph runs the browser's startup initializations in the order
+// given by their declared dependencies rather than in one long sequence on
+// the UI thread. Tasks that don't touch UI thread state run on the blocking
+// pool, concurrently with each other and with the UI thread, and tasks that
+// aren't needed to show the first tab are held back until the initial page
+// has loaded.
+//
+// The time taken by each task is recorded in the slow startup histograms of
+// startup_metric_utils, as "Startup.SlowStartupTask.<name>".
+//
+// All the methods must be called on the UI thread.
+class StartupTaskGraph : public base::RefCounted<StartupTaskGraph> {
+ public:
+  enum TaskThread {
+    // The task runs on the UI thread.
+    UI_THREAD,
+    // The task runs on the blocking pool, and may run concurrently with other
+    // tasks.
+    BLOCKING_POOL,
+  };
+
+  enum TaskPriority {
+    // The task runs as soon as its dependencies are done.
+    BEFORE_FIRST_PAINT,
+    // The task runs once RunDeferredTasks() has been called.
+    AFTER_FIRST_PAINT,
+  };
+
+  StartupTaskGraph();
+
+  // Adds the task |name|, which runs |task| on |thread| once every task named
+  // in |dependencies| has finished. The dependencies must have been added
+  // already, so the graph can't have cycles, and a BEFORE_FIRST_PAINT task
+  // can't depend on an AFTER_FIRST_PAINT one.
+  void AddTask(const std::string& name,
+               const std::vector<std::string>& dependencies,
+               TaskThread thread,
+               TaskPriority priority,
+               const base::Closure& task);
+
+  // Starts running the BEFORE_FIRST_PAINT tasks. The UI thread tasks whose
+  // dependencies are all on the UI thread have run when this returns; the
+  // others run as their dependencies finish.
+  void RunStartupTasks();
+
+  // Lets the AFTER_FIRST_PAINT tasks run. The UI thread ones are posted as
+  // separate tasks, so that input is handled between them. Calling this more
+  // than once has no effect.
+  void RunDeferredTasks();
+
+  // Calls RunDeferredTasks() after |delay|, in case the first page never
+  // finishes loading.
+  void RunDeferredTasksAfter(base::TimeDelta delay);
+
+  // Returns true if the task |name| has finished running.
+  bool IsTaskFinished(const std::string& name) const;
+
+ private:
+  friend class base::RefCounted<StartupTaskGraph>;
+
+  struct Task {
+    Task();
+    ~Task();
+
+    TaskThread thread;
+    TaskPriority priority;
+    base::Closure closure;
+
+    // Tasks that wait for this one to finish.
+    std::vector<std::string> dependents;
+
+    // The number of dependencies that haven't finished yet.
+    int pending_dependencies;
+
+    bool started;
+    bool finished;
+  };
+  typedef std::map<std::string, Task> TaskMap;
+
+  ~StartupTaskGraph();
+
+  // Starts every task that is ready to run.
+  void RunReadyTasks();
+
+  // Marks the task |name| as finished and releases its dependents.
+  void OnTaskFinished(const std::string& name);
+
+  // Runs a posted UI thread task, then the tasks it made ready.
+  void RunPostedTask(const std::string& name, const base::Closure& closure);
+
+  // Runs a blocking pool task, then the tasks it made ready.
+  void OnBlockingPoolTaskFinished(const std::string& name);
+
+  // Runs |closure|, recording its time in the histogram for task |name|. This
+  // may be called on any thread.
+  static void RunTask(const std::string& name, const base::Closure& closure);
+
+  TaskMap tasks_;
+
+  // The names of the tasks, in the order they were added. Since dependencies
+  // are added before their dependents, a single pass over this runs chains of
+  // UI thread tasks in order.
+  std::vector<std::string> task_order_;
+
+  bool running_;
+  bool deferred_tasks_allowed_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupTaskGraph);
+};
+
+#endif  // CHROME_BROWSER_STARTUP_TASK_GRAPH_H_
@@ -0,0 +1,114 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/startup_task_graph.h"
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/run_loop.h"
+#include "base/threading/sequenced_worker_pool.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/test/test_browser_thread_bundle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+void AppendName(std::vector<std::string>* order, const std::string& name) {
+  order->push_back(name);
+}
+
+std::vector<std::string> Dependencies(const char* first,
+                                      const char* second = NULL) {
+  std::vector<std::string> dependencies;
+  if (first)
+    dependencies.push_back(first);
+  if (second)
+    dependencies.push_back(second);
+  return dependencies;
+}
+
+class StartupTaskGraphTest : public testing::Test {
+ protected:
+  StartupTaskGraphTest() : graph_(new StartupTaskGraph) {}
+
+  void AddUITask(const std::string& name,
+                 const std::vector<std::string>& dependencies,
+                 StartupTaskGraph::TaskPriority priority) {
+    graph_->AddTask(name, dependencies, StartupTaskGraph::UI_THREAD, priority,
+                    base::Bind(&AppendName, &order_, name));
+  }
+
+  void FlushTasks() {
+    content::BrowserThread::GetBlockingPool()->FlushForTesting();
+    base::RunLoop().RunUntilIdle();
+  }
+
+  content::TestBrowserThreadBundle thread_bundle_;
+  scoped_refptr<StartupTaskGraph> graph_;
+  std::vector<std::string> order_;
+};
+
+TEST_F(StartupTaskGraphTest, UITasksRunInDependencyOrder) {
+  AddUITask("a", Dependencies(NULL), StartupTaskGraph::BEFORE_FIRST_PAINT);
+  AddUITask("b", Dependencies("a"), StartupTaskGraph::BEFORE_FIRST_PAINT);
+  AddUITask("c", Dependencies("a", "b"), StartupTaskGraph::BEFORE_FIRST_PAINT);
+  EXPECT_TRUE(order_.empty());
+
+  graph_->RunStartupTasks();
+  ASSERT_EQ(3u, order_.size());
+  EXPECT_EQ("a", order_[0]);
+  EXPECT_EQ("b", order_[1]);
+  EXPECT_EQ("c", order_[2]);
+  EXPECT_TRUE(graph_->IsTaskFinished("c"));
+}
+
+TEST_F(StartupTaskGraphTest, DependentsWaitForBlockingPoolTasks) {
+  std::vector<std::string> blocking_pool_order;
+  graph_->AddTask("io", Dependencies(NULL), StartupTaskGraph::BLOCKING_POOL,
+                  StartupTaskGraph::BEFORE_FIRST_PAINT,
+                  base::Bind(&AppendName, &blocking_pool_order, "io"));
+  AddUITask("after_io", Dependencies("io"),
+            StartupTaskGraph::BEFORE_FIRST_PAINT);
+  AddUITask("independent", Dependencies(NULL),
+            StartupTaskGraph::BEFORE_FIRST_PAINT);
+
+  graph_->RunStartupTasks();
+  ASSERT_EQ(1u, order_.size());
+  EXPECT_EQ("independent", order_[0]);
+  EXPECT_FALSE(graph_->IsTaskFinished("after_io"));
+
+  FlushTasks();
+  EXPECT_EQ(1u, blocking_pool_order.size());
+  ASSERT_EQ(2u, order_.size());
+  EXPECT_EQ("after_io", order_[1]);
+  EXPECT_TRUE(graph_->IsTaskFinished("io"));
+}
+
+TEST_F(StartupTaskGraphTest, DeferredTasksWaitForFirstPaint) {
+  AddUITask("startup", Dependencies(NULL),
+            StartupTaskGraph::BEFORE_FIRST_PAINT);
+  AddUITask("deferred", Dependencies("startup"),
+            StartupTaskGraph::AFTER_FIRST_PAINT);
+
+  graph_->RunStartupTasks();
+  FlushTasks();
+  ASSERT_EQ(1u, order_.size());
+  EXPECT_FALSE(graph_->IsTaskFinished("deferred"));
+
+  graph_->RunDeferredTasks();
+  // Deferred UI thread tasks are posted rather than run inline.
+  EXPECT_EQ(1u, order_.size());
+  FlushTasks();
+  ASSERT_EQ(2u, order_.size());
+  EXPECT_EQ("deferred", order_[1]);
+
+  // Running the deferred tasks again doesn't run them twice.
+  graph_->RunDeferredTasks();
+  FlushTasks();
+  EXPECT_EQ(2u, order_.size());
+}
+
+}  // namespace
@@ -71,6 +71,12 @@ class ChangeProcessor {
   };
 
  protected:
+  // The number of local changes to write per WriteTransaction when pushing a
+  // large batch of them to the sync model. Committing the batch in chunks
+  // releases the transaction lock in between, so that other threads' read
+  // transactions don't wait for the whole batch.
+  static const int kMaxChangesPerTransaction = 100;
+
   // These methods are invoked by Start() and Stop() to do
   // implementation-specific work.
   virtual void StartImpl(Profile* profile) = 0;
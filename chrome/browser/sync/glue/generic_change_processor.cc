@@ -5,6 +5,7 @@
 #include "chrome/browser/sync/glue/generic_change_processor.h"
 
 #include "base/location.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "content/public/browser/browser_thread.h"
@@ -311,16 +312,28 @@ syncer::SyncError GenericChangeProcessor::ProcessSyncChanges(
     const tracked_objects::Location& from_here,
     const syncer::SyncChangeList& list_of_changes) {
   DCHECK(CalledOnValidThread());
-  syncer::WriteTransaction trans(from_here, share_handle());
+  scoped_ptr<syncer::WriteTransaction> trans;
+  int changes_in_transaction = 0;
 
   for (syncer::SyncChangeList::const_iterator iter = list_of_changes.begin();
        iter != list_of_changes.end();
        ++iter) {
+    // Start a new transaction every kMaxChangesPerTransaction changes. The
+    // sync model has no rollback, so an error part way through leaves the
+    // earlier changes applied either way.
+    if (changes_in_transaction == kMaxChangesPerTransaction)
+      trans.reset();
+    if (!trans) {
+      trans.reset(new syncer::WriteTransaction(from_here, share_handle()));
+      changes_in_transaction = 0;
+    }
+    ++changes_in_transaction;
+
     const syncer::SyncChange& change = *iter;
     DCHECK_NE(change.sync_data().GetDataType(), syncer::UNSPECIFIED);
     syncer::ModelType type = change.sync_data().GetDataType();
     std::string type_str = syncer::ModelTypeToString(type);
-    syncer::WriteNode sync_node(&trans);
+    syncer::WriteNode sync_node(trans.get());
     if (change.change_type() == syncer::SyncChange::ACTION_DELETE) {
       syncer::SyncError error =
           AttemptDelete(change, type, type_str, &sync_node,
@@ -336,7 +349,7 @@ syncer::SyncError GenericChangeProcessor::ProcessSyncChanges(
     } else if (change.change_type() == syncer::SyncChange::ACTION_ADD) {
       // TODO(sync): Handle other types of creation (custom parents, folders,
       // etc.).
-      syncer::ReadNode root_node(&trans);
+      syncer::ReadNode root_node(trans.get());
       if (root_node.InitByTagLookup(
               syncer::ModelTypeToRootTag(change.sync_data().GetDataType())) !=
                   syncer::BaseNode::INIT_OK) {
@@ -445,8 +458,8 @@ syncer::SyncError GenericChangeProcessor::ProcessSyncChanges(
           LOG(ERROR) << "Update: deleted entry.";
           return error;
         } else {
-          syncer::Cryptographer* crypto = trans.GetCryptographer();
-          syncer::ModelTypeSet encrypted_types(trans.GetEncryptedTypes());
+          syncer::Cryptographer* crypto = trans->GetCryptographer();
+          syncer::ModelTypeSet encrypted_types(trans->GetEncryptedTypes());
           const sync_pb::EntitySpecifics& specifics =
               sync_node.GetEntry()->Get(syncer::syncable::SPECIFICS);
           CHECK(specifics.has_encrypted());
@@ -243,6 +243,32 @@ TEST_F(SyncGenericChangeProcessorTest, UpdatePasswords) {
   }
 }
 
+// Changes beyond the first chunk are written in later transactions, and
+// must all be applied.
+TEST_F(SyncGenericChangeProcessorTest, ProcessManyChanges) {
+  const int kNumChanges = 250;
+  sync_pb::EntitySpecifics specifics;
+  syncer::SyncChangeList change_list;
+  for (int i = 0; i < kNumChanges; ++i) {
+    specifics.mutable_preference()->set_name(base::StringPrintf("pref%i", i));
+    change_list.push_back(
+        syncer::SyncChange(FROM_HERE,
+                           syncer::SyncChange::ACTION_ADD,
+                           syncer::SyncData::CreateLocalData(
+                               base::StringPrintf("tag%i", i),
+                               base::StringPrintf("title%i", i),
+                               specifics)));
+  }
+
+  ASSERT_FALSE(
+      change_processor()->ProcessSyncChanges(FROM_HERE, change_list).IsSet());
+
+  syncer::SyncDataList sync_data;
+  ASSERT_FALSE(change_processor()->GetSyncDataForType(kType, &sync_data).
+                   IsSet());
+  EXPECT_EQ(static_cast<size_t>(kNumChanges), sync_data.size());
+}
+
 }  // namespace
 
 }  // namespace browser_sync
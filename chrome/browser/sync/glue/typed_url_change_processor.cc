@@ -5,6 +5,7 @@
 #include "chrome/browser/sync/glue/typed_url_change_processor.h"
 
 #include "base/location.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
@@ -181,8 +182,6 @@ bool TypedUrlChangeProcessor::CreateOrUpdateSyncNode(
 
 void TypedUrlChangeProcessor::HandleURLsDeleted(
     history::URLsDeletedDetails* details) {
-  syncer::WriteTransaction trans(FROM_HERE, share_handle());
-
   // Ignore archivals (we don't want to sync them as deletions, to avoid
   // extra traffic up to the server, and also to make sure that a client with
   // a bad clock setting won't go on an archival rampage and delete all
@@ -192,15 +191,28 @@ void TypedUrlChangeProcessor::HandleURLsDeleted(
     return;
 
   if (details->all_history) {
+    syncer::WriteTransaction trans(FROM_HERE, share_handle());
     if (!model_associator_->DeleteAllNodes(&trans)) {
       error_handler()->OnSingleDatatypeUnrecoverableError(FROM_HERE,
           std::string());
       return;
     }
   } else {
+    // Deleting a range of history can remove thousands of URLs, so tombstone
+    // them in chunks rather than holding the transaction for all of them.
+    scoped_ptr<syncer::WriteTransaction> trans;
+    int changes_in_transaction = 0;
     for (history::URLRows::const_iterator row = details->rows.begin();
          row != details->rows.end(); ++row) {
-      syncer::WriteNode sync_node(&trans);
+      if (changes_in_transaction == kMaxChangesPerTransaction)
+        trans.reset();
+      if (!trans) {
+        trans.reset(new syncer::WriteTransaction(FROM_HERE, share_handle()));
+        changes_in_transaction = 0;
+      }
+      ++changes_in_transaction;
+
+      syncer::WriteNode sync_node(trans.get());
       // The deleted URL could have been non-typed, so it might not be found
       // in the sync DB.
       if (sync_node.InitByClientTagLookup(syncer::TYPED_URLS,
@@ -155,6 +155,9 @@ class BookmarkButtonBase : public views::TextButton {
   BookmarkButtonBase(views::ButtonListener* listener,
                      const string16& title)
       : TextButton(listener, title) {
+    // The bar repaints whole rows of buttons as the pointer moves over them;
+    // only the buttons whose state changes need to paint again.
+    SetPaintCached(true);
     show_animation_.reset(new ui::SlideAnimation(this));
     if (!animations_enabled) {
       // For some reason during testing the events generated by animating
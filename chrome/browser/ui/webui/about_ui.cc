@@ -13,6 +13,7 @@
 #include "base/bind_helpers.h"
 #include "base/callback.h"
 #include "base/command_line.h"
+#include "base/debug/trace_event_memory.h"
 #include "base/file_util.h"
 #include "base/i18n/number_formatting.h"
 #include "base/json/json_writer.h"
@@ -1063,6 +1064,21 @@ void AboutMemoryHandler::OnDetailsAvailable() {
       AppendProcess(child_data, &process.processes[index]);
   }
 
+  // Heap memory of the browser process by subsystem, when heap memory
+  // profiling has taken a snapshot.
+  base::debug::SubsystemMemoryTotals subsystems;
+  if (base::debug::GetLastSubsystemMemoryTotals(&subsystems)) {
+    ListValue* subsystem_data = new ListValue();
+    root->Set("subsystem_data", subsystem_data);
+    for (base::debug::SubsystemMemoryTotals::const_iterator it =
+             subsystems.begin(); it != subsystems.end(); ++it) {
+      DictionaryValue* subsystem = new DictionaryValue();
+      subsystem_data->Append(subsystem);
+      subsystem->SetString("name", it->first);
+      subsystem->SetInteger("heap_kb", static_cast<int>(it->second / 1024));
+    }
+  }
+
   root->SetBoolean("show_other_browsers",
       browser_defaults::kShowOtherBrowsersInAboutMemory);
 
@@ -443,6 +443,7 @@ void PrintPreviewUI::OnInitiatorClosed() {
 
 void PrintPreviewUI::OnPrintPreviewRequest(int request_id) {
   g_print_preview_request_id_map.Get().Set(id_, request_id);
+  preview_request_start_time_ = base::TimeTicks::Now();
 }
 
 void PrintPreviewUI::OnShowSystemDialog() {
@@ -492,6 +493,7 @@ void PrintPreviewUI::OnDidGetDefaultPageLayout(
 void PrintPreviewUI::OnDidPreviewPage(int page_number,
                                       int preview_request_id) {
   DCHECK_GE(page_number, 0);
+  RecordFirstPageTime(preview_request_id);
   base::FundamentalValue number(page_number);
   base::FundamentalValue ui_identifier(id_);
   base::FundamentalValue request_id(preview_request_id);
@@ -518,12 +520,29 @@ void PrintPreviewUI::OnPreviewDataIsAvailable(int expected_pages_count,
                          expected_pages_count);
     initial_preview_start_time_ = base::TimeTicks();
   }
+  // Documents that are not modifiable have no draft pages, so the first page
+  // shows up with the whole document.
+  RecordFirstPageTime(preview_request_id);
   base::FundamentalValue ui_identifier(id_);
   base::FundamentalValue ui_preview_request_id(preview_request_id);
   web_ui()->CallJavascriptFunction("updatePrintPreview", ui_identifier,
                                    ui_preview_request_id);
 }
 
+void PrintPreviewUI::RecordFirstPageTime(int preview_request_id) {
+  if (preview_request_start_time_.is_null())
+    return;
+  // Pages from a request that has since been superseded don't count.
+  int current_id = -1;
+  if (!g_print_preview_request_id_map.Get().Get(id_, &current_id) ||
+      current_id != preview_request_id) {
+    return;
+  }
+  UMA_HISTOGRAM_TIMES("PrintPreview.RequestToFirstPageTime",
+                      base::TimeTicks::Now() - preview_request_start_time_);
+  preview_request_start_time_ = base::TimeTicks();
+}
+
 void PrintPreviewUI::OnPrintPreviewDialogDestroyed() {
   handler_->OnPrintPreviewDialogDestroyed();
 }
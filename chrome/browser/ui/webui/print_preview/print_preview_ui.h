@@ -163,8 +163,16 @@ class PrintPreviewUI : public ConstrainedWebDialogUI {
   // Returns the Singleton instance of the PrintPreviewDataService.
   PrintPreviewDataService* print_preview_data_service();
 
+  // Records how long the first page of |preview_request_id| took to become
+  // available, if it is the current request and hasn't been recorded yet.
+  void RecordFirstPageTime(int preview_request_id);
+
   base::TimeTicks initial_preview_start_time_;
 
+  // When the current preview request was made. Reset once its first page is
+  // available.
+  base::TimeTicks preview_request_start_time_;
+
   // The unique ID for this class instance. Stored here to avoid calling
   // GetIDForPrintPreviewUI() everywhere.
   const int32 id_;
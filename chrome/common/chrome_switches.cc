@@ -1138,6 +1138,11 @@ const char kProfilingFile[]                 = "profiling-file";
 // and viewed in about:profiler.
 const char kProfilingOutputFile[]           = "profiling-output-file";
 
+// Times only one in this many task runs for task-level profiling, on each
+// thread of each process, and only counts the others.  This makes it cheap
+// enough to leave on.  The default of 1 times every run.
+const char kProfilingSamplingInterval[]     = "profiling-sampling-interval";
+
 // Controls whether profile data is periodically flushed to a file. Normally
 // the data gets written on exit but cases exist where chrome doesn't exit
 // cleanly (especially when using single-process). A time in seconds can be
@@ -309,6 +309,7 @@ extern const char kProfilingAtStart[];
 extern const char kProfilingFile[];
 extern const char kProfilingFlush[];
 extern const char kProfilingOutputFile[];
+extern const char kProfilingSamplingInterval[];
 extern const char kPromoServerURL[];
 extern const char kPromptForExternalExtensions[];
 extern const char kProxyAutoDetect[];
@@ -302,6 +302,15 @@ IPC_MESSAGE_ROUTED5(ExtensionMsg_MessageInvoke,
                     base::ListValue /* args */,
                     bool /* delivered as part of a user gesture */)
 
+// Dispatches several events at once to every registered context in the target
+// process. Each entry of |events| is the argument list that
+// ExtensionMsg_MessageInvoke would pass to event_bindings.dispatchEvent, for
+// the extension at the same index of |extension_ids|. None of the events are
+// delivered as part of a user gesture.
+IPC_MESSAGE_CONTROL2(ExtensionMsg_DispatchEvents,
+                     std::vector<std::string> /* extension_ids */,
+                     base::ListValue /* events */)
+
 // Tell the renderer process all known extension function names.
 IPC_MESSAGE_CONTROL1(ExtensionMsg_SetFunctionNames,
                      std::vector<std::string>)
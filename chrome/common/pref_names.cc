@@ -496,6 +496,10 @@ const char kDnsHostReferralList[] = "HostReferralList";
 const char kDnsPrefetchingHostReferralList[] =
     "dns_prefetching.host_referral_list";
 
+// The contents of the host cache at shutdown, which are restored at startup
+// so that the first page loads don't wait for DNS.
+const char kDnsPrefetchingHostCache[] = "dns_prefetching.host_cache";
+
 // Disables the SPDY protocol.
 const char kDisableSpdy[] = "spdy.disabled";
 
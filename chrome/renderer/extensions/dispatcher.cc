@@ -428,6 +428,7 @@ bool Dispatcher::OnControlMessageReceived(const IPC::Message& message) {
   IPC_BEGIN_MESSAGE_MAP(Dispatcher, message)
     IPC_MESSAGE_HANDLER(ExtensionMsg_SetChannel, OnSetChannel)
     IPC_MESSAGE_HANDLER(ExtensionMsg_MessageInvoke, OnMessageInvoke)
+    IPC_MESSAGE_HANDLER(ExtensionMsg_DispatchEvents, OnDispatchEvents)
     IPC_MESSAGE_HANDLER(ExtensionMsg_DispatchOnConnect, OnDispatchOnConnect)
     IPC_MESSAGE_HANDLER(ExtensionMsg_DeliverMessage, OnDeliverMessage)
     IPC_MESSAGE_HANDLER(ExtensionMsg_DispatchOnDisconnect,
@@ -526,6 +527,21 @@ void Dispatcher::OnMessageInvoke(const std::string& extension_id,
       NULL, extension_id, module_name, function_name, args, user_gesture);
 }
 
+void Dispatcher::OnDispatchEvents(
+    const std::vector<std::string>& extension_ids,
+    const base::ListValue& events) {
+  DCHECK_EQ(extension_ids.size(), events.GetSize());
+  for (size_t i = 0; i < extension_ids.size(); ++i) {
+    const base::ListValue* args = NULL;
+    if (!events.GetList(i, &args)) {
+      NOTREACHED();
+      continue;
+    }
+    InvokeModuleSystemMethod(NULL, extension_ids[i], kEventModule,
+                             kEventDispatchFunction, *args, false);
+  }
+}
+
 void Dispatcher::OnDispatchOnConnect(
     int target_port_id,
     const std::string& channel_name,
@@ -151,6 +151,8 @@ class Dispatcher : public content::RenderProcessObserver {
                        const std::string& function_name,
                        const base::ListValue& args,
                        bool user_gesture);
+  void OnDispatchEvents(const std::vector<std::string>& extension_ids,
+                        const base::ListValue& events);
   void OnDispatchOnConnect(int target_port_id,
                            const std::string& channel_name,
                            const base::DictionaryValue& source_tab,
@@ -11,6 +11,7 @@
 #include "base/memory/shared_memory.h"
 #include "base/metrics/histogram.h"
 #include "base/perftimer.h"
+#include "base/time/time.h"
 #include "base/pickle.h"
 #include "base/strings/stringprintf.h"
 #include "chrome/common/extensions/csp_handler.h"
@@ -52,6 +53,24 @@ namespace extensions {
 static const char kUserScriptHead[] = "(function (unsafeWindow) {\n";
 static const char kUserScriptTail[] = "\n})(window);";
 
+namespace {
+
+// Sets |condition| to a condition on the host of the URLs |pattern| matches.
+// Returns false if the pattern can match any host, so that the URL matcher
+// can't narrow it down.
+bool CreateHostCondition(const URLPattern& pattern,
+                         URLMatcherConditionFactory* factory,
+                         URLMatcherCondition* condition) {
+  if (pattern.match_all_urls() || pattern.host().empty())
+    return false;
+  *condition = pattern.match_subdomains() ?
+      factory->CreateHostSuffixCondition(pattern.host()) :
+      factory->CreateHostEqualsCondition(pattern.host());
+  return true;
+}
+
+}  // namespace
+
 int UserScriptSlave::GetIsolatedWorldIdForExtension(const Extension* extension,
                                                     WebFrame* frame) {
   static int g_next_isolated_world_id = chrome::ISOLATED_WORLD_ID_EXTENSIONS;
@@ -143,6 +162,7 @@ void UserScriptSlave::GetActiveExtensions(
 
 bool UserScriptSlave::UpdateScripts(base::SharedMemoryHandle shared_memory) {
   scripts_.clear();
+  script_sources_.clear();
 
   bool only_inject_incognito =
       ChromeRenderProcessObserver::is_incognito_process();
@@ -202,6 +222,9 @@ bool UserScriptSlave::UpdateScripts(base::SharedMemoryHandle shared_memory) {
     }
   }
 
+  script_sources_.resize(scripts_.size());
+  BuildURLMatcher();
+
   // Push user styles down into WebCore
   RenderThread::Get()->EnsureWebKitInitialized();
   WebView::removeAllUserContent();
@@ -240,6 +263,98 @@ bool UserScriptSlave::UpdateScripts(base::SharedMemoryHandle shared_memory) {
   return true;
 }
 
+void UserScriptSlave::BuildURLMatcher() {
+  url_matcher_.reset(new URLMatcher());
+  condition_set_scripts_.clear();
+  unfiltered_scripts_.clear();
+
+  URLMatcherConditionFactory* factory = url_matcher_->condition_factory();
+  URLMatcherConditionSet::Vector condition_sets;
+  for (size_t i = 0; i < scripts_.size(); ++i) {
+    // A script without URL patterns is matched by its globs alone.
+    const URLPatternSet& url_patterns = scripts_[i]->url_patterns();
+    bool filtered = !url_patterns.is_empty();
+    URLMatcherConditionSet::Vector script_condition_sets;
+    for (URLPatternSet::const_iterator it = url_patterns.begin();
+         filtered && it != url_patterns.end(); ++it) {
+      URLMatcherCondition condition;
+      if (!CreateHostCondition(*it, factory, &condition)) {
+        filtered = false;
+        break;
+      }
+      URLMatcherConditionSet::Conditions conditions;
+      conditions.insert(condition);
+      URLMatcherConditionSet::ID id = static_cast<URLMatcherConditionSet::ID>(
+          condition_set_scripts_.size() + script_condition_sets.size());
+      script_condition_sets.push_back(
+          new URLMatcherConditionSet(id, conditions));
+    }
+
+    if (!filtered) {
+      unfiltered_scripts_.push_back(i);
+      continue;
+    }
+    condition_sets.insert(condition_sets.end(), script_condition_sets.begin(),
+                          script_condition_sets.end());
+    condition_set_scripts_.insert(condition_set_scripts_.end(),
+                                  script_condition_sets.size(), i);
+  }
+  url_matcher_->AddConditionSets(condition_sets);
+}
+
+void UserScriptSlave::GetCandidateScripts(const GURL& url,
+                                          std::vector<bool>* candidates) {
+  // The matcher only knows about hosts, so URLs without one, such as
+  // view-source: and file: URLs, are tested against every script.
+  if (!url_matcher_.get() || !url.has_host()) {
+    candidates->assign(scripts_.size(), true);
+    return;
+  }
+
+  candidates->assign(scripts_.size(), false);
+  for (size_t i = 0; i < unfiltered_scripts_.size(); ++i)
+    (*candidates)[unfiltered_scripts_[i]] = true;
+  std::set<URLMatcherConditionSet::ID> matches = url_matcher_->MatchURL(url);
+  for (std::set<URLMatcherConditionSet::ID>::const_iterator it =
+           matches.begin(); it != matches.end(); ++it) {
+    (*candidates)[condition_set_scripts_[*it]] = true;
+  }
+}
+
+const std::vector<WebScriptSource>& UserScriptSlave::GetScriptSources(
+    size_t script_index) {
+  std::vector<WebScriptSource>& sources = script_sources_[script_index];
+  if (!sources.empty())
+    return sources;
+
+  UserScript* script = scripts_[script_index];
+  bool emulate_greasemonkey =
+      script->is_standalone() || script->emulate_greasemonkey();
+
+  // Emulate Greasemonkey API for scripts that were converted to extensions
+  // and "standalone" user scripts.
+  if (emulate_greasemonkey)
+    sources.push_back(
+        WebScriptSource(WebString::fromUTF8(api_js_.as_string())));
+
+  for (size_t j = 0; j < script->js_scripts().size(); ++j) {
+    UserScript::File& file = script->js_scripts()[j];
+    std::string content = file.GetContent().as_string();
+
+    // We add this dumb function wrapper for standalone user script to
+    // emulate what Greasemonkey does.
+    // TODO(aa): I think that maybe "is_standalone" scripts don't exist
+    // anymore. Investigate.
+    if (emulate_greasemonkey) {
+      content.insert(0, kUserScriptHead);
+      content += kUserScriptTail;
+    }
+    sources.push_back(
+        WebScriptSource(WebString::fromUTF8(content), file.url()));
+  }
+  return sources;
+}
+
 GURL UserScriptSlave::GetDataSourceURLForFrame(const WebFrame* frame) {
   // Normally we would use frame->document().url() to determine the document's
   // URL, but to decide whether to inject a content script, we use the URL from
@@ -269,12 +384,20 @@ void UserScriptSlave::InjectScripts(WebFrame* frame,
   int num_css = 0;
   int num_scripts = 0;
 
+  // Time spent deciding which scripts match the frame.
+  base::TimeTicks match_start_time = base::TimeTicks::Now();
+  std::vector<bool> candidates;
+  GetCandidateScripts(data_source_url, &candidates);
+  base::TimeDelta match_time = base::TimeTicks::Now() - match_start_time;
+
   ExecutingScriptsMap extensions_executing_scripts;
 
   for (size_t i = 0; i < scripts_.size(); ++i) {
-    std::vector<WebScriptSource> sources;
     UserScript* script = scripts_[i];
 
+    if (!candidates[i])
+      continue;  // The script's URL patterns can't match the frame's host.
+
     if (frame->parent() && !script->match_all_frames())
       continue;  // Only match subframes if the script declared it wanted to.
 
@@ -289,66 +412,41 @@ void UserScriptSlave::InjectScripts(WebFrame* frame,
     const int kNoTabId = -1;
     // We don't have a process id in this context.
     const int kNoProcessId = -1;
-    if (!PermissionsData::CanExecuteScriptOnPage(extension,
-                                                 data_source_url,
-                                                 frame->top()->document().url(),
-                                                 kNoTabId,
-                                                 script,
-                                                 kNoProcessId,
-                                                 NULL)) {
+    match_start_time = base::TimeTicks::Now();
+    bool can_execute_script = PermissionsData::CanExecuteScriptOnPage(
+        extension, data_source_url, frame->top()->document().url(), kNoTabId,
+        script, kNoProcessId, NULL);
+    match_time += base::TimeTicks::Now() - match_start_time;
+    if (!can_execute_script)
       continue;
-    }
 
     // We rely on WebCore for CSS injection, but it's still useful to know how
     // many css files there are.
     if (location == UserScript::DOCUMENT_START)
       num_css += script->css_scripts().size();
 
-    if (script->run_location() == location) {
-      num_scripts += script->js_scripts().size();
-      for (size_t j = 0; j < script->js_scripts().size(); ++j) {
-        UserScript::File &file = script->js_scripts()[j];
-        std::string content = file.GetContent().as_string();
-
-        // We add this dumb function wrapper for standalone user script to
-        // emulate what Greasemonkey does.
-        // TODO(aa): I think that maybe "is_standalone" scripts don't exist
-        // anymore. Investigate.
-        if (script->is_standalone() || script->emulate_greasemonkey()) {
-          content.insert(0, kUserScriptHead);
-          content += kUserScriptTail;
-        }
-        sources.push_back(
-            WebScriptSource(WebString::fromUTF8(content), file.url()));
-      }
-    }
-
-    if (!sources.empty()) {
-      // Emulate Greasemonkey API for scripts that were converted to extensions
-      // and "standalone" user scripts.
-      if (script->is_standalone() || script->emulate_greasemonkey()) {
-        sources.insert(sources.begin(),
-            WebScriptSource(WebString::fromUTF8(api_js_.as_string())));
-      }
+    if (script->run_location() != location || script->js_scripts().empty())
+      continue;
 
-      int isolated_world_id = GetIsolatedWorldIdForExtension(extension, frame);
-
-      PerfTimer exec_timer;
-      DOMActivityLogger::AttachToWorld(
-          isolated_world_id,
-          extension->id(),
-          UserScriptSlave::GetDataSourceURLForFrame(frame),
-          frame->document().title());
-      frame->executeScriptInIsolatedWorld(
-          isolated_world_id, &sources.front(), sources.size(),
-          EXTENSION_GROUP_CONTENT_SCRIPTS);
-      UMA_HISTOGRAM_TIMES("Extensions.InjectScriptTime", exec_timer.Elapsed());
-
-      for (std::vector<WebScriptSource>::const_iterator iter = sources.begin();
-           iter != sources.end(); ++iter) {
-        extensions_executing_scripts[extension->id()].insert(
-            GURL(iter->url).path());
-      }
+    num_scripts += script->js_scripts().size();
+    const std::vector<WebScriptSource>& sources = GetScriptSources(i);
+    int isolated_world_id = GetIsolatedWorldIdForExtension(extension, frame);
+
+    PerfTimer exec_timer;
+    DOMActivityLogger::AttachToWorld(
+        isolated_world_id,
+        extension->id(),
+        UserScriptSlave::GetDataSourceURLForFrame(frame),
+        frame->document().title());
+    frame->executeScriptInIsolatedWorld(
+        isolated_world_id, &sources.front(), sources.size(),
+        EXTENSION_GROUP_CONTENT_SCRIPTS);
+    UMA_HISTOGRAM_TIMES("Extensions.InjectScriptTime", exec_timer.Elapsed());
+
+    for (std::vector<WebScriptSource>::const_iterator iter = sources.begin();
+         iter != sources.end(); ++iter) {
+      extensions_executing_scripts[extension->id()].insert(
+          GURL(iter->url).path());
     }
   }
 
@@ -366,6 +464,8 @@ void UserScriptSlave::InjectScripts(WebFrame* frame,
 
   // Log debug info.
   if (location == UserScript::DOCUMENT_START) {
+    UMA_HISTOGRAM_CUSTOM_COUNTS("Extensions.InjectStart_MatchTimeUs",
+                                match_time.InMicroseconds(), 1, 1000000, 50);
     UMA_HISTOGRAM_COUNTS_100("Extensions.InjectStart_CssCount", num_css);
     UMA_HISTOGRAM_COUNTS_100("Extensions.InjectStart_ScriptCount", num_scripts);
     if (num_css || num_scripts)
@@ -14,6 +14,7 @@
 #include "base/memory/shared_memory.h"
 #include "base/stl_util.h"
 #include "base/strings/string_piece.h"
+#include "extensions/common/matcher/url_matcher.h"
 #include "extensions/common/user_script.h"
 #include "third_party/WebKit/public/web/WebScriptSource.h"
 
@@ -67,6 +68,17 @@ class UserScriptSlave {
   static void InitializeIsolatedWorld(int isolated_world_id,
                                       const Extension* extension);
 
+  // Returns the sources to execute for the JavaScript files of the script at
+  // |script_index|, converting them the first time they are needed.
+  const std::vector<WebScriptSource>& GetScriptSources(size_t script_index);
+
+  // Compiles the URL patterns of |scripts_| into |url_matcher_|.
+  void BuildURLMatcher();
+
+  // Sets |candidates| to one flag per script, true for the scripts that may
+  // match |url|. Scripts that aren't candidates certainly don't match.
+  void GetCandidateScripts(const GURL& url, std::vector<bool>* candidates);
+
   // Shared memory containing raw script data.
   scoped_ptr<base::SharedMemory> shared_memory_;
 
@@ -74,6 +86,21 @@ class UserScriptSlave {
   std::vector<UserScript*> scripts_;
   STLElementDeleter<std::vector<UserScript*> > script_deleter_;
 
+  // The sources of each script's JavaScript files, indexed like |scripts_|.
+  // WebStrings share their buffer when copied, so after the first injection
+  // a script's sources are neither copied out of shared memory nor decoded
+  // from UTF-8 again.
+  std::vector<std::vector<WebScriptSource> > script_sources_;
+
+  // Matches the hosts of all the scripts' URL patterns at once, so that only
+  // the scripts that may match a frame are tested one by one. The condition
+  // set IDs index |condition_set_scripts_|, which holds the index of the
+  // script each set came from. Scripts with a pattern the matcher can't
+  // narrow down, such as <all_urls>, are listed in |unfiltered_scripts_|.
+  scoped_ptr<URLMatcher> url_matcher_;
+  std::vector<size_t> condition_set_scripts_;
+  std::vector<size_t> unfiltered_scripts_;
+
   // Greasemonkey API source that is injected with the scripts.
   base::StringPiece api_js_;
 
@@ -1798,6 +1798,7 @@ PrintWebViewHelper::PrintPreviewContext::PrintPreviewContext()
       current_page_index_(0),
       generate_draft_pages_(true),
       print_ready_metafile_page_count_(0),
+      first_page_rendered_(false),
       error_(PREVIEW_ERROR_NONE),
       state_(UNINITIALIZED) {
 }
@@ -1885,6 +1886,7 @@ bool PrintWebViewHelper::PrintPreviewContext::CreatePreviewDocument(
 
   document_render_time_ = base::TimeDelta();
   begin_time_ = base::TimeTicks::Now();
+  first_page_rendered_ = false;
 
   return true;
 }
@@ -1894,6 +1896,13 @@ void PrintWebViewHelper::PrintPreviewContext::RenderedPreviewPage(
   DCHECK_EQ(RENDERING, state_);
   document_render_time_ += page_time;
   UMA_HISTOGRAM_TIMES("PrintPreview.RenderPDFPageTime", page_time);
+  if (!first_page_rendered_) {
+    // Includes the layout done before the first page, which is what delays
+    // the first thing the user sees.
+    UMA_HISTOGRAM_TIMES("PrintPreview.RenderToFirstPageTime",
+                        base::TimeTicks::Now() - begin_time_);
+    first_page_rendered_ = true;
+  }
 }
 
 void PrintWebViewHelper::PrintPreviewContext::AllPagesRendered() {
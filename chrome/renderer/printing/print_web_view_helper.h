@@ -476,6 +476,8 @@ class PrintWebViewHelper
 
     base::TimeDelta document_render_time_;
     base::TimeTicks begin_time_;
+    // Whether a page of the current document has been rendered yet.
+    bool first_page_rendered_;
 
     enum PrintPreviewErrorBuckets error_;
 
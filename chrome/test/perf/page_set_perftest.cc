@@ -0,0 +1,278 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Loads each page of a page set a number of times and reports metrics taken
+// from a trace of each load, so that runs on different builds can be
+// compared page by page.
+//
+// The page set is a text file with one URL per line, passed with
+// --page-set=<file>. Lines that are empty or start with '#' are skipped. For
+// repeatable numbers, record the pages once and serve them from a replay
+// server, pointing the browser at it with e.g.
+//   --host-resolver-rules="MAP * 127.0.0.1:8080"
+// Each page is loaded --page-set-iterations times (5 by default), and every
+// iteration is reported, rather than just the mean, so that the spread of the
+// results is visible.
+//
+// The metrics for each page are:
+//   first_paint  Time from the start of the main frame load to the first
+//                visually non-empty paint in the renderer.
+//   frame_time   Mean time between frames drawn by the compositor, when the
+//                page drew at least kMinFramesForFrameTime frames.
+//   busy_io      Time the browser IO thread spent running tasks.
+//   busy_render  Time renderer main threads spent running tasks.
+//   memory       The highest private working set of all Chrome processes
+//                seen after any of the loads.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/command_line.h"
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/trace_event_analyzer.h"
+#include "chrome/browser/memory_details.h"
+#include "chrome/browser/ui/browser.h"
+#include "chrome/test/base/tracing.h"
+#include "chrome/test/base/ui_test_utils.h"
+#include "chrome/test/perf/browser_perf_test.h"
+#include "chrome/test/perf/perf_test.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace {
+
+using trace_analyzer::Query;
+using trace_analyzer::TraceAnalyzer;
+using trace_analyzer::TraceEvent;
+using trace_analyzer::TraceEventVector;
+
+const char kPageSetSwitch[] = "page-set";
+const char kIterationsSwitch[] = "page-set-iterations";
+
+const int kDefaultIterations = 5;
+
+// Fewer frames than this don't say anything useful about the frame rate.
+const size_t kMinFramesForFrameTime = 3;
+
+const char kTraceCategories[] = "renderer,cc,task";
+
+// MemorySampler fetches the memory details of all Chrome processes, and
+// blocks until they are available. The details are added to on each fetch,
+// so a MemorySampler is good for one sample.
+class MemorySampler : public MemoryDetails {
+ public:
+  MemorySampler() : private_kb_(0) {}
+
+  // Returns the private working set of all Chrome processes, in KB.
+  static size_t Sample() {
+    scoped_refptr<MemorySampler> sampler(new MemorySampler);
+    return sampler->Fetch();
+  }
+
+  // MemoryDetails implementation:
+  virtual void OnDetailsAvailable() OVERRIDE {
+    // The first browser is always Chrome.
+    const ProcessMemoryInformationList& chrome = processes()[0].processes;
+    for (size_t i = 0; i < chrome.size(); ++i)
+      private_kb_ += chrome[i].working_set.priv;
+    quit_closure_.Run();
+  }
+
+ private:
+  virtual ~MemorySampler() {}
+
+  size_t Fetch() {
+    base::RunLoop run_loop;
+    quit_closure_ = run_loop.QuitClosure();
+    StartFetch(MemoryDetails::SKIP_USER_METRICS);
+    run_loop.Run();
+    return private_kb_;
+  }
+
+  size_t private_kb_;
+  base::Closure quit_closure_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemorySampler);
+};
+
+// The metrics of one page, with one entry per iteration.
+struct PageResults {
+  PageResults() : memory_kb(0) {}
+
+  std::vector<double> first_paint_ms;
+  std::vector<double> frame_time_ms;
+  std::vector<double> busy_io_ms;
+  std::vector<double> busy_render_ms;
+  size_t memory_kb;
+};
+
+class PageSetTest : public BrowserPerfTest {
+ public:
+  PageSetTest() : iterations_(kDefaultIterations) {}
+
+  virtual void SetUpCommandLine(CommandLine* command_line) OVERRIDE {
+    BrowserPerfTest::SetUpCommandLine(command_line);
+    if (command_line->HasSwitch(kIterationsSwitch)) {
+      ASSERT_TRUE(base::StringToInt(
+          command_line->GetSwitchValueASCII(kIterationsSwitch), &iterations_));
+      ASSERT_GT(iterations_, 0);
+    }
+  }
+
+ protected:
+  // Reads the URLs of the page set into |urls|. Returns false if no page set
+  // was given.
+  bool ReadPageSet(std::vector<GURL>* urls) {
+    const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+    if (!command_line.HasSwitch(kPageSetSwitch))
+      return false;
+
+    base::FilePath path = command_line.GetSwitchValuePath(kPageSetSwitch);
+    std::string contents;
+    EXPECT_TRUE(file_util::ReadFileToString(path, &contents))
+        << "Failed to read " << path.value();
+
+    std::vector<std::string> lines;
+    base::SplitString(contents, '\n', &lines);
+    for (size_t i = 0; i < lines.size(); ++i) {
+      std::string line;
+      TrimWhitespaceASCII(lines[i], TRIM_ALL, &line);
+      if (line.empty() || line[0] == '#')
+        continue;
+      GURL url(line);
+      EXPECT_TRUE(url.is_valid()) << "Bad URL in page set: " << line;
+      if (url.is_valid())
+        urls->push_back(url);
+    }
+    return true;
+  }
+
+  // Loads |url| once under tracing and adds the metrics of the load to
+  // |results|.
+  void RunPage(const GURL& url, PageResults* results) {
+    ASSERT_TRUE(tracing::BeginTracing(kTraceCategories));
+    ui_test_utils::NavigateToURL(browser(), url);
+    std::string json_events;
+    ASSERT_TRUE(tracing::EndTracing(&json_events));
+
+    results->memory_kb = std::max(results->memory_kb, MemorySampler::Sample());
+
+    scoped_ptr<TraceAnalyzer> analyzer(TraceAnalyzer::Create(json_events));
+    ASSERT_TRUE(analyzer.get());
+    analyzer->AssociateBeginEndEvents();
+
+    // Use the last load start before the first paint, since redirects start
+    // the load again.
+    const TraceEvent* paint = analyzer->FindFirstOf(
+        Query::EventNameIs("RenderViewImpl::DidFirstVisuallyNonEmptyPaint"));
+    TraceEventVector starts;
+    analyzer->FindEvents(
+        Query::EventNameIs("RenderViewImpl::DidStartProvisionalLoad"),
+        &starts);
+    const TraceEvent* start = NULL;
+    for (size_t i = 0; paint && i < starts.size(); ++i) {
+      if (starts[i]->timestamp <= paint->timestamp)
+        start = starts[i];
+    }
+    if (start) {
+      results->first_paint_ms.push_back(
+          (paint->timestamp - start->timestamp) / 1000.0);
+    }
+
+    TraceEventVector frames;
+    analyzer->FindEvents(Query::EventNameIs("LayerTreeHostImpl::DrawLayers") &&
+                         Query::EventPhaseIs(TRACE_EVENT_PHASE_BEGIN),
+                         &frames);
+    trace_analyzer::RateStats frame_stats;
+    if (frames.size() >= kMinFramesForFrameTime &&
+        trace_analyzer::GetRateStats(frames, &frame_stats, NULL)) {
+      results->frame_time_ms.push_back(frame_stats.mean_us / 1000.0);
+    }
+
+    results->busy_io_ms.push_back(
+        GetThreadBusyTime(analyzer.get(), "Chrome_IOThread") / 1000.0);
+    results->busy_render_ms.push_back(
+        GetThreadBusyTime(analyzer.get(), "CrRendererMain") / 1000.0);
+  }
+
+  void PrintResults(const std::string& trace, const PageResults& results) {
+    PrintList("first_paint", trace, results.first_paint_ms, "ms");
+    PrintList("frame_time", trace, results.frame_time_ms, "ms");
+    PrintList("busy_io", trace, results.busy_io_ms, "ms");
+    PrintList("busy_render", trace, results.busy_render_ms, "ms");
+    perf_test::PrintResult("memory", std::string(), trace, results.memory_kb,
+                           "kb", false);
+  }
+
+  int iterations_;
+
+ private:
+  // Returns the time, in microseconds, that all threads named |name| spent
+  // in the events of the trace, summed over the threads.
+  double GetThreadBusyTime(TraceAnalyzer* analyzer, const std::string& name) {
+    std::vector<TraceEvent::ProcessThreadID> threads;
+    analyzer->FindThreads(name, &threads);
+    double busy_us = 0;
+    for (size_t i = 0; i < threads.size(); ++i) {
+      TraceEventVector events;
+      analyzer->FindEvents(Query::EventThreadIs(threads[i]) &&
+                           Query::EventPhaseIs(TRACE_EVENT_PHASE_BEGIN) &&
+                           Query::EventHasOther(),
+                           &events);
+      busy_us += trace_analyzer::GetBusyTime(events);
+    }
+    return busy_us;
+  }
+
+  void PrintList(const std::string& measurement,
+                 const std::string& trace,
+                 const std::vector<double>& values,
+                 const std::string& units) {
+    // Nothing is printed when a metric could not be taken, so that a missing
+    // metric isn't mistaken for a zero.
+    if (values.empty())
+      return;
+    std::string list;
+    for (size_t i = 0; i < values.size(); ++i)
+      base::StringAppendF(&list, "%.2f,", values[i]);
+    perf_test::PrintResultList(measurement, std::string(), trace, list, units,
+                               false);
+  }
+};
+
+IN_PROC_BROWSER_TEST_F(PageSetTest, PageSet) {
+  std::vector<GURL> urls;
+  if (!ReadPageSet(&urls)) {
+    LOG(WARNING) << "Test skipped: pass --" << kPageSetSwitch
+                 << "=<file> with one URL per line.";
+    return;
+  }
+
+  for (size_t i = 0; i < urls.size(); ++i) {
+    PageResults results;
+    for (int iteration = 0; iteration < iterations_; ++iteration) {
+      // Start each load from a blank page, so that the previous page isn't
+      // counted against this one.
+      ui_test_utils::NavigateToURL(browser(), GURL("about:blank"));
+      RunPage(urls[i], &results);
+      if (HasFatalFailure())
+        return;
+    }
+    std::string trace = "page" + base::Uint64ToString(i);
+    PrintResults(trace, results);
+    LOG(INFO) << trace << ": " << urls[i].spec();
+  }
+}
+
+}  // namespace
@@ -153,6 +153,13 @@ void VisitedLinkEventListener::Add(VisitedLinkMaster::Fingerprint fingerprint) {
   }
 }
 
+void VisitedLinkEventListener::Delete(
+    VisitedLinkMaster::Fingerprint fingerprint) {
+  // Renderers recheck the visited state of the links they are sent, so a
+  // deleted link is sent the same way as an added one.
+  Add(fingerprint);
+}
+
 void VisitedLinkEventListener::Reset() {
   pending_visited_links_.clear();
   coalesce_timer_.Stop();
@@ -37,6 +37,7 @@ class VisitedLinkEventListener : public VisitedLinkMaster::Listener,
 
   virtual void NewTable(base::SharedMemory* table_memory) OVERRIDE;
   virtual void Add(VisitedLinkMaster::Fingerprint fingerprint) OVERRIDE;
+  virtual void Delete(VisitedLinkMaster::Fingerprint fingerprint) OVERRIDE;
   virtual void Reset() OVERRIDE;
 
  private:
@@ -340,9 +340,10 @@ void VisitedLinkMaster::DeleteURLs(URLIterator* urls) {
   if (!urls->HasNextURL())
     return;
 
-  listener_->Reset();
-
   if (table_builder_.get()) {
+    listener_->Reset();
+
+
     // A rebuild is in progress, save this deletion in the temporary list so
     // it can be added once rebuild is complete.
     while (urls->HasNextURL()) {
@@ -377,7 +378,24 @@ void VisitedLinkMaster::DeleteURLs(URLIterator* urls) {
     deleted_fingerprints.insert(
         ComputeURLFingerprint(url.spec().data(), url.spec().size(), salt_));
   }
+
+  // Renderers only need to recheck the links that were deleted, unless so
+  // many were that resetting the state of all links is cheaper.
+  if (deleted_fingerprints.size() > kBigDeleteThreshold) {
+    DeleteFingerprintsFromCurrentTable(deleted_fingerprints);
+    listener_->Reset();
+    return;
+  }
+
+  Fingerprints visited_fingerprints;
+  for (std::set<Fingerprint>::const_iterator i = deleted_fingerprints.begin();
+       i != deleted_fingerprints.end(); ++i) {
+    if (IsVisited(*i))
+      visited_fingerprints.push_back(*i);
+  }
   DeleteFingerprintsFromCurrentTable(deleted_fingerprints);
+  for (size_t i = 0; i < visited_fingerprints.size(); ++i)
+    listener_->Delete(visited_fingerprints[i]);
 }
 
 // See VisitedLinkCommon::IsVisited which should be in sync with this algorithm
@@ -55,8 +55,12 @@ class VisitedLinkMaster : public VisitedLinkCommon {
     // (hash) of the link.
     virtual void Add(Fingerprint fingerprint) = 0;
 
+    // Called when a link has been deleted. The argument is the fingerprint
+    // (hash) of the link.
+    virtual void Delete(Fingerprint fingerprint) = 0;
+
     // Called when link coloring state has been reset. This may occur when
-    // entire or parts of history were deleted.
+    // entire or large parts of history were deleted.
     virtual void Reset() = 0;
   };
 
@@ -39,6 +39,7 @@ class DummyVisitedLinkEventListener : public VisitedLinkMaster::Listener {
   DummyVisitedLinkEventListener() {}
   virtual void NewTable(base::SharedMemory* table) OVERRIDE {}
   virtual void Add(VisitedLinkCommon::Fingerprint) OVERRIDE {}
+  virtual void Delete(VisitedLinkCommon::Fingerprint) OVERRIDE {}
   virtual void Reset() OVERRIDE {}
 };
 
@@ -107,7 +107,8 @@ class TrackingVisitedLinkEventListener : public VisitedLinkMaster::Listener {
  public:
   TrackingVisitedLinkEventListener()
       : reset_count_(0),
-        add_count_(0) {}
+        add_count_(0),
+        delete_count_(0) {}
 
   virtual void NewTable(base::SharedMemory* table) OVERRIDE {
     if (table) {
@@ -120,19 +121,25 @@ class TrackingVisitedLinkEventListener : public VisitedLinkMaster::Listener {
     }
   }
   virtual void Add(VisitedLinkCommon::Fingerprint) OVERRIDE { add_count_++; }
+  virtual void Delete(VisitedLinkCommon::Fingerprint) OVERRIDE {
+    delete_count_++;
+  }
   virtual void Reset() OVERRIDE { reset_count_++; }
 
   void SetUp() {
     reset_count_ = 0;
     add_count_ = 0;
+    delete_count_ = 0;
   }
 
   int reset_count() const { return reset_count_; }
   int add_count() const { return add_count_; }
+  int delete_count() const { return delete_count_; }
 
  private:
   int reset_count_;
   int add_count_;
+  int delete_count_;
 };
 
 class VisitedLinkTest : public testing::Test {
@@ -473,9 +480,10 @@ TEST_F(VisitedLinkTest, Listener) {
     ASSERT_EQ(i + 1, master_->GetUsedCount());
   }
 
-  // Delete an URL.
+  // Delete an URL, and one which isn't there.
   URLs urls_to_delete;
   urls_to_delete.push_back(TestURL(0));
+  urls_to_delete.push_back(TestURL(g_test_count));
   TestURLIterator iterator(urls_to_delete);
   master_->DeleteURLs(&iterator);
 
@@ -487,9 +495,10 @@ TEST_F(VisitedLinkTest, Listener) {
 
   // Verify that VisitedLinkMaster::Listener::Add was called for each added URL.
   EXPECT_EQ(g_test_count, listener->add_count());
-  // Verify that VisitedLinkMaster::Listener::Reset was called both when one and
-  // all URLs are deleted.
-  EXPECT_EQ(2, listener->reset_count());
+  // Verify that VisitedLinkMaster::Listener::Delete was called for the one
+  // deleted URL which was visited, and Reset only when all URLs are deleted.
+  EXPECT_EQ(1, listener->delete_count());
+  EXPECT_EQ(1, listener->reset_count());
 }
 
 class VisitCountingContext : public content::TestBrowserContext {
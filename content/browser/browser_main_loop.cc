@@ -494,6 +494,8 @@ void BrowserMainLoop::MainMessageLoopStart() {
       ::HeapProfilerWithPseudoStackStart,
       ::HeapProfilerStop,
       ::GetHeapProfile));
+  if (parsed_command_line_.HasSwitch(switches::kEnableMemorySubsystemProfiling))
+    trace_memory_controller_->StartContinuousProfiling();
 #endif
 }
 
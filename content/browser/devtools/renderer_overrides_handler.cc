@@ -228,12 +228,14 @@ void RendererOverridesHandler::ScreenshotCaptured(
   SkAutoLockPixels lock_image(bitmap);
   bool encoded;
   if (format == kPng) {
-    encoded = gfx::PNGCodec::Encode(
+    // Screenshots are sent to the front-end right away, favor speed.
+    encoded = gfx::PNGCodec::EncodeWithOptions(
         reinterpret_cast<unsigned char*>(bitmap.getAddr32(0, 0)),
         gfx::PNGCodec::FORMAT_SkBitmap,
         gfx::Size(bitmap.width(), bitmap.height()),
         bitmap.width() * bitmap.bytesPerPixel(),
-        false, std::vector<gfx::PNGCodec::Comment>(), &data);
+        false, std::vector<gfx::PNGCodec::Comment>(),
+        gfx::PNGCodec::EncodeOptions::Fast(), &data);
   } else if (format == kJpeg) {
     encoded = gfx::JPEGCodec::Encode(
         reinterpret_cast<unsigned char*>(bitmap.getAddr32(0, 0)),
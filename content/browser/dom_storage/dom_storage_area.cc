@@ -100,11 +100,11 @@ DOMStorageArea::DOMStorageArea(
 DOMStorageArea::~DOMStorageArea() {
 }
 
-void DOMStorageArea::ExtractValues(DOMStorageValuesMap* map) {
+scoped_refptr<DOMStorageMap> DOMStorageArea::GetMapSnapshot() {
   if (is_shutdown_)
-    return;
+    return NULL;
   InitialImportIfNeeded();
-  map_->ExtractValues(map);
+  return map_;
 }
 
 unsigned DOMStorageArea::Length() {
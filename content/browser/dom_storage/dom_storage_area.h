@@ -48,8 +48,11 @@ class CONTENT_EXPORT DOMStorageArea
   const GURL& origin() const { return origin_; }
   int64 namespace_id() const { return namespace_id_; }
 
-  // Writes a copy of the current set of values in the area to the |map|.
-  void ExtractValues(DOMStorageValuesMap* map);
+  // Returns the map holding the current set of values in the area, or NULL
+  // once the area is shut down. The map is copy-on-write: the area copies it
+  // before changing it while the caller holds a reference, so callers see a
+  // consistent snapshot without copying the values themselves.
+  scoped_refptr<DOMStorageMap> GetMapSnapshot();
 
   unsigned Length();
   base::NullableString16 Key(unsigned index);
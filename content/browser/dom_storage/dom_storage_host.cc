@@ -50,9 +50,9 @@ void DOMStorageHost::CloseStorageArea(int connection_id) {
   connections_.erase(found);
 }
 
-bool DOMStorageHost::ExtractAreaValues(
-    int connection_id, DOMStorageValuesMap* map) {
-  map->clear();
+bool DOMStorageHost::GetAreaMapSnapshot(
+    int connection_id, scoped_refptr<DOMStorageMap>* map) {
+  *map = NULL;
   DOMStorageArea* area = GetOpenArea(connection_id);
   if (!area) {
     // TODO(michaeln): Fix crbug/134003 and return false here.
@@ -69,7 +69,7 @@ bool DOMStorageHost::ExtractAreaValues(
         ns->PurgeMemory(DOMStorageNamespace::PURGE_AGGRESSIVE);
     }
   }
-  area->ExtractValues(map);
+  *map = area->GetMapSnapshot();
   return true;
 }
 
@@ -18,6 +18,7 @@ class GURL;
 namespace content {
 
 class DOMStorageContextImpl;
+class DOMStorageMap;
 class DOMStorageHost;
 class DOMStorageNamespace;
 class DOMStorageArea;
@@ -35,7 +36,8 @@ class CONTENT_EXPORT DOMStorageHost {
   bool OpenStorageArea(int connection_id, int namespace_id,
                        const GURL& origin);
   void CloseStorageArea(int connection_id);
-  bool ExtractAreaValues(int connection_id, DOMStorageValuesMap* map);
+  bool GetAreaMapSnapshot(int connection_id,
+                          scoped_refptr<DOMStorageMap>* map);
   unsigned GetAreaLength(int connection_id);
   base::NullableString16 GetAreaKey(int connection_id, unsigned index);
   base::NullableString16 GetAreaItem(int connection_id,
@@ -14,6 +14,7 @@
 #include "content/browser/dom_storage/dom_storage_host.h"
 #include "content/browser/dom_storage/dom_storage_namespace.h"
 #include "content/browser/dom_storage/dom_storage_task_runner.h"
+#include "content/common/dom_storage/dom_storage_map.h"
 #include "content/common/dom_storage/dom_storage_messages.h"
 #include "base/synchronization/waitable_event.h"
 #include "content/public/browser/user_metrics.h"
@@ -92,7 +93,8 @@ bool DOMStorageMessageFilter::OnMessageReceived(const IPC::Message& message,
   IPC_BEGIN_MESSAGE_MAP_EX(DOMStorageMessageFilter, message, *message_was_ok)
     IPC_MESSAGE_HANDLER(DOMStorageHostMsg_OpenStorageArea, OnOpenStorageArea)
     IPC_MESSAGE_HANDLER(DOMStorageHostMsg_CloseStorageArea, OnCloseStorageArea)
-    IPC_MESSAGE_HANDLER(DOMStorageHostMsg_LoadStorageArea, OnLoadStorageArea)
+    IPC_MESSAGE_HANDLER_DELAY_REPLY(DOMStorageHostMsg_LoadStorageArea,
+                                    OnLoadStorageArea)
     IPC_MESSAGE_HANDLER(DOMStorageHostMsg_SetItem, OnSetItem)
     IPC_MESSAGE_HANDLER(DOMStorageHostMsg_RemoveItem, OnRemoveItem)
     IPC_MESSAGE_HANDLER(DOMStorageHostMsg_Clear, OnClear)
@@ -145,13 +147,25 @@ void DOMStorageMessageFilter::OnCloseStorageArea(int connection_id) {
 }
 
 void DOMStorageMessageFilter::OnLoadStorageArea(int connection_id,
-                                                DOMStorageValuesMap* map) {
+                                                IPC::Message* reply_msg) {
   DCHECK(!BrowserThread::CurrentlyOn(BrowserThread::IO));
-  if (!host_->ExtractAreaValues(connection_id, map)) {
+  scoped_refptr<DOMStorageMap> map;
+  if (!host_->GetAreaMapSnapshot(connection_id, &map)) {
     RecordAction(UserMetricsAction("BadMessageTerminate_DSMF_2"));
     BadMessageReceived();
   }
   Send(new DOMStorageMsg_AsyncOperationComplete(true));
+
+  // Serialize the values straight out of the area's map, which can be
+  // megabytes for some origins, rather than copying them first.
+  if (map.get()) {
+    DOMStorageHostMsg_LoadStorageArea::WriteReplyParams(reply_msg,
+                                                        map->values());
+  } else {
+    DOMStorageHostMsg_LoadStorageArea::WriteReplyParams(
+        reply_msg, DOMStorageValuesMap());
+  }
+  Send(reply_msg);
 }
 
 void DOMStorageMessageFilter::OnSetItem(
@@ -222,6 +222,12 @@ DownloadInterruptReason BaseFile::AnnotateWithSourceInformation() {
 }
 #endif
 
+// OS_LINUX has a specialized implementation.
+#if !defined(OS_LINUX)
+void BaseFile::Preallocate(int64 bytes) {
+}
+#endif
+
 bool BaseFile::GetHash(std::string* hash) {
   DCHECK(!detached_);
   hash->assign(reinterpret_cast<const char*>(sha256_hash_),
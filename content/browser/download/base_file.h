@@ -80,6 +80,11 @@ class CONTENT_EXPORT BaseFile {
   // Windows to ensure the correct app client ID is available.
   DownloadInterruptReason AnnotateWithSourceInformation();
 
+  // Asks the OS to reserve |bytes| of space past the data written so far,
+  // so that the file is laid out in large extents as it grows. The size of
+  // the file doesn't change. This is only a hint; failures are ignored.
+  void Preallocate(int64 bytes);
+
   base::FilePath full_path() const { return full_path_; }
   bool in_progress() const { return file_stream_.get() != NULL; }
   int64 bytes_so_far() const { return bytes_so_far_; }
@@ -4,8 +4,14 @@
 
 #include "content/browser/download/base_file.h"
 
+#include <fcntl.h>
+#include <linux/falloc.h>
+
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
 #include "content/browser/download/file_metadata_linux.h"
 #include "content/public/browser/browser_thread.h"
+#include "net/base/file_stream.h"
 
 namespace content {
 
@@ -17,4 +23,18 @@ DownloadInterruptReason BaseFile::AnnotateWithSourceInformation() {
   return DOWNLOAD_INTERRUPT_REASON_NONE;
 }
 
+void BaseFile::Preallocate(int64 bytes) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+  DCHECK(!detached_);
+
+  if (!file_stream_ || bytes <= 0)
+    return;
+
+  // FALLOC_FL_KEEP_SIZE leaves the file size alone, so the file never looks
+  // longer than the data in it if the download is interrupted.
+  if (HANDLE_EINTR(fallocate(file_stream_->GetPlatformFile(),
+                             FALLOC_FL_KEEP_SIZE, bytes_so_far_, bytes)) != 0)
+    DPLOG(WARNING) << "Failed to preallocate " << bytes << " bytes.";
+}
+
 }  // namespace content
@@ -306,6 +306,16 @@ TEST_F(BaseFileTest, SingleWrite) {
   base_file_->Finish();
 }
 
+// Reserve space for the file before writing to it.  The reserved space must
+// not show up in the file's contents.
+TEST_F(BaseFileTest, PreallocateThenWrite) {
+  ASSERT_TRUE(InitializeFile());
+  base_file_->Preallocate(1024 * 1024);
+  ASSERT_TRUE(AppendDataToFile(kTestData1));
+  ASSERT_TRUE(AppendDataToFile(kTestData2));
+  base_file_->Finish();
+}
+
 // Write data to the file multiple times.
 TEST_F(BaseFileTest, MultipleWrites) {
   ASSERT_TRUE(InitializeFile());
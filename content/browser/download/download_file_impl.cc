@@ -47,6 +47,7 @@ DownloadFileImpl::DownloadFileImpl(
                 save_info->file_stream.Pass(),
                 bound_net_log),
           default_download_directory_(default_download_directory),
+          expected_size_(save_info->expected_size),
           stream_reader_(stream.Pass()),
           bytes_seen_(0),
           bound_net_log_(bound_net_log),
@@ -71,6 +72,7 @@ void DownloadFileImpl::Initialize(const InitializeCallback& callback) {
         BrowserThread::UI, FROM_HERE, base::Bind(callback, result));
     return;
   }
+  file_.Preallocate(expected_size_);
 
   stream_reader_->RegisterCallback(
       base::Bind(&DownloadFileImpl::StreamActive, weak_factory_.GetWeakPtr()));
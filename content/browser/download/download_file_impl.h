@@ -84,6 +84,9 @@ class CONTENT_EXPORT DownloadFileImpl : virtual public DownloadFile {
   // The default directory for creating the download file.
   base::FilePath default_download_directory_;
 
+  // The number of bytes the download is expected to write, or 0 if unknown.
+  int64 expected_size_;
+
   // The stream through which data comes.
   // TODO(rdsmith): Move this into BaseFile; requires using the same
   // stream semantics in SavePackage.  Alternatively, replace SaveFile
@@ -8,6 +8,7 @@
 
 #include "base/bind.h"
 #include "base/logging.h"
+#include "base/memory/aligned_memory.h"
 #include "base/message_loop/message_loop_proxy.h"
 #include "base/metrics/histogram.h"
 #include "base/metrics/stats_counters.h"
@@ -65,9 +66,31 @@ static void StartOnUIThread(
   download_manager->StartDownload(info.Pass(), stream.Pass(), started_cb);
 }
 
+// The size of a page on the platforms we care about.
+const size_t kPageSize = 4096;
+
+// An IOBuffer whose data starts on a page boundary. The buffers are handed
+// through the ByteStream as they are, and written to disk in one piece on the
+// FILE thread, so aligning them lets the kernel copy whole pages.
+class PageAlignedIOBuffer : public net::IOBuffer {
+ public:
+  explicit PageAlignedIOBuffer(int size)
+      : net::IOBuffer(static_cast<char*>(
+            base::AlignedAlloc(size, kPageSize))) {
+  }
+
+ private:
+  virtual ~PageAlignedIOBuffer() {
+    base::AlignedFree(data_);
+    data_ = NULL;
+  }
+};
+
 }  // namespace
 
-const int DownloadResourceHandler::kDownloadByteStreamSize = 100 * 1024;
+// Room for several reads, so that the stream can hand a batch of them to the
+// FILE thread while the next ones come in.
+const int DownloadResourceHandler::kDownloadByteStreamSize = 4 * kReadBufSize;
 
 DownloadResourceHandler::DownloadResourceHandler(
     uint32 id,
@@ -184,6 +207,7 @@ bool DownloadResourceHandler::OnResponseStarted(
       save_info_->hash_state = "";
     }
   }
+  save_info_->expected_size = content_length_;
 
   std::string content_type_header;
   if (!response->head.headers.get() ||
@@ -241,7 +265,7 @@ bool DownloadResourceHandler::OnWillRead(int request_id, net::IOBuffer** buf,
 
   *buf_size = min_size < 0 ? kReadBufSize : min_size;
   last_buffer_size_ = *buf_size;
-  read_buffer_ = new net::IOBuffer(*buf_size);
+  read_buffer_ = new PageAlignedIOBuffer(*buf_size);
   *buf = read_buffer_.get();
   return true;
 }
@@ -134,7 +134,8 @@ class CONTENT_EXPORT DownloadResourceHandler
   // For DCHECKing
   bool on_response_started_called_;
 
-  static const int kReadBufSize = 32768;  // bytes
+  // Reads are large, as each one becomes a single write to the file.
+  static const int kReadBufSize = 256 * 1024;  // bytes
   static const int kThrottleTimeMs = 200;  // milliseconds
 
   DISALLOW_COPY_AND_ASSIGN(DownloadResourceHandler);
@@ -4,6 +4,9 @@
 
 #include "content/browser/gpu/shader_disk_cache.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "base/threading/thread_checker.h"
 #include "content/browser/gpu/gpu_process_host.h"
 #include "content/public/browser/browser_thread.h"
@@ -23,6 +26,17 @@ void EntryCloser(disk_cache::Entry* entry) {
   entry->Close();
 }
 
+// A program read off disk, waiting to be sent to the GPU process.
+struct CachedProgram {
+  base::Time last_used;
+  std::string key;
+  std::string data;
+};
+
+bool UsedMoreRecently(const CachedProgram& a, const CachedProgram& b) {
+  return a.last_used > b.last_used;
+}
+
 }  // namespace
 
 // ShaderDiskCacheEntry handles the work of caching/updating the cached
@@ -64,7 +78,9 @@ class ShaderDiskCacheEntry
 };
 
 // ShaderDiskReadHelper is used to load all of the cached shaders from the
-// disk cache and send to the memory cache.
+// disk cache and send to the memory cache. They are sent once all of them are
+// read, most recently used first, so that when the memory cache can't hold
+// them all it keeps the ones most likely to be linked again.
 class ShaderDiskReadHelper
     : public base::ThreadChecker,
       public base::RefCounted<ShaderDiskReadHelper> {
@@ -99,6 +115,7 @@ class ShaderDiskReadHelper
   scoped_refptr<net::IOBufferWithSize> buf_;
   int host_id_;
   disk_cache::Entry* entry_;
+  std::vector<CachedProgram> loaded_programs_;
 
   DISALLOW_COPY_AND_ASSIGN(ShaderDiskReadHelper);
 };
@@ -322,10 +339,11 @@ int ShaderDiskReadHelper::ReadComplete(int rv) {
   DCHECK(CalledOnValidThread());
   // Called through OnOpComplete, so we know |cache_| is valid.
   if (rv && rv == buf_->size()) {
-    GpuProcessHost* host = GpuProcessHost::FromID(host_id_);
-    if (host)
-      host->LoadedShader(entry_->GetKey(), std::string(buf_->data(),
-                                                       buf_->size()));
+    CachedProgram program;
+    program.last_used = entry_->GetLastUsed();
+    program.key = entry_->GetKey();
+    program.data.assign(buf_->data(), buf_->size());
+    loaded_programs_.push_back(program);
   }
 
   buf_ = NULL;
@@ -341,6 +359,16 @@ int ShaderDiskReadHelper::IterationComplete(int rv) {
   // Called through OnOpComplete, so we know |cache_| is valid.
   cache_->backend()->EndEnumeration(&iter_);
   iter_ = NULL;
+
+  GpuProcessHost* host = GpuProcessHost::FromID(host_id_);
+  if (host) {
+    std::stable_sort(loaded_programs_.begin(), loaded_programs_.end(),
+                     &UsedMoreRecently);
+    for (size_t i = 0; i < loaded_programs_.size(); ++i)
+      host->LoadedShader(loaded_programs_[i].key, loaded_programs_[i].data);
+  }
+  loaded_programs_.clear();
+
   op_type_ = TERMINATE;
   return net::OK;
 }
@@ -56,6 +56,7 @@ enum IndexedDBBackingStoreErrorSource {
   DELETE_DATABASE,
   TRANSACTION_COMMIT_METHOD,  // TRANSACTION_COMMIT is a WinNT.h macro
   GET_DATABASE_NAMES,
+  GET_RECORDS,
   INTERNAL_ERROR_MAX,
 };
 
@@ -2500,6 +2501,63 @@ bool IndexCursorOptions(
   return true;
 }
 
+bool IndexedDBBackingStore::GetRecords(
+    IndexedDBBackingStore::Transaction* transaction,
+    int64 database_id,
+    int64 object_store_id,
+    const IndexedDBKeyRange& range,
+    size_t max_count,
+    std::vector<IndexedDBKey>* keys,
+    std::vector<std::string>* records) {
+  IDB_TRACE("IndexedDBBackingStore::GetRecords");
+  keys->clear();
+  records->clear();
+  if (!KeyPrefix::ValidIds(database_id, object_store_id))
+    return false;
+  LevelDBTransaction* leveldb_transaction =
+      IndexedDBBackingStore::Transaction::LevelDBTransactionFrom(transaction);
+
+  IndexedDBBackingStore::Cursor::CursorOptions options;
+  if (!ObjectStoreCursorOptions(leveldb_transaction,
+                                database_id,
+                                object_store_id,
+                                range,
+                                indexed_db::CURSOR_NEXT,
+                                &options))
+    return true;
+
+  // Unlike Cursor::Continue(), this neither keeps the previous key around
+  // nor re-encodes each key into a RecordIdentifier, since the records are
+  // only being read.
+  scoped_ptr<LevelDBIterator> it = leveldb_transaction->CreateIterator();
+  for (it->Seek(options.low_key); it->IsValid() && keys->size() < max_count;
+       it->Next()) {
+    int compare = CompareIndexKeys(it->Key(), options.high_key);
+    if (options.high_open ? compare >= 0 : compare > 0)
+      break;
+    if (options.low_open && CompareIndexKeys(it->Key(), options.low_key) == 0)
+      continue;
+
+    StringPiece slice(it->Key());
+    ObjectStoreDataKey object_store_data_key;
+    if (!ObjectStoreDataKey::Decode(&slice, &object_store_data_key)) {
+      INTERNAL_READ_ERROR(GET_RECORDS);
+      return false;
+    }
+
+    int64 version;
+    slice = StringPiece(it->Value());
+    if (!DecodeVarInt(&slice, &version)) {
+      INTERNAL_READ_ERROR(GET_RECORDS);
+      return false;
+    }
+
+    keys->push_back(*object_store_data_key.user_key());
+    records->push_back(slice.as_string());
+  }
+  return true;
+}
+
 scoped_ptr<IndexedDBBackingStore::Cursor>
 IndexedDBBackingStore::OpenObjectStoreCursor(
     IndexedDBBackingStore::Transaction* transaction,
@@ -124,6 +124,17 @@ class CONTENT_EXPORT IndexedDBBackingStore
                          int64 object_store_id,
                          const IndexedDBKey& key,
                          std::string* record) WARN_UNUSED_RESULT;
+  // Reads up to |max_count| records in |key_range| of the object store, in
+  // key order, with a single pass of one iterator. This is much cheaper than
+  // stepping an object store cursor for each record when the caller wants
+  // the whole batch, such as a getAll() style request.
+  virtual bool GetRecords(IndexedDBBackingStore::Transaction* transaction,
+                          int64 database_id,
+                          int64 object_store_id,
+                          const IndexedDBKeyRange& key_range,
+                          size_t max_count,
+                          std::vector<IndexedDBKey>* keys,
+                          std::vector<std::string>* records) WARN_UNUSED_RESULT;
   virtual bool PutRecord(IndexedDBBackingStore::Transaction* transaction,
                          int64 database_id,
                          int64 object_store_id,
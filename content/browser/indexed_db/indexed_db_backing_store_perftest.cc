@@ -0,0 +1,112 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/indexed_db/indexed_db_backing_store.h"
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "base/compiler_specific.h"
+#include "base/time/time.h"
+#include "content/common/indexed_db/indexed_db_key.h"
+#include "content/common/indexed_db/indexed_db_key_range.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/WebKit/public/platform/WebIDBTypes.h"
+
+namespace content {
+
+namespace {
+
+const int64 kDatabaseId = 1;
+const int64 kObjectStoreId = 1;
+const int kNumRecords = 10000;
+const size_t kValueSize = 256;
+
+// Measures how fast the records of an object store can be read back, one
+// cursor step at a time and in a single batch.
+class IndexedDBBackingStorePerfTest : public testing::Test {
+ public:
+  IndexedDBBackingStorePerfTest() {}
+
+  virtual void SetUp() OVERRIDE {
+    backing_store_ = IndexedDBBackingStore::OpenInMemory(std::string());
+    ASSERT_TRUE(backing_store_.get());
+
+    IndexedDBBackingStore::Transaction transaction(backing_store_);
+    transaction.Begin();
+    const std::string value(kValueSize, 'x');
+    for (int i = 0; i < kNumRecords; ++i) {
+      IndexedDBBackingStore::RecordIdentifier record;
+      ASSERT_TRUE(backing_store_->PutRecord(
+          &transaction,
+          kDatabaseId,
+          kObjectStoreId,
+          IndexedDBKey(i, WebKit::WebIDBKeyTypeNumber),
+          value,
+          &record));
+    }
+    ASSERT_TRUE(transaction.Commit());
+  }
+
+ protected:
+  void PrintResult(const char* name, base::TimeDelta elapsed) {
+    printf("*RESULT %s: %.2f records/ms\n",
+           name,
+           kNumRecords / elapsed.InMillisecondsF());
+  }
+
+  scoped_refptr<IndexedDBBackingStore> backing_store_;
+};
+
+TEST_F(IndexedDBBackingStorePerfTest, CursorIteration) {
+  IndexedDBBackingStore::Transaction transaction(backing_store_);
+  transaction.Begin();
+
+  base::TimeTicks start = base::TimeTicks::HighResNow();
+  scoped_ptr<IndexedDBBackingStore::Cursor> cursor =
+      backing_store_->OpenObjectStoreCursor(&transaction,
+                                            kDatabaseId,
+                                            kObjectStoreId,
+                                            IndexedDBKeyRange(),
+                                            indexed_db::CURSOR_NEXT);
+  ASSERT_TRUE(cursor.get());
+  int count = 0;
+  std::vector<std::string> values;
+  do {
+    values.push_back(*cursor->Value());
+    ++count;
+  } while (cursor->Continue());
+  base::TimeDelta elapsed = base::TimeTicks::HighResNow() - start;
+  transaction.Commit();
+
+  EXPECT_EQ(kNumRecords, count);
+  PrintResult("indexed_db_cursor_iteration", elapsed);
+}
+
+TEST_F(IndexedDBBackingStorePerfTest, GetRecords) {
+  IndexedDBBackingStore::Transaction transaction(backing_store_);
+  transaction.Begin();
+
+  base::TimeTicks start = base::TimeTicks::HighResNow();
+  std::vector<IndexedDBKey> keys;
+  std::vector<std::string> values;
+  ASSERT_TRUE(backing_store_->GetRecords(&transaction,
+                                         kDatabaseId,
+                                         kObjectStoreId,
+                                         IndexedDBKeyRange(),
+                                         kNumRecords,
+                                         &keys,
+                                         &values));
+  base::TimeDelta elapsed = base::TimeTicks::HighResNow() - start;
+  transaction.Commit();
+
+  EXPECT_EQ(static_cast<size_t>(kNumRecords), values.size());
+  PrintResult("indexed_db_get_records", elapsed);
+}
+
+}  // namespace
+
+}  // namespace content
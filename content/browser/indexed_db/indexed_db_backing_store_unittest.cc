@@ -71,6 +71,63 @@ TEST_F(IndexedDBBackingStoreTest, PutGetConsistency) {
   }
 }
 
+TEST_F(IndexedDBBackingStoreTest, GetRecords) {
+  {
+    IndexedDBBackingStore::Transaction transaction1(backing_store_);
+    transaction1.Begin();
+    IndexedDBBackingStore::RecordIdentifier record;
+    EXPECT_TRUE(backing_store_->PutRecord(
+        &transaction1, 1, 1, m_key3, m_value3, &record));
+    EXPECT_TRUE(backing_store_->PutRecord(
+        &transaction1, 1, 1, m_key1, m_value1, &record));
+    EXPECT_TRUE(backing_store_->PutRecord(
+        &transaction1, 1, 1, m_key2, m_value2, &record));
+    // A record in another object store must not be returned.
+    EXPECT_TRUE(backing_store_->PutRecord(
+        &transaction1, 1, 2, m_key2, m_value1, &record));
+    EXPECT_TRUE(transaction1.Commit());
+  }
+
+  IndexedDBBackingStore::Transaction transaction2(backing_store_);
+  transaction2.Begin();
+  std::vector<IndexedDBKey> keys;
+  std::vector<std::string> values;
+
+  // The whole object store, in key order.
+  EXPECT_TRUE(backing_store_->GetRecords(
+      &transaction2, 1, 1, IndexedDBKeyRange(), 100, &keys, &values));
+  ASSERT_EQ(3u, keys.size());
+  ASSERT_EQ(3u, values.size());
+  EXPECT_TRUE(keys[0].IsEqual(m_key1));
+  EXPECT_TRUE(keys[1].IsEqual(m_key2));
+  EXPECT_TRUE(keys[2].IsEqual(m_key3));
+  EXPECT_EQ(m_value1, values[0]);
+  EXPECT_EQ(m_value2, values[1]);
+  EXPECT_EQ(m_value3, values[2]);
+
+  // Open bounds are excluded.
+  EXPECT_TRUE(backing_store_->GetRecords(
+      &transaction2, 1, 1, IndexedDBKeyRange(m_key1, m_key3, true, true), 100,
+      &keys, &values));
+  ASSERT_EQ(1u, keys.size());
+  EXPECT_TRUE(keys[0].IsEqual(m_key2));
+  EXPECT_EQ(m_value2, values[0]);
+
+  // Closed bounds are included, up to |max_count| records.
+  EXPECT_TRUE(backing_store_->GetRecords(
+      &transaction2, 1, 1, IndexedDBKeyRange(m_key2, m_key3, false, false), 1,
+      &keys, &values));
+  ASSERT_EQ(1u, keys.size());
+  EXPECT_TRUE(keys[0].IsEqual(m_key2));
+
+  // An empty object store.
+  EXPECT_TRUE(backing_store_->GetRecords(
+      &transaction2, 1, 3, IndexedDBKeyRange(), 100, &keys, &values));
+  EXPECT_TRUE(keys.empty());
+  EXPECT_TRUE(values.empty());
+  transaction2.Commit();
+}
+
 // Make sure that using very high ( more than 32 bit ) values for database_id
 // and object_store_id still work.
 TEST_F(IndexedDBBackingStoreTest, HighIds) {
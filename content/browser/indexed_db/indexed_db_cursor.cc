@@ -4,6 +4,8 @@
 
 #include "content/browser/indexed_db/indexed_db_cursor.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "content/browser/indexed_db/indexed_db_callbacks.h"
 #include "content/browser/indexed_db/indexed_db_database_error.h"
@@ -12,6 +14,14 @@
 
 namespace content {
 
+namespace {
+
+// The most records the first prefetch of a run is grown to, which matches
+// the renderer's own limit.
+const int kMaxAdaptivePrefetch = 100;
+
+}  // namespace
+
 class IndexedDBCursor::CursorIterationOperation
     : public IndexedDBTransaction::Operation {
  public:
@@ -68,7 +78,9 @@ IndexedDBCursor::IndexedDBCursor(
       cursor_type_(cursor_type),
       transaction_(transaction),
       cursor_(cursor.Pass()),
-      closed_(false) {
+      closed_(false),
+      prefetched_in_run_(0),
+      last_prefetch_run_(0) {
   transaction_->RegisterOpenCursor(this);
 }
 
@@ -79,6 +91,7 @@ IndexedDBCursor::~IndexedDBCursor() {
 void IndexedDBCursor::Continue(scoped_ptr<IndexedDBKey> key,
                                scoped_refptr<IndexedDBCallbacks> callbacks) {
   IDB_TRACE("IndexedDBCursor::Continue");
+  EndPrefetchRun(prefetched_in_run_);
 
   transaction_->ScheduleTask(
       task_type_, new CursorIterationOperation(this, key.Pass(), callbacks));
@@ -87,6 +100,7 @@ void IndexedDBCursor::Continue(scoped_ptr<IndexedDBKey> key,
 void IndexedDBCursor::Advance(uint32 count,
                               scoped_refptr<IndexedDBCallbacks> callbacks) {
   IDB_TRACE("IndexedDBCursor::Advance");
+  EndPrefetchRun(prefetched_in_run_);
 
   transaction_->ScheduleTask(
       new CursorAdvanceOperation(this, count, callbacks));
@@ -134,6 +148,13 @@ void IndexedDBCursor::CursorPrefetchIterationOperation::Perform(
     IndexedDBTransaction* /*transaction*/) {
   IDB_TRACE("CursorPrefetchIterationOperation");
 
+  int number_to_fetch = number_to_fetch_;
+  if (!cursor_->prefetched_in_run_) {
+    number_to_fetch = std::max(
+        number_to_fetch,
+        std::min(cursor_->last_prefetch_run_, kMaxAdaptivePrefetch));
+  }
+
   std::vector<IndexedDBKey> found_keys;
   std::vector<IndexedDBKey> found_primary_keys;
   std::vector<std::string> found_values;
@@ -143,7 +164,7 @@ void IndexedDBCursor::CursorPrefetchIterationOperation::Perform(
   const size_t max_size_estimate = 10 * 1024 * 1024;
   size_t size_estimate = 0;
 
-  for (int i = 0; i < number_to_fetch_; ++i) {
+  for (int i = 0; i < number_to_fetch; ++i) {
     if (!cursor_->cursor_ || !cursor_->cursor_->Continue()) {
       cursor_->cursor_.reset();
       break;
@@ -178,12 +199,16 @@ void IndexedDBCursor::CursorPrefetchIterationOperation::Perform(
     return;
   }
 
+  cursor_->prefetched_in_run_ += found_keys.size();
+
   callbacks_->OnSuccessWithPrefetch(
       found_keys, found_primary_keys, found_values);
 }
 
-void IndexedDBCursor::PrefetchReset(int used_prefetches, int) {
+void IndexedDBCursor::PrefetchReset(int used_prefetches,
+                                    int unused_prefetches) {
   IDB_TRACE("IndexedDBCursor::PrefetchReset");
+  EndPrefetchRun(prefetched_in_run_ - unused_prefetches);
   cursor_.swap(saved_cursor_);
   saved_cursor_.reset();
 
@@ -197,6 +222,13 @@ void IndexedDBCursor::PrefetchReset(int used_prefetches, int) {
   }
 }
 
+void IndexedDBCursor::EndPrefetchRun(int used) {
+  if (!prefetched_in_run_)
+    return;
+  last_prefetch_run_ = std::max(used, 0);
+  prefetched_in_run_ = 0;
+}
+
 void IndexedDBCursor::Close() {
   IDB_TRACE("IndexedDBCursor::Close");
   closed_ = true;
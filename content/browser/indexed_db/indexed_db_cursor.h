@@ -50,6 +50,10 @@ class CONTENT_EXPORT IndexedDBCursor
   class CursorAdvanceOperation;
   class CursorPrefetchIterationOperation;
 
+  // Records that the renderer used |used| of the prefetched records before
+  // it stopped continuing the cursor without a key.
+  void EndPrefetchRun(int used);
+
   IndexedDBDatabase::TaskType task_type_;
   indexed_db::CursorType cursor_type_;
   const scoped_refptr<IndexedDBTransaction> transaction_;
@@ -60,6 +64,14 @@ class CONTENT_EXPORT IndexedDBCursor
   scoped_ptr<IndexedDBBackingStore::Cursor> saved_cursor_;
 
   bool closed_;
+
+  // Number of records sent to the renderer by prefetches since it last
+  // stopped continuing without a key, and the number it used the last time
+  // it did. The renderer starts each run with a small prefetch and doubles
+  // it, so when the previous run was long the first prefetch of the next
+  // one is grown to match, saving the round trips of the ramp up.
+  int prefetched_in_run_;
+  int last_prefetch_run_;
 };
 
 }  // namespace content
@@ -15,6 +15,7 @@
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/sys_info.h"
+#include "base/time/time.h"
 #include "content/browser/indexed_db/leveldb/leveldb_comparator.h"
 #include "content/browser/indexed_db/leveldb/leveldb_iterator.h"
 #include "content/browser/indexed_db/leveldb/leveldb_write_batch.h"
@@ -378,8 +379,12 @@ bool LevelDBDatabase::Write(const LevelDBWriteBatch& write_batch) {
   leveldb::WriteOptions write_options;
   write_options.sync = true;
 
+  // Includes the time the write is held up while compactions catch up.
+  base::TimeTicks start = base::TimeTicks::Now();
   const leveldb::Status s =
       db_->Write(write_options, write_batch.write_batch_.get());
+  UMA_HISTOGRAM_TIMES("WebCore.IndexedDB.LevelDBWriteTime",
+                      base::TimeTicks::Now() - start);
   if (s.ok())
     return true;
   HistogramLevelDBError("WebCore.IndexedDB.LevelDBWriteErrors", s);
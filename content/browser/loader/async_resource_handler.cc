@@ -86,7 +86,7 @@ AsyncResourceHandler::AsyncResourceHandler(
       routing_id_(routing_id),
       request_(request),
       rdh_(rdh),
-      pending_data_count_(0),
+      pending_chunks_(new std::vector<ResourceMsg_DataChunk>()),
       allocation_size_(0),
       did_defer_(false),
       has_checked_for_sufficient_resources_(false),
@@ -127,13 +127,19 @@ void AsyncResourceHandler::OnFollowRedirect(
 }
 
 void AsyncResourceHandler::OnDataReceivedACK(int request_id) {
-  if (pending_data_count_) {
-    --pending_data_count_;
+  if (unacked_allocation_counts_.empty())
+    return;
 
+  int num_allocations = unacked_allocation_counts_.front();
+  unacked_allocation_counts_.pop();
+  for (int i = 0; i < num_allocations; ++i)
     buffer_->RecycleLeastRecentlyAllocated();
-    if (buffer_->CanAllocate())
-      ResumeIfDeferred();
-  }
+
+  if (!pending_chunks_->empty())
+    SendPendingData(request_id);
+
+  if (buffer_->CanAllocate())
+    ResumeIfDeferred();
 }
 
 bool AsyncResourceHandler::OnUploadProgress(int request_id,
@@ -260,22 +266,23 @@ bool AsyncResourceHandler::OnReadCompleted(int request_id, int bytes_read,
     sent_first_data_msg_ = true;
   }
 
-  int data_offset = buffer_->GetLastAllocationOffset();
-  int encoded_data_length =
+  ResourceMsg_DataChunk chunk;
+  chunk.data_offset = buffer_->GetLastAllocationOffset();
+  chunk.data_length = bytes_read;
+  chunk.encoded_data_length =
       DevToolsNetLogObserver::GetAndResetEncodedDataLength(request_);
+  pending_chunks_->push_back(chunk);
 
-  filter_->Send(
-      new ResourceMsg_DataReceived(routing_id_, request_id, data_offset,
-                                   bytes_read, encoded_data_length));
-  ++pending_data_count_;
-  UMA_HISTOGRAM_CUSTOM_COUNTS(
-      "Net.AsyncResourceHandler_PendingDataCount",
-      pending_data_count_, 0, 100, 100);
+  // The data goes out with the next message if the renderer is still busy
+  // with the previous one.
+  if (unacked_allocation_counts_.empty())
+    SendPendingData(request_id);
 
   if (!buffer_->CanAllocate()) {
     UMA_HISTOGRAM_CUSTOM_COUNTS(
         "Net.AsyncResourceHandler_PendingDataCount_WhenFull",
-        pending_data_count_, 0, 100, 100);
+        unacked_allocation_counts_.size() + pending_chunks_->size(),
+        0, 100, 100);
     *defer = did_defer_ = true;
   }
 
@@ -306,6 +313,9 @@ bool AsyncResourceHandler::OnResponseCompleted(
   CHECK(status.status() != net::URLRequestStatus::SUCCESS ||
         sent_received_response_msg_);
 
+  if (!pending_chunks_->empty())
+    SendPendingData(request_id);
+
   TimeTicks completion_time = TimeTicks::Now();
 
   int error_code = status.error();
@@ -337,6 +347,28 @@ bool AsyncResourceHandler::OnResponseCompleted(
   return true;
 }
 
+void AsyncResourceHandler::SendPendingData(int request_id) {
+  DCHECK(!pending_chunks_->empty());
+  if (pending_chunks_->size() == 1) {
+    const ResourceMsg_DataChunk& chunk = pending_chunks_->front();
+    filter_->Send(new ResourceMsg_DataReceived(
+        routing_id_, request_id, chunk.data_offset, chunk.data_length,
+        chunk.encoded_data_length));
+  } else {
+    filter_->Send(new ResourceMsg_DataReceivedBatch(
+        routing_id_, request_id, *pending_chunks_));
+  }
+  UMA_HISTOGRAM_CUSTOM_COUNTS(
+      "Net.AsyncResourceHandler_ChunksPerDataMessage",
+      pending_chunks_->size(), 1, 100, 50);
+
+  unacked_allocation_counts_.push(pending_chunks_->size());
+  pending_chunks_->clear();
+  UMA_HISTOGRAM_CUSTOM_COUNTS(
+      "Net.AsyncResourceHandler_PendingDataCount",
+      unacked_allocation_counts_.size(), 0, 100, 100);
+}
+
 bool AsyncResourceHandler::EnsureResourceBufferIsInitialized() {
   if (buffer_.get() && buffer_->IsInitialized())
     return true;
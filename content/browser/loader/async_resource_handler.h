@@ -5,9 +5,12 @@
 #ifndef CONTENT_BROWSER_LOADER_ASYNC_RESOURCE_HANDLER_H_
 #define CONTENT_BROWSER_LOADER_ASYNC_RESOURCE_HANDLER_H_
 
+#include <queue>
 #include <string>
+#include <vector>
 
 #include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
 #include "content/browser/loader/resource_handler.h"
 #include "content/browser/loader/resource_message_delegate.h"
 #include "url/gurl.h"
@@ -16,6 +19,8 @@ namespace net {
 class URLRequest;
 }
 
+struct ResourceMsg_DataChunk;
+
 namespace content {
 class ResourceBuffer;
 class ResourceDispatcherHostImpl;
@@ -24,6 +29,12 @@ class SharedIOBuffer;
 
 // Used to complete an asynchronous resource request in response to resource
 // load events from the resource dispatcher host.
+//
+// Response data is passed to the renderer through a ResourceBuffer in shared
+// memory. Data read while the renderer is still processing a data message is
+// held back, and sent in one DataReceivedBatch message once the renderer
+// acknowledges the previous one. A burst of reads thus costs a couple of IPCs
+// each way, rather than one per read.
 class AsyncResourceHandler : public ResourceHandler,
                              public ResourceMessageDelegate {
  public:
@@ -70,6 +81,9 @@ class AsyncResourceHandler : public ResourceHandler,
                         const GURL& new_first_party_for_cookies);
   void OnDataReceivedACK(int request_id);
 
+  // Sends the data held back in |pending_chunks_|.
+  void SendPendingData(int request_id);
+
   bool EnsureResourceBufferIsInitialized();
   void ResumeIfDeferred();
 
@@ -79,9 +93,12 @@ class AsyncResourceHandler : public ResourceHandler,
   net::URLRequest* request_;
   ResourceDispatcherHostImpl* rdh_;
 
-  // Number of messages we've sent to the renderer that we haven't gotten an
-  // ACK for. This allows us to avoid having too many messages in flight.
-  int pending_data_count_;
+  // Number of buffer allocations in each data message we've sent to the
+  // renderer that we haven't gotten an ACK for, oldest first.
+  std::queue<int> unacked_allocation_counts_;
+
+  // Data read while a data message was in flight.
+  scoped_ptr<std::vector<ResourceMsg_DataChunk> > pending_chunks_;
 
   int allocation_size_;
 
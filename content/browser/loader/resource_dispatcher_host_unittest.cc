@@ -78,6 +78,7 @@ static int RequestIDForMessage(const IPC::Message& msg) {
     case ResourceMsg_ReceivedRedirect::ID:
     case ResourceMsg_SetDataBuffer::ID:
     case ResourceMsg_DataReceived::ID:
+    case ResourceMsg_DataReceivedBatch::ID:
     case ResourceMsg_RequestComplete::ID: {
       bool result = PickleIterator(msg).ReadInt(&request_id);
       DCHECK(result);
@@ -87,6 +88,13 @@ static int RequestIDForMessage(const IPC::Message& msg) {
   return request_id;
 }
 
+// Returns true if |msg| passes response data to the renderer, which must
+// acknowledge it.
+static bool IsDataReceivedMessage(const IPC::Message& msg) {
+  return msg.type() == ResourceMsg_DataReceived::ID ||
+      msg.type() == ResourceMsg_DataReceivedBatch::ID;
+}
+
 static ResourceHostMsg_Request CreateResourceRequest(
     const char* method,
     ResourceType::Type type,
@@ -547,8 +555,7 @@ class ResourceDispatcherHostTest : public testing::Test,
   virtual bool Send(IPC::Message* msg) OVERRIDE {
     accum_.AddMessage(*msg);
 
-    if (send_data_received_acks_ &&
-        msg->type() == ResourceMsg_DataReceived::ID) {
+    if (send_data_received_acks_ && IsDataReceivedMessage(*msg)) {
       GenerateDataReceivedACK(*msg);
     }
 
@@ -702,7 +709,7 @@ class ResourceDispatcherHostTest : public testing::Test,
   }
 
   void GenerateDataReceivedACK(const IPC::Message& msg) {
-    EXPECT_EQ(ResourceMsg_DataReceived::ID, msg.type());
+    EXPECT_TRUE(IsDataReceivedMessage(msg));
 
     int request_id = -1;
     bool result = PickleIterator(msg).ReadInt(&request_id);
@@ -1900,7 +1907,7 @@ TEST_F(ResourceDispatcherHostTest, DataReceivedACKs) {
   EXPECT_EQ(ResourceMsg_ReceivedResponse::ID, msgs[0][0].type());
   EXPECT_EQ(ResourceMsg_SetDataBuffer::ID, msgs[0][1].type());
   for (size_t i = 2; i < size - 1; ++i)
-    EXPECT_EQ(ResourceMsg_DataReceived::ID, msgs[0][i].type());
+    EXPECT_TRUE(IsDataReceivedMessage(msgs[0][i]));
   EXPECT_EQ(ResourceMsg_RequestComplete::ID, msgs[0][size - 1].type());
 }
 
@@ -1936,7 +1943,7 @@ TEST_F(ResourceDispatcherHostTest, DelayedDataReceivedACKs) {
         break;
       }
 
-      EXPECT_EQ(ResourceMsg_DataReceived::ID, msgs[0][i].type());
+      EXPECT_TRUE(IsDataReceivedMessage(msgs[0][i]));
 
       ResourceHostMsg_DataReceived_ACK msg(0, 1);
       bool msg_was_ok;
@@ -1950,6 +1957,63 @@ TEST_F(ResourceDispatcherHostTest, DelayedDataReceivedACKs) {
   }
 }
 
+// Data that is read while the renderer processes a data message is sent in a
+// single batch once the renderer acknowledges that message.
+TEST_F(ResourceDispatcherHostTest, DataReceivedBatchedUntilACK) {
+  EXPECT_EQ(0, host_.pending_requests());
+
+  HandleScheme("big-job");
+  MakeTestRequest(0, 1, GURL("big-job:0123456789,1000000"));
+
+  ResourceIPCAccumulator::ClassifiedMessages msgs;
+  accum_.GetClassifiedMessages(&msgs);
+
+  // Only the first read is sent right away.
+  ASSERT_EQ(3U, msgs[0].size());
+  EXPECT_EQ(ResourceMsg_ReceivedResponse::ID, msgs[0][0].type());
+  EXPECT_EQ(ResourceMsg_SetDataBuffer::ID, msgs[0][1].type());
+  EXPECT_EQ(ResourceMsg_DataReceived::ID, msgs[0][2].type());
+
+  ResourceHostMsg_DataReceived_ACK ack(0, 1);
+  bool msg_was_ok;
+  host_.OnMessageReceived(ack, filter_.get(), &msg_was_ok);
+  base::MessageLoop::current()->RunUntilIdle();
+
+  // The reads that filled the buffer meanwhile come in one message, and the
+  // ones after it wait for the next ACK.
+  msgs.clear();
+  accum_.GetClassifiedMessages(&msgs);
+  ASSERT_EQ(1U, msgs[0].size());
+  ASSERT_EQ(ResourceMsg_DataReceivedBatch::ID, msgs[0][0].type());
+
+  PickleIterator iter(msgs[0][0]);
+  int request_id;
+  std::vector<ResourceMsg_DataChunk> chunks;
+  ASSERT_TRUE(IPC::ReadParam(&msgs[0][0], &iter, &request_id));
+  ASSERT_TRUE(IPC::ReadParam(&msgs[0][0], &iter, &chunks));
+  EXPECT_EQ(1, request_id);
+  EXPECT_GT(chunks.size(), 1U);
+  for (size_t i = 0; i < chunks.size(); ++i)
+    EXPECT_GT(chunks[i].data_length, 0);
+
+  // ACK the rest until the request completes.
+  bool complete = false;
+  while (!complete) {
+    host_.OnMessageReceived(ack, filter_.get(), &msg_was_ok);
+    base::MessageLoop::current()->RunUntilIdle();
+
+    msgs.clear();
+    accum_.GetClassifiedMessages(&msgs);
+    ASSERT_FALSE(msgs[0].empty());
+    for (size_t i = 0; i < msgs[0].size(); ++i) {
+      if (msgs[0][i].type() == ResourceMsg_RequestComplete::ID)
+        complete = true;
+      else
+        EXPECT_TRUE(IsDataReceivedMessage(msgs[0][i]));
+    }
+  }
+}
+
 // Flakyness of this test might indicate memory corruption issues with
 // for example the ResourceBuffer of AsyncResourceHandler.
 TEST_F(ResourceDispatcherHostTest, DataReceivedUnexpectedACKs) {
@@ -1990,7 +2054,7 @@ TEST_F(ResourceDispatcherHostTest, DataReceivedUnexpectedACKs) {
         break;
       }
 
-      EXPECT_EQ(ResourceMsg_DataReceived::ID, msgs[0][i].type());
+      EXPECT_TRUE(IsDataReceivedMessage(msgs[0][i]));
 
       ResourceHostMsg_DataReceived_ACK msg(0, 1);
       bool msg_was_ok;
@@ -4,7 +4,11 @@
 
 #include "content/browser/loader/resource_scheduler.h"
 
+#include <algorithm>
+
 #include "base/stl_util.h"
+#include "base/time/default_tick_clock.h"
+#include "base/time/tick_clock.h"
 #include "content/common/resource_messages.h"
 #include "content/browser/loader/resource_message_delegate.h"
 #include "content/public/browser/resource_controller.h"
@@ -20,7 +24,40 @@
 
 namespace content {
 
-static const size_t kMaxNumDelayableRequestsPerClient = 10;
+// HTTP/1.1 origins get at most this many connections, so more delayable
+// requests would only wait in the socket pool, where they can't be
+// reprioritized.
+static const size_t kMaxNumDelayableRequestsPerHost = 6;
+
+// The limit on delayable requests in flight per client starts at the minimum,
+// and moves by kDelayableRequestsLimitStep within these bounds as the
+// throughput of the client changes.
+static const size_t kMinNumDelayableRequestsPerClient = 10;
+static const size_t kMaxNumDelayableRequestsPerClient = 30;
+static const size_t kDelayableRequestsLimitStep = 2;
+
+// The number of finished requests that make up one throughput sample.
+static const int kNumRequestsPerThroughputSample = 10;
+
+// Throughput changes smaller than this fraction are considered noise.
+static const double kThroughputChangeThreshold = 0.1;
+
+namespace {
+
+// Returns true if requests to the origin of |request| are multiplexed over a
+// SPDY or QUIC session, which takes care of prioritizing them.
+bool OriginIsMultiplexed(const net::URLRequest& request) {
+  const net::HttpServerProperties& http_server_properties =
+      *request.context()->http_server_properties();
+  net::HostPortPair host_port_pair = net::HostPortPair::FromURL(request.url());
+  if (http_server_properties.SupportsSpdy(host_port_pair))
+    return true;
+  return http_server_properties.HasAlternateProtocol(host_port_pair) &&
+      http_server_properties.GetAlternateProtocol(host_port_pair).protocol ==
+          net::QUIC;
+}
+
+}  // namespace
 
 // A thin wrapper around net::PriorityQueue that deals with
 // ScheduledResourceRequests instead of PriorityQueue::Pointers.
@@ -47,7 +84,17 @@ class ResourceScheduler::RequestQueue {
 
   // Returns the highest priority request that's queued, or NULL if none are.
   ScheduledResourceRequest* FirstMax() {
-    return queue_.FirstMax().value();
+    NetQueue::Pointer pointer = queue_.FirstMax();
+    return pointer.is_null() ? NULL : pointer.value();
+  }
+
+  // Returns the request that follows |request| in priority order, or NULL if
+  // |request| is the last one.
+  ScheduledResourceRequest* GetNextHighest(ScheduledResourceRequest* request) {
+    PointerMap::iterator it = pointers_.find(request);
+    DCHECK(it != pointers_.end());
+    NetQueue::Pointer pointer = queue_.GetNextTowardsLastMin(it->second);
+    return pointer.is_null() ? NULL : pointer.value();
   }
 
   // Returns true if |request| is queued.
@@ -80,6 +127,7 @@ class ResourceScheduler::ScheduledResourceRequest
         request_(request),
         ready_(false),
         deferred_(false),
+        measured_(false),
         scheduler_(scheduler) {
   }
 
@@ -99,6 +147,15 @@ class ResourceScheduler::ScheduledResourceRequest
   net::URLRequest* url_request() { return request_; }
   const net::URLRequest* url_request() const { return request_; }
 
+  // Whether the request counts towards the throughput of its client, and when
+  // it started.
+  bool measured() const { return measured_; }
+  base::TimeTicks start_time() const { return start_time_; }
+  void set_measured(base::TimeTicks start_time) {
+    measured_ = true;
+    start_time_ = start_time;
+  }
+
  private:
   // ResourceMessageDelegate interface:
   virtual bool OnMessageReceived(const IPC::Message& message,
@@ -124,22 +181,66 @@ class ResourceScheduler::ScheduledResourceRequest
   net::URLRequest* request_;
   bool ready_;
   bool deferred_;
+  bool measured_;
+  base::TimeTicks start_time_;
   ResourceScheduler* scheduler_;
 
   DISALLOW_COPY_AND_ASSIGN(ScheduledResourceRequest);
 };
 
 // Each client represents a tab.
+//
+// The throughput of a client is estimated from its delayable requests to
+// HTTP/1.1 origins, the "measured" requests. Bytes are only known once a
+// request finishes, so rather than dividing the bytes received by the elapsed
+// time, which is noisy when requests finish in bursts, the estimate is the
+// average rate of the finished requests times the average number of measured
+// requests in flight.
 struct ResourceScheduler::Client {
-  Client() : has_body(false) {}
+  Client()
+      : has_body(false),
+        max_delayable_requests(kMinNumDelayableRequestsPerClient),
+        num_measured_requests_in_flight(0),
+        request_seconds_in_flight(0),
+        busy_seconds(0),
+        num_finished_requests(0),
+        finished_bytes(0),
+        finished_request_seconds(0),
+        limit_reached(false),
+        last_throughput(0),
+        last_limit_change(0),
+        probe_failed(false) {}
   ~Client() {}
 
   bool has_body;
   RequestQueue pending_requests;
   RequestSet in_flight_requests;
+
+  // The current limit on delayable requests in flight.
+  size_t max_delayable_requests;
+
+  // Statistics of the current throughput sample.
+  size_t num_measured_requests_in_flight;
+  base::TimeTicks last_update;
+  double request_seconds_in_flight;
+  double busy_seconds;
+  int num_finished_requests;
+  int64 finished_bytes;
+  double finished_request_seconds;
+  bool limit_reached;
+
+  // The throughput of the previous sample in bytes per second, and the change
+  // it made to |max_delayable_requests|: -1, 0 or 1 steps.
+  double last_throughput;
+  int last_limit_change;
+
+  // True if raising the limit did not improve the throughput, in which case
+  // the limit stays put until the throughput changes.
+  bool probe_failed;
 };
 
-ResourceScheduler::ResourceScheduler() {
+ResourceScheduler::ResourceScheduler()
+    : tick_clock_(new base::DefaultTickClock()) {
 }
 
 ResourceScheduler::~ResourceScheduler() {
@@ -168,7 +269,7 @@ scoped_ptr<ResourceThrottle> ResourceScheduler::ScheduleRequest(
   }
 
   Client* client = it->second;
-  if (ShouldStartRequest(request.get(), client)) {
+  if (ShouldStartRequest(request.get(), client) == START_REQUEST) {
     StartRequest(request.get(), client);
   } else {
     client->pending_requests.Insert(request.get(), url_request->priority());
@@ -197,6 +298,9 @@ void ResourceScheduler::RemoveRequest(ScheduledResourceRequest* request) {
     size_t erased = client->in_flight_requests.erase(request);
     DCHECK(erased);
 
+    if (request->measured())
+      OnMeasuredRequestFinished(request, client);
+
     // Removing this request may have freed up another to load.
     LoadAnyStartablePendingRequests(client);
   }
@@ -262,12 +366,115 @@ void ResourceScheduler::OnWillInsertBody(int child_id, int route_id) {
   }
 }
 
+void ResourceScheduler::SetTickClockForTesting(
+    scoped_ptr<base::TickClock> tick_clock) {
+  tick_clock_ = tick_clock.Pass();
+}
+
 void ResourceScheduler::StartRequest(ScheduledResourceRequest* request,
                                      Client* client) {
   client->in_flight_requests.insert(request);
+
+  const net::URLRequest& url_request = *request->url_request();
+  if (url_request.priority() < net::LOW && !OriginIsMultiplexed(url_request)) {
+    UpdateConcurrency(client);
+    request->set_measured(client->last_update);
+    ++client->num_measured_requests_in_flight;
+    if (client->num_measured_requests_in_flight >=
+        client->max_delayable_requests) {
+      client->limit_reached = true;
+    }
+  }
+
   request->Start();
 }
 
+void ResourceScheduler::UpdateConcurrency(Client* client) {
+  base::TimeTicks now = tick_clock_->NowTicks();
+  if (client->num_measured_requests_in_flight > 0) {
+    double seconds = (now - client->last_update).InSecondsF();
+    client->request_seconds_in_flight +=
+        seconds * client->num_measured_requests_in_flight;
+    client->busy_seconds += seconds;
+  }
+  client->last_update = now;
+}
+
+void ResourceScheduler::OnMeasuredRequestFinished(
+    ScheduledResourceRequest* request,
+    Client* client) {
+  UpdateConcurrency(client);
+  DCHECK_GT(client->num_measured_requests_in_flight, 0u);
+  --client->num_measured_requests_in_flight;
+
+  // Requests that were canceled, or served without touching the network,
+  // say nothing about the throughput.
+  int64 bytes = request->url_request()->received_response_content_length();
+  double seconds = (client->last_update - request->start_time()).InSecondsF();
+  if (bytes <= 0 || seconds <= 0)
+    return;
+
+  client->finished_bytes += bytes;
+  client->finished_request_seconds += seconds;
+  // Requests that finish together with the ones that closed the previous
+  // sample carry over to the next one.
+  if (++client->num_finished_requests < kNumRequestsPerThroughputSample ||
+      client->busy_seconds <= 0) {
+    return;
+  }
+
+  double average_concurrency =
+      client->request_seconds_in_flight / client->busy_seconds;
+  double throughput = average_concurrency * client->finished_bytes /
+      client->finished_request_seconds;
+
+  // Hill climbing: raise the limit while that helps the throughput, and lower
+  // it when the throughput drops.
+  int limit_change = 0;
+  if (client->last_throughput > 0) {
+    double ratio = throughput / client->last_throughput;
+    if (ratio < 1 - kThroughputChangeThreshold) {
+      limit_change = -1;
+      client->probe_failed = false;
+    } else if (ratio > 1 + kThroughputChangeThreshold) {
+      if (client->last_limit_change >= 0 && client->limit_reached)
+        limit_change = 1;
+      client->probe_failed = false;
+    } else if (client->last_limit_change > 0) {
+      // The last raise did not pay off; take it back.
+      limit_change = -1;
+      client->probe_failed = true;
+    } else if (!client->probe_failed && client->limit_reached) {
+      limit_change = 1;
+    }
+  }
+
+  if (limit_change > 0 &&
+      client->max_delayable_requests < kMaxNumDelayableRequestsPerClient) {
+    client->max_delayable_requests = std::min(
+        client->max_delayable_requests + kDelayableRequestsLimitStep,
+        kMaxNumDelayableRequestsPerClient);
+  } else if (limit_change < 0 &&
+             client->max_delayable_requests >
+                 kMinNumDelayableRequestsPerClient) {
+    client->max_delayable_requests = std::max(
+        client->max_delayable_requests - kDelayableRequestsLimitStep,
+        kMinNumDelayableRequestsPerClient);
+  } else {
+    limit_change = 0;
+  }
+
+  client->last_throughput = throughput;
+  client->last_limit_change = limit_change;
+  client->request_seconds_in_flight = 0;
+  client->busy_seconds = 0;
+  client->num_finished_requests = 0;
+  client->finished_bytes = 0;
+  client->finished_request_seconds = 0;
+  client->limit_reached =
+      client->num_measured_requests_in_flight >= client->max_delayable_requests;
+}
+
 void ResourceScheduler::ReprioritizeRequest(ScheduledResourceRequest* request,
                                             net::RequestPriority new_priority) {
   net::RequestPriority old_priority = request->url_request()->priority();
@@ -296,32 +503,46 @@ void ResourceScheduler::ReprioritizeRequest(ScheduledResourceRequest* request,
 }
 
 void ResourceScheduler::LoadAnyStartablePendingRequests(Client* client) {
-  while (!client->pending_requests.IsEmpty()) {
-    ScheduledResourceRequest* request = client->pending_requests.FirstMax();
-    if (ShouldStartRequest(request, client)) {
+  // Requests that are blocked by the limit for their host are skipped, so
+  // that they don't hold up requests to other hosts.
+  ScheduledResourceRequest* request = client->pending_requests.FirstMax();
+  while (request) {
+    ShouldStartReqResult result = ShouldStartRequest(request, client);
+    if (result == START_REQUEST) {
       client->pending_requests.Erase(request);
       StartRequest(request, client);
+      // Starting the request may have canceled others, so start over.
+      request = client->pending_requests.FirstMax();
+    } else if (result == DO_NOT_START_REQUEST_AND_KEEP_SEARCHING) {
+      request = client->pending_requests.GetNextHighest(request);
     } else {
+      DCHECK_EQ(DO_NOT_START_REQUEST_AND_STOP_SEARCHING, result);
       break;
     }
   }
 }
 
-size_t ResourceScheduler::GetNumDelayableRequestsInFlight(
-    Client* client) const {
+void ResourceScheduler::GetNumDelayableRequestsInFlight(
+    Client* client,
+    const net::HostPortPair& active_request_host,
+    size_t* total_delayable,
+    size_t* total_for_active_host) const {
   size_t count = 0;
+  size_t count_for_host = 0;
   for (RequestSet::iterator it = client->in_flight_requests.begin();
        it != client->in_flight_requests.end(); ++it) {
-    if ((*it)->url_request()->priority() < net::LOW) {
-      const net::HttpServerProperties& http_server_properties =
-          *(*it)->url_request()->context()->http_server_properties();
-      if (!http_server_properties.SupportsSpdy(
-          net::HostPortPair::FromURL((*it)->url_request()->url()))) {
-        ++count;
+    const net::URLRequest& url_request = *(*it)->url_request();
+    if (url_request.priority() < net::LOW &&
+        !OriginIsMultiplexed(url_request)) {
+      ++count;
+      if (active_request_host.Equals(
+              net::HostPortPair::FromURL(url_request.url()))) {
+        ++count_for_host;
       }
     }
   }
-  return count;
+  *total_delayable = count;
+  *total_for_active_host = count_for_host;
 }
 
 // ShouldStartRequest is the main scheduling algorithm.
@@ -332,47 +553,51 @@ size_t ResourceScheduler::GetNumDelayableRequestsInFlight(
 //
 //   * Higher priority requests (>= net::LOW).
 //   * Synchronous requests.
-//   * Requests to SPDY-capable origin servers.
+//   * Requests to origin servers that multiplex requests over SPDY or QUIC,
+//     which prioritize them within the session.
 //
 // 2. The remainder are delayable requests, which follow these rules:
 //
 //   * If no high priority requests are in flight, start loading low priority
 //     requests.
 //   * Once the renderer has a <body>, start loading delayable requests.
-//   * Never exceed 10 delayable requests in flight per client.
+//   * Never exceed 6 delayable requests in flight per host, the number of
+//     connections per host. Requests to other hosts may start meanwhile.
+//   * Never exceed the client's limit on delayable requests in flight. It
+//     starts at 10, and follows the throughput of the client, up to 30.
 //   * Prior to <body>, allow one delayable request to load at a time.
-bool ResourceScheduler::ShouldStartRequest(ScheduledResourceRequest* request,
-                                           Client* client) const {
+ResourceScheduler::ShouldStartReqResult ResourceScheduler::ShouldStartRequest(
+    ScheduledResourceRequest* request,
+    Client* client) const {
   const net::URLRequest& url_request = *request->url_request();
-  const net::HttpServerProperties& http_server_properties =
-      *url_request.context()->http_server_properties();
 
   // TODO(willchan): We should really improve this algorithm as described in
-  // crbug.com/164101. Also, theoretically we should not count a SPDY request
-  // against the delayable requests limit.
-  bool origin_supports_spdy = http_server_properties.SupportsSpdy(
-      net::HostPortPair::FromURL(url_request.url()));
-
+  // crbug.com/164101.
   if (url_request.priority() >= net::LOW ||
       !ResourceRequestInfo::ForRequest(&url_request)->IsAsync() ||
-      origin_supports_spdy) {
-    return true;
+      OriginIsMultiplexed(url_request)) {
+    return START_REQUEST;
   }
 
-  size_t num_delayable_requests_in_flight =
-      GetNumDelayableRequestsInFlight(client);
-  if (num_delayable_requests_in_flight >= kMaxNumDelayableRequestsPerClient) {
-    return false;
-  }
+  size_t num_delayable_requests_in_flight = 0;
+  size_t num_requests_in_flight_for_host = 0;
+  GetNumDelayableRequestsInFlight(
+      client, net::HostPortPair::FromURL(url_request.url()),
+      &num_delayable_requests_in_flight, &num_requests_in_flight_for_host);
+  if (num_delayable_requests_in_flight >= client->max_delayable_requests)
+    return DO_NOT_START_REQUEST_AND_STOP_SEARCHING;
+
+  if (num_requests_in_flight_for_host >= kMaxNumDelayableRequestsPerHost)
+    return DO_NOT_START_REQUEST_AND_KEEP_SEARCHING;
 
   bool have_immediate_requests_in_flight =
       client->in_flight_requests.size() > num_delayable_requests_in_flight;
   if (have_immediate_requests_in_flight && !client->has_body &&
       num_delayable_requests_in_flight != 0) {
-    return false;
+    return DO_NOT_START_REQUEST_AND_STOP_SEARCHING;
   }
 
-  return true;
+  return START_REQUEST;
 }
 
 ResourceScheduler::ClientId ResourceScheduler::MakeClientId(
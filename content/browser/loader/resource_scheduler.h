@@ -16,7 +16,12 @@
 #include "net/base/priority_queue.h"
 #include "net/base/request_priority.h"
 
+namespace base {
+class TickClock;
+}
+
 namespace net {
+class HostPortPair;
 class URLRequest;
 }
 
@@ -77,6 +82,9 @@ class CONTENT_EXPORT ResourceScheduler : public base::NonThreadSafe {
   // resource loads won't interfere with first paint.
   void OnWillInsertBody(int child_id, int route_id);
 
+  // Replaces the clock used to measure throughput.
+  void SetTickClockForTesting(scoped_ptr<base::TickClock> tick_clock);
+
  private:
   class RequestQueue;
   class ScheduledResourceRequest;
@@ -86,9 +94,26 @@ class CONTENT_EXPORT ResourceScheduler : public base::NonThreadSafe {
   typedef std::map<ClientId, Client*> ClientMap;
   typedef std::set<ScheduledResourceRequest*> RequestSet;
 
+  enum ShouldStartReqResult {
+    DO_NOT_START_REQUEST_AND_STOP_SEARCHING,
+    DO_NOT_START_REQUEST_AND_KEEP_SEARCHING,
+    START_REQUEST,
+  };
+
   // Called when a ScheduledResourceRequest is destroyed.
   void RemoveRequest(ScheduledResourceRequest* request);
 
+  // Adds the time since the last update, weighted by the number of measured
+  // requests in flight, to the throughput statistics of |client|.
+  void UpdateConcurrency(Client* client);
+
+  // Called when a request that counts towards the throughput of |client|
+  // finishes. Once enough requests have finished, compares their throughput
+  // with that of the previous sample, and adjusts the limit on delayable
+  // requests of |client|.
+  void OnMeasuredRequestFinished(ScheduledResourceRequest* request,
+                                 Client* client);
+
   // Unthrottles the |request| and adds it to |client|.
   void StartRequest(ScheduledResourceRequest* request, Client* client);
 
@@ -105,20 +130,25 @@ class CONTENT_EXPORT ResourceScheduler : public base::NonThreadSafe {
   // results of ShouldStartRequest().
   void LoadAnyStartablePendingRequests(Client* client);
 
-  // Returns the number of requests with priority < LOW that are currently in
-  // flight.
-  size_t GetNumDelayableRequestsInFlight(Client* client) const;
+  // Returns the number of requests with priority < LOW to HTTP/1.1 origins
+  // that are currently in flight, in total and to |active_request_host|.
+  void GetNumDelayableRequestsInFlight(
+      Client* client,
+      const net::HostPortPair& active_request_host,
+      size_t* total_delayable,
+      size_t* total_for_active_host) const;
 
-  // Returns true if the request should start. This is the core scheduling
+  // Returns whether the request should start. This is the core scheduling
   // algorithm.
-  bool ShouldStartRequest(ScheduledResourceRequest* request,
-                          Client* client) const;
+  ShouldStartReqResult ShouldStartRequest(ScheduledResourceRequest* request,
+                                          Client* client) const;
 
   // Returns the client ID for the given |child_id| and |route_id| combo.
   ClientId MakeClientId(int child_id, int route_id);
 
   ClientMap client_map_;
   RequestSet unowned_requests_;
+  scoped_ptr<base::TickClock> tick_clock_;
 };
 
 }  // namespace content
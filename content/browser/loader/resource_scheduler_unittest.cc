@@ -4,9 +4,13 @@
 
 #include "content/browser/loader/resource_scheduler.h"
 
+#include <vector>
+
 #include "base/memory/scoped_vector.h"
 #include "base/message_loop/message_loop.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/simple_test_tick_clock.h"
 #include "content/browser/browser_thread_impl.h"
 #include "content/browser/loader/resource_dispatcher_host_impl.h"
 #include "content/browser/loader/resource_message_filter.h"
@@ -50,6 +54,7 @@ class TestRequest : public ResourceController {
     started_ = !deferred;
   }
 
+  net::URLRequest* url_request() { return url_request_.get(); }
   const net::URLRequest* url_request() const { return url_request_.get(); }
 
  protected:
@@ -126,7 +131,10 @@ class ResourceSchedulerTest : public testing::Test {
       : next_request_id_(0),
         message_loop_(base::MessageLoop::TYPE_IO),
         ui_thread_(BrowserThread::UI, &message_loop_),
-        io_thread_(BrowserThread::IO, &message_loop_) {
+        io_thread_(BrowserThread::IO, &message_loop_),
+        tick_clock_(new base::SimpleTestTickClock()) {
+    scheduler_.SetTickClockForTesting(
+        scoped_ptr<base::TickClock>(tick_clock_));
     scheduler_.OnClientCreated(kChildId, kRouteId);
     context_.set_http_server_properties(http_server_properties_.GetWeakPtr());
   }
@@ -200,11 +208,87 @@ class ResourceSchedulerTest : public testing::Test {
     EXPECT_TRUE(ok);
   }
 
+  // Simulates loading |num_resources| of |bytes_per_resource| each, spread
+  // over |num_hosts| HTTP/1.1 hosts, over a link with the given round trip
+  // time and bandwidth. Each request waits one round trip for its response,
+  // and then shares the bandwidth with the other requests that are receiving
+  // data. Returns the time it takes to load all of the resources.
+  base::TimeDelta SimulatePageLoad(int num_resources,
+                                   int num_hosts,
+                                   int64 bytes_per_resource,
+                                   base::TimeDelta round_trip_time,
+                                   int64 bytes_per_second) {
+    const base::TimeDelta kTick = base::TimeDelta::FromMilliseconds(10);
+    const base::TimeTicks load_start = tick_clock_->NowTicks();
+
+    scheduler_.OnWillInsertBody(kChildId, kRouteId);
+    std::vector<TestRequest*> requests;
+    std::vector<base::TimeTicks> response_starts(num_resources);
+    std::vector<int64> bytes_left(num_resources, bytes_per_resource);
+    for (int i = 0; i < num_resources; ++i) {
+      std::string url = base::StringPrintf("http://host%d/%d",
+                                           i % num_hosts, i);
+      requests.push_back(NewRequest(url.c_str(), net::LOWEST));
+    }
+
+    int num_loaded = 0;
+    while (num_loaded < num_resources) {
+      base::TimeTicks now = tick_clock_->NowTicks();
+      int num_receiving = 0;
+      for (int i = 0; i < num_resources; ++i) {
+        if (!requests[i] || !requests[i]->started())
+          continue;
+        if (response_starts[i].is_null())
+          response_starts[i] = now + round_trip_time;
+        else if (response_starts[i] <= now)
+          ++num_receiving;
+      }
+
+      tick_clock_->Advance(kTick);
+      if (num_receiving == 0)
+        continue;
+
+      int64 bytes_per_request =
+          bytes_per_second * kTick.InMilliseconds() / 1000 / num_receiving;
+      for (int i = 0; i < num_resources; ++i) {
+        if (!requests[i] || response_starts[i].is_null() ||
+            response_starts[i] > now) {
+          continue;
+        }
+        bytes_left[i] -= bytes_per_request;
+        if (bytes_left[i] > 0)
+          continue;
+        requests[i]->url_request()->set_received_response_content_length(
+            bytes_per_resource);
+        // Finishing a request may start others.
+        delete requests[i];
+        requests[i] = NULL;
+        ++num_loaded;
+      }
+    }
+    return tick_clock_->NowTicks() - load_start;
+  }
+
+  // Returns how many of a burst of delayable requests to different hosts
+  // start right away.
+  int NumDelayableRequestsStarted() {
+    ScopedVector<TestRequest> lows;
+    int num_started = 0;
+    for (int i = 0; i < 40; ++i) {
+      std::string url = base::StringPrintf("http://burst%d/low", i);
+      lows.push_back(NewRequest(url.c_str(), net::LOWEST));
+      if (lows.back()->started())
+        ++num_started;
+    }
+    return num_started;
+  }
+
   int next_request_id_;
   base::MessageLoop message_loop_;
   BrowserThreadImpl ui_thread_;
   BrowserThreadImpl io_thread_;
   ResourceDispatcherHostImpl rdh_;
+  base::SimpleTestTickClock* tick_clock_;  // Owned by |scheduler_|.
   ResourceScheduler scheduler_;
   net::HttpServerPropertiesImpl http_server_properties_;
   net::TestURLRequestContext context_;
@@ -253,6 +337,22 @@ TEST_F(ResourceSchedulerTest, OneLowLoadsUntilBodyInsertedExceptSpdy) {
   EXPECT_TRUE(low2->started());
 }
 
+TEST_F(ResourceSchedulerTest, OneLowLoadsUntilBodyInsertedExceptQuic) {
+  http_server_properties_.SetAlternateProtocol(
+      net::HostPortPair("quichost", 80), 443, net::QUIC);
+  scoped_ptr<TestRequest> high(NewRequest("http://host/high", net::HIGHEST));
+  scoped_ptr<TestRequest> low_quic(
+      NewRequest("http://quichost/low", net::LOWEST));
+  scoped_ptr<TestRequest> low(NewRequest("http://host/low", net::LOWEST));
+  scoped_ptr<TestRequest> low2(NewRequest("http://host/low", net::LOWEST));
+  EXPECT_TRUE(high->started());
+  EXPECT_TRUE(low_quic->started());
+  EXPECT_TRUE(low->started());
+  EXPECT_FALSE(low2->started());
+  scheduler_.OnWillInsertBody(kChildId, kRouteId);
+  EXPECT_TRUE(low2->started());
+}
+
 TEST_F(ResourceSchedulerTest, NavigationResetsState) {
   scheduler_.OnWillInsertBody(kChildId, kRouteId);
   scheduler_.OnNavigate(kChildId, kRouteId);
@@ -318,10 +418,10 @@ TEST_F(ResourceSchedulerTest, LimitedNumberOfDelayableRequestsInFlight) {
   scoped_ptr<TestRequest> high(NewRequest("http://host/high", net::HIGHEST));
   EXPECT_TRUE(high->started());
 
-  const int kMaxNumDelayableRequestsPerClient = 10;  // Should match the .cc.
+  const int kMinNumDelayableRequestsPerClient = 10;  // Should match the .cc.
   ScopedVector<TestRequest> lows;
-  for (int i = 0; i < kMaxNumDelayableRequestsPerClient; ++i) {
-    string url = "http://host/low" + base::IntToString(i);
+  for (int i = 0; i < kMinNumDelayableRequestsPerClient; ++i) {
+    string url = "http://host" + base::IntToString(i) + "/low";
     lows.push_back(NewRequest(url.c_str(), net::LOWEST));
     EXPECT_TRUE(lows[i]->started());
   }
@@ -334,6 +434,34 @@ TEST_F(ResourceSchedulerTest, LimitedNumberOfDelayableRequestsInFlight) {
   EXPECT_TRUE(last->started());
 }
 
+TEST_F(ResourceSchedulerTest, LimitedNumberOfDelayableRequestsPerHost) {
+  // Dummy to enforce scheduling.
+  scoped_ptr<TestRequest> high(NewRequest("http://host/high", net::HIGHEST));
+
+  const int kMaxNumDelayableRequestsPerHost = 6;  // Should match the .cc.
+  ScopedVector<TestRequest> lows;
+  for (int i = 0; i < kMaxNumDelayableRequestsPerHost; ++i) {
+    string url = "http://host/low" + base::IntToString(i);
+    lows.push_back(NewRequest(url.c_str(), net::LOWEST));
+  }
+  scoped_ptr<TestRequest> last_same_host(
+      NewRequest("http://host/last", net::LOWEST));
+  scoped_ptr<TestRequest> other_host(
+      NewRequest("http://otherhost/low", net::LOWEST));
+  EXPECT_FALSE(last_same_host->started());
+  EXPECT_FALSE(other_host->started());
+
+  scheduler_.OnWillInsertBody(kChildId, kRouteId);
+  for (int i = 0; i < kMaxNumDelayableRequestsPerHost; ++i)
+    EXPECT_TRUE(lows[i]->started());
+  EXPECT_FALSE(last_same_host->started());
+  // The request queued for the busy host doesn't hold up the other one.
+  EXPECT_TRUE(other_host->started());
+
+  lows.erase(lows.begin());
+  EXPECT_TRUE(last_same_host->started());
+}
+
 TEST_F(ResourceSchedulerTest, RaisePriorityAndStart) {
   // Dummies to enforce scheduling.
   scoped_ptr<TestRequest> high(NewRequest("http://host/high", net::HIGHEST));
@@ -360,10 +488,10 @@ TEST_F(ResourceSchedulerTest, RaisePriorityInQueue) {
   EXPECT_FALSE(request->started());
   EXPECT_FALSE(idle->started());
 
-  const int kMaxNumDelayableRequestsPerClient = 10;  // Should match the .cc.
+  const int kMinNumDelayableRequestsPerClient = 10;  // Should match the .cc.
   ScopedVector<TestRequest> lows;
-  for (int i = 0; i < kMaxNumDelayableRequestsPerClient - 1; ++i) {
-    string url = "http://host/low" + base::IntToString(i);
+  for (int i = 0; i < kMinNumDelayableRequestsPerClient - 1; ++i) {
+    string url = "http://host" + base::IntToString(i) + "/low";
     lows.push_back(NewRequest(url.c_str(), net::LOWEST));
   }
 
@@ -386,13 +514,13 @@ TEST_F(ResourceSchedulerTest, LowerPriority) {
   EXPECT_FALSE(request->started());
   EXPECT_FALSE(idle->started());
 
-  const int kMaxNumDelayableRequestsPerClient = 10;  // Should match the .cc.
+  const int kMinNumDelayableRequestsPerClient = 10;  // Should match the .cc.
   // 2 fewer filler requests: 1 for the "low" dummy at the start, and 1 for the
   // one at the end, which will be tested.
-  const int kNumFillerRequests = kMaxNumDelayableRequestsPerClient - 2;
+  const int kNumFillerRequests = kMinNumDelayableRequestsPerClient - 2;
   ScopedVector<TestRequest> lows;
   for (int i = 0; i < kNumFillerRequests; ++i) {
-    string url = "http://host/low" + base::IntToString(i);
+    string url = "http://host" + base::IntToString(i) + "/low";
     lows.push_back(NewRequest(url.c_str(), net::LOWEST));
   }
 
@@ -411,10 +539,10 @@ TEST_F(ResourceSchedulerTest, ReprioritizedRequestGoesToBackOfQueue) {
   EXPECT_FALSE(request->started());
   EXPECT_FALSE(idle->started());
 
-  const int kMaxNumDelayableRequestsPerClient = 10;  // Should match the .cc.
+  const int kMinNumDelayableRequestsPerClient = 10;  // Should match the .cc.
   ScopedVector<TestRequest> lows;
-  for (int i = 0; i < kMaxNumDelayableRequestsPerClient; ++i) {
-    string url = "http://host/low" + base::IntToString(i);
+  for (int i = 0; i < kMinNumDelayableRequestsPerClient; ++i) {
+    string url = "http://host" + base::IntToString(i) + "/low";
     lows.push_back(NewRequest(url.c_str(), net::LOWEST));
   }
 
@@ -431,6 +559,25 @@ TEST_F(ResourceSchedulerTest, ReprioritizedRequestGoesToBackOfQueue) {
   EXPECT_FALSE(idle->started());
 }
 
+// When the round trip time limits the throughput, the scheduler lets more
+// delayable requests into flight. With at most 10 in flight, 120 requests
+// would take at least 12 round trips.
+TEST_F(ResourceSchedulerTest, SimulatedPageLoadOnHighLatencyLink) {
+  const base::TimeDelta kRoundTripTime = base::TimeDelta::FromMilliseconds(200);
+  base::TimeDelta load_time = SimulatePageLoad(
+      120, 6, 10 * 1024, kRoundTripTime, 40 * 1024 * 1024);
+  EXPECT_LT(load_time, kRoundTripTime * 12);
+  EXPECT_GT(NumDelayableRequestsStarted(), 10);
+}
+
+// When the bandwidth limits the throughput, more requests in flight don't
+// help, and the scheduler sticks to its initial limit.
+TEST_F(ResourceSchedulerTest, SimulatedPageLoadOnLowBandwidthLink) {
+  SimulatePageLoad(120, 6, 10 * 1024, base::TimeDelta::FromMilliseconds(200),
+                   200 * 1024);
+  EXPECT_EQ(10, NumDelayableRequestsStarted());
+}
+
 }  // unnamed namespace
 
 }  // namespace content
@@ -4,6 +4,8 @@
 
 #include "content/browser/net/sqlite_persistent_cookie_store.h"
 
+#include <algorithm>
+#include <deque>
 #include <list>
 #include <map>
 #include <set>
@@ -51,7 +53,9 @@ namespace content {
 // delegates to Backend::Load, which posts a Backend::LoadAndNotifyOnDBThread
 // task to the background runner.  This task calls Backend::ChainLoadCookies(),
 // which repeatedly posts itself to the BG runner to load each eTLD+1's cookies
-// in separate tasks.  When this is complete, Backend::CompleteLoadOnIOThread is
+// in separate tasks, most recently accessed eTLD+1 first. An eTLD+1 with many
+// cookies is split over several tasks, so that a priority load never waits
+// long behind one.  When this is complete, Backend::CompleteLoadOnIOThread is
 // posted to the client runner, which notifies the caller of
 // SQLitePersistentCookieStore::Load that the load is complete.
 //
@@ -86,7 +90,8 @@ class SQLitePersistentCookieStore::Backend
         client_task_runner_(client_task_runner),
         background_task_runner_(background_task_runner),
         num_priority_waiting_(0),
-        total_priority_requests_(0) {}
+        total_priority_requests_(0),
+        first_priority_load_done_(false) {}
 
   // Creates or loads the SQLite database.
   void Load(const LoadedCallback& loaded_callback);
@@ -166,8 +171,11 @@ class SQLitePersistentCookieStore::Backend
                                 bool load_success);
 
   // Sends notification when a single priority load completes. Updates priority
-  // load metric data. The data is sent only after the final load completes.
+  // load metric data. The data is sent only after the final load completes,
+  // except for the blocking time of the first priority load, which was
+  // requested at |requested_at|.
   void CompleteLoadForKeyInForeground(const LoadedCallback& loaded_callback,
+                                      const base::Time& requested_at,
                                       bool load_success);
 
   // Sends all metrics, including posting a ReportMetricsInBackground task.
@@ -229,6 +237,13 @@ class SQLitePersistentCookieStore::Backend
   // Map of domain keys(eTLD+1) to domains/hosts that are to be loaded from DB.
   std::map<std::string, std::set<std::string> > keys_to_load_;
 
+  // The order in which ChainLoadCookies() loads |keys_to_load_|, most recently
+  // accessed first. Keys loaded by priority loads are skipped.
+  std::deque<std::string> key_load_order_;
+
+  // Number of cookies in the DB for each domain/host in |keys_to_load_|.
+  std::map<std::string, int> cookies_per_domain_;
+
   // Map of (domain keys(eTLD+1), is secure cookie) to number of cookies in the
   // database.
   typedef std::pair<std::string, bool> CookieOrigin;
@@ -269,6 +284,9 @@ class SQLitePersistentCookieStore::Backend
   // The cumulative duration of time when |num_priority_waiting_| was greater
   // than 1.
   base::TimeDelta priority_wait_duration_;
+  // Whether the first priority load, which blocks the first request, has been
+  // reported.
+  bool first_priority_load_done_;
 
   DISALLOW_COPY_AND_ASSIGN(Backend);
 };
@@ -296,6 +314,10 @@ namespace {
 const int kCurrentVersionNumber = 6;
 const int kCompatibleVersionNumber = 5;
 
+// The number of cookies ChainLoadCookies() loads in one task, unless a single
+// domain has more.
+const int kMaxCookiesPerChainLoad = 200;
+
 // Possible values for the 'priority' column.
 enum DBCookiePriority {
   kCookiePriorityLow = 0,
@@ -460,11 +482,12 @@ void SQLitePersistentCookieStore::Backend::LoadKeyAndNotifyInBackground(
 
   PostClientTask(FROM_HERE, base::Bind(
       &SQLitePersistentCookieStore::Backend::CompleteLoadForKeyInForeground,
-      this, loaded_callback, success));
+      this, loaded_callback, posted_at, success));
 }
 
 void SQLitePersistentCookieStore::Backend::CompleteLoadForKeyInForeground(
     const LoadedCallback& loaded_callback,
+    const base::Time& requested_at,
     bool load_success) {
   DCHECK(client_task_runner_->RunsTasksOnCurrentThread());
 
@@ -477,8 +500,16 @@ void SQLitePersistentCookieStore::Backend::CompleteLoadForKeyInForeground(
       priority_wait_duration_ +=
           base::Time::Now() - current_priority_wait_start_;
     }
+    if (!first_priority_load_done_) {
+      first_priority_load_done_ = true;
+      UMA_HISTOGRAM_CUSTOM_TIMES(
+          "Cookie.FirstPriorityLoadBlockingTime",
+          base::Time::Now() - requested_at,
+          base::TimeDelta::FromMilliseconds(1),
+          base::TimeDelta::FromMinutes(1),
+          50);
+    }
   }
-
 }
 
 void SQLitePersistentCookieStore::Backend::ReportMetricsInBackground() {
@@ -587,9 +618,11 @@ bool SQLitePersistentCookieStore::Backend::InitializeDatabase() {
 
   start = base::Time::Now();
 
-  // Retrieve all the domains
+  // Retrieve all the domains, with their number of cookies and the time any
+  // of them was last accessed.
   sql::Statement smt(db_->GetUniqueStatement(
-    "SELECT DISTINCT host_key FROM cookies"));
+    "SELECT host_key, COUNT(*), MAX(last_access_utc) FROM cookies "
+    "GROUP BY host_key"));
 
   if (!smt.is_valid()) {
     if (corruption_detected_)
@@ -600,8 +633,12 @@ bool SQLitePersistentCookieStore::Backend::InitializeDatabase() {
   }
 
   std::vector<std::string> host_keys;
-  while (smt.Step())
+  std::vector<int64> host_last_access;
+  while (smt.Step()) {
     host_keys.push_back(smt.ColumnString(0));
+    cookies_per_domain_[host_keys.back()] = smt.ColumnInt(1);
+    host_last_access.push_back(smt.ColumnInt64(2));
+  }
 
   UMA_HISTOGRAM_CUSTOM_TIMES(
       "Cookie.TimeLoadDomains",
@@ -612,6 +649,7 @@ bool SQLitePersistentCookieStore::Backend::InitializeDatabase() {
   base::Time start_parse = base::Time::Now();
 
   // Build a map of domain keys (always eTLD+1) to domains.
+  std::map<std::string, int64> key_last_access;
   for (size_t idx = 0; idx < host_keys.size(); ++idx) {
     const std::string& domain = host_keys[idx];
     std::string key =
@@ -620,7 +658,20 @@ bool SQLitePersistentCookieStore::Backend::InitializeDatabase() {
             net::registry_controlled_domains::EXCLUDE_PRIVATE_REGISTRIES);
 
     keys_to_load_[key].insert(domain);
+    int64& last_access = key_last_access[key];
+    last_access = std::max(last_access, host_last_access[idx]);
+  }
+
+  // The keys the user visited most recently are the most likely to be needed
+  // by the first requests, so load them first.
+  std::vector<std::pair<int64, std::string> > keys_by_last_access;
+  for (std::map<std::string, int64>::const_iterator it =
+           key_last_access.begin(); it != key_last_access.end(); ++it) {
+    keys_by_last_access.push_back(std::make_pair(it->second, it->first));
   }
+  std::sort(keys_by_last_access.begin(), keys_by_last_access.end());
+  for (size_t idx = keys_by_last_access.size(); idx > 0; --idx)
+    key_load_order_.push_back(keys_by_last_access[idx - 1].second);
 
   UMA_HISTOGRAM_CUSTOM_TIMES(
       "Cookie.TimeParseDomains",
@@ -645,15 +696,41 @@ void SQLitePersistentCookieStore::Backend::ChainLoadCookies(
 
   bool load_success = true;
 
+  // Skip keys that priority loads have already loaded.
+  while (!key_load_order_.empty() &&
+         keys_to_load_.find(key_load_order_.front()) == keys_to_load_.end()) {
+    key_load_order_.pop_front();
+  }
+
   if (!db_) {
     // Close() has been called on this store.
     load_success = false;
-  } else if (keys_to_load_.size() > 0) {
-    // Load cookies for the first domain key.
+  } else if (!key_load_order_.empty()) {
+    // Load up to |kMaxCookiesPerChainLoad| cookies of the next domain key, but
+    // at least one domain.
     std::map<std::string, std::set<std::string> >::iterator
-      it = keys_to_load_.begin();
-    load_success = LoadCookiesForDomains(it->second);
-    keys_to_load_.erase(it);
+      it = keys_to_load_.find(key_load_order_.front());
+    std::set<std::string> domains;
+    int num_cookies = 0;
+    for (std::set<std::string>::const_iterator domain = it->second.begin();
+         domain != it->second.end(); ++domain) {
+      int domain_cookies = cookies_per_domain_[*domain];
+      if (!domains.empty() &&
+          num_cookies + domain_cookies > kMaxCookiesPerChainLoad) {
+        break;
+      }
+      domains.insert(*domain);
+      num_cookies += domain_cookies;
+    }
+    load_success = LoadCookiesForDomains(domains);
+    for (std::set<std::string>::const_iterator domain = domains.begin();
+         domain != domains.end(); ++domain) {
+      it->second.erase(*domain);
+    }
+    if (it->second.empty()) {
+      keys_to_load_.erase(it);
+      key_load_order_.pop_front();
+    }
   }
 
   // If load is successful and there are more domain keys to be loaded,
@@ -282,6 +282,58 @@ TEST_F(SQLitePersistentCookieStoreTest, TestLoadCookiesForKey) {
   STLDeleteElements(&cookies_);
 }
 
+// Test that the chain load starts with the most recently accessed key.
+TEST_F(SQLitePersistentCookieStoreTest, TestLoadRecentKeysFirst) {
+  InitializeStore(false);
+  base::Time t = base::Time::Now();
+  AddCookie("A", "B", "www.aaa.com", "/", t);
+  t += base::TimeDelta::FromInternalValue(10);
+  AddCookie("A", "B", "www.ccc.com", "/", t);
+  t += base::TimeDelta::FromInternalValue(10);
+  AddCookie("A", "B", "www.bbb.com", "/", t);
+  DestroyStore();
+
+  store_ = new SQLitePersistentCookieStore(
+      temp_dir_.path().Append(kCookieFilename),
+      client_task_runner(),
+      background_task_runner(),
+      false, NULL);
+  // As in TestLoadCookiesForKey, let the first chain load run before the
+  // priority load.
+  background_task_runner()->PostTask(
+      FROM_HERE,
+      base::Bind(&SQLitePersistentCookieStoreTest::WaitOnDBEvent,
+                 base::Unretained(this)));
+  store_->Load(base::Bind(&SQLitePersistentCookieStoreTest::OnLoaded,
+                          base::Unretained(this)));
+  store_->LoadCookiesForKey("ccc.com",
+    base::Bind(&SQLitePersistentCookieStoreTest::OnKeyLoaded,
+               base::Unretained(this)));
+  background_task_runner()->PostTask(
+      FROM_HERE,
+      base::Bind(&SQLitePersistentCookieStoreTest::WaitOnDBEvent,
+                 base::Unretained(this)));
+
+  db_thread_event_.Signal();
+  key_loaded_event_.Wait();
+  std::set<std::string> cookies_loaded;
+  for (CanonicalCookieVector::const_iterator it = cookies_.begin();
+       it != cookies_.end();
+       ++it) {
+    cookies_loaded.insert((*it)->Domain());
+  }
+  STLDeleteElements(&cookies_);
+  EXPECT_EQ(2U, cookies_loaded.size());
+  EXPECT_TRUE(cookies_loaded.find("www.bbb.com") != cookies_loaded.end());
+  EXPECT_TRUE(cookies_loaded.find("www.ccc.com") != cookies_loaded.end());
+
+  db_thread_event_.Signal();
+  loaded_event_.Wait();
+  ASSERT_EQ(1U, cookies_.size());
+  EXPECT_EQ("www.aaa.com", cookies_[0]->Domain());
+  STLDeleteElements(&cookies_);
+}
+
 // Test that we can force the database to be written by calling Flush().
 TEST_F(SQLitePersistentCookieStoreTest, TestFlush) {
   InitializeStore(false);
@@ -82,6 +82,8 @@ ImmediateInputRouter::ImmediateInputRouter(
       move_caret_pending_(false),
       mouse_move_pending_(false),
       mouse_wheel_pending_(false),
+      vsync_aligned_input_(CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnableVSyncAlignedInput)),
       has_touch_handler_(false),
       touch_event_queue_(new TouchEventQueue(this)),
       gesture_event_filter_(new GestureEventFilter(this)) {
@@ -135,7 +137,7 @@ void ImmediateInputRouter::SendWheelEvent(
   // add the new deltas to that event. Not doing so (e.g., by dropping the old
   // event, as for mouse moves) results in very slow scrolling on the Mac (on
   // which many, very small wheel events are sent).
-  if (mouse_wheel_pending_) {
+  if (mouse_wheel_pending_ || wheel_frame_timer_.IsRunning()) {
     if (coalesced_mouse_wheel_events_.empty() ||
         !ShouldCoalesceMouseWheelEvents(
             coalesced_mouse_wheel_events_.back().event, wheel_event.event)) {
@@ -169,6 +171,18 @@ void ImmediateInputRouter::SendWheelEvent(
     }
     return;
   }
+
+  // Hold the event until the next frame if one was sent during this frame.
+  TimeDelta frame_delay = TimeUntilNextFrame(last_wheel_time_);
+  if (frame_delay > TimeDelta()) {
+    // This may be an event that was just taken from the front of the queue.
+    coalesced_mouse_wheel_events_.push_front(wheel_event);
+    wheel_frame_timer_.Start(FROM_HERE, frame_delay, this,
+                             &ImmediateInputRouter::OnWheelFrame);
+    UMA_HISTOGRAM_TIMES("MPArch.IIR_VSyncAlignedInputDelay", frame_delay);
+    return;
+  }
+
   mouse_wheel_pending_ = true;
   current_wheel_event_ = wheel_event;
 
@@ -223,7 +237,7 @@ void ImmediateInputRouter::SendMouseEventImmediately(
   // thread is able to rapidly consume WM_MOUSEMOVE events, we may get way
   // more WM_MOUSEMOVE events than we wish to send to the renderer.
   if (mouse_event.event.type == WebInputEvent::MouseMove) {
-    if (mouse_move_pending_) {
+    if (mouse_move_pending_ || mouse_move_frame_timer_.IsRunning()) {
       if (!next_mouse_move_) {
         next_mouse_move_.reset(new MouseEventWithLatencyInfo(mouse_event));
       } else {
@@ -237,6 +251,16 @@ void ImmediateInputRouter::SendMouseEventImmediately(
       }
       return;
     }
+
+    // Hold the event until the next frame if one was sent during this frame.
+    TimeDelta frame_delay = TimeUntilNextFrame(last_mouse_move_time_);
+    if (frame_delay > TimeDelta()) {
+      next_mouse_move_.reset(new MouseEventWithLatencyInfo(mouse_event));
+      mouse_move_frame_timer_.Start(FROM_HERE, frame_delay, this,
+                                    &ImmediateInputRouter::OnMouseMoveFrame);
+      UMA_HISTOGRAM_TIMES("MPArch.IIR_VSyncAlignedInputDelay", frame_delay);
+      return;
+    }
     mouse_move_pending_ = true;
   }
 
@@ -247,6 +271,20 @@ void ImmediateInputRouter::SendTouchEventImmediately(
     const TouchEventWithLatencyInfo& touch_event) {
   if (!client_->OnSendTouchEventImmediately(touch_event))
     return;
+
+  // Only one touch event is ever in flight, so a held touch move simply
+  // delays the queue. The moves that arrive meanwhile coalesce behind it.
+  if (touch_event.event.type == WebInputEvent::TouchMove) {
+    TimeDelta frame_delay = TimeUntilNextFrame(last_touch_move_time_);
+    if (frame_delay > TimeDelta()) {
+      next_touch_move_.reset(new TouchEventWithLatencyInfo(touch_event));
+      touch_move_frame_timer_.Start(FROM_HERE, frame_delay, this,
+                                    &ImmediateInputRouter::OnTouchMoveFrame);
+      UMA_HISTOGRAM_TIMES("MPArch.IIR_VSyncAlignedInputDelay", frame_delay);
+      return;
+    }
+  }
+
   FilterAndSendWebInputEvent(touch_event.event, touch_event.latency, false);
 }
 
@@ -281,6 +319,12 @@ bool ImmediateInputRouter::HasQueuedGestureEvents() const {
   return gesture_event_filter_->HasQueuedGestureEvents();
 }
 
+void ImmediateInputRouter::UpdateVSyncParameters(base::TimeTicks timebase,
+                                                 base::TimeDelta interval) {
+  vsync_timebase_ = timebase;
+  vsync_interval_ = interval;
+}
+
 bool ImmediateInputRouter::OnMessageReceived(const IPC::Message& message) {
   bool handled = true;
   bool message_is_ok = true;
@@ -336,6 +380,12 @@ void ImmediateInputRouter::SendWebInputEvent(
     const ui::LatencyInfo& latency_info,
     bool is_keyboard_shortcut) {
   input_event_start_time_ = TimeTicks::Now();
+  if (input_event.type == WebInputEvent::MouseMove)
+    last_mouse_move_time_ = input_event_start_time_;
+  else if (input_event.type == WebInputEvent::MouseWheel)
+    last_wheel_time_ = input_event_start_time_;
+  else if (input_event.type == WebInputEvent::TouchMove)
+    last_touch_move_time_ = input_event_start_time_;
   Send(new InputMsg_HandleInputEvent(
       routing_id(), &input_event, latency_info, is_keyboard_shortcut));
   client_->IncrementInFlightEventCount();
@@ -447,11 +497,56 @@ void ImmediateInputRouter::OnHasTouchEventHandlers(bool has_handlers) {
  if (has_touch_handler_ == has_handlers)
     return;
   has_touch_handler_ = has_handlers;
-  if (!has_handlers)
+  if (!has_handlers) {
+    touch_move_frame_timer_.Stop();
+    next_touch_move_.reset();
     touch_event_queue_->FlushQueue();
+  }
   client_->OnHasTouchEventHandlers(has_handlers);
 }
 
+TimeDelta ImmediateInputRouter::TimeUntilNextFrame(
+    TimeTicks last_dispatch) const {
+  if (!vsync_aligned_input_ || vsync_interval_ <= TimeDelta() ||
+      last_dispatch.is_null())
+    return TimeDelta();
+
+  // Find the frame |last_dispatch| fell in, rounding down for times before
+  // |vsync_timebase_|.
+  TimeDelta since_timebase = last_dispatch - vsync_timebase_;
+  int64 frame = since_timebase / vsync_interval_;
+  if (since_timebase < vsync_interval_ * frame)
+    --frame;
+  TimeTicks next_frame = vsync_timebase_ + vsync_interval_ * (frame + 1);
+  return next_frame - TimeTicks::Now();
+}
+
+void ImmediateInputRouter::OnMouseMoveFrame() {
+  if (!next_mouse_move_)
+    return;
+  scoped_ptr<MouseEventWithLatencyInfo> next_mouse_move =
+      next_mouse_move_.Pass();
+  SendMouseEvent(*next_mouse_move);
+}
+
+void ImmediateInputRouter::OnWheelFrame() {
+  if (coalesced_mouse_wheel_events_.empty())
+    return;
+  MouseWheelEventWithLatencyInfo next_wheel_event =
+      coalesced_mouse_wheel_events_.front();
+  coalesced_mouse_wheel_events_.pop_front();
+  SendWheelEvent(next_wheel_event);
+}
+
+void ImmediateInputRouter::OnTouchMoveFrame() {
+  if (!next_touch_move_)
+    return;
+  scoped_ptr<TouchEventWithLatencyInfo> next_touch_move =
+      next_touch_move_.Pass();
+  FilterAndSendWebInputEvent(next_touch_move->event, next_touch_move->latency,
+                             false);
+}
+
 void ImmediateInputRouter::ProcessInputEventAck(
     WebInputEvent::Type event_type,
     InputEventAckState ack_result,
@@ -10,6 +10,7 @@
 #include "base/basictypes.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "content/browser/renderer_host/input/input_router.h"
 #include "content/browser/renderer_host/input/touch_event_queue.h"
 #include "content/public/browser/native_web_keyboard_event.h"
@@ -60,6 +61,8 @@ class CONTENT_EXPORT ImmediateInputRouter
   virtual bool ShouldForwardGestureEvent(
       const GestureEventWithLatencyInfo& gesture_event) const OVERRIDE;
   virtual bool HasQueuedGestureEvents() const OVERRIDE;
+  virtual void UpdateVSyncParameters(base::TimeTicks timebase,
+                                     base::TimeDelta interval) OVERRIDE;
 
   // IPC::Listener
   virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE;
@@ -129,6 +132,15 @@ private:
 
   int routing_id() const { return routing_id_; }
 
+  // Returns how long an event should be held so that it is dispatched no
+  // sooner than the vsync interval after the one containing |last_dispatch|.
+  // Returns a zero or negative delay if the event can be sent right away.
+  base::TimeDelta TimeUntilNextFrame(base::TimeTicks last_dispatch) const;
+
+  // Timer callbacks that send the event held for the current frame, if any.
+  void OnMouseMoveFrame();
+  void OnWheelFrame();
+  void OnTouchMoveFrame();
 
   RenderProcessHost* process_;
   InputRouterClient* client_;
@@ -173,6 +185,29 @@ private:
   // The time when an input event was sent to the RenderWidget.
   base::TimeTicks input_event_start_time_;
 
+  // True if mouse moves, mouse wheels and touch moves are sent at most once
+  // per vsync interval. Events that arrive in the meantime are coalesced
+  // into the held event as they would be while waiting for an ack.
+  bool vsync_aligned_input_;
+  base::TimeTicks vsync_timebase_;
+  base::TimeDelta vsync_interval_;
+
+  // The times the last event of each kind was sent to the renderer.
+  base::TimeTicks last_mouse_move_time_;
+  base::TimeTicks last_wheel_time_;
+  base::TimeTicks last_touch_move_time_;
+
+  // Running while an event of each kind is held for the next frame. The held
+  // mouse move is |next_mouse_move_|, and the held wheel event is the front of
+  // |coalesced_mouse_wheel_events_|.
+  base::OneShotTimer<ImmediateInputRouter> mouse_move_frame_timer_;
+  base::OneShotTimer<ImmediateInputRouter> wheel_frame_timer_;
+  base::OneShotTimer<ImmediateInputRouter> touch_move_frame_timer_;
+
+  // The touch move held for the next frame. Later touch moves are coalesced
+  // behind it in |touch_event_queue_|.
+  scoped_ptr<TouchEventWithLatencyInfo> next_touch_move_;
+
   // Queue of keyboard events that we need to track.
   typedef std::deque<NativeWebKeyboardEvent> KeyQueue;
 
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "base/basictypes.h"
+#include "base/command_line.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/strings/utf_string_conversions.h"
 #include "content/browser/renderer_host/input/gesture_event_filter.h"
@@ -12,6 +13,7 @@
 #include "content/common/edit_command.h"
 #include "content/common/input_messages.h"
 #include "content/common/view_messages.h"
+#include "content/public/common/content_switches.h"
 #include "content/public/test/mock_render_process_host.h"
 #include "content/public/test/test_browser_context.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -2165,4 +2167,55 @@ TEST_F(ImmediateInputRouterTest, UnhandledWheelEvent) {
   EXPECT_EQ(client_->acked_wheel_event().deltaY, -5);
 }
 
+// Test that with vsync-aligned input, mouse moves and wheel events that arrive
+// within a frame of the last one sent are held and coalesced until the next
+// frame.
+TEST_F(ImmediateInputRouterTest, VSyncAlignedInput) {
+  CommandLine::ForCurrentProcess()->AppendSwitch(
+      switches::kEnableVSyncAlignedInput);
+  input_router_.reset(new ImmediateInputRouter(
+      process_.get(), client_.get(), MSG_ROUTING_NONE));
+  client_->set_input_router(input_router_.get());
+  const TimeDelta kInterval = TimeDelta::FromMilliseconds(50);
+  input_router_->UpdateVSyncParameters(base::TimeTicks::Now(), kInterval);
+
+  // The first events are sent right away.
+  SimulateMouseMove(1, 1, 0);
+  SimulateWheelEvent(0, -5, 0, false);
+  EXPECT_EQ(2U, process_->sink().message_count());
+  process_->sink().ClearMessages();
+
+  // Once they are acked, the events that follow in the same frame are held.
+  SendInputEventACK(WebInputEvent::MouseMove, INPUT_EVENT_ACK_STATE_CONSUMED);
+  SendInputEventACK(WebInputEvent::MouseWheel,
+                    INPUT_EVENT_ACK_STATE_CONSUMED);
+  SimulateMouseMove(2, 2, 0);
+  SimulateMouseMove(3, 3, 0);
+  SimulateWheelEvent(0, -10, 0, false);
+  SimulateWheelEvent(0, -6, 0, false);
+  EXPECT_EQ(0U, process_->sink().message_count());
+
+  // The next frame sends one coalesced event of each kind.
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::MessageLoop::QuitClosure(),
+      kInterval * 2);
+  base::MessageLoop::current()->Run();
+  ASSERT_EQ(2U, process_->sink().message_count());
+
+  // Sending the mouse move flushes the held wheel event, so the two may come
+  // in either order.
+  for (size_t i = 0; i < 2; ++i) {
+    const WebInputEvent* input_event =
+        GetInputEventFromMessage(*process_->sink().GetMessageAt(i));
+    if (input_event->type == WebInputEvent::MouseMove) {
+      EXPECT_EQ(3, static_cast<const WebMouseEvent*>(input_event)->x);
+    } else {
+      ASSERT_EQ(WebInputEvent::MouseWheel, input_event->type);
+      EXPECT_EQ(-16,
+                static_cast<const WebMouseWheelEvent*>(input_event)->deltaY);
+    }
+  }
+}
+
 }  // namespace content
@@ -6,6 +6,7 @@
 #define CONTENT_BROWSER_RENDERER_HOST_INPUT_INPUT_ROUTER_H_
 
 #include "base/basictypes.h"
+#include "base/time/time.h"
 #include "content/port/browser/event_with_latency_info.h"
 #include "content/port/common/input_event_ack_state.h"
 #include "content/public/browser/native_web_keyboard_event.h"
@@ -63,6 +64,11 @@ class InputRouter : public IPC::Listener {
 
   // Returns |true| if the router has any queued or in-flight gesture events.
   virtual bool HasQueuedGestureEvents() const = 0;
+
+  // Informs the router of the display's vsync timing, which it may use to
+  // align the dispatch of continuous events with frames.
+  virtual void UpdateVSyncParameters(base::TimeTicks timebase,
+                                     base::TimeDelta interval) = 0;
 };
 
 }  // namespace content
@@ -4,6 +4,8 @@
 
 #include "content/browser/renderer_host/media/desktop_capture_device.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/location.h"
 #include "base/logging.h"
@@ -226,14 +228,18 @@ void DesktopCaptureDevice::Core::OnCaptureCompleted(
   // If the output size differs from the frame size (e.g. the source has changed
   // from its original dimensions, or the caller specified size constraints)
   // then we need to scale the image.
-  if (!scaled_frame_)
+  bool scale_whole_frame = false;
+  if (!scaled_frame_) {
     scaled_frame_.reset(new webrtc::BasicDesktopFrame(output_size_));
+    scale_whole_frame = true;
+  }
   DCHECK(scaled_frame_->size().equals(output_size_));
 
   // If the source frame size changed then clear |scaled_frame_|'s pixels.
-  if (!previous_frame_size_.equals(frame->size())) {
+  if (scale_whole_frame || !previous_frame_size_.equals(frame->size())) {
     previous_frame_size_ = frame->size();
     memset(scaled_frame_->data(), 0, output_bytes);
+    scale_whole_frame = true;
   }
 
   // Determine the output size preserving aspect, and center in output buffer.
@@ -244,13 +250,44 @@ void DesktopCaptureDevice::Core::OnCaptureCompleted(
       scaled_frame_->stride() * scaled_rect.y() +
       webrtc::DesktopFrame::kBytesPerPixel * scaled_rect.x();
 
-  // TODO(wez): Optimize this to scale only changed portions of the output,
-  // using ARGBScaleClip().
-  libyuv::ARGBScale(frame->data(), frame->stride(),
-                    frame->size().width(), frame->size().height(),
-                    scaled_data, scaled_frame_->stride(),
-                    scaled_rect.width(), scaled_rect.height(),
-                    libyuv::kFilterBilinear);
+  if (scale_whole_frame) {
+    libyuv::ARGBScale(frame->data(), frame->stride(),
+                      frame->size().width(), frame->size().height(),
+                      scaled_data, scaled_frame_->stride(),
+                      scaled_rect.width(), scaled_rect.height(),
+                      libyuv::kFilterBilinear);
+  } else {
+    // Otherwise |scaled_frame_| still holds the previous frame, so only the
+    // parts of the output that the capturer reported as changed need to be
+    // scaled. Each rect is grown by a pixel on every side to cover the
+    // output pixels that the bilinear filter blends with changed ones.
+    const int frame_width = frame->size().width();
+    const int frame_height = frame->size().height();
+    for (webrtc::DesktopRegion::Iterator i(frame->updated_region());
+         !i.IsAtEnd(); i.Advance()) {
+      const webrtc::DesktopRect& rect = i.rect();
+      int left = std::max(
+          rect.left() * scaled_rect.width() / frame_width - 1, 0);
+      int top = std::max(
+          rect.top() * scaled_rect.height() / frame_height - 1, 0);
+      int right = std::min(
+          (rect.right() * scaled_rect.width() + frame_width - 1) /
+              frame_width + 1,
+          scaled_rect.width());
+      int bottom = std::min(
+          (rect.bottom() * scaled_rect.height() + frame_height - 1) /
+              frame_height + 1,
+          scaled_rect.height());
+      if (left >= right || top >= bottom)
+        continue;
+      libyuv::ARGBScaleClip(frame->data(), frame->stride(),
+                            frame_width, frame_height,
+                            scaled_data, scaled_frame_->stride(),
+                            scaled_rect.width(), scaled_rect.height(),
+                            left, top, right - left, bottom - top,
+                            libyuv::kFilterBilinear);
+    }
+  }
 
   base::AutoLock auto_lock(event_handler_lock_);
   if (event_handler_) {
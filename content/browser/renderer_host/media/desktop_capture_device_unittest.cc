@@ -4,6 +4,8 @@
 
 #include "content/browser/renderer_host/media/desktop_capture_device.h"
 
+#include <stdio.h>
+
 #include "base/basictypes.h"
 #include "base/sequenced_task_runner.h"
 #include "base/synchronization/waitable_event.h"
@@ -17,6 +19,7 @@
 #include "third_party/webrtc/modules/desktop_capture/screen_capturer.h"
 
 using ::testing::_;
+using ::testing::AnyNumber;
 using ::testing::DoAll;
 using ::testing::InvokeWithoutArgs;
 using ::testing::SaveArg;
@@ -83,6 +86,64 @@ class FakeScreenCapturer : public webrtc::ScreenCapturer {
   int frame_index_;
 };
 
+// Captures large frames in which only a small square has changed, and
+// measures how long DesktopCaptureDevice takes to process them.
+class FakeDirtyScreenCapturer : public webrtc::ScreenCapturer {
+ public:
+  FakeDirtyScreenCapturer(int frames_to_time, base::WaitableEvent* done_event)
+      : callback_(NULL),
+        frames_to_time_(frames_to_time),
+        frame_index_(0),
+        done_event_(done_event) {
+  }
+  virtual ~FakeDirtyScreenCapturer() {}
+
+  // VideoFrameCapturer interface.
+  virtual void Start(Callback* callback) OVERRIDE {
+    callback_ = callback;
+  }
+
+  virtual void Capture(const webrtc::DesktopRegion& region) OVERRIDE {
+    webrtc::DesktopFrame* frame = new webrtc::BasicDesktopFrame(
+        webrtc::DesktopSize(kLargeFrameWidth, kLargeFrameHeight));
+    int offset = (frame_index_ * kDirtySize) % (kLargeFrameWidth - kDirtySize);
+    frame->mutable_updated_region()->SetRect(
+        webrtc::DesktopRect::MakeXYWH(
+            offset, offset % (kLargeFrameHeight - kDirtySize),
+            kDirtySize, kDirtySize));
+    frame_index_++;
+
+    // The first frame is always scaled as a whole, so it isn't timed.
+    if (frame_index_ == 1 || frame_index_ > frames_to_time_ + 1) {
+      callback_->OnCaptureCompleted(frame);
+      return;
+    }
+    base::TimeTicks start = base::TimeTicks::HighResNow();
+    callback_->OnCaptureCompleted(frame);
+    elapsed_ += base::TimeTicks::HighResNow() - start;
+    if (frame_index_ == frames_to_time_ + 1)
+      done_event_->Signal();
+  }
+
+  virtual void SetMouseShapeObserver(
+      MouseShapeObserver* mouse_shape_observer) OVERRIDE {
+  }
+
+  // Only valid once |done_event_| is signaled.
+  base::TimeDelta elapsed() const { return elapsed_; }
+
+  static const int kLargeFrameWidth = 1920;
+  static const int kLargeFrameHeight = 1080;
+  static const int kDirtySize = 64;
+
+ private:
+  Callback* callback_;
+  int frames_to_time_;
+  int frame_index_;
+  base::WaitableEvent* done_event_;
+  base::TimeDelta elapsed_;
+};
+
 class DesktopCaptureDeviceTest : public testing::Test {
  public:
   virtual void SetUp() OVERRIDE {
@@ -190,4 +251,46 @@ TEST_F(DesktopCaptureDeviceTest, ScreenResolutionChange) {
   EXPECT_EQ(caps.width * caps.height * 4, frame_size);
 }
 
+// Reports how long scaling a large frame takes when only a small part of it
+// has changed.
+TEST_F(DesktopCaptureDeviceTest, ScaleChangedRegion) {
+  const int kFramesToTime = 30;
+  base::WaitableEvent done_event(false, false);
+  FakeDirtyScreenCapturer* capturer =
+      new FakeDirtyScreenCapturer(kFramesToTime, &done_event);
+
+  DesktopCaptureDevice capture_device(
+      worker_pool_->GetSequencedTaskRunner(worker_pool_->GetSequenceToken()),
+      scoped_ptr<webrtc::DesktopCapturer>(capturer));
+
+  MockFrameObserver frame_observer;
+  EXPECT_CALL(frame_observer, OnFrameInfo(_));
+  EXPECT_CALL(frame_observer, OnError())
+      .Times(0);
+  EXPECT_CALL(frame_observer, OnIncomingCapturedFrame(_, _, _, _, _, _))
+      .Times(AnyNumber());
+
+  // Request a smaller size than the frames, so that they are scaled.
+  media::VideoCaptureCapability capture_format(
+      640, 360, kFrameRate, media::VideoCaptureCapability::kI420, 0, false,
+      media::ConstantResolutionVideoCaptureDevice);
+  capture_device.Allocate(capture_format, &frame_observer);
+  capture_device.Start();
+  EXPECT_TRUE(done_event.TimedWait(TestTimeouts::action_max_timeout()));
+  // |capturer| is destroyed by DeAllocate().
+  base::TimeDelta elapsed = capturer->elapsed();
+  capture_device.Stop();
+  capture_device.DeAllocate();
+
+  printf("Processed %d frames of %dx%d with %dx%d changed in %.2f ms "
+         "(%.3f ms/frame)\n",
+         kFramesToTime,
+         FakeDirtyScreenCapturer::kLargeFrameWidth,
+         FakeDirtyScreenCapturer::kLargeFrameHeight,
+         FakeDirtyScreenCapturer::kDirtySize,
+         FakeDirtyScreenCapturer::kDirtySize,
+         elapsed.InMillisecondsF(),
+         elapsed.InMillisecondsF() / kFramesToTime);
+}
+
 }  // namespace content
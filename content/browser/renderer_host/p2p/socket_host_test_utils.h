@@ -306,6 +306,20 @@ MATCHER_P(MatchPacketMessage, packet_content, "") {
   return params.c == packet_content;
 }
 
+MATCHER_P(MatchPacketBatchMessage, packet_contents, "") {
+  if (arg->type() != P2PMsg_OnDataReceivedBatch::ID)
+    return false;
+  P2PMsg_OnDataReceivedBatch::Param params;
+  P2PMsg_OnDataReceivedBatch::Read(arg, &params);
+  if (params.b.size() != packet_contents.size())
+    return false;
+  for (size_t i = 0; i < packet_contents.size(); ++i) {
+    if (params.b[i].data != packet_contents[i])
+      return false;
+  }
+  return true;
+}
+
 MATCHER_P(MatchIncomingSocketMessage, address, "") {
   if (arg->type() != P2PMsg_OnIncomingTcpConnection::ID)
     return false;
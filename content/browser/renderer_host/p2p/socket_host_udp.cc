@@ -17,6 +17,9 @@ namespace {
 // UDP packets cannot be bigger than 64k.
 const int kReadBufferSize = 65536;
 
+// The most packets sent to the renderer in one P2PMsg_OnDataReceivedBatch.
+const size_t kMaxPacketsPerBatch = 32;
+
 // Defines set of transient errors. These errors are ignored when we get them
 // from sendto() or recvfrom() calls.
 //
@@ -125,9 +128,12 @@ void P2PSocketHostUdp::DoRead() {
         &recv_address_,
         base::Bind(&P2PSocketHostUdp::OnRecv, base::Unretained(this)));
     if (result == net::ERR_IO_PENDING)
-      return;
+      break;
     HandleReadResult(result);
   } while (state_ == STATE_OPEN);
+
+  // Everything that was waiting in the socket has been read.
+  SendReceivedPackets();
 }
 
 void P2PSocketHostUdp::OnRecv(int result) {
@@ -141,11 +147,9 @@ void P2PSocketHostUdp::HandleReadResult(int result) {
   DCHECK_EQ(state_, STATE_OPEN);
 
   if (result > 0) {
-    std::vector<char> data(recv_buffer_->data(), recv_buffer_->data() + result);
-
     if (connected_peers_.find(recv_address_) == connected_peers_.end()) {
       P2PSocketHost::StunMessageType type;
-      bool stun = GetStunPacketType(&*data.begin(), data.size(), &type);
+      bool stun = GetStunPacketType(recv_buffer_->data(), result, &type);
       if (stun && IsRequestOrResponse(type)) {
         connected_peers_.insert(recv_address_);
       } else if (!stun || type == STUN_DATA_INDICATION) {
@@ -156,13 +160,35 @@ void P2PSocketHostUdp::HandleReadResult(int result) {
       }
     }
 
-    message_sender_->Send(new P2PMsg_OnDataReceived(id_, recv_address_, data));
+    received_packets_.push_back(P2PReceivedPacket());
+    P2PReceivedPacket& packet = received_packets_.back();
+    packet.address = recv_address_;
+    packet.data.assign(recv_buffer_->data(), recv_buffer_->data() + result);
+    if (received_packets_.size() >= kMaxPacketsPerBatch)
+      SendReceivedPackets();
   } else if (result < 0 && !IsTransientError(result)) {
     LOG(ERROR) << "Error when reading from UDP socket: " << result;
+    // Deliver the packets read before the error first.
+    SendReceivedPackets();
     OnError();
   }
 }
 
+void P2PSocketHostUdp::SendReceivedPackets() {
+  if (received_packets_.empty())
+    return;
+
+  if (received_packets_.size() == 1) {
+    const P2PReceivedPacket& packet = received_packets_.front();
+    message_sender_->Send(
+        new P2PMsg_OnDataReceived(id_, packet.address, packet.data));
+  } else {
+    message_sender_->Send(
+        new P2PMsg_OnDataReceivedBatch(id_, received_packets_));
+  }
+  received_packets_.clear();
+}
+
 void P2PSocketHostUdp::Send(const net::IPEndPoint& to,
                             const std::vector<char>& data) {
   if (!socket_) {
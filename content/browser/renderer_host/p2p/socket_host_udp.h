@@ -55,6 +55,7 @@ class CONTENT_EXPORT P2PSocketHostUdp : public P2PSocketHost {
   void DoRead();
   void OnRecv(int result);
   void HandleReadResult(int result);
+  void SendReceivedPackets();
 
   void DoSend(const PendingPacket& packet);
   void OnSend(uint64 packet_id, int result);
@@ -64,6 +65,10 @@ class CONTENT_EXPORT P2PSocketHostUdp : public P2PSocketHost {
   scoped_refptr<net::IOBuffer> recv_buffer_;
   net::IPEndPoint recv_address_;
 
+  // Packets read but not yet sent to the renderer. Packets that can be read
+  // without waiting are sent to the renderer together.
+  std::vector<P2PReceivedPacket> received_packets_;
+
   std::deque<PendingPacket> send_queue_;
   bool send_pending_;
   uint64 send_packet_count_;
@@ -104,6 +104,13 @@ class FakeDatagramServerSocket : public net::DatagramServerSocket {
     }
   }
 
+  // Receives |packets| as if they had all arrived before they could be read.
+  void ReceivePackets(const std::deque<UDPPacket>& packets) {
+    incoming_packets_.insert(incoming_packets_.end(),
+                             packets.begin() + 1, packets.end());
+    ReceivePacket(packets.front().first, packets.front().second);
+  }
+
   virtual const net::BoundNetLog& NetLog() const OVERRIDE {
     return net_log_;
   }
@@ -289,4 +296,23 @@ TEST_F(P2PSocketHostUdpTest, SendAfterStunResponseDifferentHost) {
   socket_host_->Send(dest2_, packet);
 }
 
+// Verify that packets waiting in the socket together are sent to the
+// renderer in one message.
+TEST_F(P2PSocketHostUdpTest, ReceiveBatch) {
+  std::vector<std::vector<char> > packet_contents(3);
+  CreateStunRequest(&packet_contents[0]);
+  CreateStunResponse(&packet_contents[1]);
+  CreateRandomPacket(&packet_contents[2]);
+
+  std::deque<FakeDatagramServerSocket::UDPPacket> packets;
+  for (size_t i = 0; i < packet_contents.size(); ++i) {
+    packets.push_back(
+        FakeDatagramServerSocket::UDPPacket(dest1_, packet_contents[i]));
+  }
+
+  EXPECT_CALL(sender_, Send(MatchPacketBatchMessage(packet_contents)))
+      .WillOnce(DoAll(DeleteArg<0>(), Return(true)));
+  socket_->ReceivePackets(packets);
+}
+
 }  // namespace content
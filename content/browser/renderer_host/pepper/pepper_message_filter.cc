@@ -136,7 +136,7 @@ net::HostResolver* PepperMessageFilter::GetHostResolver() {
 
 net::CertVerifier* PepperMessageFilter::GetCertVerifier() {
   if (!cert_verifier_)
-    cert_verifier_.reset(net::CertVerifier::CreateDefault());
+    cert_verifier_.reset(net::CertVerifier::CreateDefaultWithSharedCache());
 
   return cert_verifier_.get();
 }
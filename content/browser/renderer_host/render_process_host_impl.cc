@@ -1042,9 +1042,12 @@ void RenderProcessHostImpl::PropagateBrowserCommandLineToRenderer(
     // also be added to chrome/browser/chromeos/login/chrome_restart_request.cc.
     cc::switches::kBackgroundColorInsteadOfCheckerboard,
     cc::switches::kCompositeToMailbox,
+    cc::switches::kCompressLowPriorityTiles,
     cc::switches::kDisableCompositedAntialiasing,
     cc::switches::kDisableImplSidePainting,
     cc::switches::kDisableThreadedAnimation,
+    cc::switches::kEnableDeadlineScheduling,
+    cc::switches::kEnableGpuRasterization,
     cc::switches::kEnableImplSidePainting,
     cc::switches::kEnablePartialSwap,
     cc::switches::kEnablePerTilePainting,
@@ -1296,7 +1299,8 @@ void RenderProcessHostImpl::OnChannelConnected(int32 peer_pid) {
 
   tracked_objects::ThreadData::Status status =
       tracked_objects::ThreadData::status();
-  Send(new ChildProcessMsg_SetProfilerStatus(status));
+  Send(new ChildProcessMsg_SetProfilerStatus(
+      status, tracked_objects::ThreadData::sampling_interval()));
 }
 
 void RenderProcessHostImpl::OnChannelError() {
@@ -91,6 +91,25 @@ const int kPaintMsgTimeoutMS = 50;
 base::LazyInstance<std::vector<RenderWidgetHost::CreatedCallback> >
 g_created_callbacks = LAZY_INSTANCE_INITIALIZER;
 
+// Id of the next "InputLatency" trace event.
+int64 g_next_latency_trace_id = 0;
+
+// Returns in |delta| the time between two components of |latency_info|, if it
+// has both of them.
+bool GetLatencyBetween(const ui::LatencyInfo& latency_info,
+                       ui::LatencyComponentType from,
+                       int64 from_id,
+                       ui::LatencyComponentType to,
+                       base::TimeDelta* delta) {
+  ui::LatencyInfo::LatencyComponent from_component;
+  ui::LatencyInfo::LatencyComponent to_component;
+  if (!latency_info.FindLatency(from, from_id, &from_component) ||
+      !latency_info.FindLatency(to, 0, &to_component))
+    return false;
+  *delta = to_component.event_time - from_component.event_time;
+  return true;
+}
+
 }  // namespace
 
 
@@ -1109,6 +1128,11 @@ ui::LatencyInfo RenderWidgetHostImpl::CreateRWHLatencyInfoIfNotExist(
   if (!info.FindLatency(ui::INPUT_EVENT_LATENCY_RWH_COMPONENT,
                         GetLatencyComponentId(),
                         NULL)) {
+    if (info.trace_id == -1) {
+      info.trace_id = g_next_latency_trace_id++;
+      TRACE_EVENT_ASYNC_BEGIN0("benchmark", "InputLatency",
+                               TRACE_ID_DONT_MANGLE(info.trace_id));
+    }
     info.AddLatencyNumber(ui::INPUT_EVENT_LATENCY_RWH_COMPONENT,
                           GetLatencyComponentId(),
                           ++last_input_number_);
@@ -1189,6 +1213,7 @@ void RenderWidgetHostImpl::OnSnapshot(bool success,
 void RenderWidgetHostImpl::UpdateVSyncParameters(base::TimeTicks timebase,
                                                  base::TimeDelta interval) {
   Send(new ViewMsg_UpdateVSyncParameters(GetRoutingID(), timebase, interval));
+  input_router_->UpdateVSyncParameters(timebase, interval);
 }
 
 void RenderWidgetHostImpl::RendererExited(base::TerminationStatus status,
@@ -2424,11 +2449,76 @@ void RenderWidgetHostImpl::FrameSwapped(const ui::LatencyInfo& latency_info) {
                                 &rwh_component))
     return;
 
+  if (latency_info.trace_id != -1) {
+    TRACE_EVENT_ASYNC_END0("benchmark", "InputLatency",
+                           TRACE_ID_DONT_MANGLE(latency_info.trace_id));
+  }
+
   rendering_stats_.input_event_count += rwh_component.event_count;
   rendering_stats_.total_input_latency +=
       rwh_component.event_count *
       (latency_info.swap_timestamp - rwh_component.event_time);
 
+  // The time spent in each stage of the pipeline that the events went
+  // through. Events handled on the renderer's impl thread skip the main
+  // thread and the commit.
+  base::TimeDelta stage_delta;
+  if (GetLatencyBetween(latency_info,
+                        ui::INPUT_EVENT_LATENCY_RWH_COMPONENT,
+                        GetLatencyComponentId(),
+                        ui::INPUT_EVENT_LATENCY_RENDERER_MAIN_COMPONENT,
+                        &stage_delta)) {
+    UMA_HISTOGRAM_CUSTOM_COUNTS("Event.Latency.Stage.RendererMain",
+                                stage_delta.InMicroseconds(), 0, 1000000, 100);
+  }
+  if (GetLatencyBetween(latency_info,
+                        ui::INPUT_EVENT_LATENCY_RENDERER_MAIN_COMPONENT,
+                        0,
+                        ui::INPUT_EVENT_LATENCY_COMMIT_COMPONENT,
+                        &stage_delta)) {
+    UMA_HISTOGRAM_CUSTOM_COUNTS("Event.Latency.Stage.Commit",
+                                stage_delta.InMicroseconds(), 0, 1000000, 100);
+  }
+  if (GetLatencyBetween(latency_info,
+                        ui::INPUT_EVENT_LATENCY_COMMIT_COMPONENT,
+                        0,
+                        ui::INPUT_EVENT_LATENCY_DRAW_COMPONENT,
+                        &stage_delta)) {
+    UMA_HISTOGRAM_CUSTOM_COUNTS("Event.Latency.Stage.Draw",
+                                stage_delta.InMicroseconds(), 0, 1000000, 100);
+  }
+  if (GetLatencyBetween(latency_info,
+                        ui::INPUT_EVENT_LATENCY_DRAW_COMPONENT,
+                        0,
+                        ui::INPUT_EVENT_LATENCY_GPU_SWAP_COMPONENT,
+                        &stage_delta)) {
+    UMA_HISTOGRAM_CUSTOM_COUNTS("Event.Latency.Stage.GpuSwap",
+                                stage_delta.InMicroseconds(), 0, 1000000, 100);
+  }
+  if (GetLatencyBetween(latency_info,
+                        ui::INPUT_EVENT_LATENCY_DRAW_COMPONENT,
+                        0,
+                        ui::INPUT_EVENT_LATENCY_BROWSER_COMPOSITOR_COMPONENT,
+                        &stage_delta)) {
+    UMA_HISTOGRAM_CUSTOM_COUNTS("Event.Latency.Stage.BrowserCompositor",
+                                stage_delta.InMicroseconds(), 0, 1000000, 100);
+  }
+
+  // The time from the OS input event to the final swap, if the platform
+  // reports when the event happened.
+  ui::LatencyInfo::LatencyComponent input_component;
+  if (latency_info.FindLatency(ui::INPUT_EVENT_LATENCY_ORIGINAL_COMPONENT,
+                               0,
+                               &input_component)) {
+    UMA_HISTOGRAM_CUSTOM_COUNTS(
+        "Event.Latency.InputToSwap",
+        (latency_info.swap_timestamp - input_component.event_time)
+            .InMicroseconds(),
+        0,
+        1000000,
+        100);
+  }
+
   ui::LatencyInfo::LatencyComponent original_component;
   if (latency_info.FindLatency(
           ui::INPUT_EVENT_LATENCY_SCROLL_UPDATE_ORIGINAL_COMPONENT,
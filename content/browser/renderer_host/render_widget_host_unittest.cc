@@ -196,6 +196,8 @@ class MockInputRouter : public InputRouter {
     return true;
   }
   virtual bool HasQueuedGestureEvents() const OVERRIDE { return true; }
+  virtual void UpdateVSyncParameters(base::TimeTicks timebase,
+                                     base::TimeDelta interval) OVERRIDE {}
 
   // IPC::Listener
   virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE {
@@ -282,6 +282,7 @@ pid_t ZygoteHostImpl::ForkRequest(
   pid_t pid;
   {
     base::AutoLock lock(control_lock_);
+    const base::TimeTicks fork_start = base::TimeTicks::Now();
     if (!SendMessage(pickle, &fds))
       return base::kNullProcessHandle;
 
@@ -320,8 +321,24 @@ pid_t ZygoteHostImpl::ForkRequest(
       uma_histogram->Add(uma_sample);
     }
 
+    // Renderers may be handed out of the zygote's pool of preforked ones,
+    // which skips the fork on this path.
+    bool preforked = false;
+    reply_pickle.ReadBool(&iter, &preforked);
+
     if (pid <= 0)
       return base::kNullProcessHandle;
+
+    if (process_type == switches::kRendererProcess) {
+      const base::TimeDelta fork_time = base::TimeTicks::Now() - fork_start;
+      UMA_HISTOGRAM_BOOLEAN("Linux.ZygotePreforkedRenderer", preforked);
+      if (preforked) {
+        UMA_HISTOGRAM_TIMES("Linux.ZygoteRendererForkTime.Preforked",
+                            fork_time);
+      } else {
+        UMA_HISTOGRAM_TIMES("Linux.ZygoteRendererForkTime.Forked", fork_time);
+      }
+    }
   }
 
 #if !defined(OS_OPENBSD)
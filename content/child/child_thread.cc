@@ -362,8 +362,10 @@ void ChildThread::OnSetIPCLoggingEnabled(bool enable) {
 }
 #endif  //  IPC_MESSAGE_LOG_ENABLED
 
-void ChildThread::OnSetProfilerStatus(ThreadData::Status status) {
+void ChildThread::OnSetProfilerStatus(ThreadData::Status status,
+                                      int32 sampling_interval) {
   ThreadData::InitializeAndSetTrackingStatus(status);
+  ThreadData::SetSamplingInterval(sampling_interval);
 }
 
 void ChildThread::OnGetChildProfilerData(int sequence_number) {
@@ -151,7 +151,8 @@ class CONTENT_EXPORT ChildThread : public IPC::Listener, public IPC::Sender {
 
   // IPC message handlers.
   void OnShutdown();
-  void OnSetProfilerStatus(tracked_objects::ThreadData::Status status);
+  void OnSetProfilerStatus(tracked_objects::ThreadData::Status status,
+                           int32 sampling_interval);
   void OnGetChildProfilerData(int sequence_number);
   void OnDumpHandles();
 #ifdef IPC_MESSAGE_LOG_ENABLED
@@ -395,29 +395,37 @@ void ResourceDispatcher::OnReceivedData(const IPC::Message& message,
                                         int data_offset,
                                         int data_length,
                                         int encoded_data_length) {
-  PendingRequestInfo* request_info = GetPendingRequestInfo(request_id);
-  if (request_info && data_length > 0) {
-    CHECK(base::SharedMemory::IsHandleValid(request_info->buffer->handle()));
-    CHECK_GE(request_info->buffer_size, data_offset + data_length);
-
-    // Ensure that the SHM buffer remains valid for the duration of this scope.
-    // It is possible for CancelPendingRequest() to be called before we exit
-    // this scope.
-    linked_ptr<base::SharedMemory> retain_buffer(request_info->buffer);
+  DeliverReceivedData(request_id, data_offset, data_length,
+                      encoded_data_length);
 
-    base::TimeTicks time_start = base::TimeTicks::Now();
-
-    const char* data_ptr = static_cast<char*>(request_info->buffer->memory());
-    CHECK(data_ptr);
-    CHECK(data_ptr + data_offset);
+  // Acknowledge the reception of this data.
+  message_sender()->Send(
+      new ResourceHostMsg_DataReceived_ACK(message.routing_id(), request_id));
+}
 
-    request_info->peer->OnReceivedData(
-        data_ptr + data_offset,
-        data_length,
-        encoded_data_length);
+void ResourceDispatcher::OnReceivedDataBatch(
+    const IPC::Message& message,
+    int request_id,
+    const std::vector<ResourceMsg_DataChunk>& chunks) {
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    if (!DeliverReceivedData(request_id, chunks[i].data_offset,
+                             chunks[i].data_length,
+                             chunks[i].encoded_data_length)) {
+      break;
+    }
 
-    UMA_HISTOGRAM_TIMES("ResourceDispatcher.OnReceivedDataTime",
-                        base::TimeTicks::Now() - time_start);
+    // The peer may have deferred the request. The rest of the chunks then
+    // wait in front of the deferred messages, and the whole batch is
+    // acknowledged once they have been delivered.
+    PendingRequestInfo* request_info = GetPendingRequestInfo(request_id);
+    if (request_info && request_info->is_deferred && i + 1 < chunks.size()) {
+      std::vector<ResourceMsg_DataChunk> remaining_chunks(
+          chunks.begin() + i + 1, chunks.end());
+      request_info->deferred_message_queue.push_front(
+          new ResourceMsg_DataReceivedBatch(
+              message.routing_id(), request_id, remaining_chunks));
+      return;
+    }
   }
 
   // Acknowledge the reception of this data.
@@ -425,6 +433,40 @@ void ResourceDispatcher::OnReceivedData(const IPC::Message& message,
       new ResourceHostMsg_DataReceived_ACK(message.routing_id(), request_id));
 }
 
+bool ResourceDispatcher::DeliverReceivedData(int request_id,
+                                             int data_offset,
+                                             int data_length,
+                                             int encoded_data_length) {
+  PendingRequestInfo* request_info = GetPendingRequestInfo(request_id);
+  if (!request_info)
+    return false;
+  if (data_length <= 0)
+    return true;
+
+  CHECK(base::SharedMemory::IsHandleValid(request_info->buffer->handle()));
+  CHECK_GE(request_info->buffer_size, data_offset + data_length);
+
+  // Ensure that the SHM buffer remains valid for the duration of this scope.
+  // It is possible for CancelPendingRequest() to be called before we exit
+  // this scope.
+  linked_ptr<base::SharedMemory> retain_buffer(request_info->buffer);
+
+  base::TimeTicks time_start = base::TimeTicks::Now();
+
+  const char* data_ptr = static_cast<char*>(request_info->buffer->memory());
+  CHECK(data_ptr);
+  CHECK(data_ptr + data_offset);
+
+  request_info->peer->OnReceivedData(
+      data_ptr + data_offset,
+      data_length,
+      encoded_data_length);
+
+  UMA_HISTOGRAM_TIMES("ResourceDispatcher.OnReceivedDataTime",
+                      base::TimeTicks::Now() - time_start);
+  return true;
+}
+
 void ResourceDispatcher::OnDownloadedData(const IPC::Message& message,
                                           int request_id,
                                           int data_len) {
@@ -611,6 +653,7 @@ void ResourceDispatcher::DispatchMessage(const IPC::Message& message) {
     IPC_MESSAGE_HANDLER(ResourceMsg_ReceivedRedirect, OnReceivedRedirect)
     IPC_MESSAGE_HANDLER(ResourceMsg_SetDataBuffer, OnSetDataBuffer)
     IPC_MESSAGE_HANDLER(ResourceMsg_DataReceived, OnReceivedData)
+    IPC_MESSAGE_HANDLER(ResourceMsg_DataReceivedBatch, OnReceivedDataBatch)
     IPC_MESSAGE_HANDLER(ResourceMsg_DataDownloaded, OnDownloadedData)
     IPC_MESSAGE_HANDLER(ResourceMsg_RequestComplete, OnRequestComplete)
   IPC_END_MESSAGE_MAP()
@@ -640,7 +683,10 @@ void ResourceDispatcher::FlushDeferredMessages(int request_id) {
     if (index != pending_requests_.end()) {
       PendingRequestInfo& pending_request = index->second;
       if (pending_request.is_deferred) {
-        pending_request.deferred_message_queue.swap(q);
+        // Keep what the above message queued, such as the rest of a batch, in
+        // front of the messages that were not dispatched yet.
+        pending_request.deferred_message_queue.insert(
+            pending_request.deferred_message_queue.end(), q.begin(), q.end());
         return;
       }
     }
@@ -720,6 +766,7 @@ bool ResourceDispatcher::IsResourceDispatcherMessage(
     case ResourceMsg_ReceivedRedirect::ID:
     case ResourceMsg_SetDataBuffer::ID:
     case ResourceMsg_DataReceived::ID:
+    case ResourceMsg_DataReceivedBatch::ID:
     case ResourceMsg_DataDownloaded::ID:
     case ResourceMsg_RequestComplete::ID:
       return true;
@@ -9,6 +9,7 @@
 
 #include <deque>
 #include <string>
+#include <vector>
 
 #include "base/containers/hash_tables.h"
 #include "base/memory/linked_ptr.h"
@@ -20,6 +21,8 @@
 #include "ipc/ipc_sender.h"
 #include "webkit/child/resource_loader_bridge.h"
 
+struct ResourceMsg_DataChunk;
+
 namespace content {
 class ResourceDispatcherDelegate;
 struct ResourceResponseHead;
@@ -135,6 +138,10 @@ class CONTENT_EXPORT ResourceDispatcher : public IPC::Listener {
       int data_offset,
       int data_length,
       int encoded_data_length);
+  void OnReceivedDataBatch(
+      const IPC::Message& message,
+      int request_id,
+      const std::vector<ResourceMsg_DataChunk>& chunks);
   void OnDownloadedData(
       const IPC::Message& message,
       int request_id,
@@ -146,6 +153,13 @@ class CONTENT_EXPORT ResourceDispatcher : public IPC::Listener {
       const std::string& security_info,
       const base::TimeTicks& completion_time);
 
+  // Hands a byte range of the shared memory buffer of the request to its
+  // peer. Returns false if the request is gone.
+  bool DeliverReceivedData(int request_id,
+                           int data_offset,
+                           int data_length,
+                           int encoded_data_length);
+
   // Dispatch the message to one of the message response handlers.
   void DispatchMessage(const IPC::Message& message);
 
@@ -341,6 +341,101 @@ TEST_F(DeferredResourceLoadingTest, DeferredLoadTest) {
   delete bridge;
 }
 
+// Checks that the chunks of a DataReceivedBatch message are delivered in
+// order, and acknowledged once, even if the peer defers loading in between.
+class DataReceivedBatchTest : public ResourceDispatcherTest,
+                              public ResourceLoaderBridge::Peer {
+ public:
+  DataReceivedBatchTest() : num_acks_(0), defer_on_next_data_(false) {}
+
+  virtual bool Send(IPC::Message* msg) OVERRIDE {
+    if (msg->type() == ResourceHostMsg_DataReceived_ACK::ID)
+      ++num_acks_;
+    delete msg;
+    return true;
+  }
+
+  // ResourceLoaderBridge::Peer methods.
+  virtual void OnUploadProgress(uint64 position, uint64 size) OVERRIDE {
+  }
+
+  virtual bool OnReceivedRedirect(
+      const GURL& new_url,
+      const ResourceResponseInfo& info,
+      bool* has_new_first_party_for_cookies,
+      GURL* new_first_party_for_cookies) OVERRIDE {
+    return true;
+  }
+
+  virtual void OnReceivedResponse(const ResourceResponseInfo& info) OVERRIDE {
+  }
+
+  virtual void OnDownloadedData(int len) OVERRIDE {
+  }
+
+  virtual void OnReceivedData(const char* data,
+                              int data_length,
+                              int encoded_data_length) OVERRIDE {
+    received_lengths_.push_back(data_length);
+    if (defer_on_next_data_) {
+      defer_on_next_data_ = false;
+      dispatcher_->SetDefersLoading(0, true);
+    }
+  }
+
+  virtual void OnCompletedRequest(
+      int error_code,
+      bool was_ignored_by_handler,
+      const std::string& security_info,
+      const base::TimeTicks& completion_time) OVERRIDE {
+  }
+
+ protected:
+  int num_acks_;
+  bool defer_on_next_data_;
+  std::vector<int> received_lengths_;
+};
+
+TEST_F(DataReceivedBatchTest, DeferInTheMiddleOfBatch) {
+  base::MessageLoop message_loop(base::MessageLoop::TYPE_IO);
+
+  scoped_ptr<ResourceLoaderBridge> bridge(CreateBridge());
+  bridge->Start(this);
+
+  ResourceResponseHead response_head;
+  response_head.error_code = net::OK;
+  dispatcher_->OnMessageReceived(
+      ResourceMsg_ReceivedResponse(0, 0, response_head));
+
+  base::SharedMemory shared_memory;
+  ASSERT_TRUE(shared_memory.CreateAndMapAnonymous(100));
+  base::SharedMemoryHandle handle;
+  ASSERT_TRUE(shared_memory.ShareToProcess(base::GetCurrentProcessHandle(),
+                                           &handle));
+  dispatcher_->OnMessageReceived(
+      ResourceMsg_SetDataBuffer(0, 0, handle, 100, 0));
+
+  std::vector<ResourceMsg_DataChunk> chunks(3);
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    chunks[i].data_offset = 10 * i;
+    chunks[i].data_length = i + 1;
+    chunks[i].encoded_data_length = i + 1;
+  }
+  defer_on_next_data_ = true;
+  dispatcher_->OnMessageReceived(
+      ResourceMsg_DataReceivedBatch(0, 0, chunks));
+  ASSERT_EQ(1U, received_lengths_.size());
+  EXPECT_EQ(0, num_acks_);
+
+  dispatcher_->SetDefersLoading(0, false);
+  message_loop.RunUntilIdle();
+  ASSERT_EQ(3U, received_lengths_.size());
+  EXPECT_EQ(1, received_lengths_[0]);
+  EXPECT_EQ(2, received_lengths_[1]);
+  EXPECT_EQ(3, received_lengths_[2]);
+  EXPECT_EQ(1, num_acks_);
+}
+
 class TimeConversionTest : public ResourceDispatcherTest,
                            public ResourceLoaderBridge::Peer {
  public:
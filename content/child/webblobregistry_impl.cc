@@ -38,50 +38,78 @@ WebBlobRegistryImpl::WebBlobRegistryImpl(ThreadSafeSender* sender)
 WebBlobRegistryImpl::~WebBlobRegistryImpl() {
 }
 
-void WebBlobRegistryImpl::SendDataForBlob(const WebURL& url,
-                                          const WebThreadSafeData& data) {
-
-  if (data.size() == 0)
+void WebBlobRegistryImpl::SendDataForBlob(
+    const WebURL& url,
+    const char* data,
+    size_t data_size,
+    scoped_ptr<base::SharedMemory>* shared_memory) {
+  if (data_size == 0)
     return;
-  if (data.size() < kLargeThresholdBytes) {
+  if (data_size < kLargeThresholdBytes) {
     webkit_blob::BlobData::Item item;
-    item.SetToBytes(data.data(), data.size());
+    item.SetToBytes(data, data_size);
     sender_->Send(new BlobHostMsg_AppendBlobDataItem(url, item));
   } else {
     // We handle larger amounts of data via SharedMemory instead of
-    // writing it directly to the IPC channel.
-    size_t shared_memory_size = std::min(
-        data.size(), kMaxSharedMemoryBytes);
-    scoped_ptr<base::SharedMemory> shared_memory(
-        ChildThread::AllocateSharedMemory(shared_memory_size,
-                                          sender_.get()));
-    CHECK(shared_memory.get());
+    // writing it directly to the IPC channel. The segment is kept for the
+    // rest of the blob, since allocating one takes a sync IPC on POSIX, and
+    // the browser is done with it when each sync append returns.
+    size_t wanted_size = std::min(data_size, kMaxSharedMemoryBytes);
+    if (!shared_memory->get() ||
+        (*shared_memory)->mapped_size() < wanted_size) {
+      shared_memory->reset(
+          ChildThread::AllocateSharedMemory(wanted_size, sender_.get()));
+    }
+    CHECK(shared_memory->get());
+    size_t shared_memory_size = (*shared_memory)->mapped_size();
 
-    size_t data_size = data.size();
-    const char* data_ptr = data.data();
+    const char* data_ptr = data;
     while (data_size) {
       size_t chunk_size = std::min(data_size, shared_memory_size);
-      memcpy(shared_memory->memory(), data_ptr, chunk_size);
+      memcpy((*shared_memory)->memory(), data_ptr, chunk_size);
       sender_->Send(new BlobHostMsg_SyncAppendSharedMemory(
-          url, shared_memory->handle(), chunk_size));
+          url, (*shared_memory)->handle(), chunk_size));
       data_size -= chunk_size;
       data_ptr += chunk_size;
     }
   }
 }
 
+void WebBlobRegistryImpl::FlushPendingDataForBlob(
+    const WebURL& url,
+    std::string* pending_data,
+    scoped_ptr<base::SharedMemory>* shared_memory) {
+  SendDataForBlob(url, pending_data->data(), pending_data->size(),
+                  shared_memory);
+  pending_data->clear();
+}
+
 void WebBlobRegistryImpl::registerBlobURL(
     const WebURL& url, WebBlobData& data) {
   DCHECK(ChildThread::current());
   sender_->Send(new BlobHostMsg_StartBuilding(url));
+  // Runs of small data items, such as the parts of a Blob constructed from
+  // many strings, are sent as one item rather than a message each.
+  std::string pending_data;
+  scoped_ptr<base::SharedMemory> shared_memory;
   size_t i = 0;
   WebBlobData::Item data_item;
   while (data.itemAt(i++, data_item)) {
+    if (data_item.type != WebBlobData::Item::TypeData)
+      FlushPendingDataForBlob(url, &pending_data, &shared_memory);
     switch (data_item.type) {
       case WebBlobData::Item::TypeData: {
         // WebBlobData does not allow partial data items.
         DCHECK(!data_item.offset && data_item.length == -1);
-        SendDataForBlob(url, data_item.data);
+        if (data_item.data.size() < kLargeThresholdBytes) {
+          pending_data.append(data_item.data.data(), data_item.data.size());
+          if (pending_data.size() >= kLargeThresholdBytes)
+            FlushPendingDataForBlob(url, &pending_data, &shared_memory);
+        } else {
+          FlushPendingDataForBlob(url, &pending_data, &shared_memory);
+          SendDataForBlob(url, data_item.data.data(), data_item.data.size(),
+                          &shared_memory);
+        }
         break;
       }
       case WebBlobData::Item::TypeFile:
@@ -125,6 +153,7 @@ void WebBlobRegistryImpl::registerBlobURL(
         NOTREACHED();
     }
   }
+  FlushPendingDataForBlob(url, &pending_data, &shared_memory);
   sender_->Send(new BlobHostMsg_FinishBuilding(
       url, data.contentType().utf8().data()));
 }
@@ -5,10 +5,17 @@
 #ifndef CONTENT_CHILD_FILEAPI_WEBBLOBREGISTRY_IMPL_H_
 #define CONTENT_CHILD_FILEAPI_WEBBLOBREGISTRY_IMPL_H_
 
+#include <string>
+
 #include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
 #include "third_party/WebKit/public/platform/WebBlobRegistry.h"
 #include "webkit/common/blob/blob_data.h"
 
+namespace base {
+class SharedMemory;
+}
+
 namespace WebKit {
 class WebBlobData;
 class WebString;
@@ -40,8 +47,15 @@ class WebBlobRegistryImpl : public WebKit::WebBlobRegistry {
   virtual void unregisterStreamURL(const WebKit::WebURL& url);
 
  private:
+  // Sends |data| as a bytes item, through |shared_memory| if it is large,
+  // allocating or growing the segment as needed.
   void SendDataForBlob(const WebKit::WebURL& url,
-                       const WebKit::WebThreadSafeData& data);
+                       const char* data,
+                       size_t data_size,
+                       scoped_ptr<base::SharedMemory>* shared_memory);
+  void FlushPendingDataForBlob(const WebKit::WebURL& url,
+                               std::string* pending_data,
+                               scoped_ptr<base::SharedMemory>* shared_memory);
 
   scoped_refptr<ThreadSafeSender> sender_;
 };
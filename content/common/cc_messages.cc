@@ -382,8 +382,7 @@ void ParamTraits<cc::RenderPass>::Write(
         break;
     }
 
-    const cc::ScopedPtrVector<cc::SharedQuadState>& sqs_list =
-        p.shared_quad_state_list;
+    const cc::SharedQuadStateList& sqs_list = p.shared_quad_state_list;
 
     // This is an invalid index.
     size_t bad_index = sqs_list.size();
@@ -412,13 +411,17 @@ void ParamTraits<cc::RenderPass>::Write(
   }
 }
 
+// Reads the quad straight into the storage of |quad_list|, which saves an
+// allocation per quad. The quad is appended even if it can't be read, but then
+// the whole render pass is thrown away.
 template<typename QuadType>
-static scoped_ptr<cc::DrawQuad> ReadDrawQuad(const Message* m,
-                                             PickleIterator* iter) {
-  scoped_ptr<QuadType> quad = QuadType::Create();
-  if (!ReadParam(m, iter, quad.get()))
-    return scoped_ptr<QuadType>().template PassAs<cc::DrawQuad>();
-  return quad.template PassAs<cc::DrawQuad>();
+static cc::DrawQuad* ReadDrawQuad(const Message* m,
+                                  PickleIterator* iter,
+                                  cc::QuadList* quad_list) {
+  QuadType* quad = quad_list->AllocateAndConstruct<QuadType>();
+  if (!ReadParam(m, iter, quad))
+    return NULL;
+  return quad;
 }
 
 bool ParamTraits<cc::RenderPass>::Read(
@@ -450,12 +453,13 @@ bool ParamTraits<cc::RenderPass>::Read(
             has_occlusion_from_outside_target_surface);
 
   for (size_t i = 0; i < shared_quad_state_list_size; ++i) {
-    scoped_ptr<cc::SharedQuadState> state(cc::SharedQuadState::Create());
-    if (!ReadParam(m, iter, state.get()))
+    cc::SharedQuadState* state =
+        p->shared_quad_state_list.AllocateAndConstruct<cc::SharedQuadState>();
+    if (!ReadParam(m, iter, state))
       return false;
-    p->shared_quad_state_list.push_back(state.Pass());
   }
 
+  cc::QuadList* quad_list = &p->quad_list;
   size_t last_shared_quad_state_index = 0;
   for (size_t i = 0; i < quad_list_size; ++i) {
     cc::DrawQuad::Material material;
@@ -463,37 +467,37 @@ bool ParamTraits<cc::RenderPass>::Read(
     if (!ReadParam(m, &temp_iter, &material))
       return false;
 
-    scoped_ptr<cc::DrawQuad> draw_quad;
+    cc::DrawQuad* draw_quad = NULL;
     switch (material) {
       case cc::DrawQuad::CHECKERBOARD:
-        draw_quad = ReadDrawQuad<cc::CheckerboardDrawQuad>(m, iter);
+        draw_quad = ReadDrawQuad<cc::CheckerboardDrawQuad>(m, iter, quad_list);
         break;
       case cc::DrawQuad::DEBUG_BORDER:
-        draw_quad = ReadDrawQuad<cc::DebugBorderDrawQuad>(m, iter);
+        draw_quad = ReadDrawQuad<cc::DebugBorderDrawQuad>(m, iter, quad_list);
         break;
       case cc::DrawQuad::IO_SURFACE_CONTENT:
-        draw_quad = ReadDrawQuad<cc::IOSurfaceDrawQuad>(m, iter);
+        draw_quad = ReadDrawQuad<cc::IOSurfaceDrawQuad>(m, iter, quad_list);
         break;
       case cc::DrawQuad::PICTURE_CONTENT:
         NOTREACHED();
         return false;
       case cc::DrawQuad::TEXTURE_CONTENT:
-        draw_quad = ReadDrawQuad<cc::TextureDrawQuad>(m, iter);
+        draw_quad = ReadDrawQuad<cc::TextureDrawQuad>(m, iter, quad_list);
         break;
       case cc::DrawQuad::RENDER_PASS:
-        draw_quad = ReadDrawQuad<cc::RenderPassDrawQuad>(m, iter);
+        draw_quad = ReadDrawQuad<cc::RenderPassDrawQuad>(m, iter, quad_list);
         break;
       case cc::DrawQuad::SOLID_COLOR:
-        draw_quad = ReadDrawQuad<cc::SolidColorDrawQuad>(m, iter);
+        draw_quad = ReadDrawQuad<cc::SolidColorDrawQuad>(m, iter, quad_list);
         break;
       case cc::DrawQuad::TILED_CONTENT:
-        draw_quad = ReadDrawQuad<cc::TileDrawQuad>(m, iter);
+        draw_quad = ReadDrawQuad<cc::TileDrawQuad>(m, iter, quad_list);
         break;
       case cc::DrawQuad::STREAM_VIDEO_CONTENT:
-        draw_quad = ReadDrawQuad<cc::StreamVideoDrawQuad>(m, iter);
+        draw_quad = ReadDrawQuad<cc::StreamVideoDrawQuad>(m, iter, quad_list);
         break;
       case cc::DrawQuad::YUV_VIDEO_CONTENT:
-        draw_quad = ReadDrawQuad<cc::YUVVideoDrawQuad>(m, iter);
+        draw_quad = ReadDrawQuad<cc::YUVVideoDrawQuad>(m, iter, quad_list);
         break;
       case cc::DrawQuad::INVALID:
         break;
@@ -512,8 +516,6 @@ bool ParamTraits<cc::RenderPass>::Read(
 
     draw_quad->shared_quad_state =
         p->shared_quad_state_list[shared_quad_state_index];
-
-    p->quad_list.push_back(draw_quad.Pass());
   }
 
   return true;
@@ -71,9 +71,11 @@ IPC_MESSAGE_CONTROL1(ChildProcessMsg_SetIPCLoggingEnabled,
                      bool /* on or off */)
 #endif
 
-// Tell the child process to enable or disable the profiler status.
-IPC_MESSAGE_CONTROL1(ChildProcessMsg_SetProfilerStatus,
-                     tracked_objects::ThreadData::Status /* profiler status */)
+// Tell the child process to enable or disable the profiler status, and how
+// many task runs to count for each one that it times.
+IPC_MESSAGE_CONTROL2(ChildProcessMsg_SetProfilerStatus,
+                     tracked_objects::ThreadData::Status /* profiler status */,
+                     int32 /* sampling interval */)
 
 // Send to all the child processes to send back profiler data (ThreadData in
 // tracked_objects).
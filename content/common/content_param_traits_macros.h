@@ -30,6 +30,7 @@ IPC_STRUCT_TRAITS_END()
 IPC_STRUCT_TRAITS_BEGIN(ui::LatencyInfo)
   IPC_STRUCT_TRAITS_MEMBER(latency_components)
   IPC_STRUCT_TRAITS_MEMBER(swap_timestamp)
+  IPC_STRUCT_TRAITS_MEMBER(trace_id)
 IPC_STRUCT_TRAITS_END()
 
 #endif  // CONTENT_COMMON_CONTENT_PARAM_TRAITS_MACROS_H_
@@ -39,6 +39,9 @@ class CONTENT_EXPORT DOMStorageMap
   // Writes a copy of the current set of values_ to the |map|.
   void ExtractValues(DOMStorageValuesMap* map) const { *map = values_; }
 
+  // Returns the current set of values_ without copying them.
+  const DOMStorageValuesMap& values() const { return values_; }
+
   // Creates a new instance of DOMStorageMap containing
   // a deep copy of values_.
   DOMStorageMap* DeepCopy() const;
@@ -726,6 +726,11 @@ gpu::PreemptionFlag* GpuChannel::GetPreemptionFlag() {
         FROM_HERE, base::Bind(
             &GpuChannelMessageFilter::SetPreemptingFlagAndSchedulingState,
             filter_, preempting_flag_, num_stubs_descheduled_ > 0));
+
+    for (StubMap::Iterator<GpuCommandBufferStub> it(&stubs_);
+         !it.IsAtEnd(); it.Advance()) {
+      it.GetCurrentValue()->UpdateSchedulingPriority();
+    }
   }
   return preempting_flag_.get();
 }
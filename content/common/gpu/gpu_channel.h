@@ -138,6 +138,12 @@ class GpuChannel : public IPC::Listener,
 
   gpu::PreemptionFlag* GetPreemptionFlag();
 
+  // True once GetPreemptionFlag() was called, which only the channel of the
+  // browser compositor has done.
+  bool preempts_other_channels() const {
+    return preempting_flag_.get() != NULL;
+  }
+
   bool handle_messages_scheduled() const { return handle_messages_scheduled_; }
   uint64 messages_processed() const { return messages_processed_; }
 
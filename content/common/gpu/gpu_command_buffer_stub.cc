@@ -8,6 +8,7 @@
 #include "base/debug/trace_event.h"
 #include "base/hash.h"
 #include "base/memory/shared_memory.h"
+#include "base/metrics/histogram.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
 #include "content/common/gpu/gpu_channel.h"
@@ -98,6 +99,25 @@ const int64 kHandleMoreWorkPeriodBusyMs = 1;
 // Prevents idle work from being starved.
 const int64 kMaxTimeSinceIdleMs = 10;
 
+// How long a stub of each scheduling priority may process commands before it
+// yields to other stubs. The browser compositor is never made to yield, and
+// is also the only one that preempts other channels.
+base::TimeDelta TimeSliceForPriority(
+    GpuCommandBufferStub::SchedulingPriority priority) {
+  switch (priority) {
+    case GpuCommandBufferStub::SCHEDULING_PRIORITY_BROWSER_UI:
+      return base::TimeDelta();
+    case GpuCommandBufferStub::SCHEDULING_PRIORITY_VISIBLE:
+      return base::TimeDelta::FromMilliseconds(8);
+    case GpuCommandBufferStub::SCHEDULING_PRIORITY_OFFSCREEN:
+      return base::TimeDelta::FromMilliseconds(4);
+    case GpuCommandBufferStub::SCHEDULING_PRIORITY_HIDDEN:
+      return base::TimeDelta::FromMilliseconds(2);
+  }
+  NOTREACHED();
+  return base::TimeDelta();
+}
+
 }  // namespace
 
 GpuCommandBufferStub::GpuCommandBufferStub(
@@ -129,6 +149,8 @@ GpuCommandBufferStub::GpuCommandBufferStub(
       surface_id_(surface_id),
       software_(software),
       last_flush_count_(0),
+      surface_visible_(true),
+      scheduling_priority_(SCHEDULING_PRIORITY_OFFSCREEN),
       last_memory_allocation_valid_(false),
       watchdog_(watchdog),
       sync_point_wait_count_(0),
@@ -410,6 +432,7 @@ void GpuCommandBufferStub::OnInitialize(
                                          decoder_.get()));
   if (preemption_flag_.get())
     scheduler_->SetPreemptByFlag(preemption_flag_);
+  UpdateSchedulingPriority();
 
   decoder_->set_engine(scheduler_.get());
 
@@ -631,7 +654,10 @@ void GpuCommandBufferStub::OnAsyncFlush(int32 put_offset,
   DCHECK(command_buffer_.get());
   if (flush_count - last_flush_count_ < 0x8000000U) {
     last_flush_count_ = flush_count;
+    if (first_pending_flush_time_.is_null())
+      first_pending_flush_time_ = base::TimeTicks::Now();
     command_buffer_->Flush(put_offset);
+    ReportFlushLatencyIfDone();
   } else {
     // We received this message out-of-order. This should not happen but is here
     // to catch regressions. Ignore the message.
@@ -644,6 +670,7 @@ void GpuCommandBufferStub::OnAsyncFlush(int32 put_offset,
 void GpuCommandBufferStub::OnRescheduled() {
   gpu::CommandBuffer::State pre_state = command_buffer_->GetLastState();
   command_buffer_->Flush(pre_state.put_offset);
+  ReportFlushLatencyIfDone();
   gpu::CommandBuffer::State post_state = command_buffer_->GetLastState();
 
   if (pre_state.get_offset != post_state.get_offset)
@@ -731,6 +758,8 @@ void GpuCommandBufferStub::OnSetSurfaceVisible(bool visible) {
   TRACE_EVENT0("gpu", "GpuCommandBufferStub::OnSetSurfaceVisible");
   if (memory_manager_client_state_)
     memory_manager_client_state_->SetVisible(visible);
+  surface_visible_ = visible;
+  UpdateSchedulingPriority();
 }
 
 void GpuCommandBufferStub::OnDiscardBackbuffer() {
@@ -885,6 +914,42 @@ void GpuCommandBufferStub::SetPreemptByFlag(
     scheduler_->SetPreemptByFlag(preemption_flag_);
 }
 
+void GpuCommandBufferStub::UpdateSchedulingPriority() {
+  if (channel_->preempts_other_channels())
+    scheduling_priority_ = SCHEDULING_PRIORITY_BROWSER_UI;
+  else if (handle_.is_null())
+    scheduling_priority_ = SCHEDULING_PRIORITY_OFFSCREEN;
+  else if (surface_visible_)
+    scheduling_priority_ = SCHEDULING_PRIORITY_VISIBLE;
+  else
+    scheduling_priority_ = SCHEDULING_PRIORITY_HIDDEN;
+
+  if (scheduler_)
+    scheduler_->SetTimeSlice(TimeSliceForPriority(scheduling_priority_));
+}
+
+void GpuCommandBufferStub::ReportFlushLatencyIfDone() {
+  if (first_pending_flush_time_.is_null() || HasUnprocessedCommands())
+    return;
+
+  base::TimeDelta latency = base::TimeTicks::Now() - first_pending_flush_time_;
+  first_pending_flush_time_ = base::TimeTicks();
+  switch (scheduling_priority_) {
+    case SCHEDULING_PRIORITY_BROWSER_UI:
+      UMA_HISTOGRAM_TIMES("GPU.FlushLatency.BrowserUI", latency);
+      break;
+    case SCHEDULING_PRIORITY_VISIBLE:
+      UMA_HISTOGRAM_TIMES("GPU.FlushLatency.Visible", latency);
+      break;
+    case SCHEDULING_PRIORITY_OFFSCREEN:
+      UMA_HISTOGRAM_TIMES("GPU.FlushLatency.Offscreen", latency);
+      break;
+    case SCHEDULING_PRIORITY_HIDDEN:
+      UMA_HISTOGRAM_TIMES("GPU.FlushLatency.Hidden", latency);
+      break;
+  }
+}
+
 bool GpuCommandBufferStub::GetTotalGpuMemory(uint64* bytes) {
   *bytes = total_gpu_memory_;
   return !!total_gpu_memory_;
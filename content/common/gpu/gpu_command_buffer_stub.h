@@ -62,6 +62,20 @@ class GpuCommandBufferStub
   typedef base::Callback<void(const ui::LatencyInfo&)>
       LatencyInfoCallback;
 
+  // Decides how long the stub may process commands before it yields to the
+  // others. Higher priorities get longer time slices.
+  enum SchedulingPriority {
+    // Contexts on the channel of the browser compositor, which preempts the
+    // channels of the contexts it composites.
+    SCHEDULING_PRIORITY_BROWSER_UI,
+    // Onscreen contexts with a visible surface, like renderer compositors.
+    SCHEDULING_PRIORITY_VISIBLE,
+    // Offscreen contexts, mostly WebGL.
+    SCHEDULING_PRIORITY_OFFSCREEN,
+    // Onscreen contexts with a hidden surface.
+    SCHEDULING_PRIORITY_HIDDEN
+  };
+
   GpuCommandBufferStub(
       GpuChannel* channel,
       GpuCommandBufferStub* share_group,
@@ -135,6 +149,14 @@ class GpuCommandBufferStub
 
   void SetPreemptByFlag(scoped_refptr<gpu::PreemptionFlag> flag);
 
+  SchedulingPriority scheduling_priority() const {
+    return scheduling_priority_;
+  }
+
+  // Recomputes the scheduling priority, e.g. after the channel started
+  // preempting other channels.
+  void UpdateSchedulingPriority();
+
   void SetLatencyInfoCallback(const LatencyInfoCallback& callback);
 
   void MarkContextLost();
@@ -201,6 +223,10 @@ class GpuCommandBufferStub
 
   bool CheckContextLost();
 
+  // Records how long it took from the first flush since the command buffer
+  // was last empty until it got empty again, if it just did.
+  void ReportFlushLatencyIfDone();
+
   // The lifetime of objects of this class is managed by a GpuChannel. The
   // GpuChannels destroy all the GpuCommandBufferStubs that they own when they
   // are destroyed. So a raw pointer is safe.
@@ -220,6 +246,9 @@ class GpuCommandBufferStub
   int32 surface_id_;
   bool software_;
   uint32 last_flush_count_;
+  bool surface_visible_;
+  SchedulingPriority scheduling_priority_;
+  base::TimeTicks first_pending_flush_time_;
 
   scoped_ptr<gpu::CommandBufferService> command_buffer_;
   scoped_ptr<gpu::gles2::GLES2Decoder> decoder_;
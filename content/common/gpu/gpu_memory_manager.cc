@@ -318,6 +318,7 @@ void GpuMemoryManager::SetClientStateVisible(
 
   RemoveClientFromList(client_state);
   client_state->visible_ = visible;
+  client_state->managed_memory_stats_received_since_visible_ = false;
   AddClientToList(client_state);
 
   TrackValueChanged(client_state->managed_memory_stats_.bytes_allocated, 0,
@@ -341,6 +342,10 @@ void GpuMemoryManager::SetClientStateManagedMemoryStats(
                         &bytes_allocated_managed_visible_ :
                         &bytes_allocated_managed_nonvisible_);
   client_state->managed_memory_stats_ = stats;
+  if (client_state->visible_) {
+    client_state->visible_managed_memory_stats_ = stats;
+    client_state->managed_memory_stats_received_since_visible_ = true;
+  }
 
   // If this is the first time that stats have been received for this
   // client, use them immediately.
@@ -470,16 +475,15 @@ uint64 GpuMemoryManager::ComputeClientAllocationWhenVisible(
     uint64 bytes_above_required_cap,
     uint64 bytes_above_minimum_cap,
     uint64 bytes_overall_cap) {
-  GpuManagedMemoryStats* stats = &client_state->managed_memory_stats_;
-
   if (!client_state->managed_memory_stats_received_)
     return GetDefaultClientAllocation();
 
-  uint64 bytes_required = 9 * stats->bytes_required / 8;
+  GpuManagedMemoryStats stats = GetStatsForAllocationWhenVisible(client_state);
+  uint64 bytes_required = 9 * stats.bytes_required / 8;
   bytes_required = std::min(bytes_required, GetMaximumClientAllocation());
   bytes_required = std::max(bytes_required, GetMinimumClientAllocation());
 
-  uint64 bytes_nicetohave = 4 * stats->bytes_nice_to_have / 3;
+  uint64 bytes_nicetohave = 4 * stats.bytes_nice_to_have / 3;
   bytes_nicetohave = std::min(bytes_nicetohave, GetMaximumClientAllocation());
   bytes_nicetohave = std::max(bytes_nicetohave, GetMinimumClientAllocation());
   bytes_nicetohave = std::max(bytes_nicetohave, bytes_required);
@@ -503,6 +507,22 @@ uint64 GpuMemoryManager::ComputeClientAllocationWhenNonvisible(
   return 9 * client_state->managed_memory_stats_.bytes_required / 8;
 }
 
+GpuManagedMemoryStats GpuMemoryManager::GetStatsForAllocationWhenVisible(
+    GpuMemoryManagerClientState* client_state) const {
+  GpuManagedMemoryStats stats = client_state->managed_memory_stats_;
+  if (client_state->visible_ &&
+      client_state->managed_memory_stats_received_since_visible_)
+    return stats;
+
+  const GpuManagedMemoryStats& visible_stats =
+      client_state->visible_managed_memory_stats_;
+  stats.bytes_required = std::max(stats.bytes_required,
+                                  visible_stats.bytes_required);
+  stats.bytes_nice_to_have = std::max(stats.bytes_nice_to_have,
+                                      visible_stats.bytes_nice_to_have);
+  return stats;
+}
+
 void GpuMemoryManager::ComputeVisibleSurfacesAllocations() {
   uint64 bytes_available_total = GetAvailableGpuMemory();
   uint64 bytes_above_required_cap = std::numeric_limits<uint64>::max();
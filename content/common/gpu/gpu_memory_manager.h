@@ -129,6 +129,14 @@ class CONTENT_EXPORT GpuMemoryManager :
   uint64 ComputeClientAllocationWhenNonvisible(
       GpuMemoryManagerClientState* client_state);
 
+  // The statistics to compute a client's budget when visible from. Until a
+  // client reports after becoming visible, its statistics only cover what it
+  // keeps while nonvisible, so the larger of those and what it last reported
+  // while visible is used. This gives clients that become visible again the
+  // budget they had, instead of a small one that makes them re-raster.
+  GpuManagedMemoryStats GetStatsForAllocationWhenVisible(
+      GpuMemoryManagerClientState* client_state) const;
+
   // Update the amount of GPU memory we think we have in the system, based
   // on what the stubs' contexts report.
   void UpdateAvailableGpuMemory();
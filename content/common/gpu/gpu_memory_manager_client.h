@@ -85,6 +85,11 @@ class CONTENT_EXPORT GpuMemoryManagerClientState {
   GpuManagedMemoryStats managed_memory_stats_;
   bool managed_memory_stats_received_;
 
+  // The statistics last received while this client was visible, and whether
+  // any have been received since it last became visible.
+  GpuManagedMemoryStats visible_managed_memory_stats_;
+  bool managed_memory_stats_received_since_visible_;
+
   // When managed_memory_stats_.bytes_nicetohave leaves the range
   // [low_, high_], then re-adjust memory limits.
   uint64 bytes_nicetohave_limit_low_;
@@ -761,6 +761,36 @@ TEST_F(GpuMemoryManagerTest, BackgroundDiscardPersistent) {
   EXPECT_GE(stub2.BytesWhenNotVisible(), bytes_when_not_visible_expected);
 }
 
+// Test that a client that becomes visible again is budgeted for what it
+// needed when it was last visible, not for what it keeps while nonvisible.
+TEST_F(GpuMemoryManagerTest, VisibleBudgetOutlivesNonvisibleStats) {
+  memmgr_.TestingSetAvailableGpuMemory(64);
+  memmgr_.TestingSetMinimumClientAllocation(8);
+
+  FakeClient stub1(&memmgr_, GenerateUniqueSurfaceId(), true);
+  FakeClient stub2(&memmgr_, GenerateUniqueSurfaceId(), true);
+
+  SetClientStats(&stub1, 16, 24);
+  SetClientStats(&stub2, 16, 24);
+  Manage();
+  EXPECT_GE(stub1.BytesWhenVisible(), 24u);
+
+  // While nonvisible, stub 1 reports much smaller needs, but is still
+  // promised its full budget for when it becomes visible.
+  stub1.SetVisible(false);
+  SetClientStats(&stub1, 2, 4);
+  Manage();
+  EXPECT_GE(stub1.BytesWhenVisible(), 24u);
+
+  // It keeps that budget once visible, until it reports again.
+  stub1.SetVisible(true);
+  Manage();
+  EXPECT_GE(stub1.BytesWhenVisible(), 24u);
+  SetClientStats(&stub1, 2, 4);
+  Manage();
+  EXPECT_LT(stub1.BytesWhenVisible(), stub2.BytesWhenVisible());
+}
+
 // Test tracking of unmanaged (e.g, WebGL) memory.
 TEST_F(GpuMemoryManagerTest, UnmanagedTracking) {
   // Set memory manager constants for this test
@@ -252,6 +252,8 @@ bool PassThroughImageTransportSurface::SwapBuffers() {
   SendVSyncUpdateIfAvailable();
   bool result = gfx::GLSurfaceAdapter::SwapBuffers();
   latency_info_.swap_timestamp = base::TimeTicks::HighResNow();
+  latency_info_.AddFirstLatencyNumber(
+      ui::INPUT_EVENT_LATENCY_GPU_SWAP_COMPONENT);
 
   if (transport_) {
     DCHECK(!is_swap_buffers_pending_);
@@ -275,6 +277,8 @@ bool PassThroughImageTransportSurface::PostSubBuffer(
   SendVSyncUpdateIfAvailable();
   bool result = gfx::GLSurfaceAdapter::PostSubBuffer(x, y, width, height);
   latency_info_.swap_timestamp = base::TimeTicks::HighResNow();
+  latency_info_.AddFirstLatencyNumber(
+      ui::INPUT_EVENT_LATENCY_GPU_SWAP_COMPONENT);
 
   if (transport_) {
     DCHECK(!is_swap_buffers_pending_);
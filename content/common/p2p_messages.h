@@ -22,6 +22,11 @@ IPC_STRUCT_TRAITS_BEGIN(net::NetworkInterface)
   IPC_STRUCT_TRAITS_MEMBER(address)
 IPC_STRUCT_TRAITS_END()
 
+IPC_STRUCT_TRAITS_BEGIN(content::P2PReceivedPacket)
+  IPC_STRUCT_TRAITS_MEMBER(address)
+  IPC_STRUCT_TRAITS_MEMBER(data)
+IPC_STRUCT_TRAITS_END()
+
 // P2P Socket messages sent from the browser to the renderer.
 
 IPC_MESSAGE_CONTROL1(P2PMsg_NetworkListChanged,
@@ -50,6 +55,12 @@ IPC_MESSAGE_CONTROL3(P2PMsg_OnDataReceived,
                      net::IPEndPoint /* socket_address */,
                      std::vector<char> /* data */)
 
+// Sent instead of P2PMsg_OnDataReceived when a socket has received several
+// packets at once.
+IPC_MESSAGE_CONTROL2(P2PMsg_OnDataReceivedBatch,
+                     int /* socket_id */,
+                     std::vector<content::P2PReceivedPacket> /* packets */)
+
 // P2P Socket messages sent from the renderer to the browser.
 
 // Start/stop sending P2PMsg_NetworkListChanged messages when network
@@ -8,6 +8,10 @@
 #ifndef CONTENT_COMMON_P2P_SOCKETS_H_
 #define CONTENT_COMMON_P2P_SOCKETS_H_
 
+#include <vector>
+
+#include "net/base/ip_endpoint.h"
+
 namespace content {
 
 // Type of P2P Socket.
@@ -23,6 +27,12 @@ enum P2PSocketType {
   P2P_SOCKET_STUN_TLS_CLIENT,
 };
 
+// A packet received by a P2P socket, as sent in P2PMsg_OnDataReceivedBatch.
+struct P2PReceivedPacket {
+  net::IPEndPoint address;
+  std::vector<char> data;
+};
+
 }  // namespace content
 
 #endif  // CONTENT_COMMON_P2P_SOCKETS_H_
@@ -200,6 +200,14 @@ IPC_STRUCT_BEGIN(ResourceHostMsg_Request)
   IPC_STRUCT_MEMBER(bool, allow_download)
 IPC_STRUCT_END()
 
+// A byte range of the shared memory buffer provided by the SetDataBuffer
+// message, holding response data.
+IPC_STRUCT_BEGIN(ResourceMsg_DataChunk)
+  IPC_STRUCT_MEMBER(int, data_offset)
+  IPC_STRUCT_MEMBER(int, data_length)
+  IPC_STRUCT_MEMBER(int, encoded_data_length)
+IPC_STRUCT_END()
+
 // Resource messages sent from the browser to the renderer.
 
 // Sent when the headers are available for a resource request.
@@ -252,6 +260,14 @@ IPC_MESSAGE_ROUTED4(ResourceMsg_DataReceived,
                     int /* data_length */,
                     int /* encoded_data_length */)
 
+// Sent instead of DataReceived when more data became ready while the renderer
+// was processing the previous DataReceived or DataReceivedBatch message.  The
+// chunks are in the order in which they should be consumed, and a single
+// DataReceived_ACK acknowledges all of them.
+IPC_MESSAGE_ROUTED2(ResourceMsg_DataReceivedBatch,
+                    int /* request_id */,
+                    std::vector<ResourceMsg_DataChunk> /* chunks */)
+
 // Sent when some data from a resource request has been downloaded to
 // file. This is only called in the 'download_to_file' case and replaces
 // ResourceMsg_DataReceived in the call sequence in that case.
@@ -291,8 +307,8 @@ IPC_SYNC_MESSAGE_ROUTED2_1(ResourceHostMsg_SyncLoad,
                            ResourceHostMsg_Request,
                            content::SyncLoadResult)
 
-// Sent when the renderer process is done processing a DataReceived
-// message.
+// Sent when the renderer process is done processing a DataReceived or
+// DataReceivedBatch message.
 IPC_MESSAGE_ROUTED1(ResourceHostMsg_DataReceived_ACK,
                     int /* request_id */)
 
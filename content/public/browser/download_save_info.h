@@ -38,6 +38,10 @@ struct CONTENT_EXPORT DownloadSaveInfo {
   // The state of the hash at the start of the download.  May be empty.
   std::string hash_state;
 
+  // The number of bytes the download is expected to add after |offset|, used
+  // to reserve space for the file up front.  0 if unknown.
+  int64 expected_size;
+
   // If |prompt_for_save_location| is true, and |file_path| is empty, then
   // the user will be prompted for a location to save the download. Otherwise,
   // the location will be determined automatically using |file_path| as a
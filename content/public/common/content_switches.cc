@@ -412,6 +412,12 @@ const char kEnableLogging[]                 = "enable-logging";
 // Enables the memory benchmarking extension
 const char kEnableMemoryBenchmarking[]      = "enable-memory-benchmarking";
 
+// Keeps heap profiling running in the browser process, so that heap memory
+// can be attributed to subsystems in about:memory. Only has an effect in
+// builds with tcmalloc.
+const char kEnableMemorySubsystemProfiling[] =
+    "enable-memory-subsystem-profiling";
+
 // On Windows, converts the page to the currently-installed monitor profile.
 // This does NOT enable color management for images. The source is still
 // assumed to be sRGB.
@@ -430,6 +436,11 @@ const char kEnableOverlayScrollbars[]       = "enable-overlay-scrollbars";
 // Forward overscroll event data from the renderer to the browser.
 const char kEnableOverscrollNotifications[] = "enable-overscroll-notifications";
 
+// Composite Pepper Graphics2D plugins through a texture layer that is updated
+// with only the damaged parts of each flush, instead of having WebKit repaint
+// them, when the page uses accelerated compositing.
+const char kEnablePepper2DCompositing[]     = "enable-pepper-2d-compositing";
+
 // Enables compositor-accelerated touch-screen pinch gestures.
 const char kEnablePinch[]                   = "enable-pinch";
 
@@ -513,6 +524,10 @@ const char kEnableVirtualGLContexts[]       = "enable-virtual-gl-contexts";
 // Enables moving cursor by word in visual order.
 const char kEnableVisualWordMovement[]      = "enable-visual-word-movement";
 
+// Send at most one mouse move, mouse wheel and touch move event to the
+// renderer per vsync interval, coalescing the events that arrive in between.
+const char kEnableVSyncAlignedInput[]       = "enable-vsync-aligned-input";
+
 // Enable the Vtune profiler support.
 const char kEnableVtune[]                   = "enable-vtune-support";
 
@@ -127,11 +127,13 @@ extern const char kEnableHTMLImports[];
 CONTENT_EXPORT extern const char kEnableInbandTextTracks[];
 CONTENT_EXPORT extern const char kEnableLogging[];
 extern const char kEnableMemoryBenchmarking[];
+extern const char kEnableMemorySubsystemProfiling[];
 extern const char kEnableMonitorProfile[];
 extern const char kEnableNewMediaInternals[];
 CONTENT_EXPORT extern const char kEnableOfflineCacheAccess[];
 extern const char kEnableOverlayScrollbars[];
 CONTENT_EXPORT extern const char kEnableOverscrollNotifications[];
+extern const char kEnablePepper2DCompositing[];
 extern const char kEnablePinch[];
 extern const char kEnablePreparsedJsCaching[];
 CONTENT_EXPORT extern const char kEnablePrivilegedWebGLExtensions[];
@@ -153,6 +155,7 @@ extern const char kEnableUserMediaScreenCapturing[];
 extern const char kEnableViewport[];
 extern const char kEnableVirtualGLContexts[];
 extern const char kEnableVisualWordMovement[];
+CONTENT_EXPORT extern const char kEnableVSyncAlignedInput[];
 CONTENT_EXPORT extern const char kEnableVtune[];
 extern const char kEnableWebAnimationsCSS[];
 extern const char kEnableWebAnimationsSVG[];
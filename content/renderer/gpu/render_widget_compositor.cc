@@ -96,6 +96,8 @@ scoped_ptr<RenderWidgetCompositor> RenderWidgetCompositor::Create(
       !cmd->HasSwitch(switches::kDisableGpuVsync);
   settings.begin_frame_scheduling_enabled =
       cmd->HasSwitch(switches::kEnableBeginFrameScheduling);
+  settings.deadline_scheduling_enabled =
+      cmd->HasSwitch(cc::switches::kEnableDeadlineScheduling);
   settings.using_synchronous_renderer_compositor =
       widget->UsingSynchronousRendererCompositor();
   settings.per_tile_painting_enabled =
@@ -261,6 +263,10 @@ scoped_ptr<RenderWidgetCompositor> RenderWidgetCompositor::Create(
       cmd->HasSwitch(cc::switches::kStrictLayerPropertyChangeChecking);
 
   settings.use_map_image = cmd->HasSwitch(cc::switches::kUseMapImage);
+  settings.compress_low_priority_tiles =
+      cmd->HasSwitch(cc::switches::kCompressLowPriorityTiles);
+  settings.gpu_rasterization =
+      cmd->HasSwitch(cc::switches::kEnableGpuRasterization);
 
 #if defined(OS_ANDROID)
   // TODO(danakj): Move these to the android code.
@@ -1113,7 +1113,8 @@ void WebMediaPlayerImpl::StartPipeline(WebKit::WebMediaSource* media_source) {
   video_decoders.push_back(new media::VpxVideoDecoder(media_loop_));
 #endif  // !defined(MEDIA_DISABLE_LIBVPX)
 
-  video_decoders.push_back(new media::FFmpegVideoDecoder(media_loop_));
+  video_decoders.push_back(
+      new media::FFmpegVideoDecoder(media_loop_, media_log_));
 
   scoped_ptr<media::VideoRenderer> video_renderer(
       new media::VideoRendererBase(
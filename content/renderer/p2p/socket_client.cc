@@ -177,6 +177,22 @@ void P2PSocketClient::DeliverOnDataReceived(const net::IPEndPoint& address,
     delegate_->OnDataReceived(address, data);
 }
 
+void P2PSocketClient::OnDataReceivedBatch(
+    const std::vector<P2PReceivedPacket>& packets) {
+  DCHECK(ipc_message_loop_->BelongsToCurrentThread());
+  DCHECK_EQ(STATE_OPEN, state_);
+  delegate_message_loop_->PostTask(
+      FROM_HERE,
+      base::Bind(&P2PSocketClient::DeliverOnDataReceivedBatch, this, packets));
+}
+
+void P2PSocketClient::DeliverOnDataReceivedBatch(
+    const std::vector<P2PReceivedPacket>& packets) {
+  DCHECK(delegate_message_loop_->BelongsToCurrentThread());
+  for (size_t i = 0; i < packets.size() && delegate_; ++i)
+    delegate_->OnDataReceived(packets[i].address, packets[i].data);
+}
+
 void P2PSocketClient::Detach() {
   DCHECK(ipc_message_loop_->BelongsToCurrentThread());
   dispatcher_ = NULL;
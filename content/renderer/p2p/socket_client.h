@@ -87,6 +87,7 @@ class P2PSocketClient : public base::RefCountedThreadSafe<P2PSocketClient> {
   void OnError();
   void OnDataReceived(const net::IPEndPoint& address,
                       const std::vector<char>& data);
+  void OnDataReceivedBatch(const std::vector<P2PReceivedPacket>& packets);
 
   // Proxy methods that deliver messages to the delegate thread.
   void DeliverOnSocketCreated(const net::IPEndPoint& address);
@@ -97,6 +98,8 @@ class P2PSocketClient : public base::RefCountedThreadSafe<P2PSocketClient> {
   void DeliverOnError();
   void DeliverOnDataReceived(const net::IPEndPoint& address,
                              const std::vector<char>& data);
+  void DeliverOnDataReceivedBatch(
+      const std::vector<P2PReceivedPacket>& packets);
 
   // Scheduled on the IPC thread to finish initialization.
   void DoInit(P2PSocketType type,
@@ -101,6 +101,8 @@ class CONTENT_EXPORT P2PSocketDispatcher
   void OnError(int socket_id);
   void OnDataReceived(int socket_id, const net::IPEndPoint& address,
                       const std::vector<char>& data);
+  void OnDataReceivedBatch(int socket_id,
+                           const std::vector<P2PReceivedPacket>& packets);
 
   P2PSocketClient* GetClient(int socket_id);
 
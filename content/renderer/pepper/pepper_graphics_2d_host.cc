@@ -4,10 +4,15 @@
 
 #include "content/renderer/pepper/pepper_graphics_2d_host.h"
 
+#include <string.h>
+
 #include "base/bind.h"
 #include "base/debug/trace_event.h"
 #include "base/logging.h"
+#include "base/memory/shared_memory.h"
 #include "base/message_loop/message_loop.h"
+#include "cc/resources/texture_mailbox.h"
+#include "content/public/renderer/render_thread.h"
 #include "content/public/renderer/renderer_ppapi_host.h"
 #include "content/renderer/pepper/common.h"
 #include "content/renderer/pepper/gfx_conversion.h"
@@ -47,6 +52,9 @@ namespace {
 
 const int64 kOffscreenCallbackDelayMs = 1000 / 30;  // 30 fps
 
+// The number of backing store copies that can be with the compositor at once.
+const size_t kMailboxBufferCount = 2;
+
 // Converts a rect inside an image of the given dimensions. The rect may be
 // NULL to indicate it should be the entire image. If the rect is outside of
 // the image, this will do nothing and return false.
@@ -160,6 +168,35 @@ struct PepperGraphics2DHost::QueuedOperation {
   scoped_refptr<PPB_ImageData_Impl> replace_image;
 };
 
+// A shared memory copy of the backing store handed to the compositor, and the
+// part of it that is out of date.
+class PepperGraphics2DHost::MailboxBuffer
+    : public base::RefCounted<MailboxBuffer> {
+ public:
+  explicit MailboxBuffer(scoped_ptr<base::SharedMemory> memory)
+      : memory_(memory.Pass()),
+        in_use_(false) {
+  }
+
+  base::SharedMemory* memory() const { return memory_.get(); }
+
+  gfx::Rect& stale_rect() { return stale_rect_; }
+
+  // True while the compositor holds the buffer.
+  bool in_use() const { return in_use_; }
+  void set_in_use(bool in_use) { in_use_ = in_use; }
+
+ private:
+  friend class base::RefCounted<MailboxBuffer>;
+  ~MailboxBuffer() {}
+
+  scoped_ptr<base::SharedMemory> memory_;
+  gfx::Rect stale_rect_;
+  bool in_use_;
+
+  DISALLOW_COPY_AND_ASSIGN(MailboxBuffer);
+};
+
 // static
 PepperGraphics2DHost* PepperGraphics2DHost::Create(RendererPpapiHost* host,
                                                    PP_Instance instance,
@@ -184,6 +221,7 @@ PepperGraphics2DHost::PepperGraphics2DHost(RendererPpapiHost* host,
       bound_instance_(NULL),
       need_flush_ack_(false),
       offscreen_flush_pending_(false),
+      needs_new_mailbox_(true),
       is_always_opaque_(false),
       scale_(1.0f),
       weak_ptr_factory_(this),
@@ -309,6 +347,8 @@ bool PepperGraphics2DHost::BindToInstance(
       ScheduleOffscreenFlushAck();
   } else {
     // Devices being replaced, redraw the plugin.
+    MarkMailboxBuffersStale(
+        gfx::Rect(0, 0, image_data_->width(), image_data_->height()));
     new_instance->InvalidateRect(gfx::Rect());
   }
 
@@ -414,6 +454,56 @@ PPB_ImageData_Impl* PepperGraphics2DHost::ImageData() {
   return image_data_.get();
 }
 
+bool PepperGraphics2DHost::PrepareTextureMailbox(cc::TextureMailbox* mailbox) {
+  if (!needs_new_mailbox_)
+    return false;
+
+  scoped_refptr<MailboxBuffer> buffer;
+  for (size_t i = 0; i < mailbox_buffers_.size(); ++i) {
+    if (!mailbox_buffers_[i]->in_use()) {
+      buffer = mailbox_buffers_[i];
+      break;
+    }
+  }
+
+  const gfx::Size size(image_data_->width(), image_data_->height());
+  if (!buffer.get()) {
+    if (mailbox_buffers_.size() >= kMailboxBufferCount || !RenderThread::Get())
+      return false;
+    const size_t bytes = 4 * size.GetArea();
+    scoped_ptr<base::SharedMemory> memory =
+        RenderThread::Get()->HostAllocateSharedMemoryBuffer(bytes);
+    if (!memory || !memory->Map(bytes))
+      return false;
+    buffer = new MailboxBuffer(memory.Pass());
+    buffer->stale_rect() = gfx::Rect(size);
+    mailbox_buffers_.push_back(buffer);
+  }
+
+  // Only the parts that changed since the buffer was last handed out are
+  // copied.
+  ImageDataAutoMapper auto_mapper(image_data_.get());
+  const SkBitmap& backing_bitmap = *image_data_->GetMappedBitmap();
+  SkAutoLockPixels lock(backing_bitmap);
+  const gfx::Rect copy_rect =
+      gfx::IntersectRects(buffer->stale_rect(), gfx::Rect(size));
+  uint8* pixels = static_cast<uint8*>(buffer->memory()->memory());
+  for (int y = copy_rect.y(); y < copy_rect.bottom(); ++y) {
+    memcpy(pixels + (y * size.width() + copy_rect.x()) * 4,
+           backing_bitmap.getAddr32(copy_rect.x(), y),
+           copy_rect.width() * 4);
+  }
+
+  buffer->stale_rect() = gfx::Rect();
+  buffer->set_in_use(true);
+  needs_new_mailbox_ = false;
+  *mailbox = cc::TextureMailbox(
+      buffer->memory(), size,
+      base::Bind(&PepperGraphics2DHost::ReleaseMailboxBuffer,
+                 weak_ptr_factory_.GetWeakPtr(), buffer));
+  return true;
+}
+
 int32_t PepperGraphics2DHost::OnHostMsgPaintImageData(
     ppapi::host::HostMessageContext* context,
     const ppapi::HostResource& image_data,
@@ -583,6 +673,9 @@ int32_t PepperGraphics2DHost::Flush(PP_Resource* old_image_data) {
         break;
     }
 
+    if (!op_rect.IsEmpty())
+      MarkMailboxBuffersStale(op_rect);
+
     // For correctness with accelerated compositing, we must issue an invalidate
     // on the full op_rect even if it is partially or completely off-screen.
     // However, if we issue an invalidate for a clipped-out region, WebKit will
@@ -706,6 +799,28 @@ void PepperGraphics2DHost::ExecuteReplaceContents(PPB_ImageData_Impl* image,
                                 image_data_->width(), image_data_->height());
 }
 
+void PepperGraphics2DHost::MarkMailboxBuffersStale(const gfx::Rect& rect) {
+  for (size_t i = 0; i < mailbox_buffers_.size(); ++i)
+    mailbox_buffers_[i]->stale_rect().Union(rect);
+  needs_new_mailbox_ = true;
+}
+
+// static
+void PepperGraphics2DHost::ReleaseMailboxBuffer(
+    base::WeakPtr<PepperGraphics2DHost> host,
+    scoped_refptr<MailboxBuffer> buffer,
+    unsigned sync_point,
+    bool lost_resource) {
+  buffer->set_in_use(false);
+  if (!host.get())
+    return;
+
+  // If a flush came in while the compositor held every buffer, it could not
+  // be given a copy. Ask for another frame now that one is free.
+  if (host->needs_new_mailbox_ && host->bound_instance_)
+    host->bound_instance_->InvalidateRect(gfx::Rect());
+}
+
 void PepperGraphics2DHost::SendFlushAck() {
   host()->SendReply(flush_reply_context_,
                     PpapiPluginMsg_Graphics2D_FlushAck());
@@ -9,6 +9,7 @@
 
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "content/common/content_export.h"
 #include "ppapi/c/ppb_graphics_2d.h"
@@ -16,6 +17,10 @@
 #include "ppapi/host/resource_host.h"
 #include "third_party/WebKit/public/platform/WebCanvas.h"
 
+namespace cc {
+class TextureMailbox;
+}
+
 namespace gfx {
 class Point;
 class Rect;
@@ -68,7 +73,16 @@ class CONTENT_EXPORT PepperGraphics2DHost
   bool IsAlwaysOpaque() const;
   PPB_ImageData_Impl* ImageData();
 
+  // Fills |mailbox| with a shared memory copy of the backing store for the
+  // compositor, when the plugin is drawn through a texture layer. Returns
+  // false if the compositor already has the latest contents, or still holds
+  // every buffer; in the latter case the instance is invalidated once one is
+  // returned.
+  bool PrepareTextureMailbox(cc::TextureMailbox* mailbox);
+
  private:
+  class MailboxBuffer;
+
   PepperGraphics2DHost(RendererPpapiHost* host,
                        PP_Instance instance,
                        PP_Resource resource);
@@ -112,6 +126,17 @@ class CONTENT_EXPORT PepperGraphics2DHost
                               gfx::Rect* invalidated_rect,
                               PP_Resource* old_image_data);
 
+  // Records that |rect| of the backing store changed, so the copies of it
+  // that the compositor gets must be updated.
+  void MarkMailboxBuffersStale(const gfx::Rect& rect);
+
+  // Release callback for the mailboxes made by PrepareTextureMailbox(). The
+  // compositor may give |buffer| back after the host is gone.
+  static void ReleaseMailboxBuffer(base::WeakPtr<PepperGraphics2DHost> host,
+                                   scoped_refptr<MailboxBuffer> buffer,
+                                   unsigned sync_point,
+                                   bool lost_resource);
+
   void SendFlushAck();
 
   // Function scheduled to execute by ScheduleOffscreenFlushAck that actually
@@ -155,6 +180,15 @@ class CONTENT_EXPORT PepperGraphics2DHost
   // enforce the "only one pending flush at a time" constraint in the API.
   bool offscreen_flush_pending_;
 
+  // The shared memory copies of the backing store handed to the compositor.
+  // Two of them let the plugin's next flush be copied while the compositor
+  // draws the previous one.
+  std::vector<scoped_refptr<MailboxBuffer> > mailbox_buffers_;
+
+  // True if the backing store changed since the compositor was last given
+  // a copy of it.
+  bool needs_new_mailbox_;
+
   // Set to true if the plugin declares that this device will always be opaque.
   // This allows us to do more optimized painting in some cases.
   bool is_always_opaque_;
@@ -6,6 +6,7 @@
 
 #include "base/bind.h"
 #include "base/callback_helpers.h"
+#include "base/command_line.h"
 #include "base/debug/trace_event.h"
 #include "base/logging.h"
 #include "base/memory/linked_ptr.h"
@@ -17,6 +18,7 @@
 #include "base/time/time.h"
 #include "cc/layers/texture_layer.h"
 #include "content/common/content_constants_internal.h"
+#include "content/public/common/content_switches.h"
 #include "content/public/common/page_zoom.h"
 #include "content/public/renderer/content_renderer_client.h"
 #include "content/renderer/pepper/common.h"
@@ -450,6 +452,7 @@ PepperPluginInstanceImpl::PepperPluginInstanceImpl(
       pp_instance_(0),
       container_(container),
       layer_bound_to_fullscreen_(false),
+      layer_is_graphics_2d_(false),
       plugin_url_(plugin_url),
       full_frame_(false),
       sent_initial_did_change_view_(false),
@@ -594,6 +597,11 @@ void PepperPluginInstanceImpl::Delete() {
     fullscreen_container_ = NULL;
   }
   bound_graphics_3d_ = NULL;
+  // A Graphics2D layer has this instance as its client, so it must go now.
+  if (bound_graphics_2d_platform_) {
+    bound_graphics_2d_platform_->BindToInstance(NULL);
+    bound_graphics_2d_platform_ = NULL;
+  }
   UpdateLayer();
   container_ = NULL;
 }
@@ -625,6 +633,14 @@ void PepperPluginInstanceImpl::InvalidateRect(const gfx::Rect& rect) {
     if (!container_ ||
         view_data_.rect.size.width == 0 || view_data_.rect.size.height == 0)
       return;  // Nothing to do.
+    if (texture_layer_.get() && layer_is_graphics_2d_) {
+      // The compositor pulls the damaged parts of the Graphics2D itself.
+      if (rect.IsEmpty())
+        texture_layer_->SetNeedsDisplay();
+      else
+        texture_layer_->SetNeedsDisplayRect(rect);
+      return;
+    }
     if (rect.IsEmpty())
       container_->invalidate();
     else
@@ -1801,9 +1817,16 @@ void PepperPluginInstanceImpl::UpdateLayer() {
     PlatformContext3D* context = bound_graphics_3d_->platform_context();
     context->GetBackingMailbox(&mailbox);
   }
-  bool want_layer = !mailbox.IsZero();
+  // A Graphics2D gets a layer only in a composited page, and not in
+  // fullscreen, where the fullscreen widget paints it.
+  bool want_2d_layer = bound_graphics_2d_platform_ && !fullscreen_container_ &&
+      IsViewAccelerated() &&
+      CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnablePepper2DCompositing);
+  bool want_layer = !mailbox.IsZero() || want_2d_layer;
 
   if (want_layer == !!texture_layer_.get() &&
+      want_2d_layer == layer_is_graphics_2d_ &&
       layer_bound_to_fullscreen_ == !!fullscreen_container_)
     return;
 
@@ -1813,9 +1836,19 @@ void PepperPluginInstanceImpl::UpdateLayer() {
     else if (fullscreen_container_)
       fullscreen_container_->SetLayer(NULL);
     web_layer_.reset();
+    texture_layer_->ClearClient();
     texture_layer_ = NULL;
   }
-  if (want_layer) {
+  layer_is_graphics_2d_ = want_2d_layer;
+  if (want_2d_layer) {
+    texture_layer_ = cc::TextureLayer::CreateForMailbox(this);
+    web_layer_.reset(new webkit::WebLayerImpl(texture_layer_));
+    container_->setWebLayer(web_layer_.get());
+    // Shared memory is laid out top to bottom, unlike a GL texture.
+    texture_layer_->SetFlipped(false);
+    texture_layer_->SetContentsOpaque(
+        bound_graphics_2d_platform_->IsAlwaysOpaque());
+  } else if (want_layer) {
     DCHECK(bound_graphics_3d_.get());
     texture_layer_ = cc::TextureLayer::CreateForMailbox(NULL);
     web_layer_.reset(new webkit::WebLayerImpl(texture_layer_));
@@ -1835,6 +1868,23 @@ void PepperPluginInstanceImpl::UpdateLayer() {
   layer_bound_to_fullscreen_ = !!fullscreen_container_;
 }
 
+unsigned PepperPluginInstanceImpl::PrepareTexture() {
+  NOTREACHED();
+  return 0;
+}
+
+WebKit::WebGraphicsContext3D* PepperPluginInstanceImpl::Context3d() {
+  return NULL;
+}
+
+bool PepperPluginInstanceImpl::PrepareTextureMailbox(
+    cc::TextureMailbox* mailbox,
+    bool use_shared_memory) {
+  if (!bound_graphics_2d_platform_)
+    return false;
+  return bound_graphics_2d_platform_->PrepareTextureMailbox(mailbox);
+}
+
 void PepperPluginInstanceImpl::AddPluginObject(PluginObject* plugin_object) {
   DCHECK(live_plugin_objects_.find(plugin_object) ==
          live_plugin_objects_.end());
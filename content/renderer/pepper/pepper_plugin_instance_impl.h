@@ -114,7 +114,8 @@ class CONTENT_EXPORT PepperPluginInstanceImpl
     : public base::RefCounted<PepperPluginInstanceImpl>,
       public base::SupportsWeakPtr<PepperPluginInstanceImpl>,
       public NON_EXPORTED_BASE(PepperPluginInstance),
-      public ppapi::PPB_Instance_Shared {
+      public ppapi::PPB_Instance_Shared,
+      public NON_EXPORTED_BASE(cc::TextureLayerClient) {
  public:
   // Create and return a PepperPluginInstanceImpl object which supports the most
   // recent version of PPP_Instance possible by querying the given
@@ -365,6 +366,13 @@ class CONTENT_EXPORT PepperPluginInstanceImpl
                            const char* target,
                            bool from_user_action) OVERRIDE;
 
+  // cc::TextureLayerClient implementation, used when a bound Graphics2D is
+  // composited through |texture_layer_|.
+  virtual unsigned PrepareTexture() OVERRIDE;
+  virtual WebKit::WebGraphicsContext3D* Context3d() OVERRIDE;
+  virtual bool PrepareTextureMailbox(cc::TextureMailbox* mailbox,
+                                     bool use_shared_memory) OVERRIDE;
+
   // PPB_Instance_API implementation.
   virtual PP_Bool BindGraphics(PP_Instance instance,
                                PP_Resource device) OVERRIDE;
@@ -658,6 +666,8 @@ class CONTENT_EXPORT PepperPluginInstanceImpl
   scoped_refptr<cc::TextureLayer> texture_layer_;
   scoped_ptr<WebKit::WebLayer> web_layer_;
   bool layer_bound_to_fullscreen_;
+  // True if |texture_layer_| shows a Graphics2D rather than a Graphics3D.
+  bool layer_is_graphics_2d_;
 
   // Plugin URL.
   GURL plugin_url_;
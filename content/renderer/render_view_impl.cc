@@ -3598,6 +3598,8 @@ void RenderViewImpl::didStartProvisionalLoad(WebFrame* frame) {
 
   bool is_top_most = !frame->parent();
   if (is_top_most) {
+    TRACE_EVENT_INSTANT0("renderer", "RenderViewImpl::DidStartProvisionalLoad",
+                         TRACE_EVENT_SCOPE_THREAD);
     navigation_gesture_ = WebUserGestureIndicator::isProcessingUserGesture() ?
         NavigationGestureUser : NavigationGestureAuto;
 
@@ -5592,6 +5594,9 @@ void RenderViewImpl::DidFlushPaint() {
     if (data->did_first_visually_non_empty_layout() &&
         !data->did_first_visually_non_empty_paint()) {
       data->set_did_first_visually_non_empty_paint(true);
+      TRACE_EVENT_INSTANT0("renderer",
+                           "RenderViewImpl::DidFirstVisuallyNonEmptyPaint",
+                           TRACE_EVENT_SCOPE_THREAD);
       Send(new ViewHostMsg_DidFirstVisuallyNonEmptyPaint(routing_id_,
                                                          page_id_));
     }
@@ -798,10 +798,13 @@ void RenderWidget::OnHandleInputEvent(const WebKit::WebInputEvent* input_event,
   TRACE_EVENT1("renderer", "RenderWidget::OnHandleInputEvent",
                "event", event_name);
 
+  ui::LatencyInfo main_latency_info = latency_info;
+  main_latency_info.AddFirstLatencyNumber(
+      ui::INPUT_EVENT_LATENCY_RENDERER_MAIN_COMPONENT);
   if (compositor_)
-    compositor_->SetLatencyInfo(latency_info);
+    compositor_->SetLatencyInfo(main_latency_info);
   else
-    latency_info_.MergeWith(latency_info);
+    latency_info_.MergeWith(main_latency_info);
 
   base::TimeDelta now = base::TimeDelta::FromInternalValue(
       base::TimeTicks::Now().ToInternalValue());
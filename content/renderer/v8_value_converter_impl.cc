@@ -6,6 +6,7 @@
 
 #include <string>
 
+#include "base/debug/trace_event_memory.h"
 #include "base/float_util.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
@@ -111,6 +112,7 @@ void V8ValueConverterImpl::SetStrategy(Strategy* strategy) {
 
 v8::Handle<v8::Value> V8ValueConverterImpl::ToV8Value(
     const base::Value* value, v8::Handle<v8::Context> context) const {
+  TRACE_MEMORY_SUBSYSTEM("v8_bindings");
   v8::Context::Scope context_scope(context);
   v8::HandleScope handle_scope;
   return handle_scope.Close(ToV8ValueImpl(value));
@@ -119,6 +121,7 @@ v8::Handle<v8::Value> V8ValueConverterImpl::ToV8Value(
 Value* V8ValueConverterImpl::FromV8Value(
     v8::Handle<v8::Value> val,
     v8::Handle<v8::Context> context) const {
+  TRACE_MEMORY_SUBSYSTEM("v8_bindings");
   v8::Context::Scope context_scope(context);
   v8::HandleScope handle_scope;
   FromV8ValueState state(avoid_identity_hash_for_testing_);
@@ -24,6 +24,7 @@
 #include "content/common/set_process_title.h"
 #include "content/common/zygote_commands_linux.h"
 #include "content/public/common/content_descriptors.h"
+#include "content/public/common/content_switches.h"
 #include "content/public/common/result_codes.h"
 #include "content/public/common/sandbox_linux.h"
 #include "content/public/common/zygote_fork_delegate_linux.h"
@@ -40,6 +41,10 @@ namespace {
 void SIGCHLDHandler(int signal) {
 }
 
+// The number of renderers that are forked ahead of the browser's requests.
+// Each one costs a process, so this only needs to cover a burst of new tabs.
+const size_t kPreforkedRendererCount = 2;
+
 }  // namespace
 
 const int Zygote::kMagicSandboxIPCDescriptor;
@@ -93,7 +98,9 @@ bool Zygote::ProcessRequests() {
   }
 
   for (;;) {
-    // This function call can return multiple times, once per fork().
+    // These function calls can return multiple times, once per fork().
+    if (ReplenishPreforkedRenderers())
+      return true;
     if (HandleRequestFromBrowser(kBrowserDescriptor))
       return true;
   }
@@ -103,6 +110,98 @@ bool Zygote::UsingSUIDSandbox() const {
   return sandbox_flags_ & kSandboxLinuxSUID;
 }
 
+bool Zygote::ReplenishPreforkedRenderers() {
+  while (preforked_renderers_.size() < kPreforkedRendererCount) {
+    // Renderers that the fork helper starts can't be forked ahead of time.
+    std::string uma_name;
+    int uma_sample;
+    int uma_boundary_value;
+    if (helper_ && helper_->CanHelp(switches::kRendererProcess, &uma_name,
+                                    &uma_sample, &uma_boundary_value)) {
+      return false;
+    }
+
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sockets) != 0) {
+      PLOG(ERROR) << "Failed to create preforked renderer socket";
+      return false;
+    }
+
+    std::vector<int> fds;
+    base::ProcessId pid = ForkWithRealPid(switches::kRendererProcess, fds,
+                                          std::string(), &uma_name,
+                                          &uma_sample, &uma_boundary_value);
+    if (!pid) {
+      // This is the preforked renderer.
+      close(sockets[0]);
+      CloseZygoteDescriptors();
+      WaitForForkRequest(sockets[1]);
+      return true;
+    }
+
+    close(sockets[1]);
+    if (pid < 0) {
+      LOG(ERROR) << "Zygote could not prefork a renderer";
+      close(sockets[0]);
+      return false;
+    }
+    PreforkedRenderer renderer = { pid, sockets[0] };
+    preforked_renderers_.push_back(renderer);
+  }
+  return false;
+}
+
+void Zygote::WaitForForkRequest(int socket) {
+  std::vector<int> fds;
+  char buf[kZygoteMaxMessageLength];
+  const ssize_t len = UnixDomainSocket::RecvMsg(socket, buf, sizeof(buf),
+                                                &fds);
+  if (len <= 0) {
+    // The zygote exited before this renderer was needed.
+    _exit(0);
+  }
+  close(socket);
+
+  Pickle pickle(buf, len);
+  PickleIterator iter(pickle);
+  int kind;
+  std::string process_type;
+  std::vector<std::string> args;
+  base::GlobalDescriptors::Mapping mapping;
+  std::string channel_id;
+  if (!pickle.ReadInt(&iter, &kind) || kind != kZygoteCommandFork ||
+      !ReadArgs(pickle, &iter, fds, &process_type, &args, &mapping,
+                &channel_id)) {
+    LOG(FATAL) << "Invalid fork request for preforked renderer";
+  }
+  SetUpChild(args, mapping);
+}
+
+base::ProcessId Zygote::LaunchPreforkedRenderer(const Pickle& pickle,
+                                                const std::vector<int>& fds) {
+  while (!preforked_renderers_.empty()) {
+    PreforkedRenderer renderer = preforked_renderers_.front();
+    preforked_renderers_.erase(preforked_renderers_.begin());
+
+    const bool sent = UnixDomainSocket::SendMsg(
+        renderer.socket, pickle.data(), pickle.size(), fds);
+    close(renderer.socket);
+    if (sent)
+      return renderer.pid;
+
+    // The renderer died while it was waiting.
+    LOG(WARNING) << "Preforked renderer " << renderer.pid << " is gone";
+    base::ProcessId actual_pid = renderer.pid;
+    if (UsingSUIDSandbox()) {
+      actual_pid = real_pids_to_sandbox_pids[renderer.pid];
+      real_pids_to_sandbox_pids.erase(renderer.pid);
+    }
+    if (actual_pid)
+      base::EnsureProcessTerminated(actual_pid);
+  }
+  return -1;
+}
+
 bool Zygote::HandleRequestFromBrowser(int fd) {
   std::vector<int> fds;
   char buf[kZygoteMaxMessageLength];
@@ -360,49 +459,99 @@ int Zygote::ForkWithRealPid(const std::string& process_type,
   return -1;
 }
 
-base::ProcessId Zygote::ReadArgsAndFork(const Pickle& pickle,
-                                        PickleIterator iter,
-                                        std::vector<int>& fds,
-                                        std::string* uma_name,
-                                        int* uma_sample,
-                                        int* uma_boundary_value) {
-  std::vector<std::string> args;
+bool Zygote::ReadArgs(const Pickle& pickle,
+                      PickleIterator* iter,
+                      const std::vector<int>& fds,
+                      std::string* process_type,
+                      std::vector<std::string>* args,
+                      base::GlobalDescriptors::Mapping* mapping,
+                      std::string* channel_id) {
   int argc = 0;
   int numfds = 0;
-  base::GlobalDescriptors::Mapping mapping;
-  std::string process_type;
-  std::string channel_id;
   const std::string channel_id_prefix = std::string("--")
       + switches::kProcessChannelID + std::string("=");
 
-  if (!pickle.ReadString(&iter, &process_type))
-    return -1;
-  if (!pickle.ReadInt(&iter, &argc))
-    return -1;
+  if (!pickle.ReadString(iter, process_type))
+    return false;
+  if (!pickle.ReadInt(iter, &argc))
+    return false;
 
   for (int i = 0; i < argc; ++i) {
     std::string arg;
-    if (!pickle.ReadString(&iter, &arg))
-      return -1;
-    args.push_back(arg);
+    if (!pickle.ReadString(iter, &arg))
+      return false;
+    args->push_back(arg);
     if (arg.compare(0, channel_id_prefix.length(), channel_id_prefix) == 0)
-      channel_id = arg;
+      *channel_id = arg;
   }
 
-  if (!pickle.ReadInt(&iter, &numfds))
-    return -1;
+  if (!pickle.ReadInt(iter, &numfds))
+    return false;
   if (numfds != static_cast<int>(fds.size()))
-    return -1;
+    return false;
 
   for (int i = 0; i < numfds; ++i) {
     base::GlobalDescriptors::Key key;
-    if (!pickle.ReadUInt32(&iter, &key))
-      return -1;
-    mapping.push_back(std::make_pair(key, fds[i]));
+    if (!pickle.ReadUInt32(iter, &key))
+      return false;
+    mapping->push_back(std::make_pair(key, fds[i]));
   }
 
-  mapping.push_back(std::make_pair(
+  mapping->push_back(std::make_pair(
       static_cast<uint32_t>(kSandboxIPCChannel), kMagicSandboxIPCDescriptor));
+  return true;
+}
+
+void Zygote::CloseZygoteDescriptors() {
+  close(kBrowserDescriptor);  // Our socket from the browser.
+  if (UsingSUIDSandbox())
+    close(kZygoteIdFd);  // Another socket from the browser.
+  for (std::vector<PreforkedRenderer>::const_iterator
+       i = preforked_renderers_.begin(); i != preforked_renderers_.end(); ++i)
+    close(i->socket);
+  preforked_renderers_.clear();
+}
+
+void Zygote::SetUpChild(const std::vector<std::string>& args,
+                        const base::GlobalDescriptors::Mapping& mapping) {
+  base::GlobalDescriptors::GetInstance()->Reset(mapping);
+
+  // Reset the process-wide command line to our new command line.
+  CommandLine::Reset();
+  CommandLine::Init(0, NULL);
+  CommandLine::ForCurrentProcess()->InitFromArgv(args);
+
+  // Update the process title. The argv was already cached by the call to
+  // SetProcessTitleFromCommandLine in ChromeMain, so we can pass NULL here
+  // (we don't have the original argv at this point).
+  SetProcessTitleFromCommandLine(NULL);
+}
+
+base::ProcessId Zygote::ReadArgsAndFork(const Pickle& pickle,
+                                        PickleIterator iter,
+                                        std::vector<int>& fds,
+                                        std::string* uma_name,
+                                        int* uma_sample,
+                                        int* uma_boundary_value,
+                                        bool* preforked) {
+  std::string process_type;
+  std::vector<std::string> args;
+  base::GlobalDescriptors::Mapping mapping;
+  std::string channel_id;
+
+  *preforked = false;
+  if (!ReadArgs(pickle, &iter, fds, &process_type, &args, &mapping,
+                &channel_id)) {
+    return -1;
+  }
+
+  if (process_type == switches::kRendererProcess) {
+    base::ProcessId child_pid = LaunchPreforkedRenderer(pickle, fds);
+    if (child_pid > 0) {
+      *preforked = true;
+      return child_pid;
+    }
+  }
 
   // Returns twice, once per process.
   base::ProcessId child_pid = ForkWithRealPid(process_type, fds, channel_id,
@@ -410,24 +559,11 @@ base::ProcessId Zygote::ReadArgsAndFork(const Pickle& pickle,
                                               uma_boundary_value);
   if (!child_pid) {
     // This is the child process.
-
-    close(kBrowserDescriptor);  // Our socket from the browser.
-    if (UsingSUIDSandbox())
-      close(kZygoteIdFd);  // Another socket from the browser.
-    base::GlobalDescriptors::GetInstance()->Reset(mapping);
-
-    // Reset the process-wide command line to our new command line.
-    CommandLine::Reset();
-    CommandLine::Init(0, NULL);
-    CommandLine::ForCurrentProcess()->InitFromArgv(args);
-
-    // Update the process title. The argv was already cached by the call to
-    // SetProcessTitleFromCommandLine in ChromeMain, so we can pass NULL here
-    // (we don't have the original argv at this point).
-    SetProcessTitleFromCommandLine(NULL);
+    CloseZygoteDescriptors();
+    SetUpChild(args, mapping);
   } else if (child_pid < 0) {
     LOG(ERROR) << "Zygote could not fork: process_type " << process_type
-        << " numfds " << numfds << " child_pid " << child_pid;
+        << " numfds " << fds.size() << " child_pid " << child_pid;
   }
   return child_pid;
 }
@@ -439,9 +575,11 @@ bool Zygote::HandleForkRequest(int fd,
   std::string uma_name;
   int uma_sample;
   int uma_boundary_value;
+  bool preforked;
   base::ProcessId child_pid = ReadArgsAndFork(pickle, iter, fds,
                                               &uma_name, &uma_sample,
-                                              &uma_boundary_value);
+                                              &uma_boundary_value,
+                                              &preforked);
   if (child_pid == 0)
     return true;
   for (std::vector<int>::const_iterator
@@ -464,6 +602,7 @@ bool Zygote::HandleForkRequest(int fd,
     reply_pickle.WriteInt(uma_sample);
     reply_pickle.WriteInt(uma_boundary_value);
   }
+  reply_pickle.WriteBool(preforked);
   if (HANDLE_EINTR(write(fd, reply_pickle.data(), reply_pickle.size())) !=
       static_cast<ssize_t> (reply_pickle.size()))
     PLOG(ERROR) << "write";
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "base/containers/hash_tables.h"
+#include "base/posix/global_descriptors.h"
 #include "base/process/process.h"
 
 class Pickle;
@@ -33,9 +34,34 @@ class Zygote {
   static const int kMagicSandboxIPCDescriptor = 5;
 
  private:
+  // A renderer that was forked before the browser asked for it. It waits for
+  // the arguments of a fork request on |socket|.
+  struct PreforkedRenderer {
+    base::ProcessId pid;
+    int socket;
+  };
+
   // Returns true if the SUID sandbox is active.
   bool UsingSUIDSandbox() const;
 
+  // ---------------------------------------------------------------------------
+  // Preforked renderers...
+
+  // Forks renderers until kPreforkedRendererCount of them are waiting. This
+  // runs after each request from the browser, so the fork is not on the path
+  // of any request. Returns true in a new renderer, once it has received its
+  // fork request and needs to unwind back into ChromeMain.
+  bool ReplenishPreforkedRenderers();
+
+  // Runs in a preforked renderer: waits for the fork request on |socket| and
+  // sets the process up for it, or exits if the zygote goes away first.
+  void WaitForForkRequest(int socket);
+
+  // Passes the fork request in |pickle|, with its |fds|, to a waiting
+  // preforked renderer. Returns the renderer's PID, or -1 if there is none.
+  base::ProcessId LaunchPreforkedRenderer(const Pickle& pickle,
+                                          const std::vector<int>& fds);
+
   // ---------------------------------------------------------------------------
   // Requests from the browser...
 
@@ -61,7 +87,26 @@ class Zygote {
                       int* uma_sample,
                       int* uma_boundary_value);
 
-  // Unpacks process type and arguments from |pickle| and forks a new process.
+  // Unpacks the process type, command line and descriptor mapping of a fork
+  // request from |pickle|. |fds| are the descriptors sent with the request.
+  bool ReadArgs(const Pickle& pickle,
+                PickleIterator* iter,
+                const std::vector<int>& fds,
+                std::string* process_type,
+                std::vector<std::string>* args,
+                base::GlobalDescriptors::Mapping* mapping,
+                std::string* channel_id);
+
+  // Closes, in a new child, the descriptors that only the zygote should have.
+  void CloseZygoteDescriptors();
+
+  // Sets up a new child with the command line |args| and the descriptor
+  // |mapping| of its fork request.
+  void SetUpChild(const std::vector<std::string>& args,
+                  const base::GlobalDescriptors::Mapping& mapping);
+
+  // Unpacks process type and arguments from |pickle| and forks a new process,
+  // or hands them to a preforked renderer, in which case |preforked| is set.
   // Returns -1 on error, otherwise returns twice, returning 0 to the child
   // process and the child process ID to the parent process, like fork().
   base::ProcessId ReadArgsAndFork(const Pickle& pickle,
@@ -69,7 +114,8 @@ class Zygote {
                                   std::vector<int>& fds,
                                   std::string* uma_name,
                                   int* uma_sample,
-                                  int* uma_boundary_value);
+                                  int* uma_boundary_value,
+                                  bool* preforked);
 
   // Handle a 'fork' request from the browser: this means that the browser
   // wishes to start a new renderer. Returns true if we are in a new process,
@@ -98,6 +144,9 @@ class Zygote {
   std::string initial_uma_name_;
   int initial_uma_sample_;
   int initial_uma_boundary_value_;
+
+  // Renderers waiting for a fork request, oldest first.
+  std::vector<PreforkedRenderer> preforked_renderers_;
 };
 
 }  // namespace content
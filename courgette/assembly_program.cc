@@ -30,6 +30,7 @@ enum OP {
   REL32ARM,       // REL32ARM <c_op> <label> - arm-specific rel32 reference
   MAKEELFARMRELOCS, // Generates a base relocation table.
   DEFBYTES,       // Emits any number of byte literals
+  ABS64,          // ABS64 <label> - emit an abs64 encoded reference to 'label'.
   LAST_OP
 };
 
@@ -197,6 +198,10 @@ CheckBool AssemblyProgram::EmitAbs32(Label* label) {
   return Emit(new(std::nothrow) InstructionWithLabel(ABS32, label));
 }
 
+CheckBool AssemblyProgram::EmitAbs64(Label* label) {
+  return Emit(new(std::nothrow) InstructionWithLabel(ABS64, label));
+}
+
 Label* AssemblyProgram::FindOrMakeAbs32Label(RVA rva) {
   return FindLabel(rva, &abs32_labels_);
 }
@@ -222,7 +227,7 @@ void AssemblyProgram::AssignRemainingIndexes() {
 
 Label* AssemblyProgram::InstructionAbs32Label(
     const Instruction* instruction) const {
-  if (instruction->op() == ABS32)
+  if (instruction->op() == ABS32 || instruction->op() == ABS64)
     return static_cast<const InstructionWithLabel*>(instruction)->label();
   return NULL;
 }
@@ -449,6 +454,12 @@ EncodedProgram* AssemblyProgram::Encode() const {
           return NULL;
         break;
       }
+      case ABS64: {
+        Label* label = static_cast<InstructionWithLabel*>(instruction)->label();
+        if (!encoded->AddAbs64(label->index_))
+          return NULL;
+        break;
+      }
       case MAKEPERELOCS: {
         if (!encoded->AddPeMakeRelocs())
           return NULL;
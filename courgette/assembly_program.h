@@ -101,6 +101,10 @@ class AssemblyProgram {
   // Generates 4-byte absolute reference to address of 'label'.
   CheckBool EmitAbs32(Label* label) WARN_UNUSED_RESULT;
 
+  // Generates 8-byte absolute reference to address of 'label'.  The label is
+  // one of the abs32 labels, as the addresses are the same.
+  CheckBool EmitAbs64(Label* label) WARN_UNUSED_RESULT;
+
   // Looks up a label or creates a new one.  Might return NULL.
   Label* FindOrMakeAbs32Label(RVA rva);
 
@@ -119,7 +123,7 @@ class AssemblyProgram {
   }
 
   // Returns the label if the instruction contains and absolute address,
-  // otherwise returns NULL.
+  // either abs32 or abs64, otherwise returns NULL.
   Label* InstructionAbs32Label(const Instruction* instruction) const;
 
   // Returns the label if the instruction contains and rel32 offset,
@@ -8,6 +8,29 @@
 #include "courgette/courgette.h"
 #include "courgette/streams.h"
 
+namespace {
+
+// Collects the output of a patch application, checking it arrives in pieces.
+class StringOutputSink : public courgette::BSDiffOutputSink {
+ public:
+  StringOutputSink() {}
+
+  virtual bool Consume(const uint8* data, size_t length) OVERRIDE {
+    EXPECT_GT(length, 0U);
+    output_.append(reinterpret_cast<const char*>(data), length);
+    return true;
+  }
+
+  const std::string& output() const { return output_; }
+
+ private:
+  std::string output_;
+
+  DISALLOW_COPY_AND_ASSIGN(StringOutputSink);
+};
+
+}  // namespace
+
 class BSDiffMemoryTest : public BaseTest {
  public:
   void GenerateAndTestPatch(const std::string& a, const std::string& b) const;
@@ -36,6 +59,16 @@ void BSDiffMemoryTest::GenerateAndTestPatch(const std::string& old_text,
   EXPECT_EQ(courgette::OK, status);
   EXPECT_EQ(new_text.length(), new2.Length());
   EXPECT_EQ(0, memcmp(new_text.c_str(), new2.Buffer(), new_text.length()));
+
+  courgette::SourceStream old3;
+  courgette::SourceStream patch3;
+  old3.Init(old_text.c_str(), old_text.length());
+  patch3.Init(patch1);
+
+  StringOutputSink new3;
+  status = ApplyBinaryPatch(&old3, &patch3, &new3);
+  EXPECT_EQ(courgette::OK, status);
+  EXPECT_EQ(new_text, new3.output());
 }
 
 std::string BSDiffMemoryTest::GenerateSyntheticInput(size_t length, int seed)
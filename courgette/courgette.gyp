@@ -28,6 +28,8 @@
       'disassembler_elf_32_arm.h',
       'disassembler_elf_32_x86.cc',
       'disassembler_elf_32_x86.h',
+      'disassembler_elf_64_x86.cc',
+      'disassembler_elf_64_x86.h',
       'disassembler_win32_x86.cc',
       'disassembler_win32_x86.h',
       'encoded_program.cc',
@@ -98,6 +100,7 @@
         'base_test_unittest.h',
         'difference_estimator_unittest.cc',
         'disassembler_elf_32_x86_unittest.cc',
+        'disassembler_elf_64_x86_unittest.cc',
         'disassembler_win32_x86_unittest.cc',
         'encoded_program_unittest.cc',
         'encode_decode_unittest.cc',
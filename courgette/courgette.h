@@ -58,6 +58,7 @@ enum ExecutableType {
   EXE_WIN_32_X86 = 1,
   EXE_ELF_32_X86 = 2,
   EXE_ELF_32_ARM = 3,
+  EXE_ELF_64_X86 = 4,
 };
 
 class SinkStream;
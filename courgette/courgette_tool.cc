@@ -14,6 +14,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
 #include "courgette/courgette.h"
 #include "courgette/streams.h"
 #include "courgette/third_party/bsdiff.h"
@@ -26,7 +27,7 @@ void PrintHelp() {
     "  courgette -dis <executable_file> <binary_assembly_file>\n"
     "  courgette -asm <binary_assembly_file> <executable_file>\n"
     "  courgette -disadj <executable_file> <reference> <binary_assembly_file>\n"
-    "  courgette -gen <v1> <v2> <patch>\n"
+    "  courgette -gen <v1> <v2> <patch> [-compare]\n"
     "  courgette -apply <v1> <patch> <v2>\n"
     "\n");
 }
@@ -140,6 +141,11 @@ bool Supported(const base::FilePath& input_file) {
       format = "ELF 32 ARM";
       result = true;
       break;
+
+    case courgette::EXE_ELF_64_X86:
+      format = "ELF 64 X86";
+      result = true;
+      break;
   }
 
   printf("%s Executable\n", format.c_str());
@@ -304,7 +310,8 @@ void Assemble(const base::FilePath& input_file,
 
 void GenerateEnsemblePatch(const base::FilePath& old_file,
                            const base::FilePath& new_file,
-                           const base::FilePath& patch_file) {
+                           const base::FilePath& patch_file,
+                           bool compare_with_bsdiff) {
   std::string old_buffer = ReadOrFail(old_file, "'old' input");
   std::string new_buffer = ReadOrFail(new_file, "'new' input");
 
@@ -314,11 +321,33 @@ void GenerateEnsemblePatch(const base::FilePath& old_file,
   new_stream.Init(new_buffer);
 
   courgette::SinkStream patch_stream;
+  base::TimeTicks start_time = base::TimeTicks::Now();
   courgette::Status status =
       courgette::GenerateEnsemblePatch(&old_stream, &new_stream, &patch_stream);
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start_time;
 
   if (status != courgette::C_OK) Problem("-gen failed.");
 
+  fprintf(stderr, "Generated %lu byte patch in %.2f seconds.\n",
+          static_cast<unsigned long>(patch_stream.Length()),
+          elapsed.InSecondsF());
+
+  if (compare_with_bsdiff) {
+    old_stream.Init(old_buffer);
+    new_stream.Init(new_buffer);
+    courgette::SinkStream bsdiff_stream;
+    if (courgette::CreateBinaryPatch(&old_stream, &new_stream,
+                                     &bsdiff_stream) != courgette::OK)
+      Problem("-gen -compare bsdiff failed.");
+    fprintf(stderr,
+            "Plain bsdiff patch is %lu bytes; courgette saves %.1f%%.\n",
+            static_cast<unsigned long>(bsdiff_stream.Length()),
+            bsdiff_stream.Length() ?
+                100.0 * (1.0 - static_cast<double>(patch_stream.Length()) /
+                               bsdiff_stream.Length()) :
+                0.0);
+  }
+
   WriteSinkToFile(&patch_stream, patch_file);
 }
 
@@ -440,6 +469,7 @@ int main(int argc, const char* argv[]) {
   bool cmd_apply_bsdiff_patch = command_line.HasSwitch("applybsdiff");
   bool cmd_spread_1_adjusted = command_line.HasSwitch("gen1a");
   bool cmd_spread_1_unadjusted = command_line.HasSwitch("gen1u");
+  bool compare_with_bsdiff = command_line.HasSwitch("compare");
 
   std::vector<base::FilePath> values;
   const CommandLine::StringVector& args = command_line.GetArgs();
@@ -484,7 +514,8 @@ int main(int argc, const char* argv[]) {
     } else if (cmd_make_patch) {
       if (values.size() != 3)
         UsageProblem("-gen <old_file> <new_file> <patch_file>");
-      GenerateEnsemblePatch(values[0], values[1], values[2]);
+      GenerateEnsemblePatch(values[0], values[1], values[2],
+                            compare_with_bsdiff);
     } else if (cmd_apply_patch) {
       if (values.size() != 3)
         UsageProblem("-apply <old_file> <patch_file> <new_file>");
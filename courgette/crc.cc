@@ -31,4 +31,19 @@ uint32 CalculateCrc(const uint8* buffer, size_t size) {
   return ~crc;
 }
 
+uint32 UpdateCrc(uint32 crc, const uint8* buffer, size_t size) {
+  // Both libraries' CRCs are the complement of ours.
+  crc = ~crc;
+
+#ifdef COURGETTE_USE_CRC_LIB
+  crc = crc32(crc, buffer, size);
+#else
+  // CrcUpdate works on the CRC before its final inversion.
+  CrcGenerateTable();
+  crc = CrcUpdate(crc ^ 0xFFFFFFFF, buffer, size) ^ 0xFFFFFFFF;
+#endif
+
+  return ~crc;
+}
+
 }  // namespace
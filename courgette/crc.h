@@ -13,5 +13,11 @@ namespace courgette {
 //
 uint32 CalculateCrc(const uint8* buffer, size_t size);
 
+// Returns the CRC of the data whose CRC is |crc| followed by the |size| bytes
+// at |buffer|, so that a CRC can be calculated a piece at a time.  The CRC of
+// no data is kInitialCrc.
+const uint32 kInitialCrc = 0xFFFFFFFF;
+uint32 UpdateCrc(uint32 crc, const uint8* buffer, size_t size);
+
 }  // namespace courgette
 #endif  // COURGETTE_CRC_H_
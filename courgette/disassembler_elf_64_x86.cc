@@ -0,0 +1,524 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "courgette/disassembler_elf_64_x86.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/logging.h"
+
+#include "courgette/assembly_program.h"
+#include "courgette/courgette.h"
+
+namespace courgette {
+
+namespace {
+
+bool SectionOffsetLessThan(const Elf64_Shdr* a, const Elf64_Shdr* b) {
+  return a->sh_offset < b->sh_offset;
+}
+
+// Returns true if the bytes of |section_header| lie within a file of
+// |length| bytes.
+bool SectionInFile(const Elf64_Shdr* section_header, size_t length) {
+  if (section_header->sh_type == SHT_NOBITS)
+    return true;
+  return section_header->sh_offset <= length &&
+         section_header->sh_size <= length - section_header->sh_offset;
+}
+
+}  // namespace
+
+DisassemblerElf64X86::DisassemblerElf64X86(const void* start, size_t length)
+  : Disassembler(start, length),
+    header_(NULL),
+    section_header_table_(NULL),
+    section_header_table_size_(0),
+    program_header_table_(NULL),
+    program_header_table_size_(0) {
+}
+
+bool DisassemblerElf64X86::ParseHeader() {
+  if (length() < sizeof(Elf64_Ehdr))
+    return Bad("Too small");
+
+  header_ = reinterpret_cast<const Elf64_Ehdr*>(start());
+
+  // Have magic for elf header?
+  if (header_->e_ident[0] != 0x7f ||
+      header_->e_ident[1] != 'E' ||
+      header_->e_ident[2] != 'L' ||
+      header_->e_ident[3] != 'F')
+    return Bad("No Magic Number");
+
+  if (header_->e_ident[EI_CLASS] != ELFCLASS64)
+    return Bad("Not a 64 bit file");
+
+  if (header_->e_type != ET_EXEC &&
+      header_->e_type != ET_DYN)
+    return Bad("Not an executable file or shared library");
+
+  if (header_->e_machine != EM_x86_64)
+    return Bad("Not a supported architecture");
+
+  if (header_->e_version != 1)
+    return Bad("Unknown file version");
+
+  if (header_->e_shentsize != sizeof(Elf64_Shdr))
+    return Bad("Unexpected section header size");
+
+  if (header_->e_phentsize != sizeof(Elf64_Phdr))
+    return Bad("Unexpected program header size");
+
+  if (header_->e_shoff > length() ||
+      header_->e_shnum > (length() - header_->e_shoff) / sizeof(Elf64_Shdr))
+    return Bad("Out of bounds section header table");
+
+  section_header_table_ =
+      reinterpret_cast<const Elf64_Shdr*>(OffsetToPointer(header_->e_shoff));
+  section_header_table_size_ = header_->e_shnum;
+
+  if (header_->e_phoff > length() ||
+      header_->e_phnum > (length() - header_->e_phoff) / sizeof(Elf64_Phdr))
+    return Bad("Out of bounds program header table");
+
+  program_header_table_ =
+      reinterpret_cast<const Elf64_Phdr*>(OffsetToPointer(header_->e_phoff));
+  program_header_table_size_ = header_->e_phnum;
+
+  for (int section_id = 0; section_id < SectionHeaderCount(); section_id++) {
+    if (!SectionInFile(SectionHeader(section_id), length()))
+      return Bad("Out of bounds section");
+  }
+
+  for (int i = 0; i < ProgramSegmentHeaderCount(); i++) {
+    const Elf64_Phdr* segment_header = ProgramSegmentHeader(i);
+
+    if (segment_header->p_offset > length() ||
+        segment_header->p_filesz > length() - segment_header->p_offset)
+      return Bad("Out of bounds segment");
+
+    if (segment_header->p_type != PT_LOAD)
+      continue;
+
+    // Addresses are held as 32 bit RVAs.
+    if (segment_header->p_vaddr > kuint32max ||
+        segment_header->p_memsz > kuint32max - segment_header->p_vaddr)
+      return Bad("Segment addresses don't fit in 32 bits");
+  }
+
+  ReduceLength(static_cast<size_t>(DiscoverLength()));
+
+  return Good();
+}
+
+bool DisassemblerElf64X86::Disassemble(AssemblyProgram* target) {
+  if (!ok())
+    return false;
+
+  // The Image Base is always 0 for ELF Executables
+  target->set_image_base(0);
+
+  if (!ParseAbs64Relocs())
+    return false;
+
+  if (!ParseRel32RelocsFromSections())
+    return false;
+
+  if (!ParseFile(target))
+    return false;
+
+  target->DefaultAssignIndexes();
+
+  return true;
+}
+
+uint64 DisassemblerElf64X86::DiscoverLength() {
+  uint64 result = 0;
+
+  // Find the end of the last section
+  for (int section_id = 0; section_id < SectionHeaderCount(); section_id++) {
+    const Elf64_Shdr* section_header = SectionHeader(section_id);
+
+    if (section_header->sh_type == SHT_NOBITS)
+      continue;
+
+    uint64 section_end = section_header->sh_offset + section_header->sh_size;
+
+    if (section_end > result)
+      result = section_end;
+  }
+
+  // Find the end of the last segment
+  for (int i = 0; i < ProgramSegmentHeaderCount(); i++) {
+    const Elf64_Phdr* segment_header = ProgramSegmentHeader(i);
+
+    uint64 segment_end = segment_header->p_offset + segment_header->p_filesz;
+
+    if (segment_end > result)
+      result = segment_end;
+  }
+
+  uint64 section_table_end = header_->e_shoff +
+                             (header_->e_shnum * sizeof(Elf64_Shdr));
+  if (section_table_end > result)
+    result = section_table_end;
+
+  uint64 segment_table_end = header_->e_phoff +
+                             (header_->e_phnum * sizeof(Elf64_Phdr));
+  if (segment_table_end > result)
+    result = segment_table_end;
+
+  return result;
+}
+
+CheckBool DisassemblerElf64X86::IsValidRVA(RVA rva) const {
+  // It's valid if it's contained in any loadable program segment
+  for (int i = 0; i < ProgramSegmentHeaderCount(); i++) {
+    const Elf64_Phdr* segment_header = ProgramSegmentHeader(i);
+
+    if (segment_header->p_type != PT_LOAD)
+      continue;
+
+    if (rva >= segment_header->p_vaddr &&
+        rva - segment_header->p_vaddr < segment_header->p_memsz)
+      return true;
+  }
+
+  return false;
+}
+
+CheckBool DisassemblerElf64X86::RVAToFileOffset(RVA rva,
+                                                size_t* result) const {
+  for (int i = 0; i < ProgramSegmentHeaderCount(); i++) {
+    const Elf64_Phdr* segment_header = ProgramSegmentHeader(i);
+
+    if (segment_header->p_type != PT_LOAD || rva < segment_header->p_vaddr)
+      continue;
+
+    uint64 offset = rva - segment_header->p_vaddr;
+    if (offset < segment_header->p_filesz) {
+      *result = static_cast<size_t>(segment_header->p_offset + offset);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void DisassemblerElf64X86::RVAsToOffsets(const std::vector<RVA>& rvas,
+                                         std::vector<size_t>* offsets) const {
+  offsets->clear();
+
+  for (size_t i = 0; i < rvas.size(); ++i) {
+    size_t offset;
+    if (RVAToFileOffset(rvas[i], &offset))
+      offsets->push_back(offset);
+  }
+
+  std::sort(offsets->begin(), offsets->end());
+}
+
+CheckBool DisassemblerElf64X86::IsAbs64Location(RVA rva) {
+  size_t offset;
+  if (!RVAToFileOffset(rva, &offset) || offset + 8 > length())
+    return false;
+
+  // An abs64 reference only holds an RVA, so the upper half must be zero.
+  uint64 value = ReadU64(start(), offset);
+  return value <= kuint32max && IsValidRVA(static_cast<RVA>(value));
+}
+
+CheckBool DisassemblerElf64X86::ParseAbs64Relocs() {
+  abs64_locations_.clear();
+
+  // Loop through sections for relocation sections
+  for (int section_id = 0; section_id < SectionHeaderCount(); section_id++) {
+    const Elf64_Shdr* section_header = SectionHeader(section_id);
+
+    if (section_header->sh_type != SHT_RELA ||
+        section_header->sh_entsize != sizeof(Elf64_Rela))
+      continue;
+
+    const Elf64_Rela* relocs_table =
+        reinterpret_cast<const Elf64_Rela*>(SectionBody(section_id));
+    size_t relocs_table_count = static_cast<size_t>(
+        section_header->sh_size / sizeof(Elf64_Rela));
+
+    for (size_t rel_id = 0; rel_id < relocs_table_count; rel_id++) {
+      const Elf64_Rela& rel = relocs_table[rel_id];
+
+      // The low half of r_info is the type, and the high half the symbol.
+      uint32 type = static_cast<uint32>(rel.r_info);
+      uint32 symbol = static_cast<uint32>(rel.r_info >> 32);
+
+      // Quite a few of the other relocation types refer to symbols rather
+      // than addresses in the file, so we simply skip them.
+      if (type != R_X86_64_RELATIVE || symbol != 0)
+        continue;
+
+      if (rel.r_offset > kuint32max)
+        continue;
+
+      RVA rva = static_cast<RVA>(rel.r_offset);
+      if (IsAbs64Location(rva))
+        abs64_locations_.push_back(rva);
+    }
+  }
+
+  std::sort(abs64_locations_.begin(), abs64_locations_.end());
+  abs64_locations_.erase(
+      std::unique(abs64_locations_.begin(), abs64_locations_.end()),
+      abs64_locations_.end());
+  return true;
+}
+
+CheckBool DisassemblerElf64X86::ParseRel32RelocsFromSections() {
+  rel32_locations_.clear();
+
+  // Only code sections have instructions with rel32 operands.
+  for (int section_id = 0; section_id < SectionHeaderCount(); section_id++) {
+    const Elf64_Shdr* section_header = SectionHeader(section_id);
+
+    if (section_header->sh_type != SHT_PROGBITS ||
+        !(section_header->sh_flags & SHF_EXECINSTR))
+      continue;
+
+    if (!ParseRel32RelocsFromSection(section_header))
+      return false;
+  }
+
+  std::sort(rel32_locations_.begin(), rel32_locations_.end());
+  return true;
+}
+
+CheckBool DisassemblerElf64X86::ParseRel32RelocsFromSection(
+    const Elf64_Shdr* section_header) {
+  // Sections outside of the 32 bit address space are left as plain bytes.
+  if (section_header->sh_addr > kuint32max ||
+      section_header->sh_size > kuint32max - section_header->sh_addr)
+    return true;
+
+  size_t start_file_offset = static_cast<size_t>(section_header->sh_offset);
+  size_t end_file_offset =
+      start_file_offset + static_cast<size_t>(section_header->sh_size);
+
+  const uint8* start_pointer = OffsetToPointer(start_file_offset);
+  const uint8* end_pointer = OffsetToPointer(end_file_offset);
+  RVA start_rva = static_cast<RVA>(section_header->sh_addr);
+
+  // Find the rel32 relocations.
+  const uint8* p = start_pointer;
+  while (p < end_pointer) {
+    // Heuristic discovery of rel32 locations in instruction stream: are the
+    // next few bytes the start of an instruction containing a rel32
+    // addressing mode?
+    const uint8* rel32 = NULL;
+
+    if (p + 5 <= end_pointer) {
+      if (*p == 0xE8 || *p == 0xE9)  // jmp rel32 and call rel32
+        rel32 = p + 1;
+    }
+    if (p + 6 <= end_pointer) {
+      if (p[0] == 0x0F && (p[1] & 0xF0) == 0x80) {  // Jcc long form
+        if (p[1] != 0x8A && p[1] != 0x8B)  // JPE/JPO unlikely
+          rel32 = p + 2;
+      } else if ((p[0] == 0x8B || p[0] == 0x89 || p[0] == 0x8D) &&
+                 (p[1] & 0xC7) == 0x05) {
+        // mov and lea with a RIP-relative memory operand.  Nothing follows
+        // the displacement, so it is relative to the end of the rel32 just
+        // as for a jump.
+        rel32 = p + 2;
+      } else if (p[0] == 0xFF && (p[1] == 0x15 || p[1] == 0x25)) {
+        // call and jmp through a RIP-relative pointer.
+        rel32 = p + 2;
+      }
+    }
+
+    if (rel32) {
+      RVA rva = start_rva + static_cast<RVA>(rel32 - start_pointer);
+      RVA target_rva = rva + 4 + Read32LittleEndian(rel32);
+      // To be valid, rel32 target must be within image.
+      if (IsValidRVA(target_rva)) {
+        rel32_locations_.push_back(rva);
+        p = rel32 + 4;
+        continue;
+      }
+    }
+    p += 1;
+  }
+
+  return true;
+}
+
+CheckBool DisassemblerElf64X86::ParseFile(AssemblyProgram* program) {
+  std::vector<size_t> abs_offsets;
+  RVAsToOffsets(abs64_locations_, &abs_offsets);
+
+  std::vector<size_t> rel_offsets;
+  RVAsToOffsets(rel32_locations_, &rel_offsets);
+
+  std::vector<size_t>::iterator current_abs_offset = abs_offsets.begin();
+  std::vector<size_t>::iterator end_abs_offset = abs_offsets.end();
+  std::vector<size_t>::iterator current_rel_offset = rel_offsets.begin();
+  std::vector<size_t>::iterator end_rel_offset = rel_offsets.end();
+
+  // Visit the sections with contents in file order.
+  std::vector<const Elf64_Shdr*> sections;
+  for (int section_id = 0; section_id < SectionHeaderCount(); section_id++) {
+    const Elf64_Shdr* section_header = SectionHeader(section_id);
+    if (section_header->sh_type != SHT_NOBITS && section_header->sh_size > 0)
+      sections.push_back(section_header);
+  }
+  std::stable_sort(sections.begin(), sections.end(), SectionOffsetLessThan);
+
+  // Walk all the bytes in the file, whether or not in a section.
+  size_t file_offset = 0;
+
+  for (size_t i = 0; i < sections.size(); ++i) {
+    const Elf64_Shdr* section_header = sections[i];
+    size_t section_offset = static_cast<size_t>(section_header->sh_offset);
+
+    // Overlapping sections aren't expected in a linked file.
+    if (section_offset < file_offset)
+      return false;
+
+    if (!ParseSimpleRegion(file_offset, section_offset, program))
+      return false;
+    file_offset = section_offset;
+
+    if (!(section_header->sh_flags & SHF_ALLOC))
+      continue;
+
+    switch (section_header->sh_type) {
+      case SHT_PROGBITS:
+        // Fall through
+      case SHT_INIT_ARRAY:
+        // Fall through
+      case SHT_FINI_ARRAY:
+        if (!ParseProgbitsSection(section_header,
+                                  &current_abs_offset, end_abs_offset,
+                                  &current_rel_offset, end_rel_offset,
+                                  program))
+          return false;
+        file_offset =
+            section_offset + static_cast<size_t>(section_header->sh_size);
+        break;
+      default:
+        // The contents are emitted as plain bytes along with whatever
+        // follows.
+        break;
+    }
+  }
+
+  // Rest of the file past the last section
+  return ParseSimpleRegion(file_offset, length(), program);
+}
+
+CheckBool DisassemblerElf64X86::ParseProgbitsSection(
+    const Elf64_Shdr* section_header,
+    std::vector<size_t>::iterator* current_abs_offset,
+    std::vector<size_t>::iterator end_abs_offset,
+    std::vector<size_t>::iterator* current_rel_offset,
+    std::vector<size_t>::iterator end_rel_offset,
+    AssemblyProgram* program) {
+  size_t file_offset = static_cast<size_t>(section_header->sh_offset);
+  size_t section_end =
+      file_offset + static_cast<size_t>(section_header->sh_size);
+
+  // Sections outside of the 32 bit address space are left as plain bytes.
+  if (section_header->sh_addr > kuint32max ||
+      section_header->sh_size > kuint32max - section_header->sh_addr)
+    return ParseSimpleRegion(file_offset, section_end, program);
+
+  RVA origin = static_cast<RVA>(section_header->sh_addr);
+  size_t origin_offset = file_offset;
+  if (!program->EmitOriginInstruction(origin))
+    return false;
+
+  while (file_offset < section_end) {
+    // Skip the locations that are behind us, either in an earlier section or
+    // overlapping a location that has been emitted.
+    while (*current_abs_offset != end_abs_offset &&
+           **current_abs_offset < file_offset)
+      (*current_abs_offset)++;
+    while (*current_rel_offset != end_rel_offset &&
+           **current_rel_offset < file_offset)
+      (*current_rel_offset)++;
+
+    // Rel32 locations are derived heuristically, so an abs64 location wins
+    // if the two overlap.
+    while (*current_rel_offset != end_rel_offset &&
+           *current_abs_offset != end_abs_offset &&
+           **current_rel_offset + 4 > **current_abs_offset &&
+           **current_rel_offset < **current_abs_offset + 8)
+      (*current_rel_offset)++;
+
+    size_t next_relocation = section_end;
+
+    if (*current_abs_offset != end_abs_offset &&
+        **current_abs_offset + 8 <= section_end)
+      next_relocation = std::min(next_relocation, **current_abs_offset);
+
+    if (*current_rel_offset != end_rel_offset &&
+        **current_rel_offset + 4 <= section_end)
+      next_relocation = std::min(next_relocation, **current_rel_offset);
+
+    if (next_relocation > file_offset) {
+      if (!ParseSimpleRegion(file_offset, next_relocation, program))
+        return false;
+
+      file_offset = next_relocation;
+      continue;
+    }
+
+    const uint8* p = OffsetToPointer(file_offset);
+
+    if (*current_abs_offset != end_abs_offset &&
+        file_offset == **current_abs_offset &&
+        file_offset + 8 <= section_end) {
+      // ParseAbs64Relocs checked the upper half is zero.
+      RVA target_rva = Read32LittleEndian(p);
+
+      if (!program->EmitAbs64(program->FindOrMakeAbs32Label(target_rva)))
+        return false;
+      file_offset += 8;
+      (*current_abs_offset)++;
+      continue;
+    }
+
+    DCHECK(*current_rel_offset != end_rel_offset &&
+           file_offset == **current_rel_offset);
+    RVA rva = origin + static_cast<RVA>(file_offset - origin_offset);
+    RVA target_rva = rva + 4 + Read32LittleEndian(p);
+
+    if (!program->EmitRel32(program->FindOrMakeRel32Label(target_rva)))
+      return false;
+    file_offset += 4;
+    (*current_rel_offset)++;
+  }
+
+  return true;
+}
+
+CheckBool DisassemblerElf64X86::ParseSimpleRegion(
+    size_t start_file_offset,
+    size_t end_file_offset,
+    AssemblyProgram* program) {
+  // Callers don't guarantee start < end
+  if (start_file_offset >= end_file_offset)
+    return true;
+
+  const uint8* start = OffsetToPointer(start_file_offset);
+  const ptrdiff_t len = end_file_offset - start_file_offset;
+
+  if (!program->EmitBytesInstruction(start, len))
+    return false;
+
+  return true;
+}
+
+}  // namespace courgette
@@ -0,0 +1,126 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef COURGETTE_DISASSEMBLER_ELF_64_X86_H_
+#define COURGETTE_DISASSEMBLER_ELF_64_X86_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "courgette/disassembler.h"
+#include "courgette/memory_allocator.h"
+#include "courgette/types_elf.h"
+
+namespace courgette {
+
+class AssemblyProgram;
+
+// A courgette disassembler for 64-bit x86 ELF files.
+//
+// Absolute addresses are found from the R_X86_64_RELATIVE entries of the
+// SHT_RELA relocation tables, and are emitted as abs64 references.  Relative
+// addresses are found heuristically in executable sections, from the rel32
+// operands of calls and jumps and the RIP-relative operands of the most
+// common memory instructions.
+//
+// RVAs are 32 bits, so only files whose loadable segments lie entirely in the
+// low 4GB of the address space are supported.  That covers executables and
+// shared libraries as linked; anything else is left to plain bsdiff.
+class DisassemblerElf64X86 : public Disassembler {
+ public:
+  DisassemblerElf64X86(const void* start, size_t length);
+
+  virtual ExecutableType kind() OVERRIDE { return EXE_ELF_64_X86; }
+
+  // Returns 'true' if the buffer appears to point to a valid 64-bit x86 ELF
+  // executable or shared library.  If ParseHeader() succeeds, other member
+  // functions may be called.
+  virtual bool ParseHeader() OVERRIDE;
+
+  virtual bool Disassemble(AssemblyProgram* target) OVERRIDE;
+
+  // Public for unittests only
+  std::vector<RVA>& Abs64Locations() { return abs64_locations_; }
+  std::vector<RVA>& Rel32Locations() { return rel32_locations_; }
+
+ protected:
+  uint64 DiscoverLength();
+
+  // Misc Section Helpers
+
+  Elf64_Half SectionHeaderCount() const {
+    return section_header_table_size_;
+  }
+
+  const Elf64_Shdr* SectionHeader(int id) const {
+    assert(id >= 0 && id < SectionHeaderCount());
+    return section_header_table_ + id;
+  }
+
+  const uint8* SectionBody(int id) const {
+    return OffsetToPointer(SectionHeader(id)->sh_offset);
+  }
+
+  // Misc Segment Helpers
+
+  Elf64_Half ProgramSegmentHeaderCount() const {
+    return program_header_table_size_;
+  }
+
+  const Elf64_Phdr* ProgramSegmentHeader(int id) const {
+    assert(id >= 0 && id < ProgramSegmentHeaderCount());
+    return program_header_table_ + id;
+  }
+
+  // Misc address space helpers
+
+  CheckBool IsValidRVA(RVA rva) const WARN_UNUSED_RESULT;
+
+  CheckBool RVAToFileOffset(RVA rva, size_t* result) const WARN_UNUSED_RESULT;
+
+  // Converts |rvas| to file offsets in |offsets|, dropping any RVA without
+  // one.
+  void RVAsToOffsets(const std::vector<RVA>& rvas,
+                     std::vector<size_t>* offsets) const;
+
+  // Parsing Code used to really implement Disassemble
+
+  CheckBool ParseAbs64Relocs() WARN_UNUSED_RESULT;
+  CheckBool ParseRel32RelocsFromSections() WARN_UNUSED_RESULT;
+  CheckBool ParseRel32RelocsFromSection(
+      const Elf64_Shdr* section_header) WARN_UNUSED_RESULT;
+
+  // Returns true if the 8 bytes at |rva| hold an address in the image that an
+  // abs64 reference can represent.
+  CheckBool IsAbs64Location(RVA rva) WARN_UNUSED_RESULT;
+
+  CheckBool ParseFile(AssemblyProgram* program) WARN_UNUSED_RESULT;
+  CheckBool ParseProgbitsSection(
+      const Elf64_Shdr* section_header,
+      std::vector<size_t>::iterator* current_abs_offset,
+      std::vector<size_t>::iterator end_abs_offset,
+      std::vector<size_t>::iterator* current_rel_offset,
+      std::vector<size_t>::iterator end_rel_offset,
+      AssemblyProgram* program) WARN_UNUSED_RESULT;
+  CheckBool ParseSimpleRegion(size_t start_file_offset,
+                              size_t end_file_offset,
+                              AssemblyProgram* program) WARN_UNUSED_RESULT;
+
+  const Elf64_Ehdr* header_;
+  const Elf64_Shdr* section_header_table_;
+  Elf64_Half section_header_table_size_;
+
+  const Elf64_Phdr* program_header_table_;
+  Elf64_Half program_header_table_size_;
+
+  // Both sorted by RVA.
+  std::vector<RVA> abs64_locations_;
+  std::vector<RVA> rel32_locations_;
+
+  DISALLOW_COPY_AND_ASSIGN(DisassemblerElf64X86);
+};
+
+}  // namespace courgette
+
+#endif  // COURGETTE_DISASSEMBLER_ELF_64_X86_H_
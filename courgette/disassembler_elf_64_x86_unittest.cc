@@ -0,0 +1,62 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+
+#include "courgette/assembly_program.h"
+#include "courgette/base_test_unittest.h"
+#include "courgette/disassembler_elf_64_x86.h"
+#include "courgette/encoded_program.h"
+#include "courgette/streams.h"
+
+class DisassemblerElf64X86Test : public BaseTest {
+ public:
+  void TestExe(const char* file_name) const;
+};
+
+void DisassemblerElf64X86Test::TestExe(const char* file_name) const {
+  std::string file1 = FileContents(file_name);
+
+  scoped_ptr<courgette::DisassemblerElf64X86> disassembler(
+      new courgette::DisassemblerElf64X86(file1.c_str(), file1.length()));
+
+  bool can_parse_header = disassembler->ParseHeader();
+  EXPECT_TRUE(can_parse_header);
+  EXPECT_TRUE(disassembler->ok());
+
+  EXPECT_EQ(file1.length(), disassembler->length());
+
+  const uint8* offset_p = disassembler->OffsetToPointer(0);
+  EXPECT_EQ(0x7F, offset_p[0]);
+  EXPECT_EQ('E', offset_p[1]);
+  EXPECT_EQ('L', offset_p[2]);
+  EXPECT_EQ('F', offset_p[3]);
+
+  scoped_ptr<courgette::AssemblyProgram> program(
+      new courgette::AssemblyProgram(courgette::EXE_ELF_64_X86));
+
+  EXPECT_TRUE(disassembler->Disassemble(program.get()));
+
+  std::vector<courgette::RVA>& abs64 = disassembler->Abs64Locations();
+  std::vector<courgette::RVA>& rel32 = disassembler->Rel32Locations();
+  EXPECT_FALSE(abs64.empty());
+  EXPECT_FALSE(rel32.empty());
+
+  // Prove that none of the rel32 RVAs are abs64 RVAs.
+  for (size_t i = 0; i < rel32.size(); ++i)
+    EXPECT_FALSE(std::binary_search(abs64.begin(), abs64.end(), rel32[i]));
+
+  // The program must assemble back to the original file.
+  scoped_ptr<courgette::EncodedProgram> encoded(program->Encode());
+  ASSERT_TRUE(encoded.get() != NULL);
+
+  courgette::SinkStream assembled;
+  EXPECT_TRUE(encoded->AssembleTo(&assembled));
+  ASSERT_EQ(file1.length(), assembled.Length());
+  EXPECT_EQ(0, memcmp(file1.c_str(), assembled.Buffer(), file1.length()));
+}
+
+TEST_F(DisassemblerElf64X86Test, All) {
+  TestExe("elf-64-1");
+}
@@ -239,6 +239,10 @@ CheckBool EncodedProgram::AddAbs32(int label_index) {
   return ops_.push_back(ABS32) && abs32_ix_.push_back(label_index);
 }
 
+CheckBool EncodedProgram::AddAbs64(int label_index) {
+  return ops_.push_back(ABS64) && abs32_ix_.push_back(label_index);
+}
+
 CheckBool EncodedProgram::AddRel32(int label_index) {
   return ops_.push_back(REL32) && rel32_ix_.push_back(label_index);
 }
@@ -609,6 +613,22 @@ CheckBool EncodedProgram::AssembleTo(SinkStream* final_buffer) {
         break;
       }
 
+      case ABS64: {
+        // Shares the address table and index stream with ABS32.
+        uint32 index;
+        if (!VectorAt(abs32_ix_, ix_abs32_ix, &index))
+          return false;
+        ++ix_abs32_ix;
+        RVA rva;
+        if (!VectorAt(abs32_rva_, index, &rva))
+          return false;
+        uint64 abs64 = rva + image_base_;
+        if (!output->Write(&abs64, 8))
+          return false;
+        current_rva += 8;
+        break;
+      }
+
       case MAKE_PE_RELOCATION_TABLE: {
         // We can see the base relocation anywhere, but we only have the
         // information to generate it at the very end.  So we divert the bytes
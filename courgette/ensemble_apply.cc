@@ -6,7 +6,10 @@
 
 #include "courgette/ensemble.h"
 
+#include <stdio.h>
+
 #include "base/basictypes.h"
+#include "base/compiler_specific.h"
 #include "base/file_util.h"
 #include "base/files/memory_mapped_file.h"
 #include "base/logging.h"
@@ -15,9 +18,56 @@
 #include "courgette/streams.h"
 #include "courgette/simple_delta.h"
 #include "courgette/patcher_x86_32.h"
+#include "courgette/third_party/bsdiff.h"
 
 namespace courgette {
 
+namespace {
+
+// Passes the output on to another sink, keeping the CRC of all of it.
+class CrcOutputSink : public BSDiffOutputSink {
+ public:
+  explicit CrcOutputSink(BSDiffOutputSink* output)
+      : output_(output),
+        crc_(kInitialCrc) {
+  }
+
+  virtual bool Consume(const uint8* data, size_t length) OVERRIDE {
+    crc_ = UpdateCrc(crc_, data, length);
+    return output_->Consume(data, length);
+  }
+
+  uint32 crc() const { return crc_; }
+
+ private:
+  BSDiffOutputSink* output_;
+  uint32 crc_;
+
+  DISALLOW_COPY_AND_ASSIGN(CrcOutputSink);
+};
+
+// Writes the output to a file.
+class FileOutputSink : public BSDiffOutputSink {
+ public:
+  explicit FileOutputSink(FILE* file) : file_(file), failed_(false) {}
+
+  virtual bool Consume(const uint8* data, size_t length) OVERRIDE {
+    if (fwrite(data, 1, length, file_) != length)
+      failed_ = true;
+    return !failed_;
+  }
+
+  bool failed() const { return failed_; }
+
+ private:
+  FILE* file_;
+  bool failed_;
+
+  DISALLOW_COPY_AND_ASSIGN(FileOutputSink);
+};
+
+}  // namespace
+
 // EnsemblePatchApplication is all the logic and data required to apply the
 // multi-stage patch.
 class EnsemblePatchApplication {
@@ -53,6 +103,12 @@ class EnsemblePatchApplication {
                              SourceStream* correction,
                              SinkStream* corrected_ensemble);
 
+  // As SubpatchFinalOutput, but passes the corrected ensemble to |output| as
+  // it is produced rather than keeping it in memory.
+  Status SubpatchFinalOutputToSink(SourceStream* original,
+                                   SourceStream* correction,
+                                   BSDiffOutputSink* output);
+
  private:
   Status SubpatchStreamSets(SinkStreamSet* predicted_items,
                             SourceStream* correction,
@@ -148,6 +204,9 @@ Status EnsemblePatchApplication::ReadInitialParameters(
       case EXE_ELF_32_ARM:
         patcher = new PatcherX86_32(base_region_);
         break;
+      case EXE_ELF_64_X86:
+        patcher = new PatcherX86_32(base_region_);
+        break;
     }
 
     if (patcher)
@@ -276,6 +335,21 @@ Status EnsemblePatchApplication::SubpatchFinalOutput(
   return C_OK;
 }
 
+Status EnsemblePatchApplication::SubpatchFinalOutputToSink(
+    SourceStream* original,
+    SourceStream* correction,
+    BSDiffOutputSink* output) {
+  CrcOutputSink crc_output(output);
+  Status delta_status = ApplySimpleDelta(original, correction, &crc_output);
+  if (delta_status != C_OK)
+    return delta_status;
+
+  if (crc_output.crc() != target_checksum_)
+    return C_BAD_ENSEMBLE_CRC;
+
+  return C_OK;
+}
+
 Status EnsemblePatchApplication::SubpatchStreamSets(
     SinkStreamSet* predicted_items,
     SourceStream* correction,
@@ -301,9 +375,12 @@ Status EnsemblePatchApplication::SubpatchStreamSets(
   return C_OK;
 }
 
-Status ApplyEnsemblePatch(SourceStream* base,
-                          SourceStream* patch,
-                          SinkStream* output) {
+// Applies |patch| to |base|.  The result goes to |output_sink| as it is
+// produced if that isn't NULL, and to |output| otherwise.
+Status ApplyEnsemblePatchTo(SourceStream* base,
+                            SourceStream* patch,
+                            SinkStream* output,
+                            BSDiffOutputSink* output_sink) {
   Status status;
   EnsemblePatchApplication patch_process;
 
@@ -367,14 +444,26 @@ Status ApplyEnsemblePatch(SourceStream* base,
 
   SourceStream final_patch_prediction;
   final_patch_prediction.Init(original_ensemble_and_corrected_base_elements);
-  status = patch_process.SubpatchFinalOutput(&final_patch_prediction,
-                                             ensemble_correction, output);
+  if (output_sink) {
+    status = patch_process.SubpatchFinalOutputToSink(&final_patch_prediction,
+                                                     ensemble_correction,
+                                                     output_sink);
+  } else {
+    status = patch_process.SubpatchFinalOutput(&final_patch_prediction,
+                                               ensemble_correction, output);
+  }
   if (status != C_OK)
     return status;
 
   return C_OK;
 }
 
+Status ApplyEnsemblePatch(SourceStream* base,
+                          SourceStream* patch,
+                          SinkStream* output) {
+  return ApplyEnsemblePatchTo(base, patch, output, NULL);
+}
+
 Status ApplyEnsemblePatch(const base::FilePath::CharType* old_file_name,
                           const base::FilePath::CharType* patch_file_name,
                           const base::FilePath::CharType* new_file_name) {
@@ -399,28 +488,37 @@ Status ApplyEnsemblePatch(const base::FilePath::CharType* old_file_name,
   if (!old_file.Initialize(old_file_path))
     return C_READ_ERROR;
 
-  // Apply patch on streams.
+  // Apply patch on streams, writing the result to a temporary file next to
+  // |new_file_name| as it is produced, so the new version is never held in
+  // memory as a whole and no partial file is left behind on failure.
+  base::FilePath new_file_path(new_file_name);
+  base::FilePath temp_file_path;
+  if (!file_util::CreateTemporaryFileInDir(new_file_path.DirName(),
+                                           &temp_file_path))
+    return C_WRITE_OPEN_ERROR;
+  FILE* new_file = file_util::OpenFile(temp_file_path, "wb");
+  if (!new_file) {
+    base::DeleteFile(temp_file_path, false);
+    return C_WRITE_OPEN_ERROR;
+  }
+
   SourceStream old_source_stream;
   SourceStream patch_source_stream;
   old_source_stream.Init(old_file.data(), old_file.length());
   patch_source_stream.Init(patch_file.data(), patch_file.length());
-  SinkStream new_sink_stream;
-  status = ApplyEnsemblePatch(&old_source_stream, &patch_source_stream,
-                              &new_sink_stream);
-  if (status != C_OK)
+  FileOutputSink new_file_sink(new_file);
+  status = ApplyEnsemblePatchTo(&old_source_stream, &patch_source_stream,
+                                NULL, &new_file_sink);
+  if (new_file_sink.failed())
+    status = C_WRITE_ERROR;
+  if (!file_util::CloseFile(new_file) && status == C_OK)
+    status = C_WRITE_ERROR;
+  if (status == C_OK && !base::ReplaceFile(temp_file_path, new_file_path, NULL))
+    status = C_WRITE_ERROR;
+  if (status != C_OK) {
+    base::DeleteFile(temp_file_path, false);
     return status;
-
-  // Write the patched data to |new_file_name|.
-  base::FilePath new_file_path(new_file_name);
-  int written =
-      file_util::WriteFile(
-          new_file_path,
-          reinterpret_cast<const char*>(new_sink_stream.Buffer()),
-          static_cast<int>(new_sink_stream.Length()));
-  if (written == -1)
-    return C_WRITE_OPEN_ERROR;
-  if (static_cast<size_t>(written) != new_sink_stream.Length())
-    return C_WRITE_ERROR;
+  }
 
   return C_OK;
 }
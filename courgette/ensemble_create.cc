@@ -14,11 +14,15 @@
 
 #include "courgette/ensemble.h"
 
+#include <algorithm>
 #include <limits>
 #include <vector>
 
 #include "base/basictypes.h"
 #include "base/logging.h"
+#include "base/memory/scoped_vector.h"
+#include "base/sys_info.h"
+#include "base/threading/simple_thread.h"
 #include "base/time/time.h"
 
 #include "courgette/crc.h"
@@ -94,6 +98,15 @@ TransformationPatchGenerator* MakeGenerator(Element* old_element,
               EXE_ELF_32_ARM);
       return generator;
     }
+    case EXE_ELF_64_X86: {
+      TransformationPatchGenerator* generator =
+          new PatchGeneratorX86_32(
+              old_element,
+              new_element,
+              new PatcherX86_32(old_element->region()),
+              EXE_ELF_64_X86);
+      return generator;
+    }
   }
 
   LOG(WARNING) << "Unexpected Element::Kind " << old_element->kind();
@@ -229,6 +242,74 @@ void FreeGenerators(std::vector<TransformationPatchGenerator*>* generators) {
   generators->clear();
 }
 
+// Runs the Transform step of one generator.  The elements of an ensemble are
+// transformed independently of each other, so the runners for the different
+// elements can run on separate threads.  Each runner has its own input and
+// output streams, which are only looked at once all the runners are done.
+class TransformRunner : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit TransformRunner(TransformationPatchGenerator* generator)
+      : generator_(generator),
+        status_(C_OK) {
+  }
+
+  virtual void Run() OVERRIDE {
+    status_ = generator_->Transform(&parameters_,
+                                    &predicted_transformed_element_,
+                                    &corrected_transformed_element_);
+  }
+
+  SourceStreamSet* parameters() { return &parameters_; }
+  SinkStreamSet* predicted_transformed_element() {
+    return &predicted_transformed_element_;
+  }
+  SinkStreamSet* corrected_transformed_element() {
+    return &corrected_transformed_element_;
+  }
+  Status status() const { return status_; }
+
+ private:
+  TransformationPatchGenerator* generator_;
+  SourceStreamSet parameters_;
+  SinkStreamSet predicted_transformed_element_;
+  SinkStreamSet corrected_transformed_element_;
+  Status status_;
+
+  DISALLOW_COPY_AND_ASSIGN(TransformRunner);
+};
+
+// Transforms all the elements, using up to one thread per processor.  The
+// results are left in |runners| in the same order as |generators|, so the
+// patch doesn't depend on the order in which the threads finish.
+Status RunTransforms(
+    const std::vector<TransformationPatchGenerator*>& generators,
+    SourceStreamSet* corrected_parameters_source_set,
+    ScopedVector<TransformRunner>* runners) {
+  // The parameters are read up front, as the source set can only be read in
+  // sequence.
+  for (size_t i = 0;  i < generators.size();  ++i) {
+    TransformRunner* runner = new TransformRunner(generators[i]);
+    runners->push_back(runner);
+    if (!corrected_parameters_source_set->ReadSet(runner->parameters()))
+      return C_STREAM_ERROR;
+  }
+
+  int num_threads = std::min(static_cast<int>(runners->size()),
+                             base::SysInfo::NumberOfProcessors());
+  if (num_threads <= 1) {
+    for (size_t i = 0;  i < runners->size();  ++i)
+      (*runners)[i]->Run();
+  } else {
+    base::DelegateSimpleThreadPool pool("CourgetteTransform", num_threads);
+    for (size_t i = 0;  i < runners->size();  ++i)
+      pool.AddWork((*runners)[i], 1);
+    pool.Start();
+    pool.JoinAll();
+  }
+
+  return C_OK;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Status GenerateEnsemblePatch(SourceStream* base,
@@ -326,27 +407,26 @@ Status GenerateEnsemblePatch(SourceStream* base,
   SinkStreamSet predicted_transformed_elements;
   SinkStreamSet corrected_transformed_elements;
 
+  ScopedVector<TransformRunner> runners;
+  Status transform_status =
+      RunTransforms(generators, &corrected_parameters_source_set, &runners);
+  if (transform_status != C_OK)
+    return transform_status;
+
   for (size_t i = 0;  i < number_of_transformations;  ++i) {
-    SourceStreamSet single_parameters;
-    if (!corrected_parameters_source_set.ReadSet(&single_parameters))
-      return C_STREAM_ERROR;
-    SinkStreamSet single_predicted_transformed_element;
-    SinkStreamSet single_corrected_transformed_element;
-    Status status = generators[i]->Transform(
-        &single_parameters,
-        &single_predicted_transformed_element,
-        &single_corrected_transformed_element);
-    if (status != C_OK)
-      return status;
-    if (!single_parameters.Empty())
+    TransformRunner* runner = runners[i];
+    if (runner->status() != C_OK)
+      return runner->status();
+    if (!runner->parameters()->Empty())
       return C_STREAM_NOT_CONSUMED;
     if (!predicted_transformed_elements.WriteSet(
-            &single_predicted_transformed_element))
+            runner->predicted_transformed_element()))
       return C_STREAM_ERROR;
     if (!corrected_transformed_elements.WriteSet(
-            &single_corrected_transformed_element))
+            runner->corrected_transformed_element()))
       return C_STREAM_ERROR;
   }
+  runners.clear();
 
   if (!corrected_parameters_source_set.Empty())
     return C_STREAM_NOT_CONSUMED;
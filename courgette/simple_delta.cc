@@ -31,6 +31,11 @@ Status ApplySimpleDelta(SourceStream* old, SourceStream* delta,
   return BSDiffStatusToStatus(ApplyBinaryPatch(old, delta, target));
 }
 
+Status ApplySimpleDelta(SourceStream* old, SourceStream* delta,
+                        BSDiffOutputSink* target) {
+  return BSDiffStatusToStatus(ApplyBinaryPatch(old, delta, target));
+}
+
 Status GenerateSimpleDelta(SourceStream* old, SourceStream* target,
                            SinkStream* delta) {
   VLOG(1) << "GenerateSimpleDelta " << old->Remaining()
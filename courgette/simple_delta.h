@@ -12,9 +12,15 @@
 
 namespace courgette {
 
+class BSDiffOutputSink;
+
 Status ApplySimpleDelta(SourceStream* old, SourceStream* delta,
                         SinkStream* target);
 
+// As above, but passes the result to |target| as it is produced.
+Status ApplySimpleDelta(SourceStream* old, SourceStream* delta,
+                        BSDiffOutputSink* target);
+
 Status GenerateSimpleDelta(SourceStream* old, SourceStream* target,
                            SinkStream* delta);
 
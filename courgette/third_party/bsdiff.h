@@ -73,6 +73,22 @@ BSDiffStatus ApplyBinaryPatch(const base::FilePath& old_stream,
                               const base::FilePath& patch_stream,
                               const base::FilePath& new_stream);
 
+// Receives the result of applying a patch, in order, one piece at a time.
+class BSDiffOutputSink {
+ public:
+  virtual ~BSDiffOutputSink() {}
+
+  // Takes the next |length| bytes of the result.  Returns false if they could
+  // not be stored, which stops the patch application.
+  virtual bool Consume(const uint8* data, size_t length) = 0;
+};
+
+// As the first ApplyBinaryPatch, but passes the result to |output_sink| as it
+// is produced instead of collecting all of it in memory.
+BSDiffStatus ApplyBinaryPatch(SourceStream* old_stream,
+                              SourceStream* patch_stream,
+                              BSDiffOutputSink* output_sink);
+
 // The following declarations are common to the patch-creation and
 // patch-application code.
 
@@ -36,12 +36,21 @@
 
 #include "courgette/third_party/bsdiff.h"
 
+#include <algorithm>
+
 #include "base/files/memory_mapped_file.h"
 #include "courgette/crc.h"
 #include "courgette/streams.h"
 
 namespace courgette {
 
+namespace {
+
+// The amount of output collected before it is passed to a BSDiffOutputSink.
+const size_t kOutputChunkSize = 1 << 20;
+
+}  // namespace
+
 BSDiffStatus MBS_ReadHeader(SourceStream* stream, MBSPatchHeader* header) {
   if (!stream->Read(header->tag, sizeof(header->tag))) return READ_ERROR;
   if (!stream->ReadVarint32(&header->slen)) return READ_ERROR;
@@ -57,10 +66,13 @@ BSDiffStatus MBS_ReadHeader(SourceStream* stream, MBSPatchHeader* header) {
   return OK;
 }
 
+// If |output_sink| is not NULL, |new_stream| only holds the output that
+// hasn't been passed to |output_sink| yet.
 BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader *header,
                             SourceStream* patch_stream,
                             const uint8* old_start, size_t old_size,
-                            SinkStream* new_stream) {
+                            SinkStream* new_stream,
+                            BSDiffOutputSink* output_sink) {
   const uint8* old_end = old_start + old_size;
 
   SourceStreamSet patch_streams;
@@ -80,7 +92,10 @@ BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader *header,
 
   const uint8* old_position = old_start;
 
-  if (header->dlen && !new_stream->Reserve(header->dlen))
+  size_t reserve_size = header->dlen;
+  if (output_sink)
+    reserve_size = std::min(reserve_size, kOutputChunkSize);
+  if (reserve_size && !new_stream->Reserve(reserve_size))
     return MEM_ERROR;
 
   uint32 pending_diff_zeros = 0;
@@ -138,6 +153,14 @@ BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader *header,
       return UNEXPECTED_ERROR;
 
     old_position += seek_adjustment;
+
+    if (output_sink && new_stream->Length() >= kOutputChunkSize) {
+      if (!output_sink->Consume(new_stream->Buffer(), new_stream->Length()))
+        return WRITE_ERROR;
+      new_stream->Retire();
+      if (!new_stream->Reserve(kOutputChunkSize))
+        return MEM_ERROR;
+    }
   }
 
   if (!control_stream_copy_counts->Empty() ||
@@ -148,6 +171,12 @@ BSDiffStatus MBS_ApplyPatch(const MBSPatchHeader *header,
       !extra_bytes->Empty())
     return UNEXPECTED_ERROR;
 
+  if (output_sink && new_stream->Length() > 0) {
+    if (!output_sink->Consume(new_stream->Buffer(), new_stream->Length()))
+      return WRITE_ERROR;
+    new_stream->Retire();
+  }
+
   return OK;
 }
 
@@ -166,11 +195,31 @@ BSDiffStatus ApplyBinaryPatch(SourceStream* old_stream,
   if (CalculateCrc(old_start, old_size) != header.scrc32)
     return CRC_ERROR;
 
-  MBS_ApplyPatch(&header, patch_stream, old_start, old_size, new_stream);
+  MBS_ApplyPatch(&header, patch_stream, old_start, old_size, new_stream, NULL);
 
   return OK;
 }
 
+BSDiffStatus ApplyBinaryPatch(SourceStream* old_stream,
+                              SourceStream* patch_stream,
+                              BSDiffOutputSink* output_sink) {
+  MBSPatchHeader header;
+  BSDiffStatus ret = MBS_ReadHeader(patch_stream, &header);
+  if (ret != OK) return ret;
+
+  const uint8* old_start = old_stream->Buffer();
+  size_t old_size = old_stream->Remaining();
+
+  if (old_size != header.slen) return UNEXPECTED_ERROR;
+
+  if (CalculateCrc(old_start, old_size) != header.scrc32)
+    return CRC_ERROR;
+
+  SinkStream pending_output;
+  return MBS_ApplyPatch(&header, patch_stream, old_start, old_size,
+                        &pending_output, output_sink);
+}
+
 BSDiffStatus ApplyBinaryPatch(const base::FilePath& old_file_path,
                               const base::FilePath& patch_file_path,
                               const base::FilePath& new_file_path) {
@@ -16,6 +16,19 @@ typedef uint32 Elf32_Off; // Unsigned file offset
 typedef int32 Elf32_Sword; // Signed large integer
 typedef uint32 Elf32_Word; // Unsigned large integer
 
+typedef uint64 Elf64_Addr; // Unsigned program address
+typedef uint16 Elf64_Half; // Unsigned medium integer
+typedef uint64 Elf64_Off; // Unsigned file offset
+typedef uint32 Elf64_Word; // Unsigned integer
+typedef uint64 Elf64_Xword; // Unsigned long integer
+typedef int64 Elf64_Sxword; // Signed long integer
+
+// Values for header->e_ident[EI_CLASS]
+enum e_ident_class_values {
+  EI_CLASS = 4, // Index of the file class in e_ident
+  ELFCLASS32 = 1, // 32-bit objects
+  ELFCLASS64 = 2, // 64-bit objects
+};
 
 // The header at the top of the file
 struct Elf32_Ehdr {
@@ -35,6 +48,24 @@ struct Elf32_Ehdr {
   Elf32_Half     e_shstrndx;
 };
 
+// The header at the top of a 64-bit file
+struct Elf64_Ehdr {
+  unsigned char  e_ident[16];
+  Elf64_Half     e_type;
+  Elf64_Half     e_machine;
+  Elf64_Word     e_version;
+  Elf64_Addr     e_entry;
+  Elf64_Off      e_phoff;
+  Elf64_Off      e_shoff;
+  Elf64_Word     e_flags;
+  Elf64_Half     e_ehsize;
+  Elf64_Half     e_phentsize;
+  Elf64_Half     e_phnum;
+  Elf64_Half     e_shentsize;
+  Elf64_Half     e_shnum;
+  Elf64_Half     e_shstrndx;
+};
+
 // values for header->e_type
 enum e_type_values {
   ET_NONE = 0, // No file type
@@ -69,6 +100,20 @@ struct Elf32_Shdr {
   Elf32_Word   sh_entsize;
 };
 
+// A section header in the section header table of a 64-bit file
+struct Elf64_Shdr {
+  Elf64_Word   sh_name;
+  Elf64_Word   sh_type;
+  Elf64_Xword  sh_flags;
+  Elf64_Addr   sh_addr;
+  Elf64_Off    sh_offset;
+  Elf64_Xword  sh_size;
+  Elf64_Word   sh_link;
+  Elf64_Word   sh_info;
+  Elf64_Xword  sh_addralign;
+  Elf64_Xword  sh_entsize;
+};
+
 // Values for the section type field in a section header
 enum sh_type_values {
   SHT_NULL = 0,
@@ -91,6 +136,13 @@ enum sh_type_values {
   SHT_HIUSER = 0xffffffff,
 };
 
+// Values for the section flags field in a section header
+enum sh_flags_values {
+  SHF_WRITE = 0x1,
+  SHF_ALLOC = 0x2,
+  SHF_EXECINSTR = 0x4,
+};
+
 struct Elf32_Phdr {
   Elf32_Word    p_type;
   Elf32_Off     p_offset;
@@ -102,6 +154,17 @@ struct Elf32_Phdr {
   Elf32_Word    p_align;
 };
 
+struct Elf64_Phdr {
+  Elf64_Word    p_type;
+  Elf64_Word    p_flags;
+  Elf64_Off     p_offset;
+  Elf64_Addr    p_vaddr;
+  Elf64_Addr    p_paddr;
+  Elf64_Xword   p_filesz;
+  Elf64_Xword   p_memsz;
+  Elf64_Xword   p_align;
+};
+
 // Values for the segment type field in a program segment header
 enum ph_type_values {
   PT_NULL = 0,
@@ -126,6 +189,12 @@ struct Elf32_Rela {
   Elf32_Sword   r_addend;
 };
 
+struct Elf64_Rela {
+  Elf64_Addr    r_offset;
+  Elf64_Xword   r_info;
+  Elf64_Sxword  r_addend;
+};
+
 enum elf32_rel_386_type_values {
   R_386_NONE = 0,
   R_386_32 = 1,
@@ -145,4 +214,16 @@ enum elf32_rel_arm_type_values {
   R_ARM_RELATIVE = 23,
 };
 
+enum elf64_rel_x86_64_type_values {
+  R_X86_64_NONE = 0,
+  R_X86_64_64 = 1,
+  R_X86_64_PC32 = 2,
+  R_X86_64_GOT32 = 3,
+  R_X86_64_PLT32 = 4,
+  R_X86_64_COPY = 5,
+  R_X86_64_GLOB_DAT = 6,
+  R_X86_64_JUMP_SLOT = 7,
+  R_X86_64_RELATIVE = 8,
+};
+
 #endif  // COURGETTE_ELF_TYPES_H_
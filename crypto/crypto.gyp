@@ -35,6 +35,11 @@
         4018,
       ],
       'conditions': [
+        [ 'target_arch == "ia32" or target_arch == "x64"', {
+          'dependencies': [
+            'crypto_clmul',
+          ],
+        }],
         [ 'os_posix == 1 and OS != "mac" and OS != "ios" and OS != "android"', {
           'dependencies': [
             '../build/linux/system.gyp:ssl',
@@ -226,6 +231,7 @@
         'secure_hash_openssl.cc',
         'sha2.cc',
         'sha2.h',
+        'sha2_multi_buffer.cc',
         'signature_creator.h',
         'signature_creator_nss.cc',
         'signature_creator_openssl.cc',
@@ -242,6 +248,40 @@
         'third_party/nss/secsign.cc',
       ],
     },
+    {
+      # The PCLMULQDQ implementation of GHASH, which needs its own compiler
+      # flags. It is only called after checking that the CPU supports it.
+      'target_name': 'crypto_clmul',
+      'type': 'static_library',
+      'dependencies': [
+        '../base/base.gyp:base',
+      ],
+      'defines': [
+        'CRYPTO_IMPLEMENTATION',
+      ],
+      'sources': [
+        'ghash_clmul.cc',
+      ],
+      'conditions': [
+        [ 'target_arch != "ia32" and target_arch != "x64"', {
+          'sources!': [
+            'ghash_clmul.cc',
+          ],
+        }],
+        [ '(target_arch == "ia32" or target_arch == "x64") and OS != "win"', {
+          'cflags': [
+            '-msse2',
+            '-mpclmul',
+          ],
+          'xcode_settings': {
+            'OTHER_CFLAGS': [
+              '-msse2',
+              '-mpclmul',
+            ],
+          },
+        }],
+      ],
+    },
     {
       'target_name': 'crypto_unittests',
       'type': 'executable',
@@ -4,6 +4,8 @@
 
 #include "crypto/ghash.h"
 
+#include "base/cpu.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/sys_byteorder.h"
 
@@ -37,6 +39,22 @@ void Put64(uint8 bytes[8], uint64 x) {
   memcpy(bytes, &x, sizeof(x));
 }
 
+#if defined(ARCH_CPU_X86_FAMILY)
+// CLMULSupport checks once whether the CPU has the PCLMULQDQ instruction.
+class CLMULSupport {
+ public:
+  CLMULSupport() : supported_(base::CPU().has_pclmul()) {}
+
+  bool supported() const { return supported_; }
+
+ private:
+  const bool supported_;
+};
+
+base::LazyInstance<CLMULSupport>::Leaky g_clmul_support =
+    LAZY_INSTANCE_INITIALIZER;
+#endif
+
 // Reverse reverses the order of the bits of 4-bit number in |i|.
 int Reverse(int i) {
   i = ((i << 2) & 0xc) | ((i >> 2) & 0x3);
@@ -46,8 +64,11 @@ int Reverse(int i) {
 
 }  // namespace
 
-GaloisHash::GaloisHash(const uint8 key[16]) {
+GaloisHash::GaloisHash(const uint8 key[16]) : use_clmul_(false) {
   Reset();
+#if defined(ARCH_CPU_X86_FAMILY)
+  use_clmul_ = g_clmul_support.Get().supported();
+#endif
 
   // We precompute 16 multiples of |key|. However, when we do lookups into this
   // table we'll be using bits from a field element and therefore the bits will
@@ -218,6 +239,13 @@ void GaloisHash::Mul16(FieldElement* x) {
 }
 
 void GaloisHash::UpdateBlocks(const uint8* bytes, size_t num_blocks) {
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (use_clmul_) {
+    UpdateBlocksCLMUL(product_table_[Reverse(1)], &y_, bytes, num_blocks);
+    return;
+  }
+#endif
+
   for (size_t i = 0; i < num_blocks; i++) {
     y_.low ^= Get64(bytes);
     bytes += 8;
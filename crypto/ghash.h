@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "base/basictypes.h"
+#include "build/build_config.h"
 #include "crypto/crypto_export.h"
 
 namespace crypto {
@@ -69,6 +70,15 @@ class CRYPTO_EXPORT_PRIVATE GaloisHash {
 
   // UpdateBlocks processes |num_blocks| 16-bytes blocks from |bytes|.
   void UpdateBlocks(const uint8* bytes, size_t num_blocks);
+#if defined(ARCH_CPU_X86_FAMILY)
+  // UpdateBlocksCLMUL sets |y| = (...((|y|+b_1)*|h| + b_2)*|h| ...)*|h| for
+  // the |num_blocks| 16-byte blocks b_i in |bytes|, using the PCLMULQDQ
+  // instruction. It must only be called if the CPU supports it.
+  static void UpdateBlocksCLMUL(const FieldElement& h,
+                                FieldElement* y,
+                                const uint8* bytes,
+                                size_t num_blocks);
+#endif
   // Update processes |length| bytes from |bytes| and calls UpdateBlocks on as
   // much data as possible. It uses |buf_| to buffer any remaining data and
   // always consumes all of |bytes|.
@@ -81,6 +91,9 @@ class CRYPTO_EXPORT_PRIVATE GaloisHash {
   uint8 buf_[16];
   size_t buf_used_;
   FieldElement product_table_[16];
+  // True if UpdateBlocksCLMUL() can be used in place of the table based
+  // multiplication.
+  bool use_clmul_;
 };
 
 }  // namespace crypto
@@ -0,0 +1,100 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "crypto/ghash.h"
+
+#include <emmintrin.h>
+#include <wmmintrin.h>
+
+#include "base/sys_byteorder.h"
+
+// This file is built with the flags needed for the PCLMULQDQ intrinsics, so
+// nothing in it may run unless the CPU has been checked for support first.
+//
+// The multiplication follows "Intel Carry-Less Multiplication Instruction and
+// its Usage for Computing the GCM Mode" (Gueron and Kounavis), algorithms 2
+// and 4. Field elements are held with their bytes reversed, which puts the
+// bit-reflected GCM representation into the form that PCLMULQDQ expects, up
+// to a one bit shift of the product.
+
+namespace crypto {
+
+namespace {
+
+// ToM128 converts a field element to a byte-reversed 128-bit value. The
+// |low| word of a FieldElement holds the first eight bytes of the block in
+// big-endian order, so it becomes the high half.
+__m128i ToM128(uint64 low, uint64 hi) {
+  return _mm_set_epi32(static_cast<int>(low >> 32), static_cast<int>(low),
+                       static_cast<int>(hi >> 32), static_cast<int>(hi));
+}
+
+// Get64 reads a 64-bit, big-endian number from |bytes|.
+uint64 Get64(const uint8 bytes[8]) {
+  uint64 t;
+  memcpy(&t, bytes, sizeof(t));
+  return base::NetToHost64(t);
+}
+
+// Mul returns |a|*|b| in GF(2^128), for byte-reversed |a| and |b|.
+__m128i Mul(__m128i a, __m128i b) {
+  // Schoolbook multiplication of the two 128-bit polynomials, giving the
+  // 256-bit product |hi|:|lo|.
+  __m128i lo = _mm_clmulepi64_si128(a, b, 0x00);
+  __m128i mid = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10),
+                              _mm_clmulepi64_si128(a, b, 0x01));
+  __m128i hi = _mm_clmulepi64_si128(a, b, 0x11);
+  lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+  hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+  // The operands are bit-reflected, so the product is one bit short of where
+  // it should be. Shift the 256-bit value left by one.
+  __m128i lo_carry = _mm_srli_epi32(lo, 31);
+  __m128i hi_carry = _mm_srli_epi32(hi, 31);
+  lo = _mm_slli_epi32(lo, 1);
+  hi = _mm_slli_epi32(hi, 1);
+  __m128i cross_carry = _mm_srli_si128(lo_carry, 12);
+  hi_carry = _mm_slli_si128(hi_carry, 4);
+  lo_carry = _mm_slli_si128(lo_carry, 4);
+  lo = _mm_or_si128(lo, lo_carry);
+  hi = _mm_or_si128(hi, hi_carry);
+  hi = _mm_or_si128(hi, cross_carry);
+
+  // Reduce modulo 1+x+x^2+x^7+x^128, in the reflected form.
+  __m128i t = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31),
+                                          _mm_slli_epi32(lo, 30)),
+                            _mm_slli_epi32(lo, 25));
+  __m128i t_high = _mm_srli_si128(t, 4);
+  lo = _mm_xor_si128(lo, _mm_slli_si128(t, 12));
+  __m128i u = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1),
+                                          _mm_srli_epi32(lo, 2)),
+                            _mm_srli_epi32(lo, 7));
+  u = _mm_xor_si128(u, t_high);
+  lo = _mm_xor_si128(lo, u);
+  return _mm_xor_si128(hi, lo);
+}
+
+}  // namespace
+
+// static
+void GaloisHash::UpdateBlocksCLMUL(const FieldElement& h,
+                                   FieldElement* y,
+                                   const uint8* bytes,
+                                   size_t num_blocks) {
+  const __m128i hh = ToM128(h.low, h.hi);
+  __m128i yy = ToM128(y->low, y->hi);
+
+  for (size_t i = 0; i < num_blocks; i++) {
+    yy = _mm_xor_si128(yy, ToM128(Get64(bytes), Get64(bytes + 8)));
+    bytes += 16;
+    yy = Mul(yy, hh);
+  }
+
+  uint64 words[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(words), yy);
+  y->low = words[1];
+  y->hi = words[0];
+}
+
+}  // namespace crypto
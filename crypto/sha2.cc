@@ -4,12 +4,123 @@
 
 #include "crypto/sha2.h"
 
+#include "base/compiler_specific.h"
+#include "base/files/file_path.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/platform_file.h"
 #include "base/stl_util.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/simple_thread.h"
 #include "crypto/secure_hash.h"
 
 namespace crypto {
 
+namespace {
+
+// ChunkReader reads a file on its own thread, into a small ring of buffers
+// that the hashing thread takes chunks from. The reader runs ahead of the
+// hashing by at most kBuffers chunks.
+class ChunkReader : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit ChunkReader(base::PlatformFile file)
+      : file_(file),
+        ready_(&lock_),
+        filled_(0),
+        read_index_(0),
+        write_index_(0),
+        taken_(false),
+        done_(false),
+        failed_(false) {
+    for (size_t i = 0; i < kBuffers; ++i)
+      sizes_[i] = 0;
+  }
+
+  // Returns the next chunk of the file in |data| and |size|, or false at the
+  // end of the file or on a read error. The chunk stays valid until the next
+  // call.
+  bool NextChunk(const char** data, int* size) {
+    base::AutoLock auto_lock(lock_);
+    if (taken_) {
+      // The previous chunk has been hashed; give its buffer back.
+      read_index_ = (read_index_ + 1) % kBuffers;
+      --filled_;
+      taken_ = false;
+      ready_.Broadcast();
+    }
+    while (filled_ == 0 && !done_)
+      ready_.Wait();
+    if (filled_ == 0)
+      return false;
+    *data = buffers_[read_index_];
+    *size = sizes_[read_index_];
+    taken_ = true;
+    return true;
+  }
+
+  bool failed() {
+    base::AutoLock auto_lock(lock_);
+    return failed_;
+  }
+
+  // base::DelegateSimpleThread::Delegate implementation.
+  virtual void Run() OVERRIDE {
+    for (;;) {
+      size_t index;
+      {
+        base::AutoLock auto_lock(lock_);
+        while (filled_ == kBuffers)
+          ready_.Wait();
+        index = write_index_;
+      }
+
+      // Only this thread touches a buffer that isn't filled, so the read
+      // doesn't need the lock.
+      int size = base::ReadPlatformFileCurPosNoBestEffort(
+          file_, buffers_[index], kChunkSize);
+
+      base::AutoLock auto_lock(lock_);
+      if (size <= 0) {
+        failed_ = size < 0;
+        done_ = true;
+        ready_.Broadcast();
+        return;
+      }
+      sizes_[index] = size;
+      write_index_ = (write_index_ + 1) % kBuffers;
+      ++filled_;
+      ready_.Broadcast();
+    }
+  }
+
+ private:
+  static const size_t kBuffers = 3;
+  static const int kChunkSize = 64 * 1024;
+
+  const base::PlatformFile file_;
+
+  base::Lock lock_;
+  // Signalled when a buffer is filled or given back, and at the end of the
+  // file.
+  base::ConditionVariable ready_;
+
+  char buffers_[kBuffers][kChunkSize];
+  int sizes_[kBuffers];
+
+  // The number of filled buffers, including one that has been handed out.
+  size_t filled_;
+  size_t read_index_;
+  size_t write_index_;
+  // True if buffers_[read_index_] has been handed out by NextChunk().
+  bool taken_;
+  bool done_;
+  bool failed_;
+
+  DISALLOW_COPY_AND_ASSIGN(ChunkReader);
+};
+
+}  // namespace
+
 void SHA256HashString(const base::StringPiece& str, void* output, size_t len) {
   scoped_ptr<SecureHash> ctx(SecureHash::Create(SecureHash::SHA256));
   ctx->Update(str.data(), str.length());
@@ -22,4 +133,29 @@ std::string SHA256HashString(const base::StringPiece& str) {
   return output;
 }
 
+bool SHA256HashFile(const base::FilePath& path, void* output, size_t len) {
+  base::PlatformFile file = base::CreatePlatformFile(
+      path, base::PLATFORM_FILE_OPEN | base::PLATFORM_FILE_READ, NULL, NULL);
+  if (file == base::kInvalidPlatformFileValue)
+    return false;
+
+  scoped_ptr<SecureHash> ctx(SecureHash::Create(SecureHash::SHA256));
+  scoped_ptr<ChunkReader> reader(new ChunkReader(file));
+  base::DelegateSimpleThread thread(reader.get(), "SHA256HashFile");
+  thread.Start();
+
+  const char* data;
+  int size;
+  while (reader->NextChunk(&data, &size))
+    ctx->Update(data, size);
+
+  thread.Join();
+  base::ClosePlatformFile(file);
+  if (reader->failed())
+    return false;
+
+  ctx->Finish(output, len);
+  return true;
+}
+
 }  // namespace crypto
@@ -6,10 +6,15 @@
 #define CRYPTO_SHA2_H_
 
 #include <string>
+#include <vector>
 
 #include "base/strings/string_piece.h"
 #include "crypto/crypto_export.h"
 
+namespace base {
+class FilePath;
+}
+
 namespace crypto {
 
 // These functions perform SHA-256 operations.
@@ -28,6 +33,22 @@ CRYPTO_EXPORT void SHA256HashString(const base::StringPiece& str,
 // string.
 CRYPTO_EXPORT std::string SHA256HashString(const base::StringPiece& str);
 
+// Computes the SHA-256 hashes of each of |inputs|, and stores them in
+// |outputs| as 32-byte strings, in the same order. On x86 CPUs this hashes
+// four inputs at a time in the lanes of the SSE2 registers, which is much
+// faster than hashing them one after another when there are many of them.
+CRYPTO_EXPORT void SHA256HashStrings(
+    const std::vector<base::StringPiece>& inputs,
+    std::vector<std::string>* outputs);
+
+// Computes the SHA-256 hash of the contents of the file at |path| and stores
+// the first |len| bytes of the hash in |output|, like SHA256HashString().
+// The file is read on a separate thread, so that reading each chunk overlaps
+// with hashing the one before it. Returns false if the file could not be
+// opened or read. This does blocking I/O.
+CRYPTO_EXPORT bool SHA256HashFile(const base::FilePath& path,
+                                  void* output, size_t len);
+
 }  // namespace crypto
 
 #endif  // CRYPTO_SHA2_H_
@@ -0,0 +1,274 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "crypto/sha2.h"
+
+#include <string.h>
+
+#include "base/basictypes.h"
+#include "base/logging.h"
+#include "base/stl_util.h"
+#include "base/sys_byteorder.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && \
+    (defined(__SSE2__) || defined(_M_X64) || \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SHA256_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace crypto {
+
+namespace {
+
+#if defined(SHA256_USE_SSE2)
+
+// Multi-buffer SHA-256 -------------------------------------------------------
+
+// SHA-256 works on 32-bit words, so an SSE2 register holds the same word of
+// four independent hash computations. Each of the four lanes is fed its own
+// input, one 64-byte block at a time, and when a lane runs out of input it
+// starts on the next one. See FIPS 180-4 for the algorithm itself.
+
+const size_t kLanes = 4;
+const size_t kBlockSize = 64;
+
+const uint32 kRoundConstants[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+  0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+  0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+  0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+  0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+  0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+const uint32 kInitialState[8] = {
+  0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+  0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+// Lane holds the progress of one input through the hash.
+class Lane {
+ public:
+  Lane() : index_(0), offset_(0), tail_blocks_(0), blocks_left_(0) {}
+
+  // Starts hashing |input|, which is the |index|th input.
+  void Start(size_t index, const base::StringPiece& input) {
+    index_ = index;
+    input_ = input;
+    offset_ = 0;
+
+    // The input is followed by a one bit, zeros, and the 64-bit bit length,
+    // which takes one or two extra blocks after the last full one.
+    const size_t full_blocks = input.size() / kBlockSize;
+    const size_t remainder = input.size() % kBlockSize;
+    tail_blocks_ = remainder + 1 + 8 <= kBlockSize ? 1 : 2;
+    memset(tail_, 0, sizeof(tail_));
+    memcpy(tail_, input.data() + full_blocks * kBlockSize, remainder);
+    tail_[remainder] = 0x80;
+    const uint64 bit_length = base::HostToNet64(
+        static_cast<uint64>(input.size()) * 8);
+    memcpy(tail_ + tail_blocks_ * kBlockSize - 8, &bit_length, 8);
+
+    blocks_left_ = full_blocks + tail_blocks_;
+  }
+
+  bool active() const { return blocks_left_ > 0; }
+  size_t index() const { return index_; }
+
+  // Returns the next block of the padded input. The block stays valid until
+  // the next call to Start().
+  const uint8* NextBlock() {
+    DCHECK(active());
+    const uint8* block;
+    if (blocks_left_ > tail_blocks_) {
+      block = reinterpret_cast<const uint8*>(input_.data()) + offset_;
+      offset_ += kBlockSize;
+    } else {
+      block = tail_ + (tail_blocks_ - blocks_left_) * kBlockSize;
+    }
+    --blocks_left_;
+    return block;
+  }
+
+ private:
+  size_t index_;
+  base::StringPiece input_;
+  size_t offset_;
+  uint8 tail_[2 * kBlockSize];
+  size_t tail_blocks_;
+  size_t blocks_left_;
+};
+
+inline __m128i Rotr(__m128i x, int n) {
+  return _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32 - n));
+}
+
+inline __m128i Add(__m128i a, __m128i b) {
+  return _mm_add_epi32(a, b);
+}
+
+// Load32 reads the big-endian word at |offset| in each of the blocks.
+inline __m128i Load32(const uint8* const blocks[kLanes], size_t offset) {
+  uint32 words[kLanes];
+  for (size_t i = 0; i < kLanes; ++i) {
+    memcpy(&words[i], blocks[i] + offset, 4);
+    words[i] = base::NetToHost32(words[i]);
+  }
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(words));
+}
+
+// Compress runs the SHA-256 compression function on one block for each lane.
+// |state| holds the eight state words of the four lanes.
+void Compress(__m128i state[8], const uint8* const blocks[kLanes]) {
+  __m128i w[16];
+  __m128i a = state[0], b = state[1], c = state[2], d = state[3];
+  __m128i e = state[4], f = state[5], g = state[6], h = state[7];
+
+  for (size_t t = 0; t < 64; ++t) {
+    __m128i wt;
+    if (t < 16) {
+      wt = Load32(blocks, t * 4);
+    } else {
+      const __m128i w15 = w[(t - 15) & 15];
+      const __m128i w2 = w[(t - 2) & 15];
+      const __m128i s0 = _mm_xor_si128(_mm_xor_si128(Rotr(w15, 7),
+                                                     Rotr(w15, 18)),
+                                       _mm_srli_epi32(w15, 3));
+      const __m128i s1 = _mm_xor_si128(_mm_xor_si128(Rotr(w2, 17),
+                                                     Rotr(w2, 19)),
+                                       _mm_srli_epi32(w2, 10));
+      wt = Add(Add(w[t & 15], s0), Add(w[(t - 7) & 15], s1));
+    }
+    w[t & 15] = wt;
+
+    const __m128i s1 = _mm_xor_si128(_mm_xor_si128(Rotr(e, 6), Rotr(e, 11)),
+                                     Rotr(e, 25));
+    const __m128i ch = _mm_xor_si128(_mm_and_si128(e, f),
+                                     _mm_andnot_si128(e, g));
+    const __m128i t1 = Add(Add(Add(h, s1), Add(ch, wt)),
+                           _mm_set1_epi32(kRoundConstants[t]));
+    const __m128i s0 = _mm_xor_si128(_mm_xor_si128(Rotr(a, 2), Rotr(a, 13)),
+                                     Rotr(a, 22));
+    const __m128i maj = _mm_xor_si128(
+        _mm_xor_si128(_mm_and_si128(a, b), _mm_and_si128(a, c)),
+        _mm_and_si128(b, c));
+    const __m128i t2 = Add(s0, maj);
+
+    h = g;
+    g = f;
+    f = e;
+    e = Add(d, t1);
+    d = c;
+    c = b;
+    b = a;
+    a = Add(t1, t2);
+  }
+
+  state[0] = Add(state[0], a);
+  state[1] = Add(state[1], b);
+  state[2] = Add(state[2], c);
+  state[3] = Add(state[3], d);
+  state[4] = Add(state[4], e);
+  state[5] = Add(state[5], f);
+  state[6] = Add(state[6], g);
+  state[7] = Add(state[7], h);
+}
+
+// ResetLane sets the state of |lane| to the initial SHA-256 state.
+void ResetLane(__m128i state[8], size_t lane) {
+  for (size_t i = 0; i < 8; ++i) {
+    uint32 words[kLanes];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(words), state[i]);
+    words[lane] = kInitialState[i];
+    state[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words));
+  }
+}
+
+// GetLaneHash writes the hash in |lane| to |output|.
+void GetLaneHash(const __m128i state[8], size_t lane, std::string* output) {
+  output->resize(kSHA256Length);
+  uint8* out = reinterpret_cast<uint8*>(string_as_array(output));
+  for (size_t i = 0; i < 8; ++i) {
+    uint32 words[kLanes];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(words), state[i]);
+    const uint32 word = base::HostToNet32(words[lane]);
+    memcpy(out + i * 4, &word, 4);
+  }
+}
+
+void SHA256HashStringsSSE2(const std::vector<base::StringPiece>& inputs,
+                           std::vector<std::string>* outputs) {
+  // Idle lanes hash this block, and their results are thrown away.
+  static const uint8 kIdleBlock[kBlockSize] = { 0 };
+
+  Lane lanes[kLanes];
+  __m128i state[8];
+  for (size_t i = 0; i < 8; ++i)
+    state[i] = _mm_setzero_si128();
+
+  size_t next_input = 0;
+  for (size_t i = 0; i < kLanes && next_input < inputs.size(); ++i) {
+    lanes[i].Start(next_input, inputs[next_input]);
+    ResetLane(state, i);
+    ++next_input;
+  }
+
+  bool any_active = true;
+  while (any_active) {
+    const uint8* blocks[kLanes];
+    bool last_block[kLanes];
+    for (size_t i = 0; i < kLanes; ++i) {
+      const bool was_active = lanes[i].active();
+      blocks[i] = was_active ? lanes[i].NextBlock() : kIdleBlock;
+      last_block[i] = was_active && !lanes[i].active();
+    }
+
+    Compress(state, blocks);
+
+    any_active = false;
+    for (size_t i = 0; i < kLanes; ++i) {
+      if (last_block[i]) {
+        GetLaneHash(state, i, &(*outputs)[lanes[i].index()]);
+        if (next_input < inputs.size()) {
+          lanes[i].Start(next_input, inputs[next_input]);
+          ResetLane(state, i);
+          ++next_input;
+        }
+      }
+      any_active |= lanes[i].active();
+    }
+  }
+}
+
+#endif  // defined(SHA256_USE_SSE2)
+
+}  // namespace
+
+void SHA256HashStrings(const std::vector<base::StringPiece>& inputs,
+                       std::vector<std::string>* outputs) {
+  outputs->resize(inputs.size());
+#if defined(SHA256_USE_SSE2)
+  // With a single input, three of the four lanes would be wasted.
+  if (inputs.size() > 1) {
+    SHA256HashStringsSSE2(inputs, outputs);
+    return;
+  }
+#endif
+  for (size_t i = 0; i < inputs.size(); ++i)
+    (*outputs)[i] = SHA256HashString(inputs[i]);
+}
+
+}  // namespace crypto
@@ -5,6 +5,8 @@
 #include "crypto/sha2.h"
 
 #include "base/basictypes.h"
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 TEST(Sha256Test, Test1) {
@@ -98,3 +100,61 @@ TEST(Sha256Test, Test3) {
   for (size_t i = 0; i < sizeof(output_truncated3); i++)
     EXPECT_EQ(expected3[i], static_cast<int>(output_truncated3[i]));
 }
+
+TEST(Sha256Test, HashStrings) {
+  // Inputs of every length around the one and two padding block boundaries,
+  // and a few long ones, so that the lanes finish at different times.
+  std::string data(3000, 0);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i * 7 + i / 256);
+
+  std::vector<base::StringPiece> inputs;
+  for (size_t length = 0; length <= 130; ++length)
+    inputs.push_back(base::StringPiece(data.data() + length, length));
+  inputs.push_back(base::StringPiece(data.data(), 1000));
+  inputs.push_back(base::StringPiece(data.data() + 1, 2999));
+  inputs.push_back(base::StringPiece(data.data() + 2, 5));
+
+  std::vector<std::string> outputs;
+  crypto::SHA256HashStrings(inputs, &outputs);
+  ASSERT_EQ(inputs.size(), outputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i)
+    EXPECT_EQ(crypto::SHA256HashString(inputs[i]), outputs[i]) << i;
+
+  // A single input, and none at all.
+  inputs.resize(1);
+  crypto::SHA256HashStrings(inputs, &outputs);
+  ASSERT_EQ(1u, outputs.size());
+  EXPECT_EQ(crypto::SHA256HashString(inputs[0]), outputs[0]);
+  inputs.clear();
+  crypto::SHA256HashStrings(inputs, &outputs);
+  EXPECT_TRUE(outputs.empty());
+}
+
+TEST(Sha256Test, HashFile) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+
+  // Larger than the reader's buffers put together, and not a whole number of
+  // chunks.
+  std::string contents(1000001, 'a');
+  for (size_t i = 0; i < contents.size(); i += 4099)
+    contents[i] = static_cast<char>(i);
+  base::FilePath path = temp_dir.path().AppendASCII("file");
+  ASSERT_EQ(static_cast<int>(contents.size()),
+            file_util::WriteFile(path, contents.data(), contents.size()));
+
+  uint8 output[crypto::kSHA256Length];
+  EXPECT_TRUE(crypto::SHA256HashFile(path, output, sizeof(output)));
+  EXPECT_EQ(crypto::SHA256HashString(contents),
+            std::string(reinterpret_cast<char*>(output), sizeof(output)));
+
+  base::FilePath empty_path = temp_dir.path().AppendASCII("empty");
+  ASSERT_EQ(0, file_util::WriteFile(empty_path, "", 0));
+  EXPECT_TRUE(crypto::SHA256HashFile(empty_path, output, sizeof(output)));
+  EXPECT_EQ(crypto::SHA256HashString(""),
+            std::string(reinterpret_cast<char*>(output), sizeof(output)));
+
+  EXPECT_FALSE(crypto::SHA256HashFile(temp_dir.path().AppendASCII("missing"),
+                                      output, sizeof(output)));
+}
@@ -8,6 +8,7 @@
 
 #include "base/bind.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/message_loop/message_loop.h"
 #include "base/stl_util.h"
 #include "base/test/test_timeouts.h"
@@ -169,6 +170,21 @@ class EndToEndAsyncTest : public testing::Test {
         base::Bind(&EndToEndAsyncTest::OnError, base::Unretained(this)));
   }
 
+  // Calls the methods asynchronously, in one batch. OnResponse() will be
+  // called once each response is received without error, otherwise OnError()
+  // will be called.
+  void CallMethodBatch(const std::vector<MethodCall*>& method_calls,
+                       int timeout_ms) {
+    std::vector<ObjectProxy::BatchedMethodCall> calls;
+    for (size_t i = 0; i < method_calls.size(); ++i) {
+      calls.push_back(ObjectProxy::BatchedMethodCall(
+          method_calls[i],
+          base::Bind(&EndToEndAsyncTest::OnResponse, base::Unretained(this)),
+          base::Bind(&EndToEndAsyncTest::OnError, base::Unretained(this))));
+    }
+    object_proxy_->CallMethodBatch(calls, timeout_ms);
+  }
+
   // Wait for the give number of responses.
   void WaitForResponses(size_t num_responses) {
     while (response_strings_.size() < num_responses) {
@@ -328,6 +344,53 @@ TEST_F(EndToEndAsyncTest, EchoThreeTimes) {
   EXPECT_EQ("foo", response_strings_[2]);
 }
 
+// Call Echo method three times in one batch.
+TEST_F(EndToEndAsyncTest, EchoBatch) {
+  const char* kMessages[] = { "foo", "bar", "baz" };
+
+  ScopedVector<MethodCall> method_calls;
+  for (size_t i = 0; i < arraysize(kMessages); ++i) {
+    // Create the method call.
+    MethodCall* method_call =
+        new MethodCall("org.chromium.TestInterface", "Echo");
+    method_calls.push_back(method_call);
+    MessageWriter writer(method_call);
+    writer.AppendString(kMessages[i]);
+  }
+
+  // Call the methods.
+  const int timeout_ms = ObjectProxy::TIMEOUT_USE_DEFAULT;
+  CallMethodBatch(method_calls.get(), timeout_ms);
+
+  // Check the responses.
+  WaitForResponses(3);
+  // Sort as the order of the returned messages is not deterministic.
+  std::sort(response_strings_.begin(), response_strings_.end());
+  EXPECT_EQ("bar", response_strings_[0]);
+  EXPECT_EQ("baz", response_strings_[1]);
+  EXPECT_EQ("foo", response_strings_[2]);
+  EXPECT_TRUE(error_names_.empty());
+}
+
+// Call Echo and a nonexistent method in one batch.
+TEST_F(EndToEndAsyncTest, BatchWithError) {
+  MethodCall echo_call("org.chromium.TestInterface", "Echo");
+  MessageWriter writer(&echo_call);
+  writer.AppendString("foo");
+  MethodCall nonexistent_call("org.chromium.TestInterface", "Nonexistent");
+
+  std::vector<MethodCall*> method_calls;
+  method_calls.push_back(&echo_call);
+  method_calls.push_back(&nonexistent_call);
+  const int timeout_ms = ObjectProxy::TIMEOUT_USE_DEFAULT;
+  CallMethodBatch(method_calls, timeout_ms);
+
+  WaitForResponses(1);
+  WaitForErrors(1);
+  EXPECT_EQ("foo", response_strings_[0]);
+  ASSERT_EQ(DBUS_ERROR_UNKNOWN_METHOD, error_names_[0]);
+}
+
 TEST_F(EndToEndAsyncTest, Echo_HugePayload) {
   const std::string kHugePayload(kHugePayloadSize, 'o');
 
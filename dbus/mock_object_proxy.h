@@ -6,6 +6,7 @@
 #define DBUS_MOCK_OBJECT_PROXY_H_
 
 #include <string>
+#include <vector>
 
 #include "dbus/message.h"
 #include "dbus/object_path.h"
@@ -39,6 +40,9 @@ class MockObjectProxy : public ObjectProxy {
                                                  int timeout_ms,
                                                  ResponseCallback callback,
                                                  ErrorCallback error_callback));
+  MOCK_METHOD2(CallMethodBatch,
+               void(const std::vector<BatchedMethodCall>& calls,
+                    int timeout_ms));
   MOCK_METHOD4(ConnectToSignal,
                void(const std::string& interface_name,
                     const std::string& signal_name,
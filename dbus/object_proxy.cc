@@ -165,6 +165,63 @@ void ObjectProxy::CallMethodWithErrorCallback(MethodCall* method_call,
   bus_->PostTaskToDBusThread(FROM_HERE, task);
 }
 
+void ObjectProxy::CallMethodBatch(const std::vector<BatchedMethodCall>& calls,
+                                  int timeout_ms) {
+  bus_->AssertOnOriginThread();
+
+  const base::TimeTicks start_time = base::TimeTicks::Now();
+
+  std::vector<PendingMethodCall> pending_calls;
+  pending_calls.reserve(calls.size());
+  for (size_t i = 0; i < calls.size(); ++i) {
+    MethodCall* method_call = calls[i].method_call;
+    ErrorCallback error_callback = calls[i].error_callback;
+    if (error_callback.is_null()) {
+      error_callback = base::Bind(&ObjectProxy::OnCallMethodError,
+                                  this,
+                                  method_call->GetInterface(),
+                                  method_call->GetMember(),
+                                  calls[i].callback);
+    }
+
+    if (!method_call->SetDestination(service_name_) ||
+        !method_call->SetPath(object_path_)) {
+      // In case of a failure, run the error callback with NULL.
+      DBusMessage* response_message = NULL;
+      bus_->PostTaskToOriginThread(
+          FROM_HERE,
+          base::Bind(&ObjectProxy::RunResponseCallback,
+                     this,
+                     calls[i].callback,
+                     error_callback,
+                     start_time,
+                     response_message));
+      continue;
+    }
+
+    // Unref'ed once the message is sent, in SendAsyncMethodCall(), or in
+    // StartAsyncMethodCalls() if it can't be.
+    DBusMessage* request_message = method_call->raw_message();
+    dbus_message_ref(request_message);
+    pending_calls.push_back(
+        PendingMethodCall(request_message, calls[i].callback, error_callback));
+    statistics::AddSentMethodCall(service_name_,
+                                  method_call->GetInterface(),
+                                  method_call->GetMember());
+  }
+
+  if (pending_calls.empty())
+    return;
+
+  // Send all of the calls from one task in the D-Bus thread.
+  bus_->PostTaskToDBusThread(FROM_HERE,
+                             base::Bind(&ObjectProxy::StartAsyncMethodCalls,
+                                        this,
+                                        timeout_ms,
+                                        pending_calls,
+                                        start_time));
+}
+
 void ObjectProxy::ConnectToSignal(const std::string& interface_name,
                                   const std::string& signal_name,
                                   SignalCallback signal_callback,
@@ -220,6 +277,29 @@ ObjectProxy::OnPendingCallIsCompleteData::OnPendingCallIsCompleteData(
 ObjectProxy::OnPendingCallIsCompleteData::~OnPendingCallIsCompleteData() {
 }
 
+ObjectProxy::BatchedMethodCall::BatchedMethodCall(MethodCall* method_call,
+                                                  ResponseCallback callback,
+                                                  ErrorCallback error_callback)
+    : method_call(method_call),
+      callback(callback),
+      error_callback(error_callback) {
+}
+
+ObjectProxy::BatchedMethodCall::~BatchedMethodCall() {
+}
+
+ObjectProxy::PendingMethodCall::PendingMethodCall(
+    DBusMessage* in_request_message,
+    ResponseCallback in_response_callback,
+    ErrorCallback in_error_callback)
+    : request_message(in_request_message),
+      response_callback(in_response_callback),
+      error_callback(in_error_callback) {
+}
+
+ObjectProxy::PendingMethodCall::~PendingMethodCall() {
+}
+
 void ObjectProxy::StartAsyncMethodCall(int timeout_ms,
                                        DBusMessage* request_message,
                                        ResponseCallback response_callback,
@@ -242,6 +322,47 @@ void ObjectProxy::StartAsyncMethodCall(int timeout_ms,
     return;
   }
 
+  SendAsyncMethodCall(timeout_ms, request_message, response_callback,
+                      error_callback, start_time);
+}
+
+void ObjectProxy::StartAsyncMethodCalls(
+    int timeout_ms,
+    const std::vector<PendingMethodCall>& calls,
+    base::TimeTicks start_time) {
+  bus_->AssertOnDBusThread();
+
+  if (!bus_->Connect() || !bus_->SetUpAsyncOperations()) {
+    // In case of a failure, run the error callbacks with NULL.
+    DBusMessage* response_message = NULL;
+    for (size_t i = 0; i < calls.size(); ++i) {
+      bus_->PostTaskToOriginThread(
+          FROM_HERE,
+          base::Bind(&ObjectProxy::RunResponseCallback,
+                     this,
+                     calls[i].response_callback,
+                     calls[i].error_callback,
+                     start_time,
+                     response_message));
+      dbus_message_unref(calls[i].request_message);
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < calls.size(); ++i) {
+    SendAsyncMethodCall(timeout_ms, calls[i].request_message,
+                        calls[i].response_callback, calls[i].error_callback,
+                        start_time);
+  }
+}
+
+void ObjectProxy::SendAsyncMethodCall(int timeout_ms,
+                                      DBusMessage* request_message,
+                                      ResponseCallback response_callback,
+                                      ErrorCallback error_callback,
+                                      base::TimeTicks start_time) {
+  bus_->AssertOnDBusThread();
+
   DBusPendingCall* pending_call = NULL;
 
   bus_->SendWithReply(request_message, &pending_call, timeout_ms);
@@ -125,6 +125,32 @@ class CHROME_DBUS_EXPORT ObjectProxy
                                            ResponseCallback callback,
                                            ErrorCallback error_callback);
 
+  // A method call made by CallMethodBatch(), along with the callbacks for
+  // its response. If |error_callback| is null, errors are logged and
+  // |callback| is run with NULL, as with CallMethod().
+  struct CHROME_DBUS_EXPORT BatchedMethodCall {
+    BatchedMethodCall(MethodCall* method_call,
+                      ResponseCallback callback,
+                      ErrorCallback error_callback);
+    ~BatchedMethodCall();
+
+    MethodCall* method_call;
+    ResponseCallback callback;
+    ErrorCallback error_callback;
+  };
+
+  // Requests to call several methods of the remote object at once.
+  //
+  // This is like calling CallMethodWithErrorCallback() for each of |calls|,
+  // but all of the method calls are sent by a single task on the D-Bus
+  // thread, one after another and without waiting for any of the responses,
+  // so their round trips overlap. The callbacks of each method call are run
+  // in the origin thread as its response arrives, which may be in any order.
+  //
+  // Must be called in the origin thread.
+  virtual void CallMethodBatch(const std::vector<BatchedMethodCall>& calls,
+                               int timeout_ms);
+
   // Requests to connect to the signal from the remote object, replacing
   // any previous |signal_callback| connected to that signal.
   //
@@ -179,6 +205,19 @@ class CHROME_DBUS_EXPORT ObjectProxy
     base::TimeTicks start_time;
   };
 
+  // A method call of a batch, passed from CallMethodBatch() to
+  // StartAsyncMethodCalls().
+  struct PendingMethodCall {
+    PendingMethodCall(DBusMessage* in_request_message,
+                      ResponseCallback in_response_callback,
+                      ErrorCallback in_error_callback);
+    ~PendingMethodCall();
+
+    DBusMessage* request_message;
+    ResponseCallback response_callback;
+    ErrorCallback error_callback;
+  };
+
   // Starts the async method call. This is a helper function to implement
   // CallMethod().
   void StartAsyncMethodCall(int timeout_ms,
@@ -187,6 +226,21 @@ class CHROME_DBUS_EXPORT ObjectProxy
                             ErrorCallback error_callback,
                             base::TimeTicks start_time);
 
+  // Starts the async method calls of a batch. This is a helper function to
+  // implement CallMethodBatch().
+  void StartAsyncMethodCalls(int timeout_ms,
+                             const std::vector<PendingMethodCall>& calls,
+                             base::TimeTicks start_time);
+
+  // Sends |request_message| once the bus is connected and set up for async
+  // operations, and unrefs it. Helper function for StartAsyncMethodCall()
+  // and StartAsyncMethodCalls().
+  void SendAsyncMethodCall(int timeout_ms,
+                           DBusMessage* request_message,
+                           ResponseCallback response_callback,
+                           ErrorCallback error_callback,
+                           base::TimeTicks start_time);
+
   // Called when the pending call is complete.
   void OnPendingCallIsComplete(DBusPendingCall* pending_call,
                                ResponseCallback response_callback,
@@ -7,6 +7,7 @@
 #include "base/basictypes.h"
 #include "base/bind.h"
 #include "base/logging.h"
+#include "base/memory/scoped_vector.h"
 
 #include "dbus/message.h"
 #include "dbus/object_path.h"
@@ -29,6 +30,16 @@ void PropertyBase::Init(PropertySet* property_set, const std::string& name) {
 // PropertySet implementation.
 //
 
+PropertySet::GetBatchState::GetBatchState(size_t in_remaining,
+                                          GetCallback in_callback)
+    : remaining(in_remaining),
+      success(true),
+      callback(in_callback) {
+}
+
+PropertySet::GetBatchState::~GetBatchState() {
+}
+
 PropertySet::PropertySet(
     ObjectProxy* object_proxy,
     const std::string& interface,
@@ -36,6 +47,7 @@ PropertySet::PropertySet(
     : object_proxy_(object_proxy),
       interface_(interface),
       property_changed_callback_(property_changed_callback),
+      get_all_pending_(false),
       weak_ptr_factory_(this) {}
 
 PropertySet::~PropertySet() {
@@ -122,18 +134,73 @@ void PropertySet::OnGet(PropertyBase* property, GetCallback callback,
     callback.Run(response);
 }
 
+void PropertySet::GetBatch(const std::vector<PropertyBase*>& properties,
+                           GetCallback callback) {
+  if (properties.empty()) {
+    if (!callback.is_null())
+      callback.Run(true);
+    return;
+  }
+
+  // The method calls need to live until CallMethodBatch() returns.
+  ScopedVector<MethodCall> method_calls;
+  std::vector<ObjectProxy::BatchedMethodCall> calls;
+  scoped_refptr<GetBatchState> state(
+      new GetBatchState(properties.size(), callback));
+  for (size_t i = 0; i < properties.size(); ++i) {
+    MethodCall* method_call =
+        new MethodCall(kPropertiesInterface, kPropertiesGet);
+    method_calls.push_back(method_call);
+    MessageWriter writer(method_call);
+    writer.AppendString(interface());
+    writer.AppendString(properties[i]->name());
+
+    calls.push_back(ObjectProxy::BatchedMethodCall(
+        method_call,
+        base::Bind(&PropertySet::OnGetBatchResponse,
+                   GetWeakPtr(),
+                   properties[i],
+                   state),
+        ObjectProxy::ErrorCallback()));
+  }
+
+  DCHECK(object_proxy_);
+  object_proxy_->CallMethodBatch(calls, ObjectProxy::TIMEOUT_USE_DEFAULT);
+}
+
+void PropertySet::OnGetBatchResponse(PropertyBase* property,
+                                     scoped_refptr<GetBatchState> state,
+                                     Response* response) {
+  OnGet(property, GetCallback(), response);
+  if (!response)
+    state->success = false;
+
+  DCHECK_GT(state->remaining, 0U);
+  if (--state->remaining == 0 && !state->callback.is_null())
+    state->callback.Run(state->success);
+}
+
 void PropertySet::GetAll() {
+  if (get_all_pending_)
+    return;
+
   MethodCall method_call(kPropertiesInterface, kPropertiesGetAll);
   MessageWriter writer(&method_call);
   writer.AppendString(interface());
 
   DCHECK(object_proxy_);
+  get_all_pending_ = true;
   object_proxy_->CallMethod(&method_call,
                             ObjectProxy::TIMEOUT_USE_DEFAULT,
-                            base::Bind(&PropertySet::OnGetAll,
+                            base::Bind(&PropertySet::OnGetAllResponse,
                                        weak_ptr_factory_.GetWeakPtr()));
 }
 
+void PropertySet::OnGetAllResponse(Response* response) {
+  get_all_pending_ = false;
+  OnGetAll(response);
+}
+
 void PropertySet::OnGetAll(Response* response) {
   if (!response) {
     LOG(WARNING) << "GetAll request failed.";
@@ -7,10 +7,12 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/bind.h"
 #include "base/callback.h"
+#include "base/memory/ref_counted.h"
 #include "dbus/dbus_export.h"
 #include "dbus/message.h"
 #include "dbus/object_proxy.h"
@@ -248,10 +250,21 @@ class CHROME_DBUS_EXPORT PropertySet {
   virtual void OnGet(PropertyBase* property, GetCallback callback,
                      Response* response);
 
+  // Requests updated values from the remote object for each of |properties|.
+  // The method calls for all of them are sent together with
+  // ObjectProxy::CallMethodBatch(), so this incurs a single round-trip
+  // rather than one per property. |callback| is called once all of the
+  // values have been received, with |success| true only if each of them
+  // could be retrieved.
+  void GetBatch(const std::vector<PropertyBase*>& properties,
+                GetCallback callback);
+
   // Queries the remote object for values of all properties and updates
-  // initial values. Sub-classes may override to use a different D-Bus
-  // method, or if the remote object does not support retrieving all
-  // properties, either ignore or obtain each property value individually.
+  // initial values. A call made while an earlier one is still waiting for its
+  // reply does nothing, as that reply will update every property anyway.
+  // Sub-classes may override to use a different D-Bus method, or if the
+  // remote object does not support retrieving all properties, either ignore
+  // or obtain each property value individually.
   virtual void GetAll();
   virtual void OnGetAll(Response* response);
 
@@ -300,6 +313,28 @@ class CHROME_DBUS_EXPORT PropertySet {
   }
 
  private:
+  // The progress of a GetBatch() call.
+  struct GetBatchState : public base::RefCounted<GetBatchState> {
+    GetBatchState(size_t in_remaining, GetCallback in_callback);
+
+    size_t remaining;
+    bool success;
+    GetCallback callback;
+
+   private:
+    friend class base::RefCounted<GetBatchState>;
+    ~GetBatchState();
+  };
+
+  // Called with the reply to the GetAll method call made by GetAll().
+  void OnGetAllResponse(Response* response);
+
+  // Called with the reply to the Get method call for |property| made by
+  // GetBatch().
+  void OnGetBatchResponse(PropertyBase* property,
+                          scoped_refptr<GetBatchState> state,
+                          Response* response);
+
   // Pointer to object proxy for making method calls, no ownership is taken
   // so this must outlive this class.
   ObjectProxy* object_proxy_;
@@ -319,6 +354,9 @@ class CHROME_DBUS_EXPORT PropertySet {
   typedef std::map<const std::string, PropertyBase*> PropertiesMap;
   PropertiesMap properties_map_;
 
+  // True while the reply to a GetAll method call is awaited.
+  bool get_all_pending_;
+
   // Weak pointer factory as D-Bus callbacks may last longer than these
   // objects.
   base::WeakPtrFactory<PropertySet> weak_ptr_factory_;
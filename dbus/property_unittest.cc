@@ -232,6 +232,41 @@ TEST_F(PropertyTest, Get) {
   EXPECT_EQ(20, properties_->version.value());
 }
 
+TEST_F(PropertyTest, GetBatch) {
+  WaitForGetAll();
+
+  // Ask for the Name and Version properties together.
+  std::vector<PropertyBase*> properties;
+  properties.push_back(&properties_->name);
+  properties.push_back(&properties_->version);
+  properties_->GetBatch(properties,
+                        base::Bind(&PropertyTest::PropertyCallback,
+                                   base::Unretained(this),
+                                   "GetBatch"));
+  WaitForCallback("GetBatch");
+
+  // Both properties are updated before the callback.
+  EXPECT_EQ(2U, updated_properties_.size());
+  EXPECT_EQ("TestService", properties_->name.value());
+  EXPECT_EQ(20, properties_->version.value());
+}
+
+TEST_F(PropertyTest, GetAllWhilePending) {
+  // The GetAll() call made in SetUp() hasn't been answered yet, so this one
+  // should not make another method call.
+  properties_->GetAll();
+  WaitForGetAll();
+
+  // The reply to any second GetAll call would arrive before this one.
+  properties_->name.Get(base::Bind(&PropertyTest::PropertyCallback,
+                                   base::Unretained(this),
+                                   "Name"));
+  WaitForCallback("Name");
+  WaitForUpdates(1);
+
+  EXPECT_TRUE(updated_properties_.empty());
+}
+
 TEST_F(PropertyTest, Set) {
   WaitForGetAll();
 
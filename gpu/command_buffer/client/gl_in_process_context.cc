@@ -226,6 +226,7 @@ bool GLInProcessContextImpl::Initialize(
   base::Closure wrapped_callback =
       base::Bind(&GLInProcessContextImpl::OnContextLost, AsWeakPtr());
   command_buffer_.reset(new InProcessCommandBuffer());
+  command_buffer_->set_trusted_client(attribs.trusted_client);
 
   scoped_ptr<base::AutoLock> scoped_shared_context_lock;
   scoped_refptr<gles2::ShareGroup> share_group;
@@ -371,7 +372,8 @@ GLInProcessContextAttribs::GLInProcessContextAttribs()
       depth_size(-1),
       stencil_size(-1),
       samples(-1),
-      sample_buffers(-1) {}
+      sample_buffers(-1),
+      trusted_client(false) {}
 
 // static
 GLInProcessContext* GLInProcessContext::CreateContext(
@@ -36,6 +36,8 @@ struct GLES2_IMPL_EXPORT GLInProcessContextAttribs {
   int32 stencil_size;
   int32 samples;
   int32 sample_buffers;
+  // Whether only the embedder itself uses the context.
+  bool trusted_client;
 };
 
 class GLES2_IMPL_EXPORT GLInProcessContext {
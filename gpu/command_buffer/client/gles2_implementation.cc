@@ -103,6 +103,7 @@ GLES2Implementation::GLES2Implementation(
       bound_read_framebuffer_(0),
       bound_renderbuffer_(0),
       current_program_(0),
+      redundant_commands_skipped_(0),
       bound_array_buffer_id_(0),
       bound_pixel_pack_transfer_buffer_id_(0),
       bound_pixel_unpack_transfer_buffer_id_(0),
@@ -554,6 +555,8 @@ void GLES2Implementation::Disable(GLenum cap) {
   bool changed = false;
   if (!state_.SetCapabilityState(cap, false, &changed) || changed) {
     helper_->Disable(cap);
+  } else {
+    ++redundant_commands_skipped_;
   }
   CheckGLError();
 }
@@ -565,6 +568,8 @@ void GLES2Implementation::Enable(GLenum cap) {
   bool changed = false;
   if (!state_.SetCapabilityState(cap, true, &changed) || changed) {
     helper_->Enable(cap);
+  } else {
+    ++redundant_commands_skipped_;
   }
   CheckGLError();
 }
@@ -845,6 +850,8 @@ void GLES2Implementation::SwapBuffers() {
   // All it means is that we could be slightly looser on the kMaxSwapBuffers
   // semantics if the client doesn't use the callback mechanism, and by chance
   // the scheduler yields between the InsertToken and the SwapBuffers.
+  TRACE_COUNTER_ID1("gpu", "GLES2::RedundantCommandsSkipped", this,
+                    redundant_commands_skipped_);
   swap_buffers_tokens_.push(helper_->InsertToken());
   helper_->SwapBuffers();
   helper_->CommandBufferHelper::Flush();
@@ -998,6 +1005,7 @@ bool GLES2Implementation::DeleteProgramHelper(GLuint program) {
   }
   if (program == current_program_) {
     current_program_ = 0;
+    current_program_uniforms_.clear();
   }
   return true;
 }
@@ -1092,7 +1100,10 @@ void GLES2Implementation::UseProgram(GLuint program) {
   if (current_program_ != program) {
     current_program_ = program;
     helper_->UseProgram(program);
+  } else {
+    ++redundant_commands_skipped_;
   }
+  current_program_uniforms_.clear();
   CheckGLError();
 }
 
@@ -1113,6 +1124,9 @@ void GLES2Implementation::LinkProgram(GLuint program) {
   GPU_CLIENT_LOG("[" << GetLogPrefix() << "] glLinkProgram(" << program << ")");
   helper_->LinkProgram(program);
   share_group_->program_info_manager()->CreateInfo(program);
+  // Linking resets the uniforms.
+  if (program == current_program_)
+    current_program_uniforms_.clear();
   CheckGLError();
 }
 
@@ -2308,6 +2322,10 @@ void GLES2Implementation::ActiveTexture(GLenum texture) {
     return;
   }
 
+  if (active_texture_unit_ == texture_index) {
+    ++redundant_commands_skipped_;
+    return;
+  }
   active_texture_unit_ = texture_index;
   helper_->ActiveTexture(texture);
   CheckGLError();
@@ -2354,10 +2372,14 @@ bool GLES2Implementation::BindBufferHelper(
       if (bound_array_buffer_id_ != buffer) {
         bound_array_buffer_id_ = buffer;
         changed = true;
+      } else {
+        ++redundant_commands_skipped_;
       }
       break;
     case GL_ELEMENT_ARRAY_BUFFER:
       changed = vertex_array_object_manager_->BindElementArray(buffer);
+      if (!changed)
+        ++redundant_commands_skipped_;
       break;
     case GL_PIXEL_PACK_TRANSFER_BUFFER_CHROMIUM:
       bound_pixel_pack_transfer_buffer_id_ = buffer;
@@ -2412,6 +2434,8 @@ bool GLES2Implementation::BindFramebufferHelper(
       SetGLErrorInvalidEnum("glBindFramebuffer", target, "target");
       return false;
   }
+  if (!changed)
+    ++redundant_commands_skipped_;
   GetIdHandler(id_namespaces::kFramebuffers)->MarkAsUsedForBind(framebuffer);
   return changed;
 }
@@ -2431,6 +2455,8 @@ bool GLES2Implementation::BindRenderbufferHelper(
       changed = true;
       break;
   }
+  if (!changed)
+    ++redundant_commands_skipped_;
   // TODO(gman): There's a bug here. If the target is invalid the ID will not be
   // used even though it's marked it as used here.
   GetIdHandler(id_namespaces::kRenderbuffers)->MarkAsUsedForBind(renderbuffer);
@@ -2439,9 +2465,7 @@ bool GLES2Implementation::BindRenderbufferHelper(
 
 bool GLES2Implementation::BindTextureHelper(GLenum target, GLuint texture) {
   // TODO(gman): See note #1 above.
-  // TODO(gman): Change this to false once we figure out why it's failing
-  //     on daisy.
-  bool changed = true;
+  bool changed = false;
   TextureUnit& unit = texture_units_[active_texture_unit_];
   switch (target) {
     case GL_TEXTURE_2D:
@@ -2460,6 +2484,8 @@ bool GLES2Implementation::BindTextureHelper(GLenum target, GLuint texture) {
       changed = true;
       break;
   }
+  if (!changed)
+    ++redundant_commands_skipped_;
   // TODO(gman): There's a bug here. If the target is invalid the ID will not be
   // used. even though it's marked it as used here.
   GetIdHandler(id_namespaces::kTextures)->MarkAsUsedForBind(texture);
@@ -2481,6 +2507,27 @@ bool GLES2Implementation::BindVertexArrayHelper(GLuint array) {
   return changed;
 }
 
+bool GLES2Implementation::UniformNeedsUpdate(const char* function,
+                                             GLint location,
+                                             GLsizei count,
+                                             const void* values,
+                                             size_t size) {
+  if (count != 1 || !current_program_) {
+    current_program_uniforms_.clear();
+    return true;
+  }
+  std::string value(function);
+  value.push_back('\0');
+  value.append(static_cast<const char*>(values), size);
+  std::string& last_value = current_program_uniforms_[location];
+  if (last_value == value) {
+    ++redundant_commands_skipped_;
+    return false;
+  }
+  last_value.swap(value);
+  return true;
+}
+
 bool GLES2Implementation::IsBufferReservedId(GLuint id) {
   return vertex_array_object_manager_->IsReservedId(id);
 }
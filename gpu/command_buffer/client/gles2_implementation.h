@@ -228,6 +228,12 @@ class GLES2_IMPL_EXPORT GLES2Implementation : public GLES2Interface {
     return share_group_.get();
   }
 
+  // The number of state commands that weren't sent because they wouldn't
+  // have changed anything.
+  uint32 redundant_commands_skipped() const {
+    return redundant_commands_skipped_;
+  }
+
  private:
   friend class GLES2ImplementationTest;
   friend class VertexArrayObjectManager;
@@ -462,6 +468,16 @@ class GLES2_IMPL_EXPORT GLES2Implementation : public GLES2Interface {
   bool BindTextureHelper(GLenum target, GLuint texture);
   bool BindVertexArrayHelper(GLuint array);
 
+  // Returns true unless the uniform at |location| of the current program
+  // was last set to the |size| bytes at |values| by |function|, in which
+  // case the command doesn't need to be sent. Only single elements are
+  // remembered, since a |count| of elements can overlap other locations.
+  bool UniformNeedsUpdate(const char* function,
+                          GLint location,
+                          GLsizei count,
+                          const void* values,
+                          size_t size);
+
   void GenBuffersHelper(GLsizei n, const GLuint* buffers);
   void GenFramebuffersHelper(GLsizei n, const GLuint* framebuffers);
   void GenRenderbuffersHelper(GLsizei n, const GLuint* renderbuffers);
@@ -616,6 +632,15 @@ class GLES2_IMPL_EXPORT GLES2Implementation : public GLES2Interface {
   // The program in use by glUseProgram
   GLuint current_program_;
 
+  // The values the uniforms of the current program were last set to, by
+  // location, each prefixed with the name of the function that set it.
+  // Cleared on glUseProgram, since other contexts sharing the program may
+  // have changed its uniforms by then.
+  typedef std::map<GLint, std::string> UniformValueMap;
+  UniformValueMap current_program_uniforms_;
+
+  uint32 redundant_commands_skipped_;
+
   // The currently bound array buffer.
   GLuint bound_array_buffer_id_;
 
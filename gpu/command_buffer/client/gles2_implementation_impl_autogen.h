@@ -1081,7 +1081,11 @@ void GLES2Implementation::TexParameteriv(
 void GLES2Implementation::Uniform1f(GLint location, GLfloat x) {
   GPU_CLIENT_SINGLE_THREAD_CHECK();
   GPU_CLIENT_LOG("[" << GetLogPrefix() << "] glUniform1f(" << location << ", " << x << ")");  // NOLINT
-  helper_->Uniform1f(location, x);
+  GLfloat values[] = { x };
+  if (UniformNeedsUpdate(
+      "glUniform1f", location, 1, values, sizeof(values))) {
+    helper_->Uniform1f(location, x);
+  }
   CheckGLError();
 }
 
@@ -1098,14 +1102,22 @@ void GLES2Implementation::Uniform1fv(
     SetGLError(GL_INVALID_VALUE, "glUniform1fv", "count < 0");
     return;
   }
-  helper_->Uniform1fvImmediate(location, count, v);
+  if (UniformNeedsUpdate(
+      "glUniform1fv", location, count, v,
+      count * 1 * sizeof(GLfloat))) {
+    helper_->Uniform1fvImmediate(location, count, v);
+  }
   CheckGLError();
 }
 
 void GLES2Implementation::Uniform1i(GLint location, GLint x) {
   GPU_CLIENT_SINGLE_THREAD_CHECK();
   GPU_CLIENT_LOG("[" << GetLogPrefix() << "] glUniform1i(" << location << ", " << x << ")");  // NOLINT
-  helper_->Uniform1i(location, x);
+  GLint values[] = { x };
+  if (UniformNeedsUpdate(
+      "glUniform1i", location, 1, values, sizeof(values))) {
+    helper_->Uniform1i(location, x);
+  }
   CheckGLError();
 }
 
@@ -1122,14 +1134,22 @@ void GLES2Implementation::Uniform1iv(
     SetGLError(GL_INVALID_VALUE, "glUniform1iv", "count < 0");
     return;
   }
-  helper_->Uniform1ivImmediate(location, count, v);
+  if (UniformNeedsUpdate(
+      "glUniform1iv", location, count, v,
+      count * 1 * sizeof(GLint))) {
+    helper_->Uniform1ivImmediate(location, count, v);
+  }
   CheckGLError();
 }
 
 void GLES2Implementation::Uniform2f(GLint location, GLfloat x, GLfloat y) {
   GPU_CLIENT_SINGLE_THREAD_CHECK();
   GPU_CLIENT_LOG("[" << GetLogPrefix() << "] glUniform2f(" << location << ", " << x << ", " << y << ")");  // NOLINT
-  helper_->Uniform2f(location, x, y);
+  GLfloat values[] = { x, y };
+  if (UniformNeedsUpdate(
+      "glUniform2f", location, 1, values, sizeof(values))) {
+    helper_->Uniform2f(location, x, y);
+  }
   CheckGLError();
 }
 
@@ -1146,14 +1166,22 @@ void GLES2Implementation::Uniform2fv(
     SetGLError(GL_INVALID_VALUE, "glUniform2fv", "count < 0");
     return;
   }
-  helper_->Uniform2fvImmediate(location, count, v);
+  if (UniformNeedsUpdate(
+      "glUniform2fv", location, count, v,
+      count * 2 * sizeof(GLfloat))) {
+    helper_->Uniform2fvImmediate(location, count, v);
+  }
   CheckGLError();
 }
 
 void GLES2Implementation::Uniform2i(GLint location, GLint x, GLint y) {
   GPU_CLIENT_SINGLE_THREAD_CHECK();
   GPU_CLIENT_LOG("[" << GetLogPrefix() << "] glUniform2i(" << location << ", " << x << ", " << y << ")");  // NOLINT
-  helper_->Uniform2i(location, x, y);
+  GLint values[] = { x, y };
+  if (UniformNeedsUpdate(
+      "glUniform2i", location, 1, values, sizeof(values))) {
+    helper_->Uniform2i(location, x, y);
+  }
   CheckGLError();
 }
 
@@ -1170,7 +1198,11 @@ void GLES2Implementation::Uniform2iv(
     SetGLError(GL_INVALID_VALUE, "glUniform2iv", "count < 0");
     return;
   }
-  helper_->Uniform2ivImmediate(location, count, v);
+  if (UniformNeedsUpdate(
+      "glUniform2iv", location, count, v,
+      count * 2 * sizeof(GLint))) {
+    helper_->Uniform2ivImmediate(location, count, v);
+  }
   CheckGLError();
 }
 
@@ -1178,7 +1210,11 @@ void GLES2Implementation::Uniform3f(
     GLint location, GLfloat x, GLfloat y, GLfloat z) {
   GPU_CLIENT_SINGLE_THREAD_CHECK();
   GPU_CLIENT_LOG("[" << GetLogPrefix() << "] glUniform3f(" << location << ", " << x << ", " << y << ", " << z << ")");  // NOLINT
-  helper_->Uniform3f(location, x, y, z);
+  GLfloat values[] = { x, y, z };
+  if (UniformNeedsUpdate(
+      "glUniform3f", location, 1, values, sizeof(values))) {
+    helper_->Uniform3f(location, x, y, z);
+  }
   CheckGLError();
 }
 
@@ -1195,7 +1231,11 @@ void GLES2Implementation::Uniform3fv(
     SetGLError(GL_INVALID_VALUE, "glUniform3fv", "count < 0");
     return;
   }
-  helper_->Uniform3fvImmediate(location, count, v);
+  if (UniformNeedsUpdate(
+      "glUniform3fv", location, count, v,
+      count * 3 * sizeof(GLfloat))) {
+    helper_->Uniform3fvImmediate(location, count, v);
+  }
   CheckGLError();
 }
 
@@ -1203,7 +1243,11 @@ void GLES2Implementation::Uniform3i(
     GLint location, GLint x, GLint y, GLint z) {
   GPU_CLIENT_SINGLE_THREAD_CHECK();
   GPU_CLIENT_LOG("[" << GetLogPrefix() << "] glUniform3i(" << location << ", " << x << ", " << y << ", " << z << ")");  // NOLINT
-  helper_->Uniform3i(location, x, y, z);
+  GLint values[] = { x, y, z };
+  if (UniformNeedsUpdate(
+      "glUniform3i", location, 1, values, sizeof(values))) {
+    helper_->Uniform3i(location, x, y, z);
+  }
   CheckGLError();
 }
 
@@ -1220,7 +1264,11 @@ void GLES2Implementation::Uniform3iv(
     SetGLError(GL_INVALID_VALUE, "glUniform3iv", "count < 0");
     return;
   }
-  helper_->Uniform3ivImmediate(location, count, v);
+  if (UniformNeedsUpdate(
+      "glUniform3iv", location, count, v,
+      count * 3 * sizeof(GLint))) {
+    helper_->Uniform3ivImmediate(location, count, v);
+  }
   CheckGLError();
 }
 
@@ -1228,7 +1276,11 @@ void GLES2Implementation::Uniform4f(
     GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w) {
   GPU_CLIENT_SINGLE_THREAD_CHECK();
   GPU_CLIENT_LOG("[" << GetLogPrefix() << "] glUniform4f(" << location << ", " << x << ", " << y << ", " << z << ", " << w << ")");  // NOLINT
-  helper_->Uniform4f(location, x, y, z, w);
+  GLfloat values[] = { x, y, z, w };
+  if (UniformNeedsUpdate(
+      "glUniform4f", location, 1, values, sizeof(values))) {
+    helper_->Uniform4f(location, x, y, z, w);
+  }
   CheckGLError();
 }
 
@@ -1245,7 +1297,11 @@ void GLES2Implementation::Uniform4fv(
     SetGLError(GL_INVALID_VALUE, "glUniform4fv", "count < 0");
     return;
   }
-  helper_->Uniform4fvImmediate(location, count, v);
+  if (UniformNeedsUpdate(
+      "glUniform4fv", location, count, v,
+      count * 4 * sizeof(GLfloat))) {
+    helper_->Uniform4fvImmediate(location, count, v);
+  }
   CheckGLError();
 }
 
@@ -1253,7 +1309,11 @@ void GLES2Implementation::Uniform4i(
     GLint location, GLint x, GLint y, GLint z, GLint w) {
   GPU_CLIENT_SINGLE_THREAD_CHECK();
   GPU_CLIENT_LOG("[" << GetLogPrefix() << "] glUniform4i(" << location << ", " << x << ", " << y << ", " << z << ", " << w << ")");  // NOLINT
-  helper_->Uniform4i(location, x, y, z, w);
+  GLint values[] = { x, y, z, w };
+  if (UniformNeedsUpdate(
+      "glUniform4i", location, 1, values, sizeof(values))) {
+    helper_->Uniform4i(location, x, y, z, w);
+  }
   CheckGLError();
 }
 
@@ -1270,7 +1330,11 @@ void GLES2Implementation::Uniform4iv(
     SetGLError(GL_INVALID_VALUE, "glUniform4iv", "count < 0");
     return;
   }
-  helper_->Uniform4ivImmediate(location, count, v);
+  if (UniformNeedsUpdate(
+      "glUniform4iv", location, count, v,
+      count * 4 * sizeof(GLint))) {
+    helper_->Uniform4ivImmediate(location, count, v);
+  }
   CheckGLError();
 }
 
@@ -1287,7 +1351,11 @@ void GLES2Implementation::UniformMatrix2fv(
     SetGLError(GL_INVALID_VALUE, "glUniformMatrix2fv", "count < 0");
     return;
   }
-  helper_->UniformMatrix2fvImmediate(location, count, transpose, value);
+  if (transpose || UniformNeedsUpdate(
+      "glUniformMatrix2fv", location, count, value,
+      count * 4 * sizeof(GLfloat))) {
+    helper_->UniformMatrix2fvImmediate(location, count, transpose, value);
+  }
   CheckGLError();
 }
 
@@ -1304,7 +1372,11 @@ void GLES2Implementation::UniformMatrix3fv(
     SetGLError(GL_INVALID_VALUE, "glUniformMatrix3fv", "count < 0");
     return;
   }
-  helper_->UniformMatrix3fvImmediate(location, count, transpose, value);
+  if (transpose || UniformNeedsUpdate(
+      "glUniformMatrix3fv", location, count, value,
+      count * 9 * sizeof(GLfloat))) {
+    helper_->UniformMatrix3fvImmediate(location, count, transpose, value);
+  }
   CheckGLError();
 }
 
@@ -1321,7 +1393,11 @@ void GLES2Implementation::UniformMatrix4fv(
     SetGLError(GL_INVALID_VALUE, "glUniformMatrix4fv", "count < 0");
     return;
   }
-  helper_->UniformMatrix4fvImmediate(location, count, transpose, value);
+  if (transpose || UniformNeedsUpdate(
+      "glUniformMatrix4fv", location, count, value,
+      count * 16 * sizeof(GLfloat))) {
+    helper_->UniformMatrix4fvImmediate(location, count, transpose, value);
+  }
   CheckGLError();
 }
 
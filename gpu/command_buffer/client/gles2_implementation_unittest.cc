@@ -2869,6 +2869,69 @@ TEST_F(GLES2ImplementationTest, Enable) {
   EXPECT_TRUE(NoCommandsWritten());
 }
 
+TEST_F(GLES2ImplementationTest, BindTexture) {
+  struct Cmds {
+    cmds::BindTexture cmd;
+  };
+  Cmds expected;
+  expected.cmd.Init(GL_TEXTURE_2D, 2);
+
+  gl_->BindTexture(GL_TEXTURE_2D, 2);
+  EXPECT_EQ(0, memcmp(&expected, commands_, sizeof(expected)));
+  // Check it's cached and not called again.
+  ClearCommands();
+  gl_->BindTexture(GL_TEXTURE_2D, 2);
+  EXPECT_TRUE(NoCommandsWritten());
+  ClearCommands();
+  gl_->ActiveTexture(GL_TEXTURE0);
+  EXPECT_TRUE(NoCommandsWritten());
+  EXPECT_EQ(2u, gl_->redundant_commands_skipped());
+}
+
+TEST_F(GLES2ImplementationTest, UniformsAreCachedForCurrentProgram) {
+  struct Cmds {
+    cmds::UseProgram use_program;
+    cmds::Uniform4f uniform;
+  };
+  Cmds expected;
+  expected.use_program.Init(1);
+  expected.uniform.Init(1, 2, 3, 4, 5);
+
+  gl_->UseProgram(1);
+  gl_->Uniform4f(1, 2, 3, 4, 5);
+  EXPECT_EQ(0, memcmp(&expected, commands_, sizeof(expected)));
+  // Check it's cached and not called again.
+  ClearCommands();
+  gl_->Uniform4f(1, 2, 3, 4, 5);
+  EXPECT_TRUE(NoCommandsWritten());
+  EXPECT_EQ(1u, gl_->redundant_commands_skipped());
+
+  // Other values and other functions are still sent.
+  ClearCommands();
+  gl_->Uniform4f(1, 2, 3, 4, 6);
+  EXPECT_FALSE(NoCommandsWritten());
+  ClearCommands();
+  const GLint ints[] = { 2, 3, 4, 6 };
+  gl_->Uniform4iv(1, 1, ints);
+  EXPECT_FALSE(NoCommandsWritten());
+
+  // Arrays aren't cached, as they overlap other locations.
+  const GLfloat floats[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+  ClearCommands();
+  gl_->Uniform4fv(1, 2, floats);
+  EXPECT_FALSE(NoCommandsWritten());
+  ClearCommands();
+  gl_->Uniform4fv(1, 2, floats);
+  EXPECT_FALSE(NoCommandsWritten());
+
+  // Using the program again, even if that's redundant, forgets the values.
+  gl_->Uniform1i(2, 0);
+  gl_->UseProgram(1);
+  ClearCommands();
+  gl_->Uniform1i(2, 0);
+  EXPECT_FALSE(NoCommandsWritten());
+}
+
 
 #include "gpu/command_buffer/client/gles2_implementation_unittest_autogen.h"
 
@@ -5,6 +5,9 @@
 // A class to Manage a growing transfer buffer.
 
 #include "gpu/command_buffer/client/transfer_buffer.h"
+
+#include <algorithm>
+
 #include "gpu/command_buffer/client/cmd_buffer_helper.h"
 
 namespace gpu {
@@ -61,6 +64,7 @@ void TransferBuffer::Free() {
     ring_buffer_.reset();
     bytes_since_last_flush_ = 0;
   }
+  DestroyRetiredRingBuffers(true);
 }
 
 bool TransferBuffer::HaveBuffer() const {
@@ -73,7 +77,11 @@ RingBuffer::Offset TransferBuffer::GetOffset(void* pointer) const {
 
 void TransferBuffer::FreePendingToken(void* p, unsigned int token) {
   ring_buffer_->FreePendingToken(p, token);
-  if (bytes_since_last_flush_ >= size_to_flush_ && size_to_flush_ > 0) {
+  // Flush at least every half ring so the service reads one half while the
+  // other is being filled.
+  unsigned int flush_size = std::min(
+      size_to_flush_, ring_buffer_->GetLargestFreeOrPendingSize() / 2);
+  if (bytes_since_last_flush_ >= flush_size && size_to_flush_ > 0) {
     helper_->Flush();
     bytes_since_last_flush_ = 0;
   }
@@ -104,6 +112,33 @@ void TransferBuffer::AllocateRingBuffer(unsigned int size) {
   usable_ = false;
 }
 
+void TransferBuffer::RetireRingBuffer() {
+  RetiredRingBuffer retired;
+  retired.ring_buffer = make_linked_ptr(ring_buffer_.release());
+  retired.buffer_id = buffer_id_;
+  retired.token = helper_->InsertToken();
+  retired_ring_buffers_.push_back(retired);
+  buffer_id_ = -1;
+  buffer_.ptr = NULL;
+  buffer_.size = 0;
+  result_buffer_ = NULL;
+  result_shm_offset_ = 0;
+}
+
+void TransferBuffer::DestroyRetiredRingBuffers(bool wait) {
+  while (!retired_ring_buffers_.empty()) {
+    RetiredRingBuffer& retired = retired_ring_buffers_.front();
+    if (retired.token > helper_->last_token_read()) {
+      if (!wait)
+        return;
+      helper_->WaitForToken(retired.token);
+    }
+    retired.ring_buffer.reset();
+    helper_->command_buffer()->DestroyTransferBuffer(retired.buffer_id);
+    retired_ring_buffers_.pop_front();
+  }
+}
+
 // Returns the integer i such as 2^i <= n < 2^(i+1)
 static int Log2Floor(uint32 n) {
   if (n == 0)
@@ -144,17 +179,30 @@ void TransferBuffer::ReallocateRingBuffer(unsigned int size) {
   needed_buffer_size = std::min(needed_buffer_size, max_buffer_size_);
 
   if (usable_ && (!HaveBuffer() || needed_buffer_size > buffer_.size)) {
+    // Commands still to be processed may use the old buffer, so it is only
+    // destroyed once the service is done with it, instead of waiting here.
     if (HaveBuffer()) {
-      Free();
+      RetireRingBuffer();
     }
     AllocateRingBuffer(needed_buffer_size);
   }
 }
 
+void TransferBuffer::GrowRingBufferIfFull(unsigned int size) {
+  if (buffer_.size >= max_buffer_size_ ||
+      ring_buffer_->GetLargestFreeSizeNoWaiting() >= size) {
+    return;
+  }
+  unsigned int new_buffer_size = std::min(buffer_.size * 2, max_buffer_size_);
+  RetireRingBuffer();
+  AllocateRingBuffer(new_buffer_size);
+}
+
 void* TransferBuffer::AllocUpTo(
     unsigned int size, unsigned int* size_allocated) {
   GPU_DCHECK(size_allocated);
 
+  DestroyRetiredRingBuffers(false);
   ReallocateRingBuffer(size);
 
   if (!HaveBuffer()) {
@@ -162,12 +210,25 @@ void* TransferBuffer::AllocUpTo(
   }
 
   unsigned int max_size = ring_buffer_->GetLargestFreeOrPendingSize();
+  if (size > max_size) {
+    // Data that doesn't fit is streamed through the ring in chunks of half its
+    // size, so the service doesn't have to read all of it before the next
+    // chunk can be written.
+    max_size = (max_size / 2) & ~(alignment_ - 1);
+  }
   *size_allocated = std::min(max_size, size);
+
+  GrowRingBufferIfFull(*size_allocated);
+  if (!HaveBuffer()) {
+    return NULL;
+  }
+
   bytes_since_last_flush_ += *size_allocated;
   return ring_buffer_->Alloc(*size_allocated);
 }
 
 void* TransferBuffer::Alloc(unsigned int size) {
+  DestroyRetiredRingBuffers(false);
   ReallocateRingBuffer(size);
 
   if (!HaveBuffer()) {
@@ -179,6 +240,11 @@ void* TransferBuffer::Alloc(unsigned int size) {
     return NULL;
   }
 
+  GrowRingBufferIfFull(size);
+  if (!HaveBuffer()) {
+    return NULL;
+  }
+
   bytes_since_last_flush_ += size;
   return ring_buffer_->Alloc(size);
 }
@@ -5,6 +5,9 @@
 #ifndef GPU_COMMAND_BUFFER_CLIENT_TRANSFER_BUFFER_H_
 #define GPU_COMMAND_BUFFER_CLIENT_TRANSFER_BUFFER_H_
 
+#include <deque>
+
+#include "base/memory/linked_ptr.h"
 #include "base/memory/scoped_ptr.h"
 #include "gpu/command_buffer/client/ring_buffer.h"
 #include "gpu/command_buffer/common/buffer.h"
@@ -114,14 +117,37 @@ class GPU_EXPORT TransferBuffer : public TransferBufferInterface {
   unsigned int GetMaxAllocation() const;
 
  private:
+  // A ring buffer that was replaced by a larger one, and the token after the
+  // last command that may still read from it.
+  struct RetiredRingBuffer {
+    linked_ptr<AlignedRingBuffer> ring_buffer;
+    int32 buffer_id;
+    int32 token;
+  };
+
   // Tries to reallocate the ring buffer if it's not large enough for size.
   void ReallocateRingBuffer(unsigned int size);
 
+  // Doubles the ring buffer, up to the max size, if an allocation of size
+  // would have to wait for the service to free up space in it.
+  void GrowRingBufferIfFull(unsigned int size);
+
   void AllocateRingBuffer(unsigned int size);
 
+  // Replaces the current buffer by a retired one that is destroyed once the
+  // service is done with it.
+  void RetireRingBuffer();
+
+  // Destroys the retired buffers the service is done with. If wait is true,
+  // waits for the service to be done with all of them.
+  void DestroyRetiredRingBuffers(bool wait);
+
   CommandBufferHelper* helper_;
   scoped_ptr<AlignedRingBuffer> ring_buffer_;
 
+  // Oldest first.
+  std::deque<RetiredRingBuffer> retired_ring_buffers_;
+
   // size reserved for results
   unsigned int result_size_;
 
@@ -172,12 +172,13 @@ TEST_F(TransferBufferTest, TooLargeAllocation) {
   // Check that we can't allocate large than max size.
   void* ptr = transfer_buffer_->Alloc(kTransferBufferSize + 1);
   EXPECT_TRUE(ptr == NULL);
-  // Check we if we try to allocate larger than max we get max.
+  // Check we if we try to allocate larger than max we get half of max, so the
+  // data can be streamed.
   unsigned int size_allocated = 0;
   ptr = transfer_buffer_->AllocUpTo(
       kTransferBufferSize + 1, &size_allocated);
   ASSERT_TRUE(ptr != NULL);
-  EXPECT_EQ(kTransferBufferSize - kStartingOffset, size_allocated);
+  EXPECT_EQ((kTransferBufferSize - kStartingOffset) / 2, size_allocated);
   transfer_buffer_->FreePendingToken(ptr, 1);
 }
 
@@ -292,6 +293,7 @@ void TransferBufferExpandContractTest::TearDown() {
   EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
       .Times(1)
       .RetiresOnSaturation();
+  EXPECT_CALL(*command_buffer(), OnFlush()).Times(AtMost(1));
   transfer_buffer_.reset();
 }
 
@@ -312,9 +314,6 @@ TEST_F(TransferBufferExpandContractTest, Expand) {
       kStartTransferBufferSize - kStartingOffset,
       transfer_buffer_->GetCurrentMaxAllocationWithoutRealloc());
 
-  EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
-      .Times(1)
-      .RetiresOnSaturation();
   EXPECT_CALL(*command_buffer(),
               CreateTransferBuffer(kStartTransferBufferSize * 2, _))
       .WillOnce(Invoke(
@@ -331,6 +330,8 @@ TEST_F(TransferBufferExpandContractTest, Expand) {
   EXPECT_EQ(kSize1, transfer_buffer_->GetCurrentMaxAllocationWithoutRealloc());
   transfer_buffer_->FreePendingToken(ptr, 1);
 
+  // The old buffer is destroyed on the next allocation, as the service is done
+  // with it by then.
   EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
       .Times(1)
       .RetiresOnSaturation();
@@ -349,15 +350,56 @@ TEST_F(TransferBufferExpandContractTest, Expand) {
   EXPECT_EQ(kSize2, transfer_buffer_->GetCurrentMaxAllocationWithoutRealloc());
   transfer_buffer_->FreePendingToken(ptr, 1);
 
-  // Try next one more. Should not go past max.
+  EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
+      .Times(1)
+      .RetiresOnSaturation();
+
+  // Try next one more. Should not go past max, and streams in halves.
   size_allocated = 0;
   const size_t kSize3 = kSize2 + 1;
   ptr = transfer_buffer_->AllocUpTo(kSize3, &size_allocated);
-  EXPECT_EQ(kSize2, size_allocated);
+  EXPECT_EQ(kSize2 / 2, size_allocated);
   EXPECT_EQ(kSize2, transfer_buffer_->GetCurrentMaxAllocationWithoutRealloc());
   transfer_buffer_->FreePendingToken(ptr, 1);
 }
 
+TEST_F(TransferBufferExpandContractTest, GrowsInsteadOfWaiting) {
+  // A token the service hasn't reached.
+  const unsigned int kPendingToken = 20000;
+
+  // Fill the buffer with data the service hasn't read yet.
+  const size_t kSize1 = kStartTransferBufferSize - kStartingOffset;
+  unsigned int size_allocated = 0;
+  void* ptr = transfer_buffer_->AllocUpTo(kSize1, &size_allocated);
+  ASSERT_TRUE(ptr != NULL);
+  EXPECT_EQ(kSize1, size_allocated);
+  transfer_buffer_->FreePendingToken(ptr, kPendingToken);
+
+  // The next allocation gets a larger buffer instead of waiting. The old one
+  // is kept for the service.
+  EXPECT_CALL(*command_buffer(),
+              CreateTransferBuffer(kStartTransferBufferSize * 2, _))
+      .WillOnce(Invoke(
+          command_buffer(),
+          &MockClientCommandBufferCanFail::RealCreateTransferBuffer))
+      .RetiresOnSaturation();
+  const size_t kSize2 = 16;
+  ptr = transfer_buffer_->AllocUpTo(kSize2, &size_allocated);
+  ASSERT_TRUE(ptr != NULL);
+  EXPECT_EQ(kSize2, size_allocated);
+  EXPECT_EQ(kStartTransferBufferSize * 2 - kStartingOffset,
+            transfer_buffer_->GetCurrentMaxAllocationWithoutRealloc());
+  transfer_buffer_->FreePendingToken(ptr, helper_->InsertToken());
+
+  // Once the service is done with the old buffer, it's destroyed.
+  EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
+      .Times(1)
+      .RetiresOnSaturation();
+  ptr = transfer_buffer_->AllocUpTo(kSize2, &size_allocated);
+  ASSERT_TRUE(ptr != NULL);
+  transfer_buffer_->FreePendingToken(ptr, helper_->InsertToken());
+}
+
 TEST_F(TransferBufferExpandContractTest, Contract) {
   // Check it starts at starting size.
   EXPECT_EQ(
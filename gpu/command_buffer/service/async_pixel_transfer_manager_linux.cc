@@ -10,6 +10,7 @@
 #include "gpu/command_buffer/service/async_pixel_transfer_manager_share_group.h"
 #include "gpu/command_buffer/service/async_pixel_transfer_manager_stub.h"
 #include "gpu/command_buffer/service/gpu_switches.h"
+#include "ui/gl/gl_fence.h"
 #include "ui/gl/gl_implementation.h"
 
 namespace gpu {
@@ -25,8 +26,18 @@ AsyncPixelTransferManager* AsyncPixelTransferManager::Create(
   }
 
   switch (gfx::GetGLImplementation()) {
-    case gfx::kGLImplementationOSMesaGL:
     case gfx::kGLImplementationDesktopGL:
+      // Uploads go to a thread with a context in the same share group, and
+      // complete with a fence, so large images don't hold up the main
+      // thread.
+      if (gfx::GLFence::IsSupported() &&
+          !CommandLine::ForCurrentProcess()->HasSwitch(
+              switches::kDisableShareGroupAsyncTextureUpload) &&
+          AsyncPixelTransferManagerShareGroup::CanUploadFor(context)) {
+        return new AsyncPixelTransferManagerShareGroup(context);
+      }
+      return new AsyncPixelTransferManagerIdle;
+    case gfx::kGLImplementationOSMesaGL:
     case gfx::kGLImplementationEGLGLES2:
       return new AsyncPixelTransferManagerIdle;
     case gfx::kGLImplementationMockGL:
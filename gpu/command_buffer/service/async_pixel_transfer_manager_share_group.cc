@@ -21,6 +21,8 @@
 #include "gpu/command_buffer/service/safe_shared_memory_pool.h"
 #include "ui/gl/gl_bindings.h"
 #include "ui/gl/gl_context.h"
+#include "ui/gl/gl_fence.h"
+#include "ui/gl/gl_share_group.h"
 #include "ui/gl/gl_surface.h"
 #include "ui/gl/gpu_preference.h"
 #include "ui/gl/scoped_binders.h"
@@ -72,6 +74,15 @@ class TransferThread : public base::Thread {
                  base::Unretained(parent_context),
                  &wait_for_init));
     wait_for_init.Wait();
+    if (initialized_)
+      share_group_ = parent_context->share_group();
+  }
+
+  // Returns true if textures of |context| can be uploaded by this thread.
+  // The thread's context shares with the first context that initialized it.
+  bool IsSharedWith(gfx::GLContext* context) const {
+    return initialized_ && context &&
+           context->share_group() == share_group_.get();
   }
 
   virtual void CleanUp() OVERRIDE {
@@ -86,6 +97,9 @@ class TransferThread : public base::Thread {
  private:
   bool initialized_;
 
+  // Only used on the main thread.
+  scoped_refptr<gfx::GLShareGroup> share_group_;
+
   scoped_refptr<gfx::GLSurface> surface_;
   scoped_refptr<gfx::GLContext> context_;
   SafeSharedMemoryPool safe_shared_memory_pool_;
@@ -171,8 +185,14 @@ class PendingTask : public base::RefCountedThreadSafe<PendingTask> {
       task_.Run();
       task_.Reset();
       glBindTexture(GL_TEXTURE_2D, 0);
-      // Flush for synchronization between threads.
-      glFlush();
+      // The main thread can use the texture once the upload has completed
+      // on the GPU, which a fence tells reliably. A flush is all that can
+      // be done without one.
+      scoped_ptr<gfx::GLFence> fence(gfx::GLFence::Create());
+      if (fence)
+        fence->ClientWait();
+      else
+        glFlush();
       task_pending_.Signal();
     }
   }
@@ -506,6 +526,13 @@ AsyncPixelTransferManagerShareGroup::AsyncPixelTransferManagerShareGroup(
 
 AsyncPixelTransferManagerShareGroup::~AsyncPixelTransferManagerShareGroup() {}
 
+// static
+bool AsyncPixelTransferManagerShareGroup::CanUploadFor(
+    gfx::GLContext* context) {
+  g_transfer_thread.Pointer()->InitializeOnMainThread(context);
+  return g_transfer_thread.Pointer()->IsSharedWith(context);
+}
+
 void AsyncPixelTransferManagerShareGroup::BindCompletedAsyncTransfers() {
   scoped_ptr<gfx::ScopedTextureBinder> texture_binder;
 
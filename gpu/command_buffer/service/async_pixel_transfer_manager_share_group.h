@@ -22,6 +22,10 @@ class AsyncPixelTransferManagerShareGroup : public AsyncPixelTransferManager {
   explicit AsyncPixelTransferManagerShareGroup(gfx::GLContext* context);
   virtual ~AsyncPixelTransferManagerShareGroup();
 
+  // Returns true if the upload thread can upload textures of |context|,
+  // which means its context could be created and shares with |context|.
+  static bool CanUploadFor(gfx::GLContext* context);
+
   // AsyncPixelTransferManager implementation:
   virtual void BindCompletedAsyncTransfers() OVERRIDE;
   virtual void AsyncNotifyCompletion(
@@ -501,7 +501,8 @@ bool GLES2Decoder::GetServiceTextureId(uint32 client_texture_id,
 GLES2Decoder::GLES2Decoder()
     : initialized_(false),
       debug_(false),
-      log_commands_(false) {
+      log_commands_(false),
+      trusted_client_(false) {
 }
 
 GLES2Decoder::~GLES2Decoder() {
@@ -1202,6 +1203,10 @@ class GLES2DecoderImpl : public GLES2Decoder {
   // Wrapper for glCompileShader.
   void DoCompileShader(GLuint shader);
 
+  // Compiles |shader| if DoCompileShader deferred its compile, for queries
+  // that need the result.
+  void CompileDeferredShader(Shader* shader);
+
   // Helper for DeleteSharedIdsCHROMIUM commands.
   void DoDeleteSharedIdsCHROMIUM(
       GLuint namespace_id, GLsizei n, const GLuint* ids);
@@ -1392,6 +1397,10 @@ class GLES2DecoderImpl : public GLES2Decoder {
   // false if pname is unknown.
   bool GetNumValuesReturnedForGLGet(GLenum pname, GLsizei* num_values);
 
+  // Returns true if a draw needs to simulate vertex attributes, which
+  // requires knowing the largest vertex it accesses.
+  bool NeedsAttribSimulation();
+
   // Checks if the current program and vertex attributes are valid for drawing.
   bool IsDrawValid(
       const char* function_name, GLuint max_vertex_accessed, GLsizei primcount);
@@ -1729,6 +1738,9 @@ class GLES2DecoderImpl : public GLES2Decoder {
 
   bool compile_shader_always_succeeds_;
 
+  // Attach a fence to produced textures, for consumers to wait on.
+  bool use_mailbox_fences_;
+
   // Log extra info.
   bool service_logging_;
 
@@ -2182,6 +2194,7 @@ GLES2DecoderImpl::GLES2DecoderImpl(ContextGroup* group)
       frag_depth_explicitly_enabled_(false),
       draw_buffers_explicitly_enabled_(false),
       compile_shader_always_succeeds_(false),
+      use_mailbox_fences_(false),
       service_logging_(CommandLine::ForCurrentProcess()->HasSwitch(
           switches::kEnableGPUServiceLoggingGPU)),
       viewport_max_width_(0),
@@ -2242,6 +2255,9 @@ bool GLES2DecoderImpl::Initialize(
   compile_shader_always_succeeds_ = CommandLine::ForCurrentProcess()->HasSwitch(
       switches::kCompileShaderAlwaysSucceeds);
 
+  use_mailbox_fences_ = gfx::GLFence::IsSupportedAcrossContexts() &&
+      !CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kDisableMailboxFences);
 
   // Take ownership of the context and surface. The surface can be replaced with
   // SetSurface.
@@ -5790,6 +5806,22 @@ bool GLES2DecoderImpl::IsDrawValid(
                          primcount);
 }
 
+bool GLES2DecoderImpl::NeedsAttribSimulation() {
+  if (gfx::GetGLImplementation() == gfx::kGLImplementationEGLGLES2)
+    return false;
+  if (state_.vertex_attrib_manager->HaveFixedAttribs())
+    return true;
+  // Without a program the draw fails anyway.
+  if (!state_.current_program.get())
+    return false;
+  // Matches the checks of SimulateAttrib0.
+  const VertexAttrib* attrib =
+      state_.vertex_attrib_manager->GetVertexAttrib(0);
+  bool attrib_0_used =
+      state_.current_program->GetAttribInfoByLocation(0) != NULL;
+  return !attrib->enabled() || !attrib_0_used;
+}
+
 bool GLES2DecoderImpl::SimulateAttrib0(
     const char* function_name, GLuint max_vertex_accessed, bool* simulated) {
   DCHECK(simulated);
@@ -6154,11 +6186,25 @@ error::Error GLES2DecoderImpl::DoDrawElements(
     return error::kNoError;
   }
 
-  GLuint max_vertex_accessed;
+  GLuint max_vertex_accessed = 0;
   Buffer* element_array_buffer =
       state_.vertex_attrib_manager->element_array_buffer();
 
-  if (!element_array_buffer->GetMaxValueForRange(
+  // Trusted clients don't have their indices checked, so they only need to
+  // be scanned when attributes have to be simulated. The range still has to
+  // be within the buffer and aligned, which is cheap to check.
+  if (trusted_client() && !NeedsAttribSimulation()) {
+    uint32 type_size = GLES2Util::GetGLTypeSizeForTexturesAndBuffers(type);
+    uint32 size = 0;
+    if ((offset % type_size) != 0 ||
+        !SafeMultiplyUint32(count, type_size, &size) ||
+        !element_array_buffer->GetRange(offset, size)) {
+      LOCAL_SET_GL_ERROR(
+          GL_INVALID_OPERATION, function_name,
+          "range out of bounds for buffer");
+      return error::kNoError;
+    }
+  } else if (!element_array_buffer->GetMaxValueForRange(
       offset, count, type, &max_vertex_accessed)) {
     LOCAL_SET_GL_ERROR(
         GL_INVALID_OPERATION, function_name, "range out of bounds for buffer");
@@ -6330,6 +6376,19 @@ void GLES2DecoderImpl::DoCompileShader(GLuint client_id) {
   program_manager()->DoCompileShader(shader, translator, feature_info_.get());
 };
 
+void GLES2DecoderImpl::CompileDeferredShader(Shader* shader) {
+  if (!shader->compilation_deferred())
+    return;
+  ShaderTranslator* translator = NULL;
+  if (use_shader_translator_) {
+    translator = shader->shader_type() == GL_VERTEX_SHADER ?
+        vertex_translator_.get() : fragment_translator_.get();
+  }
+
+  program_manager()->CompileDeferredShader(
+      shader, translator, feature_info_.get());
+}
+
 void GLES2DecoderImpl::DoGetShaderiv(
     GLuint shader_id, GLenum pname, GLint* params) {
   Shader* shader = GetShaderInfoNotProgram(shader_id, "glGetShaderiv");
@@ -6347,6 +6406,7 @@ void GLES2DecoderImpl::DoGetShaderiv(
       *params = shader->log_info() ? shader->log_info()->size() + 1 : 0;
       return;
     case GL_TRANSLATED_SHADER_SOURCE_LENGTH_ANGLE:
+      CompileDeferredShader(shader);
       *params = shader->translated_source() ?
           shader->translated_source()->size() + 1 : 0;
       return;
@@ -6383,6 +6443,7 @@ error::Error GLES2DecoderImpl::HandleGetTranslatedShaderSourceANGLE(
     return error::kNoError;
   }
 
+  CompileDeferredShader(shader);
   bucket->SetFromString(shader->translated_source() ?
       shader->translated_source()->c_str() : NULL);
   return error::kNoError;
@@ -9984,6 +10045,13 @@ void GLES2DecoderImpl::DoProduceTextureCHROMIUM(GLenum target,
         "glProduceTextureCHROMIUM", "invalid mailbox name");
     return;
   }
+
+  if (use_mailbox_fences_) {
+    // The fence has to reach the GPU before other contexts can wait for it.
+    group_->mailbox_manager()->SetProduceFence(produced,
+                                               gfx::GLFence::Create());
+    glFlush();
+  }
 }
 
 void GLES2DecoderImpl::DoConsumeTextureCHROMIUM(GLenum target,
@@ -10024,6 +10092,11 @@ void GLES2DecoderImpl::DoConsumeTextureCHROMIUM(GLenum target,
     return;
   }
 
+  // Rather than the producer's sync point, wait for its commands on the GPU.
+  gfx::GLFence* fence = group_->mailbox_manager()->GetProduceFence(texture);
+  if (fence)
+    fence->ServerWait();
+
   DeleteTexturesHelper(1, &client_id);
   texture_ref = texture_manager()->Consume(client_id, texture);
   glBindTexture(target, texture_ref->service_id());
@@ -93,6 +93,17 @@ class GPU_EXPORT GLES2Decoder : public base::SupportsWeakPtr<GLES2Decoder>,
     log_commands_ = log_commands;
   }
 
+  bool trusted_client() const {
+    return trusted_client_;
+  }
+
+  // Set to true for clients that can be relied on not to draw past the ends
+  // of their vertex buffers, like the browser's own compositor. Their draws
+  // aren't checked against the buffers and the indices in them.
+  void set_trusted_client(bool trusted_client) {
+    trusted_client_ = trusted_client;
+  }
+
   // Initializes the graphics context. Can create an offscreen
   // decoder with a frame buffer that can be referenced from the parent.
   // Takes ownership of GLContext.
@@ -243,6 +254,7 @@ class GPU_EXPORT GLES2Decoder : public base::SupportsWeakPtr<GLES2Decoder>,
   bool initialized_;
   bool debug_;
   bool log_commands_;
+  bool trusted_client_;
   static bool testing_force_is_angle_;
 
   DISALLOW_COPY_AND_ASSIGN(GLES2Decoder);
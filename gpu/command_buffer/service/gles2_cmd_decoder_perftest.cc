@@ -0,0 +1,91 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "base/time/time.h"
+#include "gpu/command_buffer/common/gles2_cmd_format.h"
+#include "gpu/command_buffer/service/gles2_cmd_decoder.h"
+#include "gpu/command_buffer/service/gles2_cmd_decoder_unittest_base.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "ui/gl/gl_mock.h"
+
+using ::testing::_;
+
+namespace gpu {
+namespace gles2 {
+
+using namespace cmds;
+
+namespace {
+
+const int kIterations = 10000;
+const GLsizei kPerfNumIndices = 512;
+
+}  // namespace
+
+class GLES2DecoderPerfTest : public GLES2DecoderWithShaderTestBase {
+ public:
+  GLES2DecoderPerfTest() {}
+
+ protected:
+  // Streams new indices into the element array buffer and draws them, the
+  // way the compositor draws its quads, and reports how many of these
+  // commands the decoder gets through per second.
+  void RunStreamingDrawElements(const char* name) {
+    SetupTexture();
+    DoBindBuffer(GL_ARRAY_BUFFER, client_buffer_id_, kServiceBufferId);
+    DoBufferData(GL_ARRAY_BUFFER, kNumVertices * 4 * sizeof(GLfloat));
+    DoEnableVertexAttribArray(0);
+    DoVertexAttribPointer(0, 4, GL_FLOAT, 0, 0);
+    DoBindBuffer(GL_ELEMENT_ARRAY_BUFFER,
+                 client_element_buffer_id_,
+                 kServiceElementBufferId);
+    const GLsizei kIndicesSize = kPerfNumIndices * sizeof(GLushort);
+    DoBufferData(GL_ELEMENT_ARRAY_BUFFER, kIndicesSize);
+
+    GLushort* indices = GetSharedMemoryAs<GLushort*>();
+    for (GLsizei i = 0; i < kPerfNumIndices; ++i)
+      indices[i] = i % kNumVertices;
+
+    SetupExpectationsForApplyingDefaultDirtyState();
+    EXPECT_CALL(*gl_, BufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, kIndicesSize,
+                                    shared_memory_address_))
+        .Times(kIterations);
+    EXPECT_CALL(*gl_, DrawElements(GL_TRIANGLES, kPerfNumIndices,
+                                   GL_UNSIGNED_SHORT, _))
+        .Times(kIterations);
+
+    BufferSubData sub_data_cmd;
+    sub_data_cmd.Init(GL_ELEMENT_ARRAY_BUFFER, 0, kIndicesSize,
+                      shared_memory_id_, shared_memory_offset_);
+    DrawElements draw_cmd;
+    draw_cmd.Init(GL_TRIANGLES, kPerfNumIndices, GL_UNSIGNED_SHORT, 0);
+
+    base::TimeTicks start = base::TimeTicks::HighResNow();
+    for (int i = 0; i < kIterations; ++i) {
+      ASSERT_EQ(error::kNoError, ExecuteCmd(sub_data_cmd));
+      ASSERT_EQ(error::kNoError, ExecuteCmd(draw_cmd));
+    }
+    base::TimeDelta elapsed = base::TimeTicks::HighResNow() - start;
+    EXPECT_EQ(GL_NO_ERROR, GetGLError());
+
+    printf("*RESULT %s: %.2f commands/s\n",
+           name,
+           2 * kIterations / elapsed.InSecondsF());
+  }
+};
+
+TEST_F(GLES2DecoderPerfTest, StreamingDrawElements) {
+  RunStreamingDrawElements("gles2_decoder_streaming_draw_elements");
+}
+
+TEST_F(GLES2DecoderPerfTest, StreamingDrawElementsTrustedClient) {
+  GetDecoder()->set_trusted_client(true);
+  RunStreamingDrawElements("gles2_decoder_streaming_draw_elements_trusted");
+}
+
+}  // namespace gles2
+}  // namespace gpu
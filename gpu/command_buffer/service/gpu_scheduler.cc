@@ -25,6 +25,10 @@ namespace gpu {
 namespace {
 const int64 kRescheduleTimeOutDelay = 1000;
 const int64 kUnscheduleFenceTimeOutDelay = 10000;
+
+// Reading the clock after every command would be noticeable, so the time slice
+// is only checked after this many commands.
+const int kCommandsPerTimeSliceCheck = 16;
 }
 
 GpuScheduler::GpuScheduler(CommandBuffer* command_buffer,
@@ -68,6 +72,7 @@ void GpuScheduler::PutChanged() {
 
   base::TimeTicks begin_time(base::TimeTicks::HighResNow());
   error::Error error = error::kNoError;
+  int commands_processed = 0;
   while (!parser_->IsEmpty()) {
     if (IsPreempted())
       break;
@@ -100,6 +105,14 @@ void GpuScheduler::PutChanged() {
 
     if (unscheduled_count_ > 0)
       break;
+
+    if (time_slice_ > base::TimeDelta() &&
+        ++commands_processed % kCommandsPerTimeSliceCheck == 0 &&
+        base::TimeTicks::HighResNow() - begin_time >= time_slice_) {
+      TRACE_EVENT_INSTANT0("gpu", "GpuScheduler:TimeSliceExpired",
+                           TRACE_EVENT_SCOPE_THREAD);
+      break;
+    }
   }
 
   if (decoder_) {
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "base/message_loop/message_loop.h"
+#include "base/threading/platform_thread.h"
 #include "gpu/command_buffer/common/command_buffer_mock.h"
 #include "gpu/command_buffer/service/gles2_cmd_decoder.h"
 #include "gpu/command_buffer/service/gles2_cmd_decoder_mock.h"
@@ -157,6 +158,43 @@ TEST_F(GpuSchedulerTest, ProcessesTwoCommands) {
   scheduler_->PutChanged();
 }
 
+namespace {
+
+error::Error SlowCommand(unsigned int command,
+                         unsigned int arg_count,
+                         const void* cmd_data) {
+  base::PlatformThread::Sleep(base::TimeDelta::FromMilliseconds(1));
+  return error::kNoError;
+}
+
+}  // namespace
+
+TEST_F(GpuSchedulerTest, YieldsWhenTimeSliceIsUsedUp) {
+  const int kNumCommands = 64;
+  CommandHeader* header = reinterpret_cast<CommandHeader*>(&buffer_[0]);
+  for (int i = 0; i < kNumCommands; ++i) {
+    header[i].command = 8;
+    header[i].size = 1;
+  }
+
+  CommandBuffer::State state;
+
+  state.put_offset = kNumCommands;
+  EXPECT_CALL(*command_buffer_, GetState())
+    .WillRepeatedly(Return(state));
+
+  // The time slice is only checked every few commands, so the scheduler
+  // stops after the first check rather than the first command.
+  EXPECT_CALL(*decoder_, DoCommand(8, 0, _))
+    .Times(16)
+    .WillRepeatedly(Invoke(&SlowCommand));
+  EXPECT_CALL(*command_buffer_, SetGetOffset(_))
+    .Times(16);
+
+  scheduler_->SetTimeSlice(base::TimeDelta::FromMilliseconds(1));
+  scheduler_->PutChanged();
+}
+
 TEST_F(GpuSchedulerTest, SetsErrorCodeOnCommandBuffer) {
   CommandHeader* header = reinterpret_cast<CommandHeader*>(&buffer_[0]);
   header[0].command = 7;
@@ -66,6 +66,15 @@ const char kDisableGpuShaderDiskCache[]     = "disable-gpu-shader-disk-cache";
 const char kEnableShareGroupAsyncTextureUpload[] =
     "enable-share-group-async-texture-upload";
 
+// Disables the async texture uploads via GL context sharing that desktop GL
+// uses by default, in favor of uploads on the main thread when idle.
+const char kDisableShareGroupAsyncTextureUpload[] =
+    "disable-share-group-async-texture-upload";
+
+// Disables the GL fences attached to textures put into mailboxes, which let
+// consuming contexts wait on the GPU for the producer's commands.
+const char kDisableMailboxFences[] = "disable-mailbox-fences";
+
 const char* kGpuSwitches[] = {
   kCompileShaderAlwaysSucceeds,
   kDisableGLErrorLimit,
@@ -85,6 +94,8 @@ const char* kGpuSwitches[] = {
   kTraceGL,
   kDisableGpuShaderDiskCache,
   kEnableShareGroupAsyncTextureUpload,
+  kDisableShareGroupAsyncTextureUpload,
+  kDisableMailboxFences,
 };
 
 const int kNumGpuSwitches = arraysize(kGpuSwitches);
@@ -234,6 +234,7 @@ class ScopedEvent {
 
 InProcessCommandBuffer::InProcessCommandBuffer()
     : context_lost_(false),
+      trusted_client_(false),
       share_group_id_(0),
       last_put_offset_(-1),
       flush_event_(false, false),
@@ -391,6 +392,7 @@ bool InProcessCommandBuffer::InitializeOnGpuThread(
   command_buffer_ = command_buffer.Pass();
 
   decoder_->set_engine(gpu_scheduler_.get());
+  decoder_->set_trusted_client(trusted_client_);
 
   if (!surface_) {
     if (is_offscreen)
@@ -62,6 +62,13 @@ class GPU_EXPORT InProcessCommandBuffer : public CommandBuffer {
 
   static void EnableVirtualizedContext();
 
+  // Marks the context as used only by the embedder itself, which saves the
+  // decoder some checks (see GLES2Decoder::set_trusted_client). Must be called
+  // before Initialize.
+  void set_trusted_client(bool trusted_client) {
+    trusted_client_ = trusted_client;
+  }
+
   // If |surface| is not NULL, use it directly; in this case, the command
   // buffer gpu thread must be the same as the client thread. Otherwise create
   // a new GLSurface.
@@ -139,6 +146,7 @@ class GPU_EXPORT InProcessCommandBuffer : public CommandBuffer {
   // creation):
   bool context_lost_;
   bool share_resources_;
+  bool trusted_client_;
   scoped_ptr<TransferBufferManagerInterface> transfer_buffer_manager_;
   scoped_ptr<GpuScheduler> gpu_scheduler_;
   scoped_ptr<gles2::GLES2Decoder> decoder_;
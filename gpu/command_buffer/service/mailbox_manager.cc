@@ -9,6 +9,7 @@
 #include "base/rand_util.h"
 #include "crypto/hmac.h"
 #include "gpu/command_buffer/service/texture_manager.h"
+#include "ui/gl/gl_fence.h"
 
 namespace gpu {
 namespace gles2 {
@@ -31,6 +32,7 @@ MailboxManager::MailboxManager()
 MailboxManager::~MailboxManager() {
   DCHECK(mailbox_to_textures_.empty());
   DCHECK(textures_to_mailboxes_.empty());
+  DCHECK(produce_fences_.empty());
 }
 
 void MailboxManager::GenerateMailboxName(MailboxName* name) {
@@ -73,6 +75,16 @@ bool MailboxManager::ProduceTexture(unsigned target,
   return true;
 }
 
+void MailboxManager::SetProduceFence(Texture* texture, gfx::GLFence* fence) {
+  DCHECK(textures_to_mailboxes_.find(texture) != textures_to_mailboxes_.end());
+  produce_fences_[texture] = linked_ptr<gfx::GLFence>(fence);
+}
+
+gfx::GLFence* MailboxManager::GetProduceFence(Texture* texture) {
+  TextureToFenceMap::iterator it = produce_fences_.find(texture);
+  return it != produce_fences_.end() ? it->second.get() : NULL;
+}
+
 void MailboxManager::TextureDeleted(Texture* texture) {
   std::pair<TextureToMailboxMap::iterator,
             TextureToMailboxMap::iterator> range =
@@ -83,6 +95,7 @@ void MailboxManager::TextureDeleted(Texture* texture) {
     DCHECK(count == 1);
   }
   textures_to_mailboxes_.erase(range.first, range.second);
+  produce_fences_.erase(texture);
   DCHECK_EQ(mailbox_to_textures_.size(), textures_to_mailboxes_.size());
 }
 
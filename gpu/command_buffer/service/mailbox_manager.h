@@ -21,6 +21,10 @@
 
 typedef signed char GLbyte;
 
+namespace gfx {
+class GLFence;
+}
+
 namespace gpu {
 namespace gles2 {
 
@@ -52,6 +56,14 @@ class GPU_EXPORT MailboxManager : public base::RefCounted<MailboxManager> {
                       const MailboxName& name,
                       Texture* texture);
 
+  // Attach a fence to the mailboxes of the texture, replacing the one of an
+  // earlier produce. Consumers make the GPU wait for the fence instead of
+  // waiting for the producer's sync point. Takes ownership of the fence.
+  void SetProduceFence(Texture* texture, gfx::GLFence* fence);
+
+  // Returns the fence attached by the last produce of the texture, or NULL.
+  gfx::GLFence* GetProduceFence(Texture* texture);
+
   // Destroy any mailbox that reference the given texture.
   void TextureDeleted(Texture* texture);
 
@@ -85,11 +97,13 @@ class GPU_EXPORT MailboxManager : public base::RefCounted<MailboxManager> {
       TextureToMailboxMap::iterator,
       std::pointer_to_binary_function<
           const TargetName&, const TargetName&, bool> > MailboxToTextureMap;
+  typedef std::map<Texture*, linked_ptr<gfx::GLFence> > TextureToFenceMap;
 
   char private_key_[GL_MAILBOX_SIZE_CHROMIUM / 2];
   crypto::HMAC hmac_;
   MailboxToTextureMap mailbox_to_textures_;
   TextureToMailboxMap textures_to_mailboxes_;
+  TextureToFenceMap produce_fences_;
 
   DISALLOW_COPY_AND_ASSIGN(MailboxManager);
 };
@@ -4,12 +4,33 @@
 
 #include "gpu/command_buffer/service/mailbox_manager.h"
 
+#include "base/compiler_specific.h"
 #include "gpu/command_buffer/service/texture_manager.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "ui/gl/gl_fence.h"
 
 namespace gpu {
 namespace gles2 {
 
+namespace {
+
+// Counts how many of its instances are alive.
+class FakeFence : public gfx::GLFence {
+ public:
+  FakeFence() { ++count_; }
+  virtual ~FakeFence() { --count_; }
+
+  virtual bool HasCompleted() OVERRIDE { return true; }
+  virtual void ClientWait() OVERRIDE {}
+  virtual void ServerWait() OVERRIDE {}
+
+  static int count_;
+};
+
+int FakeFence::count_ = 0;
+
+}  // namespace
+
 class MailboxManagerTest : public testing::Test {
  public:
   MailboxManagerTest() : manager_(new MailboxManager()) {}
@@ -142,5 +163,29 @@ TEST_F(MailboxManagerTest, ProduceMultipleTextureMailbox) {
   EXPECT_EQ(NULL, manager_->ConsumeTexture(0, name2));
 }
 
+// A new produce replaces the fence of the last one, and destroying the texture
+// drops it.
+TEST_F(MailboxManagerTest, ProduceFence) {
+  Texture* texture = CreateTexture();
+  MailboxName name;
+  manager_->GenerateMailboxName(&name);
+
+  EXPECT_TRUE(manager_->ProduceTexture(0, name, texture));
+  EXPECT_EQ(NULL, manager_->GetProduceFence(texture));
+
+  FakeFence* fence1 = new FakeFence;
+  manager_->SetProduceFence(texture, fence1);
+  EXPECT_EQ(fence1, manager_->GetProduceFence(texture));
+
+  EXPECT_TRUE(manager_->ProduceTexture(0, name, texture));
+  FakeFence* fence2 = new FakeFence;
+  manager_->SetProduceFence(texture, fence2);
+  EXPECT_EQ(fence2, manager_->GetProduceFence(texture));
+  EXPECT_EQ(1, FakeFence::count_);
+
+  DestroyTexture(texture);
+  EXPECT_EQ(0, FakeFence::count_);
+}
+
 }  // namespace gles2
 }  // namespace gpu
@@ -61,6 +61,16 @@ void StoreShaderInfo(ShaderMapType type, ShaderProto *proto,
   }
 }
 
+void StoreHashedNames(ShaderProto* proto,
+                      const ShaderTranslator::NameMap& map) {
+  ShaderTranslator::NameMap::const_iterator iter;
+  for (iter = map.begin(); iter != map.end(); iter++) {
+    HashedNameProto* hashed_name = proto->add_hashed_names();
+    hashed_name->set_hashed_name(iter->first);
+    hashed_name->set_name(iter->second);
+  }
+}
+
 void RetrieveShaderInfo(const ShaderInfoProto& proto,
                         ShaderTranslator::VariableMap* map) {
   ShaderTranslator::VariableInfo info(proto.type(), proto.size(),
@@ -73,6 +83,7 @@ void FillShaderProto(ShaderProto* proto, const char* sha,
   proto->set_sha(sha, gpu::gles2::ProgramCache::kHashLength);
   StoreShaderInfo(ATTRIB_MAP, proto, shader->attrib_map());
   StoreShaderInfo(UNIFORM_MAP, proto, shader->uniform_map());
+  StoreHashedNames(proto, shader->name_map());
 }
 
 void RunShaderCallback(const ShaderCacheCallback& callback,
@@ -149,6 +160,8 @@ ProgramCache::ProgramLoadResult MemoryProgramCache::LoadLinkedProgram(
   shader_a->set_uniform_map(value->uniform_map_0());
   shader_b->set_attrib_map(value->attrib_map_1());
   shader_b->set_uniform_map(value->uniform_map_1());
+  shader_a->set_name_map(value->name_map_0());
+  shader_b->set_name_map(value->name_map_1());
 
   if (!shader_callback.is_null() &&
       !CommandLine::ForCurrentProcess()->HasSwitch(
@@ -241,9 +254,11 @@ void MemoryProgramCache::SaveLinkedProgram(
                                    a_sha,
                                    shader_a->attrib_map(),
                                    shader_a->uniform_map(),
+                                   shader_a->name_map(),
                                    b_sha,
                                    shader_b->attrib_map(),
                                    shader_b->uniform_map(),
+                                   shader_b->name_map(),
                                    this));
 
   UMA_HISTOGRAM_COUNTS("GPU.ProgramCache.MemorySizeAfterKb",
@@ -277,6 +292,28 @@ void MemoryProgramCache::LoadProgram(const std::string& program) {
                          &fragment_uniforms);
     }
 
+    ShaderTranslator::NameMap vertex_names;
+    for (int i = 0; i < proto->vertex_shader().hashed_names_size(); i++) {
+      const HashedNameProto& name = proto->vertex_shader().hashed_names(i);
+      vertex_names[name.hashed_name()] = name.name();
+    }
+
+    ShaderTranslator::NameMap fragment_names;
+    for (int i = 0; i < proto->fragment_shader().hashed_names_size(); i++) {
+      const HashedNameProto& name = proto->fragment_shader().hashed_names(i);
+      fragment_names[name.hashed_name()] = name.name();
+    }
+
+    // The browser sends the most recently used programs first, so once the
+    // cache is full the rest are less likely to be needed than what it has.
+    const size_t length = proto->program().length();
+    if (curr_size_bytes_ + length > max_size_bytes_ ||
+        store_.Peek(proto->sha()) != store_.end()) {
+      UMA_HISTOGRAM_BOOLEAN("GPU.ProgramCache.DiskProgramLoaded", false);
+      return;
+    }
+    UMA_HISTOGRAM_BOOLEAN("GPU.ProgramCache.DiskProgramLoaded", true);
+
     scoped_ptr<char[]> binary(new char[proto->program().length()]);
     memcpy(binary.get(), proto->program().c_str(), proto->program().length());
 
@@ -288,9 +325,11 @@ void MemoryProgramCache::LoadProgram(const std::string& program) {
                                      proto->vertex_shader().sha().c_str(),
                                      vertex_attribs,
                                      vertex_uniforms,
+                                     vertex_names,
                                      proto->fragment_shader().sha().c_str(),
                                      fragment_attribs,
                                      fragment_uniforms,
+                                     fragment_names,
                                      this));
 
     UMA_HISTOGRAM_COUNTS("GPU.ProgramCache.MemorySizeAfterKb",
@@ -308,9 +347,11 @@ MemoryProgramCache::ProgramCacheValue::ProgramCacheValue(
     const char* shader_0_hash,
     const ShaderTranslator::VariableMap& attrib_map_0,
     const ShaderTranslator::VariableMap& uniform_map_0,
+    const ShaderTranslator::NameMap& name_map_0,
     const char* shader_1_hash,
     const ShaderTranslator::VariableMap& attrib_map_1,
     const ShaderTranslator::VariableMap& uniform_map_1,
+    const ShaderTranslator::NameMap& name_map_1,
     MemoryProgramCache* program_cache)
     : length_(length),
       format_(format),
@@ -319,12 +360,16 @@ MemoryProgramCache::ProgramCacheValue::ProgramCacheValue(
       shader_0_hash_(shader_0_hash, kHashLength),
       attrib_map_0_(attrib_map_0),
       uniform_map_0_(uniform_map_0),
+      name_map_0_(name_map_0),
       shader_1_hash_(shader_1_hash, kHashLength),
       attrib_map_1_(attrib_map_1),
       uniform_map_1_(uniform_map_1),
+      name_map_1_(name_map_1),
       program_cache_(program_cache) {
   program_cache_->curr_size_bytes_ += length_;
   program_cache_->LinkedProgramCacheSuccess(program_hash);
+  program_cache_->ShaderCompilationSucceeded(shader_0_hash_);
+  program_cache_->ShaderCompilationSucceeded(shader_1_hash_);
 }
 
 MemoryProgramCache::ProgramCacheValue::~ProgramCacheValue() {
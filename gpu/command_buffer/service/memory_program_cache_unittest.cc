@@ -622,5 +622,105 @@ TEST_F(MemoryProgramCacheTest, OverwriteOnNewSave) {
                  base::Unretained(this))));
 }
 
+TEST_F(MemoryProgramCacheTest, LoadProgramRestoresShaderState) {
+  const GLenum kFormat = 1;
+  const int kProgramId = 10;
+  const int kBinaryLength = 20;
+  char test_binary[kBinaryLength];
+  for (int i = 0; i < kBinaryLength; ++i) {
+    test_binary[i] = i;
+  }
+  ProgramBinaryEmulator emulator(kBinaryLength, kFormat, test_binary);
+
+  ShaderTranslator::NameMap vertex_name_map;
+  vertex_name_map["webgl_1234"] = "position";
+  vertex_shader_->set_name_map(vertex_name_map);
+
+  SetExpectationsForSaveLinkedProgram(kProgramId, &emulator);
+  cache_->SaveLinkedProgram(kProgramId, vertex_shader_, NULL,
+                            fragment_shader_, NULL, NULL,
+                            base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
+                                       base::Unretained(this)));
+  EXPECT_EQ(ProgramCache::COMPILATION_SUCCEEDED,
+            cache_->GetShaderCompilationStatus(
+                *vertex_shader_->signature_source(), NULL));
+
+  cache_->Clear();
+  EXPECT_EQ(ProgramCache::COMPILATION_UNKNOWN,
+            cache_->GetShaderCompilationStatus(
+                *vertex_shader_->signature_source(), NULL));
+  vertex_shader_->set_name_map(ShaderTranslator::NameMap());
+
+  // A program read off disk lets its shaders skip compiling, and gives them
+  // back the hashed names they would have had.
+  cache_->LoadProgram(shader_cache_shader());
+  EXPECT_EQ(ProgramCache::COMPILATION_SUCCEEDED,
+            cache_->GetShaderCompilationStatus(
+                *vertex_shader_->signature_source(), NULL));
+  EXPECT_EQ(ProgramCache::COMPILATION_SUCCEEDED,
+            cache_->GetShaderCompilationStatus(
+                *fragment_shader_->signature_source(), NULL));
+
+  SetExpectationsForLoadLinkedProgram(kProgramId, &emulator);
+  EXPECT_EQ(ProgramCache::PROGRAM_LOAD_SUCCESS, cache_->LoadLinkedProgram(
+      kProgramId,
+      vertex_shader_,
+      NULL,
+      fragment_shader_,
+      NULL,
+      NULL,
+      base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
+                 base::Unretained(this))));
+  const std::string* name =
+      vertex_shader_->GetOriginalNameFromHashedName("webgl_1234");
+  ASSERT_TRUE(name != NULL);
+  EXPECT_EQ("position", *name);
+}
+
+TEST_F(MemoryProgramCacheTest, LoadProgramKeepsFirstWhenFull) {
+  const GLenum kFormat = 1;
+  const int kProgramId = 10;
+  const GLsizei kBinaryLength = kCacheSizeBytes / 2 + 1;
+  scoped_ptr<char[]> test_binary(new char[kBinaryLength]);
+  for (GLsizei i = 0; i < kBinaryLength; ++i) {
+    test_binary[i] = i % 250;
+  }
+  ProgramBinaryEmulator emulator(kBinaryLength, kFormat, test_binary.get());
+
+  SetExpectationsForSaveLinkedProgram(kProgramId, &emulator);
+  cache_->SaveLinkedProgram(kProgramId, vertex_shader_, NULL,
+                            fragment_shader_, NULL, NULL,
+                            base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
+                                       base::Unretained(this)));
+  const std::string first_program = shader_cache_shader();
+  const std::string first_source = *fragment_shader_->signature_source();
+
+  fragment_shader_->UpdateSource("al sdfkjdk");
+  fragment_shader_->SetStatus(true, NULL, NULL);
+  SetExpectationsForSaveLinkedProgram(kProgramId, &emulator);
+  cache_->SaveLinkedProgram(kProgramId, vertex_shader_, NULL,
+                            fragment_shader_, NULL, NULL,
+                            base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
+                                       base::Unretained(this)));
+  const std::string second_program = shader_cache_shader();
+
+  // Both don't fit, and the one sent first is the more recently used one.
+  cache_->Clear();
+  cache_->LoadProgram(first_program);
+  cache_->LoadProgram(second_program);
+  EXPECT_EQ(ProgramCache::LINK_SUCCEEDED, cache_->GetLinkedProgramStatus(
+      *vertex_shader_->signature_source(),
+      NULL,
+      first_source,
+      NULL,
+      NULL));
+  EXPECT_EQ(ProgramCache::LINK_UNKNOWN, cache_->GetLinkedProgramStatus(
+      *vertex_shader_->signature_source(),
+      NULL,
+      *fragment_shader_->signature_source(),
+      NULL,
+      NULL));
+}
+
 }  // namespace gles2
 }  // namespace gpu
@@ -17,6 +17,7 @@ ProgramCache::~ProgramCache() {}
 void ProgramCache::Clear() {
   ClearBackend();
   link_status_.clear();
+  shader_status_.clear();
 }
 
 ProgramCache::LinkedProgramStatus ProgramCache::GetLinkedProgramStatus(
@@ -45,6 +46,21 @@ ProgramCache::LinkedProgramStatus ProgramCache::GetLinkedProgramStatus(
   }
 }
 
+ProgramCache::CompiledShaderStatus ProgramCache::GetShaderCompilationStatus(
+    const std::string& untranslated_shader,
+    const ShaderTranslatorInterface* translator) const {
+  char sha[kHashLength];
+  ComputeShaderHash(untranslated_shader, translator, sha);
+  const std::string sha_string(sha, kHashLength);
+
+  CompileStatusMap::const_iterator found = shader_status_.find(sha_string);
+  if (found == shader_status_.end()) {
+    return ProgramCache::COMPILATION_UNKNOWN;
+  } else {
+    return found->second;
+  }
+}
+
 void ProgramCache::LinkedProgramCacheSuccess(
     const std::string& shader_a,
     const ShaderTranslatorInterface* translator_a,
@@ -63,12 +79,18 @@ void ProgramCache::LinkedProgramCacheSuccess(
   const std::string sha_string(sha, kHashLength);
 
   LinkedProgramCacheSuccess(sha_string);
+  ShaderCompilationSucceeded(std::string(a_sha, kHashLength));
+  ShaderCompilationSucceeded(std::string(b_sha, kHashLength));
 }
 
 void ProgramCache::LinkedProgramCacheSuccess(const std::string& program_hash) {
   link_status_[program_hash] = LINK_SUCCEEDED;
 }
 
+void ProgramCache::ShaderCompilationSucceeded(const std::string& shader_hash) {
+  shader_status_[shader_hash] = COMPILATION_SUCCEEDED;
+}
+
 void ProgramCache::ComputeShaderHash(
     const std::string& str,
     const ShaderTranslatorInterface* translator,
@@ -37,6 +37,11 @@ class GPU_EXPORT ProgramCache {
     PROGRAM_LOAD_SUCCESS
   };
 
+  enum CompiledShaderStatus {
+    COMPILATION_UNKNOWN,
+    COMPILATION_SUCCEEDED
+  };
+
   ProgramCache();
   virtual ~ProgramCache();
 
@@ -47,6 +52,13 @@ class GPU_EXPORT ProgramCache {
       const ShaderTranslatorInterface* translator_b,
       const LocationMap* bind_attrib_location_map) const;
 
+  // Returns COMPILATION_SUCCEEDED if a cached program was built from a shader
+  // with this source and these translator options, so its compile can wait
+  // until the program is linked and may not be needed at all.
+  CompiledShaderStatus GetShaderCompilationStatus(
+      const std::string& untranslated_shader,
+      const ShaderTranslatorInterface* translator) const;
+
   // Loads the linked program from the cache.  If the program is not found or
   // there was an error, PROGRAM_LOAD_FAILURE should be returned.
   virtual ProgramLoadResult LoadLinkedProgram(
@@ -85,6 +97,10 @@ class GPU_EXPORT ProgramCache {
   // called by implementing class after a shader was successfully cached
   void LinkedProgramCacheSuccess(const std::string& program_hash);
 
+  // called by implementing class for each shader of a cached program.
+  // |shader_hash| is expected to be kHashLength in length
+  void ShaderCompilationSucceeded(const std::string& shader_hash);
+
   // result is not null terminated
   void ComputeShaderHash(const std::string& shader,
                          const ShaderTranslatorInterface* translator,
@@ -103,11 +119,16 @@ class GPU_EXPORT ProgramCache {
  private:
   typedef base::hash_map<std::string,
                          LinkedProgramStatus> LinkStatusMap;
+  typedef base::hash_map<std::string,
+                         CompiledShaderStatus> CompileStatusMap;
 
   // called to clear the backend cache
   virtual void ClearBackend() = 0;
 
   LinkStatusMap link_status_;
+  // Shaders are not forgotten when their programs are evicted; a stale entry
+  // only means the deferred compile happens at link time after all.
+  CompileStatusMap shader_status_;
 
   DISALLOW_COPY_AND_ASSIGN(ProgramCache);
 };
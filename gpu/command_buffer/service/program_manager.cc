@@ -11,6 +11,7 @@
 
 #include "base/basictypes.h"
 #include "base/command_line.h"
+#include "base/debug/trace_event.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram.h"
@@ -443,9 +444,44 @@ void Program::ExecuteBindAttribLocationCalls() {
 void ProgramManager::DoCompileShader(Shader* shader,
                                      ShaderTranslator* translator,
                                      FeatureInfo* feature_info) {
+  // A shader that the program cache has seen compile successfully can be
+  // assumed to compile again; if every program using it is then loaded from
+  // the cache, translating and compiling it would be wasted.
+  if (program_cache_ && shader->source() &&
+      program_cache_->GetShaderCompilationStatus(
+          *shader->source(), translator) ==
+          ProgramCache::COMPILATION_SUCCEEDED) {
+    shader->SetStatus(true, "", NULL);
+    shader->set_compilation_deferred(true);
+    return;
+  }
+  ForceCompileShader(shader->source(), shader, translator, feature_info);
+}
+
+void ProgramManager::CompileDeferredShader(Shader* shader,
+                                           ShaderTranslator* translator,
+                                           FeatureInfo* feature_info) {
+  if (!shader->compilation_deferred())
+    return;
+  TRACE_EVENT0("gpu", "ProgramManager::CompileDeferredShader");
+  // The source may have been replaced since glCompileShader. Compile the
+  // source glCompileShader saw, which is also what its status reflects, and
+  // put the current one back afterwards.
+  DCHECK(shader->signature_source());
+  std::string compiled_source(*shader->signature_source());
+  scoped_ptr<std::string> current_source(
+      shader->source() ? new std::string(*shader->source()) : NULL);
+  shader->UpdateSource(compiled_source.c_str());
+  ForceCompileShader(&compiled_source, shader, translator, feature_info);
+  shader->UpdateSource(current_source.get() ? current_source->c_str() : NULL);
+}
+
+void ProgramManager::ForceCompileShader(const std::string* source,
+                                        Shader* shader,
+                                        ShaderTranslator* translator,
+                                        FeatureInfo* feature_info) {
   // Translate GL ES 2.0 shader to Desktop GL shader and pass that to
   // glShaderSource and then glCompileShader.
-  const std::string* source = shader->source();
   const char* shader_src = source ? source->c_str() : "";
   if (translator) {
     if (!translator->Translate(shader_src)) {
@@ -541,6 +577,31 @@ bool Program::Link(ShaderManager* manager,
   }
 
   if (link) {
+    // The cache had no binary to stand in for shaders whose compile was
+    // deferred, so they have to be compiled now.
+    bool compiled = false;
+    for (int i = 0; i < kMaxAttachedShaders; ++i) {
+      Shader* shader = attached_shaders_[i].get();
+      if (!shader->compilation_deferred())
+        continue;
+      manager_->CompileDeferredShader(
+          shader,
+          shader->shader_type() == GL_VERTEX_SHADER ? vertex_translator
+                                                    : fragment_translator,
+          feature_info);
+      compiled = true;
+    }
+    if (compiled) {
+      if (!CanLink()) {
+        set_log_info("invalid shaders");
+        return false;
+      }
+      if (DetectAttribLocationBindingConflicts()) {
+        set_log_info("glBindAttribLocation() conflicts");
+        return false;
+      }
+    }
+
     ExecuteBindAttribLocationCalls();
     before_time = TimeTicks::HighResNow();
     if (cache && gfx::g_driver_gl.ext.b_GL_ARB_get_program_binary) {
@@ -358,13 +358,25 @@ class GPU_EXPORT ProgramManager {
 
   static int32 MakeFakeLocation(int32 index, int32 element);
 
+  // Compiles |shader|, unless the program cache already has a program built
+  // from it, in which case the compile is deferred until it is needed.
   void DoCompileShader(Shader* shader,
                        ShaderTranslator* translator,
                        FeatureInfo* feature_info);
 
+  // Does the compile of |shader| if it was deferred.
+  void CompileDeferredShader(Shader* shader,
+                             ShaderTranslator* translator,
+                             FeatureInfo* feature_info);
+
  private:
   friend class Program;
 
+  void ForceCompileShader(const std::string* source,
+                          Shader* shader,
+                          ShaderTranslator* translator,
+                          FeatureInfo* feature_info);
+
   void StartTracking(Program* program);
   void StopTracking(Program* program);
 
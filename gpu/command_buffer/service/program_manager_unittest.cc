@@ -1375,5 +1375,49 @@ TEST_F(ProgramManagerWithCacheTest, LoadProgramOnProgramCacheHit) {
                              base::Bind(&ShaderCacheCb)));
 }
 
+TEST_F(ProgramManagerWithCacheTest, DeferCompileOnProgramCacheHit) {
+  scoped_refptr<FeatureInfo> feature_info(new FeatureInfo());
+  SetProgramCached();
+
+  SetExpectationsForNoCompile(vertex_shader_);
+  SetExpectationsForNoCompile(fragment_shader_);
+  manager_.DoCompileShader(vertex_shader_, NULL, feature_info.get());
+  manager_.DoCompileShader(fragment_shader_, NULL, feature_info.get());
+  EXPECT_TRUE(vertex_shader_->IsValid());
+  EXPECT_TRUE(vertex_shader_->compilation_deferred());
+  EXPECT_TRUE(fragment_shader_->IsValid());
+  EXPECT_TRUE(fragment_shader_->compilation_deferred());
+
+  SetExpectationsForProgramLoad(ProgramCache::PROGRAM_LOAD_SUCCESS);
+  SetExpectationsForNotCachingProgram();
+  SetExpectationsForProgramLoadSuccess();
+
+  EXPECT_TRUE(program_->Link(NULL, NULL, NULL, feature_info.get(),
+                             base::Bind(&ShaderCacheCb)));
+  EXPECT_TRUE(vertex_shader_->compilation_deferred());
+}
+
+TEST_F(ProgramManagerWithCacheTest, CompileDeferredShadersOnLoadFailure) {
+  scoped_refptr<FeatureInfo> feature_info(new FeatureInfo());
+  SetProgramCached();
+
+  SetExpectationsForNoCompile(vertex_shader_);
+  SetExpectationsForNoCompile(fragment_shader_);
+  manager_.DoCompileShader(vertex_shader_, NULL, feature_info.get());
+  manager_.DoCompileShader(fragment_shader_, NULL, feature_info.get());
+  ::testing::Mock::VerifyAndClearExpectations(gl_.get());
+
+  SetExpectationsForProgramLoad(ProgramCache::PROGRAM_LOAD_FAILURE);
+  SetExpectationsForSuccessCompile(vertex_shader_);
+  SetExpectationsForSuccessCompile(fragment_shader_);
+  SetExpectationsForProgramLink();
+  SetExpectationsForProgramCached();
+
+  EXPECT_TRUE(program_->Link(NULL, NULL, NULL, feature_info.get(),
+                             base::Bind(&ShaderCacheCb)));
+  EXPECT_FALSE(vertex_shader_->compilation_deferred());
+  EXPECT_FALSE(fragment_shader_->compilation_deferred());
+}
+
 }  // namespace gles2
 }  // namespace gpu
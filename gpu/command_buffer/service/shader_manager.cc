@@ -16,7 +16,8 @@ Shader::Shader(GLuint service_id, GLenum shader_type)
       : use_count_(0),
         service_id_(service_id),
         shader_type_(shader_type),
-        valid_(false) {
+        valid_(false),
+        compilation_deferred_(false) {
 }
 
 Shader::~Shader() {
@@ -39,6 +40,7 @@ void Shader::MarkAsDeleted() {
 void Shader::SetStatus(
     bool valid, const char* log, ShaderTranslatorInterface* translator) {
   valid_ = valid;
+  compilation_deferred_ = false;
   log_info_.reset(log ? new std::string(log) : NULL);
   if (translator && valid) {
     attrib_map_ = translator->attrib_map();
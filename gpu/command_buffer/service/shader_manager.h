@@ -78,6 +78,17 @@ class GPU_EXPORT Shader : public base::RefCounted<Shader> {
     return valid_;
   }
 
+  // True if the shader was marked as compiled without actually being
+  // compiled, because the program cache had a program built from it. It is
+  // compiled for real only if a program using it misses the cache.
+  bool compilation_deferred() const {
+    return compilation_deferred_;
+  }
+
+  void set_compilation_deferred(bool deferred) {
+    compilation_deferred_ = deferred;
+  }
+
   bool IsDeleted() const {
     return service_id_ == 0;
   }
@@ -97,6 +108,11 @@ class GPU_EXPORT Shader : public base::RefCounted<Shader> {
     return uniform_map_;
   }
 
+  // Used by program cache.
+  const ShaderTranslator::NameMap& name_map() const {
+    return name_map_;
+  }
+
   // Used by program cache.
   void set_attrib_map(const ShaderTranslator::VariableMap& attrib_map) {
     // copied because cache might be cleared
@@ -109,6 +125,12 @@ class GPU_EXPORT Shader : public base::RefCounted<Shader> {
     uniform_map_ = ShaderTranslator::VariableMap(uniform_map);
   }
 
+  // Used by program cache.
+  void set_name_map(const ShaderTranslator::NameMap& name_map) {
+    // copied because cache might be cleared
+    name_map_ = ShaderTranslator::NameMap(name_map);
+  }
+
  private:
   typedef ShaderTranslator::VariableMap VariableMap;
   typedef ShaderTranslator::NameMap NameMap;
@@ -133,6 +155,9 @@ class GPU_EXPORT Shader : public base::RefCounted<Shader> {
   // True if compilation succeeded.
   bool valid_;
 
+  // True if the compile of |signature_source_| has not happened yet.
+  bool compilation_deferred_;
+
   // The shader source as passed to glShaderSource.
   scoped_ptr<std::string> source_;
 
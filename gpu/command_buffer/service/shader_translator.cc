@@ -10,7 +10,10 @@
 #include "base/at_exit.h"
 #include "base/debug/trace_event.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
+#include "base/sha1.h"
 #include "base/strings/string_number_conversions.h"
+#include "gpu/command_buffer/service/shader_translator_cache.h"
 
 namespace {
 
@@ -120,7 +123,8 @@ ShaderTranslator::DestructionObserver::~DestructionObserver() {
 ShaderTranslator::ShaderTranslator()
     : compiler_(NULL),
       implementation_is_glsl_es_(false),
-      needs_built_in_function_emulation_(false) {
+      needs_built_in_function_emulation_(false),
+      translation_cache_(NULL) {
 }
 
 bool ShaderTranslator::Init(
@@ -151,6 +155,11 @@ bool ShaderTranslator::Init(
   implementation_is_glsl_es_ = (glsl_implementation_type == kGlslES);
   needs_built_in_function_emulation_ =
       (glsl_built_in_function_behavior == kGlslBuiltInFunctionEmulated);
+  translation_cache_key_ =
+      ":ShaderType:" + base::IntToString(shader_type) +
+      ":ShaderSpec:" + base::IntToString(shader_spec) +
+      ":ShaderOutput:" + base::IntToString(shader_output) +
+      GetStringForOptionsThatWouldEffectCompilation() + ":Source:";
   return compiler_ != NULL;
 }
 
@@ -174,6 +183,33 @@ bool ShaderTranslator::Translate(const char* shader) {
   DCHECK(shader != NULL);
   ClearResults();
 
+  std::string cache_key;
+  if (translation_cache_) {
+    cache_key = base::SHA1HashString(translation_cache_key_ + shader);
+    const ShaderTranslatorCache::Translation* translation =
+        translation_cache_->GetTranslation(cache_key);
+    UMA_HISTOGRAM_BOOLEAN("GPU.ShaderTranslator.CacheHit", translation != NULL);
+    if (translation) {
+      if (!translation->translated_shader.empty()) {
+        translated_shader_.reset(
+            new char[translation->translated_shader.size() + 1]);
+        memcpy(translated_shader_.get(),
+               translation->translated_shader.c_str(),
+               translation->translated_shader.size() + 1);
+      }
+      if (!translation->info_log.empty()) {
+        info_log_.reset(new char[translation->info_log.size() + 1]);
+        memcpy(info_log_.get(),
+               translation->info_log.c_str(),
+               translation->info_log.size() + 1);
+      }
+      attrib_map_ = translation->attrib_map;
+      uniform_map_ = translation->uniform_map;
+      name_map_ = translation->name_map;
+      return translation->success;
+    }
+  }
+
   bool success = false;
   {
     TRACE_EVENT0("gpu", "ShCompile");
@@ -204,6 +240,19 @@ bool ShaderTranslator::Translate(const char* shader) {
     info_log_.reset();
   }
 
+  if (translation_cache_) {
+    ShaderTranslatorCache::Translation translation;
+    translation.success = success;
+    if (translated_shader_)
+      translation.translated_shader = translated_shader_.get();
+    if (info_log_)
+      translation.info_log = info_log_.get();
+    translation.attrib_map = attrib_map_;
+    translation.uniform_map = uniform_map_;
+    translation.name_map = name_map_;
+    translation_cache_->StoreTranslation(cache_key, translation);
+  }
+
   return success;
 }
 
@@ -18,6 +18,8 @@
 namespace gpu {
 namespace gles2 {
 
+class ShaderTranslatorCache;
+
 // Translates a GLSL ES 2.0 shader to desktop GLSL shader, or just
 // validates GLSL ES 2.0 shaders on a true GLSL ES implementation.
 class ShaderTranslatorInterface {
@@ -136,6 +138,12 @@ class GPU_EXPORT ShaderTranslator
   void AddDestructionObserver(DestructionObserver* observer);
   void RemoveDestructionObserver(DestructionObserver* observer);
 
+  // Makes Translate look up and store its results in |cache|, which is
+  // shared with all other translators that use it.
+  void set_translation_cache(ShaderTranslatorCache* cache) {
+    translation_cache_ = cache;
+  }
+
  private:
   friend class base::RefCounted<ShaderTranslator>;
 
@@ -152,6 +160,9 @@ class GPU_EXPORT ShaderTranslator
   NameMap name_map_;
   bool implementation_is_glsl_es_;
   bool needs_built_in_function_emulation_;
+  ShaderTranslatorCache* translation_cache_;
+  // Everything besides the source that the results of Translate depend on.
+  std::string translation_cache_key_;
   ObserverList<DestructionObserver> destruction_observers_;
 
   DISALLOW_COPY_AND_ASSIGN(ShaderTranslator);
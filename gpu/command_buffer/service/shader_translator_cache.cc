@@ -7,11 +7,26 @@
 namespace gpu {
 namespace gles2 {
 
+namespace {
+
+// Enough for the shaders of a few pages' worth of WebGL contexts.
+const size_t kMaxCachedTranslations = 64;
+
+}  // namespace
+
+ShaderTranslatorCache::Translation::Translation()
+    : success(false) {
+}
+
+ShaderTranslatorCache::Translation::~Translation() {
+}
+
 ShaderTranslatorCache* ShaderTranslatorCache::GetInstance() {
   return Singleton<ShaderTranslatorCache>::get();
 }
 
-ShaderTranslatorCache::ShaderTranslatorCache() {
+ShaderTranslatorCache::ShaderTranslatorCache()
+    : translations_(kMaxCachedTranslations) {
 }
 
 ShaderTranslatorCache::~ShaderTranslatorCache() {
@@ -52,11 +67,23 @@ scoped_refptr<ShaderTranslator> ShaderTranslatorCache::GetTranslator(
                        glsl_built_in_function_behavior)) {
     cache_[params] = translator;
     translator->AddDestructionObserver(this);
+    translator->set_translation_cache(this);
     return translator;
   } else {
     return NULL;
   }
 }
 
+const ShaderTranslatorCache::Translation*
+ShaderTranslatorCache::GetTranslation(const std::string& key) {
+  TranslationCache::iterator it = translations_.Get(key);
+  return it != translations_.end() ? &it->second : NULL;
+}
+
+void ShaderTranslatorCache::StoreTranslation(const std::string& key,
+                                             const Translation& translation) {
+  translations_.Put(key, translation);
+}
+
 }  // namespace gles2
 }  // namespace gpu
@@ -8,7 +8,9 @@
 #include <string.h>
 
 #include <map>
+#include <string>
 
+#include "base/containers/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/singleton.h"
 #include "gpu/command_buffer/service/shader_translator.h"
@@ -25,6 +27,21 @@ namespace gles2 {
 // to this cache.
 class ShaderTranslatorCache : public ShaderTranslator::DestructionObserver {
  public:
+  // The results of translating a shader, kept so that other contexts, or
+  // contexts created after the translator is gone, don't have to translate
+  // the same source again.
+  struct Translation {
+    Translation();
+    ~Translation();
+
+    bool success;
+    std::string translated_shader;
+    std::string info_log;
+    ShaderTranslatorInterface::VariableMap attrib_map;
+    ShaderTranslatorInterface::VariableMap uniform_map;
+    ShaderTranslatorInterface::NameMap name_map;
+  };
+
   static ShaderTranslatorCache* GetInstance();
 
   // ShaderTranslator::DestructionObserver implementation
@@ -39,6 +56,12 @@ class ShaderTranslatorCache : public ShaderTranslator::DestructionObserver {
       ShaderTranslatorInterface::GlslBuiltInFunctionBehavior
           glsl_built_in_function_behavior);
 
+  // Returns the translation stored under |key|, or NULL if there is none.
+  // |key| covers the source and everything the translation depends on.
+  const Translation* GetTranslation(const std::string& key);
+  void StoreTranslation(const std::string& key,
+                        const Translation& translation);
+
  private:
   ShaderTranslatorCache();
   virtual ~ShaderTranslatorCache();
@@ -86,6 +109,9 @@ class ShaderTranslatorCache : public ShaderTranslator::DestructionObserver {
   typedef std::map<ShaderTranslatorInitParams, ShaderTranslator* > Cache;
   Cache cache_;
 
+  typedef base::MRUCache<std::string, Translation> TranslationCache;
+  TranslationCache translations_;
+
   DISALLOW_COPY_AND_ASSIGN(ShaderTranslatorCache);
 };
 
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "gpu/command_buffer/service/shader_translator.h"
+#include "gpu/command_buffer/service/shader_translator_cache.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace gpu {
@@ -258,6 +259,53 @@ TEST_F(ShaderTranslatorTest, OptionsString) {
   EXPECT_NE(options_3, options_4);
 }
 
+TEST_F(ShaderTranslatorTest, TranslationsOutliveTranslators) {
+  const char* shader =
+      "attribute vec4 vPosition;\n"
+      "void main() {\n"
+      "  gl_Position = vPosition;\n"
+      "}";
+  const char* bad_shader =
+      "void main() {\n"
+      "  gl_Position = vPosition;\n"
+      "}";
+
+  ShBuiltInResources resources;
+  ShInitBuiltInResources(&resources);
+  ShaderTranslatorCache* cache = ShaderTranslatorCache::GetInstance();
+
+  scoped_refptr<ShaderTranslator> translator = cache->GetTranslator(
+      SH_VERTEX_SHADER, SH_WEBGL_SPEC, &resources,
+      ShaderTranslatorInterface::kGlsl,
+      ShaderTranslatorInterface::kGlslBuiltInFunctionOriginal);
+  ASSERT_TRUE(translator.get() != NULL);
+  ASSERT_TRUE(translator->Translate(shader));
+  ASSERT_TRUE(translator->translated_shader() != NULL);
+  std::string translated_shader(translator->translated_shader());
+  ShaderTranslator::VariableMap attrib_map(translator->attrib_map());
+  EXPECT_FALSE(translator->Translate(bad_shader));
+  ASSERT_TRUE(translator->info_log() != NULL);
+  std::string info_log(translator->info_log());
+  translator = NULL;
+
+  // A new translator returns the same results.
+  translator = cache->GetTranslator(
+      SH_VERTEX_SHADER, SH_WEBGL_SPEC, &resources,
+      ShaderTranslatorInterface::kGlsl,
+      ShaderTranslatorInterface::kGlslBuiltInFunctionOriginal);
+  ASSERT_TRUE(translator.get() != NULL);
+  EXPECT_TRUE(translator->Translate(shader));
+  ASSERT_TRUE(translator->translated_shader() != NULL);
+  EXPECT_EQ(translated_shader, translator->translated_shader());
+  EXPECT_TRUE(translator->info_log() == NULL);
+  EXPECT_TRUE(attrib_map == translator->attrib_map());
+  EXPECT_FALSE(translator->Translate(bad_shader));
+  EXPECT_TRUE(translator->translated_shader() == NULL);
+  ASSERT_TRUE(translator->info_log() != NULL);
+  EXPECT_EQ(info_log, translator->info_log());
+  EXPECT_TRUE(translator->attrib_map().empty());
+}
+
 }  // namespace gles2
 }  // namespace gpu
 
@@ -186,8 +186,12 @@ bool VertexAttribManager::ValidateBindings(
     if (attrib_info) {
       divisor0 |= (attrib->divisor() == 0);
       GLuint count = attrib->MaxVertexAccessed(primcount, max_vertex_accessed);
-      // This attrib is used in the current program.
-      if (!attrib->CanAccess(count)) {
+      // This attrib is used in the current program. Trusted clients only
+      // need a buffer; their draws aren't checked against its size.
+      bool can_access = decoder->trusted_client() ?
+          attrib->buffer() && !attrib->buffer()->IsDeleted() :
+          attrib->CanAccess(count);
+      if (!can_access) {
         ERRORSTATE_SET_GL_ERROR(
             error_state, GL_INVALID_OPERATION, function_name,
             (std::string(
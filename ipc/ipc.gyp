@@ -57,6 +57,7 @@
         'ipc_sync_message_unittest.h',
         'ipc_test_base.cc',
         'ipc_test_base.h',
+        'message_ring_posix_unittest.cc',
         'sync_socket_unittest.cc',
         'unix_domain_socket_util_unittest.cc',
       ],
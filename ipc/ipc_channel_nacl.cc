@@ -193,6 +193,8 @@ bool Channel::ChannelImpl::Send(Message* message) {
   Logging::GetInstance()->OnSendMessage(message_ptr.get(), "");
 #endif  // IPC_MESSAGE_LOG_ENABLED
 
+  // imc_sendmsg() is handed a single buffer, so gather any external data now.
+  message->Flatten();
   message->TraceMessageBegin();
   output_queue_.push_back(linked_ptr<Message>(message_ptr.release()));
   if (!waiting_connect_)
@@ -381,4 +383,13 @@ bool Channel::Send(Message* message) {
   return channel_impl_->Send(message);
 }
 
+bool Channel::SendMessages(const std::vector<Message*>& messages) {
+  // Every message is handed over, even after a failure, since the channel
+  // owns them all.
+  bool result = true;
+  for (size_t i = 0; i < messages.size(); ++i)
+    result &= channel_impl_->Send(messages[i]);
+  return result;
+}
+
 }  // namespace IPC
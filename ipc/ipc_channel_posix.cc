@@ -6,20 +6,20 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stddef.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <unistd.h>
 
-#if defined(OS_OPENBSD)
-#include <sys/uio.h>
-#endif
-
 #include <map>
 #include <string>
+#include <vector>
 
+#include "base/auto_reset.h"
 #include "base/command_line.h"
 #include "base/file_util.h"
 #include "base/files/file_path.h"
@@ -27,6 +27,7 @@
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/singleton.h"
+#include "base/metrics/histogram.h"
 #include "base/posix/eintr_wrapper.h"
 #include "base/posix/global_descriptors.h"
 #include "base/process/process_handle.h"
@@ -158,6 +159,47 @@ bool SocketWriteErrorIsRecoverable() {
 #endif  // OS_MACOSX
 }
 
+// Appends to |iovs| the parts of |msg| that follow its first |bytes_written|
+// bytes. At most IOV_MAX entries are produced; whatever does not fit is picked
+// up by the next write, just like after a short write.
+void GetUnsentIOVecs(const Message& msg,
+                     size_t bytes_written,
+                     std::vector<struct iovec>* iovs) {
+  std::vector<Pickle::Segment> segments;
+  msg.GetSegments(&segments);
+  for (size_t i = 0; i < segments.size() && iovs->size() < IOV_MAX; ++i) {
+    if (bytes_written >= segments[i].size) {
+      bytes_written -= segments[i].size;
+      continue;
+    }
+    struct iovec iov = {
+      const_cast<char*>(segments[i].data) + bytes_written,
+      segments[i].size - bytes_written
+    };
+    iovs->push_back(iov);
+    bytes_written = 0;
+  }
+}
+
+// Wakes up the peer at the other end of a message ring's socketpair. If the
+// socket buffer is full, a wakeup is pending already.
+void WakeUpRingPeer(int fd) {
+  char wakeup = 0;
+  if (HANDLE_EINTR(write(fd, &wakeup, 1)) < 0 && errno != EAGAIN)
+    DPLOG(ERROR) << "write " << fd;
+}
+
+// Reads all pending wakeups from a message ring's socketpair. Returns false
+// once the peer has closed its end.
+bool DrainRingWakeups(int fd) {
+  char buf[64];
+  while (true) {
+    ssize_t bytes_read = HANDLE_EINTR(read(fd, buf, sizeof(buf)));
+    if (bytes_read <= 0)
+      return bytes_read < 0 && errno == EAGAIN;
+  }
+}
+
 }  // namespace
 //------------------------------------------------------------------------------
 
@@ -181,7 +223,15 @@ Channel::ChannelImpl::ChannelImpl(const IPC::ChannelHandle& channel_handle,
       remote_fd_pipe_(-1),
 #endif  // IPC_USES_READWRITE
       pipe_name_(channel_handle.name),
-      must_unlink_(false) {
+      must_unlink_(false),
+      use_shared_memory_(false),
+      send_ring_wakeup_pipe_(-1),
+      send_ring_active_(false),
+      send_ring_diverted_(false),
+      is_blocked_on_send_ring_(false),
+      receive_ring_wakeup_pipe_(-1),
+      pending_diverted_messages_(0),
+      processing_receive_ring_(false) {
   memset(input_cmsg_buf_, 0, sizeof(input_cmsg_buf_));
   if (!CreatePipe(channel_handle)) {
     // The pipe may have been closed already.
@@ -361,15 +411,43 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
   while (!output_queue_.empty()) {
     Message* msg = output_queue_.front();
 
-    size_t amt_to_write = msg->size() - message_send_bytes_written_;
+    if (send_ring_active_ && message_send_bytes_written_ == 0) {
+      if (!WriteToSendRing(msg))
+        return true;
+      if (!send_ring_diverted_) {
+        delete output_queue_.front();
+        output_queue_.pop_front();
+        continue;
+      }
+    }
+
+    // Gather the unsent part of the message straight from its segments, so
+    // that data attached with WriteDataNoCopy() is never copied in userland.
+    std::vector<struct iovec> iovs;
+    GetUnsentIOVecs(*msg, message_send_bytes_written_, &iovs);
+    DCHECK(!iovs.empty());
+
+    // Messages queued together, e.g. by SendMessages(), go out with a single
+    // write as long as they don't carry file descriptors, which only travel
+    // with the first chunk of their message. Once a ring is set up, messages
+    // are written one at a time, since the ring may take over at any message.
+    int batch_size = 1;
+    if (!send_ring_ && msg->file_descriptor_set()->empty()) {
+      for (std::deque<Message*>::const_iterator it = output_queue_.begin() + 1;
+           it != output_queue_.end() && iovs.size() < IOV_MAX &&
+           (*it)->file_descriptor_set()->empty();
+           ++it, ++batch_size) {
+        GetUnsentIOVecs(**it, 0, &iovs);
+      }
+    }
+    size_t amt_to_write = 0;
+    for (size_t i = 0; i < iovs.size(); ++i)
+      amt_to_write += iovs[i].iov_len;
     DCHECK_NE(0U, amt_to_write);
-    const char* out_bytes = reinterpret_cast<const char*>(msg->data()) +
-        message_send_bytes_written_;
 
     struct msghdr msgh = {0};
-    struct iovec iov = {const_cast<char*>(out_bytes), amt_to_write};
-    msgh.msg_iov = &iov;
-    msgh.msg_iovlen = 1;
+    msgh.msg_iov = &iovs[0];
+    msgh.msg_iovlen = iovs.size();
     char buf[CMSG_SPACE(
         sizeof(int) * FileDescriptorSet::kMaxDescriptorsPerMessage)];
 
@@ -416,7 +494,7 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
         msgh.msg_iov = &fd_pipe_iov;
         fd_written = fd_pipe_;
         bytes_written = HANDLE_EINTR(sendmsg(fd_pipe_, &msgh, MSG_DONTWAIT));
-        msgh.msg_iov = &iov;
+        msgh.msg_iov = &iovs[0];
         msgh.msg_controllen = 0;
         if (bytes_written > 0) {
           msg->file_descriptor_set()->CommitAll();
@@ -432,7 +510,8 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
         DCHECK_EQ(msg->file_descriptor_set()->size(), 1U);
       }
       if (!msgh.msg_controllen) {
-        bytes_written = HANDLE_EINTR(write(pipe_, out_bytes, amt_to_write));
+        bytes_written = HANDLE_EINTR(
+            writev(pipe_, &iovs[0], static_cast<int>(iovs.size())));
       } else
 #endif  // IPC_USES_READWRITE
       {
@@ -461,13 +540,34 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
       return false;
     }
 
-    if (static_cast<size_t>(bytes_written) != amt_to_write) {
-      if (bytes_written > 0) {
-        // If write() fails with EAGAIN then bytes_written will be -1.
-        message_send_bytes_written_ += bytes_written;
+    if (bytes_written > 0) {
+      UMA_HISTOGRAM_COUNTS_100("IPC.MessagesPerWrite", batch_size);
+      // Retire the messages that went out completely.
+      size_t bytes_left = bytes_written;
+      while (bytes_left > 0) {
+        Message* sent = output_queue_.front();
+        size_t unsent = sent->size() - message_send_bytes_written_;
+        if (bytes_left < unsent) {
+          message_send_bytes_written_ += bytes_left;
+          break;
+        }
+        bytes_left -= unsent;
+        message_send_bytes_written_ = 0;
+        send_ring_diverted_ = false;
+        if (send_ring_ && IsInternalMessage(*sent))
+          send_ring_active_ = true;
+
+        // Message sent OK!
+        DVLOG(2) << "sent message @" << sent << " on channel @" << this
+                 << " with type " << sent->type() << " on fd " << pipe_;
+        delete sent;
+        output_queue_.pop_front();
       }
+    }
 
+    if (static_cast<size_t>(bytes_written) != amt_to_write) {
       // Tell libevent to call us back once things are unblocked.
+      // If write() fails with EAGAIN then bytes_written will be -1.
       is_blocked_on_write_ = true;
       base::MessageLoopForIO::current()->WatchFileDescriptor(
           pipe_,
@@ -476,20 +576,31 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
           &write_watcher_,
           this);
       return true;
-    } else {
-      message_send_bytes_written_ = 0;
-
-      // Message sent OK!
-      DVLOG(2) << "sent message @" << msg << " on channel @" << this
-               << " with type " << msg->type() << " on fd " << pipe_;
-      delete output_queue_.front();
-      output_queue_.pop();
     }
   }
   return true;
 }
 
 bool Channel::ChannelImpl::Send(Message* message) {
+  QueueOutgoingMessage(message);
+  if (!is_blocked_on_write_ && !is_blocked_on_send_ring_ && !waiting_connect_) {
+    return ProcessOutgoingMessages();
+  }
+
+  return true;
+}
+
+bool Channel::ChannelImpl::SendMessages(const std::vector<Message*>& messages) {
+  for (size_t i = 0; i < messages.size(); ++i)
+    QueueOutgoingMessage(messages[i]);
+  if (!is_blocked_on_write_ && !is_blocked_on_send_ring_ && !waiting_connect_) {
+    return ProcessOutgoingMessages();
+  }
+
+  return true;
+}
+
+void Channel::ChannelImpl::QueueOutgoingMessage(Message* message) {
   DVLOG(2) << "sending message @" << message << " on channel @" << this
            << " with type " << message->type()
            << " (" << output_queue_.size() << " in queue)";
@@ -499,12 +610,7 @@ bool Channel::ChannelImpl::Send(Message* message) {
 #endif  // IPC_MESSAGE_LOG_ENABLED
 
   message->TraceMessageBegin();
-  output_queue_.push(message);
-  if (!is_blocked_on_write_ && !waiting_connect_) {
-    return ProcessOutgoingMessages();
-  }
-
-  return true;
+  output_queue_.push_back(message);
 }
 
 int Channel::ChannelImpl::GetClientFileDescriptor() {
@@ -567,9 +673,11 @@ void Channel::ChannelImpl::ResetToAcceptingConnectionState() {
   }
 #endif  // IPC_USES_READWRITE
 
+  CloseRings();
+
   while (!output_queue_.empty()) {
     Message* m = output_queue_.front();
-    output_queue_.pop();
+    output_queue_.pop_front();
     delete m;
   }
 
@@ -577,6 +685,11 @@ void Channel::ChannelImpl::ResetToAcceptingConnectionState() {
   ClearInputFDs();
 }
 
+void Channel::ChannelImpl::EnableSharedMemoryTransport() {
+  DCHECK(!send_ring_);
+  use_shared_memory_ = true;
+}
+
 // static
 bool Channel::ChannelImpl::IsNamedServerInitialized(
     const std::string& channel_id) {
@@ -638,12 +751,30 @@ void Channel::ChannelImpl::OnFileCanReadWithoutBlocking(int fd) {
       send_server_hello_msg = true;
       waiting_connect_ = false;
     }
-    if (!ProcessIncomingMessages()) {
+    // Messages diverted around the receive ring may have unblocked it.
+    if (!ProcessIncomingMessages() || !ProcessRingMessages()) {
       // ClosePipeOnError may delete this object, so we mustn't call
       // ProcessOutgoingMessages.
       send_server_hello_msg = false;
       ClosePipeOnError();
     }
+  } else if (fd == send_ring_wakeup_pipe_) {
+    if (!DrainRingWakeups(fd))
+      send_ring_watcher_.StopWatchingFileDescriptor();
+    if (is_blocked_on_send_ring_) {
+      is_blocked_on_send_ring_ = false;
+      if (!ProcessOutgoingMessages()) {
+        ClosePipeOnError();
+        return;
+      }
+    }
+  } else if (fd == receive_ring_wakeup_pipe_) {
+    if (!DrainRingWakeups(fd))
+      receive_ring_watcher_.StopWatchingFileDescriptor();
+    if (!ProcessRingMessages()) {
+      ClosePipeOnError();
+      return;
+    }
   } else {
     NOTREACHED() << "Unknown pipe " << fd;
   }
@@ -670,6 +801,8 @@ bool Channel::ChannelImpl::AcceptConnection() {
   base::MessageLoopForIO::current()->WatchFileDescriptor(
       pipe_, true, base::MessageLoopForIO::WATCH_READ, &read_watcher_, this);
   QueueHelloMessage();
+  if (use_shared_memory_)
+    QueueRingSetupMessage();
 
   if (mode_ & MODE_CLIENT_FLAG) {
     // If we are a client we want to send a hello message out immediately.
@@ -729,7 +862,127 @@ void Channel::ChannelImpl::QueueHelloMessage() {
     DCHECK_EQ(msg->file_descriptor_set()->size(), 1U);
   }
 #endif  // IPC_USES_READWRITE
-  output_queue_.push(msg.release());
+  output_queue_.push_back(msg.release());
+}
+
+void Channel::ChannelImpl::QueueRingSetupMessage() {
+  DCHECK(!send_ring_);
+  scoped_ptr<internal::MessageRing> ring(
+      internal::MessageRing::Create(internal::MessageRing::kDefaultCapacity));
+  int local_wakeup_pipe = -1;
+  int remote_wakeup_pipe = -1;
+  if (!ring || !SocketPair(&local_wakeup_pipe, &remote_wakeup_pipe)) {
+    LOG(WARNING) << "Unable to set up the message ring for " << pipe_name_;
+    return;
+  }
+
+  // The ring stays open on our side; the peer's end of the socketpair is
+  // closed once it has been sent.
+  scoped_ptr<Message> msg(new Message(MSG_ROUTING_NONE,
+                                      RING_SETUP_MESSAGE_TYPE,
+                                      IPC::Message::PRIORITY_NORMAL));
+  if (!msg->WriteUInt32(static_cast<uint32>(ring->capacity())) ||
+      !msg->WriteFileDescriptor(
+          base::FileDescriptor(ring->handle().fd, false)) ||
+      !msg->WriteFileDescriptor(
+          base::FileDescriptor(remote_wakeup_pipe, true))) {
+    NOTREACHED() << "Unable to pickle ring setup message";
+  }
+  output_queue_.push_back(msg.release());
+
+  send_ring_ = ring.Pass();
+  send_ring_wakeup_pipe_ = local_wakeup_pipe;
+  base::MessageLoopForIO::current()->WatchFileDescriptor(
+      send_ring_wakeup_pipe_,
+      true,
+      base::MessageLoopForIO::WATCH_READ,
+      &send_ring_watcher_,
+      this);
+}
+
+bool Channel::ChannelImpl::WriteToSendRing(Message* msg) {
+  bool through_ring = msg->file_descriptor_set()->empty() &&
+                      send_ring_->CanWrite(msg->size());
+  if (!through_ring && send_ring_diverted_)
+    return true;
+
+  while (through_ring ? !send_ring_->WriteMessage(*msg)
+                      : !send_ring_->WriteDivert()) {
+    if (send_ring_->WaitForSpace(through_ring ? msg->size() : 0)) {
+      is_blocked_on_send_ring_ = true;
+      return false;
+    }
+  }
+  if (!through_ring)
+    send_ring_diverted_ = true;
+  if (send_ring_->TakeReaderWakeup())
+    WakeUpRingPeer(send_ring_wakeup_pipe_);
+  return true;
+}
+
+bool Channel::ChannelImpl::ProcessRingMessages() {
+  // A nested message loop run by a listener mustn't read the ring while a
+  // message read from it is being dispatched.
+  if (processing_receive_ring_)
+    return true;
+  base::AutoReset<bool> processing(&processing_receive_ring_, true);
+
+  // The ring is gone if a listener closed the channel.
+  while (receive_ring_ && pending_diverted_messages_ == 0) {
+    internal::MessageRing::ReadResult result =
+        receive_ring_->Read(&ring_input_buf_);
+    if (result == internal::MessageRing::READ_EMPTY) {
+      if (receive_ring_->WaitForData())
+        return true;
+      continue;
+    }
+    if (result == internal::MessageRing::READ_ERROR) {
+      LOG(ERROR) << "Corrupt message ring on " << pipe_name_;
+      return false;
+    }
+    if (receive_ring_->TakeWriterWakeup())
+      WakeUpRingPeer(receive_ring_wakeup_pipe_);
+    if (result == internal::MessageRing::READ_DIVERT) {
+      ++pending_diverted_messages_;
+      continue;
+    }
+
+    const char* data = ring_input_buf_.data();
+    const char* end = data + ring_input_buf_.size();
+    if (Message::FindNext(data, end) != end) {
+      LOG(ERROR) << "Malformed message in the message ring on " << pipe_name_;
+      return false;
+    }
+    Message m(data, static_cast<int>(ring_input_buf_.size()));
+    if (IsHelloMessage(m) || IsInternalMessage(m)) {
+      LOG(ERROR) << "Internal message in the message ring on " << pipe_name_;
+      return false;
+    }
+    if (!DispatchInputMessage(&m))
+      return false;
+  }
+  return true;
+}
+
+void Channel::ChannelImpl::CloseRings() {
+  send_ring_watcher_.StopWatchingFileDescriptor();
+  receive_ring_watcher_.StopWatchingFileDescriptor();
+  if (send_ring_wakeup_pipe_ != -1) {
+    if (HANDLE_EINTR(close(send_ring_wakeup_pipe_)) < 0)
+      PLOG(ERROR) << "close send_ring_wakeup_pipe_ " << pipe_name_;
+    send_ring_wakeup_pipe_ = -1;
+  }
+  if (receive_ring_wakeup_pipe_ != -1) {
+    if (HANDLE_EINTR(close(receive_ring_wakeup_pipe_)) < 0)
+      PLOG(ERROR) << "close receive_ring_wakeup_pipe_ " << pipe_name_;
+    receive_ring_wakeup_pipe_ = -1;
+  }
+  send_ring_.reset();
+  receive_ring_.reset();
+  send_ring_active_ = false;
+  send_ring_diverted_ = false;
+  is_blocked_on_send_ring_ = false;
+  pending_diverted_messages_ = 0;
 }
 
 Channel::ChannelImpl::ReadState Channel::ChannelImpl::ReadData(
@@ -816,6 +1069,19 @@ bool Channel::ChannelImpl::ReadFileDescriptorsFromFDPipe() {
 // This will read from the input_fds_ (READWRITE mode only) and read more
 // handles from the FD pipe if necessary.
 bool Channel::ChannelImpl::WillDispatchInputMessage(Message* msg) {
+  if (receive_ring_ && !processing_receive_ring_ && !IsHelloMessage(*msg) &&
+      !IsInternalMessage(*msg)) {
+    // The peer sends everything through the ring but the messages it diverts
+    // around it, so deliver the messages that precede this one there first.
+    if (pending_diverted_messages_ == 0 && !ProcessRingMessages())
+      return false;
+    if (pending_diverted_messages_ == 0) {
+      LOG(ERROR) << "Message bypassed the message ring on " << pipe_name_;
+      return false;
+    }
+    --pending_diverted_messages_;
+  }
+
   uint16 header_fds = msg->header()->num_fds;
   if (!header_fds)
     return true;  // Nothing to do.
@@ -927,6 +1193,52 @@ void Channel::ChannelImpl::HandleHelloMessage(const Message& msg) {
   listener()->OnChannelConnected(pid);
 }
 
+bool Channel::ChannelImpl::IsInternalMessage(const Message& m) const {
+  return m.routing_id() == MSG_ROUTING_NONE &&
+         m.type() == RING_SETUP_MESSAGE_TYPE;
+}
+
+bool Channel::ChannelImpl::HandleInternalMessage(const Message& msg) {
+  // The RING_SETUP message contains the capacity of the peer's send ring, the
+  // ring itself and our end of the socketpair used for wakeups.
+  PickleIterator iter(msg);
+  uint32 capacity;
+  base::FileDescriptor ring_descriptor;
+  base::FileDescriptor wakeup_descriptor;
+  if (!msg.ReadUInt32(&iter, &capacity) ||
+      !msg.ReadFileDescriptor(&iter, &ring_descriptor) ||
+      !msg.ReadFileDescriptor(&iter, &wakeup_descriptor) ||
+      receive_ring_) {
+    LOG(ERROR) << "Bad ring setup message on " << pipe_name_;
+    if (ring_descriptor.fd >= 0 && HANDLE_EINTR(close(ring_descriptor.fd)) < 0)
+      PLOG(ERROR) << "close";
+    if (wakeup_descriptor.fd >= 0 &&
+        HANDLE_EINTR(close(wakeup_descriptor.fd)) < 0) {
+      PLOG(ERROR) << "close";
+    }
+    return false;
+  }
+
+  receive_ring_ = internal::MessageRing::Open(ring_descriptor, capacity);
+  receive_ring_wakeup_pipe_ = wakeup_descriptor.fd;
+  if (!receive_ring_) {
+    LOG(ERROR) << "Unable to map the message ring on " << pipe_name_;
+    return false;
+  }
+  // Don't count on the peer to have made its end non-blocking.
+  if (fcntl(receive_ring_wakeup_pipe_, F_SETFL, O_NONBLOCK) == -1) {
+    PLOG(ERROR) << "fcntl(O_NONBLOCK)";
+    return false;
+  }
+  base::MessageLoopForIO::current()->WatchFileDescriptor(
+      receive_ring_wakeup_pipe_,
+      true,
+      base::MessageLoopForIO::WATCH_READ,
+      &receive_ring_watcher_,
+      this);
+  return ProcessRingMessages();
+}
+
 void Channel::ChannelImpl::Close() {
   // Close can be called multiple time, so we need to make sure we're
   // idempotent.
@@ -976,6 +1288,10 @@ bool Channel::Send(Message* message) {
   return channel_impl_->Send(message);
 }
 
+bool Channel::SendMessages(const std::vector<Message*>& messages) {
+  return channel_impl_->SendMessages(messages);
+}
+
 int Channel::GetClientFileDescriptor() const {
   return channel_impl_->GetClientFileDescriptor();
 }
@@ -1000,6 +1316,10 @@ void Channel::ResetToAcceptingConnectionState() {
   channel_impl_->ResetToAcceptingConnectionState();
 }
 
+void Channel::EnableSharedMemoryTransport() {
+  channel_impl_->EnableSharedMemoryTransport();
+}
+
 // static
 bool Channel::IsNamedServerInitialized(const std::string& channel_id) {
   return ChannelImpl::IsNamedServerInitialized(channel_id);
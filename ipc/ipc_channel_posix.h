@@ -9,14 +9,16 @@
 
 #include <sys/socket.h>  // for CMSG macros
 
-#include <queue>
+#include <deque>
 #include <string>
 #include <vector>
 
+#include "base/memory/scoped_ptr.h"
 #include "base/message_loop/message_loop.h"
 #include "base/process/process.h"
 #include "ipc/file_descriptor_set_posix.h"
 #include "ipc/ipc_channel_reader.h"
+#include "ipc/message_ring_posix.h"
 
 #if !defined(OS_MACOSX)
 // On Linux, the seccomp sandbox makes it very expensive to call
@@ -46,6 +48,21 @@
 #define IPC_USES_READWRITE 1
 #endif
 
+// With EnableSharedMemoryTransport(), each end of a channel can move the
+// messages it sends off the socket and into an internal::MessageRing. Right
+// after the hello message, the sending end sends a RING_SETUP message with
+// the ring and one end of a dedicated socketpair(), and writes every later
+// message into the ring. The reader drains the ring when a byte arrives on
+// the socketpair, which the writer only sends after the reader has flagged
+// that it ran out of messages; the reader wakes a writer waiting for space the
+// same way. Busy channels thus go without system calls altogether.
+//
+// Messages that carry file descriptors or don't fit into the ring still go
+// over the channel socket. So that the reader doesn't deliver the messages
+// behind them in the ring too early, the writer first puts a divert record
+// into the ring, at which the reader stops reading the ring until the message
+// has arrived on the socket.
+
 namespace IPC {
 
 class Channel::ChannelImpl : public internal::ChannelReader,
@@ -58,6 +75,7 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   bool Connect();
   void Close();
   bool Send(Message* message);
+  bool SendMessages(const std::vector<Message*>& messages);
   int GetClientFileDescriptor();
   int TakeClientFileDescriptor();
   void CloseClientFileDescriptor();
@@ -65,6 +83,7 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   bool HasAcceptedConnection() const;
   bool GetPeerEuid(uid_t* peer_euid) const;
   void ResetToAcceptingConnectionState();
+  void EnableSharedMemoryTransport();
   base::ProcessId peer_pid() const { return peer_pid_; }
   static bool IsNamedServerInitialized(const std::string& channel_id);
 #if defined(OS_LINUX)
@@ -74,6 +93,8 @@ class Channel::ChannelImpl : public internal::ChannelReader,
  private:
   bool CreatePipe(const IPC::ChannelHandle& channel_handle);
 
+  // Logs |message| and appends it to |output_queue_|.
+  void QueueOutgoingMessage(Message* message);
   bool ProcessOutgoingMessages();
 
   bool AcceptConnection();
@@ -81,6 +102,21 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   int GetHelloMessageProcId();
   void QueueHelloMessage();
 
+  // Creates the ring this end sends through and queues the message that
+  // hands it to the peer. Sending falls back to the socket on failure.
+  void QueueRingSetupMessage();
+
+  // Writes |msg| into the send ring, or the divert record that precedes it if
+  // it has to go over the socket. Returns false if the ring is full, in which
+  // case we may have to wait until the peer wakes us up.
+  bool WriteToSendRing(Message* msg);
+
+  // Dispatches the messages in the receive ring, up to the first divert
+  // record. Returns false on channel error.
+  bool ProcessRingMessages();
+
+  void CloseRings();
+
   // ChannelReader implementation.
   virtual ReadState ReadData(char* buffer,
                              int buffer_len,
@@ -88,6 +124,8 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   virtual bool WillDispatchInputMessage(Message* msg) OVERRIDE;
   virtual bool DidEmptyInputBuffers() OVERRIDE;
   virtual void HandleHelloMessage(const Message& msg) OVERRIDE;
+  virtual bool IsInternalMessage(const Message& m) const OVERRIDE;
+  virtual bool HandleInternalMessage(const Message& msg) OVERRIDE;
 
 #if defined(IPC_USES_READWRITE)
   // Reads the next message from the fd_pipe_ and appends them to the
@@ -154,7 +192,7 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   std::string pipe_name_;
 
   // Messages to be sent are queued here.
-  std::queue<Message*> output_queue_;
+  std::deque<Message*> output_queue_;
 
   // We assume a worst case: kReadBufferSize bytes of messages, where each
   // message has no payload and a full complement of descriptors.
@@ -187,6 +225,35 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   // True if we are responsible for unlinking the unix domain socket file.
   bool must_unlink_;
 
+  // Set by EnableSharedMemoryTransport().
+  bool use_shared_memory_;
+
+  // The ring we send through, and our end of the socketpair its reader uses
+  // to wake us up when we are waiting for space. Messages are written into
+  // the ring once |send_ring_active_|, i.e. once the RING_SETUP message is out.
+  scoped_ptr<internal::MessageRing> send_ring_;
+  int send_ring_wakeup_pipe_;
+  base::MessageLoopForIO::FileDescriptorWatcher send_ring_watcher_;
+  bool send_ring_active_;
+  // True if the divert record for the message at the front of output_queue_
+  // has been written.
+  bool send_ring_diverted_;
+  // True if we wait for the reader of the send ring to make room.
+  bool is_blocked_on_send_ring_;
+
+  // The ring the peer sends through, and our end of the socketpair it uses to
+  // wake us up when there is something to read.
+  scoped_ptr<internal::MessageRing> receive_ring_;
+  int receive_ring_wakeup_pipe_;
+  base::MessageLoopForIO::FileDescriptorWatcher receive_ring_watcher_;
+  // The number of divert records read from the receive ring for which the
+  // message has yet to arrive on the socket.
+  int pending_diverted_messages_;
+  // True while ProcessRingMessages() runs.
+  bool processing_receive_ring_;
+  // The message most recently read from the receive ring.
+  std::string ring_input_buf_;
+
 #if defined(OS_LINUX)
   // If non-zero, overrides the process ID sent in the hello message.
   static int global_pid_;
@@ -9,6 +9,7 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/single_thread_task_runner.h"
+#include "base/stl_util.h"
 #include "base/thread_task_runner_handle.h"
 #include "ipc/ipc_channel_proxy.h"
 #include "ipc/ipc_listener.h"
@@ -55,6 +56,7 @@ ChannelProxy::Context::Context(Listener* listener,
 }
 
 ChannelProxy::Context::~Context() {
+  STLDeleteElements(&pending_messages_);
 }
 
 void ChannelProxy::Context::ClearIPCTaskRunner() {
@@ -97,6 +99,21 @@ bool ChannelProxy::Context::OnMessageReceived(const Message& message) {
 
 // Called on the IPC::Channel thread
 bool ChannelProxy::Context::OnMessageReceivedNoFilter(const Message& message) {
+  scoped_refptr<base::SingleThreadTaskRunner> route_task_runner;
+  {
+    base::AutoLock auto_lock(message_class_routes_lock_);
+    MessageClassRoutes::const_iterator it =
+        message_class_routes_.find(IPC_MESSAGE_ID_CLASS(message.type()));
+    if (it != message_class_routes_.end())
+      route_task_runner = it->second.task_runner;
+  }
+  if (route_task_runner.get()) {
+    route_task_runner->PostTask(
+        FROM_HERE,
+        base::Bind(&Context::OnDispatchRoutedMessage, this, message));
+    return true;
+  }
+
   // NOTE: This code relies on the listener's message loop not going away while
   // this thread is active.  That should be a reasonable assumption, but it
   // feels risky.  We may want to invent some more indirect way of referring to
@@ -177,13 +194,58 @@ void ChannelProxy::Context::Clear() {
   listener_ = NULL;
 }
 
+void ChannelProxy::Context::QueueMessage(Message* message) {
+  bool was_empty;
+  {
+    base::AutoLock auto_lock(pending_messages_lock_);
+    was_empty = pending_messages_.empty();
+    pending_messages_.push_back(message);
+  }
+  // Only the first message of a batch rings the IPC thread; the others are
+  // picked up by the same task.
+  if (was_empty) {
+    ipc_task_runner_->PostTask(
+        FROM_HERE, base::Bind(&Context::OnSendPendingMessages, this));
+  }
+}
+
+void ChannelProxy::Context::AddMessageClassRoute(
+    int message_class,
+    Listener* listener,
+    base::SingleThreadTaskRunner* task_runner) {
+  DCHECK(listener);
+  DCHECK(task_runner);
+  MessageClassRoute route;
+  route.listener = listener;
+  route.task_runner = task_runner;
+  base::AutoLock auto_lock(message_class_routes_lock_);
+  bool inserted =
+      message_class_routes_.insert(std::make_pair(message_class, route)).second;
+  DCHECK(inserted) << "Message class " << message_class << " is routed already";
+}
+
+void ChannelProxy::Context::RemoveMessageClassRoute(int message_class) {
+  base::AutoLock auto_lock(message_class_routes_lock_);
+  MessageClassRoutes::iterator it = message_class_routes_.find(message_class);
+  if (it == message_class_routes_.end())
+    return;
+  DCHECK(it->second.task_runner->BelongsToCurrentThread());
+  message_class_routes_.erase(it);
+}
+
 // Called on the IPC::Channel thread
-void ChannelProxy::Context::OnSendMessage(scoped_ptr<Message> message) {
+void ChannelProxy::Context::OnSendPendingMessages() {
+  std::vector<Message*> messages;
+  {
+    base::AutoLock auto_lock(pending_messages_lock_);
+    messages.swap(pending_messages_);
+  }
   if (!channel_.get()) {
+    STLDeleteElements(&messages);
     OnChannelClosed();
     return;
   }
-  if (!channel_->Send(message.release()))
+  if (!channel_->SendMessages(messages))
     OnChannelError();
 }
 
@@ -269,6 +331,30 @@ void ChannelProxy::Context::OnDispatchMessage(const Message& message) {
 #endif
 }
 
+void ChannelProxy::Context::OnDispatchRoutedMessage(const Message& message) {
+  TRACE_EVENT2("task", "ChannelProxy::Context::OnDispatchRoutedMessage",
+               "class", IPC_MESSAGE_ID_CLASS(message.type()),
+               "line", IPC_MESSAGE_ID_LINE(message.type()));
+
+  Listener* listener = NULL;
+  {
+    base::AutoLock auto_lock(message_class_routes_lock_);
+    MessageClassRoutes::const_iterator it =
+        message_class_routes_.find(IPC_MESSAGE_ID_CLASS(message.type()));
+    if (it != message_class_routes_.end() &&
+        it->second.task_runner->BelongsToCurrentThread()) {
+      listener = it->second.listener;
+    }
+  }
+  if (!listener) {
+    // The route went away while the message was on its way.
+    listener_task_runner_->PostTask(
+        FROM_HERE, base::Bind(&Context::OnDispatchMessage, this, message));
+    return;
+  }
+  listener->OnMessageReceived(message);
+}
+
 // Called on the listener's thread
 void ChannelProxy::Context::OnDispatchConnected() {
   if (channel_connected_called_)
@@ -369,10 +455,7 @@ bool ChannelProxy::Send(Message* message) {
   Logging::GetInstance()->OnSendMessage(message, context_->channel_id());
 #endif
 
-  context_->ipc_task_runner()->PostTask(
-      FROM_HERE,
-      base::Bind(&ChannelProxy::Context::OnSendMessage,
-                 context_, base::Passed(scoped_ptr<Message>(message))));
+  context_->QueueMessage(message);
   return true;
 }
 
@@ -390,6 +473,17 @@ void ChannelProxy::RemoveFilter(MessageFilter* filter) {
                             make_scoped_refptr(filter)));
 }
 
+void ChannelProxy::AddMessageClassRoute(
+    int message_class,
+    Listener* listener,
+    base::SingleThreadTaskRunner* task_runner) {
+  context_->AddMessageClassRoute(message_class, listener, task_runner);
+}
+
+void ChannelProxy::RemoveMessageClassRoute(int message_class) {
+  context_->RemoveMessageClassRoute(message_class);
+}
+
 void ChannelProxy::ClearIPCTaskRunner() {
   DCHECK(CalledOnValidThread());
 
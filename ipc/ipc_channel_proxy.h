@@ -5,6 +5,7 @@
 #ifndef IPC_IPC_CHANNEL_PROXY_H_
 #define IPC_IPC_CHANNEL_PROXY_H_
 
+#include <map>
 #include <vector>
 
 #include "base/memory/ref_counted.h"
@@ -42,6 +43,10 @@ class SendCallbackHelper;
 // channel will not get cycles to flush its message queue until the thread, on
 // which it is running, returns to its message loop.)
 //
+// Whole classes of messages (see ipc_message_start.h) can also be routed to a
+// listener on another thread with AddMessageClassRoute(), in which case they
+// go straight from the IPC thread to that thread.
+//
 // An IPC::ChannelProxy can have a MessageFilter associated with it, which will
 // be notified of incoming messages on the IPC::Channel's thread.  This gives
 // the consumer of IPC::ChannelProxy the ability to respond to incoming
@@ -166,6 +171,21 @@ class IPC_EXPORT ChannelProxy : public Sender, public base::NonThreadSafe {
   void AddFilter(MessageFilter* filter);
   void RemoveFilter(MessageFilter* filter);
 
+  // Dispatches the messages of |message_class|, one of the values of
+  // IPCMessageStart, that no filter handles to |listener| on |task_runner|
+  // rather than to the proxy's listener. Messages of different classes may
+  // thus be dispatched out of order. There is at most one route per class.
+  // This method can be called on any thread and applies to the messages the
+  // IPC thread receives from then on.
+  void AddMessageClassRoute(int message_class,
+                            Listener* listener,
+                            base::SingleThreadTaskRunner* task_runner);
+
+  // Removes the route of |message_class|. Must be called on the route's
+  // thread; |listener| isn't called once this returns. Messages of the class
+  // that are still on their way go to the proxy's listener.
+  void RemoveMessageClassRoute(int message_class);
+
   void set_outgoing_message_filter(OutgoingMessageFilter* filter) {
     outgoing_message_filter_ = filter;
   }
@@ -237,8 +257,18 @@ class IPC_EXPORT ChannelProxy : public Sender, public base::NonThreadSafe {
     void CreateChannel(const IPC::ChannelHandle& channel_handle,
                        const Channel::Mode& mode);
 
+    // Queues |message| for the IPC thread, which sends all the messages
+    // queued in the meantime at once. Called on any thread.
+    void QueueMessage(Message* message);
+
+    // Methods called on any thread.
+    void AddMessageClassRoute(int message_class,
+                              Listener* listener,
+                              base::SingleThreadTaskRunner* task_runner);
+    void RemoveMessageClassRoute(int message_class);
+
     // Methods called on the IO thread.
-    void OnSendMessage(scoped_ptr<Message> message_ptr);
+    void OnSendPendingMessages();
     void OnAddFilter();
     void OnRemoveFilter(MessageFilter* filter);
 
@@ -247,6 +277,15 @@ class IPC_EXPORT ChannelProxy : public Sender, public base::NonThreadSafe {
     void OnDispatchConnected();
     void OnDispatchError();
 
+    // Called on the thread of a message class route.
+    void OnDispatchRoutedMessage(const Message& message);
+
+    struct MessageClassRoute {
+      Listener* listener;
+      scoped_refptr<base::SingleThreadTaskRunner> task_runner;
+    };
+    typedef std::map<int, MessageClassRoute> MessageClassRoutes;
+
     scoped_refptr<base::SingleThreadTaskRunner> listener_task_runner_;
     Listener* listener_;
 
@@ -263,6 +302,18 @@ class IPC_EXPORT ChannelProxy : public Sender, public base::NonThreadSafe {
     // Lock for pending_filters_.
     base::Lock pending_filters_lock_;
 
+    // Messages sent on the listener thread, or any other thread, that wait to
+    // be handed to the channel on the IPC thread. Owned.
+    std::vector<Message*> pending_messages_;
+    // Lock for pending_messages_.
+    base::Lock pending_messages_lock_;
+
+    // Routes by message class, read on the IPC thread and on the routes'
+    // threads.
+    MessageClassRoutes message_class_routes_;
+    // Lock for message_class_routes_.
+    base::Lock message_class_routes_lock_;
+
     // Cached copy of the peer process ID. Set on IPC but read on both IPC and
     // listener threads.
     base::ProcessId peer_pid_;
@@ -43,6 +43,41 @@ bool ChannelReader::IsHelloMessage(const Message& m) const {
          m.type() == Channel::HELLO_MESSAGE_TYPE;
 }
 
+bool ChannelReader::IsInternalMessage(const Message& m) const {
+  return false;
+}
+
+bool ChannelReader::HandleInternalMessage(const Message& msg) {
+  NOTREACHED();
+  return false;
+}
+
+bool ChannelReader::DispatchInputMessage(Message* m) {
+  if (!WillDispatchInputMessage(m))
+    return false;
+
+#ifdef IPC_MESSAGE_LOG_ENABLED
+  Logging* logger = Logging::GetInstance();
+  std::string name;
+  logger->GetMessageText(m->type(), &name, m, NULL);
+  TRACE_EVENT1("ipc", "ChannelReader::DispatchInputData", "name", name);
+#else
+  TRACE_EVENT2("ipc", "ChannelReader::DispatchInputData",
+               "class", IPC_MESSAGE_ID_CLASS(m->type()),
+               "line", IPC_MESSAGE_ID_LINE(m->type()));
+#endif
+  m->TraceMessageEnd();
+  if (IsHelloMessage(*m)) {
+    HandleHelloMessage(*m);
+  } else if (IsInternalMessage(*m)) {
+    if (!HandleInternalMessage(*m))
+      return false;
+  } else {
+    listener_->OnMessageReceived(*m);
+  }
+  return true;
+}
+
 bool ChannelReader::DispatchInputData(const char* input_data,
                                       int input_data_len) {
   const char* p;
@@ -70,24 +105,8 @@ bool ChannelReader::DispatchInputData(const char* input_data,
     if (message_tail) {
       int len = static_cast<int>(message_tail - p);
       Message m(p, len);
-      if (!WillDispatchInputMessage(&m))
+      if (!DispatchInputMessage(&m))
         return false;
-
-#ifdef IPC_MESSAGE_LOG_ENABLED
-      Logging* logger = Logging::GetInstance();
-      std::string name;
-      logger->GetMessageText(m.type(), &name, &m, NULL);
-      TRACE_EVENT1("ipc", "ChannelReader::DispatchInputData", "name", name);
-#else
-      TRACE_EVENT2("ipc", "ChannelReader::DispatchInputData",
-                   "class", IPC_MESSAGE_ID_CLASS(m.type()),
-                   "line", IPC_MESSAGE_ID_LINE(m.type()));
-#endif
-      m.TraceMessageEnd();
-      if (IsHelloMessage(m))
-        HandleHelloMessage(m);
-      else
-        listener_->OnMessageReceived(m);
       p = message_tail;
     } else {
       // Last message is partial.
@@ -79,6 +79,19 @@ class ChannelReader {
   // Handles the first message sent over the pipe which contains setup info.
   virtual void HandleHelloMessage(const Message& msg) = 0;
 
+  // Returns true if the given message, other than the "hello" message, is
+  // meant for the channel implementation rather than the listener.
+  virtual bool IsInternalMessage(const Message& m) const;
+
+  // Handles a message for which IsInternalMessage() is true. Returns false
+  // on channel error.
+  virtual bool HandleInternalMessage(const Message& msg);
+
+  // Passes a complete message to WillDispatchInputMessage() and dispatches it.
+  // Implementations that receive messages other than through ReadData() use
+  // this to dispatch them. Returns false on channel error.
+  bool DispatchInputMessage(Message* m);
+
  private:
   // Takes the given data received from the IPC channel and dispatches any
   // fully completed messages.
@@ -9,18 +9,21 @@
 #endif
 
 #include <string>
+#include <vector>
 
 #include "base/message_loop/message_loop.h"
 #include "base/pickle.h"
 #include "base/threading/thread.h"
+#include "ipc/ipc_channel_proxy.h"
 #include "ipc/ipc_message.h"
+#include "ipc/ipc_message_macros.h"
 #include "ipc/ipc_test_base.h"
 
 namespace {
 
 const size_t kLongMessageStringNumBytes = 50000;
 
-static void Send(IPC::Sender* sender, const char* text) {
+static IPC::Message* CreateMessage(const char* text) {
   static int message_index = 0;
 
   IPC::Message* message = new IPC::Message(0,
@@ -34,9 +37,12 @@ static void Send(IPC::Sender* sender, const char* text) {
   memset(junk, 'a', sizeof(junk)-1);
   junk[sizeof(junk)-1] = 0;
   message->WriteString(std::string(junk));
+  return message;
+}
 
+static void Send(IPC::Sender* sender, const char* text) {
   // DEBUG: printf("[%u] sending message [%s]\n", GetCurrentProcessId(), text);
-  sender->Send(message);
+  sender->Send(CreateMessage(text));
 }
 
 // A generic listener that expects messages of a certain type (see
@@ -142,6 +148,33 @@ TEST_F(IPCChannelTest, ChannelTest) {
   DestroyChannel();
 }
 
+// Messages sent together keep their order and are split up on the other side.
+TEST_F(IPCChannelTest, SendMessagesTest) {
+  Init("GenericClient");
+
+  // Set up IPC channel and start client.
+  GenericChannelListener listener;
+  CreateChannel(&listener);
+  listener.Init(sender());
+  ASSERT_TRUE(ConnectChannel());
+  ASSERT_TRUE(StartClient());
+
+  // Each message starts its own ping-pong with the client.
+  std::vector<IPC::Message*> messages;
+  for (int i = 0; i < 5; ++i)
+    messages.push_back(CreateMessage("hello from parent"));
+  EXPECT_TRUE(channel()->SendMessages(messages));
+
+  // Run message loop.
+  base::MessageLoop::current()->Run();
+
+  // Close the channel so the client's OnChannelError() gets fired.
+  channel()->Close();
+
+  EXPECT_TRUE(WaitForClientShutdown());
+  DestroyChannel();
+}
+
 // TODO(viettrungluu): Move to a separate IPCChannelWinTest.
 #if defined(OS_WIN)
 TEST_F(IPCChannelTest, ChannelTestExistingPipe) {
@@ -209,6 +242,85 @@ TEST_F(IPCChannelTest, ChannelProxyTest) {
   thread.Stop();
 }
 
+// Fails the test if it gets any message.
+class UnexpectedMessageListener : public IPC::Listener {
+ public:
+  virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE {
+    ADD_FAILURE() << "Message of type " << message.type() << " not routed";
+    return true;
+  }
+};
+
+// Plays a few rounds of ping-pong with the client on the thread of
+// |task_runner|, then removes its route and quits |quit_loop|.
+class RoutedChannelListener : public IPC::Listener {
+ public:
+  RoutedChannelListener(IPC::ChannelProxy* proxy,
+                        base::SingleThreadTaskRunner* task_runner,
+                        base::MessageLoop* quit_loop)
+      : proxy_(proxy),
+        task_runner_(task_runner),
+        quit_loop_(quit_loop),
+        messages_left_(10) {}
+
+  virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE {
+    EXPECT_TRUE(task_runner_->BelongsToCurrentThread());
+    if (--messages_left_ > 0) {
+      Send(proxy_, "Foo");
+    } else {
+      proxy_->RemoveMessageClassRoute(IPC_MESSAGE_ID_CLASS(message.type()));
+      quit_loop_->PostTask(FROM_HERE, base::MessageLoop::QuitClosure());
+    }
+    return true;
+  }
+
+ private:
+  IPC::ChannelProxy* proxy_;
+  scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
+  base::MessageLoop* quit_loop_;
+  int messages_left_;
+};
+
+TEST_F(IPCChannelTest, ChannelProxyMessageClassRouteTest) {
+  Init("GenericClient");
+
+  base::Thread thread("ChannelProxyTestServer");
+  base::Thread::Options options;
+  options.message_loop_type = base::MessageLoop::TYPE_IO;
+  thread.StartWithOptions(options);
+  base::Thread route_thread("ChannelProxyTestRoute");
+  route_thread.Start();
+
+  // Set up IPC channel proxy, with the test messages routed to
+  // |route_thread|.
+  UnexpectedMessageListener listener;
+  CreateChannelProxy(&listener, thread.message_loop_proxy().get());
+  RoutedChannelListener routed_listener(
+      channel_proxy(), route_thread.message_loop_proxy().get(),
+      base::MessageLoop::current());
+  scoped_ptr<IPC::Message> message(CreateMessage("hello from parent"));
+  channel_proxy()->AddMessageClassRoute(
+      IPC_MESSAGE_ID_CLASS(message->type()), &routed_listener,
+      route_thread.message_loop_proxy().get());
+
+  ASSERT_TRUE(StartClient());
+
+  sender()->Send(message.release());
+
+  // Run message loop.
+  base::MessageLoop::current()->Run();
+
+  // Close the channel so the client's OnChannelError() gets fired.
+  channel_proxy()->Close();
+
+  EXPECT_TRUE(WaitForClientShutdown());
+
+  // Destroy the channel proxy before shutting down the threads.
+  DestroyChannelProxy();
+  route_thread.Stop();
+  thread.Stop();
+}
+
 class ChannelListenerWithOnConnectedSend : public GenericChannelListener {
  public:
   ChannelListenerWithOnConnectedSend() {}
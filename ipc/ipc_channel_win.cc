@@ -90,6 +90,8 @@ bool Channel::ChannelImpl::Send(Message* message) {
   Logging::GetInstance()->OnSendMessage(message, "");
 #endif
 
+  // Overlapped writes take a single buffer, so gather any external data now.
+  message->Flatten();
   message->TraceMessageBegin();
   output_queue_.push(message);
   // ensure waiting to write
@@ -489,6 +491,15 @@ bool Channel::Send(Message* message) {
   return channel_impl_->Send(message);
 }
 
+bool Channel::SendMessages(const std::vector<Message*>& messages) {
+  // Every message is handed over, even after a failure, since the channel
+  // owns them all.
+  bool result = true;
+  for (size_t i = 0; i < messages.size(); ++i)
+    result &= channel_impl_->Send(messages[i]);
+  return result;
+}
+
 // static
 bool Channel::IsNamedServerInitialized(const std::string& channel_id) {
   return ChannelImpl::IsNamedServerInitialized(channel_id);
@@ -122,6 +122,10 @@ void Logging::OnSendMessage(Message* message, const std::string& channel_id) {
   if (!Enabled())
     return;
 
+  // Logging reads and appends to the message, both of which need its payload
+  // to be contiguous.
+  message->Flatten();
+
   if (message->is_reply()) {
     LogData* data = message->sync_log_data();
     if (!data)
@@ -154,6 +154,10 @@
 // less typical case where the enum must be in the range minvalue..maxvalue
 // inclusive.
 //
+// Plain structs that can be sent as a copy of their memory are registered
+// with a single IPC_POD_TRAITS() macro instead of IPC_STRUCT_TRAITS_BEGIN();
+// see PodParamTraits in ipc_message_utils.h for the requirements.
+//
 // Do not place semicolons following these IPC_ macro invocations.  There
 // is no reason to expect that their expansion corresponds one-to-one with
 // C++ statements.
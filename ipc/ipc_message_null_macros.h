@@ -14,6 +14,7 @@
 #undef IPC_STRUCT_TRAITS_PARENT
 #undef IPC_STRUCT_TRAITS_END
 #undef IPC_ENUM_TRAITS_VALIDATE
+#undef IPC_POD_TRAITS
 #undef IPC_MESSAGE_DECL
 
 #define IPC_STRUCT_BEGIN_WITH_PARENT(struct_name, parent)
@@ -24,6 +25,7 @@
 #define IPC_STRUCT_TRAITS_PARENT(type)
 #define IPC_STRUCT_TRAITS_END()
 #define IPC_ENUM_TRAITS_VALIDATE(enum_name, validation_expression)
+#define IPC_POD_TRAITS(type)
 #define IPC_MESSAGE_DECL(sync, kind, msg_class, \
                          in_cnt, out_cnt, in_list, out_list)
 
@@ -5,6 +5,8 @@
 #ifndef IPC_IPC_MESSAGE_UTILS_H_
 #define IPC_IPC_MESSAGE_UTILS_H_
 
+#include <string.h>
+
 #include <algorithm>
 #include <map>
 #include <set>
@@ -298,8 +300,38 @@ struct IPC_EXPORT ParamTraits<std::vector<bool> > {
   static void Log(const param_type& p, std::string* l);
 };
 
+// Plain struct ParamTraits ---------------------------------------------------
+
+// Structs registered with IPC_POD_TRAITS() are sent as a copy of their memory,
+// with a single memcpy instead of a WriteParam() per member, and vectors of
+// them are copied in bulk. This only suits trivially copyable structs without
+// pointers or padding, for which every bit pattern is a valid value: nothing
+// checks what the receiver gets.
+template <class P>
+struct IsPodParam {
+  static const bool value = false;
+};
+
 template <class P>
-struct ParamTraits<std::vector<P> > {
+struct PodParamTraits {
+  typedef P param_type;
+  static void Write(Message* m, const param_type& p) {
+    m->WriteBytes(&p, sizeof(p));
+  }
+  static bool Read(const Message* m, PickleIterator* iter, param_type* r) {
+    const char* data;
+    if (!m->ReadBytes(iter, &data, sizeof(*r)))
+      return false;
+    memcpy(r, data, sizeof(*r));
+    return true;
+  }
+  static void Log(const param_type& p, std::string* l) {
+    l->append(base::StringPrintf("<%" PRIuS " bytes>", sizeof(p)));
+  }
+};
+
+template <class P, bool is_pod = IsPodParam<P>::value>
+struct VectorParamTraits {
   typedef std::vector<P> param_type;
   static void Write(Message* m, const param_type& p) {
     WriteParam(m, static_cast<int>(p.size()));
@@ -331,6 +363,45 @@ struct ParamTraits<std::vector<P> > {
   }
 };
 
+// Vectors of plain structs are copied in one go.
+template <class P>
+struct VectorParamTraits<P, true> {
+  typedef std::vector<P> param_type;
+  static void Write(Message* m, const param_type& p) {
+    WriteParam(m, static_cast<int>(p.size()));
+    if (!p.empty())
+      m->WriteBytes(&p[0], static_cast<int>(p.size() * sizeof(P)));
+  }
+  static bool Read(const Message* m, PickleIterator* iter,
+                   param_type* r) {
+    int size;
+    // ReadLength() checks for < 0 itself.
+    if (!m->ReadLength(iter, &size))
+      return false;
+    if (INT_MAX / sizeof(P) <= static_cast<size_t>(size))
+      return false;
+    r->clear();
+    if (size == 0)
+      return true;
+    const char* data;
+    // Unlike the members of other vectors, the data is checked before the
+    // vector is resized.
+    if (!m->ReadBytes(iter, &data, size * static_cast<int>(sizeof(P))))
+      return false;
+    r->resize(size);
+    memcpy(&(*r)[0], data, size * sizeof(P));
+    return true;
+  }
+  static void Log(const param_type& p, std::string* l) {
+    l->append(base::StringPrintf("<%" PRIuS " x %" PRIuS " bytes>",
+                                 p.size(), sizeof(P)));
+  }
+};
+
+template <class P>
+struct ParamTraits<std::vector<P> > : VectorParamTraits<P> {
+};
+
 template <class P>
 struct ParamTraits<std::set<P> > {
   typedef std::set<P> param_type;
@@ -6,8 +6,21 @@
 
 #include "base/files/file_path.h"
 #include "ipc/ipc_message.h"
+#include "ipc/param_traits_macros.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+namespace {
+
+struct PodTestStruct {
+  int32 x;
+  int32 y;
+  double z;
+};
+
+}  // namespace
+
+IPC_POD_TRAITS(PodTestStruct)
+
 namespace IPC {
 namespace {
 
@@ -70,5 +83,50 @@ TEST(IPCMessageUtilsTest, ParameterValidation) {
   ASSERT_FALSE(ParamTraits<base::FilePath>::Read(&message, &iter, &bad_path));
 }
 
+TEST(IPCMessageUtilsTest, PodParam) {
+  PodTestStruct input = { 1, -2, 3.5 };
+  Message message;
+  WriteParam(&message, input);
+  EXPECT_EQ(sizeof(input), message.payload_size());
+
+  PickleIterator iter(message);
+  PodTestStruct output;
+  ASSERT_TRUE(ReadParam(&message, &iter, &output));
+  EXPECT_EQ(0, memcmp(&input, &output, sizeof(input)));
+  EXPECT_FALSE(ReadParam(&message, &iter, &output));
+}
+
+TEST(IPCMessageUtilsTest, PodParamVector) {
+  std::vector<PodTestStruct> input(100);
+  for (size_t i = 0; i < input.size(); ++i) {
+    PodTestStruct element = { static_cast<int32>(i), 2, i * 0.5 };
+    input[i] = element;
+  }
+  Message message;
+  WriteParam(&message, input);
+  WriteParam(&message, std::vector<PodTestStruct>());
+
+  PickleIterator iter(message);
+  std::vector<PodTestStruct> output(3);
+  ASSERT_TRUE(ReadParam(&message, &iter, &output));
+  ASSERT_EQ(input.size(), output.size());
+  EXPECT_EQ(0, memcmp(&input[0], &output[0], input.size() * sizeof(input[0])));
+  ASSERT_TRUE(ReadParam(&message, &iter, &output));
+  EXPECT_TRUE(output.empty());
+}
+
+TEST(IPCMessageUtilsTest, PodParamVectorTooShort) {
+  // A length with fewer elements behind it than it claims.
+  Message message;
+  WriteParam(&message, 100);
+  PodTestStruct element = { 1, 2, 3.0 };
+  WriteParam(&message, element);
+
+  PickleIterator iter(message);
+  std::vector<PodTestStruct> output;
+  EXPECT_FALSE(ReadParam(&message, &iter, &output));
+  EXPECT_TRUE(output.empty());
+}
+
 }  // namespace
 }  // namespace IPC
@@ -4,8 +4,11 @@
 
 #include "build/build_config.h"
 
+#include <string.h>
+
 #include <algorithm>
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/logging.h"
@@ -21,6 +24,80 @@
 #include "ipc/ipc_message_utils.h"
 #include "ipc/ipc_sender.h"
 #include "ipc/ipc_test_base.h"
+#include "ipc/param_traits_macros.h"
+
+namespace {
+
+// A struct shaped like a mouse event, serialized member by member the way
+// IPC_STRUCT_TRAITS_MEMBER() does it.
+struct FieldwiseEvent {
+  int32 type;
+  int32 modifiers;
+  double time_stamp;
+  int32 x;
+  int32 y;
+  int32 window_x;
+  int32 window_y;
+  int32 global_x;
+  int32 global_y;
+  int32 click_count;
+  int32 button;
+};
+
+// The same struct, sent as a copy of its memory.
+struct PodEvent {
+  int32 type;
+  int32 modifiers;
+  double time_stamp;
+  int32 x;
+  int32 y;
+  int32 window_x;
+  int32 window_y;
+  int32 global_x;
+  int32 global_y;
+  int32 click_count;
+  int32 button;
+};
+
+}  // namespace
+
+namespace IPC {
+
+template <>
+struct ParamTraits<FieldwiseEvent> {
+  typedef FieldwiseEvent param_type;
+  static void Write(Message* m, const param_type& p) {
+    WriteParam(m, p.type);
+    WriteParam(m, p.modifiers);
+    WriteParam(m, p.time_stamp);
+    WriteParam(m, p.x);
+    WriteParam(m, p.y);
+    WriteParam(m, p.window_x);
+    WriteParam(m, p.window_y);
+    WriteParam(m, p.global_x);
+    WriteParam(m, p.global_y);
+    WriteParam(m, p.click_count);
+    WriteParam(m, p.button);
+  }
+  static bool Read(const Message* m, PickleIterator* iter, param_type* p) {
+    return ReadParam(m, iter, &p->type) &&
+           ReadParam(m, iter, &p->modifiers) &&
+           ReadParam(m, iter, &p->time_stamp) &&
+           ReadParam(m, iter, &p->x) &&
+           ReadParam(m, iter, &p->y) &&
+           ReadParam(m, iter, &p->window_x) &&
+           ReadParam(m, iter, &p->window_y) &&
+           ReadParam(m, iter, &p->global_x) &&
+           ReadParam(m, iter, &p->global_y) &&
+           ReadParam(m, iter, &p->click_count) &&
+           ReadParam(m, iter, &p->button);
+  }
+  static void Log(const param_type& p, std::string* l) {}
+};
+
+}  // namespace IPC
+
+IPC_POD_TRAITS(PodEvent)
 
 namespace {
 
@@ -29,6 +106,13 @@ namespace {
 // TODO(brettw): Make this test run by default.
 
 class IPCChannelPerfTest : public IPCTestBase {
+ protected:
+  // Bounces messages of various sizes off |client_name|, which must send
+  // through shared memory iff |use_shared_memory|. The results are logged
+  // under |label|.
+  void RunPerformanceTest(const char* client_name,
+                          const char* label,
+                          bool use_shared_memory);
 };
 
 // This class simply collects stats about abstract "events" (each of which has a
@@ -59,6 +143,10 @@ class EventTimeTracker {
             << max_duration_.InMillisecondsF() << " ms";
   }
 
+  base::TimeDelta average_duration() const {
+    return count_ ? total_duration_ / count_ : base::TimeDelta();
+  }
+
   void Reset() {
     count_ = 0;
     total_duration_ = base::TimeDelta();
@@ -137,8 +225,9 @@ class ChannelReflectorListener : public IPC::Listener {
 
 class PerformanceChannelListener : public IPC::Listener {
  public:
-  PerformanceChannelListener()
-      : channel_(NULL),
+  explicit PerformanceChannelListener(const char* label)
+      : label_(label),
+        channel_(NULL),
         msg_count_(0),
         msg_size_(0),
         count_down_(0),
@@ -182,9 +271,9 @@ class PerformanceChannelListener : public IPC::Listener {
       // Start timing on hello.
       latency_tracker_.Reset();
       DCHECK(!perf_logger_.get());
-      std::string test_name = base::StringPrintf(
-          "IPC_Perf_%dx_%u", msg_count_, static_cast<unsigned>(msg_size_));
-      perf_logger_.reset(new PerfTimeLogger(test_name.c_str()));
+      test_name_ = base::StringPrintf("%s_%dx_%u", label_, msg_count_,
+                                      static_cast<unsigned>(msg_size_));
+      perf_logger_.reset(new PerfTimeLogger(test_name_.c_str()));
     } else {
       DCHECK_EQ(payload_.size(), reflected_payload.size());
 
@@ -196,6 +285,9 @@ class PerformanceChannelListener : public IPC::Listener {
       if (count_down_ == 0) {
         perf_logger_.reset();  // Stop the perf timer now.
         latency_tracker_.ShowResults();
+        LogPerfResult((test_name_ + "_latency").c_str(),
+                      latency_tracker_.average_duration().InMicroseconds(),
+                      "us");
         base::MessageLoop::current()->QuitWhenIdle();
         return true;
       }
@@ -210,23 +302,31 @@ class PerformanceChannelListener : public IPC::Listener {
   }
 
  private:
+  const char* label_;
   IPC::Channel* channel_;
   int msg_count_;
   size_t msg_size_;
 
   int count_down_;
   std::string payload_;
+  std::string test_name_;
   EventTimeTracker latency_tracker_;
   scoped_ptr<PerfTimeLogger> perf_logger_;
 };
 
-TEST_F(IPCChannelPerfTest, Performance) {
-  Init("PerformanceClient");
+void IPCChannelPerfTest::RunPerformanceTest(const char* client_name,
+                                            const char* label,
+                                            bool use_shared_memory) {
+  Init(client_name);
 
   // Set up IPC channel and start client.
-  PerformanceChannelListener listener;
+  PerformanceChannelListener listener(label);
   CreateChannel(&listener);
   listener.Init(channel());
+#if defined(OS_POSIX)
+  if (use_shared_memory)
+    channel()->EnableSharedMemoryTransport();
+#endif
   ASSERT_TRUE(ConnectChannel());
   ASSERT_TRUE(StartClient());
 
@@ -262,18 +362,79 @@ TEST_F(IPCChannelPerfTest, Performance) {
   DestroyChannel();
 }
 
+TEST_F(IPCChannelPerfTest, Performance) {
+  RunPerformanceTest("PerformanceClient", "IPC_Perf", false);
+}
+
+#if defined(OS_POSIX)
+// Compare with Performance: messages that fit into the ring go through shared
+// memory in both directions.
+TEST_F(IPCChannelPerfTest, SharedMemoryPerformance) {
+  RunPerformanceTest("SharedMemoryPerformanceClient", "IPC_SharedMemory_Perf",
+                     true);
+}
+#endif
+
+// Times writing and reading back |count| messages that each carry a vector of
+// |vector_size| Events.
+template <class Event>
+void RunParamTraitsPerformanceTest(const char* label,
+                                   int count,
+                                   size_t vector_size) {
+  Event event;
+  memset(&event, 0, sizeof(event));
+  std::vector<Event> events(vector_size, event);
+  std::vector<Event> read_events;
+  std::string test_name = base::StringPrintf(
+      "%s_%dx_%u", label, count, static_cast<unsigned>(vector_size));
+  PerfTimeLogger logger(test_name.c_str());
+  for (int i = 0; i < count; ++i) {
+    IPC::Message message(0, 2, IPC::Message::PRIORITY_NORMAL);
+    IPC::WriteParam(&message, events);
+    PickleIterator iter(message);
+    CHECK(IPC::ReadParam(&message, &iter, &read_events));
+  }
+}
+
+// Compares field by field serialization with IPC_POD_TRAITS(), for single
+// events and for lists of them.
+TEST(IPCParamTraitsPerfTest, PodTraits) {
+  const size_t kVectorSizes[] = { 1, 100, 10000 };
+  for (size_t i = 0; i < arraysize(kVectorSizes); ++i) {
+    int count = static_cast<int>(1000000 / kVectorSizes[i]);
+    RunParamTraitsPerformanceTest<FieldwiseEvent>(
+        "IPC_ParamTraits_Fieldwise", count, kVectorSizes[i]);
+    RunParamTraitsPerformanceTest<PodEvent>(
+        "IPC_ParamTraits_Pod", count, kVectorSizes[i]);
+  }
+}
+
 // This message loop bounces all messages back to the sender.
-MULTIPROCESS_IPC_TEST_CLIENT_MAIN(PerformanceClient) {
+int RunPerformanceClient(const char* client_name, bool use_shared_memory) {
   base::MessageLoopForIO main_message_loop;
   ChannelReflectorListener listener;
-  IPC::Channel channel(IPCTestBase::GetChannelName("PerformanceClient"),
+  IPC::Channel channel(IPCTestBase::GetChannelName(client_name),
                        IPC::Channel::MODE_CLIENT,
                        &listener);
   listener.Init(&channel);
+#if defined(OS_POSIX)
+  if (use_shared_memory)
+    channel.EnableSharedMemoryTransport();
+#endif
   CHECK(channel.Connect());
 
   base::MessageLoop::current()->Run();
   return 0;
 }
 
+MULTIPROCESS_IPC_TEST_CLIENT_MAIN(PerformanceClient) {
+  return RunPerformanceClient("PerformanceClient", false);
+}
+
+#if defined(OS_POSIX)
+MULTIPROCESS_IPC_TEST_CLIENT_MAIN(SharedMemoryPerformanceClient) {
+  return RunPerformanceClient("SharedMemoryPerformanceClient", true);
+}
+#endif
+
 }  // namespace
@@ -0,0 +1,269 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/message_ring_posix.h"
+
+#include <string.h>
+#include <sys/stat.h>
+
+#include <vector>
+
+#include "base/logging.h"
+#include "ipc/ipc_message.h"
+
+namespace IPC {
+namespace internal {
+
+namespace {
+
+// Keeps the writer's and the reader's parts of the header on separate cache
+// lines, so that moving one position doesn't slow down the other side.
+const size_t kCacheLineSize = 64;
+
+// The largest ring a reader agrees to map.
+const size_t kMaxCapacity = 64 * 1024 * 1024;
+
+// Every record starts with a RecordHeader and is padded to kRecordAlignment
+// bytes, which keeps the headers aligned.
+const size_t kRecordAlignment = 8;
+
+enum RecordType {
+  // Fills the end of the ring when the next record doesn't fit there.
+  RECORD_PADDING = 1,
+  RECORD_MESSAGE = 2,
+  RECORD_DIVERT = 3
+};
+
+struct RecordHeader {
+  uint32 payload_size;
+  uint32 type;
+};
+
+COMPILE_ASSERT(sizeof(RecordHeader) == kRecordAlignment,
+               record_header_must_be_aligned);
+
+size_t RecordSize(size_t payload_size) {
+  return (sizeof(RecordHeader) + payload_size + kRecordAlignment - 1) &
+         ~(kRecordAlignment - 1);
+}
+
+bool IsPowerOfTwo(size_t value) {
+  return value != 0 && (value & (value - 1)) == 0;
+}
+
+}  // namespace
+
+struct MessageRing::Header {
+  // Owned by the writer.
+  volatile base::subtle::Atomic32 write_position;
+  volatile base::subtle::Atomic32 writer_waiting;
+  char padding0[kCacheLineSize - 2 * sizeof(base::subtle::Atomic32)];
+
+  // Owned by the reader.
+  volatile base::subtle::Atomic32 read_position;
+  volatile base::subtle::Atomic32 reader_waiting;
+  char padding1[kCacheLineSize - 2 * sizeof(base::subtle::Atomic32)];
+};
+
+MessageRing::MessageRing(scoped_ptr<base::SharedMemory> shared_memory,
+                         size_t capacity)
+    : shared_memory_(shared_memory.Pass()),
+      capacity_(capacity),
+      header_(static_cast<Header*>(shared_memory_->memory())),
+      data_(static_cast<char*>(shared_memory_->memory()) + sizeof(Header)),
+      position_(0) {
+}
+
+MessageRing::~MessageRing() {
+}
+
+// static
+scoped_ptr<MessageRing> MessageRing::Create(size_t capacity) {
+  DCHECK(IsPowerOfTwo(capacity));
+  DCHECK_LE(capacity, kMaxCapacity);
+  scoped_ptr<base::SharedMemory> shared_memory(new base::SharedMemory);
+  // Fresh shared memory is zero-filled, which is the initial state of the
+  // header.
+  if (!shared_memory->CreateAndMapAnonymous(sizeof(Header) + capacity)) {
+    LOG(ERROR) << "Unable to create a message ring";
+    return scoped_ptr<MessageRing>();
+  }
+  return scoped_ptr<MessageRing>(
+      new MessageRing(shared_memory.Pass(), capacity));
+}
+
+// static
+scoped_ptr<MessageRing> MessageRing::Open(
+    const base::SharedMemoryHandle& handle,
+    size_t capacity) {
+  scoped_ptr<base::SharedMemory> shared_memory(
+      new base::SharedMemory(handle, false));
+  if (!IsPowerOfTwo(capacity) || capacity > kMaxCapacity)
+    return scoped_ptr<MessageRing>();
+#if !defined(OS_ANDROID)
+  // Touching a mapping beyond the end of the file raises SIGBUS, so make sure
+  // the peer didn't send a smaller one.
+  struct stat st;
+  if (fstat(handle.fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(Header) + capacity) {
+    return scoped_ptr<MessageRing>();
+  }
+#endif
+  if (!shared_memory->Map(sizeof(Header) + capacity))
+    return scoped_ptr<MessageRing>();
+  scoped_ptr<MessageRing> ring(new MessageRing(shared_memory.Pass(), capacity));
+  ring->position_ = base::subtle::NoBarrier_Load(&ring->header_->read_position);
+  return ring.Pass();
+}
+
+bool MessageRing::WriteMessage(const Message& message) {
+  DCHECK(CanWrite(message.size()));
+  char* payload = BeginRecord(RECORD_MESSAGE, message.size());
+  if (!payload)
+    return false;
+  std::vector<Pickle::Segment> segments;
+  message.GetSegments(&segments);
+  for (size_t i = 0; i < segments.size(); ++i) {
+    memcpy(payload, segments[i].data, segments[i].size);
+    payload += segments[i].size;
+  }
+  CommitRecord(message.size());
+  return true;
+}
+
+bool MessageRing::WriteDivert() {
+  if (!BeginRecord(RECORD_DIVERT, 0))
+    return false;
+  CommitRecord(0);
+  return true;
+}
+
+bool MessageRing::WaitForSpace(size_t size) {
+  base::subtle::NoBarrier_Store(&header_->writer_waiting, 1);
+  // Order the store of the flag before the load of the read position; the
+  // reader does the opposite in Advance() and TakeWriterWakeup().
+  base::subtle::MemoryBarrier();
+  if (!HasSpaceFor(RecordSize(size)))
+    return true;
+  base::subtle::NoBarrier_Store(&header_->writer_waiting, 0);
+  return false;
+}
+
+bool MessageRing::TakeReaderWakeup() {
+  base::subtle::MemoryBarrier();
+  if (!base::subtle::NoBarrier_Load(&header_->reader_waiting))
+    return false;
+  return base::subtle::NoBarrier_AtomicExchange(&header_->reader_waiting,
+                                                0) != 0;
+}
+
+MessageRing::ReadResult MessageRing::Read(std::string* message) {
+  while (true) {
+    uint32 write_position =
+        base::subtle::Acquire_Load(&header_->write_position);
+    if (write_position == position_)
+      return READ_EMPTY;
+
+    // The writer only publishes whole records. Everything below is read from
+    // memory the writer can still change, so it is read once and checked.
+    size_t available = write_position - position_;
+    size_t offset = position_ & (capacity_ - 1);
+    size_t to_end = capacity_ - offset;
+    if (available > capacity_ || available < sizeof(RecordHeader))
+      return READ_ERROR;
+    RecordHeader record;
+    memcpy(&record, data_ + offset, sizeof(record));
+    if (record.payload_size > to_end - sizeof(RecordHeader))
+      return READ_ERROR;
+    size_t record_size = RecordSize(record.payload_size);
+    if (record_size > available)
+      return READ_ERROR;
+
+    switch (record.type) {
+      case RECORD_PADDING:
+        if (record_size != to_end)
+          return READ_ERROR;
+        Advance(record_size);
+        continue;
+      case RECORD_MESSAGE:
+        message->assign(data_ + offset + sizeof(RecordHeader),
+                        record.payload_size);
+        Advance(record_size);
+        return READ_MESSAGE;
+      case RECORD_DIVERT:
+        if (record.payload_size != 0)
+          return READ_ERROR;
+        Advance(record_size);
+        return READ_DIVERT;
+      default:
+        return READ_ERROR;
+    }
+  }
+}
+
+bool MessageRing::WaitForData() {
+  base::subtle::NoBarrier_Store(&header_->reader_waiting, 1);
+  // Order the store of the flag before the load of the write position; the
+  // writer does the opposite in CommitRecord() and TakeReaderWakeup().
+  base::subtle::MemoryBarrier();
+  if (base::subtle::Acquire_Load(&header_->write_position) == position_)
+    return true;
+  base::subtle::NoBarrier_Store(&header_->reader_waiting, 0);
+  return false;
+}
+
+bool MessageRing::TakeWriterWakeup() {
+  base::subtle::MemoryBarrier();
+  if (!base::subtle::NoBarrier_Load(&header_->writer_waiting))
+    return false;
+  return base::subtle::NoBarrier_AtomicExchange(&header_->writer_waiting,
+                                                0) != 0;
+}
+
+bool MessageRing::HasSpaceFor(size_t record_size) const {
+  uint32 read_position = base::subtle::Acquire_Load(&header_->read_position);
+  size_t used = position_ - read_position;
+  size_t to_end = capacity_ - (position_ & (capacity_ - 1));
+  size_t needed = record_size <= to_end ? record_size : to_end + record_size;
+  return used <= capacity_ && needed <= capacity_ - used;
+}
+
+char* MessageRing::BeginRecord(uint32 type, size_t payload_size) {
+  size_t record_size = RecordSize(payload_size);
+  if (!HasSpaceFor(record_size))
+    return NULL;
+
+  size_t offset = position_ & (capacity_ - 1);
+  size_t to_end = capacity_ - offset;
+  if (record_size > to_end) {
+    // Pad out the end of the ring; the record starts over at the beginning.
+    // The padding is published along with the record.
+    RecordHeader padding = {
+      static_cast<uint32>(to_end - sizeof(RecordHeader)), RECORD_PADDING
+    };
+    memcpy(data_ + offset, &padding, sizeof(padding));
+    position_ += to_end;
+    offset = 0;
+  }
+  RecordHeader record = { static_cast<uint32>(payload_size), type };
+  memcpy(data_ + offset, &record, sizeof(record));
+  return data_ + offset + sizeof(RecordHeader);
+}
+
+void MessageRing::CommitRecord(size_t payload_size) {
+  position_ += RecordSize(payload_size);
+  base::subtle::Release_Store(&header_->write_position,
+                              static_cast<base::subtle::Atomic32>(position_));
+}
+
+void MessageRing::Advance(size_t record_size) {
+  // The release store also keeps the writer from reusing the space before the
+  // record has been copied out.
+  position_ += record_size;
+  base::subtle::Release_Store(&header_->read_position,
+                              static_cast<base::subtle::Atomic32>(position_));
+}
+
+}  // namespace internal
+}  // namespace IPC
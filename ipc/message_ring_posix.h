@@ -0,0 +1,143 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IPC_MESSAGE_RING_POSIX_H_
+#define IPC_MESSAGE_RING_POSIX_H_
+
+#include <string>
+
+#include "base/atomicops.h"
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/shared_memory.h"
+#include "ipc/ipc_export.h"
+
+namespace IPC {
+
+class Message;
+
+namespace internal {
+
+// A single-producer, single-consumer ring of IPC messages in shared memory,
+// which lets Channel move messages between processes without a system call
+// per message. One end of a channel creates the ring and writes into it; the
+// other end maps it and reads from it.
+//
+// The ring only moves bytes; it never blocks. Each side instead flags when it
+// is about to wait for the other one, and the other side checks the flag
+// after it has made progress and wakes the waiter out of band. Checking and
+// clearing the flags with Take*Wakeup() after every write or read, and only
+// waiting when Wait*() says so, guarantees that no wakeup is lost.
+//
+// Records never wrap around the end of the ring, so every message is
+// contiguous in memory. The reader copies each message out before parsing it,
+// since the writer, which may be less trusted, can still modify the ring.
+class IPC_EXPORT MessageRing {
+ public:
+  // The default capacity, in bytes, of a ring's data area.
+  static const size_t kDefaultCapacity = 512 * 1024;
+
+  enum ReadResult {
+    // Nothing to read.
+    READ_EMPTY,
+    // A message was read.
+    READ_MESSAGE,
+    // The writer sent its next message some other way; see WriteDivert().
+    READ_DIVERT,
+    // The ring is corrupt. The reader must stop using it.
+    READ_ERROR
+  };
+
+  ~MessageRing();
+
+  // Creates a ring with a data area of |capacity| bytes, which must be a
+  // power of two, to be written by the caller. Returns NULL on failure.
+  static scoped_ptr<MessageRing> Create(size_t capacity);
+
+  // Maps the ring with a data area of |capacity| bytes in the shared memory
+  // |handle|, created by the peer with Create(), to be read by the caller.
+  // Takes ownership of |handle|. Returns NULL if the memory can't hold such a
+  // ring.
+  static scoped_ptr<MessageRing> Open(const base::SharedMemoryHandle& handle,
+                                      size_t capacity);
+
+  // The shared memory to hand to the reader. Owned by the ring.
+  base::SharedMemoryHandle handle() const { return shared_memory_->handle(); }
+
+  size_t capacity() const { return capacity_; }
+
+  // Returns true if a message of |size| bytes may be written at all. Larger
+  // messages have to be sent some other way.
+  bool CanWrite(size_t size) const { return size <= capacity_ / 4; }
+
+  // Writer side ---------------------------------------------------------------
+
+  // Copies |message| into the ring. Returns false if there isn't enough free
+  // space at the moment.
+  bool WriteMessage(const Message& message);
+
+  // Tells the reader to stop reading the ring until the writer's next message
+  // has arrived some other way, which keeps messages in order when some of
+  // them can't go through the ring. Returns false if the ring is full.
+  bool WriteDivert();
+
+  // Called after a write failed for lack of space, to wait until the reader
+  // has made room for a message of |size| bytes. Returns true if the writer
+  // should wait to be woken up, or false if there is room after all.
+  bool WaitForSpace(size_t size);
+
+  // Returns true, once, if the reader waits for data and should be woken up.
+  bool TakeReaderWakeup();
+
+  // Reader side ---------------------------------------------------------------
+
+  // Reads the next record. On READ_MESSAGE, the message is copied into
+  // |message|, whose storage is reused from one call to the next.
+  ReadResult Read(std::string* message);
+
+  // Called after Read() found the ring empty, to wait for the writer. Returns
+  // true if the reader should wait to be woken up, or false if data has
+  // arrived after all.
+  bool WaitForData();
+
+  // Returns true, once, if the writer waits for space and should be woken up.
+  bool TakeWriterWakeup();
+
+ private:
+  struct Header;
+
+  MessageRing(scoped_ptr<base::SharedMemory> shared_memory, size_t capacity);
+
+  // Returns true if a record of |record_size| bytes fits into the free space,
+  // along with the padding needed to keep it from wrapping.
+  bool HasSpaceFor(size_t record_size) const;
+
+  // Reserves room for a record of |type| with |payload_size| bytes of payload
+  // and returns a pointer to the payload, or NULL if the ring is full. The
+  // record becomes visible to the reader with CommitRecord().
+  char* BeginRecord(uint32 type, size_t payload_size);
+  void CommitRecord(size_t payload_size);
+
+  // Moves the read position past a record of |record_size| bytes.
+  void Advance(size_t record_size);
+
+  scoped_ptr<base::SharedMemory> shared_memory_;
+  size_t capacity_;
+
+  // The shared state, followed by the data area.
+  Header* header_;
+  char* data_;
+
+  // This side's copy of its own position in the ring. Only the writer moves
+  // the write position and only the reader moves the read position, so they
+  // needn't be loaded back from shared memory.
+  uint32 position_;
+
+  DISALLOW_COPY_AND_ASSIGN(MessageRing);
+};
+
+}  // namespace internal
+}  // namespace IPC
+
+#endif  // IPC_MESSAGE_RING_POSIX_H_
@@ -0,0 +1,137 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/message_ring_posix.h"
+
+#include <unistd.h>
+
+#include <string>
+
+#include "base/pickle.h"
+#include "ipc/ipc_message.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace IPC {
+namespace internal {
+
+namespace {
+
+const size_t kCapacity = 4096;
+
+class MessageRingTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    writer_ = MessageRing::Create(kCapacity);
+    ASSERT_TRUE(writer_.get());
+    base::SharedMemoryHandle handle(dup(writer_->handle().fd), true);
+    reader_ = MessageRing::Open(handle, kCapacity);
+    ASSERT_TRUE(reader_.get());
+  }
+
+  static Message* CreateMessage(int id, size_t payload_size) {
+    Message* message = new Message(0, id, Message::PRIORITY_NORMAL);
+    message->WriteString(std::string(payload_size, 'a' + id % 26));
+    return message;
+  }
+
+  // Reads the next message and checks that it's |expected|.
+  void ExpectMessage(const Message& expected) {
+    std::string data;
+    ASSERT_EQ(MessageRing::READ_MESSAGE, reader_->Read(&data));
+    ASSERT_EQ(expected.size(), data.size());
+    Message message(data.data(), static_cast<int>(data.size()));
+    EXPECT_EQ(expected.type(), message.type());
+    EXPECT_EQ(0, memcmp(expected.data(), data.data(), data.size()));
+  }
+
+  scoped_ptr<MessageRing> writer_;
+  scoped_ptr<MessageRing> reader_;
+};
+
+TEST_F(MessageRingTest, ReadWrite) {
+  std::string data;
+  EXPECT_EQ(MessageRing::READ_EMPTY, reader_->Read(&data));
+
+  scoped_ptr<Message> first(CreateMessage(1, 10));
+  scoped_ptr<Message> second(CreateMessage(2, 100));
+  EXPECT_TRUE(writer_->WriteMessage(*first));
+  EXPECT_TRUE(writer_->WriteMessage(*second));
+  ExpectMessage(*first);
+  ExpectMessage(*second);
+  EXPECT_EQ(MessageRing::READ_EMPTY, reader_->Read(&data));
+}
+
+TEST_F(MessageRingTest, Divert) {
+  scoped_ptr<Message> first(CreateMessage(1, 10));
+  scoped_ptr<Message> second(CreateMessage(2, 10));
+  EXPECT_TRUE(writer_->WriteMessage(*first));
+  EXPECT_TRUE(writer_->WriteDivert());
+  EXPECT_TRUE(writer_->WriteMessage(*second));
+
+  std::string data;
+  ExpectMessage(*first);
+  EXPECT_EQ(MessageRing::READ_DIVERT, reader_->Read(&data));
+  ExpectMessage(*second);
+}
+
+// Messages keep their order, and stay contiguous, as the ring wraps around.
+TEST_F(MessageRingTest, WrapAround) {
+  for (int i = 0; i < 100; ++i) {
+    scoped_ptr<Message> message(CreateMessage(i, 300 + i * 7 % 400));
+    ASSERT_TRUE(writer_->WriteMessage(*message));
+    ExpectMessage(*message);
+  }
+}
+
+TEST_F(MessageRingTest, Full) {
+  scoped_ptr<Message> message(CreateMessage(1, 500));
+  ASSERT_TRUE(writer_->CanWrite(message->size()));
+  int written = 0;
+  while (writer_->WriteMessage(*message))
+    ++written;
+  EXPECT_GT(written, 1);
+  EXPECT_LT(static_cast<size_t>(written) * message->size(), kCapacity);
+
+  // The writer waits, and the reader wakes it up once it has made room.
+  EXPECT_FALSE(reader_->TakeWriterWakeup());
+  EXPECT_TRUE(writer_->WaitForSpace(message->size()));
+  ExpectMessage(*message);
+  EXPECT_TRUE(reader_->TakeWriterWakeup());
+  EXPECT_FALSE(reader_->TakeWriterWakeup());
+  EXPECT_TRUE(writer_->WriteMessage(*message));
+
+  // Room that's already there needs no waiting.
+  ExpectMessage(*message);
+  EXPECT_FALSE(writer_->WaitForSpace(message->size()));
+  EXPECT_FALSE(reader_->TakeWriterWakeup());
+}
+
+TEST_F(MessageRingTest, WaitForData) {
+  std::string data;
+  EXPECT_EQ(MessageRing::READ_EMPTY, reader_->Read(&data));
+  EXPECT_FALSE(writer_->TakeReaderWakeup());
+  EXPECT_TRUE(reader_->WaitForData());
+
+  scoped_ptr<Message> message(CreateMessage(1, 10));
+  EXPECT_TRUE(writer_->WriteMessage(*message));
+  EXPECT_TRUE(writer_->TakeReaderWakeup());
+  EXPECT_FALSE(writer_->TakeReaderWakeup());
+
+  // Data that's already there needs no waiting.
+  EXPECT_FALSE(reader_->WaitForData());
+  EXPECT_FALSE(writer_->TakeReaderWakeup());
+  ExpectMessage(*message);
+}
+
+TEST_F(MessageRingTest, BadCapacity) {
+  base::SharedMemoryHandle handle(dup(writer_->handle().fd), true);
+  EXPECT_FALSE(MessageRing::Open(handle, kCapacity * 2).get());
+  handle = base::SharedMemoryHandle(dup(writer_->handle().fd), true);
+  EXPECT_FALSE(MessageRing::Open(handle, kCapacity - 8).get());
+}
+
+}  // namespace
+
+}  // namespace internal
+}  // namespace IPC
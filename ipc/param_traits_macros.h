@@ -54,5 +54,18 @@
     }; \
   }
 
+// Traits for plain structs, which are sent as a copy of their memory; see
+// PodParamTraits in ipc_message_utils.h for what qualifies. The traits are
+// complete here, so the later passes null this macro out.
+#define IPC_POD_TRAITS(type) \
+  namespace IPC { \
+    template <> \
+    struct IsPodParam<type> { \
+      static const bool value = true; \
+    }; \
+    template <> \
+    struct ParamTraits<type> : PodParamTraits<type> {}; \
+  }
+
 #endif  // IPC_PARAM_TRAITS_MACROS_H_
 
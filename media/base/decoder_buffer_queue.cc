@@ -11,7 +11,8 @@
 namespace media {
 
 DecoderBufferQueue::DecoderBufferQueue()
-    : earliest_valid_timestamp_(kNoTimestamp()) {
+    : earliest_valid_timestamp_(kNoTimestamp()),
+      data_size_(0) {
 }
 
 DecoderBufferQueue::~DecoderBufferQueue() {}
@@ -20,6 +21,7 @@ void DecoderBufferQueue::Push(const scoped_refptr<DecoderBuffer>& buffer) {
   CHECK(!buffer->end_of_stream());
 
   queue_.push_back(buffer);
+  data_size_ += buffer->data_size();
 
   // TODO(scherkus): FFmpeg returns some packets with no timestamp after
   // seeking. Fix and turn this into CHECK(). See http://crbug.com/162192
@@ -48,6 +50,7 @@ void DecoderBufferQueue::Push(const scoped_refptr<DecoderBuffer>& buffer) {
 scoped_refptr<DecoderBuffer> DecoderBufferQueue::Pop() {
   scoped_refptr<DecoderBuffer> buffer = queue_.front();
   queue_.pop_front();
+  data_size_ -= buffer->data_size();
 
   if (!in_order_queue_.empty() &&
       in_order_queue_.front().get() == buffer.get()) {
@@ -61,6 +64,7 @@ void DecoderBufferQueue::Clear() {
   queue_.clear();
   in_order_queue_.clear();
   earliest_valid_timestamp_ = kNoTimestamp();
+  data_size_ = 0;
 }
 
 bool DecoderBufferQueue::IsEmpty() {
@@ -51,6 +51,9 @@ class MEDIA_EXPORT DecoderBufferQueue {
   // Returns zero if the queue is empty.
   base::TimeDelta Duration();
 
+  // Returns the total size of the data of all queued buffers, in bytes.
+  size_t data_size() const { return data_size_; }
+
  private:
   typedef std::deque<scoped_refptr<DecoderBuffer> > Queue;
   Queue queue_;
@@ -62,6 +65,9 @@ class MEDIA_EXPORT DecoderBufferQueue {
 
   base::TimeDelta earliest_valid_timestamp_;
 
+  // Total size of the data in |queue_|.
+  size_t data_size_;
+
   DISALLOW_COPY_AND_ASSIGN(DecoderBufferQueue);
 };
 
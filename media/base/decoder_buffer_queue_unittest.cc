@@ -18,8 +18,9 @@ static base::TimeDelta ToTimeDelta(int seconds) {
 // Helper to create buffers with specified timestamp in seconds.
 //
 // Negative numbers will be converted to kNoTimestamp();
-static scoped_refptr<DecoderBuffer> CreateBuffer(int timestamp) {
-  scoped_refptr<DecoderBuffer> buffer = new DecoderBuffer(0);
+static scoped_refptr<DecoderBuffer> CreateBuffer(int timestamp,
+                                                  int size = 0) {
+  scoped_refptr<DecoderBuffer> buffer = new DecoderBuffer(size);
   buffer->set_timestamp(ToTimeDelta(timestamp));
   buffer->set_duration(ToTimeDelta(0));
   return buffer;
@@ -135,4 +136,22 @@ TEST(DecoderBufferQueueTest, Duration_NoTimestamp) {
   EXPECT_EQ(0, queue.Duration().InSeconds());
 }
 
+TEST(DecoderBufferQueueTest, DataSize) {
+  DecoderBufferQueue queue;
+  EXPECT_EQ(0u, queue.data_size());
+
+  queue.Push(CreateBuffer(0, 1200));
+  EXPECT_EQ(1200u, queue.data_size());
+
+  queue.Push(CreateBuffer(1, 1000));
+  EXPECT_EQ(2200u, queue.data_size());
+
+  queue.Pop();
+  EXPECT_EQ(1000u, queue.data_size());
+
+  queue.Push(CreateBuffer(2, 500));
+  queue.Clear();
+  EXPECT_EQ(0u, queue.data_size());
+}
+
 }  // namespace media
@@ -21,6 +21,10 @@ const char kEnableVp8AlphaPlayback[] = "enable-vp8-alpha-playback";
 // Set number of threads to use for video decoding.
 const char kVideoThreads[] = "video-threads";
 
+// How many milliseconds of encoded data FFmpegDemuxer reads ahead of what the
+// decoders have asked for. 0 only reads when a decoder is waiting.
+const char kDemuxerReadAheadMs[] = "demuxer-read-ahead-ms";
+
 // Override suppressed responses to canPlayType().
 const char kOverrideEncryptedMediaCanPlayType[] =
     "override-encrypted-media-canplaytype";
@@ -107,6 +107,37 @@ MEDIA_EXPORT void LinearScaleYUVToRGB32RowWithRange_C(const uint8* y_buf,
                                                       int source_x,
                                                       int source_dx);
 
+MEDIA_EXPORT void ConvertYUVToRGB32_NEON(const uint8* yplane,
+                                         const uint8* uplane,
+                                         const uint8* vplane,
+                                         uint8* rgbframe,
+                                         int width,
+                                         int height,
+                                         int ystride,
+                                         int uvstride,
+                                         int rgbstride,
+                                         YUVType yuv_type);
+
+MEDIA_EXPORT void ConvertYUVToRGB32Row_NEON(const uint8* yplane,
+                                            const uint8* uplane,
+                                            const uint8* vplane,
+                                            uint8* rgbframe,
+                                            ptrdiff_t width);
+
+MEDIA_EXPORT void ScaleYUVToRGB32Row_NEON(const uint8* y_buf,
+                                          const uint8* u_buf,
+                                          const uint8* v_buf,
+                                          uint8* rgb_buf,
+                                          ptrdiff_t width,
+                                          ptrdiff_t source_dx);
+
+MEDIA_EXPORT void LinearScaleYUVToRGB32Row_NEON(const uint8* y_buf,
+                                                const uint8* u_buf,
+                                                const uint8* v_buf,
+                                                uint8* rgb_buf,
+                                                ptrdiff_t width,
+                                                ptrdiff_t source_dx);
+
 }  // namespace media
 
 // Assembly functions are declared without namespace.
@@ -0,0 +1,147 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <arm_neon.h>
+
+#include "build/build_config.h"
+#include "media/base/simd/convert_yuv_to_rgb.h"
+#include "media/base/simd/yuv_to_rgb_table.h"
+
+namespace media {
+
+// The NEON versions look up the same kCoefficientsRgbY rows as the C and x86
+// versions, but add, shift and clamp all four channels of two pixels at once.
+// The saturating adds are done in the same order as paddsw in the C version,
+// so the output is bit-exact with it.
+
+// Returns the summed U and V contributions, which are shared by a pair of
+// pixels.
+static inline int16x4_t LookupUV(int u, int v) {
+  return vqadd_s16(vld1_s16(kCoefficientsRgbY[256 + u]),
+                   vld1_s16(kCoefficientsRgbY[512 + v]));
+}
+
+// Converts two pixels, which share |uv|, to 8 bytes of 32 bit ARGB.
+static inline uint8x8_t ConvertTwoPixels(int16x4_t uv, int y0, int y1) {
+  int16x8_t y = vcombine_s16(vld1_s16(kCoefficientsRgbY[y0]),
+                             vld1_s16(kCoefficientsRgbY[y1]));
+  int16x8_t rgb = vqaddq_s16(vcombine_s16(uv, uv), y);
+  uint8x8_t pixels = vqmovun_s16(vshrq_n_s16(rgb, 6));
+#if defined(OS_ANDROID)
+  // Skia on Android wants RGBA rather than BGRA; see convert_yuv_to_rgb_c.cc.
+  static const uint8 kSwapRedAndBlue[8] = { 2, 1, 0, 3, 6, 5, 4, 7 };
+  pixels = vtbl1_u8(pixels, vld1_u8(kSwapRedAndBlue));
+#endif
+  return pixels;
+}
+
+// Stores two pixels, or only the first one for the last pixel of an odd row.
+static inline void StorePixels(uint8x8_t pixels, bool both, uint8* rgb_buf) {
+  if (both) {
+    vst1_u8(rgb_buf, pixels);
+  } else {
+    vst1_lane_u32(reinterpret_cast<uint32*>(rgb_buf),
+                  vreinterpret_u32_u8(pixels), 0);
+  }
+}
+
+void ConvertYUVToRGB32Row_NEON(const uint8* y_buf,
+                               const uint8* u_buf,
+                               const uint8* v_buf,
+                               uint8* rgb_buf,
+                               ptrdiff_t width) {
+  for (int x = 0; x < width; x += 2) {
+    int16x4_t uv = LookupUV(u_buf[x >> 1], v_buf[x >> 1]);
+    bool both = (x + 1) < width;
+    uint8x8_t pixels = ConvertTwoPixels(uv, y_buf[x], y_buf[x + both]);
+    StorePixels(pixels, both, rgb_buf);
+    rgb_buf += 8;  // Advance 2 pixels.
+  }
+}
+
+void ScaleYUVToRGB32Row_NEON(const uint8* y_buf,
+                             const uint8* u_buf,
+                             const uint8* v_buf,
+                             uint8* rgb_buf,
+                             ptrdiff_t width,
+                             ptrdiff_t source_dx) {
+  int x = 0;
+  for (int i = 0; i < width; i += 2) {
+    int16x4_t uv = LookupUV(u_buf[x >> 17], v_buf[x >> 17]);
+    int y0 = y_buf[x >> 16];
+    x += source_dx;
+    bool both = (i + 1) < width;
+    int y1 = y0;
+    if (both) {
+      y1 = y_buf[x >> 16];
+      x += source_dx;
+    }
+    StorePixels(ConvertTwoPixels(uv, y0, y1), both, rgb_buf);
+    rgb_buf += 8;
+  }
+}
+
+void LinearScaleYUVToRGB32Row_NEON(const uint8* y_buf,
+                                   const uint8* u_buf,
+                                   const uint8* v_buf,
+                                   uint8* rgb_buf,
+                                   ptrdiff_t width,
+                                   ptrdiff_t source_dx) {
+  // Avoid point-sampling for down-scaling by > 2:1.
+  int x = 0;
+  if (source_dx >= 0x20000)
+    x += 0x8000;
+
+  // The interpolation matches LinearScaleYUVToRGB32RowWithRange_C().
+  for (int i = 0; i < width; i += 2) {
+    int uv_frac = (x >> 1) & 65535;
+    const uint8* u = u_buf + (x >> 17);
+    const uint8* v = v_buf + (x >> 17);
+    int16x4_t uv = LookupUV(
+        (uv_frac * u[1] + (uv_frac ^ 65535) * u[0]) >> 16,
+        (uv_frac * v[1] + (uv_frac ^ 65535) * v[0]) >> 16);
+
+    int y_frac = x & 65535;
+    const uint8* y = y_buf + (x >> 16);
+    int y0 = (y_frac * y[1] + (y_frac ^ 65535) * y[0]) >> 16;
+    x += source_dx;
+    bool both = (i + 1) < width;
+    int y1 = y0;
+    if (both) {
+      y_frac = x & 65535;
+      y = y_buf + (x >> 16);
+      y1 = (y_frac * y[1] + (y_frac ^ 65535) * y[0]) >> 16;
+      x += source_dx;
+    }
+    StorePixels(ConvertTwoPixels(uv, y0, y1), both, rgb_buf);
+    rgb_buf += 8;
+  }
+}
+
+void ConvertYUVToRGB32_NEON(const uint8* yplane,
+                            const uint8* uplane,
+                            const uint8* vplane,
+                            uint8* rgbframe,
+                            int width,
+                            int height,
+                            int ystride,
+                            int uvstride,
+                            int rgbstride,
+                            YUVType yuv_type) {
+  unsigned int y_shift = yuv_type;
+  for (int y = 0; y < height; ++y) {
+    uint8* rgb_row = rgbframe + y * rgbstride;
+    const uint8* y_ptr = yplane + y * ystride;
+    const uint8* u_ptr = uplane + (y >> y_shift) * uvstride;
+    const uint8* v_ptr = vplane + (y >> y_shift) * uvstride;
+
+    ConvertYUVToRGB32Row_NEON(y_ptr,
+                              u_ptr,
+                              v_ptr,
+                              rgb_row,
+                              width);
+  }
+}
+
+}  // namespace media
@@ -111,13 +111,9 @@ static double SincScaleFactor(double io_ratio) {
 // methods and plumbing the -msse built library is non-trivial.  iOS lies
 // about its architecture, so we also need to exclude it here.
 #if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL) && !defined(OS_IOS)
-#if defined(__SSE__)
-#define CONVOLVE_FUNC Convolve_SSE
-void SincResampler::InitializeCPUSpecificFeatures() {}
-#else
 // X86 CPU detection required.  Functions will be set by
-// InitializeCPUSpecificFeatures().
-// TODO(dalecurtis): Once Chrome moves to an SSE baseline this can be removed.
+// InitializeCPUSpecificFeatures().  Even builds with an SSE baseline have to
+// check for AVX.
 #define CONVOLVE_FUNC g_convolve_proc_
 
 typedef float (*ConvolveProc)(const float*, const float*, const float*, double);
@@ -125,9 +121,19 @@ static ConvolveProc g_convolve_proc_ = NULL;
 
 void SincResampler::InitializeCPUSpecificFeatures() {
   CHECK(!g_convolve_proc_);
-  g_convolve_proc_ = base::CPU().has_sse() ? Convolve_SSE : Convolve_C;
-}
+  const base::CPU cpu;
+  if (cpu.has_avx()) {
+    g_convolve_proc_ = Convolve_AVX;
+  } else {
+#if defined(__SSE__)
+    g_convolve_proc_ = Convolve_SSE;
+#else
+    // TODO(dalecurtis): Once Chrome moves to an SSE baseline this can be
+    // removed.
+    g_convolve_proc_ = cpu.has_sse() ? Convolve_SSE : Convolve_C;
 #endif
+  }
+}
 #elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
 #define CONVOLVE_FUNC Convolve_NEON
 void SincResampler::InitializeCPUSpecificFeatures() {}
@@ -34,8 +34,8 @@ class MEDIA_EXPORT SincResampler {
     kKernelStorageSize = kKernelSize * (kKernelOffsetCount + 1),
   };
 
-  // Selects runtime specific CPU features like SSE.  Must be called before
-  // using SincResampler.
+  // Selects runtime specific CPU features like SSE and AVX.  Must be called
+  // before using SincResampler.
   static void InitializeCPUSpecificFeatures();
 
   // Callback type for providing more data into the resampler.  Expects |frames|
@@ -81,14 +81,18 @@ class MEDIA_EXPORT SincResampler {
 
   // Compute convolution of |k1| and |k2| over |input_ptr|, resultant sums are
   // linearly interpolated using |kernel_interpolation_factor|.  On x86, the
-  // underlying implementation is chosen at run time based on SSE support.  On
-  // ARM, NEON support is chosen at compile time based on compilation flags.
+  // underlying implementation is chosen at run time based on SSE and AVX
+  // support.  On ARM, NEON support is chosen at compile time based on
+  // compilation flags.
   static float Convolve_C(const float* input_ptr, const float* k1,
                           const float* k2, double kernel_interpolation_factor);
 #if defined(ARCH_CPU_X86_FAMILY)
   static float Convolve_SSE(const float* input_ptr, const float* k1,
                             const float* k2,
                             double kernel_interpolation_factor);
+  static float Convolve_AVX(const float* input_ptr, const float* k1,
+                            const float* k2,
+                            double kernel_interpolation_factor);
 #elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
   static float Convolve_NEON(const float* input_ptr, const float* k1,
                              const float* k2,
@@ -158,6 +158,15 @@ TEST(SincResamplerTest, Convolve) {
       resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get(),
       resampler.kernel_storage_.get(), kKernelInterpolationFactor);
   EXPECT_NEAR(result2, result, kEpsilon);
+
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (base::CPU().has_avx()) {
+    result2 = resampler.Convolve_AVX(
+        resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get(),
+        resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+    EXPECT_NEAR(result2, result, kEpsilon);
+  }
+#endif
 }
 #endif
 
@@ -225,6 +234,23 @@ TEST(SincResamplerTest, ConvolveBenchmark) {
          total_time_c_ms / total_time_optimized_aligned_ms,
          total_time_optimized_unaligned_ms / total_time_optimized_aligned_ms);
 #endif
+
+#if defined(ARCH_CPU_X86_FAMILY)
+  // Benchmark Convolve_AVX() where the CPU supports it.
+  if (base::CPU().has_avx()) {
+    start = base::TimeTicks::HighResNow();
+    for (int j = 0; j < convolve_iterations; ++j) {
+      resampler.Convolve_AVX(
+          resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get(),
+          resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+    }
+    double total_time_avx_ms =
+        (base::TimeTicks::HighResNow() - start).InMillisecondsF();
+    printf("Convolve_AVX (unaligned) took %.2fms; which is %.2fx faster than "
+           "Convolve_C.\n", total_time_avx_ms,
+           total_time_c_ms / total_time_avx_ms);
+  }
+#endif
 }
 
 #undef CONVOLVE_FUNC
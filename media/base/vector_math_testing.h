@@ -20,6 +20,10 @@ MEDIA_EXPORT void FMAC_SSE(const float src[], float scale, int len,
                            float dest[]);
 MEDIA_EXPORT void FMUL_SSE(const float src[], float scale, int len,
                            float dest[]);
+MEDIA_EXPORT void FMAC_AVX(const float src[], float scale, int len,
+                           float dest[]);
+MEDIA_EXPORT void FMUL_AVX(const float src[], float scale, int len,
+                           float dest[]);
 #endif
 
 #if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
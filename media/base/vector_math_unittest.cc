@@ -101,6 +101,14 @@ TEST_F(VectorMathTest, FMAC) {
         input_vector.get(), kScale, kVectorSize, output_vector.get());
     VerifyOutput(kResult);
   }
+
+  if (base::CPU().has_avx()) {
+    SCOPED_TRACE("FMAC_AVX");
+    FillTestVectors(kInputFillValue, kOutputFillValue);
+    vector_math::FMAC_AVX(
+        input_vector.get(), kScale, kVectorSize, output_vector.get());
+    VerifyOutput(kResult);
+  }
 #endif
 
 #if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
@@ -143,6 +151,14 @@ TEST_F(VectorMathTest, FMUL) {
         input_vector.get(), kScale, kVectorSize, output_vector.get());
     VerifyOutput(kResult);
   }
+
+  if (base::CPU().has_avx()) {
+    SCOPED_TRACE("FMUL_AVX");
+    FillTestVectors(kInputFillValue, kOutputFillValue);
+    vector_math::FMUL_AVX(
+        input_vector.get(), kScale, kVectorSize, output_vector.get());
+    VerifyOutput(kResult);
+  }
 #endif
 
 #if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
@@ -218,6 +234,22 @@ TEST_F(VectorMathTest, FMACBenchmark) {
          total_time_c_ms / total_time_optimized_aligned_ms,
          total_time_optimized_unaligned_ms / total_time_optimized_aligned_ms);
 #endif
+
+#if defined(ARCH_CPU_X86_FAMILY)
+  // Benchmark FMAC_AVX() where the CPU supports it.
+  if (base::CPU().has_avx()) {
+    FillTestVectors(kInputFillValue, kOutputFillValue);
+    start = TimeTicks::HighResNow();
+    for (int j = 0; j < kBenchmarkIterations; ++j) {
+      vector_math::FMAC_AVX(
+          input_vector.get(), kScale, kVectorSize, output_vector.get());
+    }
+    double total_time_avx_ms =
+        (TimeTicks::HighResNow() - start).InMillisecondsF();
+    printf("FMAC_AVX (aligned) took %.2fms; which is %.2fx faster than "
+           "FMAC_C.\n", total_time_avx_ms, total_time_c_ms / total_time_avx_ms);
+  }
+#endif
 }
 
 #undef FMAC_FUNC
@@ -284,6 +316,22 @@ TEST_F(VectorMathTest, FMULBenchmark) {
          total_time_c_ms / total_time_optimized_aligned_ms,
          total_time_optimized_unaligned_ms / total_time_optimized_aligned_ms);
 #endif
+
+#if defined(ARCH_CPU_X86_FAMILY)
+  // Benchmark FMUL_AVX() where the CPU supports it.
+  if (base::CPU().has_avx()) {
+    FillTestVectors(kInputFillValue, kOutputFillValue);
+    start = TimeTicks::HighResNow();
+    for (int j = 0; j < kBenchmarkIterations; ++j) {
+      vector_math::FMUL_AVX(
+          input_vector.get(), kScale, kVectorSize, output_vector.get());
+    }
+    double total_time_avx_ms =
+        (TimeTicks::HighResNow() - start).InMillisecondsF();
+    printf("FMUL_AVX (aligned) took %.2fms; which is %.2fx faster than "
+           "FMUL_C.\n", total_time_avx_ms, total_time_c_ms / total_time_avx_ms);
+  }
+#endif
 }
 
 #undef FMUL_FUNC
@@ -171,6 +171,23 @@ class MEDIA_EXPORT VideoFrame : public base::RefCountedThreadSafe<VideoFrame> {
       base::TimeDelta timestamp,
       const base::Closure& no_longer_needed_cb);
 
+  // Like WrapExternalYuvData(), for YV12A data with an additional alpha plane.
+  static scoped_refptr<VideoFrame> WrapExternalYuvaData(
+      Format format,
+      const gfx::Size& coded_size,
+      const gfx::Rect& visible_rect,
+      const gfx::Size& natural_size,
+      int32 y_stride,
+      int32 u_stride,
+      int32 v_stride,
+      int32 a_stride,
+      uint8* y_data,
+      uint8* u_data,
+      uint8* v_data,
+      uint8* a_data,
+      base::TimeDelta timestamp,
+      const base::Closure& no_longer_needed_cb);
+
   // Creates a frame with format equals to VideoFrame::EMPTY, width, height,
   // and timestamp are all 0.
   static scoped_refptr<VideoFrame> CreateEmptyFrame();
@@ -0,0 +1,150 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/base/video_frame_pool.h"
+
+#include <list>
+
+#include "base/bind.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+
+namespace media {
+
+class VideoFramePool::PoolImpl
+    : public base::RefCountedThreadSafe<VideoFramePool::PoolImpl> {
+ public:
+  PoolImpl();
+
+  // Returns a frame from the pool that matches the specified parameters or
+  // creates a new frame if no suitable frame exists in the pool.
+  scoped_refptr<VideoFrame> CreateFrame(VideoFrame::Format format,
+                                        const gfx::Size& coded_size,
+                                        const gfx::Rect& visible_rect,
+                                        const gfx::Size& natural_size,
+                                        base::TimeDelta timestamp);
+
+  // Shuts down the frame pool and releases all frames in |frames_|.
+  // Once this is called frames will no longer be inserted back into
+  // |frames_|.
+  void Shutdown();
+
+  size_t GetPoolSizeForTesting() const { return frames_.size(); }
+
+ private:
+  friend class base::RefCountedThreadSafe<VideoFramePool::PoolImpl>;
+  ~PoolImpl();
+
+  // Called when the frame wrapper gets destroyed.
+  // |frame| is the actual frame that was wrapped and is placed
+  // in |frames_| by this function so it can be reused.
+  void FrameReleased(const scoped_refptr<VideoFrame>& frame);
+
+  base::Lock lock_;
+  bool is_shutdown_;
+  std::list<scoped_refptr<VideoFrame> > frames_;
+
+  DISALLOW_COPY_AND_ASSIGN(PoolImpl);
+};
+
+VideoFramePool::PoolImpl::PoolImpl() : is_shutdown_(false) {}
+
+VideoFramePool::PoolImpl::~PoolImpl() {
+  DCHECK(is_shutdown_);
+}
+
+scoped_refptr<VideoFrame> VideoFramePool::PoolImpl::CreateFrame(
+    VideoFrame::Format format,
+    const gfx::Size& coded_size,
+    const gfx::Rect& visible_rect,
+    const gfx::Size& natural_size,
+    base::TimeDelta timestamp) {
+  DCHECK(format == VideoFrame::YV12 || format == VideoFrame::YV12A ||
+         format == VideoFrame::YV16) << format;
+
+  base::AutoLock auto_lock(lock_);
+  DCHECK(!is_shutdown_);
+
+  scoped_refptr<VideoFrame> frame;
+
+  while (!frame.get() && !frames_.empty()) {
+    scoped_refptr<VideoFrame> pool_frame = frames_.front();
+    frames_.pop_front();
+
+    if (pool_frame->format() == format &&
+        pool_frame->coded_size() == coded_size) {
+      frame = pool_frame;
+    }
+  }
+
+  if (!frame.get()) {
+    frame = VideoFrame::CreateFrame(
+        format, coded_size, visible_rect, natural_size, timestamp);
+  }
+
+  base::Closure frame_released_cb =
+      base::Bind(&VideoFramePool::PoolImpl::FrameReleased, this, frame);
+  if (format == VideoFrame::YV12A) {
+    return VideoFrame::WrapExternalYuvaData(
+        frame->format(), frame->coded_size(), visible_rect, natural_size,
+        frame->stride(VideoFrame::kYPlane),
+        frame->stride(VideoFrame::kUPlane),
+        frame->stride(VideoFrame::kVPlane),
+        frame->stride(VideoFrame::kAPlane),
+        frame->data(VideoFrame::kYPlane),
+        frame->data(VideoFrame::kUPlane),
+        frame->data(VideoFrame::kVPlane),
+        frame->data(VideoFrame::kAPlane),
+        timestamp,
+        frame_released_cb);
+  }
+  return VideoFrame::WrapExternalYuvData(
+      frame->format(), frame->coded_size(), visible_rect, natural_size,
+      frame->stride(VideoFrame::kYPlane),
+      frame->stride(VideoFrame::kUPlane),
+      frame->stride(VideoFrame::kVPlane),
+      frame->data(VideoFrame::kYPlane),
+      frame->data(VideoFrame::kUPlane),
+      frame->data(VideoFrame::kVPlane),
+      timestamp,
+      frame_released_cb);
+}
+
+void VideoFramePool::PoolImpl::Shutdown() {
+  base::AutoLock auto_lock(lock_);
+  is_shutdown_ = true;
+  frames_.clear();
+}
+
+void VideoFramePool::PoolImpl::FrameReleased(
+    const scoped_refptr<VideoFrame>& frame) {
+  base::AutoLock auto_lock(lock_);
+  if (is_shutdown_)
+    return;
+
+  frames_.push_back(frame);
+}
+
+VideoFramePool::VideoFramePool() : pool_(new PoolImpl()) {
+}
+
+VideoFramePool::~VideoFramePool() {
+  pool_->Shutdown();
+}
+
+scoped_refptr<VideoFrame> VideoFramePool::CreateFrame(
+    VideoFrame::Format format,
+    const gfx::Size& coded_size,
+    const gfx::Rect& visible_rect,
+    const gfx::Size& natural_size,
+    base::TimeDelta timestamp) {
+  return pool_->CreateFrame(format, coded_size, visible_rect, natural_size,
+                            timestamp);
+}
+
+size_t VideoFramePool::GetPoolSizeForTesting() const {
+  return pool_->GetPoolSizeForTesting();
+}
+
+}  // namespace media
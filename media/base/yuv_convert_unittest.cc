@@ -7,6 +7,7 @@
 #include "base/file_util.h"
 #include "base/logging.h"
 #include "base/path_service.h"
+#include "base/time/time.h"
 #include "media/base/djb2.h"
 #include "media/base/simd/convert_rgb_to_yuv.h"
 #include "media/base/simd/convert_yuv_to_rgb.h"
@@ -967,4 +968,138 @@ TEST(YUVConvertTest, LinearScaleYUVToRGB32Row_MMX_X64) {
 
 #endif  // defined(ARCH_CPU_X86_FAMILY)
 
+#if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+TEST(YUVConvertTest, ConvertYUVToRGB32Row_NEON) {
+  scoped_ptr<uint8[]> yuv_bytes(new uint8[kYUV12Size]);
+  scoped_ptr<uint8[]> rgb_bytes_reference(new uint8[kRGBSize]);
+  scoped_ptr<uint8[]> rgb_bytes_converted(new uint8[kRGBSize]);
+  ReadYV12Data(&yuv_bytes);
+
+  const int kWidth = 167;
+  ConvertYUVToRGB32Row_C(yuv_bytes.get(),
+                         yuv_bytes.get() + kSourceUOffset,
+                         yuv_bytes.get() + kSourceVOffset,
+                         rgb_bytes_reference.get(),
+                         kWidth);
+  ConvertYUVToRGB32Row_NEON(yuv_bytes.get(),
+                            yuv_bytes.get() + kSourceUOffset,
+                            yuv_bytes.get() + kSourceVOffset,
+                            rgb_bytes_converted.get(),
+                            kWidth);
+  EXPECT_EQ(0, memcmp(rgb_bytes_reference.get(),
+                      rgb_bytes_converted.get(),
+                      kWidth * kBpp));
+}
+
+TEST(YUVConvertTest, ScaleYUVToRGB32Row_NEON) {
+  scoped_ptr<uint8[]> yuv_bytes(new uint8[kYUV12Size]);
+  scoped_ptr<uint8[]> rgb_bytes_reference(new uint8[kRGBSize]);
+  scoped_ptr<uint8[]> rgb_bytes_converted(new uint8[kRGBSize]);
+  ReadYV12Data(&yuv_bytes);
+
+  const int kWidth = 167;
+  const int kSourceDx = 80000;  // This value means a scale down.
+  ScaleYUVToRGB32Row_C(yuv_bytes.get(),
+                       yuv_bytes.get() + kSourceUOffset,
+                       yuv_bytes.get() + kSourceVOffset,
+                       rgb_bytes_reference.get(),
+                       kWidth,
+                       kSourceDx);
+  ScaleYUVToRGB32Row_NEON(yuv_bytes.get(),
+                          yuv_bytes.get() + kSourceUOffset,
+                          yuv_bytes.get() + kSourceVOffset,
+                          rgb_bytes_converted.get(),
+                          kWidth,
+                          kSourceDx);
+  EXPECT_EQ(0, memcmp(rgb_bytes_reference.get(),
+                      rgb_bytes_converted.get(),
+                      kWidth * kBpp));
+}
+
+TEST(YUVConvertTest, LinearScaleYUVToRGB32Row_NEON) {
+  scoped_ptr<uint8[]> yuv_bytes(new uint8[kYUV12Size]);
+  scoped_ptr<uint8[]> rgb_bytes_reference(new uint8[kRGBSize]);
+  scoped_ptr<uint8[]> rgb_bytes_converted(new uint8[kRGBSize]);
+  ReadYV12Data(&yuv_bytes);
+
+  const int kWidth = 167;
+  const int kSourceDx = 80000;  // This value means a scale down.
+  LinearScaleYUVToRGB32Row_C(yuv_bytes.get(),
+                             yuv_bytes.get() + kSourceUOffset,
+                             yuv_bytes.get() + kSourceVOffset,
+                             rgb_bytes_reference.get(),
+                             kWidth,
+                             kSourceDx);
+  LinearScaleYUVToRGB32Row_NEON(yuv_bytes.get(),
+                                yuv_bytes.get() + kSourceUOffset,
+                                yuv_bytes.get() + kSourceVOffset,
+                                rgb_bytes_converted.get(),
+                                kWidth,
+                                kSourceDx);
+  EXPECT_EQ(0, memcmp(rgb_bytes_reference.get(),
+                      rgb_bytes_converted.get(),
+                      kWidth * kBpp));
+}
+#endif  // defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+
+// Reports the throughput of the converters picked for this CPU, next to the C
+// versions, for the unscaled and the bilinear scaled paths.
+TEST(YUVConvertTest, Benchmark) {
+  const int kIterations = 20;
+  scoped_ptr<uint8[]> yuv_bytes;
+  scoped_ptr<uint8[]> rgb_bytes(new uint8[kRGBSizeScaled]);
+  ReadYV12Data(&yuv_bytes);
+
+  base::TimeTicks start = base::TimeTicks::HighResNow();
+  for (int i = 0; i < kIterations; ++i) {
+    ConvertYUVToRGB32_C(yuv_bytes.get(),
+                        yuv_bytes.get() + kSourceUOffset,
+                        yuv_bytes.get() + kSourceVOffset,
+                        rgb_bytes.get(),
+                        kSourceWidth, kSourceHeight,
+                        kSourceWidth,
+                        kSourceWidth / 2,
+                        kSourceWidth * kBpp,
+                        media::YV12);
+  }
+  double c_ms = (base::TimeTicks::HighResNow() - start).InMillisecondsF();
+
+  start = base::TimeTicks::HighResNow();
+  for (int i = 0; i < kIterations; ++i) {
+    media::ConvertYUVToRGB32(yuv_bytes.get(),
+                             yuv_bytes.get() + kSourceUOffset,
+                             yuv_bytes.get() + kSourceVOffset,
+                             rgb_bytes.get(),
+                             kSourceWidth, kSourceHeight,
+                             kSourceWidth,
+                             kSourceWidth / 2,
+                             kSourceWidth * kBpp,
+                             media::YV12);
+  }
+  double optimized_ms =
+      (base::TimeTicks::HighResNow() - start).InMillisecondsF();
+  printf("ConvertYUVToRGB32: %.2f Mpixels/s, C: %.2f Mpixels/s.\n",
+         kIterations * kSourceYSize / (optimized_ms * 1000),
+         kIterations * kSourceYSize / (c_ms * 1000));
+
+  start = base::TimeTicks::HighResNow();
+  for (int i = 0; i < kIterations; ++i) {
+    media::ScaleYUVToRGB32(yuv_bytes.get(),
+                           yuv_bytes.get() + kSourceUOffset,
+                           yuv_bytes.get() + kSourceVOffset,
+                           rgb_bytes.get(),
+                           kSourceWidth, kSourceHeight,
+                           kScaledWidth, kScaledHeight,
+                           kSourceWidth,
+                           kSourceWidth / 2,
+                           kScaledWidth * kBpp,
+                           media::YV12,
+                           media::ROTATE_0,
+                           media::FILTER_BILINEAR);
+  }
+  double scale_ms = (base::TimeTicks::HighResNow() - start).InMillisecondsF();
+  printf("ScaleYUVToRGB32 (bilinear): %.2f Mpixels/s.\n",
+         kIterations * kScaledWidth * kScaledHeight / (scale_ms * 1000));
+}
+
 }  // namespace media
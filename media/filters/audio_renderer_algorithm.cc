@@ -222,20 +222,24 @@ int AudioRendererAlgorithm::OutputFasterPlayback(AudioBus* dest,
     index_into_window_ += seek_frames;
   }
 
-  // d) Crossfade and output a frame, as long as we have data.
+  // d) Crossfade and output as many frames as we have data for, up to the
+  //    end of the window.
   if (audio_buffer_.frames() < 1)
     return 0;
   DCHECK_GT(frames_in_crossfade_, 0);
   DCHECK_LT(index_into_window_, window_size_);
 
   int offset_into_buffer = index_into_window_ - intro_crossfade_begin;
-  int copied = audio_buffer_.ReadFrames(1, dest_offset, dest);
-  DCHECK_EQ(copied, 1);
-  CrossfadeFrame(crossfade_buffer_.get(),
-                 offset_into_buffer,
-                 dest,
-                 dest_offset,
-                 offset_into_buffer);
+  const int frames_to_copy =
+      std::min(requested_frames, window_size_ - index_into_window_);
+  int copied = audio_buffer_.ReadFrames(frames_to_copy, dest_offset, dest);
+  DCHECK_GT(copied, 0);
+  CrossfadeFrames(crossfade_buffer_.get(),
+                  offset_into_buffer,
+                  dest,
+                  dest_offset,
+                  offset_into_buffer,
+                  copied);
   index_into_window_ += copied;
   return copied;
 }
@@ -305,43 +309,55 @@ int AudioRendererAlgorithm::OutputSlowerPlayback(AudioBus* dest,
     return copied;
   }
 
-  // c) Output a raw frame into |dest| without advancing the |audio_buffer_|
-  //    cursor.
+  // c) Output raw frames into |dest| without advancing the |audio_buffer_|
+  //    cursor, stopping at the outtro crossfade section or the end of the
+  //    window.
   int audio_buffer_offset = index_into_window_ - intro_crossfade_end;
   DCHECK_GE(audio_buffer_offset, 0);
   if (audio_buffer_.frames() <= audio_buffer_offset)
     return 0;
-  int copied =
-      audio_buffer_.PeekFrames(1, audio_buffer_offset, dest_offset, dest);
-  DCHECK_EQ(1, copied);
-
-  // d) Crossfade the next frame of |crossfade_buffer_| into |dest| if we've
+  int phase_end = index_into_window_ < outtro_crossfade_begin ?
+      outtro_crossfade_begin : window_size_;
+  const int frames_to_copy =
+      std::min(requested_frames, phase_end - index_into_window_);
+  int copied = audio_buffer_.PeekFrames(
+      frames_to_copy, audio_buffer_offset, dest_offset, dest);
+  DCHECK_GT(copied, 0);
+
+  // d) Crossfade the next frames of |crossfade_buffer_| into |dest| if we've
   //    reached the outtro crossfade section of the window.
   if (index_into_window_ >= outtro_crossfade_begin) {
     int offset_into_crossfade_buffer =
         index_into_window_ - outtro_crossfade_begin;
-    CrossfadeFrame(dest,
-                   dest_offset,
-                   crossfade_buffer_.get(),
-                   offset_into_crossfade_buffer,
-                   offset_into_crossfade_buffer);
+    CrossfadeFrames(dest,
+                    dest_offset,
+                    crossfade_buffer_.get(),
+                    offset_into_crossfade_buffer,
+                    offset_into_crossfade_buffer,
+                    copied);
   }
 
   index_into_window_ += copied;
   return copied;
 }
 
-void AudioRendererAlgorithm::CrossfadeFrame(AudioBus* intro,
-                                            int intro_offset,
-                                            AudioBus* outtro,
-                                            int outtro_offset,
-                                            int fade_offset) {
-  float crossfade_ratio =
-      static_cast<float>(fade_offset) / frames_in_crossfade_;
+void AudioRendererAlgorithm::CrossfadeFrames(AudioBus* intro,
+                                             int intro_offset,
+                                             AudioBus* outtro,
+                                             int outtro_offset,
+                                             int fade_offset,
+                                             int frames) {
+  DCHECK_LE(fade_offset + frames, frames_in_crossfade_);
+  const float ratio_step = 1.0f / frames_in_crossfade_;
   for (int channel = 0; channel < channels_; ++channel) {
-    outtro->channel(channel)[outtro_offset] =
-        (1.0f - crossfade_ratio) * intro->channel(channel)[intro_offset] +
-        (crossfade_ratio) * outtro->channel(channel)[outtro_offset];
+    // Each channel is contiguous, so the compiler can vectorize this loop.
+    const float* intro_data = intro->channel(channel) + intro_offset;
+    float* outtro_data = outtro->channel(channel) + outtro_offset;
+    for (int i = 0; i < frames; ++i) {
+      float crossfade_ratio = (fade_offset + i) * ratio_step;
+      outtro_data[i] = (1.0f - crossfade_ratio) * intro_data[i] +
+                       crossfade_ratio * outtro_data[i];
+    }
   }
 }
 
@@ -118,12 +118,14 @@ class MEDIA_EXPORT AudioRendererAlgorithm {
   // Resets the window state to the start of a new window.
   void ResetWindow();
 
-  // Does a linear crossfade from |intro| into |outtro| for one frame.
-  void CrossfadeFrame(AudioBus* intro,
-                      int intro_offset,
-                      AudioBus* outtro,
-                      int outtro_offset,
-                      int fade_offset);
+  // Does a linear crossfade from |intro| into |outtro| for |frames| frames,
+  // starting |fade_offset| frames into the crossfade.
+  void CrossfadeFrames(AudioBus* intro,
+                       int intro_offset,
+                       AudioBus* outtro,
+                       int outtro_offset,
+                       int fade_offset,
+                       int frames);
 
   // Number of channels in audio stream.
   int channels_;
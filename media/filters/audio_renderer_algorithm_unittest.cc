@@ -8,10 +8,13 @@
 // correct rate.  We always pass in a very large destination buffer with the
 // expectation that FillBuffer() will fill as much as it can but no more.
 
+#include <stdio.h>
+
 #include <cmath>
 
 #include "base/bind.h"
 #include "base/callback.h"
+#include "base/time/time.h"
 #include "media/base/audio_buffer.h"
 #include "media/base/audio_bus.h"
 #include "media/base/buffers.h"
@@ -297,4 +300,36 @@ TEST_F(AudioRendererAlgorithmTest, FillBuffer_HigherQualityAudio) {
   TestPlaybackRate(1.5);
 }
 
+// Reports how many seconds of audio are rendered per second of CPU time at
+// common playback rates.
+TEST_F(AudioRendererAlgorithmTest, FillBuffer_Benchmark) {
+  const int kSampleRate = 44100;
+  const int kBufferSize = kSampleRate / 100;
+  const int kFramesPerRate = 60 * kSampleRate;
+  const double kPlaybackRates[] = { 0.5, 1.5, 2.0 };
+
+  Initialize(CHANNEL_LAYOUT_STEREO, kSampleFormatS16, kSampleRate);
+  scoped_ptr<AudioBus> bus = AudioBus::Create(channels_, kBufferSize);
+  for (size_t i = 0; i < arraysize(kPlaybackRates); ++i) {
+    algorithm_.SetPlaybackRate(static_cast<float>(kPlaybackRates[i]));
+
+    base::TimeDelta elapsed;
+    int frames_remaining = kFramesPerRate;
+    while (frames_remaining > 0) {
+      FillAlgorithmQueue();
+      base::TimeTicks start = base::TimeTicks::HighResNow();
+      int frames_written = algorithm_.FillBuffer(bus.get(), kBufferSize);
+      elapsed += base::TimeTicks::HighResNow() - start;
+      ASSERT_GT(frames_written, 0);
+      frames_remaining -= frames_written;
+    }
+
+    printf("Rendered %.1f s of audio at rate %.1f in %.2f ms (%.0fx)\n",
+           static_cast<double>(kFramesPerRate) / kSampleRate,
+           kPlaybackRates[i],
+           elapsed.InMillisecondsF(),
+           kFramesPerRate / (kSampleRate * elapsed.InSecondsF()));
+  }
+}
+
 }  // namespace media
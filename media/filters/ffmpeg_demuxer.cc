@@ -16,6 +16,7 @@
 #include "base/message_loop/message_loop.h"
 #include "base/metrics/sparse_histogram.h"
 #include "base/stl_util.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/task_runner_util.h"
@@ -35,6 +36,13 @@
 
 namespace media {
 
+// How much encoded data FFmpegDemuxer reads ahead of the decoders, unless
+// overridden with --demuxer-read-ahead-ms.
+static const int kDefaultReadAheadMs = 1000;
+
+// The most memory a stream's read-ahead queue may use.
+static const size_t kMaxReadAheadBytes = 8 * 1024 * 1024;
+
 //
 // FFmpegDemuxerStream
 //
@@ -262,14 +270,19 @@ void FFmpegDemuxerStream::SatisfyPendingRead() {
 }
 
 bool FFmpegDemuxerStream::HasAvailableCapacity() {
-  // TODO(scherkus): Remove early return and reenable time-based capacity
-  // after our data sources support canceling/concurrent reads, see
-  // http://crbug.com/165762 for details.
-  return !read_cb_.is_null();
+  if (!demuxer_ || end_of_stream_)
+    return false;
 
-  // Try to have one second's worth of encoded data per stream.
-  const base::TimeDelta kCapacity = base::TimeDelta::FromSeconds(1);
-  return buffer_queue_.IsEmpty() || buffer_queue_.Duration() < kCapacity;
+  // Always read for a waiting decoder. Otherwise read ahead up to the
+  // demuxer's read-ahead duration of encoded data, but bound the memory used
+  // in case the packets have no timestamps to measure it by.
+  //
+  // TODO(scherkus): A read ahead can still delay a seek until it completes;
+  // cancel it once our data sources support canceling reads, see
+  // http://crbug.com/165762 for details.
+  return !read_cb_.is_null() ||
+         (buffer_queue_.Duration() < demuxer_->read_ahead_duration() &&
+          buffer_queue_.data_size() < kMaxReadAheadBytes);
 }
 
 // static
@@ -301,11 +314,21 @@ FFmpegDemuxer::FFmpegDemuxer(
       start_time_(kNoTimestamp()),
       audio_disabled_(false),
       duration_known_(false),
+      read_ahead_duration_(
+          base::TimeDelta::FromMilliseconds(kDefaultReadAheadMs)),
       url_protocol_(data_source, BindToLoop(message_loop_, base::Bind(
           &FFmpegDemuxer::OnDataSourceError, base::Unretained(this)))),
       need_key_cb_(need_key_cb) {
   DCHECK(message_loop_.get());
   DCHECK(data_source_);
+
+  std::string read_ahead_ms(CommandLine::ForCurrentProcess()->
+      GetSwitchValueASCII(switches::kDemuxerReadAheadMs));
+  int value = 0;
+  if (!read_ahead_ms.empty() && base::StringToInt(read_ahead_ms, &value) &&
+      value >= 0) {
+    read_ahead_duration_ = base::TimeDelta::FromMilliseconds(value);
+  }
 }
 
 FFmpegDemuxer::~FFmpegDemuxer() {}
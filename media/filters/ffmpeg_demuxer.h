@@ -161,6 +161,10 @@ class MEDIA_EXPORT FFmpegDemuxer : public Demuxer {
   void NotifyCapacityAvailable();
   void NotifyBufferingChanged();
 
+  // Returns how much encoded data each stream keeps queued ahead of its
+  // decoder.
+  base::TimeDelta read_ahead_duration() const { return read_ahead_duration_; }
+
  private:
   // To allow tests access to privates.
   friend class FFmpegDemuxerTest;
@@ -246,6 +250,10 @@ class MEDIA_EXPORT FFmpegDemuxer : public Demuxer {
   // stream -- at this moment we definitely know duration.
   bool duration_known_;
 
+  // How far the streams read ahead of their decoders. Zero reads packets only
+  // while a decoder is waiting for one.
+  base::TimeDelta read_ahead_duration_;
+
   // FFmpegURLProtocol implementation and corresponding glue bits.
   BlockingUrlProtocol url_protocol_;
   scoped_ptr<FFmpegGlue> glue_;
@@ -145,6 +145,16 @@ class FFmpegDemuxerTest : public testing::Test {
     demuxer_->duration_known_ = duration_known;
   }
 
+  void set_read_ahead_duration(base::TimeDelta read_ahead_duration) {
+    demuxer_->read_ahead_duration_ = read_ahead_duration;
+  }
+
+  bool HasAvailableCapacity(DemuxerStream::Type type) {
+    DemuxerStream* stream = demuxer_->GetStream(type);
+    CHECK(stream);
+    return static_cast<FFmpegDemuxerStream*>(stream)->HasAvailableCapacity();
+  }
+
   bool IsStreamStopped(DemuxerStream::Type type) {
     DemuxerStream* stream = demuxer_->GetStream(type);
     CHECK(stream);
@@ -336,6 +346,24 @@ TEST_F(FFmpegDemuxerTest, Read_Video) {
   message_loop_.Run();
 }
 
+TEST_F(FFmpegDemuxerTest, Read_ReadAhead) {
+  CreateDemuxer("bear-320x240.webm");
+  InitializeDemuxer();
+
+  // Empty streams read ahead without waiting for a decoder to ask for data.
+  EXPECT_TRUE(HasAvailableCapacity(DemuxerStream::AUDIO));
+  EXPECT_TRUE(HasAvailableCapacity(DemuxerStream::VIDEO));
+
+  // Without a read-ahead duration they only read for a pending Read().
+  set_read_ahead_duration(base::TimeDelta());
+  EXPECT_FALSE(HasAvailableCapacity(DemuxerStream::AUDIO));
+  EXPECT_FALSE(HasAvailableCapacity(DemuxerStream::VIDEO));
+
+  DemuxerStream* video = demuxer_->GetStream(DemuxerStream::VIDEO);
+  video->Read(NewReadCB(FROM_HERE, 22084, 0));
+  message_loop_.Run();
+}
+
 TEST_F(FFmpegDemuxerTest, Read_VideoNonZeroStart) {
   // Test the start time is the first timestamp of the video and audio stream.
   CreateDemuxer("nonzero-start-time.webm");
@@ -13,9 +13,12 @@
 #include "base/location.h"
 #include "base/message_loop/message_loop_proxy.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/sys_info.h"
+#include "base/time/time.h"
 #include "media/base/bind_to_loop.h"
 #include "media/base/decoder_buffer.h"
 #include "media/base/limits.h"
+#include "media/base/media_log.h"
 #include "media/base/media_switches.h"
 #include "media/base/pipeline.h"
 #include "media/base/video_decoder_config.h"
@@ -26,41 +29,75 @@
 
 namespace media {
 
-// Always try to use three threads for video decoding.  There is little reason
-// not to since current day CPUs tend to be multi-core and we measured
-// performance benefits on older machines such as P4s with hyperthreading.
+// Use two threads for video decoding by default.  There is little reason not
+// to since current day CPUs tend to be multi-core and we measured performance
+// benefits on older machines such as P4s with hyperthreading.
 //
 // Handling decoding on separate threads also frees up the pipeline thread to
-// continue processing. Although it'd be nice to have the option of a single
-// decoding thread, FFmpeg treats having one thread the same as having zero
-// threads (i.e., avcodec_decode_video() will execute on the calling thread).
-// Yet another reason for having two threads :)
+// continue processing.  FFmpeg treats having one thread the same as having
+// zero threads (i.e., avcodec_decode_video() will execute on the calling
+// thread), which is only worth it for small videos where handing frames
+// between threads costs more than decoding them.
 static const int kDecodeThreads = 2;
 static const int kMaxDecodeThreads = 16;
 
-// Returns the number of threads given the FFmpeg CodecID. Also inspects the
-// command line for a valid --video-threads flag.
-static int GetThreadCount(AVCodecID codec_id) {
+// Videos of at most this many pixels are decoded on the calling thread.
+static const int kSingleThreadedMaxArea = 640 * 360;
+
+// H.264 and VP8 videos of at least this many pixels get a thread per core and
+// use frame threading only.  Frame threading scales much better than slice
+// threading, which needs several slices per frame, but delays the output by a
+// frame per thread.  Other videos let FFmpeg pick what the codec supports.
+static const int kFrameThreadingMinArea = 1280 * 720;
+static const int kMaxFrameThreads = 8;
+
+// How many decoded frames the decode time is averaged over before it is
+// reported and checked against the frame duration.
+static const int kDecodeStatsInterval = 60;
+
+// Returns the number of threads to decode |config| with, and stores the kind
+// of threading to use in |thread_type|.  Also inspects the command line for a
+// valid --video-threads flag.
+static int GetThreadCount(const VideoDecoderConfig& config,
+                          int* thread_type) {
   // Refer to http://crbug.com/93932 for tsan suppressions on decoding.
   int decode_threads = kDecodeThreads;
+  *thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
 
   const CommandLine* cmd_line = CommandLine::ForCurrentProcess();
   std::string threads(cmd_line->GetSwitchValueASCII(switches::kVideoThreads));
-  if (threads.empty() || !base::StringToInt(threads, &decode_threads))
+  if (!threads.empty() && base::StringToInt(threads, &decode_threads)) {
+    decode_threads = std::max(decode_threads, 0);
+    decode_threads = std::min(decode_threads, kMaxDecodeThreads);
     return decode_threads;
+  }
+
+  int area = config.coded_size().GetArea();
+  if (area <= kSingleThreadedMaxArea)
+    return 1;
 
-  decode_threads = std::max(decode_threads, 0);
-  decode_threads = std::min(decode_threads, kMaxDecodeThreads);
+  if (area >= kFrameThreadingMinArea &&
+      (config.codec() == kCodecH264 || config.codec() == kCodecVP8)) {
+    *thread_type = FF_THREAD_FRAME;
+    decode_threads = std::max(decode_threads,
+                              base::SysInfo::NumberOfProcessors());
+    decode_threads = std::min(decode_threads, kMaxFrameThreads);
+  }
   return decode_threads;
 }
 
 FFmpegVideoDecoder::FFmpegVideoDecoder(
-    const scoped_refptr<base::MessageLoopProxy>& message_loop)
+    const scoped_refptr<base::MessageLoopProxy>& message_loop,
+    const scoped_refptr<MediaLog>& media_log)
     : message_loop_(message_loop),
       weak_factory_(this),
       state_(kUninitialized),
       codec_context_(NULL),
-      av_frame_(NULL) {
+      av_frame_(NULL),
+      media_log_(media_log),
+      extra_decode_threads_(0),
+      needs_more_threads_(false),
+      stats_frame_count_(0) {
 }
 
 int FFmpegVideoDecoder::GetVideoBuffer(AVCodecContext* codec_context,
@@ -93,7 +130,7 @@ int FFmpegVideoDecoder::GetVideoBuffer(AVCodecContext* codec_context,
     return AVERROR(EINVAL);
 
   scoped_refptr<VideoFrame> video_frame =
-      VideoFrame::CreateFrame(format, size, gfx::Rect(size), natural_size,
+      frame_pool_.CreateFrame(format, size, gfx::Rect(size), natural_size,
                               kNoTimestamp());
 
   for (int i = 0; i < 3; i++) {
@@ -189,7 +226,21 @@ void FFmpegVideoDecoder::Reset(const base::Closure& closure) {
 void FFmpegVideoDecoder::DoReset() {
   DCHECK(decode_cb_.is_null());
 
-  avcodec_flush_buffers(codec_context_);
+  // The decoder was too slow with its threads; decoding starts over from a
+  // key frame after a reset, so this is the time to reopen it with more.
+  if (needs_more_threads_ && codec_context_->thread_count < kMaxDecodeThreads) {
+    needs_more_threads_ = false;
+    extra_decode_threads_ =
+        std::max(2 * extra_decode_threads_, codec_context_->thread_count);
+    if (!ConfigureDecoder()) {
+      state_ = kError;
+      base::ResetAndReturn(&reset_cb_).Run();
+      return;
+    }
+  } else {
+    avcodec_flush_buffers(codec_context_);
+  }
+  ResetDecodeStats();
   state_ = kNormal;
   base::ResetAndReturn(&reset_cb_).Run();
 }
@@ -312,10 +363,12 @@ bool FFmpegVideoDecoder::FFmpegDecode(
   }
 
   int frame_decoded = 0;
+  base::TimeTicks decode_start = base::TimeTicks::HighResNow();
   int result = avcodec_decode_video2(codec_context_,
                                      av_frame_,
                                      &frame_decoded,
                                      &packet);
+  stats_decode_time_ += base::TimeTicks::HighResNow() - decode_start;
   // Log the problem if we can't decode a video frame and exit early.
   if (result < 0) {
     LOG(ERROR) << "Error decoding video: " << buffer->AsHumanReadableString();
@@ -352,9 +405,39 @@ bool FFmpegVideoDecoder::FFmpegDecode(
   (*video_frame)->SetTimestamp(
       base::TimeDelta::FromMicroseconds(av_frame_->reordered_opaque));
 
+  UpdateDecodeStats((*video_frame)->GetTimestamp());
   return true;
 }
 
+void FFmpegVideoDecoder::UpdateDecodeStats(base::TimeDelta timestamp) {
+  if (stats_frame_count_++ == 0) {
+    stats_first_timestamp_ = timestamp;
+    return;
+  }
+  if (stats_frame_count_ < kDecodeStatsInterval)
+    return;
+
+  // |stats_decode_time_| includes the calls that didn't output a frame, which
+  // are part of the cost of the frames that did.
+  base::TimeDelta decode_time = stats_decode_time_ / stats_frame_count_;
+  media_log_->SetDoubleProperty("video_decode_time_ms",
+                                decode_time.InMillisecondsF());
+
+  // Frames come out in presentation order, so the timestamps tell how long
+  // each frame is shown.  Decoding slower than that drops frames.
+  base::TimeDelta frame_duration =
+      (timestamp - stats_first_timestamp_) / (stats_frame_count_ - 1);
+  if (frame_duration > base::TimeDelta() && decode_time > frame_duration)
+    needs_more_threads_ = true;
+
+  ResetDecodeStats();
+}
+
+void FFmpegVideoDecoder::ResetDecodeStats() {
+  stats_frame_count_ = 0;
+  stats_decode_time_ = base::TimeDelta();
+}
+
 void FFmpegVideoDecoder::ReleaseFFmpegResources() {
   if (codec_context_) {
     av_free(codec_context_->extradata);
@@ -379,7 +462,14 @@ bool FFmpegVideoDecoder::ConfigureDecoder() {
   // Enable motion vector search (potentially slow), strong deblocking filter
   // for damaged macroblocks, and set our error detection sensitivity.
   codec_context_->error_concealment = FF_EC_GUESS_MVS | FF_EC_DEBLOCK;
-  codec_context_->thread_count = GetThreadCount(codec_context_->codec_id);
+  int thread_type;
+  int thread_count = GetThreadCount(config_, &thread_type);
+  if (extra_decode_threads_) {
+    thread_count = std::min(std::max(thread_count, 2) + extra_decode_threads_,
+                            kMaxDecodeThreads);
+  }
+  codec_context_->thread_count = thread_count;
+  codec_context_->thread_type = thread_type;
   codec_context_->opaque = this;
   codec_context_->flags |= CODEC_FLAG_EMU_EDGE;
   codec_context_->get_buffer = GetVideoBufferImpl;
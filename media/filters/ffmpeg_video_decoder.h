@@ -9,8 +9,10 @@
 
 #include "base/callback.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "media/base/video_decoder.h"
 #include "media/base/video_decoder_config.h"
+#include "media/base/video_frame_pool.h"
 
 struct AVCodecContext;
 struct AVFrame;
@@ -22,11 +24,13 @@ class MessageLoopProxy;
 namespace media {
 
 class DecoderBuffer;
+class MediaLog;
 
 class MEDIA_EXPORT FFmpegVideoDecoder : public VideoDecoder {
  public:
-  explicit FFmpegVideoDecoder(
-      const scoped_refptr<base::MessageLoopProxy>& message_loop);
+  FFmpegVideoDecoder(
+      const scoped_refptr<base::MessageLoopProxy>& message_loop,
+      const scoped_refptr<MediaLog>& media_log);
   virtual ~FFmpegVideoDecoder();
 
   // VideoDecoder implementation.
@@ -67,6 +71,12 @@ class MEDIA_EXPORT FFmpegVideoDecoder : public VideoDecoder {
   // Reset decoder and call |reset_cb_|.
   void DoReset();
 
+  // Accounts for a decoded frame with |timestamp|.  Every few frames, reports
+  // the average decode time to |media_log_| and notes whether decoding is
+  // slower than playback.
+  void UpdateDecodeStats(base::TimeDelta timestamp);
+  void ResetDecodeStats();
+
   scoped_refptr<base::MessageLoopProxy> message_loop_;
   base::WeakPtrFactory<FFmpegVideoDecoder> weak_factory_;
   base::WeakPtr<FFmpegVideoDecoder> weak_this_;
@@ -82,6 +92,22 @@ class MEDIA_EXPORT FFmpegVideoDecoder : public VideoDecoder {
 
   VideoDecoderConfig config_;
 
+  scoped_refptr<MediaLog> media_log_;
+
+  // Threads added to the default count because decoding couldn't keep up.
+  // They are added when the decoder is reset, since changing the thread count
+  // means reopening the codec.
+  int extra_decode_threads_;
+  bool needs_more_threads_;
+
+  // Decode time and timestamps of the frames since the last report.
+  int stats_frame_count_;
+  base::TimeDelta stats_decode_time_;
+  base::TimeDelta stats_first_timestamp_;
+
+  // Recycles the memory of decoded frames once the renderer is done with them.
+  VideoFramePool frame_pool_;
+
   DISALLOW_COPY_AND_ASSIGN(FFmpegVideoDecoder);
 };
 
@@ -13,6 +13,7 @@
 #include "media/base/decoder_buffer.h"
 #include "media/base/gmock_callback_support.h"
 #include "media/base/limits.h"
+#include "media/base/media_log.h"
 #include "media/base/mock_filters.h"
 #include "media/base/test_data_util.h"
 #include "media/base/test_helpers.h"
@@ -46,7 +47,8 @@ ACTION_P(ReturnBuffer, buffer) {
 class FFmpegVideoDecoderTest : public testing::Test {
  public:
   FFmpegVideoDecoderTest()
-      : decoder_(new FFmpegVideoDecoder(message_loop_.message_loop_proxy())),
+      : decoder_(new FFmpegVideoDecoder(message_loop_.message_loop_proxy(),
+                                        new MediaLog())),
         decode_cb_(base::Bind(&FFmpegVideoDecoderTest::FrameReady,
                               base::Unretained(this))) {
     FFmpegGlue::InitializeFFmpeg();
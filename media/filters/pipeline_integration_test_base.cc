@@ -233,7 +233,8 @@ PipelineIntegrationTestBase::CreateFilterCollection(
   video_decoders.push_back(
       new VpxVideoDecoder(message_loop_.message_loop_proxy()));
   video_decoders.push_back(
-      new FFmpegVideoDecoder(message_loop_.message_loop_proxy()));
+      new FFmpegVideoDecoder(message_loop_.message_loop_proxy(),
+                             new MediaLog()));
 
   // Disable frame dropping if hashing is enabled.
   scoped_ptr<VideoRenderer> renderer(new VideoRendererBase(
@@ -295,6 +295,11 @@ static int kDefaultAudioMemoryLimit = 12 * 1024 * 1024;
 static int kDefaultVideoMemoryLimit = 150 * 1024 * 1024;
 #endif
 
+// The longest time a single Append() spends on garbage collection. Whatever
+// is still over the memory limit after that is freed by the next appends, so
+// a large backlog doesn't stall the thread appending the data.
+static int kDefaultGarbageCollectionBudgetInMs = 5;
+
 namespace media {
 
 SourceBufferStream::SourceBufferStream(const AudioDecoderConfig& audio_config,
@@ -314,6 +319,8 @@ SourceBufferStream::SourceBufferStream(const AudioDecoderConfig& audio_config,
       last_output_buffer_timestamp_(kNoTimestamp()),
       max_interbuffer_distance_(kNoTimestamp()),
       memory_limit_(kDefaultAudioMemoryLimit),
+      garbage_collection_budget_(base::TimeDelta::FromMilliseconds(
+          kDefaultGarbageCollectionBudgetInMs)),
       config_change_pending_(false) {
   DCHECK(audio_config.IsValidConfig());
   audio_configs_.push_back(audio_config);
@@ -336,6 +343,8 @@ SourceBufferStream::SourceBufferStream(const VideoDecoderConfig& video_config,
       last_output_buffer_timestamp_(kNoTimestamp()),
       max_interbuffer_distance_(kNoTimestamp()),
       memory_limit_(kDefaultVideoMemoryLimit),
+      garbage_collection_budget_(base::TimeDelta::FromMilliseconds(
+          kDefaultGarbageCollectionBudgetInMs)),
       config_change_pending_(false) {
   DCHECK(video_config.IsValidConfig());
   video_configs_.push_back(video_config);
@@ -640,17 +649,20 @@ void SourceBufferStream::GarbageCollectIfNeeded() {
     return;
 
   int bytes_to_free = ranges_size - memory_limit_;
+  base::TimeTicks deadline =
+      base::TimeTicks::Now() + garbage_collection_budget_;
 
   // Begin deleting from the front.
-  int bytes_freed = FreeBuffers(bytes_to_free, false);
+  int bytes_freed = FreeBuffers(bytes_to_free, false, deadline);
 
   // Begin deleting from the back.
-  if (bytes_to_free - bytes_freed > 0)
-    FreeBuffers(bytes_to_free - bytes_freed, true);
+  if (bytes_to_free - bytes_freed > 0 && base::TimeTicks::Now() < deadline)
+    FreeBuffers(bytes_to_free - bytes_freed, true, deadline);
 }
 
 int SourceBufferStream::FreeBuffers(int total_bytes_to_free,
-                                    bool reverse_direction) {
+                                    bool reverse_direction,
+                                    base::TimeTicks deadline) {
   TRACE_EVENT2("mse", "SourceBufferStream::FreeBuffers",
                "total bytes to free", total_bytes_to_free,
                "reverse direction", reverse_direction);
@@ -707,6 +719,11 @@ int SourceBufferStream::FreeBuffers(int total_bytes_to_free,
       delete current_range;
       reverse_direction ? ranges_.pop_back() : ranges_.pop_front();
     }
+
+    // At least one GOP is freed per call, so that garbage collection always
+    // makes progress.
+    if (base::TimeTicks::Now() >= deadline)
+      break;
   }
 
   // Insert |new_range_for_append| into |ranges_|, if applicable.
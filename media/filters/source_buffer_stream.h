@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "base/memory/ref_counted.h"
+#include "base/time/time.h"
 #include "media/base/audio_decoder_config.h"
 #include "media/base/media_export.h"
 #include "media/base/media_log.h"
@@ -125,17 +126,26 @@ class MEDIA_EXPORT SourceBufferStream {
     memory_limit_ = memory_limit;
   }
 
+  void set_garbage_collection_budget_for_testing(base::TimeDelta budget) {
+    garbage_collection_budget_ = budget;
+  }
+
  private:
   typedef std::list<SourceBufferRange*> RangeList;
 
   // Frees up space if the SourceBufferStream is taking up too much memory.
+  // Spends at most |garbage_collection_budget_| doing so; the rest is freed
+  // by later calls.
   void GarbageCollectIfNeeded();
 
   // Attempts to delete approximately |total_bytes_to_free| amount of data
   // |ranges_|, starting at the front of |ranges_| and moving linearly forward
   // through the buffers. Deletes starting from the back if |reverse_direction|
-  // is true. Returns the number of bytes freed.
-  int FreeBuffers(int total_bytes_to_free, bool reverse_direction);
+  // is true. Stops early once |deadline| has passed, after freeing at least
+  // one GOP. Returns the number of bytes freed.
+  int FreeBuffers(int total_bytes_to_free,
+                  bool reverse_direction,
+                  base::TimeTicks deadline);
 
   // Appends |new_buffers| into |range_for_new_buffers_itr|, handling start and
   // end overlaps if necessary.
@@ -342,6 +352,9 @@ class MEDIA_EXPORT SourceBufferStream {
   // The maximum amount of data in bytes the stream will keep in memory.
   int memory_limit_;
 
+  // The longest time a single GarbageCollectIfNeeded() call may take.
+  base::TimeDelta garbage_collection_budget_;
+
   // Indicates that a kConfigChanged status has been reported by GetNextBuffer()
   // and GetCurrentXXXDecoderConfig() must be called to update the current
   // config. GetNextBuffer() must not be called again until
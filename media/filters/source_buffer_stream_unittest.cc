@@ -2051,6 +2051,34 @@ TEST_F(SourceBufferStreamTest, GarbageCollection_DeleteFrontGOPsAtATime) {
   CheckExpectedBuffers(5, 9, &kDataA);
 }
 
+// Garbage collection that runs out of time frees the rest on later appends.
+TEST_F(SourceBufferStreamTest, GarbageCollection_Incremental) {
+  // Set memory limit to 20 buffers, and only allow one GOP to be freed per
+  // append.
+  SetMemoryLimit(20);
+  stream_->set_garbage_collection_budget_for_testing(base::TimeDelta());
+
+  // Append 20 buffers at positions 0 through 19 and seek into the last GOP.
+  NewSegmentAppend(0, 20, &kDataA);
+  Seek(15);
+
+  // Append 10 buffers, which puts the stream two GOPs over the limit. Only
+  // the first GOP is freed.
+  AppendBuffers(20, 10, &kDataA);
+  CheckExpectedRanges("{ [5,29) }");
+
+  // The next append frees another GOP.
+  AppendBuffers(30, 1, &kDataA);
+  CheckExpectedRanges("{ [10,30) }");
+
+  // With enough time, the stream gets back under the limit in one append.
+  stream_->set_garbage_collection_budget_for_testing(
+      base::TimeDelta::FromSeconds(10));
+  AppendBuffers(31, 1, &kDataA);
+  CheckExpectedRanges("{ [15,31) }");
+  CheckExpectedBuffers(15, 31, &kDataA);
+}
+
 TEST_F(SourceBufferStreamTest, GarbageCollection_DeleteBack) {
   // Set memory limit to 5 buffers.
   SetMemoryLimit(5);
@@ -120,7 +120,8 @@ void InitPipeline(media::Pipeline* pipeline,
   collection->SetDemuxer(demuxer);
 
   ScopedVector<media::VideoDecoder> video_decoders;
-  video_decoders.push_back(new media::FFmpegVideoDecoder(message_loop));
+  video_decoders.push_back(
+      new media::FFmpegVideoDecoder(message_loop, new media::MediaLog()));
   scoped_ptr<media::VideoRenderer> video_renderer(new media::VideoRendererBase(
       message_loop,
       video_decoders.Pass(),
@@ -136,6 +136,17 @@ class ExpiringCache {
     return &it->second.first;
   }
 
+  // Returns the value matching |key| and sets |expiration| to when it expires,
+  // whether or not it has expired. Returns NULL if the item is not found.
+  // Unlike Get(), this never removes the item.
+  const ValueType* Peek(const KeyType& key, ExpirationType* expiration) const {
+    typename EntryMap::const_iterator it = entries_.find(key);
+    if (it == entries_.end())
+      return NULL;
+    *expiration = it->second.second;
+    return &it->second.first;
+  }
+
   // Updates or replaces the value associated with |key|.
   void Put(const KeyType& key,
            const ValueType& value,
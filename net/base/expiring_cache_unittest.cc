@@ -254,6 +254,31 @@ TEST(ExpiringCacheTest, GetTruncatesExpiredEntries) {
   EXPECT_EQ(6U, cache.size());
 }
 
+TEST(ExpiringCacheTest, PeekKeepsExpiredEntries) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+
+  Cache cache(kMaxCacheEntries);
+
+  // Start at t=0.
+  base::TimeTicks now;
+  base::TimeTicks expiration;
+  EXPECT_FALSE(cache.Peek("test1", &expiration));
+
+  cache.Put("test1", "foo1", now, now + kTTL);
+  EXPECT_THAT(cache.Peek("test1", &expiration), Pointee(StrEq("foo1")));
+  EXPECT_EQ(now + kTTL, expiration);
+
+  // At t=20 the entry has expired, but is still returned.
+  now += 2 * kTTL;
+  EXPECT_THAT(cache.Peek("test1", &expiration), Pointee(StrEq("foo1")));
+  EXPECT_EQ(1U, cache.size());
+
+  // Get() removes it.
+  EXPECT_FALSE(cache.Get("test1", now));
+  EXPECT_FALSE(cache.Peek("test1", &expiration));
+  EXPECT_EQ(0U, cache.size());
+}
+
 TEST(ExpiringCacheTest, CustomFunctor) {
   ExpiringCache<std::string, std::string, std::string, TestFunctor> cache(5);
 
@@ -278,6 +278,10 @@ void FileStream::SetBoundNetLogSource(const BoundNetLog& owner_bound_net_log) {
       bound_net_log_.source().ToEventParametersCallback());
 }
 
+base::PlatformFile FileStream::GetPlatformFile() {
+  return context_->file();
+}
+
 base::PlatformFile FileStream::GetPlatformFileForTesting() {
   return context_->file();
 }
@@ -228,6 +228,10 @@ class NET_EXPORT FileStream {
   // of ownership happened, but without details.
   void SetBoundNetLogSource(const net::BoundNetLog& owner_bound_net_log);
 
+  // Returns the underlying platform file, which remains owned by the stream.
+  // It may only be used while no operation is pending on the stream.
+  base::PlatformFile GetPlatformFile();
+
   // Returns the underlying platform file for testing.
   base::PlatformFile GetPlatformFileForTesting();
 
@@ -345,6 +345,10 @@ Filter::FilterStatus Filter::CopyOut(char* dest_buffer, int* dest_len) {
   }
 }
 
+bool Filter::IsPassThrough() const {
+  return false;
+}
+
 // static
 Filter* Filter::InitGZipFilter(FilterType type_id, int buffer_size) {
   scoped_ptr<GZipFilter> gz_filter(new GZipFilter());
@@ -396,6 +400,9 @@ void Filter::InitBuffer(int buffer_size) {
 }
 
 void Filter::PushDataIntoNextFilter() {
+  if (HandStreamBufferToNextFilter())
+    return;
+
   IOBuffer* next_buffer = next_filter_->stream_buffer();
   int next_size = next_filter_->stream_buffer_size();
   last_status_ = ReadFilteredData(next_buffer->data(), &next_size);
@@ -403,4 +410,23 @@ void Filter::PushDataIntoNextFilter() {
     next_filter_->FlushStreamBuffer(next_size);
 }
 
+bool Filter::HandStreamBufferToNextFilter() {
+  // Filters of a chain share the same buffer size, but filters created for
+  // tests might not.
+  if (!IsPassThrough() || !stream_data_len_ ||
+      next_filter_->stream_data_len() ||
+      next_filter_->stream_buffer_size() != stream_buffer_size_) {
+    return false;
+  }
+
+  // |next_stream_data_| points into |stream_buffer_|, so it stays valid.
+  stream_buffer_.swap(next_filter_->stream_buffer_);
+  next_filter_->next_stream_data_ = next_stream_data_;
+  next_filter_->stream_data_len_ = stream_data_len_;
+  next_stream_data_ = NULL;
+  stream_data_len_ = 0;
+  last_status_ = FILTER_NEED_MORE_DATA;
+  return true;
+}
+
 }  // namespace net
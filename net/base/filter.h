@@ -157,7 +157,9 @@ class NET_EXPORT_PRIVATE Filter {
   // next_filter_, then it obtains data from this specific filter.
   FilterStatus ReadData(char* dest_buffer, int* dest_len);
 
-  // Returns a pointer to the stream_buffer_.
+  // Returns a pointer to the stream_buffer_. The buffer may be handed to the
+  // next filter in the chain by ReadData(), so callers should not hold on to
+  // it across calls to ReadData().
   IOBuffer* stream_buffer() const { return stream_buffer_.get(); }
 
   // Returns the maximum size of stream_buffer_ in number of chars.
@@ -218,6 +220,11 @@ class NET_EXPORT_PRIVATE Filter {
   // Copy pre-filter data directly to destination buffer without decoding.
   FilterStatus CopyOut(char* dest_buffer, int* dest_len);
 
+  // Returns true if ReadFilteredData() would only CopyOut() the remaining
+  // pre-filter data, with no output of its own pending. The data can then be
+  // handed to the next filter in the chain without copying it.
+  virtual bool IsPassThrough() const;
+
   FilterStatus last_status() const { return last_status_; }
 
   // Buffer to hold the data to be filtered (the input queue).
@@ -256,6 +263,11 @@ class NET_EXPORT_PRIVATE Filter {
   // Helper function to empty our output into the next filter's input.
   void PushDataIntoNextFilter();
 
+  // Gives the remaining pre-filter data to the next filter by swapping
+  // stream buffers with it. Returns false if that is not possible, in which
+  // case the data has to be filtered into the next filter's buffer.
+  bool HandStreamBufferToNextFilter();
+
   // Constructs a filter with an internal buffer of the given size.
   // Only meant to be called by unit tests that need to control the buffer size.
   static Filter* FactoryForTests(const std::vector<FilterType>& filter_types,
@@ -0,0 +1,150 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "base/strings/stringprintf.h"
+#include "net/base/filter.h"
+#include "net/base/io_buffer.h"
+#include "net/base/mock_filter_context.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/zlib/zlib.h"
+#include "url/gurl.h"
+
+namespace net {
+
+namespace {
+
+// The size of the decoded body, and the number of times it is decoded.
+const int kBodySize = 4 * 1024 * 1024;
+const int kNumIterations = 10;
+
+// The size of the buffer the consumer of the filter reads into, as
+// URLRequestJob does.
+const int kReadBufferSize = 32 * 1024;
+
+// Returns a body that compresses about as well as typical HTML.
+std::string MakeBody() {
+  std::string body;
+  body.reserve(kBodySize);
+  for (int i = 0; body.size() < static_cast<size_t>(kBodySize); ++i) {
+    body.append(base::StringPrintf(
+        "<div class=\"item\" id=\"item%d\"><a href=\"/items/%d\">Item %d</a>"
+        "</div>\n", i, i * 7919 % 100003, i));
+  }
+  body.resize(kBodySize);
+  return body;
+}
+
+std::string GZipCompress(const std::string& input) {
+  z_stream zlib_stream;
+  memset(&zlib_stream, 0, sizeof(zlib_stream));
+  // 16 is added to the window bits to get a gzip header and footer.
+  int code = deflateInit2(&zlib_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                          MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY);
+  CHECK_EQ(Z_OK, code);
+
+  std::string output(deflateBound(&zlib_stream, input.size()), '\0');
+  zlib_stream.next_in =
+      reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+  zlib_stream.avail_in = input.size();
+  zlib_stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+  zlib_stream.avail_out = output.size();
+  code = deflate(&zlib_stream, Z_FINISH);
+  CHECK_EQ(Z_STREAM_END, code);
+  output.resize(zlib_stream.total_out);
+  deflateEnd(&zlib_stream);
+  return output;
+}
+
+class FilterPerfTest : public testing::Test {
+ protected:
+  FilterPerfTest() {
+    filter_context_.SetURL(GURL("http://www.example.com/"));
+    // Lets a tentative sdch filter pass its input through.
+    filter_context_.SetResponseCode(404);
+  }
+
+  // Decodes |encoded| with a chain of |filter_types| kNumIterations times,
+  // and logs the rate of decoded output as |test_name|.
+  void RunDecodeTest(const std::string& test_name,
+                     const std::vector<Filter::FilterType>& filter_types,
+                     const std::string& encoded) {
+    scoped_ptr<char[]> read_buffer(new char[kReadBufferSize]);
+    int64 total_decoded = 0;
+
+    PerfTimer timer;
+    for (int i = 0; i < kNumIterations; ++i) {
+      scoped_ptr<Filter> filter(Filter::Factory(filter_types, filter_context_));
+      ASSERT_TRUE(filter.get());
+
+      size_t encoded_offset = 0;
+      Filter::FilterStatus status = Filter::FILTER_NEED_MORE_DATA;
+      int64 decoded = 0;
+      while (status != Filter::FILTER_DONE && status != Filter::FILTER_ERROR) {
+        if (status == Filter::FILTER_NEED_MORE_DATA) {
+          if (encoded_offset == encoded.size())
+            break;
+          int amount = std::min(
+              static_cast<size_t>(filter->stream_buffer_size()),
+              encoded.size() - encoded_offset);
+          memcpy(filter->stream_buffer()->data(),
+                 encoded.data() + encoded_offset, amount);
+          filter->FlushStreamBuffer(amount);
+          encoded_offset += amount;
+        }
+        int read_len = kReadBufferSize;
+        status = filter->ReadData(read_buffer.get(), &read_len);
+        decoded += read_len;
+        // A chain reports FILTER_OK with no output once it is done.
+        if (status == Filter::FILTER_OK && read_len == 0)
+          break;
+      }
+      ASSERT_NE(Filter::FILTER_ERROR, status);
+      ASSERT_EQ(kBodySize, decoded);
+      total_decoded += decoded;
+    }
+
+    double seconds = timer.Elapsed().InSecondsF();
+    LogPerfResult(test_name.c_str(),
+                  static_cast<double>(total_decoded) / (1024 * 1024) / seconds,
+                  "MB/s");
+  }
+
+  MockFilterContext filter_context_;
+};
+
+TEST_F(FilterPerfTest, GZip) {
+  std::vector<Filter::FilterType> filter_types;
+  filter_types.push_back(Filter::FILTER_TYPE_GZIP);
+  RunDecodeTest("Filter_GZip", filter_types, GZipCompress(MakeBody()));
+}
+
+// The chain built by Filter::FixupEncodingTypes() for a gzip response to a
+// request that advertised an sdch dictionary, when the server did not use it.
+TEST_F(FilterPerfTest, GZipWithTentativeSdch) {
+  std::vector<Filter::FilterType> filter_types;
+  filter_types.push_back(Filter::FILTER_TYPE_SDCH_POSSIBLE);
+  filter_types.push_back(Filter::FILTER_TYPE_GZIP_HELPING_SDCH);
+  filter_types.push_back(Filter::FILTER_TYPE_GZIP);
+  RunDecodeTest("Filter_GZipWithTentativeSdch", filter_types,
+                GZipCompress(MakeBody()));
+}
+
+// A chain in which every filter passes its input through.
+TEST_F(FilterPerfTest, PassThroughChain) {
+  std::vector<Filter::FilterType> filter_types;
+  filter_types.push_back(Filter::FILTER_TYPE_SDCH_POSSIBLE);
+  filter_types.push_back(Filter::FILTER_TYPE_GZIP_HELPING_SDCH);
+  RunDecodeTest("Filter_PassThroughChain", filter_types, MakeBody());
+}
+
+}  // namespace
+
+}  // namespace net
@@ -64,6 +64,14 @@ bool GZipFilter::InitDecoding(Filter::FilterType filter_type) {
   return true;
 }
 
+bool GZipFilter::IsPassThrough() const {
+  // Once the stream is decoded and its footer skipped, or it turned out not
+  // to be gzip encoded, the remaining data is copied out as is.
+  return decoding_status_ == DECODING_DONE &&
+      (GZIP_GET_INVALID_HEADER == gzip_header_status_ ||
+       gzip_footer_bytes_ == kGZipFooterSize);
+}
+
 Filter::FilterStatus GZipFilter::ReadFilteredData(char* dest_buffer,
                                                   int* dest_len) {
   if (!dest_buffer || !dest_len || *dest_len <= 0)
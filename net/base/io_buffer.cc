@@ -9,20 +9,26 @@
 namespace net {
 
 IOBuffer::IOBuffer()
-    : data_(NULL) {
+    : data_(NULL),
+      pooled_size_(-1) {
 }
 
-IOBuffer::IOBuffer(int buffer_size) {
+IOBuffer::IOBuffer(int buffer_size)
+    : pooled_size_(buffer_size) {
   CHECK_GE(buffer_size, 0);
-  data_ = new char[buffer_size];
+  data_ = static_cast<char*>(base::ObjectPool::Allocate(buffer_size));
 }
 
 IOBuffer::IOBuffer(char* data)
-    : data_(data) {
+    : data_(data),
+      pooled_size_(-1) {
 }
 
 IOBuffer::~IOBuffer() {
-  delete[] data_;
+  if (pooled_size_ >= 0)
+    base::ObjectPool::Free(data_, pooled_size_);
+  else
+    delete[] data_;
   data_ = NULL;
 }
 
@@ -7,6 +7,7 @@
 
 #include <string>
 
+#include "base/memory/object_pool.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/pickle.h"
@@ -70,7 +71,11 @@ namespace net {
 // and hence the buffer it was reading into must remain alive. Using
 // reference counting we can add a reference to the IOBuffer and make sure
 // it is not destroyed until after the synchronous operation has completed.
-class NET_EXPORT IOBuffer : public base::RefCountedThreadSafe<IOBuffer> {
+//
+// IOBuffers, and the buffers allocated by IOBuffer(int), come from the
+// base::ObjectPool, as they are created and destroyed at a very high rate.
+class NET_EXPORT IOBuffer : public base::RefCountedThreadSafe<IOBuffer>,
+                            public base::PoolAllocated {
  public:
   IOBuffer();
   explicit IOBuffer(int buffer_size);
@@ -87,6 +92,11 @@ class NET_EXPORT IOBuffer : public base::RefCountedThreadSafe<IOBuffer> {
   virtual ~IOBuffer();
 
   char* data_;
+
+ private:
+  // The size of |data_| if it was allocated from the ObjectPool by
+  // IOBuffer(int), or -1 if it was allocated with new[].
+  int pooled_size_;
 };
 
 // This version stores the size of the buffer so that the creator of the object
@@ -201,6 +201,26 @@ class PriorityQueue : public base::NonThreadSafe {
     return Pointer();
   }
 
+  // Returns a pointer to the value that follows |pointer| in the order in which
+  // FirstMax() would return values, or a null-pointer if |pointer| points to
+  // the last such value.
+  Pointer GetNextTowardsLastMin(const Pointer& pointer) {
+    DCHECK(CalledOnValidThread());
+    DCHECK(!pointer.is_null());
+    DCHECK_LT(pointer.priority_, lists_.size());
+
+    Priority priority = pointer.priority_;
+    typename List::iterator it = pointer.iterator_;
+    ++it;
+    while (it == lists_[priority].end()) {
+      if (priority == 0u)
+        return Pointer();
+      --priority;
+      it = lists_[priority].begin();
+    }
+    return Pointer(priority, it);
+  }
+
   // Empties the queue. All pointers become invalid.
   void Clear() {
     DCHECK(CalledOnValidThread());
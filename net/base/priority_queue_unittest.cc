@@ -87,6 +87,17 @@ TEST_F(PriorityQueueTest, LastMaxOrder) {
   CheckEmpty();
 }
 
+TEST_F(PriorityQueueTest, GetNextTowardsLastMin) {
+  PriorityQueue<int>::Pointer current = queue_.FirstMax();
+  for (size_t i = 0; i < kNumElements; ++i) {
+    ASSERT_FALSE(current.is_null());
+    EXPECT_EQ(kFirstMaxOrder[i], current.value());
+    current = queue_.GetNextTowardsLastMin(current);
+  }
+  EXPECT_TRUE(current.is_null());
+  EXPECT_EQ(kNumElements, queue_.size());
+}
+
 TEST_F(PriorityQueueTest, EraseFromMiddle) {
   queue_.Erase(pointers_[2]);
   queue_.Erase(pointers_[3]);
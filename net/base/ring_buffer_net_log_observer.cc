@@ -0,0 +1,123 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/ring_buffer_net_log_observer.h"
+
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/logging.h"
+#include "base/values.h"
+#include "net/base/net_log_logger.h"
+
+namespace net {
+
+namespace {
+
+base::Value* CopyParams(const base::Value* params,
+                        NetLog::LogLevel /* log_level */) {
+  return params->DeepCopy();
+}
+
+void AppendEntryToList(base::ListValue* list, const NetLog::Entry& entry) {
+  list->Append(entry.ToValue());
+}
+
+void AddEntryToLogger(NetLogLogger* logger, const NetLog::Entry& entry) {
+  logger->OnAddEntry(entry);
+}
+
+}  // namespace
+
+RingBufferNetLogObserver::Record::Record()
+    : type(NetLog::EVENT_COUNT),
+      phase(NetLog::PHASE_NONE) {
+}
+
+RingBufferNetLogObserver::Record::~Record() {
+}
+
+RingBufferNetLogObserver::RingBufferNetLogObserver(size_t max_entries)
+    : max_entries_(max_entries),
+      oldest_(0) {
+  DCHECK_GT(max_entries, 0u);
+}
+
+RingBufferNetLogObserver::~RingBufferNetLogObserver() {
+}
+
+void RingBufferNetLogObserver::StartObserving(NetLog* net_log,
+                                              NetLog::LogLevel log_level) {
+  net_log->AddThreadSafeObserver(this, log_level);
+}
+
+void RingBufferNetLogObserver::StopObserving() {
+  net_log()->RemoveThreadSafeObserver(this);
+}
+
+size_t RingBufferNetLogObserver::GetSize() const {
+  base::AutoLock lock(lock_);
+  return records_.size();
+}
+
+void RingBufferNetLogObserver::Clear() {
+  base::AutoLock lock(lock_);
+  records_.clear();
+  oldest_ = 0;
+}
+
+base::ListValue* RingBufferNetLogObserver::GetEntriesAsValue() const {
+  base::ListValue* list = new base::ListValue();
+  base::AutoLock lock(lock_);
+  ForEachEntry(base::Bind(&AppendEntryToList, list));
+  return list;
+}
+
+void RingBufferNetLogObserver::WriteToFile(
+    FILE* file,
+    const base::Value& constants) const {
+  NetLogLogger logger(file, constants);
+  base::AutoLock lock(lock_);
+  ForEachEntry(base::Bind(&AddEntryToLogger, &logger));
+}
+
+void RingBufferNetLogObserver::OnAddEntry(const NetLog::Entry& entry) {
+  // Build the parameters before taking the lock, so other threads adding
+  // events don't wait on it.
+  scoped_ptr<base::Value> params(entry.ParametersToValue());
+
+  base::AutoLock lock(lock_);
+  Record* record;
+  if (records_.size() < max_entries_) {
+    record = new Record();
+    records_.push_back(record);
+  } else {
+    record = records_[oldest_];
+    oldest_ = (oldest_ + 1) % max_entries_;
+  }
+  record->type = entry.type();
+  record->source = entry.source();
+  record->phase = entry.phase();
+  record->time = entry.time();
+  record->params = params.Pass();
+}
+
+void RingBufferNetLogObserver::ForEachEntry(
+    const base::Callback<void(const NetLog::Entry&)>& callback) const {
+  lock_.AssertAcquired();
+  for (size_t i = 0; i < records_.size(); ++i) {
+    const Record* record = records_[(oldest_ + i) % records_.size()];
+    NetLog::ParametersCallback params_callback;
+    if (record->params)
+      params_callback = base::Bind(&CopyParams, record->params.get());
+    NetLog::Entry entry(record->type,
+                        record->source,
+                        record->phase,
+                        record->time,
+                        record->params ? &params_callback : NULL,
+                        NetLog::LOG_ALL);
+    callback.Run(entry);
+  }
+}
+
+}  // namespace net
@@ -0,0 +1,99 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_BASE_RING_BUFFER_NET_LOG_OBSERVER_H_
+#define NET_BASE_RING_BUFFER_NET_LOG_OBSERVER_H_
+
+#include <stdio.h>
+
+#include "base/callback_forward.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "net/base/net_log.h"
+
+namespace base {
+class ListValue;
+class Value;
+}
+
+namespace net {
+
+// RingBufferNetLogObserver keeps the most recent events of a NetLog in
+// memory, and only turns them into JSON when they are asked for.  Unlike
+// NetLogLogger, nothing is serialized or written while events are added, and
+// the number of events kept is bounded, so it can be left observing for the
+// life of the process.
+//
+// Event parameters are built when the event is added, since the parameters
+// callback may refer to objects that don't outlive the event, but they are
+// kept as Values until the events are written out.
+class NET_EXPORT RingBufferNetLogObserver : public NetLog::ThreadSafeObserver {
+ public:
+  // Keeps at most |max_entries| events.  Older events are dropped first.
+  explicit RingBufferNetLogObserver(size_t max_entries);
+  virtual ~RingBufferNetLogObserver();
+
+  // Starts observing |net_log| at |log_level|.  Must not already be watching
+  // a NetLog.
+  void StartObserving(NetLog* net_log, NetLog::LogLevel log_level);
+
+  // Stops observing net_log().  Must already be watching.
+  void StopObserving();
+
+  // Returns the number of events currently kept.
+  size_t GetSize() const;
+
+  // Drops all events kept so far.
+  void Clear();
+
+  // Returns the events kept, oldest first, in the format of
+  // NetLog::Entry::ToValue().  Caller takes ownership of the returned Value.
+  base::ListValue* GetEntriesAsValue() const;
+
+  // Writes the events kept, oldest first, to |file| in the format written by
+  // NetLogLogger, which can be loaded by about:net-internals.  Takes ownership
+  // of |file|, and closes it when done.  |constants| is as for NetLogLogger.
+  void WriteToFile(FILE* file, const base::Value& constants) const;
+
+  // net::NetLog::ThreadSafeObserver implementation:
+  virtual void OnAddEntry(const NetLog::Entry& entry) OVERRIDE;
+
+ private:
+  struct Record {
+    Record();
+    ~Record();
+
+    NetLog::EventType type;
+    NetLog::Source source;
+    NetLog::EventPhase phase;
+    base::TimeTicks time;
+    // NULL if the event has no parameters.
+    scoped_ptr<base::Value> params;
+  };
+
+  // Calls |callback| with each event kept, oldest first.  |lock_| must be
+  // held.
+  void ForEachEntry(
+      const base::Callback<void(const NetLog::Entry&)>& callback) const;
+
+  const size_t max_entries_;
+
+  // Needs to be "mutable" so it can be used by the const methods.
+  mutable base::Lock lock_;
+
+  // Grows to |max_entries_|, after which the oldest record is reused for each
+  // new event.
+  ScopedVector<Record> records_;
+
+  // Index in |records_| of the oldest event, once |records_| is full.
+  size_t oldest_;
+
+  DISALLOW_COPY_AND_ASSIGN(RingBufferNetLogObserver);
+};
+
+}  // namespace net
+
+#endif  // NET_BASE_RING_BUFFER_NET_LOG_OBSERVER_H_
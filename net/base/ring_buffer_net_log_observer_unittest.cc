@@ -0,0 +1,126 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/ring_buffer_net_log_observer.h"
+
+#include "base/callback.h"
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/json/json_reader.h"
+#include "base/values.h"
+#include "net/base/net_log_logger.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+// Adds |count| global events to |net_log|, each with an "index" parameter
+// that counts up from |first_index|.
+void AddEntries(NetLog* net_log, int first_index, int count) {
+  for (int i = first_index; i < first_index + count; ++i) {
+    net_log->AddGlobalEntry(NetLog::TYPE_CANCELLED,
+                            NetLog::IntegerCallback("index", i));
+  }
+}
+
+// Checks that |entries| holds events with the "index" parameters
+// |first_index| through |first_index| + |count| - 1, in order.
+void ExpectIndices(const base::ListValue& entries, int first_index,
+                   int count) {
+  ASSERT_EQ(static_cast<size_t>(count), entries.GetSize());
+  for (int i = 0; i < count; ++i) {
+    const base::DictionaryValue* entry;
+    ASSERT_TRUE(entries.GetDictionary(i, &entry));
+    int type;
+    ASSERT_TRUE(entry->GetInteger("type", &type));
+    EXPECT_EQ(NetLog::TYPE_CANCELLED, type);
+    int index;
+    ASSERT_TRUE(entry->GetInteger("params.index", &index));
+    EXPECT_EQ(first_index + i, index);
+  }
+}
+
+}  // namespace
+
+TEST(RingBufferNetLogObserverTest, KeepsEntriesUntilFull) {
+  NetLog net_log;
+  RingBufferNetLogObserver observer(10);
+  observer.StartObserving(&net_log, NetLog::LOG_ALL_BUT_BYTES);
+
+  AddEntries(&net_log, 0, 4);
+  EXPECT_EQ(4u, observer.GetSize());
+  scoped_ptr<base::ListValue> entries(observer.GetEntriesAsValue());
+  ExpectIndices(*entries, 0, 4);
+
+  observer.StopObserving();
+}
+
+TEST(RingBufferNetLogObserverTest, DropsOldestEntries) {
+  NetLog net_log;
+  RingBufferNetLogObserver observer(10);
+  observer.StartObserving(&net_log, NetLog::LOG_ALL_BUT_BYTES);
+
+  AddEntries(&net_log, 0, 25);
+  EXPECT_EQ(10u, observer.GetSize());
+  scoped_ptr<base::ListValue> entries(observer.GetEntriesAsValue());
+  ExpectIndices(*entries, 15, 10);
+
+  observer.Clear();
+  EXPECT_EQ(0u, observer.GetSize());
+  AddEntries(&net_log, 30, 3);
+  entries.reset(observer.GetEntriesAsValue());
+  ExpectIndices(*entries, 30, 3);
+
+  observer.StopObserving();
+}
+
+TEST(RingBufferNetLogObserverTest, EntryWithoutParameters) {
+  NetLog net_log;
+  RingBufferNetLogObserver observer(10);
+  observer.StartObserving(&net_log, NetLog::LOG_ALL_BUT_BYTES);
+
+  net_log.AddGlobalEntry(NetLog::TYPE_CANCELLED);
+  scoped_ptr<base::ListValue> entries(observer.GetEntriesAsValue());
+  ASSERT_EQ(1u, entries->GetSize());
+  const base::DictionaryValue* entry;
+  ASSERT_TRUE(entries->GetDictionary(0, &entry));
+  EXPECT_FALSE(entry->HasKey("params"));
+
+  observer.StopObserving();
+}
+
+TEST(RingBufferNetLogObserverTest, WriteToFile) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath log_path = temp_dir.path().AppendASCII("NetLogFile");
+
+  NetLog net_log;
+  RingBufferNetLogObserver observer(5);
+  observer.StartObserving(&net_log, NetLog::LOG_ALL_BUT_BYTES);
+  AddEntries(&net_log, 0, 8);
+  observer.StopObserving();
+
+  FILE* file = file_util::OpenFile(log_path, "w");
+  ASSERT_TRUE(file);
+  scoped_ptr<base::Value> constants(NetLogLogger::GetConstants());
+  observer.WriteToFile(file, *constants);
+
+  std::string input;
+  ASSERT_TRUE(file_util::ReadFileToString(log_path, &input));
+
+  base::JSONReader reader;
+  scoped_ptr<base::Value> root(reader.ReadToValue(input));
+  ASSERT_TRUE(root) << reader.GetErrorMessage();
+
+  base::DictionaryValue* dict;
+  ASSERT_TRUE(root->GetAsDictionary(&dict));
+  EXPECT_TRUE(dict->HasKey("constants"));
+  base::ListValue* events;
+  ASSERT_TRUE(dict->GetList("events", &events));
+  ExpectIndices(*events, 3, 5);
+}
+
+}  // namespace net
@@ -140,6 +140,10 @@ static const char* kDecompressionErrorHtml =
   "<head><META HTTP-EQUIV=\"Refresh\" CONTENT=\"0\"></head>";
 #endif
 
+bool SdchFilter::IsPassThrough() const {
+  return PASS_THROUGH == decoding_status_ && dest_buffer_excess_.empty();
+}
+
 Filter::FilterStatus SdchFilter::ReadFilteredData(char* dest_buffer,
                                                   int* dest_len) {
   int available_space = *dest_len;
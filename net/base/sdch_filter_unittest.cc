@@ -10,6 +10,7 @@
 
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/strings/stringprintf.h"
 #include "net/base/filter.h"
 #include "net/base/io_buffer.h"
 #include "net/base/mock_filter_context.h"
@@ -206,6 +207,30 @@ TEST_F(SdchFilterTest, PassThroughWhenTentative) {
   EXPECT_EQ(Filter::FILTER_NEED_MORE_DATA, status);
 }
 
+// Tests that data passed through a chain of pass through filters, which hand
+// their buffers down the chain, arrives intact.
+TEST_F(SdchFilterTest, PassThroughChainOfManyBuffers) {
+  std::vector<Filter::FilterType> filter_types;
+  filter_types.push_back(Filter::FILTER_TYPE_SDCH);
+  filter_types.push_back(Filter::FILTER_TYPE_GZIP_HELPING_SDCH);
+  MockFilterContext filter_context;
+  // A 404 response code allows the sdch filter to pass the data through.
+  filter_context.SetResponseCode(404);
+  filter_context.SetURL(GURL("http://ignore.com"));
+  scoped_ptr<Filter> filter(Filter::Factory(filter_types, filter_context));
+  ASSERT_TRUE(filter.get());
+
+  std::string content;
+  while (content.size() < 4u * filter->stream_buffer_size())
+    content.append(base::StringPrintf("neither gzip nor sdch %d\n",
+                                      static_cast<int>(content.size())));
+
+  std::string output;
+  EXPECT_TRUE(FilterTestData(content, filter->stream_buffer_size(), 10000,
+                             filter.get(), &output));
+  EXPECT_EQ(content, output);
+}
+
 TEST_F(SdchFilterTest, RefreshBadReturnCode) {
   std::vector<Filter::FilterType> filter_types;
   // Selective a tentative filter (which can fall back to pass through).
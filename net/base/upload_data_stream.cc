@@ -9,6 +9,7 @@
 #include "net/base/net_errors.h"
 #include "net/base/upload_bytes_element_reader.h"
 #include "net/base/upload_element_reader.h"
+#include "net/base/upload_file_element_reader.h"
 
 namespace net {
 
@@ -112,6 +113,45 @@ void UploadDataStream::AppendChunk(const char* bytes,
   }
 }
 
+UploadFileElementReader* UploadDataStream::GetFileReaderForSend() {
+  DCHECK(initialized_successfully_);
+  if (is_chunked_ || read_failed_)
+    return NULL;
+
+  while (element_index_ < element_readers_.size() &&
+         element_readers_[element_index_]->BytesRemaining() == 0) {
+    ++element_index_;
+  }
+  if (element_index_ == element_readers_.size())
+    return NULL;
+
+  UploadElementReader* reader = element_readers_[element_index_];
+  if (!reader->AsFileReader())
+    return NULL;
+  return static_cast<UploadFileElementReader*>(reader);
+}
+
+void UploadDataStream::DidSendFromFile(int bytes) {
+  DCHECK_LT(element_index_, element_readers_.size());
+  DCHECK(element_readers_[element_index_]->AsFileReader());
+  static_cast<UploadFileElementReader*>(element_readers_[element_index_])
+      ->DidSend(bytes);
+  current_position_ += bytes;
+  DCHECK_GE(total_size_, current_position_);
+}
+
+uint64 UploadDataStream::GetBytesBeforeNextFile() const {
+  DCHECK(initialized_successfully_);
+  uint64 bytes = 0;
+  for (size_t i = element_index_; i < element_readers_.size(); ++i) {
+    const UploadElementReader* reader = element_readers_[i];
+    if (reader->AsFileReader() && reader->BytesRemaining() > 0)
+      return bytes;
+    bytes += reader->BytesRemaining();
+  }
+  return 0;
+}
+
 void UploadDataStream::Reset() {
   weak_ptr_factory_.InvalidateWeakPtrs();
   pending_chunked_read_callback_.Reset();
@@ -17,6 +17,7 @@ namespace net {
 class DrainableIOBuffer;
 class IOBuffer;
 class UploadElementReader;
+class UploadFileElementReader;
 
 // A class to read all elements from an UploadData object.
 class NET_EXPORT UploadDataStream {
@@ -95,6 +96,21 @@ class NET_EXPORT UploadDataStream {
   // Adds the given chunk of bytes to be sent with chunked transfer encoding.
   void AppendChunk(const char* bytes, int bytes_len, bool is_last_chunk);
 
+  // Support for sending files without reading them into memory. Returns the
+  // reader of the element the next bytes of the stream come from if it's a
+  // file that can be sent with UploadFileElementReader::PrepareToSend()
+  // instead of being read with Read(); otherwise returns NULL.
+  UploadFileElementReader* GetFileReaderForSend();
+
+  // Records that |bytes| were sent from the reader returned by
+  // GetFileReaderForSend().
+  void DidSendFromFile(int bytes);
+
+  // Returns the number of bytes to Read() before the next file element, so
+  // that a caller sending files with PrepareToSend() doesn't read into one,
+  // or 0 if no file element follows.
+  uint64 GetBytesBeforeNextFile() const;
+
  private:
   // Resets this instance to the uninitialized state.
   void Reset();
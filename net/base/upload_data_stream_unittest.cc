@@ -356,6 +356,50 @@ TEST_F(UploadDataStreamTest, FileAndBytes) {
   ASSERT_TRUE(stream.IsEOF());
 }
 
+TEST_F(UploadDataStreamTest, SendFromFile) {
+  base::FilePath temp_file_path;
+  ASSERT_TRUE(file_util::CreateTemporaryFileInDir(temp_dir_.path(),
+                                                  &temp_file_path));
+  ASSERT_EQ(static_cast<int>(kTestDataSize),
+            file_util::WriteFile(temp_file_path, kTestData, kTestDataSize));
+
+  // Bytes, a file, and more bytes, like a multipart form.
+  element_readers_.push_back(new UploadBytesElementReader(kTestData, 3));
+  element_readers_.push_back(
+      new UploadFileElementReader(base::MessageLoopProxy::current().get(),
+                                  temp_file_path,
+                                  0,
+                                  kuint64max,
+                                  base::Time()));
+  element_readers_.push_back(new UploadBytesElementReader(kTestData, 5));
+
+  TestCompletionCallback init_callback;
+  UploadDataStream stream(&element_readers_, 0);
+  ASSERT_EQ(ERR_IO_PENDING, stream.Init(init_callback.callback()));
+  ASSERT_EQ(OK, init_callback.WaitForResult());
+
+  // The leading bytes must be read.
+  EXPECT_EQ(NULL, stream.GetFileReaderForSend());
+  EXPECT_EQ(3U, stream.GetBytesBeforeNextFile());
+  scoped_refptr<IOBuffer> buf = new IOBuffer(kTestBufferSize);
+  EXPECT_EQ(3, stream.Read(buf.get(), 3, CompletionCallback()));
+
+  // Then the file can be sent.
+  UploadFileElementReader* reader = stream.GetFileReaderForSend();
+  ASSERT_TRUE(reader);
+  EXPECT_EQ(stream.element_readers()[1], reader);
+  EXPECT_EQ(0U, stream.GetBytesBeforeNextFile());
+  stream.DidSendFromFile(static_cast<int>(kTestDataSize));
+  EXPECT_EQ(3U + kTestDataSize, stream.position());
+  EXPECT_EQ(0U, reader->BytesRemaining());
+
+  // And the trailing bytes read.
+  EXPECT_EQ(NULL, stream.GetFileReaderForSend());
+  EXPECT_EQ(0U, stream.GetBytesBeforeNextFile());
+  EXPECT_EQ(5, stream.Read(buf.get(), kTestBufferSize, CompletionCallback()));
+  EXPECT_TRUE(stream.IsEOF());
+}
+
 TEST_F(UploadDataStreamTest, Chunk) {
   const uint64 kStreamSize = kTestDataSize*2;
   UploadDataStream stream(UploadDataStream::CHUNKED, 0);
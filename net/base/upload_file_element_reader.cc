@@ -4,9 +4,17 @@
 
 #include "net/base/upload_file_element_reader.h"
 
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+#include <fcntl.h>
+#endif
+
+#include <vector>
+
 #include "base/bind.h"
 #include "base/file_util.h"
+#include "base/lazy_instance.h"
 #include "base/location.h"
+#include "base/synchronization/lock.h"
 #include "base/task_runner_util.h"
 #include "net/base/file_stream.h"
 #include "net/base/io_buffer.h"
@@ -20,6 +28,43 @@ namespace {
 // UploadFileElementReader::GetContentLength() when set to non-zero.
 uint64 overriding_content_length = 0;
 
+// The number of idle read-ahead buffers kept for reuse.
+const size_t kMaxIdleReadAheadBuffers = 4;
+
+// Recycles read-ahead buffers, so that large uploads don't keep allocating
+// and freeing them.
+class ReadAheadBufferPool {
+ public:
+  ReadAheadBufferPool() {}
+
+  scoped_refptr<IOBuffer> Get() {
+    {
+      base::AutoLock lock(lock_);
+      if (!buffers_.empty()) {
+        scoped_refptr<IOBuffer> buffer = buffers_.back();
+        buffers_.pop_back();
+        return buffer;
+      }
+    }
+    return new IOBuffer(UploadFileElementReader::kReadAheadBufferSize);
+  }
+
+  void Put(const scoped_refptr<IOBuffer>& buffer) {
+    base::AutoLock lock(lock_);
+    if (buffers_.size() < kMaxIdleReadAheadBuffers)
+      buffers_.push_back(buffer);
+  }
+
+ private:
+  base::Lock lock_;
+  std::vector<scoped_refptr<IOBuffer> > buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReadAheadBufferPool);
+};
+
+base::LazyInstance<ReadAheadBufferPool>::Leaky g_read_ahead_buffer_pool =
+    LAZY_INSTANCE_INITIALIZER;
+
 // This function is used to implement Init().
 template<typename FileStreamDeleter>
 int InitInternal(const base::FilePath& path,
@@ -90,8 +135,34 @@ int ReadInternal(scoped_refptr<IOBuffer> buf,
   return result;
 }
 
+// This function is used to implement PrepareToSend().
+int PrepareToSendInternal(int length,
+                          uint64 bytes_remaining,
+                          FileStream* file_stream) {
+  DCHECK_LT(0, length);
+  DCHECK(file_stream);  // file_stream is non-null if content_length_ > 0.
+
+  const uint64 num_bytes_to_prepare =
+      std::min(bytes_remaining, static_cast<uint64>(length));
+  const int64 offset = file_stream->SeekSync(FROM_CURRENT, 0);
+  if (offset < 0)
+    return static_cast<int>(offset);
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  // readahead() returns once the bytes are in the page cache. Failing to
+  // read ahead only means that sending may block.
+  if (readahead(file_stream->GetPlatformFile(), offset,
+                num_bytes_to_prepare) != 0) {
+    DPLOG(WARNING) << "readahead";
+  }
+#endif
+  return static_cast<int>(num_bytes_to_prepare);
+}
+
 }  // namespace
 
+const uint64 UploadFileElementReader::kReadAheadMinLength = 1024 * 1024;
+const int UploadFileElementReader::kReadAheadBufferSize = 256 * 1024;
+
 UploadFileElementReader::FileStreamDeleter::FileStreamDeleter(
     base::TaskRunner* task_runner) : task_runner_(task_runner) {
   DCHECK(task_runner_.get());
@@ -122,11 +193,17 @@ UploadFileElementReader::UploadFileElementReader(
       file_stream_(NULL, FileStreamDeleter(task_runner_.get())),
       content_length_(0),
       bytes_remaining_(0),
+      read_ahead_size_(0),
+      read_ahead_offset_(0),
+      read_ahead_pending_(false),
+      bytes_unread_(0),
+      pending_read_buf_length_(0),
       weak_ptr_factory_(this) {
   DCHECK(task_runner_.get());
 }
 
 UploadFileElementReader::~UploadFileElementReader() {
+  ReleaseReadAheadBuffer();
 }
 
 const UploadFileElementReader* UploadFileElementReader::AsFileReader() const {
@@ -177,6 +254,17 @@ int UploadFileElementReader::Read(IOBuffer* buf,
   if (BytesRemaining() == 0)
     return 0;
 
+  if (content_length_ >= kReadAheadMinLength) {
+    if (read_ahead_size_ != 0)
+      return ConsumeReadAhead(buf, buf_length);
+    if (!read_ahead_pending_)
+      StartReadAhead();
+    pending_read_buf_ = buf;
+    pending_read_buf_length_ = buf_length;
+    pending_read_callback_ = callback;
+    return ERR_IO_PENDING;
+  }
+
   // Save the value of file_stream_.get() before base::Passed() invalidates it.
   FileStream* file_stream_ptr = file_stream_.get();
   // Pass the ownership of file_stream_ to the worker pool to safely perform
@@ -197,11 +285,57 @@ int UploadFileElementReader::Read(IOBuffer* buf,
   return ERR_IO_PENDING;
 }
 
+int UploadFileElementReader::PrepareToSend(
+    int length,
+    const CompletionCallback& callback) {
+  DCHECK(!callback.is_null());
+  DCHECK(!read_ahead_pending_);
+  DCHECK_EQ(0, read_ahead_size_);
+
+  if (BytesRemaining() == 0)
+    return 0;
+
+  FileStream* file_stream_ptr = file_stream_.get();
+  const bool posted = base::PostTaskAndReplyWithResult(
+      task_runner_.get(),
+      FROM_HERE,
+      base::Bind(&PrepareToSendInternal,
+                 length,
+                 BytesRemaining(),
+                 file_stream_ptr),
+      base::Bind(&UploadFileElementReader::OnPrepareToSendCompleted,
+                 weak_ptr_factory_.GetWeakPtr(),
+                 base::Passed(&file_stream_),
+                 callback));
+  DCHECK(posted);
+  return ERR_IO_PENDING;
+}
+
+base::PlatformFile UploadFileElementReader::platform_file() const {
+  DCHECK(file_stream_.get());
+  return file_stream_->GetPlatformFile();
+}
+
+void UploadFileElementReader::DidSend(int bytes) {
+  DCHECK_LE(0, bytes);
+  DCHECK_GE(bytes_remaining_, static_cast<uint64>(bytes));
+  bytes_remaining_ -= bytes;
+  bytes_unread_ -= bytes;
+}
+
 void UploadFileElementReader::Reset() {
   weak_ptr_factory_.InvalidateWeakPtrs();
   bytes_remaining_ = 0;
   content_length_ = 0;
   file_stream_.reset();
+  ReleaseReadAheadBuffer();
+  read_ahead_size_ = 0;
+  read_ahead_offset_ = 0;
+  read_ahead_pending_ = false;
+  bytes_unread_ = 0;
+  pending_read_buf_ = NULL;
+  pending_read_buf_length_ = 0;
+  pending_read_callback_.Reset();
 }
 
 void UploadFileElementReader::OnInitCompleted(
@@ -212,6 +346,7 @@ void UploadFileElementReader::OnInitCompleted(
   file_stream_.swap(*file_stream);
   content_length_ = *content_length;
   bytes_remaining_ = GetContentLength();
+  bytes_unread_ = bytes_remaining_;
   if (!callback.is_null())
     callback.Run(result);
 }
@@ -224,11 +359,99 @@ void UploadFileElementReader::OnReadCompleted(
   if (result > 0) {
     DCHECK_GE(bytes_remaining_, static_cast<uint64>(result));
     bytes_remaining_ -= result;
+    bytes_unread_ -= result;
   }
   if (!callback.is_null())
     callback.Run(result);
 }
 
+void UploadFileElementReader::StartReadAhead() {
+  DCHECK(!read_ahead_pending_);
+  DCHECK_EQ(0, read_ahead_size_);
+  DCHECK_LT(0U, bytes_unread_);
+
+  if (!read_ahead_buf_.get())
+    read_ahead_buf_ = g_read_ahead_buffer_pool.Get().Get();
+  read_ahead_pending_ = true;
+  read_ahead_offset_ = 0;
+
+  FileStream* file_stream_ptr = file_stream_.get();
+  const bool posted = base::PostTaskAndReplyWithResult(
+      task_runner_.get(),
+      FROM_HERE,
+      base::Bind(&ReadInternal,
+                 read_ahead_buf_,
+                 kReadAheadBufferSize,
+                 bytes_unread_,
+                 file_stream_ptr),
+      base::Bind(&UploadFileElementReader::OnReadAheadCompleted,
+                 weak_ptr_factory_.GetWeakPtr(),
+                 base::Passed(&file_stream_)));
+  DCHECK(posted);
+}
+
+void UploadFileElementReader::OnReadAheadCompleted(
+    ScopedFileStreamPtr file_stream,
+    int result) {
+  DCHECK(read_ahead_pending_);
+  DCHECK_NE(0, result);  // ReadInternal() maps a premature EOF to an error.
+  file_stream_.swap(file_stream);
+  read_ahead_pending_ = false;
+  read_ahead_size_ = result;
+  if (result > 0)
+    bytes_unread_ -= result;
+
+  if (pending_read_callback_.is_null())
+    return;
+  scoped_refptr<IOBuffer> buf;
+  buf.swap(pending_read_buf_);
+  CompletionCallback callback = pending_read_callback_;
+  pending_read_callback_.Reset();
+  callback.Run(ConsumeReadAhead(buf.get(), pending_read_buf_length_));
+}
+
+int UploadFileElementReader::ConsumeReadAhead(IOBuffer* buf, int buf_length) {
+  DCHECK_NE(0, read_ahead_size_);
+  // The error sticks, like a failing read would keep failing.
+  if (read_ahead_size_ < 0)
+    return read_ahead_size_;
+
+  const int num_bytes = std::min(buf_length,
+                                 read_ahead_size_ - read_ahead_offset_);
+  memcpy(buf->data(), read_ahead_buf_->data() + read_ahead_offset_,
+         num_bytes);
+  read_ahead_offset_ += num_bytes;
+  DCHECK_GE(bytes_remaining_, static_cast<uint64>(num_bytes));
+  bytes_remaining_ -= num_bytes;
+
+  if (read_ahead_offset_ == read_ahead_size_) {
+    read_ahead_size_ = 0;
+    read_ahead_offset_ = 0;
+    // Read the next bytes while the caller sends these.
+    if (bytes_unread_ > 0)
+      StartReadAhead();
+    else
+      ReleaseReadAheadBuffer();
+  }
+  return num_bytes;
+}
+
+void UploadFileElementReader::ReleaseReadAheadBuffer() {
+  // A buffer that a read on the file task runner still refers to can't be
+  // reused yet.
+  if (read_ahead_buf_.get() && read_ahead_buf_->HasOneRef())
+    g_read_ahead_buffer_pool.Get().Put(read_ahead_buf_);
+  read_ahead_buf_ = NULL;
+}
+
+void UploadFileElementReader::OnPrepareToSendCompleted(
+    ScopedFileStreamPtr file_stream,
+    const CompletionCallback& callback,
+    int result) {
+  file_stream_.swap(file_stream);
+  callback.Run(result);
+}
+
 UploadFileElementReader::ScopedOverridingContentLengthForTests::
 ScopedOverridingContentLengthForTests(uint64 value) {
   overriding_content_length = value;
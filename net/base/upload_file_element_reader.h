@@ -11,6 +11,7 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/platform_file.h"
 #include "base/time/time.h"
 #include "net/base/upload_element_reader.h"
 
@@ -23,8 +24,17 @@ namespace net {
 class FileStream;
 
 // An UploadElementReader implementation for file.
+//
+// Large files are read ahead: while the caller sends the bytes of one Read(),
+// the next bytes are already being read on the file task runner.
 class NET_EXPORT UploadFileElementReader : public UploadElementReader {
  public:
+  // Files at least this long are read ahead.
+  static const uint64 kReadAheadMinLength;
+
+  // The number of bytes read ahead at a time.
+  static const int kReadAheadBufferSize;
+
   // |task_runner| is used to perform file operations. It must not be NULL.
   UploadFileElementReader(base::TaskRunner* task_runner,
                           const base::FilePath& path,
@@ -49,6 +59,25 @@ class NET_EXPORT UploadFileElementReader : public UploadElementReader {
                    int buf_length,
                    const CompletionCallback& callback) OVERRIDE;
 
+  // Support for sending the file with StreamSocket::SendFile() rather than
+  // reading it into memory. This is an alternative to Read(); a caller that
+  // has started with one may only switch to the other when everything it got
+  // has been consumed.
+  //
+  // Loads up to |length| of the next bytes of the file into the page cache
+  // on the file task runner, so that sending them doesn't block on the disk.
+  // Returns 0 if no bytes remain; otherwise returns ERR_IO_PENDING and runs
+  // |callback| with the number of bytes ready to be sent from
+  // platform_file(), or an error.
+  int PrepareToSend(int length, const CompletionCallback& callback);
+
+  // The file to send the prepared bytes from. Its position is that of the
+  // first byte not sent yet.
+  base::PlatformFile platform_file() const;
+
+  // Records that |bytes| of the prepared bytes were sent.
+  void DidSend(int bytes);
+
  private:
   // Deletes FileStream with |task_runner| to avoid blocking the IO thread.
   // This class is used as a template argument of scoped_ptr.
@@ -86,6 +115,18 @@ class NET_EXPORT UploadFileElementReader : public UploadElementReader {
                        const CompletionCallback& callback,
                        int result);
 
+  // Methods used to implement Read() with read-ahead.
+  void StartReadAhead();
+  void OnReadAheadCompleted(ScopedFileStreamPtr file_stream, int result);
+  // Hands the bytes read ahead, or the read-ahead error, over to |buf|.
+  int ConsumeReadAhead(IOBuffer* buf, int buf_length);
+  void ReleaseReadAheadBuffer();
+
+  // This method is used to implement PrepareToSend().
+  void OnPrepareToSendCompleted(ScopedFileStreamPtr file_stream,
+                                const CompletionCallback& callback,
+                                int result);
+
   // Sets an value to override the result for GetContentLength().
   // Used for tests.
   struct NET_EXPORT_PRIVATE ScopedOverridingContentLengthForTests {
@@ -101,6 +142,22 @@ class NET_EXPORT UploadFileElementReader : public UploadElementReader {
   ScopedFileStreamPtr file_stream_;
   uint64 content_length_;
   uint64 bytes_remaining_;
+
+  // Read-ahead state. |read_ahead_size_| is the number of bytes in
+  // |read_ahead_buf_|, or the error the read-ahead failed with, and
+  // |read_ahead_offset_| the number of them already handed out.
+  // |bytes_unread_| is the number of bytes not read from the file yet.
+  scoped_refptr<IOBuffer> read_ahead_buf_;
+  int read_ahead_size_;
+  int read_ahead_offset_;
+  bool read_ahead_pending_;
+  uint64 bytes_unread_;
+
+  // A Read() waiting for the pending read-ahead.
+  scoped_refptr<IOBuffer> pending_read_buf_;
+  int pending_read_buf_length_;
+  CompletionCallback pending_read_callback_;
+
   base::WeakPtrFactory<UploadFileElementReader> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(UploadFileElementReader);
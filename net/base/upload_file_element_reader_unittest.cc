@@ -7,6 +7,7 @@
 #include "base/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/message_loop/message_loop_proxy.h"
+#include "base/platform_file.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
 #include "net/base/test_completion_callback.h"
@@ -229,6 +230,91 @@ TEST_F(UploadFileElementReaderTest, WrongPath) {
   EXPECT_EQ(0U, reader_->BytesRemaining());
 }
 
+TEST_F(UploadFileElementReaderTest, ReadAhead) {
+  // Large enough to be read ahead, and to end in a partial read-ahead.
+  const size_t kSize = UploadFileElementReader::kReadAheadMinLength +
+      UploadFileElementReader::kReadAheadBufferSize / 2 + 1;
+  std::vector<char> bytes(kSize);
+  for (size_t i = 0; i < kSize; ++i)
+    bytes[i] = static_cast<char>(i % 251);
+  ASSERT_EQ(static_cast<int>(kSize),
+            file_util::WriteFile(temp_file_path_, &bytes[0], kSize));
+  reader_.reset(
+      new UploadFileElementReader(base::MessageLoopProxy::current().get(),
+                                  temp_file_path_,
+                                  0,
+                                  kuint64max,
+                                  base::Time()));
+  TestCompletionCallback init_callback;
+  ASSERT_EQ(ERR_IO_PENDING, reader_->Init(init_callback.callback()));
+  ASSERT_EQ(OK, init_callback.WaitForResult());
+
+  // Reads the bytes read ahead synchronously, as long as the next read-ahead
+  // has completed by the time they are used up.
+  std::vector<char> buf;
+  const int kReadSize = 16 * 1024;
+  scoped_refptr<IOBuffer> read_buf(new IOBuffer(kReadSize));
+  int sync_reads = 0;
+  while (reader_->BytesRemaining() > 0) {
+    TestCompletionCallback read_callback;
+    int result = reader_->Read(read_buf.get(), kReadSize,
+                               read_callback.callback());
+    if (result != ERR_IO_PENDING)
+      ++sync_reads;
+    result = read_callback.GetResult(result);
+    ASSERT_LT(0, result);
+    buf.insert(buf.end(), read_buf->data(), read_buf->data() + result);
+  }
+  EXPECT_LT(0, sync_reads);
+  EXPECT_TRUE(bytes == buf);
+}
+
+TEST_F(UploadFileElementReaderTest, PrepareToSend) {
+  UploadFileElementReader reader(base::MessageLoopProxy::current().get(),
+                                 temp_file_path_,
+                                 0,
+                                 kuint64max,
+                                 base::Time());
+  TestCompletionCallback init_callback;
+  ASSERT_EQ(ERR_IO_PENDING, reader.Init(init_callback.callback()));
+  ASSERT_EQ(OK, init_callback.WaitForResult());
+
+  TestCompletionCallback prepare_callback1;
+  ASSERT_EQ(ERR_IO_PENDING,
+            reader.PrepareToSend(4, prepare_callback1.callback()));
+  EXPECT_EQ(4, prepare_callback1.WaitForResult());
+
+  // Send the prepared bytes the way a socket would, from the file position.
+  char sent[4];
+  ASSERT_EQ(4, base::ReadPlatformFileCurPosNoBestEffort(reader.platform_file(),
+                                                        sent, 4));
+  EXPECT_EQ(std::vector<char>(bytes_.begin(), bytes_.begin() + 4),
+            std::vector<char>(sent, sent + 4));
+  reader.DidSend(4);
+  EXPECT_EQ(bytes_.size() - 4, reader.BytesRemaining());
+
+  // No more than what remains is prepared.
+  TestCompletionCallback prepare_callback2;
+  ASSERT_EQ(ERR_IO_PENDING,
+            reader.PrepareToSend(1024, prepare_callback2.callback()));
+  EXPECT_EQ(static_cast<int>(bytes_.size() - 4),
+            prepare_callback2.WaitForResult());
+
+  // Reading picks up after the bytes sent.
+  std::vector<char> buf(bytes_.size());
+  scoped_refptr<IOBuffer> wrapped_buffer = new WrappedIOBuffer(&buf[0]);
+  TestCompletionCallback read_callback;
+  ASSERT_EQ(ERR_IO_PENDING,
+            reader.Read(wrapped_buffer.get(), buf.size(),
+                        read_callback.callback()));
+  EXPECT_EQ(static_cast<int>(bytes_.size() - 4), read_callback.WaitForResult());
+  EXPECT_EQ(std::vector<char>(bytes_.begin() + 4, bytes_.end()),
+            std::vector<char>(buf.begin(), buf.begin() + bytes_.size() - 4));
+  EXPECT_EQ(0U, reader.BytesRemaining());
+  TestCompletionCallback prepare_callback3;
+  EXPECT_EQ(0, reader.PrepareToSend(1024, prepare_callback3.callback()));
+}
+
 
 class UploadFileElementReaderSyncTest : public PlatformTest {
  protected:
@@ -13,4 +13,11 @@ CertVerifier* CertVerifier::CreateDefault() {
   return new MultiThreadedCertVerifier(CertVerifyProc::CreateDefault());
 }
 
+CertVerifier* CertVerifier::CreateDefaultWithSharedCache() {
+  MultiThreadedCertVerifier* verifier =
+      new MultiThreadedCertVerifier(CertVerifyProc::CreateDefault());
+  verifier->SetUseSharedCache(true);
+  return verifier;
+}
+
 }  // namespace net
@@ -117,6 +117,10 @@ class NET_EXPORT CertVerifier {
   // Creates a CertVerifier implementation that verifies certificates using
   // the preferred underlying cryptographic libraries.
   static CertVerifier* CreateDefault();
+
+  // Like CreateDefault(), but the returned verifier shares its results with
+  // the other verifiers created by this function in the process.
+  static CertVerifier* CreateDefaultWithSharedCache();
 };
 
 }  // namespace net
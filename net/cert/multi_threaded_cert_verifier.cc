@@ -9,6 +9,7 @@
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/compiler_specific.h"
+#include "base/lazy_instance.h"
 #include "base/message_loop/message_loop.h"
 #include "base/metrics/histogram.h"
 #include "base/stl_util.h"
@@ -78,6 +79,13 @@ const unsigned kMaxCacheEntries = 256;
 // The number of seconds for which we'll cache a cache entry.
 const unsigned kTTLSecs = 1800;  // 30 minutes.
 
+// The default size of the cache shared by verifiers, see
+// MultiThreadedCertVerifier::SetUseSharedCache().
+const size_t kDefaultMaxSharedCacheEntries = 1024;
+
+size_t g_max_shared_cache_entries = kDefaultMaxSharedCacheEntries;
+bool g_shared_cache_created = false;
+
 }  // namespace
 
 MultiThreadedCertVerifier::CachedResult::CachedResult() : error(ERR_FAILED) {}
@@ -388,9 +396,54 @@ class CertVerifierJob {
   const BoundNetLog net_log_;
 };
 
+// Verifiers may live on different threads, so the shared cache is guarded by
+// a lock.
+class MultiThreadedCertVerifier::SharedCache {
+ public:
+  SharedCache() : cache_(g_max_shared_cache_entries) {
+    g_shared_cache_created = true;
+  }
+
+  bool Get(const RequestParams& key, CachedResult* result) {
+    base::AutoLock lock(lock_);
+    const CertVerifierCache::value_type* entry =
+        cache_.Get(key, CacheValidityPeriod(base::Time::Now()));
+    if (!entry)
+      return false;
+    *result = *entry;
+    return true;
+  }
+
+  void Put(const RequestParams& key,
+           const CachedResult& result,
+           const base::Time& now) {
+    base::AutoLock lock(lock_);
+    cache_.Put(key, result, CacheValidityPeriod(now),
+               CacheValidityPeriod(
+                   now, now + base::TimeDelta::FromSeconds(kTTLSecs)));
+  }
+
+  void Clear() {
+    base::AutoLock lock(lock_);
+    cache_.Clear();
+  }
+
+  size_t size() {
+    base::AutoLock lock(lock_);
+    return cache_.size();
+  }
+
+ private:
+  base::Lock lock_;
+  CertVerifierCache cache_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedCache);
+};
+
 MultiThreadedCertVerifier::MultiThreadedCertVerifier(
     CertVerifyProc* verify_proc)
     : cache_(kMaxCacheEntries),
+      use_shared_cache_(false),
       requests_(0),
       cache_hits_(0),
       inflight_joins_(0),
@@ -410,6 +463,45 @@ void MultiThreadedCertVerifier::SetCertTrustAnchorProvider(
   trust_anchor_provider_ = trust_anchor_provider;
 }
 
+void MultiThreadedCertVerifier::SetUseSharedCache(bool use_shared_cache) {
+  DCHECK(CalledOnValidThread());
+  DCHECK_EQ(0u, requests_);
+  use_shared_cache_ = use_shared_cache;
+}
+
+// static
+void MultiThreadedCertVerifier::SetSharedCacheSize(size_t max_entries) {
+  DCHECK(!g_shared_cache_created);
+  g_max_shared_cache_entries = max_entries;
+}
+
+// static
+MultiThreadedCertVerifier::SharedCache*
+MultiThreadedCertVerifier::GetSharedCache() {
+  static base::LazyInstance<SharedCache>::Leaky shared_cache =
+      LAZY_INSTANCE_INITIALIZER;
+  return shared_cache.Pointer();
+}
+
+const MultiThreadedCertVerifier::CachedResult*
+MultiThreadedCertVerifier::GetCachedResult(const RequestParams& key,
+                                           CachedResult* storage) {
+  if (use_shared_cache_)
+    return GetSharedCache()->Get(key, storage) ? storage : NULL;
+  return cache_.Get(key, CacheValidityPeriod(base::Time::Now()));
+}
+
+void MultiThreadedCertVerifier::ClearCache() {
+  if (use_shared_cache_)
+    GetSharedCache()->Clear();
+  else
+    cache_.Clear();
+}
+
+size_t MultiThreadedCertVerifier::GetCacheSize() const {
+  return use_shared_cache_ ? GetSharedCache()->size() : cache_.size();
+}
+
 int MultiThreadedCertVerifier::Verify(X509Certificate* cert,
                                       const std::string& hostname,
                                       int flags,
@@ -434,8 +526,8 @@ int MultiThreadedCertVerifier::Verify(X509Certificate* cert,
 
   const RequestParams key(cert->fingerprint(), cert->ca_fingerprint(),
                           hostname, flags, additional_trust_anchors);
-  const CertVerifierCache::value_type* cached_entry =
-      cache_.Get(key, CacheValidityPeriod(base::Time::Now()));
+  CachedResult cached_result;
+  const CachedResult* cached_entry = GetCachedResult(key, &cached_result);
   if (cached_entry) {
     ++cache_hits_;
     *out_req = NULL;
@@ -539,9 +631,14 @@ void MultiThreadedCertVerifier::HandleResult(
   cached_result.error = error;
   cached_result.result = verify_result;
   base::Time now = base::Time::Now();
-  cache_.Put(
-      key, cached_result, CacheValidityPeriod(now),
-      CacheValidityPeriod(now, now + base::TimeDelta::FromSeconds(kTTLSecs)));
+  if (use_shared_cache_) {
+    GetSharedCache()->Put(key, cached_result, now);
+  } else {
+    cache_.Put(
+        key, cached_result, CacheValidityPeriod(now),
+        CacheValidityPeriod(now,
+                            now + base::TimeDelta::FromSeconds(kTTLSecs)));
+  }
 
   std::map<RequestParams, CertVerifierJob*>::iterator j;
   j = inflight_.find(key);
@@ -53,6 +53,16 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
   void SetCertTrustAnchorProvider(
       CertTrustAnchorProvider* trust_anchor_provider);
 
+  // Makes this verifier keep its results in a cache shared by all the
+  // verifiers in the process that use it, instead of its own. Only verifiers
+  // whose CertVerifyProc gives the same answers for the same inputs should
+  // share it. Must be called before the first Verify().
+  void SetUseSharedCache(bool use_shared_cache);
+
+  // Sets the number of results the shared cache holds. Must be called before
+  // any verifier uses the shared cache.
+  static void SetSharedCacheSize(size_t max_entries);
+
   // CertVerifier implementation
   virtual int Verify(X509Certificate* cert,
                      const std::string& hostname,
@@ -78,6 +88,7 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
                            RequestParamsComparators);
   FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest,
                            CertTrustAnchorProvider);
+  FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest, SharedCache);
 
   // Input parameters of a certificate verification request.
   struct NET_EXPORT_PRIVATE RequestParams {
@@ -129,6 +140,15 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
   typedef ExpiringCache<RequestParams, CachedResult, CacheValidityPeriod,
                         CacheExpirationFunctor> CertVerifierCache;
 
+  // The process-wide cache used by verifiers with SetUseSharedCache().
+  class SharedCache;
+  static SharedCache* GetSharedCache();
+
+  // Looks up |key| in the cache this verifier uses. Returns NULL on a miss,
+  // or |storage| filled with the result.
+  const CachedResult* GetCachedResult(const RequestParams& key,
+                                      CachedResult* storage);
+
   void HandleResult(X509Certificate* cert,
                     const std::string& hostname,
                     int flags,
@@ -140,8 +160,8 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
   virtual void OnCertTrustChanged(const X509Certificate* cert) OVERRIDE;
 
   // For unit testing.
-  void ClearCache() { cache_.Clear(); }
-  size_t GetCacheSize() const { return cache_.size(); }
+  void ClearCache();
+  size_t GetCacheSize() const;
   uint64 cache_hits() const { return cache_hits_; }
   uint64 requests() const { return requests_; }
   uint64 inflight_joins() const { return inflight_joins_; }
@@ -149,6 +169,9 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
   // cache_ maps from a request to a cached result.
   CertVerifierCache cache_;
 
+  // Whether GetSharedCache() is used instead of |cache_|.
+  bool use_shared_cache_;
+
   // inflight_ maps from a request to an active verification which is taking
   // place.
   std::map<RequestParams, CertVerifierJob*> inflight_;
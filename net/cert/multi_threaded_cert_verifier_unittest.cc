@@ -121,6 +121,70 @@ TEST_F(MultiThreadedCertVerifierTest, CacheHit) {
   ASSERT_EQ(1u, verifier_.GetCacheSize());
 }
 
+// Tests that a result verified by one verifier is a cache hit for another
+// verifier using the shared cache, and not for one using its own cache.
+TEST_F(MultiThreadedCertVerifierTest, SharedCache) {
+  base::FilePath certs_dir = GetTestCertsDirectory();
+  scoped_refptr<X509Certificate> test_cert(
+      ImportCertFromFile(certs_dir, "ok_cert.pem"));
+  ASSERT_NE(static_cast<X509Certificate*>(NULL), test_cert);
+
+  MultiThreadedCertVerifier shared_verifier1(new MockCertVerifyProc());
+  shared_verifier1.SetUseSharedCache(true);
+  shared_verifier1.ClearCache();
+  MultiThreadedCertVerifier shared_verifier2(new MockCertVerifyProc());
+  shared_verifier2.SetUseSharedCache(true);
+
+  int error;
+  CertVerifyResult verify_result;
+  TestCompletionCallback callback;
+  CertVerifier::RequestHandle request_handle;
+
+  error = shared_verifier1.Verify(test_cert.get(),
+                                  "www.example.com",
+                                  0,
+                                  NULL,
+                                  &verify_result,
+                                  callback.callback(),
+                                  &request_handle,
+                                  BoundNetLog());
+  ASSERT_EQ(ERR_IO_PENDING, error);
+  error = callback.WaitForResult();
+  ASSERT_TRUE(IsCertificateError(error));
+  ASSERT_EQ(1u, shared_verifier1.GetCacheSize());
+  ASSERT_EQ(1u, shared_verifier2.GetCacheSize());
+  ASSERT_EQ(0u, verifier_.GetCacheSize());
+
+  error = shared_verifier2.Verify(test_cert.get(),
+                                  "www.example.com",
+                                  0,
+                                  NULL,
+                                  &verify_result,
+                                  callback.callback(),
+                                  &request_handle,
+                                  BoundNetLog());
+  // Synchronous completion.
+  ASSERT_NE(ERR_IO_PENDING, error);
+  ASSERT_TRUE(IsCertificateError(error));
+  ASSERT_TRUE(request_handle == NULL);
+  ASSERT_EQ(1u, shared_verifier2.cache_hits());
+
+  error = verifier_.Verify(test_cert.get(),
+                           "www.example.com",
+                           0,
+                           NULL,
+                           &verify_result,
+                           callback.callback(),
+                           &request_handle,
+                           BoundNetLog());
+  ASSERT_EQ(ERR_IO_PENDING, error);
+  error = callback.WaitForResult();
+  ASSERT_TRUE(IsCertificateError(error));
+  ASSERT_EQ(0u, verifier_.cache_hits());
+
+  shared_verifier1.ClearCache();
+}
+
 // Tests the same server certificate with different intermediate CA
 // certificates.  These should be treated as different certificate chains even
 // though the two X509Certificate objects contain the same server certificate.
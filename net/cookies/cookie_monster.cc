@@ -1661,25 +1661,37 @@ void CookieMonster::FindCookiesForHostAndDomain(
   // want to collect statistics whenever the browser's being used.
   RecordPeriodicStats(current_time);
 
-  // Can just dispatch to FindCookiesForKey
-  const std::string key(GetKey(url.host()));
-  FindCookiesForKey(key, url, options, current_time,
-                    update_access_time, cookies);
-}
-
-void CookieMonster::FindCookiesForKey(const std::string& key,
-                                      const GURL& url,
-                                      const CookieOptions& options,
-                                      const Time& current,
-                                      bool update_access_time,
-                                      std::vector<CanonicalCookie*>* cookies) {
+  // A host cookie only matches its own host, and a domain cookie matches
+  // hosts ending in its domain, so only these domains need to be visited.
+  const std::string host(url.host());
+  FindCookiesForDomain(host, url, options, current_time,
+                       update_access_time, cookies);
+  for (size_t dot = 0; dot != std::string::npos;
+       dot = host.find('.', dot + 1)) {
+    FindCookiesForDomain(dot == 0 ? "." + host : host.substr(dot), url,
+                         options, current_time, update_access_time, cookies);
+  }
+}
+
+void CookieMonster::FindCookiesForDomain(
+    const std::string& domain,
+    const GURL& url,
+    const CookieOptions& options,
+    const Time& current,
+    bool update_access_time,
+    std::vector<CanonicalCookie*>* cookies) {
   lock_.AssertAcquired();
 
-  for (CookieMapItPair its = cookies_.equal_range(key);
-       its.first != its.second; ) {
-    CookieMap::iterator curit = its.first;
+  CookieDomainIndex::const_iterator index_it = domain_index_.find(domain);
+  if (index_it == domain_index_.end())
+    return;
+
+  // Copied, as deleting expired cookies modifies the index.
+  const CookieItVector cookie_its(index_it->second);
+  for (CookieItVector::const_iterator it = cookie_its.begin();
+       it != cookie_its.end(); ++it) {
+    CookieMap::iterator curit = *it;
     CanonicalCookie* cc = curit->second;
-    ++its.first;
 
     // If the cookie is expired, delete it.
     if (cc->IsExpired(current) && !keep_expired_cookies_) {
@@ -1741,7 +1753,9 @@ void CookieMonster::InternalInsertCookie(const std::string& key,
   if ((cc->IsPersistent() || persist_session_cookies_) && store_.get() &&
       sync_to_store)
     store_->AddCookie(*cc);
-  cookies_.insert(CookieMap::value_type(key, cc));
+  CookieMap::iterator inserted =
+      cookies_.insert(CookieMap::value_type(key, cc));
+  domain_index_[cc->Domain()].push_back(inserted);
   if (delegate_.get()) {
     delegate_->OnCookieChanged(
         *cc, false, CookieMonster::Delegate::CHANGE_COOKIE_EXPLICIT);
@@ -1858,6 +1872,17 @@ void CookieMonster::InternalDeleteCookie(CookieMap::iterator it,
     if (mapping.notify)
       delegate_->OnCookieChanged(*cc, true, mapping.cause);
   }
+  CookieDomainIndex::iterator index_it = domain_index_.find(cc->Domain());
+  DCHECK(index_it != domain_index_.end());
+  CookieItVector& domain_its = index_it->second;
+  CookieItVector::iterator domain_it =
+      std::find(domain_its.begin(), domain_its.end(), it);
+  DCHECK(domain_it != domain_its.end());
+  *domain_it = domain_its.back();
+  domain_its.pop_back();
+  if (domain_its.empty())
+    domain_index_.erase(index_it);
+
   cookies_.erase(it);
   delete cc;
 }
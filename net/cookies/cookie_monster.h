@@ -17,6 +17,7 @@
 
 #include "base/basictypes.h"
 #include "base/callback_forward.h"
+#include "base/containers/hash_tables.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
@@ -108,6 +109,12 @@ class NET_EXPORT CookieMonster : public CookieStore {
   typedef std::pair<CookieMap::iterator, CookieMap::iterator> CookieMapItPair;
   typedef std::vector<CookieMap::iterator> CookieItVector;
 
+  // A secondary index of CookieMap by the exact Domain() of the cookies, so
+  // that a lookup only visits the cookies whose domain can match the host,
+  // rather than every cookie under its eTLD+1. Ad-heavy sites keep up to
+  // kDomainMaxCookies cookies spread over many subdomains of one eTLD+1.
+  typedef base::hash_map<std::string, CookieItVector> CookieDomainIndex;
+
   // Cookie garbage collection thresholds.  Based off of the Mozilla defaults.
   // When the number of cookies gets to k{Domain,}MaxCookies
   // purge down to k{Domain,}MaxCookies - k{Domain,}PurgeCookies.
@@ -345,7 +352,7 @@ class NET_EXPORT CookieMonster : public CookieStore {
   FRIEND_TEST_ALL_PREFIXES(CookieMonsterTest, GetKey);
   FRIEND_TEST_ALL_PREFIXES(CookieMonsterTest, TestGetKey);
 
-  // For FindCookiesForKey.
+  // For FindCookiesForDomain.
   FRIEND_TEST_ALL_PREFIXES(CookieMonsterTest, ShortLivedSessionCookies);
 
   // Internal reasons for deletion, used to populate informative histograms
@@ -499,12 +506,14 @@ class NET_EXPORT CookieMonster : public CookieStore {
                                    bool update_access_time,
                                    std::vector<CanonicalCookie*>* cookies);
 
-  void FindCookiesForKey(const std::string& key,
-                         const GURL& url,
-                         const CookieOptions& options,
-                         const base::Time& current,
-                         bool update_access_time,
-                         std::vector<CanonicalCookie*>* cookies);
+  // Appends the cookies with Domain() |domain| that should be sent with a
+  // request to |url|, and deletes the expired ones.
+  void FindCookiesForDomain(const std::string& domain,
+                            const GURL& url,
+                            const CookieOptions& options,
+                            const base::Time& current,
+                            bool update_access_time,
+                            std::vector<CanonicalCookie*>* cookies);
 
   // Delete any cookies that are equivalent to |ecc| (same path, domain, etc).
   // If |skip_httponly| is true, httponly cookies will not be deleted.  The
@@ -614,6 +623,10 @@ class NET_EXPORT CookieMonster : public CookieStore {
 
   CookieMap cookies_;
 
+  // Kept in sync with |cookies_| by InternalInsertCookie() and
+  // InternalDeleteCookie().
+  CookieDomainIndex domain_index_;
+
   // Indicates whether the cookie store has been initialized. This happens
   // lazily in InitStoreIfNecessary().
   bool initialized_;
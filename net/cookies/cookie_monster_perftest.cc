@@ -312,6 +312,48 @@ TEST_F(CookieMonsterTest, TestImport) {
   EXPECT_EQ("domain_1.com", cm->GetKey("www.Domain_1.com"));
 }
 
+// Loads a store of 100k cookies, with 100 eTLD+1s of 1000 subdomains each,
+// and queries single subdomains.
+TEST_F(CookieMonsterTest, TestQueryLargeStore) {
+  const int kNumDomains = 100;
+  const int kNumSubdomains = 1000;
+  scoped_refptr<MockPersistentCookieStore> store(new MockPersistentCookieStore);
+  std::vector<CanonicalCookie*> initial_cookies;
+  GetCookiesCallback getCookiesCallback;
+
+  // Creation times must be unique.
+  int64 time_tick(base::Time::Now().ToInternalValue());
+  for (int domain_num = 0; domain_num < kNumDomains; domain_num++) {
+    for (int subdomain_num = 0; subdomain_num < kNumSubdomains;
+         subdomain_num++) {
+      std::string host(base::StringPrintf("s%d.domain%d.com",
+                                          subdomain_num, domain_num));
+      AddCookieToList(host, "a=b; Path=/",
+                      base::Time::FromInternalValue(time_tick++),
+                      &initial_cookies);
+    }
+  }
+  store->SetLoadExpectation(true, initial_cookies);
+
+  scoped_refptr<CookieMonster> cm(new CookieMonster(store.get(), NULL));
+
+  PerfTimeLogger timer("Cookie_monster_import_large_store");
+  GURL probe_gurl("http://s0.domain0.com/");
+  EXPECT_EQ("a=b", getCookiesCallback.GetCookies(cm.get(), probe_gurl));
+  timer.Done();
+
+  std::vector<GURL> gurls;
+  for (int i = 0; i < kNumDomains; i++) {
+    gurls.push_back(GURL(base::StringPrintf("http://s%d.domain%d.com/",
+                                            i * 7 % kNumSubdomains, i)));
+  }
+
+  PerfTimeLogger timer2("Cookie_monster_query_large_store");
+  for (int i = 0; i < kNumCookies; i++)
+    getCookiesCallback.GetCookies(cm.get(), gurls[i % gurls.size()]);
+  timer2.Done();
+}
+
 TEST_F(CookieMonsterTest, TestGetKey) {
   scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
   PerfTimeLogger timer("Cookie_monster_get_key");
@@ -1242,6 +1242,35 @@ TEST_F(CookieMonsterTest, TestDeleteSingleCookie) {
   EXPECT_EQ("A=B; E=F", GetCookies(cm.get(), url_google_));
 }
 
+// Cookies are looked up by the domains that can match the host, check that
+// deletions keep that index in sync.
+TEST_F(CookieMonsterTest, CookiesOnSiblingSubdomains) {
+  scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
+  GURL url_a("http://a.b.google.izzle/");
+  GURL url_b("http://b.google.izzle/");
+  GURL url_c("http://c.google.izzle/");
+
+  EXPECT_TRUE(SetCookie(cm.get(), url_a, "A=1"));
+  EXPECT_TRUE(SetCookie(cm.get(), url_a, "B=1; domain=.b.google.izzle"));
+  EXPECT_TRUE(SetCookie(cm.get(), url_b, "C=1"));
+  EXPECT_TRUE(SetCookie(cm.get(), url_c, "D=1; domain=.google.izzle"));
+  EXPECT_TRUE(SetCookie(cm.get(), url_c, "E=1"));
+
+  EXPECT_EQ("A=1; B=1; D=1", GetCookies(cm.get(), url_a));
+  EXPECT_EQ("B=1; C=1; D=1", GetCookies(cm.get(), url_b));
+  EXPECT_EQ("D=1; E=1", GetCookies(cm.get(), url_c));
+
+  EXPECT_TRUE(FindAndDeleteCookie(cm.get(), ".b.google.izzle", "B"));
+  EXPECT_TRUE(SetCookie(cm.get(), url_b, "C=2"));
+  EXPECT_EQ("A=1; D=1", GetCookies(cm.get(), url_a));
+  EXPECT_EQ("D=1; C=2", GetCookies(cm.get(), url_b));
+
+  EXPECT_EQ(4, DeleteAll(cm.get()));
+  EXPECT_EQ("", GetCookies(cm.get(), url_a));
+  EXPECT_TRUE(SetCookie(cm.get(), url_a, "A=2"));
+  EXPECT_EQ("A=2", GetCookies(cm.get(), url_a));
+}
+
 TEST_F(CookieMonsterTest, SetCookieableSchemes) {
   scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
   scoped_refptr<CookieMonster> cm_foo(new CookieMonster(NULL, NULL));
@@ -258,6 +258,8 @@ int BackendImpl::SyncInit() {
   if (!(user_flags_ & kNoRandom)) {
     // The unit test controls directly what to test.
     new_eviction_ = (cache_type_ == net::DISK_CACHE);
+    if (cache_type_ == net::DISK_CACHE)
+      user_flags_ |= kBatchRankings;
   }
 
   if (!CheckIndex()) {
@@ -840,6 +842,7 @@ void BackendImpl::RemoveEntry(EntryImpl* entry) {
 }
 
 void BackendImpl::OnEntryDestroyBegin(Addr address) {
+  eviction_.OnCloseEntry(address);
   EntriesMap::iterator it = open_entries_.find(address.value());
   if (it != open_entries_.end())
     open_entries_.erase(it);
@@ -1653,6 +1656,8 @@ EntryImpl* BackendImpl::OpenFollowingEntry(bool forward, void** iter) {
   *iter = NULL;
 
   if (!iterator.get()) {
+    // The enumeration follows the order of the lists.
+    eviction_.FlushRankUpdates();
     iterator.reset(new Rankings::Iterator(&rankings_));
     bool ret = false;
 
@@ -82,6 +82,7 @@ class DiskCacheBackendTest : public DiskCacheTestWithCache {
   void BackendTrimInvalidEntry2();
   void BackendEnumerations();
   void BackendEnumerations2();
+  void BackendBatchRankings();
   void BackendInvalidEntryEnumeration();
   void BackendFixEnumerators();
   void BackendDoomRecent();
@@ -659,6 +660,56 @@ TEST_F(DiskCacheBackendTest, MemoryOnlyLoad) {
   BackendLoad();
 }
 
+TEST_F(DiskCacheBackendTest, MemorySlabLoad) {
+  SetMaxSize(0x100000);
+  SetMemoryOnlyMode();
+  SetMemorySlabStorage();
+  BackendLoad();
+}
+
+// Tests that the clock eviction of the memory cache gives a second chance to
+// the entries used since they were inserted.
+TEST_F(DiskCacheBackendTest, MemorySlabClockEviction) {
+  SetMaxSize(0x200000);
+  SetMemoryOnlyMode();
+  SetMemorySlabStorage();
+  InitCache();
+
+  const int kSize = 200000;
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer->data(), kSize, false);
+
+  disk_cache::Entry* entry;
+  for (int i = 0; i < 10; i++) {
+    std::string key = base::StringPrintf("key %d", i);
+    ASSERT_EQ(net::OK, CreateEntry(key, &entry));
+    EXPECT_EQ(kSize, WriteData(entry, 0, 0, buffer.get(), kSize, false));
+    entry->Close();
+  }
+  EXPECT_EQ(10, cache_->GetEntryCount());
+
+  // Reference the oldest entry.
+  ASSERT_EQ(net::OK, OpenEntry("key 0", &entry));
+  EXPECT_EQ(kSize, ReadData(entry, 0, 0, buffer.get(), kSize));
+  entry->Close();
+
+  // Going over the limit trims down to 1 MB.
+  ASSERT_EQ(net::OK, CreateEntry("key 10", &entry));
+  EXPECT_EQ(kSize, WriteData(entry, 0, 0, buffer.get(), kSize, false));
+  entry->Close();
+  EXPECT_EQ(5, cache_->GetEntryCount());
+
+  ASSERT_EQ(net::OK, OpenEntry("key 0", &entry));
+  entry->Close();
+  for (int i = 1; i < 7; i++) {
+    EXPECT_NE(net::OK, OpenEntry(base::StringPrintf("key %d", i), &entry));
+  }
+  for (int i = 7; i < 11; i++) {
+    ASSERT_EQ(net::OK, OpenEntry(base::StringPrintf("key %d", i), &entry));
+    entry->Close();
+  }
+}
+
 TEST_F(DiskCacheBackendTest, AppCacheLoad) {
   SetCacheType(net::APP_CACHE);
   // Work with a tiny index table (16 entries)
@@ -1193,6 +1244,66 @@ TEST_F(DiskCacheBackendTest, AppCacheEnumerations2) {
   BackendEnumerations2();
 }
 
+// Verifies that batched rank updates are applied in order.
+void DiskCacheBackendTest::BackendBatchRankings() {
+  SetBatchRankings();
+  InitCache();
+  const std::string first("first");
+  const std::string second("second");
+  const std::string third("third");
+  disk_cache::Entry *entry1, *entry2, *entry3;
+  ASSERT_EQ(net::OK, CreateEntry(first, &entry1));
+  entry1->Close();
+  ASSERT_EQ(net::OK, CreateEntry(second, &entry2));
+  entry2->Close();
+  ASSERT_EQ(net::OK, CreateEntry(third, &entry3));
+  entry3->Close();
+  FlushQueueForTest();
+
+  // Access the oldest entries while they stay open; the enumeration has to
+  // see the updates.
+  AddDelay();
+  ASSERT_EQ(net::OK, OpenEntry(second, &entry2));
+  EXPECT_EQ(0, WriteData(entry2, 0, 200, NULL, 0, false));
+  AddDelay();
+  ASSERT_EQ(net::OK, OpenEntry(first, &entry1));
+  EXPECT_EQ(0, WriteData(entry1, 0, 200, NULL, 0, false));
+  base::Time last_used = entry1->GetLastUsed();
+  void* iter = NULL;
+  ASSERT_EQ(net::OK, OpenNextEntry(&iter, &entry3));
+  EXPECT_EQ(first, entry3->GetKey());
+  EXPECT_TRUE(last_used <= entry3->GetLastUsed());
+  entry3->Close();
+  ASSERT_EQ(net::OK, OpenNextEntry(&iter, &entry3));
+  EXPECT_EQ(second, entry3->GetKey());
+  entry3->Close();
+  cache_->EndEnumeration(&iter);
+  entry1->Close();
+  entry2->Close();
+
+  // The updates survive a restart of the backend.
+  AddDelay();
+  ASSERT_EQ(net::OK, OpenEntry(third, &entry3));
+  EXPECT_EQ(0, WriteData(entry3, 0, 200, NULL, 0, false));
+  entry3->Close();
+  SimulateCrash();
+
+  ASSERT_EQ(net::OK, OpenNextEntry(&iter, &entry3));
+  EXPECT_EQ(third, entry3->GetKey());
+  entry3->Close();
+  cache_->EndEnumeration(&iter);
+  EXPECT_EQ(3, cache_->GetEntryCount());
+}
+
+TEST_F(DiskCacheBackendTest, BatchRankings) {
+  BackendBatchRankings();
+}
+
+TEST_F(DiskCacheBackendTest, NewEvictionBatchRankings) {
+  SetNewEviction();
+  BackendBatchRankings();
+}
+
 TEST_F(DiskCacheBackendTest, ShaderCacheEnumerations2) {
   SetCacheType(net::SHADER_CACHE);
   BackendEnumerations2();
@@ -1467,6 +1578,15 @@ TEST_F(DiskCacheBackendTest, MemoryOnlyDoomEntriesSinceSparse) {
   EXPECT_EQ(1, cache_->GetEntryCount());
 }
 
+TEST_F(DiskCacheBackendTest, MemorySlabDoomEntriesSinceSparse) {
+  SetMemoryOnlyMode();
+  SetMemorySlabStorage();
+  base::Time start;
+  InitSparseCache(&start, NULL);
+  DoomEntriesSince(start);
+  EXPECT_EQ(1, cache_->GetEntryCount());
+}
+
 TEST_F(DiskCacheBackendTest, DoomEntriesSinceSparse) {
   base::Time start;
   InitSparseCache(&start, NULL);
@@ -1484,6 +1604,14 @@ TEST_F(DiskCacheBackendTest, MemoryOnlyDoomAllSparse) {
   EXPECT_EQ(0, cache_->GetEntryCount());
 }
 
+TEST_F(DiskCacheBackendTest, MemorySlabDoomAllSparse) {
+  SetMemoryOnlyMode();
+  SetMemorySlabStorage();
+  InitSparseCache(NULL, NULL);
+  EXPECT_EQ(net::OK, DoomAllEntries());
+  EXPECT_EQ(0, cache_->GetEntryCount());
+}
+
 TEST_F(DiskCacheBackendTest, DoomAllSparse) {
   InitSparseCache(NULL, NULL);
   EXPECT_EQ(net::OK, DoomAllEntries());
@@ -1547,6 +1675,12 @@ TEST_F(DiskCacheBackendTest, MemoryOnlyDoomBetween) {
   BackendDoomBetween();
 }
 
+TEST_F(DiskCacheBackendTest, MemorySlabDoomBetween) {
+  SetMemoryOnlyMode();
+  SetMemorySlabStorage();
+  BackendDoomBetween();
+}
+
 TEST_F(DiskCacheBackendTest, MemoryOnlyDoomEntriesBetweenSparse) {
   SetMemoryOnlyMode();
   base::Time start, end;
@@ -3049,6 +3183,71 @@ TEST_F(DiskCacheBackendTest, TracingBackendBasics) {
   TracingBackendBasics();
 }
 
+// Tests that the tracing backend records the operations in a trace that
+// survives serialization.
+TEST_F(DiskCacheBackendTest, TracingBackendRecordsTrace) {
+  InitCache();
+  disk_cache::TracingCacheBackend* tracing_cache =
+      new disk_cache::TracingCacheBackend(cache_.Pass());
+  cache_.reset(tracing_cache);
+  cache_impl_ = NULL;
+
+  disk_cache::CacheTrace trace;
+  tracing_cache->set_trace(&trace);
+
+  const int kSize = 100;
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer->data(), kSize, false);
+
+  disk_cache::Entry* entry = NULL;
+  EXPECT_NE(net::OK, OpenEntry("the first key", &entry));
+  ASSERT_EQ(net::OK, CreateEntry("the first key", &entry));
+  EXPECT_EQ(kSize, WriteData(entry, 1, 0, buffer.get(), kSize, true));
+  EXPECT_EQ(kSize, ReadData(entry, 1, 0, buffer.get(), kSize));
+  entry->Close();
+  EXPECT_EQ(net::OK, DoomEntry("the first key"));
+  tracing_cache->set_trace(NULL);
+
+  const disk_cache::CacheTraceEvent::Type kTypes[] = {
+    disk_cache::CacheTraceEvent::OPEN,
+    disk_cache::CacheTraceEvent::CREATE,
+    disk_cache::CacheTraceEvent::WRITE,
+    disk_cache::CacheTraceEvent::READ,
+    disk_cache::CacheTraceEvent::CLOSE,
+    disk_cache::CacheTraceEvent::DOOM_ENTRY
+  };
+  ASSERT_EQ(arraysize(kTypes), trace.events().size());
+  for (size_t i = 0; i < arraysize(kTypes); i++) {
+    EXPECT_EQ(kTypes[i], trace.events()[i].type);
+    EXPECT_EQ("the first key", trace.events()[i].key);
+  }
+  EXPECT_NE(net::OK, trace.events()[0].result);
+  EXPECT_EQ(1, trace.events()[2].index);
+  EXPECT_EQ(kSize, trace.events()[2].buf_len);
+  EXPECT_TRUE(trace.events()[2].truncate);
+  EXPECT_EQ(kSize, trace.events()[2].result);
+
+  disk_cache::CacheTrace parsed;
+  ASSERT_TRUE(parsed.Deserialize(trace.Serialize()));
+  ASSERT_EQ(trace.events().size(), parsed.events().size());
+  for (size_t i = 0; i < trace.events().size(); i++) {
+    const disk_cache::CacheTraceEvent& event = trace.events()[i];
+    const disk_cache::CacheTraceEvent& parsed_event = parsed.events()[i];
+    EXPECT_EQ(event.type, parsed_event.type);
+    EXPECT_EQ(event.time, parsed_event.time);
+    EXPECT_EQ(event.latency, parsed_event.latency);
+    EXPECT_EQ(event.key, parsed_event.key);
+    EXPECT_EQ(event.index, parsed_event.index);
+    EXPECT_EQ(event.offset, parsed_event.offset);
+    EXPECT_EQ(event.buf_len, parsed_event.buf_len);
+    EXPECT_EQ(event.truncate, parsed_event.truncate);
+    EXPECT_EQ(event.result, parsed_event.result);
+  }
+
+  EXPECT_FALSE(parsed.Deserialize("12 3 open 0 0 0 0\n"));
+  EXPECT_FALSE(parsed.Deserialize("12 3 seek 0 0 0 0 0 key\n"));
+}
+
 // The simple cache backend isn't intended to work on windows, which has very
 // different file system guarantees from Windows.
 #if !defined(OS_WIN)
@@ -3200,6 +3399,69 @@ TEST_F(DiskCacheBackendTest, SimpleCacheOpenBadFile) {
   ASSERT_EQ(net::ERR_FAILED, OpenEntry(key, &entry));
 }
 
+// Tests that the entries used early in a session have their stream 0
+// prefetched by the next session.
+TEST_F(DiskCacheBackendTest, SimpleCachePrefetchHotSet) {
+  SetSimpleCacheMode();
+  InitCache();
+
+  const int kSize = 200;
+  scoped_refptr<net::IOBuffer> buffer1(new net::IOBuffer(kSize));
+  scoped_refptr<net::IOBuffer> buffer2(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer1->data(), kSize, false);
+  disk_cache::Entry* entry;
+  ASSERT_EQ(net::OK, CreateEntry("read", &entry));
+  ASSERT_EQ(kSize, WriteData(entry, 0, 0, buffer1.get(), kSize, false));
+  entry->Close();
+  ASSERT_EQ(net::OK, CreateEntry("written", &entry));
+  ASSERT_EQ(kSize, WriteData(entry, 0, 0, buffer1.get(), kSize, false));
+  entry->Close();
+  simple_cache_impl_->RecordHotSet();
+  cache_.reset();
+
+  DisableFirstCleanup();
+  InitCache();
+
+  ASSERT_EQ(net::OK, OpenEntry("read", &entry));
+  EXPECT_EQ(kSize, ReadData(entry, 0, 0, buffer2.get(), kSize));
+  EXPECT_EQ(0, memcmp(buffer1->data(), buffer2->data(), kSize));
+  // The prefetched data is only served once.
+  memset(buffer2->data(), 0, kSize);
+  EXPECT_EQ(kSize, ReadData(entry, 0, 0, buffer2.get(), kSize));
+  EXPECT_EQ(0, memcmp(buffer1->data(), buffer2->data(), kSize));
+  entry->Close();
+
+  // Writing to stream 0 drops its prefetched data.
+  CacheTestFillBuffer(buffer2->data(), kSize, false);
+  ASSERT_EQ(net::OK, OpenEntry("written", &entry));
+  ASSERT_EQ(kSize, WriteData(entry, 0, 0, buffer2.get(), kSize, false));
+  memset(buffer1->data(), 0, kSize);
+  EXPECT_EQ(kSize, ReadData(entry, 0, 0, buffer1.get(), kSize));
+  EXPECT_EQ(0, memcmp(buffer1->data(), buffer2->data(), kSize));
+  entry->Close();
+
+  disk_cache::StatsItems stats;
+  cache_->GetStats(&stats);
+  disk_cache::StatsItems::value_type hits("Prefetch hit", "0x1");
+  EXPECT_EQ(1, std::count(stats.begin(), stats.end(), hits));
+  disk_cache::StatsItems::value_type unused("Prefetch unused", "0x1");
+  EXPECT_EQ(1, std::count(stats.begin(), stats.end(), unused));
+
+  // The hot set of the previous session is only prefetched once.
+  cache_.reset();
+  InitCache();
+  stats.clear();
+  cache_->GetStats(&stats);
+  disk_cache::StatsItems::value_type no_hits("Prefetch hit", "0x0");
+  EXPECT_EQ(1, std::count(stats.begin(), stats.end(), no_hits));
+  ASSERT_EQ(net::OK, OpenEntry("read", &entry));
+  EXPECT_EQ(kSize, ReadData(entry, 0, 0, buffer2.get(), kSize));
+  entry->Close();
+  stats.clear();
+  cache_->GetStats(&stats);
+  EXPECT_EQ(1, std::count(stats.begin(), stats.end(), no_hits));
+}
+
 // Tests that the Simple Cache Backend fails to initialize with non-matching
 // file structure on disk.
 TEST_F(DiskCacheBackendTest, SimpleCacheOverBlockfileCache) {
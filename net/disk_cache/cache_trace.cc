@@ -0,0 +1,132 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/cache_trace.h"
+
+#include "base/format_macros.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/stringprintf.h"
+
+namespace {
+
+// The number of fields before the key.
+const size_t kNumFields = 8;
+
+const char* const kTypeNames[] = {
+  "open",
+  "create",
+  "doom",
+  "read",
+  "write",
+  "close"
+};
+
+bool ParseType(const std::string& name,
+               disk_cache::CacheTraceEvent::Type* type) {
+  for (size_t i = 0; i < arraysize(kTypeNames); i++) {
+    if (name == kTypeNames[i]) {
+      *type = static_cast<disk_cache::CacheTraceEvent::Type>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ParseEvent(const std::string& line, disk_cache::CacheTraceEvent* event) {
+  // Find the start of the key.
+  size_t key_start = 0;
+  for (size_t i = 0; i < kNumFields; i++) {
+    key_start = line.find(' ', key_start);
+    if (key_start == std::string::npos)
+      return false;
+    key_start++;
+  }
+
+  std::vector<std::string> fields;
+  base::SplitString(line.substr(0, key_start - 1), ' ', &fields);
+  if (fields.size() != kNumFields)
+    return false;
+
+  int64 time;
+  int64 latency;
+  int truncate;
+  if (!base::StringToInt64(fields[0], &time) ||
+      !base::StringToInt64(fields[1], &latency) ||
+      !ParseType(fields[2], &event->type) ||
+      !base::StringToInt(fields[3], &event->index) ||
+      !base::StringToInt(fields[4], &event->offset) ||
+      !base::StringToInt(fields[5], &event->buf_len) ||
+      !base::StringToInt(fields[6], &truncate) ||
+      !base::StringToInt(fields[7], &event->result)) {
+    return false;
+  }
+
+  event->time = base::TimeDelta::FromMicroseconds(time);
+  event->latency = base::TimeDelta::FromMicroseconds(latency);
+  event->truncate = truncate != 0;
+  event->key = line.substr(key_start);
+  return true;
+}
+
+}  // namespace
+
+namespace disk_cache {
+
+CacheTraceEvent::CacheTraceEvent()
+    : type(OPEN),
+      index(0),
+      offset(0),
+      buf_len(0),
+      truncate(false),
+      result(0) {
+}
+
+CacheTraceEvent::~CacheTraceEvent() {
+}
+
+CacheTrace::CacheTrace() : start_time_(base::TimeTicks::Now()) {
+}
+
+CacheTrace::~CacheTrace() {
+}
+
+void CacheTrace::AddEvent(const CacheTraceEvent& event) {
+  events_.push_back(event);
+}
+
+std::string CacheTrace::Serialize() const {
+  COMPILE_ASSERT(arraysize(kTypeNames) == CacheTraceEvent::CLOSE + 1,
+                 trace_event_names_mismatch);
+  std::string data;
+  for (size_t i = 0; i < events_.size(); i++) {
+    const CacheTraceEvent& event = events_[i];
+    base::StringAppendF(&data, "%" PRId64 " %" PRId64 " %s %d %d %d %d %d %s\n",
+                        event.time.InMicroseconds(),
+                        event.latency.InMicroseconds(),
+                        kTypeNames[event.type], event.index, event.offset,
+                        event.buf_len, event.truncate ? 1 : 0, event.result,
+                        event.key.c_str());
+  }
+  return data;
+}
+
+bool CacheTrace::Deserialize(const std::string& data) {
+  std::vector<std::string> lines;
+  base::SplitString(data, '\n', &lines);
+
+  std::vector<CacheTraceEvent> events;
+  for (size_t i = 0; i < lines.size(); i++) {
+    if (lines[i].empty())
+      continue;
+    CacheTraceEvent event;
+    if (!ParseEvent(lines[i], &event))
+      return false;
+    events.push_back(event);
+  }
+  events_.swap(events);
+  return true;
+}
+
+}  // namespace disk_cache
@@ -0,0 +1,79 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_DISK_CACHE_CACHE_TRACE_H_
+#define NET_DISK_CACHE_CACHE_TRACE_H_
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/time/time.h"
+#include "net/base/net_export.h"
+
+namespace disk_cache {
+
+// A single cache operation, as seen by a TracingCacheBackend.
+struct NET_EXPORT_PRIVATE CacheTraceEvent {
+  enum Type {
+    OPEN,
+    CREATE,
+    DOOM_ENTRY,
+    READ,
+    WRITE,
+    CLOSE
+  };
+
+  CacheTraceEvent();
+  ~CacheTraceEvent();
+
+  Type type;
+  base::TimeDelta time;     // From the start of the trace to the operation.
+  base::TimeDelta latency;  // From the operation to its result.
+  std::string key;
+
+  // The arguments of READ and WRITE.
+  int index;
+  int offset;
+  int buf_len;
+  bool truncate;
+
+  int result;
+};
+
+// A recorded sequence of cache operations that can be saved to a file and
+// replayed later against any backend.
+//
+// The text form has one operation per line:
+//   <time us> <latency us> <type> <index> <offset> <buf_len> <truncate>
+//   <result> <key>
+// The key goes last, up to the end of the line, so it can contain spaces.
+class NET_EXPORT_PRIVATE CacheTrace {
+ public:
+  CacheTrace();
+  ~CacheTrace();
+
+  // The time all the events are relative to.
+  base::TimeTicks start_time() const { return start_time_; }
+
+  void AddEvent(const CacheTraceEvent& event);
+
+  const std::vector<CacheTraceEvent>& events() const { return events_; }
+
+  std::string Serialize() const;
+
+  // Replaces the events with the ones from |data|, returned by Serialize().
+  // Returns false if |data| is malformed.
+  bool Deserialize(const std::string& data);
+
+ private:
+  base::TimeTicks start_time_;
+  std::vector<CacheTraceEvent> events_;
+
+  DISALLOW_COPY_AND_ASSIGN(CacheTrace);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_CACHE_TRACE_H_
@@ -16,6 +16,7 @@
 #include "net/base/cache_type.h"
 #include "net/base/completion_callback.h"
 #include "net/base/net_export.h"
+#include "net/base/request_priority.h"
 
 namespace base {
 class FilePath;
@@ -305,6 +306,11 @@ class NET_EXPORT Entry {
   // Note: This method is deprecated.
   virtual int ReadyForSparseIO(const CompletionCallback& callback) = 0;
 
+  // Sets the priority of the request that the following calls to ReadData()
+  // are made for. Backends may run the reads of the most urgent requests ahead
+  // of other pending operations. The default is net::DEFAULT_PRIORITY.
+  virtual void SetPriority(net::RequestPriority priority) = 0;
+
  protected:
   virtual ~Entry() {}
 };
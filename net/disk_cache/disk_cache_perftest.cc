@@ -2,26 +2,38 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/bind.h"
 #include "base/bind_helpers.h"
+#include "base/command_line.h"
+#include "base/file_util.h"
 #include "base/hash.h"
 #include "base/perftimer.h"
+#include "base/process/process_metrics.h"
 #include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
 #include "base/test/test_file_util.h"
 #include "base/threading/thread.h"
+#include "base/time/time.h"
 #include "base/timer/timer.h"
 #include "net/base/cache_type.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
+#include "net/base/request_priority.h"
 #include "net/base/test_completion_callback.h"
 #include "net/disk_cache/backend_impl.h"
 #include "net/disk_cache/block_files.h"
+#include "net/disk_cache/cache_trace.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/disk_cache/disk_cache_test_base.h"
 #include "net/disk_cache/disk_cache_test_util.h"
+#include "net/disk_cache/mem_backend_impl.h"
+#include "net/disk_cache/tracing_cache_backend.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/platform_test.h"
 
@@ -139,11 +151,328 @@ bool TimeRead(int num_entries, disk_cache::Backend* cache,
   return (expected == helper.callbacks_called());
 }
 
+// Returns the |percentile|th percentile of |samples|, in milliseconds.
+double GetPercentile(std::vector<base::TimeDelta> samples, int percentile) {
+  if (samples.empty())
+    return 0;
+  std::sort(samples.begin(), samples.end());
+  size_t index = (samples.size() - 1) * percentile / 100;
+  return samples[index].InMillisecondsF();
+}
+
+// Opens and reads the data of each entry listed on |entries|, one at a time
+// and with |priority|, while |num_writes| new entries are being written in the
+// background. Reports the latency of the reads.
+bool TimeReadUnderLoad(int num_writes, disk_cache::Backend* cache,
+                       const TestEntries& entries,
+                       net::RequestPriority priority) {
+  scoped_refptr<net::IOBuffer> write_buffer(new net::IOBuffer(kMaxSize));
+  scoped_refptr<net::IOBuffer> read_buffer(new net::IOBuffer(kMaxSize));
+  CacheTestFillBuffer(write_buffer->data(), kMaxSize, false);
+
+  int expected = 0;
+
+  MessageLoopHelper helper;
+  CallbackTest callback(&helper, true);
+
+  for (int i = 0; i < num_writes; i++) {
+    disk_cache::Entry* cache_entry;
+    net::TestCompletionCallback cb;
+    int rv = cache->CreateEntry(GenerateKey(true), &cache_entry,
+                                cb.callback());
+    if (net::OK != cb.GetResult(rv))
+      return false;
+    int ret = cache_entry->WriteData(
+        1, 0, write_buffer.get(), kMaxSize,
+        base::Bind(&CallbackTest::Run, base::Unretained(&callback)), false);
+    if (net::ERR_IO_PENDING == ret)
+      expected++;
+    else if (kMaxSize != ret)
+      return false;
+    cache_entry->Close();
+  }
+
+  std::vector<base::TimeDelta> open_read_times;
+  std::vector<base::TimeDelta> read_times;
+  for (size_t i = 0; i < entries.size(); i++) {
+    const base::TimeTicks start = base::TimeTicks::Now();
+    disk_cache::Entry* cache_entry;
+    net::TestCompletionCallback open_cb;
+    int rv = cache->OpenEntry(entries[i].key, &cache_entry,
+                              open_cb.callback());
+    if (net::OK != open_cb.GetResult(rv))
+      return false;
+    cache_entry->SetPriority(priority);
+
+    const base::TimeTicks read_start = base::TimeTicks::Now();
+    net::TestCompletionCallback read_cb;
+    rv = cache_entry->ReadData(1, 0, read_buffer.get(), entries[i].data_len,
+                               read_cb.callback());
+    if (entries[i].data_len != read_cb.GetResult(rv))
+      return false;
+    const base::TimeTicks end = base::TimeTicks::Now();
+    open_read_times.push_back(end - start);
+    read_times.push_back(end - read_start);
+    cache_entry->Close();
+  }
+
+  helper.WaitUntilCacheIoFinished(expected);
+
+  const std::string suffix =
+      priority == net::HIGHEST ? "_highest" : "_default";
+  LogPerfResult(("Open and read under load p50" + suffix).c_str(),
+                GetPercentile(open_read_times, 50), "ms");
+  LogPerfResult(("Open and read under load p99" + suffix).c_str(),
+                GetPercentile(open_read_times, 99), "ms");
+  LogPerfResult(("Read under load p50" + suffix).c_str(),
+                GetPercentile(read_times, 50), "ms");
+  LogPerfResult(("Read under load p99" + suffix).c_str(),
+                GetPercentile(read_times, 99), "ms");
+
+  return (expected == helper.callbacks_called());
+}
+
 int BlockSize() {
   // We can use form 1 to 4 blocks.
   return (rand() & 0x3) + 1;
 }
 
+bool EventStartsFirst(const disk_cache::CacheTraceEvent& a,
+                      const disk_cache::CacheTraceEvent& b) {
+  return a.time < b.time;
+}
+
+// A file with a trace saved by CacheTrace::Serialize(), to replay instead of
+// the synthetic one.
+const char kCacheTraceSwitch[] = "cache-trace";
+
+// Records a trace of |num_requests| requests for a set of resources where a
+// few are much more popular than the rest. A hit reads the headers and the
+// body, and sometimes finds the entry stale and dooms it; a miss creates the
+// entry and writes the body in pieces, the way the HttpCache does.
+void RecordSyntheticTrace(int num_requests, disk_cache::CacheTrace* trace) {
+  const int kNumResources = 1000;
+  const int kHeadersSize = 500;
+  const int kPieceSize = 32 * 1024;
+  const int kMaxBodySize = 128 * 1024;
+
+  disk_cache::TracingCacheBackend* tracing_cache =
+      new disk_cache::TracingCacheBackend(
+          disk_cache::MemBackendImpl::CreateBackend(256 * 1024 * 1024, NULL));
+  scoped_ptr<disk_cache::Backend> cache(tracing_cache);
+  tracing_cache->set_trace(trace);
+
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kPieceSize));
+  CacheTestFillBuffer(buffer->data(), kPieceSize, false);
+
+  for (int i = 0; i < num_requests; i++) {
+    int resource = (rand() % kNumResources) * (rand() % kNumResources) /
+                   kNumResources;
+    std::string key =
+        base::StringPrintf("http://www.example.com/resource/%d", resource);
+
+    disk_cache::Entry* entry = NULL;
+    net::TestCompletionCallback cb;
+    if (cb.GetResult(cache->OpenEntry(key, &entry, cb.callback())) ==
+        net::OK) {
+      cb.GetResult(entry->ReadData(0, 0, buffer.get(), kHeadersSize,
+                                   cb.callback()));
+      if (rand() % 20 == 0) {
+        entry->Doom();
+        entry->Close();
+        continue;
+      }
+      int size = entry->GetDataSize(1);
+      for (int offset = 0; offset < size; offset += kPieceSize) {
+        cb.GetResult(entry->ReadData(1, offset, buffer.get(), kPieceSize,
+                                     cb.callback()));
+      }
+      entry->Close();
+      continue;
+    }
+
+    ASSERT_EQ(net::OK,
+              cb.GetResult(cache->CreateEntry(key, &entry, cb.callback())));
+    cb.GetResult(entry->WriteData(0, 0, buffer.get(), kHeadersSize,
+                                  cb.callback(), true));
+    int size = rand() % kMaxBodySize;
+    for (int offset = 0; offset < size; offset += kPieceSize) {
+      int len = std::min(kPieceSize, size - offset);
+      cb.GetResult(entry->WriteData(1, offset, buffer.get(), len,
+                                    cb.callback(), false));
+    }
+    entry->Close();
+  }
+  tracing_cache->set_trace(NULL);
+}
+
+// Replays |trace| against |cache|, one operation at a time and as fast as the
+// backend allows, and logs the throughput and the latency of each kind of
+// operation under |name|. Operations on entries that could not be opened or
+// created during the replay are skipped.
+void ReplayTrace(const disk_cache::CacheTrace& trace,
+                 disk_cache::Backend* cache,
+                 const std::string& name) {
+  const char* const kTypeNames[] = {
+    "open", "create", "doom", "read", "write", "close"
+  };
+  const int kNumTypes = arraysize(kTypeNames);
+  COMPILE_ASSERT(kNumTypes == disk_cache::CacheTraceEvent::CLOSE + 1,
+                 type_names_mismatch);
+
+  // The tracing backend adds asynchronous operations when they complete, so
+  // put them back in the order they started.
+  std::vector<disk_cache::CacheTraceEvent> events(trace.events());
+  std::stable_sort(events.begin(), events.end(), EventStartsFirst);
+
+  int buffer_size = 1;
+  for (size_t i = 0; i < events.size(); i++)
+    buffer_size = std::max(buffer_size, events[i].buf_len);
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(buffer_size));
+  CacheTestFillBuffer(buffer->data(), buffer_size, false);
+
+  // The same entry can be open more than once.
+  typedef std::multimap<std::string, disk_cache::Entry*> EntryMap;
+  EntryMap open_entries;
+
+  std::vector<base::TimeDelta> latencies[kNumTypes];
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (size_t i = 0; i < events.size(); i++) {
+    const disk_cache::CacheTraceEvent& event = events[i];
+    EntryMap::iterator it = open_entries.find(event.key);
+    disk_cache::Entry* entry = NULL;
+    net::TestCompletionCallback cb;
+    const base::TimeTicks op_start = base::TimeTicks::Now();
+    switch (event.type) {
+      case disk_cache::CacheTraceEvent::OPEN:
+        if (cb.GetResult(cache->OpenEntry(event.key, &entry,
+                                          cb.callback())) == net::OK) {
+          open_entries.insert(std::make_pair(event.key, entry));
+        }
+        break;
+      case disk_cache::CacheTraceEvent::CREATE:
+        if (cb.GetResult(cache->CreateEntry(event.key, &entry,
+                                            cb.callback())) == net::OK) {
+          open_entries.insert(std::make_pair(event.key, entry));
+        }
+        break;
+      case disk_cache::CacheTraceEvent::DOOM_ENTRY:
+        if (it != open_entries.end())
+          it->second->Doom();
+        else
+          cb.GetResult(cache->DoomEntry(event.key, cb.callback()));
+        break;
+      case disk_cache::CacheTraceEvent::READ:
+        if (it == open_entries.end())
+          continue;
+        cb.GetResult(it->second->ReadData(event.index, event.offset,
+                                          buffer.get(), event.buf_len,
+                                          cb.callback()));
+        break;
+      case disk_cache::CacheTraceEvent::WRITE:
+        if (it == open_entries.end())
+          continue;
+        cb.GetResult(it->second->WriteData(event.index, event.offset,
+                                           buffer.get(), event.buf_len,
+                                           cb.callback(), event.truncate));
+        break;
+      case disk_cache::CacheTraceEvent::CLOSE:
+        if (it == open_entries.end())
+          continue;
+        it->second->Close();
+        open_entries.erase(it);
+        break;
+    }
+    latencies[event.type].push_back(base::TimeTicks::Now() - op_start);
+  }
+  const base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+  for (EntryMap::iterator it = open_entries.begin(); it != open_entries.end();
+       ++it) {
+    it->second->Close();
+  }
+
+  size_t num_operations = 0;
+  for (int i = 0; i < kNumTypes; i++) {
+    num_operations += latencies[i].size();
+    if (latencies[i].empty())
+      continue;
+    const std::string prefix = name + " " + kTypeNames[i];
+    LogPerfResult((prefix + " p50").c_str(), GetPercentile(latencies[i], 50),
+                  "ms");
+    LogPerfResult((prefix + " p90").c_str(), GetPercentile(latencies[i], 90),
+                  "ms");
+    LogPerfResult((prefix + " p99").c_str(), GetPercentile(latencies[i], 99),
+                  "ms");
+  }
+  LogPerfResult((name + " replay throughput").c_str(),
+                num_operations / std::max(elapsed.InSecondsF(), 0.001),
+                "ops/s");
+}
+
+// Writes four times the capacity of a memory-only cache, so that eviction
+// churns the memory, and logs how much the working set grew for each MB of
+// data left in the cache, on top of the data itself.
+void MemoryCacheOverhead(bool slab_storage) {
+  scoped_ptr<base::ProcessMetrics> metrics(
+      base::ProcessMetrics::CreateProcessMetrics(
+          base::GetCurrentProcessHandle()));
+  size_t start_working_set = metrics->GetWorkingSetSize();
+
+  const int kCacheSize = 50 * 1024 * 1024;
+  const int kMaxEntrySize = 64 * 1024;
+  const int kPieceSize = 4 * 1024;
+  disk_cache::MemBackendImpl cache(NULL);
+  ASSERT_TRUE(cache.SetMaxSize(kCacheSize));
+  if (slab_storage)
+    cache.EnableSlabStorage();
+  ASSERT_TRUE(cache.Init());
+
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kPieceSize));
+  CacheTestFillBuffer(buffer->data(), kPieceSize, false);
+
+  PerfTimeLogger timer(slab_storage ? "Fill memory cache (slabs)" :
+                                      "Fill memory cache (vectors)");
+  int64 written = 0;
+  while (written < 4LL * kCacheSize) {
+    disk_cache::Entry* entry;
+    net::TestCompletionCallback cb;
+    int rv = cache.CreateEntry(GenerateKey(true), &entry, cb.callback());
+    ASSERT_EQ(net::OK, cb.GetResult(rv));
+
+    // Store the body in pieces, the way it arrives from the network.
+    int size = rand() % kMaxEntrySize;
+    for (int offset = 0; offset < size; offset += kPieceSize) {
+      int len = std::min(kPieceSize, size - offset);
+      rv = entry->WriteData(1, offset, buffer.get(), len, cb.callback(), false);
+      ASSERT_EQ(len, cb.GetResult(rv));
+    }
+    entry->Close();
+    written += size;
+  }
+  timer.Done();
+
+  size_t working_set = metrics->GetWorkingSetSize();
+
+  int64 cached = 0;
+  void* iter = NULL;
+  disk_cache::Entry* entry;
+  net::TestCompletionCallback cb;
+  while (cb.GetResult(cache.OpenNextEntry(&iter, &entry, cb.callback())) ==
+         net::OK) {
+    cached += entry->GetDataSize(1);
+    entry->Close();
+  }
+  cache.EndEnumeration(&iter);
+  ASSERT_GT(cached, 0);
+
+  double cached_mb = static_cast<double>(cached) / (1024 * 1024);
+  double growth = static_cast<double>(working_set) - start_working_set;
+  LogPerfResult(slab_storage ? "Memory cache overhead per MB (slabs)" :
+                               "Memory cache overhead per MB (vectors)",
+                (growth - cached) / 1024 / cached_mb, "KB");
+}
+
 }  // namespace
 
 TEST_F(DiskCacheTest, Hash) {
@@ -206,6 +535,36 @@ TEST_F(DiskCacheTest, CacheBackendPerformance) {
   base::MessageLoop::current()->RunUntilIdle();
 }
 
+// Measures how long opening and reading an entry takes while many other
+// entries are being written, with reads at the default and at the highest
+// priority.
+TEST_F(DiskCacheTest, SimpleCacheLatencyUnderLoad) {
+  base::Thread cache_thread("CacheThread");
+  ASSERT_TRUE(cache_thread.StartWithOptions(
+                  base::Thread::Options(base::MessageLoop::TYPE_IO, 0)));
+
+  ASSERT_TRUE(CleanupCacheDir());
+  net::TestCompletionCallback cb;
+  scoped_ptr<disk_cache::Backend> cache;
+  int rv = disk_cache::CreateCacheBackend(
+      net::DISK_CACHE, net::CACHE_BACKEND_SIMPLE, cache_path_, 0, false,
+      cache_thread.message_loop_proxy().get(), NULL, &cache, cb.callback());
+  ASSERT_EQ(net::OK, cb.GetResult(rv));
+
+  int seed = static_cast<int>(Time::Now().ToInternalValue());
+  srand(seed);
+
+  TestEntries entries;
+  EXPECT_TRUE(TimeWrite(200, cache.get(), &entries));
+  base::MessageLoop::current()->RunUntilIdle();
+
+  EXPECT_TRUE(TimeReadUnderLoad(2000, cache.get(), entries,
+                                net::DEFAULT_PRIORITY));
+  EXPECT_TRUE(TimeReadUnderLoad(2000, cache.get(), entries, net::HIGHEST));
+
+  base::MessageLoop::current()->RunUntilIdle();
+}
+
 // Creating and deleting "entries" on a block-file is something quite frequent
 // (after all, almost everything is stored on block files). The operation is
 // almost free when the file is empty, but can be expensive if the file gets
@@ -248,3 +607,82 @@ TEST_F(DiskCacheTest, BlockFilesPerformance) {
   base::MessageLoop::current()->RunUntilIdle();
   delete[] address;
 }
+
+// Compares the memory used by the two storage layouts of the memory-only
+// cache, after enough writes to evict its contents a few times.
+TEST_F(DiskCacheTest, MemoryCacheMemoryOverhead) {
+  int seed = static_cast<int>(Time::Now().ToInternalValue());
+  srand(seed);
+
+  MemoryCacheOverhead(false);
+  MemoryCacheOverhead(true);
+}
+
+// Replays a recorded sequence of cache operations against each backend. The
+// trace comes from --cache-trace, or from a synthetic workload when the switch
+// is not present.
+TEST_F(DiskCacheTest, CacheTraceReplay) {
+  int seed = static_cast<int>(Time::Now().ToInternalValue());
+  srand(seed);
+
+  disk_cache::CacheTrace trace;
+  base::FilePath trace_path =
+      CommandLine::ForCurrentProcess()->GetSwitchValuePath(kCacheTraceSwitch);
+  if (trace_path.empty()) {
+    RecordSyntheticTrace(5000, &trace);
+  } else {
+    std::string data;
+    ASSERT_TRUE(file_util::ReadFileToString(trace_path, &data));
+    ASSERT_TRUE(trace.Deserialize(data));
+  }
+  ASSERT_FALSE(trace.events().empty());
+
+  base::Thread cache_thread("CacheThread");
+  ASSERT_TRUE(cache_thread.StartWithOptions(
+                  base::Thread::Options(base::MessageLoop::TYPE_IO, 0)));
+  scoped_ptr<base::ProcessMetrics> metrics(
+      base::ProcessMetrics::CreateProcessMetrics(
+          base::GetCurrentProcessHandle()));
+
+  const struct {
+    net::CacheType cache_type;
+    net::BackendType backend_type;
+    const char* name;
+  } kBackends[] = {
+    { net::DISK_CACHE, net::CACHE_BACKEND_BLOCKFILE, "Blockfile" },
+    { net::DISK_CACHE, net::CACHE_BACKEND_SIMPLE, "Simple" },
+    { net::MEMORY_CACHE, net::CACHE_BACKEND_DEFAULT, "Memory" },
+  };
+  for (size_t i = 0; i < arraysize(kBackends); i++) {
+    ASSERT_TRUE(CleanupCacheDir());
+    base::IoCounters start_counters;
+    bool has_counters = metrics->GetIOCounters(&start_counters);
+
+    net::TestCompletionCallback cb;
+    scoped_ptr<disk_cache::Backend> cache;
+    int rv = disk_cache::CreateCacheBackend(
+        kBackends[i].cache_type, kBackends[i].backend_type, cache_path_, 0,
+        false, cache_thread.message_loop_proxy().get(), NULL, &cache,
+        cb.callback());
+    ASSERT_EQ(net::OK, cb.GetResult(rv));
+
+    ReplayTrace(trace, cache.get(), kBackends[i].name);
+    cache.reset();
+    base::MessageLoop::current()->RunUntilIdle();
+
+    if (kBackends[i].cache_type == net::MEMORY_CACHE)
+      continue;
+    base::IoCounters end_counters;
+    if (has_counters && metrics->GetIOCounters(&end_counters)) {
+      LogPerfResult(
+          (std::string(kBackends[i].name) + " bytes written").c_str(),
+          static_cast<double>(end_counters.WriteTransferCount -
+                              start_counters.WriteTransferCount),
+          "bytes");
+    }
+    LogPerfResult((std::string(kBackends[i].name) + " size on disk").c_str(),
+                  static_cast<double>(
+                      base::ComputeDirectorySize(cache_path_)),
+                  "bytes");
+  }
+}
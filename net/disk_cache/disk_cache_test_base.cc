@@ -59,8 +59,11 @@ DiskCacheTestWithCache::DiskCacheTestWithCache()
       memory_only_(false),
       simple_cache_mode_(false),
       simple_cache_wait_for_index_(true),
+      simple_cache_single_file_layout_(false),
       force_creation_(false),
       new_eviction_(false),
+      batch_rankings_(false),
+      memory_slab_storage_(false),
       first_cleanup_(true),
       integrity_(true),
       use_current_thread_(false),
@@ -247,6 +250,8 @@ void DiskCacheTestWithCache::InitMemoryCache() {
 
   if (size_)
     EXPECT_TRUE(mem_cache_->SetMaxSize(size_));
+  if (memory_slab_storage_)
+    mem_cache_->EnableSlabStorage();
 
   ASSERT_TRUE(mem_cache_->Init());
 }
@@ -276,6 +281,10 @@ void DiskCacheTestWithCache::CreateBackend(uint32 flags, base::Thread* thread) {
     scoped_ptr<disk_cache::SimpleBackendImpl> simple_backend(
         new disk_cache::SimpleBackendImpl(
             cache_path_, size_, type_, make_scoped_refptr(runner).get(), NULL));
+    if (simple_cache_single_file_layout_) {
+      simple_backend->SetEntryLayout(
+          disk_cache::SIMPLE_ENTRY_LAYOUT_SINGLE_FILE);
+    }
     int rv = simple_backend->Init(cb.callback());
     ASSERT_EQ(net::OK, cb.GetResult(rv));
     simple_cache_impl_ = simple_backend.get();
@@ -299,6 +308,8 @@ void DiskCacheTestWithCache::CreateBackend(uint32 flags, base::Thread* thread) {
     EXPECT_TRUE(cache_impl_->SetMaxSize(size_));
   if (new_eviction_)
     cache_impl_->SetNewEviction();
+  if (batch_rankings_)
+    cache_impl_->SetFlags(disk_cache::kBatchRankings);
   cache_impl_->SetType(type_);
   cache_impl_->SetFlags(flags);
   net::TestCompletionCallback cb;
@@ -70,10 +70,21 @@ class DiskCacheTestWithCache : public DiskCacheTest {
     memory_only_ = true;
   }
 
+  // The memory-only cache stores the entry data in slabs and evicts with a
+  // clock.
+  void SetMemorySlabStorage() {
+    memory_slab_storage_ = true;
+  }
+
   void SetSimpleCacheMode() {
     simple_cache_mode_ = true;
   }
 
+  // New simple cache entries keep streams 0 and 1 in a single file.
+  void SetSimpleCacheSingleFileLayout() {
+    simple_cache_single_file_layout_ = true;
+  }
+
   void SetMask(uint32 mask) {
     mask_ = mask;
   }
@@ -89,6 +100,10 @@ class DiskCacheTestWithCache : public DiskCacheTest {
     new_eviction_ = true;
   }
 
+  void SetBatchRankings() {
+    batch_rankings_ = true;
+  }
+
   void DisableSimpleCacheWaitForIndex() {
     simple_cache_wait_for_index_ = false;
   }
@@ -157,8 +172,11 @@ class DiskCacheTestWithCache : public DiskCacheTest {
   bool memory_only_;
   bool simple_cache_mode_;
   bool simple_cache_wait_for_index_;
+  bool simple_cache_single_file_layout_;
   bool force_creation_;
   bool new_eviction_;
+  bool batch_rankings_;
+  bool memory_slab_storage_;
   bool first_cleanup_;
   bool integrity_;
   bool use_current_thread_;
@@ -901,6 +901,13 @@ TEST_F(DiskCacheEntryTest, MemoryOnlyGrowData) {
   GrowData();
 }
 
+TEST_F(DiskCacheEntryTest, MemorySlabGrowData) {
+  SetMemoryOnlyMode();
+  SetMemorySlabStorage();
+  InitCache();
+  GrowData();
+}
+
 void DiskCacheEntryTest::TruncateData() {
   std::string key("the first key");
   disk_cache::Entry* entry;
@@ -978,6 +985,13 @@ TEST_F(DiskCacheEntryTest, MemoryOnlyTruncateData) {
   TruncateData();
 }
 
+TEST_F(DiskCacheEntryTest, MemorySlabTruncateData) {
+  SetMemoryOnlyMode();
+  SetMemorySlabStorage();
+  InitCache();
+  TruncateData();
+}
+
 void DiskCacheEntryTest::ZeroLengthIO() {
   std::string key("the first key");
   disk_cache::Entry* entry;
@@ -1033,6 +1047,13 @@ TEST_F(DiskCacheEntryTest, MemoryOnlyZeroLengthIO) {
   ZeroLengthIO();
 }
 
+TEST_F(DiskCacheEntryTest, MemorySlabZeroLengthIO) {
+  SetMemoryOnlyMode();
+  SetMemorySlabStorage();
+  InitCache();
+  ZeroLengthIO();
+}
+
 // Tests that we handle the content correctly when buffering, a feature of the
 // standard cache that permits fast responses to certain reads.
 void DiskCacheEntryTest::Buffering() {
@@ -1696,6 +1717,13 @@ TEST_F(DiskCacheEntryTest, MemoryOnlyHugeSparseIO) {
   HugeSparseIO();
 }
 
+TEST_F(DiskCacheEntryTest, MemorySlabHugeSparseIO) {
+  SetMemoryOnlyMode();
+  SetMemorySlabStorage();
+  InitCache();
+  HugeSparseIO();
+}
+
 void DiskCacheEntryTest::GetAvailableRange() {
   std::string key("the first key");
   disk_cache::Entry* entry;
@@ -3403,4 +3431,115 @@ TEST_F(DiskCacheEntryTest, SimpleCacheNonSequentialWrite) {
   entry = NULL;
 }
 
+TEST_F(DiskCacheEntryTest, SimpleCacheSingleFileStreamAccess) {
+  SetSimpleCacheMode();
+  SetSimpleCacheSingleFileLayout();
+  InitCache();
+  StreamAccess();
+}
+
+TEST_F(DiskCacheEntryTest, SimpleCacheSingleFileGrowData) {
+  SetSimpleCacheMode();
+  SetSimpleCacheSingleFileLayout();
+  InitCache();
+  GrowData();
+}
+
+TEST_F(DiskCacheEntryTest, SimpleCacheSingleFileTruncateData) {
+  SetSimpleCacheMode();
+  SetSimpleCacheSingleFileLayout();
+  InitCache();
+  TruncateData();
+}
+
+TEST_F(DiskCacheEntryTest, SimpleCacheSingleFileSizeChanges) {
+  SetSimpleCacheMode();
+  SetSimpleCacheSingleFileLayout();
+  InitCache();
+  SizeChanges();
+}
+
+// Tests that in the single file layout, streams 0 and 1 share the first file,
+// and stream 2 gets a file only once it has data.
+TEST_F(DiskCacheEntryTest, SimpleCacheSingleFileLayout) {
+  SetSimpleCacheMode();
+  SetSimpleCacheSingleFileLayout();
+  InitCache();
+  const char key[] = "the first key";
+
+  const int kSize = 1000;
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kSize));
+  scoped_refptr<net::IOBuffer> read_buffer(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer->data(), kSize, false);
+
+  disk_cache::Entry* entry = NULL;
+  ASSERT_EQ(net::OK, CreateEntry(key, &entry));
+  EXPECT_EQ(100, WriteData(entry, 0, 0, buffer.get(), 100, false));
+  EXPECT_EQ(kSize, WriteData(entry, 1, 0, buffer.get(), kSize, false));
+  entry->Close();
+
+  // The entry runs its IO in order, so its files are complete once it has
+  // been opened again.
+  ASSERT_EQ(net::OK, OpenEntry(key, &entry));
+  EXPECT_TRUE(base::PathExists(cache_path_.AppendASCII(
+      disk_cache::simple_util::GetFilenameFromKeyAndIndex(key, 0))));
+  EXPECT_FALSE(base::PathExists(cache_path_.AppendASCII(
+      disk_cache::simple_util::GetFilenameFromKeyAndIndex(key, 1))));
+  EXPECT_FALSE(base::PathExists(cache_path_.AppendASCII(
+      disk_cache::simple_util::GetFilenameFromKeyAndIndex(key, 2))));
+  EXPECT_EQ(100, entry->GetDataSize(0));
+  EXPECT_EQ(kSize, entry->GetDataSize(1));
+  EXPECT_EQ(0, entry->GetDataSize(2));
+  EXPECT_EQ(100, ReadData(entry, 0, 0, read_buffer.get(), kSize));
+  EXPECT_EQ(0, memcmp(buffer->data(), read_buffer->data(), 100));
+  EXPECT_EQ(kSize, ReadData(entry, 1, 0, read_buffer.get(), kSize));
+  EXPECT_EQ(0, memcmp(buffer->data(), read_buffer->data(), kSize));
+
+  EXPECT_EQ(10, WriteData(entry, 2, 0, buffer.get(), 10, false));
+  EXPECT_EQ(50, WriteData(entry, 1, 0, buffer.get(), 50, true));
+  entry->Close();
+
+  ASSERT_EQ(net::OK, OpenEntry(key, &entry));
+  EXPECT_TRUE(base::PathExists(cache_path_.AppendASCII(
+      disk_cache::simple_util::GetFilenameFromKeyAndIndex(key, 2))));
+  EXPECT_EQ(100, entry->GetDataSize(0));
+  EXPECT_EQ(50, entry->GetDataSize(1));
+  EXPECT_EQ(10, entry->GetDataSize(2));
+  EXPECT_EQ(100, ReadData(entry, 0, 0, read_buffer.get(), kSize));
+  EXPECT_EQ(0, memcmp(buffer->data(), read_buffer->data(), 100));
+  EXPECT_EQ(10, ReadData(entry, 2, 0, read_buffer.get(), kSize));
+  EXPECT_EQ(0, memcmp(buffer->data(), read_buffer->data(), 10));
+  entry->Close();
+}
+
+// Tests that entries written one file per stream can still be read once new
+// entries use the single file layout.
+TEST_F(DiskCacheEntryTest, SimpleCacheSingleFileOpensFilePerStreamEntries) {
+  SetSimpleCacheMode();
+  InitCache();
+  const char key[] = "the first key";
+
+  const int kSize = 100;
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kSize));
+  scoped_refptr<net::IOBuffer> read_buffer(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer->data(), kSize, false);
+
+  disk_cache::Entry* entry = NULL;
+  ASSERT_EQ(net::OK, CreateEntry(key, &entry));
+  EXPECT_EQ(kSize, WriteData(entry, 1, 0, buffer.get(), kSize, false));
+  entry->Close();
+  ASSERT_EQ(net::OK, OpenEntry(key, &entry));
+  entry->Close();
+  base::MessageLoop::current()->RunUntilIdle();
+  cache_.reset();
+
+  SetSimpleCacheSingleFileLayout();
+  DisableFirstCleanup();
+  InitCache();
+  ASSERT_EQ(net::OK, OpenEntry(key, &entry));
+  EXPECT_EQ(kSize, ReadData(entry, 1, 0, read_buffer.get(), kSize));
+  EXPECT_EQ(0, memcmp(buffer->data(), read_buffer->data(), kSize));
+  entry->Close();
+}
+
 #endif  // defined(OS_POSIX)
@@ -26,8 +26,22 @@
 // size so that we have a chance to see an element again and move it to another
 // list.
 
+// Moving an entry to the head of its list takes a few synchronous writes to
+// the block files, so with batched rank updates (kBatchRankings) the accesses
+// are only recorded in memory, and the entries are moved later on, in the
+// order of their last access: when the entry is closed, before the cache is
+// trimmed or enumerated, when too many updates are waiting, and after a short
+// delay otherwise. Each move still goes through Rankings::Remove() and
+// Rankings::Insert(), so the lists are as safe from crashes as they are
+// without batching: a crash only loses the pending moves, which leaves a
+// consistent list in a slightly older order.
+
 #include "net/disk_cache/eviction.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/logging.h"
@@ -50,6 +64,8 @@ const int kCleanUpMargin = 1024 * 1024;
 const int kHighUse = 10;  // Reuse count to be on the HIGH_USE list.
 const int kTargetTime = 24 * 7;  // Time to be evicted (hours since last use).
 const int kMaxDelayedTrims = 60;
+const int kRankFlushDelayMs = 5000;
+const size_t kMaxPendingRankUpdates = 64;
 
 int LowWaterAdjust(int high_water) {
   if (high_water < kCleanUpMargin)
@@ -71,6 +87,9 @@ namespace disk_cache {
 Eviction::Eviction()
     : backend_(NULL),
       init_(false),
+      batch_rankings_(false),
+      rank_flush_pending_(false),
+      rank_sequence_(0),
       ptr_factory_(this) {
 }
 
@@ -92,6 +111,10 @@ void Eviction::Init(BackendImpl* backend) {
   trim_delays_ = 0;
   init_ = true;
   test_mode_ = false;
+  batch_rankings_ = (backend->user_flags_ & kBatchRankings) != 0;
+  rank_flush_pending_ = false;
+  rank_sequence_ = 0;
+  pending_ranks_.clear();
 }
 
 void Eviction::Stop() {
@@ -100,6 +123,10 @@ void Eviction::Stop() {
   if (!init_)
     return;
 
+  // Save the order of the entries before the backend goes away.
+  FlushRankUpdates();
+  batch_rankings_ = false;
+
   // We want to stop further evictions, so let's pretend that we are busy from
   // this point on.
   DCHECK(!trimming_);
@@ -114,6 +141,10 @@ void Eviction::TrimCache(bool empty) {
   if (!empty && !ShouldTrim())
     return PostDelayedTrim();
 
+  // The entries to evict are taken from the tail of the lists, so they have to
+  // be in order.
+  FlushRankUpdates();
+
   if (new_eviction_)
     return TrimCacheV2(empty);
 
@@ -163,10 +194,32 @@ void Eviction::TrimCache(bool empty) {
 }
 
 void Eviction::UpdateRank(EntryImpl* entry, bool modified) {
-  if (new_eviction_)
-    return UpdateRankV2(entry, modified);
+  if (batch_rankings_ && !trimming_)
+    return DeferRankUpdate(entry, modified);
 
-  rankings_->UpdateRank(entry->rankings(), modified, GetListForEntry(entry));
+  ApplyRankUpdate(entry, modified);
+}
+
+void Eviction::FlushRankUpdates() {
+  if (pending_ranks_.empty())
+    return;
+
+  // Moving the entries in the order of their last access leaves the most
+  // recently used entry at the head of its list.
+  std::vector<std::pair<int64, CacheAddr> > updates;
+  updates.reserve(pending_ranks_.size());
+  for (PendingRankUpdates::const_iterator it = pending_ranks_.begin();
+       it != pending_ranks_.end(); ++it) {
+    updates.push_back(std::make_pair(it->second.sequence, it->first));
+  }
+  std::sort(updates.begin(), updates.end());
+
+  PendingRankUpdates pending;
+  pending.swap(pending_ranks_);
+  for (size_t i = 0; i < updates.size(); i++) {
+    const PendingRankUpdate& update = pending[updates[i].second];
+    ApplyRankUpdate(update.entry, update.modified);
+  }
 }
 
 void Eviction::OnOpenEntry(EntryImpl* entry) {
@@ -182,6 +235,7 @@ void Eviction::OnCreateEntry(EntryImpl* entry) {
 }
 
 void Eviction::OnDoomEntry(EntryImpl* entry) {
+  DropRankUpdate(entry);
   if (new_eviction_)
     return OnDoomEntryV2(entry);
 
@@ -196,6 +250,16 @@ void Eviction::OnDestroyEntry(EntryImpl* entry) {
     return OnDestroyEntryV2(entry);
 }
 
+void Eviction::OnCloseEntry(Addr address) {
+  PendingRankUpdates::iterator it = pending_ranks_.find(address.value());
+  if (it == pending_ranks_.end())
+    return;
+
+  PendingRankUpdate update = it->second;
+  pending_ranks_.erase(it);
+  ApplyRankUpdate(update.entry, update.modified);
+}
+
 void Eviction::SetTestMode() {
   test_mode_ = true;
 }
@@ -225,6 +289,52 @@ void Eviction::DelayedTrim() {
   TrimCache(false);
 }
 
+void Eviction::DeferRankUpdate(EntryImpl* entry, bool modified) {
+  // Keep the times current for whoever looks at the entry before the flush.
+  CacheRankingsBlock* node = entry->rankings();
+  int64 now = Time::Now().ToInternalValue();
+  node->Data()->last_used = now;
+  if (modified)
+    node->Data()->last_modified = now;
+
+  PendingRankUpdate& update =
+      pending_ranks_[entry->entry()->address().value()];
+  update.modified = (update.entry && update.modified) || modified;
+  update.entry = entry;
+  update.sequence = rank_sequence_++;
+
+  if (pending_ranks_.size() >= kMaxPendingRankUpdates)
+    return FlushRankUpdates();
+
+  PostDelayedRankFlush();
+}
+
+void Eviction::ApplyRankUpdate(EntryImpl* entry, bool modified) {
+  if (new_eviction_)
+    return UpdateRankV2(entry, modified);
+
+  rankings_->UpdateRank(entry->rankings(), modified, GetListForEntry(entry));
+}
+
+void Eviction::DropRankUpdate(EntryImpl* entry) {
+  pending_ranks_.erase(entry->entry()->address().value());
+}
+
+void Eviction::PostDelayedRankFlush() {
+  if (rank_flush_pending_)
+    return;
+  rank_flush_pending_ = true;
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&Eviction::DelayedRankFlush, ptr_factory_.GetWeakPtr()),
+      base::TimeDelta::FromMilliseconds(kRankFlushDelayMs));
+}
+
+void Eviction::DelayedRankFlush() {
+  rank_flush_pending_ = false;
+  FlushRankUpdates();
+}
+
 bool Eviction::ShouldTrim() {
   if (!FallingBehind(header_->num_bytes, max_size_) &&
       trim_delays_ < kMaxDelayedTrims && backend_->IsLoaded()) {
@@ -295,6 +405,7 @@ bool Eviction::EvictEntry(CacheRankingsBlock* node, bool empty,
     EntryStore* info = entry->entry()->Data();
     DCHECK_EQ(ENTRY_NORMAL, info->state);
 
+    DropRankUpdate(entry);
     rankings_->Remove(entry->rankings(), GetListForEntryV2(entry), true);
     info->state = ENTRY_EVICTED;
     entry->entry()->Store();
@@ -6,7 +6,9 @@
 #define NET_DISK_CACHE_EVICTION_H_
 
 #include "base/basictypes.h"
+#include "base/containers/hash_tables.h"
 #include "base/memory/weak_ptr.h"
+#include "net/disk_cache/addr.h"
 #include "net/disk_cache/rankings.h"
 
 namespace disk_cache {
@@ -30,24 +32,45 @@ class Eviction {
   // use.
   void TrimCache(bool empty);
 
-  // Updates the ranking information for an entry.
+  // Updates the ranking information for an entry. When rank updates are
+  // batched, the entry is only moved on its list by a later flush.
   void UpdateRank(EntryImpl* entry, bool modified);
 
+  // Applies all the rank updates that are waiting to be flushed.
+  void FlushRankUpdates();
+
   // Notifications of interesting events for a given entry.
   void OnOpenEntry(EntryImpl* entry);
   void OnCreateEntry(EntryImpl* entry);
   void OnDoomEntry(EntryImpl* entry);
   void OnDestroyEntry(EntryImpl* entry);
+  void OnCloseEntry(Addr address);
 
   // Testing interface.
   void SetTestMode();
   void TrimDeletedList(bool empty);
 
  private:
+  // A rank update that has not been written to the lists yet. The sequence
+  // number keeps the order of the updates when they are flushed.
+  struct PendingRankUpdate {
+    PendingRankUpdate() : entry(NULL), sequence(0), modified(false) {}
+
+    EntryImpl* entry;
+    int64 sequence;
+    bool modified;
+  };
+  typedef base::hash_map<CacheAddr, PendingRankUpdate> PendingRankUpdates;
+
   void PostDelayedTrim();
   void DelayedTrim();
   bool ShouldTrim();
   bool ShouldTrimDeleted();
+  void DeferRankUpdate(EntryImpl* entry, bool modified);
+  void ApplyRankUpdate(EntryImpl* entry, bool modified);
+  void DropRankUpdate(EntryImpl* entry);
+  void PostDelayedRankFlush();
+  void DelayedRankFlush();
   void ReportTrimTimes(EntryImpl* entry);
   Rankings::List GetListForEntry(EntryImpl* entry);
   bool EvictEntry(CacheRankingsBlock* node, bool empty, Rankings::List list);
@@ -81,6 +104,10 @@ class Eviction {
   bool delay_trim_;
   bool init_;
   bool test_mode_;
+  bool batch_rankings_;
+  bool rank_flush_pending_;
+  int64 rank_sequence_;
+  PendingRankUpdates pending_ranks_;
   base::WeakPtrFactory<Eviction> ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(Eviction);
@@ -128,6 +128,9 @@ int FlashEntryImpl::ReadyForSparseIO(const CompletionCallback& callback) {
   return net::ERR_FAILED;
 }
 
+void FlashEntryImpl::SetPriority(net::RequestPriority priority) {
+}
+
 void FlashEntryImpl::OnInitComplete(
     scoped_ptr<KeyAndStreamSizes> key_and_stream_sizes) {
   DCHECK(!callback_.is_null());
@@ -70,6 +70,7 @@ class NET_EXPORT_PRIVATE FlashEntryImpl
   virtual bool CouldBeSparse() const OVERRIDE;
   virtual void CancelSparseIO() OVERRIDE;
   virtual int ReadyForSparseIO(const CompletionCallback& callback) OVERRIDE;
+  virtual void SetPriority(net::RequestPriority priority) OVERRIDE;
 
  private:
   void OnInitComplete(scoped_ptr<KeyAndStreamSizes> key_and_stream_sizes);
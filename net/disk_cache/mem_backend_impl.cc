@@ -87,6 +87,11 @@ bool MemBackendImpl::SetMaxSize(int max_bytes) {
   return true;
 }
 
+void MemBackendImpl::EnableSlabStorage() {
+  DCHECK(entries_.empty());
+  slab_allocator_.reset(new MemSlabAllocator());
+}
+
 void MemBackendImpl::InternalDoomEntry(MemEntryImpl* entry) {
   // Only parent entries can be passed into this method.
   DCHECK(entry->type() == MemEntryImpl::kParentEntry);
@@ -102,7 +107,10 @@ void MemBackendImpl::InternalDoomEntry(MemEntryImpl* entry) {
 }
 
 void MemBackendImpl::UpdateRank(MemEntryImpl* node) {
-  rankings_.UpdateRank(node);
+  if (slab_allocator_)
+    node->set_referenced(true);
+  else
+    rankings_.UpdateRank(node);
 }
 
 void MemBackendImpl::ModifyStorageSize(int32 old_size, int32 new_size) {
@@ -250,6 +258,11 @@ bool MemBackendImpl::DoomEntriesBetween(const Time initial_time,
 
   DCHECK(end_time >= initial_time);
 
+  if (slab_allocator_) {
+    DoomEntriesByScan(initial_time, end_time);
+    return true;
+  }
+
   MemEntryImpl* node = rankings_.GetNext(NULL);
   // Last valid entry before |node|.
   // Note, that entries after |node| may become invalid during |node| doom in
@@ -276,6 +289,11 @@ bool MemBackendImpl::DoomEntriesBetween(const Time initial_time,
 }
 
 bool MemBackendImpl::DoomEntriesSince(const Time initial_time) {
+  if (slab_allocator_) {
+    DoomEntriesByScan(initial_time, Time::Max());
+    return true;
+  }
+
   for (;;) {
     // Get the entry in the front.
     Entry* entry = rankings_.GetNext(NULL);
@@ -305,6 +323,11 @@ bool MemBackendImpl::OpenNextEntry(void** iter, Entry** next_entry) {
 }
 
 void MemBackendImpl::TrimCache(bool empty) {
+  if (slab_allocator_) {
+    TrimCacheWithClock(empty);
+    return;
+  }
+
   MemEntryImpl* next = rankings_.GetPrev(NULL);
   if (!next)
     return;
@@ -321,6 +344,56 @@ void MemBackendImpl::TrimCache(bool empty) {
   return;
 }
 
+void MemBackendImpl::TrimCacheWithClock(bool empty) {
+  int target_size = empty ? 0 : LowWaterAdjust(max_size_);
+
+  // The hand starts at the oldest entry and moves towards the head. A
+  // referenced entry loses its bit and moves to the head, where the hand
+  // reaches it again by the end of the sweep, so no entry is looked at more
+  // than twice.
+  MemEntryImpl* next = rankings_.GetPrev(NULL);
+  while (current_size_ > target_size && next) {
+    MemEntryImpl* node = next;
+    next = rankings_.GetPrev(next);
+    if (!empty && node->InUse())
+      continue;
+
+    if (!empty && node->referenced()) {
+      node->set_referenced(false);
+      rankings_.UpdateRank(node);
+      continue;
+    }
+
+    // Dooming a sparse entry dooms its children too, and the clock does not
+    // keep them behind their parent, so |next| may go away.
+    bool restart = node->type() == MemEntryImpl::kParentEntry &&
+                   node->CouldBeSparse();
+    node->Doom();
+    if (restart)
+      next = rankings_.GetPrev(NULL);
+  }
+}
+
+void MemBackendImpl::DoomEntriesByScan(Time initial_time, Time end_time) {
+  MemEntryImpl* last_valid = NULL;
+  MemEntryImpl* node = rankings_.GetNext(NULL);
+  while (node) {
+    Time last_used = node->GetLastUsed();
+    if (last_used < initial_time || last_used >= end_time) {
+      last_valid = node;
+      node = rankings_.GetNext(node);
+      continue;
+    }
+
+    // As in TrimCacheWithClock(), the children of a sparse entry can be
+    // anywhere on the list, including before it.
+    if (node->type() == MemEntryImpl::kParentEntry && node->CouldBeSparse())
+      last_valid = NULL;
+    node->Doom();
+    node = rankings_.GetNext(last_valid);
+  }
+}
+
 void MemBackendImpl::AddStorageSize(int32 bytes) {
   current_size_ += bytes;
   DCHECK_GE(current_size_, 0);
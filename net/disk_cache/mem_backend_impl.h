@@ -9,8 +9,10 @@
 
 #include "base/compiler_specific.h"
 #include "base/containers/hash_tables.h"
+#include "base/memory/scoped_ptr.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/disk_cache/mem_rankings.h"
+#include "net/disk_cache/mem_slab_allocator.h"
 
 namespace net {
 class NetLog;
@@ -40,6 +42,17 @@ class NET_EXPORT_PRIVATE MemBackendImpl : public Backend {
   // Sets the maximum size for the total amount of data stored by this instance.
   bool SetMaxSize(int max_bytes);
 
+  // Stores the data of the entries in size-class chunks carved out of slabs,
+  // and replaces the strict LRU order with a clock: using an entry only sets
+  // its reference bit, and eviction gives referenced entries a second chance
+  // instead of moving every used entry to the head of the list. Must be
+  // called before any entry is created.
+  void EnableSlabStorage();
+
+  // Returns the allocator for the entry data, or NULL if the entries keep
+  // their data in plain vectors.
+  MemSlabAllocator* slab_allocator() { return slab_allocator_.get(); }
+
   // Permanently deletes an entry.
   void InternalDoomEntry(MemEntryImpl* entry);
 
@@ -101,6 +114,13 @@ class NET_EXPORT_PRIVATE MemBackendImpl : public Backend {
   // use.
   void TrimCache(bool empty);
 
+  // TrimCache() for the clock eviction.
+  void TrimCacheWithClock(bool empty);
+
+  // Dooms the entries last used in [|initial_time|, |end_time|) by looking at
+  // all of them, for when the rankings are not ordered by last use.
+  void DoomEntriesByScan(base::Time initial_time, base::Time end_time);
+
   // Handles the used storage count.
   void AddStorageSize(int32 bytes);
   void SubstractStorageSize(int32 bytes);
@@ -109,6 +129,7 @@ class NET_EXPORT_PRIVATE MemBackendImpl : public Backend {
   MemRankings rankings_;  // Rankings to be able to trim the cache.
   int32 max_size_;        // Maximum data size for this instance.
   int32 current_size_;
+  scoped_ptr<MemSlabAllocator> slab_allocator_;
 
   net::NetLog* net_log_;
 
@@ -68,6 +68,7 @@ MemEntryImpl::MemEntryImpl(MemBackendImpl* backend) {
   child_first_pos_ = 0;
   next_ = NULL;
   prev_ = NULL;
+  referenced_ = false;
   for (int i = 0; i < NUM_STREAMS; i++)
     data_size_[i] = 0;
 }
@@ -273,8 +274,12 @@ int MemEntryImpl::ReadyForSparseIO(const CompletionCallback& callback) {
 // ------------------------------------------------------------------------
 
 MemEntryImpl::~MemEntryImpl() {
-  for (int i = 0; i < NUM_STREAMS; i++)
+  MemSlabAllocator* allocator = backend_->slab_allocator();
+  for (int i = 0; i < NUM_STREAMS; i++) {
+    if (allocator)
+      slab_data_[i].Clear(allocator);
     backend_->ModifyStorageSize(data_size_[i], 0);
+  }
   backend_->ModifyStorageSize(static_cast<int32>(key_.size()), 0);
   net_log_.EndEvent(net::NetLog::TYPE_DISK_CACHE_MEM_ENTRY_IMPL);
 }
@@ -298,7 +303,10 @@ int MemEntryImpl::InternalReadData(int index, int offset, IOBuffer* buf,
 
   UpdateRank(false);
 
-  memcpy(buf->data(), &(data_[index])[offset], buf_len);
+  if (backend_->slab_allocator())
+    slab_data_[index].Read(offset, buf->data(), buf_len);
+  else
+    memcpy(buf->data(), &(data_[index])[offset], buf_len);
   return buf_len;
 }
 
@@ -332,6 +340,11 @@ int MemEntryImpl::InternalWriteData(int index, int offset, IOBuffer* buf,
     if (entry_size > offset + buf_len) {
       backend_->ModifyStorageSize(entry_size, offset + buf_len);
       data_size_[index] = offset + buf_len;
+      // Give the chunks past the new end back right away.
+      if (backend_->slab_allocator()) {
+        slab_data_[index].SetCapacity(backend_->slab_allocator(),
+                                      offset + buf_len);
+      }
     }
   }
 
@@ -340,7 +353,10 @@ int MemEntryImpl::InternalWriteData(int index, int offset, IOBuffer* buf,
   if (!buf_len)
     return 0;
 
-  memcpy(&(data_[index])[offset], buf->data(), buf_len);
+  if (backend_->slab_allocator())
+    slab_data_[index].Write(offset, buf->data(), buf_len);
+  else
+    memcpy(&(data_[index])[offset], buf->data(), buf_len);
   return buf_len;
 }
 
@@ -517,15 +533,23 @@ void MemEntryImpl::PrepareTarget(int index, int offset, int buf_len) {
   if (entry_size >= offset + buf_len)
     return;  // Not growing the stored data.
 
-  if (static_cast<int>(data_[index].size()) < offset + buf_len)
+  MemSlabAllocator* allocator = backend_->slab_allocator();
+  if (allocator) {
+    if (slab_data_[index].capacity() < offset + buf_len)
+      slab_data_[index].SetCapacity(allocator, offset + buf_len);
+  } else if (static_cast<int>(data_[index].size()) < offset + buf_len) {
     data_[index].resize(offset + buf_len);
+  }
 
   if (offset <= entry_size)
     return;  // There is no "hole" on the stored data.
 
   // Cleanup the hole not written by the user. The point is to avoid returning
   // random stuff later on.
-  memset(&(data_[index])[entry_size], 0, offset - entry_size);
+  if (allocator)
+    slab_data_[index].Zero(entry_size, offset - entry_size);
+  else
+    memset(&(data_[index])[entry_size], 0, offset - entry_size);
 }
 
 void MemEntryImpl::UpdateRank(bool modified) {
@@ -535,8 +559,15 @@ void MemEntryImpl::UpdateRank(bool modified) {
   if (modified)
     last_modified_ = current;
 
-  if (!doomed_)
-    backend_->UpdateRank(this);
+  if (doomed_)
+    return;
+
+  // With the clock eviction a write does not count as a use: almost every
+  // write follows the creation of the entry, which already put it at the head.
+  if (modified && backend_->slab_allocator())
+    return;
+
+  backend_->UpdateRank(this);
 }
 
 bool MemEntryImpl::InitSparseInfo() {
@@ -10,6 +10,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "net/base/net_log.h"
 #include "net/disk_cache/disk_cache.h"
+#include "net/disk_cache/mem_slab_allocator.h"
 
 namespace disk_cache {
 
@@ -78,6 +79,15 @@ class MemEntryImpl : public Entry {
     prev_ = prev;
   }
 
+  // The reference bit of the clock eviction (see MemBackendImpl).
+  bool referenced() const {
+    return referenced_;
+  }
+
+  void set_referenced(bool referenced) {
+    referenced_ = referenced;
+  }
+
   EntryType type() const {
     return parent_ ? kChildEntry : kParentEntry;
   }
@@ -111,6 +121,7 @@ class MemEntryImpl : public Entry {
   virtual bool CouldBeSparse() const OVERRIDE;
   virtual void CancelSparseIO() OVERRIDE {}
   virtual int ReadyForSparseIO(const CompletionCallback& callback) OVERRIDE;
+  virtual void SetPriority(net::RequestPriority priority) OVERRIDE {}
 
  private:
   typedef base::hash_map<int, MemEntryImpl*> EntryMap;
@@ -163,6 +174,7 @@ class MemEntryImpl : public Entry {
 
   std::string key_;
   std::vector<char> data_[NUM_STREAMS];  // User data.
+  MemSlabBuffer slab_data_[NUM_STREAMS];  // User data, with slab storage.
   int32 data_size_[NUM_STREAMS];
   int ref_count_;
 
@@ -172,6 +184,7 @@ class MemEntryImpl : public Entry {
   MemEntryImpl* next_;        // Pointers for the LRU list.
   MemEntryImpl* prev_;
   MemEntryImpl* parent_;      // Pointer to the parent entry.
+  bool referenced_;           // Used since the clock hand last passed.
   scoped_ptr<EntryMap> children_;
 
   base::Time last_modified_;  // LRU information.
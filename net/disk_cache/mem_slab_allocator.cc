@@ -0,0 +1,248 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/mem_slab_allocator.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace {
+
+// The smallest chunk. Each class is four times bigger than the previous one.
+const int kMinChunkSize = 256;
+
+}  // namespace
+
+namespace disk_cache {
+
+const int MemSlabAllocator::kSlabSize;
+const int MemSlabAllocator::kMaxChunkSize;
+
+struct MemSlabAllocator::Slab {
+  char* memory;
+  int size_class;
+  int used;         // Chunks handed out.
+  int carved;       // Chunks ever handed out from |memory|. The memory after
+                    // them has never been touched.
+  char* free_list;  // Chunks returned to this slab, linked through their
+                    // first bytes.
+};
+
+MemSlabAllocator::MemSlabAllocator()
+    : reserved_bytes_(0),
+      allocated_bytes_(0) {
+  for (int i = 0; i < kNumSizeClasses; i++)
+    num_slabs_[i] = 0;
+}
+
+MemSlabAllocator::~MemSlabAllocator() {
+  DCHECK(!allocated_bytes_);
+  for (SlabMap::iterator it = slabs_.begin(); it != slabs_.end(); ++it) {
+    delete[] it->second->memory;
+    delete it->second;
+  }
+}
+
+// static
+int MemSlabAllocator::SizeClassFor(int size) {
+  DCHECK_LE(size, kMaxChunkSize);
+  int size_class = 0;
+  while (ChunkSize(size_class) < size)
+    size_class++;
+  return size_class;
+}
+
+// static
+int MemSlabAllocator::ChunkSize(int size_class) {
+  DCHECK(size_class >= 0 && size_class < kNumSizeClasses);
+  return kMinChunkSize << (2 * size_class);
+}
+
+char* MemSlabAllocator::Allocate(int size_class) {
+  std::set<Slab*>& partial = partial_slabs_[size_class];
+  Slab* slab;
+  if (partial.empty()) {
+    slab = new Slab;
+    slab->memory = new char[kSlabSize];
+    slab->size_class = size_class;
+    slab->used = 0;
+    slab->carved = 0;
+    slab->free_list = NULL;
+    slabs_[slab->memory] = slab;
+    partial.insert(slab);
+    num_slabs_[size_class]++;
+    reserved_bytes_ += kSlabSize;
+  } else {
+    slab = *partial.begin();
+  }
+
+  int chunk_size = ChunkSize(size_class);
+  char* chunk;
+  if (slab->free_list) {
+    chunk = slab->free_list;
+    slab->free_list = *reinterpret_cast<char**>(chunk);
+  } else {
+    chunk = slab->memory + slab->carved * chunk_size;
+    slab->carved++;
+  }
+
+  slab->used++;
+  if (slab->used == kSlabSize / chunk_size)
+    partial.erase(slab);
+
+  allocated_bytes_ += chunk_size;
+  return chunk;
+}
+
+void MemSlabAllocator::Free(char* chunk, int size_class) {
+  Slab* slab = SlabFor(chunk);
+  DCHECK_EQ(size_class, slab->size_class);
+  DCHECK_GT(slab->used, 0);
+
+  *reinterpret_cast<char**>(chunk) = slab->free_list;
+  slab->free_list = chunk;
+  slab->used--;
+  allocated_bytes_ -= ChunkSize(size_class);
+
+  // Keep one empty slab around so that a buffer bouncing around a slab
+  // boundary does not allocate and release a slab every time.
+  if (!slab->used && num_slabs_[size_class] > 1) {
+    ReleaseSlab(slab);
+    return;
+  }
+  partial_slabs_[size_class].insert(slab);
+}
+
+MemSlabAllocator::Slab* MemSlabAllocator::SlabFor(char* chunk) const {
+  SlabMap::const_iterator it = slabs_.upper_bound(chunk);
+  DCHECK(it != slabs_.begin());
+  --it;
+  DCHECK(chunk < it->first + kSlabSize);
+  return it->second;
+}
+
+void MemSlabAllocator::ReleaseSlab(Slab* slab) {
+  partial_slabs_[slab->size_class].erase(slab);
+  slabs_.erase(slab->memory);
+  num_slabs_[slab->size_class]--;
+  reserved_bytes_ -= kSlabSize;
+  delete[] slab->memory;
+  delete slab;
+}
+
+// ------------------------------------------------------------------------
+
+MemSlabBuffer::MemSlabBuffer() : size_class_(0), capacity_(0) {
+}
+
+MemSlabBuffer::~MemSlabBuffer() {
+  DCHECK(chunks_.empty());
+}
+
+void MemSlabBuffer::SetCapacity(MemSlabAllocator* allocator, int size) {
+  const int kMaxChunkSize = MemSlabAllocator::kMaxChunkSize;
+  if (size <= 0) {
+    Clear(allocator);
+    return;
+  }
+
+  if (size <= kMaxChunkSize) {
+    int size_class = MemSlabAllocator::SizeClassFor(size);
+    if (chunks_.size() == 1 && size_class == size_class_)
+      return;
+
+    // Move to a single chunk of the right class.
+    char* chunk = allocator->Allocate(size_class);
+    int keep = std::min(capacity_, MemSlabAllocator::ChunkSize(size_class));
+    if (keep)
+      Read(0, chunk, keep);
+    Clear(allocator);
+    chunks_.push_back(chunk);
+    size_class_ = size_class;
+    capacity_ = MemSlabAllocator::ChunkSize(size_class);
+    return;
+  }
+
+  const int kMaxSizeClass = MemSlabAllocator::kNumSizeClasses - 1;
+  if (chunks_.size() == 1 && size_class_ != kMaxSizeClass) {
+    char* chunk = allocator->Allocate(kMaxSizeClass);
+    memcpy(chunk, chunks_[0], capacity_);
+    allocator->Free(chunks_[0], size_class_);
+    chunks_[0] = chunk;
+  }
+  size_class_ = kMaxSizeClass;
+
+  size_t num_chunks = (size + kMaxChunkSize - 1) / kMaxChunkSize;
+  while (chunks_.size() > num_chunks) {
+    allocator->Free(chunks_.back(), size_class_);
+    chunks_.pop_back();
+  }
+  while (chunks_.size() < num_chunks)
+    chunks_.push_back(allocator->Allocate(size_class_));
+  capacity_ = static_cast<int>(num_chunks) * kMaxChunkSize;
+}
+
+void MemSlabBuffer::Clear(MemSlabAllocator* allocator) {
+  for (size_t i = 0; i < chunks_.size(); i++)
+    allocator->Free(chunks_[i], size_class_);
+  chunks_.clear();
+  size_class_ = 0;
+  capacity_ = 0;
+}
+
+void MemSlabBuffer::Read(int offset, char* dest, int len) const {
+  DCHECK_GE(offset, 0);
+  DCHECK_LE(offset + len, capacity_);
+  while (len > 0) {
+    int available;
+    const char* src = ChunkAt(offset, &available);
+    int bytes = std::min(len, available);
+    memcpy(dest, src, bytes);
+    dest += bytes;
+    offset += bytes;
+    len -= bytes;
+  }
+}
+
+void MemSlabBuffer::Write(int offset, const char* src, int len) {
+  DCHECK_GE(offset, 0);
+  DCHECK_LE(offset + len, capacity_);
+  while (len > 0) {
+    int available;
+    char* dest = ChunkAt(offset, &available);
+    int bytes = std::min(len, available);
+    memcpy(dest, src, bytes);
+    src += bytes;
+    offset += bytes;
+    len -= bytes;
+  }
+}
+
+void MemSlabBuffer::Zero(int offset, int len) {
+  DCHECK_GE(offset, 0);
+  DCHECK_LE(offset + len, capacity_);
+  while (len > 0) {
+    int available;
+    char* dest = ChunkAt(offset, &available);
+    int bytes = std::min(len, available);
+    memset(dest, 0, bytes);
+    offset += bytes;
+    len -= bytes;
+  }
+}
+
+char* MemSlabBuffer::ChunkAt(int offset, int* available) const {
+  // A single chunk buffer is never bigger than kMaxChunkSize, so this works
+  // for both layouts.
+  const int kMaxChunkSize = MemSlabAllocator::kMaxChunkSize;
+  int index = offset / kMaxChunkSize;
+  int chunk_offset = offset % kMaxChunkSize;
+  *available = std::min(kMaxChunkSize, capacity_) - chunk_offset;
+  return chunks_[index] + chunk_offset;
+}
+
+}  // namespace disk_cache
@@ -0,0 +1,115 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_DISK_CACHE_MEM_SLAB_ALLOCATOR_H_
+#define NET_DISK_CACHE_MEM_SLAB_ALLOCATOR_H_
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "net/base/net_export.h"
+
+namespace disk_cache {
+
+// Hands out fixed size chunks of memory for the data of the memory-only cache.
+// Chunks of each size class are carved out of large slabs that are released
+// as soon as they hold no chunk, so a long lived cache with a lot of churn
+// does not leave the heap fragmented with stream sized blocks. This class is
+// not thread safe.
+class NET_EXPORT_PRIVATE MemSlabAllocator {
+ public:
+  enum {
+    kNumSizeClasses = 4
+  };
+
+  // The size of each slab, and of the largest chunk.
+  static const int kSlabSize = 64 * 1024;
+  static const int kMaxChunkSize = 16 * 1024;
+
+  MemSlabAllocator();
+  ~MemSlabAllocator();
+
+  // Returns the smallest size class that can hold |size| bytes. |size| must
+  // not be bigger than kMaxChunkSize.
+  static int SizeClassFor(int size);
+
+  // Returns the size of the chunks of |size_class|.
+  static int ChunkSize(int size_class);
+
+  // Returns a chunk of |size_class|. The contents of the chunk are undefined.
+  char* Allocate(int size_class);
+
+  // Returns |chunk|, previously obtained from Allocate(|size_class|).
+  void Free(char* chunk, int size_class);
+
+  // The memory held in slabs, and the part of it handed out as chunks.
+  int64 reserved_bytes() const { return reserved_bytes_; }
+  int64 allocated_bytes() const { return allocated_bytes_; }
+
+ private:
+  struct Slab;
+  typedef std::map<char*, Slab*> SlabMap;
+
+  // Returns the slab that contains |chunk|.
+  Slab* SlabFor(char* chunk) const;
+
+  void ReleaseSlab(Slab* slab);
+
+  // All slabs, by start address.
+  SlabMap slabs_;
+
+  // The slabs of each class that have free chunks.
+  std::set<Slab*> partial_slabs_[kNumSizeClasses];
+  int num_slabs_[kNumSizeClasses];
+
+  int64 reserved_bytes_;
+  int64 allocated_bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemSlabAllocator);
+};
+
+// A growable byte buffer made of chunks from a MemSlabAllocator. A buffer that
+// fits in kMaxChunkSize uses a single chunk of the smallest class that holds
+// it; a bigger one is a list of kMaxChunkSize chunks, so growing it never
+// moves the bytes already stored.
+class NET_EXPORT_PRIVATE MemSlabBuffer {
+ public:
+  MemSlabBuffer();
+  ~MemSlabBuffer();
+
+  // Changes the capacity of the buffer to at least |size| bytes, preserving
+  // the first min(|size|, capacity()) bytes. Chunks that are no longer needed
+  // go back to |allocator|.
+  void SetCapacity(MemSlabAllocator* allocator, int size);
+
+  // Returns all the chunks to |allocator|.
+  void Clear(MemSlabAllocator* allocator);
+
+  // Copies |len| bytes at |offset| to or from the buffer. The range must be
+  // within capacity().
+  void Read(int offset, char* dest, int len) const;
+  void Write(int offset, const char* src, int len);
+
+  // Zeroes |len| bytes at |offset|.
+  void Zero(int offset, int len);
+
+  int capacity() const { return capacity_; }
+
+ private:
+  // Returns the address of |offset| and sets |available| to the number of
+  // bytes that follow it in the same chunk.
+  char* ChunkAt(int offset, int* available) const;
+
+  std::vector<char*> chunks_;
+  int size_class_;  // The class of |chunks_|.
+  int capacity_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemSlabBuffer);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_MEM_SLAB_ALLOCATOR_H_
@@ -0,0 +1,99 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/mem_slab_allocator.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace disk_cache {
+
+TEST(MemSlabAllocatorTest, SizeClasses) {
+  EXPECT_EQ(0, MemSlabAllocator::SizeClassFor(1));
+  EXPECT_EQ(0, MemSlabAllocator::SizeClassFor(256));
+  EXPECT_EQ(1, MemSlabAllocator::SizeClassFor(257));
+  EXPECT_EQ(2, MemSlabAllocator::SizeClassFor(4096));
+  EXPECT_EQ(3, MemSlabAllocator::SizeClassFor(
+                   MemSlabAllocator::kMaxChunkSize));
+  EXPECT_EQ(MemSlabAllocator::kMaxChunkSize,
+            MemSlabAllocator::ChunkSize(MemSlabAllocator::kNumSizeClasses - 1));
+}
+
+TEST(MemSlabAllocatorTest, ReleasesEmptySlabs) {
+  MemSlabAllocator allocator;
+  const int kChunksPerSlab =
+      MemSlabAllocator::kSlabSize / MemSlabAllocator::ChunkSize(0);
+
+  // Fill three slabs.
+  std::vector<char*> chunks;
+  for (int i = 0; i < 3 * kChunksPerSlab; i++)
+    chunks.push_back(allocator.Allocate(0));
+  EXPECT_EQ(3 * MemSlabAllocator::kSlabSize, allocator.reserved_bytes());
+  EXPECT_EQ(allocator.reserved_bytes(), allocator.allocated_bytes());
+
+  // Chunks are reused before a new slab is created.
+  allocator.Free(chunks[5], 0);
+  char* chunk = allocator.Allocate(0);
+  EXPECT_EQ(chunks[5], chunk);
+  EXPECT_EQ(3 * MemSlabAllocator::kSlabSize, allocator.reserved_bytes());
+
+  // Emptying all but one slab keeps a single spare one.
+  for (size_t i = 0; i < chunks.size(); i++)
+    allocator.Free(chunks[i], 0);
+  EXPECT_EQ(0, allocator.allocated_bytes());
+  EXPECT_EQ(MemSlabAllocator::kSlabSize, allocator.reserved_bytes());
+}
+
+TEST(MemSlabAllocatorTest, BufferGrowsAndShrinks) {
+  MemSlabAllocator allocator;
+  MemSlabBuffer buffer;
+
+  const int kSize = 3 * MemSlabAllocator::kMaxChunkSize + 100;
+  std::vector<char> data(kSize);
+  for (int i = 0; i < kSize; i++)
+    data[i] = static_cast<char>(i * 7);
+
+  // Grow one byte range at a time, through all the size classes.
+  int written = 0;
+  while (written < kSize) {
+    int len = std::min(kSize - written, 1000);
+    buffer.SetCapacity(&allocator, written + len);
+    EXPECT_GE(buffer.capacity(), written + len);
+    buffer.Write(written, &data[written], len);
+    written += len;
+  }
+  EXPECT_EQ(4 * MemSlabAllocator::kMaxChunkSize, buffer.capacity());
+
+  std::vector<char> read(kSize);
+  buffer.Read(0, &read[0], kSize);
+  EXPECT_EQ(0, memcmp(&data[0], &read[0], kSize));
+
+  // Reads across a chunk boundary.
+  buffer.Read(MemSlabAllocator::kMaxChunkSize - 10, &read[0], 20);
+  EXPECT_EQ(0, memcmp(&data[MemSlabAllocator::kMaxChunkSize - 10], &read[0],
+                      20));
+
+  buffer.Zero(10, 20);
+  buffer.Read(0, &read[0], 40);
+  EXPECT_EQ(0, memcmp(&data[0], &read[0], 10));
+  for (int i = 10; i < 30; i++)
+    EXPECT_EQ(0, read[i]);
+
+  // Shrinking back to a small class keeps the first bytes.
+  buffer.SetCapacity(&allocator, 1000);
+  EXPECT_EQ(1024, buffer.capacity());
+  EXPECT_EQ(1024, allocator.allocated_bytes());
+  buffer.Read(30, &read[0], 900);
+  EXPECT_EQ(0, memcmp(&data[30], &read[0], 900));
+
+  buffer.Clear(&allocator);
+  EXPECT_EQ(0, buffer.capacity());
+  EXPECT_EQ(0, allocator.allocated_bytes());
+}
+
+}  // namespace disk_cache
@@ -14,16 +14,20 @@
 #include "base/bind.h"
 #include "base/callback.h"
 #include "base/file_util.h"
+#include "base/format_macros.h"
 #include "base/location.h"
 #include "base/message_loop/message_loop_proxy.h"
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
 #include "base/metrics/sparse_histogram.h"
+#include "base/pickle.h"
 #include "base/single_thread_task_runner.h"
+#include "base/strings/stringprintf.h"
 #include "base/sys_info.h"
 #include "base/task_runner_util.h"
 #include "base/threading/sequenced_worker_pool.h"
 #include "base/time/time.h"
+#include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
 #include "net/disk_cache/backend_impl.h"
 #include "net/disk_cache/simple/simple_entry_format.h"
@@ -32,6 +36,7 @@
 #include "net/disk_cache/simple/simple_index_file.h"
 #include "net/disk_cache/simple/simple_synchronous_entry.h"
 #include "net/disk_cache/simple/simple_util.h"
+#include "net/disk_cache/simple/simple_worker_pool.h"
 
 using base::Closure;
 using base::FilePath;
@@ -48,7 +53,11 @@ namespace {
 // on concurrent IO (as we use one thread per IO request).
 const int kDefaultMaxWorkerThreads = 50;
 
+// Number of threads the IO of the entries is sharded onto.
+const int kDefaultEntryWorkerThreads = 16;
+
 const char kThreadNamePrefix[] = "SimpleCache";
+const char kEntryThreadNamePrefix[] = "SimpleCacheEntry";
 
 // Cache size when all other size heuristics failed.
 const uint64 kDefaultCacheSize = 80 * 1024 * 1024;
@@ -56,9 +65,27 @@ const uint64 kDefaultCacheSize = 80 * 1024 * 1024;
 // Maximum fraction of the cache that one entry can consume.
 const int kMaxFileRatio = 8;
 
-// A global sequenced worker pool to use for launching all tasks.
+// The entries used in the first seconds of a session make its hot set, which
+// the next session prefetches.
+const int kHotSetRecordingSeconds = 30;
+const size_t kMaxHotSetEntries = 500;
+
+// Bounds on the memory used by the prefetched data. Stream 0 holds the HTTP
+// headers, which are seldom over a few kilobytes.
+const int kMaxPrefetchedStream0Size = 16 * 1024;
+const int64 kMaxPrefetchedBytes = 2 * 1024 * 1024;
+
+const char kHotSetFileName[] = "hot-set";
+const uint64 kHotSetMagicNumber = GG_UINT64_C(0x6c0a4e9d3f21b857);
+const uint32 kHotSetVersion = 1;
+
+// A global sequenced worker pool to use for launching the tasks on the index
+// and on sets of entries.
 SequencedWorkerPool* g_sequenced_worker_pool = NULL;
 
+// A global pool running the IO of the entries.
+disk_cache::SimpleWorkerPool* g_entry_worker_pool = NULL;
+
 void MaybeCreateSequencedWorkerPool() {
   if (!g_sequenced_worker_pool) {
     int max_worker_threads = kDefaultMaxWorkerThreads;
@@ -76,6 +103,31 @@ void MaybeCreateSequencedWorkerPool() {
   }
 }
 
+void MaybeCreateEntryWorkerPool() {
+  if (!g_entry_worker_pool) {
+    int entry_worker_threads = kDefaultEntryWorkerThreads;
+
+    const std::string thread_count_field_trial =
+        base::FieldTrialList::FindFullName("SimpleCacheEntryThreads");
+    if (!thread_count_field_trial.empty()) {
+      entry_worker_threads =
+          std::max(1, std::atoi(thread_count_field_trial.c_str()));
+    }
+
+    g_entry_worker_pool = new disk_cache::SimpleWorkerPool(
+        entry_worker_threads, kEntryThreadNamePrefix);
+    g_entry_worker_pool->AddRef();  // Leak it.
+  }
+}
+
+disk_cache::SimpleEntryLayout GetDefaultEntryLayout() {
+  if (base::FieldTrialList::FindFullName("SimpleCacheEntryLayout") ==
+      "SingleFile") {
+    return disk_cache::SIMPLE_ENTRY_LAYOUT_SINGLE_FILE;
+  }
+  return disk_cache::SIMPLE_ENTRY_LAYOUT_FILE_PER_STREAM;
+}
+
 bool g_fd_limit_histogram_has_been_populated = false;
 
 void MaybeHistogramFdLimit() {
@@ -196,6 +248,54 @@ void CallCompletionCallback(const net::CompletionCallback& callback,
   callback.Run(error_code);
 }
 
+// Reads the hot set saved by the previous session, and deletes it so that a
+// crash does not prefetch the same entries over and over again.
+std::vector<uint64> ReadHotSet(const base::FilePath& path) {
+  std::vector<uint64> hot_set;
+  const base::FilePath hot_set_path = path.AppendASCII(kHotSetFileName);
+  std::string contents;
+  if (!file_util::ReadFileToString(hot_set_path, &contents))
+    return hot_set;
+  base::DeleteFile(hot_set_path, false);
+
+  Pickle pickle(contents.data(), contents.size());
+  PickleIterator it(pickle);
+  uint64 magic_number;
+  uint32 version;
+  uint32 entry_count;
+  if (!pickle.ReadUInt64(&it, &magic_number) ||
+      magic_number != kHotSetMagicNumber ||
+      !pickle.ReadUInt32(&it, &version) || version != kHotSetVersion ||
+      !pickle.ReadUInt32(&it, &entry_count) ||
+      entry_count > kMaxHotSetEntries) {
+    return hot_set;
+  }
+  hot_set.resize(entry_count);
+  for (uint32 i = 0; i < entry_count; ++i) {
+    if (!pickle.ReadUInt64(&it, &hot_set[i])) {
+      hot_set.clear();
+      break;
+    }
+  }
+  return hot_set;
+}
+
+void WriteHotSet(const base::FilePath& path,
+                 scoped_ptr<std::vector<uint64> > hot_set) {
+  Pickle pickle;
+  pickle.WriteUInt64(kHotSetMagicNumber);
+  pickle.WriteUInt32(kHotSetVersion);
+  pickle.WriteUInt32(hot_set->size());
+  for (size_t i = 0; i < hot_set->size(); ++i)
+    pickle.WriteUInt64((*hot_set)[i]);
+  const int size = static_cast<int>(pickle.size());
+  if (file_util::WriteFile(path.AppendASCII(kHotSetFileName),
+                           static_cast<const char*>(pickle.data()),
+                           size) != size) {
+    LOG(ERROR) << "Could not write the hot set of the simple cache.";
+  }
+}
+
 void RecordIndexLoad(base::TimeTicks constructed_since, int result) {
   const base::TimeDelta creation_to_index = base::TimeTicks::Now() -
                                             constructed_since;
@@ -209,6 +309,23 @@ void RecordIndexLoad(base::TimeTicks constructed_since, int result) {
 
 namespace disk_cache {
 
+SimpleBackendImpl::DiskStatResult::DiskStatResult()
+    : max_size(0),
+      detected_magic_number_mismatch(false),
+      net_error(net::OK) {
+}
+
+SimpleBackendImpl::DiskStatResult::~DiskStatResult() {
+}
+
+SimpleBackendImpl::PrefetchedStream0::PrefetchedStream0()
+    : data_size(0),
+      crc32(0) {
+}
+
+SimpleBackendImpl::PrefetchedStream0::~PrefetchedStream0() {
+}
+
 SimpleBackendImpl::SimpleBackendImpl(const FilePath& path,
                                      int max_bytes,
                                      net::CacheType type,
@@ -217,11 +334,15 @@ SimpleBackendImpl::SimpleBackendImpl(const FilePath& path,
     : path_(path),
       cache_thread_(cache_thread),
       orig_max_size_(max_bytes),
+      cache_type_(type),
       entry_operations_mode_(
           type == net::DISK_CACHE ?
               SimpleEntryImpl::OPTIMISTIC_OPERATIONS :
               SimpleEntryImpl::NON_OPTIMISTIC_OPERATIONS),
+      entry_layout_(GetDefaultEntryLayout()),
+      prefetched_bytes_(0),
       net_log_(net_log) {
+  stats_.Init(NULL, 0, Addr());
   MaybeHistogramFdLimit();
 }
 
@@ -231,18 +352,30 @@ SimpleBackendImpl::~SimpleBackendImpl() {
 
 int SimpleBackendImpl::Init(const CompletionCallback& completion_callback) {
   MaybeCreateSequencedWorkerPool();
+  MaybeCreateEntryWorkerPool();
 
   worker_pool_ = g_sequenced_worker_pool->GetTaskRunnerWithShutdownBehavior(
       SequencedWorkerPool::CONTINUE_ON_SHUTDOWN);
+  entry_worker_pool_ = g_entry_worker_pool;
 
   index_.reset(
       new SimpleIndex(MessageLoopProxy::current().get(),
                       path_,
                       make_scoped_ptr(new SimpleIndexFile(
                           cache_thread_.get(), worker_pool_.get(), path_))));
+  // Like the blockfile backend, never evict from an application cache: its
+  // entries are owned by the manifests referencing them, and the appcache
+  // storage enforces its own quota.
+  if (cache_type_ == net::APP_CACHE)
+    index_->DisableEviction();
   index_->ExecuteWhenReady(base::Bind(&RecordIndexLoad,
                                       base::TimeTicks::Now()));
 
+  init_time_ = Time::Now();
+  hot_set_timer_.Start(FROM_HERE,
+                       base::TimeDelta::FromSeconds(kHotSetRecordingSeconds),
+                       this, &SimpleBackendImpl::RecordHotSet);
+
   PostTaskAndReplyWithResult(
       cache_thread_,
       FROM_HERE,
@@ -266,8 +399,59 @@ void SimpleBackendImpl::OnDeactivated(const SimpleEntryImpl* entry) {
   active_entries_.erase(entry->entry_hash());
 }
 
+scoped_refptr<net::IOBuffer> SimpleBackendImpl::TakePrefetchedStream0(
+    uint64 entry_hash,
+    Time last_modified,
+    int32 data_size,
+    uint32* out_crc32) {
+  PrefetchedStream0Map::iterator it = prefetched_streams_.find(entry_hash);
+  if (it == prefetched_streams_.end())
+    return NULL;
+  scoped_refptr<net::IOBuffer> buffer;
+  if (it->second.last_modified == last_modified &&
+      it->second.data_size == data_size) {
+    buffer = it->second.buffer;
+    *out_crc32 = it->second.crc32;
+    stats_.OnEvent(Stats::PREFETCH_HIT);
+  } else {
+    stats_.OnEvent(Stats::PREFETCH_UNUSED);
+  }
+  prefetched_bytes_ -= it->second.data_size;
+  prefetched_streams_.erase(it);
+  return buffer;
+}
+
+void SimpleBackendImpl::DropPrefetchedStream0(uint64 entry_hash) {
+  pending_prefetches_.erase(entry_hash);
+  PrefetchedStream0Map::iterator it = prefetched_streams_.find(entry_hash);
+  if (it == prefetched_streams_.end())
+    return;
+  stats_.OnEvent(Stats::PREFETCH_UNUSED);
+  prefetched_bytes_ -= it->second.data_size;
+  prefetched_streams_.erase(it);
+}
+
+void SimpleBackendImpl::RecordHotSet() {
+  hot_set_timer_.Stop();
+  if (index_->initialized()) {
+    scoped_ptr<std::vector<uint64> > hot_set(
+        index_->GetEntriesUsedSince(init_time_).release());
+    if (hot_set->size() > kMaxHotSetEntries)
+      hot_set->resize(kMaxHotSetEntries);
+    cache_thread_->PostTask(FROM_HERE, base::Bind(&WriteHotSet, path_,
+                                                  base::Passed(&hot_set)));
+  }
+
+  stats_.SetCounter(Stats::PREFETCH_UNUSED,
+                    stats_.GetCounter(Stats::PREFETCH_UNUSED) +
+                        prefetched_streams_.size());
+  pending_prefetches_.clear();
+  prefetched_streams_.clear();
+  prefetched_bytes_ = 0;
+}
+
 net::CacheType SimpleBackendImpl::GetCacheType() const {
-  return net::DISK_CACHE;
+  return cache_type_;
 }
 
 int32 SimpleBackendImpl::GetEntryCount() const {
@@ -323,6 +507,7 @@ void SimpleBackendImpl::IndexReadyForDoom(Time initial_time,
   // succeed and attempts to open them will fail.
   for (int i = removed_key_hashes->size() - 1; i >= 0; --i) {
     const uint64 entry_hash = (*removed_key_hashes)[i];
+    DropPrefetchedStream0(entry_hash);
     EntryMap::iterator it = active_entries_.find(entry_hash);
     if (it == active_entries_.end())
       continue;
@@ -377,6 +562,15 @@ void SimpleBackendImpl::GetStats(
   item.first = "Cache type";
   item.second = "Simple Cache";
   stats->push_back(item);
+
+  item.first = "Prefetch hit";
+  item.second = base::StringPrintf(
+      "0x%" PRIx64, stats_.GetCounter(Stats::PREFETCH_HIT));
+  stats->push_back(item);
+  item.first = "Prefetch unused";
+  item.second = base::StringPrintf(
+      "0x%" PRIx64, stats_.GetCounter(Stats::PREFETCH_UNUSED));
+  stats->push_back(item);
 }
 
 void SimpleBackendImpl::OnExternalCacheHit(const std::string& key) {
@@ -388,6 +582,9 @@ void SimpleBackendImpl::InitializeIndex(const CompletionCallback& callback,
   if (result.net_error == net::OK) {
     index_->SetMaxSize(result.max_size);
     index_->Initialize(result.cache_dir_mtime);
+    // The prefetch is queued on the worker threads before the entries are
+    // opened, so it completes before their first reads.
+    StartPrefetch(result.hot_set);
   }
   callback.Run(result.net_error);
 }
@@ -416,10 +613,75 @@ SimpleBackendImpl::DiskStatResult SimpleBackendImpl::InitCacheStructureOnDisk(
         result.max_size = disk_cache::PreferedCacheSize(available);
     }
     DCHECK(result.max_size);
+    result.hot_set = ReadHotSet(path);
   }
   return result;
 }
 
+void SimpleBackendImpl::StartPrefetch(const std::vector<uint64>& hot_set) {
+  for (size_t i = 0; i < hot_set.size(); ++i) {
+    const uint64 entry_hash = hot_set[i];
+    if (active_entries_.count(entry_hash) ||
+        !pending_prefetches_.insert(entry_hash).second) {
+      continue;
+    }
+    scoped_ptr<PrefetchedStream0> stream_0(new PrefetchedStream0());
+    Closure task = base::Bind(&SimpleBackendImpl::PrefetchStream0, path_,
+                              entry_hash, stream_0.get());
+    Closure reply = base::Bind(&SimpleBackendImpl::OnStream0Prefetched,
+                               AsWeakPtr(), entry_hash,
+                               base::Passed(&stream_0));
+    entry_worker_pool_->GetTaskRunner(entry_hash)->PostTaskAndReply(
+        FROM_HERE, task, reply);
+  }
+}
+
+// static
+void SimpleBackendImpl::PrefetchStream0(const FilePath& path,
+                                        uint64 entry_hash,
+                                        PrefetchedStream0* out_stream_0) {
+  const SimpleEntryStat entry_stat;
+  SimpleEntryCreationResults results(entry_stat);
+  SimpleSynchronousEntry::OpenEntry(path, entry_hash, true, &results);
+  if (results.result != net::OK)
+    return;
+  SimpleSynchronousEntry* sync_entry = results.sync_entry;
+  const int32 data_size = results.entry_stat.data_size[0];
+  if (data_size > 0 && data_size <= kMaxPrefetchedStream0Size) {
+    scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(data_size));
+    uint32 crc32 = 0;
+    Time last_used;
+    int result = net::ERR_FAILED;
+    sync_entry->ReadData(
+        SimpleSynchronousEntry::EntryOperationData(0, 0, data_size),
+        buffer.get(), &crc32, &last_used, &result);
+    if (result == data_size) {
+      sync_entry->CheckEOFRecord(0, data_size, crc32, &result);
+      if (result == net::OK) {
+        out_stream_0->buffer = buffer;
+        out_stream_0->data_size = data_size;
+        out_stream_0->crc32 = crc32;
+        out_stream_0->last_modified = results.entry_stat.last_modified;
+      }
+    }
+  }
+  sync_entry->Close(results.entry_stat,
+                    make_scoped_ptr(
+                        new std::vector<SimpleSynchronousEntry::CRCRecord>()));
+}
+
+void SimpleBackendImpl::OnStream0Prefetched(
+    uint64 entry_hash,
+    scoped_ptr<PrefetchedStream0> stream_0) {
+  // The entry may have been changed or doomed while it was read.
+  if (!pending_prefetches_.erase(entry_hash) || !stream_0->buffer.get() ||
+      prefetched_bytes_ + stream_0->data_size > kMaxPrefetchedBytes) {
+    return;
+  }
+  prefetched_bytes_ += stream_0->data_size;
+  prefetched_streams_[entry_hash] = *stream_0;
+}
+
 scoped_refptr<SimpleEntryImpl> SimpleBackendImpl::CreateOrFindActiveEntry(
     const std::string& key) {
   const uint64 entry_hash = simple_util::GetEntryHashKey(key);
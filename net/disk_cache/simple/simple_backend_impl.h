@@ -17,15 +17,21 @@
 #include "base/memory/weak_ptr.h"
 #include "base/task_runner.h"
 #include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "net/base/cache_type.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/disk_cache/simple/simple_entry_impl.h"
+#include "net/disk_cache/stats.h"
 
 namespace base {
 class SingleThreadTaskRunner;
 class TaskRunner;
 }
 
+namespace net {
+class IOBuffer;
+}
+
 namespace disk_cache {
 
 // SimpleBackendImpl is a new cache backend that stores entries in individual
@@ -37,6 +43,7 @@ namespace disk_cache {
 
 class SimpleEntryImpl;
 class SimpleIndex;
+class SimpleWorkerPool;
 
 class NET_EXPORT_PRIVATE SimpleBackendImpl : public Backend,
     public base::SupportsWeakPtr<SimpleBackendImpl> {
@@ -52,6 +59,14 @@ class NET_EXPORT_PRIVATE SimpleBackendImpl : public Backend,
 
   base::TaskRunner* worker_pool() { return worker_pool_.get(); }
 
+  // Runs the IO of the entries of this backend.
+  SimpleWorkerPool* entry_worker_pool() { return entry_worker_pool_.get(); }
+
+  // The layout of the files of new entries. It comes from the
+  // SimpleCacheEntryLayout field trial, and can be set by tests.
+  SimpleEntryLayout entry_layout() const { return entry_layout_; }
+  void SetEntryLayout(SimpleEntryLayout layout) { entry_layout_ = layout; }
+
   int Init(const CompletionCallback& completion_callback);
 
   // Sets the maximum size for the total amount of data stored by this instance.
@@ -64,6 +79,28 @@ class NET_EXPORT_PRIVATE SimpleBackendImpl : public Backend,
   // operations to construct a new object.
   void OnDeactivated(const SimpleEntryImpl* entry);
 
+  // The entries used in the first seconds of a session are its hot set. The
+  // next session prefetches their stream 0, which holds the HTTP headers, as
+  // soon as the backend is initialized.
+  //
+  // Returns the prefetched stream 0 of the entry |entry_hash|, which holds
+  // |data_size| bytes and has the checksum |*out_crc32|, if the files of the
+  // entry were last modified at |last_modified|. The data is then dropped, as
+  // it is only served once. Returns NULL if there is no such data.
+  scoped_refptr<net::IOBuffer> TakePrefetchedStream0(
+      uint64 entry_hash,
+      base::Time last_modified,
+      int32 data_size,
+      uint32* out_crc32);
+
+  // Drops the prefetched stream 0 of the entry |entry_hash|, when the entry is
+  // written to, created or doomed.
+  void DropPrefetchedStream0(uint64 entry_hash);
+
+  // Saves the hot set of this session, and drops the prefetched data which
+  // has not been used. Runs when the hot set recording window is over.
+  void RecordHotSet();
+
   // Backend:
   virtual net::CacheType GetCacheType() const OVERRIDE;
   virtual int32 GetEntryCount() const OVERRIDE;
@@ -94,12 +131,30 @@ class NET_EXPORT_PRIVATE SimpleBackendImpl : public Backend,
 
   // Return value of InitCacheStructureOnDisk().
   struct DiskStatResult {
+    DiskStatResult();
+    ~DiskStatResult();
+
     base::Time cache_dir_mtime;
     uint64 max_size;
     bool detected_magic_number_mismatch;
     int net_error;
+
+    // The hot set saved by the previous session.
+    std::vector<uint64> hot_set;
   };
 
+  struct PrefetchedStream0 {
+    PrefetchedStream0();
+    ~PrefetchedStream0();
+
+    scoped_refptr<net::IOBuffer> buffer;
+    int32 data_size;
+    uint32 crc32;
+    base::Time last_modified;
+  };
+
+  typedef base::hash_map<uint64, PrefetchedStream0> PrefetchedStream0Map;
+
   void InitializeIndex(const CompletionCallback& callback,
                        const DiskStatResult& result);
 
@@ -115,6 +170,19 @@ class NET_EXPORT_PRIVATE SimpleBackendImpl : public Backend,
   static DiskStatResult InitCacheStructureOnDisk(const base::FilePath& path,
                                                  uint64 suggested_max_size);
 
+  // Starts prefetching stream 0 of the entries of |hot_set|.
+  void StartPrefetch(const std::vector<uint64>& hot_set);
+
+  // Reads stream 0 of the entry |entry_hash| and checks it against its
+  // checksum. Runs on the worker thread of the entry. Leaves |out_stream_0|
+  // untouched on failure.
+  static void PrefetchStream0(const base::FilePath& path,
+                              uint64 entry_hash,
+                              PrefetchedStream0* out_stream_0);
+
+  void OnStream0Prefetched(uint64 entry_hash,
+                           scoped_ptr<PrefetchedStream0> stream_0);
+
   // Searches |active_entries_| for the entry corresponding to |key|. If found,
   // returns the found entry. Otherwise, creates a new entry and returns that.
   scoped_refptr<SimpleEntryImpl> CreateOrFindActiveEntry(
@@ -166,14 +234,31 @@ class NET_EXPORT_PRIVATE SimpleBackendImpl : public Backend,
   scoped_ptr<SimpleIndex> index_;
   const scoped_refptr<base::SingleThreadTaskRunner> cache_thread_;
   scoped_refptr<base::TaskRunner> worker_pool_;
+  scoped_refptr<SimpleWorkerPool> entry_worker_pool_;
 
   int orig_max_size_;
+  const net::CacheType cache_type_;
   const SimpleEntryImpl::OperationsMode entry_operations_mode_;
+  SimpleEntryLayout entry_layout_;
 
   // TODO(gavinp): Store the entry_hash in SimpleEntryImpl, and index this map
   // by hash. This will save memory, and make IndexReadyForDoom easier.
   EntryMap active_entries_;
 
+  // The hot set of this session is made of the entries used since
+  // |init_time_|, until |hot_set_timer_| fires.
+  base::Time init_time_;
+  base::OneShotTimer<SimpleBackendImpl> hot_set_timer_;
+
+  // The entries of the hot set of the previous session whose stream 0 is
+  // being read, and the ones whose stream 0 is ready, using
+  // |prefetched_bytes_| of memory.
+  base::hash_set<uint64> pending_prefetches_;
+  PrefetchedStream0Map prefetched_streams_;
+  int64 prefetched_bytes_;
+
+  Stats stats_;
+
   net::NetLog* const net_log_;
 };
 
@@ -18,6 +18,7 @@ namespace disk_cache {
 
 const uint64 kSimpleInitialMagicNumber = GG_UINT64_C(0xfcfb6d1ba7725c30);
 const uint64 kSimpleFinalMagicNumber = GG_UINT64_C(0xf4fa6f45970d41d8);
+const uint64 kSimpleTrailerMagicNumber = GG_UINT64_C(0x8b3f5c1e72d4a690);
 
 // A file in the Simple cache consists of a SimpleFileHeader followed
 // by data.
@@ -29,8 +30,28 @@ const uint64 kSimpleFinalMagicNumber = GG_UINT64_C(0xf4fa6f45970d41d8);
 //   - at the end, a SimpleFileEOF record.
 const uint32 kSimpleVersion = 4;
 
+// In the single file layout, the first file of an entry holds both stream 0
+// and stream 1:
+//   - a SimpleFileHeader, with version kSimpleSingleFileVersion.
+//   - the key.
+//   - the data of stream 1.
+//   - a SimpleFileEOF record for stream 1.
+//   - the data of stream 0.
+//   - at the end, a SimpleFileTrailer.
+// Stream 2 has a file of its own, in the format above, only when the trailer
+// says so.
+const uint32 kSimpleSingleFileVersion = 5;
+
+// The number of streams of an entry, which is also the number of files when
+// each stream has its own.
 static const int kSimpleEntryFileCount = 3;
 
+// How new entries lay out their streams in files.
+enum SimpleEntryLayout {
+  SIMPLE_ENTRY_LAYOUT_FILE_PER_STREAM,
+  SIMPLE_ENTRY_LAYOUT_SINGLE_FILE,
+};
+
 struct NET_EXPORT_PRIVATE SimpleFileHeader {
   SimpleFileHeader();
 
@@ -52,6 +73,20 @@ struct SimpleFileEOF {
   uint32 data_crc32;
 };
 
+struct SimpleFileTrailer {
+  enum Flags {
+    FLAG_HAS_STREAM_2_FILE = (1U << 0),
+  };
+
+  SimpleFileTrailer();
+
+  uint64 final_magic_number;
+  uint32 flags;
+  uint32 stream_0_crc32;
+  uint32 stream_0_size;
+  uint32 unused;
+};
+
 }  // namespace disk_cache
 
 #endif  // NET_DISK_CACHE_SIMPLE_SIMPLE_ENTRY_FORMAT_H_
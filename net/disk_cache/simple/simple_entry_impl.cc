@@ -25,6 +25,7 @@
 #include "net/disk_cache/simple/simple_net_log_parameters.h"
 #include "net/disk_cache/simple/simple_synchronous_entry.h"
 #include "net/disk_cache/simple/simple_util.h"
+#include "net/disk_cache/simple/simple_worker_pool.h"
 #include "third_party/zlib/zlib.h"
 
 namespace {
@@ -156,13 +157,17 @@ SimpleEntryImpl::SimpleEntryImpl(const FilePath& path,
                                  SimpleBackendImpl* backend,
                                  net::NetLog* net_log)
     : backend_(backend->AsWeakPtr()),
-      worker_pool_(backend->worker_pool()),
+      worker_pool_(backend->entry_worker_pool()->GetTaskRunner(entry_hash)),
+      high_priority_worker_pool_(
+          backend->entry_worker_pool()->GetHighPriorityTaskRunner(entry_hash)),
       path_(path),
       entry_hash_(entry_hash),
+      entry_layout_(backend->entry_layout()),
       use_optimistic_operations_(operations_mode == OPTIMISTIC_OPERATIONS),
       last_used_(Time::Now()),
       last_modified_(last_used_),
       open_count_(0),
+      priority_(net::DEFAULT_PRIORITY),
       state_(STATE_UNINITIALIZED),
       synchronous_entry_(NULL),
       net_log_(net::BoundNetLog::Make(
@@ -247,6 +252,7 @@ int SimpleEntryImpl::CreateEntry(Entry** out_entry,
   // way we never leak files. CreationOperationComplete will remove the entry
   // from the index if the creation fails.
   backend_->index()->Insert(key_);
+  backend_->DropPrefetchedStream0(entry_hash_);
 
   RunNextOperationIfNeeded();
   return ret_value;
@@ -499,6 +505,11 @@ int SimpleEntryImpl::ReadyForSparseIO(const CompletionCallback& callback) {
   return net::ERR_NOT_IMPLEMENTED;
 }
 
+void SimpleEntryImpl::SetPriority(net::RequestPriority priority) {
+  DCHECK(io_thread_checker_.CalledOnValidThread());
+  priority_ = priority;
+}
+
 SimpleEntryImpl::~SimpleEntryImpl() {
   DCHECK(io_thread_checker_.CalledOnValidThread());
   DCHECK_EQ(0U, pending_operations_.size());
@@ -537,6 +548,7 @@ void SimpleEntryImpl::MarkAsDoomed() {
   if (!backend_.get())
     return;
   backend_->index()->Remove(key_);
+  backend_->DropPrefetchedStream0(entry_hash_);
   RemoveSelfFromBackend();
 }
 
@@ -678,6 +690,7 @@ void SimpleEntryImpl::CreateEntryInternal(bool have_index,
                             path_,
                             key_,
                             entry_hash_,
+                            entry_layout_,
                             have_index,
                             results.get());
   Closure reply = base::Bind(&SimpleEntryImpl::CreationOperationComplete,
@@ -778,6 +791,35 @@ void SimpleEntryImpl::ReadDataInternal(int stream_index,
 
   buf_len = std::min(buf_len, GetDataSize(stream_index) - offset);
 
+  // Stream 0 of the entries used early in the previous session may have been
+  // prefetched, and already checked against its checksum.
+  if (stream_index == 0 && offset == 0 && buf_len == GetDataSize(0) &&
+      backend_.get()) {
+    uint32 prefetched_crc32 = 0;
+    scoped_refptr<net::IOBuffer> prefetched_buf =
+        backend_->TakePrefetchedStream0(entry_hash_, last_modified_, buf_len,
+                                        &prefetched_crc32);
+    if (prefetched_buf.get()) {
+      memcpy(buf->data(), prefetched_buf->data(), buf_len);
+      backend_->index()->UseIfExists(key_);
+      last_used_ = Time::Now();
+      crc32s_[0] = prefetched_crc32;
+      crc32s_end_offset_[0] = buf_len;
+      crc_check_state_[0] = CRC_CHECK_DONE;
+      RecordReadResult(READ_RESULT_SUCCESS);
+      if (net_log_.IsLoggingAllEvents()) {
+        net_log_.AddEvent(
+            net::NetLog::TYPE_SIMPLE_CACHE_ENTRY_READ_END,
+            CreateNetLogReadWriteCompleteCallback(buf_len));
+      }
+      if (!callback.is_null()) {
+        MessageLoopProxy::current()->PostTask(FROM_HERE, base::Bind(
+            callback, buf_len));
+      }
+      return;
+    }
+  }
+
   state_ = STATE_IO_PENDING;
   if (backend_.get())
     backend_->index()->UseIfExists(key_);
@@ -801,7 +843,11 @@ void SimpleEntryImpl::ReadDataInternal(int stream_index,
                              base::Passed(&read_crc32),
                              base::Passed(&last_used),
                              base::Passed(&result));
-  worker_pool_->PostTaskAndReply(FROM_HERE, task, reply);
+  // The reads of the most urgent requests go ahead of the IO of the other
+  // entries waiting on the same worker thread.
+  base::TaskRunner* worker_pool = priority_ == net::HIGHEST ?
+      high_priority_worker_pool_.get() : worker_pool_.get();
+  worker_pool->PostTaskAndReply(FROM_HERE, task, reply);
 }
 
 void SimpleEntryImpl::WriteDataInternal(int stream_index,
@@ -839,8 +885,11 @@ void SimpleEntryImpl::WriteDataInternal(int stream_index,
 
   DCHECK_EQ(STATE_READY, state_);
   state_ = STATE_IO_PENDING;
-  if (backend_.get())
+  if (backend_.get()) {
     backend_->index()->UseIfExists(key_);
+    if (stream_index == 0)
+      backend_->DropPrefetchedStream0(entry_hash_);
+  }
   // It is easy to incrementally compute the CRC from [0 .. |offset + buf_len|)
   // if |offset == 0| or we have already computed the CRC for [0 .. offset).
   // We rely on most write operations being sequential, start to end to compute
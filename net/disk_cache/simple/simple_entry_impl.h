@@ -98,6 +98,7 @@ class SimpleEntryImpl : public Entry, public base::RefCounted<SimpleEntryImpl>,
   virtual bool CouldBeSparse() const OVERRIDE;
   virtual void CancelSparseIO() OVERRIDE;
   virtual int ReadyForSparseIO(const CompletionCallback& callback) OVERRIDE;
+  virtual void SetPriority(net::RequestPriority priority) OVERRIDE;
 
  private:
   class ScopedOperationRunner;
@@ -240,8 +241,10 @@ class SimpleEntryImpl : public Entry, public base::RefCounted<SimpleEntryImpl>,
 
   base::WeakPtr<SimpleBackendImpl> backend_;
   const scoped_refptr<base::TaskRunner> worker_pool_;
+  const scoped_refptr<base::TaskRunner> high_priority_worker_pool_;
   const base::FilePath path_;
   const uint64 entry_hash_;
+  const SimpleEntryLayout entry_layout_;
   const bool use_optimistic_operations_;
   std::string key_;
 
@@ -257,6 +260,9 @@ class SimpleEntryImpl : public Entry, public base::RefCounted<SimpleEntryImpl>,
   // notify the backend when this entry not used by any callers.
   int open_count_;
 
+  // The priority of the request the reads are made for, see SetPriority().
+  net::RequestPriority priority_;
+
   State state_;
 
   // When possible, we compute a crc32, for the data in each entry as we read or
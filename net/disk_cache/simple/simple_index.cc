@@ -106,6 +106,7 @@ SimpleIndex::SimpleIndex(base::SingleThreadTaskRunner* io_thread,
       max_size_(0),
       high_watermark_(0),
       low_watermark_(0),
+      eviction_enabled_(true),
       eviction_in_progress_(false),
       initialized_(false),
       cache_directory_(cache_directory),
@@ -194,6 +195,11 @@ scoped_ptr<SimpleIndex::HashList> SimpleIndex::GetAllHashes() {
   return ExtractEntriesBetween(null_time, null_time, false);
 }
 
+scoped_ptr<SimpleIndex::HashList> SimpleIndex::GetEntriesUsedSince(
+    const base::Time initial_time) {
+  return ExtractEntriesBetween(initial_time, base::Time(), false);
+}
+
 int32 SimpleIndex::GetEntryCount() const {
   // TODO(pasko): return a meaningful initial estimate before initialized.
   return entries_set_.size();
@@ -207,6 +213,7 @@ void SimpleIndex::Insert(const std::string& key) {
   const uint64 hash_key = simple_util::GetEntryHashKey(key);
   InsertInEntrySet(
       hash_key, EntryMetadata(base::Time::Now(), 0), &entries_set_);
+  changed_entries_.insert(hash_key);
   if (!initialized_)
     removed_entries_.erase(hash_key);
   PostponeWritingToDisk();
@@ -220,6 +227,7 @@ void SimpleIndex::Remove(const std::string& key) {
     UpdateEntryIteratorSize(&it, 0);
     entries_set_.erase(it);
   }
+  changed_entries_.insert(hash_key);
 
   if (!initialized_)
     removed_entries_.insert(hash_key);
@@ -241,14 +249,17 @@ bool SimpleIndex::UseIfExists(const std::string& key) {
     // If not initialized, always return true, forcing it to go to the disk.
     return !initialized_;
   it->second.SetLastUsedTime(base::Time::Now());
+  changed_entries_.insert(it->first);
   PostponeWritingToDisk();
   return true;
 }
 
 void SimpleIndex::StartEvictionIfNeeded() {
   DCHECK(io_thread_checker_.CalledOnValidThread());
-  if (eviction_in_progress_ || cache_size_ <= high_watermark_)
+  if (!eviction_enabled_ || eviction_in_progress_ ||
+      cache_size_ <= high_watermark_) {
     return;
+  }
 
   // Take all live key hashes from the index and sort them by time.
   eviction_in_progress_ = true;
@@ -274,6 +285,7 @@ void SimpleIndex::StartEvictionIfNeeded() {
     DCHECK(found_meta != entries_set_.end());
     uint64 to_evict_size = found_meta->second.GetEntrySize();
     evicted_so_far_size += to_evict_size;
+    changed_entries_.insert(found_meta->first);
     entries_set_.erase(found_meta);
     ++it;
   }
@@ -299,6 +311,7 @@ bool SimpleIndex::UpdateEntrySize(const std::string& key, uint64 entry_size) {
     return false;
 
   UpdateEntryIteratorSize(&it, entry_size);
+  changed_entries_.insert(it->first);
   PostponeWritingToDisk();
   StartEvictionIfNeeded();
   return true;
@@ -429,8 +442,9 @@ void SimpleIndex::WriteToDisk() {
   }
   last_write_to_disk_ = start;
 
-  index_file_->WriteToDisk(entries_set_, cache_size_,
+  index_file_->WriteToDisk(entries_set_, changed_entries_, cache_size_,
                            start, app_on_background_);
+  changed_entries_.clear();
 }
 
 scoped_ptr<SimpleIndex::HashList> SimpleIndex::ExtractEntriesBetween(
@@ -449,6 +463,7 @@ scoped_ptr<SimpleIndex::HashList> SimpleIndex::ExtractEntriesBetween(
       ret_hashes->push_back(it->first);
       if (delete_entries) {
         cache_size_ -= metadata.GetEntrySize();
+        changed_entries_.insert(it->first);
         entries_set_.erase(it++);
         continue;
       }
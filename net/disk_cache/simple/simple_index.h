@@ -83,6 +83,9 @@ class NET_EXPORT_PRIVATE SimpleIndex
   bool SetMaxSize(int max_bytes);
   int max_size() const { return max_size_; }
 
+  // Stops the index from ever evicting entries, whatever their total size.
+  void DisableEviction() { eviction_enabled_ = false; }
+
   void Insert(const std::string& key);
   void Remove(const std::string& key);
 
@@ -119,6 +122,10 @@ class NET_EXPORT_PRIVATE SimpleIndex
   // Returns the list of all entries key hash.
   scoped_ptr<HashList> GetAllHashes();
 
+  // Returns the list of the hashes of the entries last used at or after
+  // |initial_time|.
+  scoped_ptr<HashList> GetEntriesUsedSince(const base::Time initial_time);
+
   // Returns number of indexed entries.
   int32 GetEntryCount() const;
 
@@ -131,6 +138,7 @@ class NET_EXPORT_PRIVATE SimpleIndex
   FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWriteQueued);
   FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWriteExecuted);
   FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWritePostponed);
+  FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWriteChangedEntries);
 
   void StartEvictionIfNeeded();
   void EvictionDone(int result);
@@ -158,12 +166,17 @@ class NET_EXPORT_PRIVATE SimpleIndex
   uint64 max_size_;
   uint64 high_watermark_;
   uint64 low_watermark_;
+  bool eviction_enabled_;
   bool eviction_in_progress_;
   base::TimeTicks eviction_start_time_;
 
   // This stores all the hash_key of entries that are removed during
   // initialization.
   base::hash_set<uint64> removed_entries_;
+
+  // The hash_key of the entries inserted, updated or removed since the index
+  // was last written to disk, whose records the next write has to update.
+  base::hash_set<uint64> changed_entries_;
   bool initialized_;
 
   const base::FilePath& cache_directory_;
@@ -4,6 +4,10 @@
 
 #include "net/disk_cache/simple/simple_index_file.h"
 
+#include <stddef.h>
+#include <string.h>
+
+#include <map>
 #include <vector>
 
 #include "base/file_util.h"
@@ -12,6 +16,7 @@
 #include "base/logging.h"
 #include "base/metrics/histogram.h"
 #include "base/pickle.h"
+#include "base/platform_file.h"
 #include "base/single_thread_task_runner.h"
 #include "base/task_runner_util.h"
 #include "base/threading/thread_restrictions.h"
@@ -32,37 +37,195 @@ const uint64 kMaxEntiresInIndex = 100000000;
 const char kIndexFileName[] = "the-real-index";
 const char kTempIndexFileName[] = "temp-index";
 
+typedef SimpleIndexFile::TableHeader TableHeader;
+typedef SimpleIndexFile::TableSlot TableSlot;
+
+COMPILE_ASSERT(sizeof(TableHeader) == 48, table_header_has_no_padding);
+COMPILE_ASSERT(sizeof(TableSlot) == 32, table_slot_has_no_padding);
+
+uint32 CalculateCRC(const void* data, size_t length) {
+  return crc32(crc32(0, Z_NULL, 0), reinterpret_cast<const Bytef*>(data),
+               length);
+}
+
 uint32 CalculatePickleCRC(const Pickle& pickle) {
-  return crc32(crc32(0, Z_NULL, 0),
-               reinterpret_cast<const Bytef*>(pickle.payload()),
-               pickle.payload_size());
+  return CalculateCRC(pickle.payload(), pickle.payload_size());
+}
+
+TableHeader MakeTableHeader(uint32 number_of_slots,
+                            uint64 number_of_entries,
+                            uint64 number_of_removed_slots,
+                            uint64 cache_size) {
+  TableHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic_number = kSimpleIndexTableMagicNumber;
+  header.version = kSimpleVersion;
+  header.number_of_slots = number_of_slots;
+  header.number_of_entries = number_of_entries;
+  header.number_of_removed_slots = number_of_removed_slots;
+  header.cache_size = cache_size;
+  header.crc = CalculateCRC(&header, offsetof(TableHeader, crc));
+  return header;
+}
+
+// Returns whether |header| is valid for an index file of |file_length| bytes.
+bool CheckTableHeader(const TableHeader& header, size_t file_length) {
+  const uint64 number_of_slots = header.number_of_slots;
+  return header.magic_number == kSimpleIndexTableMagicNumber &&
+      header.version == kSimpleVersion &&
+      header.crc == CalculateCRC(&header, offsetof(TableHeader, crc)) &&
+      number_of_slots >= SimpleIndexFile::kMinTableSlots &&
+      (number_of_slots & (number_of_slots - 1)) == 0 &&
+      header.number_of_entries <= kMaxEntiresInIndex &&
+      header.number_of_removed_slots <= number_of_slots &&
+      header.number_of_entries + header.number_of_removed_slots <=
+          number_of_slots &&
+      file_length == sizeof(TableHeader) + number_of_slots * sizeof(TableSlot);
+}
+
+TableSlot MakeTableSlot(uint64 hash_key,
+                        TableSlot::State state,
+                        const EntryMetadata& entry_metadata) {
+  TableSlot slot;
+  memset(&slot, 0, sizeof(slot));
+  slot.hash_key = hash_key;
+  slot.last_used_time = entry_metadata.GetLastUsedTime().ToInternalValue();
+  slot.entry_size = entry_metadata.GetEntrySize();
+  slot.state = state;
+  slot.crc = CalculateCRC(&slot, offsetof(TableSlot, crc));
+  return slot;
+}
+
+bool IsTableSlotValid(const TableSlot& slot) {
+  if (slot.state == TableSlot::STATE_EMPTY) {
+    return slot.hash_key == 0 && slot.last_used_time == 0 &&
+        slot.entry_size == 0 && slot.crc == 0;
+  }
+  return (slot.state == TableSlot::STATE_USED ||
+          slot.state == TableSlot::STATE_REMOVED) &&
+      slot.crc == CalculateCRC(&slot, offsetof(TableSlot, crc));
+}
+
+EntryMetadata GetTableSlotEntryMetadata(const TableSlot& slot) {
+  return EntryMetadata(base::Time::FromInternalValue(slot.last_used_time),
+                       slot.entry_size);
+}
+
+// Returns the number of slots of a new table holding |number_of_entries|.
+uint32 GetTableSlotCount(uint64 number_of_entries) {
+  uint32 number_of_slots = SimpleIndexFile::kMinTableSlots;
+  while (number_of_slots < 2 * number_of_entries)
+    number_of_slots *= 2;
+  return number_of_slots;
+}
+
+bool IsTableTooFull(uint64 number_of_taken_slots, uint32 number_of_slots) {
+  return number_of_taken_slots >
+      number_of_slots - number_of_slots / SimpleIndexFile::kMaxTableLoadDivisor;
 }
 
+// Looks up entries in a mapped index table, and keeps track of the slots
+// changed since, which are not written to the file yet.
+class TableProber {
+ public:
+  TableProber(const TableSlot* slots, uint32 number_of_slots)
+      : slots_(slots),
+        mask_(number_of_slots - 1) {
+  }
+
+  // Sets |position| to the slot holding |hash_key| if there is one, or to the
+  // slot where it should be inserted otherwise, and |found| accordingly.
+  // Returns false if a corrupt slot is met on the way.
+  bool FindSlot(uint64 hash_key, uint32* position, bool* found) const {
+    bool found_removed_slot = false;
+    uint32 removed_slot_position = 0;
+    for (uint32 i = 0; i <= mask_; ++i) {
+      const uint32 current = (static_cast<uint32>(hash_key) + i) & mask_;
+      const TableSlot& slot = GetSlot(current);
+      if (!IsTableSlotValid(slot))
+        return false;
+      if (slot.state == TableSlot::STATE_EMPTY) {
+        *position = found_removed_slot ? removed_slot_position : current;
+        *found = false;
+        return true;
+      }
+      if (slot.state == TableSlot::STATE_USED && slot.hash_key == hash_key) {
+        *position = current;
+        *found = true;
+        return true;
+      }
+      if (slot.state == TableSlot::STATE_REMOVED && !found_removed_slot) {
+        found_removed_slot = true;
+        removed_slot_position = current;
+      }
+    }
+    *position = removed_slot_position;
+    *found = false;
+    return found_removed_slot;
+  }
+
+  const TableSlot& GetSlot(uint32 position) const {
+    std::map<uint32, TableSlot>::const_iterator it =
+        changed_slots_.find(position);
+    return it == changed_slots_.end() ? slots_[position] : it->second;
+  }
+
+  void SetSlot(uint32 position, const TableSlot& slot) {
+    changed_slots_[position] = slot;
+  }
+
+  const std::map<uint32, TableSlot>& changed_slots() const {
+    return changed_slots_;
+  }
+
+ private:
+  const TableSlot* const slots_;
+  const uint32 mask_;
+
+  // Ordered by position, so that they are written in file order.
+  std::map<uint32, TableSlot> changed_slots_;
+
+  DISALLOW_COPY_AND_ASSIGN(TableProber);
+};
+
 void DoomEntrySetReply(const net::CompletionCallback& reply_callback,
                        int result) {
   reply_callback.Run(result);
 }
 
-void WriteToDiskInternal(const base::FilePath& index_filename,
-                         const base::FilePath& temp_index_filename,
-                         scoped_ptr<Pickle> pickle,
-                         const base::TimeTicks& start_time,
-                         bool app_on_background) {
-  int bytes_written = file_util::WriteFile(
-      temp_index_filename,
-      reinterpret_cast<const char*>(pickle->data()),
-      pickle->size());
-  DCHECK_EQ(bytes_written, implicit_cast<int>(pickle->size()));
-  if (bytes_written != static_cast<int>(pickle->size())) {
-    // TODO(felipeg): Add better error handling.
+// Writes |data| to |temp_index_filename|, then swaps it with |index_filename|.
+// On failure, the index file is deleted too, since it no longer matches the
+// entries.
+bool WriteIndexFile(const base::FilePath& index_filename,
+                    const base::FilePath& temp_index_filename,
+                    const std::string& data) {
+  int bytes_written = file_util::WriteFile(temp_index_filename, data.data(),
+                                           data.size());
+  if (bytes_written != static_cast<int>(data.size())) {
     LOG(ERROR) << "Could not write Simple Cache index to temporary file: "
                << temp_index_filename.value();
     base::DeleteFile(temp_index_filename, /* recursive = */ false);
-  } else {
-    // Swap temp and index_file.
-    bool result = base::ReplaceFile(temp_index_filename, index_filename, NULL);
-    DCHECK(result);
+    base::DeleteFile(index_filename, /* recursive = */ false);
+    return false;
   }
+  // Swap temp and index_file.
+  if (!base::ReplaceFile(temp_index_filename, index_filename, NULL)) {
+    LOG(ERROR) << "Could not replace Simple Cache index file: "
+               << index_filename.value();
+    base::DeleteFile(temp_index_filename, /* recursive = */ false);
+    base::DeleteFile(index_filename, /* recursive = */ false);
+    return false;
+  }
+  return true;
+}
+
+bool WriteToDiskInternal(const base::FilePath& index_filename,
+                         const base::FilePath& temp_index_filename,
+                         scoped_ptr<std::string> table,
+                         const base::TimeTicks& start_time,
+                         bool app_on_background) {
+  const bool result = WriteIndexFile(index_filename, temp_index_filename,
+                                     *table);
   if (app_on_background) {
     UMA_HISTOGRAM_TIMES("SimpleCache.IndexWriteToDiskTime.Background",
                         (base::TimeTicks::Now() - start_time));
@@ -70,6 +233,7 @@ void WriteToDiskInternal(const base::FilePath& index_filename,
     UMA_HISTOGRAM_TIMES("SimpleCache.IndexWriteToDiskTime.Foreground",
                         (base::TimeTicks::Now() - start_time));
   }
+  return result;
 }
 
 // Called for each cache directory traversal iteration.
@@ -169,6 +333,12 @@ bool SimpleIndexFile::IndexMetadata::CheckIndexMetadata() {
       version_ == disk_cache::kSimpleVersion;
 }
 
+SimpleIndexFile::IndexUpdates::IndexUpdates() : cache_size(0) {
+}
+
+SimpleIndexFile::IndexUpdates::~IndexUpdates() {
+}
+
 SimpleIndexFile::SimpleIndexFile(
     base::SingleThreadTaskRunner* cache_thread,
     base::TaskRunner* worker_pool,
@@ -177,7 +347,9 @@ SimpleIndexFile::SimpleIndexFile(
       worker_pool_(worker_pool),
       cache_directory_(cache_directory),
       index_file_(cache_directory_.AppendASCII(kIndexFileName)),
-      temp_index_file_(cache_directory_.AppendASCII(kTempIndexFileName)) {
+      temp_index_file_(cache_directory_.AppendASCII(kTempIndexFileName)),
+      can_update_in_place_(false),
+      weak_ptr_factory_(this) {
 }
 
 SimpleIndexFile::~SimpleIndexFile() {}
@@ -188,22 +360,54 @@ void SimpleIndexFile::LoadIndexEntries(base::Time cache_last_modified,
   base::Closure task = base::Bind(&SimpleIndexFile::SyncLoadIndexEntries,
                                   cache_last_modified, cache_directory_,
                                   index_file_, out_result);
-  worker_pool_->PostTaskAndReply(FROM_HERE, task, callback);
+  worker_pool_->PostTaskAndReply(
+      FROM_HERE, task,
+      base::Bind(&SimpleIndexFile::OnIndexLoaded,
+                 weak_ptr_factory_.GetWeakPtr(), callback, out_result));
 }
 
 void SimpleIndexFile::WriteToDisk(const SimpleIndex::EntrySet& entry_set,
+                                  const base::hash_set<uint64>& changed_hashes,
                                   uint64 cache_size,
                                   const base::TimeTicks& start,
                                   bool app_on_background) {
-  IndexMetadata index_metadata(entry_set.size(), cache_size);
-  scoped_ptr<Pickle> pickle = Serialize(index_metadata, entry_set);
-  cache_thread_->PostTask(FROM_HERE, base::Bind(
-      &WriteToDiskInternal,
-      index_file_,
-      temp_index_file_,
-      base::Passed(&pickle),
-      base::TimeTicks::Now(),
-      app_on_background));
+  if (!can_update_in_place_) {
+    scoped_ptr<std::string> table = SerializeTable(entry_set, cache_size);
+    // The writes that follow are made in place, on top of this one.
+    can_update_in_place_ = true;
+    PostTaskAndReplyWithResult(
+        cache_thread_,
+        FROM_HERE,
+        base::Bind(&WriteToDiskInternal,
+                   index_file_,
+                   temp_index_file_,
+                   base::Passed(&table),
+                   base::TimeTicks::Now(),
+                   app_on_background),
+        base::Bind(&SimpleIndexFile::OnIndexWritten,
+                   weak_ptr_factory_.GetWeakPtr()));
+    return;
+  }
+
+  scoped_ptr<IndexUpdates> updates(new IndexUpdates());
+  updates->cache_size = cache_size;
+  for (base::hash_set<uint64>::const_iterator it = changed_hashes.begin();
+       it != changed_hashes.end(); ++it) {
+    SimpleIndex::EntrySet::const_iterator entry = entry_set.find(*it);
+    if (entry == entry_set.end())
+      updates->removed_hashes.push_back(*it);
+    else
+      updates->updated_entries.insert(*entry);
+  }
+  PostTaskAndReplyWithResult(
+      cache_thread_,
+      FROM_HERE,
+      base::Bind(&SimpleIndexFile::SyncUpdateIndexFile,
+                 index_file_,
+                 temp_index_file_,
+                 base::Passed(&updates)),
+      base::Bind(&SimpleIndexFile::OnIndexWritten,
+                 weak_ptr_factory_.GetWeakPtr()));
 }
 
 void SimpleIndexFile::DoomEntrySet(
@@ -263,7 +467,9 @@ void SimpleIndexFile::SyncLoadIndexEntries(
                             index_file_state,
                             INDEX_STATE_MAX);
 
+  bool restored_from_disk = false;
   if (!out_result->did_load) {
+    restored_from_disk = true;
     const base::TimeTicks start = base::TimeTicks::Now();
     SyncRestoreFromDisk(cache_directory, index_file_path, out_result);
     UMA_HISTOGRAM_MEDIUM_TIMES("SimpleCache.IndexRestoreTime",
@@ -281,7 +487,7 @@ void SimpleIndexFile::SyncLoadIndexEntries(
   };
   int initialize_method;
   if (index_file_exists) {
-    if (out_result->flush_required)
+    if (restored_from_disk)
       initialize_method = INITIALIZE_METHOD_RECOVERED;
     else
       initialize_method = INITIALIZE_METHOD_LOADED;
@@ -307,14 +513,246 @@ void SimpleIndexFile::SyncLoadFromDisk(const base::FilePath& index_filename,
     return;
   }
 
-  SimpleIndexFile::Deserialize(
-      reinterpret_cast<const char*>(index_file_map.data()),
-      index_file_map.length(), out_result);
+  const char* data = reinterpret_cast<const char*>(index_file_map.data());
+  const size_t data_len = index_file_map.length();
+  if (data_len >= sizeof(TableHeader) &&
+      reinterpret_cast<const TableHeader*>(data)->magic_number ==
+          kSimpleIndexTableMagicNumber) {
+    SimpleIndexFile::DeserializeTable(data, data_len, out_result);
+  } else {
+    SimpleIndexFile::Deserialize(data, static_cast<int>(data_len), out_result);
+    // Replace the index with a table right away, so that the next writes can
+    // be made in place.
+    out_result->flush_required = out_result->did_load;
+  }
 
   if (!out_result->did_load)
     base::DeleteFile(index_filename, false);
 }
 
+// static
+bool SimpleIndexFile::SyncUpdateIndexFile(
+    const base::FilePath& index_filename,
+    const base::FilePath& temp_index_filename,
+    scoped_ptr<IndexUpdates> updates) {
+  TableHeader header;
+  scoped_ptr<TableProber> prober;
+  SimpleIndexLoadResult rebuilt_index;
+  bool needs_rebuild = false;
+  {
+    base::MemoryMappedFile index_file_map;
+    if (!index_file_map.Initialize(index_filename)) {
+      LOG(WARNING) << "Could not map Simple Index file.";
+      base::DeleteFile(index_filename, false);
+      return false;
+    }
+    const char* data = reinterpret_cast<const char*>(index_file_map.data());
+    const size_t data_len = index_file_map.length();
+    if (data_len < sizeof(TableHeader)) {
+      LOG(WARNING) << "Corrupt Simple Index File.";
+      base::DeleteFile(index_filename, false);
+      return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (!CheckTableHeader(header, data_len)) {
+      LOG(WARNING) << "Invalid header in Simple Index file.";
+      base::DeleteFile(index_filename, false);
+      return false;
+    }
+
+    // Only the slots probed for the changed entries are read, and validated.
+    prober.reset(new TableProber(
+        reinterpret_cast<const TableSlot*>(data + sizeof(TableHeader)),
+        header.number_of_slots));
+    bool has_corrupt_slot = false;
+    for (std::vector<uint64>::const_iterator it =
+             updates->removed_hashes.begin();
+         it != updates->removed_hashes.end(); ++it) {
+      uint32 position;
+      bool found;
+      if (!prober->FindSlot(*it, &position, &found)) {
+        has_corrupt_slot = true;
+        break;
+      }
+      if (!found)
+        continue;
+      prober->SetSlot(position, MakeTableSlot(*it, TableSlot::STATE_REMOVED,
+                                              EntryMetadata()));
+      --header.number_of_entries;
+      ++header.number_of_removed_slots;
+    }
+    for (SimpleIndex::EntrySet::const_iterator it =
+             updates->updated_entries.begin();
+         !has_corrupt_slot && it != updates->updated_entries.end(); ++it) {
+      uint32 position;
+      bool found;
+      if (!prober->FindSlot(it->first, &position, &found)) {
+        has_corrupt_slot = true;
+        break;
+      }
+      if (!found) {
+        if (prober->GetSlot(position).state == TableSlot::STATE_REMOVED)
+          --header.number_of_removed_slots;
+        ++header.number_of_entries;
+        if (IsTableTooFull(
+                header.number_of_entries + header.number_of_removed_slots,
+                header.number_of_slots)) {
+          needs_rebuild = true;
+          break;
+        }
+      }
+      prober->SetSlot(position, MakeTableSlot(it->first,
+                                              TableSlot::STATE_USED,
+                                              it->second));
+    }
+    if (has_corrupt_slot) {
+      LOG(WARNING) << "Invalid record in Simple Index file.";
+      base::DeleteFile(index_filename, false);
+      return false;
+    }
+
+    if (needs_rebuild) {
+      DeserializeTable(data, data_len, &rebuilt_index);
+      if (!rebuilt_index.did_load) {
+        base::DeleteFile(index_filename, false);
+        return false;
+      }
+    }
+    // |index_file_map| must be closed before the file is replaced or written.
+  }
+
+  if (needs_rebuild) {
+    SimpleIndex::EntrySet* entries = &rebuilt_index.entries;
+    for (std::vector<uint64>::const_iterator it =
+             updates->removed_hashes.begin();
+         it != updates->removed_hashes.end(); ++it) {
+      entries->erase(*it);
+    }
+    for (SimpleIndex::EntrySet::const_iterator it =
+             updates->updated_entries.begin();
+         it != updates->updated_entries.end(); ++it) {
+      (*entries)[it->first] = it->second;
+    }
+    scoped_ptr<std::string> table = SerializeTable(*entries,
+                                                   updates->cache_size);
+    return WriteIndexFile(index_filename, temp_index_filename, *table);
+  }
+
+  base::PlatformFile index_file = base::CreatePlatformFile(
+      index_filename, base::PLATFORM_FILE_OPEN | base::PLATFORM_FILE_WRITE,
+      NULL, NULL);
+  if (index_file == base::kInvalidPlatformFileValue) {
+    LOG(WARNING) << "Could not open Simple Index file.";
+    base::DeleteFile(index_filename, false);
+    return false;
+  }
+  // The header goes last, so that an interrupted update leaves counts that do
+  // not match the records, and the index is restored from the entries.
+  bool succeeded = true;
+  const std::map<uint32, TableSlot>& changed_slots = prober->changed_slots();
+  for (std::map<uint32, TableSlot>::const_iterator it = changed_slots.begin();
+       succeeded && it != changed_slots.end(); ++it) {
+    const int64 offset =
+        sizeof(TableHeader) + static_cast<int64>(it->first) * sizeof(TableSlot);
+    succeeded = base::WritePlatformFile(
+        index_file, offset, reinterpret_cast<const char*>(&it->second),
+        sizeof(TableSlot)) == static_cast<int>(sizeof(TableSlot));
+  }
+  if (succeeded) {
+    header = MakeTableHeader(header.number_of_slots,
+                             header.number_of_entries,
+                             header.number_of_removed_slots,
+                             updates->cache_size);
+    succeeded = base::WritePlatformFile(
+        index_file, 0, reinterpret_cast<const char*>(&header),
+        sizeof(header)) == static_cast<int>(sizeof(header));
+  }
+  base::ClosePlatformFile(index_file);
+  if (!succeeded) {
+    LOG(ERROR) << "Could not update Simple Cache index file: "
+               << index_filename.value();
+    base::DeleteFile(index_filename, false);
+    return false;
+  }
+  return true;
+}
+
+// static
+scoped_ptr<std::string> SimpleIndexFile::SerializeTable(
+    const SimpleIndex::EntrySet& entries,
+    uint64 cache_size) {
+  const uint32 number_of_slots = GetTableSlotCount(entries.size());
+  scoped_ptr<std::string> table(new std::string(
+      sizeof(TableHeader) + number_of_slots * sizeof(TableSlot), '\0'));
+  const TableHeader header =
+      MakeTableHeader(number_of_slots, entries.size(), 0, cache_size);
+  memcpy(&(*table)[0], &header, sizeof(header));
+
+  TableSlot* slots = reinterpret_cast<TableSlot*>(
+      &(*table)[sizeof(TableHeader)]);
+  const uint32 mask = number_of_slots - 1;
+  for (SimpleIndex::EntrySet::const_iterator it = entries.begin();
+       it != entries.end(); ++it) {
+    uint32 position = static_cast<uint32>(it->first) & mask;
+    while (slots[position].state != TableSlot::STATE_EMPTY)
+      position = (position + 1) & mask;
+    slots[position] = MakeTableSlot(it->first, TableSlot::STATE_USED,
+                                    it->second);
+  }
+  return table.Pass();
+}
+
+// static
+void SimpleIndexFile::DeserializeTable(const char* data, size_t data_len,
+                                       SimpleIndexLoadResult* out_result) {
+  DCHECK(data);
+
+  out_result->Reset();
+  SimpleIndex::EntrySet* entries = &out_result->entries;
+
+  if (data_len < sizeof(TableHeader)) {
+    LOG(WARNING) << "Corrupt Simple Index File.";
+    return;
+  }
+  TableHeader header;
+  memcpy(&header, data, sizeof(header));
+  if (!CheckTableHeader(header, data_len)) {
+    LOG(WARNING) << "Invalid header in Simple Index file.";
+    return;
+  }
+
+#if !defined(OS_WIN)
+  entries->resize(header.number_of_entries + kExtraSizeForMerge);
+#endif
+  const TableSlot* slots =
+      reinterpret_cast<const TableSlot*>(data + sizeof(TableHeader));
+  uint64 number_of_removed_slots = 0;
+  for (uint32 i = 0; i < header.number_of_slots; ++i) {
+    const TableSlot& slot = slots[i];
+    if (!IsTableSlotValid(slot)) {
+      LOG(WARNING) << "Invalid record in Simple Index file.";
+      entries->clear();
+      return;
+    }
+    if (slot.state == TableSlot::STATE_USED) {
+      SimpleIndex::InsertInEntrySet(
+          slot.hash_key, GetTableSlotEntryMetadata(slot), entries);
+    } else if (slot.state == TableSlot::STATE_REMOVED) {
+      ++number_of_removed_slots;
+    }
+  }
+
+  // Catches both duplicated records and updates that did not complete.
+  if (entries->size() != header.number_of_entries ||
+      number_of_removed_slots != header.number_of_removed_slots) {
+    LOG(WARNING) << "Inconsistent Simple Index file.";
+    entries->clear();
+    return;
+  }
+
+  out_result->did_load = true;
+}
+
 // static
 scoped_ptr<Pickle> SimpleIndexFile::Serialize(
     const SimpleIndexFile::IndexMetadata& index_metadata,
@@ -415,6 +853,17 @@ void SimpleIndexFile::SyncRestoreFromDisk(
   out_result->flush_required = true;
 }
 
+void SimpleIndexFile::OnIndexLoaded(const base::Closure& callback,
+                                    SimpleIndexLoadResult* load_result) {
+  can_update_in_place_ = load_result->did_load && !load_result->flush_required;
+  callback.Run();
+}
+
+void SimpleIndexFile::OnIndexWritten(bool succeeded) {
+  if (!succeeded)
+    can_update_in_place_ = false;
+}
+
 // static
 bool SimpleIndexFile::IsIndexFileStale(base::Time cache_last_modified,
                                        const base::FilePath& index_file_path) {
@@ -14,6 +14,7 @@
 #include "base/gtest_prod_util.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
 #include "base/pickle.h"
 #include "base/port.h"
 #include "net/base/net_export.h"
@@ -27,6 +28,7 @@ class TaskRunner;
 namespace disk_cache {
 
 const uint64 kSimpleIndexMagicNumber = GG_UINT64_C(0x656e74657220796f);
+const uint64 kSimpleIndexTableMagicNumber = GG_UINT64_C(0x7461626c65206978);
 
 struct NET_EXPORT_PRIVATE SimpleIndexLoadResult {
   SimpleIndexLoadResult();
@@ -38,12 +40,19 @@ struct NET_EXPORT_PRIVATE SimpleIndexLoadResult {
   bool flush_required;
 };
 
-// Simple Index File format is a pickle serialized data of IndexMetadata and
-// EntryMetadata objects.  The file format is as follows: one instance of
-// serialized |IndexMetadata| followed serialized |EntryMetadata| entries
-// repeated |number_of_entries| amount of times.  To know more about the format,
-// see SimpleIndexFile::Serialize() and SeeSimpleIndexFile::LoadFromDisk()
-// methods.
+// The Simple Index File is a table of fixed size records, so that single
+// entries can be updated in place.  The file is a |TableHeader| followed by
+// |TableHeader::number_of_slots| |TableSlot| records, which form an open
+// addressing hash table keyed by entry hash, with linear probing.  Removed
+// entries leave a tombstone behind so that probe sequences stay intact; the
+// table is rewritten when too many of its slots are taken.  The header and
+// each record carry their own CRC, so a record is only validated when it is
+// read.  To know more about the format, see SimpleIndexFile::SerializeTable()
+// and SimpleIndexFile::DeserializeTable().
+//
+// Older caches have an index that is a pickle of |IndexMetadata| followed by
+// as many |EntryMetadata| as there are entries.  It is still read, and is
+// replaced by a table on the first write.
 //
 // The non-static methods must run on the IO thread.  All the real
 // work is done in the static methods, which are run on the cache thread
@@ -73,6 +82,40 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
     uint64 cache_size_;  // Total cache storage size in bytes.
   };
 
+  // The header of the index file.  |crc| covers the fields before it.
+  struct TableHeader {
+    uint64 magic_number;
+    uint32 version;
+    uint32 number_of_slots;  // A power of two.
+    uint64 number_of_entries;
+    uint64 number_of_removed_slots;
+    uint64 cache_size;  // Total cache storage size in bytes.
+    uint32 unused;
+    uint32 crc;
+  };
+
+  // A record of the index file.  |crc| covers the fields before it, except in
+  // empty slots, which are all zeroes.
+  struct TableSlot {
+    enum State {
+      STATE_EMPTY = 0,
+      STATE_USED = 1,
+      STATE_REMOVED = 2,
+    };
+
+    uint64 hash_key;
+    int64 last_used_time;  // As base::Time::ToInternalValue().
+    uint64 entry_size;
+    uint32 state;
+    uint32 crc;
+  };
+
+  // A table is rebuilt when an update would leave fewer than
+  // 1 / kMaxTableLoadDivisor of its slots empty.  A new table has at least
+  // twice as many slots as entries, and at least kMinTableSlots.
+  static const uint32 kMinTableSlots = 256;
+  static const uint32 kMaxTableLoadDivisor = 4;
+
   SimpleIndexFile(base::SingleThreadTaskRunner* cache_thread,
                   base::TaskRunner* worker_pool,
                   const base::FilePath& cache_directory);
@@ -83,8 +126,12 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
                                 const base::Closure& callback,
                                 SimpleIndexLoadResult* out_result);
 
-  // Write the specified set of entries to disk.
+  // Write the specified set of entries to disk.  |changed_hashes| are the
+  // entries that were inserted, updated or removed since the previous call;
+  // when the index file on disk is known to be current otherwise, only their
+  // records are rewritten.
   virtual void WriteToDisk(const SimpleIndex::EntrySet& entry_set,
+                           const base::hash_set<uint64>& changed_hashes,
                            uint64 cache_size,
                            const base::TimeTicks& start,
                            bool app_on_background);
@@ -100,6 +147,17 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
   // Used for cache directory traversal.
   typedef base::Callback<void (const base::FilePath&)> EntryFileCallback;
 
+  // The entries to update and remove in the index file.
+  struct IndexUpdates {
+    IndexUpdates();
+    ~IndexUpdates();
+
+    SimpleIndex::EntrySet updated_entries;
+    std::vector<uint64> removed_hashes;
+    uint64 cache_size;
+  };
+
+
   // When loading the entries from disk, add this many extra hash buckets to
   // prevent reallocation on the IO thread when merging in new live entries.
   static const int kExtraSizeForMerge = 512;
@@ -115,6 +173,25 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
   static void SyncLoadFromDisk(const base::FilePath& index_filename,
                                SimpleIndexLoadResult* out_result);
 
+  // Rewrites the records of the updated and removed entries of |updates| in
+  // the index file, or the whole table when it gets too full.  Returns false,
+  // after deleting the index file, if it is missing or corrupt.
+  static bool SyncUpdateIndexFile(const base::FilePath& index_filename,
+                                  const base::FilePath& temp_index_filename,
+                                  scoped_ptr<IndexUpdates> updates);
+
+  // Returns a newly allocated buffer with the index table holding |entries|,
+  // to be written to a file.
+  static scoped_ptr<std::string> SerializeTable(
+      const SimpleIndex::EntrySet& entries,
+      uint64 cache_size);
+
+  // Given the contents of a table index file |data| of length |data_len|,
+  // returns the corresponding EntrySet.  |out_result->did_load| is false on
+  // error.
+  static void DeserializeTable(const char* data, size_t data_len,
+                               SimpleIndexLoadResult* out_result);
+
   // Returns a scoped_ptr for a newly allocated Pickle containing the serialized
   // data to be written to a file.
   static scoped_ptr<Pickle> Serialize(
@@ -150,12 +227,26 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
     uint32 crc;
   };
 
+  // Called on the IO thread when a load started by LoadIndexEntries() is
+  // done, before |callback|.
+  void OnIndexLoaded(const base::Closure& callback,
+                     SimpleIndexLoadResult* load_result);
+
+  // Called on the IO thread with the result of a write of the index file.
+  void OnIndexWritten(bool succeeded);
+
   const scoped_refptr<base::SingleThreadTaskRunner> cache_thread_;
   const scoped_refptr<base::TaskRunner> worker_pool_;
   const base::FilePath cache_directory_;
   const base::FilePath index_file_;
   const base::FilePath temp_index_file_;
 
+  // True when the index file is a table matching all the entries written so
+  // far, so that the next write can be made in place.
+  bool can_update_in_place_;
+
+  base::WeakPtrFactory<SimpleIndexFile> weak_ptr_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(SimpleIndexFile);
 };
 
@@ -57,8 +57,10 @@ TEST(IndexMetadataTest, Serialize) {
 class WrappedSimpleIndexFile : public SimpleIndexFile {
  public:
   using SimpleIndexFile::Deserialize;
+  using SimpleIndexFile::DeserializeTable;
   using SimpleIndexFile::IsIndexFileStale;
   using SimpleIndexFile::Serialize;
+  using SimpleIndexFile::SerializeTable;
 
   explicit WrappedSimpleIndexFile(const base::FilePath& index_file_directory)
       : SimpleIndexFile(base::MessageLoopProxy::current().get(),
@@ -89,6 +91,20 @@ class SimpleIndexFileTest : public testing::Test {
 
   bool callback_called() { return callback_called_; }
 
+  // Loads the index in |cache_path| as the backend would on startup.
+  void LoadIndex(const base::FilePath& cache_path,
+                 SimpleIndexLoadResult* load_result) {
+    WrappedSimpleIndexFile simple_index_file(cache_path);
+    base::Time fake_cache_mtime;
+    ASSERT_TRUE(simple_util::GetMTime(simple_index_file.GetIndexFilePath(),
+                                      &fake_cache_mtime));
+    callback_called_ = false;
+    simple_index_file.LoadIndexEntries(fake_cache_mtime, GetCallback(),
+                                       load_result);
+    base::RunLoop().RunUntilIdle();
+    ASSERT_TRUE(callback_called());
+  }
+
  private:
   void LoadIndexEntriesCallback() {
     EXPECT_FALSE(callback_called_);
@@ -185,8 +201,8 @@ TEST_F(SimpleIndexFileTest, WriteThenLoadIndex) {
   const uint64 kCacheSize = 456U;
   {
     WrappedSimpleIndexFile simple_index_file(cache_dir.path());
-    simple_index_file.WriteToDisk(entries, kCacheSize,
-                                  base::TimeTicks(), false);
+    simple_index_file.WriteToDisk(entries, base::hash_set<uint64>(),
+                                  kCacheSize, base::TimeTicks(), false);
     base::RunLoop().RunUntilIdle();
     EXPECT_TRUE(base::PathExists(simple_index_file.GetIndexFilePath()));
   }
@@ -211,6 +227,177 @@ TEST_F(SimpleIndexFileTest, WriteThenLoadIndex) {
     EXPECT_EQ(1U, load_index_result.entries.count(kHashes[i]));
 }
 
+TEST_F(SimpleIndexFileTest, SerializeTable) {
+  SimpleIndex::EntrySet entries;
+  for (uint64 hash = 0; hash < 1000; ++hash) {
+    // Hashes colliding on the low bits share a probe sequence.
+    const uint64 hash_key = hash * SimpleIndexFile::kMinTableSlots;
+    SimpleIndex::InsertInEntrySet(
+        hash_key, EntryMetadata(Time::FromInternalValue(hash), hash),
+        &entries);
+  }
+
+  scoped_ptr<std::string> table =
+      WrappedSimpleIndexFile::SerializeTable(entries, 1234);
+  ASSERT_TRUE(table.get());
+  SimpleIndexLoadResult deserialize_result;
+  WrappedSimpleIndexFile::DeserializeTable(table->data(), table->size(),
+                                           &deserialize_result);
+  EXPECT_TRUE(deserialize_result.did_load);
+  const SimpleIndex::EntrySet& new_entries = deserialize_result.entries;
+  EXPECT_EQ(entries.size(), new_entries.size());
+  for (SimpleIndex::EntrySet::const_iterator it = entries.begin();
+       it != entries.end(); ++it) {
+    SimpleIndex::EntrySet::const_iterator new_it = new_entries.find(it->first);
+    ASSERT_TRUE(new_entries.end() != new_it);
+    EXPECT_TRUE(CompareTwoEntryMetadata(it->second, new_it->second));
+  }
+
+  // Any changed byte is caught, whether in the header or in a record.
+  for (size_t offset = 0; offset < table->size(); offset += 4093) {
+    std::string corrupt_table(*table);
+    corrupt_table[offset] ^= 0x10;
+    WrappedSimpleIndexFile::DeserializeTable(corrupt_table.data(),
+                                             corrupt_table.size(),
+                                             &deserialize_result);
+    EXPECT_FALSE(deserialize_result.did_load) << offset;
+    EXPECT_TRUE(deserialize_result.entries.empty());
+  }
+  WrappedSimpleIndexFile::DeserializeTable(table->data(), table->size() - 1,
+                                           &deserialize_result);
+  EXPECT_FALSE(deserialize_result.did_load);
+}
+
+TEST_F(SimpleIndexFileTest, UpdateIndexInPlace) {
+  base::ScopedTempDir cache_dir;
+  ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
+
+  SimpleIndex::EntrySet entries;
+  for (uint64 hash = 1; hash <= 10; ++hash) {
+    SimpleIndex::InsertInEntrySet(
+        hash, EntryMetadata(Time::FromInternalValue(hash), hash), &entries);
+  }
+  WrappedSimpleIndexFile simple_index_file(cache_dir.path());
+  const base::FilePath& index_path = simple_index_file.GetIndexFilePath();
+  simple_index_file.WriteToDisk(entries, base::hash_set<uint64>(), 55,
+                                base::TimeTicks(), false);
+  base::RunLoop().RunUntilIdle();
+  int64 index_size = 0;
+  ASSERT_TRUE(file_util::GetFileSize(index_path, &index_size));
+
+  // Update one entry, remove one and add one.
+  base::hash_set<uint64> changed_hashes;
+  entries[3] = EntryMetadata(Time::FromInternalValue(300), 30);
+  changed_hashes.insert(3);
+  entries.erase(5);
+  changed_hashes.insert(5);
+  SimpleIndex::InsertInEntrySet(
+      11, EntryMetadata(Time::FromInternalValue(11), 11), &entries);
+  changed_hashes.insert(11);
+  simple_index_file.WriteToDisk(entries, changed_hashes, 88,
+                                base::TimeTicks(), false);
+  base::RunLoop().RunUntilIdle();
+
+  // The file was not rewritten.
+  int64 new_index_size = 0;
+  ASSERT_TRUE(file_util::GetFileSize(index_path, &new_index_size));
+  EXPECT_EQ(index_size, new_index_size);
+  EXPECT_FALSE(base::PathExists(cache_dir.path().AppendASCII("temp-index")));
+
+  SimpleIndexLoadResult load_index_result;
+  LoadIndex(cache_dir.path(), &load_index_result);
+  EXPECT_TRUE(load_index_result.did_load);
+  EXPECT_FALSE(load_index_result.flush_required);
+  const SimpleIndex::EntrySet& loaded_entries = load_index_result.entries;
+  EXPECT_EQ(entries.size(), loaded_entries.size());
+  for (SimpleIndex::EntrySet::const_iterator it = entries.begin();
+       it != entries.end(); ++it) {
+    SimpleIndex::EntrySet::const_iterator loaded_it =
+        loaded_entries.find(it->first);
+    ASSERT_TRUE(loaded_entries.end() != loaded_it);
+    EXPECT_TRUE(CompareTwoEntryMetadata(it->second, loaded_it->second));
+  }
+}
+
+TEST_F(SimpleIndexFileTest, UpdateIndexGrowsTable) {
+  base::ScopedTempDir cache_dir;
+  ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
+
+  SimpleIndex::EntrySet entries;
+  WrappedSimpleIndexFile simple_index_file(cache_dir.path());
+  const base::FilePath& index_path = simple_index_file.GetIndexFilePath();
+  simple_index_file.WriteToDisk(entries, base::hash_set<uint64>(), 0,
+                                base::TimeTicks(), false);
+  base::RunLoop().RunUntilIdle();
+  int64 index_size = 0;
+  ASSERT_TRUE(file_util::GetFileSize(index_path, &index_size));
+
+  // Adding and removing entries in small batches keeps filling the table with
+  // records and tombstones, until it is rebuilt.
+  uint64 next_hash = 1;
+  for (int batch = 0; batch < 100; ++batch) {
+    base::hash_set<uint64> changed_hashes;
+    for (int i = 0; i < 10; ++i, ++next_hash) {
+      SimpleIndex::InsertInEntrySet(
+          next_hash, EntryMetadata(Time::FromInternalValue(next_hash), 1),
+          &entries);
+      changed_hashes.insert(next_hash);
+      if (next_hash % 2) {
+        entries.erase(next_hash / 2);
+        changed_hashes.insert(next_hash / 2);
+      }
+    }
+    simple_index_file.WriteToDisk(entries, changed_hashes, entries.size(),
+                                  base::TimeTicks(), false);
+    base::RunLoop().RunUntilIdle();
+  }
+  int64 new_index_size = 0;
+  ASSERT_TRUE(file_util::GetFileSize(index_path, &new_index_size));
+  EXPECT_LT(index_size, new_index_size);
+
+  SimpleIndexLoadResult load_index_result;
+  LoadIndex(cache_dir.path(), &load_index_result);
+  EXPECT_TRUE(load_index_result.did_load);
+  EXPECT_FALSE(load_index_result.flush_required);
+  EXPECT_EQ(entries.size(), load_index_result.entries.size());
+  for (SimpleIndex::EntrySet::const_iterator it = entries.begin();
+       it != entries.end(); ++it) {
+    EXPECT_EQ(1U, load_index_result.entries.count(it->first));
+  }
+}
+
+TEST_F(SimpleIndexFileTest, LoadPickleIndex) {
+  base::ScopedTempDir cache_dir;
+  ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
+
+  SimpleIndex::EntrySet entries;
+  static const uint64 kHashes[] = { 11, 22, 33 };
+  static const size_t kNumHashes = arraysize(kHashes);
+  for (size_t i = 0; i < kNumHashes; ++i) {
+    SimpleIndex::InsertInEntrySet(
+        kHashes[i], EntryMetadata(Time::FromInternalValue(kHashes[i]), 1),
+        &entries);
+  }
+  SimpleIndexFile::IndexMetadata index_metadata(kNumHashes, kNumHashes);
+  scoped_ptr<Pickle> pickle = WrappedSimpleIndexFile::Serialize(
+      index_metadata, entries);
+  WrappedSimpleIndexFile simple_index_file(cache_dir.path());
+  const base::FilePath& index_path = simple_index_file.GetIndexFilePath();
+  ASSERT_EQ(static_cast<int>(pickle->size()),
+            file_util::WriteFile(index_path,
+                                 static_cast<const char*>(pickle->data()),
+                                 pickle->size()));
+
+  // An index in the old format is loaded, then replaced by a table.
+  SimpleIndexLoadResult load_index_result;
+  LoadIndex(cache_dir.path(), &load_index_result);
+  EXPECT_TRUE(load_index_result.did_load);
+  EXPECT_TRUE(load_index_result.flush_required);
+  EXPECT_EQ(kNumHashes, load_index_result.entries.size());
+  for (size_t i = 0; i < kNumHashes; ++i)
+    EXPECT_EQ(1U, load_index_result.entries.count(kHashes[i]));
+}
+
 TEST_F(SimpleIndexFileTest, LoadCorruptIndex) {
   base::ScopedTempDir cache_dir;
   ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
@@ -240,4 +427,50 @@ TEST_F(SimpleIndexFileTest, LoadCorruptIndex) {
   EXPECT_TRUE(load_index_result.flush_required);
 }
 
+TEST_F(SimpleIndexFileTest, LoadIndexWithCorruptRecord) {
+  base::ScopedTempDir cache_dir;
+  ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
+
+  SimpleIndex::EntrySet entries;
+  SimpleIndex::InsertInEntrySet(
+      42, EntryMetadata(Time::FromInternalValue(42), 42), &entries);
+  scoped_ptr<std::string> table =
+      WrappedSimpleIndexFile::SerializeTable(entries, 42);
+  (*table)[sizeof(SimpleIndexFile::TableHeader) +
+           42 * sizeof(SimpleIndexFile::TableSlot)] ^= 1;
+  WrappedSimpleIndexFile simple_index_file(cache_dir.path());
+  const base::FilePath& index_path = simple_index_file.GetIndexFilePath();
+  ASSERT_EQ(static_cast<int>(table->size()),
+            file_util::WriteFile(index_path, table->data(), table->size()));
+
+  // The index is restored from the entry files instead.
+  SimpleIndexLoadResult load_index_result;
+  LoadIndex(cache_dir.path(), &load_index_result);
+  EXPECT_TRUE(load_index_result.did_load);
+  EXPECT_TRUE(load_index_result.flush_required);
+  EXPECT_TRUE(load_index_result.entries.empty());
+
+  // A corrupt record is also caught when updating the index in place, and
+  // the index is then written in full.
+  simple_index_file.WriteToDisk(entries, base::hash_set<uint64>(), 42,
+                                base::TimeTicks(), false);
+  base::RunLoop().RunUntilIdle();
+  ASSERT_EQ(static_cast<int>(table->size()),
+            file_util::WriteFile(index_path, table->data(), table->size()));
+  base::hash_set<uint64> changed_hashes;
+  changed_hashes.insert(42);
+  simple_index_file.WriteToDisk(entries, changed_hashes, 42,
+                                base::TimeTicks(), false);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_FALSE(base::PathExists(index_path));
+
+  simple_index_file.WriteToDisk(entries, base::hash_set<uint64>(), 42,
+                                base::TimeTicks(), false);
+  base::RunLoop().RunUntilIdle();
+  LoadIndex(cache_dir.path(), &load_index_result);
+  EXPECT_TRUE(load_index_result.did_load);
+  EXPECT_FALSE(load_index_result.flush_required);
+  EXPECT_EQ(1U, load_index_result.entries.count(42));
+}
+
 }  // namespace disk_cache
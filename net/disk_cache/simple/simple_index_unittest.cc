@@ -63,11 +63,13 @@ class MockSimpleIndexFile : public SimpleIndexFile,
   }
 
   virtual void WriteToDisk(const SimpleIndex::EntrySet& entry_set,
+                           const base::hash_set<uint64>& changed_hashes,
                            uint64 cache_size,
                            const base::TimeTicks& start,
                            bool app_on_background) OVERRIDE {
     disk_writes_++;
     disk_write_entry_set_ = entry_set;
+    disk_write_changed_hashes_ = changed_hashes;
   }
 
   virtual void DoomEntrySet(
@@ -82,6 +84,10 @@ class MockSimpleIndexFile : public SimpleIndexFile,
     entry_set->swap(disk_write_entry_set_);
   }
 
+  const base::hash_set<uint64>& disk_write_changed_hashes() const {
+    return disk_write_changed_hashes_;
+  }
+
   const base::Closure& load_callback() const { return load_callback_; }
   SimpleIndexLoadResult* load_result() const { return load_result_; }
   int load_index_entries_calls() const { return load_index_entries_calls_; }
@@ -100,6 +106,7 @@ class MockSimpleIndexFile : public SimpleIndexFile,
   base::Callback<void(int)> last_doom_reply_callback_;
   int disk_writes_;
   SimpleIndex::EntrySet disk_write_entry_set_;
+  base::hash_set<uint64> disk_write_changed_hashes_;
 };
 
 class SimpleIndexTest  : public testing::Test {
@@ -338,6 +345,25 @@ TEST_F(SimpleIndexTest, GetEntryCount) {
   EXPECT_EQ(0, index()->GetEntryCount());
 }
 
+TEST_F(SimpleIndexTest, GetEntriesUsedSince) {
+  base::Time now(base::Time::Now());
+
+  InsertIntoIndexFileReturn("key1",
+                            now - base::TimeDelta::FromDays(2),
+                            10u);
+  ReturnIndexFile();
+  index()->Insert("key2");
+
+  scoped_ptr<SimpleIndex::HashList> hashes(
+      index()->GetEntriesUsedSince(now - base::TimeDelta::FromDays(1)));
+  ASSERT_EQ(1U, hashes->size());
+  EXPECT_EQ(simple_util::GetEntryHashKey("key2"), (*hashes)[0]);
+
+  hashes = index()->GetEntriesUsedSince(now - base::TimeDelta::FromDays(3));
+  EXPECT_EQ(2U, hashes->size());
+  EXPECT_EQ(2, index()->GetEntryCount());
+}
+
 // Confirm that we get the results we expect from a simple init.
 TEST_F(SimpleIndexTest, BasicInit) {
   base::Time now(base::Time::Now());
@@ -578,4 +604,30 @@ TEST_F(SimpleIndexTest, DiskWritePostponed) {
   index()->write_to_disk_timer_.Stop();
 }
 
+TEST_F(SimpleIndexTest, DiskWriteChangedEntries) {
+  InsertIntoIndexFileReturn("key1", base::Time::Now(), 10);
+  InsertIntoIndexFileReturn("key2", base::Time::Now(), 10);
+  index()->Insert("key3");
+  ReturnIndexFile();
+
+  index()->Remove("key1");
+  index()->UseIfExists("key4");
+  index()->WriteToDisk();
+  EXPECT_EQ(1, index_file_->disk_writes());
+  const base::hash_set<uint64>& changed_hashes =
+      index_file_->disk_write_changed_hashes();
+  EXPECT_EQ(2U, changed_hashes.size());
+  EXPECT_EQ(1U, changed_hashes.count(simple_util::GetEntryHashKey("key1")));
+  EXPECT_EQ(1U, changed_hashes.count(simple_util::GetEntryHashKey("key3")));
+
+  // Only the entries changed since the previous write are passed.
+  index()->UseIfExists("key2");
+  index()->WriteToDisk();
+  EXPECT_EQ(2, index_file_->disk_writes());
+  EXPECT_EQ(1U, index_file_->disk_write_changed_hashes().size());
+  EXPECT_EQ(1U, index_file_->disk_write_changed_hashes().count(
+      simple_util::GetEntryHashKey("key2")));
+  index()->write_to_disk_timer_.Stop();
+}
+
 }  // namespace disk_cache
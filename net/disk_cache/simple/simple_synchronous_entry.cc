@@ -41,6 +41,10 @@ using base::WritePlatformFile;
 
 namespace {
 
+// The size of the first read of an entry. Small entries in the single file
+// layout are read whole.
+const int64 kFilePrefixReadSize = 32 * 1024;
+
 // Used in histograms, please only add entries at the end.
 enum OpenEntryResult {
   OPEN_ENTRY_SUCCESS = 0,
@@ -51,7 +55,10 @@ enum OpenEntryResult {
   OPEN_ENTRY_CANT_READ_KEY = 5,
   // OPEN_ENTRY_KEY_MISMATCH = 6, Deprecated.
   OPEN_ENTRY_KEY_HASH_MISMATCH = 7,
-  OPEN_ENTRY_MAX = 8,
+  OPEN_ENTRY_CANT_READ_TRAILER = 8,
+  OPEN_ENTRY_BAD_TRAILER = 9,
+  OPEN_ENTRY_STREAM_0_CRC_MISMATCH = 10,
+  OPEN_ENTRY_MAX = 11,
 };
 
 // Used in histograms, please only add entries at the end.
@@ -59,7 +66,7 @@ enum CreateEntryResult {
   CREATE_ENTRY_SUCCESS = 0,
   CREATE_ENTRY_PLATFORM_FILE_ERROR = 1,
   CREATE_ENTRY_CANT_WRITE_HEADER = 2,
-  CREATE_ENTRY_CANT_WRITE_KEY = 3,
+  // CREATE_ENTRY_CANT_WRITE_KEY = 3, Deprecated.
   CREATE_ENTRY_MAX = 4,
 };
 
@@ -193,8 +200,8 @@ void SimpleSynchronousEntry::OpenEntry(
     const uint64 entry_hash,
     bool had_index,
     SimpleEntryCreationResults *out_results) {
-  SimpleSynchronousEntry* sync_entry = new SimpleSynchronousEntry(path, "",
-                                                                  entry_hash);
+  SimpleSynchronousEntry* sync_entry = new SimpleSynchronousEntry(
+      path, "", entry_hash, SIMPLE_ENTRY_LAYOUT_FILE_PER_STREAM);
   out_results->result = sync_entry->InitializeForOpen(
       had_index, &out_results->entry_stat);
   if (out_results->result != net::OK) {
@@ -211,11 +218,12 @@ void SimpleSynchronousEntry::CreateEntry(
     const FilePath& path,
     const std::string& key,
     const uint64 entry_hash,
+    SimpleEntryLayout layout,
     bool had_index,
     SimpleEntryCreationResults *out_results) {
   DCHECK_EQ(entry_hash, GetEntryHashKey(key));
-  SimpleSynchronousEntry* sync_entry = new SimpleSynchronousEntry(path, key,
-                                                                  entry_hash);
+  SimpleSynchronousEntry* sync_entry = new SimpleSynchronousEntry(
+      path, key, entry_hash, layout);
   out_results->result = sync_entry->InitializeForCreate(
       had_index, &out_results->entry_stat);
   if (out_results->result != net::OK) {
@@ -272,12 +280,23 @@ void SimpleSynchronousEntry::ReadData(const EntryOperationData& in_entry_op,
                                       base::Time* out_last_used,
                                       int* out_result) const {
   DCHECK(initialized_);
-  int64 file_offset =
-      GetFileOffsetFromKeyAndDataOffset(key_, in_entry_op.offset);
-  int bytes_read = ReadPlatformFile(files_[in_entry_op.index],
-                                    file_offset,
-                                    out_buf->data(),
-                                    in_entry_op.buf_len);
+  int bytes_read;
+  if (layout_ == SIMPLE_ENTRY_LAYOUT_SINGLE_FILE && in_entry_op.index == 0) {
+    bytes_read = std::max(0, std::min(
+        in_entry_op.buf_len,
+        static_cast<int>(stream_0_data_.size()) - in_entry_op.offset));
+    if (bytes_read > 0) {
+      memcpy(out_buf->data(), stream_0_data_.data() + in_entry_op.offset,
+             bytes_read);
+    }
+  } else {
+    int64 file_offset =
+        GetFileOffsetFromKeyAndDataOffset(key_, in_entry_op.offset);
+    bytes_read = ReadFromFile(GetFileIndexForStream(in_entry_op.index),
+                              file_offset,
+                              out_buf->data(),
+                              in_entry_op.buf_len);
+  }
   if (bytes_read > 0) {
     *out_last_used = Time::Now();
     *out_crc32 = crc32(crc32(0L, Z_NULL, 0),
@@ -295,7 +314,7 @@ void SimpleSynchronousEntry::ReadData(const EntryOperationData& in_entry_op,
 void SimpleSynchronousEntry::WriteData(const EntryOperationData& in_entry_op,
                                        net::IOBuffer* in_buf,
                                        SimpleEntryStat* out_entry_stat,
-                                       int* out_result) const {
+                                       int* out_result) {
   DCHECK(initialized_);
   int index = in_entry_op.index;
   int offset = in_entry_op.offset;
@@ -303,11 +322,44 @@ void SimpleSynchronousEntry::WriteData(const EntryOperationData& in_entry_op,
   int truncate = in_entry_op.truncate;
 
   bool extending_by_write = offset + buf_len > out_entry_stat->data_size[index];
+  if (layout_ == SIMPLE_ENTRY_LAYOUT_SINGLE_FILE && index == 0) {
+    // Stream 0 only reaches the file when the entry is closed.
+    const size_t end = offset + buf_len;
+    stream_0_data_.resize(std::max(stream_0_data_.size(), end));
+    if (buf_len > 0)
+      memcpy(&stream_0_data_[offset], in_buf->data(), buf_len);
+    if (truncate || (buf_len == 0 && extending_by_write))
+      stream_0_data_.resize(end);
+    out_entry_stat->data_size[index] = stream_0_data_.size();
+    rewrite_file_tail_ = true;
+    RecordWriteResult(WRITE_RESULT_SUCCESS);
+    out_entry_stat->last_used = out_entry_stat->last_modified = Time::Now();
+    *out_result = buf_len;
+    return;
+  }
+
+  if (layout_ == SIMPLE_ENTRY_LAYOUT_SINGLE_FILE) {
+    // Writing stream 1 runs over the EOF record and stream 0 after it, and a
+    // new stream 2 file needs the trailer to point to it.
+    if (index == 1)
+      rewrite_file_tail_ = true;
+    if (index == 2 && files_[2] == kInvalidPlatformFileValue &&
+        !CreateStream2File()) {
+      RecordWriteResult(WRITE_RESULT_WRITE_FAILURE);
+      Doom();
+      *out_result = net::ERR_CACHE_WRITE_FAILURE;
+      return;
+    }
+  }
+  const int file_index = GetFileIndexForStream(index);
+  if (file_index == 0)
+    file_0_prefix_.clear();
+
   if (extending_by_write) {
     // We are extending the file, and need to insure the EOF record is zeroed.
     const int64 file_eof_offset = GetFileOffsetFromKeyAndDataOffset(
         key_, out_entry_stat->data_size[index]);
-    if (!TruncatePlatformFile(files_[index], file_eof_offset)) {
+    if (!TruncatePlatformFile(files_[file_index], file_eof_offset)) {
       RecordWriteResult(WRITE_RESULT_PRETRUNCATE_FAILURE);
       Doom();
       *out_result = net::ERR_CACHE_WRITE_FAILURE;
@@ -316,8 +368,8 @@ void SimpleSynchronousEntry::WriteData(const EntryOperationData& in_entry_op,
   }
   const int64 file_offset = GetFileOffsetFromKeyAndDataOffset(key_, offset);
   if (buf_len > 0) {
-    if (WritePlatformFile(
-            files_[index], file_offset, in_buf->data(), buf_len) != buf_len) {
+    if (WritePlatformFile(files_[file_index], file_offset, in_buf->data(),
+                          buf_len) != buf_len) {
       RecordWriteResult(WRITE_RESULT_WRITE_FAILURE);
       Doom();
       *out_result = net::ERR_CACHE_WRITE_FAILURE;
@@ -328,7 +380,7 @@ void SimpleSynchronousEntry::WriteData(const EntryOperationData& in_entry_op,
     out_entry_stat->data_size[index] =
         std::max(out_entry_stat->data_size[index], offset + buf_len);
   } else {
-    if (!TruncatePlatformFile(files_[index], file_offset + buf_len)) {
+    if (!TruncatePlatformFile(files_[file_index], file_offset + buf_len)) {
       RecordWriteResult(WRITE_RESULT_TRUNCATE_FAILURE);
       Doom();
       *out_result = net::ERR_CACHE_WRITE_FAILURE;
@@ -348,12 +400,22 @@ void SimpleSynchronousEntry::CheckEOFRecord(int index,
                                             int* out_result) const {
   DCHECK(initialized_);
 
+  const int file_index = GetFileIndexForStream(index);
+  if (layout_ == SIMPLE_ENTRY_LAYOUT_SINGLE_FILE &&
+      (index == 0 || files_[file_index] == kInvalidPlatformFileValue)) {
+    // Stream 0 was checked against the trailer when the entry was opened, and
+    // a missing stream 2 is empty.
+    RecordCheckEOFResult(CHECK_EOF_RESULT_SUCCESS);
+    *out_result = net::OK;
+    return;
+  }
+
   SimpleFileEOF eof_record;
   int64 file_offset = GetFileOffsetFromKeyAndDataOffset(key_, data_size);
-  if (ReadPlatformFile(files_[index],
-                       file_offset,
-                       reinterpret_cast<char*>(&eof_record),
-                       sizeof(eof_record)) != sizeof(eof_record)) {
+  if (ReadFromFile(file_index,
+                   file_offset,
+                   reinterpret_cast<char*>(&eof_record),
+                   sizeof(eof_record)) != sizeof(eof_record)) {
     RecordCheckEOFResult(CHECK_EOF_RESULT_READ_FAILURE);
     Doom();
     *out_result = net::ERR_CACHE_CHECKSUM_READ_FAILURE;
@@ -394,6 +456,14 @@ void SimpleSynchronousEntry::Close(
     if (it->has_crc32)
       eof_record.flags |= SimpleFileEOF::FLAG_HAS_CRC32;
     eof_record.data_crc32 = it->data_crc32;
+    if (layout_ == SIMPLE_ENTRY_LAYOUT_SINGLE_FILE && it->index != 2) {
+      // Written with the rest of the file tail below.
+      if (it->index == 1)
+        stream_1_eof_ = eof_record;
+      continue;
+    }
+    if (files_[it->index] == kInvalidPlatformFileValue)
+      continue;
     int64 file_offset = GetFileOffsetFromKeyAndDataOffset(
         key_, entry_stat.data_size[it->index]);
     if (WritePlatformFile(files_[it->index],
@@ -413,7 +483,16 @@ void SimpleSynchronousEntry::Close(
                              cluster_loss * 100 / (cluster_loss + file_size));
   }
 
+  if (layout_ == SIMPLE_ENTRY_LAYOUT_SINGLE_FILE && rewrite_file_tail_ &&
+      !WriteFileTail(entry_stat)) {
+    RecordCloseResult(CLOSE_RESULT_WRITE_FAILURE);
+    DLOG(INFO) << "Could not write file tail.";
+    Doom();
+  }
+
   for (int i = 0; i < kSimpleEntryFileCount; ++i) {
+    if (files_[i] == kInvalidPlatformFileValue)
+      continue;
     bool did_close_file = ClosePlatformFile(files_[i]);
     CHECK(did_close_file);
   }
@@ -424,12 +503,16 @@ void SimpleSynchronousEntry::Close(
 
 SimpleSynchronousEntry::SimpleSynchronousEntry(const FilePath& path,
                                                const std::string& key,
-                                               const uint64 entry_hash)
+                                               const uint64 entry_hash,
+                                               SimpleEntryLayout layout)
     : path_(path),
       entry_hash_(entry_hash),
       key_(key),
       have_open_files_(false),
-      initialized_(false) {
+      initialized_(false),
+      layout_(layout),
+      rewrite_file_tail_(false) {
+  stream_1_eof_.final_magic_number = kSimpleFinalMagicNumber;
   for (int i = 0; i < kSimpleEntryFileCount; ++i) {
     files_[i] = kInvalidPlatformFileValue;
   }
@@ -441,154 +524,287 @@ SimpleSynchronousEntry::~SimpleSynchronousEntry() {
     CloseFiles();
 }
 
-bool SimpleSynchronousEntry::OpenOrCreateFiles(
-    bool create,
-    bool had_index,
-    SimpleEntryStat* out_entry_stat) {
-  for (int i = 0; i < kSimpleEntryFileCount; ++i) {
-    FilePath filename = path_.AppendASCII(
-        GetFilenameFromEntryHashAndIndex(entry_hash_, i));
-    int flags = PLATFORM_FILE_READ | PLATFORM_FILE_WRITE;
-    if (create)
-      flags |= PLATFORM_FILE_CREATE;
-    else
-      flags |= PLATFORM_FILE_OPEN;
-    PlatformFileError error;
-    files_[i] = CreatePlatformFile(filename, flags, NULL, &error);
-    if (error != PLATFORM_FILE_OK) {
-      // TODO(ttuttle,gavinp): Remove one each of these triplets of histograms.
-      // We can calculate the third as the sum or difference of the other two.
-      if (create) {
-        RecordSyncCreateResult(CREATE_ENTRY_PLATFORM_FILE_ERROR, had_index);
-        UMA_HISTOGRAM_ENUMERATION("SimpleCache.SyncCreatePlatformFileError",
-                                  -error, -base::PLATFORM_FILE_ERROR_MAX);
-        if (had_index) {
-          UMA_HISTOGRAM_ENUMERATION(
-              "SimpleCache.SyncCreatePlatformFileError_WithIndex",
-              -error, -base::PLATFORM_FILE_ERROR_MAX);
-        } else {
-          UMA_HISTOGRAM_ENUMERATION(
-              "SimpleCache.SyncCreatePlatformFileError_WithoutIndex",
-              -error, -base::PLATFORM_FILE_ERROR_MAX);
-        }
-      } else {
-        RecordSyncOpenResult(OPEN_ENTRY_PLATFORM_FILE_ERROR, had_index);
-        UMA_HISTOGRAM_ENUMERATION("SimpleCache.SyncOpenPlatformFileError",
-                                  -error, -base::PLATFORM_FILE_ERROR_MAX);
-        if (had_index) {
-          UMA_HISTOGRAM_ENUMERATION(
-              "SimpleCache.SyncOpenPlatformFileError_WithIndex",
-              -error, -base::PLATFORM_FILE_ERROR_MAX);
-        } else {
-          UMA_HISTOGRAM_ENUMERATION(
-              "SimpleCache.SyncOpenPlatformFileError_WithoutIndex",
-              -error, -base::PLATFORM_FILE_ERROR_MAX);
-        }
-      }
-      while (--i >= 0) {
-        bool ALLOW_UNUSED did_close = ClosePlatformFile(files_[i]);
-        DLOG_IF(INFO, !did_close) << "Could not close file "
-                                  << filename.MaybeAsASCII();
-      }
-      return false;
-    }
+bool SimpleSynchronousEntry::OpenOrCreateFile(int file_index,
+                                              bool create,
+                                              bool had_index) {
+  FilePath filename = path_.AppendASCII(
+      GetFilenameFromEntryHashAndIndex(entry_hash_, file_index));
+  int flags = PLATFORM_FILE_READ | PLATFORM_FILE_WRITE;
+  if (create)
+    flags |= PLATFORM_FILE_CREATE;
+  else
+    flags |= PLATFORM_FILE_OPEN;
+  PlatformFileError error;
+  files_[file_index] = CreatePlatformFile(filename, flags, NULL, &error);
+  if (error == PLATFORM_FILE_OK) {
+    have_open_files_ = true;
+    return true;
   }
 
-  have_open_files_ = true;
+  // TODO(ttuttle,gavinp): Remove one each of these triplets of histograms.
+  // We can calculate the third as the sum or difference of the other two.
   if (create) {
-    out_entry_stat->last_modified = out_entry_stat->last_used = Time::Now();
-    for (int i = 0; i < kSimpleEntryFileCount; ++i)
-      out_entry_stat->data_size[i] = 0;
+    RecordSyncCreateResult(CREATE_ENTRY_PLATFORM_FILE_ERROR, had_index);
+    UMA_HISTOGRAM_ENUMERATION("SimpleCache.SyncCreatePlatformFileError",
+                              -error, -base::PLATFORM_FILE_ERROR_MAX);
+    if (had_index) {
+      UMA_HISTOGRAM_ENUMERATION(
+          "SimpleCache.SyncCreatePlatformFileError_WithIndex",
+          -error, -base::PLATFORM_FILE_ERROR_MAX);
+    } else {
+      UMA_HISTOGRAM_ENUMERATION(
+          "SimpleCache.SyncCreatePlatformFileError_WithoutIndex",
+          -error, -base::PLATFORM_FILE_ERROR_MAX);
+    }
   } else {
-    for (int i = 0; i < kSimpleEntryFileCount; ++i) {
-      PlatformFileInfo file_info;
-      bool success = GetPlatformFileInfo(files_[i], &file_info);
-      base::Time file_last_modified;
-      if (!success) {
-        DLOG(WARNING) << "Could not get platform file info.";
-        continue;
-      }
-      out_entry_stat->last_used = file_info.last_accessed;
-      if (simple_util::GetMTime(path_, &file_last_modified))
-        out_entry_stat->last_modified = file_last_modified;
-      else
-        out_entry_stat->last_modified = file_info.last_modified;
-
-      // Keep the file size in |data size_| briefly until the key is initialized
-      // properly.
-      out_entry_stat->data_size[i] = file_info.size;
+    RecordSyncOpenResult(OPEN_ENTRY_PLATFORM_FILE_ERROR, had_index);
+    UMA_HISTOGRAM_ENUMERATION("SimpleCache.SyncOpenPlatformFileError",
+                              -error, -base::PLATFORM_FILE_ERROR_MAX);
+    if (had_index) {
+      UMA_HISTOGRAM_ENUMERATION(
+          "SimpleCache.SyncOpenPlatformFileError_WithIndex",
+          -error, -base::PLATFORM_FILE_ERROR_MAX);
+    } else {
+      UMA_HISTOGRAM_ENUMERATION(
+          "SimpleCache.SyncOpenPlatformFileError_WithoutIndex",
+          -error, -base::PLATFORM_FILE_ERROR_MAX);
     }
   }
-
-  return true;
+  return false;
 }
 
 void SimpleSynchronousEntry::CloseFiles() {
   for (int i = 0; i < kSimpleEntryFileCount; ++i) {
-    DCHECK_NE(kInvalidPlatformFileValue, files_[i]);
+    if (files_[i] == kInvalidPlatformFileValue)
+      continue;
     bool did_close = ClosePlatformFile(files_[i]);
     DCHECK(did_close);
   }
 }
 
+int SimpleSynchronousEntry::GetFileIndexForStream(int index) const {
+  if (layout_ == SIMPLE_ENTRY_LAYOUT_SINGLE_FILE && index == 1)
+    return 0;
+  return index;
+}
+
+int SimpleSynchronousEntry::ReadFromFile(int file_index,
+                                         int64 offset,
+                                         char* data,
+                                         int size) const {
+  if (file_index == 0 &&
+      offset + size <= static_cast<int64>(file_0_prefix_.size())) {
+    memcpy(data, file_0_prefix_.data() + offset, size);
+    return size;
+  }
+  if (files_[file_index] == kInvalidPlatformFileValue)
+    return 0;
+  return ReadPlatformFile(files_[file_index], offset, data, size);
+}
+
+bool SimpleSynchronousEntry::ReadHeaderAndKey(int file_index,
+                                              bool had_index,
+                                              uint32* out_version) {
+  SimpleFileHeader header;
+  int header_read_result =
+      ReadFromFile(file_index, 0, reinterpret_cast<char*>(&header),
+                   sizeof(header));
+  if (header_read_result != sizeof(header)) {
+    DLOG(WARNING) << "Cannot read header from entry.";
+    RecordSyncOpenResult(OPEN_ENTRY_CANT_READ_HEADER, had_index);
+    return false;
+  }
+
+  if (header.initial_magic_number != kSimpleInitialMagicNumber) {
+    // TODO(gavinp): This seems very bad; for now we log at WARNING, but we
+    // should give consideration to not saturating the log with these if that
+    // becomes a problem.
+    DLOG(WARNING) << "Magic number did not match.";
+    RecordSyncOpenResult(OPEN_ENTRY_BAD_MAGIC_NUMBER, had_index);
+    return false;
+  }
+
+  if (header.version != kSimpleVersion &&
+      (file_index != 0 || header.version != kSimpleSingleFileVersion)) {
+    DLOG(WARNING) << "Unreadable version.";
+    RecordSyncOpenResult(OPEN_ENTRY_BAD_VERSION, had_index);
+    return false;
+  }
+
+  scoped_ptr<char[]> key(new char[header.key_length]);
+  int key_read_result = ReadFromFile(file_index, sizeof(header),
+                                     key.get(), header.key_length);
+  if (key_read_result != implicit_cast<int>(header.key_length)) {
+    DLOG(WARNING) << "Cannot read key from entry.";
+    RecordSyncOpenResult(OPEN_ENTRY_CANT_READ_KEY, had_index);
+    return false;
+  }
+
+  if (base::Hash(key.get(), header.key_length) != header.key_hash) {
+    DLOG(WARNING) << "Hash mismatch on key.";
+    RecordSyncOpenResult(OPEN_ENTRY_KEY_HASH_MISMATCH, had_index);
+    return false;
+  }
+
+  key_ = std::string(key.get(), header.key_length);
+  *out_version = header.version;
+  return true;
+}
+
+bool SimpleSynchronousEntry::WriteHeaderAndKey(int file_index) {
+  SimpleFileHeader header;
+  header.initial_magic_number = kSimpleInitialMagicNumber;
+  header.version = kSimpleVersion;
+  if (layout_ == SIMPLE_ENTRY_LAYOUT_SINGLE_FILE && file_index == 0)
+    header.version = kSimpleSingleFileVersion;
+
+  header.key_length = key_.size();
+  header.key_hash = base::Hash(key_);
+
+  std::string header_and_key(reinterpret_cast<const char*>(&header),
+                             sizeof(header));
+  header_and_key.append(key_);
+  return WritePlatformFile(files_[file_index], 0, header_and_key.data(),
+                           header_and_key.size()) ==
+      implicit_cast<int>(header_and_key.size());
+}
+
 int SimpleSynchronousEntry::InitializeForOpen(bool had_index,
                                               SimpleEntryStat* out_entry_stat) {
   DCHECK(!initialized_);
-  if (!OpenOrCreateFiles(false, had_index, out_entry_stat))
+  if (!OpenOrCreateFile(0, false, had_index))
     return net::ERR_FAILED;
 
-  for (int i = 0; i < kSimpleEntryFileCount; ++i) {
-    SimpleFileHeader header;
-    int header_read_result =
-        ReadPlatformFile(files_[i], 0, reinterpret_cast<char*>(&header),
-                         sizeof(header));
-    if (header_read_result != sizeof(header)) {
-      DLOG(WARNING) << "Cannot read header from entry.";
-      RecordSyncOpenResult(OPEN_ENTRY_CANT_READ_HEADER, had_index);
-      return net::ERR_FAILED;
-    }
-
-    if (header.initial_magic_number != kSimpleInitialMagicNumber) {
-      // TODO(gavinp): This seems very bad; for now we log at WARNING, but we
-      // should give consideration to not saturating the log with these if that
-      // becomes a problem.
-      DLOG(WARNING) << "Magic number did not match.";
-      RecordSyncOpenResult(OPEN_ENTRY_BAD_MAGIC_NUMBER, had_index);
-      return net::ERR_FAILED;
-    }
+  PlatformFileInfo file_info;
+  if (!GetPlatformFileInfo(files_[0], &file_info)) {
+    DLOG(WARNING) << "Could not get platform file info.";
+    return net::ERR_FAILED;
+  }
+  out_entry_stat->last_used = file_info.last_accessed;
+  base::Time file_last_modified;
+  if (simple_util::GetMTime(path_, &file_last_modified))
+    out_entry_stat->last_modified = file_last_modified;
+  else
+    out_entry_stat->last_modified = file_info.last_modified;
+
+  // One read brings in the header, the key and, for small entries in the
+  // single file layout, all the streams.
+  const int prefix_size =
+      static_cast<int>(std::min<int64>(file_info.size, kFilePrefixReadSize));
+  file_0_prefix_.resize(prefix_size);
+  if (prefix_size > 0 &&
+      ReadPlatformFile(files_[0], 0, &file_0_prefix_[0], prefix_size) !=
+          prefix_size) {
+    file_0_prefix_.clear();
+  }
 
-    if (header.version != kSimpleVersion) {
-      DLOG(WARNING) << "Unreadable version.";
-      RecordSyncOpenResult(OPEN_ENTRY_BAD_VERSION, had_index);
-      return net::ERR_FAILED;
-    }
+  uint32 version = 0;
+  if (!ReadHeaderAndKey(0, had_index, &version))
+    return net::ERR_FAILED;
 
-    scoped_ptr<char[]> key(new char[header.key_length]);
-    int key_read_result = ReadPlatformFile(files_[i], sizeof(header),
-                                           key.get(), header.key_length);
-    if (key_read_result != implicit_cast<int>(header.key_length)) {
-      DLOG(WARNING) << "Cannot read key from entry.";
-      RecordSyncOpenResult(OPEN_ENTRY_CANT_READ_KEY, had_index);
-      return net::ERR_FAILED;
+  if (version == kSimpleSingleFileVersion) {
+    layout_ = SIMPLE_ENTRY_LAYOUT_SINGLE_FILE;
+    int result =
+        InitializeSingleFileStreams(file_info.size, had_index, out_entry_stat);
+    if (result != net::OK)
+      return result;
+  } else {
+    layout_ = SIMPLE_ENTRY_LAYOUT_FILE_PER_STREAM;
+    out_entry_stat->data_size[0] =
+        GetDataSizeFromKeyAndFileSize(key_, file_info.size);
+    for (int i = 1; i < kSimpleEntryFileCount; ++i) {
+      if (!OpenOrCreateFile(i, false, had_index))
+        return net::ERR_FAILED;
+      if (!GetPlatformFileInfo(files_[i], &file_info)) {
+        DLOG(WARNING) << "Could not get platform file info.";
+        return net::ERR_FAILED;
+      }
+      if (!ReadHeaderAndKey(i, had_index, &version))
+        return net::ERR_FAILED;
+      out_entry_stat->data_size[i] =
+          GetDataSizeFromKeyAndFileSize(key_, file_info.size);
     }
+  }
 
-    key_ = std::string(key.get(), header.key_length);
-    out_entry_stat->data_size[i] =
-        GetDataSizeFromKeyAndFileSize(key_, out_entry_stat->data_size[i]);
+  for (int i = 0; i < kSimpleEntryFileCount; ++i) {
     if (out_entry_stat->data_size[i] < 0) {
       // This entry can't possibly be valid, as it does not have enough space to
       // store a valid SimpleFileEOF record.
       return net::ERR_FAILED;
     }
+  }
+  RecordSyncOpenResult(OPEN_ENTRY_SUCCESS, had_index);
+  initialized_ = true;
+  return net::OK;
+}
 
-    if (base::Hash(key.get(), header.key_length) != header.key_hash) {
-      DLOG(WARNING) << "Hash mismatch on key.";
-      RecordSyncOpenResult(OPEN_ENTRY_KEY_HASH_MISMATCH, had_index);
+int SimpleSynchronousEntry::InitializeSingleFileStreams(
+    int64 file_0_size,
+    bool had_index,
+    SimpleEntryStat* out_entry_stat) {
+  const int64 min_file_size =
+      GetFileSizeFromKeyAndDataSize(key_, 0) + sizeof(SimpleFileTrailer);
+  SimpleFileTrailer trailer;
+  const int64 trailer_offset = file_0_size - sizeof(trailer);
+  if (file_0_size < min_file_size ||
+      ReadFromFile(0, trailer_offset, reinterpret_cast<char*>(&trailer),
+                   sizeof(trailer)) != sizeof(trailer)) {
+    DLOG(WARNING) << "Cannot read trailer from entry.";
+    RecordSyncOpenResult(OPEN_ENTRY_CANT_READ_TRAILER, had_index);
+    return net::ERR_FAILED;
+  }
+
+  if (trailer.final_magic_number != kSimpleTrailerMagicNumber ||
+      file_0_size - trailer.stream_0_size < min_file_size) {
+    DLOG(WARNING) << "Bad trailer.";
+    RecordSyncOpenResult(OPEN_ENTRY_BAD_TRAILER, had_index);
+    return net::ERR_FAILED;
+  }
+
+  // Read the EOF record of stream 1 and stream 0 at once.
+  const int64 stream_0_offset = trailer_offset - trailer.stream_0_size;
+  const int64 stream_1_eof_offset = stream_0_offset - sizeof(stream_1_eof_);
+  std::string stream_1_eof_and_stream_0(
+      sizeof(stream_1_eof_) + trailer.stream_0_size, '\0');
+  if (ReadFromFile(0, stream_1_eof_offset, &stream_1_eof_and_stream_0[0],
+                   stream_1_eof_and_stream_0.size()) !=
+      implicit_cast<int>(stream_1_eof_and_stream_0.size())) {
+    DLOG(WARNING) << "Cannot read trailer from entry.";
+    RecordSyncOpenResult(OPEN_ENTRY_CANT_READ_TRAILER, had_index);
+    return net::ERR_FAILED;
+  }
+  memcpy(&stream_1_eof_, stream_1_eof_and_stream_0.data(),
+         sizeof(stream_1_eof_));
+  stream_0_data_ = stream_1_eof_and_stream_0.substr(sizeof(stream_1_eof_));
+
+  const uint32 stream_0_crc32 = crc32(
+      crc32(0L, Z_NULL, 0),
+      reinterpret_cast<const Bytef*>(stream_0_data_.data()),
+      stream_0_data_.size());
+  if (stream_0_crc32 != trailer.stream_0_crc32) {
+    DLOG(WARNING) << "Stream 0 crc mismatch.";
+    RecordSyncOpenResult(OPEN_ENTRY_STREAM_0_CRC_MISMATCH, had_index);
+    return net::ERR_FAILED;
+  }
+
+  out_entry_stat->data_size[0] = stream_0_data_.size();
+  out_entry_stat->data_size[1] =
+      GetDataSizeFromKeyAndFileSize(key_, stream_0_offset);
+  out_entry_stat->data_size[2] = 0;
+  if (trailer.flags & SimpleFileTrailer::FLAG_HAS_STREAM_2_FILE) {
+    PlatformFileInfo file_info;
+    uint32 version = 0;
+    if (!OpenOrCreateFile(2, false, had_index))
+      return net::ERR_FAILED;
+    if (!GetPlatformFileInfo(files_[2], &file_info)) {
+      DLOG(WARNING) << "Could not get platform file info.";
       return net::ERR_FAILED;
     }
+    if (!ReadHeaderAndKey(2, had_index, &version))
+      return net::ERR_FAILED;
+    out_entry_stat->data_size[2] =
+        GetDataSizeFromKeyAndFileSize(key_, file_info.size);
   }
-  RecordSyncOpenResult(OPEN_ENTRY_SUCCESS, had_index);
-  initialized_ = true;
   return net::OK;
 }
 
@@ -596,37 +812,79 @@ int SimpleSynchronousEntry::InitializeForCreate(
     bool had_index,
     SimpleEntryStat* out_entry_stat) {
   DCHECK(!initialized_);
-  if (!OpenOrCreateFiles(true, had_index, out_entry_stat)) {
-    DLOG(WARNING) << "Could not create platform files.";
-    return net::ERR_FILE_EXISTS;
+  const int file_count = layout_ == SIMPLE_ENTRY_LAYOUT_SINGLE_FILE ?
+      1 : kSimpleEntryFileCount;
+  for (int i = 0; i < file_count; ++i) {
+    if (!OpenOrCreateFile(i, true, had_index)) {
+      DLOG(WARNING) << "Could not create platform files.";
+      return net::ERR_FILE_EXISTS;
+    }
   }
-  for (int i = 0; i < kSimpleEntryFileCount; ++i) {
-    SimpleFileHeader header;
-    header.initial_magic_number = kSimpleInitialMagicNumber;
-    header.version = kSimpleVersion;
 
-    header.key_length = key_.size();
-    header.key_hash = base::Hash(key_);
+  out_entry_stat->last_modified = out_entry_stat->last_used = Time::Now();
+  for (int i = 0; i < kSimpleEntryFileCount; ++i)
+    out_entry_stat->data_size[i] = 0;
 
-    if (WritePlatformFile(files_[i], 0, reinterpret_cast<char*>(&header),
-                          sizeof(header)) != sizeof(header)) {
+  for (int i = 0; i < file_count; ++i) {
+    if (!WriteHeaderAndKey(i)) {
       DLOG(WARNING) << "Could not write headers to new cache entry.";
       RecordSyncCreateResult(CREATE_ENTRY_CANT_WRITE_HEADER, had_index);
       return net::ERR_FAILED;
     }
-
-    if (WritePlatformFile(files_[i], sizeof(header), key_.data(),
-                          key_.size()) != implicit_cast<int>(key_.size())) {
-      DLOG(WARNING) << "Could not write keys to new cache entry.";
-      RecordSyncCreateResult(CREATE_ENTRY_CANT_WRITE_KEY, had_index);
-      return net::ERR_FAILED;
-    }
   }
+  // The trailer makes the new file a valid entry.
+  rewrite_file_tail_ = layout_ == SIMPLE_ENTRY_LAYOUT_SINGLE_FILE;
   RecordSyncCreateResult(CREATE_ENTRY_SUCCESS, had_index);
   initialized_ = true;
   return net::OK;
 }
 
+bool SimpleSynchronousEntry::CreateStream2File() {
+  DCHECK_EQ(SIMPLE_ENTRY_LAYOUT_SINGLE_FILE, layout_);
+  FilePath filename = path_.AppendASCII(
+      GetFilenameFromEntryHashAndIndex(entry_hash_, 2));
+  // A file left over by an entry which has since been replaced is not
+  // pointed to by any trailer, so it is overwritten.
+  PlatformFileError error;
+  files_[2] = CreatePlatformFile(
+      filename,
+      base::PLATFORM_FILE_CREATE_ALWAYS | PLATFORM_FILE_READ |
+          PLATFORM_FILE_WRITE,
+      NULL, &error);
+  if (error != PLATFORM_FILE_OK)
+    return false;
+  rewrite_file_tail_ = true;
+  return WriteHeaderAndKey(2);
+}
+
+bool SimpleSynchronousEntry::WriteFileTail(const SimpleEntryStat& entry_stat) {
+  DCHECK_EQ(SIMPLE_ENTRY_LAYOUT_SINGLE_FILE, layout_);
+  DCHECK_EQ(implicit_cast<size_t>(entry_stat.data_size[0]),
+            stream_0_data_.size());
+  SimpleFileTrailer trailer;
+  trailer.final_magic_number = kSimpleTrailerMagicNumber;
+  if (files_[2] != kInvalidPlatformFileValue)
+    trailer.flags |= SimpleFileTrailer::FLAG_HAS_STREAM_2_FILE;
+  trailer.stream_0_crc32 = crc32(
+      crc32(0L, Z_NULL, 0),
+      reinterpret_cast<const Bytef*>(stream_0_data_.data()),
+      stream_0_data_.size());
+  trailer.stream_0_size = stream_0_data_.size();
+
+  std::string tail(reinterpret_cast<const char*>(&stream_1_eof_),
+                   sizeof(stream_1_eof_));
+  tail.append(stream_0_data_);
+  tail.append(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+  const int64 file_offset =
+      GetFileOffsetFromKeyAndDataOffset(key_, entry_stat.data_size[1]);
+  if (WritePlatformFile(files_[0], file_offset, tail.data(), tail.size()) !=
+      implicit_cast<int>(tail.size())) {
+    return false;
+  }
+  // The entry may have shrunk, and the trailer has to end the file.
+  return TruncatePlatformFile(files_[0], file_offset + tail.size());
+}
+
 void SimpleSynchronousEntry::Doom() const {
   // TODO(gavinp): Consider if we should guard against redundant Doom() calls.
   DeleteFilesForEntryHash(path_, entry_hash_);
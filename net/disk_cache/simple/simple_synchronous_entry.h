@@ -76,9 +76,12 @@ class SimpleSynchronousEntry {
                         bool had_index,
                         SimpleEntryCreationResults* out_results);
 
+  // Entries are opened in the layout they were created with; |layout| only
+  // applies to the files of the new entry.
   static void CreateEntry(const base::FilePath& path,
                           const std::string& key,
                           uint64 entry_hash,
+                          SimpleEntryLayout layout,
                           bool had_index,
                           SimpleEntryCreationResults* out_results);
 
@@ -106,7 +109,7 @@ class SimpleSynchronousEntry {
   void WriteData(const EntryOperationData& in_entry_op,
                  net::IOBuffer* in_buf,
                  SimpleEntryStat* out_entry_stat,
-                 int* out_result) const;
+                 int* out_result);
   void CheckEOFRecord(int index,
                       int data_size,
                       uint32 expected_crc32,
@@ -124,17 +127,42 @@ class SimpleSynchronousEntry {
   SimpleSynchronousEntry(
       const base::FilePath& path,
       const std::string& key,
-      uint64 entry_hash);
+      uint64 entry_hash,
+      SimpleEntryLayout layout);
 
   // Like Entry, the SimpleSynchronousEntry self releases when Close() is
   // called.
   ~SimpleSynchronousEntry();
 
-  bool OpenOrCreateFiles(bool create,
-                         bool had_index,
-                         SimpleEntryStat* out_entry_stat);
+  bool OpenOrCreateFile(int file_index, bool create, bool had_index);
   void CloseFiles();
 
+  // Returns the index of the file holding stream |index|.
+  int GetFileIndexForStream(int index) const;
+
+  // Like ReadPlatformFile(), but served from |file_0_prefix_| when it holds
+  // the bytes. Reading a file which does not exist reads nothing.
+  int ReadFromFile(int file_index, int64 offset, char* data, int size) const;
+
+  // Reads the header and the key of a file, and sets |key_|. Returns false,
+  // after recording why, if they are not valid.
+  bool ReadHeaderAndKey(int file_index, bool had_index, uint32* out_version);
+  bool WriteHeaderAndKey(int file_index);
+
+  // Reads the streams of an entry in the single file layout, from the trailer
+  // at the end of |file_0_size| bytes back.
+  int InitializeSingleFileStreams(int64 file_0_size,
+                                  bool had_index,
+                                  SimpleEntryStat* out_entry_stat);
+
+  // In the single file layout, creates the file of stream 2 when it is first
+  // written.
+  bool CreateStream2File();
+
+  // In the single file layout, writes everything after the data of stream 1:
+  // its EOF record, stream 0 and the trailer.
+  bool WriteFileTail(const SimpleEntryStat& entry_stat);
+
   // Returns a net error, i.e. net::OK on success.  |had_index| is passed
   // from the main entry for metrics purposes, and is true if the index was
   // initialized when the open operation began.
@@ -158,6 +186,21 @@ class SimpleSynchronousEntry {
   bool have_open_files_;
   bool initialized_;
 
+  SimpleEntryLayout layout_;
+
+  // In the single file layout, stream 0 is kept in memory and written out at
+  // the end of the file by Close(), after the EOF record of stream 1.
+  std::string stream_0_data_;
+  SimpleFileEOF stream_1_eof_;
+  bool rewrite_file_tail_;
+
+  // The first bytes of file 0, read when opening the entry. For small entries
+  // this is the whole file, so reading them needs no further IO. Cleared when
+  // the file is written to.
+  std::string file_0_prefix_;
+
+  // In the single file layout, the file of stream 2 is only open when stream 2
+  // has been written.
   base::PlatformFile files_[kSimpleEntryFileCount];
 };
 
@@ -0,0 +1,148 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/simple/simple_worker_pool.h"
+
+#include <deque>
+
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/logging.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/synchronization/lock.h"
+#include "base/task_runner.h"
+#include "base/threading/thread.h"
+
+namespace disk_cache {
+
+// The tasks of one thread. Every posted task is queued here, and a call to
+// RunNextTask() is posted to the thread for it; each call runs the oldest
+// high priority task if there is one, and the oldest normal task otherwise.
+class SimpleWorkerPool::PriorityQueue
+    : public base::RefCountedThreadSafe<PriorityQueue> {
+ public:
+  explicit PriorityQueue(base::MessageLoopProxy* message_loop_proxy)
+      : message_loop_proxy_(message_loop_proxy) {
+  }
+
+  bool PostTask(const tracked_objects::Location& from_here,
+                const base::Closure& task,
+                base::TimeDelta delay,
+                bool high_priority) {
+    if (delay > base::TimeDelta()) {
+      return message_loop_proxy_->PostDelayedTask(
+          from_here,
+          base::Bind(base::IgnoreResult(&PriorityQueue::PostTask), this,
+                     from_here, task, base::TimeDelta(), high_priority),
+          delay);
+    }
+    {
+      base::AutoLock lock(lock_);
+      if (high_priority)
+        high_priority_tasks_.push_back(task);
+      else
+        tasks_.push_back(task);
+    }
+    return message_loop_proxy_->PostTask(
+        from_here, base::Bind(&PriorityQueue::RunNextTask, this));
+  }
+
+  bool RunsTasksOnCurrentThread() const {
+    return message_loop_proxy_->BelongsToCurrentThread();
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<PriorityQueue>;
+
+  ~PriorityQueue() {}
+
+  void RunNextTask() {
+    base::Closure task;
+    {
+      base::AutoLock lock(lock_);
+      std::deque<base::Closure>* queue =
+          high_priority_tasks_.empty() ? &tasks_ : &high_priority_tasks_;
+      DCHECK(!queue->empty());
+      task = queue->front();
+      queue->pop_front();
+    }
+    task.Run();
+  }
+
+  const scoped_refptr<base::MessageLoopProxy> message_loop_proxy_;
+
+  base::Lock lock_;
+  std::deque<base::Closure> high_priority_tasks_;
+  std::deque<base::Closure> tasks_;
+
+  DISALLOW_COPY_AND_ASSIGN(PriorityQueue);
+};
+
+class SimpleWorkerPool::PriorityTaskRunner : public base::TaskRunner {
+ public:
+  PriorityTaskRunner(PriorityQueue* queue, bool high_priority)
+      : queue_(queue),
+        high_priority_(high_priority) {
+  }
+
+  // From base::TaskRunner:
+  virtual bool PostDelayedTask(const tracked_objects::Location& from_here,
+                               const base::Closure& task,
+                               base::TimeDelta delay) OVERRIDE {
+    return queue_->PostTask(from_here, task, delay, high_priority_);
+  }
+
+  virtual bool RunsTasksOnCurrentThread() const OVERRIDE {
+    return queue_->RunsTasksOnCurrentThread();
+  }
+
+ private:
+  virtual ~PriorityTaskRunner() {}
+
+  const scoped_refptr<PriorityQueue> queue_;
+  const bool high_priority_;
+
+  DISALLOW_COPY_AND_ASSIGN(PriorityTaskRunner);
+};
+
+SimpleWorkerPool::SimpleWorkerPool(int thread_count,
+                                   const std::string& thread_name_prefix) {
+  DCHECK_LT(0, thread_count);
+  for (int i = 0; i < thread_count; ++i) {
+    const std::string thread_name = thread_name_prefix + base::IntToString(i);
+    base::Thread* thread = new base::Thread(thread_name.c_str());
+    threads_.push_back(thread);
+    CHECK(thread->Start());
+    scoped_refptr<PriorityQueue> queue(
+        new PriorityQueue(thread->message_loop_proxy().get()));
+    task_runners_.push_back(new PriorityTaskRunner(queue.get(), false));
+    high_priority_task_runners_.push_back(
+        new PriorityTaskRunner(queue.get(), true));
+  }
+}
+
+base::TaskRunner* SimpleWorkerPool::GetTaskRunner(uint64 entry_hash) {
+  return task_runners_[GetShard(entry_hash)].get();
+}
+
+base::TaskRunner* SimpleWorkerPool::GetHighPriorityTaskRunner(
+    uint64 entry_hash) {
+  return high_priority_task_runners_[GetShard(entry_hash)].get();
+}
+
+void SimpleWorkerPool::Shutdown() {
+  for (size_t i = 0; i < threads_.size(); ++i)
+    threads_[i]->Stop();
+}
+
+SimpleWorkerPool::~SimpleWorkerPool() {
+  Shutdown();
+}
+
+int SimpleWorkerPool::GetShard(uint64 entry_hash) const {
+  return static_cast<int>(entry_hash % threads_.size());
+}
+
+}  // namespace disk_cache
@@ -0,0 +1,68 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_DISK_CACHE_SIMPLE_SIMPLE_WORKER_POOL_H_
+#define NET_DISK_CACHE_SIMPLE_SIMPLE_WORKER_POOL_H_
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_vector.h"
+#include "net/base/net_export.h"
+
+namespace base {
+class TaskRunner;
+class Thread;
+}
+
+namespace disk_cache {
+
+// SimpleWorkerPool runs the IO of the simple cache entries on a fixed set of
+// threads. Entries are sharded onto the threads by their hash, so all the IO
+// of an entry runs in order on a single thread, and a busy entry never holds
+// up more than its own shard.
+//
+// Each thread has two queues. Tasks posted to GetHighPriorityTaskRunner() are
+// run before any task waiting in the normal queue of the same thread, which
+// lets the reads of the most urgent requests jump ahead of background writes.
+class NET_EXPORT_PRIVATE SimpleWorkerPool
+    : public base::RefCountedThreadSafe<SimpleWorkerPool> {
+ public:
+  // Starts |thread_count| threads, named |thread_name_prefix| followed by
+  // their index.
+  SimpleWorkerPool(int thread_count, const std::string& thread_name_prefix);
+
+  int thread_count() const { return static_cast<int>(threads_.size()); }
+
+  // Returns the task runners for the entry with hash |entry_hash|. The tasks
+  // posted to both of them run on the same thread.
+  base::TaskRunner* GetTaskRunner(uint64 entry_hash);
+  base::TaskRunner* GetHighPriorityTaskRunner(uint64 entry_hash);
+
+  // Stops all the threads. Tasks which have not run yet are deleted, and
+  // tasks posted afterwards are dropped. Used by tests; the pool of the
+  // backends is leaked and never shut down.
+  void Shutdown();
+
+ private:
+  friend class base::RefCountedThreadSafe<SimpleWorkerPool>;
+  class PriorityQueue;
+  class PriorityTaskRunner;
+
+  ~SimpleWorkerPool();
+
+  int GetShard(uint64 entry_hash) const;
+
+  ScopedVector<base::Thread> threads_;
+  std::vector<scoped_refptr<base::TaskRunner> > task_runners_;
+  std::vector<scoped_refptr<base::TaskRunner> > high_priority_task_runners_;
+
+  DISALLOW_COPY_AND_ASSIGN(SimpleWorkerPool);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_SIMPLE_SIMPLE_WORKER_POOL_H_
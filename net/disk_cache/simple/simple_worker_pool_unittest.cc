@@ -0,0 +1,142 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/simple/simple_worker_pool.h"
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/location.h"
+#include "base/synchronization/lock.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/task_runner.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+class TaskRecorder {
+ public:
+  TaskRecorder() {}
+
+  void Record(int task) {
+    base::AutoLock lock(lock_);
+    tasks_.push_back(task);
+  }
+
+  std::vector<int> tasks() {
+    base::AutoLock lock(lock_);
+    return tasks_;
+  }
+
+ private:
+  base::Lock lock_;
+  std::vector<int> tasks_;
+};
+
+void RecordThread(base::TaskRunner* task_runner, bool* runs_tasks) {
+  *runs_tasks = task_runner->RunsTasksOnCurrentThread();
+}
+
+void Signal(base::WaitableEvent* event) {
+  event->Signal();
+}
+
+void Wait(base::WaitableEvent* event) {
+  event->Wait();
+}
+
+// Waits for all the tasks posted to |task_runner| so far to run.
+void Flush(base::TaskRunner* task_runner) {
+  base::WaitableEvent done(false, false);
+  task_runner->PostTask(FROM_HERE, base::Bind(&Signal, &done));
+  done.Wait();
+}
+
+}  // namespace
+
+namespace disk_cache {
+
+TEST(SimpleWorkerPoolTest, ShardsByHash) {
+  scoped_refptr<SimpleWorkerPool> pool(new SimpleWorkerPool(4, "Test"));
+  EXPECT_EQ(4, pool->thread_count());
+
+  EXPECT_EQ(pool->GetTaskRunner(1), pool->GetTaskRunner(5));
+  EXPECT_NE(pool->GetTaskRunner(1), pool->GetTaskRunner(2));
+  EXPECT_NE(pool->GetTaskRunner(1), pool->GetHighPriorityTaskRunner(1));
+
+  // Both runners of a hash run their tasks on the same thread.
+  bool runs_tasks = false;
+  pool->GetHighPriorityTaskRunner(1)->PostTask(
+      FROM_HERE, base::Bind(&RecordThread,
+                            base::Unretained(pool->GetTaskRunner(5)),
+                            &runs_tasks));
+  Flush(pool->GetTaskRunner(1));
+  EXPECT_TRUE(runs_tasks);
+
+  pool->GetTaskRunner(1)->PostTask(
+      FROM_HERE, base::Bind(&RecordThread,
+                            base::Unretained(pool->GetTaskRunner(2)),
+                            &runs_tasks));
+  Flush(pool->GetTaskRunner(1));
+  EXPECT_FALSE(runs_tasks);
+  EXPECT_FALSE(pool->GetTaskRunner(1)->RunsTasksOnCurrentThread());
+
+  pool->Shutdown();
+}
+
+TEST(SimpleWorkerPoolTest, HighPriorityTasksRunFirst) {
+  scoped_refptr<SimpleWorkerPool> pool(new SimpleWorkerPool(2, "Test"));
+  base::TaskRunner* task_runner = pool->GetTaskRunner(0);
+  base::TaskRunner* high_priority_task_runner =
+      pool->GetHighPriorityTaskRunner(0);
+
+  // Keep the thread busy while the tasks are queued.
+  base::WaitableEvent release(false, false);
+  task_runner->PostTask(FROM_HERE, base::Bind(&Wait, &release));
+
+  TaskRecorder recorder;
+  for (int i = 0; i < 3; ++i) {
+    task_runner->PostTask(FROM_HERE, base::Bind(
+        &TaskRecorder::Record, base::Unretained(&recorder), i));
+  }
+  for (int i = 10; i < 12; ++i) {
+    high_priority_task_runner->PostTask(FROM_HERE, base::Bind(
+        &TaskRecorder::Record, base::Unretained(&recorder), i));
+  }
+  // Tasks on another thread are not held up.
+  base::WaitableEvent other_thread_done(false, false);
+  pool->GetTaskRunner(1)->PostTask(FROM_HERE,
+                                   base::Bind(&Signal, &other_thread_done));
+  other_thread_done.Wait();
+
+  release.Signal();
+  Flush(task_runner);
+
+  std::vector<int> tasks = recorder.tasks();
+  ASSERT_EQ(5U, tasks.size());
+  EXPECT_EQ(10, tasks[0]);
+  EXPECT_EQ(11, tasks[1]);
+  EXPECT_EQ(0, tasks[2]);
+  EXPECT_EQ(1, tasks[3]);
+  EXPECT_EQ(2, tasks[4]);
+
+  pool->Shutdown();
+}
+
+TEST(SimpleWorkerPoolTest, DelayedTask) {
+  scoped_refptr<SimpleWorkerPool> pool(new SimpleWorkerPool(1, "Test"));
+  base::WaitableEvent done(false, false);
+  EXPECT_TRUE(pool->GetTaskRunner(0)->PostDelayedTask(
+      FROM_HERE, base::Bind(&Signal, &done),
+      base::TimeDelta::FromMilliseconds(10)));
+  done.Wait();
+
+  pool->Shutdown();
+  EXPECT_FALSE(pool->GetTaskRunner(0)->PostTask(FROM_HERE,
+                                                base::Bind(&base::DoNothing)));
+}
+
+}  // namespace disk_cache
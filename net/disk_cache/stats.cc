@@ -61,7 +61,9 @@ static const char* kCounterNames[] = {
   "Last report",
   "Last report timer",
   "Doom recent entries",
-  "unused"
+  "unused",
+  "Prefetch hit",
+  "Prefetch unused"
 };
 COMPILE_ASSERT(arraysize(kCounterNames) == disk_cache::Stats::MAX_COUNTER,
                update_the_names);
@@ -48,6 +48,8 @@ class Stats {
     LAST_REPORT_TIMER,  // Timer count of the last time we sent a report.
     DOOM_RECENT,  // The cache was partially cleared.
     UNUSED,  // Was: ga.js was evicted from the cache.
+    PREFETCH_HIT,  // A read was served from the data prefetched at startup.
+    PREFETCH_UNUSED,  // Data prefetched at startup was never read.
     MAX_COUNTER
   };
 
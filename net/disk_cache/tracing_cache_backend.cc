@@ -34,6 +34,7 @@ class EntryProxy : public Entry, public base::RefCountedThreadSafe<EntryProxy> {
   virtual bool CouldBeSparse() const OVERRIDE;
   virtual void CancelSparseIO() OVERRIDE;
   virtual int ReadyForSparseIO(const CompletionCallback& callback) OVERRIDE;
+  virtual void SetPriority(net::RequestPriority priority) OVERRIDE;
 
  private:
   friend class base::RefCountedThreadSafe<EntryProxy>;
@@ -64,12 +65,17 @@ EntryProxy::EntryProxy(Entry *entry, TracingCacheBackend* backend)
 }
 
 void EntryProxy::Doom() {
-  // TODO(pasko): Record the event.
+  base::TimeTicks start_time = base::TimeTicks::Now();
   entry_->Doom();
+  RwOpExtra extra = {0, 0, 0, false};
+  RecordEvent(start_time, TracingCacheBackend::OP_DOOM_ENTRY, extra, net::OK);
 }
 
 void EntryProxy::Close() {
-  // TODO(pasko): Record the event.
+  // The entry may go away with the last reference.
+  RwOpExtra extra = {0, 0, 0, false};
+  RecordEvent(base::TimeTicks::Now(), TracingCacheBackend::OP_CLOSE, extra,
+              net::OK);
   entry_->Close();
   Release();
 }
@@ -156,9 +162,17 @@ int EntryProxy::ReadyForSparseIO(const CompletionCallback& callback) {
   return entry_->ReadyForSparseIO(callback);
 }
 
+void EntryProxy::SetPriority(net::RequestPriority priority) {
+  entry_->SetPriority(priority);
+}
+
 void EntryProxy::RecordEvent(base::TimeTicks start_time, Operation op,
                              RwOpExtra extra, int result_to_record) {
-  // TODO(pasko): Implement.
+  if (!backend_.get())
+    return;
+  backend_->AddTraceEvent(start_time, op, entry_->GetKey(), extra.index,
+                          extra.offset, extra.buf_len, extra.truncate,
+                          result_to_record);
 }
 
 void EntryProxy::EntryOpComplete(base::TimeTicks start_time, Operation op,
@@ -177,7 +191,8 @@ EntryProxy::~EntryProxy() {
 }
 
 TracingCacheBackend::TracingCacheBackend(scoped_ptr<Backend> backend)
-  : backend_(backend.Pass()) {
+  : backend_(backend.Pass()),
+    trace_(NULL) {
 }
 
 TracingCacheBackend::~TracingCacheBackend() {
@@ -193,7 +208,46 @@ int32 TracingCacheBackend::GetEntryCount() const {
 
 void TracingCacheBackend::RecordEvent(base::TimeTicks start_time, Operation op,
                                       std::string key, Entry* entry, int rv) {
-  // TODO(pasko): Implement.
+  AddTraceEvent(start_time, op, key, 0, 0, 0, false, rv);
+}
+
+void TracingCacheBackend::AddTraceEvent(base::TimeTicks start_time,
+                                        Operation op, const std::string& key,
+                                        int index, int offset, int buf_len,
+                                        bool truncate, int result) {
+  if (!trace_)
+    return;
+
+  CacheTraceEvent event;
+  switch (op) {
+    case OP_OPEN:
+      event.type = CacheTraceEvent::OPEN;
+      break;
+    case OP_CREATE:
+      event.type = CacheTraceEvent::CREATE;
+      break;
+    case OP_DOOM_ENTRY:
+      event.type = CacheTraceEvent::DOOM_ENTRY;
+      break;
+    case OP_READ:
+      event.type = CacheTraceEvent::READ;
+      break;
+    case OP_WRITE:
+      event.type = CacheTraceEvent::WRITE;
+      break;
+    case OP_CLOSE:
+      event.type = CacheTraceEvent::CLOSE;
+      break;
+  }
+  event.time = start_time - trace_->start_time();
+  event.latency = base::TimeTicks::Now() - start_time;
+  event.key = key;
+  event.index = index;
+  event.offset = offset;
+  event.buf_len = buf_len;
+  event.truncate = truncate;
+  event.result = result;
+  trace_->AddEvent(event);
 }
 
 EntryProxy* TracingCacheBackend::FindOrCreateEntryProxy(Entry* entry) {
@@ -223,9 +277,11 @@ void TracingCacheBackend::BackendOpComplete(base::TimeTicks start_time,
                                             Entry** entry,
                                             const CompletionCallback& callback,
                                             int result) {
-  RecordEvent(start_time, op, key, *entry, result);
-  if (*entry) {
-    *entry = FindOrCreateEntryProxy(*entry);
+  // DoomEntry() has no entry to hand back.
+  Entry* result_entry = entry ? *entry : NULL;
+  RecordEvent(start_time, op, key, result_entry, result);
+  if (result_entry) {
+    *entry = FindOrCreateEntryProxy(result_entry);
   }
   if (!callback.is_null()) {
     callback.Run(result);
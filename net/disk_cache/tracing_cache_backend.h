@@ -6,6 +6,7 @@
 #define NET_DISK_CACHE_TRACING_CACHE_BACKEND_H_
 
 #include "base/memory/weak_ptr.h"
+#include "net/disk_cache/cache_trace.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/disk_cache/stats.h"
 
@@ -21,6 +22,10 @@ class NET_EXPORT TracingCacheBackend : public Backend,
  public:
   explicit TracingCacheBackend(scoped_ptr<Backend> backend);
 
+  // Records every operation from now on to |trace|, which must outlive this
+  // object unless tracing is stopped by passing NULL.
+  void set_trace(CacheTrace* trace) { trace_ = trace; }
+
   virtual net::CacheType GetCacheType() const OVERRIDE;
   virtual int32 GetEntryCount() const OVERRIDE;
   virtual int OpenEntry(const std::string& key, Entry** entry,
@@ -48,7 +53,8 @@ class NET_EXPORT TracingCacheBackend : public Backend,
     OP_CREATE,
     OP_DOOM_ENTRY,
     OP_READ,
-    OP_WRITE
+    OP_WRITE,
+    OP_CLOSE
   };
 
   virtual ~TracingCacheBackend();
@@ -60,6 +66,12 @@ class NET_EXPORT TracingCacheBackend : public Backend,
   void RecordEvent(base::TimeTicks start_time, Operation op, std::string key,
                    Entry* entry, int result);
 
+  // Adds an operation that started at |start_time| and just completed to
+  // |trace_|, if there is one.
+  void AddTraceEvent(base::TimeTicks start_time, Operation op,
+                     const std::string& key, int index, int offset,
+                     int buf_len, bool truncate, int result);
+
   void BackendOpComplete(base::TimeTicks start_time, Operation op,
                          std::string key, Entry** entry,
                          const CompletionCallback& callback, int result);
@@ -72,6 +84,7 @@ class NET_EXPORT TracingCacheBackend : public Backend,
   scoped_ptr<Backend> backend_;
   typedef std::map<Entry*, EntryProxy*> EntryToProxyMap;
   EntryToProxyMap open_entries_;
+  CacheTrace* trace_;
 
   DISALLOW_COPY_AND_ASSIGN(TracingCacheBackend);
 };
@@ -693,6 +693,10 @@ int EntryImpl::ReadyForSparseIO(const CompletionCallback& callback) {
   return net::ERR_IO_PENDING;
 }
 
+void EntryImpl::SetPriority(net::RequestPriority priority) {
+  // All the operations run in order on the cache thread.
+}
+
 int EntryImpl::ReadyForSparseIOImpl(const CompletionCallback& callback) {
   DCHECK(sparse_.get());
   return sparse_->ReadyToUse(callback);
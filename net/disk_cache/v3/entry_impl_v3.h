@@ -111,6 +111,7 @@ class NET_EXPORT_PRIVATE EntryImpl
   virtual bool CouldBeSparse() const OVERRIDE;
   virtual void CancelSparseIO() OVERRIDE;
   virtual int ReadyForSparseIO(const CompletionCallback& callback) OVERRIDE;
+  virtual void SetPriority(net::RequestPriority priority) OVERRIDE;
 
  private:
   enum {
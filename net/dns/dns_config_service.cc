@@ -20,7 +20,8 @@ DnsConfig::DnsConfig()
       timeout(base::TimeDelta::FromSeconds(kDnsTimeoutSeconds)),
       attempts(2),
       rotate(false),
-      edns0(false) {}
+      edns0(false),
+      race_nameservers(false) {}
 
 DnsConfig::~DnsConfig() {}
 
@@ -36,7 +37,8 @@ bool DnsConfig::EqualsIgnoreHosts(const DnsConfig& d) const {
          (timeout == d.timeout) &&
          (attempts == d.attempts) &&
          (rotate == d.rotate) &&
-         (edns0 == d.edns0);
+         (edns0 == d.edns0) &&
+         (race_nameservers == d.race_nameservers);
 }
 
 void DnsConfig::CopyIgnoreHosts(const DnsConfig& d) {
@@ -48,6 +50,7 @@ void DnsConfig::CopyIgnoreHosts(const DnsConfig& d) {
   attempts = d.attempts;
   rotate = d.rotate;
   edns0 = d.edns0;
+  race_nameservers = d.race_nameservers;
 }
 
 base::Value* DnsConfig::ToValue() const {
@@ -69,6 +72,7 @@ base::Value* DnsConfig::ToValue() const {
   dict->SetInteger("attempts", attempts);
   dict->SetBoolean("rotate", rotate);
   dict->SetBoolean("edns0", edns0);
+  dict->SetBoolean("race_nameservers", race_nameservers);
   dict->SetInteger("num_hosts", hosts.size());
 
   return dict;
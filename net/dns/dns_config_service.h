@@ -79,6 +79,11 @@ struct NET_EXPORT_PRIVATE DnsConfig {
   bool rotate;
   // Enable EDNS0 extensions.
   bool edns0;
+
+  // Not read from the system. Send the first attempt of each query to two
+  // servers at once, starting with the one with the lowest observed RTT, and
+  // use the first good answer.
+  bool race_nameservers;
 };
 
 
@@ -103,6 +103,8 @@ DnsSession::~DnsSession() {
 int DnsSession::NextQueryId() const { return rand_callback_.Run(); }
 
 unsigned DnsSession::NextFirstServerIndex() {
+  if (config_.race_nameservers && !config_.rotate)
+    return FastestGoodServerIndex();
   unsigned index = NextGoodServerIndex(server_index_);
   if (config_.rotate)
     server_index_ = (server_index_ + 1) % config_.nameservers.size();
@@ -137,6 +139,22 @@ unsigned DnsSession::NextGoodServerIndex(unsigned server_index) {
   return oldest_server_failure_index;
 }
 
+unsigned DnsSession::FastestGoodServerIndex() {
+  unsigned fastest_index = server_stats_.size();
+  for (unsigned index = 0; index < server_stats_.size(); ++index) {
+    if (server_stats_[index]->last_failure_count >= config_.attempts)
+      continue;
+    if (fastest_index == server_stats_.size() ||
+        server_stats_[index]->rtt_estimate <
+            server_stats_[fastest_index]->rtt_estimate) {
+      fastest_index = index;
+    }
+  }
+  if (fastest_index == server_stats_.size())
+    return NextGoodServerIndex(server_index_);
+  return fastest_index;
+}
+
 void DnsSession::RecordServerFailure(unsigned server_index) {
   UMA_HISTOGRAM_CUSTOM_COUNTS(
       "AsyncDNS.ServerFailureIndex", server_index, 0, 10, 10);
@@ -186,6 +204,11 @@ void DnsSession::RecordRTT(unsigned server_index, base::TimeDelta rtt) {
       ->Accumulate(rtt.InMilliseconds(), 1);
 }
 
+base::TimeDelta DnsSession::GetRTTEstimate(unsigned server_index) const {
+  DCHECK_LT(server_index, server_stats_.size());
+  return server_stats_[server_index]->rtt_estimate;
+}
+
 void DnsSession::RecordLostPacket(unsigned server_index, int attempt) {
   base::TimeDelta timeout_jacobson =
       NextTimeoutFromJacobson(server_index, attempt);
@@ -69,6 +69,8 @@ class NET_EXPORT_PRIVATE DnsSession
   int NextQueryId() const;
 
   // Return the index of the first configured server to use on first attempt.
+  // With |config_.race_nameservers| and without |config_.rotate|, this is the
+  // good server with the lowest estimated RTT.
   unsigned NextFirstServerIndex();
 
   // Start with |server_index| and find the index of the next known good server
@@ -86,6 +88,10 @@ class NET_EXPORT_PRIVATE DnsSession
   // Record how long it took to receive a response from the server.
   void RecordRTT(unsigned server_index, base::TimeDelta rtt);
 
+  // Return the current estimate of the RTT of the server, which is the
+  // configured timeout until a response has been received.
+  base::TimeDelta GetRTTEstimate(unsigned server_index) const;
+
   // Record suspected loss of a packet for a specific server.
   void RecordLostPacket(unsigned server_index, int attempt);
 
@@ -110,6 +116,11 @@ class NET_EXPORT_PRIVATE DnsSession
   friend class base::RefCounted<DnsSession>;
   ~DnsSession();
 
+  // Return the index of the server with the lowest estimated RTT among those
+  // that have not failed |config_.attempts| times in a row, or the next good
+  // server if they all have.
+  unsigned FastestGoodServerIndex();
+
   // Release a socket.
   void FreeSocket(unsigned server_index,
                   scoped_ptr<DatagramClientSocket> socket);
@@ -243,6 +243,30 @@ TEST_F(DnsSessionTest, HistogramTimeoutLong) {
   EXPECT_EQ(config_.timeout.InMilliseconds(), timeout.InMilliseconds());
 }
 
+TEST_F(DnsSessionTest, FirstServerIgnoresRTTByDefault) {
+  Initialize(3);
+  session_->RecordRTT(2, base::TimeDelta::FromMilliseconds(10));
+  EXPECT_EQ(0u, session_->NextFirstServerIndex());
+}
+
+TEST_F(DnsSessionTest, RaceNameserversPrefersFastestServer) {
+  config_.race_nameservers = true;
+  Initialize(3);
+  EXPECT_EQ(0u, session_->NextFirstServerIndex());
+
+  session_->RecordRTT(2, base::TimeDelta::FromMilliseconds(10));
+  EXPECT_LT(session_->GetRTTEstimate(2), session_->GetRTTEstimate(0));
+  EXPECT_EQ(2u, session_->NextFirstServerIndex());
+  EXPECT_EQ(2u, session_->NextFirstServerIndex());
+
+  // A server which failed every allowed attempt is skipped until it succeeds.
+  for (int i = 0; i < config_.attempts; ++i)
+    session_->RecordServerFailure(2);
+  EXPECT_EQ(0u, session_->NextFirstServerIndex());
+  session_->RecordServerSuccess(2);
+  EXPECT_EQ(2u, session_->NextFirstServerIndex());
+}
+
 }  // namespace
 
 } // namespace net
@@ -512,7 +512,9 @@ class DnsTCPAttempt : public DnsAttempt {
 // The timeout for each DnsUDPAttempt is given by DnsSession::NextTimeout.
 // The first server to attempt on each query is given by
 // DnsSession::NextFirstServerIndex, and the order is round-robin afterwards.
-// Each server is attempted DnsConfig::attempts times.
+// Each server is attempted DnsConfig::attempts times. With
+// DnsConfig::race_nameservers, the first attempt is immediately followed by
+// one to the next server, and the first good answer from either is used.
 class DnsTransactionImpl : public DnsTransaction,
                            public base::NonThreadSafe,
                            public base::SupportsWeakPtr<DnsTransactionImpl> {
@@ -762,7 +764,14 @@ class DnsTransactionImpl : public DnsTransaction,
     RecordLostPacketsIfAny();
     attempts_.clear();
     had_tcp_attempt_ = false;
-    return MakeAttempt();
+    AttemptResult result = MakeAttempt();
+    if (result.rv == ERR_IO_PENDING && session_->config().race_nameservers &&
+        session_->config().nameservers.size() > 1 && MoreAttemptsAllowed()) {
+      // Don't wait for the retransmission timeout before asking the next
+      // server. An answer to the first attempt is still accepted.
+      result = MakeAttempt();
+    }
+    return result;
   }
 
   void OnUdpAttemptComplete(unsigned attempt_number,
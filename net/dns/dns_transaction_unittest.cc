@@ -658,6 +658,48 @@ TEST_F(DnsTransactionTest, ServerFallbackAndRotate) {
   CheckServerOrder(kOrder, arraysize(kOrder));
 }
 
+TEST_F(DnsTransactionTest, RaceNameservers) {
+  config_.race_nameservers = true;
+  ConfigureNumServers(3);
+  ConfigureFactory();
+
+  // The first two servers are asked at once and the second one answers.
+  AddQueryAndTimeout(kT0HostName, kT0Qtype);
+  AddAsyncQueryAndResponse(0 /* id */, kT0HostName, kT0Qtype,
+                           kT0ResponseDatagram, arraysize(kT0ResponseDatagram));
+  // The next transaction starts with the server which answered.
+  AddAsyncQueryAndResponse(1 /* id */, kT1HostName, kT1Qtype,
+                           kT1ResponseDatagram, arraysize(kT1ResponseDatagram));
+  AddQueryAndTimeout(kT1HostName, kT1Qtype);
+
+  TransactionHelper helper0(kT0HostName, kT0Qtype, kT0RecordCount);
+  EXPECT_TRUE(helper0.Run(transaction_factory_.get()));
+  TransactionHelper helper1(kT1HostName, kT1Qtype, kT1RecordCount);
+  EXPECT_TRUE(helper1.Run(transaction_factory_.get()));
+
+  unsigned kOrder[] = {
+      0, 1,  // The first transaction.
+      1, 2,  // The second transaction.
+  };
+  CheckServerOrder(kOrder, arraysize(kOrder));
+}
+
+TEST_F(DnsTransactionTest, RaceNameserversFirstAnswerWins) {
+  config_.race_nameservers = true;
+  ConfigureNumServers(2);
+  ConfigureFactory();
+
+  AddAsyncQueryAndResponse(0 /* id */, kT0HostName, kT0Qtype,
+                           kT0ResponseDatagram, arraysize(kT0ResponseDatagram));
+  AddQueryAndTimeout(kT0HostName, kT0Qtype);
+
+  TransactionHelper helper0(kT0HostName, kT0Qtype, kT0RecordCount);
+  EXPECT_TRUE(helper0.Run(transaction_factory_.get()));
+
+  unsigned kOrder[] = { 0, 1 };
+  CheckServerOrder(kOrder, arraysize(kOrder));
+}
+
 TEST_F(DnsTransactionTest, SuffixSearchAboveNdots) {
   config_.ndots = 2;
   config_.search.push_back("a");
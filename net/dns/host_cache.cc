@@ -8,10 +8,24 @@
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/values.h"
 #include "net/base/net_errors.h"
+#include "net/base/net_util.h"
 
 namespace net {
 
+namespace {
+
+// Keys of the dictionaries made by HostCache::GetAsListValue().
+const char kHostnameKey[] = "hostname";
+const char kAddressFamilyKey[] = "address_family";
+const char kFlagsKey[] = "flags";
+const char kExpirationKey[] = "expiration";
+const char kCanonicalNameKey[] = "canonical_name";
+const char kAddressesKey[] = "addresses";
+
+}  // namespace
+
 //-----------------------------------------------------------------------------
 
 HostCache::Entry::Entry(int error, const AddressList& addrlist,
@@ -49,6 +63,20 @@ const HostCache::Entry* HostCache::Lookup(const Key& key,
   return entries_.Get(key, now);
 }
 
+const HostCache::Entry* HostCache::LookupStale(const Key& key,
+                                               base::TimeTicks now,
+                                               base::TimeDelta* staleness) {
+  DCHECK(CalledOnValidThread());
+  if (caching_is_disabled())
+    return NULL;
+
+  base::TimeTicks expiration;
+  const Entry* entry = entries_.Peek(key, &expiration);
+  if (entry)
+    *staleness = now - expiration;
+  return entry;
+}
+
 void HostCache::Set(const Key& key,
                     const Entry& entry,
                     base::TimeTicks now,
@@ -81,6 +109,99 @@ const HostCache::EntryMap& HostCache::entries() const {
   return entries_;
 }
 
+void HostCache::GetAsListValue(base::ListValue* entry_list) const {
+  DCHECK(CalledOnValidThread());
+  // The expiration times are saved as wall clock times, since TimeTicks do
+  // not survive a restart.
+  base::TimeTicks now_ticks = base::TimeTicks::Now();
+  base::Time now = base::Time::Now();
+  for (EntryMap::Iterator it(entries_); it.HasNext(); it.Advance()) {
+    const Entry& entry = it.value();
+    if (entry.error != OK || entry.addrlist.empty())
+      continue;
+
+    base::ListValue* addresses = new base::ListValue();
+    for (size_t i = 0; i < entry.addrlist.size(); ++i) {
+      addresses->AppendString(
+          IPAddressToString(entry.addrlist[i].address()));
+    }
+    base::Time expiration = now + (it.expiration() - now_ticks);
+
+    base::DictionaryValue* entry_dict = new base::DictionaryValue();
+    entry_dict->SetString(kHostnameKey, it.key().hostname);
+    entry_dict->SetInteger(kAddressFamilyKey, it.key().address_family);
+    entry_dict->SetInteger(kFlagsKey, it.key().host_resolver_flags);
+    entry_dict->SetString(kExpirationKey,
+                          base::Int64ToString(expiration.ToInternalValue()));
+    if (!entry.addrlist.canonical_name().empty()) {
+      entry_dict->SetString(kCanonicalNameKey,
+                            entry.addrlist.canonical_name());
+    }
+    entry_dict->Set(kAddressesKey, addresses);
+    entry_list->Append(entry_dict);
+  }
+}
+
+bool HostCache::RestoreFromListValue(const base::ListValue& entry_list) {
+  DCHECK(CalledOnValidThread());
+  if (caching_is_disabled())
+    return true;
+
+  base::TimeTicks now_ticks = base::TimeTicks::Now();
+  base::Time now = base::Time::Now();
+  bool all_valid = true;
+  for (size_t i = 0; i < entry_list.GetSize(); ++i) {
+    const base::DictionaryValue* entry_dict = NULL;
+    std::string hostname;
+    int address_family = 0;
+    int flags = 0;
+    std::string expiration_string;
+    int64 expiration_value = 0;
+    const base::ListValue* addresses = NULL;
+    if (!entry_list.GetDictionary(i, &entry_dict) ||
+        !entry_dict->GetString(kHostnameKey, &hostname) ||
+        !entry_dict->GetInteger(kAddressFamilyKey, &address_family) ||
+        address_family < ADDRESS_FAMILY_UNSPECIFIED ||
+        address_family > ADDRESS_FAMILY_IPV6 ||
+        !entry_dict->GetInteger(kFlagsKey, &flags) ||
+        !entry_dict->GetString(kExpirationKey, &expiration_string) ||
+        !base::StringToInt64(expiration_string, &expiration_value) ||
+        !entry_dict->GetList(kAddressesKey, &addresses)) {
+      all_valid = false;
+      continue;
+    }
+
+    AddressList addrlist;
+    for (size_t j = 0; j < addresses->GetSize(); ++j) {
+      std::string address_string;
+      IPAddressNumber address;
+      if (!addresses->GetString(j, &address_string) ||
+          !ParseIPLiteralToNumber(address_string, &address)) {
+        addrlist.clear();
+        break;
+      }
+      addrlist.push_back(IPEndPoint(address, 0));
+    }
+    if (addrlist.empty()) {
+      all_valid = false;
+      continue;
+    }
+    std::string canonical_name;
+    if (entry_dict->GetString(kCanonicalNameKey, &canonical_name))
+      addrlist.set_canonical_name(canonical_name);
+
+    Key key(hostname, static_cast<AddressFamily>(address_family), flags);
+    base::TimeTicks expiration_unused;
+    if (entries_.Peek(key, &expiration_unused))
+      continue;
+
+    base::Time expiration = base::Time::FromInternalValue(expiration_value);
+    entries_.Put(key, Entry(OK, addrlist), now_ticks,
+                 now_ticks + (expiration - now));
+  }
+  return all_valid;
+}
+
 // static
 scoped_ptr<HostCache> HostCache::CreateDefaultCache() {
   // Cache capacity is determined by the field trial.
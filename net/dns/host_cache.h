@@ -17,6 +17,10 @@
 #include "net/base/expiring_cache.h"
 #include "net/base/net_export.h"
 
+namespace base {
+class ListValue;
+}
+
 namespace net {
 
 // Cache used by HostResolver to map hostnames to their resolved result.
@@ -82,6 +86,14 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
   // |now|. If there is no such entry, returns NULL.
   const Entry* Lookup(const Key& key, base::TimeTicks now);
 
+  // Returns a pointer to the entry for |key|, even if it has expired, and sets
+  // |staleness| to how long ago it expired, which is negative if it is still
+  // valid at time |now|. Unlike Lookup(), expired entries are not removed. If
+  // there is no such entry, returns NULL.
+  const Entry* LookupStale(const Key& key,
+                           base::TimeTicks now,
+                           base::TimeDelta* staleness);
+
   // Overwrites or creates an entry for |key|.
   // |entry| is the value to set, |now| is the current time
   // |ttl| is the "time to live".
@@ -101,6 +113,17 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
 
   const EntryMap& entries() const;
 
+  // Appends the successful resolutions in the cache, including expired ones,
+  // to |entry_list| in a form that can be saved and later passed to
+  // RestoreFromListValue(), possibly after a restart.
+  void GetAsListValue(base::ListValue* entry_list) const;
+
+  // Adds the entries from a list made by GetAsListValue(), keeping their
+  // expiration times. Keys the cache already has an entry for are skipped,
+  // since that entry is newer. Returns false if |entry_list| is malformed, in
+  // which case the valid entries are still added.
+  bool RestoreFromListValue(const base::ListValue& entry_list);
+
   // Creates a default cache.
   static scoped_ptr<HostCache> CreateDefaultCache();
 
@@ -8,7 +8,9 @@
 #include "base/stl_util.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
+#include "base/values.h"
 #include "net/base/net_errors.h"
+#include "net/base/net_util.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace net {
@@ -296,6 +298,103 @@ TEST(HostCacheTest, Clear) {
   EXPECT_EQ(0u, cache.size());
 }
 
+TEST(HostCacheTest, LookupStale) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+
+  HostCache cache(kMaxCacheEntries);
+
+  // Set t=0.
+  base::TimeTicks now;
+  base::TimeDelta staleness;
+
+  HostCache::Entry entry = HostCache::Entry(OK, AddressList());
+
+  EXPECT_FALSE(cache.LookupStale(Key("foobar.com"), now, &staleness));
+  cache.Set(Key("foobar.com"), entry, now, kTTL);
+  EXPECT_TRUE(cache.LookupStale(Key("foobar.com"), now, &staleness));
+  EXPECT_EQ(-kTTL, staleness);
+
+  // Advance to t=15; the entry expired 5 seconds ago, but is kept.
+  now += base::TimeDelta::FromSeconds(15);
+  EXPECT_TRUE(cache.LookupStale(Key("foobar.com"), now, &staleness));
+  EXPECT_EQ(base::TimeDelta::FromSeconds(5), staleness);
+  EXPECT_EQ(1u, cache.size());
+
+  // Lookup() removes it.
+  EXPECT_FALSE(cache.Lookup(Key("foobar.com"), now));
+  EXPECT_FALSE(cache.LookupStale(Key("foobar.com"), now, &staleness));
+}
+
+TEST(HostCacheTest, SerializeAndRestore) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+
+  HostCache cache(kMaxCacheEntries);
+  base::TimeTicks now = base::TimeTicks::Now();
+
+  IPAddressNumber address_ipv4;
+  ASSERT_TRUE(ParseIPLiteralToNumber("192.168.1.1", &address_ipv4));
+  IPAddressNumber address_ipv6;
+  ASSERT_TRUE(ParseIPLiteralToNumber("2001:db8::1", &address_ipv6));
+  AddressList addresses;
+  addresses.push_back(IPEndPoint(address_ipv4, 80));
+  addresses.push_back(IPEndPoint(address_ipv6, 80));
+  addresses.set_canonical_name("canonical.foobar.com");
+
+  cache.Set(Key("foobar.com"), HostCache::Entry(OK, addresses), now, kTTL);
+  // Expired entries are saved too.
+  cache.Set(Key("expired.com"), HostCache::Entry(OK, addresses),
+            now - 2 * kTTL, kTTL);
+  // Failures are not.
+  cache.Set(Key("failed.com"),
+            HostCache::Entry(ERR_NAME_NOT_RESOLVED, AddressList()), now, kTTL);
+
+  base::ListValue serialized;
+  cache.GetAsListValue(&serialized);
+  EXPECT_EQ(2u, serialized.GetSize());
+
+  HostCache restored_cache(kMaxCacheEntries);
+  // An existing entry is newer than the saved one.
+  HostCache::Entry newer_entry(OK, AddressList());
+  restored_cache.Set(Key("expired.com"), newer_entry, now, kTTL);
+
+  EXPECT_TRUE(restored_cache.RestoreFromListValue(serialized));
+  EXPECT_EQ(2u, restored_cache.size());
+
+  base::TimeDelta staleness;
+  const HostCache::Entry* entry =
+      restored_cache.LookupStale(Key("foobar.com"), now, &staleness);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(OK, entry->error);
+  ASSERT_EQ(2u, entry->addrlist.size());
+  EXPECT_EQ(address_ipv4, entry->addrlist[0].address());
+  EXPECT_EQ(address_ipv6, entry->addrlist[1].address());
+  EXPECT_EQ("canonical.foobar.com", entry->addrlist.canonical_name());
+  // The expiration survives to within the resolution of the clocks.
+  EXPECT_TRUE(staleness > -kTTL - base::TimeDelta::FromSeconds(1));
+  EXPECT_TRUE(staleness < -kTTL + base::TimeDelta::FromSeconds(1));
+
+  entry = restored_cache.LookupStale(Key("expired.com"), now, &staleness);
+  ASSERT_TRUE(entry);
+  EXPECT_TRUE(entry->addrlist.empty());
+  EXPECT_FALSE(restored_cache.LookupStale(Key("failed.com"), now, &staleness));
+}
+
+TEST(HostCacheTest, RestoreMalformed) {
+  HostCache cache(kMaxCacheEntries);
+
+  base::ListValue serialized;
+  serialized.AppendString("foobar.com");
+  base::DictionaryValue* no_addresses = new base::DictionaryValue();
+  no_addresses->SetString("hostname", "foobar.com");
+  no_addresses->SetInteger("address_family", ADDRESS_FAMILY_UNSPECIFIED);
+  no_addresses->SetInteger("flags", 0);
+  no_addresses->SetString("expiration", "0");
+  serialized.Append(no_addresses);
+
+  EXPECT_FALSE(cache.RestoreFromListValue(serialized));
+  EXPECT_EQ(0u, cache.size());
+}
+
 // Tests the less than and equal operators for HostCache::Key work.
 TEST(HostCacheTest, KeyComparators) {
   struct {
@@ -11,6 +11,7 @@
 #endif
 
 #include <cmath>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -25,6 +26,7 @@
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
 #include "base/stl_util.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/worker_pool.h"
@@ -258,6 +260,14 @@ bool ConfigureAsyncDnsNoFallbackFieldTrial() {
   return kDefault;
 }
 
+// Races the first two nameservers in groups of the AsyncDnsRaceNameservers
+// field trial starting with "Race", see DnsConfig::race_nameservers.
+void ConfigureRaceNameserversFieldTrial(DnsConfig* dns_config) {
+  std::string group_name =
+      base::FieldTrialList::FindFullName("AsyncDnsRaceNameservers");
+  dns_config->race_nameservers = StartsWithASCII(group_name, "Race", false);
+}
+
 //-----------------------------------------------------------------------------
 
 AddressList EnsurePortOnAddressList(const AddressList& list, uint16 port) {
@@ -266,6 +276,18 @@ AddressList EnsurePortOnAddressList(const AddressList& list, uint16 port) {
   return AddressList::CopyWithPort(list, port);
 }
 
+// Returns true if |a| and |b| have the same IP addresses, ignoring ports and
+// order.
+bool HaveSameAddresses(const AddressList& a, const AddressList& b) {
+  std::set<IPAddressNumber> a_addresses;
+  for (size_t i = 0; i < a.size(); ++i)
+    a_addresses.insert(a[i].address());
+  std::set<IPAddressNumber> b_addresses;
+  for (size_t i = 0; i < b.size(); ++i)
+    b_addresses.insert(b[i].address());
+  return a_addresses == b_addresses;
+}
+
 // Returns true if |addresses| contains only IPv4 loopback addresses.
 bool IsAllIPv4Loopback(const AddressList& addresses) {
   for (unsigned i = 0; i < addresses.size(); ++i) {
@@ -1252,7 +1274,8 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
                    req->request_net_log().source(),
                    priority()));
 
-    if (num_active_requests() > 0) {
+    if (num_active_requests() > 0 || is_stale_refresh()) {
+      // A refresh of a stale cache entry keeps running without Requests.
       UpdatePriority();
     } else {
       // If we were called from a Request's callback within CompleteRequests,
@@ -1312,6 +1335,17 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
     return key_;
   }
 
+  // Makes this Job a background refresh of the expired |entry|, which was
+  // served from the cache. The result is cached even if no Request is
+  // attached.
+  void set_stale_entry(const HostCache::Entry& entry) {
+    stale_entry_.reset(new HostCache::Entry(entry));
+  }
+
+  bool is_stale_refresh() const {
+    return stale_entry_.get() != NULL;
+  }
+
   bool is_queued() const {
     return !handle_.is_null();
   }
@@ -1546,7 +1580,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
       handle_.Reset();
     }
 
-    if (num_active_requests() == 0) {
+    if (num_active_requests() == 0 && !is_stale_refresh()) {
       net_log_.AddEvent(NetLog::TYPE_CANCELLED);
       net_log_.EndEventWithNetErrorCode(NetLog::TYPE_HOST_RESOLVER_IMPL_JOB,
                                         OK);
@@ -1556,7 +1590,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
     net_log_.EndEventWithNetErrorCode(NetLog::TYPE_HOST_RESOLVER_IMPL_JOB,
                                       entry.error);
 
-    DCHECK(!requests_.empty());
+    DCHECK(!requests_.empty() || is_stale_refresh());
 
     if (entry.error == OK) {
       // Record this histogram here, when we know the system has a valid DNS
@@ -1567,8 +1601,11 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
 
     bool did_complete = (entry.error != ERR_NETWORK_CHANGED) &&
                         (entry.error != ERR_HOST_RESOLVER_QUEUE_TOO_LARGE);
-    if (did_complete)
+    if (did_complete) {
       resolver_->CacheResult(key_, entry, ttl);
+      if (is_stale_refresh())
+        resolver_->OnStaleEntryRefreshed(*stale_entry_, entry);
+    }
 
     // Complete all of the requests that were attached to the job.
     for (RequestsList::const_iterator it = requests_.begin();
@@ -1650,6 +1687,9 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
 
   // A handle used in |HostResolverImpl::dispatcher_|.
   PrioritizedDispatcher::Handle handle_;
+
+  // The expired cache entry this Job is refreshing, if any.
+  scoped_ptr<HostCache::Entry> stale_entry_;
 };
 
 //-----------------------------------------------------------------------------
@@ -1683,7 +1723,9 @@ HostResolverImpl::HostResolverImpl(
       probe_ipv6_support_(true),
       resolved_known_ipv6_hostname_(false),
       additional_resolver_flags_(0),
-      fallback_to_proctask_(true) {
+      fallback_to_proctask_(true),
+      num_stale_answers_(0),
+      num_wrong_stale_answers_(0) {
 
   DCHECK_GE(dispatcher_.num_priorities(), static_cast<size_t>(NUM_PRIORITIES));
 
@@ -1715,6 +1757,15 @@ HostResolverImpl::HostResolverImpl(
   }
 
   fallback_to_proctask_ = !ConfigureAsyncDnsNoFallbackFieldTrial();
+
+  // The group of this trial is the staleness limit in seconds.
+  int max_staleness_seconds = 0;
+  if (base::StringToInt(
+          base::FieldTrialList::FindFullName("HostCacheMaxStaleness"),
+          &max_staleness_seconds) &&
+      max_staleness_seconds > 0) {
+    max_staleness_ = base::TimeDelta::FromSeconds(max_staleness_seconds);
+  }
 }
 
 HostResolverImpl::~HostResolverImpl() {
@@ -1731,6 +1782,11 @@ void HostResolverImpl::SetMaxQueuedJobs(size_t value) {
   max_queued_jobs_ = value;
 }
 
+void HostResolverImpl::SetMaxStaleness(base::TimeDelta max_staleness) {
+  DCHECK(CalledOnValidThread());
+  max_staleness_ = max_staleness;
+}
+
 int HostResolverImpl::Resolve(const RequestInfo& info,
                               AddressList* addresses,
                               const CompletionCallback& callback,
@@ -1755,10 +1811,13 @@ int HostResolverImpl::Resolve(const RequestInfo& info,
   // outstanding jobs map.
   Key key = GetEffectiveKeyForRequest(info, request_net_log);
 
-  int rv = ResolveHelper(key, info, addresses, request_net_log);
+  bool served_stale = false;
+  int rv = ResolveHelper(key, info, addresses, request_net_log, &served_stale);
   if (rv != ERR_DNS_CACHE_MISS) {
     LogFinishRequest(source_net_log, request_net_log, info, rv);
     RecordTotalTime(HaveDnsConfig(), info.is_speculative(), base::TimeDelta());
+    if (served_stale)
+      StartStaleRefresh(key, request_net_log);
     return rv;
   }
 
@@ -1805,7 +1864,8 @@ int HostResolverImpl::Resolve(const RequestInfo& info,
 int HostResolverImpl::ResolveHelper(const Key& key,
                                     const RequestInfo& info,
                                     AddressList* addresses,
-                                    const BoundNetLog& request_net_log) {
+                                    const BoundNetLog& request_net_log,
+                                    bool* served_stale) {
   // The result of |getaddrinfo| for empty hosts is inconsistent across systems.
   // On Windows it gives the default interface's address, whereas on Linux it
   // gives an error. We will make it fail on all platforms for consistency.
@@ -1815,7 +1875,7 @@ int HostResolverImpl::ResolveHelper(const Key& key,
   int net_error = ERR_UNEXPECTED;
   if (ResolveAsIP(key, info, &net_error, addresses))
     return net_error;
-  if (ServeFromCache(key, info, &net_error, addresses)) {
+  if (ServeFromCache(key, info, &net_error, addresses, served_stale)) {
     request_net_log.AddEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_CACHE_HIT);
     return net_error;
   }
@@ -1843,7 +1903,7 @@ int HostResolverImpl::ResolveFromCache(const RequestInfo& info,
 
   Key key = GetEffectiveKeyForRequest(info, request_net_log);
 
-  int rv = ResolveHelper(key, info, addresses, request_net_log);
+  int rv = ResolveHelper(key, info, addresses, request_net_log, NULL);
   LogFinishRequest(source_net_log, request_net_log, info, rv);
   return rv;
 }
@@ -1926,14 +1986,29 @@ bool HostResolverImpl::ResolveAsIP(const Key& key,
 bool HostResolverImpl::ServeFromCache(const Key& key,
                                       const RequestInfo& info,
                                       int* net_error,
-                                      AddressList* addresses) {
+                                      AddressList* addresses,
+                                      bool* served_stale) {
   DCHECK(addresses);
   DCHECK(net_error);
   if (!info.allow_cached_response() || !cache_.get())
     return false;
 
-  const HostCache::Entry* cache_entry = cache_->Lookup(
-      key, base::TimeTicks::Now());
+  const HostCache::Entry* cache_entry = NULL;
+  if (max_staleness_ > base::TimeDelta()) {
+    // Keep expired entries around, they may be served to a later Request.
+    base::TimeDelta staleness;
+    cache_entry = cache_->LookupStale(key, base::TimeTicks::Now(), &staleness);
+    if (cache_entry && staleness >= base::TimeDelta()) {
+      if (!served_stale || staleness > max_staleness_ ||
+          cache_entry->error != OK) {
+        return false;
+      }
+      *served_stale = true;
+      ++num_stale_answers_;
+    }
+  } else {
+    cache_entry = cache_->Lookup(key, base::TimeTicks::Now());
+  }
   if (!cache_entry)
     return false;
 
@@ -2001,6 +2076,41 @@ void HostResolverImpl::CacheResult(const Key& key,
     cache_->Set(key, entry, base::TimeTicks::Now(), ttl);
 }
 
+void HostResolverImpl::StartStaleRefresh(const Key& key,
+                                         const BoundNetLog& request_net_log) {
+  // The entry may already be being refreshed.
+  if (jobs_.find(key) != jobs_.end())
+    return;
+
+  base::TimeDelta staleness;
+  const HostCache::Entry* stale_entry =
+      cache_->LookupStale(key, base::TimeTicks::Now(), &staleness);
+  DCHECK(stale_entry);
+
+  Job* job = new Job(weak_ptr_factory_.GetWeakPtr(), key, MINIMUM_PRIORITY,
+                     request_net_log);
+  job->set_stale_entry(*stale_entry);
+  job->Schedule();
+  jobs_.insert(std::make_pair(key, job));
+
+  // Check for queue overflow.
+  if (dispatcher_.num_queued_jobs() > max_queued_jobs_) {
+    Job* evicted = static_cast<Job*>(dispatcher_.EvictOldestLowest());
+    DCHECK(evicted);
+    evicted->OnEvicted();  // Deletes |evicted|.
+  }
+}
+
+void HostResolverImpl::OnStaleEntryRefreshed(
+    const HostCache::Entry& stale_entry,
+    const HostCache::Entry& entry) {
+  bool was_wrong = entry.error != OK ||
+                   !HaveSameAddresses(stale_entry.addrlist, entry.addrlist);
+  UMA_HISTOGRAM_BOOLEAN("DNS.StaleAnswerWasWrong", was_wrong);
+  if (was_wrong)
+    ++num_wrong_stale_answers_;
+}
+
 void HostResolverImpl::RemoveJob(Job* job) {
   DCHECK(job);
   JobMap::iterator it = jobs_.find(job->key());
@@ -2117,6 +2227,7 @@ void HostResolverImpl::OnIPAddressChanged() {
 void HostResolverImpl::OnDNSChanged() {
   DnsConfig dns_config;
   NetworkChangeNotifier::GetDnsConfig(&dns_config);
+  ConfigureRaceNameserversFieldTrial(&dns_config);
 
   if (net_log_) {
     net_log_->AddGlobalEntry(
@@ -2197,6 +2308,7 @@ void HostResolverImpl::SetDnsClient(scoped_ptr<DnsClient> dns_client) {
   }
   DnsConfig dns_config;
   NetworkChangeNotifier::GetDnsConfig(&dns_config);
+  ConfigureRaceNameserversFieldTrial(&dns_config);
   dns_client_->SetConfig(dns_config);
   num_dns_failures_ = 0;
   if (dns_config.IsValid())
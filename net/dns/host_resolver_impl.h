@@ -123,6 +123,16 @@ class NET_EXPORT HostResolverImpl
   // Only allowed when the queue is empty.
   void SetMaxQueuedJobs(size_t value);
 
+  // Enables serving cache entries that expired up to |max_staleness| ago. Such
+  // an entry is returned right away, and refreshed by a Job running in the
+  // background. Zero, the default, disables this.
+  void SetMaxStaleness(base::TimeDelta max_staleness);
+
+  // The number of expired cache entries served, and how many of them were
+  // found to be wrong when refreshed.
+  size_t num_stale_answers() const { return num_stale_answers_; }
+  size_t num_wrong_stale_answers() const { return num_wrong_stale_answers_; }
+
   // Set the DnsClient to be used for resolution. In case of failure, the
   // HostResolverProc from ProcTaskParams will be queried. If the DnsClient is
   // not pre-configured with a valid DnsConfig, a new config is fetched from
@@ -160,10 +170,13 @@ class NET_EXPORT HostResolverImpl
   // literal, cache and HOSTS lookup (if enabled), returns OK if successful,
   // ERR_NAME_NOT_RESOLVED if either hostname is invalid or IP literal is
   // incompatible, ERR_DNS_CACHE_MISS if entry was not found in cache and HOSTS.
+  // If |served_stale| is not NULL, expired cache entries may be served, and it
+  // is set to true when one is.
   int ResolveHelper(const Key& key,
                     const RequestInfo& info,
                     AddressList* addresses,
-                    const BoundNetLog& request_net_log);
+                    const BoundNetLog& request_net_log,
+                    bool* served_stale);
 
   // Tries to resolve |key| as an IP, returns true and sets |net_error| if
   // succeeds, returns false otherwise.
@@ -174,11 +187,14 @@ class NET_EXPORT HostResolverImpl
 
   // If |key| is not found in cache returns false, otherwise returns
   // true, sets |net_error| to the cached error code and fills |addresses|
-  // if it is a positive entry.
+  // if it is a positive entry. Expired positive entries are only served if
+  // |served_stale| is not NULL and |max_staleness_| allows it, in which case
+  // |served_stale| is set to true.
   bool ServeFromCache(const Key& key,
                       const RequestInfo& info,
                       int* net_error,
-                      AddressList* addresses);
+                      AddressList* addresses,
+                      bool* served_stale);
 
   // If we have a DnsClient with a valid DnsConfig, and |key| is found in the
   // HOSTS file, returns true and fills |addresses|. Otherwise returns false.
@@ -200,6 +216,14 @@ class NET_EXPORT HostResolverImpl
                    const HostCache::Entry& entry,
                    base::TimeDelta ttl);
 
+  // Starts a background Job refreshing the expired cache entry for |key|,
+  // unless one is already running.
+  void StartStaleRefresh(const Key& key, const BoundNetLog& request_net_log);
+
+  // Called when a Job started by StartStaleRefresh() completes with |entry|.
+  void OnStaleEntryRefreshed(const HostCache::Entry& stale_entry,
+                             const HostCache::Entry& entry);
+
   // Removes |job| from |jobs_|, only if it exists.
   void RemoveJob(Job* job);
 
@@ -277,6 +301,12 @@ class NET_EXPORT HostResolverImpl
   // Allow fallback to ProcTask if DnsTask fails.
   bool fallback_to_proctask_;
 
+  // How long ago a cache entry may have expired and still be served.
+  base::TimeDelta max_staleness_;
+
+  size_t num_stale_answers_;
+  size_t num_wrong_stale_answers_;
+
   DISALLOW_COPY_AND_ASSIGN(HostResolverImpl);
 };
 
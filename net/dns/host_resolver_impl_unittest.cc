@@ -6,6 +6,8 @@
 
 #include <algorithm>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/bind_helpers.h"
@@ -514,6 +516,22 @@ class HostResolverImplTest : public testing::Test {
     resolver_->fallback_to_proctask_ = fallback_to_proctask;
   }
 
+  // Makes every entry in the cache expire a minute ago.
+  void ExpireCacheEntries() {
+    HostCache* cache = resolver_->GetHostCache();
+    std::vector<std::pair<HostCache::Key, HostCache::Entry> > entries;
+    for (HostCache::EntryMap::Iterator it(cache->entries()); it.HasNext();
+         it.Advance()) {
+      entries.push_back(std::make_pair(it.key(), it.value()));
+    }
+    base::TimeTicks past =
+        base::TimeTicks::Now() - base::TimeDelta::FromMinutes(2);
+    for (size_t i = 0; i < entries.size(); ++i) {
+      cache->Set(entries[i].first, entries[i].second, past,
+                 base::TimeDelta::FromMinutes(1));
+    }
+  }
+
   scoped_refptr<MockHostResolverProc> proc_;
   scoped_ptr<HostResolverImpl> resolver_;
   ScopedVector<Request> requests_;
@@ -1200,6 +1218,54 @@ TEST_F(HostResolverImplTest, ResolveFromCache) {
   EXPECT_TRUE(requests_[2]->HasOneAddress("192.168.1.42", 80));
 }
 
+TEST_F(HostResolverImplTest, ExpiredEntriesAreNotServedByDefault) {
+  proc_->AddRuleForAllFamilies("just.testing", "192.168.1.42");
+  proc_->SignalMultiple(2u);
+
+  EXPECT_EQ(ERR_IO_PENDING, CreateRequest("just.testing", 80)->Resolve());
+  EXPECT_EQ(OK, requests_[0]->WaitForResult());
+  ExpireCacheEntries();
+
+  EXPECT_EQ(ERR_IO_PENDING, CreateRequest("just.testing", 80)->Resolve());
+  EXPECT_EQ(OK, requests_[1]->WaitForResult());
+  EXPECT_EQ(2u, proc_->GetCaptureList().size());
+  EXPECT_EQ(0u, resolver_->num_stale_answers());
+}
+
+TEST_F(HostResolverImplTest, ServeStaleWhileRevalidate) {
+  resolver_->SetMaxStaleness(base::TimeDelta::FromHours(1));
+  proc_->AddRuleForAllFamilies("just.testing", "192.168.1.42");
+  proc_->SignalMultiple(2u);
+
+  EXPECT_EQ(ERR_IO_PENDING, CreateRequest("just.testing", 80)->Resolve());
+  EXPECT_EQ(OK, requests_[0]->WaitForResult());
+  ExpireCacheEntries();
+
+  // The host moved, but the expired answer is served right away, and is
+  // refreshed in the background.
+  proc_->AddRuleForAllFamilies("just.testing", "192.168.1.43");
+  EXPECT_EQ(OK, CreateRequest("just.testing", 81)->Resolve());
+  EXPECT_TRUE(requests_[1]->HasOneAddress("192.168.1.42", 81));
+  // ResolveFromCache() does not serve expired entries.
+  EXPECT_EQ(ERR_DNS_CACHE_MISS,
+            CreateRequest("just.testing", 82)->ResolveFromCache());
+  EXPECT_EQ(1u, resolver_->num_stale_answers());
+
+  // A Request bypassing the cache joins the refresh.
+  HostResolver::RequestInfo info(HostPortPair("just.testing", 83));
+  info.set_allow_cached_response(false);
+  EXPECT_EQ(ERR_IO_PENDING, CreateRequest(info)->Resolve());
+  EXPECT_EQ(OK, requests_[3]->WaitForResult());
+  EXPECT_TRUE(requests_[3]->HasOneAddress("192.168.1.43", 83));
+  EXPECT_EQ(2u, proc_->GetCaptureList().size());
+  EXPECT_EQ(1u, resolver_->num_wrong_stale_answers());
+
+  // The refreshed answer is cached.
+  EXPECT_EQ(OK, CreateRequest("just.testing", 84)->Resolve());
+  EXPECT_TRUE(requests_[4]->HasOneAddress("192.168.1.43", 84));
+  EXPECT_EQ(1u, resolver_->num_stale_answers());
+}
+
 // Test the retry attempts simulating host resolver proc that takes too long.
 TEST_F(HostResolverImplTest, MultipleAttempts) {
   // Total number of attempts would be 3 and we want the 3rd attempt to resolve
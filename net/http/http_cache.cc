@@ -93,7 +93,9 @@ HttpCache::ActiveEntry::ActiveEntry(disk_cache::Entry* entry)
     : disk_entry(entry),
       writer(NULL),
       will_process_pending_queue(false),
-      doomed(false) {
+      doomed(false),
+      shared_writing(false),
+      shared_writing_failed(false) {
 }
 
 HttpCache::ActiveEntry::~ActiveEntry() {
@@ -273,6 +275,7 @@ HttpCache::HttpCache(const net::HttpNetworkSession::Params& params,
       backend_factory_(backend_factory),
       building_backend_(false),
       mode_(NORMAL),
+      compress_text_bodies_(false),
       network_layer_(new HttpNetworkLayer(new HttpNetworkSession(params))) {
 }
 
@@ -283,6 +286,7 @@ HttpCache::HttpCache(HttpNetworkSession* session,
       backend_factory_(backend_factory),
       building_backend_(false),
       mode_(NORMAL),
+      compress_text_bodies_(false),
       network_layer_(new HttpNetworkLayer(session)) {
 }
 
@@ -293,6 +297,7 @@ HttpCache::HttpCache(HttpTransactionFactory* network_layer,
       backend_factory_(backend_factory),
       building_backend_(false),
       mode_(NORMAL),
+      compress_text_bodies_(false),
       network_layer_(network_layer) {
 }
 
@@ -780,12 +785,22 @@ int HttpCache::AddTransactionToEntry(ActiveEntry* entry, Transaction* trans) {
   //
   // NOTE: If the transaction can only write, then the entry should not be in
   // use (since any existing entry should have already been doomed).
+  //
+  // While the writer is storing the body of a complete response, readers are
+  // allowed to follow it and read the data as it is appended to the entry.
 
-  if (entry->writer || entry->will_process_pending_queue) {
+  if (entry->will_process_pending_queue ||
+      (entry->writer &&
+       (!entry->shared_writing || !trans->CanFollowWriter()))) {
     entry->pending_queue.push_back(trans);
     return ERR_IO_PENDING;
   }
 
+  if (entry->writer) {
+    entry->readers.push_back(trans);
+    return OK;
+  }
+
   if (trans->mode() & Transaction::WRITE) {
     // transaction needs exclusive access to the entry
     if (entry->readers.empty()) {
@@ -812,12 +827,12 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
                               bool cancel) {
   // If we already posted a task to move on to the next transaction and this was
   // the writer, there is nothing to cancel.
-  if (entry->will_process_pending_queue && entry->readers.empty())
+  if (entry->will_process_pending_queue && entry->readers.empty() &&
+      !entry->writer) {
     return;
+  }
 
-  if (entry->writer) {
-    DCHECK(trans == entry->writer);
-
+  if (trans == entry->writer) {
     // Assume there was a failure.
     bool success = false;
     if (cancel) {
@@ -836,7 +851,38 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
 }
 
 void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
-  DCHECK(entry->readers.empty());
+  DCHECK(entry->readers.empty() || entry->writer);
+
+  if (entry->shared_writing) {
+    // The readers following the writer will not get the rest of the body.
+    entry->shared_writing = false;
+    entry->shared_writing_failed = true;
+  }
+  entry->notified_readers.splice(entry->notified_readers.end(),
+                                 entry->waiting_readers);
+
+  if (!success &&
+      (!entry->readers.empty() || entry->will_process_pending_queue)) {
+    // Someone is still using this entry, so it cannot be destroyed yet; make
+    // sure that no one else finds it.
+    TransactionList pending_queue;
+    pending_queue.swap(entry->pending_queue);
+
+    if (entry->doomed) {
+      entry->disk_entry->Doom();
+    } else {
+      int rv = DoomEntry(entry->disk_entry->GetKey(), NULL);
+      DCHECK_EQ(OK, rv);
+    }
+    entry->writer = NULL;
+    ProcessPendingQueue(entry);
+
+    while (!pending_queue.empty()) {
+      pending_queue.front()->io_callback().Run(ERR_CACHE_RACE);
+      pending_queue.pop_front();
+    }
+    return;
+  }
 
   entry->writer = NULL;
 
@@ -863,13 +909,15 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
 }
 
 void HttpCache::DoneReadingFromEntry(ActiveEntry* entry, Transaction* trans) {
-  DCHECK(!entry->writer);
+  DCHECK(entry->writer != trans);
 
   TransactionList::iterator it =
       std::find(entry->readers.begin(), entry->readers.end(), trans);
   DCHECK(it != entry->readers.end());
 
   entry->readers.erase(it);
+  entry->waiting_readers.remove(trans);
+  entry->notified_readers.remove(trans);
 
   ProcessPendingQueue(entry);
 }
@@ -887,6 +935,39 @@ void HttpCache::ConvertWriterToReader(ActiveEntry* entry) {
   ProcessPendingQueue(entry);
 }
 
+void HttpCache::StartSharedWriting(ActiveEntry* entry) {
+  DCHECK(entry->writer);
+  DCHECK(entry->readers.empty());
+
+  entry->shared_writing = true;
+  entry->shared_writing_failed = false;
+  if (!entry->pending_queue.empty())
+    ProcessPendingQueue(entry);
+}
+
+void HttpCache::OnSharedDataWritten(ActiveEntry* entry, bool done) {
+  if (!entry->shared_writing)
+    return;
+
+  if (done)
+    entry->shared_writing = false;
+
+  if (entry->waiting_readers.empty())
+    return;
+
+  entry->notified_readers.splice(entry->notified_readers.end(),
+                                 entry->waiting_readers);
+  ProcessPendingQueue(entry);
+}
+
+void HttpCache::WaitForSharedData(ActiveEntry* entry, Transaction* trans) {
+  DCHECK(entry->shared_writing);
+  DCHECK(std::find(entry->readers.begin(), entry->readers.end(), trans) !=
+         entry->readers.end());
+
+  entry->waiting_readers.push_back(trans);
+}
+
 LoadState HttpCache::GetLoadStateForPendingTransaction(
       const Transaction* trans) {
   ActiveEntriesMap::const_iterator i = active_entries_.find(trans->key());
@@ -980,7 +1061,34 @@ void HttpCache::ProcessPendingQueue(ActiveEntry* entry) {
 
 void HttpCache::OnProcessPendingQueue(ActiveEntry* entry) {
   entry->will_process_pending_queue = false;
-  DCHECK(!entry->writer);
+
+  // Readers waiting for more data are notified one at a time, because any of
+  // them may end up removing other transactions from the entry.
+  if (!entry->notified_readers.empty()) {
+    Transaction* next = entry->notified_readers.front();
+    entry->notified_readers.pop_front();
+    ProcessPendingQueue(entry);
+    next->io_callback().Run(OK);
+    return;
+  }
+
+  if (entry->writer) {
+    // Only the transactions that can follow the writer may start now.
+    if (!entry->shared_writing)
+      return;
+    TransactionList::iterator it = entry->pending_queue.begin();
+    while (it != entry->pending_queue.end() && !(*it)->CanFollowWriter())
+      ++it;
+    if (it == entry->pending_queue.end())
+      return;
+
+    Transaction* next = *it;
+    entry->pending_queue.erase(it);
+    entry->readers.push_back(next);
+    ProcessPendingQueue(entry);
+    next->io_callback().Run(OK);
+    return;
+  }
 
   // If no one is interested in this entry, then we can deactivate it.
   if (entry->pending_queue.empty()) {
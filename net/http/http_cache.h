@@ -174,6 +174,12 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   void set_mode(Mode value) { mode_ = value; }
   Mode mode() { return mode_; }
 
+  // Stores the bodies of text responses (scripts, style sheets, JSON...)
+  // compressed when they don't arrive compressed, and decompresses them on
+  // read. Off by default.
+  void set_compress_text_bodies(bool value) { compress_text_bodies_ = value; }
+  bool compress_text_bodies() const { return compress_text_bodies_; }
+
   // Close currently active sockets so that fresh page loads will not use any
   // recycled connections.  For sockets currently in use, they may not close
   // immediately, but they will not be reusable. This is for debugging.
@@ -230,6 +236,16 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
     TransactionList    pending_queue;
     bool               will_process_pending_queue;
     bool               doomed;
+
+    // True while |writer| is storing the body of a complete response that
+    // |readers| may read as it is appended to the entry.
+    bool               shared_writing;
+    // True if the writer went away before storing the whole body.
+    bool               shared_writing_failed;
+    // Readers that have read everything the writer has stored so far, and
+    // the ones to notify about new data on the next OnProcessPendingQueue.
+    TransactionList    waiting_readers;
+    TransactionList    notified_readers;
   };
 
   typedef base::hash_map<std::string, ActiveEntry*> ActiveEntriesMap;
@@ -332,6 +348,19 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   // transactions can start reading from this entry.
   void ConvertWriterToReader(ActiveEntry* entry);
 
+  // Lets the transactions that only need to read from |entry| join it while
+  // the writer is still storing the response body.
+  void StartSharedWriting(ActiveEntry* entry);
+
+  // Called by the writer of |entry| after appending data to the response body.
+  // |done| is true once the whole body has been stored.
+  void OnSharedDataWritten(ActiveEntry* entry, bool done);
+
+  // Called by a reader of |entry| that has read all the data stored so far.
+  // The IO callback of |trans| will be invoked when there is more data or the
+  // writer goes away.
+  void WaitForSharedData(ActiveEntry* entry, Transaction* trans);
+
   // Returns the LoadState of the provided pending transaction.
   LoadState GetLoadStateForPendingTransaction(const Transaction* trans);
 
@@ -381,6 +410,7 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   bool building_backend_;
 
   Mode mode_;
+  bool compress_text_bodies_;
 
   const scoped_ptr<HttpTransactionFactory> network_layer_;
   scoped_ptr<disk_cache::Backend> disk_cache_;
@@ -0,0 +1,100 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/http_cache_body_compressor.h"
+
+#include <string>
+
+#include "base/logging.h"
+#include "net/base/io_buffer.h"
+#include "third_party/zlib/zlib.h"
+
+namespace {
+
+// The cache favors speed over size: a small window keeps the memory used by
+// each writer low, and the fastest level keeps the IO thread responsive.
+const int kCompressionLevel = 1;
+const int kWindowBits = 14;
+const int kMemLevel = 6;
+
+// Adding 16 to the window bits makes zlib write a gzip header and trailer.
+const int kGZipWrapper = 16;
+
+const int kOutputChunkSize = 16 * 1024;
+
+}  // namespace
+
+namespace net {
+
+HttpCacheBodyCompressor::HttpCacheBodyCompressor()
+    : initialized_(false),
+      finished_(false),
+      bytes_in_(0) {
+}
+
+HttpCacheBodyCompressor::~HttpCacheBodyCompressor() {
+  if (initialized_)
+    deflateEnd(zlib_stream_.get());
+}
+
+bool HttpCacheBodyCompressor::Init() {
+  DCHECK(!initialized_);
+  zlib_stream_.reset(new z_stream);
+  memset(zlib_stream_.get(), 0, sizeof(z_stream));
+  if (deflateInit2(zlib_stream_.get(), kCompressionLevel, Z_DEFLATED,
+                   kWindowBits + kGZipWrapper, kMemLevel,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    zlib_stream_.reset();
+    return false;
+  }
+  initialized_ = true;
+  return true;
+}
+
+int HttpCacheBodyCompressor::Compress(const char* data, int data_len,
+                                      bool finish,
+                                      scoped_refptr<IOBuffer>* output) {
+  DCHECK(initialized_);
+  DCHECK_GE(data_len, 0);
+  *output = NULL;
+  if (finished_)
+    return data_len ? -1 : 0;
+
+  // Sync flushes write a few bytes even without input, so don't flush when
+  // there is nothing new to write out.
+  if (!data_len && !finish)
+    return 0;
+
+  z_stream* stream = zlib_stream_.get();
+  stream->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+  stream->avail_in = data_len;
+
+  std::string compressed;
+  char chunk[kOutputChunkSize];
+  int flush = finish ? Z_FINISH : Z_SYNC_FLUSH;
+  int rv;
+  do {
+    stream->next_out = reinterpret_cast<Bytef*>(chunk);
+    stream->avail_out = sizeof(chunk);
+    rv = deflate(stream, flush);
+    if (rv != Z_OK && rv != Z_STREAM_END && rv != Z_BUF_ERROR)
+      return -1;
+    compressed.append(chunk, sizeof(chunk) - stream->avail_out);
+  } while (stream->avail_out == 0);
+
+  // With room left in the output, Z_FINISH always ends the stream.
+  if (finish && rv != Z_STREAM_END)
+    return -1;
+
+  bytes_in_ += data_len;
+  finished_ = finish;
+  if (compressed.empty())
+    return 0;
+
+  int compressed_len = static_cast<int>(compressed.size());
+  *output = new StringIOBuffer(compressed);
+  return compressed_len;
+}
+
+}  // namespace net
@@ -0,0 +1,55 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_HTTP_HTTP_CACHE_BODY_COMPRESSOR_H_
+#define NET_HTTP_HTTP_CACHE_BODY_COMPRESSOR_H_
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "net/base/net_export.h"
+
+typedef struct z_stream_s z_stream;
+
+namespace net {
+
+class IOBuffer;
+
+// Compresses the body of a response as it is written to the HttpCache. The
+// output is a gzip stream, so it can be decoded with Filter::GZipFactory().
+//
+// Every call to Compress() flushes the compressor, so all the data passed to
+// it so far can be decoded from the output produced so far. This lets readers
+// decode an entry that is still being written.
+class NET_EXPORT_PRIVATE HttpCacheBodyCompressor {
+ public:
+  HttpCacheBodyCompressor();
+  ~HttpCacheBodyCompressor();
+
+  // Sets up the compression stream. Returns false on failure.
+  bool Init();
+
+  // Compresses |data_len| bytes from |data|, and ends the stream if |finish|
+  // is true. Returns the number of bytes placed in |output|, which may be 0,
+  // or -1 on error. Calls after the stream is finished produce no output.
+  int Compress(const char* data, int data_len, bool finish,
+               scoped_refptr<IOBuffer>* output);
+
+  // The number of uncompressed bytes passed to Compress() so far.
+  int64 bytes_in() const { return bytes_in_; }
+
+  bool finished() const { return finished_; }
+
+ private:
+  scoped_ptr<z_stream> zlib_stream_;
+  bool initialized_;
+  bool finished_;
+  int64 bytes_in_;
+
+  DISALLOW_COPY_AND_ASSIGN(HttpCacheBodyCompressor);
+};
+
+}  // namespace net
+
+#endif  // NET_HTTP_HTTP_CACHE_BODY_COMPRESSOR_H_
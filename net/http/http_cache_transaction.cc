@@ -15,6 +15,7 @@
 
 #include "base/bind.h"
 #include "base/compiler_specific.h"
+#include "base/debug/trace_event_memory.h"
 #include "base/memory/ref_counted.h"
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
@@ -24,6 +25,7 @@
 #include "base/strings/string_util.h"
 #include "base/time/time.h"
 #include "net/base/completion_callback.h"
+#include "net/base/filter.h"
 #include "net/base/io_buffer.h"
 #include "net/base/load_flags.h"
 #include "net/base/load_timing_info.h"
@@ -32,6 +34,7 @@
 #include "net/base/upload_data_stream.h"
 #include "net/cert/cert_status_flags.h"
 #include "net/disk_cache/disk_cache.h"
+#include "net/http/http_cache_body_compressor.h"
 #include "net/http/http_network_session.h"
 #include "net/http/http_request_info.h"
 #include "net/http/http_response_headers.h"
@@ -65,6 +68,20 @@ bool IsOfflineError(int error) {
           error == net::ERR_CONNECTION_TIMED_OUT);
 }
 
+// Bodies smaller than this are not worth compressing.
+const int64 kMinCompressedBodySize = 256;
+
+// Returns true for the text formats that the cache may store compressed.
+bool IsCompressibleMimeType(const std::string& mime_type) {
+  return StartsWithASCII(mime_type, "text/", true) ||
+         mime_type == "application/javascript" ||
+         mime_type == "application/x-javascript" ||
+         mime_type == "application/ecmascript" ||
+         mime_type == "application/json" ||
+         mime_type == "application/xml" ||
+         mime_type == "image/svg+xml";
+}
+
 // Enum for UMA, indicating the status (with regard to offline mode) of
 // a particular request.
 enum RequestOfflineStatus {
@@ -188,10 +205,13 @@ HttpCache::Transaction::Transaction(
       done_reading_(false),
       vary_mismatch_(false),
       couldnt_conditionalize_request_(false),
+      following_writer_(false),
+      must_wait_for_writer_(false),
       io_buf_len_(0),
       read_offset_(0),
       effective_load_flags_(0),
       write_len_(0),
+      cache_write_len_(0),
       weak_factory_(this),
       io_callback_(base::Bind(&Transaction::OnIOComplete,
                               weak_factory_.GetWeakPtr())),
@@ -278,6 +298,14 @@ bool HttpCache::Transaction::AddTruncatedFlag() {
   return true;
 }
 
+bool HttpCache::Transaction::CanFollowWriter() const {
+  // Range requests may have to write to the entry, and so may anything that
+  // is not strictly reading it.
+  if (must_wait_for_writer_ || partial_.get())
+    return false;
+  return mode_ == READ || mode_ == READ_WRITE;
+}
+
 LoadState HttpCache::Transaction::GetWriterLoadState() const {
   if (network_trans_.get())
     return network_trans_->GetLoadState();
@@ -406,6 +434,13 @@ int HttpCache::Transaction::Read(IOBuffer* buf, int buf_len,
     mode_ = NONE;
   }
 
+  // Once the body is being read, other requests for this resource can read it
+  // as we store it.
+  if (!reading_ && entry_ && mode_ == WRITE && !partial_.get() &&
+      request_->method == "GET" && response_.headers->response_code() == 200) {
+    cache_->StartSharedWriting(entry_);
+  }
+
   reading_ = true;
   int rv;
 
@@ -446,8 +481,10 @@ void HttpCache::Transaction::StopCaching() {
   // entry how it is (it will be marked as truncated at destruction), and let
   // the next piece of code that executes know that we are now reading directly
   // from the net.
+  //
+  // Keep writing to the entry if other transactions are reading it along.
   if (cache_.get() && entry_ && (mode_ & WRITE) && network_trans_.get() &&
-      !is_sparse_ && !range_requested_) {
+      !is_sparse_ && !range_requested_ && entry_->readers.empty()) {
     mode_ = NONE;
   }
 }
@@ -465,8 +502,10 @@ void HttpCache::Transaction::DoneReading() {
   if (cache_.get() && entry_) {
     DCHECK(reading_);
     DCHECK_NE(mode_, UPDATE);
-    if (mode_ & WRITE)
+    if (mode_ & WRITE) {
+      cache_->OnSharedDataWritten(entry_, true);
       DoneWritingToEntry(true);
+    }
   }
 }
 
@@ -612,6 +651,7 @@ int HttpCache::Transaction::HandleResult(int rv) {
 //   -> PartialHeadersReceived -> NetworkRead* -> CacheWriteData*
 //
 int HttpCache::Transaction::DoLoop(int result) {
+  TRACE_MEMORY_SUBSYSTEM("net");
   DCHECK(next_state_ != STATE_NONE);
 
   int rv = result;
@@ -1168,6 +1208,7 @@ int HttpCache::Transaction::DoAddToEntryComplete(int result) {
 
   if (result == OK)
     entry_ = new_entry_;
+  following_writer_ = entry_ && entry_->writer && entry_->writer != this;
 
   // If there is a failure, the cache should have taken care of new_entry_.
   new_entry_ = NULL;
@@ -1416,6 +1457,7 @@ int HttpCache::Transaction::DoCacheReadResponse() {
 
   net_log_.BeginEvent(NetLog::TYPE_HTTP_CACHE_READ_INFO);
   ReportCacheActionStart();
+  entry_->disk_entry->SetPriority(priority_);
   return ResetCacheIOStart(entry_->disk_entry->ReadData(
       kResponseInfoIndex, 0, read_buf_.get(), io_buf_len_, io_callback_));
 }
@@ -1513,6 +1555,7 @@ int HttpCache::Transaction::DoCacheReadMetadata() {
 
   net_log_.BeginEvent(NetLog::TYPE_HTTP_CACHE_READ_INFO);
   ReportCacheActionStart();
+  entry_->disk_entry->SetPriority(priority_);
   return ResetCacheIOStart(
       entry_->disk_entry->ReadData(kMetadataIndex,
                                    0,
@@ -1561,21 +1604,48 @@ int HttpCache::Transaction::DoCacheQueryDataComplete(int result) {
 
 int HttpCache::Transaction::DoCacheReadData() {
   DCHECK(entry_);
+
+  IOBuffer* buf = read_buf_.get();
+  int buf_len = io_buf_len_;
+  if (response_.body_compressed_in_cache && !partial_.get()) {
+    if (!body_decoder_.get()) {
+      body_decoder_.reset(Filter::GZipFactory());
+      if (!body_decoder_.get())
+        return ERR_CACHE_READ_FAILURE;
+    }
+    // Return what is left from the last read before reading more.
+    if (body_decoder_->stream_data_len())
+      return DecodeCachedBody();
+    buf = body_decoder_->stream_buffer();
+    buf_len = body_decoder_->stream_buffer_size();
+  }
+
+  if (following_writer_ && !partial_.get() &&
+      read_offset_ >= entry_->disk_entry->GetDataSize(kResponseContentIndex)) {
+    if (entry_->shared_writing) {
+      // Wait until the writer stores more data.
+      next_state_ = STATE_CACHE_READ_DATA;
+      cache_->WaitForSharedData(entry_, this);
+      return ERR_IO_PENDING;
+    }
+    // The writer went away without storing the whole body.
+    if (entry_->shared_writing_failed)
+      return ERR_CACHE_READ_FAILURE;
+  }
+
   next_state_ = STATE_CACHE_READ_DATA_COMPLETE;
 
   if (net_log_.IsLoggingAllEvents())
     net_log_.BeginEvent(NetLog::TYPE_HTTP_CACHE_READ_DATA);
   ReportCacheActionStart();
+  entry_->disk_entry->SetPriority(priority_);
   if (partial_.get()) {
     return ResetCacheIOStart(partial_->CacheRead(
         entry_->disk_entry, read_buf_.get(), io_buf_len_, io_callback_));
   }
 
-  return ResetCacheIOStart(entry_->disk_entry->ReadData(kResponseContentIndex,
-                                                        read_offset_,
-                                                        read_buf_.get(),
-                                                        io_buf_len_,
-                                                        io_callback_));
+  return ResetCacheIOStart(entry_->disk_entry->ReadData(
+      kResponseContentIndex, read_offset_, buf, buf_len, io_callback_));
 }
 
 int HttpCache::Transaction::DoCacheReadDataComplete(int result) {
@@ -1597,6 +1667,10 @@ int HttpCache::Transaction::DoCacheReadDataComplete(int result) {
 
   if (result > 0) {
     read_offset_ += result;
+    if (body_decoder_.get()) {
+      body_decoder_->FlushStreamBuffer(result);
+      return DecodeCachedBody();
+    }
   } else if (result == 0) {  // End of file.
     RecordHistograms();
     cache_->DoneReadingFromEntry(entry_, this);
@@ -1610,6 +1684,25 @@ int HttpCache::Transaction::DoCacheReadDataComplete(int result) {
 int HttpCache::Transaction::DoCacheWriteData(int num_bytes) {
   next_state_ = STATE_CACHE_WRITE_DATA_COMPLETE;
   write_len_ = num_bytes;
+  cache_write_len_ = num_bytes;
+
+  scoped_refptr<IOBuffer> buf = read_buf_;
+  if (entry_ && body_compressor_.get()) {
+    // Finish the stream as soon as the whole body is here, in case we are not
+    // asked to read past its end.
+    int64 body_size = response_.headers->GetContentLength();
+    int64 bytes_in = body_compressor_->bytes_in() + num_bytes;
+    bool finish = !num_bytes || (body_size >= 0 && bytes_in >= body_size);
+    cache_write_len_ = body_compressor_->Compress(read_buf_->data(), num_bytes,
+                                                  finish, &buf);
+    if (cache_write_len_ < 0) {
+      DLOG(ERROR) << "failed to compress response data";
+      DoneWritingToEntry(false);
+      cache_write_len_ = num_bytes;
+      buf = read_buf_;
+    }
+  }
+
   if (entry_) {
     if (net_log_.IsLoggingAllEvents())
       net_log_.BeginEvent(NetLog::TYPE_HTTP_CACHE_WRITE_DATA);
@@ -1617,7 +1710,7 @@ int HttpCache::Transaction::DoCacheWriteData(int num_bytes) {
   }
 
   return ResetCacheIOStart(
-      AppendResponseDataToEntry(read_buf_.get(), num_bytes, io_callback_));
+      AppendResponseDataToEntry(buf.get(), cache_write_len_, io_callback_));
 }
 
 int HttpCache::Transaction::DoCacheWriteDataComplete(int result) {
@@ -1632,20 +1725,28 @@ int HttpCache::Transaction::DoCacheWriteDataComplete(int result) {
   if (!cache_.get())
     return ERR_UNEXPECTED;
 
-  if (result != write_len_) {
+  if (result != cache_write_len_) {
     DLOG(ERROR) << "failed to write response data to cache";
     DoneWritingToEntry(false);
-
-    // We want to ignore errors writing to disk and just keep reading from
-    // the network.
-    result = write_len_;
   } else if (!done_reading_ && entry_) {
-    int current_size = entry_->disk_entry->GetDataSize(kResponseContentIndex);
+    int64 current_size = body_compressor_.get() ?
+        body_compressor_->bytes_in() :
+        entry_->disk_entry->GetDataSize(kResponseContentIndex);
     int64 body_size = response_.headers->GetContentLength();
     if (body_size >= 0 && body_size <= current_size)
       done_reading_ = true;
   }
 
+  // We want to ignore errors writing to disk and just keep reading from the
+  // network. The caller gets the data as it came from the network.
+  result = write_len_;
+
+  if (entry_ && !partial_.get()) {
+    cache_->OnSharedDataWritten(
+        entry_, done_reading_ ||
+                (result == 0 && response_.headers->GetContentLength() <= 0));
+  }
+
   if (partial_.get()) {
     // This may be the last request.
     if (!(result == 0 && !truncated_ &&
@@ -1840,6 +1941,9 @@ int HttpCache::Transaction::BeginCacheValidation() {
     skip_validation = false;
   }
 
+  if (!skip_validation && following_writer_)
+    return StopFollowingWriter();
+
   if (skip_validation) {
     UpdateTransactionPattern(PATTERN_ENTRY_USED);
     RecordOfflineStatus(effective_load_flags_, OFFLINE_STATUS_FRESH_CACHE);
@@ -1872,6 +1976,14 @@ int HttpCache::Transaction::BeginPartialCacheValidation() {
     return BeginCacheValidation();
   }
 
+  // The writer we joined did not store the whole response.
+  if (following_writer_)
+    return StopFollowingWriter();
+
+  // Byte ranges cannot be served from a compressed body.
+  if (response_.body_compressed_in_cache)
+    return DoRestartPartialRequest();
+
   // Partial requests should not be recorded in histograms.
   UpdateTransactionPattern(PATTERN_NOT_COVERED);
   if (range_requested_) {
@@ -2227,7 +2339,10 @@ int HttpCache::Transaction::SetupEntryForRead() {
       partial_.reset();
     }
   }
-  cache_->ConvertWriterToReader(entry_);
+  // A transaction that joined the entry while it was written is already one
+  // of its readers.
+  if (!following_writer_)
+    cache_->ConvertWriterToReader(entry_);
   mode_ = READ;
 
   if (entry_->disk_entry->GetDataSize(kMetadataIndex))
@@ -2297,6 +2412,16 @@ int HttpCache::Transaction::WriteResponseInfoToEntry(bool truncated) {
   if (truncated)
     DCHECK_EQ(200, response_.headers->response_code());
 
+  // The headers of a new body are written before the body itself.
+  if (mode_ == WRITE && !truncated) {
+    if (!body_compressor_.get() && ShouldCompressBody()) {
+      body_compressor_.reset(new HttpCacheBodyCompressor());
+      if (!body_compressor_->Init())
+        body_compressor_.reset();
+    }
+    response_.body_compressed_in_cache = body_compressor_.get() != NULL;
+  }
+
   scoped_refptr<PickledIOBuffer> data(new PickledIOBuffer());
   response_.Persist(data->pickle(), skip_transient_headers, truncated);
   data->Done();
@@ -2316,13 +2441,66 @@ int HttpCache::Transaction::AppendResponseDataToEntry(
                       callback);
 }
 
+bool HttpCache::Transaction::ShouldCompressBody() const {
+  if (!cache_->compress_text_bodies() || partial_.get() || truncated_ ||
+      request_->method != "GET" || response_.headers->response_code() != 200 ||
+      response_.headers->HasHeader("Content-Encoding")) {
+    return false;
+  }
+
+  int64 body_size = response_.headers->GetContentLength();
+  if (body_size >= 0 && body_size < kMinCompressedBodySize)
+    return false;
+
+  std::string mime_type;
+  return response_.headers->GetMimeType(&mime_type) &&
+         IsCompressibleMimeType(mime_type);
+}
+
+int HttpCache::Transaction::DecodeCachedBody() {
+  int len = io_buf_len_;
+  Filter::FilterStatus status =
+      body_decoder_->ReadData(read_buf_->data(), &len);
+  if (status == Filter::FILTER_ERROR)
+    return OnCacheReadError(ERR_CACHE_READ_FAILURE, false);
+
+  if (!len && status != Filter::FILTER_DONE) {
+    // Not enough data to decode anything yet.
+    next_state_ = STATE_CACHE_READ_DATA;
+    return OK;
+  }
+
+  if (!len) {
+    // End of the body.
+    RecordHistograms();
+    cache_->DoneReadingFromEntry(entry_, this);
+    entry_ = NULL;
+  }
+  return len;
+}
+
+int HttpCache::Transaction::StopFollowingWriter() {
+  DCHECK(following_writer_);
+  cache_->DoneReadingFromEntry(entry_, this);
+  entry_ = NULL;
+  following_writer_ = false;
+  must_wait_for_writer_ = true;
+  next_state_ = STATE_INIT_ENTRY;
+  return OK;
+}
+
 void HttpCache::Transaction::DoneWritingToEntry(bool success) {
   if (!entry_)
     return;
 
   RecordHistograms();
 
-  cache_->DoneWritingToEntry(entry_, success);
+  // We may have joined the entry as a reader before knowing that we would
+  // rather write to it.
+  if (following_writer_)
+    cache_->DoneReadingFromEntry(entry_, this);
+  else
+    cache_->DoneWritingToEntry(entry_, success);
   entry_ = NULL;
   mode_ = NONE;  // switch to 'pass through' mode
 }
@@ -2421,6 +2599,10 @@ bool HttpCache::Transaction::CanResume(bool has_data) {
   if (request_->method != "GET")
     return false;
 
+  // The stored bytes don't match the byte ranges of the resource.
+  if (response_.body_compressed_in_cache)
+    return false;
+
   if (response_.headers->GetContentLength() <= 0 ||
       response_.headers->HasHeaderValue("Accept-Ranges", "none") ||
       !response_.headers->HasStrongValidators()) {
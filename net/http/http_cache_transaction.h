@@ -21,6 +21,8 @@
 
 namespace net {
 
+class Filter;
+class HttpCacheBodyCompressor;
 class PartialData;
 struct HttpRequestInfo;
 class HttpTransactionDelegate;
@@ -103,6 +105,10 @@ class HttpCache::Transaction : public HttpTransaction {
 
   const CompletionCallback& io_callback() { return io_callback_; }
 
+  // Returns true if this transaction may read the response body of an entry
+  // while another transaction is still writing it.
+  bool CanFollowWriter() const;
+
   const BoundNetLog& net_log() const;
 
   // HttpTransaction methods:
@@ -318,6 +324,10 @@ class HttpCache::Transaction : public HttpTransaction {
   // Setups the transaction for reading from the cache entry.
   int SetupEntryForRead();
 
+  // Leaves an entry that we joined while it was being written, to wait for the
+  // writer to finish instead.  Returns a network error code.
+  int StopFollowingWriter();
+
   // Reads data from the network.
   int ReadFromNetwork(IOBuffer* data, int data_len);
 
@@ -339,6 +349,14 @@ class HttpCache::Transaction : public HttpTransaction {
   int AppendResponseDataToEntry(IOBuffer* data, int data_len,
                                 const CompletionCallback& callback);
 
+  // Returns true if the body of response_ should be stored compressed.
+  bool ShouldCompressBody() const;
+
+  // Decodes the compressed body data read from the cache into read_buf_.
+  // Returns the number of bytes decoded, or sets next_state_ to read more
+  // data from the entry.
+  int DecodeCachedBody();
+
   // Called when we are done writing to the cache entry.
   void DoneWritingToEntry(bool success);
 
@@ -422,12 +440,17 @@ class HttpCache::Transaction : public HttpTransaction {
   bool done_reading_;
   bool vary_mismatch_;  // The request doesn't match the stored vary data.
   bool couldnt_conditionalize_request_;
+  bool following_writer_;  // We read the entry while it is being written.
+  bool must_wait_for_writer_;  // We cannot read along with the writer.
   scoped_refptr<IOBuffer> read_buf_;
   int io_buf_len_;
   int read_offset_;
   int effective_load_flags_;
   int write_len_;
+  int cache_write_len_;  // The bytes actually written for write_len_ bytes.
   scoped_ptr<PartialData> partial_;  // We are dealing with range requests.
+  scoped_ptr<HttpCacheBodyCompressor> body_compressor_;
+  scoped_ptr<Filter> body_decoder_;
   UploadProgress final_upload_progress_;
   base::WeakPtrFactory<Transaction> weak_factory_;
   CompletionCallback io_callback_;
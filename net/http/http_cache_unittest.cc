@@ -1351,6 +1351,132 @@ TEST(HttpCache, SimpleGET_ManyReaders) {
   }
 }
 
+// Tests that readers can read the body of an entry while the writer is still
+// storing it.
+TEST(HttpCache, SimpleGET_ReadersFollowWriter) {
+  MockHttpCache cache;
+
+  MockHttpRequest request(kSimpleGET_Transaction);
+
+  ScopedVector<Context> context_list;
+  const int kNumTransactions = 3;
+
+  for (int i = 0; i < kNumTransactions; ++i) {
+    context_list.push_back(new Context());
+    Context* c = context_list[i];
+
+    c->result = cache.http_cache()->CreateTransaction(
+        net::DEFAULT_PRIORITY, &c->trans, NULL);
+    EXPECT_EQ(net::OK, c->result);
+
+    c->result = c->trans->Start(
+        &request, c->callback.callback(), net::BoundNetLog());
+  }
+
+  // The first request is the writer, and the other ones wait until it starts
+  // reading the body.
+  Context* writer = context_list[0];
+  EXPECT_EQ(net::OK, writer->callback.GetResult(writer->result));
+  base::MessageLoop::current()->RunUntilIdle();
+  for (int i = 1; i < kNumTransactions; ++i)
+    EXPECT_FALSE(context_list[i]->callback.have_result());
+
+  const std::string expected(kSimpleGET_Transaction.data);
+  const int kFirstChunkSize = 10;
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(256));
+  net::TestCompletionCallback callback;
+  int rv = writer->trans->Read(buf.get(), kFirstChunkSize, callback.callback());
+  EXPECT_EQ(kFirstChunkSize, callback.GetResult(rv));
+  EXPECT_EQ(expected.substr(0, kFirstChunkSize),
+            std::string(buf->data(), kFirstChunkSize));
+
+  // The readers get what has been stored so far, and then wait for more.
+  for (int i = 1; i < kNumTransactions; ++i) {
+    Context* c = context_list[i];
+    EXPECT_EQ(net::OK, c->callback.WaitForResult());
+    rv = c->trans->Read(buf.get(), 256, callback.callback());
+    EXPECT_EQ(kFirstChunkSize, callback.GetResult(rv));
+    EXPECT_EQ(expected.substr(0, kFirstChunkSize),
+              std::string(buf->data(), kFirstChunkSize));
+  }
+
+  Context* reader = context_list[1];
+  scoped_refptr<net::IOBuffer> reader_buf(new net::IOBuffer(256));
+  net::TestCompletionCallback reader_callback;
+  rv = reader->trans->Read(reader_buf.get(), 256, reader_callback.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_FALSE(reader_callback.have_result());
+
+  std::string content;
+  EXPECT_EQ(net::OK, ReadTransaction(writer->trans.get(), &content));
+  EXPECT_EQ(expected.substr(kFirstChunkSize), content);
+
+  rv = reader_callback.WaitForResult();
+  ASSERT_EQ(static_cast<int>(expected.size()) - kFirstChunkSize, rv);
+  EXPECT_EQ(expected.substr(kFirstChunkSize),
+            std::string(reader_buf->data(), rv));
+
+  for (int i = 1; i < kNumTransactions; ++i) {
+    Context* c = context_list[i];
+    EXPECT_EQ(net::OK, ReadTransaction(c->trans.get(), &content));
+    if (i == 1)
+      EXPECT_EQ("", content);
+    else
+      EXPECT_EQ(expected.substr(kFirstChunkSize), content);
+  }
+
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+}
+
+// Tests that readers following a writer that goes away before storing the
+// whole body get an error.
+TEST(HttpCache, SimpleGET_ReadersFollowWriter_CancelWriter) {
+  MockHttpCache cache;
+
+  MockHttpRequest request(kSimpleGET_Transaction);
+
+  ScopedVector<Context> context_list;
+  const int kNumTransactions = 2;
+
+  for (int i = 0; i < kNumTransactions; ++i) {
+    context_list.push_back(new Context());
+    Context* c = context_list[i];
+
+    c->result = cache.http_cache()->CreateTransaction(
+        net::DEFAULT_PRIORITY, &c->trans, NULL);
+    EXPECT_EQ(net::OK, c->result);
+
+    c->result = c->trans->Start(
+        &request, c->callback.callback(), net::BoundNetLog());
+  }
+
+  Context* writer = context_list[0];
+  EXPECT_EQ(net::OK, writer->callback.GetResult(writer->result));
+
+  const int kFirstChunkSize = 10;
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(256));
+  net::TestCompletionCallback callback;
+  int rv = writer->trans->Read(buf.get(), kFirstChunkSize, callback.callback());
+  EXPECT_EQ(kFirstChunkSize, callback.GetResult(rv));
+
+  Context* reader = context_list[1];
+  EXPECT_EQ(net::OK, reader->callback.WaitForResult());
+  rv = reader->trans->Read(buf.get(), 256, callback.callback());
+  EXPECT_EQ(kFirstChunkSize, callback.GetResult(rv));
+  rv = reader->trans->Read(buf.get(), 256, callback.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+
+  context_list[0]->trans.reset();
+  EXPECT_EQ(net::ERR_CACHE_READ_FAILURE, callback.WaitForResult());
+
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+}
+
 // This is a test for http://code.google.com/p/chromium/issues/detail?id=4769.
 // If cancelling a request is racing with another request for the same resource
 // finishing, we have to make sure that we remove both transactions from the
@@ -1396,11 +1522,12 @@ TEST(HttpCache, SimpleGET_RacingReaders) {
   c->result = c->callback.WaitForResult();
   ReadAndVerifyTransaction(c->trans.get(), kSimpleGET_Transaction);
 
-  // Now we have 2 active readers and two queued transactions.
+  // Now we have 4 active readers, that joined the entry while the first
+  // request was writing it.
 
   EXPECT_EQ(net::LOAD_STATE_IDLE,
             context_list[2]->trans->GetLoadState());
-  EXPECT_EQ(net::LOAD_STATE_WAITING_FOR_CACHE,
+  EXPECT_EQ(net::LOAD_STATE_IDLE,
             context_list[3]->trans->GetLoadState());
 
   c = context_list[1];
@@ -1409,10 +1536,9 @@ TEST(HttpCache, SimpleGET_RacingReaders) {
   if (c->result == net::OK)
     ReadAndVerifyTransaction(c->trans.get(), kSimpleGET_Transaction);
 
-  // At this point we have one reader, two pending transactions and a task on
-  // the queue to move to the next transaction. Now we cancel the request that
-  // is the current reader, and expect the queued task to be able to start the
-  // next request.
+  // At this point we have three readers and a task on the queue to move to
+  // the next transaction. Now we cancel one of the readers, and expect the
+  // other ones to be able to finish.
 
   c = context_list[2];
   c->trans.reset();
@@ -4072,6 +4198,62 @@ TEST(HttpCache, GET_Previous206_NotValidation) {
 }
 
 // Tests that we can handle range requests with cached 200 responses.
+// Tests that a range request waits until the entry has been written, instead of
+// following the writer.
+TEST(HttpCache, RangeGET_WaitsForWriter) {
+  MockHttpCache cache;
+
+  MockTransaction transaction(kTypicalGET_Transaction);
+  transaction.url = kRangeGET_TransactionOK.url;
+  transaction.data = "rg: 00-09 rg: 10-19 rg: 20-29 rg: 30-39 rg: 40-49 "
+                     "rg: 50-59 rg: 60-69 rg: 70-79 ";
+  AddMockTransaction(&transaction);
+
+  MockHttpRequest request(transaction);
+  Context writer;
+  writer.result = cache.http_cache()->CreateTransaction(
+      net::DEFAULT_PRIORITY, &writer.trans, NULL);
+  EXPECT_EQ(net::OK, writer.result);
+  writer.result =
+      writer.trans->Start(&request, writer.callback.callback(),
+                          net::BoundNetLog());
+  EXPECT_EQ(net::OK, writer.callback.GetResult(writer.result));
+  RemoveMockTransaction(&transaction);
+  AddMockTransaction(&kRangeGET_TransactionOK);
+
+  RangeTransactionServer handler;
+  handler.set_not_modified(true);
+  MockHttpRequest range_request(kRangeGET_TransactionOK);
+  Context reader;
+  reader.result = cache.http_cache()->CreateTransaction(
+      net::DEFAULT_PRIORITY, &reader.trans, NULL);
+  EXPECT_EQ(net::OK, reader.result);
+  reader.result =
+      reader.trans->Start(&range_request, reader.callback.callback(),
+                          net::BoundNetLog());
+
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(256));
+  net::TestCompletionCallback callback;
+  int rv = writer.trans->Read(buf.get(), 10, callback.callback());
+  EXPECT_EQ(10, callback.GetResult(rv));
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_FALSE(reader.callback.have_result());
+
+  std::string content;
+  EXPECT_EQ(net::OK, ReadTransaction(writer.trans.get(), &content));
+  writer.trans.reset();
+
+  EXPECT_EQ(net::OK, reader.callback.GetResult(reader.result));
+  EXPECT_EQ(206, reader.trans->GetResponseInfo()->headers->response_code());
+  EXPECT_EQ(net::OK, ReadTransaction(reader.trans.get(), &content));
+  EXPECT_EQ("rg: 40-49 ", content);
+
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+  RemoveMockTransaction(&kRangeGET_TransactionOK);
+}
+
 TEST(HttpCache, RangeGET_Previous200) {
   MockHttpCache cache;
 
@@ -6077,3 +6259,172 @@ TEST(HttpCache, SetPriorityNewTransaction) {
 
   RemoveMockTransaction(&kRangeGET_TransactionOK);
 }
+
+// Returns a script that compresses well.
+std::string CompressibleBody() {
+  std::string body;
+  for (int i = 0; i < 100; i++)
+    body.append(base::StringPrintf("var blah%d = 'Google Blah Blah';\n", i));
+  return body;
+}
+
+// Tests that text bodies can be stored compressed and read back.
+TEST(HttpCache, SimpleGET_CompressedBody) {
+  MockHttpCache cache;
+  cache.http_cache()->set_compress_text_bodies(true);
+
+  std::string body = CompressibleBody();
+  MockTransaction transaction(kSimpleGET_Transaction);
+  transaction.response_headers =
+      "Cache-Control: max-age=10000\n"
+      "Content-Type: application/javascript\n";
+  transaction.data = body.c_str();
+  AddMockTransaction(&transaction);
+
+  RunTransactionTest(cache.http_cache(), transaction);
+
+  disk_cache::Entry* entry;
+  ASSERT_TRUE(cache.OpenBackendEntry(transaction.url, &entry));
+  net::HttpResponseInfo response;
+  bool truncated = true;
+  EXPECT_TRUE(MockHttpCache::ReadResponseInfo(entry, &response, &truncated));
+  EXPECT_TRUE(response.body_compressed_in_cache);
+  EXPECT_FALSE(truncated);
+  EXPECT_LT(entry->GetDataSize(1), static_cast<int>(body.size()) / 4);
+  entry->Close();
+
+  // The second request is served from the cache, in small reads.
+  RunTransactionTest(cache.http_cache(), transaction);
+
+  // One of the entry opens was ours.
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(2, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+
+  RemoveMockTransaction(&transaction);
+}
+
+// Tests that a reader can follow the writer of a compressed body.
+TEST(HttpCache, SimpleGET_CompressedBody_ReaderFollowsWriter) {
+  MockHttpCache cache;
+  cache.http_cache()->set_compress_text_bodies(true);
+
+  std::string body = CompressibleBody();
+  MockTransaction transaction(kSimpleGET_Transaction);
+  transaction.response_headers =
+      "Cache-Control: max-age=10000\n"
+      "Content-Type: text/css\n";
+  transaction.data = body.c_str();
+  AddMockTransaction(&transaction);
+  MockHttpRequest request(transaction);
+
+  Context writer;
+  Context reader;
+  writer.result = cache.http_cache()->CreateTransaction(
+      net::DEFAULT_PRIORITY, &writer.trans, NULL);
+  reader.result = cache.http_cache()->CreateTransaction(
+      net::DEFAULT_PRIORITY, &reader.trans, NULL);
+  writer.result = writer.trans->Start(
+      &request, writer.callback.callback(), net::BoundNetLog());
+  reader.result = reader.trans->Start(
+      &request, reader.callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, writer.callback.GetResult(writer.result));
+
+  const int kFirstChunkSize = 10;
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(256));
+  net::TestCompletionCallback callback;
+  int rv = writer.trans->Read(buf.get(), kFirstChunkSize, callback.callback());
+  EXPECT_EQ(kFirstChunkSize, callback.GetResult(rv));
+
+  // The reader can decode what has been stored so far.
+  EXPECT_EQ(net::OK, reader.callback.WaitForResult());
+  rv = reader.trans->Read(buf.get(), 256, callback.callback());
+  EXPECT_EQ(kFirstChunkSize, callback.GetResult(rv));
+  EXPECT_EQ(body.substr(0, kFirstChunkSize),
+            std::string(buf->data(), kFirstChunkSize));
+
+  std::string content;
+  EXPECT_EQ(net::OK, ReadTransaction(writer.trans.get(), &content));
+  EXPECT_EQ(body.substr(kFirstChunkSize), content);
+  EXPECT_EQ(net::OK, ReadTransaction(reader.trans.get(), &content));
+  EXPECT_EQ(body.substr(kFirstChunkSize), content);
+
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+
+  RemoveMockTransaction(&transaction);
+}
+
+// Tests that bodies that are not text, or that are already encoded, are
+// stored as they are.
+TEST(HttpCache, SimpleGET_CompressedBody_NotCompressible) {
+  MockHttpCache cache;
+  cache.http_cache()->set_compress_text_bodies(true);
+
+  std::string body = CompressibleBody();
+  MockTransaction transaction(kSimpleGET_Transaction);
+  transaction.data = body.c_str();
+  const char* kHeaders[] = {
+    "Cache-Control: max-age=10000\n"
+    "Content-Type: image/png\n",
+    "Cache-Control: max-age=10000\n"
+    "Content-Type: text/css\n"
+    "Content-Encoding: identity\n",
+  };
+
+  for (size_t i = 0; i < arraysize(kHeaders); i++) {
+    transaction.response_headers = kHeaders[i];
+    AddMockTransaction(&transaction);
+    RunTransactionTest(cache.http_cache(), transaction);
+
+    disk_cache::Entry* entry;
+    ASSERT_TRUE(cache.OpenBackendEntry(transaction.url, &entry));
+    net::HttpResponseInfo response;
+    bool truncated = true;
+    EXPECT_TRUE(MockHttpCache::ReadResponseInfo(entry, &response, &truncated));
+    EXPECT_FALSE(response.body_compressed_in_cache);
+    EXPECT_EQ(static_cast<int>(body.size()), entry->GetDataSize(1));
+    entry->Doom();
+    entry->Close();
+    RemoveMockTransaction(&transaction);
+  }
+}
+
+// Tests that an interrupted compressed body is not kept as a truncated entry,
+// because it cannot be resumed with a byte range request.
+TEST(HttpCache, CompressedBody_NotTruncated) {
+  MockHttpCache cache;
+  cache.http_cache()->set_compress_text_bodies(true);
+
+  std::string body = CompressibleBody();
+  std::string headers = base::StringPrintf(
+      "Last-Modified: Wed, 28 Nov 2007 00:40:09 GMT\n"
+      "Content-Type: text/plain\n"
+      "Content-Length: %d\n"
+      "Etag: \"foopy\"\n", static_cast<int>(body.size()));
+  MockTransaction transaction(kSimpleGET_Transaction);
+  transaction.response_headers = headers.c_str();
+  transaction.data = body.c_str();
+  AddMockTransaction(&transaction);
+  MockHttpRequest request(transaction);
+
+  scoped_ptr<Context> c(new Context());
+  int rv = cache.http_cache()->CreateTransaction(
+      net::DEFAULT_PRIORITY, &c->trans, NULL);
+  EXPECT_EQ(net::OK, rv);
+
+  rv = c->trans->Start(&request, c->callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::OK, c->callback.GetResult(rv));
+
+  // Read part of the body.
+  scoped_refptr<net::IOBufferWithSize> buf(new net::IOBufferWithSize(10));
+  rv = c->trans->Read(buf.get(), buf->size(), c->callback.callback());
+  EXPECT_EQ(buf->size(), c->callback.GetResult(rv));
+
+  c->trans.reset();
+
+  disk_cache::Entry* entry;
+  EXPECT_FALSE(cache.OpenBackendEntry(transaction.url, &entry));
+
+  RemoveMockTransaction(&transaction);
+}
@@ -10,6 +10,7 @@
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/compiler_specific.h"
+#include "base/debug/trace_event_memory.h"
 #include "base/format_macros.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/field_trial.h"
@@ -548,6 +549,7 @@ void HttpNetworkTransaction::OnIOComplete(int result) {
 }
 
 int HttpNetworkTransaction::DoLoop(int result) {
+  TRACE_MEMORY_SUBSYSTEM("net");
   DCHECK(next_state_ != STATE_NONE);
 
   int rv = result;
@@ -17,6 +17,8 @@
 #include "net/http/http_stream_parser.h"
 #include "net/http/http_version.h"
 #include "net/socket/client_socket_handle.h"
+#include "net/socket/coalescing_write_stream_socket.h"
+#include "net/ssl/ssl_info.h"
 
 namespace net {
 
@@ -59,6 +61,13 @@ HttpPipelinedConnectionImpl::Factory::CreateNewPipeline(
     const BoundNetLog& net_log,
     bool was_npn_negotiated,
     NextProto protocol_negotiated) {
+  // Requests are written back to back, so over TLS coalesce them into as few
+  // records and socket writes as possible.
+  SSLInfo ssl_info;
+  if (connection->socket()->GetSSLInfo(&ssl_info)) {
+    connection->set_socket(
+        new CoalescingWriteStreamSocket(connection->release_socket()));
+  }
   return new HttpPipelinedConnectionImpl(connection, delegate, origin,
                                          used_ssl_config, used_proxy_info,
                                          net_log, was_npn_negotiated,
@@ -11,6 +11,7 @@
 
 #include <algorithm>
 
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/metrics/histogram.h"
 #include "base/pickle.h"
@@ -124,8 +125,54 @@ struct HttpResponseHeaders::ParsedHeader {
   std::string::const_iterator name_end;
   std::string::const_iterator value_begin;
   std::string::const_iterator value_end;
+
+  // The atom of the header name, ATOM_NONE for continuations.
+  HeaderAtom atom;
+
+  // The index in parsed_ of the next header with the same atom, or
+  // string::npos.
+  size_t next_with_same_atom;
+};
+
+namespace {
+
+// Maps the lowercase names of the headers in http_atom_list.h to their atom.
+class HeaderAtomTable {
+ public:
+  HeaderAtomTable() {
+    const char* const kAtomNames[] = {
+#define HTTP_ATOM(x) #x,
+#include "net/http/http_atom_list.h"
+#undef HTTP_ATOM
+    };
+    for (size_t i = 0; i < arraysize(kAtomNames); ++i) {
+      // CONTENT_TYPE -> content-type.
+      std::string name = StringToLowerASCII(std::string(kAtomNames[i]));
+      std::replace(name.begin(), name.end(), '_', '-');
+      atoms_[name] = static_cast<int>(i);
+    }
+  }
+
+  // Returns the index of |name| in http_atom_list.h, or -1.
+  int Find(const base::StringPiece& name) const {
+    std::string lower_name = name.as_string();
+    StringToLowerASCII(&lower_name);
+    base::hash_map<std::string, int>::const_iterator it =
+        atoms_.find(lower_name);
+    return it == atoms_.end() ? -1 : it->second;
+  }
+
+ private:
+  base::hash_map<std::string, int> atoms_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeaderAtomTable);
 };
 
+base::LazyInstance<HeaderAtomTable>::Leaky g_header_atom_table =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
 //-----------------------------------------------------------------------------
 
 HttpResponseHeaders::HttpResponseHeaders(const std::string& raw_input)
@@ -154,6 +201,8 @@ HttpResponseHeaders::HttpResponseHeaders(const std::string& raw_input)
 HttpResponseHeaders::HttpResponseHeaders(const Pickle& pickle,
                                          PickleIterator* iter)
     : response_code_(-1) {
+  std::fill(first_header_by_atom_, first_header_by_atom_ + ATOM_COUNT,
+            std::string::npos);
   std::string raw_input;
   if (pickle.ReadString(iter, &raw_input))
     Parse(raw_input);
@@ -366,6 +415,8 @@ void HttpResponseHeaders::ReplaceStatusLine(const std::string& new_status) {
 
 void HttpResponseHeaders::Parse(const std::string& raw_input) {
   raw_headers_.reserve(raw_input.size());
+  std::fill(first_header_by_atom_, first_header_by_atom_ + ATOM_COUNT,
+            std::string::npos);
 
   // ParseStatusLine adds a normalized status line to raw_headers_
   std::string::const_iterator line_begin = raw_input.begin();
@@ -412,6 +463,7 @@ void HttpResponseHeaders::Parse(const std::string& raw_input) {
               headers.values_begin(),
               headers.values_end());
   }
+  IndexParsedHeaders();
 
   DCHECK_EQ('\0', raw_headers_[raw_headers_.size() - 2]);
   DCHECK_EQ('\0', raw_headers_[raw_headers_.size() - 1]);
@@ -584,6 +636,8 @@ bool HttpResponseHeaders::HasHeader(const base::StringPiece& name) const {
 }
 
 HttpResponseHeaders::HttpResponseHeaders() : response_code_(-1) {
+  std::fill(first_header_by_atom_, first_header_by_atom_ + ATOM_COUNT,
+            std::string::npos);
 }
 
 HttpResponseHeaders::~HttpResponseHeaders() {
@@ -706,8 +760,23 @@ void HttpResponseHeaders::ParseStatusLine(
   }
 }
 
+// static
+HttpResponseHeaders::HeaderAtom HttpResponseHeaders::FindAtom(
+    const base::StringPiece& name) {
+  int atom = g_header_atom_table.Get().Find(name);
+  return atom < 0 ? ATOM_NONE : static_cast<HeaderAtom>(atom);
+}
+
 size_t HttpResponseHeaders::FindHeader(size_t from,
                                        const base::StringPiece& search) const {
+  HeaderAtom atom = FindAtom(search);
+  if (atom != ATOM_NONE) {
+    size_t i = first_header_by_atom_[atom];
+    while (i != std::string::npos && i < from)
+      i = parsed_[i].next_with_same_atom;
+    return i;
+  }
+
   for (size_t i = from; i < parsed_.size(); ++i) {
     if (parsed_[i].is_continuation())
       continue;
@@ -749,9 +818,23 @@ void HttpResponseHeaders::AddToParsed(std::string::const_iterator name_begin,
   header.name_end = name_end;
   header.value_begin = value_begin;
   header.value_end = value_end;
+  header.atom = header.is_continuation() ?
+      ATOM_NONE : FindAtom(base::StringPiece(name_begin, name_end));
+  header.next_with_same_atom = std::string::npos;
   parsed_.push_back(header);
 }
 
+void HttpResponseHeaders::IndexParsedHeaders() {
+  // Walk backwards so that each header links to the one after it.
+  for (size_t i = parsed_.size(); i > 0; --i) {
+    ParsedHeader& header = parsed_[i - 1];
+    if (header.atom == ATOM_NONE)
+      continue;
+    header.next_with_same_atom = first_header_by_atom_[header.atom];
+    first_header_by_atom_[header.atom] = i - 1;
+  }
+}
+
 void HttpResponseHeaders::AddNonCacheableHeaders(HeaderSet* result) const {
   // Add server specified transients.  Any 'cache-control: no-cache="foo,bar"'
   // headers present in the response specify additional headers that we should
@@ -279,6 +279,18 @@ class NET_EXPORT HttpResponseHeaders
   struct ParsedHeader;
   typedef std::vector<ParsedHeader> HeaderList;
 
+  // Ids for the common header names listed in http_atom_list.h.
+  enum HeaderAtom {
+#define HTTP_ATOM(x) ATOM_ ## x,
+#include "net/http/http_atom_list.h"
+#undef HTTP_ATOM
+    ATOM_COUNT,
+    ATOM_NONE = ATOM_COUNT
+  };
+
+  // Returns the atom for the header |name| (case-insensitive), or ATOM_NONE.
+  static HeaderAtom FindAtom(const base::StringPiece& name);
+
   HttpResponseHeaders();
   ~HttpResponseHeaders();
 
@@ -304,9 +316,14 @@ class NET_EXPORT HttpResponseHeaders
                        bool has_headers);
 
   // Find the header in our list (case-insensitive) starting with parsed_ at
-  // index |from|.  Returns string::npos if not found.
+  // index |from|.  Returns string::npos if not found.  Headers with an atom
+  // are found without scanning the list.
   size_t FindHeader(size_t from, const base::StringPiece& name) const;
 
+  // Links the headers of |parsed_| that have the same atom, see
+  // |first_header_by_atom_|.
+  void IndexParsedHeaders();
+
   // Add a header->value pair to our list.  If we already have header in our
   // list, append the value to it.
   void AddHeader(std::string::const_iterator name_begin,
@@ -352,6 +369,10 @@ class NET_EXPORT HttpResponseHeaders
   // header-value pairs within raw_headers_.
   HeaderList parsed_;
 
+  // The index in |parsed_| of the first header with each atom, or
+  // string::npos.  Each ParsedHeader links to the next one with its atom.
+  size_t first_header_by_atom_[ATOM_COUNT];
+
   // The raw_headers_ consists of the normalized status line (terminated with a
   // null byte) and then followed by the raw null-terminated headers from the
   // input that was passed to our constructor.  We preserve the input [*] to
@@ -529,6 +529,54 @@ TEST(HttpResponseHeadersTest, EnumerateHeader_Challenge) {
   EXPECT_FALSE(parsed->EnumerateHeader(&iter, "WWW-Authenticate", &value));
 }
 
+// Common headers are looked up through an index, others with a scan. Both
+// must find every occurrence, in order, regardless of case.
+TEST(HttpResponseHeadersTest, EnumerateHeader_CommonAndUncommonNames) {
+  std::string headers =
+      "HTTP/1.1 200 OK\n"
+      "Vary: Accept-Encoding\n"
+      "X-Custom: 1\n"
+      "Set-Cookie: a=1\n"
+      "x-custom: 2\n"
+      "VARY: Cookie\n"
+      "set-cookie: b=2\n";
+  HeadersToRaw(&headers);
+  scoped_refptr<net::HttpResponseHeaders> parsed(
+      new net::HttpResponseHeaders(headers));
+
+  void* iter = NULL;
+  std::string value;
+  EXPECT_TRUE(parsed->EnumerateHeader(&iter, "Vary", &value));
+  EXPECT_EQ("Accept-Encoding", value);
+  EXPECT_TRUE(parsed->EnumerateHeader(&iter, "vary", &value));
+  EXPECT_EQ("Cookie", value);
+  EXPECT_FALSE(parsed->EnumerateHeader(&iter, "vary", &value));
+
+  iter = NULL;
+  EXPECT_TRUE(parsed->EnumerateHeader(&iter, "set-cookie", &value));
+  EXPECT_EQ("a=1", value);
+  EXPECT_TRUE(parsed->EnumerateHeader(&iter, "set-cookie", &value));
+  EXPECT_EQ("b=2", value);
+  EXPECT_FALSE(parsed->EnumerateHeader(&iter, "set-cookie", &value));
+
+  iter = NULL;
+  EXPECT_TRUE(parsed->EnumerateHeader(&iter, "X-CUSTOM", &value));
+  EXPECT_EQ("1", value);
+  EXPECT_TRUE(parsed->EnumerateHeader(&iter, "X-CUSTOM", &value));
+  EXPECT_EQ("2", value);
+  EXPECT_FALSE(parsed->EnumerateHeader(&iter, "X-CUSTOM", &value));
+
+  EXPECT_TRUE(parsed->HasHeaderValue("vary", "cookie"));
+  EXPECT_FALSE(parsed->HasHeader("content-type"));
+
+  // The index is rebuilt when the headers change.
+  parsed->RemoveHeader("vary");
+  EXPECT_FALSE(parsed->HasHeader("vary"));
+  EXPECT_TRUE(parsed->HasHeaderValue("set-cookie", "b=2"));
+  parsed->AddHeader("Content-Type: text/html");
+  EXPECT_TRUE(parsed->HasHeaderValue("content-type", "text/html"));
+}
+
 TEST(HttpResponseHeadersTest, EnumerateHeader_DateValued) {
   // The comma in a date valued header should not be treated as a
   // field-value separator
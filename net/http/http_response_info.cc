@@ -87,6 +87,9 @@ enum {
   // This bit is set if the request has http authentication.
   RESPONSE_INFO_USE_HTTP_AUTHENTICATION = 1 << 19,
 
+  // This bit is set if the body is stored compressed by the HttpCache.
+  RESPONSE_INFO_BODY_COMPRESSED = 1 << 20,
+
   // TODO(darin): Add other bits to indicate alternate request methods.
   // For now, we don't support storing those.
 };
@@ -99,6 +102,7 @@ HttpResponseInfo::HttpResponseInfo()
       was_npn_negotiated(false),
       was_fetched_via_proxy(false),
       did_use_http_auth(false),
+      body_compressed_in_cache(false),
       connection_info(CONNECTION_INFO_UNKNOWN) {
 }
 
@@ -110,6 +114,7 @@ HttpResponseInfo::HttpResponseInfo(const HttpResponseInfo& rhs)
       was_npn_negotiated(rhs.was_npn_negotiated),
       was_fetched_via_proxy(rhs.was_fetched_via_proxy),
       did_use_http_auth(rhs.did_use_http_auth),
+      body_compressed_in_cache(rhs.body_compressed_in_cache),
       socket_address(rhs.socket_address),
       npn_negotiated_protocol(rhs.npn_negotiated_protocol),
       connection_info(rhs.connection_info),
@@ -134,6 +139,7 @@ HttpResponseInfo& HttpResponseInfo::operator=(const HttpResponseInfo& rhs) {
   was_npn_negotiated = rhs.was_npn_negotiated;
   was_fetched_via_proxy = rhs.was_fetched_via_proxy;
   did_use_http_auth = rhs.did_use_http_auth;
+  body_compressed_in_cache = rhs.body_compressed_in_cache;
   socket_address = rhs.socket_address;
   npn_negotiated_protocol = rhs.npn_negotiated_protocol;
   connection_info = rhs.connection_info;
@@ -255,6 +261,8 @@ bool HttpResponseInfo::InitFromPickle(const Pickle& pickle,
 
   did_use_http_auth = (flags & RESPONSE_INFO_USE_HTTP_AUTHENTICATION) != 0;
 
+  body_compressed_in_cache = (flags & RESPONSE_INFO_BODY_COMPRESSED) != 0;
+
   return true;
 }
 
@@ -286,6 +294,8 @@ void HttpResponseInfo::Persist(Pickle* pickle,
     flags |= RESPONSE_INFO_HAS_CONNECTION_INFO;
   if (did_use_http_auth)
     flags |= RESPONSE_INFO_USE_HTTP_AUTHENTICATION;
+  if (body_compressed_in_cache)
+    flags |= RESPONSE_INFO_BODY_COMPRESSED;
 
   pickle->WriteInt(flags);
   pickle->WriteInt64(request_time.ToInternalValue());
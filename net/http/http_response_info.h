@@ -90,6 +90,10 @@ class NET_EXPORT HttpResponseInfo {
   // Whether the request use http proxy or server authentication.
   bool did_use_http_auth;
 
+  // True if the HttpCache stores the body of this response compressed. The
+  // data returned to the caller is never compressed by the cache.
+  bool body_compressed_in_cache;
+
   // Remote address of the socket which fetched this resource.
   //
   // NOTE: If the response was served from the cache (was_cached is true),
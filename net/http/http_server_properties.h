@@ -62,6 +62,7 @@ extern const char kAlternateProtocolHeader[];
 // * SPDY support (based on NPN results)
 // * Alternate-Protocol support
 // * Spdy Settings (like CWND ID field)
+// * Whether connecting over IPv6 is broken
 class NET_EXPORT HttpServerProperties {
  public:
   HttpServerProperties() {}
@@ -132,6 +133,13 @@ class NET_EXPORT HttpServerProperties {
 
   virtual PipelineCapabilityMap GetPipelineCapabilityMap() const = 0;
 
+  // Returns true if an IPv6 connect to |server| recently lost to IPv4 or
+  // failed, so that connects should try IPv4 first.
+  virtual bool IsIPv6Broken(const HostPortPair& server) = 0;
+
+  // Records whether IPv6 connects to |server| are broken. Not persisted.
+  virtual void SetIPv6Broken(const HostPortPair& server, bool broken) = 0;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(HttpServerProperties);
 };
@@ -17,10 +17,15 @@ namespace net {
 // then, this is just a bad guess.
 static const int kDefaultNumHostsToRemember = 200;
 
+// How long a server stays marked as having broken IPv6, after which IPv6 is
+// tried first again.
+static const int kBrokenIPv6ExpiryMinutes = 10;
+
 HttpServerPropertiesImpl::HttpServerPropertiesImpl()
     : weak_ptr_factory_(this),
       pipeline_capability_map_(
-        new CachedPipelineCapabilityMap(kDefaultNumHostsToRemember)) {
+        new CachedPipelineCapabilityMap(kDefaultNumHostsToRemember)),
+      broken_ipv6_map_(kDefaultNumHostsToRemember) {
 }
 
 HttpServerPropertiesImpl::~HttpServerPropertiesImpl() {
@@ -123,6 +128,7 @@ void HttpServerPropertiesImpl::Clear() {
   alternate_protocol_map_.clear();
   spdy_settings_map_.clear();
   pipeline_capability_map_->Clear();
+  broken_ipv6_map_.Clear();
 }
 
 bool HttpServerPropertiesImpl::SupportsSpdy(
@@ -300,4 +306,27 @@ HttpServerPropertiesImpl::GetPipelineCapabilityMap() const {
   return result;
 }
 
+bool HttpServerPropertiesImpl::IsIPv6Broken(const HostPortPair& server) {
+  BrokenIPv6Map::iterator it = broken_ipv6_map_.Peek(server);
+  if (it == broken_ipv6_map_.end())
+    return false;
+  if (base::TimeTicks::Now() - it->second >
+      base::TimeDelta::FromMinutes(kBrokenIPv6ExpiryMinutes)) {
+    broken_ipv6_map_.Erase(it);
+    return false;
+  }
+  return true;
+}
+
+void HttpServerPropertiesImpl::SetIPv6Broken(const HostPortPair& server,
+                                             bool broken) {
+  if (broken) {
+    broken_ipv6_map_.Put(server, base::TimeTicks::Now());
+    return;
+  }
+  BrokenIPv6Map::iterator it = broken_ipv6_map_.Peek(server);
+  if (it != broken_ipv6_map_.end())
+    broken_ipv6_map_.Erase(it);
+}
+
 }  // namespace net
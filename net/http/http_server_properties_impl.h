@@ -14,6 +14,7 @@
 #include "base/containers/mru_cache.h"
 #include "base/gtest_prod_util.h"
 #include "base/threading/non_thread_safe.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "net/base/host_port_pair.h"
 #include "net/base/net_export.h"
@@ -138,9 +139,15 @@ class NET_EXPORT HttpServerPropertiesImpl
 
   virtual PipelineCapabilityMap GetPipelineCapabilityMap() const OVERRIDE;
 
+  virtual bool IsIPv6Broken(const HostPortPair& server) OVERRIDE;
+
+  virtual void SetIPv6Broken(const HostPortPair& server, bool broken) OVERRIDE;
+
  private:
   typedef base::MRUCache<
       HostPortPair, HttpPipelinedHostCapability> CachedPipelineCapabilityMap;
+  // Servers with broken IPv6, and when that was last seen.
+  typedef base::MRUCache<HostPortPair, base::TimeTicks> BrokenIPv6Map;
   // |spdy_servers_table_| has flattened representation of servers (host/port
   // pair) that either support or not support SPDY protocol.
   typedef base::hash_map<std::string, bool> SpdyServerHostPortTable;
@@ -152,6 +159,7 @@ class NET_EXPORT HttpServerPropertiesImpl
   AlternateProtocolMap alternate_protocol_map_;
   SpdySettingsMap spdy_settings_map_;
   scoped_ptr<CachedPipelineCapabilityMap> pipeline_capability_map_;
+  BrokenIPv6Map broken_ipv6_map_;
 
   DISALLOW_COPY_AND_ASSIGN(HttpServerPropertiesImpl);
 };
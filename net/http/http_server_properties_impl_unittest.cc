@@ -411,6 +411,24 @@ TEST_F(SpdySettingsServerPropertiesTest, Clear) {
   EXPECT_EQ(0U, impl_.GetSpdySettings(spdy_server_docs).size());
 }
 
+typedef HttpServerPropertiesImplTest IPv6BrokenServerPropertiesTest;
+
+TEST_F(IPv6BrokenServerPropertiesTest, SetIPv6Broken) {
+  HostPortPair server("www.google.com", 80);
+  EXPECT_FALSE(impl_.IsIPv6Broken(server));
+
+  impl_.SetIPv6Broken(server, true);
+  EXPECT_TRUE(impl_.IsIPv6Broken(server));
+  EXPECT_FALSE(impl_.IsIPv6Broken(HostPortPair("www.google.com", 443)));
+
+  impl_.SetIPv6Broken(server, false);
+  EXPECT_FALSE(impl_.IsIPv6Broken(server));
+
+  impl_.SetIPv6Broken(server, true);
+  impl_.Clear();
+  EXPECT_FALSE(impl_.IsIPv6Broken(server));
+}
+
 }  // namespace
 
 }  // namespace net
@@ -4,13 +4,17 @@
 
 #include "net/http/http_stream_parser.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/compiler_specific.h"
+#include "base/debug/trace_event_memory.h"
 #include "base/strings/string_util.h"
 #include "base/values.h"
 #include "net/base/io_buffer.h"
 #include "net/base/ip_endpoint.h"
 #include "net/base/upload_data_stream.h"
+#include "net/base/upload_file_element_reader.h"
 #include "net/http/http_chunked_decoder.h"
 #include "net/http/http_request_headers.h"
 #include "net/http/http_request_info.h"
@@ -24,6 +28,14 @@ namespace {
 const size_t kMaxMergedHeaderAndBodySize = 1400;
 const size_t kRequestBodyBufferSize = 1 << 14;  // 16KB
 
+// The bodies of large uploads are read from disk in bigger pieces, which also
+// lets SSL sockets fill several records per write.
+const size_t kLargeRequestBodyBufferSize = 1 << 16;  // 64KB
+
+// The number of bytes of a file that are loaded into the page cache at a
+// time when sending it with StreamSocket::SendFile().
+const int kSendFileWindowSize = 1 << 19;  // 512KB
+
 std::string GetResponseHeaderLines(const net::HttpResponseHeaders& headers) {
   std::string raw_headers = headers.raw_headers();
   const char* null_separated_headers = raw_headers.c_str();
@@ -179,6 +191,7 @@ HttpStreamParser::HttpStreamParser(ClientSocketHandle* connection,
       read_buf_(read_buffer),
       read_buf_unused_offset_(0),
       response_header_start_offset_(-1),
+      end_of_header_search_offset_(0),
       response_body_length_(-1),
       response_body_read_(0),
       user_read_buf_(NULL),
@@ -186,6 +199,9 @@ HttpStreamParser::HttpStreamParser(ClientSocketHandle* connection,
       connection_(connection),
       net_log_(net_log),
       sent_last_chunk_(false),
+      send_body_from_file_(false),
+      request_body_file_reader_(NULL),
+      request_body_file_bytes_ready_(0),
       weak_ptr_factory_(this) {
   io_callback_ = base::Bind(&HttpStreamParser::OnIOComplete,
                             weak_ptr_factory_.GetWeakPtr());
@@ -224,15 +240,22 @@ int HttpStreamParser::SendRequest(const std::string& request_line,
   std::string request = request_line + headers.ToString();
 
   if (request_->upload_data_stream != NULL) {
-    request_body_send_buf_ = new SeekableIOBuffer(kRequestBodyBufferSize);
     if (request_->upload_data_stream->is_chunked()) {
+      request_body_send_buf_ = new SeekableIOBuffer(kRequestBodyBufferSize);
       // Read buffer is adjusted to guarantee that |request_body_send_buf_| is
       // large enough to hold the encoded chunk.
       request_body_read_buf_ =
           new SeekableIOBuffer(kRequestBodyBufferSize - kChunkHeaderFooterSize);
     } else {
+      const bool is_large =
+          !request_->upload_data_stream->IsInMemory() &&
+          request_->upload_data_stream->size() > kRequestBodyBufferSize;
+      request_body_send_buf_ = new SeekableIOBuffer(
+          is_large ? kLargeRequestBodyBufferSize : kRequestBodyBufferSize);
       // No need to encode request body, just send the raw data.
       request_body_read_buf_ = request_body_send_buf_;
+      // Encrypting sockets can't send files directly, so don't bother.
+      send_body_from_file_ = !request_->url.SchemeIsSecure();
     }
   }
 
@@ -357,6 +380,7 @@ void HttpStreamParser::OnIOComplete(int result) {
 }
 
 int HttpStreamParser::DoLoop(int result) {
+  TRACE_MEMORY_SUBSYSTEM("net");
   bool can_do_more = true;
   do {
     switch (io_state_) {
@@ -375,6 +399,15 @@ int HttpStreamParser::DoLoop(int result) {
       case STATE_SEND_REQUEST_READING_BODY:
         result = DoSendRequestReadingBody(result);
         break;
+      case STATE_SEND_BODY_FROM_FILE:
+        result = DoSendBodyFromFile(result);
+        break;
+      case STATE_SEND_BODY_FROM_FILE_COMPLETE:
+        if (result < 0 && result != ERR_NOT_IMPLEMENTED)
+          can_do_more = false;
+        else
+          result = DoSendBodyFromFileComplete(result);
+        break;
       case STATE_REQUEST_SENT:
         DCHECK(result != ERR_IO_PENDING);
         can_do_more = false;
@@ -461,10 +494,28 @@ int HttpStreamParser::DoSendBody(int result) {
     return OK;
   }
 
+  int read_length = request_body_read_buf_->capacity();
+  if (send_body_from_file_) {
+    request_body_file_reader_ =
+        request_->upload_data_stream->GetFileReaderForSend();
+    if (request_body_file_reader_) {
+      io_state_ = STATE_SEND_BODY_FROM_FILE;
+      return request_body_file_reader_->PrepareToSend(kSendFileWindowSize,
+                                                      io_callback_);
+    }
+    // Don't read into the next file, which will be sent from the disk.
+    const uint64 bytes_before_file =
+        request_->upload_data_stream->GetBytesBeforeNextFile();
+    if (bytes_before_file > 0 &&
+        bytes_before_file < static_cast<uint64>(read_length)) {
+      read_length = static_cast<int>(bytes_before_file);
+    }
+  }
+
   request_body_read_buf_->Clear();
   io_state_ = STATE_SEND_REQUEST_READING_BODY;
   return request_->upload_data_stream->Read(request_body_read_buf_.get(),
-                                            request_body_read_buf_->capacity(),
+                                            read_length,
                                             io_callback_);
 }
 
@@ -501,6 +552,45 @@ int HttpStreamParser::DoSendRequestReadingBody(int result) {
   return result;
 }
 
+int HttpStreamParser::DoSendBodyFromFile(int result) {
+  // |result| is the number of bytes made ready to send by PrepareToSend(), or
+  // OK when continuing to send them.
+  if (result > 0)
+    request_body_file_bytes_ready_ = result;
+
+  if (request_body_file_bytes_ready_ <= 0) {
+    // Preparing failed; reading the file will run into the same problem and
+    // deal with it.
+    send_body_from_file_ = false;
+    io_state_ = STATE_SENDING_BODY;
+    return OK;
+  }
+
+  io_state_ = STATE_SEND_BODY_FROM_FILE_COMPLETE;
+  return connection_->socket()->SendFile(
+      request_body_file_reader_->platform_file(),
+      request_body_file_bytes_ready_,
+      io_callback_);
+}
+
+int HttpStreamParser::DoSendBodyFromFileComplete(int result) {
+  // |result| is the number of bytes sent from the file.
+  if (result == ERR_NOT_IMPLEMENTED || result == 0) {
+    // The socket can't send files, or the file got shorter. Read the rest of
+    // the body instead, which pads a file that got shorter.
+    send_body_from_file_ = false;
+    request_body_file_bytes_ready_ = 0;
+    io_state_ = STATE_SENDING_BODY;
+    return OK;
+  }
+
+  request_->upload_data_stream->DidSendFromFile(result);
+  request_body_file_bytes_ready_ -= result;
+  io_state_ = request_body_file_bytes_ready_ > 0 ? STATE_SEND_BODY_FROM_FILE
+                                                 : STATE_SENDING_BODY;
+  return OK;
+}
+
 int HttpStreamParser::DoReadHeaders() {
   io_state_ = STATE_READ_HEADERS_COMPLETE;
 
@@ -760,10 +850,18 @@ int HttpStreamParser::ParseResponseHeaders() {
   }
 
   if (response_header_start_offset_ >= 0) {
+    // Resume the search where the previous read left it, rather than
+    // scanning the whole header block again for every read.
+    int buf_len = read_buf_->offset() - read_buf_unused_offset_;
     end_offset = HttpUtil::LocateEndOfHeaders(
         read_buf_->StartOfBuffer() + read_buf_unused_offset_,
-        read_buf_->offset() - read_buf_unused_offset_,
-        response_header_start_offset_);
+        buf_len,
+        std::max(response_header_start_offset_,
+                 end_of_header_search_offset_));
+    // The end-of-headers marker is at most 3 bytes, so up to 2 of them may
+    // already be in the buffer.
+    if (end_offset == -1)
+      end_of_header_search_offset_ = std::max(0, buf_len - 2);
   } else if (read_buf_->offset() - read_buf_unused_offset_ >= 8) {
     // Enough data to decide that this is an HTTP/0.9 response.
     // 8 bytes = (4 bytes of junk) + "http".length()
@@ -772,6 +870,7 @@ int HttpStreamParser::ParseResponseHeaders() {
 
   if (end_offset == -1)
     return -1;
+  end_of_header_search_offset_ = 0;
 
   int rv = DoParseResponseHeaders(end_offset);
   if (rv < 0)
@@ -897,11 +996,10 @@ bool HttpStreamParser::IsConnectionReusable() const {
 }
 
 void HttpStreamParser::GetSSLInfo(SSLInfo* ssl_info) {
-  if (request_->url.SchemeIsSecure() && connection_->socket()) {
-    SSLClientSocket* ssl_socket =
-        static_cast<SSLClientSocket*>(connection_->socket());
-    ssl_socket->GetSSLInfo(ssl_info);
-  }
+  // The socket may be a decorator around the SSLClientSocket, so use the
+  // StreamSocket interface.
+  if (request_->url.SchemeIsSecure() && connection_->socket())
+    connection_->socket()->GetSSLInfo(ssl_info);
 }
 
 void HttpStreamParser::GetSSLCertRequestInfo(
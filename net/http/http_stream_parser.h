@@ -31,6 +31,7 @@ class IOBufferWithSize;
 class SSLCertRequestInfo;
 class SSLInfo;
 class UploadDataStream;
+class UploadFileElementReader;
 
 class NET_EXPORT_PRIVATE HttpStreamParser {
  public:
@@ -115,6 +116,10 @@ class NET_EXPORT_PRIVATE HttpStreamParser {
     // or not.
     STATE_SENDING_BODY,
     STATE_SEND_REQUEST_READING_BODY,
+    // Non-chunked file bodies are sent straight from the file, when the
+    // socket can do that, going through these states instead of reading.
+    STATE_SEND_BODY_FROM_FILE,
+    STATE_SEND_BODY_FROM_FILE_COMPLETE,
     STATE_REQUEST_SENT,
     STATE_READ_HEADERS,
     STATE_READ_HEADERS_COMPLETE,
@@ -147,6 +152,8 @@ class NET_EXPORT_PRIVATE HttpStreamParser {
   int DoSendHeaders(int result);
   int DoSendBody(int result);
   int DoSendRequestReadingBody(int result);
+  int DoSendBodyFromFile(int result);
+  int DoSendBodyFromFileComplete(int result);
   int DoReadHeaders();
   int DoReadHeadersComplete(int result);
   int DoReadBody();
@@ -185,6 +192,10 @@ class NET_EXPORT_PRIVATE HttpStreamParser {
   // -1 if not found yet.
   int response_header_start_offset_;
 
+  // The amount beyond |read_buf_unused_offset_| from which to resume looking
+  // for the end of the headers.
+  int end_of_header_search_offset_;
+
   // The parsed response headers.  Owned by the caller.
   HttpResponseInfo* response_;
 
@@ -228,6 +239,14 @@ class NET_EXPORT_PRIVATE HttpStreamParser {
   scoped_refptr<SeekableIOBuffer> request_body_send_buf_;
   bool sent_last_chunk_;
 
+  // Whether to try sending file elements of the request body with
+  // StreamSocket::SendFile(). Once that fails, the rest of the body is read.
+  bool send_body_from_file_;
+  // The element being sent from its file, and the number of its bytes that
+  // are ready to be sent.
+  UploadFileElementReader* request_body_file_reader_;
+  int request_body_file_bytes_ready_;
+
   base::WeakPtrFactory<HttpStreamParser> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(HttpStreamParser);
@@ -7,6 +7,8 @@
 
 #include "net/http/http_util.h"
 
+#include <string.h>
+
 #include <algorithm>
 
 #include "base/basictypes.h"
@@ -17,6 +19,14 @@
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/time/time.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && \
+    (defined(__SSE2__) || defined(_M_X64) || \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define HTTP_UTIL_USE_SSE2
+#include <emmintrin.h>
+#endif
 
 using std::string;
 
@@ -502,6 +512,25 @@ std::string HttpUtil::Quote(const std::string& str) {
   return escaped;
 }
 
+// Returns the offset of the first LF in |buf| at or after |i|, or |buf_len|
+// if there is none. Header blocks are mostly long lines, so 16 bytes at a
+// time are skipped while they contain no LF.
+static int FindNextLF(const char* buf, int buf_len, int i) {
+#if defined(HTTP_UTIL_USE_SSE2)
+  const __m128i lf = _mm_set1_epi8('\n');
+  for (; i + 16 <= buf_len; i += 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, lf)))
+      break;
+  }
+#endif
+  if (i >= buf_len)
+    return buf_len;
+  const void* lf_pos = memchr(buf + i, '\n', buf_len - i);
+  return lf_pos ? static_cast<int>(static_cast<const char*>(lf_pos) - buf)
+                : buf_len;
+}
+
 // Find the "http" substring in a status line. This allows for
 // some slop at the start. If the "http" string could not be found
 // then returns -1.
@@ -521,18 +550,14 @@ int HttpUtil::LocateStartOfStatusLine(const char* buf, int buf_len) {
 }
 
 int HttpUtil::LocateEndOfHeaders(const char* buf, int buf_len, int i) {
-  bool was_lf = false;
-  char last_c = '\0';
-  for (; i < buf_len; ++i) {
-    char c = buf[i];
-    if (c == '\n') {
-      if (was_lf)
-        return i + 1;
-      was_lf = true;
-    } else if (c != '\r' || last_c != '\n') {
-      was_lf = false;
-    }
-    last_c = c;
+  // Only a LF can start the end-of-headers marker, so skip from one LF to
+  // the next and check what follows it.
+  for (i = FindNextLF(buf, buf_len, i); i < buf_len;
+       i = FindNextLF(buf, buf_len, i + 1)) {
+    if (i + 1 < buf_len && buf[i + 1] == '\n')
+      return i + 2;
+    if (i + 2 < buf_len && buf[i + 1] == '\r' && buf[i + 2] == '\n')
+      return i + 3;
   }
   return -1;
 }
@@ -279,6 +279,31 @@ TEST(HttpUtilTest, LocateEndOfHeaders) {
   }
 }
 
+// Exercises the parts of the search that skip over 16 bytes at a time.
+TEST(HttpUtilTest, LocateEndOfHeadersLongLines) {
+  const std::string line = "X-Header: " + std::string(40, 'v') + "\r\n";
+  for (size_t padding = 0; padding < 20; ++padding) {
+    std::string headers = "HTTP/1.1 200 OK" + std::string(padding, ' ') +
+        "\r\n" + line + line;
+    std::string input = headers + "\r\n" + line;
+    int input_len = static_cast<int>(input.size());
+    EXPECT_EQ(static_cast<int>(headers.size()) + 2,
+              HttpUtil::LocateEndOfHeaders(input.data(), input_len));
+
+    // Truncated markers are not matched.
+    EXPECT_EQ(-1, HttpUtil::LocateEndOfHeaders(
+        input.data(), static_cast<int>(headers.size()) + 1));
+    EXPECT_EQ(-1, HttpUtil::LocateEndOfHeaders(
+        input.data(), static_cast<int>(headers.size())));
+
+    // The search can resume anywhere before the marker.
+    EXPECT_EQ(static_cast<int>(headers.size()) + 2,
+              HttpUtil::LocateEndOfHeaders(
+                  input.data(), input_len,
+                  static_cast<int>(headers.size()) - 2));
+  }
+}
+
 TEST(HttpUtilTest, AssembleRawHeaders) {
   struct {
     const char* input;  // with '|' representing '\0'
@@ -263,6 +263,9 @@ int MockDiskEntry::ReadyForSparseIO(const net::CompletionCallback& callback) {
   return net::ERR_IO_PENDING;
 }
 
+void MockDiskEntry::SetPriority(net::RequestPriority priority) {
+}
+
 // If |value| is true, don't deliver any completion callbacks until called
 // again with |value| set to false.  Caution: remember to enable callbacks
 // again or all subsequent tests will fail.
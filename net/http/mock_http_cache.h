@@ -48,6 +48,7 @@ class MockDiskEntry : public disk_cache::Entry,
   virtual void CancelSparseIO() OVERRIDE;
   virtual int ReadyForSparseIO(
       const net::CompletionCallback& completion_callback) OVERRIDE;
+  virtual void SetPriority(net::RequestPriority priority) OVERRIDE;
 
   // Fail most subsequent requests.
   void set_fail_requests() { fail_requests_ = true; }
@@ -5,13 +5,16 @@
 #include "base/base_paths.h"
 #include "base/compiler_specific.h"
 #include "base/file_util.h"
+#include "base/message_loop/message_loop.h"
 #include "base/path_service.h"
 #include "base/perftimer.h"
 #include "base/strings/string_util.h"
 #include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
 #include "net/dns/mock_host_resolver.h"
 #include "net/proxy/proxy_info.h"
 #include "net/proxy/proxy_resolver_v8.h"
+#include "net/proxy/proxy_resolver_v8_tracing.h"
 #include "net/test/spawned_test_server/spawned_test_server.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -62,6 +65,28 @@ static PacPerfTest kPerfTests[] = {
       {NULL, NULL}
     },
   },
+  // This test uses a PAC script with many rules on the host being accessed,
+  // as is common in enterprise deployments. Its results do not depend on the
+  // path of the URL, so they can be cached by ProxyResolverV8Tracing.
+  { "host-rules.pac",
+    { // queries:
+      {"http://wiki.corp.example.com/index.html", "DIRECT"},
+      {"http://wiki.corp.example.com/page/1", "DIRECT"},
+      {"http://intranet/", "DIRECT"},
+      {"http://10.1.2.3/x", "DIRECT"},
+      {"https://www.partner-b.example.net/orders/42",
+       "PROXY partner-proxy.example.com:8080"},
+      {"https://www.partner-b.example.net/orders/43",
+       "PROXY partner-proxy.example.com:8080"},
+      {"http://www.example.com/", "PROXY web-proxy.example.com:3128"},
+      {"http://www.example.com/about", "PROXY web-proxy.example.com:3128"},
+      {"http://www.google.com/", "PROXY proxy.example.com:8080;DIRECT"},
+      {"http://www.google.com/search?q=pac",
+       "PROXY proxy.example.com:8080;DIRECT"},
+      {"http://www.foobar.com/a/b/c", "PROXY proxy.example.com:8080;DIRECT"},
+      {NULL, NULL}
+    },
+  },
 };
 
 int PacPerfTest::NumQueries() const {
@@ -109,10 +134,11 @@ class PacPerfSuiteRunner {
     if (!resolver_->expects_pac_bytes()) {
       GURL pac_url =
           test_server_.GetURL(std::string("files/") + script_name);
+      net::TestCompletionCallback callback;
       int rv = resolver_->SetPacScript(
           net::ProxyResolverScriptData::FromURL(pac_url),
-          net::CompletionCallback());
-      EXPECT_EQ(net::OK, rv);
+          callback.callback());
+      EXPECT_EQ(net::OK, callback.GetResult(rv));
     } else {
       LoadPacScriptIntoResolver(script_name);
     }
@@ -122,10 +148,11 @@ class PacPerfSuiteRunner {
     // the PAC script.
     {
       net::ProxyInfo proxy_info;
+      net::TestCompletionCallback callback;
       int result = resolver_->GetProxyForURL(
-          GURL("http://www.warmup.com"), &proxy_info, net::CompletionCallback(),
+          GURL("http://www.warmup.com"), &proxy_info, callback.callback(),
           NULL, net::BoundNetLog());
-      ASSERT_EQ(net::OK, result);
+      ASSERT_EQ(net::OK, callback.GetResult(result));
     }
 
     // Start the perf timer.
@@ -136,11 +163,13 @@ class PacPerfSuiteRunner {
       // Round-robin between URLs to resolve.
       const PacQuery& query = queries[i % queries_len];
 
-      // Resolve.
+      // Resolve. Resolvers which complete asynchronously, like
+      // ProxyResolverV8Tracing, are waited for.
       net::ProxyInfo proxy_info;
-      int result = resolver_->GetProxyForURL(
-          GURL(query.query_url), &proxy_info, net::CompletionCallback(), NULL,
-          net::BoundNetLog());
+      net::TestCompletionCallback callback;
+      int result = callback.GetResult(resolver_->GetProxyForURL(
+          GURL(query.query_url), &proxy_info, callback.callback(), NULL,
+          net::BoundNetLog()));
 
       // Check that the result was correct. Note that ToPacString() and
       // ASSERT_EQ() are fast, so they won't skew the results.
@@ -170,10 +199,11 @@ class PacPerfSuiteRunner {
     ASSERT_TRUE(ok);
 
     // Load the PAC script into the ProxyResolver.
+    net::TestCompletionCallback callback;
     int rv = resolver_->SetPacScript(
         net::ProxyResolverScriptData::FromUTF8(file_contents),
-        net::CompletionCallback());
-    EXPECT_EQ(net::OK, rv);
+        callback.callback());
+    EXPECT_EQ(net::OK, callback.GetResult(rv));
   }
 
   net::ProxyResolver* resolver_;
@@ -227,3 +257,34 @@ TEST(ProxyResolverPerfTest, ProxyResolverV8) {
   PacPerfSuiteRunner runner(&resolver, "ProxyResolverV8");
   runner.RunAllTests();
 }
+
+// ProxyResolverV8Tracing runs ProxyResolverV8 on a worker thread, so this
+// measures the cost of a PAC execution including the thread hops.
+TEST(ProxyResolverPerfTest, ProxyResolverV8Tracing) {
+  base::MessageLoop message_loop;
+  net::ProxyResolverV8::RememberDefaultIsolate();
+
+  bool old_value = net::ProxyResolverV8Tracing::set_result_cache_enabled(false);
+  net::MockCachingHostResolver host_resolver;
+  net::ProxyResolverV8Tracing resolver(
+      &host_resolver, NULL, NULL);
+  PacPerfSuiteRunner runner(&resolver, "ProxyResolverV8Tracing");
+  runner.RunAllTests();
+  net::ProxyResolverV8Tracing::set_result_cache_enabled(old_value);
+}
+
+// Same as above, with the result cache. no-ads.pac depends on the path of URLs
+// and keeps running the script, while host-rules.pac is mostly answered from
+// the cache.
+TEST(ProxyResolverPerfTest, ProxyResolverV8TracingResultCache) {
+  base::MessageLoop message_loop;
+  net::ProxyResolverV8::RememberDefaultIsolate();
+
+  bool old_value = net::ProxyResolverV8Tracing::set_result_cache_enabled(true);
+  net::MockCachingHostResolver host_resolver;
+  net::ProxyResolverV8Tracing resolver(
+      &host_resolver, NULL, NULL);
+  PacPerfSuiteRunner runner(&resolver, "ProxyResolverV8TracingResultCache");
+  runner.RunAllTests();
+  net::ProxyResolverV8Tracing::set_result_cache_enabled(old_value);
+}
@@ -8,6 +8,7 @@
 #include "base/message_loop/message_loop_proxy.h"
 #include "base/metrics/histogram.h"
 #include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
 #include "base/synchronization/cancellation_flag.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/threading/thread.h"
@@ -19,6 +20,7 @@
 #include "net/dns/host_resolver.h"
 #include "net/proxy/proxy_info.h"
 #include "net/proxy/proxy_resolver_error_observer.h"
+#include "net/proxy/proxy_resolver_script_data.h"
 #include "net/proxy/proxy_resolver_v8.h"
 
 // The intent of this class is explained in the design document:
@@ -54,6 +56,45 @@ const size_t kMaxUniqueResolveDnsPerExec = 20;
 // hit this. (In fact normal scripts should not even have alerts() or errors).
 const size_t kMaxAlertsAndErrorsBytes = 2048;
 
+// The number of results kept in the result cache.
+const size_t kMaxResultCacheEntries = 256;
+
+// How long a cached result is used for. Results may depend on DNS, so this is
+// kept short.
+const int kResultCacheTTLSecs = 60;
+
+// The number of times different URLs on the same host need to have given the
+// same result before the result cache is used to answer requests.
+const int kMinPathIndependentResults = 5;
+
+// Identifiers which, when present in the script, suggest its results may
+// change between calls for the same URL. The date functions of the PAC
+// utility script are implemented with Date, but scripts call them by name.
+const char* const kTimeDependentIdentifiers[] = {
+  "Date",
+  "dateRange",
+  "timeRange",
+  "weekdayRange",
+  "random",
+};
+
+bool g_result_cache_enabled = false;
+
+// Returns true if |script_data| mentions any of kTimeDependentIdentifiers.
+bool MayBeTimeDependent(
+    const scoped_refptr<ProxyResolverScriptData>& script_data) {
+  if (script_data->type() != ProxyResolverScriptData::TYPE_SCRIPT_CONTENTS)
+    return true;
+  const base::string16& script = script_data->utf16();
+  for (size_t i = 0; i < arraysize(kTimeDependentIdentifiers); ++i) {
+    if (script.find(ASCIIToUTF16(kTimeDependentIdentifiers[i])) !=
+        base::string16::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
 // Returns event parameters for a PAC error message (line number + message).
 base::Value* NetLogErrorCallback(int line_number,
                                  const base::string16* message,
@@ -509,6 +550,12 @@ void ProxyResolverV8Tracing::Job::NotifyCallerOnOriginLoop(int result) {
   if (operation_ == GET_PROXY_FOR_URL) {
     RecordMetrics();
     *user_results_ = results_;
+    if (result == OK) {
+      parent_->OnProxyResolved(
+          url_, results_,
+          !blocking_dns_ && metrics_num_alerts_ == 0 &&
+              metrics_num_errors_ == 0);
+    }
   }
 
   // There is only ever 1 outstanding SET_PAC_SCRIPT job. It needs to be
@@ -1096,7 +1143,11 @@ ProxyResolverV8Tracing::ProxyResolverV8Tracing(
       host_resolver_(host_resolver),
       error_observer_(error_observer),
       net_log_(net_log),
-      num_outstanding_callbacks_(0) {
+      num_outstanding_callbacks_(0),
+      result_cache_(kMaxResultCacheEntries),
+      script_may_be_time_dependent_(true),
+      script_depends_on_path_(false),
+      num_path_independent_results_(0) {
   DCHECK(host_resolver);
   // Start up the thread.
   thread_.reset(new base::Thread("Proxy resolver"));
@@ -1126,6 +1177,17 @@ int ProxyResolverV8Tracing::GetProxyForURL(const GURL& url,
   DCHECK(!callback.is_null());
   DCHECK(!set_pac_script_job_.get());
 
+  if (CanServeFromResultCache()) {
+    ResultCache::iterator it = result_cache_.Get(url.GetOrigin().spec());
+    bool hit = it != result_cache_.end() &&
+        it->second.expiration > base::TimeTicks::Now();
+    UMA_HISTOGRAM_BOOLEAN("Net.ProxyResolver.ResultCacheHit", hit);
+    if (hit) {
+      *results = it->second.info;
+      return OK;
+    }
+  }
+
   scoped_refptr<Job> job = new Job(this);
 
   if (request)
@@ -1152,6 +1214,7 @@ void ProxyResolverV8Tracing::CancelSetPacScript() {
 }
 
 void ProxyResolverV8Tracing::PurgeMemory() {
+  result_cache_.Clear();
   thread_->message_loop()->PostTask(
       FROM_HERE,
       base::Bind(&ProxyResolverV8::PurgeMemory,
@@ -1172,10 +1235,65 @@ int ProxyResolverV8Tracing::SetPacScript(
   DCHECK(!set_pac_script_job_.get());
   CHECK_EQ(0, num_outstanding_callbacks_);
 
+  result_cache_.Clear();
+  script_may_be_time_dependent_ = MayBeTimeDependent(script_data);
+  script_depends_on_path_ = false;
+  num_path_independent_results_ = 0;
+
   set_pac_script_job_ = new Job(this);
   set_pac_script_job_->StartSetPacScript(script_data, callback);
 
   return ERR_IO_PENDING;
 }
 
+// static
+bool ProxyResolverV8Tracing::set_result_cache_enabled(bool enabled) {
+  bool old_value = g_result_cache_enabled;
+  g_result_cache_enabled = enabled;
+  return old_value;
+}
+
+// static
+bool ProxyResolverV8Tracing::result_cache_enabled() {
+  return g_result_cache_enabled;
+}
+
+bool ProxyResolverV8Tracing::CanUseResultCache() const {
+  return g_result_cache_enabled && !script_may_be_time_dependent_ &&
+      !script_depends_on_path_;
+}
+
+bool ProxyResolverV8Tracing::CanServeFromResultCache() const {
+  return CanUseResultCache() &&
+      num_path_independent_results_ >= kMinPathIndependentResults;
+}
+
+void ProxyResolverV8Tracing::OnProxyResolved(const GURL& url,
+                                             const ProxyInfo& results,
+                                             bool deterministic) {
+  DCHECK(CalledOnValidThread());
+  if (!CanUseResultCache() || !deterministic)
+    return;
+
+  std::string key = url.GetOrigin().spec();
+  ResultCache::iterator it = result_cache_.Get(key);
+  if (it != result_cache_.end() && it->second.url != url) {
+    // The script is only assumed to ignore the path, query and fragment of
+    // URLs once it has been seen to do so.
+    if (it->second.info.ToPacString() != results.ToPacString()) {
+      script_depends_on_path_ = true;
+      result_cache_.Clear();
+      return;
+    }
+    ++num_path_independent_results_;
+  }
+
+  CachedResult cached_result;
+  cached_result.info = results;
+  cached_result.url = url;
+  cached_result.expiration = base::TimeTicks::Now() +
+      base::TimeDelta::FromSeconds(kResultCacheTTLSecs);
+  result_cache_.Put(key, cached_result);
+}
+
 }  // namespace net
@@ -5,12 +5,18 @@
 #ifndef NET_PROXY_PROXY_RESOLVER_V8_TRACING_H_
 #define NET_PROXY_PROXY_RESOLVER_V8_TRACING_H_
 
+#include <string>
+
 #include "base/basictypes.h"
+#include "base/containers/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/threading/non_thread_safe.h"
+#include "base/time/time.h"
 #include "net/base/net_export.h"
+#include "net/proxy/proxy_info.h"
 #include "net/proxy/proxy_resolver.h"
+#include "url/gurl.h"
 
 namespace base {
 class Thread;
@@ -58,9 +64,40 @@ class NET_EXPORT_PRIVATE ProxyResolverV8Tracing
       const scoped_refptr<ProxyResolverScriptData>& script_data,
       const CompletionCallback& callback) OVERRIDE;
 
+  // Enables answering GetProxyForURL() synchronously from earlier results for
+  // the same scheme, host and port. Returns the previous value. Disabled by
+  // default.
+  //
+  // Results are only reused once the script has been seen to give the same
+  // answer for different URLs on the same host, and never for scripts that
+  // refer to the date or to random numbers. See CanServeFromResultCache().
+  static bool set_result_cache_enabled(bool enabled);
+  static bool result_cache_enabled();
+
  private:
   class Job;
 
+  struct CachedResult {
+    ProxyInfo info;
+    // The URL |info| was resolved for.
+    GURL url;
+    base::TimeTicks expiration;
+  };
+  typedef base::MRUCache<std::string, CachedResult> ResultCache;
+
+  // Returns true if results may be recorded in |result_cache_|.
+  bool CanUseResultCache() const;
+
+  // Returns true if lookups may be answered from |result_cache_|. That takes
+  // enough results which were the same for different paths on a host.
+  bool CanServeFromResultCache() const;
+
+  // Called by a Job when it resolved |url| to |results|. |deterministic| is
+  // false if the execution had alerts or errors, or fell back to blocking DNS.
+  void OnProxyResolved(const GURL& url,
+                       const ProxyInfo& results,
+                       bool deterministic);
+
   // The worker thread on which the ProxyResolverV8 will be run.
   scoped_ptr<base::Thread> thread_;
   scoped_ptr<ProxyResolverV8> v8_resolver_;
@@ -77,6 +114,19 @@ class NET_EXPORT_PRIVATE ProxyResolverV8Tracing
   // The number of outstanding (non-cancelled) jobs.
   int num_outstanding_callbacks_;
 
+  // Earlier results of GetProxyForURL(), keyed by the origin of the URL.
+  ResultCache result_cache_;
+
+  // Whether the current script text refers to something that may make its
+  // results change from one call to the next, like the date.
+  bool script_may_be_time_dependent_;
+
+  // Set once two URLs on the same host were seen to give different results.
+  bool script_depends_on_path_;
+
+  // The number of times two URLs on the same host gave the same result.
+  int num_path_independent_results_;
+
   DISALLOW_COPY_AND_ASSIGN(ProxyResolverV8Tracing);
 };
 
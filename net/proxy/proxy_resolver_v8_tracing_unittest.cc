@@ -66,6 +66,41 @@ void InitResolver(ProxyResolverV8Tracing* resolver, const char* filename) {
   EXPECT_EQ(OK, callback.WaitForResult());
 }
 
+void InitResolverWithScript(ProxyResolverV8Tracing* resolver,
+                            const char* script) {
+  TestCompletionCallback callback;
+  int rv = resolver->SetPacScript(ProxyResolverScriptData::FromUTF8(script),
+                                  callback.callback());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(OK, callback.WaitForResult());
+}
+
+// Enables the result cache of ProxyResolverV8Tracing for the scope.
+class ScopedEnableResultCache {
+ public:
+  ScopedEnableResultCache()
+      : old_value_(ProxyResolverV8Tracing::set_result_cache_enabled(true)) {}
+  ~ScopedEnableResultCache() {
+    ProxyResolverV8Tracing::set_result_cache_enabled(old_value_);
+  }
+
+ private:
+  bool old_value_;
+};
+
+// Resolves |url| and returns the result, or ERR_IO_PENDING if the request did
+// not complete synchronously.
+int ResolveUrl(ProxyResolverV8Tracing* resolver,
+               const std::string& url,
+               ProxyInfo* proxy_info) {
+  TestCompletionCallback callback;
+  int rv = resolver->GetProxyForURL(GURL(url), proxy_info, callback.callback(),
+                                    NULL, BoundNetLog());
+  if (rv == ERR_IO_PENDING)
+    EXPECT_EQ(OK, callback.WaitForResult());
+  return rv;
+}
+
 class MockErrorObserver : public ProxyResolverErrorObserver {
  public:
   MockErrorObserver() : event_(true, false) {}
@@ -1093,6 +1128,100 @@ TEST_F(ProxyResolverV8TracingTest, MultipleResolvers) {
   }
 }
 
+// Tests that results are answered from the cache once the script was seen to
+// ignore the path of URLs.
+TEST_F(ProxyResolverV8TracingTest, ResultCache) {
+  ScopedEnableResultCache enable_result_cache;
+  MockCachingHostResolver host_resolver;
+  ProxyResolverV8Tracing resolver(&host_resolver, new MockErrorObserver, NULL);
+  InitResolverWithScript(
+      &resolver,
+      "function FindProxyForURL(url, host) {\n"
+      "  return 'PROXY ' + host + ':99';\n"
+      "}\n");
+
+  // The first results for a host are computed by the script, as it has not
+  // yet been seen to ignore paths.
+  for (int i = 0; i < 6; ++i) {
+    ProxyInfo proxy_info;
+    EXPECT_EQ(ERR_IO_PENDING,
+              ResolveUrl(&resolver, base::StringPrintf("http://foo/%d", i),
+                         &proxy_info));
+    EXPECT_EQ("foo:99", proxy_info.proxy_server().ToURI());
+  }
+
+  ProxyInfo proxy_info;
+  EXPECT_EQ(OK, ResolveUrl(&resolver, "http://foo/other", &proxy_info));
+  EXPECT_EQ("foo:99", proxy_info.proxy_server().ToURI());
+
+  // Other hosts are still computed by the script.
+  EXPECT_EQ(ERR_IO_PENDING,
+            ResolveUrl(&resolver, "http://bar/", &proxy_info));
+  EXPECT_EQ("bar:99", proxy_info.proxy_server().ToURI());
+  EXPECT_EQ(OK, ResolveUrl(&resolver, "http://bar/other", &proxy_info));
+  EXPECT_EQ("bar:99", proxy_info.proxy_server().ToURI());
+
+  // Setting a new script clears the cache.
+  InitResolverWithScript(
+      &resolver,
+      "function FindProxyForURL(url, host) {\n"
+      "  return 'DIRECT';\n"
+      "}\n");
+  EXPECT_EQ(ERR_IO_PENDING,
+            ResolveUrl(&resolver, "http://foo/other", &proxy_info));
+  EXPECT_TRUE(proxy_info.is_direct());
+}
+
+// Tests that the cache is not used for scripts that depend on the path.
+TEST_F(ProxyResolverV8TracingTest, ResultCachePathDependentScript) {
+  ScopedEnableResultCache enable_result_cache;
+  MockCachingHostResolver host_resolver;
+  ProxyResolverV8Tracing resolver(&host_resolver, new MockErrorObserver, NULL);
+  InitResolverWithScript(
+      &resolver,
+      "function FindProxyForURL(url, host) {\n"
+      "  if (url.indexOf('/proxied') != -1)\n"
+      "    return 'PROXY foo:99';\n"
+      "  return 'DIRECT';\n"
+      "}\n");
+
+  ProxyInfo proxy_info;
+  EXPECT_EQ(ERR_IO_PENDING, ResolveUrl(&resolver, "http://foo/", &proxy_info));
+  EXPECT_TRUE(proxy_info.is_direct());
+  EXPECT_EQ(ERR_IO_PENDING,
+            ResolveUrl(&resolver, "http://foo/proxied", &proxy_info));
+  EXPECT_EQ("foo:99", proxy_info.proxy_server().ToURI());
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(ERR_IO_PENDING,
+              ResolveUrl(&resolver, base::StringPrintf("http://foo/%d", i),
+                         &proxy_info));
+    EXPECT_TRUE(proxy_info.is_direct());
+  }
+}
+
+// Tests that the cache is not used for scripts that depend on the time.
+TEST_F(ProxyResolverV8TracingTest, ResultCacheTimeDependentScript) {
+  ScopedEnableResultCache enable_result_cache;
+  MockCachingHostResolver host_resolver;
+  ProxyResolverV8Tracing resolver(&host_resolver, new MockErrorObserver, NULL);
+  InitResolverWithScript(
+      &resolver,
+      "function FindProxyForURL(url, host) {\n"
+      "  if (timeRange(0, 23))\n"
+      "    return 'PROXY foo:99';\n"
+      "  return 'PROXY foo:99';\n"
+      "}\n");
+
+  for (int i = 0; i < 10; ++i) {
+    ProxyInfo proxy_info;
+    EXPECT_EQ(ERR_IO_PENDING,
+              ResolveUrl(&resolver, base::StringPrintf("http://foo/%d", i),
+                         &proxy_info));
+    EXPECT_EQ("foo:99", proxy_info.proxy_server().ToURI());
+  }
+}
+
 }  // namespace
 
 }  // namespace net
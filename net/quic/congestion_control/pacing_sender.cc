@@ -0,0 +1,122 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/congestion_control/pacing_sender.h"
+
+#include "base/logging.h"
+
+namespace net {
+
+namespace {
+
+// Packets are sent at this multiple of the estimated bandwidth, so that the
+// congestion window rather than the pacing limits the rate.
+const float kPacingGain = 1.25f;
+
+// Packets due this soon are sent right away, as the send alarm is not
+// precise enough to wait for them.
+const int64 kAlarmGranularityUs = 1000;
+
+}  // namespace
+
+PacingSender::PacingSender(SendAlgorithmInterface* sender)
+    : sender_(sender),
+      next_packet_send_time_(QuicTime::Zero()),
+      delayed_since_(QuicTime::Zero()),
+      packets_paced_(0),
+      pacing_delay_(QuicTime::Delta::Zero()) {
+}
+
+PacingSender::~PacingSender() {
+}
+
+void PacingSender::OnIncomingQuicCongestionFeedbackFrame(
+    const QuicCongestionFeedbackFrame& feedback,
+    QuicTime feedback_receive_time,
+    const SentPacketsMap& sent_packets) {
+  sender_->OnIncomingQuicCongestionFeedbackFrame(
+      feedback, feedback_receive_time, sent_packets);
+}
+
+void PacingSender::OnIncomingAck(
+    QuicPacketSequenceNumber acked_sequence_number,
+    QuicByteCount acked_bytes,
+    QuicTime::Delta rtt) {
+  sender_->OnIncomingAck(acked_sequence_number, acked_bytes, rtt);
+}
+
+void PacingSender::OnIncomingLoss(QuicTime ack_receive_time) {
+  sender_->OnIncomingLoss(ack_receive_time);
+}
+
+void PacingSender::SentPacket(QuicTime sent_time,
+                              QuicPacketSequenceNumber sequence_number,
+                              QuicByteCount bytes,
+                              Retransmission is_retransmission) {
+  sender_->SentPacket(sent_time, sequence_number, bytes, is_retransmission);
+
+  if (delayed_since_.IsInitialized()) {
+    ++packets_paced_;
+    pacing_delay_ = pacing_delay_.Add(sent_time.Subtract(delayed_since_));
+    delayed_since_ = QuicTime::Zero();
+  }
+
+  QuicBandwidth pacing_rate = PacingRate();
+  if (pacing_rate.IsZero()) {
+    return;
+  }
+  // Don't let the time spent idle turn into a burst.
+  if (next_packet_send_time_ < sent_time) {
+    next_packet_send_time_ = sent_time;
+  }
+  next_packet_send_time_ = next_packet_send_time_.Add(
+      QuicTime::Delta::FromMicroseconds(
+          bytes * 1000000 / pacing_rate.ToBytesPerSecond()));
+}
+
+void PacingSender::AbandoningPacket(QuicPacketSequenceNumber sequence_number,
+                                    QuicByteCount abandoned_bytes) {
+  sender_->AbandoningPacket(sequence_number, abandoned_bytes);
+}
+
+QuicTime::Delta PacingSender::TimeUntilSend(
+    QuicTime now,
+    Retransmission is_retransmission,
+    HasRetransmittableData has_retransmittable_data,
+    IsHandshake handshake) {
+  QuicTime::Delta time_until_send = sender_->TimeUntilSend(
+      now, is_retransmission, has_retransmittable_data, handshake);
+  // Acks are not paced, and neither is what the sender holds back itself.
+  if (!time_until_send.IsZero() ||
+      has_retransmittable_data == NO_RETRANSMITTABLE_DATA) {
+    return time_until_send;
+  }
+
+  QuicTime::Delta pacing_delay = next_packet_send_time_.Subtract(now);
+  if (pacing_delay.ToMicroseconds() <= kAlarmGranularityUs) {
+    return QuicTime::Delta::Zero();
+  }
+  if (!delayed_since_.IsInitialized()) {
+    delayed_since_ = now;
+  }
+  return pacing_delay;
+}
+
+QuicBandwidth PacingSender::BandwidthEstimate() {
+  return sender_->BandwidthEstimate();
+}
+
+QuicTime::Delta PacingSender::SmoothedRtt() {
+  return sender_->SmoothedRtt();
+}
+
+QuicTime::Delta PacingSender::RetransmissionDelay() {
+  return sender_->RetransmissionDelay();
+}
+
+QuicBandwidth PacingSender::PacingRate() {
+  return sender_->BandwidthEstimate().Scale(kPacingGain);
+}
+
+}  // namespace net
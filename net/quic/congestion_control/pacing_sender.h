@@ -0,0 +1,86 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// A send algorithm which paces the packets of another one.
+
+#ifndef NET_QUIC_CONGESTION_CONTROL_PACING_SENDER_H_
+#define NET_QUIC_CONGESTION_CONTROL_PACING_SENDER_H_
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "base/memory/scoped_ptr.h"
+#include "net/base/net_export.h"
+#include "net/quic/congestion_control/send_algorithm_interface.h"
+#include "net/quic/quic_bandwidth.h"
+#include "net/quic/quic_time.h"
+
+namespace net {
+
+// Wraps any SendAlgorithmInterface, and spreads the packets it allows out
+// over time at a little more than its estimated bandwidth, rather than
+// letting a whole congestion window go out in a burst as soon as an ack
+// opens it. The delays are returned from TimeUntilSend(), so it is the
+// connection's send alarm which releases the paced packets.
+//
+// Packets due within the alarm granularity go out together as a short
+// train, and nothing is paced until the wrapped sender has a bandwidth
+// estimate.
+class NET_EXPORT_PRIVATE PacingSender : public SendAlgorithmInterface {
+ public:
+  // Takes ownership of |sender|.
+  explicit PacingSender(SendAlgorithmInterface* sender);
+  virtual ~PacingSender();
+
+  // Start implementation of SendAlgorithmInterface.
+  virtual void OnIncomingQuicCongestionFeedbackFrame(
+      const QuicCongestionFeedbackFrame& feedback,
+      QuicTime feedback_receive_time,
+      const SentPacketsMap& sent_packets) OVERRIDE;
+  virtual void OnIncomingAck(QuicPacketSequenceNumber acked_sequence_number,
+                             QuicByteCount acked_bytes,
+                             QuicTime::Delta rtt) OVERRIDE;
+  virtual void OnIncomingLoss(QuicTime ack_receive_time) OVERRIDE;
+  virtual void SentPacket(QuicTime sent_time,
+                          QuicPacketSequenceNumber sequence_number,
+                          QuicByteCount bytes,
+                          Retransmission is_retransmission) OVERRIDE;
+  virtual void AbandoningPacket(QuicPacketSequenceNumber sequence_number,
+                                QuicByteCount abandoned_bytes) OVERRIDE;
+  virtual QuicTime::Delta TimeUntilSend(
+      QuicTime now,
+      Retransmission is_retransmission,
+      HasRetransmittableData has_retransmittable_data,
+      IsHandshake handshake) OVERRIDE;
+  virtual QuicBandwidth BandwidthEstimate() OVERRIDE;
+  virtual QuicTime::Delta SmoothedRtt() OVERRIDE;
+  virtual QuicTime::Delta RetransmissionDelay() OVERRIDE;
+  // End implementation of SendAlgorithmInterface.
+
+  // The rate packets are currently sent at, or zero if they are not paced.
+  QuicBandwidth PacingRate();
+
+  // The number of packets which had to wait for the pacing.
+  uint32 packets_paced() const { return packets_paced_; }
+
+  // The total time packets waited for the pacing.
+  QuicTime::Delta pacing_delay() const { return pacing_delay_; }
+
+ private:
+  scoped_ptr<SendAlgorithmInterface> sender_;
+
+  // The earliest time the next packet may be sent at.
+  QuicTime next_packet_send_time_;
+  // When the packet waiting for the pacing was first held back, or
+  // QuicTime::Zero() if none is.
+  QuicTime delayed_since_;
+
+  uint32 packets_paced_;
+  QuicTime::Delta pacing_delay_;
+
+  DISALLOW_COPY_AND_ASSIGN(PacingSender);
+};
+
+}  // namespace net
+
+#endif  // NET_QUIC_CONGESTION_CONTROL_PACING_SENDER_H_
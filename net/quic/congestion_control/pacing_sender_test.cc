@@ -0,0 +1,113 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/congestion_control/pacing_sender.h"
+
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "net/quic/quic_protocol.h"
+#include "net/quic/test_tools/mock_clock.h"
+#include "net/quic/test_tools/quic_test_utils.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using testing::Return;
+using testing::_;
+
+namespace net {
+namespace test {
+
+const QuicByteCount kPacketSize = 1200;
+
+class PacingSenderTest : public ::testing::Test {
+ protected:
+  PacingSenderTest()
+      : mock_sender_(new MockSendAlgorithm()),
+        pacing_sender_(new PacingSender(mock_sender_)),
+        sequence_number_(1) {
+    // Pick arbitrary time.
+    clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(9));
+    EXPECT_CALL(*mock_sender_, TimeUntilSend(_, _, _, _))
+        .WillRepeatedly(Return(QuicTime::Delta::Zero()));
+  }
+
+  void SetBandwidth(QuicBandwidth bandwidth) {
+    EXPECT_CALL(*mock_sender_, BandwidthEstimate())
+        .WillRepeatedly(Return(bandwidth));
+  }
+
+  QuicTime::Delta TimeUntilSend() {
+    return pacing_sender_->TimeUntilSend(clock_.Now(), NOT_RETRANSMISSION,
+                                         HAS_RETRANSMITTABLE_DATA,
+                                         NOT_HANDSHAKE);
+  }
+
+  void SendPacket() {
+    EXPECT_CALL(*mock_sender_, SentPacket(clock_.Now(), sequence_number_,
+                                          kPacketSize, NOT_RETRANSMISSION));
+    pacing_sender_->SentPacket(clock_.Now(), sequence_number_++, kPacketSize,
+                               NOT_RETRANSMISSION);
+  }
+
+  MockClock clock_;
+  MockSendAlgorithm* mock_sender_;  // Owned by |pacing_sender_|.
+  scoped_ptr<PacingSender> pacing_sender_;
+  QuicPacketSequenceNumber sequence_number_;
+};
+
+TEST_F(PacingSenderTest, NoBandwidthEstimate) {
+  SetBandwidth(QuicBandwidth::Zero());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(TimeUntilSend().IsZero());
+    SendPacket();
+  }
+  EXPECT_TRUE(TimeUntilSend().IsZero());
+  EXPECT_EQ(0u, pacing_sender_->packets_paced());
+}
+
+TEST_F(PacingSenderTest, PacesAtEstimatedBandwidth) {
+  // With the pacing gain, one packet every 5ms.
+  SetBandwidth(QuicBandwidth::FromBytesPerSecond(kPacketSize * 200 * 4 / 5));
+  EXPECT_EQ(kPacketSize * 200,
+            static_cast<QuicByteCount>(
+                pacing_sender_->PacingRate().ToBytesPerSecond()));
+
+  EXPECT_TRUE(TimeUntilSend().IsZero());
+  SendPacket();
+  EXPECT_EQ(5000, TimeUntilSend().ToMicroseconds());
+
+  // Within the alarm granularity, the packet goes now.
+  clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(4));
+  EXPECT_TRUE(TimeUntilSend().IsZero());
+  SendPacket();
+  // The next one is due 5ms after the last one was, not after now.
+  EXPECT_EQ(6000, TimeUntilSend().ToMicroseconds());
+
+  clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(6));
+  EXPECT_TRUE(TimeUntilSend().IsZero());
+  SendPacket();
+  EXPECT_EQ(2u, pacing_sender_->packets_paced());
+  EXPECT_EQ(10000, pacing_sender_->pacing_delay().ToMicroseconds());
+
+  // After being idle, there is no burst to catch up.
+  clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(100));
+  EXPECT_TRUE(TimeUntilSend().IsZero());
+  SendPacket();
+  EXPECT_EQ(5000, TimeUntilSend().ToMicroseconds());
+}
+
+TEST_F(PacingSenderTest, AcksAndCongestionDelaysAreNotPaced) {
+  SetBandwidth(QuicBandwidth::FromBytesPerSecond(kPacketSize * 200 * 4 / 5));
+  SendPacket();
+
+  EXPECT_TRUE(pacing_sender_->TimeUntilSend(
+      clock_.Now(), NOT_RETRANSMISSION, NO_RETRANSMITTABLE_DATA,
+      NOT_HANDSHAKE).IsZero());
+
+  EXPECT_CALL(*mock_sender_, TimeUntilSend(_, _, _, _))
+      .WillOnce(Return(QuicTime::Delta::Infinite()));
+  EXPECT_TRUE(TimeUntilSend().IsInfinite());
+}
+
+}  // namespace test
+}  // namespace net
@@ -8,6 +8,7 @@
 #include <map>
 
 #include "base/stl_util.h"
+#include "net/quic/congestion_control/pacing_sender.h"
 #include "net/quic/congestion_control/receive_algorithm_interface.h"
 #include "net/quic/congestion_control/send_algorithm_interface.h"
 
@@ -40,6 +41,7 @@ QuicCongestionManager::QuicCongestionManager(
     : clock_(clock),
       receive_algorithm_(ReceiveAlgorithmInterface::Create(clock, type)),
       send_algorithm_(SendAlgorithmInterface::Create(clock, type)),
+      pacing_sender_(NULL),
       largest_missing_(0),
       current_rtt_(QuicTime::Delta::Infinite()) {
 }
@@ -194,6 +196,14 @@ QuicBandwidth QuicCongestionManager::BandwidthEstimate() {
   return send_algorithm_->BandwidthEstimate();
 }
 
+void QuicCongestionManager::EnablePacing() {
+  if (pacing_sender_) {
+    return;
+  }
+  pacing_sender_ = new PacingSender(send_algorithm_.release());
+  send_algorithm_.reset(pacing_sender_);
+}
+
 void QuicCongestionManager::CleanupPacketHistory() {
   const QuicTime::Delta kHistoryPeriod =
       QuicTime::Delta::FromMilliseconds(kHistoryPeriodMs);
@@ -27,6 +27,7 @@ class QuicConnectionPeer;
 class QuicCongestionManagerPeer;
 }  // namespace test
 
+class PacingSender;
 class QuicClock;
 class ReceiveAlgorithmInterface;
 
@@ -95,6 +96,12 @@ class NET_EXPORT_PRIVATE QuicCongestionManager {
   // Returns the estimated bandwidth calculated by the congestion algorithm.
   QuicBandwidth BandwidthEstimate();
 
+  // Paces the packets allowed by the send algorithm with a PacingSender.
+  void EnablePacing();
+
+  // The PacingSender, or NULL if pacing is not enabled.
+  const PacingSender* pacing_sender() const { return pacing_sender_; }
+
  private:
   friend class test::QuicConnectionPeer;
   friend class test::QuicCongestionManagerPeer;
@@ -108,6 +115,8 @@ class NET_EXPORT_PRIVATE QuicCongestionManager {
   const QuicClock* clock_;
   scoped_ptr<ReceiveAlgorithmInterface> receive_algorithm_;
   scoped_ptr<SendAlgorithmInterface> send_algorithm_;
+  // Owned by |send_algorithm_|.
+  PacingSender* pacing_sender_;
   SendAlgorithmInterface::SentPacketsMap packet_history_map_;
   PendingPacketsMap pending_packets_;
   QuicPacketSequenceNumber largest_missing_;
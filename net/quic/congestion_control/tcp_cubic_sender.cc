@@ -149,7 +149,12 @@ QuicBandwidth TcpCubicSender::BandwidthEstimate() {
   // TODO(pwestin): make a long term estimate, based on RTT and loss rate? or
   // instantaneous estimate?
   // Throughput ~= (1/RTT)*sqrt(3/2p)
-  return QuicBandwidth::Zero();
+  // Until then, one congestion window per RTT is what the sender allows.
+  if (smoothed_rtt_.IsZero()) {
+    return QuicBandwidth::Zero();
+  }
+  return QuicBandwidth::FromBytesAndTimeDelta(
+      congestion_window_ * kMaxSegmentSize, smoothed_rtt_);
 }
 
 QuicTime::Delta TcpCubicSender::SmoothedRtt() {
@@ -12,6 +12,8 @@
 
 #if defined(USE_OPENSSL)
 #include "net/quic/crypto/scoped_evp_cipher_ctx.h"
+#else
+#include "crypto/scoped_nss_types.h"
 #endif
 
 namespace net {
@@ -50,6 +52,11 @@ class NET_EXPORT_PRIVATE Aes128Gcm12Decrypter : public QuicDecrypter {
   virtual QuicData* DecryptPacket(QuicPacketSequenceNumber sequence_number,
                                   base::StringPiece associated_data,
                                   base::StringPiece ciphertext) OVERRIDE;
+  virtual bool DecryptPacketInBuffer(QuicPacketSequenceNumber sequence_number,
+                                     base::StringPiece associated_data,
+                                     base::StringPiece ciphertext,
+                                     char* output,
+                                     size_t* output_length) OVERRIDE;
   virtual base::StringPiece GetKey() const OVERRIDE;
   virtual base::StringPiece GetNoncePrefix() const OVERRIDE;
 
@@ -61,6 +68,10 @@ class NET_EXPORT_PRIVATE Aes128Gcm12Decrypter : public QuicDecrypter {
 
 #if defined(USE_OPENSSL)
   ScopedEVPCipherCtx ctx_;
+#else
+  // |key_| imported into NSS. It is imported once, in SetKey(), rather than
+  // for every packet.
+  crypto::ScopedPK11SymKey aes_key_;
 #endif
 };
 
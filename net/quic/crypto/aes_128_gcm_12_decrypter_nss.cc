@@ -271,6 +271,25 @@ bool Aes128Gcm12Decrypter::SetKey(StringPiece key) {
     return false;
   }
   memcpy(key_, key.data(), key.size());
+
+  // Import key_ into NSS.
+  SECItem key_item;
+  key_item.type = siBuffer;
+  key_item.data = key_;
+  key_item.len = sizeof(key_);
+  PK11SlotInfo* slot = PK11_GetInternalSlot();
+  // The exact value of the |origin| argument doesn't matter to NSS as long as
+  // it's not PK11_OriginFortezzaHack, so we pass PK11_OriginUnwrap as a
+  // placeholder.
+  aes_key_.reset(PK11_ImportSymKey(
+      slot, GcmSupportChecker::aes_key_mechanism(), PK11_OriginUnwrap,
+      CKA_DECRYPT, &key_item, NULL));
+  PK11_FreeSlot(slot);
+  slot = NULL;
+  if (!aes_key_) {
+    DLOG(INFO) << "PK11_ImportSymKey failed";
+    return false;
+  }
   return true;
 }
 
@@ -300,22 +319,7 @@ bool Aes128Gcm12Decrypter::Decrypt(StringPiece nonce,
   // |ciphertext| on entry.
   size_t plaintext_size = ciphertext.length() - kAuthTagSize;
 
-  // Import key_ into NSS.
-  SECItem key_item;
-  key_item.type = siBuffer;
-  key_item.data = key_;
-  key_item.len = sizeof(key_);
-  PK11SlotInfo* slot = PK11_GetInternalSlot();
-  // The exact value of the |origin| argument doesn't matter to NSS as long as
-  // it's not PK11_OriginFortezzaHack, so pass PK11_OriginUnwrap as a
-  // placeholder.
-  crypto::ScopedPK11SymKey aes_key(PK11_ImportSymKey(
-      slot, GcmSupportChecker::aes_key_mechanism(), PK11_OriginUnwrap,
-      CKA_DECRYPT, &key_item, NULL));
-  PK11_FreeSlot(slot);
-  slot = NULL;
-  if (!aes_key) {
-    DLOG(INFO) << "PK11_ImportSymKey failed";
+  if (!aes_key_) {
     return false;
   }
 
@@ -336,7 +340,7 @@ bool Aes128Gcm12Decrypter::Decrypt(StringPiece nonce,
   unsigned int output_len;
   // If an incorrect authentication tag causes a decryption failure, the NSS
   // error is SEC_ERROR_BAD_DATA (-8190).
-  if (My_Decrypt(aes_key.get(), CKM_AES_GCM, &param,
+  if (My_Decrypt(aes_key_.get(), CKM_AES_GCM, &param,
                  output, &output_len, ciphertext.length(),
                  reinterpret_cast<const unsigned char*>(ciphertext.data()),
                  ciphertext.length()) != SECSuccess) {
@@ -356,23 +360,32 @@ QuicData* Aes128Gcm12Decrypter::DecryptPacket(
     QuicPacketSequenceNumber sequence_number,
     StringPiece associated_data,
     StringPiece ciphertext) {
-  if (ciphertext.length() < kAuthTagSize) {
-    return NULL;
-  }
   size_t plaintext_size;
   scoped_ptr<char[]> plaintext(new char[ciphertext.length()]);
+  if (!DecryptPacketInBuffer(sequence_number, associated_data, ciphertext,
+                             plaintext.get(), &plaintext_size)) {
+    return NULL;
+  }
+  return new QuicData(plaintext.release(), plaintext_size, true);
+}
+
+bool Aes128Gcm12Decrypter::DecryptPacketInBuffer(
+    QuicPacketSequenceNumber sequence_number,
+    StringPiece associated_data,
+    StringPiece ciphertext,
+    char* output,
+    size_t* output_length) {
+  if (ciphertext.length() < kAuthTagSize) {
+    return false;
+  }
 
   uint8 nonce[kNoncePrefixSize + sizeof(sequence_number)];
   COMPILE_ASSERT(sizeof(nonce) == kAESNonceSize, bad_sequence_number_size);
   memcpy(nonce, nonce_prefix_, kNoncePrefixSize);
   memcpy(nonce + kNoncePrefixSize, &sequence_number, sizeof(sequence_number));
-  if (!Decrypt(StringPiece(reinterpret_cast<char*>(nonce), sizeof(nonce)),
-               associated_data, ciphertext,
-               reinterpret_cast<uint8*>(plaintext.get()),
-               &plaintext_size)) {
-    return NULL;
-  }
-  return new QuicData(plaintext.release(), plaintext_size, true);
+  return Decrypt(StringPiece(reinterpret_cast<char*>(nonce), sizeof(nonce)),
+                 associated_data, ciphertext,
+                 reinterpret_cast<uint8*>(output), output_length);
 }
 
 StringPiece Aes128Gcm12Decrypter::GetKey() const {
@@ -12,6 +12,8 @@
 
 #if defined(USE_OPENSSL)
 #include "net/quic/crypto/scoped_evp_cipher_ctx.h"
+#else
+#include "crypto/scoped_nss_types.h"
 #endif
 
 namespace net {
@@ -49,6 +51,10 @@ class NET_EXPORT_PRIVATE Aes128Gcm12Encrypter : public QuicEncrypter {
   virtual QuicData* EncryptPacket(QuicPacketSequenceNumber sequence_number,
                                   base::StringPiece associated_data,
                                   base::StringPiece plaintext) OVERRIDE;
+  virtual bool EncryptPacketInBuffer(QuicPacketSequenceNumber sequence_number,
+                                     base::StringPiece associated_data,
+                                     base::StringPiece plaintext,
+                                     char* output) OVERRIDE;
   virtual size_t GetKeySize() const OVERRIDE;
   virtual size_t GetNoncePrefixSize() const OVERRIDE;
   virtual size_t GetMaxPlaintextSize(size_t ciphertext_size) const OVERRIDE;
@@ -66,6 +72,10 @@ class NET_EXPORT_PRIVATE Aes128Gcm12Encrypter : public QuicEncrypter {
 
 #if defined(USE_OPENSSL)
   ScopedEVPCipherCtx ctx_;
+#else
+  // |key_| imported into NSS. It is imported once, in SetKey(), rather than
+  // for every packet.
+  crypto::ScopedPK11SymKey aes_key_;
 #endif
 };
 
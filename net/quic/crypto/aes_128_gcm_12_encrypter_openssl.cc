@@ -117,10 +117,22 @@ QuicData* Aes128Gcm12Encrypter::EncryptPacket(
     StringPiece plaintext) {
   size_t ciphertext_size = GetCiphertextSize(plaintext.length());
   scoped_ptr<char[]> ciphertext(new char[ciphertext_size]);
+  if (!EncryptPacketInBuffer(sequence_number, associated_data, plaintext,
+                             ciphertext.get())) {
+    return NULL;
+  }
 
+  return new QuicData(ciphertext.release(), ciphertext_size, true);
+}
+
+bool Aes128Gcm12Encrypter::EncryptPacketInBuffer(
+    QuicPacketSequenceNumber sequence_number,
+    StringPiece associated_data,
+    StringPiece plaintext,
+    char* output) {
   if (last_seq_num_ != 0 && sequence_number <= last_seq_num_) {
     DLOG(FATAL) << "Sequence numbers regressed";
-    return NULL;
+    return false;
   }
   last_seq_num_ = sequence_number;
 
@@ -128,13 +140,9 @@ QuicData* Aes128Gcm12Encrypter::EncryptPacket(
   COMPILE_ASSERT(sizeof(nonce) == kAESNonceSize, bad_sequence_number_size);
   memcpy(nonce, nonce_prefix_, kNoncePrefixSize);
   memcpy(nonce + kNoncePrefixSize, &sequence_number, sizeof(sequence_number));
-  if (!Encrypt(StringPiece(reinterpret_cast<char*>(nonce), sizeof(nonce)),
-               associated_data, plaintext,
-               reinterpret_cast<unsigned char*>(ciphertext.get()))) {
-    return NULL;
-  }
-
-  return new QuicData(ciphertext.release(), ciphertext_size, true);
+  return Encrypt(StringPiece(reinterpret_cast<char*>(nonce), sizeof(nonce)),
+                 associated_data, plaintext,
+                 reinterpret_cast<unsigned char*>(output));
 }
 
 size_t Aes128Gcm12Encrypter::GetKeySize() const { return kKeySize; }
@@ -67,6 +67,16 @@ QuicData* NullDecrypter::DecryptPacket(QuicPacketSequenceNumber /*seq_number*/,
   return new QuicData(plaintext.data(), plaintext.length());
 }
 
+bool NullDecrypter::DecryptPacketInBuffer(
+    QuicPacketSequenceNumber /*sequence_number*/,
+    StringPiece associated_data,
+    StringPiece ciphertext,
+    char* output,
+    size_t* output_length) {
+  return Decrypt(StringPiece(), associated_data, ciphertext,
+                 reinterpret_cast<unsigned char*>(output), output_length);
+}
+
 StringPiece NullDecrypter::GetKey() const { return StringPiece(); }
 
 StringPiece NullDecrypter::GetNoncePrefix() const { return StringPiece(); }
@@ -29,6 +29,11 @@ class NET_EXPORT_PRIVATE NullDecrypter : public QuicDecrypter {
   virtual QuicData* DecryptPacket(QuicPacketSequenceNumber sequence_number,
                                   base::StringPiece associated_data,
                                   base::StringPiece ciphertext) OVERRIDE;
+  virtual bool DecryptPacketInBuffer(QuicPacketSequenceNumber sequence_number,
+                                     base::StringPiece associated_data,
+                                     base::StringPiece ciphertext,
+                                     char* output,
+                                     size_t* output_length) OVERRIDE;
   virtual base::StringPiece GetKey() const OVERRIDE;
   virtual base::StringPiece GetNoncePrefix() const OVERRIDE;
 };
@@ -4,6 +4,10 @@
 
 #include "net/quic/crypto/quic_decrypter.h"
 
+#include <string.h>
+
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
 #include "net/quic/crypto/aes_128_gcm_12_decrypter.h"
 #include "net/quic/crypto/null_decrypter.h"
 
@@ -22,4 +26,21 @@ QuicDecrypter* QuicDecrypter::Create(QuicTag algorithm) {
   }
 }
 
+bool QuicDecrypter::DecryptPacketInBuffer(
+    QuicPacketSequenceNumber sequence_number,
+    base::StringPiece associated_data,
+    base::StringPiece ciphertext,
+    char* output,
+    size_t* output_length) {
+  scoped_ptr<QuicData> plaintext(
+      DecryptPacket(sequence_number, associated_data, ciphertext));
+  if (plaintext.get() == NULL) {
+    return false;
+  }
+  DCHECK_LE(plaintext->length(), ciphertext.length());
+  memcpy(output, plaintext->data(), plaintext->length());
+  *output_length = plaintext->length();
+  return true;
+}
+
 }  // namespace net
@@ -62,6 +62,16 @@ class NET_EXPORT_PRIVATE QuicDecrypter {
                                   base::StringPiece associated_data,
                                   base::StringPiece ciphertext) = 0;
 
+  // Like DecryptPacket, but writes the plaintext to |output| instead of
+  // allocating it. |output| must be as long as |ciphertext| and, on success,
+  // the length of the plaintext is written to |*output_length|. The default
+  // implementation copies the result of DecryptPacket.
+  virtual bool DecryptPacketInBuffer(QuicPacketSequenceNumber sequence_number,
+                                     base::StringPiece associated_data,
+                                     base::StringPiece ciphertext,
+                                     char* output,
+                                     size_t* output_length);
+
   // For use by unit tests only.
   virtual base::StringPiece GetKey() const = 0;
   virtual base::StringPiece GetNoncePrefix() const = 0;
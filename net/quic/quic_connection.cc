@@ -8,6 +8,7 @@
 
 #include "base/logging.h"
 #include "base/stl_util.h"
+#include "net/quic/congestion_control/pacing_sender.h"
 #include "net/quic/crypto/quic_decrypter.h"
 #include "net/quic/crypto/quic_encrypter.h"
 #include "net/quic/quic_utils.h"
@@ -815,9 +816,19 @@ const QuicConnectionStats& QuicConnection::GetStats() {
   stats_.rtt = congestion_manager_.SmoothedRtt().ToMicroseconds();
   stats_.estimated_bandwidth =
       congestion_manager_.BandwidthEstimate().ToBytesPerSecond();
+  const PacingSender* pacing_sender = congestion_manager_.pacing_sender();
+  if (pacing_sender) {
+    stats_.packets_paced = pacing_sender->packets_paced();
+    stats_.pacing_delay = pacing_sender->pacing_delay().ToMicroseconds();
+    stats_.pacing_rate = pacing_sender->PacingRate().ToBytesPerSecond();
+  }
   return stats_;
 }
 
+void QuicConnection::EnablePacing() {
+  congestion_manager_.EnablePacing();
+}
+
 void QuicConnection::ProcessUdpPacket(const IPEndPoint& self_address,
                                       const IPEndPoint& peer_address,
                                       const QuicEncryptedPacket& packet) {
@@ -233,6 +233,11 @@ class NET_EXPORT_PRIVATE QuicConnection
   // Returns statistics tracked for this connection.
   const QuicConnectionStats& GetStats();
 
+  // Spreads the packets sent over time at the estimated bandwidth, instead
+  // of sending as much as the congestion window allows at once. The
+  // pacing delays are waited out with the send alarm.
+  void EnablePacing();
+
   // Processes an incoming UDP packet (consisting of a QuicEncryptedPacket) from
   // the peer.  If processing this packet permits a packet to be revived from
   // its FEC group that packet will be revived and processed.
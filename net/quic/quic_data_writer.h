@@ -26,13 +26,17 @@ namespace net {
 class NET_EXPORT_PRIVATE QuicDataWriter {
  public:
   explicit QuicDataWriter(size_t length);
+  // Writes into |buffer|, which is owned by the caller and must outlive the
+  // writer, instead of allocating one.
+  QuicDataWriter(size_t length, char* buffer);
 
   ~QuicDataWriter();
 
   // Returns the size of the QuicDataWriter's data.
   size_t length() const { return length_; }
 
-  // Takes the buffer from the QuicDataWriter.
+  // Takes the buffer from the QuicDataWriter. Only valid if the writer
+  // allocated it.
   char* take();
 
   // Methods for adding to the payload.  These values are appended to the end
@@ -73,6 +77,7 @@ class NET_EXPORT_PRIVATE QuicDataWriter {
   char* buffer_;
   size_t capacity_;  // Allocation size of payload (or -1 if buffer is const).
   size_t length_;    // Current length of the buffer.
+  bool owns_buffer_;
 };
 
 }  // namespace net
@@ -82,11 +82,13 @@ QuicPacketSequenceNumber ClosestTo(QuicPacketSequenceNumber target,
 QuicFramer::QuicFramer(QuicVersion version,
                        QuicTime creation_time,
                        bool is_server)
-    : visitor_(NULL),
+    : reader_(NULL),
+      visitor_(NULL),
       fec_builder_(NULL),
       error_(QUIC_NO_ERROR),
       last_sequence_number_(0),
       last_serialized_guid_(0),
+      decrypted_buffer_(kMaxPacketSize),
       quic_version_(version),
       decrypter_(QuicDecrypter::Create(kNULL)),
       alternative_decrypter_latch_(false),
@@ -259,18 +261,38 @@ SerializedPacket QuicFramer::BuildDataPacket(
     const QuicPacketHeader& header,
     const QuicFrames& frames,
     size_t packet_size) {
-  QuicDataWriter writer(packet_size);
-  const SerializedPacket kNoPacket(0, NULL, 0, NULL);
+  scoped_ptr<char[]> buffer(new char[packet_size]);
+  const size_t len = BuildDataPacketInBuffer(
+      header, frames.empty() ? NULL : &frames[0], frames.size(),
+      buffer.get(), packet_size);
+  if (len == 0) {
+    return SerializedPacket(0, NULL, 0, NULL);
+  }
+  QuicPacket* packet = QuicPacket::NewDataPacket(
+      buffer.release(), len, true, header.public_header.guid_length,
+      header.public_header.version_flag,
+      header.public_header.sequence_number_length);
+
+  return SerializedPacket(header.packet_sequence_number, packet,
+                          GetPacketEntropyHash(header), NULL);
+}
+
+size_t QuicFramer::BuildDataPacketInBuffer(const QuicPacketHeader& header,
+                                           const QuicFrame* frames,
+                                           size_t num_frames,
+                                           char* buffer,
+                                           size_t buffer_len) {
+  QuicDataWriter writer(buffer_len, buffer);
   if (!WritePacketHeader(header, &writer)) {
-    return kNoPacket;
+    return 0;
   }
 
-  for (size_t i = 0; i < frames.size(); ++i) {
+  for (size_t i = 0; i < num_frames; ++i) {
     const QuicFrame& frame = frames[i];
 
-    const bool last_frame_in_packet = i == (frames.size() - 1);
+    const bool last_frame_in_packet = i == (num_frames - 1);
     if (!AppendTypeByte(frame, last_frame_in_packet, &writer)) {
-      return kNoPacket;
+      return 0;
     }
 
     switch (frame.type) {
@@ -280,59 +302,57 @@ SerializedPacket QuicFramer::BuildDataPacket(
       case STREAM_FRAME:
         if (!AppendStreamFramePayload(
             *frame.stream_frame, last_frame_in_packet, &writer)) {
-          return kNoPacket;
+          return 0;
         }
         break;
       case ACK_FRAME:
         if (!AppendAckFramePayload(*frame.ack_frame, &writer)) {
-          return kNoPacket;
+          return 0;
         }
         break;
       case CONGESTION_FEEDBACK_FRAME:
         if (!AppendQuicCongestionFeedbackFramePayload(
                 *frame.congestion_feedback_frame, &writer)) {
-          return kNoPacket;
+          return 0;
         }
         break;
       case RST_STREAM_FRAME:
         if (!AppendRstStreamFramePayload(*frame.rst_stream_frame, &writer)) {
-          return kNoPacket;
+          return 0;
         }
         break;
       case CONNECTION_CLOSE_FRAME:
         if (!AppendConnectionCloseFramePayload(
                 *frame.connection_close_frame, &writer)) {
-          return kNoPacket;
+          return 0;
         }
         break;
       case GOAWAY_FRAME:
         if (!AppendGoAwayFramePayload(*frame.goaway_frame, &writer)) {
-          return kNoPacket;
+          return 0;
         }
         break;
       default:
         RaiseError(QUIC_INVALID_FRAME_DATA);
-        return kNoPacket;
+        return 0;
     }
   }
 
-  // Save the length before writing, because take clears it.
   const size_t len = writer.length();
   // Less than or equal because truncated acks end up with max_plaintex_size
   // length, even though they're typically slightly shorter.
-  DCHECK_LE(len, packet_size);
-  QuicPacket* packet = QuicPacket::NewDataPacket(
-      writer.take(), len, true, header.public_header.guid_length,
-      header.public_header.version_flag,
-      header.public_header.sequence_number_length);
+  DCHECK_LE(len, buffer_len);
 
   if (fec_builder_) {
-    fec_builder_->OnBuiltFecProtectedPayload(header,
-                                             packet->FecProtectedData());
+    const size_t start_of_fec = GetStartOfFecProtectedData(
+        header.public_header.guid_length,
+        header.public_header.version_flag,
+        header.public_header.sequence_number_length);
+    fec_builder_->OnBuiltFecProtectedPayload(
+        header, StringPiece(buffer + start_of_fec, len - start_of_fec));
   }
 
-  return SerializedPacket(header.packet_sequence_number, packet,
-                          GetPacketEntropyHash(header), NULL);
+  return len;
 }
 
 SerializedPacket QuicFramer::BuildFecPacket(const QuicPacketHeader& header,
@@ -422,8 +442,9 @@ QuicEncryptedPacket* QuicFramer::BuildVersionNegotiationPacket(
 bool QuicFramer::ProcessPacket(const QuicEncryptedPacket& packet) {
   // TODO(satyamshekhar): Don't RaiseError (and close the connection) for
   // invalid (unauthenticated) packets.
-  DCHECK(!reader_.get());
-  reader_.reset(new QuicDataReader(packet.data(), packet.length()));
+  DCHECK(!reader_);
+  QuicDataReader reader(packet.data(), packet.length());
+  reader_ = &reader;
 
   visitor_->OnPacket();
 
@@ -437,7 +458,7 @@ bool QuicFramer::ProcessPacket(const QuicEncryptedPacket& packet) {
   if (is_server_ && public_header.version_flag &&
       public_header.versions[0] != quic_version_) {
     if (!visitor_->OnProtocolVersionMismatch(public_header.versions[0])) {
-      reader_.reset(NULL);
+      reader_ = NULL;
       return true;
     }
   }
@@ -451,7 +472,7 @@ bool QuicFramer::ProcessPacket(const QuicEncryptedPacket& packet) {
     rv = ProcessDataPacket(public_header, packet);
   }
 
-  reader_.reset(NULL);
+  reader_ = NULL;
   return rv;
 }
 
@@ -476,12 +497,23 @@ bool QuicFramer::ProcessDataPacket(
     const QuicPacketPublicHeader& public_header,
     const QuicEncryptedPacket& packet) {
   QuicPacketHeader header(public_header);
-  if (!ProcessPacketHeader(&header, packet)) {
+  StringPiece decrypted;
+  if (!ProcessPacketHeader(&header, packet, &decrypted)) {
     DCHECK_NE(QUIC_NO_ERROR, error_);  // ProcessPacketHeader sets the error.
     DLOG(WARNING) << "Unable to process data packet header.";
     return false;
   }
 
+  // The rest of the packet is read from the decrypted payload. ProcessPacket()
+  // clears |reader_| once this returns.
+  QuicDataReader decrypted_reader(decrypted.data(), decrypted.length());
+  reader_ = &decrypted_reader;
+  if (!ProcessPrivateHeader(&header)) {
+    DCHECK_NE(QUIC_NO_ERROR, error_);  // ProcessPrivateHeader sets the error.
+    DLOG(WARNING) << "Unable to process data packet header.";
+    return false;
+  }
+
   if (!visitor_->OnPacketHeader(header)) {
     // The visitor suppresses further processing of the packet.
     return true;
@@ -533,7 +565,7 @@ bool QuicFramer::ProcessPublicResetPacket(
 
 bool QuicFramer::ProcessRevivedPacket(QuicPacketHeader* header,
                                       StringPiece payload) {
-  DCHECK(!reader_.get());
+  DCHECK(!reader_);
 
   visitor_->OnRevivedPacket();
 
@@ -548,15 +580,17 @@ bool QuicFramer::ProcessRevivedPacket(QuicPacketHeader* header,
     return RaiseError(QUIC_PACKET_TOO_LARGE);
   }
 
-  reader_.reset(new QuicDataReader(payload.data(), payload.length()));
+  QuicDataReader reader(payload.data(), payload.length());
+  reader_ = &reader;
   if (!ProcessFrameData()) {
     DCHECK_NE(QUIC_NO_ERROR, error_);  // ProcessFrameData sets the error.
     DLOG(WARNING) << "Unable to process frame data.";
+    reader_ = NULL;
     return false;
   }
 
   visitor_->OnPacketComplete();
-  reader_.reset(NULL);
+  reader_ = NULL;
   return true;
 }
 
@@ -805,7 +839,8 @@ bool QuicFramer::ReadGuidFromPacket(const QuicEncryptedPacket& packet,
 
 bool QuicFramer::ProcessPacketHeader(
     QuicPacketHeader* header,
-    const QuicEncryptedPacket& packet) {
+    const QuicEncryptedPacket& packet,
+    StringPiece* decrypted) {
   if (!ProcessPacketSequenceNumber(header->public_header.sequence_number_length,
                                    &header->packet_sequence_number)) {
     set_detailed_error("Unable to read sequence number.");
@@ -817,11 +852,14 @@ bool QuicFramer::ProcessPacketHeader(
     return RaiseError(QUIC_INVALID_PACKET_HEADER);
   }
 
-  if (!DecryptPayload(*header, packet)) {
+  if (!DecryptPayload(*header, packet, decrypted)) {
     set_detailed_error("Unable to decrypt payload.");
     return RaiseError(QUIC_DECRYPTION_FAILURE);
   }
+  return true;
+}
 
+bool QuicFramer::ProcessPrivateHeader(QuicPacketHeader* header) {
   uint8 private_flags;
   if (!reader_->ReadBytes(&private_flags, 1)) {
     set_detailed_error("Unable to read private flags.");
@@ -1365,19 +1403,50 @@ QuicEncryptedPacket* QuicFramer::EncryptPacket(
     const QuicPacket& packet) {
   DCHECK(encrypter_[level].get() != NULL);
 
-  scoped_ptr<QuicData> out(encrypter_[level]->EncryptPacket(
-      packet_sequence_number, packet.AssociatedData(), packet.Plaintext()));
-  if (out.get() == NULL) {
+  StringPiece header_data = packet.BeforePlaintext();
+  StringPiece plaintext = packet.Plaintext();
+  const size_t len = header_data.length() +
+      encrypter_[level]->GetCiphertextSize(plaintext.length());
+  scoped_ptr<char[]> buffer(new char[len]);
+  memcpy(buffer.get(), header_data.data(), header_data.length());
+  if (!encrypter_[level]->EncryptPacketInBuffer(
+          packet_sequence_number, packet.AssociatedData(), plaintext,
+          buffer.get() + header_data.length())) {
     RaiseError(QUIC_ENCRYPTION_FAILURE);
     return NULL;
   }
-  StringPiece header_data = packet.BeforePlaintext();
-  size_t len =  header_data.length() + out->length();
-  char* buffer = new char[len];
-  // TODO(rch): eliminate this buffer copy by passing in a buffer to Encrypt().
-  memcpy(buffer, header_data.data(), header_data.length());
-  memcpy(buffer + header_data.length(), out->data(), out->length());
-  return new QuicEncryptedPacket(buffer, len, true);
+  return new QuicEncryptedPacket(buffer.release(), len, true);
+}
+
+size_t QuicFramer::EncryptPacketInBuffer(EncryptionLevel level,
+                                         const QuicPacketHeader& header,
+                                         StringPiece packet,
+                                         char* buffer,
+                                         size_t buffer_len) {
+  DCHECK(encrypter_[level].get() != NULL);
+
+  const size_t start_of_encrypted_data = GetStartOfEncryptedData(
+      header.public_header.guid_length,
+      header.public_header.version_flag,
+      header.public_header.sequence_number_length);
+  DCHECK_LE(start_of_encrypted_data, packet.length());
+  StringPiece plaintext = packet.substr(start_of_encrypted_data);
+  const size_t len = start_of_encrypted_data +
+      encrypter_[level]->GetCiphertextSize(plaintext.length());
+  if (len > buffer_len) {
+    RaiseError(QUIC_ENCRYPTION_FAILURE);
+    return 0;
+  }
+  memcpy(buffer, packet.data(), start_of_encrypted_data);
+  if (!encrypter_[level]->EncryptPacketInBuffer(
+          header.packet_sequence_number,
+          StringPiece(packet.data() + kStartOfHashData,
+                      start_of_encrypted_data - kStartOfHashData),
+          plaintext, buffer + start_of_encrypted_data)) {
+    RaiseError(QUIC_ENCRYPTION_FAILURE);
+    return 0;
+  }
+  return len;
 }
 
 size_t QuicFramer::GetMaxPlaintextSize(size_t ciphertext_size) {
@@ -1400,30 +1469,31 @@ size_t QuicFramer::GetMaxPlaintextSize(size_t ciphertext_size) {
 }
 
 bool QuicFramer::DecryptPayload(const QuicPacketHeader& header,
-                                const QuicEncryptedPacket& packet) {
+                                const QuicEncryptedPacket& packet,
+                                StringPiece* decrypted) {
   StringPiece encrypted;
   if (!reader_->ReadStringPiece(&encrypted, reader_->BytesRemaining())) {
     return false;
   }
   DCHECK(decrypter_.get() != NULL);
-  decrypted_.reset(decrypter_->DecryptPacket(
-      header.packet_sequence_number,
-      GetAssociatedDataFromEncryptedPacket(
-          packet,
-          header.public_header.guid_length,
-          header.public_header.version_flag,
-          header.public_header.sequence_number_length),
-      encrypted));
-  if  (decrypted_.get() == NULL && alternative_decrypter_.get() != NULL) {
-    decrypted_.reset(alternative_decrypter_->DecryptPacket(
-        header.packet_sequence_number,
-        GetAssociatedDataFromEncryptedPacket(
-            packet,
-            header.public_header.guid_length,
-            header.public_header.version_flag,
-            header.public_header.sequence_number_length),
-        encrypted));
-    if (decrypted_.get() != NULL) {
+  if (decrypted_buffer_.size() < encrypted.length()) {
+    decrypted_buffer_.resize(encrypted.length());
+  }
+  char* buffer = &decrypted_buffer_[0];
+  size_t decrypted_length = 0;
+  StringPiece associated_data = GetAssociatedDataFromEncryptedPacket(
+      packet,
+      header.public_header.guid_length,
+      header.public_header.version_flag,
+      header.public_header.sequence_number_length);
+  bool success = decrypter_->DecryptPacketInBuffer(
+      header.packet_sequence_number, associated_data, encrypted, buffer,
+      &decrypted_length);
+  if (!success && alternative_decrypter_.get() != NULL) {
+    success = alternative_decrypter_->DecryptPacketInBuffer(
+        header.packet_sequence_number, associated_data, encrypted, buffer,
+        &decrypted_length);
+    if (success) {
       if (alternative_decrypter_latch_) {
         // Switch to the alternative decrypter and latch so that we cannot
         // switch back.
@@ -1435,11 +1505,11 @@ bool QuicFramer::DecryptPayload(const QuicPacketHeader& header,
     }
   }
 
-  if  (decrypted_.get() == NULL) {
+  if (!success) {
     return false;
   }
 
-  reader_.reset(new QuicDataReader(decrypted_->data(), decrypted_->length()));
+  *decrypted = StringPiece(buffer, decrypted_length);
   return true;
 }
 
@@ -1852,7 +1922,7 @@ bool QuicFramer::RaiseError(QuicErrorCode error) {
   DLOG(INFO) << detailed_error_;
   set_error(error);
   visitor_->OnError(this);
-  reader_.reset(NULL);
+  reader_ = NULL;
   return false;
 }
 
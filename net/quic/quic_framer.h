@@ -279,6 +279,16 @@ class NET_EXPORT_PRIVATE QuicFramer {
                                    const QuicFrames& frames,
                                    size_t packet_size);
 
+  // Serializes |header| and the |num_frames| frames at |frames| into
+  // |buffer|, without allocating, and returns the length of the packet or 0
+  // if it could not be built. |buffer_len| plays the part of |packet_size| in
+  // BuildDataPacket, so a padding frame fills the whole buffer.
+  size_t BuildDataPacketInBuffer(const QuicPacketHeader& header,
+                                 const QuicFrame* frames,
+                                 size_t num_frames,
+                                 char* buffer,
+                                 size_t buffer_len);
+
   // Returns a SerializedPacket whose |packet| member is owned by the caller,
   // and is populated with the fields in |header| and |fec|, or is NULL if the
   // packet could not be created.
@@ -325,6 +335,15 @@ class NET_EXPORT_PRIVATE QuicFramer {
                                      QuicPacketSequenceNumber sequence_number,
                                      const QuicPacket& packet);
 
+  // Encrypts |packet|, built by BuildDataPacketInBuffer() with |header|, into
+  // |buffer| and returns the length of the encrypted packet, or 0 on error.
+  // |buffer| must not overlap |packet|.
+  size_t EncryptPacketInBuffer(EncryptionLevel level,
+                               const QuicPacketHeader& header,
+                               base::StringPiece packet,
+                               char* buffer,
+                               size_t buffer_len);
+
   // Returns the maximum length of plaintext that can be encrypted
   // to ciphertext no larger than |ciphertext_size|.
   size_t GetMaxPlaintextSize(size_t ciphertext_size);
@@ -354,8 +373,15 @@ class NET_EXPORT_PRIVATE QuicFramer {
 
   bool ProcessPublicHeader(QuicPacketPublicHeader* header);
 
+  // Reads the sequence number and decrypts the rest of the packet, which
+  // |decrypted| is set to.
   bool ProcessPacketHeader(QuicPacketHeader* header,
-                           const QuicEncryptedPacket& packet);
+                           const QuicEncryptedPacket& packet,
+                           base::StringPiece* decrypted);
+
+  // Reads the header fields which follow the sequence number from the
+  // decrypted payload.
+  bool ProcessPrivateHeader(QuicPacketHeader* header);
 
   bool ProcessPacketSequenceNumber(
       QuicSequenceNumberLength sequence_number_length,
@@ -372,7 +398,8 @@ class NET_EXPORT_PRIVATE QuicFramer {
   bool ProcessGoAwayFrame(QuicGoAwayFrame* frame);
 
   bool DecryptPayload(const QuicPacketHeader& header,
-                      const QuicEncryptedPacket& packet);
+                      const QuicEncryptedPacket& packet,
+                      base::StringPiece* decrypted);
 
   // Returns the full packet sequence number from the truncated
   // wire format version and the last seen packet sequence number.
@@ -417,7 +444,10 @@ class NET_EXPORT_PRIVATE QuicFramer {
   }
 
   std::string detailed_error_;
-  scoped_ptr<QuicDataReader> reader_;
+  // Reads the packet being processed. It points at a reader on the stack of
+  // ProcessPacket() or ProcessRevivedPacket(), so no allocation is needed
+  // per packet.
+  QuicDataReader* reader_;
   QuicFramerVisitorInterface* visitor_;
   QuicFecBuilderInterface* fec_builder_;
   QuicReceivedEntropyHashCalculatorInterface* entropy_calculator_;
@@ -426,8 +456,9 @@ class NET_EXPORT_PRIVATE QuicFramer {
   QuicPacketSequenceNumber last_sequence_number_;
   // Updated by WritePacketHeader.
   QuicGuid last_serialized_guid_;
-  // Buffer containing decrypted payload data during parsing.
-  scoped_ptr<QuicData> decrypted_;
+  // Buffer containing decrypted payload data during parsing. It is reused
+  // across packets and only grows.
+  std::vector<char> decrypted_buffer_;
   // Version of the protocol being used.
   QuicVersion quic_version_;
   // Primary decrypter used to decrypt packets during parsing.
@@ -12,6 +12,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/port.h"
 #include "base/stl_util.h"
+#include "base/time/time.h"
 #include "net/quic/crypto/quic_decrypter.h"
 #include "net/quic/crypto/quic_encrypter.h"
 #include "net/quic/quic_framer.h"
@@ -3635,5 +3636,144 @@ TEST_P(QuicFramerTest, ConnectionCloseWithInvalidAck) {
   EXPECT_EQ(QUIC_NO_ERROR, framer_.error());
 }
 
+TEST_P(QuicFramerTest, BuildAndEncryptPacketInBuffer) {
+  QuicPacketHeader header;
+  header.public_header.guid = GG_UINT64_C(0xFEDCBA9876543210);
+  header.public_header.reset_flag = false;
+  header.public_header.version_flag = false;
+  header.fec_flag = false;
+  header.entropy_flag = true;
+  header.packet_sequence_number = GG_UINT64_C(0x77123456789ABC);
+  header.fec_group = 0;
+
+  QuicStreamFrame stream_frame;
+  stream_frame.stream_id = 0x01020304;
+  stream_frame.fin = true;
+  stream_frame.offset = GG_UINT64_C(0xBA98FEDC32107654);
+  stream_frame.data = "hello world!";
+
+  QuicFrames frames;
+  frames.push_back(QuicFrame(&stream_frame));
+
+  scoped_ptr<QuicPacket> packet(
+      framer_.BuildUnsizedDataPacket(header, frames).packet);
+  ASSERT_TRUE(packet != NULL);
+
+  char buffer[kMaxPacketSize];
+  size_t length = framer_.BuildDataPacketInBuffer(
+      header, &frames[0], frames.size(), buffer, packet->length());
+  test::CompareCharArraysWithHexError("built packet", buffer, length,
+                                      packet->data(), packet->length());
+
+  // A buffer which is too short fails.
+  EXPECT_EQ(0u, framer_.BuildDataPacketInBuffer(
+      header, &frames[0], frames.size(), buffer, packet->length() - 1));
+
+  scoped_ptr<QuicEncryptedPacket> encrypted(framer_.EncryptPacket(
+      ENCRYPTION_NONE, header.packet_sequence_number, *packet));
+  ASSERT_TRUE(encrypted != NULL);
+  EXPECT_TRUE(CheckEncryption(header.packet_sequence_number, packet.get()));
+
+  char encrypted_buffer[kMaxPacketSize];
+  length = framer_.EncryptPacketInBuffer(
+      ENCRYPTION_NONE, header, StringPiece(buffer, packet->length()),
+      encrypted_buffer, arraysize(encrypted_buffer));
+  test::CompareCharArraysWithHexError(
+      "encrypted packet", encrypted_buffer, length,
+      encrypted->data(), encrypted->length());
+  EXPECT_TRUE(CheckEncryption(header.packet_sequence_number, packet.get()));
+
+  QuicEncryptedPacket processed(encrypted_buffer, length, false);
+  EXPECT_TRUE(framer_.ProcessPacket(processed));
+  ASSERT_EQ(1u, visitor_.stream_frames_.size());
+  EXPECT_EQ("hello world!", visitor_.stream_frames_[0]->data);
+}
+
+namespace {
+
+class StreamFrameCountingVisitor : public NoOpFramerVisitor {
+ public:
+  StreamFrameCountingVisitor() : stream_frames_(0) {}
+
+  virtual bool OnStreamFrame(const QuicStreamFrame& frame) OVERRIDE {
+    ++stream_frames_;
+    return true;
+  }
+
+  int stream_frames() const { return stream_frames_; }
+
+ private:
+  int stream_frames_;
+};
+
+}  // namespace
+
+// Compares the packets per second that can be built, encrypted and
+// processed through the allocating API and through the in-buffer one.
+TEST_P(QuicFramerTest, PacketsPerSecond) {
+  const int kNumPackets = 50000;
+
+  QuicFramer client_framer(version_, start_, false);
+  QuicFramer server_framer(version_, start_, true);
+  StreamFrameCountingVisitor visitor;
+  server_framer.set_visitor(&visitor);
+
+  QuicPacketHeader header;
+  header.public_header.guid = GG_UINT64_C(0xFEDCBA9876543210);
+  header.public_header.reset_flag = false;
+  header.public_header.version_flag = false;
+  header.fec_flag = false;
+  header.entropy_flag = false;
+  header.fec_group = 0;
+
+  const string data(1000, 'a');
+  QuicStreamFrame stream_frame;
+  stream_frame.stream_id = 3;
+  stream_frame.fin = false;
+  stream_frame.offset = 0;
+  stream_frame.data = data;
+  QuicFrames frames;
+  frames.push_back(QuicFrame(&stream_frame));
+
+  QuicPacketSequenceNumber sequence_number = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumPackets; ++i) {
+    header.packet_sequence_number = ++sequence_number;
+    scoped_ptr<QuicPacket> packet(
+        client_framer.BuildUnsizedDataPacket(header, frames).packet);
+    scoped_ptr<QuicEncryptedPacket> encrypted(client_framer.EncryptPacket(
+        ENCRYPTION_NONE, sequence_number, *packet));
+    ASSERT_TRUE(server_framer.ProcessPacket(*encrypted));
+  }
+  base::TimeDelta allocating_time = base::TimeTicks::Now() - start;
+  EXPECT_EQ(kNumPackets, visitor.stream_frames());
+
+  char buffer[kMaxPacketSize];
+  char encrypted_buffer[kMaxPacketSize];
+  start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumPackets; ++i) {
+    header.packet_sequence_number = ++sequence_number;
+    const size_t length = client_framer.BuildDataPacketInBuffer(
+        header, &frames[0], frames.size(), buffer,
+        client_framer.GetMaxPlaintextSize(kMaxPacketSize));
+    ASSERT_NE(0u, length);
+    const size_t encrypted_length = client_framer.EncryptPacketInBuffer(
+        ENCRYPTION_NONE, header, StringPiece(buffer, length),
+        encrypted_buffer, arraysize(encrypted_buffer));
+    ASSERT_NE(0u, encrypted_length);
+    ASSERT_TRUE(server_framer.ProcessPacket(
+        QuicEncryptedPacket(encrypted_buffer, encrypted_length, false)));
+  }
+  base::TimeDelta in_buffer_time = base::TimeTicks::Now() - start;
+  EXPECT_EQ(2 * kNumPackets, visitor.stream_frames());
+
+  LOG(INFO) << "Allocating path: "
+            << kNumPackets / std::max(allocating_time.InSecondsF(), 1e-6)
+            << " packets/sec";
+  LOG(INFO) << "In-buffer path: "
+            << kNumPackets / std::max(in_buffer_time.InSecondsF(), 1e-6)
+            << " packets/sec";
+}
+
 }  // namespace test
 }  // namespace net
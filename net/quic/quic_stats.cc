@@ -17,7 +17,10 @@ QuicConnectionStats::QuicConnectionStats()
       packets_dropped(0),
       rto_count(0),
       rtt(0),
-      estimated_bandwidth(0) {
+      estimated_bandwidth(0),
+      packets_paced(0),
+      pacing_delay(0),
+      pacing_rate(0) {
 }
 
 QuicConnectionStats::~QuicConnectionStats() {}
@@ -42,6 +42,11 @@ struct NET_EXPORT_PRIVATE QuicConnectionStats {
 
   uint32 rtt;
   uint64 estimated_bandwidth;
+
+  // Only set when pacing is enabled.
+  uint32 packets_paced;  // held back to follow the pacing rate.
+  uint64 pacing_delay;  // total time packets were held back, in microseconds.
+  uint64 pacing_rate;  // in bytes per second.
   // TODO(satyamshekhar): Add window_size, mss and mtu.
 };
 
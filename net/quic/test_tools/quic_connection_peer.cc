@@ -31,6 +31,7 @@ void QuicConnectionPeer::SetSendAlgorithm(
     QuicConnection* connection,
     SendAlgorithmInterface* send_algorithm) {
   connection->congestion_manager_.send_algorithm_.reset(send_algorithm);
+  connection->congestion_manager_.pacing_sender_ = NULL;
 }
 
 // static
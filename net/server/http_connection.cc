@@ -31,7 +31,10 @@ void HttpConnection::Send(const HttpServerResponseInfo& response) {
 
 HttpConnection::HttpConnection(HttpServer* server, StreamListenSocket* sock)
     : server_(server),
-      socket_(sock) {
+      socket_(sock),
+      pending_responses_(0),
+      close_after_response_(false),
+      sending_chunked_response_(false) {
   id_ = last_id_++;
 }
 
@@ -45,7 +48,7 @@ void HttpConnection::DetachSocket() {
 }
 
 void HttpConnection::Shift(int num_bytes) {
-  recv_data_ = recv_data_.substr(num_bytes);
+  recv_data_.erase(0, num_bytes);
 }
 
 }  // namespace net
@@ -45,6 +45,16 @@ class HttpConnection {
   scoped_ptr<WebSocket> web_socket_;
   std::string recv_data_;
   int id_;
+
+  // The number of requests passed to the delegate that haven't been fully
+  // answered yet, and whether the last of them asked for the connection to
+  // be closed after its response, in which case no more requests are read.
+  size_t pending_responses_;
+  bool close_after_response_;
+
+  // Whether a response body is being sent with chunked transfer encoding.
+  bool sending_chunked_response_;
+
   DISALLOW_COPY_AND_ASSIGN(HttpConnection);
 };
 
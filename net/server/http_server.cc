@@ -4,15 +4,20 @@
 
 #include "net/server/http_server.h"
 
+#include "base/bind.h"
 #include "base/compiler_specific.h"
+#include "base/format_macros.h"
+#include "base/location.h"
 #include "base/logging.h"
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/sys_byteorder.h"
+#include "base/task_runner.h"
 #include "build/build_config.h"
 #include "net/base/net_errors.h"
+#include "net/http/http_request_headers.h"
 #include "net/server/http_connection.h"
 #include "net/server/http_server_request_info.h"
 #include "net/server/http_server_response_info.h"
@@ -24,7 +29,14 @@ namespace net {
 HttpServer::HttpServer(const StreamListenSocketFactory& factory,
                        HttpServer::Delegate* delegate)
     : delegate_(delegate),
-      server_(factory.CreateAndListen(this)) {
+      server_(factory.CreateAndListen(this)),
+      message_loop_proxy_(base::MessageLoopProxy::current()) {
+}
+
+void HttpServer::SetRequestHandlerTaskRunner(
+    const scoped_refptr<base::TaskRunner>& task_runner) {
+  DCHECK(message_loop_proxy_->BelongsToCurrentThread());
+  request_handler_task_runner_ = task_runner;
 }
 
 void HttpServer::AcceptWebSocket(
@@ -49,10 +61,18 @@ void HttpServer::SendOverWebSocket(int connection_id,
 
 void HttpServer::SendResponse(int connection_id,
                               const HttpServerResponseInfo& response) {
+  if (!message_loop_proxy_->BelongsToCurrentThread()) {
+    message_loop_proxy_->PostTask(
+        FROM_HERE,
+        base::Bind(&HttpServer::SendResponse, this, connection_id, response));
+    return;
+  }
   HttpConnection* connection = FindConnection(connection_id);
   if (connection == NULL)
     return;
+  DCHECK(!connection->sending_chunked_response_);
   connection->Send(response);
+  DidFinishResponse(connection);
 }
 
 void HttpServer::Send(int connection_id,
@@ -78,7 +98,71 @@ void HttpServer::Send500(int connection_id, const std::string& message) {
   SendResponse(connection_id, HttpServerResponseInfo::CreateFor500(message));
 }
 
+void HttpServer::StartChunkedResponse(int connection_id,
+                                      HttpStatusCode status_code,
+                                      const std::string& content_type) {
+  if (!message_loop_proxy_->BelongsToCurrentThread()) {
+    message_loop_proxy_->PostTask(
+        FROM_HERE,
+        base::Bind(&HttpServer::StartChunkedResponse, this, connection_id,
+                   status_code, content_type));
+    return;
+  }
+  HttpConnection* connection = FindConnection(connection_id);
+  if (connection == NULL)
+    return;
+  DCHECK(!connection->sending_chunked_response_);
+  HttpServerResponseInfo response(status_code);
+  response.AddHeader(HttpRequestHeaders::kTransferEncoding, "chunked");
+  response.AddHeader(HttpRequestHeaders::kContentType, content_type);
+  connection->Send(response);
+  connection->sending_chunked_response_ = true;
+}
+
+void HttpServer::SendChunk(int connection_id, const std::string& data) {
+  if (!message_loop_proxy_->BelongsToCurrentThread()) {
+    message_loop_proxy_->PostTask(
+        FROM_HERE,
+        base::Bind(&HttpServer::SendChunk, this, connection_id, data));
+    return;
+  }
+  HttpConnection* connection = FindConnection(connection_id);
+  if (connection == NULL)
+    return;
+  DCHECK(connection->sending_chunked_response_);
+  // An empty chunk would end the body.
+  if (data.empty())
+    return;
+  std::string chunk = base::StringPrintf("%" PRIx64 "\r\n",
+                                         static_cast<uint64>(data.length()));
+  chunk.reserve(chunk.length() + data.length() + 2);
+  chunk.append(data);
+  chunk.append("\r\n");
+  connection->Send(chunk);
+}
+
+void HttpServer::FinishChunkedResponse(int connection_id) {
+  if (!message_loop_proxy_->BelongsToCurrentThread()) {
+    message_loop_proxy_->PostTask(
+        FROM_HERE,
+        base::Bind(&HttpServer::FinishChunkedResponse, this, connection_id));
+    return;
+  }
+  HttpConnection* connection = FindConnection(connection_id);
+  if (connection == NULL)
+    return;
+  DCHECK(connection->sending_chunked_response_);
+  connection->Send("0\r\n\r\n");
+  connection->sending_chunked_response_ = false;
+  DidFinishResponse(connection);
+}
+
 void HttpServer::Close(int connection_id) {
+  if (!message_loop_proxy_->BelongsToCurrentThread()) {
+    message_loop_proxy_->PostTask(
+        FROM_HERE, base::Bind(&HttpServer::Close, this, connection_id));
+    return;
+  }
   HttpConnection* connection = FindConnection(connection_id);
   if (connection == NULL)
     return;
@@ -110,7 +194,15 @@ void HttpServer::DidRead(StreamListenSocket* socket,
     return;
 
   connection->recv_data_.append(data, len);
-  while (connection->recv_data_.length()) {
+  ProcessReceivedData(connection->id());
+}
+
+void HttpServer::ProcessReceivedData(int connection_id) {
+  // The delegate may close the connection from any of its callbacks, so look
+  // it up again each time around.
+  HttpConnection* connection;
+  while ((connection = FindConnection(connection_id)) != NULL &&
+         !connection->recv_data_.empty()) {
     if (connection->web_socket_.get()) {
       std::string message;
       WebSocket::ParseResult result = connection->web_socket_->Read(&message);
@@ -119,13 +211,22 @@ void HttpServer::DidRead(StreamListenSocket* socket,
 
       if (result == WebSocket::FRAME_CLOSE ||
           result == WebSocket::FRAME_ERROR) {
-        Close(connection->id());
+        Close(connection_id);
         break;
       }
-      delegate_->OnWebSocketMessage(connection->id(), message);
+      delegate_->OnWebSocketMessage(connection_id, message);
       continue;
     }
 
+    // Nothing may follow a request that closes the connection, and requests
+    // handled on another thread are handed out one at a time so that their
+    // responses can't be reordered.
+    if (connection->close_after_response_ ||
+        (request_handler_task_runner_.get() &&
+         connection->pending_responses_ > 0)) {
+      break;
+    }
+
     HttpServerRequestInfo request;
     size_t pos = 0;
     if (!ParseHeaders(connection, &request, &pos))
@@ -139,7 +240,10 @@ void HttpServer::DidRead(StreamListenSocket* socket,
 
       if (!connection->web_socket_.get())  // Not enough data was received.
         break;
-      delegate_->OnWebSocketRequest(connection->id(), request);
+      delegate_->OnWebSocketRequest(connection_id, request);
+      connection = FindConnection(connection_id);
+      if (connection == NULL)
+        break;
       connection->Shift(pos);
       continue;
     }
@@ -154,7 +258,7 @@ void HttpServer::DidRead(StreamListenSocket* socket,
         connection->Send(HttpServerResponseInfo::CreateFor500(
             "request content-length too big or unknown: " +
             request.GetHeaderValue(kContentLength)));
-        DidClose(socket);
+        DidClose(connection->socket_.get());
         break;
       }
 
@@ -164,8 +268,41 @@ void HttpServer::DidRead(StreamListenSocket* socket,
       pos += content_length;
     }
 
-    delegate_->OnHttpRequest(connection->id(), request);
     connection->Shift(pos);
+    ++connection->pending_responses_;
+    if (LowerCaseEqualsASCII(connection_header, "close"))
+      connection->close_after_response_ = true;
+
+    if (request_handler_task_runner_.get()) {
+      request_handler_task_runner_->PostTask(
+          FROM_HERE,
+          base::Bind(&HttpServer::Delegate::OnHttpRequest,
+                     base::Unretained(delegate_), connection_id, request));
+    } else {
+      delegate_->OnHttpRequest(connection_id, request);
+    }
+  }
+}
+
+void HttpServer::DidFinishResponse(HttpConnection* connection) {
+  // Responses sent without a request, like the error for a bad request, don't
+  // count.
+  if (connection->pending_responses_ == 0)
+    return;
+  if (--connection->pending_responses_ > 0)
+    return;
+
+  if (connection->close_after_response_) {
+    // This may run in the middle of reading from the socket, which must not be
+    // closed under it.
+    message_loop_proxy_->PostTask(
+        FROM_HERE, base::Bind(&HttpServer::Close, this, connection->id()));
+  } else if (request_handler_task_runner_.get() &&
+             !connection->recv_data_.empty()) {
+    // Hand out the next pipelined request.
+    message_loop_proxy_->PostTask(
+        FROM_HERE,
+        base::Bind(&HttpServer::ProcessReceivedData, this, connection->id()));
   }
 }
 
@@ -248,6 +385,11 @@ int charToInput(char ch) {
 bool HttpServer::ParseHeaders(HttpConnection* connection,
                               HttpServerRequestInfo* info,
                               size_t* ppos) {
+  // The headers end with an empty line, so don't run the parser over a
+  // partially received request again and again.
+  if (connection->recv_data_.find("\n\r\n") == std::string::npos)
+    return false;
+
   size_t& pos = *ppos;
   size_t data_len = connection->recv_data_.length();
   int state = ST_METHOD;
@@ -10,9 +10,14 @@
 
 #include "base/basictypes.h"
 #include "base/memory/ref_counted.h"
+#include "base/message_loop/message_loop_proxy.h"
 #include "net/http/http_status_code.h"
 #include "net/socket/stream_listen_socket.h"
 
+namespace base {
+class TaskRunner;
+}
+
 namespace net {
 
 class HttpConnection;
@@ -44,6 +49,16 @@ class HttpServer : public StreamListenSocket::Delegate,
   HttpServer(const StreamListenSocketFactory& socket_factory,
              HttpServer::Delegate* delegate);
 
+  // Makes OnHttpRequest() run on |task_runner|, e.g. a worker pool, instead
+  // of the thread the server was created on. The delegate must then handle
+  // requests in a thread-safe way; the functions below that send a response
+  // or close a connection may be called from any thread. The requests
+  // pipelined on a connection are handed out one at a time, so that their
+  // responses are sent in order. WebSocket events and OnClose() are still
+  // delivered on the server's thread.
+  void SetRequestHandlerTaskRunner(
+      const scoped_refptr<base::TaskRunner>& task_runner);
+
   void AcceptWebSocket(int connection_id,
                        const HttpServerRequestInfo& request);
   void SendOverWebSocket(int connection_id, const std::string& data);
@@ -58,6 +73,15 @@ class HttpServer : public StreamListenSocket::Delegate,
   void Send404(int connection_id);
   void Send500(int connection_id, const std::string& message);
 
+  // Sends the headers of a response whose body is streamed with chunked
+  // transfer encoding: each SendChunk() sends one chunk of the body, and
+  // FinishChunkedResponse() ends it.
+  void StartChunkedResponse(int connection_id,
+                            HttpStatusCode status_code,
+                            const std::string& content_type);
+  void SendChunk(int connection_id, const std::string& data);
+  void FinishChunkedResponse(int connection_id);
+
   void Close(int connection_id);
 
   // Copies the local address to |address|. Returns a network error code.
@@ -85,11 +109,24 @@ class HttpServer : public StreamListenSocket::Delegate,
                     HttpServerRequestInfo* info,
                     size_t* pos);
 
+  // Handles as much of the data received on the connection as possible.
+  void ProcessReceivedData(int connection_id);
+
+  // Called once the response to the oldest pending request of |connection|
+  // has been sent. Closes the connection if that request asked for it.
+  void DidFinishResponse(HttpConnection* connection);
+
   HttpConnection* FindConnection(int connection_id);
   HttpConnection* FindConnection(StreamListenSocket* socket);
 
   HttpServer::Delegate* delegate_;
   scoped_refptr<StreamListenSocket> server_;
+
+  // The thread the server runs on, and the task runner requests are
+  // handled on if it isn't that thread.
+  scoped_refptr<base::MessageLoopProxy> message_loop_proxy_;
+  scoped_refptr<base::TaskRunner> request_handler_task_runner_;
+
   typedef std::map<int, HttpConnection*> IdToConnectionMap;
   IdToConnectionMap id_to_connection_;
   typedef std::map<StreamListenSocket*, HttpConnection*> SocketToConnectionMap;
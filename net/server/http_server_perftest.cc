@@ -0,0 +1,119 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "base/memory/ref_counted.h"
+#include "base/message_loop/message_loop.h"
+#include "base/perftimer.h"
+#include "net/server/http_server.h"
+#include "net/server/http_server_request_info.h"
+#include "net/socket/tcp_listen_socket.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const int kNumRequests = 100000;
+
+// A request the way DevTools front-ends send them.
+const char kRequest[] =
+    "GET /json/version HTTP/1.1\r\n"
+    "Host: 127.0.0.1:9222\r\n"
+    "Connection: keep-alive\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 "
+    "(KHTML, like Gecko) Chrome/30.0.1599.0 Safari/537.36\r\n"
+    "Accept: */*\r\n"
+    "Accept-Encoding: gzip,deflate,sdch\r\n"
+    "Accept-Language: en-US,en;q=0.8\r\n"
+    "\r\n";
+
+class MockStreamListenSocket : public StreamListenSocket {
+ public:
+  explicit MockStreamListenSocket(StreamListenSocket::Delegate* delegate)
+      : StreamListenSocket(kInvalidSocket, delegate) {}
+
+  virtual void Accept() OVERRIDE { NOTREACHED(); }
+
+ private:
+  virtual ~MockStreamListenSocket() {}
+};
+
+class HttpServerPerfTest : public testing::Test,
+                           public HttpServer::Delegate {
+ public:
+  HttpServerPerfTest() : request_count_(0) {}
+
+  virtual void SetUp() OVERRIDE {
+    TCPListenSocketFactory socket_factory("127.0.0.1", 0);
+    server_ = new HttpServer(socket_factory, this);
+  }
+
+  virtual void OnHttpRequest(int connection_id,
+                             const HttpServerRequestInfo& info) OVERRIDE {
+    ++request_count_;
+  }
+
+  virtual void OnWebSocketRequest(int connection_id,
+                                  const HttpServerRequestInfo& info) OVERRIDE {
+    NOTREACHED();
+  }
+
+  virtual void OnWebSocketMessage(int connection_id,
+                                  const std::string& data) OVERRIDE {
+    NOTREACHED();
+  }
+
+  virtual void OnClose(int connection_id) OVERRIDE {}
+
+  // Feeds kNumRequests copies of kRequest to a new connection, |packet_size|
+  // bytes at a time, and logs how many requests were handled per second.
+  void RunTest(const char* name, size_t packet_size) {
+    scoped_refptr<StreamListenSocket> socket(
+        new MockStreamListenSocket(server_.get()));
+    server_->DidAccept(NULL, socket.get());
+
+    std::string data;
+    for (int i = 0; i < 100; ++i)
+      data += kRequest;
+
+    PerfTimer timer;
+    for (int i = 0; i < kNumRequests / 100; ++i) {
+      for (size_t pos = 0; pos < data.length(); pos += packet_size) {
+        size_t len = std::min(packet_size, data.length() - pos);
+        server_->DidRead(socket.get(), data.data() + pos,
+                         static_cast<int>(len));
+      }
+    }
+    double elapsed = timer.Elapsed().InSecondsF();
+    EXPECT_EQ(kNumRequests, request_count_);
+    LogPerfResult(name, kNumRequests / elapsed, "requests/s");
+
+    server_->DidClose(socket.get());
+    request_count_ = 0;
+  }
+
+ protected:
+  base::MessageLoopForIO message_loop_;
+  scoped_refptr<HttpServer> server_;
+  int request_count_;
+};
+
+}  // namespace
+
+// Whole batches of pipelined requests arriving in full reads.
+TEST_F(HttpServerPerfTest, PipelinedRequests) {
+  RunTest("HttpServer_pipelined_requests", 4096);
+}
+
+// Requests trickling in a few bytes at a time, as over a slow link.
+TEST_F(HttpServerPerfTest, FragmentedRequests) {
+  RunTest("HttpServer_fragmented_requests", 16);
+}
+
+}  // namespace net
@@ -17,6 +17,7 @@
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
+#include "base/threading/thread.h"
 #include "base/time/time.h"
 #include "net/base/address_list.h"
 #include "net/base/io_buffer.h"
@@ -61,7 +62,7 @@ bool RunLoopWithTimeout(base::RunLoop* run_loop) {
 
 class TestHttpClient {
  public:
-  TestHttpClient() : connect_result_(OK) {}
+  TestHttpClient() : connect_result_(OK), read_result_(OK) {}
 
   int ConnectAndWait(const IPEndPoint& address) {
     AddressList addresses(address);
@@ -86,12 +87,39 @@ class TestHttpClient {
     Write();
   }
 
+  // Reads until |terminator| has been received, appending everything read to
+  // |message|. Returns a network error code.
+  int ReadUntil(const std::string& terminator, std::string* message) {
+    while (message->find(terminator) == std::string::npos) {
+      scoped_refptr<IOBufferWithSize> buffer(new IOBufferWithSize(4096));
+      base::RunLoop run_loop;
+      read_result_ = socket_->Read(buffer.get(),
+                                   buffer->size(),
+                                   base::Bind(&TestHttpClient::OnRead,
+                                              base::Unretained(this),
+                                              run_loop.QuitClosure()));
+      if (read_result_ == ERR_IO_PENDING && !RunLoopWithTimeout(&run_loop))
+        return ERR_TIMED_OUT;
+      if (read_result_ == 0)
+        return ERR_CONNECTION_CLOSED;
+      if (read_result_ < 0)
+        return read_result_;
+      message->append(buffer->data(), read_result_);
+    }
+    return OK;
+  }
+
  private:
   void OnConnect(const base::Closure& quit_loop, int result) {
     connect_result_ = result;
     quit_loop.Run();
   }
 
+  void OnRead(const base::Closure& quit_loop, int result) {
+    read_result_ = result;
+    quit_loop.Run();
+  }
+
   void Write() {
     int result = socket_->Write(
         write_buffer_.get(),
@@ -111,6 +139,7 @@ class TestHttpClient {
   scoped_refptr<DrainableIOBuffer> write_buffer_;
   scoped_ptr<TCPClientSocket> socket_;
   int connect_result_;
+  int read_result_;
 };
 
 }  // namespace
@@ -129,6 +158,7 @@ class HttpServerTest : public testing::Test,
   virtual void OnHttpRequest(int connection_id,
                              const HttpServerRequestInfo& info) OVERRIDE {
     requests_.push_back(info);
+    connection_ids_.push_back(connection_id);
     if (requests_.size() == quit_after_request_count_)
       run_loop_quit_func_.Run();
   }
@@ -162,6 +192,7 @@ class HttpServerTest : public testing::Test,
   IPEndPoint server_address_;
   base::Closure run_loop_quit_func_;
   std::vector<HttpServerRequestInfo> requests_;
+  std::vector<int> connection_ids_;
 
  private:
   size_t quit_after_request_count_;
@@ -316,4 +347,86 @@ TEST_F(HttpServerTest, MultipleRequestsOnSameConnection) {
   ASSERT_EQ("/test3", requests_[2].path);
 }
 
+TEST_F(HttpServerTest, ChunkedResponse) {
+  TestHttpClient client;
+  ASSERT_EQ(OK, client.ConnectAndWait(server_address_));
+  client.Send("GET /trace HTTP/1.1\r\n\r\n");
+  ASSERT_TRUE(RunUntilRequestsReceived(1));
+
+  server_->StartChunkedResponse(connection_ids_[0], HTTP_OK, "text/plain");
+  server_->SendChunk(connection_ids_[0], "Hello, ");
+  server_->SendChunk(connection_ids_[0], "");
+  server_->SendChunk(connection_ids_[0], std::string(20, 'x'));
+  server_->FinishChunkedResponse(connection_ids_[0]);
+
+  std::string response;
+  ASSERT_EQ(OK, client.ReadUntil("\r\n0\r\n\r\n", &response));
+  EXPECT_TRUE(StartsWithASCII(response, "HTTP/1.1 200 OK\r\n", true));
+  std::string::size_type body_start = response.find("\r\n\r\n");
+  ASSERT_NE(std::string::npos, body_start);
+  std::string headers = StringToLowerASCII(response.substr(0, body_start));
+  EXPECT_NE(std::string::npos, headers.find("transfer-encoding:chunked"));
+  EXPECT_EQ(std::string::npos, headers.find("content-length"));
+  EXPECT_EQ("\r\n\r\n7\r\nHello, \r\n14\r\n" + std::string(20, 'x') +
+                "\r\n0\r\n\r\n",
+            response.substr(body_start));
+}
+
+TEST_F(HttpServerTest, ConnectionCloseEndsPipeline) {
+  TestHttpClient client;
+  ASSERT_EQ(OK, client.ConnectAndWait(server_address_));
+  client.Send("GET /test HTTP/1.1\r\n"
+              "Connection: close\r\n\r\n"
+              "GET /ignored HTTP/1.1\r\n\r\n");
+  ASSERT_TRUE(RunUntilRequestsReceived(1));
+  server_->Send200(connection_ids_[0], "body", "text/plain");
+
+  std::string response;
+  ASSERT_EQ(ERR_CONNECTION_CLOSED, client.ReadUntil("never sent", &response));
+  EXPECT_TRUE(EndsWith(response, "\r\n\r\nbody", true));
+  EXPECT_EQ(1u, requests_.size());
+}
+
+TEST_F(HttpServerTest, PipelinedRequestsOnRequestHandlerTaskRunner) {
+  server_->SetRequestHandlerTaskRunner(base::MessageLoopProxy::current());
+  TestHttpClient client;
+  ASSERT_EQ(OK, client.ConnectAndWait(server_address_));
+  client.Send("GET /1 HTTP/1.1\r\n\r\n"
+              "GET /2 HTTP/1.1\r\n\r\n"
+              "GET /3 HTTP/1.1\r\n\r\n");
+
+  std::string response;
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_TRUE(RunUntilRequestsReceived(i + 1));
+    // The next request is only handed out once this one is answered.
+    base::MessageLoop::current()->RunUntilIdle();
+    ASSERT_EQ(i + 1, requests_.size());
+    EXPECT_EQ(base::StringPrintf("/%d", static_cast<int>(i + 1)),
+              requests_[i].path);
+    std::string body = "response to " + requests_[i].path;
+    server_->Send200(connection_ids_[i], body, "text/plain");
+    ASSERT_EQ(OK, client.ReadUntil(body, &response));
+  }
+  EXPECT_EQ(3u, requests_.size());
+}
+
+TEST_F(HttpServerTest, SendResponseFromAnotherThread) {
+  TestHttpClient client;
+  ASSERT_EQ(OK, client.ConnectAndWait(server_address_));
+  client.Send("GET /test HTTP/1.1\r\n\r\n");
+  ASSERT_TRUE(RunUntilRequestsReceived(1));
+
+  base::Thread worker("HttpServerTestWorker");
+  ASSERT_TRUE(worker.Start());
+  worker.message_loop_proxy()->PostTask(
+      FROM_HERE,
+      base::Bind(&HttpServer::Send200, server_, connection_ids_[0],
+                 std::string("from worker"), std::string("text/plain")));
+  worker.Stop();
+
+  std::string response;
+  ASSERT_EQ(OK, client.ReadUntil("from worker", &response));
+  EXPECT_TRUE(StartsWithASCII(response, "HTTP/1.1 200 OK\r\n", true));
+}
+
 }  // namespace net
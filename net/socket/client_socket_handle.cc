@@ -59,6 +59,7 @@ void ClientSocketHandle::ResetInternal(bool cancel) {
   }
   pool_ = NULL;
   idle_time_ = base::TimeDelta();
+  connect_time_saved_ = base::TimeDelta();
   init_time_ = base::TimeTicks();
   setup_time_ = base::TimeDelta();
   connect_timing_ = LoadTimingInfo::ConnectTiming();
@@ -150,6 +151,8 @@ void ClientSocketHandle::HandleInitCompletion(int result) {
       break;
     case ClientSocketHandle::UNUSED_IDLE:
       histograms->AddUnusedIdleTime(idle_time());
+      if (connect_time_saved() > base::TimeDelta())
+        histograms->AddConnectTimeSaved(connect_time_saved());
       break;
     case ClientSocketHandle::REUSED_IDLE:
       histograms->AddReusedIdleTime(idle_time());
@@ -166,6 +166,13 @@ class NET_EXPORT ClientSocketHandle {
     connect_timing_ = connect_timing;
   }
 
+  // How long a socket that was connected ahead of the request, and not used
+  // before, took to connect. Zero for other sockets.
+  base::TimeDelta connect_time_saved() const { return connect_time_saved_; }
+  void set_connect_time_saved(base::TimeDelta connect_time_saved) {
+    connect_time_saved_ = connect_time_saved;
+  }
+
  private:
   // Called on asynchronous completion of an Init() request.
   void OnIOComplete(int result);
@@ -191,6 +198,7 @@ class NET_EXPORT ClientSocketHandle {
   CompletionCallback callback_;
   CompletionCallback user_callback_;
   base::TimeDelta idle_time_;
+  base::TimeDelta connect_time_saved_;
   int pool_id_;  // See ClientSocketPool::ReleaseSocket() for an explanation.
   bool is_ssl_error_;
   HttpResponseInfo ssl_error_response_info_;
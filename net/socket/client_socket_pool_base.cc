@@ -4,6 +4,8 @@
 
 #include "net/socket/client_socket_pool_base.h"
 
+#include <algorithm>
+
 #include "base/compiler_specific.h"
 #include "base/format_macros.h"
 #include "base/logging.h"
@@ -39,6 +41,25 @@ const int kCleanupInterval = 10;  // DO NOT INCREASE THIS TIMEOUT.
 // after a certain timeout has passed without receiving an ACK.
 bool g_connect_backup_jobs_enabled = true;
 
+// Indicate whether or not preconnects should open as many sockets as the
+// group has needed at once before.
+bool g_preconnect_learned_demand_enabled = false;
+
+// The number of groups whose peak demand is remembered.
+const size_t kMaxGroupDemandEntries = 256;
+
+// Returns how long the socket described by |connect_timing| took to connect,
+// including the host resolution.
+base::TimeDelta GetConnectDuration(
+    const LoadTimingInfo::ConnectTiming& connect_timing) {
+  base::TimeTicks start = connect_timing.dns_start;
+  if (start.is_null())
+    start = connect_timing.connect_start;
+  if (start.is_null() || connect_timing.connect_end.is_null())
+    return base::TimeDelta();
+  return connect_timing.connect_end - start;
+}
+
 // Compares the effective priority of two results, and returns 1 if |request1|
 // has greater effective priority than |request2|, 0 if they have the same
 // effective priority, and -1 if |request2| has the greater effective priority.
@@ -175,6 +196,7 @@ ClientSocketPoolBaseHelper::ClientSocketPoolBaseHelper(
       unused_idle_socket_timeout_(unused_idle_socket_timeout),
       used_idle_socket_timeout_(used_idle_socket_timeout),
       connect_job_factory_(connect_job_factory),
+      group_demand_(kMaxGroupDemandEntries),
       connect_backup_jobs_enabled_(false),
       pool_generation_number_(0),
       weak_factory_(this) {
@@ -264,8 +286,11 @@ int ClientSocketPoolBaseHelper::RequestSocket(
     request->net_log().EndEventWithNetErrorCode(NetLog::TYPE_SOCKET_POOL, rv);
     CHECK(!request->handle()->is_initialized());
     delete request;
+    if (rv == OK)
+      RecordGroupDemand(group_name, *group);
   } else {
     InsertRequestIntoQueue(request, group->mutable_pending_requests());
+    RecordGroupDemand(group_name, *group);
     // Have to do this asynchronously, as closing sockets in higher level pools
     // call back in to |this|, which will cause all sorts of fun and exciting
     // re-entrancy issues if the socket pool is doing something else at the
@@ -292,6 +317,9 @@ void ClientSocketPoolBaseHelper::RequestSockets(
   if (!use_cleanup_timer_)
     CleanupIdleSockets(false);
 
+  if (g_preconnect_learned_demand_enabled)
+    num_sockets = std::max(num_sockets, LearnedDemandForGroup(group_name));
+
   if (num_sockets > max_sockets_per_group_) {
     num_sockets = max_sockets_per_group_;
   }
@@ -396,7 +424,8 @@ int ClientSocketPoolBaseHelper::RequestSocketInternal(
                     connect_job->connect_timing(), handle, base::TimeDelta(),
                     group, request->net_log());
     } else {
-      AddIdleSocket(connect_job->ReleaseSocket(), group);
+      AddIdleSocket(connect_job->ReleaseSocket(),
+                    GetConnectDuration(connect_job->connect_timing()), group);
     }
   } else if (rv == ERR_IO_PENDING) {
     // If we don't have any sockets in this group, set a timer for potentially
@@ -468,6 +497,7 @@ bool ClientSocketPoolBaseHelper::AssignIdleSocketToRequest(
         base::TimeTicks::Now() - idle_socket_it->start_time;
     IdleSocket idle_socket = *idle_socket_it;
     idle_sockets->erase(idle_socket_it);
+    request->handle()->set_connect_time_saved(idle_socket.connect_time);
     HandOutSocket(
         idle_socket.socket,
         idle_socket.socket->WasEverUsed(),
@@ -728,6 +758,38 @@ void ClientSocketPoolBaseHelper::EnableConnectBackupJobs() {
   connect_backup_jobs_enabled_ = g_connect_backup_jobs_enabled;
 }
 
+// static
+bool ClientSocketPoolBaseHelper::preconnect_learned_demand_enabled() {
+  return g_preconnect_learned_demand_enabled;
+}
+
+// static
+bool ClientSocketPoolBaseHelper::set_preconnect_learned_demand_enabled(
+    bool enabled) {
+  bool old_value = g_preconnect_learned_demand_enabled;
+  g_preconnect_learned_demand_enabled = enabled;
+  return old_value;
+}
+
+int ClientSocketPoolBaseHelper::LearnedDemandForGroup(
+    const std::string& group_name) {
+  GroupDemandMap::iterator it = group_demand_.Peek(group_name);
+  if (it == group_demand_.end())
+    return 0;
+  return it->second;
+}
+
+void ClientSocketPoolBaseHelper::RecordGroupDemand(
+    const std::string& group_name, const Group& group) {
+  int demand = group.active_socket_count() +
+      static_cast<int>(group.pending_requests().size());
+  GroupDemandMap::iterator it = group_demand_.Get(group_name);
+  if (it == group_demand_.end())
+    group_demand_.Put(group_name, demand);
+  else if (demand > it->second)
+    it->second = demand;
+}
+
 void ClientSocketPoolBaseHelper::IncrementIdleCount() {
   if (++idle_socket_count_ == 1 && use_cleanup_timer_)
     StartIdleSocketTimer();
@@ -773,7 +835,7 @@ void ClientSocketPoolBaseHelper::ReleaseSocket(const std::string& group_name,
       id == pool_generation_number_;
   if (can_reuse) {
     // Add it to the idle list.
-    AddIdleSocket(socket, group);
+    AddIdleSocket(socket, base::TimeDelta(), group);
     OnAvailableSocketSlot(group_name, group);
   } else {
     delete socket;
@@ -874,7 +936,8 @@ void ClientSocketPoolBaseHelper::OnConnectJobComplete(
       r->net_log().EndEvent(NetLog::TYPE_SOCKET_POOL);
       InvokeUserCallbackLater(r->handle(), r->callback(), result);
     } else {
-      AddIdleSocket(socket.release(), group);
+      AddIdleSocket(socket.release(), GetConnectDuration(connect_timing),
+                    group);
       OnAvailableSocketSlot(group_name, group);
       CheckForStalledSocketGroups();
     }
@@ -1008,11 +1071,12 @@ void ClientSocketPoolBaseHelper::HandOutSocket(
 }
 
 void ClientSocketPoolBaseHelper::AddIdleSocket(
-    StreamSocket* socket, Group* group) {
+    StreamSocket* socket, base::TimeDelta connect_time, Group* group) {
   DCHECK(socket);
   IdleSocket idle_socket;
   idle_socket.socket = socket;
   idle_socket.start_time = base::TimeTicks::Now();
+  idle_socket.connect_time = connect_time;
 
   group->mutable_idle_sockets()->push_back(idle_socket);
   IncrementIdleCount();
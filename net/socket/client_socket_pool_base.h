@@ -30,6 +30,7 @@
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/containers/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
@@ -310,6 +311,17 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
 
   void EnableConnectBackupJobs();
 
+  // Called to enable/disable preconnecting to the peak demand a group has
+  // seen. When enabled, RequestSockets() opens at least as many sockets as
+  // the group has ever had in use or waiting at once, up to the per group
+  // limit.
+  static bool preconnect_learned_demand_enabled();
+  static bool set_preconnect_learned_demand_enabled(bool enabled);
+
+  // Returns the largest number of sockets |group_name| has had in use or
+  // waiting at once, or 0 if it isn't known.
+  int LearnedDemandForGroup(const std::string& group_name);
+
   // ConnectJob::Delegate methods:
   virtual void OnConnectJobComplete(int result, ConnectJob* job) OVERRIDE;
 
@@ -335,6 +347,8 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
 
     StreamSocket* socket;
     base::TimeTicks start_time;
+    // How long it took to connect the socket, if it was never used.
+    base::TimeDelta connect_time;
   };
 
   typedef std::deque<const Request* > RequestQueue;
@@ -493,8 +507,14 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
                      Group* group,
                      const BoundNetLog& net_log);
 
-  // Adds |socket| to the list of idle sockets for |group|.
-  void AddIdleSocket(StreamSocket* socket, Group* group);
+  // Adds |socket| to the list of idle sockets for |group|. |connect_time|
+  // is how long the socket took to connect, or zero if it has been used.
+  void AddIdleSocket(StreamSocket* socket,
+                     base::TimeDelta connect_time,
+                     Group* group);
+
+  // Remembers the current demand of |group| if it is the largest seen.
+  void RecordGroupDemand(const std::string& group_name, const Group& group);
 
   // Iterates through |group_map_|, canceling all ConnectJobs and deleting
   // groups if they are no longer needed.
@@ -547,6 +567,11 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
 
   GroupMap group_map_;
 
+  // The peak demand of recently used groups, see LearnedDemandForGroup().
+  // Unlike |group_map_|, entries outlive the groups.
+  typedef base::MRUCache<std::string, int> GroupDemandMap;
+  GroupDemandMap group_demand_;
+
   // Map of the ClientSocketHandles for which we have a pending Task to invoke a
   // callback.  This is necessary since, before we invoke said callback, it's
   // possible that the request is cancelled.
@@ -744,6 +769,10 @@ class ClientSocketPoolBase {
     return helper_.HasGroup(group_name);
   }
 
+  int LearnedDemandForGroup(const std::string& group_name) {
+    return helper_.LearnedDemandForGroup(group_name);
+  }
+
   void CleanupIdleSockets(bool force) {
     return helper_.CleanupIdleSockets(force);
   }
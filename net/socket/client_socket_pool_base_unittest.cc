@@ -582,6 +582,10 @@ class TestClientSocketPool : public ClientSocketPool {
     return base_.HasGroup(group_name);
   }
 
+  int LearnedDemandForGroup(const std::string& group_name) {
+    return base_.LearnedDemandForGroup(group_name);
+  }
+
   void CleanupTimedOutIdleSockets() { base_.CleanupIdleSockets(false); }
 
   void EnableConnectBackupJobs() { base_.EnableConnectBackupJobs(); }
@@ -3511,6 +3515,44 @@ TEST_F(ClientSocketPoolBaseTest, RequestSocketsDifferentNumSockets) {
   EXPECT_EQ(0, pool_->IdleSocketCountInGroup("a"));
 }
 
+// Preconnects open as many sockets as the group needed at once before, once
+// learned demand is enabled, even after the group's sockets are gone.
+TEST_F(ClientSocketPoolBaseTest, RequestSocketsUsesLearnedDemand) {
+  CreatePool(4, 4);
+  bool old_value = internal::ClientSocketPoolBaseHelper::
+      set_preconnect_learned_demand_enabled(true);
+
+  ClientSocketHandle handles[3];
+  for (size_t i = 0; i < arraysize(handles); ++i) {
+    TestCompletionCallback callback;
+    EXPECT_EQ(OK, handles[i].Init("a",
+                                  params_,
+                                  kDefaultPriority,
+                                  callback.callback(),
+                                  pool_.get(),
+                                  BoundNetLog()));
+  }
+  EXPECT_EQ(3, pool_->LearnedDemandForGroup("a"));
+  EXPECT_EQ(0, pool_->LearnedDemandForGroup("b"));
+
+  for (size_t i = 0; i < arraysize(handles); ++i)
+    handles[i].Reset();
+  pool_->CloseIdleSockets();
+  EXPECT_FALSE(pool_->HasGroup("a"));
+  EXPECT_EQ(3, pool_->LearnedDemandForGroup("a"));
+
+  connect_job_factory_->set_job_type(TestConnectJob::kMockPendingJob);
+  pool_->RequestSockets("a", &params_, 1, BoundNetLog());
+  EXPECT_EQ(3, pool_->NumUnassignedConnectJobsInGroup("a"));
+
+  // Groups without history get what they ask for.
+  pool_->RequestSockets("b", &params_, 1, BoundNetLog());
+  EXPECT_EQ(1, pool_->NumUnassignedConnectJobsInGroup("b"));
+
+  internal::ClientSocketPoolBaseHelper::set_preconnect_learned_demand_enabled(
+      old_value);
+}
+
 TEST_F(ClientSocketPoolBaseTest, PreconnectJobsTakenByNormalRequests) {
   CreatePool(kDefaultMaxSockets, kDefaultMaxSocketsPerGroup);
   connect_job_factory_->set_job_type(TestConnectJob::kMockPendingJob);
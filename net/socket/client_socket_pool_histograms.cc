@@ -44,6 +44,12 @@ ClientSocketPoolHistograms::ClientSocketPoolHistograms(
       base::TimeDelta::FromMilliseconds(1),
       base::TimeDelta::FromMinutes(6),
       100, HistogramBase::kUmaTargetedHistogramFlag);
+  // UMA_HISTOGRAM_CUSTOM_TIMES
+  connect_time_saved_ = Histogram::FactoryTimeGet(
+      "Net.SocketConnectTimeSaved_" + pool_name,
+      base::TimeDelta::FromMilliseconds(1),
+      base::TimeDelta::FromMinutes(10),
+      100, HistogramBase::kUmaTargetedHistogramFlag);
   // UMA_HISTOGRAM_CUSTOM_ENUMERATION
   error_code_ = CustomHistogram::FactoryGet(
       "Net.SocketInitErrorCodes_" + pool_name,
@@ -75,6 +81,11 @@ void ClientSocketPoolHistograms::AddReusedIdleTime(base::TimeDelta time) const {
   reused_idle_time_->AddTime(time);
 }
 
+void ClientSocketPoolHistograms::AddConnectTimeSaved(
+    base::TimeDelta time) const {
+  connect_time_saved_->AddTime(time);
+}
+
 void ClientSocketPoolHistograms::AddErrorCode(int error_code) const {
   // Error codes are positive (since histograms expect positive sample values).
   error_code_->Add(-error_code);
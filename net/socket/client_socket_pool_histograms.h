@@ -26,6 +26,7 @@ class NET_EXPORT_PRIVATE ClientSocketPoolHistograms {
   void AddRequestTime(base::TimeDelta time) const;
   void AddUnusedIdleTime(base::TimeDelta time) const;
   void AddReusedIdleTime(base::TimeDelta time) const;
+  void AddConnectTimeSaved(base::TimeDelta time) const;
   void AddErrorCode(int error_code) const;
 
  private:
@@ -33,6 +34,7 @@ class NET_EXPORT_PRIVATE ClientSocketPoolHistograms {
   base::HistogramBase* request_time_;
   base::HistogramBase* unused_idle_time_;
   base::HistogramBase* reused_idle_time_;
+  base::HistogramBase* connect_time_saved_;
   base::HistogramBase* error_code_;
 
   bool is_http_proxy_connection_;
@@ -15,6 +15,7 @@
 #include "net/http/http_stream_factory.h"
 #include "net/proxy/proxy_info.h"
 #include "net/socket/client_socket_handle.h"
+#include "net/socket/client_socket_pool_base.h"
 #include "net/socket/socks_client_socket_pool.h"
 #include "net/socket/ssl_client_socket_pool.h"
 #include "net/socket/transport_client_socket_pool.h"
@@ -367,6 +368,13 @@ void ClientSocketPoolManager::set_max_sockets_per_proxy_server(
   g_max_sockets_per_proxy_server[pool_type] = socket_count;
 }
 
+// static
+void ClientSocketPoolManager::set_preconnect_learned_demand_enabled(
+    bool enabled) {
+  internal::ClientSocketPoolBaseHelper::set_preconnect_learned_demand_enabled(
+      enabled);
+}
+
 int InitSocketHandleForHttpRequest(
     const GURL& request_url,
     const HttpRequestHeaders& request_extra_headers,
@@ -67,6 +67,10 @@ class NET_EXPORT_PRIVATE ClientSocketPoolManager {
       HttpNetworkSession::SocketPoolType pool_type,
       int socket_count);
 
+  // Whether preconnects open as many sockets as the group has needed at once
+  // before, rather than only the number asked for. Applies to all pools.
+  static void set_preconnect_learned_demand_enabled(bool enabled);
+
   virtual void FlushSocketPoolsWithError(int error) = 0;
   virtual void CloseIdleSockets() = 0;
   virtual TransportClientSocketPool* GetTransportSocketPool() = 0;
@@ -10,6 +10,7 @@
 #include "base/compiler_specific.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
 #include "base/stl_util.h"
 #include "base/template_util.h"
 #include "base/threading/non_thread_safe.h"
@@ -65,6 +66,8 @@ class ClientSocketPoolManagerImpl : public base::NonThreadSafe,
                               const std::string& ssl_session_cache_shard,
                               ProxyService* proxy_service,
                               SSLConfigService* ssl_config_service,
+                              const base::WeakPtr<HttpServerProperties>&
+                                  http_server_properties,
                               HttpNetworkSession::SocketPoolType pool_type);
   virtual ~ClientSocketPoolManagerImpl();
 
@@ -111,6 +114,8 @@ class ClientSocketPoolManagerImpl : public base::NonThreadSafe,
   const std::string ssl_session_cache_shard_;
   ProxyService* const proxy_service_;
   const scoped_refptr<SSLConfigService> ssl_config_service_;
+  // Handed to the transport pools, which remember servers with broken IPv6.
+  const base::WeakPtr<HttpServerProperties> http_server_properties_;
   const HttpNetworkSession::SocketPoolType pool_type_;
 
   // Note: this ordering is important.
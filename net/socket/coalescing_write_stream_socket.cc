@@ -0,0 +1,233 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/socket/coalescing_write_stream_socket.h"
+
+#include <string.h>
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/message_loop/message_loop.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+
+namespace net {
+
+// static
+const int CoalescingWriteStreamSocket::kTargetRecordSize = 16 * 1024;
+
+// static
+const int CoalescingWriteStreamSocket::kMaxBufferedBytes =
+    4 * CoalescingWriteStreamSocket::kTargetRecordSize;
+
+CoalescingWriteStreamSocket::CoalescingWriteStreamSocket(
+    StreamSocket* socket_to_wrap)
+    : wrapped_socket_(socket_to_wrap),
+      pending_buffer_(new GrowableIOBuffer()),
+      blocked_buf_len_(0),
+      flush_scheduled_(false),
+      error_(OK),
+      weak_factory_(this) {
+}
+
+CoalescingWriteStreamSocket::~CoalescingWriteStreamSocket() {
+}
+
+int CoalescingWriteStreamSocket::Read(IOBuffer* buf, int buf_len,
+                                      const CompletionCallback& callback) {
+  return wrapped_socket_->Read(buf, buf_len, callback);
+}
+
+int CoalescingWriteStreamSocket::Write(IOBuffer* buf, int buf_len,
+                                       const CompletionCallback& callback) {
+  DCHECK(blocked_callback_.is_null());
+  if (error_ != OK)
+    return error_;
+
+  if (BufferedBytes() >= kMaxBufferedBytes) {
+    blocked_buf_ = buf;
+    blocked_buf_len_ = buf_len;
+    blocked_callback_ = callback;
+    return ERR_IO_PENDING;
+  }
+
+  AppendToPendingBuffer(buf, buf_len);
+  MaybeWrite();
+  return buf_len;
+}
+
+bool CoalescingWriteStreamSocket::SetReceiveBufferSize(int32 size) {
+  return wrapped_socket_->SetReceiveBufferSize(size);
+}
+
+bool CoalescingWriteStreamSocket::SetSendBufferSize(int32 size) {
+  return wrapped_socket_->SetSendBufferSize(size);
+}
+
+int CoalescingWriteStreamSocket::Connect(const CompletionCallback& callback) {
+  return wrapped_socket_->Connect(callback);
+}
+
+void CoalescingWriteStreamSocket::Disconnect() {
+  wrapped_socket_->Disconnect();
+  pending_buffer_->SetCapacity(0);
+  write_buffer_ = NULL;
+  blocked_buf_ = NULL;
+  blocked_buf_len_ = 0;
+  blocked_callback_.Reset();
+}
+
+bool CoalescingWriteStreamSocket::IsConnected() const {
+  return wrapped_socket_->IsConnected();
+}
+
+bool CoalescingWriteStreamSocket::IsConnectedAndIdle() const {
+  return BufferedBytes() == 0 && wrapped_socket_->IsConnectedAndIdle();
+}
+
+int CoalescingWriteStreamSocket::GetPeerAddress(IPEndPoint* address) const {
+  return wrapped_socket_->GetPeerAddress(address);
+}
+
+int CoalescingWriteStreamSocket::GetLocalAddress(IPEndPoint* address) const {
+  return wrapped_socket_->GetLocalAddress(address);
+}
+
+const BoundNetLog& CoalescingWriteStreamSocket::NetLog() const {
+  return wrapped_socket_->NetLog();
+}
+
+void CoalescingWriteStreamSocket::SetSubresourceSpeculation() {
+  wrapped_socket_->SetSubresourceSpeculation();
+}
+
+void CoalescingWriteStreamSocket::SetOmniboxSpeculation() {
+  wrapped_socket_->SetOmniboxSpeculation();
+}
+
+bool CoalescingWriteStreamSocket::WasEverUsed() const {
+  return BufferedBytes() > 0 || wrapped_socket_->WasEverUsed();
+}
+
+bool CoalescingWriteStreamSocket::UsingTCPFastOpen() const {
+  return wrapped_socket_->UsingTCPFastOpen();
+}
+
+bool CoalescingWriteStreamSocket::WasNpnNegotiated() const {
+  return wrapped_socket_->WasNpnNegotiated();
+}
+
+NextProto CoalescingWriteStreamSocket::GetNegotiatedProtocol() const {
+  return wrapped_socket_->GetNegotiatedProtocol();
+}
+
+bool CoalescingWriteStreamSocket::GetSSLInfo(SSLInfo* ssl_info) {
+  return wrapped_socket_->GetSSLInfo(ssl_info);
+}
+
+int CoalescingWriteStreamSocket::BufferedBytes() const {
+  int bytes = pending_buffer_->capacity();
+  if (write_buffer_.get())
+    bytes += write_buffer_->BytesRemaining();
+  return bytes;
+}
+
+void CoalescingWriteStreamSocket::AppendToPendingBuffer(IOBuffer* buf,
+                                                        int buf_len) {
+  int old_capacity = pending_buffer_->capacity();
+  pending_buffer_->SetCapacity(old_capacity + buf_len);
+  memcpy(pending_buffer_->StartOfBuffer() + old_capacity, buf->data(),
+         buf_len);
+}
+
+void CoalescingWriteStreamSocket::MaybeWrite() {
+  if (write_buffer_.get() || error_ != OK)
+    return;
+
+  if (pending_buffer_->capacity() >= kTargetRecordSize) {
+    StartWrite();
+    DoWriteLoop();
+    return;
+  }
+
+  if (pending_buffer_->capacity() > 0 && !flush_scheduled_) {
+    flush_scheduled_ = true;
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE,
+        base::Bind(&CoalescingWriteStreamSocket::OnFlushTimer,
+                   weak_factory_.GetWeakPtr()));
+  }
+}
+
+void CoalescingWriteStreamSocket::OnFlushTimer() {
+  flush_scheduled_ = false;
+  if (write_buffer_.get() || error_ != OK || pending_buffer_->capacity() == 0)
+    return;
+  StartWrite();
+  DoWriteLoop();
+}
+
+void CoalescingWriteStreamSocket::StartWrite() {
+  DCHECK(!write_buffer_.get());
+  write_buffer_ = new DrainableIOBuffer(pending_buffer_.get(),
+                                        pending_buffer_->capacity());
+  pending_buffer_ = new GrowableIOBuffer();
+}
+
+void CoalescingWriteStreamSocket::DoWriteLoop() {
+  int result;
+  do {
+    result = wrapped_socket_->Write(
+        write_buffer_.get(),
+        write_buffer_->BytesRemaining(),
+        base::Bind(&CoalescingWriteStreamSocket::OnWriteComplete,
+                   base::Unretained(this)));
+  } while (result != ERR_IO_PENDING && HandleWriteResult(result));
+}
+
+bool CoalescingWriteStreamSocket::HandleWriteResult(int result) {
+  if (result < 0) {
+    error_ = result;
+    write_buffer_ = NULL;
+    pending_buffer_->SetCapacity(0);
+    return false;
+  }
+
+  write_buffer_->DidConsume(result);
+  if (write_buffer_->BytesRemaining() > 0)
+    return true;
+
+  write_buffer_ = NULL;
+  if (pending_buffer_->capacity() >= kTargetRecordSize) {
+    StartWrite();
+    return true;
+  }
+  MaybeWrite();
+  return false;
+}
+
+void CoalescingWriteStreamSocket::OnWriteComplete(int result) {
+  if (HandleWriteResult(result))
+    DoWriteLoop();
+
+  if (blocked_callback_.is_null() ||
+      (error_ == OK && BufferedBytes() >= kMaxBufferedBytes)) {
+    return;
+  }
+
+  int rv = error_;
+  if (rv == OK) {
+    AppendToPendingBuffer(blocked_buf_.get(), blocked_buf_len_);
+    rv = blocked_buf_len_;
+  }
+  blocked_buf_ = NULL;
+  blocked_buf_len_ = 0;
+  CompletionCallback callback = blocked_callback_;
+  blocked_callback_.Reset();
+  MaybeWrite();
+  callback.Run(rv);
+}
+
+}  // namespace net
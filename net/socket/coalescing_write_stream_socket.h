@@ -0,0 +1,115 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_SOCKET_COALESCING_WRITE_STREAM_SOCKET_H_
+#define NET_SOCKET_COALESCING_WRITE_STREAM_SOCKET_H_
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "net/base/completion_callback.h"
+#include "net/base/net_log.h"
+#include "net/socket/stream_socket.h"
+
+namespace net {
+
+class DrainableIOBuffer;
+class GrowableIOBuffer;
+class IOBuffer;
+
+// A StreamSocket decorator that coalesces small Write()s. All functions are
+// passed through to the wrapped socket, except for Write().
+//
+// Writes are copied into a local buffer and reported as done right away. The
+// buffer is written to the wrapped socket as soon as it holds a full TLS
+// record's worth of data, or once the current task is done otherwise. When
+// the wrapped socket is an SSL socket, a burst of small writes then becomes a
+// few full records sent with a single write to the transport, instead of one
+// record and one system call per Write().
+//
+// Unlike BufferedWriteStreamSocket, the buffer is bounded: once it holds
+// kMaxBufferedBytes, Write() waits for the wrapped socket. A write error is
+// returned by the next Write().
+class NET_EXPORT_PRIVATE CoalescingWriteStreamSocket : public StreamSocket {
+ public:
+  // The largest amount of data that fits in one TLS record.
+  static const int kTargetRecordSize;
+
+  // The amount of buffered data past which Write() does not complete.
+  static const int kMaxBufferedBytes;
+
+  explicit CoalescingWriteStreamSocket(StreamSocket* socket_to_wrap);
+  virtual ~CoalescingWriteStreamSocket();
+
+  // Socket interface
+  virtual int Read(IOBuffer* buf, int buf_len,
+                   const CompletionCallback& callback) OVERRIDE;
+  virtual int Write(IOBuffer* buf, int buf_len,
+                    const CompletionCallback& callback) OVERRIDE;
+  virtual bool SetReceiveBufferSize(int32 size) OVERRIDE;
+  virtual bool SetSendBufferSize(int32 size) OVERRIDE;
+
+  // StreamSocket interface
+  virtual int Connect(const CompletionCallback& callback) OVERRIDE;
+  virtual void Disconnect() OVERRIDE;
+  virtual bool IsConnected() const OVERRIDE;
+  virtual bool IsConnectedAndIdle() const OVERRIDE;
+  virtual int GetPeerAddress(IPEndPoint* address) const OVERRIDE;
+  virtual int GetLocalAddress(IPEndPoint* address) const OVERRIDE;
+  virtual const BoundNetLog& NetLog() const OVERRIDE;
+  virtual void SetSubresourceSpeculation() OVERRIDE;
+  virtual void SetOmniboxSpeculation() OVERRIDE;
+  virtual bool WasEverUsed() const OVERRIDE;
+  virtual bool UsingTCPFastOpen() const OVERRIDE;
+  virtual bool WasNpnNegotiated() const OVERRIDE;
+  virtual NextProto GetNegotiatedProtocol() const OVERRIDE;
+  virtual bool GetSSLInfo(SSLInfo* ssl_info) OVERRIDE;
+
+ private:
+  // Returns the number of bytes accepted but not yet written.
+  int BufferedBytes() const;
+
+  void AppendToPendingBuffer(IOBuffer* buf, int buf_len);
+
+  // Starts writing the pending buffer if it holds a full record, or schedules
+  // a flush if it holds less. Does nothing while a write is in progress.
+  void MaybeWrite();
+  void OnFlushTimer();
+
+  // Moves the pending buffer to |write_buffer_|.
+  void StartWrite();
+
+  // Writes |write_buffer_| to the wrapped socket until it blocks, or there
+  // is no data left worth writing.
+  void DoWriteLoop();
+
+  // Updates the buffers after a write of the wrapped socket. Returns true if
+  // there is more data to write right away.
+  bool HandleWriteResult(int result);
+  void OnWriteComplete(int result);
+
+  scoped_ptr<StreamSocket> wrapped_socket_;
+
+  // Data accepted but not yet handed to the wrapped socket.
+  scoped_refptr<GrowableIOBuffer> pending_buffer_;
+
+  // Data being written to the wrapped socket, or NULL.
+  scoped_refptr<DrainableIOBuffer> write_buffer_;
+
+  // The Write() that did not fit in the buffer, if any.
+  scoped_refptr<IOBuffer> blocked_buf_;
+  int blocked_buf_len_;
+  CompletionCallback blocked_callback_;
+
+  bool flush_scheduled_;
+  int error_;
+
+  base::WeakPtrFactory<CoalescingWriteStreamSocket> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(CoalescingWriteStreamSocket);
+};
+
+}  // namespace net
+
+#endif  // NET_SOCKET_COALESCING_WRITE_STREAM_SOCKET_H_
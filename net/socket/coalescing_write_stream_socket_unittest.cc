@@ -0,0 +1,147 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/socket/coalescing_write_stream_socket.h"
+
+#include <string>
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop/message_loop.h"
+#include "net/base/net_errors.h"
+#include "net/base/net_log.h"
+#include "net/base/test_completion_callback.h"
+#include "net/socket/socket_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+class CoalescingWriteStreamSocketTest : public testing::Test {
+ public:
+  void Finish() {
+    base::MessageLoop::current()->RunUntilIdle();
+    EXPECT_TRUE(data_->at_read_eof());
+    EXPECT_TRUE(data_->at_write_eof());
+  }
+
+  void Initialize(MockWrite* writes, size_t writes_count) {
+    data_.reset(new DeterministicSocketData(NULL, 0, writes, writes_count));
+    data_->set_connect_data(MockConnect(SYNCHRONOUS, 0));
+    if (writes_count) {
+      data_->StopAfter(writes_count);
+    }
+    DeterministicMockTCPClientSocket* wrapped_socket =
+        new DeterministicMockTCPClientSocket(net_log_.net_log(), data_.get());
+    data_->set_delegate(wrapped_socket->AsWeakPtr());
+    socket_.reset(new CoalescingWriteStreamSocket(wrapped_socket));
+    socket_->Connect(callback_.callback());
+  }
+
+  void TestWrite(const std::string& text) {
+    scoped_refptr<StringIOBuffer> buf(new StringIOBuffer(text));
+    EXPECT_EQ(buf->size(),
+              socket_->Write(buf.get(), buf->size(), callback_.callback()));
+  }
+
+  scoped_ptr<CoalescingWriteStreamSocket> socket_;
+  scoped_ptr<DeterministicSocketData> data_;
+  BoundNetLog net_log_;
+  TestCompletionCallback callback_;
+};
+
+TEST_F(CoalescingWriteStreamSocketTest, SmallWritesAreCoalesced) {
+  MockWrite writes[] = {
+    MockWrite(SYNCHRONOUS, 0, "abcdefghi"),
+  };
+  Initialize(writes, arraysize(writes));
+  TestWrite("abc");
+  TestWrite("def");
+  TestWrite("ghi");
+  EXPECT_FALSE(socket_->IsConnectedAndIdle());
+  Finish();
+}
+
+// A full record is written without waiting for the current task to finish.
+TEST_F(CoalescingWriteStreamSocketTest, FullRecordIsWrittenRightAway) {
+  const std::string record(
+      CoalescingWriteStreamSocket::kTargetRecordSize, 'a');
+  MockWrite writes[] = {
+    MockWrite(SYNCHRONOUS, record.data(), record.size(), 0),
+    MockWrite(SYNCHRONOUS, 1, "bc"),
+  };
+  Initialize(writes, arraysize(writes));
+  TestWrite(record.substr(1));
+  TestWrite("a");
+  EXPECT_EQ(1, data_->sequence_number());
+  TestWrite("b");
+  TestWrite("c");
+  Finish();
+}
+
+// Writes are coalesced while the wrapped socket is blocked.
+TEST_F(CoalescingWriteStreamSocketTest, WritesWhileBlocked) {
+  MockWrite writes[] = {
+    MockWrite(ASYNC, 0, "abc"),
+    MockWrite(ASYNC, 1, "defghi"),
+  };
+  Initialize(writes, arraysize(writes));
+  TestWrite("abc");
+  base::MessageLoop::current()->RunUntilIdle();
+  TestWrite("def");
+  TestWrite("ghi");
+  data_->RunFor(1);
+  base::MessageLoop::current()->RunUntilIdle();
+  data_->RunFor(1);
+  Finish();
+}
+
+TEST_F(CoalescingWriteStreamSocketTest, ContinuesPartialWrite) {
+  MockWrite writes[] = {
+    MockWrite(ASYNC, 0, "abc"),
+    MockWrite(ASYNC, 1, "def"),
+  };
+  Initialize(writes, arraysize(writes));
+  TestWrite("abcdef");
+  data_->Run();
+  Finish();
+}
+
+// Write() waits for the wrapped socket once the buffer is full.
+TEST_F(CoalescingWriteStreamSocketTest, FullBufferBlocksWrites) {
+  const std::string data(CoalescingWriteStreamSocket::kMaxBufferedBytes, 'a');
+  MockWrite writes[] = {
+    MockWrite(ASYNC, data.data(), data.size(), 0),
+    MockWrite(ASYNC, 1, "b"),
+  };
+  Initialize(writes, arraysize(writes));
+  TestWrite(data);
+
+  scoped_refptr<StringIOBuffer> buf(new StringIOBuffer("b"));
+  EXPECT_EQ(ERR_IO_PENDING,
+            socket_->Write(buf.get(), buf->size(), callback_.callback()));
+  data_->RunFor(1);
+  EXPECT_EQ(1, callback_.WaitForResult());
+  base::MessageLoop::current()->RunUntilIdle();
+  data_->RunFor(1);
+  Finish();
+}
+
+TEST_F(CoalescingWriteStreamSocketTest, ErrorIsReturnedByNextWrite) {
+  MockWrite writes[] = {
+    MockWrite(SYNCHRONOUS, ERR_CONNECTION_RESET, 0),
+  };
+  Initialize(writes, arraysize(writes));
+  TestWrite("abc");
+  base::MessageLoop::current()->RunUntilIdle();
+
+  scoped_refptr<StringIOBuffer> buf(new StringIOBuffer("def"));
+  EXPECT_EQ(ERR_CONNECTION_RESET,
+            socket_->Write(buf.get(), buf->size(), callback_.callback()));
+}
+
+}  // anonymous namespace
+
+}  // namespace net
@@ -5,6 +5,8 @@
 #ifndef NET_SOCKET_STREAM_SOCKET_H_
 #define NET_SOCKET_STREAM_SOCKET_H_
 
+#include "base/platform_file.h"
+#include "net/base/completion_callback.h"
 #include "net/base/net_log.h"
 #include "net/socket/next_proto.h"
 #include "net/socket/socket.h"
@@ -90,6 +92,21 @@ class NET_EXPORT_PRIVATE StreamSocket : public Socket {
   // SSL was not used by this socket.
   virtual bool GetSSLInfo(SSLInfo* ssl_info) = 0;
 
+  // Writes up to |length| bytes of |file|, from its current position on, to
+  // the socket without copying them through user space, and advances the
+  // file position past the bytes written. Reading the file may block, so the
+  // caller should make sure the bytes are in the page cache first.
+  //
+  // Returns the number of bytes written, or ERR_IO_PENDING, in which case
+  // |callback| runs with the result once the socket is writable again. Like
+  // Write(), it may not be called while another write is pending. Returns
+  // ERR_NOT_IMPLEMENTED if the socket can't write files directly, e.g.
+  // because it encrypts what it sends; Write() must be used then. This is
+  // what the default implementation does.
+  virtual int SendFile(base::PlatformFile file,
+                       int length,
+                       const CompletionCallback& callback);
+
  protected:
   // The following class is only used to gather statistics about the history of
   // a socket.  It is only instantiated and used in basic sockets, such as
@@ -9,6 +9,9 @@
 #include <netdb.h>
 #include <sys/socket.h>
 #include <netinet/tcp.h>
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+#include <sys/sendfile.h>
+#endif
 #if defined(OS_POSIX)
 #include <netinet/in.h>
 #endif
@@ -138,6 +141,7 @@ TCPClientSocketLibevent::TCPClientSocketLibevent(
       current_address_index_(-1),
       read_watcher_(this),
       write_watcher_(this),
+      write_file_(base::kInvalidPlatformFileValue),
       next_connect_state_(CONNECT_STATE_NONE),
       connect_os_error_(0),
       net_log_(BoundNetLog::Make(net_log, NetLog::SOURCE_SOCKET)),
@@ -515,6 +519,64 @@ int TCPClientSocketLibevent::Write(IOBuffer* buf,
   return ERR_IO_PENDING;
 }
 
+int TCPClientSocketLibevent::SendFile(base::PlatformFile file,
+                                      int length,
+                                      const CompletionCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  DCHECK_NE(kInvalidSocket, socket_);
+  DCHECK(!waiting_connect());
+  DCHECK(write_callback_.is_null());
+  DCHECK(!callback.is_null());
+  DCHECK_GT(length, 0);
+
+  // TCP FastOpen sends the first bytes along with the SYN using sendto().
+  if (use_tcp_fastopen_ && !tcp_fastopen_connected_)
+    return ERR_NOT_IMPLEMENTED;
+
+  int nwrite = InternalSendFile(file, length);
+  if (nwrite >= 0) {
+    base::StatsCounter write_bytes("tcp.write_bytes");
+    write_bytes.Add(nwrite);
+    if (nwrite > 0)
+      use_history_.set_was_used_to_convey_data();
+    net_log_.AddEvent(NetLog::TYPE_SOCKET_BYTES_SENT,
+                      NetLog::IntegerCallback("byte_count", nwrite));
+    return nwrite;
+  }
+  // The file doesn't support sendfile(), e.g. because it's on a FUSE or
+  // network file system, or the kernel doesn't.
+  if (errno == EINVAL || errno == ENOSYS)
+    return ERR_NOT_IMPLEMENTED;
+  if (errno != EAGAIN && errno != EWOULDBLOCK) {
+    int net_error = MapSystemError(errno);
+    net_log_.AddEvent(NetLog::TYPE_SOCKET_WRITE_ERROR,
+                      CreateNetLogSocketErrorCallback(net_error, errno));
+    return net_error;
+  }
+
+  if (!base::MessageLoopForIO::current()->WatchFileDescriptor(
+          socket_, true, base::MessageLoopForIO::WATCH_WRITE,
+          &write_socket_watcher_, &write_watcher_)) {
+    DVLOG(1) << "WatchFileDescriptor failed on write, errno " << errno;
+    return MapSystemError(errno);
+  }
+
+  write_file_ = file;
+  write_buf_len_ = length;
+  write_callback_ = callback;
+  return ERR_IO_PENDING;
+}
+
+int TCPClientSocketLibevent::InternalSendFile(base::PlatformFile file,
+                                              int length) {
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  return HANDLE_EINTR(sendfile(socket_, file, NULL, length));
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
 int TCPClientSocketLibevent::InternalWrite(IOBuffer* buf, int buf_len) {
   int nwrite;
   if (use_tcp_fastopen_ && !tcp_fastopen_connected_) {
@@ -704,9 +766,14 @@ void TCPClientSocketLibevent::DidCompleteRead() {
 }
 
 void TCPClientSocketLibevent::DidCompleteWrite() {
+  const bool sending_file = write_file_ != base::kInvalidPlatformFileValue;
   int bytes_transferred;
-  bytes_transferred = HANDLE_EINTR(write(socket_, write_buf_->data(),
-                                         write_buf_len_));
+  if (sending_file) {
+    bytes_transferred = InternalSendFile(write_file_, write_buf_len_);
+  } else {
+    bytes_transferred = HANDLE_EINTR(write(socket_, write_buf_->data(),
+                                           write_buf_len_));
+  }
 
   int result;
   if (bytes_transferred >= 0) {
@@ -715,8 +782,13 @@ void TCPClientSocketLibevent::DidCompleteWrite() {
     write_bytes.Add(bytes_transferred);
     if (bytes_transferred > 0)
       use_history_.set_was_used_to_convey_data();
-    net_log_.AddByteTransferEvent(NetLog::TYPE_SOCKET_BYTES_SENT, result,
-                                  write_buf_->data());
+    if (sending_file) {
+      net_log_.AddEvent(NetLog::TYPE_SOCKET_BYTES_SENT,
+                        NetLog::IntegerCallback("byte_count", result));
+    } else {
+      net_log_.AddByteTransferEvent(NetLog::TYPE_SOCKET_BYTES_SENT, result,
+                                    write_buf_->data());
+    }
   } else {
     result = MapSystemError(errno);
     if (result != ERR_IO_PENDING) {
@@ -728,6 +800,7 @@ void TCPClientSocketLibevent::DidCompleteWrite() {
   if (result != ERR_IO_PENDING) {
     write_buf_ = NULL;
     write_buf_len_ = 0;
+    write_file_ = base::kInvalidPlatformFileValue;
     write_socket_watcher_.StopWatchingFileDescriptor();
     DoWriteCallback(result);
   }
@@ -56,6 +56,9 @@ class NET_EXPORT_PRIVATE TCPClientSocketLibevent : public StreamSocket,
   virtual bool WasNpnNegotiated() const OVERRIDE;
   virtual NextProto GetNegotiatedProtocol() const OVERRIDE;
   virtual bool GetSSLInfo(SSLInfo* ssl_info) OVERRIDE;
+  virtual int SendFile(base::PlatformFile file,
+                       int length,
+                       const CompletionCallback& callback) OVERRIDE;
 
   // Socket implementation.
   // Multiple outstanding requests are not supported.
@@ -185,6 +188,9 @@ class NET_EXPORT_PRIVATE TCPClientSocketLibevent : public StreamSocket,
   // Internal function to write to a socket.
   int InternalWrite(IOBuffer* buf, int buf_len);
 
+  // Internal function to write a file to a socket.
+  int InternalSendFile(base::PlatformFile file, int length);
+
   // Called when the socket is known to be in a connected state.
   void RecordFastOpenStatus();
 
@@ -219,6 +225,10 @@ class NET_EXPORT_PRIVATE TCPClientSocketLibevent : public StreamSocket,
   scoped_refptr<IOBuffer> write_buf_;
   int write_buf_len_;
 
+  // The file used by OnSocketReady to retry SendFile requests, in which case
+  // |write_buf_len_| is the length to send and |write_buf_| is NULL.
+  base::PlatformFile write_file_;
+
   // External callback; called when read is complete.
   CompletionCallback read_callback_;
 
@@ -8,6 +8,12 @@
 
 #include "net/socket/tcp_client_socket.h"
 
+#include <string>
+
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/platform_file.h"
+#include "net/base/io_buffer.h"
 #include "net/base/ip_endpoint.h"
 #include "net/base/net_errors.h"
 #include "net/base/net_util.h"
@@ -108,6 +114,77 @@ TEST(TCPClientSocketTest, BindLoopbackToIPv6) {
   EXPECT_NE(OK, result);
 }
 
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+// Send a file, larger than the socket buffers, straight from the disk.
+TEST(TCPClientSocketTest, SendFile) {
+  const int kFileSize = 1024 * 1024;
+  std::string data(kFileSize, '\0');
+  for (int i = 0; i < kFileSize; ++i)
+    data[i] = static_cast<char>(i % 251);
+
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = temp_dir.path().AppendASCII("data");
+  ASSERT_EQ(kFileSize, file_util::WriteFile(path, data.data(), kFileSize));
+  base::PlatformFile file = base::CreatePlatformFile(
+      path, base::PLATFORM_FILE_OPEN | base::PLATFORM_FILE_READ, NULL, NULL);
+  ASSERT_NE(base::kInvalidPlatformFileValue, file);
+
+  IPAddressNumber lo_address;
+  ASSERT_TRUE(ParseIPLiteralToNumber("127.0.0.1", &lo_address));
+  TCPServerSocket server(NULL, NetLog::Source());
+  ASSERT_EQ(OK, server.Listen(IPEndPoint(lo_address, 0), 1));
+  IPEndPoint server_address;
+  ASSERT_EQ(OK, server.GetLocalAddress(&server_address));
+
+  TCPClientSocket socket(AddressList(server_address), NULL, NetLog::Source());
+  TestCompletionCallback connect_callback;
+  int connect_result = socket.Connect(connect_callback.callback());
+  TestCompletionCallback accept_callback;
+  scoped_ptr<StreamSocket> accepted_socket;
+  ASSERT_EQ(OK, accept_callback.GetResult(
+      server.Accept(&accepted_socket, accept_callback.callback())));
+  ASSERT_EQ(OK, connect_callback.GetResult(connect_result));
+
+  // Interleave sending and receiving, so that a pending send completes.
+  int sent = 0;
+  bool send_pending = false;
+  TestCompletionCallback send_callback;
+  std::string received;
+  scoped_refptr<IOBuffer> read_buf(new IOBuffer(4096));
+  while (static_cast<int>(received.size()) < kFileSize) {
+    if (send_pending && send_callback.have_result()) {
+      int result = send_callback.WaitForResult();
+      ASSERT_LT(0, result);
+      sent += result;
+      send_pending = false;
+    }
+    if (!send_pending && sent < kFileSize) {
+      int result =
+          socket.SendFile(file, kFileSize - sent, send_callback.callback());
+      if (result == ERR_IO_PENDING) {
+        send_pending = true;
+      } else {
+        ASSERT_LT(0, result);
+        sent += result;
+      }
+    }
+    TestCompletionCallback read_callback;
+    int result = read_callback.GetResult(
+        accepted_socket->Read(read_buf.get(), 4096, read_callback.callback()));
+    ASSERT_LT(0, result);
+    received.append(read_buf->data(), result);
+  }
+  EXPECT_EQ(kFileSize, sent);
+  EXPECT_TRUE(data == received);
+
+  // The file position has moved past everything sent.
+  char byte;
+  EXPECT_EQ(0, base::ReadPlatformFileCurPosNoBestEffort(file, &byte, 1));
+  EXPECT_TRUE(base::ClosePlatformFile(file));
+}
+#endif  // defined(OS_LINUX) || defined(OS_ANDROID)
+
 }  // namespace
 
 }  // namespace net
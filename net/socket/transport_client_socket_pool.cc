@@ -16,6 +16,7 @@
 #include "net/base/ip_endpoint.h"
 #include "net/base/net_errors.h"
 #include "net/base/net_log.h"
+#include "net/http/http_server_properties.h"
 #include "net/socket/client_socket_factory.h"
 #include "net/socket/client_socket_handle.h"
 #include "net/socket/client_socket_pool_base.h"
@@ -28,7 +29,8 @@ namespace net {
 
 // TODO(willchan): Base this off RTT instead of statically setting it. Note we
 // choose a timeout that is different from the backup connect job timer so they
-// don't synchronize.
+// don't synchronize. This is also the stagger between the connects to the
+// other addresses, so that a slow network does not get a burst of SYNs.
 const int TransportConnectJob::kIPv6FallbackTimerInMs = 300;
 
 namespace {
@@ -84,6 +86,7 @@ TransportConnectJob::TransportConnectJob(
     base::TimeDelta timeout_duration,
     ClientSocketFactory* client_socket_factory,
     HostResolver* host_resolver,
+    const base::WeakPtr<HttpServerProperties>& http_server_properties,
     Delegate* delegate,
     NetLog* net_log)
     : ConnectJob(group_name, timeout_duration, delegate,
@@ -91,7 +94,11 @@ TransportConnectJob::TransportConnectJob(
       params_(params),
       client_socket_factory_(client_socket_factory),
       resolver_(host_resolver),
-      next_state_(STATE_NONE) {
+      http_server_properties_(http_server_properties),
+      next_state_(STATE_NONE),
+      pending_attempts_(0),
+      last_attempt_error_(ERR_FAILED),
+      winning_attempt_(0) {
 }
 
 TransportConnectJob::~TransportConnectJob() {
@@ -123,6 +130,29 @@ void TransportConnectJob::MakeAddressListStartWithIPv4(AddressList* list) {
   }
 }
 
+// static
+void TransportConnectJob::InterleaveAddressFamilies(AddressList* list) {
+  if (list->empty())
+    return;
+  AddressFamily first_family = list->front().GetFamily();
+  std::vector<IPEndPoint> first;
+  std::vector<IPEndPoint> others;
+  for (AddressList::const_iterator i = list->begin(); i != list->end(); ++i) {
+    if (i->GetFamily() == first_family)
+      first.push_back(*i);
+    else
+      others.push_back(*i);
+  }
+
+  list->clear();
+  for (size_t i = 0; i < std::max(first.size(), others.size()); ++i) {
+    if (i < first.size())
+      list->push_back(first[i]);
+    if (i < others.size())
+      list->push_back(others[i]);
+  }
+}
+
 void TransportConnectJob::OnIOComplete(int result) {
   int rv = DoLoop(result);
   if (rv != ERR_IO_PENDING)
@@ -190,23 +220,23 @@ int TransportConnectJob::DoResolveHostComplete(int result) {
 
 int TransportConnectJob::DoTransportConnect() {
   next_state_ = STATE_TRANSPORT_CONNECT_COMPLETE;
-  transport_socket_.reset(client_socket_factory_->CreateTransportClientSocket(
-        addresses_, net_log().net_log(), net_log().source()));
-  int rv = transport_socket_->Connect(
-      base::Bind(&TransportConnectJob::OnIOComplete, base::Unretained(this)));
-  if (rv == ERR_IO_PENDING &&
-      addresses_.front().GetFamily() == ADDRESS_FAMILY_IPV6 &&
-      !AddressListOnlyContainsIPv6(addresses_)) {
-    fallback_timer_.Start(FROM_HERE,
-        base::TimeDelta::FromMilliseconds(kIPv6FallbackTimerInMs),
-        this, &TransportConnectJob::DoIPv6FallbackTransportConnect);
+  attempt_addresses_ = addresses_;
+  if (http_server_properties_.get() &&
+      http_server_properties_->IsIPv6Broken(
+          params_->destination().host_port_pair())) {
+    MakeAddressListStartWithIPv4(&attempt_addresses_);
   }
-  return rv;
+  InterleaveAddressFamilies(&attempt_addresses_);
+  return StartNextAttempt();
 }
 
 int TransportConnectJob::DoTransportConnectComplete(int result) {
+  attempt_timer_.Stop();
   if (result == OK) {
-    bool is_ipv4 = addresses_.front().GetFamily() == ADDRESS_FAMILY_IPV4;
+    const IPEndPoint& winner = attempt_addresses_[winning_attempt_];
+    bool is_ipv4 = winner.GetFamily() == ADDRESS_FAMILY_IPV4;
+    bool raced_ipv6 =
+        attempt_addresses_.front().GetFamily() == ADDRESS_FAMILY_IPV6;
     DCHECK(!connect_timing_.connect_start.is_null());
     DCHECK(!connect_timing_.dns_start.is_null());
     base::TimeTicks now = base::TimeTicks::Now();
@@ -219,13 +249,21 @@ int TransportConnectJob::DoTransportConnectComplete(int result) {
         100);
 
     base::TimeDelta connect_duration = now - connect_timing_.connect_start;
+    if (is_ipv4 && raced_ipv6)
+      connect_duration = now - attempts_[winning_attempt_]->start_time;
     UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency",
         connect_duration,
         base::TimeDelta::FromMilliseconds(1),
         base::TimeDelta::FromMinutes(10),
         100);
 
-    if (is_ipv4) {
+    if (is_ipv4 && raced_ipv6) {
+      UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv4_Wins_Race",
+                                 connect_duration,
+                                 base::TimeDelta::FromMilliseconds(1),
+                                 base::TimeDelta::FromMinutes(10),
+                                 100);
+    } else if (is_ipv4) {
       UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv4_No_Race",
                                  connect_duration,
                                  base::TimeDelta::FromMilliseconds(1),
@@ -246,88 +284,91 @@ int TransportConnectJob::DoTransportConnectComplete(int result) {
                                    100);
       }
     }
-    set_socket(transport_socket_.release());
-    fallback_timer_.Stop();
-  } else {
-    // Be a bit paranoid and kill off the fallback members to prevent reuse.
-    fallback_transport_socket_.reset();
-    fallback_addresses_.reset();
+    RecordIPv6Result(winner);
+    set_socket(attempts_[winning_attempt_]->socket.release());
   }
 
+  // Cancels the connects that lost the race.
+  attempts_.clear();
+  pending_attempts_ = 0;
   return result;
 }
 
-void TransportConnectJob::DoIPv6FallbackTransportConnect() {
-  // The timer should only fire while we're waiting for the main connect to
-  // succeed.
-  if (next_state_ != STATE_TRANSPORT_CONNECT_COMPLETE) {
-    NOTREACHED();
-    return;
+int TransportConnectJob::StartNextAttempt() {
+  attempt_timer_.Stop();
+  while (attempts_.size() < attempt_addresses_.size()) {
+    size_t index = attempts_.size();
+    Attempt* attempt = new Attempt;
+    attempts_.push_back(attempt);
+    attempt->start_time = base::TimeTicks::Now();
+    attempt->socket.reset(client_socket_factory_->CreateTransportClientSocket(
+        AddressList(attempt_addresses_[index]),
+        net_log().net_log(), net_log().source()));
+    int rv = attempt->socket->Connect(
+        base::Bind(&TransportConnectJob::OnAttemptComplete,
+                   base::Unretained(this), index));
+    if (rv == OK) {
+      winning_attempt_ = index;
+      return OK;
+    }
+    if (rv == ERR_IO_PENDING) {
+      pending_attempts_++;
+      if (attempts_.size() < attempt_addresses_.size()) {
+        attempt_timer_.Start(FROM_HERE,
+            base::TimeDelta::FromMilliseconds(kIPv6FallbackTimerInMs),
+            this, &TransportConnectJob::OnAttemptTimer);
+      }
+      return ERR_IO_PENDING;
+    }
+    attempt->socket.reset();
+    last_attempt_error_ = rv;
   }
-
-  DCHECK(!fallback_transport_socket_.get());
-  DCHECK(!fallback_addresses_.get());
-
-  fallback_addresses_.reset(new AddressList(addresses_));
-  MakeAddressListStartWithIPv4(fallback_addresses_.get());
-  fallback_transport_socket_.reset(
-      client_socket_factory_->CreateTransportClientSocket(
-          *fallback_addresses_, net_log().net_log(), net_log().source()));
-  fallback_connect_start_time_ = base::TimeTicks::Now();
-  int rv = fallback_transport_socket_->Connect(
-      base::Bind(
-          &TransportConnectJob::DoIPv6FallbackTransportConnectComplete,
-          base::Unretained(this)));
-  if (rv != ERR_IO_PENDING)
-    DoIPv6FallbackTransportConnectComplete(rv);
+  return pending_attempts_ > 0 ? ERR_IO_PENDING : last_attempt_error_;
 }
 
-void TransportConnectJob::DoIPv6FallbackTransportConnectComplete(int result) {
-  // This should only happen when we're waiting for the main connect to succeed.
-  if (next_state_ != STATE_TRANSPORT_CONNECT_COMPLETE) {
-    NOTREACHED();
-    return;
-  }
-
+void TransportConnectJob::OnAttemptComplete(size_t index, int result) {
+  DCHECK_EQ(STATE_TRANSPORT_CONNECT_COMPLETE, next_state_);
   DCHECK_NE(ERR_IO_PENDING, result);
-  DCHECK(fallback_transport_socket_.get());
-  DCHECK(fallback_addresses_.get());
+  DCHECK_GT(pending_attempts_, 0);
+  pending_attempts_--;
 
   if (result == OK) {
-    DCHECK(!fallback_connect_start_time_.is_null());
-    DCHECK(!connect_timing_.dns_start.is_null());
-    base::TimeTicks now = base::TimeTicks::Now();
-    base::TimeDelta total_duration = now - connect_timing_.dns_start;
-    UMA_HISTOGRAM_CUSTOM_TIMES(
-        "Net.DNS_Resolution_And_TCP_Connection_Latency2",
-        total_duration,
-        base::TimeDelta::FromMilliseconds(1),
-        base::TimeDelta::FromMinutes(10),
-        100);
+    winning_attempt_ = index;
+    OnIOComplete(OK);  // Deletes |this|
+    return;
+  }
 
-    base::TimeDelta connect_duration = now - fallback_connect_start_time_;
-    UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency",
-        connect_duration,
-        base::TimeDelta::FromMilliseconds(1),
-        base::TimeDelta::FromMinutes(10),
-        100);
+  // Don't wait for the timer before trying the next address.
+  attempts_[index]->socket.reset();
+  last_attempt_error_ = result;
+  int rv = StartNextAttempt();
+  if (rv != ERR_IO_PENDING)
+    OnIOComplete(rv);  // Deletes |this|
+}
 
-    UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv4_Wins_Race",
-        connect_duration,
-        base::TimeDelta::FromMilliseconds(1),
-        base::TimeDelta::FromMinutes(10),
-        100);
-    set_socket(fallback_transport_socket_.release());
-    next_state_ = STATE_NONE;
-    transport_socket_.reset();
-  } else {
-    // Be a bit paranoid and kill off the fallback members to prevent reuse.
-    fallback_transport_socket_.reset();
-    fallback_addresses_.reset();
+void TransportConnectJob::OnAttemptTimer() {
+  DCHECK_EQ(STATE_TRANSPORT_CONNECT_COMPLETE, next_state_);
+  int rv = StartNextAttempt();
+  if (rv != ERR_IO_PENDING)
+    OnIOComplete(rv);  // Deletes |this|
+}
+
+void TransportConnectJob::RecordIPv6Result(const IPEndPoint& winner) {
+  if (!http_server_properties_.get())
+    return;
+  const HostPortPair& server = params_->destination().host_port_pair();
+  if (winner.GetFamily() == ADDRESS_FAMILY_IPV6) {
+    http_server_properties_->SetIPv6Broken(server, false);
+  } else if (attempt_addresses_.front().GetFamily() == ADDRESS_FAMILY_IPV6) {
+    // IPv6 had the head start and still lost.
+    http_server_properties_->SetIPv6Broken(server, true);
   }
-  NotifyDelegateOfCompletion(result);  // Deletes |this|
 }
 
+TransportConnectJob::Attempt::Attempt() {}
+
+TransportConnectJob::Attempt::~Attempt() {}
+
 int TransportConnectJob::ConnectInternal() {
   next_state_ = STATE_RESOLVE_HOST;
   return DoLoop(OK);
@@ -343,6 +384,7 @@ ConnectJob*
                                  ConnectionTimeout(),
                                  client_socket_factory_,
                                  host_resolver_,
+                                 http_server_properties_,
                                  delegate,
                                  net_log_);
 }
@@ -360,16 +402,22 @@ TransportClientSocketPool::TransportClientSocketPool(
     HostResolver* host_resolver,
     ClientSocketFactory* client_socket_factory,
     NetLog* net_log)
-    : base_(max_sockets, max_sockets_per_group, histograms,
+    : connect_job_factory_(new TransportConnectJobFactory(
+          client_socket_factory, host_resolver, net_log)),
+      base_(max_sockets, max_sockets_per_group, histograms,
             ClientSocketPool::unused_idle_socket_timeout(),
             ClientSocketPool::used_idle_socket_timeout(),
-            new TransportConnectJobFactory(client_socket_factory,
-                                     host_resolver, net_log)) {
+            connect_job_factory_) {
   base_.EnableConnectBackupJobs();
 }
 
 TransportClientSocketPool::~TransportClientSocketPool() {}
 
+void TransportClientSocketPool::set_http_server_properties(
+    const base::WeakPtr<HttpServerProperties>& http_server_properties) {
+  connect_job_factory_->set_http_server_properties(http_server_properties);
+}
+
 int TransportClientSocketPool::RequestSocket(
     const std::string& group_name,
     const void* params,
@@ -10,6 +10,8 @@
 #include "base/basictypes.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/memory/weak_ptr.h"
 #include "base/time/time.h"
 #include "base/timer/timer.h"
 #include "net/base/host_port_pair.h"
@@ -22,6 +24,7 @@
 namespace net {
 
 class ClientSocketFactory;
+class HttpServerProperties;
 
 typedef base::Callback<int(const AddressList&, const BoundNetLog& net_log)>
 OnHostResolutionCallback;
@@ -59,22 +62,28 @@ class NET_EXPORT_PRIVATE TransportSocketParams
 };
 
 // TransportConnectJob handles the host resolution necessary for socket creation
-// and the transport (likely TCP) connect. TransportConnectJob also has fallback
-// logic for IPv6 connect() timeouts (which may happen due to networks / routers
-// with broken IPv6 support). Those timeouts take 20s, so rather than make the
-// user wait 20s for the timeout to fire, we use a fallback timer
-// (kIPv6FallbackTimerInMs) and start a connect() to a IPv4 address if the timer
-// fires. Then we race the IPv4 connect() against the IPv6 connect() (which has
-// a headstart) and return the one that completes first to the socket pool.
+// and the transport (likely TCP) connect. Rather than trying the resolved
+// addresses one after another, which makes the user wait out the 20s connect()
+// timeout of networks / routers with broken IPv6 support, TransportConnectJob
+// races them ("happy eyeballs"). The addresses are ordered so that the two
+// families alternate, and a connect() to the next address starts whenever the
+// previous one fails or has been pending for kIPv6FallbackTimerInMs. The first
+// connect() to succeed is returned to the socket pool.
+//
+// If IPv4 wins while an IPv6 address was tried first, the server is recorded
+// as having broken IPv6 in |http_server_properties|, and later jobs for it
+// start with IPv4.
 class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
  public:
-  TransportConnectJob(const std::string& group_name,
-                      const scoped_refptr<TransportSocketParams>& params,
-                      base::TimeDelta timeout_duration,
-                      ClientSocketFactory* client_socket_factory,
-                      HostResolver* host_resolver,
-                      Delegate* delegate,
-                      NetLog* net_log);
+  TransportConnectJob(
+      const std::string& group_name,
+      const scoped_refptr<TransportSocketParams>& params,
+      base::TimeDelta timeout_duration,
+      ClientSocketFactory* client_socket_factory,
+      HostResolver* host_resolver,
+      const base::WeakPtr<HttpServerProperties>& http_server_properties,
+      Delegate* delegate,
+      NetLog* net_log);
   virtual ~TransportConnectJob();
 
   // ConnectJob methods.
@@ -84,6 +93,11 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   // WARNING: this method should only be used to implement the prefer-IPv4 hack.
   static void MakeAddressListStartWithIPv4(AddressList* addrlist);
 
+  // Reorders |addrlist| so that the address families alternate, starting with
+  // the family of the first address. The order within a family is kept.
+  static void InterleaveAddressFamilies(AddressList* addrlist);
+
+  // How long a connect() may be pending before the next address is tried.
   static const int kIPv6FallbackTimerInMs;
 
  private:
@@ -106,26 +120,49 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   int DoTransportConnectComplete(int result);
 
   // Not part of the state machine.
-  void DoIPv6FallbackTransportConnect();
-  void DoIPv6FallbackTransportConnectComplete(int result);
+
+  // Starts connecting to the next untried addresses, until a connect() is
+  // pending or the addresses run out. Returns OK once an attempt succeeded,
+  // ERR_IO_PENDING while attempts are pending, and otherwise the error of the
+  // last one.
+  int StartNextAttempt();
+  void OnAttemptComplete(size_t index, int result);
+  void OnAttemptTimer();
+
+  // Records in |http_server_properties_| whether IPv6 lost the race.
+  void RecordIPv6Result(const IPEndPoint& winner);
 
   // Begins the host resolution and the TCP connect.  Returns OK on success
   // and ERR_IO_PENDING if it cannot immediately service the request.
   // Otherwise, it returns a net error code.
   virtual int ConnectInternal() OVERRIDE;
 
+  // A connect() to one of the addresses.
+  struct Attempt {
+    Attempt();
+    ~Attempt();
+
+    // NULL once the attempt has failed.
+    scoped_ptr<StreamSocket> socket;
+    base::TimeTicks start_time;
+  };
+
   scoped_refptr<TransportSocketParams> params_;
   ClientSocketFactory* const client_socket_factory_;
   SingleRequestHostResolver resolver_;
+  const base::WeakPtr<HttpServerProperties> http_server_properties_;
   AddressList addresses_;
   State next_state_;
 
-  scoped_ptr<StreamSocket> transport_socket_;
-
-  scoped_ptr<StreamSocket> fallback_transport_socket_;
-  scoped_ptr<AddressList> fallback_addresses_;
-  base::TimeTicks fallback_connect_start_time_;
-  base::OneShotTimer<TransportConnectJob> fallback_timer_;
+  // The order in which the addresses are tried, and the attempts started so
+  // far, which match its first entries.
+  AddressList attempt_addresses_;
+  ScopedVector<Attempt> attempts_;
+  int pending_attempts_;
+  int last_attempt_error_;
+  // The index of the attempt which succeeded.
+  size_t winning_attempt_;
+  base::OneShotTimer<TransportConnectJob> attempt_timer_;
 
   DISALLOW_COPY_AND_ASSIGN(TransportConnectJob);
 };
@@ -142,6 +179,11 @@ class NET_EXPORT_PRIVATE TransportClientSocketPool : public ClientSocketPool {
 
   virtual ~TransportClientSocketPool();
 
+  // Where the connect jobs remember servers with broken IPv6. Without one,
+  // every job starts with the first resolved address.
+  void set_http_server_properties(
+      const base::WeakPtr<HttpServerProperties>& http_server_properties);
+
   // ClientSocketPool implementation.
   virtual int RequestSocket(const std::string& group_name,
                             const void* resolve_info,
@@ -200,14 +242,22 @@ class NET_EXPORT_PRIVATE TransportClientSocketPool : public ClientSocketPool {
 
     virtual base::TimeDelta ConnectionTimeout() const OVERRIDE;
 
+    void set_http_server_properties(
+        const base::WeakPtr<HttpServerProperties>& http_server_properties) {
+      http_server_properties_ = http_server_properties;
+    }
+
    private:
     ClientSocketFactory* const client_socket_factory_;
     HostResolver* const host_resolver_;
+    base::WeakPtr<HttpServerProperties> http_server_properties_;
     NetLog* net_log_;
 
     DISALLOW_COPY_AND_ASSIGN(TransportConnectJobFactory);
   };
 
+  // Owned by |base_|.
+  TransportConnectJobFactory* const connect_job_factory_;
   PoolBase base_;
 
   DISALLOW_COPY_AND_ASSIGN(TransportClientSocketPool);
@@ -19,6 +19,7 @@
 #include "net/base/net_util.h"
 #include "net/base/test_completion_callback.h"
 #include "net/dns/mock_host_resolver.h"
+#include "net/http/http_server_properties_impl.h"
 #include "net/socket/client_socket_factory.h"
 #include "net/socket/client_socket_handle.h"
 #include "net/socket/client_socket_pool_histograms.h"
@@ -558,6 +559,57 @@ TEST(TransportConnectJobTest, MakeAddrListStartWithIPv4) {
   EXPECT_EQ(ADDRESS_FAMILY_IPV6, addrlist[3].GetFamily());
 }
 
+TEST(TransportConnectJobTest, InterleaveAddressFamilies) {
+  IPAddressNumber ip_number;
+  ASSERT_TRUE(ParseIPLiteralToNumber("192.168.1.1", &ip_number));
+  IPEndPoint addrlist_v4_1(ip_number, 80);
+  ASSERT_TRUE(ParseIPLiteralToNumber("192.168.1.2", &ip_number));
+  IPEndPoint addrlist_v4_2(ip_number, 80);
+  ASSERT_TRUE(ParseIPLiteralToNumber("2001:4860:b006::64", &ip_number));
+  IPEndPoint addrlist_v6_1(ip_number, 80);
+  ASSERT_TRUE(ParseIPLiteralToNumber("2001:4860:b006::66", &ip_number));
+  IPEndPoint addrlist_v6_2(ip_number, 80);
+  ASSERT_TRUE(ParseIPLiteralToNumber("2001:4860:b006::68", &ip_number));
+  IPEndPoint addrlist_v6_3(ip_number, 80);
+
+  AddressList addrlist;
+
+  // Test 1: IPv4 only.  Expect no change.
+  addrlist.push_back(addrlist_v4_1);
+  addrlist.push_back(addrlist_v4_2);
+  TransportConnectJob::InterleaveAddressFamilies(&addrlist);
+  ASSERT_EQ(2u, addrlist.size());
+  EXPECT_TRUE(addrlist_v4_1 == addrlist[0]);
+  EXPECT_TRUE(addrlist_v4_2 == addrlist[1]);
+
+  // Test 2: IPv6, IPv6, IPv6, IPv4, IPv4.  Expect the families to alternate,
+  // starting with IPv6, and the leftover IPv6 address last.
+  addrlist.clear();
+  addrlist.push_back(addrlist_v6_1);
+  addrlist.push_back(addrlist_v6_2);
+  addrlist.push_back(addrlist_v6_3);
+  addrlist.push_back(addrlist_v4_1);
+  addrlist.push_back(addrlist_v4_2);
+  TransportConnectJob::InterleaveAddressFamilies(&addrlist);
+  ASSERT_EQ(5u, addrlist.size());
+  EXPECT_TRUE(addrlist_v6_1 == addrlist[0]);
+  EXPECT_TRUE(addrlist_v4_1 == addrlist[1]);
+  EXPECT_TRUE(addrlist_v6_2 == addrlist[2]);
+  EXPECT_TRUE(addrlist_v4_2 == addrlist[3]);
+  EXPECT_TRUE(addrlist_v6_3 == addrlist[4]);
+
+  // Test 3: IPv4, IPv6, IPv6.  Expect IPv4 to stay first.
+  addrlist.clear();
+  addrlist.push_back(addrlist_v4_1);
+  addrlist.push_back(addrlist_v6_1);
+  addrlist.push_back(addrlist_v6_2);
+  TransportConnectJob::InterleaveAddressFamilies(&addrlist);
+  ASSERT_EQ(3u, addrlist.size());
+  EXPECT_TRUE(addrlist_v4_1 == addrlist[0]);
+  EXPECT_TRUE(addrlist_v6_1 == addrlist[1]);
+  EXPECT_TRUE(addrlist_v6_2 == addrlist[2]);
+}
+
 TEST_F(TransportClientSocketPoolTest, Basic) {
   TestCompletionCallback callback;
   ClientSocketHandle handle;
@@ -1342,6 +1394,128 @@ TEST_F(TransportClientSocketPoolTest, IPv4HasNoFallback) {
   EXPECT_EQ(1, client_socket_factory_.allocation_count());
 }
 
+// Test that a failed connect moves on to the next address without waiting for
+// the fallback timer, and that all addresses get raced.
+TEST_F(TransportClientSocketPoolTest, IPv6FallbackRacesAllAddresses) {
+  // Create a pool without backup jobs.
+  ClientSocketPoolBaseHelper::set_connect_backup_jobs_enabled(false);
+  TransportClientSocketPool pool(kMaxSockets,
+                                 kMaxSocketsPerGroup,
+                                 histograms_.get(),
+                                 host_resolver_.get(),
+                                 &client_socket_factory_,
+                                 NULL);
+
+  MockClientSocketFactory::ClientSocketType case_types[] = {
+    // This is the first IPv6 socket, which fails right away.
+    MockClientSocketFactory::MOCK_FAILING_CLIENT_SOCKET,
+    // This is the IPv4 socket.
+    MockClientSocketFactory::MOCK_STALLED_CLIENT_SOCKET,
+    // This is the second IPv6 socket, started by the fallback timer.
+    MockClientSocketFactory::MOCK_PENDING_CLIENT_SOCKET
+  };
+
+  client_socket_factory_.set_client_socket_types(case_types, 3);
+
+  // Resolve an AddressList with two IPv6 addresses ahead of an IPv4 address.
+  host_resolver_->rules()->AddIPLiteralRule(
+      "*", "2:abcd::3:4:ff,3:abcd::3:4:ff,2.2.2.2", std::string());
+
+  TestCompletionCallback callback;
+  ClientSocketHandle handle;
+  int rv = handle.Init("a", low_params_, LOW, callback.callback(), &pool,
+                       BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_FALSE(handle.is_initialized());
+  EXPECT_FALSE(handle.socket());
+
+  EXPECT_EQ(OK, callback.WaitForResult());
+  EXPECT_TRUE(handle.is_initialized());
+  EXPECT_TRUE(handle.socket());
+  IPEndPoint endpoint;
+  handle.socket()->GetLocalAddress(&endpoint);
+  EXPECT_EQ(kIPv6AddressSize, endpoint.address().size());
+  EXPECT_EQ(3, client_socket_factory_.allocation_count());
+}
+
+// Test that the pool fails only once every address has failed.
+TEST_F(TransportClientSocketPoolTest, IPv6FallbackAllAddressesFail) {
+  // Create a pool without backup jobs.
+  ClientSocketPoolBaseHelper::set_connect_backup_jobs_enabled(false);
+  TransportClientSocketPool pool(kMaxSockets,
+                                 kMaxSocketsPerGroup,
+                                 histograms_.get(),
+                                 host_resolver_.get(),
+                                 &client_socket_factory_,
+                                 NULL);
+
+  client_socket_factory_.set_client_socket_type(
+      MockClientSocketFactory::MOCK_PENDING_FAILING_CLIENT_SOCKET);
+
+  host_resolver_->rules()->AddIPLiteralRule(
+      "*", "2:abcd::3:4:ff,2.2.2.2,3:abcd::3:4:ff", std::string());
+
+  TestCompletionCallback callback;
+  ClientSocketHandle handle;
+  int rv = handle.Init("a", low_params_, LOW, callback.callback(), &pool,
+                       BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(ERR_CONNECTION_FAILED, callback.WaitForResult());
+  EXPECT_FALSE(handle.is_initialized());
+  EXPECT_EQ(3, client_socket_factory_.allocation_count());
+}
+
+// Test that a server whose IPv6 connect lost the race is remembered, and that
+// the next connect to it starts with IPv4.
+TEST_F(TransportClientSocketPoolTest, IPv6FallbackRemembersBrokenIPv6) {
+  // Create a pool without backup jobs.
+  ClientSocketPoolBaseHelper::set_connect_backup_jobs_enabled(false);
+  TransportClientSocketPool pool(kMaxSockets,
+                                 kMaxSocketsPerGroup,
+                                 histograms_.get(),
+                                 host_resolver_.get(),
+                                 &client_socket_factory_,
+                                 NULL);
+  HttpServerPropertiesImpl http_server_properties;
+  pool.set_http_server_properties(http_server_properties.GetWeakPtr());
+
+  MockClientSocketFactory::ClientSocketType case_types[] = {
+    // This is the IPv6 socket.
+    MockClientSocketFactory::MOCK_STALLED_CLIENT_SOCKET,
+    // This is the IPv4 socket.
+    MockClientSocketFactory::MOCK_PENDING_CLIENT_SOCKET,
+    // The second connect only needs the IPv4 socket.
+    MockClientSocketFactory::MOCK_CLIENT_SOCKET
+  };
+
+  client_socket_factory_.set_client_socket_types(case_types, 3);
+
+  // Resolve an AddressList with a IPv6 address first and then a IPv4 address.
+  host_resolver_->rules()
+      ->AddIPLiteralRule("*", "2:abcd::3:4:ff,2.2.2.2", std::string());
+
+  const HostPortPair server("www.google.com", 80);
+  EXPECT_FALSE(http_server_properties.IsIPv6Broken(server));
+
+  TestCompletionCallback callback;
+  ClientSocketHandle handle;
+  int rv = handle.Init("a", low_params_, LOW, callback.callback(), &pool,
+                       BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(OK, callback.WaitForResult());
+  EXPECT_EQ(2, client_socket_factory_.allocation_count());
+  EXPECT_TRUE(http_server_properties.IsIPv6Broken(server));
+
+  ClientSocketHandle handle2;
+  rv = handle2.Init("b", low_params_, LOW, callback.callback(), &pool,
+                    BoundNetLog());
+  EXPECT_EQ(OK, callback.GetResult(rv));
+  IPEndPoint endpoint;
+  handle2.socket()->GetLocalAddress(&endpoint);
+  EXPECT_EQ(kIPv4AddressSize, endpoint.address().size());
+  EXPECT_EQ(3, client_socket_factory_.allocation_count());
+}
+
 }  // namespace
 
 }  // namespace net
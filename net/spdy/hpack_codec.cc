@@ -0,0 +1,422 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/spdy/hpack_codec.h"
+
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+
+namespace net {
+
+namespace {
+
+struct StaticEntry {
+  const char* name;
+  const char* value;
+};
+
+// Headers that show up in most blocks, with their most common values.
+const StaticEntry kStaticTable[] = {
+  { ":host", "" },
+  { ":method", "GET" },
+  { ":method", "POST" },
+  { ":path", "/" },
+  { ":scheme", "http" },
+  { ":scheme", "https" },
+  { ":status", "200 OK" },
+  { ":status", "200" },
+  { ":status", "204" },
+  { ":status", "206" },
+  { ":status", "304" },
+  { ":status", "404" },
+  { ":status", "500" },
+  { ":version", "HTTP/1.1" },
+  { "accept", "*/*" },
+  { "accept-charset", "" },
+  { "accept-encoding", "gzip,deflate,sdch" },
+  { "accept-language", "" },
+  { "accept-ranges", "bytes" },
+  { "age", "" },
+  { "authorization", "" },
+  { "cache-control", "" },
+  { "content-disposition", "" },
+  { "content-encoding", "gzip" },
+  { "content-language", "" },
+  { "content-length", "" },
+  { "content-location", "" },
+  { "content-range", "" },
+  { "content-type", "" },
+  { "cookie", "" },
+  { "date", "" },
+  { "etag", "" },
+  { "expires", "" },
+  { "host", "" },
+  { "if-modified-since", "" },
+  { "if-none-match", "" },
+  { "last-modified", "" },
+  { "location", "" },
+  { "pragma", "" },
+  { "referer", "" },
+  { "server", "" },
+  { "set-cookie", "" },
+  { "user-agent", "" },
+  { "vary", "" },
+  { "via", "" },
+  { "x-content-type-options", "nosniff" },
+  { "x-frame-options", "" },
+  { "x-xss-protection", "1; mode=block" },
+};
+
+// Maps the static headers, and names, to their first index.
+struct StaticTableIndex {
+  StaticTableIndex() {
+    for (size_t i = arraysize(kStaticTable); i > 0; --i) {
+      const StaticEntry& entry = kStaticTable[i - 1];
+      entries[std::make_pair(std::string(entry.name),
+                             std::string(entry.value))] = i;
+      names[entry.name] = i;
+    }
+  }
+
+  std::map<std::pair<std::string, std::string>, size_t> entries;
+  std::map<std::string, size_t> names;
+};
+
+base::LazyInstance<StaticTableIndex>::Leaky g_static_table_index =
+    LAZY_INSTANCE_INITIALIZER;
+
+// The first bytes of each representation, and the size of their integer
+// prefix.
+const uint8 kIndexedOpcode = 0x80;
+const int kIndexedPrefixBits = 7;
+const uint8 kIncrementalOpcode = 0x40;
+const int kIncrementalPrefixBits = 6;
+const uint8 kSizeUpdateOpcode = 0x20;
+const int kSizeUpdatePrefixBits = 5;
+const uint8 kNotIndexedOpcode = 0x10;
+const int kNotIndexedPrefixBits = 4;
+const int kStringLengthPrefixBits = 7;
+
+// The most bytes that EncodeInteger() writes for a 32 bit value.
+const size_t kMaxIntegerSize = 6;
+
+void EncodeInteger(uint8 opcode,
+                   int prefix_bits,
+                   size_t value,
+                   std::string* output) {
+  const size_t max_prefix = (1 << prefix_bits) - 1;
+  if (value < max_prefix) {
+    output->push_back(static_cast<char>(opcode | value));
+    return;
+  }
+  output->push_back(static_cast<char>(opcode | max_prefix));
+  value -= max_prefix;
+  while (value >= 0x80) {
+    output->push_back(static_cast<char>(0x80 | (value & 0x7f)));
+    value >>= 7;
+  }
+  output->push_back(static_cast<char>(value));
+}
+
+void EncodeString(base::StringPiece str, std::string* output) {
+  EncodeInteger(0, kStringLengthPrefixBits, str.size(), output);
+  str.AppendToString(output);
+}
+
+// Reads an integer with a |prefix_bits| prefix from the front of |data|.
+bool DecodeInteger(int prefix_bits, base::StringPiece* data, size_t* value) {
+  if (data->empty())
+    return false;
+  const size_t max_prefix = (1 << prefix_bits) - 1;
+  *value = static_cast<uint8>((*data)[0]) & max_prefix;
+  data->remove_prefix(1);
+  if (*value < max_prefix)
+    return true;
+
+  // Anything that does not fit in 28 bits is bigger than any frame.
+  for (int shift = 0; shift <= 21; shift += 7) {
+    if (data->empty())
+      return false;
+    uint8 byte = static_cast<uint8>((*data)[0]);
+    data->remove_prefix(1);
+    *value += static_cast<size_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+bool DecodeString(base::StringPiece* data, base::StringPiece* str) {
+  if (data->empty() || ((*data)[0] & 0x80))
+    return false;  // No Huffman coding.
+  size_t length;
+  if (!DecodeInteger(kStringLengthPrefixBits, data, &length) ||
+      length > data->size()) {
+    return false;
+  }
+  *str = data->substr(0, length);
+  data->remove_prefix(length);
+  return true;
+}
+
+}  // namespace
+
+const size_t HpackHeaderTable::kEntryOverhead;
+const size_t HpackHeaderTable::kDefaultMaxSize;
+
+HpackHeaderTable::HpackHeaderTable()
+    : total_added_(0),
+      size_(0),
+      max_size_(kDefaultMaxSize) {
+}
+
+HpackHeaderTable::~HpackHeaderTable() {
+}
+
+// static
+size_t HpackHeaderTable::EntrySize(base::StringPiece name,
+                                   base::StringPiece value) {
+  return name.size() + value.size() + kEntryOverhead;
+}
+
+// static
+size_t HpackHeaderTable::StaticEntryCount() {
+  return arraysize(kStaticTable);
+}
+
+bool HpackHeaderTable::GetEntry(size_t index,
+                                base::StringPiece* name,
+                                base::StringPiece* value) const {
+  if (index == 0)
+    return false;
+  if (index <= StaticEntryCount()) {
+    *name = kStaticTable[index - 1].name;
+    *value = kStaticTable[index - 1].value;
+    return true;
+  }
+  size_t position = index - StaticEntryCount() - 1;
+  if (position >= entries_.size())
+    return false;
+  *name = entries_[position].first;
+  *value = entries_[position].second;
+  return true;
+}
+
+size_t HpackHeaderTable::FindEntry(const std::string& name,
+                                   const std::string& value,
+                                   size_t* name_index) const {
+  const StaticTableIndex& static_index = g_static_table_index.Get();
+  *name_index = 0;
+
+  Entry entry(name, value);
+  std::map<Entry, size_t>::const_iterator static_it =
+      static_index.entries.find(entry);
+  if (static_it != static_index.entries.end())
+    return static_it->second;
+  std::map<Entry, uint64>::const_iterator it = entry_ids_.find(entry);
+  if (it != entry_ids_.end())
+    return IndexOfId(it->second);
+
+  std::map<std::string, size_t>::const_iterator static_name_it =
+      static_index.names.find(name);
+  if (static_name_it != static_index.names.end()) {
+    *name_index = static_name_it->second;
+  } else {
+    std::map<std::string, uint64>::const_iterator name_it =
+        name_ids_.find(name);
+    if (name_it != name_ids_.end())
+      *name_index = IndexOfId(name_it->second);
+  }
+  return 0;
+}
+
+void HpackHeaderTable::AddEntry(const std::string& name,
+                                const std::string& value) {
+  size_t entry_size = EntrySize(name, value);
+  if (entry_size > max_size_) {
+    while (!entries_.empty())
+      EvictOldest();
+    return;
+  }
+  while (size_ + entry_size > max_size_)
+    EvictOldest();
+
+  Entry entry(name, value);
+  entries_.push_front(entry);
+  total_added_++;
+  entry_ids_[entry] = total_added_;
+  name_ids_[name] = total_added_;
+  size_ += entry_size;
+}
+
+void HpackHeaderTable::SetMaxSize(size_t max_size) {
+  max_size_ = max_size;
+  while (size_ > max_size_)
+    EvictOldest();
+}
+
+void HpackHeaderTable::EvictOldest() {
+  DCHECK(!entries_.empty());
+  const Entry& entry = entries_.back();
+  uint64 id = total_added_ - entries_.size() + 1;
+
+  // Only the newest copy of a header is in the maps.
+  std::map<Entry, uint64>::iterator it = entry_ids_.find(entry);
+  if (it != entry_ids_.end() && it->second == id)
+    entry_ids_.erase(it);
+  std::map<std::string, uint64>::iterator name_it =
+      name_ids_.find(entry.first);
+  if (name_it != name_ids_.end() && name_it->second == id)
+    name_ids_.erase(name_it);
+
+  size_ -= EntrySize(entry.first, entry.second);
+  entries_.pop_back();
+}
+
+size_t HpackHeaderTable::IndexOfId(uint64 id) const {
+  DCHECK_LE(id, total_added_);
+  DCHECK_LT(total_added_ - id, entries_.size());
+  return StaticEntryCount() + 1 + static_cast<size_t>(total_added_ - id);
+}
+
+// ------------------------------------------------------------------------
+
+HpackEncoder::HpackEncoder() : pending_size_update_(false) {
+}
+
+HpackEncoder::~HpackEncoder() {
+}
+
+void HpackEncoder::EncodeHeaderBlock(const SpdyHeaderBlock& headers,
+                                     std::string* output) {
+  if (pending_size_update_) {
+    EncodeInteger(kSizeUpdateOpcode, kSizeUpdatePrefixBits,
+                  header_table_.max_size(), output);
+    pending_size_update_ = false;
+  }
+
+  for (SpdyHeaderBlock::const_iterator it = headers.begin();
+       it != headers.end(); ++it) {
+    size_t name_index;
+    size_t index = header_table_.FindEntry(it->first, it->second, &name_index);
+    if (index) {
+      EncodeInteger(kIndexedOpcode, kIndexedPrefixBits, index, output);
+      continue;
+    }
+
+    // A header that would flush the whole table is not worth indexing.
+    bool add_to_table = HpackHeaderTable::EntrySize(it->first, it->second) <=
+        header_table_.max_size() / 2;
+    if (add_to_table) {
+      EncodeInteger(kIncrementalOpcode, kIncrementalPrefixBits, name_index,
+                    output);
+    } else {
+      EncodeInteger(kNotIndexedOpcode, kNotIndexedPrefixBits, name_index,
+                    output);
+    }
+    if (!name_index)
+      EncodeString(it->first, output);
+    EncodeString(it->second, output);
+
+    if (add_to_table)
+      header_table_.AddEntry(it->first, it->second);
+  }
+}
+
+void HpackEncoder::SetMaxTableSize(size_t max_size) {
+  header_table_.SetMaxSize(max_size);
+  pending_size_update_ = true;
+}
+
+// static
+size_t HpackEncoder::MaxEncodedSize(const SpdyHeaderBlock& headers) {
+  size_t size = kMaxIntegerSize;
+  for (SpdyHeaderBlock::const_iterator it = headers.begin();
+       it != headers.end(); ++it) {
+    size += 3 * kMaxIntegerSize + it->first.size() + it->second.size();
+  }
+  return size;
+}
+
+// ------------------------------------------------------------------------
+
+HpackDecoder::HpackDecoder()
+    : max_allowed_size_(HpackHeaderTable::kDefaultMaxSize) {
+}
+
+HpackDecoder::~HpackDecoder() {
+}
+
+bool HpackDecoder::DecodeHeaderBlock(base::StringPiece data,
+                                     SpdyHeaderBlock* headers) {
+  while (!data.empty()) {
+    uint8 first_byte = static_cast<uint8>(data[0]);
+    size_t index;
+    base::StringPiece name;
+    base::StringPiece value;
+
+    if (first_byte & kIndexedOpcode) {
+      if (!DecodeInteger(kIndexedPrefixBits, &data, &index) ||
+          !header_table_.GetEntry(index, &name, &value)) {
+        return false;
+      }
+      AppendHeader(name, value, headers);
+      continue;
+    }
+
+    if (!(first_byte & kIncrementalOpcode) &&
+        (first_byte & kSizeUpdateOpcode)) {
+      size_t max_size;
+      if (!DecodeInteger(kSizeUpdatePrefixBits, &data, &max_size) ||
+          max_size > max_allowed_size_) {
+        return false;
+      }
+      header_table_.SetMaxSize(max_size);
+      continue;
+    }
+
+    bool add_to_table = (first_byte & kIncrementalOpcode) != 0;
+    if (!add_to_table && !(first_byte & kNotIndexedOpcode))
+      return false;  // Unknown representation.
+    int prefix_bits =
+        add_to_table ? kIncrementalPrefixBits : kNotIndexedPrefixBits;
+    if (!DecodeInteger(prefix_bits, &data, &index))
+      return false;
+    if (index) {
+      base::StringPiece table_value;
+      if (!header_table_.GetEntry(index, &name, &table_value))
+        return false;
+    } else if (!DecodeString(&data, &name) || name.empty()) {
+      return false;
+    }
+    if (!DecodeString(&data, &value))
+      return false;
+
+    AppendHeader(name, value, headers);
+    // |name| may point into the entry that adding the new one evicts, so it
+    // is added last.
+    if (add_to_table)
+      header_table_.AddEntry(name.as_string(), value.as_string());
+  }
+  return true;
+}
+
+void HpackDecoder::SetMaxTableSize(size_t max_size) {
+  max_allowed_size_ = max_size;
+}
+
+// static
+void HpackDecoder::AppendHeader(base::StringPiece name,
+                                base::StringPiece value,
+                                SpdyHeaderBlock* headers) {
+  // A repeated name is folded into one header, with the values separated by
+  // NUL as in SPDY/3.
+  std::pair<SpdyHeaderBlock::iterator, bool> result =
+      headers->insert(std::make_pair(name.as_string(), std::string()));
+  if (!result.second)
+    result.first->second.push_back('\0');
+  value.AppendToString(&result.first->second);
+}
+
+}  // namespace net
@@ -0,0 +1,160 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_SPDY_HPACK_CODEC_H_
+#define NET_SPDY_HPACK_CODEC_H_
+
+#include <deque>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "base/basictypes.h"
+#include "base/strings/string_piece.h"
+#include "net/base/net_export.h"
+#include "net/spdy/spdy_header_block.h"
+
+// An indexed header compression scheme in the style of the HPACK drafts, as
+// an alternative to the zlib compression of SPDY/2 and SPDY/3. Each endpoint
+// keeps a table of recently sent headers and a header that is already in the
+// table is sent as its index. Unlike zlib, the state is bounded by the table
+// size and an attacker cannot learn secret header values from the size of
+// the compressed output of guessed ones, since only exact matches compress.
+//
+// A header block is a sequence of:
+//   1xxxxxxx                 The header at index x (7 bit prefix).
+//   01xxxxxx [name] value    A literal header added to the table. The name
+//                            is the one at index x (6 bit prefix), or a
+//                            literal string if x is 0.
+//   0001xxxx [name] value    A literal header not added to the table, with a
+//                            4 bit prefix name index.
+//   001xxxxx                 A new maximum table size (5 bit prefix), no
+//                            bigger than the one the decoder allows.
+// Strings are a length with a 7 bit prefix followed by the bytes. Integers
+// use the HPACK prefix encoding. The static table takes the indexes from 1,
+// followed by the dynamic table, newest entry first.
+
+namespace net {
+
+// The dynamic table shared by the encoder and the decoder.
+class NET_EXPORT_PRIVATE HpackHeaderTable {
+ public:
+  // The overhead charged to each entry, on top of its name and value.
+  static const size_t kEntryOverhead = 32;
+
+  static const size_t kDefaultMaxSize = 4096;
+
+  HpackHeaderTable();
+  ~HpackHeaderTable();
+
+  // Returns the size that a header takes in the table.
+  static size_t EntrySize(base::StringPiece name, base::StringPiece value);
+
+  // The number of entries in the static table, which are numbered from 1.
+  static size_t StaticEntryCount();
+
+  // Gets the header at |index|, counting the static entries first. Returns
+  // false if there is no such entry.
+  bool GetEntry(size_t index,
+                base::StringPiece* name,
+                base::StringPiece* value) const;
+
+  // Returns the index of the |name|, |value| header, or 0. Sets |name_index|
+  // to the index of some entry with |name|, or 0.
+  size_t FindEntry(const std::string& name,
+                   const std::string& value,
+                   size_t* name_index) const;
+
+  // Adds a header, evicting the oldest entries to make room for it. A header
+  // bigger than the whole table empties it and is not added.
+  void AddEntry(const std::string& name, const std::string& value);
+
+  // Evicts the oldest entries until size() is not above |max_size|.
+  void SetMaxSize(size_t max_size);
+
+  size_t max_size() const { return max_size_; }
+  size_t size() const { return size_; }
+  size_t dynamic_entry_count() const { return entries_.size(); }
+
+ private:
+  typedef std::pair<std::string, std::string> Entry;
+
+  void EvictOldest();
+
+  // Returns the index of the dynamic entry added as number |id|.
+  size_t IndexOfId(uint64 id) const;
+
+  // Newest entry first.
+  std::deque<Entry> entries_;
+
+  // The number of entries ever added. The newest entry is number
+  // |total_added_|, the oldest one number |total_added_ - entries_.size() + 1|.
+  uint64 total_added_;
+
+  // The id of the newest dynamic entry with a given header, or name, used by
+  // the encoder to avoid scanning the table.
+  std::map<Entry, uint64> entry_ids_;
+  std::map<std::string, uint64> name_ids_;
+
+  size_t size_;
+  size_t max_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(HpackHeaderTable);
+};
+
+class NET_EXPORT_PRIVATE HpackEncoder {
+ public:
+  HpackEncoder();
+  ~HpackEncoder();
+
+  // Appends the encoded |headers| to |output|, and updates the table. The
+  // headers are encoded in the order of the block.
+  void EncodeHeaderBlock(const SpdyHeaderBlock& headers, std::string* output);
+
+  // Shrinks the table used by the encoder, which must not be bigger than the
+  // one of the peer's decoder. The change is signaled in the next block.
+  void SetMaxTableSize(size_t max_size);
+
+  // Returns the largest possible encoding of |headers|.
+  static size_t MaxEncodedSize(const SpdyHeaderBlock& headers);
+
+  const HpackHeaderTable& header_table() const { return header_table_; }
+
+ private:
+  HpackHeaderTable header_table_;
+  bool pending_size_update_;
+
+  DISALLOW_COPY_AND_ASSIGN(HpackEncoder);
+};
+
+class NET_EXPORT_PRIVATE HpackDecoder {
+ public:
+  HpackDecoder();
+  ~HpackDecoder();
+
+  // Decodes a whole header block into |headers|, and updates the table.
+  // Returns false if the block is malformed, after which the table is out of
+  // sync with the encoder and the decoder must not be used again.
+  bool DecodeHeaderBlock(base::StringPiece data, SpdyHeaderBlock* headers);
+
+  // Sets the largest table the encoder is allowed to switch to. The table
+  // only shrinks when the encoder signals it.
+  void SetMaxTableSize(size_t max_size);
+
+  const HpackHeaderTable& header_table() const { return header_table_; }
+
+ private:
+  static void AppendHeader(base::StringPiece name,
+                           base::StringPiece value,
+                           SpdyHeaderBlock* headers);
+
+  HpackHeaderTable header_table_;
+  size_t max_allowed_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(HpackDecoder);
+};
+
+}  // namespace net
+
+#endif  // NET_SPDY_HPACK_CODEC_H_
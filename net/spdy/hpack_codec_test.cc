@@ -0,0 +1,160 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/spdy/hpack_codec.h"
+
+#include <string>
+
+#include "base/strings/string_number_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+// Encodes |headers| with |encoder|, decodes the result with |decoder| and
+// checks that the headers survive. Returns the size of the encoding.
+size_t RoundTrip(HpackEncoder* encoder,
+                 HpackDecoder* decoder,
+                 const SpdyHeaderBlock& headers) {
+  std::string encoded;
+  encoder->EncodeHeaderBlock(headers, &encoded);
+  EXPECT_LE(encoded.size(), HpackEncoder::MaxEncodedSize(headers));
+
+  SpdyHeaderBlock decoded;
+  EXPECT_TRUE(decoder->DecodeHeaderBlock(encoded, &decoded));
+  EXPECT_TRUE(headers == decoded);
+  EXPECT_EQ(encoder->header_table().size(), decoder->header_table().size());
+  return encoded.size();
+}
+
+TEST(HpackCodecTest, StaticEntries) {
+  HpackEncoder encoder;
+  SpdyHeaderBlock headers;
+  headers[":method"] = "GET";
+  headers[":scheme"] = "https";
+  headers[":version"] = "HTTP/1.1";
+
+  std::string encoded;
+  encoder.EncodeHeaderBlock(headers, &encoded);
+  // One byte each, and nothing added to the table.
+  EXPECT_EQ(3u, encoded.size());
+  EXPECT_EQ(0u, encoder.header_table().dynamic_entry_count());
+
+  HpackDecoder decoder;
+  SpdyHeaderBlock decoded;
+  EXPECT_TRUE(decoder.DecodeHeaderBlock(encoded, &decoded));
+  EXPECT_TRUE(headers == decoded);
+}
+
+TEST(HpackCodecTest, RepeatedBlocksAreIndexed) {
+  HpackEncoder encoder;
+  HpackDecoder decoder;
+  SpdyHeaderBlock headers;
+  headers[":host"] = "www.example.com";
+  headers[":path"] = "/index.html";
+  headers["user-agent"] = "Mozilla/5.0 (X11; Linux x86_64)";
+  headers["x-custom"] = "something";
+
+  size_t first_size = RoundTrip(&encoder, &decoder, headers);
+  EXPECT_EQ(4u, encoder.header_table().dynamic_entry_count());
+  EXPECT_EQ(4u, RoundTrip(&encoder, &decoder, headers));
+  EXPECT_LT(4u, first_size);
+
+  // A new value reuses the indexed name.
+  headers[":path"] = "/style.css";
+  EXPECT_EQ(3u + 1 + 1 + 10, RoundTrip(&encoder, &decoder, headers));
+}
+
+TEST(HpackCodecTest, LargeIntegers) {
+  HpackEncoder encoder;
+  HpackDecoder decoder;
+  SpdyHeaderBlock headers;
+  // Lengths and indexes past every prefix.
+  for (int i = 0; i < 200; i++)
+    headers["x-header-" + base::IntToString(i)] = std::string(i, 'v');
+  headers["x-long"] = std::string(100000, 'l');
+
+  RoundTrip(&encoder, &decoder, headers);
+  RoundTrip(&encoder, &decoder, headers);
+}
+
+TEST(HpackCodecTest, TableIsBounded) {
+  HpackEncoder encoder;
+  HpackDecoder decoder;
+  for (int i = 0; i < 1000; i++) {
+    SpdyHeaderBlock headers;
+    headers["x-request-id"] = base::IntToString(i);
+    headers["cookie"] = std::string(i % 500, 'c');
+    RoundTrip(&encoder, &decoder, headers);
+    EXPECT_LE(encoder.header_table().size(),
+              HpackHeaderTable::kDefaultMaxSize);
+  }
+
+  // A header bigger than half the table is never added.
+  SpdyHeaderBlock headers;
+  headers["x-big"] = std::string(HpackHeaderTable::kDefaultMaxSize, 'b');
+  size_t entries = encoder.header_table().dynamic_entry_count();
+  RoundTrip(&encoder, &decoder, headers);
+  EXPECT_EQ(entries, encoder.header_table().dynamic_entry_count());
+}
+
+TEST(HpackCodecTest, ShrinkTable) {
+  HpackEncoder encoder;
+  HpackDecoder decoder;
+  SpdyHeaderBlock headers;
+  for (int i = 0; i < 10; i++)
+    headers["x-header-" + base::IntToString(i)] = std::string(50, 'v');
+  RoundTrip(&encoder, &decoder, headers);
+
+  encoder.SetMaxTableSize(256);
+  RoundTrip(&encoder, &decoder, headers);
+  EXPECT_EQ(256u, decoder.header_table().max_size());
+  EXPECT_LE(decoder.header_table().size(), 256u);
+
+  // The encoder can not grow the table past what the decoder allows.
+  decoder.SetMaxTableSize(512);
+  encoder.SetMaxTableSize(1024);
+  std::string encoded;
+  encoder.EncodeHeaderBlock(headers, &encoded);
+  SpdyHeaderBlock decoded;
+  EXPECT_FALSE(decoder.DecodeHeaderBlock(encoded, &decoded));
+}
+
+TEST(HpackCodecTest, MalformedBlocks) {
+  const char* const kBlocks[] = {
+    "\x80",                  // Index 0.
+    "\xff\x7f",              // Index past the table.
+    "\xff",                  // Truncated integer.
+    "\xff\xff\xff\xff\xff",  // Integer too large.
+    "\x40\x05name",          // Truncated literal.
+    "\x40\x00\x01v",         // Empty name.
+    "\x40\x84name\x01v",     // Huffman coded name.
+    "\x05",                  // Unknown representation.
+  };
+  const size_t kSizes[] = { 1, 2, 1, 5, 6, 4, 8, 1 };
+  COMPILE_ASSERT(arraysize(kBlocks) == arraysize(kSizes), sizes_mismatch);
+
+  for (size_t i = 0; i < arraysize(kBlocks); i++) {
+    HpackDecoder decoder;
+    SpdyHeaderBlock headers;
+    EXPECT_FALSE(decoder.DecodeHeaderBlock(
+        base::StringPiece(kBlocks[i], kSizes[i]), &headers)) << i;
+  }
+}
+
+TEST(HpackCodecTest, RepeatedNamesAreJoined) {
+  HpackDecoder decoder;
+  // A literal "a: 1" and "a: 2", not indexed.
+  const char kBlock[] = "\x10\x01" "a" "\x01" "1" "\x10\x01" "a" "\x01" "2";
+  SpdyHeaderBlock headers;
+  EXPECT_TRUE(decoder.DecodeHeaderBlock(
+      base::StringPiece(kBlock, arraysize(kBlock) - 1), &headers));
+  EXPECT_EQ(1u, headers.size());
+  EXPECT_EQ(std::string("1\0" "2", 3), headers["a"]);
+}
+
+}  // namespace
+
+}  // namespace net
@@ -29,6 +29,19 @@ scoped_ptr<SpdyFrame> MakeSpdyFrame(const char* data, size_t size) {
 
 }  // namespace
 
+struct SpdyBuffer::SharedFrame
+    : public base::RefCountedThreadSafe<SharedFrame> {
+  scoped_ptr<SpdyFrame> data;
+
+  // Set if |data| does not own its bytes but points into this buffer.
+  scoped_refptr<IOBuffer> backing_buffer;
+
+ private:
+  friend class base::RefCountedThreadSafe<SharedFrame>;
+
+  ~SharedFrame() {}
+};
+
 // This class is an IOBuffer implementation that simply holds a
 // reference to a SharedFrame object and a fixed offset. Used by
 // SpdyBuffer::GetIOBufferForRemainingData().
@@ -66,6 +79,20 @@ SpdyBuffer::SpdyBuffer(const char* data, size_t size) :
   shared_frame_->data = MakeSpdyFrame(data, size);
 }
 
+SpdyBuffer::SpdyBuffer(const scoped_refptr<IOBuffer>& buffer,
+                       const char* data,
+                       size_t size)
+    : shared_frame_(new SharedFrame()),
+      offset_(0) {
+  DCHECK(buffer.get());
+  DCHECK(data);
+  DCHECK_GT(size, 0u);
+  DCHECK_GE(data, buffer->data());
+  shared_frame_->data.reset(
+      new SpdyFrame(const_cast<char*>(data), size, false /* owns_buffer */));
+  shared_frame_->backing_buffer = buffer;
+}
+
 SpdyBuffer::~SpdyBuffer() {
   if (GetRemainingSize() > 0)
     ConsumeHelper(GetRemainingSize(), DISCARD);
@@ -53,6 +53,15 @@ class NET_EXPORT_PRIVATE SpdyBuffer {
   // non-NULL and |size| must be non-zero.
   SpdyBuffer(const char* data, size_t size);
 
+  // Construct with the |size| bytes at |data|, which must be inside
+  // |buffer|, without copying them. |buffer| is kept alive until the
+  // SpdyBuffer and any IOBuffer returned by
+  // GetIOBufferForRemainingData() go away, so its data must not be
+  // changed while they are around.
+  SpdyBuffer(const scoped_refptr<IOBuffer>& buffer,
+             const char* data,
+             size_t size);
+
   // If there are bytes remaining in the buffer, triggers a call to
   // any consume callbacks with a DISCARD source.
   ~SpdyBuffer();
@@ -86,9 +95,10 @@ class NET_EXPORT_PRIVATE SpdyBuffer {
  private:
   void ConsumeHelper(size_t consume_size, ConsumeSource consume_source);
 
-  // Ref-count the passed-in SpdyFrame to support the semantics of
+  // Ref-count the passed-in SpdyFrame, and the IOBuffer holding its
+  // data if there is one, to support the semantics of
   // |GetIOBufferForRemainingData()|.
-  typedef base::RefCountedData<scoped_ptr<SpdyFrame> > SharedFrame;
+  struct SharedFrame;
 
   class SharedFrameIOBuffer;
 
@@ -55,6 +55,29 @@ TEST_F(SpdyBufferTest, DataConstructor) {
   EXPECT_EQ(std::string(kData, kDataSize), BufferToString(buffer));
 }
 
+// Construct a SpdyBuffer from a slice of an IOBuffer and make sure it
+// points into the IOBuffer and keeps it alive.
+TEST_F(SpdyBufferTest, IOBufferSliceConstructor) {
+  scoped_refptr<IOBuffer> io_buffer(new IOBuffer(2 * kDataSize));
+  std::memcpy(io_buffer->data() + kDataSize, kData, kDataSize);
+  const char* slice = io_buffer->data() + kDataSize;
+  IOBuffer* raw_io_buffer = io_buffer.get();
+
+  SpdyBuffer buffer(io_buffer, slice, kDataSize);
+  EXPECT_EQ(slice, buffer.GetRemainingData());
+  EXPECT_EQ(kDataSize, buffer.GetRemainingSize());
+
+  // |buffer| holds the only other reference.
+  EXPECT_FALSE(io_buffer->HasOneRef());
+  io_buffer = NULL;
+  EXPECT_EQ(std::string(kData, kDataSize), BufferToString(buffer));
+
+  // An IOBuffer for the remaining data points into it too.
+  buffer.Consume(5);
+  scoped_refptr<IOBuffer> remaining = buffer.GetIOBufferForRemainingData();
+  EXPECT_EQ(raw_io_buffer->data() + kDataSize + 5, remaining->data());
+}
+
 void IncrementBy(size_t* x,
                  SpdyBuffer::ConsumeSource expected_consume_source,
                  size_t delta,
@@ -12,6 +12,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/stats_counters.h"
 #include "base/third_party/valgrind/memcheck.h"
+#include "net/spdy/hpack_codec.h"
 #include "net/spdy/spdy_frame_builder.h"
 #include "net/spdy/spdy_frame_reader.h"
 #include "net/spdy/spdy_bitmasks.h"
@@ -117,6 +118,7 @@ SpdyCredential::~SpdyCredential() {}
 SpdyFramer::SpdyFramer(SpdyMajorVersion version)
     : current_frame_buffer_(new char[kControlFrameBufferSize]),
       enable_compression_(true),
+      enable_indexed_header_compression_(false),
       visitor_(NULL),
       debug_visitor_(NULL),
       display_protocol_("SPDY"),
@@ -149,6 +151,7 @@ void SpdyFramer::Reset() {
   current_frame_length_ = 0;
   current_frame_stream_id_ = kInvalidStream;
   settings_scratch_.Reset();
+  indexed_header_data_.clear();
 }
 
 size_t SpdyFramer::GetDataFrameMinimumSize() const {
@@ -1231,7 +1234,9 @@ size_t SpdyFramer::ProcessControlFrameHeaderBlock(const char* data,
   }
   size_t process_bytes = std::min(data_len, remaining_data_length_);
   if (process_bytes > 0) {
-    if (enable_compression_) {
+    if (enable_compression_ && enable_indexed_header_compression_) {
+      indexed_header_data_.append(data, process_bytes);
+    } else if (enable_compression_) {
       processed_successfully = IncrementallyDecompressControlFrameHeaderData(
           current_frame_stream_id_, data, process_bytes);
     } else {
@@ -1242,6 +1247,12 @@ size_t SpdyFramer::ProcessControlFrameHeaderBlock(const char* data,
     remaining_data_length_ -= process_bytes;
   }
 
+  if (remaining_data_length_ == 0 && enable_compression_ &&
+      enable_indexed_header_compression_) {
+    processed_successfully =
+        DeliverIndexedControlFrameHeaderData(current_frame_stream_id_);
+  }
+
   // Handle the case that there is no futher data in this frame.
   if (remaining_data_length_ == 0 && processed_successfully) {
     // The complete header block has been delivered. We send a zero-length
@@ -2108,6 +2119,8 @@ size_t SpdyFramer::GetSerializedLength(const SpdyHeaderBlock& headers) {
   if (!enable_compression_) {
     return uncompressed_length;
   }
+  if (enable_indexed_header_compression_)
+    return HpackEncoder::MaxEncodedSize(headers);
   z_stream* compressor = GetHeaderCompressor();
   // Since we'll be performing lots of flushes when compressing the data,
   // zlib's lower bounds may be insufficient.
@@ -2174,6 +2187,18 @@ z_stream* SpdyFramer::GetHeaderDecompressor() {
   return header_decompressor_.get();
 }
 
+HpackEncoder* SpdyFramer::GetHeaderEncoder() {
+  if (!header_encoder_.get())
+    header_encoder_.reset(new HpackEncoder);
+  return header_encoder_.get();
+}
+
+HpackDecoder* SpdyFramer::GetHeaderDecoder() {
+  if (!header_decoder_.get())
+    header_decoder_.reset(new HpackDecoder);
+  return header_decoder_.get();
+}
+
 // Incrementally decompress the control frame's header block, feeding the
 // result to the visitor in chunks. Continue this until the visitor
 // indicates that it cannot process any more data, or (more commonly) we
@@ -2265,6 +2290,28 @@ bool SpdyFramer::IncrementallyDeliverControlFrameHeaderData(
   return read_successfully;
 }
 
+bool SpdyFramer::DeliverIndexedControlFrameHeaderData(
+    SpdyStreamId stream_id) {
+  SpdyHeaderBlock headers;
+  bool decoded = GetHeaderDecoder()->DecodeHeaderBlock(indexed_header_data_,
+                                                       &headers);
+  indexed_header_data_.clear();
+  if (!decoded) {
+    DLOG(WARNING) << "Indexed header block decoding failure.";
+    set_error(SPDY_DECOMPRESS_FAILURE);
+    return false;
+  }
+
+  // The visitor expects the same uncompressed block as with zlib.
+  const size_t uncompressed_len =
+      GetSerializedLength(protocol_version(), &headers);
+  SpdyFrameBuilder builder(uncompressed_len);
+  SerializeNameValueBlockWithoutCompression(&builder, headers);
+  scoped_ptr<SpdyFrame> uncompressed(builder.take());
+  return IncrementallyDeliverControlFrameHeaderData(
+      stream_id, uncompressed->data(), uncompressed_len);
+}
+
 void SpdyFramer::SerializeNameValueBlockWithoutCompression(
     SpdyFrameBuilder* builder,
     const SpdyNameValueBlock& name_value_block) const {
@@ -2297,6 +2344,23 @@ void SpdyFramer::SerializeNameValueBlock(
                                                      frame.name_value_block());
   }
 
+  base::StatsCounter compressed_frames("spdy.CompressedFrames");
+  base::StatsCounter pre_compress_bytes("spdy.PreCompressSize");
+  base::StatsCounter post_compress_bytes("spdy.PostCompressSize");
+
+  if (enable_indexed_header_compression_) {
+    std::string encoded;
+    GetHeaderEncoder()->EncodeHeaderBlock(frame.name_value_block(), &encoded);
+    builder->WriteBytes(encoded.data(), encoded.size());
+    builder->RewriteLength(*this);
+
+    pre_compress_bytes.Add(GetSerializedLength(
+        protocol_version(), &(frame.name_value_block())));
+    post_compress_bytes.Add(encoded.size());
+    compressed_frames.Increment();
+    return;
+  }
+
   // First build an uncompressed version to be fed into the compressor.
   const size_t uncompressed_len = GetSerializedLength(
       protocol_version(), &(frame.name_value_block()));
@@ -2311,10 +2375,6 @@ void SpdyFramer::SerializeNameValueBlock(
     return;
   }
 
-  base::StatsCounter compressed_frames("spdy.CompressedFrames");
-  base::StatsCounter pre_compress_bytes("spdy.PreCompressSize");
-  base::StatsCounter post_compress_bytes("spdy.PostCompressSize");
-
   // Create an output frame.
   // Since we'll be performing lots of flushes when compressing the data,
   // zlib's lower bounds may be insufficient.
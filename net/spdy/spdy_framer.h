@@ -34,6 +34,8 @@ class SpdyStreamTest;
 class SpdyWebSocketStreamTest;
 class WebSocketJobTest;
 
+class HpackDecoder;
+class HpackEncoder;
 class SpdyFramer;
 class SpdyFrameBuilder;
 class SpdyFramerTest;
@@ -490,6 +492,13 @@ class NET_EXPORT_PRIVATE SpdyFramer {
     enable_compression_ = value;
   }
 
+  // Compresses header blocks with the indexed codec of hpack_codec.h instead
+  // of zlib. Both endpoints must agree on the codec, so this has to be set
+  // before the first header block is sent or received.
+  void set_enable_indexed_header_compression(bool value) {
+    enable_indexed_header_compression_ = value;
+  }
+
   // Used only in log messages.
   void set_display_protocol(const std::string& protocol) {
     display_protocol_ = protocol;
@@ -592,6 +601,10 @@ class NET_EXPORT_PRIVATE SpdyFramer {
   z_stream* GetHeaderCompressor();
   z_stream* GetHeaderDecompressor();
 
+  // Get (and lazily initialize) the indexed codec state.
+  HpackEncoder* GetHeaderEncoder();
+  HpackDecoder* GetHeaderDecoder();
+
  private:
   // Deliver the given control frame's uncompressed headers block to the
   // visitor in chunks. Returns true if the visitor has accepted all of the
@@ -600,6 +613,11 @@ class NET_EXPORT_PRIVATE SpdyFramer {
                                                   const char* data,
                                                   size_t len);
 
+  // Decodes the indexed header block buffered in |indexed_header_data_| and
+  // delivers it to the visitor as an uncompressed block. Returns true if the
+  // visitor has accepted all of it.
+  bool DeliverIndexedControlFrameHeaderData(SpdyStreamId stream_id);
+
   // Utility to copy the given data block to the current frame buffer, up
   // to the given maximum number of bytes, and update the buffer
   // data (pointer and length). Returns the number of bytes
@@ -687,6 +705,14 @@ class NET_EXPORT_PRIVATE SpdyFramer {
   scoped_ptr<z_stream> header_compressor_;
   scoped_ptr<z_stream> header_decompressor_;
 
+  // The indexed header codec, used instead of zlib if
+  // |enable_indexed_header_compression_|. The indexed codec decodes whole
+  // blocks, so the current one is buffered in |indexed_header_data_|.
+  bool enable_indexed_header_compression_;
+  scoped_ptr<HpackEncoder> header_encoder_;
+  scoped_ptr<HpackDecoder> header_decoder_;
+  std::string indexed_header_data_;
+
   SpdyFramerVisitorInterface* visitor_;
   SpdyFramerDebugVisitorInterface* debug_visitor_;
 
@@ -5,9 +5,11 @@
 #include <algorithm>
 #include <iostream>
 #include <limits>
+#include <vector>
 
 #include "base/compiler_specific.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
 #include "net/spdy/spdy_frame_builder.h"
 #include "net/spdy/spdy_framer.h"
 #include "net/spdy/spdy_protocol.h"
@@ -292,6 +294,7 @@ class TestSpdyVisitor : public SpdyFramerVisitorInterface,
   explicit TestSpdyVisitor(SpdyMajorVersion version)
     : framer_(version),
       use_compression_(false),
+      use_indexed_compression_(false),
       error_count_(0),
       syn_frame_count_(0),
       syn_reply_frame_count_(0),
@@ -478,6 +481,7 @@ class TestSpdyVisitor : public SpdyFramerVisitorInterface,
   // Convenience function which runs a framer simulation with particular input.
   void SimulateInFramer(const unsigned char* input, size_t size) {
     framer_.set_enable_compression(use_compression_);
+    framer_.set_enable_indexed_header_compression(use_indexed_compression_);
     framer_.set_visitor(this);
     size_t input_remaining = size;
     const char* input_ptr = reinterpret_cast<const char*>(input);
@@ -519,6 +523,7 @@ class TestSpdyVisitor : public SpdyFramerVisitorInterface,
 
   SpdyFramer framer_;
   bool use_compression_;
+  bool use_indexed_compression_;
 
   // Counters from the visitor callbacks.
   int error_count_;
@@ -1758,6 +1763,230 @@ TEST_P(SpdyFramerTest, UnclosedStreamDataCompressorsOneByteAtATime) {
   EXPECT_EQ(1, visitor.data_frame_count_);
 }
 
+TEST_P(SpdyFramerTest, IndexedHeaderCompression) {
+  SpdyFramer send_framer(spdy_version_);
+  send_framer.set_enable_indexed_header_compression(true);
+
+  SpdyHeaderBlock headers;
+  headers[":host"] = "www.example.com";
+  headers[":method"] = "GET";
+  headers[":path"] = "/index.html";
+  headers["user-agent"] = "Mozilla/5.0 (X11; Linux x86_64)";
+
+  TestSpdyVisitor visitor(spdy_version_);
+  visitor.use_compression_ = true;
+  visitor.use_indexed_compression_ = true;
+  size_t frame_sizes[2];
+  for (int i = 0; i < 2; i++) {
+    SpdySynStreamIR syn_stream(1 + 2 * i);
+    for (SpdyHeaderBlock::const_iterator it = headers.begin();
+         it != headers.end(); ++it) {
+      syn_stream.SetHeader(it->first, it->second);
+    }
+    scoped_ptr<SpdyFrame> frame(send_framer.SerializeFrame(syn_stream));
+    frame_sizes[i] = frame->size();
+
+    // One byte at a time, to split the block across reads.
+    visitor.headers_.clear();
+    const unsigned char* data =
+        reinterpret_cast<const unsigned char*>(frame->data());
+    for (size_t idx = 0; idx < frame->size(); ++idx)
+      visitor.SimulateInFramer(data + idx, 1);
+    EXPECT_EQ(0, visitor.error_count_);
+    EXPECT_TRUE(CompareHeaderBlocks(&headers, &visitor.headers_));
+  }
+  EXPECT_EQ(2, visitor.syn_frame_count_);
+
+  // The second block is all indexes, one byte per header.
+  EXPECT_EQ(send_framer.GetSynStreamMinimumSize() + headers.size(),
+            frame_sizes[1]);
+  EXPECT_LT(frame_sizes[1], frame_sizes[0]);
+}
+
+TEST_P(SpdyFramerTest, IndexedHeaderCompressionCorruptBlock) {
+  SpdyFramer send_framer(spdy_version_);
+  send_framer.set_enable_compression(false);
+
+  // An uncompressed block is not a valid indexed one.
+  SpdyHeaderBlock headers;
+  headers["alpha"] = "beta";
+  SpdySynStreamIR syn_stream(1);
+  syn_stream.SetHeader("alpha", "beta");
+  scoped_ptr<SpdyFrame> frame(send_framer.SerializeFrame(syn_stream));
+
+  TestSpdyVisitor visitor(spdy_version_);
+  visitor.use_compression_ = true;
+  visitor.use_indexed_compression_ = true;
+  visitor.SimulateInFramer(
+      reinterpret_cast<unsigned char*>(frame->data()), frame->size());
+  EXPECT_EQ(1, visitor.error_count_);
+  EXPECT_EQ(SpdyFramer::SPDY_DECOMPRESS_FAILURE,
+            visitor.framer_.error_code());
+}
+
+// Header blocks seen while loading a few real pages, requests followed by
+// responses. A NULL name ends a block.
+struct RecordedHeader {
+  const char* name;
+  const char* value;
+};
+
+const RecordedHeader kRecordedHeaders[] = {
+  { ":host", "www.example.com" },
+  { ":method", "GET" },
+  { ":path", "/" },
+  { ":scheme", "https" },
+  { ":version", "HTTP/1.1" },
+  { "accept", "text/html,application/xhtml+xml,application/xml;q=0.9,"
+              "*/*;q=0.8" },
+  { "accept-encoding", "gzip,deflate,sdch" },
+  { "accept-language", "en-US,en;q=0.8" },
+  { "cookie", "PREF=ID=7a5d3c1be2f04c96:FF=0:TM=1375990213:LM=1375990213:"
+              "S=lX8VfsDMzGmh1mQk; NID=67=Rz0VxSyGzNWm3Tt8xLk1bQ" },
+  { "user-agent", "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 "
+                  "(KHTML, like Gecko) Chrome/30.0.1599.14 Safari/537.36" },
+  { NULL, NULL },
+  { ":status", "200 OK" },
+  { ":version", "HTTP/1.1" },
+  { "cache-control", "private, max-age=0" },
+  { "content-encoding", "gzip" },
+  { "content-type", "text/html; charset=UTF-8" },
+  { "date", "Thu, 08 Aug 2013 19:30:14 GMT" },
+  { "expires", "-1" },
+  { "server", "gws" },
+  { "x-frame-options", "SAMEORIGIN" },
+  { "x-xss-protection", "1; mode=block" },
+  { NULL, NULL },
+  { ":host", "www.example.com" },
+  { ":method", "GET" },
+  { ":path", "/images/logo_sprite.png" },
+  { ":scheme", "https" },
+  { ":version", "HTTP/1.1" },
+  { "accept", "image/webp,*/*;q=0.8" },
+  { "accept-encoding", "gzip,deflate,sdch" },
+  { "accept-language", "en-US,en;q=0.8" },
+  { "cookie", "PREF=ID=7a5d3c1be2f04c96:FF=0:TM=1375990213:LM=1375990213:"
+              "S=lX8VfsDMzGmh1mQk; NID=67=Rz0VxSyGzNWm3Tt8xLk1bQ" },
+  { "referer", "https://www.example.com/" },
+  { "user-agent", "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 "
+                  "(KHTML, like Gecko) Chrome/30.0.1599.14 Safari/537.36" },
+  { NULL, NULL },
+  { ":status", "200 OK" },
+  { ":version", "HTTP/1.1" },
+  { "cache-control", "private, max-age=31536000" },
+  { "content-length", "28754" },
+  { "content-type", "image/png" },
+  { "date", "Thu, 08 Aug 2013 19:30:14 GMT" },
+  { "expires", "Thu, 08 Aug 2013 19:30:14 GMT" },
+  { "last-modified", "Wed, 24 Jul 2013 21:25:04 GMT" },
+  { "server", "sffe" },
+  { "x-content-type-options", "nosniff" },
+  { NULL, NULL },
+  { ":host", "static.example.com" },
+  { ":method", "GET" },
+  { ":path", "/js/main.js?v=1375990180" },
+  { ":scheme", "https" },
+  { ":version", "HTTP/1.1" },
+  { "accept", "*/*" },
+  { "accept-encoding", "gzip,deflate,sdch" },
+  { "accept-language", "en-US,en;q=0.8" },
+  { "referer", "https://www.example.com/" },
+  { "user-agent", "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 "
+                  "(KHTML, like Gecko) Chrome/30.0.1599.14 Safari/537.36" },
+  { NULL, NULL },
+  { ":status", "304 Not Modified" },
+  { ":version", "HTTP/1.1" },
+  { "age", "3214" },
+  { "cache-control", "public, max-age=86400" },
+  { "date", "Thu, 08 Aug 2013 19:30:15 GMT" },
+  { "etag", "\"3e15a-4e2a5a1b7e5c0\"" },
+  { "expires", "Fri, 09 Aug 2013 19:30:15 GMT" },
+  { "server", "Apache" },
+  { "vary", "Accept-Encoding" },
+  { NULL, NULL },
+  { ":host", "www.example.com" },
+  { ":method", "POST" },
+  { ":path", "/log?format=json&t=1375990215843" },
+  { ":scheme", "https" },
+  { ":version", "HTTP/1.1" },
+  { "accept", "*/*" },
+  { "accept-encoding", "gzip,deflate,sdch" },
+  { "accept-language", "en-US,en;q=0.8" },
+  { "content-length", "312" },
+  { "content-type", "application/x-www-form-urlencoded;charset=utf-8" },
+  { "cookie", "PREF=ID=7a5d3c1be2f04c96:FF=0:TM=1375990213:LM=1375990213:"
+              "S=lX8VfsDMzGmh1mQk; NID=67=Rz0VxSyGzNWm3Tt8xLk1bQ" },
+  { "origin", "https://www.example.com" },
+  { "referer", "https://www.example.com/" },
+  { "user-agent", "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 "
+                  "(KHTML, like Gecko) Chrome/30.0.1599.14 Safari/537.36" },
+  { NULL, NULL },
+  { ":status", "204 No Content" },
+  { ":version", "HTTP/1.1" },
+  { "content-length", "0" },
+  { "date", "Thu, 08 Aug 2013 19:30:15 GMT" },
+  { "server", "gws" },
+  { NULL, NULL },
+};
+
+// Compares the size and speed of the zlib and the indexed header compression
+// over the recorded blocks. The results are only logged.
+TEST_P(SpdyFramerTest, HeaderCompressionThroughput) {
+  std::vector<SpdyHeaderBlock> blocks(1);
+  size_t uncompressed_bytes = 0;
+  for (size_t i = 0; i < arraysize(kRecordedHeaders); ++i) {
+    const RecordedHeader& header = kRecordedHeaders[i];
+    if (!header.name) {
+      uncompressed_bytes += SpdyFramer::GetSerializedLength(
+          spdy_version_, &blocks.back());
+      blocks.push_back(SpdyHeaderBlock());
+      continue;
+    }
+    blocks.back()[header.name] = header.value;
+  }
+  blocks.pop_back();
+
+  const int kIterations = 200;
+  for (int indexed = 0; indexed < 2; ++indexed) {
+    SpdyFramer send_framer(spdy_version_);
+    send_framer.set_enable_indexed_header_compression(indexed != 0);
+    TestSpdyVisitor visitor(spdy_version_);
+    visitor.use_compression_ = true;
+    visitor.use_indexed_compression_ = indexed != 0;
+    visitor.set_header_buffer_size(64 * 1024);
+
+    size_t compressed_bytes = 0;
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (int i = 0; i < kIterations; ++i) {
+      for (size_t j = 0; j < blocks.size(); ++j) {
+        SpdyHeadersIR headers_ir(1 + 2 * (i * blocks.size() + j));
+        for (SpdyHeaderBlock::const_iterator it = blocks[j].begin();
+             it != blocks[j].end(); ++it) {
+          headers_ir.SetHeader(it->first, it->second);
+        }
+        scoped_ptr<SpdyFrame> frame(send_framer.SerializeFrame(headers_ir));
+        compressed_bytes +=
+            frame->size() - send_framer.GetHeadersMinimumSize();
+
+        visitor.headers_.clear();
+        visitor.SimulateInFramer(
+            reinterpret_cast<unsigned char*>(frame->data()), frame->size());
+        ASSERT_EQ(0, visitor.error_count_);
+        ASSERT_TRUE(CompareHeaderBlocks(&blocks[j], &visitor.headers_));
+      }
+    }
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+    LOG(INFO) << (indexed ? "Indexed" : "Zlib") << " header compression, "
+              << "SPDY/" << spdy_version_ << ": "
+              << compressed_bytes / kIterations << " of "
+              << uncompressed_bytes << " bytes per session, "
+              << kIterations * uncompressed_bytes /
+                     std::max(elapsed.InMicrosecondsF(), 1.0)
+              << " MB/s";
+  }
+}
+
 TEST_P(SpdyFramerTest, WindowUpdateFrame) {
   SpdyFramer framer(spdy_version_);
   scoped_ptr<SpdyFrame> frame(framer.CreateWindowUpdate(1, 0x12345678));
@@ -45,6 +45,10 @@ namespace net {
 namespace {
 
 const int kReadBufferSize = 8 * 1024;
+// DATA payloads at least this big reference the read buffer instead of
+// being copied out of it. Smaller ones are copied so that a few bytes
+// cannot keep a whole read buffer alive.
+const size_t kMinReadBufferSliceSize = 1024;
 const int kDefaultConnectionAtRiskOfLossSeconds = 10;
 const int kHungIntervalSeconds = 10;
 
@@ -469,6 +473,11 @@ Error SpdySession::InitializeWithSocket(
     flow_control_state_ = FLOW_CONTROL_NONE;
   }
 
+  // SPDY/4 streams can depend on each other, and streams of equal priority
+  // share the connection instead of going first come, first served.
+  if (protocol_ >= kProtoSPDY4a2)
+    write_queue_.EnablePriorityForest();
+
   buffered_spdy_framer_.reset(
       new BufferedSpdyFramer(NextProtoToSpdyMajorVersion(protocol_),
                              enable_compression_));
@@ -1138,6 +1147,10 @@ int SpdySession::DoRead() {
   CHECK(connection_);
   CHECK(connection_->socket());
   read_state_ = READ_STATE_DO_READ_COMPLETE;
+  // DATA frames still queued on streams may point into the last buffer,
+  // so read into a new one rather than overwrite them.
+  if (!read_buffer_->HasOneRef())
+    read_buffer_ = new IOBuffer(kReadBufferSize);
   return connection_->socket()->Read(
       read_buffer_.get(),
       kReadBufferSize,
@@ -1814,7 +1827,13 @@ void SpdySession::OnStreamFrameData(SpdyStreamId stream_id,
   scoped_ptr<SpdyBuffer> buffer;
   if (data) {
     DCHECK_GT(len, 0u);
-    buffer.reset(new SpdyBuffer(data, len));
+    const char* read_data = read_buffer_->data();
+    if (len >= kMinReadBufferSliceSize &&
+        data >= read_data && data + len <= read_data + kReadBufferSize) {
+      buffer.reset(new SpdyBuffer(read_buffer_, data, len));
+    } else {
+      buffer.reset(new SpdyBuffer(data, len));
+    }
 
     if (flow_control_state_ == FLOW_CONTROL_STREAM_AND_SESSION) {
       DecreaseRecvWindowSize(static_cast<int32>(len));
@@ -26,15 +26,38 @@ SpdyWriteQueue::PendingWrite::PendingWrite(
 
 SpdyWriteQueue::PendingWrite::~PendingWrite() {}
 
-SpdyWriteQueue::SpdyWriteQueue() {}
+SpdyWriteQueue::StreamWrites::StreamWrites() : node_id(0) {}
+
+SpdyWriteQueue::StreamWrites::~StreamWrites() {}
+
+SpdyWriteQueue::SpdyWriteQueue()
+    : use_priority_forest_(false),
+      next_node_id_(1) {}
 
 SpdyWriteQueue::~SpdyWriteQueue() {
   Clear();
 }
 
+void SpdyWriteQueue::EnablePriorityForest() {
+  DCHECK(IsEmpty());
+  use_priority_forest_ = true;
+}
+
+bool SpdyWriteQueue::SetStreamDependency(
+    const base::WeakPtr<SpdyStream>& stream,
+    const base::WeakPtr<SpdyStream>& parent,
+    bool unordered) {
+  DCHECK(use_priority_forest_);
+  DCHECK(stream.get());
+  DCHECK(parent.get());
+  uint32 node_id = GetStreamWrites(stream)->node_id;
+  uint32 parent_node_id = GetStreamWrites(parent)->node_id;
+  return stream_forest_.SetParent(node_id, parent_node_id, unordered);
+}
+
 bool SpdyWriteQueue::IsEmpty() const {
   for (int i = 0; i < NUM_PRIORITIES; i++) {
-    if (!queue_[i].empty())
+    if (!queue_[i].empty() || !stream_turns_[i].empty())
       return false;
   }
   return true;
@@ -46,24 +69,39 @@ void SpdyWriteQueue::Enqueue(RequestPriority priority,
                              const base::WeakPtr<SpdyStream>& stream) {
   if (stream.get())
     DCHECK_EQ(stream->priority(), priority);
-  queue_[priority].push_back(
-      PendingWrite(frame_type, frame_producer.release(), stream));
+  PendingWrite pending_write(frame_type, frame_producer.release(), stream);
+  if (!use_priority_forest_ || !stream.get()) {
+    queue_[priority].push_back(pending_write);
+    return;
+  }
+
+  StreamWrites* stream_writes = GetStreamWrites(stream);
+  if (stream_writes->writes.empty()) {
+    stream_turns_[priority].push_back(stream.get());
+    stream_forest_.MarkReadyToWrite(stream_writes->node_id);
+  }
+  stream_writes->writes.push_back(pending_write);
 }
 
 bool SpdyWriteQueue::Dequeue(SpdyFrameType* frame_type,
                              scoped_ptr<SpdyBufferProducer>* frame_producer,
                              base::WeakPtr<SpdyStream>* stream) {
   for (int i = NUM_PRIORITIES - 1; i >= 0; --i) {
+    PendingWrite pending_write;
     if (!queue_[i].empty()) {
-      PendingWrite pending_write = queue_[i].front();
+      pending_write = queue_[i].front();
       queue_[i].pop_front();
-      *frame_type = pending_write.frame_type;
-      frame_producer->reset(pending_write.frame_producer);
-      *stream = pending_write.stream;
-      if (pending_write.has_stream)
-        DCHECK(stream->get());
-      return true;
+    } else if (!use_priority_forest_ ||
+               !DequeueStreamWrite(static_cast<RequestPriority>(i),
+                                   &pending_write)) {
+      continue;
     }
+    *frame_type = pending_write.frame_type;
+    frame_producer->reset(pending_write.frame_producer);
+    *stream = pending_write.stream;
+    if (pending_write.has_stream)
+      DCHECK(stream->get());
+    return true;
   }
   return false;
 }
@@ -71,6 +109,15 @@ bool SpdyWriteQueue::Dequeue(SpdyFrameType* frame_type,
 void SpdyWriteQueue::RemovePendingWritesForStream(
     const base::WeakPtr<SpdyStream>& stream) {
   DCHECK(stream.get());
+  if (use_priority_forest_) {
+    StreamWritesMap::iterator it = stream_writes_.find(stream.get());
+    if (it != stream_writes_.end()) {
+      DeleteStreamWrites(it);
+      stream_forest_.RemoveNode(it->second.node_id);
+      stream_writes_.erase(it);
+    }
+  }
+
   if (DCHECK_IS_ON()) {
     // |stream| should not have pending writes in a queue not matching
     // its priority.
@@ -117,6 +164,17 @@ void SpdyWriteQueue::RemovePendingWritesForStreamsAfter(
     }
     queue->erase(out_it, queue->end());
   }
+
+  for (StreamWritesMap::iterator it = stream_writes_.begin();
+       it != stream_writes_.end();) {
+    StreamWritesMap::iterator current = it++;
+    SpdyStream* stream = current->second.stream.get();
+    if (stream && (stream->stream_id() > last_good_stream_id ||
+                   stream->stream_id() == 0)) {
+      DeleteStreamWrites(current);
+      MaybeRemoveStream(current);
+    }
+  }
 }
 
 void SpdyWriteQueue::Clear() {
@@ -126,7 +184,96 @@ void SpdyWriteQueue::Clear() {
       delete it->frame_producer;
     }
     queue_[i].clear();
+    stream_turns_[i].clear();
+  }
+
+  for (StreamWritesMap::iterator it = stream_writes_.begin();
+       it != stream_writes_.end(); ++it) {
+    for (std::deque<PendingWrite>::iterator write_it =
+             it->second.writes.begin();
+         write_it != it->second.writes.end(); ++write_it) {
+      delete write_it->frame_producer;
+    }
+    stream_forest_.RemoveNode(it->second.node_id);
+  }
+  stream_writes_.clear();
+}
+
+SpdyWriteQueue::StreamWrites* SpdyWriteQueue::GetStreamWrites(
+    const base::WeakPtr<SpdyStream>& stream) {
+  StreamWrites* stream_writes = &stream_writes_[stream.get()];
+  if (!stream_writes->node_id) {
+    stream_writes->stream = stream;
+    stream_writes->node_id = next_node_id_++;
+    stream_forest_.AddRootNode(stream_writes->node_id, stream->priority());
+  }
+  return stream_writes;
+}
+
+bool SpdyWriteQueue::IsStreamUnblocked(uint32 node_id) const {
+  // Walk up the dependency chain. An ancestor with pending writes blocks
+  // the stream unless every link down from it is unordered.
+  bool unordered_path = true;
+  for (uint32 id = node_id; ; ) {
+    uint32 parent_id = stream_forest_.GetParent(id);
+    if (!parent_id)
+      return true;
+    unordered_path = unordered_path && stream_forest_.IsNodeUnordered(id);
+    if (!unordered_path && stream_forest_.IsMarkedReadyToWrite(parent_id))
+      return false;
+    id = parent_id;
+  }
+}
+
+bool SpdyWriteQueue::DequeueStreamWrite(RequestPriority priority,
+                                        PendingWrite* pending_write) {
+  std::list<SpdyStream*>* turns = &stream_turns_[priority];
+  for (std::list<SpdyStream*>::iterator it = turns->begin();
+       it != turns->end(); ++it) {
+    StreamWritesMap::iterator stream_it = stream_writes_.find(*it);
+    DCHECK(stream_it != stream_writes_.end());
+    StreamWrites* stream_writes = &stream_it->second;
+    if (!IsStreamUnblocked(stream_writes->node_id))
+      continue;
+
+    *pending_write = stream_writes->writes.front();
+    stream_writes->writes.pop_front();
+
+    // Go to the back of the line, or out of it.
+    SpdyStream* stream = *it;
+    turns->erase(it);
+    if (!stream_writes->writes.empty()) {
+      turns->push_back(stream);
+    } else {
+      stream_forest_.MarkNoLongerReadyToWrite(stream_writes->node_id);
+      MaybeRemoveStream(stream_it);
+    }
+    return true;
+  }
+  return false;
+}
+
+void SpdyWriteQueue::MaybeRemoveStream(StreamWritesMap::iterator it) {
+  DCHECK(it->second.writes.empty());
+  uint32 node_id = it->second.node_id;
+  if (stream_forest_.GetParent(node_id) || stream_forest_.GetChild(node_id))
+    return;
+  stream_forest_.RemoveNode(node_id);
+  stream_writes_.erase(it);
+}
+
+void SpdyWriteQueue::DeleteStreamWrites(StreamWritesMap::iterator it) {
+  std::deque<PendingWrite>* writes = &it->second.writes;
+  if (writes->empty())
+    return;
+  for (std::deque<PendingWrite>::iterator write_it = writes->begin();
+       write_it != writes->end(); ++write_it) {
+    delete write_it->frame_producer;
   }
+  writes->clear();
+  for (int i = 0; i < NUM_PRIORITIES; ++i)
+    stream_turns_[i].remove(it->first);
+  stream_forest_.MarkNoLongerReadyToWrite(it->second.node_id);
 }
 
 }  // namespace net
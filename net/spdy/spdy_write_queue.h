@@ -6,12 +6,15 @@
 #define NET_SPDY_SPDY_WRITE_QUEUE_H_
 
 #include <deque>
+#include <list>
+#include <map>
 
 #include "base/basictypes.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "net/base/net_export.h"
 #include "net/base/request_priority.h"
+#include "net/spdy/spdy_priority_forest.h"
 #include "net/spdy/spdy_protocol.h"
 
 namespace net {
@@ -22,11 +25,32 @@ class SpdyStream;
 
 // A queue of SpdyBufferProducers to produce frames to write. Ordered
 // by priority, and then FIFO.
+//
+// With EnablePriorityForest(), the writes of each priority that are not
+// associated with a stream still go first in FIFO order, but the streams
+// then take turns, one write each, so that a stream with a lot of data to
+// send cannot hold back the others of its priority. Streams can also be
+// made to depend on each other through a SpdyPriorityForest.
 class NET_EXPORT_PRIVATE SpdyWriteQueue {
  public:
   SpdyWriteQueue();
   ~SpdyWriteQueue();
 
+  // Switches to the stream scheduling described above. Must be called
+  // while the queue is empty.
+  void EnablePriorityForest();
+
+  // Makes the writes of |stream| wait until |parent| has no pending
+  // writes or, if |unordered|, take turns with them. Both streams must
+  // be non-NULL and outlive their pending writes, and
+  // RemovePendingWritesForStream() must be called for them once they
+  // are closed. Returns false if the dependency cannot be added, for
+  // instance because another stream already depends on |parent|.
+  // Requires EnablePriorityForest().
+  bool SetStreamDependency(const base::WeakPtr<SpdyStream>& stream,
+                           const base::WeakPtr<SpdyStream>& parent,
+                           bool unordered);
+
   // Returns whether there is anything in the write queue,
   // i.e. whether the next call to Dequeue will return true.
   bool IsEmpty() const;
@@ -78,9 +102,52 @@ class NET_EXPORT_PRIVATE SpdyWriteQueue {
     ~PendingWrite();
   };
 
-  // The actual write queue, binned by priority.
+  // The node of a stream in |stream_forest_| and its pending writes.
+  struct StreamWrites {
+    StreamWrites();
+    ~StreamWrites();
+
+    base::WeakPtr<SpdyStream> stream;
+    uint32 node_id;
+    std::deque<PendingWrite> writes;
+  };
+
+  typedef std::map<SpdyStream*, StreamWrites> StreamWritesMap;
+  typedef SpdyPriorityForest<uint32, RequestPriority> StreamForest;
+
+  // Returns the entry of |stream|, adding it to |stream_forest_| if it is
+  // not there yet.
+  StreamWrites* GetStreamWrites(const base::WeakPtr<SpdyStream>& stream);
+
+  // Returns true if the writes of the stream at |node_id| are not waiting
+  // for those of another stream.
+  bool IsStreamUnblocked(uint32 node_id) const;
+
+  // Dequeues the next write of the first unblocked stream in
+  // |stream_turns_[priority]|, if any.
+  bool DequeueStreamWrite(RequestPriority priority,
+                          PendingWrite* pending_write);
+
+  // Removes the stream of |it|, which has no pending writes, from
+  // |stream_forest_| and |stream_writes_| unless it is part of a
+  // dependency.
+  void MaybeRemoveStream(StreamWritesMap::iterator it);
+
+  // Deletes the pending writes of |it|, and takes the stream out of turn.
+  void DeleteStreamWrites(StreamWritesMap::iterator it);
+
+  // The actual write queue, binned by priority. With the priority forest,
+  // only the writes that are not associated with a stream go here.
   std::deque<PendingWrite> queue_[NUM_PRIORITIES];
 
+  bool use_priority_forest_;
+  StreamForest stream_forest_;
+  uint32 next_node_id_;
+  StreamWritesMap stream_writes_;
+
+  // The streams with pending writes, binned by priority, in turn order.
+  std::list<SpdyStream*> stream_turns_[NUM_PRIORITIES];
+
   DISALLOW_COPY_AND_ASSIGN(SpdyWriteQueue);
 };
 
@@ -247,6 +247,93 @@ TEST_F(SpdyWriteQueueTest, Clear) {
   EXPECT_FALSE(write_queue.Dequeue(&frame_type, &frame_producer, &stream));
 }
 
+// With the priority forest, streams of the same priority take turns
+// instead of going in the order their writes were enqueued. Writes
+// without a stream still go first.
+TEST_F(SpdyWriteQueueTest, PriorityForestRoundRobin) {
+  SpdyWriteQueue write_queue;
+  write_queue.EnablePriorityForest();
+
+  scoped_ptr<SpdyStream> stream1(MakeTestStream(DEFAULT_PRIORITY));
+  scoped_ptr<SpdyStream> stream2(MakeTestStream(DEFAULT_PRIORITY));
+
+  for (int i = 0; i < 10; ++i) {
+    write_queue.Enqueue(DEFAULT_PRIORITY, DATA, IntToProducer(i),
+                        stream1->GetWeakPtr());
+  }
+  for (int i = 10; i < 13; ++i) {
+    write_queue.Enqueue(DEFAULT_PRIORITY, DATA, IntToProducer(i),
+                        stream2->GetWeakPtr());
+  }
+  write_queue.Enqueue(DEFAULT_PRIORITY, SETTINGS, IntToProducer(100),
+                      base::WeakPtr<SpdyStream>());
+
+  const int kExpected[] = { 100, 0, 10, 1, 11, 2, 12, 3, 4, 5, 6, 7, 8, 9 };
+  for (size_t i = 0; i < arraysize(kExpected); ++i) {
+    SpdyFrameType frame_type = DATA;
+    scoped_ptr<SpdyBufferProducer> frame_producer;
+    base::WeakPtr<SpdyStream> stream;
+    ASSERT_TRUE(write_queue.Dequeue(&frame_type, &frame_producer, &stream));
+    EXPECT_EQ(kExpected[i], ProducerToInt(frame_producer.Pass())) << i;
+  }
+  EXPECT_TRUE(write_queue.IsEmpty());
+}
+
+// A stream that depends on another one waits for its writes, unless
+// the dependency is unordered.
+TEST_F(SpdyWriteQueueTest, PriorityForestDependencies) {
+  SpdyWriteQueue write_queue;
+  write_queue.EnablePriorityForest();
+
+  scoped_ptr<SpdyStream> parent(MakeTestStream(LOWEST));
+  scoped_ptr<SpdyStream> child(MakeTestStream(HIGHEST));
+  scoped_ptr<SpdyStream> other_parent(MakeTestStream(LOWEST));
+  scoped_ptr<SpdyStream> sibling(MakeTestStream(HIGHEST));
+  EXPECT_TRUE(write_queue.SetStreamDependency(
+      child->GetWeakPtr(), parent->GetWeakPtr(), false));
+  EXPECT_TRUE(write_queue.SetStreamDependency(
+      sibling->GetWeakPtr(), other_parent->GetWeakPtr(), true));
+  // A stream has at most one dependent.
+  EXPECT_FALSE(write_queue.SetStreamDependency(
+      sibling->GetWeakPtr(), parent->GetWeakPtr(), false));
+
+  write_queue.Enqueue(LOWEST, DATA, StringToProducer("other"),
+                      other_parent->GetWeakPtr());
+  write_queue.Enqueue(HIGHEST, DATA, StringToProducer("child"),
+                      child->GetWeakPtr());
+  write_queue.Enqueue(HIGHEST, DATA, StringToProducer("sibling"),
+                      sibling->GetWeakPtr());
+  write_queue.Enqueue(LOWEST, DATA, StringToProducer("parent1"),
+                      parent->GetWeakPtr());
+  write_queue.Enqueue(LOWEST, DATA, StringToProducer("parent2"),
+                      parent->GetWeakPtr());
+
+  const char* const kExpected[] = {
+    "sibling", "other", "parent1", "parent2", "child"
+  };
+  for (size_t i = 0; i < arraysize(kExpected); ++i) {
+    SpdyFrameType frame_type = DATA;
+    scoped_ptr<SpdyBufferProducer> frame_producer;
+    base::WeakPtr<SpdyStream> stream;
+    ASSERT_TRUE(write_queue.Dequeue(&frame_type, &frame_producer, &stream));
+    EXPECT_EQ(kExpected[i], ProducerToString(frame_producer.Pass()));
+  }
+  EXPECT_TRUE(write_queue.IsEmpty());
+
+  // Removing the parent releases the child.
+  write_queue.Enqueue(LOWEST, DATA, StringToProducer("parent3"),
+                      parent->GetWeakPtr());
+  write_queue.Enqueue(HIGHEST, DATA, StringToProducer("child2"),
+                      child->GetWeakPtr());
+  write_queue.RemovePendingWritesForStream(parent->GetWeakPtr());
+  SpdyFrameType frame_type = DATA;
+  scoped_ptr<SpdyBufferProducer> frame_producer;
+  base::WeakPtr<SpdyStream> stream;
+  ASSERT_TRUE(write_queue.Dequeue(&frame_type, &frame_producer, &stream));
+  EXPECT_EQ("child2", ProducerToString(frame_producer.Pass()));
+  EXPECT_FALSE(write_queue.Dequeue(&frame_type, &frame_producer, &stream));
+}
+
 }  // namespace
 
 }  // namespace net
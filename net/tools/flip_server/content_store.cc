@@ -0,0 +1,279 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/flip_server/content_store.h"
+
+#include <string.h>
+
+#include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/logging.h"
+#include "base/stl_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "net/tools/flip_server/balsa_frame.h"
+#include "net/tools/flip_server/balsa_visitor_interface.h"
+#include "net/tools/flip_server/simple_buffer.h"
+#include "third_party/zlib/zlib.h"
+
+namespace net {
+
+namespace {
+
+// Content types that are worth compressing.
+const char* const kCompressibleTypes[] = {
+  "text/",
+  "application/javascript",
+  "application/x-javascript",
+  "application/json",
+  "application/xml",
+  "image/svg+xml",
+};
+
+// Collects the body of a capture. As long as the framer hands the body over
+// in one contiguous run of the capture, it is kept as a pointer into the
+// capture; otherwise, e.g. for chunked captures, it is copied.
+class BodyVisitor : public BalsaVisitorInterface {
+ public:
+  explicit BodyVisitor(std::string* copy)
+      : copy_(copy), copied_(false), header_done_(false) {}
+
+  void AppendToBody(const char* input, size_t size) {
+    if (size == 0)
+      return;
+    if (!copied_ && (body_.empty() || body_.data() + body_.size() == input)) {
+      body_.set(body_.empty() ? input : body_.data(), body_.size() + size);
+      return;
+    }
+    if (!copied_) {
+      body_.CopyToString(copy_);
+      copied_ = true;
+    }
+    copy_->append(input, size);
+  }
+
+  base::StringPiece body() const {
+    return copied_ ? base::StringPiece(*copy_) : body_;
+  }
+
+  bool header_done() const { return header_done_; }
+
+  // BalsaVisitorInterface:
+  virtual void ProcessBodyData(const char* input, size_t size) OVERRIDE {
+    AppendToBody(input, size);
+  }
+  virtual void HeaderDone() OVERRIDE { header_done_ = true; }
+  virtual void ProcessBodyInput(const char*, size_t) OVERRIDE {}
+  virtual void ProcessHeaderInput(const char*, size_t) OVERRIDE {}
+  virtual void ProcessTrailerInput(const char*, size_t) OVERRIDE {}
+  virtual void ProcessHeaders(const BalsaHeaders&) OVERRIDE {}
+  virtual void ProcessRequestFirstLine(
+      const char*, size_t, const char*, size_t,
+      const char*, size_t, const char*, size_t) OVERRIDE {}
+  virtual void ProcessResponseFirstLine(
+      const char*, size_t, const char*,
+      size_t, const char*, size_t, const char*, size_t) OVERRIDE {}
+  virtual void ProcessChunkLength(size_t) OVERRIDE {}
+  virtual void ProcessChunkExtensions(const char*, size_t) OVERRIDE {}
+  virtual void MessageDone() OVERRIDE {}
+  virtual void HandleHeaderError(BalsaFrame*) OVERRIDE {}
+  virtual void HandleHeaderWarning(BalsaFrame*) OVERRIDE {}
+  virtual void HandleChunkingError(BalsaFrame*) OVERRIDE {}
+  virtual void HandleBodyError(BalsaFrame*) OVERRIDE {}
+
+ private:
+  base::StringPiece body_;
+  std::string* copy_;
+  bool copied_;
+  bool header_done_;
+};
+
+// Returns the length of the header block at the start of |capture|, including
+// the empty line that ends it, or 0 if there is none.
+size_t GetHeaderBlockLength(const base::StringPiece& capture) {
+  size_t crlf = capture.find("\r\n\r\n");
+  size_t lf = capture.find("\n\n");
+  if (crlf != base::StringPiece::npos && (lf == base::StringPiece::npos ||
+                                          crlf < lf)) {
+    return crlf + 4;
+  }
+  if (lf != base::StringPiece::npos)
+    return lf + 2;
+  return 0;
+}
+
+std::string SerializeHeaders(const BalsaHeaders& headers) {
+  SimpleBuffer buffer;
+  headers.WriteHeaderAndEndingToBuffer(&buffer);
+  return buffer.str();
+}
+
+bool IsCompressible(const BalsaHeaders& headers) {
+  if (headers.HasHeader("content-encoding"))
+    return false;
+  std::string content_type =
+      StringToLowerASCII(headers.GetHeader("content-type").as_string());
+  for (size_t i = 0; i < arraysize(kCompressibleTypes); ++i) {
+    if (StartsWithASCII(content_type, kCompressibleTypes[i], true))
+      return true;
+  }
+  return false;
+}
+
+// Compresses |input| into a gzip stream in |output|.
+bool Gzip(const base::StringPiece& input, std::string* output) {
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  // 16 + MAX_WBITS asks for a gzip wrapper around the deflate stream.
+  if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    return false;
+  }
+  output->resize(deflateBound(&stream, input.size()));
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+  stream.avail_in = input.size();
+  stream.next_out = reinterpret_cast<Bytef*>(&(*output)[0]);
+  stream.avail_out = output->size();
+  int result = deflate(&stream, Z_FINISH);
+  output->resize(stream.total_out);
+  deflateEnd(&stream);
+  return result == Z_STREAM_END;
+}
+
+}  // namespace
+
+ContentStore::Entry::Entry() {}
+
+ContentStore::Entry::~Entry() {}
+
+ContentStore::ContentStore() {}
+
+size_t ContentStore::LoadDirectory(const base::FilePath& directory) {
+  size_t loaded = 0;
+  base::FileEnumerator files(directory, true, base::FileEnumerator::FILES);
+  for (base::FilePath file = files.Next(); !file.empty(); file = files.Next()) {
+    // Skip version control metadata.
+    if (file.value().find("/.svn/") != std::string::npos)
+      continue;
+    base::FilePath relative_path;
+    if (!directory.AppendRelativePath(file, &relative_path))
+      continue;
+    if (LoadFile(file, relative_path.value()))
+      ++loaded;
+  }
+  return loaded;
+}
+
+bool ContentStore::LoadFile(const base::FilePath& file,
+                            const std::string& path) {
+  scoped_ptr<Entry> entry(new Entry);
+  entry->file_.reset(new base::MemoryMappedFile);
+  if (!entry->file_->Initialize(file)) {
+    LOG(ERROR) << "Unable to map " << file.value();
+    return false;
+  }
+  base::StringPiece capture(
+      reinterpret_cast<const char*>(entry->file_->data()),
+      entry->file_->length());
+  if (!ParseCapture(capture, false, entry.get())) {
+    LOG(ERROR) << "Unable to parse the HTTP response in " << file.value();
+    return false;
+  }
+  Store(path, entry.Pass());
+  return true;
+}
+
+bool ContentStore::AddCapture(const std::string& path,
+                              const base::StringPiece& capture) {
+  scoped_ptr<Entry> entry(new Entry);
+  if (!ParseCapture(capture, true, entry.get()))
+    return false;
+  Store(path, entry.Pass());
+  return true;
+}
+
+const ContentStore::Entry* ContentStore::GetEntry(
+    const std::string& path) const {
+  Entries::const_iterator it = entries_.find(path);
+  return it == entries_.end() ? NULL : it->second;
+}
+
+ContentStore::~ContentStore() {
+  STLDeleteValues(&entries_);
+}
+
+// static
+bool ContentStore::ParseCapture(const base::StringPiece& capture,
+                                bool copy_body,
+                                Entry* entry) {
+  // The framer needs the header block in a buffer it may write to, to make
+  // every capture look like HTTP/1.1; the body is framed in place.
+  size_t header_length = GetHeaderBlockLength(capture);
+  if (header_length == 0)
+    return false;
+  std::string header_block = capture.substr(0, header_length).as_string();
+  if (StartsWithASCII(header_block, "HTTP/1.0", true))
+    header_block[7] = '1';
+
+  BodyVisitor visitor(&entry->body_copy_);
+  BalsaFrame framer;
+  framer.set_balsa_visitor(&visitor);
+  framer.set_balsa_headers(&entry->headers_);
+  framer.ProcessInput(header_block.data(), header_block.size());
+  if (framer.Error() || !visitor.header_done())
+    return false;
+
+  size_t pos = header_length;
+  while (pos < capture.size() && !framer.MessageFullyRead()) {
+    size_t processed =
+        framer.ProcessInput(capture.data() + pos, capture.size() - pos);
+    if (framer.Error())
+      return false;
+    if (processed == 0)
+      break;
+    pos += processed;
+  }
+  // Many captures have neither a Content-Length nor chunked encoding, in
+  // which case the rest of the capture is the body.
+  if (pos < capture.size())
+    visitor.AppendToBody(capture.data() + pos, capture.size() - pos);
+
+  base::StringPiece body = visitor.body();
+  if (copy_body && body.data() != entry->body_copy_.data())
+    body.CopyToString(&entry->body_copy_);
+  entry->body_ = copy_body ? base::StringPiece(entry->body_copy_) : body;
+
+  entry->headers_.RemoveAllOfHeader("transfer-encoding");
+  entry->headers_.ReplaceOrAppendHeader(
+      "content-length", base::Uint64ToString(entry->body_.size()));
+  entry->header_block_ = SerializeHeaders(entry->headers_);
+
+  if (IsCompressible(entry->headers_) &&
+      Gzip(entry->body_, &entry->gzip_body_) &&
+      entry->gzip_body_.size() < entry->body_.size()) {
+    entry->gzip_headers_.CopyFrom(entry->headers_);
+    entry->gzip_headers_.ReplaceOrAppendHeader("content-encoding", "gzip");
+    entry->gzip_headers_.ReplaceOrAppendHeader(
+        "content-length", base::Uint64ToString(entry->gzip_body_.size()));
+    entry->gzip_headers_.ReplaceOrAppendHeader("vary", "accept-encoding");
+    entry->gzip_header_block_ = SerializeHeaders(entry->gzip_headers_);
+  } else {
+    entry->gzip_body_.clear();
+  }
+  return true;
+}
+
+void ContentStore::Store(const std::string& path, scoped_ptr<Entry> entry) {
+  entry->path_ = path;
+  Entries::iterator it = entries_.find(path);
+  if (it != entries_.end()) {
+    delete it->second;
+    it->second = entry.release();
+  } else {
+    entries_.insert(std::make_pair(path, entry.release()));
+  }
+}
+
+}  // namespace net
@@ -0,0 +1,126 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_TOOLS_FLIP_SERVER_CONTENT_STORE_H_
+#define NET_TOOLS_FLIP_SERVER_CONTENT_STORE_H_
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/string_piece.h"
+#include "net/tools/flip_server/balsa_headers.h"
+
+namespace base {
+class FilePath;
+class MemoryMappedFile;
+}
+
+namespace net {
+
+// A read-only set of HTTP responses captured to files (e.g. with
+// `wget --save-headers`), which the flip and QUIC servers serve from.
+//
+// Capture files are mapped into memory rather than read, and response bodies
+// point straight into the mapping whenever the capture stores them verbatim,
+// so the servers can hand them to the network without copying and every
+// process serving the same content shares the same pages. The serialized
+// header block and a gzip variant of compressible bodies are computed once,
+// when the capture is loaded.
+//
+// A ContentStore is filled on one thread and may then be read from any number
+// of threads.
+class ContentStore : public base::RefCountedThreadSafe<ContentStore> {
+ public:
+  class Entry {
+   public:
+    ~Entry();
+
+    // The path the capture was stored under.
+    const std::string& path() const { return path_; }
+
+    // The captured response headers, with Content-Length set to the length of
+    // body() and no Transfer-Encoding.
+    const BalsaHeaders& headers() const { return headers_; }
+
+    // headers() serialized as an HTTP/1.1 header block, ending with the empty
+    // line.
+    const std::string& header_block() const { return header_block_; }
+
+    base::StringPiece body() const { return body_; }
+
+    // The gzip-compressed variant, if the body is compressible text that isn't
+    // content-encoded already and gets smaller. |gzip_headers()| are
+    // |headers()| with Content-Encoding and Content-Length updated to match.
+    bool has_gzip_variant() const { return !gzip_body_.empty(); }
+    const BalsaHeaders& gzip_headers() const { return gzip_headers_; }
+    const std::string& gzip_header_block() const { return gzip_header_block_; }
+    base::StringPiece gzip_body() const { return gzip_body_; }
+
+   private:
+    friend class ContentStore;
+
+    Entry();
+
+    std::string path_;
+    BalsaHeaders headers_;
+    std::string header_block_;
+    base::StringPiece body_;
+
+    BalsaHeaders gzip_headers_;
+    std::string gzip_header_block_;
+    std::string gzip_body_;
+
+    // The storage |body_| points into: the mapped capture file, or
+    // |body_copy_| when the capture had to be decoded or wasn't a file.
+    scoped_ptr<base::MemoryMappedFile> file_;
+    std::string body_copy_;
+
+    DISALLOW_COPY_AND_ASSIGN(Entry);
+  };
+
+  // Maps paths to entries.
+  typedef std::map<std::string, Entry*> Entries;
+
+  ContentStore();
+
+  // Loads every capture under |directory|, recursively, stored under its path
+  // relative to |directory|. Returns the number of captures loaded.
+  size_t LoadDirectory(const base::FilePath& directory);
+
+  // Maps the capture in |file| and stores it under |path|, replacing any
+  // previous capture there. Returns false if the capture can't be parsed.
+  bool LoadFile(const base::FilePath& file, const std::string& path);
+
+  // Like LoadFile(), but with the capture given in memory.
+  bool AddCapture(const std::string& path, const base::StringPiece& capture);
+
+  // Returns the entry stored under |path|, or NULL.
+  const Entry* GetEntry(const std::string& path) const;
+
+  const Entries& entries() const { return entries_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<ContentStore>;
+
+  ~ContentStore();
+
+  // Parses |capture| into |entry|, whose storage must outlive the entry.
+  // |copy_body| forces the body into |entry->body_copy_|.
+  static bool ParseCapture(const base::StringPiece& capture,
+                           bool copy_body,
+                           Entry* entry);
+
+  void Store(const std::string& path, scoped_ptr<Entry> entry);
+
+  Entries entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(ContentStore);
+};
+
+}  // namespace net
+
+#endif  // NET_TOOLS_FLIP_SERVER_CONTENT_STORE_H_
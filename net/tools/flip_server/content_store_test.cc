@@ -0,0 +1,161 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/flip_server/content_store.h"
+
+#include <string.h>
+
+#include <string>
+
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "net/tools/flip_server/balsa_headers.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/zlib/zlib.h"
+
+namespace net {
+
+namespace {
+
+std::string Gunzip(const base::StringPiece& input) {
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK)
+    return std::string();
+  std::string output(64 * 1024, '\0');
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+  stream.avail_in = input.size();
+  stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+  stream.avail_out = output.size();
+  int result = inflate(&stream, Z_FINISH);
+  output.resize(stream.total_out);
+  inflateEnd(&stream);
+  return result == Z_STREAM_END ? output : std::string();
+}
+
+class ContentStoreTest : public ::testing::Test {
+ public:
+  ContentStoreTest() : store_(new ContentStore) {}
+
+ protected:
+  scoped_refptr<ContentStore> store_;
+};
+
+TEST_F(ContentStoreTest, NoHeaders) {
+  EXPECT_FALSE(store_->AddCapture("foo", "bar"));
+  EXPECT_EQ(NULL, store_->GetEntry("foo"));
+}
+
+TEST_F(ContentStoreTest, ContentLength) {
+  ASSERT_TRUE(store_->AddCapture("hello", "HTTP/1.0 200 OK\r\n"
+                                          "Content-Length: 5\r\n"
+                                          "key1: value1\r\n\r\n"
+                                          "hello"));
+  const ContentStore::Entry* entry = store_->GetEntry("hello");
+  ASSERT_TRUE(entry != NULL);
+  EXPECT_EQ("hello", entry->path());
+  EXPECT_EQ("hello", entry->body());
+  EXPECT_EQ("HTTP/1.1", entry->headers().response_version());
+  EXPECT_EQ("value1", entry->headers().GetHeader("key1"));
+  EXPECT_EQ("5", entry->headers().GetHeader("content-length"));
+  const std::string& header_block = entry->header_block();
+  EXPECT_EQ(0U, header_block.find("HTTP/1.1 200 OK\r\n"));
+  EXPECT_NE(std::string::npos, header_block.find("key1: value1\r\n"));
+  EXPECT_EQ(header_block.size() - 4, header_block.find("\r\n\r\n"));
+}
+
+TEST_F(ContentStoreTest, NoContentLength) {
+  ASSERT_TRUE(store_->AddCapture("hello", "HTTP/1.1 200 OK\r\n"
+                                          "key1: value1\r\n\r\n"
+                                          "body: body\r\n"));
+  const ContentStore::Entry* entry = store_->GetEntry("hello");
+  ASSERT_TRUE(entry != NULL);
+  EXPECT_EQ("body: body\r\n", entry->body());
+  EXPECT_EQ("12", entry->headers().GetHeader("content-length"));
+}
+
+TEST_F(ContentStoreTest, Chunked) {
+  ASSERT_TRUE(store_->AddCapture("hello", "HTTP/1.1 200 OK\r\n"
+                                          "Transfer-Encoding: chunked\r\n\r\n"
+                                          "5\r\nhello\r\n"
+                                          "6\r\n world\r\n"
+                                          "0\r\n\r\n"));
+  const ContentStore::Entry* entry = store_->GetEntry("hello");
+  ASSERT_TRUE(entry != NULL);
+  EXPECT_EQ("hello world", entry->body());
+  EXPECT_FALSE(entry->headers().HasHeader("transfer-encoding"));
+  EXPECT_EQ("11", entry->headers().GetHeader("content-length"));
+}
+
+TEST_F(ContentStoreTest, ReplacesEntry) {
+  ASSERT_TRUE(store_->AddCapture("hello", "HTTP/1.1 200 OK\r\n\r\nfirst"));
+  ASSERT_TRUE(store_->AddCapture("hello", "HTTP/1.1 200 OK\r\n\r\nsecond"));
+  EXPECT_EQ(1U, store_->entries().size());
+  EXPECT_EQ("second", store_->GetEntry("hello")->body());
+}
+
+TEST_F(ContentStoreTest, GzipVariant) {
+  std::string body;
+  for (int i = 0; i < 100; ++i)
+    body += "<p>Compressible text.</p>\n";
+  ASSERT_TRUE(store_->AddCapture("index.html",
+                                 "HTTP/1.1 200 OK\r\n"
+                                 "Content-Type: text/html\r\n\r\n" + body));
+  const ContentStore::Entry* entry = store_->GetEntry("index.html");
+  ASSERT_TRUE(entry != NULL);
+  EXPECT_EQ(body, entry->body());
+  ASSERT_TRUE(entry->has_gzip_variant());
+  EXPECT_LT(entry->gzip_body().size(), body.size());
+  EXPECT_EQ(body, Gunzip(entry->gzip_body()));
+  std::string value;
+  entry->gzip_headers().GetAllOfHeaderAsString("content-encoding", &value);
+  EXPECT_EQ("gzip", value);
+  value.clear();
+  entry->gzip_headers().GetAllOfHeaderAsString("vary", &value);
+  EXPECT_EQ("accept-encoding", value);
+  EXPECT_FALSE(entry->headers().HasHeader("content-encoding"));
+}
+
+TEST_F(ContentStoreTest, NoGzipVariant) {
+  std::string body(1000, 'x');
+  ASSERT_TRUE(store_->AddCapture("image.png",
+                                 "HTTP/1.1 200 OK\r\n"
+                                 "Content-Type: image/png\r\n\r\n" + body));
+  EXPECT_FALSE(store_->GetEntry("image.png")->has_gzip_variant());
+
+  ASSERT_TRUE(store_->AddCapture("encoded.html",
+                                 "HTTP/1.1 200 OK\r\n"
+                                 "Content-Type: text/html\r\n"
+                                 "Content-Encoding: deflate\r\n\r\n" + body));
+  EXPECT_FALSE(store_->GetEntry("encoded.html")->has_gzip_variant());
+
+  // Too short to get any smaller.
+  ASSERT_TRUE(store_->AddCapture("short.html",
+                                 "HTTP/1.1 200 OK\r\n"
+                                 "Content-Type: text/html\r\n\r\nhi"));
+  EXPECT_FALSE(store_->GetEntry("short.html")->has_gzip_variant());
+}
+
+TEST_F(ContentStoreTest, LoadDirectory) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const char kCapture[] = "HTTP/1.1 200 OK\r\n"
+                          "Content-Length: 5\r\n\r\n"
+                          "hello";
+  base::FilePath file = temp_dir.path().AppendASCII("hello");
+  ASSERT_EQ(static_cast<int>(strlen(kCapture)),
+            file_util::WriteFile(file, kCapture, strlen(kCapture)));
+  base::FilePath broken = temp_dir.path().AppendASCII("broken");
+  ASSERT_EQ(3, file_util::WriteFile(broken, "bar", 3));
+
+  EXPECT_EQ(1U, store_->LoadDirectory(temp_dir.path()));
+  const ContentStore::Entry* entry = store_->GetEntry("hello");
+  ASSERT_TRUE(entry != NULL);
+  EXPECT_EQ("hello", entry->body());
+  EXPECT_EQ(NULL, store_->GetEntry("broken"));
+}
+
+}  // namespace
+
+}  // namespace net
@@ -317,6 +317,44 @@ void HttpSM::SendDataFrameImpl(uint32 stream_id, const char* data, int64 len,
   EnqueueDataFrame(df);
 }
 
+size_t HttpSM::SendCachedHeaderBlock(const std::string& header_block) {
+  DataFrame* df = new DataFrame;
+  df->data = header_block.data();
+  df->size = header_block.size();
+  df->delete_when_done = false;
+  VLOG(2) << ACCEPTOR_CLIENT_IDENT << "Sending cached HTTP Reply header "
+          << stream_id_;
+  EnqueueDataFrame(df);
+  return header_block.size();
+}
+
+void HttpSM::SendCachedDataFrame(const char* data, size_t len) {
+  // The chunk framing goes in frames of its own so that the body can be sent
+  // from the cache as it is; the connection sends them with MSG_MORE.
+  char chunk_buf[32];
+  int chunk_len = snprintf(chunk_buf, sizeof(chunk_buf), "%x\r\n",
+                           static_cast<unsigned int>(len));
+  DataFrame* df = new DataFrame;
+  char* buffer = new char[chunk_len];
+  memcpy(buffer, chunk_buf, chunk_len);
+  df->data = buffer;
+  df->size = chunk_len;
+  df->delete_when_done = true;
+  EnqueueDataFrame(df);
+
+  df = new DataFrame;
+  df->data = data;
+  df->size = len;
+  df->delete_when_done = false;
+  EnqueueDataFrame(df);
+
+  df = new DataFrame;
+  df->data = "\r\n";
+  df->size = 2;
+  df->delete_when_done = false;
+  EnqueueDataFrame(df);
+}
+
 void HttpSM::EnqueueDataFrame(DataFrame* df) {
   VLOG(2) << ACCEPTOR_CLIENT_IDENT << "HttpSM: Enqueue data frame: stream "
           << stream_id_;
@@ -331,8 +369,7 @@ void HttpSM::GetOutput() {
     return;
   }
   if (!mci->transformed_header) {
-    mci->bytes_sent = SendSynReply(mci->stream_id,
-                                   *(mci->file_data->headers()));
+    mci->bytes_sent = SendCachedHeaderBlock(mci->file_data->header_block());
     mci->transformed_header = true;
     VLOG(2) << ACCEPTOR_CLIENT_IDENT << "HttpSM: GetOutput transformed "
             << "header stream_id: [" << mci->stream_id << "]";
@@ -350,9 +387,8 @@ void HttpSM::GetOutput() {
   if (num_to_write > mci->max_segment_size)
     num_to_write = mci->max_segment_size;
 
-  SendDataFrame(mci->stream_id,
-                mci->file_data->body().data() + mci->body_bytes_consumed,
-                num_to_write, 0, true);
+  SendCachedDataFrame(mci->file_data->body().data() + mci->body_bytes_consumed,
+                      num_to_write);
   VLOG(2) << ACCEPTOR_CLIENT_IDENT << "HttpSM: GetOutput SendDataFrame["
           << mci->stream_id << "]: " << num_to_write;
   mci->body_bytes_consumed += num_to_write;
@@ -115,6 +115,10 @@ class HttpSM : public BalsaVisitorInterface,
   size_t SendSynStreamImpl(uint32 stream_id, const BalsaHeaders& headers);
   void SendDataFrameImpl(uint32 stream_id, const char* data, int64 len,
                          uint32 flags, bool compress);
+  // Like SendSynReplyImpl() and SendDataFrameImpl(), for data that lives as
+  // long as the MemoryCache and so is queued without being copied.
+  size_t SendCachedHeaderBlock(const std::string& header_block);
+  void SendCachedDataFrame(const char* data, size_t len);
   void EnqueueDataFrame(DataFrame* df);
   virtual void GetOutput() OVERRIDE;
 
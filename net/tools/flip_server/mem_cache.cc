@@ -5,22 +5,20 @@
 #include "net/tools/flip_server/mem_cache.h"
 
 #include <dirent.h>
-#include <errno.h>
-#include <fcntl.h>
 #include <stdio.h>
 #include <sys/stat.h>
 #include <sys/types.h>
-#include <unistd.h>
 
 #include <deque>
 #include <map>
 #include <string>
 
+#include "base/files/file_path.h"
 #include "base/strings/string_util.h"
 #include "net/tools/dump_cache/url_to_filename_encoder.h"
 #include "net/tools/dump_cache/url_utilities.h"
-#include "net/tools/flip_server/balsa_frame.h"
 #include "net/tools/flip_server/balsa_headers.h"
+#include "net/tools/flip_server/simple_buffer.h"
 
 namespace {
 // The directory where cache locates);
@@ -29,35 +27,17 @@ const char FLAGS_cache_base_dir[] = ".";
 
 namespace net {
 
-void StoreBodyAndHeadersVisitor::ProcessBodyData(const char *input,
-                                                 size_t size) {
-  body.append(input, size);
-}
-
-void StoreBodyAndHeadersVisitor::HandleHeaderError(BalsaFrame* framer) {
-  HandleError();
-}
-
-void StoreBodyAndHeadersVisitor::HandleHeaderWarning(BalsaFrame* framer) {
-  HandleError();
-}
-
-void StoreBodyAndHeadersVisitor::HandleChunkingError(BalsaFrame* framer) {
-  HandleError();
-}
-
-void StoreBodyAndHeadersVisitor::HandleBodyError(BalsaFrame* framer) {
-  HandleError();
-}
-
 FileData::FileData(const BalsaHeaders* headers,
                    const std::string& filename,
-                   const std::string& body)
+                   const base::StringPiece& body)
     : filename_(filename)
     , body_(body) {
   if (headers) {
     headers_.reset(new BalsaHeaders);
     headers_->CopyFrom(*headers);
+    SimpleBuffer buffer;
+    headers_->WriteHeaderAndEndingToBuffer(&buffer);
+    header_block_ = buffer.str();
   }
 }
 
@@ -65,7 +45,9 @@ FileData::FileData() {}
 
 FileData::~FileData() {}
 
-MemoryCache::MemoryCache() : cwd_(FLAGS_cache_base_dir) {}
+MemoryCache::MemoryCache()
+    : store_(new ContentStore),
+      cwd_(FLAGS_cache_base_dir) {}
 
 MemoryCache::~MemoryCache() {
   ClearFiles();
@@ -74,7 +56,14 @@ MemoryCache::~MemoryCache() {
 void MemoryCache::CloneFrom(const MemoryCache& mc) {
   DCHECK_NE(this, &mc);
   ClearFiles();
-  files_ = mc.files_;
+  // The entries are cheap to copy, since the bodies stay in the shared store.
+  store_ = mc.store_;
+  for (Files::const_iterator it = mc.files_.begin(); it != mc.files_.end();
+       ++it) {
+    files_[it->first] = new FileData(it->second->headers(),
+                                     it->second->filename(),
+                                     it->second->body());
+  }
   cwd_ = mc.cwd_;
 }
 
@@ -122,90 +111,37 @@ void MemoryCache::AddFiles() {
   }
 }
 
-void MemoryCache::ReadToString(const char* filename, std::string* output) {
-  output->clear();
-  int fd = open(filename, 0, "r");
-  if (fd == -1)
-    return;
-  char buffer[4096];
-  ssize_t read_status = read(fd, buffer, sizeof(buffer));
-  while (read_status > 0) {
-    output->append(buffer, static_cast<size_t>(read_status));
-    do {
-      read_status = read(fd, buffer, sizeof(buffer));
-    } while (read_status <= 0 && errno == EINTR);
-  }
-  close(fd);
-}
-
 void MemoryCache::ReadAndStoreFileContents(const char* filename) {
-  StoreBodyAndHeadersVisitor visitor;
-  BalsaFrame framer;
-  framer.set_balsa_visitor(&visitor);
-  framer.set_balsa_headers(&(visitor.headers));
-  std::string filename_contents;
-  ReadToString(filename, &filename_contents);
-
-  // Ugly hack to make everything look like 1.1.
-  if (filename_contents.find("HTTP/1.0") == 0)
-    filename_contents[7] = '1';
-
-  size_t pos = 0;
-  size_t old_pos = 0;
-  while (true) {
-    old_pos = pos;
-    pos += framer.ProcessInput(filename_contents.data() + pos,
-                               filename_contents.size() - pos);
-    if (framer.Error() || pos == old_pos) {
-      LOG(ERROR) << "Unable to make forward progress, or error"
-        " framing file: " << filename;
-      if (framer.Error()) {
-        LOG(INFO) << "********************************************ERROR!";
-        return;
-      }
-      return;
-    }
-    if (framer.MessageFullyRead()) {
-      // If no Content-Length or Transfer-Encoding was captured in the
-      // file, then the rest of the data is the body.  Many of the captures
-      // from within Chrome don't have content-lengths.
-      if (!visitor.body.length())
-        visitor.body = filename_contents.substr(pos);
-      break;
-    }
-  }
-  visitor.headers.RemoveAllOfHeader("content-length");
-  visitor.headers.RemoveAllOfHeader("transfer-encoding");
-  visitor.headers.RemoveAllOfHeader("connection");
-  visitor.headers.AppendHeader("transfer-encoding", "chunked");
-  visitor.headers.AppendHeader("connection", "keep-alive");
-
-  // Experiment with changing headers for forcing use of cached
-  // versions of content.
-  // TODO(mbelshe) REMOVE ME
-#if 0
-  // TODO(mbelshe) append current date.
-  visitor.headers.RemoveAllOfHeader("date");
-  if (visitor.headers.HasHeader("expires")) {
-    visitor.headers.RemoveAllOfHeader("expires");
-    visitor.headers.AppendHeader("expires",
-                               "Fri, 30 Aug, 2019 12:00:00 GMT");
-  }
-#endif
   DCHECK_GE(std::string(filename).size(), cwd_.size() + 1);
   DCHECK_EQ(std::string(filename).substr(0, cwd_.size()), cwd_);
   DCHECK_EQ(filename[cwd_.size()], '/');
   std::string filename_stripped = std::string(filename).substr(cwd_.size() + 1);
-  LOG(INFO) << "Adding file (" << visitor.body.length() << " bytes): "
+  if (!LoadIntoStore(filename, filename_stripped)) {
+    LOG(ERROR) << "Unable to make forward progress, or error"
+      " framing file: " << filename;
+    return;
+  }
+  const ContentStore::Entry* entry = store_->GetEntry(filename_stripped);
+  DCHECK(entry);
+
+  BalsaHeaders headers;
+  headers.CopyFrom(entry->headers());
+  headers.RemoveAllOfHeader("content-length");
+  headers.RemoveAllOfHeader("transfer-encoding");
+  headers.RemoveAllOfHeader("connection");
+  headers.AppendHeader("transfer-encoding", "chunked");
+  headers.AppendHeader("connection", "keep-alive");
+
+  LOG(INFO) << "Adding file (" << entry->body().length() << " bytes): "
             << filename_stripped;
   size_t slash_pos = filename_stripped.find('/');
   if (slash_pos == std::string::npos) {
     slash_pos = filename_stripped.size();
   }
   FileData* data =
-      new FileData(&visitor.headers,
+      new FileData(&headers,
                    filename_stripped.substr(0, slash_pos),
-                   visitor.body);
+                   entry->body());
   Files::iterator it = files_.find(filename_stripped);
   if (it != files_.end()) {
     delete it->second;
@@ -239,6 +175,11 @@ bool MemoryCache::AssignFileData(const std::string& filename,
   return true;
 }
 
+bool MemoryCache::LoadIntoStore(const char* filename,
+                                const std::string& path) {
+  return store_->LoadFile(base::FilePath(filename), path);
+}
+
 void MemoryCache::ClearFiles() {
   for (Files::const_iterator i = files_.begin(); i != files_.end(); ++i) {
     delete i->second;
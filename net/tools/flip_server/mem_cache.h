@@ -9,76 +9,40 @@
 #include <string>
 
 #include "base/compiler_specific.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/strings/string_piece.h"
 #include "net/tools/flip_server/balsa_headers.h"
-#include "net/tools/flip_server/balsa_visitor_interface.h"
 #include "net/tools/flip_server/constants.h"
+#include "net/tools/flip_server/content_store.h"
 
 namespace net {
 
-class StoreBodyAndHeadersVisitor: public BalsaVisitorInterface {
- public:
-  void HandleError() { error_ = true; }
-
-  // BalsaVisitorInterface:
-  virtual void ProcessBodyInput(const char *input, size_t size) OVERRIDE {}
-  virtual void ProcessBodyData(const char *input, size_t size) OVERRIDE;
-  virtual void ProcessHeaderInput(const char *input, size_t size) OVERRIDE {}
-  virtual void ProcessTrailerInput(const char *input, size_t size) OVERRIDE {}
-  virtual void ProcessHeaders(const BalsaHeaders& headers) OVERRIDE {
-    // nothing to do here-- we're assuming that the BalsaFrame has
-    // been handed our headers.
-  }
-  virtual void ProcessRequestFirstLine(const char* line_input,
-                                       size_t line_length,
-                                       const char* method_input,
-                                       size_t method_length,
-                                       const char* request_uri_input,
-                                       size_t request_uri_length,
-                                       const char* version_input,
-                                       size_t version_length) OVERRIDE {}
-  virtual void ProcessResponseFirstLine(const char *line_input,
-                                        size_t line_length,
-                                        const char *version_input,
-                                        size_t version_length,
-                                        const char *status_input,
-                                        size_t status_length,
-                                        const char *reason_input,
-                                        size_t reason_length) OVERRIDE {}
-  virtual void ProcessChunkLength(size_t chunk_length) OVERRIDE {}
-  virtual void ProcessChunkExtensions(const char *input,
-                                      size_t size) OVERRIDE {}
-  virtual void HeaderDone() OVERRIDE {}
-  virtual void MessageDone() OVERRIDE {}
-  virtual void HandleHeaderError(BalsaFrame* framer) OVERRIDE;
-  virtual void HandleHeaderWarning(BalsaFrame* framer) OVERRIDE;
-  virtual void HandleChunkingError(BalsaFrame* framer) OVERRIDE;
-  virtual void HandleBodyError(BalsaFrame* framer) OVERRIDE;
-
-  BalsaHeaders headers;
-  std::string body;
-  bool error_;
-};
-
 ////////////////////////////////////////////////////////////////////////////////
+// A response served from a MemoryCache. The body isn't owned: it points into
+// the ContentStore of the cache.
 class FileData {
  public:
   FileData();
   FileData(const BalsaHeaders* headers,
            const std::string& filename,
-           const std::string& body);
+           const base::StringPiece& body);
   ~FileData();
 
   BalsaHeaders* headers() { return headers_.get(); }
   const BalsaHeaders* headers() const { return headers_.get(); }
 
+  // headers() serialized for HTTP/1.1, computed once up front.
+  const std::string& header_block() const { return header_block_; }
+
   const std::string& filename() { return filename_; }
-  const std::string& body() { return body_; }
+  base::StringPiece body() const { return body_; }
 
  private:
   scoped_ptr<BalsaHeaders> headers_;
+  std::string header_block_;
   std::string filename_;
-  std::string body_;
+  base::StringPiece body_;
 
   DISALLOW_COPY_AND_ASSIGN(FileData);
 };
@@ -126,18 +90,24 @@ class MemoryCache {
 
   void AddFiles();
 
-  // virtual for unittests
-  virtual void ReadToString(const char* filename, std::string* output);
-
   void ReadAndStoreFileContents(const char* filename);
 
   FileData* GetFileData(const std::string& filename);
 
   bool AssignFileData(const std::string& filename, MemCacheIter* mci);
 
+ protected:
+  // Loads the capture in |filename| into store() under |path|. Virtual for
+  // unittests.
+  virtual bool LoadIntoStore(const char* filename, const std::string& path);
+
+  ContentStore* store() { return store_.get(); }
+
  private:
   void ClearFiles();
 
+  // Holds the bodies of |files_|. Clones of this cache share it.
+  scoped_refptr<ContentStore> store_;
   Files files_;
   std::string cwd_;
 };
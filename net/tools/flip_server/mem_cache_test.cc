@@ -15,9 +15,9 @@ class MemoryCacheWithFakeReadToString : public MemoryCache {
  public:
   virtual ~MemoryCacheWithFakeReadToString() {}
 
-  virtual void ReadToString(const char* filename, std::string* output)
-      OVERRIDE {
-    *output = data_map_[filename];
+  virtual bool LoadIntoStore(const char* filename,
+                             const std::string& path) OVERRIDE {
+    return store()->AddCapture(path, data_map_[filename]);
   }
 
   std::map<std::string, std::string> data_map_;
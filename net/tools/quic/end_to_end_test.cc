@@ -3,13 +3,16 @@
 // found in the LICENSE file.
 
 #include <stddef.h>
+#include <algorithm>
 #include <string>
 
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/memory/singleton.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/threading/simple_thread.h"
+#include "base/time/time.h"
 #include "net/base/ip_endpoint.h"
 #include "net/quic/crypto/aes_128_gcm_12_encrypter.h"
 #include "net/quic/crypto/null_encrypter.h"
@@ -96,6 +99,9 @@ class ServerThread : public base::SimpleThread {
   WaitableEvent* listening() { return &listening_; }
   WaitableEvent* quit() { return &quit_; }
 
+  // Only to be configured before the thread is started.
+  QuicServer* server() { return &server_; }
+
  private:
   WaitableEvent listening_;
   WaitableEvent quit_;
@@ -116,7 +122,9 @@ class EndToEndTest : public ::testing::TestWithParam<QuicVersion> {
  protected:
   EndToEndTest()
       : server_hostname_("example.com"),
-        server_started_(false) {
+        server_started_(false),
+        server_batches_packets_(true),
+        server_num_threads_(1) {
     net::IPAddressNumber ip;
     CHECK(net::ParseIPLiteralToNumber("127.0.0.1", &ip));
     server_address_ = IPEndPoint(ip, 0);
@@ -155,6 +163,12 @@ class EndToEndTest : public ::testing::TestWithParam<QuicVersion> {
 
   void StartServer() {
     server_thread_.reset(new ServerThread(server_address_, server_config_));
+    server_thread_->server()->set_num_dispatcher_threads(
+        server_num_threads_);
+    if (!server_batches_packets_) {
+      server_thread_->server()->set_use_recvmmsg(false);
+      server_thread_->server()->set_use_sendmmsg(false);
+    }
     server_thread_->Start();
     server_thread_->listening()->Wait();
     server_address_ = IPEndPoint(server_address_.address(),
@@ -207,6 +221,10 @@ class EndToEndTest : public ::testing::TestWithParam<QuicVersion> {
   scoped_ptr<ServerThread> server_thread_;
   scoped_ptr<QuicTestClient> client_;
   bool server_started_;
+  // If false, the server reads and writes one packet per system call.
+  bool server_batches_packets_;
+  // The number of threads handling connections on the server.
+  int server_num_threads_;
   QuicConfig client_config_;
   QuicConfig server_config_;
   QuicVersion version_;
@@ -322,6 +340,27 @@ TEST_P(EndToEndTest, MultipleClients) {
   EXPECT_EQ(200u, client2->response_headers()->parsed_response_code());
 }
 
+TEST_P(EndToEndTest, MultipleClientsShardedServer) {
+  // TODO(rtenneti): Delete this when NSS is supported.
+  if (!Aes128Gcm12Encrypter::IsSupported()) {
+    LOG(INFO) << "AES GCM not supported. Test skipped.";
+    return;
+  }
+
+  server_num_threads_ = 4;
+  ASSERT_TRUE(Initialize());
+
+  // With random GUIDs, the clients most likely land on different threads.
+  ScopedVector<QuicTestClient> clients;
+  for (int i = 0; i < 8; ++i)
+    clients.push_back(CreateQuicClient());
+  for (size_t i = 0; i < clients.size(); ++i) {
+    EXPECT_EQ(kFooResponseBody, clients[i]->SendSynchronousRequest("/foo"));
+    EXPECT_EQ(200u, clients[i]->response_headers()->parsed_response_code());
+  }
+  EXPECT_EQ(kBarResponseBody, client_->SendSynchronousRequest("/bar"));
+}
+
 TEST_P(EndToEndTest, RequestOverMultiplePackets) {
   // TODO(rtenneti): Delete this when NSS is supported.
   if (!Aes128Gcm12Encrypter::IsSupported()) {
@@ -645,6 +684,44 @@ TEST_P(EndToEndTest, ConnectionMigration) {
   EXPECT_EQ(QUIC_ERROR_MIGRATING_ADDRESS, client_->connection_error());
 }
 
+// Measures how fast the server sends large responses with and without
+// recvmmsg() and sendmmsg().
+TEST_P(EndToEndTest, BatchedPacketsThroughput) {
+  // TODO(rtenneti): Delete this when NSS is supported.
+  if (!Aes128Gcm12Encrypter::IsSupported()) {
+    LOG(INFO) << "AES GCM not supported. Test skipped.";
+    return;
+  }
+
+  const int kBodySize = 1024 * 1024;
+  const int kNumRequests = 10;
+  string body;
+  GenerateBody(&body, kBodySize);
+  AddToCache("GET", "https://www.google.com/large",
+             "HTTP/1.1", "200", "OK", body);
+
+  for (int batched = 0; batched < 2; ++batched) {
+    server_batches_packets_ = batched != 0;
+    server_address_ = IPEndPoint(server_address_.address(), 0);
+    ASSERT_TRUE(Initialize());
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (int i = 0; i < kNumRequests; ++i) {
+      EXPECT_EQ(body, client_->SendSynchronousRequest("/large"));
+      EXPECT_EQ(200u, client_->response_headers()->parsed_response_code());
+    }
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+    LOG(INFO) << (batched ? "Batched" : "Unbatched") << " throughput: "
+              << kBodySize * kNumRequests / 1024 /
+                     std::max(elapsed.InMillisecondsF(), 1.0)
+              << " KB/ms";
+
+    client_.reset();
+    StopServer();
+    server_thread_.reset();
+  }
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace tools
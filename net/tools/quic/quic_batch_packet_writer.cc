@@ -0,0 +1,207 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_batch_packet_writer.h"
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#include "base/logging.h"
+#include "net/tools/quic/quic_socket_utils.h"
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+namespace net {
+namespace tools {
+
+namespace {
+
+// The kernel limits a segmented message to 64 segments, and to the size of
+// a single UDP datagram.
+const size_t kMaxSegments = 64;
+const size_t kMaxSegmentedMessageSize = 65507;
+
+#if MMSG_MORE
+const size_t kSpaceForSegmentSize = CMSG_SPACE(sizeof(uint16));
+#endif
+
+}  // namespace
+
+QuicBatchPacketWriter::BufferedPacket::BufferedPacket(
+    const char* buffer,
+    size_t buf_len,
+    const IPAddressNumber& self_address,
+    const IPEndPoint& peer_address)
+    : data(buffer, buf_len),
+      self_address(self_address),
+      peer_address(peer_address) {
+}
+
+QuicBatchPacketWriter::BufferedPacket::~BufferedPacket() {
+}
+
+QuicBatchPacketWriter::QuicBatchPacketWriter(int fd)
+    : fd_(fd),
+      use_segmentation_offload_(false) {
+}
+
+QuicBatchPacketWriter::~QuicBatchPacketWriter() {
+  if (!packets_.empty())
+    DLOG(WARNING) << "Dropping " << packets_.size() << " unsent packets.";
+}
+
+int QuicBatchPacketWriter::WritePacket(
+    const char* buffer, size_t buf_len,
+    const IPAddressNumber& self_address,
+    const IPEndPoint& peer_address,
+    QuicBlockedWriterInterface* blocked_writer,
+    int* error) {
+  if (packets_.size() >= kMaxBatchSize && !Flush(error))
+    return -1;
+
+  packets_.push_back(
+      BufferedPacket(buffer, buf_len, self_address, peer_address));
+  *error = 0;
+  return buf_len;
+}
+
+bool QuicBatchPacketWriter::Flush(int* error) {
+  while (!packets_.empty()) {
+    int packets_sent = SendBatch(error);
+    if (packets_sent >= 0) {
+      packets_.erase(packets_.begin(), packets_.begin() + packets_sent);
+      continue;
+    }
+
+    if (*error == EAGAIN || *error == EWOULDBLOCK)
+      return false;
+    if (use_segmentation_offload_ && (*error == EINVAL || *error == EIO)) {
+      LOG(WARNING) << "UDP_SEGMENT not supported: " << strerror(*error);
+      use_segmentation_offload_ = false;
+      continue;
+    }
+    DLOG(WARNING) << "Dropping packet: " << strerror(*error);
+    packets_.pop_front();
+  }
+  *error = 0;
+  return true;
+}
+
+size_t QuicBatchPacketWriter::GetSegmentCount(size_t start) const {
+  if (!use_segmentation_offload_)
+    return 1;
+
+  // All segments but the last must have the size of the first one.
+  const BufferedPacket& first = packets_[start];
+  size_t segment_size = first.data.size();
+  size_t total_size = segment_size;
+  size_t count = 1;
+  for (size_t i = start + 1; i < packets_.size() && count < kMaxSegments;
+       ++i) {
+    const BufferedPacket& packet = packets_[i];
+    if (packet.data.size() > segment_size ||
+        total_size + packet.data.size() > kMaxSegmentedMessageSize ||
+        !(packet.peer_address == first.peer_address) ||
+        packet.self_address != first.self_address) {
+      break;
+    }
+    total_size += packet.data.size();
+    ++count;
+    if (packet.data.size() < segment_size)
+      break;
+  }
+  return count;
+}
+
+int QuicBatchPacketWriter::SendBatch(int* error) {
+  DCHECK(!packets_.empty());
+  DCHECK_LE(packets_.size(), kMaxBatchSize);
+#if MMSG_MORE
+  mmsghdr hdrs[kMaxBatchSize];
+  sockaddr_storage raw_addresses[kMaxBatchSize];
+  char cbufs[kMaxBatchSize]
+            [QuicSocketUtils::kSpaceForIp + kSpaceForSegmentSize];
+  iovec iovs[kMaxBatchSize];
+  size_t packet_counts[kMaxBatchSize];
+
+  size_t num_messages = 0;
+  for (size_t start = 0; start < packets_.size();
+       start += packet_counts[num_messages++]) {
+    const BufferedPacket& first = packets_[start];
+    size_t count = GetSegmentCount(start);
+    packet_counts[num_messages] = count;
+    for (size_t i = 0; i < count; ++i) {
+      std::string* data = &packets_[start + i].data;
+      iovs[start + i].iov_base = &(*data)[0];
+      iovs[start + i].iov_len = data->size();
+    }
+
+    msghdr* hdr = &hdrs[num_messages].msg_hdr;
+    memset(hdr, 0, sizeof(*hdr));
+    socklen_t address_len = sizeof(raw_addresses[num_messages]);
+    CHECK(first.peer_address.ToSockAddr(
+        reinterpret_cast<sockaddr*>(&raw_addresses[num_messages]),
+        &address_len));
+    hdr->msg_name = &raw_addresses[num_messages];
+    hdr->msg_namelen = address_len;
+    hdr->msg_iov = &iovs[start];
+    hdr->msg_iovlen = count;
+
+    if (first.self_address.empty() && count == 1)
+      continue;
+    char* cbuf = cbufs[num_messages];
+    memset(cbuf, 0, sizeof(cbufs[num_messages]));
+    hdr->msg_control = cbuf;
+    hdr->msg_controllen = sizeof(cbufs[num_messages]);
+    cmsghdr* cmsg = CMSG_FIRSTHDR(hdr);
+    size_t control_len = 0;
+    if (!first.self_address.empty()) {
+      control_len += QuicSocketUtils::SetIpInfoInCmsg(first.self_address,
+                                                      cmsg);
+      cmsg = CMSG_NXTHDR(hdr, cmsg);
+    }
+    if (count > 1) {
+      cmsg->cmsg_len = CMSG_LEN(sizeof(uint16));
+      cmsg->cmsg_level = SOL_UDP;
+      cmsg->cmsg_type = UDP_SEGMENT;
+      uint16 segment_size = first.data.size();
+      memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+      control_len += kSpaceForSegmentSize;
+    }
+    hdr->msg_controllen = control_len;
+  }
+
+  int rc = sendmmsg(fd_, hdrs, num_messages, 0);
+  if (rc < 0) {
+    *error = errno;
+    return -1;
+  }
+  size_t packets_sent = 0;
+  for (int i = 0; i < rc; ++i)
+    packets_sent += packet_counts[i];
+  return packets_sent;
+#else
+  size_t packets_sent = 0;
+  for (; packets_sent < packets_.size(); ++packets_sent) {
+    const BufferedPacket& packet = packets_[packets_sent];
+    if (QuicSocketUtils::WritePacket(fd_, packet.data.data(),
+                                     packet.data.size(), packet.self_address,
+                                     packet.peer_address, error) < 0) {
+      break;
+    }
+  }
+  return packets_sent > 0 ? static_cast<int>(packets_sent) : -1;
+#endif
+}
+
+}  // namespace tools
+}  // namespace net
@@ -0,0 +1,91 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_TOOLS_QUIC_QUIC_BATCH_PACKET_WRITER_H_
+#define NET_TOOLS_QUIC_QUIC_BATCH_PACKET_WRITER_H_
+
+#include <deque>
+#include <string>
+
+#include "base/basictypes.h"
+#include "net/base/ip_endpoint.h"
+#include "net/tools/quic/quic_packet_writer.h"
+
+namespace net {
+namespace tools {
+
+// A QuicPacketWriter which holds on to the packets written to it and sends
+// them together with a single sendmmsg() call when Flush() is called, or
+// when the batch is full. Optionally, consecutive packets of the same size
+// going to the same peer are sent as a single UDP_SEGMENT message, which
+// the kernel splits into datagrams, saving the per packet cost in the
+// network stack too.
+//
+// The writer does not manage blocked writers: a write into a full batch
+// that cannot be flushed fails with EAGAIN, and the caller is expected to
+// retry once the socket is writable, as with QuicSocketUtils::WritePacket.
+class QuicBatchPacketWriter : public QuicPacketWriter {
+ public:
+  // The largest number of packets held before they are flushed.
+  static const size_t kMaxBatchSize = 32;
+
+  explicit QuicBatchPacketWriter(int fd);
+  virtual ~QuicBatchPacketWriter();
+
+  // QuicPacketWriter. Copies the packet into the batch and returns
+  // |buf_len|. |blocked_writer| is unused.
+  virtual int WritePacket(const char* buffer, size_t buf_len,
+                          const IPAddressNumber& self_address,
+                          const IPEndPoint& peer_address,
+                          QuicBlockedWriterInterface* blocked_writer,
+                          int* error) OVERRIDE;
+
+  // Sends the buffered packets. Returns true if the batch is now empty.
+  // Returns false and sets |error| if the socket is write blocked, keeping
+  // the packets that were not sent. Packets the kernel rejects for any
+  // other reason are dropped, as they would be by the network.
+  bool Flush(int* error);
+
+  size_t num_buffered_packets() const { return packets_.size(); }
+
+  // Sends runs of same size packets to the same peer as one segmented
+  // message. Needs a kernel with UDP_SEGMENT support; if the kernel rejects
+  // it, the writer goes back to one message per packet.
+  void set_use_segmentation_offload(bool use_segmentation_offload) {
+    use_segmentation_offload_ = use_segmentation_offload;
+  }
+  bool use_segmentation_offload() const { return use_segmentation_offload_; }
+
+ private:
+  struct BufferedPacket {
+    BufferedPacket(const char* buffer,
+                   size_t buf_len,
+                   const IPAddressNumber& self_address,
+                   const IPEndPoint& peer_address);
+    ~BufferedPacket();
+
+    std::string data;
+    IPAddressNumber self_address;
+    IPEndPoint peer_address;
+  };
+
+  // Returns the number of packets from |packets_[start]| that can go in a
+  // single segmented message.
+  size_t GetSegmentCount(size_t start) const;
+
+  // Sends |packets_| with one sendmmsg() call. Returns the number of
+  // packets sent, or -1 and sets |error|.
+  int SendBatch(int* error);
+
+  int fd_;
+  bool use_segmentation_offload_;
+  std::deque<BufferedPacket> packets_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicBatchPacketWriter);
+};
+
+}  // namespace tools
+}  // namespace net
+
+#endif  // NET_TOOLS_QUIC_QUIC_BATCH_PACKET_WRITER_H_
@@ -0,0 +1,141 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_batch_packet_writer.h"
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "base/logging.h"
+#include "net/base/net_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using std::string;
+
+namespace net {
+namespace tools {
+namespace test {
+namespace {
+
+// Binds a non-blocking UDP socket to a loopback port and returns it.
+int CreateBoundSocket(IPEndPoint* address) {
+  int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_UDP);
+  CHECK_GE(fd, 0);
+
+  IPAddressNumber ip;
+  CHECK(ParseIPLiteralToNumber("127.0.0.1", &ip));
+  SockaddrStorage bind_storage;
+  CHECK(IPEndPoint(ip, 0).ToSockAddr(bind_storage.addr,
+                                     &bind_storage.addr_len));
+  CHECK_EQ(0, bind(fd, bind_storage.addr, bind_storage.addr_len));
+
+  SockaddrStorage storage;
+  CHECK_EQ(0, getsockname(fd, storage.addr, &storage.addr_len));
+  CHECK(address->FromSockAddr(storage.addr, storage.addr_len));
+  return fd;
+}
+
+class QuicBatchPacketWriterTest : public ::testing::Test {
+ protected:
+  QuicBatchPacketWriterTest() {
+    write_fd_ = CreateBoundSocket(&write_address_);
+    read_fd_ = CreateBoundSocket(&read_address_);
+  }
+
+  virtual ~QuicBatchPacketWriterTest() {
+    close(write_fd_);
+    close(read_fd_);
+  }
+
+  // Returns the next datagram, or an empty string if there is none.
+  string ReadPacket() {
+    char buf[2048];
+    int rc = recv(read_fd_, buf, sizeof(buf), 0);
+    if (rc < 0) {
+      EXPECT_TRUE(errno == EAGAIN || errno == EWOULDBLOCK);
+      return string();
+    }
+    return string(buf, rc);
+  }
+
+  // Writes |num_packets| packets of |size| bytes each, tagged with their
+  // number in the first byte.
+  void WritePackets(QuicBatchPacketWriter* writer,
+                    int num_packets,
+                    size_t size) {
+    for (int i = 0; i < num_packets; ++i) {
+      string packet(size, 'a' + i % 26);
+      int error = 0;
+      EXPECT_EQ(static_cast<int>(size),
+                writer->WritePacket(packet.data(), packet.size(),
+                                    IPAddressNumber(), read_address_, NULL,
+                                    &error));
+      EXPECT_EQ(0, error);
+    }
+  }
+
+  void ExpectPackets(int num_packets, size_t size) {
+    for (int i = 0; i < num_packets; ++i)
+      EXPECT_EQ(string(size, 'a' + i % 26), ReadPacket()) << i;
+    EXPECT_EQ("", ReadPacket());
+  }
+
+  int write_fd_;
+  int read_fd_;
+  IPEndPoint write_address_;
+  IPEndPoint read_address_;
+};
+
+TEST_F(QuicBatchPacketWriterTest, PacketsWaitForFlush) {
+  QuicBatchPacketWriter writer(write_fd_);
+  WritePackets(&writer, 5, 100);
+  EXPECT_EQ(5u, writer.num_buffered_packets());
+  EXPECT_EQ("", ReadPacket());
+
+  int error = -1;
+  EXPECT_TRUE(writer.Flush(&error));
+  EXPECT_EQ(0, error);
+  EXPECT_EQ(0u, writer.num_buffered_packets());
+  ExpectPackets(5, 100);
+}
+
+TEST_F(QuicBatchPacketWriterTest, FullBatchIsFlushed) {
+  QuicBatchPacketWriter writer(write_fd_);
+  const int kNumPackets = QuicBatchPacketWriter::kMaxBatchSize + 3;
+  WritePackets(&writer, kNumPackets, 100);
+  EXPECT_EQ(3u, writer.num_buffered_packets());
+
+  int error = -1;
+  EXPECT_TRUE(writer.Flush(&error));
+  ExpectPackets(kNumPackets, 100);
+}
+
+// With segmentation offload the peer still gets one datagram per packet,
+// whether or not the kernel supports it.
+TEST_F(QuicBatchPacketWriterTest, SegmentationOffload) {
+  QuicBatchPacketWriter writer(write_fd_);
+  writer.set_use_segmentation_offload(true);
+  WritePackets(&writer, 10, 1000);
+
+  // A shorter packet ends a run of segments.
+  string last_packet(10, 'z');
+  int error = 0;
+  writer.WritePacket(last_packet.data(), last_packet.size(),
+                     IPAddressNumber(), read_address_, NULL, &error);
+
+  EXPECT_TRUE(writer.Flush(&error));
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(string(1000, 'a' + i), ReadPacket()) << i;
+  EXPECT_EQ(last_packet, ReadPacket());
+  EXPECT_EQ("", ReadPacket());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace tools
+}  // namespace net
@@ -64,9 +64,15 @@ int QuicDispatcher::WritePacket(const char* buffer, size_t buf_len,
     return -1;
   }
 
-  int rc = QuicSocketUtils::WritePacket(fd_, buffer, buf_len,
-                                        self_address, peer_address,
-                                        error);
+  int rc;
+  if (batch_writer_.get()) {
+    rc = batch_writer_->WritePacket(buffer, buf_len, self_address,
+                                    peer_address, writer, error);
+  } else {
+    rc = QuicSocketUtils::WritePacket(fd_, buffer, buf_len,
+                                      self_address, peer_address,
+                                      error);
+  }
   if (rc == -1 && (*error == EWOULDBLOCK || *error == EAGAIN)) {
     write_blocked_list_.AddBlockedObject(writer);
     write_blocked_ = true;
@@ -128,6 +134,12 @@ bool QuicDispatcher::OnCanWrite() {
   // We got an EPOLLOUT: the socket should not be blocked.
   write_blocked_ = false;
 
+  // Packets left over from the last batch go before anything new.
+  FlushWrites();
+  if (write_blocked_) {
+    return false;
+  }
+
   // Give each writer one attempt to write.
   int num_writers = write_blocked_list_.NumObjects();
   for (int i = 0; i < num_writers; ++i) {
@@ -150,6 +162,11 @@ bool QuicDispatcher::OnCanWrite() {
     }
   }
 
+  FlushWrites();
+  if (write_blocked_) {
+    return false;
+  }
+
   // We're not write blocked.  Return true if there's more work to do.
   return !write_blocked_list_.IsEmpty();
 }
@@ -164,6 +181,32 @@ void QuicDispatcher::Shutdown() {
   DeleteSessions();
 }
 
+void QuicDispatcher::EnableBatchWrites(bool use_segmentation_offload) {
+  batch_writer_.reset(new QuicBatchPacketWriter(fd_));
+  batch_writer_->set_use_segmentation_offload(use_segmentation_offload);
+}
+
+void QuicDispatcher::FlushWrites() {
+  if (!batch_writer_.get() || write_blocked_) {
+    return;
+  }
+  int error;
+  if (!batch_writer_->Flush(&error)) {
+    // OnCanWrite() flushes the rest.
+    write_blocked_ = true;
+  }
+}
+
+void QuicDispatcher::set_fd(int fd) {
+  fd_ = fd;
+  if (batch_writer_.get()) {
+    DCHECK_EQ(0u, batch_writer_->num_buffered_packets());
+    bool use_segmentation_offload =
+        batch_writer_->use_segmentation_offload();
+    EnableBatchWrites(use_segmentation_offload);
+  }
+}
+
 void QuicDispatcher::OnConnectionClose(QuicGuid guid, QuicErrorCode error) {
   SessionMap::iterator it = session_map_.find(guid);
   if (it == session_map_.end()) {
@@ -16,6 +16,7 @@
 #include "net/quic/quic_blocked_writer_interface.h"
 #include "net/quic/quic_protocol.h"
 #include "net/tools/flip_server/epoll_server.h"
+#include "net/tools/quic/quic_batch_packet_writer.h"
 #include "net/tools/quic/quic_packet_writer.h"
 #include "net/tools/quic/quic_server_session.h"
 #include "net/tools/quic/quic_time_wait_list_manager.h"
@@ -77,13 +78,22 @@ class QuicDispatcher : public QuicPacketWriter, public QuicSessionOwner {
   virtual bool OnCanWrite();
 
   // Sends ConnectionClose frames to all connected clients.
-  void Shutdown();
+  virtual void Shutdown();
+
+  // Buffers the packets written by the sessions and sends them in batches
+  // with a QuicBatchPacketWriter. FlushWrites() must then be called once
+  // the incoming events have been handled.
+  virtual void EnableBatchWrites(bool use_segmentation_offload);
+
+  // Sends the packets buffered since the last call. If the socket is write
+  // blocked, the rest are sent from OnCanWrite().
+  virtual void FlushWrites();
 
   // Ensure that the closed connection is cleaned up asynchronously.
   virtual void OnConnectionClose(QuicGuid guid, QuicErrorCode error) OVERRIDE;
 
   int fd() { return fd_; }
-  void set_fd(int fd) { fd_ = fd; }
+  void set_fd(int fd);
 
   typedef base::hash_map<QuicGuid, QuicSession*> SessionMap;
 
@@ -134,6 +144,9 @@ class QuicDispatcher : public QuicPacketWriter, public QuicSessionOwner {
   // The connection for client-server communication
   int fd_;
 
+  // Batches writes to |fd_|, if enabled.
+  scoped_ptr<QuicBatchPacketWriter> batch_writer_;
+
   // True if the session is write blocked due to the socket returning EAGAIN.
   // False if we have gotten a call to OnCanWrite after the last failed write.
   bool write_blocked_;
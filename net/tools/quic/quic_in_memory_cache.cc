@@ -4,9 +4,9 @@
 
 #include "net/tools/quic/quic_in_memory_cache.h"
 
-#include "base/file_util.h"
-#include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
 #include "base/stl_util.h"
+#include "base/strings/string_util.h"
 
 using base::FilePath;
 using base::StringPiece;
@@ -23,60 +23,17 @@ std::string FLAGS_quic_in_memory_cache_dir = "/tmp/quic-data";
 
 namespace {
 
-// BalsaVisitor implementation (glue) which caches response bodies.
-class CachingBalsaVisitor : public BalsaVisitorInterface {
- public:
-  CachingBalsaVisitor() : done_framing_(false) {}
-  virtual void ProcessBodyData(const char* input, size_t size) OVERRIDE {
-    AppendToBody(input, size);
-  }
-  virtual void ProcessTrailers(const BalsaHeaders& trailer) {
-    LOG(DFATAL) << "Trailers not supported.";
-  }
-  virtual void MessageDone() OVERRIDE {
-    done_framing_ = true;
-  }
-  virtual void HandleHeaderError(BalsaFrame* framer) OVERRIDE {
-    UnhandledError();
-  }
-  virtual void HandleHeaderWarning(BalsaFrame* framer) OVERRIDE {
-    UnhandledError();
-  }
-  virtual void HandleTrailerError(BalsaFrame* framer) { UnhandledError(); }
-  virtual void HandleTrailerWarning(BalsaFrame* framer) { UnhandledError(); }
-  virtual void HandleChunkingError(BalsaFrame* framer) OVERRIDE {
-    UnhandledError();
-  }
-  virtual void HandleBodyError(BalsaFrame* framer) OVERRIDE {
-    UnhandledError();
-  }
-  void UnhandledError() {
-    LOG(DFATAL) << "Unhandled error framing HTTP.";
-  }
-  virtual void ProcessBodyInput(const char*, size_t) OVERRIDE {}
-  virtual void ProcessHeaderInput(const char*, size_t) OVERRIDE {}
-  virtual void ProcessTrailerInput(const char*, size_t) OVERRIDE {}
-  virtual void ProcessHeaders(const net::BalsaHeaders&) OVERRIDE {}
-  virtual void ProcessRequestFirstLine(
-      const char*, size_t, const char*, size_t,
-      const char*, size_t, const char*, size_t) OVERRIDE {}
-  virtual void ProcessResponseFirstLine(
-      const char*, size_t, const char*,
-      size_t, const char*, size_t, const char*, size_t) OVERRIDE {}
-  virtual void ProcessChunkLength(size_t) OVERRIDE {}
-  virtual void ProcessChunkExtensions(const char*, size_t) OVERRIDE {}
-  virtual void HeaderDone() OVERRIDE {}
-
-  void AppendToBody(const char* input, size_t size) {
-    body_.append(input, size);
+bool AcceptsGzip(const BalsaHeaders& request_headers) {
+  for (BalsaHeaders::const_header_lines_key_iterator it =
+           request_headers.GetIteratorForKey("accept-encoding");
+       it != request_headers.header_lines_key_end(); ++it) {
+    if (StringToLowerASCII(it->second.as_string()).find("gzip") !=
+        string::npos) {
+      return true;
+    }
   }
-  bool done_framing() const { return done_framing_; }
-  const string& body() const { return body_; }
-
- private:
-  bool done_framing_;
-  string body_;
-};
+  return false;
+}
 
 }  // namespace
 
@@ -86,7 +43,16 @@ QuicInMemoryCache* QuicInMemoryCache::GetInstance() {
 
 const QuicInMemoryCache::Response* QuicInMemoryCache::GetResponse(
     const BalsaHeaders& request_headers) const {
-  ResponseMap::const_iterator it = responses_.find(GetKey(request_headers));
+  string key = GetKey(request_headers);
+  if (!gzip_responses_.empty()) {
+    if (AcceptsGzip(request_headers)) {
+      ResponseMap::const_iterator it = gzip_responses_.find(key);
+      if (it != gzip_responses_.end()) {
+        return it->second;
+      }
+    }
+  }
+  ResponseMap::const_iterator it = responses_.find(key);
   if (it == responses_.end()) {
     return NULL;
   }
@@ -108,6 +74,8 @@ void QuicInMemoryCache::AddResponse(const BalsaHeaders& request_headers,
 
 void QuicInMemoryCache::ResetForTests() {
   STLDeleteValues(&responses_);
+  STLDeleteValues(&gzip_responses_);
+  content_store_ = NULL;
   Initialize();
 }
 
@@ -125,54 +93,22 @@ void QuicInMemoryCache::Initialize() {
             << FLAGS_quic_in_memory_cache_dir;
 
   FilePath directory(FLAGS_quic_in_memory_cache_dir);
-  base::FileEnumerator file_list(directory,
-                                 true,
-                                 base::FileEnumerator::FILES);
-
-  FilePath file = file_list.Next();
-  while (!file.empty()) {
-    // Need to skip files in .svn directories
-    if (file.value().find("/.svn/") != std::string::npos) {
-      file = file_list.Next();
-      continue;
-    }
+  content_store_ = new ContentStore;
+  content_store_->LoadDirectory(directory);
 
+  const ContentStore::Entries& entries = content_store_->entries();
+  for (ContentStore::Entries::const_iterator it = entries.begin();
+       it != entries.end(); ++it) {
+    const ContentStore::Entry* entry = it->second;
     BalsaHeaders request_headers, response_headers;
+    response_headers.CopyFrom(entry->headers());
 
-    string file_contents;
-    file_util::ReadFileToString(file, &file_contents);
-
-    // Frame HTTP.
-    CachingBalsaVisitor caching_visitor;
-    BalsaFrame framer;
-    framer.set_balsa_headers(&response_headers);
-    framer.set_balsa_visitor(&caching_visitor);
-    size_t processed = 0;
-    while (processed < file_contents.length() &&
-           !caching_visitor.done_framing()) {
-      processed += framer.ProcessInput(file_contents.c_str() + processed,
-                                       file_contents.length() - processed);
-    }
-
-    string response_headers_str;
-    response_headers.DumpToString(&response_headers_str);
-    if (!caching_visitor.done_framing()) {
-      LOG(DFATAL) << "Did not frame entire message from file: " << file.value()
-                  << " (" << processed << " of " << file_contents.length()
-                  << " bytes).";
-    }
-    if (processed < file_contents.length()) {
-      // Didn't frame whole file. Assume remainder is body.
-      // This sometimes happens as a result of incompatibilities between
-      // BalsaFramer and wget's serialization of HTTP sans content-length.
-      caching_visitor.AppendToBody(file_contents.c_str() + processed,
-                                   file_contents.length() - processed);
-      processed += file_contents.length();
-    }
-
-    StringPiece base = file.value();
+    string file_name = directory.Append(entry->path()).value();
+    StringPiece base = file_name;
+    string original_url;
     if (response_headers.HasHeader("X-Original-Url")) {
-      base = response_headers.GetHeader("X-Original-Url");
+      original_url = response_headers.GetHeader("X-Original-Url").as_string();
+      base = original_url;
       response_headers.RemoveAllOfHeader("X-Original-Url");
       // Remove the protocol so that the string is of the form host + path,
       // which is parsed properly below.
@@ -195,17 +131,32 @@ void QuicInMemoryCache::Initialize() {
                                                         "HTTP/1.1");
     request_headers.ReplaceOrAppendHeader("host", host);
 
-    LOG(INFO) << "Inserting 'http://" << GetKey(request_headers)
-              << "' into QuicInMemoryCache.";
-
-    AddResponse(request_headers, response_headers, caching_visitor.body());
-
-    file = file_list.Next();
+    string key = GetKey(request_headers);
+    LOG(INFO) << "Inserting 'http://" << key << "' into QuicInMemoryCache.";
+    if (ContainsKey(responses_, key)) {
+      LOG(DFATAL) << "Response for given request already exists!";
+      delete responses_[key];
+    }
+    // The bodies stay in |content_store_|, which outlives the responses.
+    Response* response = new Response();
+    response->set_headers(response_headers);
+    response->set_body_reference(entry->body());
+    responses_[key] = response;
+
+    if (entry->has_gzip_variant()) {
+      Response* gzip_response = new Response();
+      gzip_response->set_headers(entry->gzip_headers());
+      gzip_response->headers_.RemoveAllOfHeader("X-Original-Url");
+      gzip_response->set_body_reference(entry->gzip_body());
+      delete gzip_responses_[key];
+      gzip_responses_[key] = gzip_response;
+    }
   }
 }
 
 QuicInMemoryCache::~QuicInMemoryCache() {
   STLDeleteValues(&responses_);
+  STLDeleteValues(&gzip_responses_);
 }
 
 string QuicInMemoryCache::GetKey(const BalsaHeaders& request_headers) const {
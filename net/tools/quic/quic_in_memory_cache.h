@@ -8,10 +8,12 @@
 #include <string>
 
 #include "base/containers/hash_tables.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/singleton.h"
 #include "base/strings/string_piece.h"
 #include "net/tools/flip_server/balsa_frame.h"
 #include "net/tools/flip_server/balsa_headers.h"
+#include "net/tools/flip_server/content_store.h"
 
 template <typename T> struct DefaultSingletonTraits;
 
@@ -25,6 +27,8 @@ class QuicServer;
 // In-memory cache for HTTP responses.
 // Reads from disk cache generated by:
 // `wget -p --save_headers <url>`
+// The responses read from disk are served from a ContentStore, which maps the
+// files rather than copying their bodies.
 class QuicInMemoryCache {
  public:
   // Container for response header/body pairs.
@@ -34,7 +38,7 @@ class QuicInMemoryCache {
     ~Response() {}
 
     const BalsaHeaders& headers() const { return headers_; }
-    const base::StringPiece body() const { return base::StringPiece(body_); }
+    const base::StringPiece body() const { return body_; }
 
    private:
     friend class QuicInMemoryCache;
@@ -42,12 +46,19 @@ class QuicInMemoryCache {
     void set_headers(const BalsaHeaders& headers) {
       headers_.CopyFrom(headers);
     }
+    // Copies |body| into the response.
     void set_body(base::StringPiece body) {
-      body.CopyToString(&body_);
+      body.CopyToString(&body_storage_);
+      body_ = body_storage_;
+    }
+    // Refers to |body|, which must outlive the response.
+    void set_body_reference(base::StringPiece body) {
+      body_ = body;
     }
 
     BalsaHeaders headers_;
-    std::string body_;
+    base::StringPiece body_;
+    std::string body_storage_;
 
     DISALLOW_COPY_AND_ASSIGN(Response);
   };
@@ -55,7 +66,8 @@ class QuicInMemoryCache {
 
   // Retrieve a response from this cache for a given request.
   // If no appropriate response exists, NULL is returned.
-  // Currently, responses are selected based on request URI only.
+  // Responses are selected based on request URI, and on Accept-Encoding for
+  // responses that have a gzip variant.
   const Response* GetResponse(const BalsaHeaders& request_headers) const;
 
   // Add a response to the cache.
@@ -76,8 +88,12 @@ class QuicInMemoryCache {
   void Initialize();
   std::string GetKey(const BalsaHeaders& response_headers) const;
 
-  // Cached responses.
+  // Cached responses, and the gzip variants of those that have one.
   ResponseMap responses_;
+  ResponseMap gzip_responses_;
+
+  // Holds the bodies of the responses read from disk.
+  scoped_refptr<ContentStore> content_store_;
 
   DISALLOW_COPY_AND_ASSIGN(QuicInMemoryCache);
 };
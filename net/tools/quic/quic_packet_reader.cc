@@ -0,0 +1,85 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_packet_reader.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include "base/logging.h"
+#include "net/tools/quic/quic_dispatcher.h"
+#include "net/tools/quic/quic_server.h"
+
+namespace net {
+namespace tools {
+
+QuicPacketReader::QuicPacketReader() {
+#if MMSG_MORE
+  memset(packets_, 0, sizeof(packets_));
+  memset(mmsg_hdr_, 0, sizeof(mmsg_hdr_));
+  for (int i = 0; i < kNumPacketsPerReadMmsgCall; ++i) {
+    packets_[i].iov.iov_base = packets_[i].buf;
+    packets_[i].iov.iov_len = sizeof(packets_[i].buf);
+
+    msghdr* hdr = &mmsg_hdr_[i].msg_hdr;
+    hdr->msg_name = &packets_[i].raw_address;
+    hdr->msg_iov = &packets_[i].iov;
+    hdr->msg_iovlen = 1;
+    hdr->msg_control = packets_[i].cbuf;
+  }
+  ResetHeaders();
+#endif
+}
+
+QuicPacketReader::~QuicPacketReader() {
+}
+
+bool QuicPacketReader::ReadAndDispatchPackets(int fd,
+                                              int port,
+                                              QuicDispatcher* dispatcher,
+                                              int* packets_dropped) {
+#if MMSG_MORE
+  int packets_read = recvmmsg(fd, mmsg_hdr_, kNumPacketsPerReadMmsgCall,
+                              0, NULL);
+  if (packets_read <= 0) {
+    if (packets_read < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+      LOG(ERROR) << "Error reading " << strerror(errno);
+    return false;
+  }
+
+  for (int i = 0; i < packets_read; ++i) {
+    msghdr* hdr = &mmsg_hdr_[i].msg_hdr;
+    if (packets_dropped != NULL)
+      QuicSocketUtils::GetOverflowFromMsghdr(hdr, packets_dropped);
+
+    IPEndPoint client_address;
+    QuicSocketUtils::GetPeerAddress(packets_[i].raw_address, &client_address);
+    IPEndPoint server_address(QuicSocketUtils::GetAddressFromMsghdr(hdr),
+                              port);
+    QuicEncryptedPacket packet(packets_[i].buf, mmsg_hdr_[i].msg_len, false);
+    QuicServer::MaybeDispatchPacket(dispatcher, packet, server_address,
+                                    client_address);
+  }
+  ResetHeaders();
+  return true;
+#else
+  return QuicServer::ReadAndDispatchSinglePacket(fd, port, dispatcher,
+                                                 packets_dropped);
+#endif
+}
+
+#if MMSG_MORE
+void QuicPacketReader::ResetHeaders() {
+  for (int i = 0; i < kNumPacketsPerReadMmsgCall; ++i) {
+    msghdr* hdr = &mmsg_hdr_[i].msg_hdr;
+    hdr->msg_namelen = sizeof(sockaddr_storage);
+    hdr->msg_controllen = QuicSocketUtils::kSpaceForOverflowAndIp;
+    hdr->msg_flags = 0;
+    memset(packets_[i].cbuf, 0, sizeof(packets_[i].cbuf));
+  }
+}
+#endif
+
+}  // namespace tools
+}  // namespace net
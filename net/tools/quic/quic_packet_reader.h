@@ -0,0 +1,65 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_TOOLS_QUIC_QUIC_PACKET_READER_H_
+#define NET_TOOLS_QUIC_QUIC_PACKET_READER_H_
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "base/basictypes.h"
+#include "net/quic/quic_protocol.h"
+#include "net/tools/quic/quic_socket_utils.h"
+
+namespace net {
+namespace tools {
+
+class QuicDispatcher;
+
+// The number of packets read with each recvmmsg() call.
+const int kNumPacketsPerReadMmsgCall = 16;
+
+// Reads packets in batches with recvmmsg(), saving a system call per packet
+// over QuicSocketUtils::ReadPacket. The buffers are allocated once, so a
+// reader should be kept for the lifetime of the socket.
+class QuicPacketReader {
+ public:
+  QuicPacketReader();
+  ~QuicPacketReader();
+
+  // Reads up to kNumPacketsPerReadMmsgCall packets from |fd| and passes
+  // them to |dispatcher|. Returns true if any packet was read, false if the
+  // socket had none. If |packets_dropped| is non-null, it is set as in
+  // QuicSocketUtils::ReadPacket.
+  bool ReadAndDispatchPackets(int fd,
+                              int port,
+                              QuicDispatcher* dispatcher,
+                              int* packets_dropped);
+
+ private:
+#if MMSG_MORE
+  // Resets the headers that recvmmsg() changes.
+  void ResetHeaders();
+
+  // Storage for a single packet and its addresses.
+  struct PacketData {
+    iovec iov;
+    sockaddr_storage raw_address;
+    char cbuf[QuicSocketUtils::kSpaceForOverflowAndIp];
+    // Leave room for packets over the limit so they can be rejected with an
+    // error, like QuicServer does.
+    char buf[2 * kMaxPacketSize];
+  };
+
+  PacketData packets_[kNumPacketsPerReadMmsgCall];
+  mmsghdr mmsg_hdr_[kNumPacketsPerReadMmsgCall];
+#endif
+
+  DISALLOW_COPY_AND_ASSIGN(QuicPacketReader);
+};
+
+}  // namespace tools
+}  // namespace net
+
+#endif  // NET_TOOLS_QUIC_QUIC_PACKET_READER_H_
@@ -19,10 +19,10 @@
 #include "net/quic/quic_data_reader.h"
 #include "net/quic/quic_protocol.h"
 #include "net/tools/quic/quic_in_memory_cache.h"
+#include "net/tools/quic/quic_packet_reader.h"
+#include "net/tools/quic/quic_sharded_dispatcher.h"
 #include "net/tools/quic/quic_socket_utils.h"
 
-#define MMSG_MORE 0
-
 #ifndef SO_RXQ_OVFL
 #define SO_RXQ_OVFL 40
 #endif
@@ -39,6 +39,9 @@ QuicServer::QuicServer()
       packets_dropped_(0),
       overflow_supported_(false),
       use_recvmmsg_(false),
+      use_sendmmsg_(false),
+      use_segmentation_offload_(false),
+      num_dispatcher_threads_(1),
       crypto_config_(kSourceAddressTokenSecret, QuicRandom::GetInstance()) {
   // Use hardcoded crypto parameters for now.
   config_.SetDefaults();
@@ -50,6 +53,9 @@ QuicServer::QuicServer(const QuicConfig& config)
       packets_dropped_(0),
       overflow_supported_(false),
       use_recvmmsg_(false),
+      use_sendmmsg_(false),
+      use_segmentation_offload_(false),
+      num_dispatcher_threads_(1),
       config_(config),
       crypto_config_(kSourceAddressTokenSecret, QuicRandom::GetInstance()) {
   Initialize();
@@ -58,6 +64,8 @@ QuicServer::QuicServer(const QuicConfig& config)
 void QuicServer::Initialize() {
 #if MMSG_MORE
   use_recvmmsg_ = true;
+  use_sendmmsg_ = true;
+  packet_reader_.reset(new QuicPacketReader());
 #endif
   epoll_server_.set_timeout_in_us(50 * 1000);
   // Initialize the in memory cache now.
@@ -140,14 +148,39 @@ bool QuicServer::Listen(const IPEndPoint& address) {
   }
 
   epoll_server_.RegisterFD(fd_, this, kEpollFlags);
-  dispatcher_.reset(new QuicDispatcher(config_, crypto_config_, fd_,
-                                       &epoll_server_));
+  QuicShardedDispatcher* sharded_dispatcher = NULL;
+  if (num_dispatcher_threads_ > 1) {
+    sharded_dispatcher = new QuicShardedDispatcher(
+        config_, crypto_config_, fd_, &epoll_server_, num_dispatcher_threads_);
+    dispatcher_.reset(sharded_dispatcher);
+  } else {
+    dispatcher_.reset(new QuicDispatcher(config_, crypto_config_, fd_,
+                                         &epoll_server_));
+  }
+  if (use_sendmmsg_)
+    dispatcher_->EnableBatchWrites(use_segmentation_offload_);
+  if (sharded_dispatcher)
+    sharded_dispatcher->Start();
 
   return true;
 }
 
+void QuicServer::set_use_recvmmsg(bool use_recvmmsg) {
+  DCHECK(!dispatcher_.get());
+  use_recvmmsg_ = use_recvmmsg;
+  if (use_recvmmsg_ && !packet_reader_.get())
+    packet_reader_.reset(new QuicPacketReader());
+}
+
+void QuicServer::set_use_sendmmsg(bool use_sendmmsg) {
+  DCHECK(!dispatcher_.get());
+  use_sendmmsg_ = use_sendmmsg;
+}
+
 void QuicServer::WaitForEvents() {
   epoll_server_.WaitForEventsAndExecuteCallbacks();
+  // Send what the alarms wrote.
+  dispatcher_->FlushWrites();
 }
 
 void QuicServer::Shutdown() {
@@ -164,10 +197,18 @@ void QuicServer::OnEvent(int fd, EpollEvent* event) {
     LOG(ERROR) << "EPOLLIN";
     bool read = true;
     while (read) {
+      if (use_recvmmsg_) {
+        read = packet_reader_->ReadAndDispatchPackets(
+            fd_, port_, dispatcher_.get(),
+            overflow_supported_ ? &packets_dropped_ : NULL);
+      } else {
         read = ReadAndDispatchSinglePacket(
             fd_, port_, dispatcher_.get(),
             overflow_supported_ ? &packets_dropped_ : NULL);
+      }
     }
+    // Send the replies to everything read.
+    dispatcher_->FlushWrites();
   }
   if (event->in_events & EPOLLOUT) {
     bool can_write_more = dispatcher_->OnCanWrite();
@@ -23,6 +23,7 @@ class QuicCryptoServerConfig;
 namespace tools {
 
 class QuicDispatcher;
+class QuicPacketReader;
 
 class QuicServer : public EpollCallbackInterface {
  public:
@@ -73,6 +74,25 @@ class QuicServer : public EpollCallbackInterface {
 
   int port() { return port_; }
 
+  // Whether to read and write packets in batches with recvmmsg() and
+  // sendmmsg(). Both default to true where the system supports them, and
+  // must be set before Listen().
+  void set_use_recvmmsg(bool use_recvmmsg);
+  void set_use_sendmmsg(bool use_sendmmsg);
+
+  // Whether batched writes send runs of packets to the same client as one
+  // UDP_SEGMENT message. Must be set before Listen().
+  void set_use_segmentation_offload(bool use_segmentation_offload) {
+    use_segmentation_offload_ = use_segmentation_offload;
+  }
+
+  // The number of threads handling connections, see QuicShardedDispatcher.
+  // With the default of 1, everything runs on the thread calling
+  // WaitForEvents(). Must be set before Listen().
+  void set_num_dispatcher_threads(int num_dispatcher_threads) {
+    num_dispatcher_threads_ = num_dispatcher_threads;
+  }
+
  private:
   // Initialize the internal state of the server.
   void Initialize();
@@ -100,6 +120,17 @@ class QuicServer : public EpollCallbackInterface {
   // If true, use recvmmsg for reading.
   bool use_recvmmsg_;
 
+  // If true, use sendmmsg for writing.
+  bool use_sendmmsg_;
+
+  // If true, batched writes use UDP_SEGMENT.
+  bool use_segmentation_offload_;
+
+  int num_dispatcher_threads_;
+
+  // Reads packets in batches when |use_recvmmsg_| is true.
+  scoped_ptr<QuicPacketReader> packet_reader_;
+
   // config_ contains non-crypto parameters that are negotiated in the crypto
   // handshake.
   QuicConfig config_;
@@ -17,6 +17,9 @@
 
 int32 FLAGS_port = 6121;
 
+// The number of threads handling connections.
+int32 FLAGS_num_threads = 1;
+
 int main(int argc, char *argv[]) {
   CommandLine::Init(argc, argv);
   CommandLine* line = CommandLine::ForCurrentProcess();
@@ -32,12 +35,21 @@ int main(int argc, char *argv[]) {
     }
   }
 
+  if (line->HasSwitch("num_threads")) {
+    int num_threads;
+    if (base::StringToInt(line->GetSwitchValueASCII("num_threads"),
+                          &num_threads) && num_threads > 0) {
+      FLAGS_num_threads = num_threads;
+    }
+  }
+
   base::AtExitManager exit_manager;
 
   net::IPAddressNumber ip;
   CHECK(net::ParseIPLiteralToNumber("::", &ip));
 
   net::tools::QuicServer server;
+  server.set_num_dispatcher_threads(FLAGS_num_threads);
 
   if (!server.Listen(net::IPEndPoint(ip, FLAGS_port))) {
     return 1;
@@ -0,0 +1,225 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_sharded_dispatcher.h"
+
+#include <string>
+#include <vector>
+
+#include "base/logging.h"
+#include "base/stl_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/simple_thread.h"
+#include "net/tools/flip_server/epoll_server.h"
+
+namespace net {
+namespace tools {
+
+namespace {
+
+// How long a dispatcher thread waits for events when it has nothing to do.
+const int64 kEpollTimeoutUs = 50 * 1000;
+
+}  // namespace
+
+// A thread running a QuicDispatcher. Apart from the locked hand-off
+// members, everything belongs to the thread once it is started, except for
+// |outbox_| which belongs to the server thread.
+class QuicShardedDispatcher::DispatcherThread : public base::SimpleThread {
+ public:
+  DispatcherThread(const QuicConfig& config,
+                   const QuicCryptoServerConfig& crypto_config,
+                   int fd,
+                   int index)
+      : SimpleThread("quic_dispatcher_" + base::IntToString(index)),
+        dispatcher_(config, crypto_config, fd, &epoll_server_),
+        can_write_(false),
+        quit_(false) {
+    epoll_server_.set_timeout_in_us(kEpollTimeoutUs);
+  }
+
+  virtual ~DispatcherThread() {}
+
+  // Only to be used before the thread is started.
+  QuicDispatcher* dispatcher() { return &dispatcher_; }
+
+  // Called on the server thread to queue a packet for the next
+  // PostPackets().
+  void AddPacket(const IPEndPoint& server_address,
+                 const IPEndPoint& client_address,
+                 QuicGuid guid,
+                 const QuicEncryptedPacket& packet) {
+    outbox_.push_back(PendingPacket());
+    PendingPacket* pending = &outbox_.back();
+    pending->server_address = server_address;
+    pending->client_address = client_address;
+    pending->guid = guid;
+    pending->data.assign(packet.data(), packet.length());
+  }
+
+  // Called on the server thread to hand the queued packets to the thread.
+  void PostPackets() {
+    if (outbox_.empty())
+      return;
+    {
+      base::AutoLock lock(lock_);
+      if (inbox_.empty()) {
+        inbox_.swap(outbox_);
+      } else {
+        inbox_.insert(inbox_.end(), outbox_.begin(), outbox_.end());
+      }
+    }
+    outbox_.clear();
+    epoll_server_.Wake();
+  }
+
+  // Called on the server thread when the socket becomes writable.
+  void PostCanWrite() {
+    {
+      base::AutoLock lock(lock_);
+      can_write_ = true;
+    }
+    epoll_server_.Wake();
+  }
+
+  // Called on the server thread to make the thread close its connections
+  // and exit.
+  void PostQuit() {
+    {
+      base::AutoLock lock(lock_);
+      quit_ = true;
+    }
+    epoll_server_.Wake();
+  }
+
+  // base::SimpleThread
+  virtual void Run() OVERRIDE {
+    bool more_to_write = false;
+    bool quit = false;
+    while (!quit) {
+      epoll_server_.WaitForEventsAndExecuteCallbacks();
+
+      std::vector<PendingPacket> packets;
+      bool can_write = false;
+      {
+        base::AutoLock lock(lock_);
+        packets.swap(inbox_);
+        std::swap(can_write, can_write_);
+        quit = quit_;
+      }
+
+      for (size_t i = 0; i < packets.size(); ++i) {
+        PendingPacket& pending = packets[i];
+        QuicEncryptedPacket packet(string_as_array(&pending.data),
+                                   pending.data.size(), false);
+        dispatcher_.ProcessPacket(pending.server_address,
+                                  pending.client_address,
+                                  pending.guid, packet);
+      }
+      // Like the server does with EPOLLOUT, keep going without waiting for
+      // events while the writers have more to write.
+      if (can_write || more_to_write) {
+        more_to_write = dispatcher_.OnCanWrite();
+        epoll_server_.set_timeout_in_us(more_to_write ? 0 : kEpollTimeoutUs);
+      }
+      dispatcher_.FlushWrites();
+    }
+
+    dispatcher_.Shutdown();
+    dispatcher_.FlushWrites();
+  }
+
+ private:
+  struct PendingPacket {
+    IPEndPoint server_address;
+    IPEndPoint client_address;
+    QuicGuid guid;
+    std::string data;
+  };
+
+  EpollServer epoll_server_;
+  QuicDispatcher dispatcher_;
+
+  std::vector<PendingPacket> outbox_;
+
+  base::Lock lock_;
+  // Guarded by |lock_|.
+  std::vector<PendingPacket> inbox_;
+  bool can_write_;
+  bool quit_;
+
+  DISALLOW_COPY_AND_ASSIGN(DispatcherThread);
+};
+
+QuicShardedDispatcher::QuicShardedDispatcher(
+    const QuicConfig& config,
+    const QuicCryptoServerConfig& crypto_config,
+    int fd,
+    EpollServer* epoll_server,
+    int num_threads)
+    : QuicDispatcher(config, crypto_config, fd, epoll_server),
+      started_(false) {
+  DCHECK_GT(num_threads, 0);
+  for (int i = 0; i < num_threads; ++i) {
+    threads_.push_back(
+        new DispatcherThread(config, crypto_config, fd, i));
+  }
+}
+
+QuicShardedDispatcher::~QuicShardedDispatcher() {
+  Shutdown();
+}
+
+void QuicShardedDispatcher::Start() {
+  DCHECK(!started_);
+  started_ = true;
+  for (size_t i = 0; i < threads_.size(); ++i)
+    threads_[i]->Start();
+}
+
+void QuicShardedDispatcher::ProcessPacket(const IPEndPoint& server_address,
+                                          const IPEndPoint& client_address,
+                                          QuicGuid guid,
+                                          const QuicEncryptedPacket& packet) {
+  DCHECK(started_);
+  GetThreadForGuid(guid)->AddPacket(server_address, client_address, guid,
+                                    packet);
+}
+
+bool QuicShardedDispatcher::OnCanWrite() {
+  // The threads wait for writes on their own.
+  for (size_t i = 0; i < threads_.size(); ++i)
+    threads_[i]->PostCanWrite();
+  return false;
+}
+
+void QuicShardedDispatcher::Shutdown() {
+  if (!started_)
+    return;
+  started_ = false;
+  for (size_t i = 0; i < threads_.size(); ++i)
+    threads_[i]->PostQuit();
+  for (size_t i = 0; i < threads_.size(); ++i)
+    threads_[i]->Join();
+}
+
+void QuicShardedDispatcher::EnableBatchWrites(bool use_segmentation_offload) {
+  DCHECK(!started_);
+  for (size_t i = 0; i < threads_.size(); ++i)
+    threads_[i]->dispatcher()->EnableBatchWrites(use_segmentation_offload);
+}
+
+void QuicShardedDispatcher::FlushWrites() {
+  for (size_t i = 0; i < threads_.size(); ++i)
+    threads_[i]->PostPackets();
+}
+
+QuicShardedDispatcher::DispatcherThread*
+QuicShardedDispatcher::GetThreadForGuid(QuicGuid guid) {
+  return threads_[guid % threads_.size()];
+}
+
+}  // namespace tools
+}  // namespace net
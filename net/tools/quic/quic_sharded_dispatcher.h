@@ -0,0 +1,66 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// A dispatcher which spreads the server's connections over several threads.
+
+#ifndef NET_TOOLS_QUIC_QUIC_SHARDED_DISPATCHER_H_
+#define NET_TOOLS_QUIC_QUIC_SHARDED_DISPATCHER_H_
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_vector.h"
+#include "net/tools/quic/quic_dispatcher.h"
+
+namespace net {
+namespace tools {
+
+// Runs |num_threads| QuicDispatchers, each on its own thread with its own
+// EpollServer. Packets are still read on the server's thread and passed to
+// ProcessPacket(), which steers them by GUID, so all the packets of a
+// connection are handled on the same thread and the sessions need no
+// locking. Packets are held until FlushWrites() and then handed to each
+// thread in one batch, so the threads synchronize once per read round
+// rather than once per packet. The threads write to the shared socket
+// directly.
+class QuicShardedDispatcher : public QuicDispatcher {
+ public:
+  QuicShardedDispatcher(const QuicConfig& config,
+                        const QuicCryptoServerConfig& crypto_config,
+                        int fd,
+                        EpollServer* epoll_server,
+                        int num_threads);
+  virtual ~QuicShardedDispatcher();
+
+  // Starts the dispatcher threads. Configuration such as
+  // EnableBatchWrites() must happen before.
+  void Start();
+
+  // QuicDispatcher
+  virtual void ProcessPacket(const IPEndPoint& server_address,
+                             const IPEndPoint& client_address,
+                             QuicGuid guid,
+                             const QuicEncryptedPacket& packet) OVERRIDE;
+  virtual bool OnCanWrite() OVERRIDE;
+  virtual void Shutdown() OVERRIDE;
+  virtual void EnableBatchWrites(bool use_segmentation_offload) OVERRIDE;
+  // Hands the packets received since the last call to the threads.
+  virtual void FlushWrites() OVERRIDE;
+
+  int num_threads() const { return threads_.size(); }
+
+ private:
+  class DispatcherThread;
+
+  // Returns the thread which handles the connection |guid|.
+  DispatcherThread* GetThreadForGuid(QuicGuid guid);
+
+  ScopedVector<DispatcherThread> threads_;
+  bool started_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicShardedDispatcher);
+};
+
+}  // namespace tools
+}  // namespace net
+
+#endif  // NET_TOOLS_QUIC_QUIC_SHARDED_DISPATCHER_H_
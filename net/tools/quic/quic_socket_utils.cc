@@ -76,8 +76,6 @@ int QuicSocketUtils::ReadPacket(int fd, char* buffer, size_t buf_len,
                           IPAddressNumber* self_address,
                           IPEndPoint* peer_address) {
   CHECK(peer_address != NULL);
-  const int kSpaceForOverflowAndIp =
-      CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(in6_pktinfo));
   char cbuf[kSpaceForOverflowAndIp];
   memset(cbuf, 0, arraysize(cbuf));
 
@@ -114,6 +112,38 @@ int QuicSocketUtils::ReadPacket(int fd, char* buffer, size_t buf_len,
     *self_address = QuicSocketUtils::GetAddressFromMsghdr(&hdr);
   }
 
+  GetPeerAddress(raw_address, peer_address);
+
+  return bytes_read;
+}
+
+// static
+size_t QuicSocketUtils::SetIpInfoInCmsg(const IPAddressNumber& self_address,
+                                        cmsghdr* cmsg) {
+  DCHECK(!self_address.empty());
+  if (GetAddressFamily(self_address) == ADDRESS_FAMILY_IPV4) {
+    cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
+    cmsg->cmsg_level = IPPROTO_IP;
+    cmsg->cmsg_type = IP_PKTINFO;
+    in_pktinfo* pktinfo = reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg));
+    memset(pktinfo, 0, sizeof(in_pktinfo));
+    pktinfo->ipi_ifindex = 0;
+    memcpy(&pktinfo->ipi_spec_dst, &self_address[0], self_address.size());
+    return CMSG_SPACE(sizeof(in_pktinfo));
+  }
+
+  cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
+  cmsg->cmsg_level = IPPROTO_IPV6;
+  cmsg->cmsg_type = IPV6_PKTINFO;
+  in6_pktinfo* pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
+  memset(pktinfo, 0, sizeof(in6_pktinfo));
+  memcpy(&pktinfo->ipi6_addr, &self_address[0], self_address.size());
+  return CMSG_SPACE(sizeof(in6_pktinfo));
+}
+
+// static
+void QuicSocketUtils::GetPeerAddress(const sockaddr_storage& raw_address,
+                                     IPEndPoint* peer_address) {
   if (raw_address.ss_family == AF_INET) {
     CHECK(peer_address->FromSockAddr(
         reinterpret_cast<const sockaddr*>(&raw_address),
@@ -123,8 +153,6 @@ int QuicSocketUtils::ReadPacket(int fd, char* buffer, size_t buf_len,
         reinterpret_cast<const sockaddr*>(&raw_address),
         sizeof(struct sockaddr_in6)));
   }
-
-  return bytes_read;
 }
 
 // static
@@ -146,39 +174,15 @@ int QuicSocketUtils::WritePacket(int fd, const char* buffer, size_t buf_len,
   hdr.msg_iovlen = 1;
   hdr.msg_flags = 0;
 
-  const int kSpaceForIpv4 = CMSG_SPACE(sizeof(in_pktinfo));
-  const int kSpaceForIpv6 = CMSG_SPACE(sizeof(in6_pktinfo));
-  // kSpaceForIp should be big enough to hold both IPv4 and IPv6 packet info.
-  const int kSpaceForIp =
-      (kSpaceForIpv4 < kSpaceForIpv6) ? kSpaceForIpv6 : kSpaceForIpv4;
   char cbuf[kSpaceForIp];
   if (self_address.empty()) {
     hdr.msg_control = 0;
     hdr.msg_controllen = 0;
-  } else if (GetAddressFamily(self_address) == ADDRESS_FAMILY_IPV4) {
-    hdr.msg_control = cbuf;
-    hdr.msg_controllen = kSpaceForIp;
-    cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
-
-    cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
-    cmsg->cmsg_level = IPPROTO_IP;
-    cmsg->cmsg_type = IP_PKTINFO;
-    in_pktinfo* pktinfo = reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg));
-    memset(pktinfo, 0, sizeof(in_pktinfo));
-    pktinfo->ipi_ifindex = 0;
-    memcpy(&pktinfo->ipi_spec_dst, &self_address[0], self_address.size());
-    hdr.msg_controllen = cmsg->cmsg_len;
   } else {
     hdr.msg_control = cbuf;
     hdr.msg_controllen = kSpaceForIp;
     cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
-
-    cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
-    cmsg->cmsg_level = IPPROTO_IPV6;
-    cmsg->cmsg_type = IPV6_PKTINFO;
-    in6_pktinfo* pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
-    memset(pktinfo, 0, sizeof(in6_pktinfo));
-    memcpy(&pktinfo->ipi6_addr, &self_address[0], self_address.size());
+    SetIpInfoInCmsg(self_address, cmsg);
     hdr.msg_controllen = cmsg->cmsg_len;
   }
 
@@ -7,17 +7,38 @@
 #ifndef NET_TOOLS_QUIC_QUIC_SOCKET_UTILS_H_
 #define NET_TOOLS_QUIC_QUIC_SOCKET_UTILS_H_
 
+#include <features.h>
+#include <netinet/in.h>
 #include <stddef.h>
 #include <sys/socket.h>
 #include <string>
 
 #include "net/base/ip_endpoint.h"
 
+// recvmmsg() and sendmmsg() are available from glibc 2.14.
+#if defined(__GLIBC_PREREQ)
+#if __GLIBC_PREREQ(2, 14)
+#define MMSG_MORE 1
+#endif
+#endif
+#ifndef MMSG_MORE
+#define MMSG_MORE 0
+#endif
+
 namespace net {
 namespace tools {
 
 class QuicSocketUtils {
  public:
+  // The size of the control buffer needed to read the SO_RXQ_OVFL counter
+  // and the IP_PKTINFO or IPV6_PKTINFO of a packet.
+  static const size_t kSpaceForOverflowAndIp =
+      CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(in6_pktinfo));
+
+  // The size of the control buffer needed to set the self address of a
+  // packet being written.
+  static const size_t kSpaceForIp = CMSG_SPACE(sizeof(in6_pktinfo));
+
   // If the msghdr contains IP_PKTINFO or IPV6_PKTINFO, this will return the
   // IPAddressNumber in that header.  Returns an uninitialized IPAddress on
   // failure.
@@ -31,6 +52,16 @@ class QuicSocketUtils {
   // address_family.  Returns the return code from setsockopt.
   static int SetGetAddressInfo(int fd, int address_family);
 
+  // Fills in |cmsg| with the IP_PKTINFO or IPV6_PKTINFO needed to send a
+  // packet from |self_address|, which must not be empty. Returns the space
+  // used, which is at most kSpaceForIp.
+  static size_t SetIpInfoInCmsg(const IPAddressNumber& self_address,
+                                cmsghdr* cmsg);
+
+  // Sets the peer address of a packet read into |raw_address|.
+  static void GetPeerAddress(const sockaddr_storage& raw_address,
+                             IPEndPoint* peer_address);
+
   // Reads buf_len from the socket.  If reading is successful, returns bytes
   // read and sets peer_address to the peer address.  Otherwise returns -1.
   //
@@ -9,6 +9,7 @@
 #include "base/callback.h"
 #include "base/compiler_specific.h"
 #include "base/debug/stack_trace.h"
+#include "base/debug/trace_event_memory.h"
 #include "base/lazy_instance.h"
 #include "base/memory/singleton.h"
 #include "base/message_loop/message_loop.h"
@@ -538,6 +539,7 @@ void URLRequest::set_delegate(Delegate* delegate) {
 }
 
 void URLRequest::Start() {
+  TRACE_MEMORY_SUBSYSTEM("net");
   DCHECK_EQ(network_delegate_, context_->network_delegate());
 
   g_url_requests_started = true;
@@ -13,6 +13,7 @@
 #include "net/base/big_endian.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_log.h"
+#include "net/websockets/websocket_deflate_stream.h"
 #include "net/websockets/websocket_errors.h"
 #include "net/websockets/websocket_event_interface.h"
 #include "net/websockets/websocket_frame.h"
@@ -232,6 +233,12 @@ void WebSocketChannel::SendAddChannelRequestWithFactory(
 void WebSocketChannel::OnConnectSuccess(scoped_ptr<WebSocketStream> stream) {
   DCHECK(stream);
   DCHECK_EQ(CONNECTING, state_);
+  WebSocketDeflateStream::Parameters deflate_parameters;
+  if (WebSocketDeflateStream::ParseParameters(stream->GetExtensions(),
+                                              &deflate_parameters)) {
+    stream.reset(new WebSocketDeflateStream(stream.Pass(),
+                                            deflate_parameters));
+  }
   stream_ = stream.Pass();
   state_ = CONNECTED;
   event_interface_->OnAddChannelResponse(false, stream_->GetSubProtocol());
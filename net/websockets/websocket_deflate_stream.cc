@@ -0,0 +1,509 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/websockets/websocket_deflate_stream.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/metrics/histogram.h"
+#include "base/strings/string_number_conversions.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_util.h"
+#include "third_party/zlib/zlib.h"
+
+namespace net {
+
+namespace {
+
+const char kExtensionName[] = "permessage-deflate";
+
+// The trailer of the empty stored block that ends a Z_SYNC_FLUSH, which
+// permessage-deflate removes from the end of each compressed message.
+const char kSyncFlushTrailer[] = { '\x00', '\x00', '\xff', '\xff' };
+
+// zlib refuses a window of 2^8 bytes for raw deflate streams.
+const int kMinDeflaterWindowBits = 9;
+
+// The amount the output buffers grow by while (de)compressing.
+const size_t kOutputChunkSize = 4 * 1024;
+
+// Parses the value of a *_max_window_bits parameter.
+bool ParseWindowBits(const std::string& value, int* window_bits) {
+  int bits = 0;
+  if (!base::StringToInt(value, &bits) || bits < 8 ||
+      bits > WebSocketDeflateStream::kMaxWindowBits) {
+    return false;
+  }
+  *window_bits = bits;
+  return true;
+}
+
+scoped_refptr<IOBufferWithSize> MakeBuffer(const std::vector<char>& data) {
+  if (data.empty())
+    return NULL;
+  scoped_refptr<IOBufferWithSize> buffer(new IOBufferWithSize(data.size()));
+  memcpy(buffer->data(), &data.front(), data.size());
+  return buffer;
+}
+
+void RecordMessageStats(const char* ratio_histogram,
+                        const char* time_histogram,
+                        size_t original_bytes,
+                        size_t compressed_bytes,
+                        base::TimeDelta cpu_time) {
+  if (original_bytes > 0) {
+    // Compressed size as a percentage of the original size. Small messages
+    // may grow, so this goes above 100.
+    UMA_HISTOGRAM_CUSTOM_COUNTS(
+        ratio_histogram,
+        static_cast<int>(compressed_bytes * 100 / original_bytes), 1, 200, 50);
+  }
+  UMA_HISTOGRAM_CUSTOM_TIMES(time_histogram, cpu_time,
+                             base::TimeDelta::FromMicroseconds(1),
+                             base::TimeDelta::FromSeconds(1), 50);
+}
+
+}  // namespace
+
+// Compresses the payload of outgoing data messages, one frame at a time.
+class WebSocketDeflateStream::Deflater {
+ public:
+  Deflater(int window_bits, bool take_over_context)
+      : take_over_context_(take_over_context),
+        original_bytes_(0),
+        compressed_bytes_(0) {
+    memset(&stream_, 0, sizeof(stream_));
+    // Negative window bits ask zlib for a raw deflate stream.
+    int result = deflateInit2(
+        &stream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+        -std::max(window_bits, kMinDeflaterWindowBits), 8, Z_DEFAULT_STRATEGY);
+    CHECK_EQ(Z_OK, result);
+  }
+
+  ~Deflater() {
+    deflateEnd(&stream_);
+  }
+
+  void AddBytes(const char* data, size_t size) {
+    base::TimeTicks start = WebSocketDeflateStream::Now();
+    Deflate(data, size, Z_NO_FLUSH);
+    cpu_time_ += WebSocketDeflateStream::Now() - start;
+    original_bytes_ += size;
+  }
+
+  // Returns the compressed payload of the frame, which ends the message if
+  // |final| is true.
+  scoped_refptr<IOBufferWithSize> FinishFrame(bool final) {
+    base::TimeTicks start = WebSocketDeflateStream::Now();
+    Deflate(NULL, 0, Z_SYNC_FLUSH);
+    if (final) {
+      DCHECK_GE(output_.size(), arraysize(kSyncFlushTrailer));
+      DCHECK_EQ(0, memcmp(&output_[output_.size() - 4], kSyncFlushTrailer,
+                          arraysize(kSyncFlushTrailer)));
+      output_.resize(output_.size() - arraysize(kSyncFlushTrailer));
+      if (!take_over_context_)
+        deflateReset(&stream_);
+    }
+    cpu_time_ += WebSocketDeflateStream::Now() - start;
+    compressed_bytes_ += output_.size();
+
+    scoped_refptr<IOBufferWithSize> payload = MakeBuffer(output_);
+    output_.clear();
+    if (final) {
+      RecordMessageStats("Net.WebSocket.Deflate.CompressionRatio",
+                         "Net.WebSocket.Deflate.CPUTime",
+                         original_bytes_, compressed_bytes_, cpu_time_);
+      original_bytes_ = 0;
+      compressed_bytes_ = 0;
+      cpu_time_ = base::TimeDelta();
+    }
+    return payload;
+  }
+
+ private:
+  void Deflate(const char* data, size_t size, int flush) {
+    stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream_.avail_in = size;
+    do {
+      size_t used = output_.size();
+      output_.resize(used + kOutputChunkSize);
+      stream_.next_out = reinterpret_cast<Bytef*>(&output_[used]);
+      stream_.avail_out = kOutputChunkSize;
+      int result = deflate(&stream_, flush);
+      DCHECK(result == Z_OK || result == Z_BUF_ERROR);
+      output_.resize(used + kOutputChunkSize - stream_.avail_out);
+    } while (stream_.avail_out == 0);
+    DCHECK_EQ(0u, stream_.avail_in);
+  }
+
+  z_stream stream_;
+  const bool take_over_context_;
+  std::vector<char> output_;
+
+  // Statistics of the current message.
+  size_t original_bytes_;
+  size_t compressed_bytes_;
+  base::TimeDelta cpu_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(Deflater);
+};
+
+// Decompresses the payload of incoming compressed messages, one frame at a
+// time.
+class WebSocketDeflateStream::Inflater {
+ public:
+  explicit Inflater(bool take_over_context)
+      : take_over_context_(take_over_context),
+        original_bytes_(0),
+        compressed_bytes_(0) {
+    memset(&stream_, 0, sizeof(stream_));
+    // The largest window can inflate data compressed with any window size.
+    int result = inflateInit2(&stream_, -kMaxWindowBits);
+    CHECK_EQ(Z_OK, result);
+  }
+
+  ~Inflater() {
+    inflateEnd(&stream_);
+  }
+
+  // Returns false if |data| isn't valid compressed data.
+  bool AddBytes(const char* data, size_t size) {
+    base::TimeTicks start = WebSocketDeflateStream::Now();
+    bool success = Inflate(data, size);
+    cpu_time_ += WebSocketDeflateStream::Now() - start;
+    compressed_bytes_ += size;
+    return success;
+  }
+
+  // Returns the decompressed payload of the frame, which ends the message if
+  // |final| is true. Sets |*success| to false if the data was invalid.
+  scoped_refptr<IOBufferWithSize> FinishFrame(bool final, bool* success) {
+    *success = true;
+    if (final) {
+      base::TimeTicks start = WebSocketDeflateStream::Now();
+      *success = Inflate(kSyncFlushTrailer, arraysize(kSyncFlushTrailer));
+      if (!take_over_context_)
+        inflateReset(&stream_);
+      cpu_time_ += WebSocketDeflateStream::Now() - start;
+    }
+    original_bytes_ += output_.size();
+
+    scoped_refptr<IOBufferWithSize> payload = MakeBuffer(output_);
+    output_.clear();
+    if (final) {
+      RecordMessageStats("Net.WebSocket.Inflate.CompressionRatio",
+                         "Net.WebSocket.Inflate.CPUTime",
+                         original_bytes_, compressed_bytes_, cpu_time_);
+      original_bytes_ = 0;
+      compressed_bytes_ = 0;
+      cpu_time_ = base::TimeDelta();
+    }
+    return payload;
+  }
+
+ private:
+  bool Inflate(const char* data, size_t size) {
+    stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream_.avail_in = size;
+    do {
+      size_t used = output_.size();
+      output_.resize(used + kOutputChunkSize);
+      stream_.next_out = reinterpret_cast<Bytef*>(&output_[used]);
+      stream_.avail_out = kOutputChunkSize;
+      int result = inflate(&stream_, Z_SYNC_FLUSH);
+      output_.resize(used + kOutputChunkSize - stream_.avail_out);
+      if (result == Z_STREAM_END) {
+        // The peer ended the deflate stream, which is only valid at the end
+        // of a message.
+        inflateReset(&stream_);
+        if (stream_.avail_in > 0)
+          return false;
+        break;
+      }
+      if (result != Z_OK && result != Z_BUF_ERROR)
+        return false;
+    } while (stream_.avail_out == 0);
+    return stream_.avail_in == 0;
+  }
+
+  z_stream stream_;
+  const bool take_over_context_;
+  std::vector<char> output_;
+
+  // Statistics of the current message.
+  size_t original_bytes_;
+  size_t compressed_bytes_;
+  base::TimeDelta cpu_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(Inflater);
+};
+
+WebSocketDeflateStream::Parameters::Parameters()
+    : client_no_context_takeover(false),
+      server_no_context_takeover(false),
+      client_max_window_bits(kMaxWindowBits),
+      server_max_window_bits(kMaxWindowBits) {}
+
+// static
+const int WebSocketDeflateStream::kMaxWindowBits = 15;
+
+// static
+bool WebSocketDeflateStream::ParseParameters(const std::string& extensions,
+                                             Parameters* parameters) {
+  HttpUtil::ValuesIterator extensions_iterator(
+      extensions.begin(), extensions.end(), ',');
+  while (extensions_iterator.GetNext()) {
+    HttpUtil::ValuesIterator params_iterator(
+        extensions_iterator.value_begin(), extensions_iterator.value_end(),
+        ';');
+    if (!params_iterator.GetNext() ||
+        params_iterator.value() != kExtensionName) {
+      continue;
+    }
+
+    Parameters result;
+    while (params_iterator.GetNext()) {
+      std::string param = params_iterator.value();
+      std::string value;
+      size_t equals = param.find('=');
+      if (equals != std::string::npos) {
+        std::string::const_iterator value_begin = param.begin() + equals + 1;
+        std::string::const_iterator value_end = param.end();
+        HttpUtil::TrimLWS(&value_begin, &value_end);
+        value.assign(value_begin, value_end);
+        std::string::const_iterator name_begin = param.begin();
+        std::string::const_iterator name_end = param.begin() + equals;
+        HttpUtil::TrimLWS(&name_begin, &name_end);
+        param.assign(name_begin, name_end);
+      }
+
+      if (param == "client_no_context_takeover" && value.empty()) {
+        result.client_no_context_takeover = true;
+      } else if (param == "server_no_context_takeover" && value.empty()) {
+        result.server_no_context_takeover = true;
+      } else if (param == "client_max_window_bits") {
+        if (!value.empty() &&
+            !ParseWindowBits(value, &result.client_max_window_bits)) {
+          return false;
+        }
+      } else if (param == "server_max_window_bits") {
+        if (!ParseWindowBits(value, &result.server_max_window_bits))
+          return false;
+      } else {
+        return false;
+      }
+    }
+    *parameters = result;
+    return true;
+  }
+  return false;
+}
+
+WebSocketDeflateStream::WebSocketDeflateStream(
+    scoped_ptr<WebSocketStream> stream,
+    const Parameters& parameters)
+    : stream_(stream.Pass()),
+      parameters_(parameters),
+      writing_data_frame_(false),
+      writing_first_frame_of_message_(false),
+      deflater_(new Deflater(parameters.client_max_window_bits,
+                             !parameters.client_no_context_takeover)),
+      reading_data_frame_(false),
+      reading_compressed_message_(false),
+      inflater_(new Inflater(!parameters.server_no_context_takeover)) {
+  DCHECK(stream_);
+}
+
+WebSocketDeflateStream::~WebSocketDeflateStream() {}
+
+int WebSocketDeflateStream::ReadFrames(
+    ScopedVector<WebSocketFrameChunk>* frame_chunks,
+    const CompletionCallback& callback) {
+  int result = stream_->ReadFrames(
+      frame_chunks,
+      base::Bind(&WebSocketDeflateStream::OnReadComplete,
+                 base::Unretained(this),
+                 base::Unretained(frame_chunks),
+                 callback));
+  if (result < 0)
+    return result;
+  DCHECK_EQ(OK, result);
+  return InflateAndReadIfNecessary(frame_chunks, callback);
+}
+
+int WebSocketDeflateStream::WriteFrames(
+    ScopedVector<WebSocketFrameChunk>* frame_chunks,
+    const CompletionCallback& callback) {
+  DCHECK(frames_to_write_.empty());
+  int result = Deflate(*frame_chunks, &frames_to_write_);
+  if (result != OK)
+    return result;
+  // If all of the chunks were buffered there is nothing to write yet.
+  if (frames_to_write_.empty())
+    return OK;
+  result = stream_->WriteFrames(&frames_to_write_, callback);
+  if (result != ERR_IO_PENDING)
+    frames_to_write_.clear();
+  return result;
+}
+
+void WebSocketDeflateStream::Close() {
+  stream_->Close();
+}
+
+std::string WebSocketDeflateStream::GetSubProtocol() const {
+  return stream_->GetSubProtocol();
+}
+
+std::string WebSocketDeflateStream::GetExtensions() const {
+  return stream_->GetExtensions();
+}
+
+int WebSocketDeflateStream::SendHandshakeRequest(
+    const GURL& url,
+    const HttpRequestHeaders& headers,
+    HttpResponseInfo* response_info,
+    const CompletionCallback& callback) {
+  return stream_->SendHandshakeRequest(url, headers, response_info, callback);
+}
+
+int WebSocketDeflateStream::ReadHandshakeResponse(
+    const CompletionCallback& callback) {
+  return stream_->ReadHandshakeResponse(callback);
+}
+
+int WebSocketDeflateStream::Deflate(
+    const ScopedVector<WebSocketFrameChunk>& frame_chunks,
+    ScopedVector<WebSocketFrameChunk>* frames_to_write) {
+  for (size_t i = 0; i < frame_chunks.size(); ++i) {
+    const WebSocketFrameChunk* chunk = frame_chunks[i];
+    if (chunk->header) {
+      WebSocketFrameHeader::OpCode opcode = chunk->header->opcode;
+      writing_data_frame_ = WebSocketFrameHeader::IsKnownDataOpCode(opcode);
+      if (writing_data_frame_) {
+        writing_first_frame_of_message_ =
+            opcode != WebSocketFrameHeader::kOpCodeContinuation;
+        current_writing_header_ = chunk->header->Clone();
+      }
+    }
+
+    if (!writing_data_frame_) {
+      // Control frames are written as they are.
+      scoped_ptr<WebSocketFrameChunk> copy(new WebSocketFrameChunk);
+      if (chunk->header)
+        copy->header = chunk->header->Clone();
+      copy->final_chunk = chunk->final_chunk;
+      copy->data = chunk->data;
+      frames_to_write->push_back(copy.release());
+      continue;
+    }
+
+    DCHECK(current_writing_header_);
+    if (chunk->data.get())
+      deflater_->AddBytes(chunk->data->data(), chunk->data->size());
+    if (!chunk->final_chunk)
+      continue;
+
+    scoped_ptr<WebSocketFrameChunk> compressed(new WebSocketFrameChunk);
+    compressed->header = current_writing_header_.Pass();
+    compressed->header->reserved1 = writing_first_frame_of_message_;
+    compressed->data = deflater_->FinishFrame(compressed->header->final);
+    compressed->header->payload_length =
+        compressed->data.get() ? compressed->data->size() : 0;
+    compressed->final_chunk = true;
+    frames_to_write->push_back(compressed.release());
+  }
+  return OK;
+}
+
+int WebSocketDeflateStream::Inflate(
+    ScopedVector<WebSocketFrameChunk>* frame_chunks) {
+  ScopedVector<WebSocketFrameChunk> chunks_to_inflate;
+  chunks_to_inflate.swap(*frame_chunks);
+  for (size_t i = 0; i < chunks_to_inflate.size(); ++i) {
+    WebSocketFrameChunk* chunk = chunks_to_inflate[i];
+    if (chunk->header) {
+      WebSocketFrameHeader::OpCode opcode = chunk->header->opcode;
+      reading_data_frame_ = WebSocketFrameHeader::IsKnownDataOpCode(opcode);
+      if (reading_data_frame_) {
+        if (opcode != WebSocketFrameHeader::kOpCodeContinuation)
+          reading_compressed_message_ = chunk->header->reserved1;
+        else if (chunk->header->reserved1)
+          return ERR_WS_PROTOCOL_ERROR;
+        current_reading_header_ = chunk->header->Clone();
+      }
+    }
+
+    if (!reading_data_frame_ || !reading_compressed_message_) {
+      frame_chunks->push_back(chunk);
+      chunks_to_inflate[i] = NULL;
+      continue;
+    }
+
+    DCHECK(current_reading_header_);
+    if (chunk->data.get() &&
+        !inflater_->AddBytes(chunk->data->data(), chunk->data->size())) {
+      return ERR_WS_PROTOCOL_ERROR;
+    }
+    if (!chunk->final_chunk)
+      continue;
+
+    scoped_ptr<WebSocketFrameChunk> inflated(new WebSocketFrameChunk);
+    inflated->header = current_reading_header_.Pass();
+    inflated->header->reserved1 = false;
+    bool success = false;
+    inflated->data = inflater_->FinishFrame(inflated->header->final, &success);
+    if (!success)
+      return ERR_WS_PROTOCOL_ERROR;
+    inflated->header->payload_length =
+        inflated->data.get() ? inflated->data->size() : 0;
+    inflated->final_chunk = true;
+    frame_chunks->push_back(inflated.release());
+  }
+  return frame_chunks->empty() ? ERR_IO_PENDING : OK;
+}
+
+int WebSocketDeflateStream::InflateAndReadIfNecessary(
+    ScopedVector<WebSocketFrameChunk>* frame_chunks,
+    const CompletionCallback& callback) {
+  int result = Inflate(frame_chunks);
+  while (result == ERR_IO_PENDING) {
+    result = stream_->ReadFrames(
+        frame_chunks,
+        base::Bind(&WebSocketDeflateStream::OnReadComplete,
+                   base::Unretained(this),
+                   base::Unretained(frame_chunks),
+                   callback));
+    if (result < 0)
+      break;
+    DCHECK_EQ(OK, result);
+    result = Inflate(frame_chunks);
+  }
+  return result;
+}
+
+void WebSocketDeflateStream::OnReadComplete(
+    ScopedVector<WebSocketFrameChunk>* frame_chunks,
+    const CompletionCallback& callback,
+    int result) {
+  if (result == OK)
+    result = InflateAndReadIfNecessary(frame_chunks, callback);
+  if (result != ERR_IO_PENDING)
+    callback.Run(result);
+}
+
+// static
+base::TimeTicks WebSocketDeflateStream::Now() {
+  if (base::TimeTicks::IsThreadNowSupported())
+    return base::TimeTicks::ThreadNow();
+  return base::TimeTicks::HighResNow();
+}
+
+}  // namespace net
@@ -0,0 +1,131 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_WEBSOCKETS_WEBSOCKET_DEFLATE_STREAM_H_
+#define NET_WEBSOCKETS_WEBSOCKET_DEFLATE_STREAM_H_
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/time/time.h"
+#include "net/base/completion_callback.h"
+#include "net/base/net_export.h"
+#include "net/websockets/websocket_frame.h"
+#include "net/websockets/websocket_stream.h"
+
+namespace net {
+
+// WebSocketDeflateStream is a WebSocketStream that implements the
+// permessage-deflate extension on top of another WebSocketStream: the data
+// messages written to it are compressed before being passed down, and the
+// compressed messages read from the underlying stream are decompressed.
+// Control frames and uncompressed messages pass through unchanged.
+//
+// Since the length of a frame is only known once all of it has been
+// (de)compressed, each data frame of a compressed message is buffered until
+// its last chunk has arrived and is then passed on as a single chunk.
+//
+// The compression ratio and the CPU time spent on each message are recorded
+// in UMA histograms.
+class NET_EXPORT_PRIVATE WebSocketDeflateStream : public WebSocketStream {
+ public:
+  // The permessage-deflate extension parameters negotiated in the handshake.
+  struct NET_EXPORT_PRIVATE Parameters {
+    Parameters();
+
+    // Whether each side resets its compression context after every message.
+    // Otherwise the context is kept, which compresses similar messages much
+    // better at the cost of keeping the zlib state for the connection.
+    bool client_no_context_takeover;
+    bool server_no_context_takeover;
+
+    // The base-2 logarithm of the LZ77 window size each side uses.
+    int client_max_window_bits;
+    int server_max_window_bits;
+  };
+
+  // The window size used when none is negotiated, which is also the largest.
+  static const int kMaxWindowBits;
+
+  // Finds the permessage-deflate extension in |extensions|, formatted as in
+  // the Sec-WebSocket-Extensions response header, and stores its parameters in
+  // |*parameters|. Returns false if the extension is absent or its parameters
+  // are invalid.
+  static bool ParseParameters(const std::string& extensions,
+                              Parameters* parameters);
+
+  WebSocketDeflateStream(scoped_ptr<WebSocketStream> stream,
+                         const Parameters& parameters);
+  virtual ~WebSocketDeflateStream();
+
+  // WebSocketStream functions.
+  virtual int ReadFrames(ScopedVector<WebSocketFrameChunk>* frame_chunks,
+                         const CompletionCallback& callback) OVERRIDE;
+  virtual int WriteFrames(ScopedVector<WebSocketFrameChunk>* frame_chunks,
+                          const CompletionCallback& callback) OVERRIDE;
+  virtual void Close() OVERRIDE;
+  virtual std::string GetSubProtocol() const OVERRIDE;
+  virtual std::string GetExtensions() const OVERRIDE;
+  virtual int SendHandshakeRequest(const GURL& url,
+                                   const HttpRequestHeaders& headers,
+                                   HttpResponseInfo* response_info,
+                                   const CompletionCallback& callback) OVERRIDE;
+  virtual int ReadHandshakeResponse(
+      const CompletionCallback& callback) OVERRIDE;
+
+ private:
+  class Deflater;
+  class Inflater;
+
+  // Compresses the data frames of |frame_chunks| into |frames_to_write|.
+  // Chunks of a data frame that isn't complete yet are buffered.
+  int Deflate(const ScopedVector<WebSocketFrameChunk>& frame_chunks,
+              ScopedVector<WebSocketFrameChunk>* frames_to_write);
+
+  // Decompresses the compressed data frames of |frame_chunks| in place.
+  // Returns ERR_IO_PENDING if all of the chunks were buffered, in which case
+  // |frame_chunks| is left empty.
+  int Inflate(ScopedVector<WebSocketFrameChunk>* frame_chunks);
+
+  // Calls Inflate(), and reads from |stream_| for as long as everything read
+  // is buffered.
+  int InflateAndReadIfNecessary(ScopedVector<WebSocketFrameChunk>* frame_chunks,
+                                const CompletionCallback& callback);
+
+  void OnReadComplete(ScopedVector<WebSocketFrameChunk>* frame_chunks,
+                      const CompletionCallback& callback,
+                      int result);
+
+  // Returns the time to measure the CPU cost of (de)compression with.
+  static base::TimeTicks Now();
+
+  const scoped_ptr<WebSocketStream> stream_;
+  const Parameters parameters_;
+
+  // The header of the frame being written, and whether its message is a
+  // data message (and so compressed).
+  scoped_ptr<WebSocketFrameHeader> current_writing_header_;
+  bool writing_data_frame_;
+  bool writing_first_frame_of_message_;
+  scoped_ptr<Deflater> deflater_;
+
+  // The header of the data frame being read, whether the frame being read is
+  // a data frame, and whether the current data message is compressed.
+  scoped_ptr<WebSocketFrameHeader> current_reading_header_;
+  bool reading_data_frame_;
+  bool reading_compressed_message_;
+  scoped_ptr<Inflater> inflater_;
+
+  // The frames passed to |stream_| by the pending WriteFrames().
+  ScopedVector<WebSocketFrameChunk> frames_to_write_;
+
+  DISALLOW_COPY_AND_ASSIGN(WebSocketDeflateStream);
+};
+
+}  // namespace net
+
+#endif  // NET_WEBSOCKETS_WEBSOCKET_DEFLATE_STREAM_H_
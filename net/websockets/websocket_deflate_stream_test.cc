@@ -0,0 +1,324 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/websockets/websocket_deflate_stream.h"
+
+#include <string.h>
+
+#include <string>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
+#include "net/websockets/websocket_frame.h"
+#include "net/websockets/websocket_stream.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace {
+
+// A WebSocketStream that keeps the frames written to it, and synchronously
+// returns the frames given to it from ReadFrames().
+class FakeWebSocketStream : public WebSocketStream {
+ public:
+  FakeWebSocketStream() {}
+
+  virtual int SendHandshakeRequest(
+      const GURL& url,
+      const HttpRequestHeaders& headers,
+      HttpResponseInfo* response_info,
+      const CompletionCallback& callback) OVERRIDE {
+    return ERR_IO_PENDING;
+  }
+
+  virtual int ReadHandshakeResponse(
+      const CompletionCallback& callback) OVERRIDE {
+    return ERR_IO_PENDING;
+  }
+
+  // Returns the frames passed to PrepareReadFrames(), or ERR_IO_PENDING if
+  // there are none.
+  virtual int ReadFrames(ScopedVector<WebSocketFrameChunk>* frame_chunks,
+                         const CompletionCallback& callback) OVERRIDE {
+    if (frames_to_read_.empty())
+      return ERR_IO_PENDING;
+    frame_chunks->swap(frames_to_read_);
+    frames_to_read_.clear();
+    return OK;
+  }
+
+  virtual int WriteFrames(ScopedVector<WebSocketFrameChunk>* frame_chunks,
+                          const CompletionCallback& callback) OVERRIDE {
+    written_frames_.insert(written_frames_.end(),
+                           frame_chunks->begin(),
+                           frame_chunks->end());
+    frame_chunks->weak_clear();
+    return OK;
+  }
+
+  virtual void Close() OVERRIDE {}
+  virtual std::string GetSubProtocol() const OVERRIDE { return ""; }
+  virtual std::string GetExtensions() const OVERRIDE { return ""; }
+
+  void PrepareReadFrames(ScopedVector<WebSocketFrameChunk>* frame_chunks) {
+    frames_to_read_.swap(*frame_chunks);
+  }
+
+  ScopedVector<WebSocketFrameChunk>* written_frames() {
+    return &written_frames_;
+  }
+
+ private:
+  ScopedVector<WebSocketFrameChunk> frames_to_read_;
+  ScopedVector<WebSocketFrameChunk> written_frames_;
+
+  DISALLOW_COPY_AND_ASSIGN(FakeWebSocketStream);
+};
+
+scoped_ptr<WebSocketFrameChunk> MakeChunk(WebSocketFrameHeader::OpCode opcode,
+                                          bool final,
+                                          bool reserved1,
+                                          const std::string& data) {
+  scoped_ptr<WebSocketFrameChunk> chunk(new WebSocketFrameChunk);
+  chunk->header.reset(new WebSocketFrameHeader(opcode));
+  chunk->header->final = final;
+  chunk->header->reserved1 = reserved1;
+  chunk->header->payload_length = data.size();
+  chunk->final_chunk = true;
+  if (!data.empty()) {
+    chunk->data = new IOBufferWithSize(data.size());
+    memcpy(chunk->data->data(), data.data(), data.size());
+  }
+  return chunk.Pass();
+}
+
+std::string ToString(const WebSocketFrameChunk* chunk) {
+  if (!chunk->data.get())
+    return "";
+  return std::string(chunk->data->data(), chunk->data->size());
+}
+
+class WebSocketDeflateStreamTest : public ::testing::Test {
+ protected:
+  WebSocketDeflateStreamTest() {}
+
+  void Initialize(const WebSocketDeflateStream::Parameters& parameters) {
+    fake_stream_ = new FakeWebSocketStream;
+    deflate_stream_.reset(new WebSocketDeflateStream(
+        scoped_ptr<WebSocketStream>(fake_stream_), parameters));
+  }
+
+  // Writes a text message made of one frame per element of |payloads|
+  // through |deflate_stream_|.
+  void WriteMessage(const std::string* payloads, size_t count) {
+    ScopedVector<WebSocketFrameChunk> frames;
+    for (size_t i = 0; i < count; ++i) {
+      frames.push_back(MakeChunk(
+          i == 0 ? WebSocketFrameHeader::kOpCodeText
+                 : WebSocketFrameHeader::kOpCodeContinuation,
+          i + 1 == count, false, payloads[i]).release());
+    }
+    TestCompletionCallback callback;
+    EXPECT_EQ(OK, deflate_stream_->WriteFrames(&frames, callback.callback()));
+  }
+
+  // Reads |frames| back through a second WebSocketDeflateStream, and returns
+  // the concatenated payloads.
+  std::string ReadMessage(ScopedVector<WebSocketFrameChunk>* frames,
+                          const WebSocketDeflateStream::Parameters& params) {
+    FakeWebSocketStream* reader = new FakeWebSocketStream;
+    WebSocketDeflateStream read_stream(scoped_ptr<WebSocketStream>(reader),
+                                       params);
+    reader->PrepareReadFrames(frames);
+    ScopedVector<WebSocketFrameChunk> read_frames;
+    TestCompletionCallback callback;
+    EXPECT_EQ(OK, read_stream.ReadFrames(&read_frames, callback.callback()));
+    std::string message;
+    for (size_t i = 0; i < read_frames.size(); ++i) {
+      EXPECT_FALSE(read_frames[i]->header->reserved1);
+      message += ToString(read_frames[i]);
+    }
+    return message;
+  }
+
+  FakeWebSocketStream* fake_stream_;
+  scoped_ptr<WebSocketDeflateStream> deflate_stream_;
+};
+
+TEST(WebSocketDeflateStreamParametersTest, ParseParameters) {
+  WebSocketDeflateStream::Parameters params;
+  EXPECT_FALSE(WebSocketDeflateStream::ParseParameters("", &params));
+  EXPECT_FALSE(WebSocketDeflateStream::ParseParameters("x-webkit-deflate-frame",
+                                                       &params));
+
+  ASSERT_TRUE(WebSocketDeflateStream::ParseParameters("permessage-deflate",
+                                                      &params));
+  EXPECT_FALSE(params.client_no_context_takeover);
+  EXPECT_FALSE(params.server_no_context_takeover);
+  EXPECT_EQ(WebSocketDeflateStream::kMaxWindowBits,
+            params.client_max_window_bits);
+  EXPECT_EQ(WebSocketDeflateStream::kMaxWindowBits,
+            params.server_max_window_bits);
+
+  ASSERT_TRUE(WebSocketDeflateStream::ParseParameters(
+      "foo, permessage-deflate; client_no_context_takeover; "
+      "server_no_context_takeover ; server_max_window_bits = 10; "
+      "client_max_window_bits=12",
+      &params));
+  EXPECT_TRUE(params.client_no_context_takeover);
+  EXPECT_TRUE(params.server_no_context_takeover);
+  EXPECT_EQ(12, params.client_max_window_bits);
+  EXPECT_EQ(10, params.server_max_window_bits);
+
+  EXPECT_TRUE(WebSocketDeflateStream::ParseParameters(
+      "permessage-deflate; client_max_window_bits", &params));
+  EXPECT_FALSE(WebSocketDeflateStream::ParseParameters(
+      "permessage-deflate; server_max_window_bits", &params));
+  EXPECT_FALSE(WebSocketDeflateStream::ParseParameters(
+      "permessage-deflate; server_max_window_bits=16", &params));
+  EXPECT_FALSE(WebSocketDeflateStream::ParseParameters(
+      "permessage-deflate; client_max_window_bits=7", &params));
+  EXPECT_FALSE(WebSocketDeflateStream::ParseParameters(
+      "permessage-deflate; client_no_context_takeover=1", &params));
+  EXPECT_FALSE(WebSocketDeflateStream::ParseParameters(
+      "permessage-deflate; unknown_parameter", &params));
+}
+
+TEST_F(WebSocketDeflateStreamTest, WriteSetsReserved1OnFirstFrameOnly) {
+  WebSocketDeflateStream::Parameters params;
+  Initialize(params);
+  const std::string payloads[] = { "Hello, ", "world" };
+  WriteMessage(payloads, arraysize(payloads));
+
+  ScopedVector<WebSocketFrameChunk>* written = fake_stream_->written_frames();
+  ASSERT_EQ(2u, written->size());
+  EXPECT_EQ(WebSocketFrameHeader::kOpCodeText, (*written)[0]->header->opcode);
+  EXPECT_TRUE((*written)[0]->header->reserved1);
+  EXPECT_FALSE((*written)[0]->header->final);
+  EXPECT_EQ(WebSocketFrameHeader::kOpCodeContinuation,
+            (*written)[1]->header->opcode);
+  EXPECT_FALSE((*written)[1]->header->reserved1);
+  EXPECT_TRUE((*written)[1]->header->final);
+  for (size_t i = 0; i < written->size(); ++i) {
+    EXPECT_EQ(ToString((*written)[i]).size(),
+              (*written)[i]->header->payload_length);
+  }
+}
+
+TEST_F(WebSocketDeflateStreamTest, RoundTrip) {
+  WebSocketDeflateStream::Parameters params;
+  Initialize(params);
+  const std::string payloads[] = {
+    "{\"id\": 1, \"name\": \"update\", ",
+    "\"values\": [1, 2, 3, 4, 5, 6, 7, 8, 9, 10]}",
+  };
+  WriteMessage(payloads, arraysize(payloads));
+  EXPECT_EQ(payloads[0] + payloads[1],
+            ReadMessage(fake_stream_->written_frames(), params));
+}
+
+TEST_F(WebSocketDeflateStreamTest, ChunksOfAFrameAreBuffered) {
+  WebSocketDeflateStream::Parameters params;
+  Initialize(params);
+  ScopedVector<WebSocketFrameChunk> frames;
+  frames.push_back(MakeChunk(WebSocketFrameHeader::kOpCodeText, true, false,
+                             "split ").release());
+  frames[0]->header->payload_length = 11;
+  frames[0]->final_chunk = false;
+  TestCompletionCallback callback;
+  EXPECT_EQ(OK, deflate_stream_->WriteFrames(&frames, callback.callback()));
+  EXPECT_TRUE(fake_stream_->written_frames()->empty());
+
+  frames.clear();
+  scoped_ptr<WebSocketFrameChunk> rest(new WebSocketFrameChunk);
+  rest->final_chunk = true;
+  rest->data = new IOBufferWithSize(5);
+  memcpy(rest->data->data(), "chunk", 5);
+  frames.push_back(rest.release());
+  EXPECT_EQ(OK, deflate_stream_->WriteFrames(&frames, callback.callback()));
+  ASSERT_EQ(1u, fake_stream_->written_frames()->size());
+  EXPECT_EQ("split chunk",
+            ReadMessage(fake_stream_->written_frames(), params));
+}
+
+TEST_F(WebSocketDeflateStreamTest, ContextTakeoverShrinksRepeatedMessages) {
+  const std::string message =
+      "{\"ticker\": \"GOOG\", \"bid\": 887.25, \"ask\": 887.50}";
+
+  WebSocketDeflateStream::Parameters params;
+  Initialize(params);
+  WriteMessage(&message, 1);
+  WriteMessage(&message, 1);
+  ScopedVector<WebSocketFrameChunk>* written = fake_stream_->written_frames();
+  ASSERT_EQ(2u, written->size());
+  EXPECT_LT((*written)[1]->header->payload_length,
+            (*written)[0]->header->payload_length);
+  EXPECT_EQ(message + message, ReadMessage(written, params));
+
+  params.client_no_context_takeover = true;
+  params.server_no_context_takeover = true;
+  Initialize(params);
+  WriteMessage(&message, 1);
+  WriteMessage(&message, 1);
+  written = fake_stream_->written_frames();
+  ASSERT_EQ(2u, written->size());
+  EXPECT_EQ((*written)[0]->header->payload_length,
+            (*written)[1]->header->payload_length);
+  EXPECT_EQ(message + message, ReadMessage(written, params));
+}
+
+TEST_F(WebSocketDeflateStreamTest, ControlFramesPassThrough) {
+  WebSocketDeflateStream::Parameters params;
+  Initialize(params);
+  ScopedVector<WebSocketFrameChunk> frames;
+  frames.push_back(MakeChunk(WebSocketFrameHeader::kOpCodePing, true, false,
+                             "ping").release());
+  TestCompletionCallback callback;
+  EXPECT_EQ(OK, deflate_stream_->WriteFrames(&frames, callback.callback()));
+  ScopedVector<WebSocketFrameChunk>* written = fake_stream_->written_frames();
+  ASSERT_EQ(1u, written->size());
+  EXPECT_FALSE((*written)[0]->header->reserved1);
+  EXPECT_EQ("ping", ToString((*written)[0]));
+}
+
+TEST_F(WebSocketDeflateStreamTest, UncompressedMessagesPassThrough) {
+  WebSocketDeflateStream::Parameters params;
+  ScopedVector<WebSocketFrameChunk> frames;
+  frames.push_back(MakeChunk(WebSocketFrameHeader::kOpCodeText, true, false,
+                             "plain").release());
+  EXPECT_EQ("plain", ReadMessage(&frames, params));
+}
+
+TEST_F(WebSocketDeflateStreamTest, CorruptPayloadIsProtocolError) {
+  WebSocketDeflateStream::Parameters params;
+  Initialize(params);
+  ScopedVector<WebSocketFrameChunk> frames;
+  frames.push_back(MakeChunk(WebSocketFrameHeader::kOpCodeText, true, true,
+                             "\xff\xff\xff\xff").release());
+  fake_stream_->PrepareReadFrames(&frames);
+  ScopedVector<WebSocketFrameChunk> read_frames;
+  TestCompletionCallback callback;
+  EXPECT_EQ(ERR_WS_PROTOCOL_ERROR,
+            deflate_stream_->ReadFrames(&read_frames, callback.callback()));
+}
+
+TEST_F(WebSocketDeflateStreamTest, Reserved1OnContinuationIsProtocolError) {
+  WebSocketDeflateStream::Parameters params;
+  Initialize(params);
+  ScopedVector<WebSocketFrameChunk> frames;
+  frames.push_back(MakeChunk(WebSocketFrameHeader::kOpCodeText, false, false,
+                             "a").release());
+  frames.push_back(MakeChunk(WebSocketFrameHeader::kOpCodeContinuation, true,
+                             true, "b").release());
+  fake_stream_->PrepareReadFrames(&frames);
+  ScopedVector<WebSocketFrameChunk> read_frames;
+  TestCompletionCallback callback;
+  EXPECT_EQ(ERR_WS_PROTOCOL_ERROR,
+            deflate_stream_->ReadFrames(&read_frames, callback.callback()));
+}
+
+}  // namespace
+}  // namespace net
@@ -9,10 +9,18 @@
 #include "base/basictypes.h"
 #include "base/logging.h"
 #include "base/rand_util.h"
+#include "build/build_config.h"
 #include "net/base/big_endian.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
 
+#if defined(ARCH_CPU_X86_FAMILY) && \
+    (defined(__SSE2__) || defined(_M_X64) || \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define WEBSOCKET_FRAME_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace {
 
 const uint8 kFinalBit = 0x80;
@@ -209,9 +217,27 @@ void MaskWebSocketFramePayload(const WebSocketMaskingKey& masking_key,
            kMaskingKeyLength);
   }
 
+  char* merged = aligned_begin;
+#if defined(WEBSOCKET_FRAME_USE_SSE2)
+  // Mask 16 bytes at a time for as long as possible. The distance from
+  // |aligned_begin| stays a multiple of kMaskingKeyLength, so the same
+  // realigned mask applies to every block.
+  static const size_t kVectorSize = sizeof(__m128i);
+  char vector_mask_key[kVectorSize];
+  for (size_t i = 0; i < kVectorSize; i += kMaskingKeyLength)
+    memcpy(vector_mask_key + i, realigned_mask, kMaskingKeyLength);
+  const __m128i packed_vector_mask_key =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(vector_mask_key));
+  for (; static_cast<size_t>(aligned_end - merged) >= kVectorSize;
+       merged += kVectorSize) {
+    __m128i* block = reinterpret_cast<__m128i*>(merged);
+    _mm_storeu_si128(block, _mm_xor_si128(_mm_loadu_si128(block),
+                                          packed_vector_mask_key));
+  }
+#endif
+
   // The main loop.
-  for (char* merged = aligned_begin; merged != aligned_end;
-       merged += kPackedMaskKeySize) {
+  for (; merged != aligned_end; merged += kPackedMaskKeySize) {
     // This is not quite standard-compliant C++. However, the standard-compliant
     // equivalent (using memcpy()) compiles to slower code using g++. In
     // practice, this will work for the compilers and architectures currently
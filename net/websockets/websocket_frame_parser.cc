@@ -29,13 +29,40 @@ const uint64 kMaxPayloadLengthWithoutExtendedLengthField = 125;
 const uint64 kPayloadLengthWithTwoByteExtendedLengthField = 126;
 const uint64 kPayloadLengthWithEightByteExtendedLengthField = 127;
 
+// The maximum size of a frame header, which is the most data that may need to
+// be carried over from one call to Decode() to the next.
+const size_t kMaximumFrameHeaderSize =
+    net::WebSocketFrameHeader::kBaseHeaderSize +
+    net::WebSocketFrameHeader::kMaximumExtendedLengthSize +
+    net::WebSocketFrameHeader::kMaskingKeyLength;
+
 }  // Unnamed namespace.
 
 namespace net {
 
+namespace {
+
+// Refers to |size| bytes of |buffer| starting at |offset|, and keeps |buffer|
+// alive for as long as it is.
+class SlicedIOBuffer : public IOBufferWithSize {
+ public:
+  SlicedIOBuffer(IOBuffer* buffer, int offset, int size)
+      : IOBufferWithSize(buffer->data() + offset, size),
+        buffer_(buffer) {}
+
+ private:
+  virtual ~SlicedIOBuffer() {
+    // |data_| is owned by |buffer_|.
+    data_ = NULL;
+  }
+
+  scoped_refptr<IOBuffer> buffer_;
+};
+
+}  // namespace
+
 WebSocketFrameParser::WebSocketFrameParser()
-    : current_read_pos_(0),
-      frame_offset_(0),
+    : frame_offset_(0),
       websocket_error_(kWebSocketNormalClosure) {
   std::fill(masking_key_.key,
             masking_key_.key + WebSocketFrameHeader::kMaskingKeyLength,
@@ -48,66 +75,94 @@ bool WebSocketFrameParser::Decode(
     const char* data,
     size_t length,
     ScopedVector<WebSocketFrameChunk>* frame_chunks) {
+  return DecodeInternal(data, length, NULL, frame_chunks);
+}
+
+bool WebSocketFrameParser::DecodeInPlace(
+    IOBuffer* buffer,
+    size_t length,
+    ScopedVector<WebSocketFrameChunk>* frame_chunks) {
+  return DecodeInternal(buffer->data(), length, buffer, frame_chunks);
+}
+
+bool WebSocketFrameParser::DecodeInternal(
+    const char* data,
+    size_t length,
+    IOBuffer* buffer,
+    ScopedVector<WebSocketFrameChunk>* frame_chunks) {
   if (websocket_error_ != kWebSocketNormalClosure)
     return false;
   if (!length)
     return true;
 
-  // TODO(yutak): Remove copy.
-  buffer_.insert(buffer_.end(), data, data + length);
-
-  while (current_read_pos_ < buffer_.size()) {
+  const char* current = data;
+  const char* const end = data + length;
+  while (current < end) {
     bool first_chunk = false;
     if (!current_frame_header_.get()) {
-      DecodeFrameHeader();
+      // Headers are decoded straight from |data| unless the start of one was
+      // carried over from the previous round, in which case only as many
+      // bytes as a header can take are appended to it.
+      const char* header_data = current;
+      size_t header_data_length = end - current;
+      size_t carried_over = incomplete_header_.size();
+      if (carried_over) {
+        size_t appended = std::min(header_data_length,
+                                   kMaximumFrameHeaderSize - carried_over);
+        incomplete_header_.insert(incomplete_header_.end(),
+                                  current, current + appended);
+        header_data = &incomplete_header_.front();
+        header_data_length = incomplete_header_.size();
+      }
+
+      size_t header_size = DecodeFrameHeader(header_data, header_data_length);
       if (websocket_error_ != kWebSocketNormalClosure)
         return false;
       // If frame header is incomplete, then carry over the remaining
       // data to the next round of Decode().
-      if (!current_frame_header_.get())
+      if (!current_frame_header_.get()) {
+        if (!carried_over)
+          incomplete_header_.assign(current, end);
+        DCHECK_LT(incomplete_header_.size(), kMaximumFrameHeaderSize);
         break;
+      }
+      DCHECK_GE(header_size, carried_over);
+      current += header_size - carried_over;
+      incomplete_header_.clear();
       first_chunk = true;
     }
 
+    size_t consumed = 0;
     scoped_ptr<WebSocketFrameChunk> frame_chunk =
-        DecodeFramePayload(first_chunk);
+        DecodeFramePayload(first_chunk, current, end - current, buffer,
+                           &consumed);
     DCHECK(frame_chunk.get());
     frame_chunks->push_back(frame_chunk.release());
+    current += consumed;
 
     if (current_frame_header_.get()) {
-      DCHECK(current_read_pos_ == buffer_.size());
+      DCHECK(current == end);
       break;
     }
   }
 
-  // Drain unnecessary data. TODO(yutak): Remove copy. (but how?)
-  buffer_.erase(buffer_.begin(), buffer_.begin() + current_read_pos_);
-  current_read_pos_ = 0;
-
-  // Sanity check: the size of carried-over data should not exceed
-  // the maximum possible length of a frame header.
-  static const size_t kMaximumFrameHeaderSize =
-      WebSocketFrameHeader::kBaseHeaderSize +
-      WebSocketFrameHeader::kMaximumExtendedLengthSize +
-      WebSocketFrameHeader::kMaskingKeyLength;
-  DCHECK_LT(buffer_.size(), kMaximumFrameHeaderSize);
-
   return true;
 }
 
-void WebSocketFrameParser::DecodeFrameHeader() {
+size_t WebSocketFrameParser::DecodeFrameHeader(const char* data,
+                                               size_t length) {
   typedef WebSocketFrameHeader::OpCode OpCode;
   static const int kMaskingKeyLength = WebSocketFrameHeader::kMaskingKeyLength;
 
   DCHECK(!current_frame_header_.get());
 
-  const char* start = &buffer_.front() + current_read_pos_;
+  const char* start = data;
   const char* current = start;
-  const char* end = &buffer_.front() + buffer_.size();
+  const char* end = data + length;
 
   // Header needs 2 bytes at minimum.
   if (end - current < 2)
-    return;
+    return 0;
 
   uint8 first_byte = *current++;
   uint8 second_byte = *current++;
@@ -122,7 +177,7 @@ void WebSocketFrameParser::DecodeFrameHeader() {
   uint64 payload_length = second_byte & kPayloadLengthMask;
   if (payload_length == kPayloadLengthWithTwoByteExtendedLengthField) {
     if (end - current < 2)
-      return;
+      return 0;
     uint16 payload_length_16;
     ReadBigEndian(current, &payload_length_16);
     current += 2;
@@ -131,7 +186,7 @@ void WebSocketFrameParser::DecodeFrameHeader() {
       websocket_error_ = kWebSocketErrorProtocolError;
   } else if (payload_length == kPayloadLengthWithEightByteExtendedLengthField) {
     if (end - current < 8)
-      return;
+      return 0;
     ReadBigEndian(current, &payload_length);
     current += 8;
     if (payload_length <= kuint16max ||
@@ -142,16 +197,15 @@ void WebSocketFrameParser::DecodeFrameHeader() {
     }
   }
   if (websocket_error_ != kWebSocketNormalClosure) {
-    buffer_.clear();
-    current_read_pos_ = 0;
+    incomplete_header_.clear();
     current_frame_header_.reset();
     frame_offset_ = 0;
-    return;
+    return 0;
   }
 
   if (masked) {
     if (end - current < kMaskingKeyLength)
-      return;
+      return 0;
     std::copy(current, current + kMaskingKeyLength, masking_key_.key);
     current += kMaskingKeyLength;
   } else {
@@ -165,16 +219,18 @@ void WebSocketFrameParser::DecodeFrameHeader() {
   current_frame_header_->reserved3 = reserved3;
   current_frame_header_->masked = masked;
   current_frame_header_->payload_length = payload_length;
-  current_read_pos_ += current - start;
   DCHECK_EQ(0u, frame_offset_);
+  return current - start;
 }
 
 scoped_ptr<WebSocketFrameChunk> WebSocketFrameParser::DecodeFramePayload(
-    bool first_chunk) {
-  const char* current = &buffer_.front() + current_read_pos_;
-  const char* end = &buffer_.front() + buffer_.size();
+    bool first_chunk,
+    const char* data,
+    size_t length,
+    IOBuffer* buffer,
+    size_t* consumed) {
   uint64 next_size = std::min<uint64>(
-      end - current, current_frame_header_->payload_length - frame_offset_);
+      length, current_frame_header_->payload_length - frame_offset_);
   // This check must pass because |payload_length| is already checked to be
   // less than std::numeric_limits<int>::max() when the header is parsed.
   DCHECK_LE(next_size, static_cast<uint64>(kint32max));
@@ -185,19 +241,23 @@ scoped_ptr<WebSocketFrameChunk> WebSocketFrameParser::DecodeFramePayload(
   }
   frame_chunk->final_chunk = false;
   if (next_size) {
-    frame_chunk->data = new IOBufferWithSize(static_cast<int>(next_size));
-    char* io_data = frame_chunk->data->data();
-    memcpy(io_data, current, next_size);
+    if (buffer) {
+      frame_chunk->data = new SlicedIOBuffer(
+          buffer, data - buffer->data(), static_cast<int>(next_size));
+    } else {
+      frame_chunk->data = new IOBufferWithSize(static_cast<int>(next_size));
+      memcpy(frame_chunk->data->data(), data, next_size);
+    }
     if (current_frame_header_->masked) {
       // The masking function is its own inverse, so we use the same function to
       // unmask as to mask.
       MaskWebSocketFramePayload(
-          masking_key_, frame_offset_, io_data, next_size);
+          masking_key_, frame_offset_, frame_chunk->data->data(), next_size);
     }
 
-    current_read_pos_ += next_size;
     frame_offset_ += next_size;
   }
+  *consumed = next_size;
 
   DCHECK_LE(frame_offset_, current_frame_header_->payload_length);
   if (frame_offset_ == current_frame_header_->payload_length) {
@@ -17,6 +17,8 @@
 
 namespace net {
 
+class IOBuffer;
+
 // Parses WebSocket frames from byte stream.
 //
 // Specification of WebSocket frame format is available at
@@ -40,6 +42,14 @@ class NET_EXPORT WebSocketFrameParser {
               size_t length,
               ScopedVector<WebSocketFrameChunk>* frame_chunks);
 
+  // Like Decode(), but decodes the first |length| bytes of |buffer| without
+  // copying the payload: the |data| of each chunk refers to |buffer|, and
+  // masked payloads are unmasked in place. |buffer| must not be modified while
+  // any of the chunks is alive.
+  bool DecodeInPlace(IOBuffer* buffer,
+                     size_t length,
+                     ScopedVector<WebSocketFrameChunk>* frame_chunks);
+
   // Returns kWebSocketNormalClosure if the parser has not failed to decode
   // WebSocket frames. Otherwise returns WebSocketError which is defined in
   // websocket_errors.h. We can convert net::WebSocketError to net::Error by
@@ -47,27 +57,39 @@ class NET_EXPORT WebSocketFrameParser {
   WebSocketError websocket_error() const { return websocket_error_; }
 
  private:
-  // Tries to decode a frame header from |current_read_pos_|.
-  // If successful, this function updates |current_read_pos_|,
-  // |current_frame_header_|, and |masking_key_| (if available).
-  // This function may set |failed_| to true if it observes a corrupt frame.
-  // If there is not enough data in the remaining buffer to parse a frame
-  // header, this function returns without doing anything.
-  void DecodeFrameHeader();
-
-  // Decodes frame payload and creates a WebSocketFrameChunk object.
-  // This function updates |current_read_pos_| and |frame_offset_| after
-  // parsing. This function returns a frame object even if no payload data is
-  // available at this moment, so the receiver could make use of frame header
-  // information. If the end of frame is reached, this function clears
-  // |current_frame_header_|, |frame_offset_| and |masking_key_|.
-  scoped_ptr<WebSocketFrameChunk> DecodeFramePayload(bool first_chunk);
-
-  // Internal buffer to store the data to parse.
-  std::vector<char> buffer_;
-
-  // Position in |buffer_| where the next round of parsing starts.
-  size_t current_read_pos_;
+  // Decodes |data| for Decode() and DecodeInPlace(). If |buffer| is non-NULL,
+  // |data| points into it and the payload of the chunks refers to it.
+  bool DecodeInternal(const char* data,
+                      size_t length,
+                      IOBuffer* buffer,
+                      ScopedVector<WebSocketFrameChunk>* frame_chunks);
+
+  // Tries to decode a frame header from the |length| bytes at |data|.
+  // If successful, this function updates |current_frame_header_| and
+  // |masking_key_| (if available), and returns the size of the header.
+  // This function may set |websocket_error_| if it observes a corrupt frame.
+  // If there is not enough data to parse a frame header, this function
+  // returns 0 without doing anything.
+  size_t DecodeFrameHeader(const char* data, size_t length);
+
+  // Decodes frame payload from the |length| bytes at |data| and creates a
+  // WebSocketFrameChunk object, setting |*consumed| to the number of bytes
+  // used. The payload is copied unless |buffer| is non-NULL, in which case
+  // it is unmasked in place and the chunk refers to it. This function updates
+  // |frame_offset_| after parsing. This function returns a frame object even
+  // if no payload data is available at this moment, so the receiver could
+  // make use of frame header information. If the end of frame is reached,
+  // this function clears |current_frame_header_|, |frame_offset_| and
+  // |masking_key_|.
+  scoped_ptr<WebSocketFrameChunk> DecodeFramePayload(bool first_chunk,
+                                                     const char* data,
+                                                     size_t length,
+                                                     IOBuffer* buffer,
+                                                     size_t* consumed);
+
+  // The start of a frame header that was split across calls to Decode(). Only
+  // header bytes are ever carried over, so this stays small.
+  std::vector<char> incomplete_header_;
 
   // Frame header and masking key of the current frame.
   // |masking_key_| is filled with zeros if the current frame is not masked.
@@ -5,6 +5,7 @@
 #include "net/websockets/websocket_frame_parser.h"
 
 #include <algorithm>
+#include <string>
 #include <vector>
 
 #include "base/basictypes.h"
@@ -103,6 +104,54 @@ TEST(WebSocketFrameParserTest, DecodeMaskedFrame) {
   EXPECT_TRUE(std::equal(kHello, kHello + kHelloLength, frame->data->data()));
 }
 
+TEST(WebSocketFrameParserTest, DecodeInPlace) {
+  WebSocketFrameParser parser;
+
+  // A masked frame followed by the first half of an unmasked one, the rest of
+  // which arrives in a second buffer.
+  std::string input(kMaskedHelloFrame, kMaskedHelloFrameLength);
+  input.append(kHelloFrame, kHelloFrameLength);
+  const size_t kFirstLength = kMaskedHelloFrameLength + kHelloFrameLength / 2;
+  scoped_refptr<IOBuffer> first_buffer(new IOBuffer(kFirstLength));
+  std::copy(input.begin(), input.begin() + kFirstLength, first_buffer->data());
+  const size_t kSecondLength = input.size() - kFirstLength;
+  scoped_refptr<IOBuffer> second_buffer(new IOBuffer(kSecondLength));
+  std::copy(input.begin() + kFirstLength, input.end(), second_buffer->data());
+
+  ScopedVector<WebSocketFrameChunk> frames;
+  EXPECT_TRUE(parser.DecodeInPlace(first_buffer.get(), kFirstLength, &frames));
+  EXPECT_TRUE(
+      parser.DecodeInPlace(second_buffer.get(), kSecondLength, &frames));
+  EXPECT_EQ(kWebSocketNormalClosure, parser.websocket_error());
+  ASSERT_EQ(3u, frames.size());
+
+  // The masked payload was unmasked where it was read.
+  ASSERT_TRUE(frames[0]->header.get());
+  EXPECT_TRUE(frames[0]->header->masked);
+  EXPECT_TRUE(frames[0]->final_chunk);
+  ASSERT_EQ(static_cast<int>(kHelloLength), frames[0]->data->size());
+  EXPECT_EQ(first_buffer->data() + kMaskedHelloFrameLength - kHelloLength,
+            frames[0]->data->data());
+  EXPECT_TRUE(std::equal(kHello, kHello + kHelloLength,
+                         frames[0]->data->data()));
+
+  ASSERT_TRUE(frames[1]->header.get());
+  EXPECT_FALSE(frames[1]->final_chunk);
+  ASSERT_TRUE(frames[1]->data.get());
+  EXPECT_TRUE(frames[2]->header.get() == NULL);
+  EXPECT_TRUE(frames[2]->final_chunk);
+  EXPECT_EQ(second_buffer->data(), frames[2]->data->data());
+  std::string payload(frames[1]->data->data(), frames[1]->data->size());
+  payload.append(frames[2]->data->data(), frames[2]->data->size());
+  EXPECT_EQ(std::string(kHello, kHelloLength), payload);
+
+  // The chunks keep the buffers they refer to alive.
+  first_buffer = NULL;
+  second_buffer = NULL;
+  EXPECT_TRUE(std::equal(kHello, kHello + kHelloLength,
+                         frames[0]->data->data()));
+}
+
 TEST(WebSocketFrameParserTest, DecodeManyFrames) {
   struct Input {
     const char* frame;
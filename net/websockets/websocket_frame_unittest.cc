@@ -375,12 +375,15 @@ class WebSocketFrameTestMaskBenchmark : public testing::Test {
       MaskWebSocketFramePayload(
           masking_key, x % size, &scratch.front(), scratch.size());
     }
-    double total_time_ms =
-        1000 * (TimeTicks::HighResNow() - start).InMillisecondsF() /
-        iterations_;
+    double elapsed_ms = (TimeTicks::HighResNow() - start).InMillisecondsF();
+    double total_time_ms = 1000 * elapsed_ms / iterations_;
+    double megabytes_per_second =
+        static_cast<double>(size) * iterations_ / (1024 * 1024) /
+        (elapsed_ms / 1000);
     LOG(INFO) << "Payload size " << size
-              << base::StringPrintf(" took %.03f microseconds per iteration",
-                                    total_time_ms);
+              << base::StringPrintf(" took %.03f microseconds per iteration "
+                                    "(%.01f MB/s)",
+                                    total_time_ms, megabytes_per_second);
   }
 
  private:
@@ -400,6 +403,14 @@ TEST_F(WebSocketFrameTestMaskBenchmark, BenchmarkMaskLongPayload) {
   Benchmark(payload.get(), kLongPayloadSize);
 }
 
+// A payload that doesn't start on a word boundary and whose length isn't a
+// multiple of the word size exercises every part of the masking loop.
+TEST_F(WebSocketFrameTestMaskBenchmark, BenchmarkMaskUnalignedLongPayload) {
+  scoped_ptr<char[]> payload(new char[kLongPayloadSize]);
+  std::fill(payload.get(), payload.get() + kLongPayloadSize, 'a');
+  Benchmark(payload.get() + 1, kLongPayloadSize - 3);
+}
+
 // "IsKnownDataOpCode" is currently implemented in an "obviously correct"
 // manner, but we test is anyway in case it changes to a more complex
 // implementation in future.
@@ -35,6 +35,7 @@ ChromotingClient::ChromotingClient(
       task_runner_(client_context->main_task_runner()),
       connection_(connection),
       user_interface_(user_interface),
+      hardware_video_stub_(NULL),
       host_capabilities_received_(false),
       weak_factory_(this) {
   rectangle_decoder_ =
@@ -77,7 +78,7 @@ void ChromotingClient::Start(
                        this,
                        this,
                        this,
-                       rectangle_decoder_.get(),
+                       this,
                        audio_decode_scheduler_.get());
 }
 
@@ -85,6 +86,11 @@ FrameProducer* ChromotingClient::GetFrameProducer() {
   return rectangle_decoder_.get();
 }
 
+void ChromotingClient::SetHardwareVideoStub(protocol::VideoStub* video_stub) {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+  hardware_video_stub_ = video_stub;
+}
+
 ChromotingStats* ChromotingClient::GetStats() {
   DCHECK(task_runner_->BelongsToCurrentThread());
   return rectangle_decoder_->GetStats();
@@ -159,6 +165,17 @@ void ChromotingClient::OnConnectionReady(bool ready) {
   user_interface_->OnConnectionReady(ready);
 }
 
+void ChromotingClient::ProcessVideoPacket(scoped_ptr<VideoPacket> packet,
+                                          const base::Closure& done) {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+
+  if (hardware_video_stub_) {
+    hardware_video_stub_->ProcessVideoPacket(packet.Pass(), done);
+  } else {
+    rectangle_decoder_->ProcessVideoPacket(packet.Pass(), done);
+  }
+}
+
 void ChromotingClient::OnAuthenticated() {
   DCHECK(task_runner_->BelongsToCurrentThread());
 
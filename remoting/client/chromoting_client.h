@@ -40,7 +40,8 @@ class RectangleUpdateDecoder;
 class SignalStrategy;
 
 class ChromotingClient : public protocol::ConnectionToHost::HostEventCallback,
-                         public protocol::ClientStub {
+                         public protocol::ClientStub,
+                         public protocol::VideoStub {
  public:
   // |audio_player| may be null, in which case audio will not be requested.
   ChromotingClient(const ClientConfig& config,
@@ -59,6 +60,11 @@ class ChromotingClient : public protocol::ConnectionToHost::HostEventCallback,
 
   FrameProducer* GetFrameProducer();
 
+  // Routes video packets to |video_stub| instead of the software decoder, or
+  // back to the software decoder if |video_stub| is NULL. |video_stub| must
+  // outlive the client, or be replaced before it's destroyed.
+  void SetHardwareVideoStub(protocol::VideoStub* video_stub);
+
   // Return the stats recorded by this client.
   ChromotingStats* GetStats();
 
@@ -84,6 +90,10 @@ class ChromotingClient : public protocol::ConnectionToHost::HostEventCallback,
       protocol::ErrorCode error) OVERRIDE;
   virtual void OnConnectionReady(bool ready) OVERRIDE;
 
+  // VideoStub implementation for receiving video packets from the host.
+  virtual void ProcessVideoPacket(scoped_ptr<VideoPacket> packet,
+                                  const base::Closure& done) OVERRIDE;
+
  private:
   // Called when the connection is authenticated.
   void OnAuthenticated();
@@ -98,6 +108,9 @@ class ChromotingClient : public protocol::ConnectionToHost::HostEventCallback,
   ClientUserInterface* user_interface_;
   scoped_refptr<RectangleUpdateDecoder> rectangle_decoder_;
 
+  // Receives the video packets instead of |rectangle_decoder_| if not NULL.
+  protocol::VideoStub* hardware_video_stub_;
+
   scoped_ptr<AudioDecodeScheduler> audio_decode_scheduler_;
 
   // If non-NULL, this is called when the client is done.
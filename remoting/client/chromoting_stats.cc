@@ -4,6 +4,8 @@
 
 #include "remoting/client/chromoting_stats.h"
 
+#include "remoting/proto/video.pb.h"
+
 namespace {
 
 // The default window of bandwidth and frame rate in seconds.
@@ -23,10 +25,31 @@ ChromotingStats::ChromotingStats()
       video_encode_ms_(kLatencyWindow),
       video_decode_ms_(kLatencyWindow),
       video_paint_ms_(kLatencyWindow),
-      round_trip_ms_(kLatencyWindow) {
+      round_trip_ms_(kLatencyWindow),
+      latest_sequence_number_(0) {
 }
 
 ChromotingStats::~ChromotingStats() {
 }
 
+void ChromotingStats::RecordVideoPacketStats(const VideoPacket& packet) {
+  // Add one frame to the counter.
+  video_frame_rate_.Record(1);
+
+  // Record other statistics received from host.
+  video_bandwidth_.Record(packet.data().size());
+  if (packet.has_capture_time_ms())
+    video_capture_ms_.Record(packet.capture_time_ms());
+  if (packet.has_encode_time_ms())
+    video_encode_ms_.Record(packet.encode_time_ms());
+  if (packet.has_client_sequence_number() &&
+      packet.client_sequence_number() > latest_sequence_number_) {
+    latest_sequence_number_ = packet.client_sequence_number();
+    base::TimeDelta round_trip_latency =
+        base::Time::Now() -
+        base::Time::FromInternalValue(packet.client_sequence_number());
+    round_trip_ms_.Record(round_trip_latency.InMilliseconds());
+  }
+}
+
 }  // namespace remoting
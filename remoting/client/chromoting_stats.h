@@ -13,6 +13,8 @@
 
 namespace remoting {
 
+class VideoPacket;
+
 class ChromotingStats {
  public:
   ChromotingStats();
@@ -26,6 +28,10 @@ class ChromotingStats {
   RunningAverage* video_paint_ms() { return &video_paint_ms_; }
   RunningAverage* round_trip_ms() { return &round_trip_ms_; }
 
+  // Records the frame rate, bandwidth and latencies reported by a non-empty
+  // video |packet| received from the host.
+  void RecordVideoPacketStats(const VideoPacket& packet);
+
  private:
   RateCounter video_bandwidth_;
   RateCounter video_frame_rate_;
@@ -35,6 +41,9 @@ class ChromotingStats {
   RunningAverage video_paint_ms_;
   RunningAverage round_trip_ms_;
 
+  // The most recent sequence number bounced back from the host.
+  int64 latest_sequence_number_;
+
   DISALLOW_COPY_AND_ASSIGN(ChromotingStats);
 };
 
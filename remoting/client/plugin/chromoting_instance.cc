@@ -36,11 +36,13 @@
 #include "remoting/client/plugin/pepper_port_allocator.h"
 #include "remoting/client/plugin/pepper_signal_strategy.h"
 #include "remoting/client/plugin/pepper_token_fetcher.h"
+#include "remoting/client/plugin/pepper_video_renderer_3d.h"
 #include "remoting/client/plugin/pepper_view.h"
 #include "remoting/client/rectangle_update_decoder.h"
 #include "remoting/protocol/connection_to_host.h"
 #include "remoting/protocol/host_stub.h"
 #include "remoting/protocol/libjingle_transport_factory.h"
+#include "remoting/protocol/session_config.h"
 #include "url/gurl.h"
 
 // Windows defines 'PostMessage', so we have to undef it.
@@ -144,7 +146,7 @@ logging::LogMessageHandlerFunction g_logging_old_handler = NULL;
 const char ChromotingInstance::kApiFeatures[] =
     "highQualityScaling injectKeyEvent sendClipboardItem remapKey trapKey "
     "notifyClientDimensions notifyClientResolution pauseVideo pauseAudio "
-    "asyncPin thirdPartyAuth pinlessAuth extensionMessage";
+    "asyncPin thirdPartyAuth pinlessAuth extensionMessage hardwareDecoding";
 
 const char ChromotingInstance::kRequestedCapabilities[] = "";
 const char ChromotingInstance::kSupportedCapabilities[] = "desktopShape";
@@ -173,6 +175,7 @@ ChromotingInstance::ChromotingInstance(PP_Instance pp_instance)
       initialized_(false),
       plugin_task_runner_(new PluginThreadTaskRunner(&plugin_thread_delegate_)),
       context_(plugin_task_runner_.get()),
+      use_hardware_decoding_(false),
       input_tracker_(&mouse_input_filter_),
 #if defined(OS_MACOSX)
       // On Mac we need an extra filter to inject missing keyup events.
@@ -211,6 +214,7 @@ ChromotingInstance::~ChromotingInstance() {
 
   // PepperView must be destroyed before the client.
   view_.reset();
+  video_renderer_3d_.reset();
 
   client_.reset();
 
@@ -313,6 +317,14 @@ void ChromotingInstance::HandleMessage(const pp::Var& message) {
       }
     }
 
+    // Check whether the video should be decoded in hardware, if possible.
+    if (data->HasKey("hardwareDecoding")) {
+      if (!data->GetBoolean("hardwareDecoding", &use_hardware_decoding_)) {
+        LOG(ERROR) << "Invalid connect() data.";
+        return;
+      }
+    }
+
     Connect(config);
   } else if (method == "disconnect") {
     Disconnect();
@@ -451,6 +463,11 @@ void ChromotingInstance::DidChangeView(const pp::View& view) {
     view_->SetView(view);
     mouse_input_filter_.set_input_size(view_->get_view_size_dips());
   }
+  if (video_renderer_3d_) {
+    video_renderer_3d_->SetView(view);
+    mouse_input_filter_.set_input_size(
+        video_renderer_3d_->get_view_size_dips());
+  }
 }
 
 bool ChromotingInstance::HandleInputEvent(const pp::InputEvent& event) {
@@ -498,9 +515,28 @@ void ChromotingInstance::SetDesktopShape(const SkRegion& shape) {
   PostChromotingMessage("onDesktopShape", data.Pass());
 }
 
+void ChromotingInstance::OnVideoRendererFailed() {
+  DCHECK(plugin_task_runner_->BelongsToCurrentThread());
+
+  // Stop sending packets to the renderer now, but destroy it later, since
+  // it's reporting the failure from one of its callbacks.
+  client_->SetHardwareVideoStub(NULL);
+  plugin_task_runner_->PostTask(
+      FROM_HERE, base::Bind(&ChromotingInstance::UseSoftwareRenderer,
+                            weak_factory_.GetWeakPtr()));
+}
+
 void ChromotingInstance::OnConnectionState(
     protocol::ConnectionToHost::State state,
     protocol::ErrorCode error) {
+  // The Pepper video decoder is only used for VP8.
+  if (state == protocol::ConnectionToHost::AUTHENTICATED &&
+      video_renderer_3d_ &&
+      host_connection_->config().video_config().codec !=
+          protocol::ChannelConfig::CODEC_VP8) {
+    UseSoftwareRenderer();
+  }
+
   scoped_ptr<base::DictionaryValue> data(new base::DictionaryValue());
   data->SetString("state", ConnectionStateToString(state));
   data->SetString("error", ConnectionErrorToString(error));
@@ -691,24 +727,36 @@ void ChromotingInstance::Connect(const ClientConfig& config) {
 
   // RectangleUpdateDecoder runs on a separate thread so for now we wrap
   // PepperView with a ref-counted proxy object.
-  scoped_refptr<FrameConsumerProxy> consumer_proxy =
-      new FrameConsumerProxy(plugin_task_runner_);
+  frame_consumer_proxy_ = new FrameConsumerProxy(plugin_task_runner_);
 
   host_connection_.reset(new protocol::ConnectionToHost(true));
   scoped_ptr<AudioPlayer> audio_player(new PepperAudioPlayer(this));
   client_.reset(new ChromotingClient(config, &context_,
                                      host_connection_.get(), this,
-                                     consumer_proxy, audio_player.Pass()));
+                                     frame_consumer_proxy_,
+                                     audio_player.Pass()));
 
-  view_.reset(new PepperView(this, &context_, client_->GetFrameProducer()));
-  consumer_proxy->Attach(view_->AsWeakPtr());
-  if (!plugin_view_.is_null()) {
-    view_->SetView(plugin_view_);
-  }
-
-  // Connect the input pipeline to the protocol stub & initialize components.
+  // Connect the input pipeline to the protocol stub.
   mouse_input_filter_.set_input_stub(host_connection_->input_stub());
-  mouse_input_filter_.set_input_size(view_->get_view_size_dips());
+
+  // Use the Pepper video decoder, if the webapp wants it and the browser
+  // supports it, and the software decoder otherwise.
+  if (use_hardware_decoding_) {
+    video_renderer_3d_.reset(new PepperVideoRenderer3D(this));
+    if (video_renderer_3d_->Initialize()) {
+      client_->SetHardwareVideoStub(video_renderer_3d_.get());
+      if (!plugin_view_.is_null()) {
+        video_renderer_3d_->SetView(plugin_view_);
+      }
+      mouse_input_filter_.set_input_size(
+          video_renderer_3d_->get_view_size_dips());
+    } else {
+      LOG(INFO) << "Falling back to software video decoding.";
+      video_renderer_3d_.reset();
+    }
+  }
+  if (!video_renderer_3d_)
+    UseSoftwareRenderer();
 
   LOG(INFO) << "Connecting to " << config.host_jid
             << ". Local jid: " << config.local_jid << ".";
@@ -739,16 +787,39 @@ void ChromotingInstance::Disconnect() {
 
   // PepperView must be destroyed before the client.
   view_.reset();
+  video_renderer_3d_.reset();
 
   LOG(INFO) << "Disconnecting from host.";
 
   client_.reset();
+  frame_consumer_proxy_ = NULL;
 
   // Disconnect the input pipeline and teardown the connection.
   mouse_input_filter_.set_input_stub(NULL);
   host_connection_.reset();
 }
 
+void ChromotingInstance::UseSoftwareRenderer() {
+  DCHECK(plugin_task_runner_->BelongsToCurrentThread());
+
+  // Nothing to do if the client was disconnected meanwhile, or is already
+  // decoding in software.
+  if (!client_ || view_)
+    return;
+
+  // After a failure the software decoder can only decode the video again
+  // from the next key frame sent by the host.
+  client_->SetHardwareVideoStub(NULL);
+  video_renderer_3d_.reset();
+
+  view_.reset(new PepperView(this, &context_, client_->GetFrameProducer()));
+  frame_consumer_proxy_->Attach(view_->AsWeakPtr());
+  if (!plugin_view_.is_null()) {
+    view_->SetView(plugin_view_);
+  }
+  mouse_input_filter_.set_input_size(view_->get_view_size_dips());
+}
+
 void ChromotingInstance::OnIncomingIq(const std::string& iq) {
   // Just ignore the message if it's received before Connect() is called. It's
   // likely to be a leftover from a previous session, so it's safe to ignore it.
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "base/gtest_prod_util.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "ppapi/c/pp_instance.h"
@@ -61,6 +62,7 @@ class ClientContext;
 class FrameConsumerProxy;
 class PepperAudioPlayer;
 class PepperTokenFetcher;
+class PepperVideoRenderer3D;
 class PepperView;
 class PepperSignalStrategy;
 class RectangleUpdateDecoder;
@@ -135,11 +137,15 @@ class ChromotingInstance :
   virtual void SetCursorShape(
       const protocol::CursorShapeInfo& cursor_shape) OVERRIDE;
 
-  // Called by PepperView.
+  // Called by PepperView and PepperVideoRenderer3D.
   void SetDesktopSize(const SkISize& size, const SkIPoint& dpi);
   void SetDesktopShape(const SkRegion& shape);
   void OnFirstFrameReceived();
 
+  // Called by PepperVideoRenderer3D when it can't decode or draw the video,
+  // to switch to software decoding.
+  void OnVideoRendererFailed();
+
   // Return statistics record by ChromotingClient.
   // If no connection is currently active then NULL will be returned.
   ChromotingStats* GetStats();
@@ -228,6 +234,10 @@ class ChromotingInstance :
       bool pairing_supported,
       const protocol::SecretFetchedCallback& secret_fetched_callback);
 
+  // Replaces the hardware video renderer, if any, with a PepperView, which
+  // draws the video decoded in software.
+  void UseSoftwareRenderer();
+
   bool initialized_;
 
   PepperPluginThreadDelegate plugin_thread_delegate_;
@@ -237,6 +247,14 @@ class ChromotingInstance :
   scoped_ptr<PepperView> view_;
   pp::View plugin_view_;
 
+  // Draws the video instead of |view_| while the VP8 decoding is done by the
+  // Pepper video decoder. Only one of them exists at a time.
+  scoped_ptr<PepperVideoRenderer3D> video_renderer_3d_;
+  scoped_refptr<FrameConsumerProxy> frame_consumer_proxy_;
+
+  // True if the webapp asked for video to be decoded in hardware if possible.
+  bool use_hardware_decoding_;
+
   // Contains the most-recently-reported desktop shape, if any.
   scoped_ptr<SkRegion> desktop_shape_;
 
@@ -0,0 +1,528 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "remoting/client/plugin/pepper_video_renderer_3d.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <vector>
+
+#include "base/logging.h"
+#include "ppapi/c/pp_errors.h"
+#include "ppapi/c/ppb_opengles2.h"
+#include "ppapi/cpp/dev/buffer_dev.h"
+#include "ppapi/cpp/dev/video_decoder_dev.h"
+#include "ppapi/cpp/dev/view_dev.h"
+#include "ppapi/cpp/module.h"
+#include "ppapi/cpp/rect.h"
+#include "ppapi/cpp/view.h"
+#include "ppapi/lib/gl/include/GLES2/gl2.h"
+#include "ppapi/lib/gl/include/GLES2/gl2ext.h"
+#include "remoting/client/chromoting_stats.h"
+#include "remoting/client/plugin/chromoting_instance.h"
+#include "remoting/proto/video.pb.h"
+
+namespace remoting {
+
+namespace {
+
+// Id of no picture.
+const int32_t kNoPicture = -1;
+
+// Attribute locations of the vertex positions and texture coordinates.
+const GLuint kPositionLocation = 0;
+const GLuint kTexCoordLocation = 1;
+
+// Positions and texture coordinates of the corners of a quad covering the
+// whole view. Decoded pictures are stored bottom-up, as GL renders them.
+const GLfloat kVertices[] = {
+  -1, 1, -1, -1, 1, 1, 1, -1,  // Position coordinates.
+  0, 1, 0, 0, 1, 1, 1, 0,      // Texture coordinates.
+};
+
+const char kVertexShader[] =
+    "attribute vec2 a_position;\n"
+    "attribute vec2 a_texCoord;\n"
+    "varying vec2 v_texCoord;\n"
+    "void main() {\n"
+    "  v_texCoord = a_texCoord;\n"
+    "  gl_Position = vec4(a_position, 0.0, 1.0);\n"
+    "}\n";
+
+const char kFragmentShader2D[] =
+    "precision mediump float;\n"
+    "varying vec2 v_texCoord;\n"
+    "uniform sampler2D s_texture;\n"
+    "void main() {\n"
+    "  gl_FragColor = texture2D(s_texture, v_texCoord);\n"
+    "}\n";
+
+// Some decoders, e.g. on ARM ChromeOS devices, output external textures.
+const char kFragmentShaderExternal[] =
+    "#extension GL_OES_EGL_image_external : require\n"
+    "precision mediump float;\n"
+    "varying vec2 v_texCoord;\n"
+    "uniform samplerExternalOES s_texture;\n"
+    "void main() {\n"
+    "  gl_FragColor = texture2D(s_texture, v_texCoord);\n"
+    "}\n";
+
+}  // namespace
+
+PepperVideoRenderer3D::PendingPacket::PendingPacket() {
+}
+
+PepperVideoRenderer3D::PendingPacket::~PendingPacket() {
+}
+
+PepperVideoRenderer3D::PepperVideoRenderer3D(ChromotingInstance* instance)
+    : pp::Graphics3DClient(instance),
+      pp::VideoDecoderClient_Dev(instance),
+      instance_(instance),
+      gles2_if_(static_cast<const PPB_OpenGLES2*>(
+          pp::Module::Get()->GetBrowserInterface(PPB_OPENGLES2_INTERFACE))),
+      graphics_bound_(false),
+      dips_size_(SkISize::Make(0, 0)),
+      view_size_(SkISize::Make(0, 0)),
+      source_size_(SkISize::Make(0, 0)),
+      source_dpi_(SkIPoint::Make(0, 0)),
+      next_bitstream_buffer_id_(0),
+      next_picture_buffer_id_(0),
+      picture_being_painted_(kNoPicture),
+      last_painted_picture_(kNoPicture),
+      vertex_buffer_(0),
+      frame_received_(false),
+      failed_(false),
+      callback_factory_(this) {
+}
+
+PepperVideoRenderer3D::~PepperVideoRenderer3D() {
+  StopDecoding();
+
+  if (!graphics3d_.is_null()) {
+    PP_Resource context = graphics3d_.pp_resource();
+    for (PictureBuffers::iterator i = picture_buffers_.begin();
+         i != picture_buffers_.end(); ++i) {
+      gles2_if_->DeleteTextures(context, 1, &i->second.buffer.texture_id);
+    }
+    for (size_t i = 0; i < dismissed_picture_buffers_.size(); ++i)
+      gles2_if_->DeleteTextures(context, 1, &dismissed_picture_buffers_[i]);
+    for (Programs::iterator i = programs_.begin(); i != programs_.end(); ++i)
+      gles2_if_->DeleteProgram(context, i->second);
+    if (vertex_buffer_)
+      gles2_if_->DeleteBuffers(context, 1, &vertex_buffer_);
+  }
+}
+
+bool PepperVideoRenderer3D::Initialize() {
+  if (!gles2_if_)
+    return false;
+
+  // The context is resized to match the view in SetView().
+  const int32_t kAttributes[] = {
+    PP_GRAPHICS3DATTRIB_ALPHA_SIZE, 8,
+    PP_GRAPHICS3DATTRIB_BLUE_SIZE, 8,
+    PP_GRAPHICS3DATTRIB_GREEN_SIZE, 8,
+    PP_GRAPHICS3DATTRIB_RED_SIZE, 8,
+    PP_GRAPHICS3DATTRIB_DEPTH_SIZE, 0,
+    PP_GRAPHICS3DATTRIB_STENCIL_SIZE, 0,
+    PP_GRAPHICS3DATTRIB_SAMPLES, 0,
+    PP_GRAPHICS3DATTRIB_SAMPLE_BUFFERS, 0,
+    PP_GRAPHICS3DATTRIB_WIDTH, 1,
+    PP_GRAPHICS3DATTRIB_HEIGHT, 1,
+    PP_GRAPHICS3DATTRIB_NONE,
+  };
+  graphics3d_ = pp::Graphics3D(instance_, kAttributes);
+  if (graphics3d_.is_null()) {
+    LOG(INFO) << "Failed to create a 3D context.";
+    return false;
+  }
+
+  decoder_.reset(new pp::VideoDecoder_Dev(instance_, graphics3d_,
+                                          PP_VIDEODECODER_VP8PROFILE_MAIN));
+  if (decoder_->is_null()) {
+    LOG(INFO) << "VP8 video decoding is not supported by the browser.";
+    decoder_.reset();
+    return false;
+  }
+
+  PP_Resource context = graphics3d_.pp_resource();
+  gles2_if_->GenBuffers(context, 1, &vertex_buffer_);
+  gles2_if_->BindBuffer(context, GL_ARRAY_BUFFER, vertex_buffer_);
+  gles2_if_->BufferData(context, GL_ARRAY_BUFFER, sizeof(kVertices),
+                        kVertices, GL_STATIC_DRAW);
+  gles2_if_->EnableVertexAttribArray(context, kPositionLocation);
+  gles2_if_->VertexAttribPointer(context, kPositionLocation, 2, GL_FLOAT,
+                                 GL_FALSE, 0, 0);
+  gles2_if_->EnableVertexAttribArray(context, kTexCoordLocation);
+  gles2_if_->VertexAttribPointer(context, kTexCoordLocation, 2, GL_FLOAT,
+                                 GL_FALSE, 0,
+                                 static_cast<const GLfloat*>(0) + 8);
+  return gles2_if_->GetError(context) == GL_NO_ERROR;
+}
+
+void PepperVideoRenderer3D::SetView(const pp::View& view) {
+  pp::Rect pp_size = view.GetRect();
+  dips_size_ = SkISize::Make(pp_size.width(), pp_size.height());
+
+  // Render at device resolution; the GPU does the scaling for free.
+  pp::ViewDev view_dev(view);
+  float dips_to_device_scale = view_dev.GetDeviceScale();
+  SkISize view_size = SkISize::Make(
+      ceilf(dips_size_.width() * dips_to_device_scale),
+      ceilf(dips_size_.height() * dips_to_device_scale));
+
+  if (view_size_ != view_size && !view_size.isEmpty()) {
+    view_size_ = view_size;
+    graphics3d_.ResizeBuffers(view_size_.width(), view_size_.height());
+
+    // The content of the back buffer is lost, so draw the current picture
+    // again, unless a newer one is on its way.
+    if (last_painted_picture_ != kNoPicture &&
+        picture_being_painted_ == kNoPicture && pictures_to_paint_.empty()) {
+      pictures_to_paint_.push_back(last_painted_picture_);
+      last_painted_picture_ = kNoPicture;
+    }
+    PaintIfNeeded();
+  }
+
+  if (!graphics_bound_) {
+    graphics_bound_ = instance_->BindGraphics(graphics3d_);
+
+    // There is no good way to handle this error currently.
+    DCHECK(graphics_bound_) << "Couldn't bind the device context.";
+  }
+}
+
+void PepperVideoRenderer3D::ProcessVideoPacket(scoped_ptr<VideoPacket> packet,
+                                               const base::Closure& done) {
+  // If the video packet is empty then drop it. Empty packets are used to
+  // maintain activity on the network.
+  if (failed_ || !packet->has_data() || packet->data().size() == 0) {
+    done.Run();
+    return;
+  }
+
+  instance_->GetStats()->RecordVideoPacketStats(*packet);
+
+  // If the packet includes screen size or DPI information, pass them on.
+  bool notify_size_or_dpi_change = false;
+  if (packet->format().has_screen_width() &&
+      packet->format().has_screen_height()) {
+    SkISize source_size = SkISize::Make(packet->format().screen_width(),
+                                        packet->format().screen_height());
+    if (source_size_ != source_size) {
+      source_size_ = source_size;
+      notify_size_or_dpi_change = true;
+    }
+  }
+  if (packet->format().has_x_dpi() && packet->format().has_y_dpi()) {
+    SkIPoint source_dpi(SkIPoint::Make(packet->format().x_dpi(),
+                                       packet->format().y_dpi()));
+    if (source_dpi != source_dpi_) {
+      source_dpi_ = source_dpi;
+      notify_size_or_dpi_change = true;
+    }
+  }
+  if (notify_size_or_dpi_change)
+    instance_->SetDesktopSize(source_size_, source_dpi_);
+
+  // The instance ignores shapes that haven't changed.
+  SkRegion desktop_shape;
+  if (packet->has_use_desktop_shape()) {
+    for (int i = 0; i < packet->desktop_shape_rects_size(); ++i) {
+      Rect remoting_rect = packet->desktop_shape_rects(i);
+      desktop_shape.op(SkIRect::MakeXYWH(remoting_rect.x(),
+                                         remoting_rect.y(),
+                                         remoting_rect.width(),
+                                         remoting_rect.height()),
+                       SkRegion::kUnion_Op);
+    }
+  } else {
+    desktop_shape.setRect(SkIRect::MakeSize(source_size_));
+  }
+  instance_->SetDesktopShape(desktop_shape);
+
+  // Each packet holds a whole VP8 frame. The decoder reads it from shared
+  // memory, so this is the only copy made on the CPU.
+  int32_t id = next_bitstream_buffer_id_++;
+  linked_ptr<PendingPacket> pending_packet(new PendingPacket());
+  pending_packet->buffer.reset(
+      new pp::Buffer_Dev(instance_, packet->data().size()));
+  if (pending_packet->buffer->is_null()) {
+    LOG(ERROR) << "Failed to allocate a bitstream buffer.";
+    done.Run();
+    ReportError();
+    return;
+  }
+  memcpy(pending_packet->buffer->data(), packet->data().data(),
+         packet->data().size());
+  pending_packet->done = done;
+  pending_packet->decode_start = base::Time::Now();
+  pending_packets_[id] = pending_packet;
+
+  PP_VideoBitstreamBuffer_Dev bitstream_buffer;
+  bitstream_buffer.id = id;
+  bitstream_buffer.data = pending_packet->buffer->pp_resource();
+  bitstream_buffer.size = packet->data().size();
+  int32_t result = decoder_->Decode(
+      bitstream_buffer,
+      callback_factory_.NewCallback(&PepperVideoRenderer3D::OnDecodeDone, id));
+  if (result != PP_OK_COMPLETIONPENDING)
+    OnDecodeDone(result, id);
+}
+
+void PepperVideoRenderer3D::Graphics3DContextLost() {
+  LOG(ERROR) << "The 3D context was lost.";
+  ReportError();
+}
+
+void PepperVideoRenderer3D::ProvidePictureBuffers(PP_Resource decoder,
+                                                  uint32_t req_num_of_bufs,
+                                                  const PP_Size& dimensions,
+                                                  uint32_t texture_target) {
+  PP_Resource context = graphics3d_.pp_resource();
+  std::vector<PP_PictureBuffer_Dev> buffers;
+  for (uint32_t i = 0; i < req_num_of_bufs; ++i) {
+    PictureBuffer picture_buffer;
+    picture_buffer.texture_target = texture_target;
+    picture_buffer.buffer.id = next_picture_buffer_id_++;
+    picture_buffer.buffer.size = dimensions;
+    gles2_if_->GenTextures(context, 1, &picture_buffer.buffer.texture_id);
+    gles2_if_->ActiveTexture(context, GL_TEXTURE0);
+    gles2_if_->BindTexture(context, texture_target,
+                           picture_buffer.buffer.texture_id);
+    gles2_if_->TexParameteri(context, texture_target, GL_TEXTURE_MIN_FILTER,
+                             GL_LINEAR);
+    gles2_if_->TexParameteri(context, texture_target, GL_TEXTURE_MAG_FILTER,
+                             GL_LINEAR);
+    gles2_if_->TexParameteri(context, texture_target, GL_TEXTURE_WRAP_S,
+                             GL_CLAMP_TO_EDGE);
+    gles2_if_->TexParameteri(context, texture_target, GL_TEXTURE_WRAP_T,
+                             GL_CLAMP_TO_EDGE);
+    if (texture_target == GL_TEXTURE_2D) {
+      gles2_if_->TexImage2D(context, texture_target, 0, GL_RGBA,
+                            dimensions.width, dimensions.height, 0, GL_RGBA,
+                            GL_UNSIGNED_BYTE, NULL);
+    }
+    picture_buffers_[picture_buffer.buffer.id] = picture_buffer;
+    buffers.push_back(picture_buffer.buffer);
+  }
+  decoder_->AssignPictureBuffers(buffers);
+}
+
+void PepperVideoRenderer3D::DismissPictureBuffer(PP_Resource decoder,
+                                                 int32_t picture_buffer_id) {
+  PictureBuffers::iterator it = picture_buffers_.find(picture_buffer_id);
+  if (it == picture_buffers_.end()) {
+    NOTREACHED();
+    return;
+  }
+
+  // Pictures that were decoded into the buffer are gone with it.
+  pictures_to_paint_.remove(picture_buffer_id);
+  if (last_painted_picture_ == picture_buffer_id)
+    last_painted_picture_ = kNoPicture;
+
+  // A buffer being drawn is deleted once SwapBuffers() completes.
+  if (picture_being_painted_ == picture_buffer_id) {
+    dismissed_picture_buffers_.push_back(it->second.buffer.texture_id);
+  } else {
+    gles2_if_->DeleteTextures(graphics3d_.pp_resource(), 1,
+                              &it->second.buffer.texture_id);
+  }
+  picture_buffers_.erase(it);
+}
+
+void PepperVideoRenderer3D::PictureReady(PP_Resource decoder,
+                                         const PP_Picture_Dev& picture) {
+  pictures_to_paint_.push_back(picture.picture_buffer_id);
+  PaintIfNeeded();
+}
+
+void PepperVideoRenderer3D::NotifyError(PP_Resource decoder,
+                                        PP_VideoDecodeError_Dev error) {
+  LOG(ERROR) << "Video decoder failed with error " << error << ".";
+  ReportError();
+}
+
+void PepperVideoRenderer3D::StopDecoding() {
+  // Destroying the decoder cancels the outstanding decode callbacks.
+  decoder_.reset();
+
+  PendingPackets pending_packets;
+  pending_packets.swap(pending_packets_);
+  for (PendingPackets::iterator i = pending_packets.begin();
+       i != pending_packets.end(); ++i) {
+    i->second->done.Run();
+  }
+
+  pictures_to_paint_.clear();
+}
+
+void PepperVideoRenderer3D::OnDecodeDone(int32_t result,
+                                         int32_t bitstream_buffer_id) {
+  PendingPackets::iterator it = pending_packets_.find(bitstream_buffer_id);
+  if (it == pending_packets_.end()) {
+    NOTREACHED();
+    return;
+  }
+
+  linked_ptr<PendingPacket> pending_packet = it->second;
+  pending_packets_.erase(it);
+
+  if (result == PP_OK) {
+    instance_->GetStats()->video_decode_ms()->Record(
+        (base::Time::Now() - pending_packet->decode_start).InMilliseconds());
+  }
+
+  pending_packet->done.Run();
+
+  if (result != PP_OK) {
+    LOG(ERROR) << "Decode() failed with error " << result << ".";
+    ReportError();
+  }
+}
+
+void PepperVideoRenderer3D::PaintIfNeeded() {
+  if (!decoder_ || picture_being_painted_ != kNoPicture ||
+      pictures_to_paint_.empty() || view_size_.isEmpty()) {
+    return;
+  }
+
+  // Only the most recent picture is worth drawing. Return the others to the
+  // decoder straight away, so that it can keep decoding into them.
+  while (pictures_to_paint_.size() > 1) {
+    decoder_->ReusePictureBuffer(pictures_to_paint_.front());
+    pictures_to_paint_.pop_front();
+  }
+  int32_t picture_buffer_id = pictures_to_paint_.front();
+  pictures_to_paint_.pop_front();
+
+  PictureBuffers::iterator it = picture_buffers_.find(picture_buffer_id);
+  DCHECK(it != picture_buffers_.end());
+  const PictureBuffer& picture_buffer = it->second;
+  if (!UseProgramFor(picture_buffer.texture_target)) {
+    LOG(ERROR) << "Unsupported texture target "
+               << picture_buffer.texture_target << ".";
+    decoder_->ReusePictureBuffer(picture_buffer_id);
+    ReportError();
+    return;
+  }
+
+  base::Time paint_start = base::Time::Now();
+  PP_Resource context = graphics3d_.pp_resource();
+  gles2_if_->Viewport(context, 0, 0, view_size_.width(), view_size_.height());
+  gles2_if_->ActiveTexture(context, GL_TEXTURE0);
+  gles2_if_->BindTexture(context, picture_buffer.texture_target,
+                         picture_buffer.buffer.texture_id);
+  gles2_if_->DrawArrays(context, GL_TRIANGLE_STRIP, 0, 4);
+
+  picture_being_painted_ = picture_buffer_id;
+  int32_t result = graphics3d_.SwapBuffers(callback_factory_.NewCallback(
+      &PepperVideoRenderer3D::OnPaintDone, paint_start));
+  if (result != PP_OK_COMPLETIONPENDING)
+    OnPaintDone(result, paint_start);
+}
+
+void PepperVideoRenderer3D::OnPaintDone(int32_t result,
+                                        base::Time paint_start) {
+  DCHECK_NE(picture_being_painted_, kNoPicture);
+
+  instance_->GetStats()->video_paint_ms()->Record(
+      (base::Time::Now() - paint_start).InMilliseconds());
+
+  if (!frame_received_) {
+    instance_->OnFirstFrameReceived();
+    frame_received_ = true;
+  }
+
+  for (std::vector<uint32_t>::iterator i = dismissed_picture_buffers_.begin();
+       i != dismissed_picture_buffers_.end(); ++i) {
+    gles2_if_->DeleteTextures(graphics3d_.pp_resource(), 1, &*i);
+  }
+  dismissed_picture_buffers_.clear();
+
+  // Keep the picture that is on the screen until the next one replaces it,
+  // so that it can be drawn again if the view is resized.
+  if (decoder_ && last_painted_picture_ != kNoPicture)
+    decoder_->ReusePictureBuffer(last_painted_picture_);
+  last_painted_picture_ = kNoPicture;
+  if (picture_buffers_.count(picture_being_painted_))
+    last_painted_picture_ = picture_being_painted_;
+  picture_being_painted_ = kNoPicture;
+
+  if (result != PP_OK) {
+    LOG(ERROR) << "SwapBuffers() failed with error " << result << ".";
+    ReportError();
+    return;
+  }
+
+  PaintIfNeeded();
+}
+
+bool PepperVideoRenderer3D::UseProgramFor(uint32_t texture_target) {
+  PP_Resource context = graphics3d_.pp_resource();
+  Programs::iterator it = programs_.find(texture_target);
+  if (it != programs_.end()) {
+    gles2_if_->UseProgram(context, it->second);
+    return true;
+  }
+
+  const char* fragment_shader;
+  if (texture_target == GL_TEXTURE_2D) {
+    fragment_shader = kFragmentShader2D;
+  } else if (texture_target == GL_TEXTURE_EXTERNAL_OES) {
+    fragment_shader = kFragmentShaderExternal;
+  } else {
+    return false;
+  }
+
+  GLuint program = gles2_if_->CreateProgram(context);
+  CreateShader(program, GL_VERTEX_SHADER, kVertexShader);
+  CreateShader(program, GL_FRAGMENT_SHADER, fragment_shader);
+  gles2_if_->BindAttribLocation(context, program, kPositionLocation,
+                                "a_position");
+  gles2_if_->BindAttribLocation(context, program, kTexCoordLocation,
+                                "a_texCoord");
+  gles2_if_->LinkProgram(context, program);
+
+  GLint linked = GL_FALSE;
+  gles2_if_->GetProgramiv(context, program, GL_LINK_STATUS, &linked);
+  if (!linked) {
+    gles2_if_->DeleteProgram(context, program);
+    return false;
+  }
+
+  gles2_if_->UseProgram(context, program);
+  gles2_if_->Uniform1i(
+      context, gles2_if_->GetUniformLocation(context, program, "s_texture"),
+      0);
+  programs_[texture_target] = program;
+  return true;
+}
+
+void PepperVideoRenderer3D::CreateShader(uint32_t program,
+                                         uint32_t type,
+                                         const char* source) {
+  PP_Resource context = graphics3d_.pp_resource();
+  GLint size = strlen(source);
+  GLuint shader = gles2_if_->CreateShader(context, type);
+  gles2_if_->ShaderSource(context, shader, 1, &source, &size);
+  gles2_if_->CompileShader(context, shader);
+  gles2_if_->AttachShader(context, program, shader);
+  gles2_if_->DeleteShader(context, shader);
+}
+
+void PepperVideoRenderer3D::ReportError() {
+  if (failed_)
+    return;
+  failed_ = true;
+
+  StopDecoding();
+  instance_->OnVideoRendererFailed();
+}
+
+}  // namespace remoting
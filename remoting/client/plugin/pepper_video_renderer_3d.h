@@ -0,0 +1,180 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// PepperVideoRenderer3D decodes VP8 video packets with the Pepper video
+// decoder, which may use the video decoding hardware, and draws the decoded
+// pictures with OpenGL ES, without converting them to RGB or scaling them on
+// the CPU. It is callable only on the Pepper thread.
+
+#ifndef REMOTING_CLIENT_PLUGIN_PEPPER_VIDEO_RENDERER_3D_H_
+#define REMOTING_CLIENT_PLUGIN_PEPPER_VIDEO_RENDERER_3D_H_
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/compiler_specific.h"
+#include "base/memory/linked_ptr.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
+#include "ppapi/c/dev/pp_video_dev.h"
+#include "ppapi/cpp/dev/video_decoder_client_dev.h"
+#include "ppapi/cpp/graphics_3d.h"
+#include "ppapi/cpp/graphics_3d_client.h"
+#include "ppapi/utility/completion_callback_factory.h"
+#include "remoting/protocol/video_stub.h"
+#include "third_party/skia/include/core/SkPoint.h"
+#include "third_party/skia/include/core/SkRegion.h"
+#include "third_party/skia/include/core/SkSize.h"
+
+struct PPB_OpenGLES2;
+
+namespace pp {
+class Buffer_Dev;
+class VideoDecoder_Dev;
+class View;
+}  // namespace pp
+
+namespace remoting {
+
+class ChromotingInstance;
+
+class PepperVideoRenderer3D : public protocol::VideoStub,
+                              public pp::Graphics3DClient,
+                              public pp::VideoDecoderClient_Dev {
+ public:
+  // Constructs a renderer for the |instance|, which must outlive this class.
+  explicit PepperVideoRenderer3D(ChromotingInstance* instance);
+  virtual ~PepperVideoRenderer3D();
+
+  // Creates the 3D context and the decoder. Returns false if the browser
+  // can't decode VP8 this way, in which case the renderer must not be used.
+  bool Initialize();
+
+  // Updates the size of the view, and binds the 3D context to the instance
+  // the first time it's called.
+  void SetView(const pp::View& view);
+
+  // Returns the dimensions of the view in Density Independent Pixels (DIPs).
+  const SkISize& get_view_size_dips() const {
+    return dips_size_;
+  }
+
+  // protocol::VideoStub implementation.
+  virtual void ProcessVideoPacket(scoped_ptr<VideoPacket> packet,
+                                  const base::Closure& done) OVERRIDE;
+
+  // pp::Graphics3DClient implementation.
+  virtual void Graphics3DContextLost() OVERRIDE;
+
+  // pp::VideoDecoderClient_Dev implementation.
+  virtual void ProvidePictureBuffers(PP_Resource decoder,
+                                     uint32_t req_num_of_bufs,
+                                     const PP_Size& dimensions,
+                                     uint32_t texture_target) OVERRIDE;
+  virtual void DismissPictureBuffer(PP_Resource decoder,
+                                    int32_t picture_buffer_id) OVERRIDE;
+  virtual void PictureReady(PP_Resource decoder,
+                            const PP_Picture_Dev& picture) OVERRIDE;
+  virtual void NotifyError(PP_Resource decoder,
+                           PP_VideoDecodeError_Dev error) OVERRIDE;
+
+ private:
+  // A packet handed to the decoder, held until the decoder is done with it.
+  struct PendingPacket {
+    PendingPacket();
+    ~PendingPacket();
+
+    scoped_ptr<pp::Buffer_Dev> buffer;
+    base::Closure done;
+    base::Time decode_start;
+  };
+
+  struct PictureBuffer {
+    PP_PictureBuffer_Dev buffer;
+    uint32_t texture_target;
+  };
+
+  // Returns the packets that the decoder hasn't finished with to the network
+  // layer, so that it keeps on receiving, and stops decoding.
+  void StopDecoding();
+
+  // Handles completion of decoding the packet with |bitstream_buffer_id|.
+  void OnDecodeDone(int32_t result, int32_t bitstream_buffer_id);
+
+  // Draws the most recent decoded picture, if there is one and no other
+  // picture is being drawn, and returns any older ones to the decoder.
+  void PaintIfNeeded();
+
+  // Handles completion of SwapBuffers(), returning the previously drawn
+  // picture to the decoder and drawing the next one.
+  void OnPaintDone(int32_t result, base::Time paint_start);
+
+  // Creates the program that draws textures of |texture_target|, if needed.
+  // Returns false if |texture_target| is not supported.
+  bool UseProgramFor(uint32_t texture_target);
+  void CreateShader(uint32_t program, uint32_t type, const char* source);
+
+  // Reports a failure to the instance, which falls back to software
+  // rendering.
+  void ReportError();
+
+  // Reference to the creating plugin instance.
+  ChromotingInstance* const instance_;
+
+  const PPB_OpenGLES2* gles2_if_;
+  pp::Graphics3D graphics3d_;
+  scoped_ptr<pp::VideoDecoder_Dev> decoder_;
+
+  // True once |graphics3d_| has been bound to the instance.
+  bool graphics_bound_;
+
+  // View size in Density Independent Pixels (DIPs) and in device pixels.
+  SkISize dips_size_;
+  SkISize view_size_;
+
+  // Size and DPI of the remote screen, from the packets.
+  SkISize source_size_;
+  SkIPoint source_dpi_;
+
+  int32_t next_bitstream_buffer_id_;
+  int32_t next_picture_buffer_id_;
+
+  typedef std::map<int32_t, linked_ptr<PendingPacket> > PendingPackets;
+  PendingPackets pending_packets_;
+
+  typedef std::map<int32_t, PictureBuffer> PictureBuffers;
+  PictureBuffers picture_buffers_;
+
+  // Decoded pictures waiting to be drawn, oldest first, the one being drawn
+  // and the one on the screen, if any.
+  std::list<int32_t> pictures_to_paint_;
+  int32_t picture_being_painted_;
+  int32_t last_painted_picture_;
+
+  // Textures of picture buffers that were dismissed while being drawn.
+  std::vector<uint32_t> dismissed_picture_buffers_;
+
+  // Programs drawing each of the texture targets used so far.
+  typedef std::map<uint32_t, uint32_t> Programs;
+  Programs programs_;
+
+  // Buffer holding the vertex positions and texture coordinates of the quad.
+  uint32_t vertex_buffer_;
+
+  // True after the first picture has been drawn.
+  bool frame_received_;
+
+  // True after an error has been reported to the instance.
+  bool failed_;
+
+  pp::CompletionCallbackFactory<PepperVideoRenderer3D> callback_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(PepperVideoRenderer3D);
+};
+
+}  // namespace remoting
+
+#endif  // REMOTING_CLIENT_PLUGIN_PEPPER_VIDEO_RENDERER_3D_H_
@@ -35,8 +35,7 @@ RectangleUpdateDecoder::RectangleUpdateDecoder(
       source_dpi_(SkIPoint::Make(0, 0)),
       view_size_(SkISize::Make(0, 0)),
       clip_area_(SkIRect::MakeEmpty()),
-      paint_scheduled_(false),
-      latest_sequence_number_(0) {
+      paint_scheduled_(false) {
 }
 
 RectangleUpdateDecoder::~RectangleUpdateDecoder() {
@@ -236,23 +235,7 @@ void RectangleUpdateDecoder::ProcessVideoPacket(scoped_ptr<VideoPacket> packet,
     return;
   }
 
-  // Add one frame to the counter.
-  stats_.video_frame_rate()->Record(1);
-
-  // Record other statistics received from host.
-  stats_.video_bandwidth()->Record(packet->data().size());
-  if (packet->has_capture_time_ms())
-    stats_.video_capture_ms()->Record(packet->capture_time_ms());
-  if (packet->has_encode_time_ms())
-    stats_.video_encode_ms()->Record(packet->encode_time_ms());
-  if (packet->has_client_sequence_number() &&
-      packet->client_sequence_number() > latest_sequence_number_) {
-    latest_sequence_number_ = packet->client_sequence_number();
-    base::TimeDelta round_trip_latency =
-        base::Time::Now() -
-        base::Time::FromInternalValue(packet->client_sequence_number());
-    stats_.round_trip_ms()->Record(round_trip_latency.InMilliseconds());
-  }
+  stats_.RecordVideoPacketStats(*packet);
 
   // Measure the latency between the last packet being received and presented.
   bool last_packet = (packet->flags() & VideoPacket::LAST_PACKET) != 0;
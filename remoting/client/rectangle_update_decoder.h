@@ -108,9 +108,6 @@ class RectangleUpdateDecoder
   bool paint_scheduled_;
 
   ChromotingStats stats_;
-
-  // Keep track of the most recent sequence number bounced back from the host.
-  int64 latest_sequence_number_;
 };
 
 }  // namespace remoting
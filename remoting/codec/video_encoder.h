@@ -34,6 +34,11 @@ class VideoEncoder {
   // called.
   virtual void Encode(const webrtc::DesktopFrame* frame,
                       const DataAvailableCallback& data_available_callback) = 0;
+
+  // Asks the encoder to aim for |kbps| kilobits per second of encoded video,
+  // starting with the next frame. Encoders that can't control their output
+  // size ignore it.
+  virtual void SetTargetBitrate(int kbps) {}
 };
 
 }  // namespace remoting
@@ -4,6 +4,10 @@
 
 #include "remoting/codec/video_encoder_vp8.h"
 
+#include <stdlib.h>
+
+#include <algorithm>
+
 #include "base/logging.h"
 #include "base/sys_info.h"
 #include "base/time/time.h"
@@ -25,12 +29,49 @@ namespace {
 // map for the encoder.
 const int kMacroBlockSize = 16;
 
+// The most threads to encode with. Each thread encodes its own token
+// partition, of which VP8 allows up to eight.
+const int kMaxEncoderThreads = 8;
+
+// Range of the VP8E_SET_CPUUSED values to pick from. Higher values are
+// faster. The encoder starts at the fastest setting, and uses slower, better
+// quality ones while frames encode well within |kTargetEncodeTimeMs|.
+const int kMinCpuUsed = 4;
+const int kMaxCpuUsed = 16;
+const int kCpuUsedStep = 4;
+
+// The encode time to stay under. Frames are captured at most every 50ms, and
+// this leaves time for capturing and sending them.
+const int kTargetEncodeTimeMs = 30;
+
+// Number of frames to average the encode time over before changing speed.
+const int kEncodeTimeWindow = 5;
+
+// Quantizer range. The upper limit is raised towards
+// |kMaxQuantizerAtMinBitrate| as the target bitrate drops, so that frames can
+// shrink enough to fit.
+const unsigned int kMinQuantizer = 20;
+const unsigned int kMaxQuantizer = 30;
+const unsigned int kMaxQuantizerAtMinBitrate = 56;
+
+// The lowest bitrate to aim for, however slow the network appears.
+const int kMinBitrateKbps = 100;
+
+// Bitrate changes smaller than this fraction aren't worth reconfiguring the
+// encoder for.
+const double kBitrateChangeThreshold = 0.1;
+
 }  // namespace remoting
 
 namespace remoting {
 
 VideoEncoderVp8::VideoEncoderVp8()
     : initialized_(false),
+      image_is_blank_(true),
+      cpu_used_(kMaxCpuUsed),
+      encode_time_(kEncodeTimeWindow),
+      target_bitrate_kbps_(0),
+      max_bitrate_kbps_(0),
       active_map_width_(0),
       active_map_height_(0),
       last_timestamp_(0) {}
@@ -90,6 +131,10 @@ bool VideoEncoderVp8::Init(const webrtc::DesktopSize& size) {
 
   // Reset image value to 128 so we just need to fill in the y plane.
   memset(yuv_image_.get(), 128, yuv_image_size);
+  image_is_blank_ = true;
+
+  macro_block_.reset(
+      new uint8[kMacroBlockSize * kMacroBlockSize * 3 / 2]);
 
   // Fill in the information for |image_|.
   unsigned char* image = reinterpret_cast<unsigned char*>(yuv_image_.get());
@@ -101,7 +146,8 @@ bool VideoEncoderVp8::Init(const webrtc::DesktopSize& size) {
   image_->stride[2] = uv_width;
 
   // Configure the encoder.
-  vpx_codec_enc_cfg_t config;
+  config_.reset(new vpx_codec_enc_cfg_t());
+  vpx_codec_enc_cfg_t& config = *config_;
   const vpx_codec_iface_t* algo = vpx_codec_vp8_cx();
   CHECK(algo);
   vpx_codec_err_t ret = vpx_codec_enc_config_default(algo, &config, 0);
@@ -110,6 +156,7 @@ bool VideoEncoderVp8::Init(const webrtc::DesktopSize& size) {
 
   config.rc_target_bitrate = image_->w * image_->h *
       config.rc_target_bitrate / config.g_w / config.g_h;
+  max_bitrate_kbps_ = config.rc_target_bitrate;
   config.g_w = image_->w;
   config.g_h = image_->h;
   config.g_pass = VPX_RC_ONE_PASS;
@@ -119,13 +166,16 @@ bool VideoEncoderVp8::Init(const webrtc::DesktopSize& size) {
   // encoding.
   config.g_profile = 2;
 
-  // Using 2 threads gives a great boost in performance for most systems with
-  // adequate processing power. NB: Going to multiple threads on low end
-  // windows systems can really hurt performance.
+  // Using more threads gives a great boost in performance for most systems
+  // with adequate processing power, so use half of the cores, leaving the
+  // rest for capturing and everything else. NB: Going to multiple threads on
+  // low end windows systems can really hurt performance.
   // http://crbug.com/99179
-  config.g_threads = (base::SysInfo::NumberOfProcessors() > 2) ? 2 : 1;
-  config.rc_min_quantizer = 20;
-  config.rc_max_quantizer = 30;
+  int processors = base::SysInfo::NumberOfProcessors();
+  config.g_threads =
+      processors > 2 ? std::min(processors / 2, kMaxEncoderThreads) : 1;
+  config.rc_min_quantizer = kMinQuantizer;
+  config.rc_max_quantizer = kMaxQuantizer;
   config.g_timebase.num = 1;
   config.g_timebase.den = 20;
 
@@ -133,10 +183,20 @@ bool VideoEncoderVp8::Init(const webrtc::DesktopSize& size) {
     return false;
 
   // Value of 16 will have the smallest CPU load. This turns off subpixel
-  // motion search.
-  if (vpx_codec_control(codec_.get(), VP8E_SET_CPUUSED, 16))
+  // motion search. AdjustSpeed() lowers it when there is time to spare.
+  if (vpx_codec_control(codec_.get(), VP8E_SET_CPUUSED, cpu_used_))
     return false;
 
+  // Split the tokens into a partition per thread, so that the threads can
+  // pack them, and the client can decode them, in parallel.
+  int token_partitions = 0;
+  while ((2 << token_partitions) <= static_cast<int>(config.g_threads))
+    ++token_partitions;
+  if (vpx_codec_control(codec_.get(), VP8E_SET_TOKEN_PARTITIONS,
+                        token_partitions)) {
+    return false;
+  }
+
   // Use the lowest level of noise sensitivity so as to spend less time
   // on motion estimation and inter-prediction mode.
   if (vpx_codec_control(codec_.get(), VP8E_SET_NOISE_SENSITIVITY, 0))
@@ -171,21 +231,111 @@ void VideoEncoderVp8::PrepareImage(const webrtc::DesktopFrame* frame,
                      SkRegion::kIntersect_Op);
 
   // Convert the updated region to YUV ready for encoding.
-  const uint8* rgb_data = frame->data();
-  const int rgb_stride = frame->stride();
-  const int y_stride = image_->stride[0];
-  DCHECK_EQ(image_->stride[1], image_->stride[2]);
-  const int uv_stride = image_->stride[1];
-  uint8* y_data = image_->planes[0];
-  uint8* u_data = image_->planes[1];
-  uint8* v_data = image_->planes[2];
+  if (image_is_blank_) {
+    const uint8* rgb_data = frame->data();
+    const int rgb_stride = frame->stride();
+    const int y_stride = image_->stride[0];
+    DCHECK_EQ(image_->stride[1], image_->stride[2]);
+    const int uv_stride = image_->stride[1];
+    uint8* y_data = image_->planes[0];
+    uint8* u_data = image_->planes[1];
+    uint8* v_data = image_->planes[2];
+    for (SkRegion::Iterator r(*updated_region); !r.done(); r.next()) {
+      const SkIRect& rect = r.rect();
+      ConvertRGB32ToYUVWithRect(
+          rgb_data, y_data, u_data, v_data,
+          rect.x(), rect.y(), rect.width(), rect.height(),
+          rgb_stride, y_stride, uv_stride);
+    }
+    image_is_blank_ = false;
+    return;
+  }
+
+  // Capturers often report more than what actually changed, e.g. a window
+  // that was redrawn with the same content. Convert macroblock by macroblock,
+  // and leave out the ones that are the same as in the previous frame, so
+  // that they are neither marked active nor sent as dirty.
+  // Adjacent changed blocks are merged into runs first, since adding each
+  // block to the region on its own is slow for large updates.
+  SkRegion changed_region;
   for (SkRegion::Iterator r(*updated_region); !r.done(); r.next()) {
     const SkIRect& rect = r.rect();
-    ConvertRGB32ToYUVWithRect(
-        rgb_data, y_data, u_data, v_data,
-        rect.x(), rect.y(), rect.width(), rect.height(),
-        rgb_stride, y_stride, uv_stride);
+    for (int y = rect.top(); y < rect.bottom(); y += kMacroBlockSize) {
+      int bottom = std::min(y + kMacroBlockSize, rect.bottom());
+      int run_left = -1;
+      for (int x = rect.left(); x < rect.right(); x += kMacroBlockSize) {
+        int right = std::min(x + kMacroBlockSize, rect.right());
+        bool changed =
+            ConvertMacroBlock(frame, SkIRect::MakeLTRB(x, y, right, bottom));
+        if (changed && run_left < 0)
+          run_left = x;
+        if (!changed && run_left >= 0) {
+          changed_region.op(SkIRect::MakeLTRB(run_left, y, x, bottom),
+                            SkRegion::kUnion_Op);
+          run_left = -1;
+        }
+      }
+      if (run_left >= 0) {
+        changed_region.op(SkIRect::MakeLTRB(run_left, y, rect.right(), bottom),
+                          SkRegion::kUnion_Op);
+      }
+    }
   }
+  updated_region->swap(changed_region);
+}
+
+bool VideoEncoderVp8::ConvertMacroBlock(const webrtc::DesktopFrame* frame,
+                                        const SkIRect& rect) {
+  // Blocks start at even coordinates, so each one has its own U and V
+  // samples.
+  DCHECK_EQ(rect.x() % 2, 0);
+  DCHECK_EQ(rect.y() % 2, 0);
+  const int width = rect.width();
+  const int height = rect.height();
+  const int uv_width = (width + 1) / 2;
+  const int uv_height = (height + 1) / 2;
+  uint8* y_block = macro_block_.get();
+  uint8* u_block = y_block + kMacroBlockSize * kMacroBlockSize;
+  uint8* v_block = u_block + kMacroBlockSize * kMacroBlockSize / 4;
+  ConvertRGB32ToYUVWithRect(
+      frame->data() + rect.y() * frame->stride() +
+          rect.x() * webrtc::DesktopFrame::kBytesPerPixel,
+      y_block, u_block, v_block,
+      0, 0, width, height,
+      frame->stride(), kMacroBlockSize, kMacroBlockSize / 2);
+
+  const int y_stride = image_->stride[0];
+  const int uv_stride = image_->stride[1];
+  uint8* y_data = image_->planes[0] + rect.y() * y_stride + rect.x();
+  uint8* u_data =
+      image_->planes[1] + rect.y() / 2 * uv_stride + rect.x() / 2;
+  uint8* v_data =
+      image_->planes[2] + rect.y() / 2 * uv_stride + rect.x() / 2;
+
+  bool changed = false;
+  for (int row = 0; row < height && !changed; ++row) {
+    changed = memcmp(y_data + row * y_stride,
+                     y_block + row * kMacroBlockSize, width) != 0;
+  }
+  for (int row = 0; row < uv_height && !changed; ++row) {
+    changed = memcmp(u_data + row * uv_stride,
+                     u_block + row * kMacroBlockSize / 2, uv_width) != 0 ||
+              memcmp(v_data + row * uv_stride,
+                     v_block + row * kMacroBlockSize / 2, uv_width) != 0;
+  }
+  if (!changed)
+    return false;
+
+  for (int row = 0; row < height; ++row) {
+    memcpy(y_data + row * y_stride, y_block + row * kMacroBlockSize, width);
+  }
+  for (int row = 0; row < uv_height; ++row) {
+    memcpy(u_data + row * uv_stride, u_block + row * kMacroBlockSize / 2,
+           uv_width);
+    memcpy(v_data + row * uv_stride, v_block + row * kMacroBlockSize / 2,
+           uv_width);
+  }
+  return true;
 }
 
 void VideoEncoderVp8::PrepareActiveMap(const SkRegion& updated_region) {
@@ -211,6 +361,52 @@ void VideoEncoderVp8::PrepareActiveMap(const SkRegion& updated_region) {
   }
 }
 
+void VideoEncoderVp8::AdjustSpeed(base::TimeDelta encode_time) {
+  encode_time_.Record(encode_time.InMilliseconds());
+  double average = encode_time_.Average();
+
+  int cpu_used = cpu_used_;
+  if (average > kTargetEncodeTimeMs)
+    cpu_used = std::min(cpu_used_ + kCpuUsedStep, kMaxCpuUsed);
+  else if (average < kTargetEncodeTimeMs / 2)
+    cpu_used = std::max(cpu_used_ - kCpuUsedStep, kMinCpuUsed);
+  if (cpu_used == cpu_used_)
+    return;
+
+  if (vpx_codec_control(codec_.get(), VP8E_SET_CPUUSED, cpu_used)) {
+    LOG(ERROR) << "Unable to change the encoder speed";
+    return;
+  }
+  cpu_used_ = cpu_used;
+}
+
+void VideoEncoderVp8::SetTargetBitrate(int kbps) {
+  target_bitrate_kbps_ = kbps;
+}
+
+void VideoEncoderVp8::AdjustBitrate() {
+  if (target_bitrate_kbps_ <= 0)
+    return;
+
+  int bitrate = std::max(std::min(target_bitrate_kbps_, max_bitrate_kbps_),
+                         std::min(kMinBitrateKbps, max_bitrate_kbps_));
+  int current = config_->rc_target_bitrate;
+  if (abs(bitrate - current) <= current * kBitrateChangeThreshold)
+    return;
+
+  // Scale the quantizer limit with how far below the maximum the bitrate is.
+  double shortfall = 1.0 - static_cast<double>(bitrate) / max_bitrate_kbps_;
+  config_->rc_target_bitrate = bitrate;
+  config_->rc_max_quantizer = kMaxQuantizer + static_cast<unsigned int>(
+      shortfall * (kMaxQuantizerAtMinBitrate - kMaxQuantizer));
+  if (vpx_codec_enc_config_set(codec_.get(), config_.get())) {
+    LOG(ERROR) << "Unable to change the encoder bitrate";
+    return;
+  }
+  VLOG(1) << "VP8 target bitrate " << bitrate << " kbps, max quantizer "
+          << config_->rc_max_quantizer;
+}
+
 void VideoEncoderVp8::Encode(
     const webrtc::DesktopFrame* frame,
     const DataAvailableCallback& data_available_callback) {
@@ -227,10 +423,26 @@ void VideoEncoderVp8::Encode(
     initialized_ = ret;
   }
 
+  AdjustBitrate();
+
   // Convert the updated capture data ready for encode.
   SkRegion updated_region;
   PrepareImage(frame, &updated_region);
 
+  // If nothing changed, skip the encoder and send a packet without data,
+  // which the client ignores.
+  if (updated_region.isEmpty()) {
+    scoped_ptr<VideoPacket> packet(new VideoPacket());
+    packet->mutable_format()->set_encoding(VideoPacketFormat::ENCODING_VP8);
+    packet->set_flags(VideoPacket::FIRST_PACKET | VideoPacket::LAST_PACKET |
+                      VideoPacket::LAST_PARTITION);
+    packet->set_capture_time_ms(frame->capture_time_ms());
+    packet->set_encode_time_ms(
+        (base::Time::Now() - encode_start_time).InMillisecondsRoundedUp());
+    data_available_callback.Run(packet.Pass());
+    return;
+  }
+
   // Update active map based on updated region.
   PrepareActiveMap(updated_region);
 
@@ -287,8 +499,9 @@ void VideoEncoderVp8::Encode(
   packet->mutable_format()->set_screen_width(frame->size().width());
   packet->mutable_format()->set_screen_height(frame->size().height());
   packet->set_capture_time_ms(frame->capture_time_ms());
-  packet->set_encode_time_ms(
-      (base::Time::Now() - encode_start_time).InMillisecondsRoundedUp());
+  base::TimeDelta encode_time = base::Time::Now() - encode_start_time;
+  packet->set_encode_time_ms(encode_time.InMillisecondsRoundedUp());
+  AdjustSpeed(encode_time);
   if (!frame->dpi().is_zero()) {
     packet->mutable_format()->set_x_dpi(frame->dpi().x());
     packet->mutable_format()->set_y_dpi(frame->dpi().y());
@@ -6,10 +6,12 @@
 #define REMOTING_CODEC_VIDEO_ENCODER_VP8_H_
 
 #include "base/gtest_prod_util.h"
+#include "remoting/base/running_average.h"
 #include "remoting/codec/video_encoder.h"
 #include "third_party/skia/include/core/SkRegion.h"
 
 typedef struct vpx_codec_ctx vpx_codec_ctx_t;
+typedef struct vpx_codec_enc_cfg vpx_codec_enc_cfg_t;
 typedef struct vpx_image vpx_image_t;
 
 namespace webrtc {
@@ -28,6 +30,7 @@ class VideoEncoderVp8 : public VideoEncoder {
   virtual void Encode(
       const webrtc::DesktopFrame* frame,
       const DataAvailableCallback& data_available_callback) OVERRIDE;
+  virtual void SetTargetBitrate(int kbps) OVERRIDE;
 
  private:
   FRIEND_TEST_ALL_PREFIXES(VideoEncoderVp8Test, AlignAndClipRect);
@@ -39,20 +42,49 @@ class VideoEncoderVp8 : public VideoEncoder {
   void Destroy();
 
   // Prepare |image_| for encoding. Write updated rectangles into
-  // |updated_region|.
+  // |updated_region|. Unless |image_| was just initialized, macroblocks whose
+  // YUV data didn't change are left out of |updated_region|.
   //
   // TODO(sergeyu): Update this code to use webrtc::DesktopRegion.
   void PrepareImage(const webrtc::DesktopFrame* frame,
                     SkRegion* updated_region);
 
+  // Converts the macroblock-aligned |rect| of |frame| to YUV and copies it to
+  // |image_|. Returns false if |image_| already held the same data.
+  bool ConvertMacroBlock(const webrtc::DesktopFrame* frame,
+                         const SkIRect& rect);
+
   // Update the active map according to |updated_region|. Active map is then
   // given to the encoder to speed up encoding.
   void PrepareActiveMap(const SkRegion& updated_region);
 
+  // Trades quality for speed depending on how long recent frames took to
+  // encode.
+  void AdjustSpeed(base::TimeDelta encode_time);
+
+  // Applies |target_bitrate_kbps_| to the encoder, if it differs enough from
+  // the current setting.
+  void AdjustBitrate();
+
   // True if the encoder is initialized.
   bool initialized_;
 
+  // True if |image_| doesn't hold a previous frame to compare against.
+  bool image_is_blank_;
+
+  // The VP8E_SET_CPUUSED value currently used by the encoder.
+  int cpu_used_;
+  RunningAverage encode_time_;
+
+  // The bitrate requested with SetTargetBitrate(), or 0 if none was.
+  int target_bitrate_kbps_;
+
+  // The bitrate the encoder uses for the current frame size when the network
+  // isn't the limit.
+  int max_bitrate_kbps_;
+
   scoped_ptr<vpx_codec_ctx_t> codec_;
+  scoped_ptr<vpx_codec_enc_cfg_t> config_;
   scoped_ptr<vpx_image_t> image_;
   scoped_ptr<uint8[]> active_map_;
   int active_map_width_;
@@ -62,6 +94,9 @@ class VideoEncoderVp8 : public VideoEncoder {
   // Buffer for storing the yuv image.
   scoped_ptr<uint8[]> yuv_image_;
 
+  // Holds one macroblock of YUV data while it is compared with |image_|.
+  scoped_ptr<uint8[]> macro_block_;
+
   DISALLOW_COPY_AND_ASSIGN(VideoEncoderVp8);
 };
 
@@ -24,6 +24,10 @@ const int64 kMinimumRecordingDelay = 50;
 // available while 1 means using 100% of all CPUs available.
 const double kRecordingCpuConsumption = 0.5;
 
+// The share of the measured network throughput that video should use, which
+// leaves headroom for bursts and for the other channels.
+const double kNetworkUtilization = 0.8;
+
 }  // namespace
 
 namespace remoting {
@@ -32,7 +36,9 @@ namespace remoting {
 CaptureScheduler::CaptureScheduler()
     : num_of_processors_(base::SysInfo::NumberOfProcessors()),
       capture_time_(kStatisticsWindow),
-      encode_time_(kStatisticsWindow) {
+      encode_time_(kStatisticsWindow),
+      send_time_(kStatisticsWindow),
+      frame_size_(kStatisticsWindow) {
   DCHECK(num_of_processors_);
 }
 
@@ -47,6 +53,9 @@ base::TimeDelta CaptureScheduler::NextCaptureDelay() {
       (capture_time_.Average() + encode_time_.Average()) /
       (kRecordingCpuConsumption * num_of_processors_);
 
+  // Don't capture faster than the network can send the frames.
+  delay = std::max(delay, send_time_.Average());
+
   if (delay < kMinimumRecordingDelay)
     return base::TimeDelta::FromMilliseconds(kMinimumRecordingDelay);
   return base::TimeDelta::FromMilliseconds(delay);
@@ -60,6 +69,25 @@ void CaptureScheduler::RecordEncodeTime(base::TimeDelta encode_time) {
   encode_time_.Record(encode_time.InMilliseconds());
 }
 
+void CaptureScheduler::RecordSendTime(int size, base::TimeDelta send_time) {
+  frame_size_.Record(size);
+  send_time_.Record(send_time.InMilliseconds());
+}
+
+int CaptureScheduler::TargetBitrateKbps() {
+  double send_time = send_time_.Average();
+  if (frame_size_.Average() == 0)
+    return 0;
+
+  // Frames that take less than a millisecond to send say little about the
+  // throughput, other than that it is ample.
+  send_time = std::max(send_time, 1.0);
+
+  // Bytes per millisecond times eight is kilobits per second.
+  return static_cast<int>(
+      kNetworkUtilization * frame_size_.Average() * 8 / send_time);
+}
+
 void CaptureScheduler::SetNumOfProcessorsForTest(int num_of_processors) {
   num_of_processors_ = num_of_processors;
 }
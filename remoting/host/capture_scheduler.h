@@ -4,7 +4,9 @@
 
 // This class chooses a capture interval so as to limit CPU usage to not exceed
 // a specified %age. It bases this on the CPU usage of recent capture and encode
-// operations, and on the number of available CPUs.
+// operations, and on the number of available CPUs. It also keeps captures from
+// outpacing the network, and estimates the bitrate the encoder should aim for,
+// from how long recent frames took to send.
 
 #ifndef REMOTING_HOST_CAPTURE_SCHEDULER_H_
 #define REMOTING_HOST_CAPTURE_SCHEDULER_H_
@@ -27,6 +29,16 @@ class CaptureScheduler {
   void RecordCaptureTime(base::TimeDelta capture_time);
   void RecordEncodeTime(base::TimeDelta encode_time);
 
+  // Records that a frame of |size| bytes took |send_time| from being handed
+  // to the network until it was written to the socket, including the time it
+  // spent queued behind earlier frames.
+  void RecordSendTime(int size, base::TimeDelta send_time);
+
+  // Returns the bitrate, in kilobits per second, that encoded video should
+  // stay under for frames not to queue up on the network, or 0 if nothing has
+  // been sent yet.
+  int TargetBitrateKbps();
+
   // Overrides the number of processors for testing.
   void SetNumOfProcessorsForTest(int num_of_processors);
 
@@ -34,6 +46,8 @@ class CaptureScheduler {
   int num_of_processors_;
   RunningAverage capture_time_;
   RunningAverage encode_time_;
+  RunningAverage send_time_;
+  RunningAverage frame_size_;
 
   DISALLOW_COPY_AND_ASSIGN(CaptureScheduler);
 };
@@ -77,4 +77,30 @@ TEST(CaptureSchedulerTest, RollingAverageDifferentTimes) {
   }
 }
 
+TEST(CaptureSchedulerTest, LimitedBySendTime) {
+  CaptureScheduler scheduler;
+  scheduler.SetNumOfProcessorsForTest(8);
+  scheduler.RecordCaptureTime(base::TimeDelta::FromMilliseconds(10));
+  scheduler.RecordEncodeTime(base::TimeDelta::FromMilliseconds(10));
+  EXPECT_EQ(50, scheduler.NextCaptureDelay().InMilliseconds());
+
+  // Frames that take longer to send than to capture and encode slow down
+  // captures to match.
+  scheduler.RecordSendTime(10000, base::TimeDelta::FromMilliseconds(200));
+  EXPECT_EQ(200, scheduler.NextCaptureDelay().InMilliseconds());
+}
+
+TEST(CaptureSchedulerTest, TargetBitrate) {
+  CaptureScheduler scheduler;
+  EXPECT_EQ(0, scheduler.TargetBitrateKbps());
+
+  // 10000 bytes in 100ms is 800 kbps, of which video is given 80%.
+  scheduler.RecordSendTime(10000, base::TimeDelta::FromMilliseconds(100));
+  EXPECT_EQ(640, scheduler.TargetBitrateKbps());
+
+  // Averaged over the last frames: 20000 bytes in 50ms on average.
+  scheduler.RecordSendTime(30000, base::TimeDelta::FromMilliseconds(0));
+  EXPECT_EQ(2560, scheduler.TargetBitrateKbps());
+}
+
 }  // namespace remoting
@@ -62,10 +62,15 @@ void DesktopSesssionClipboardStub::InjectClipboardEvent(
   desktop_session_agent_->InjectClipboardEvent(event);
 }
 
+// The number of shared buffers released by the capturer that are kept for
+// reuse. Screen capturers hold two frames at a time, so this covers them
+// replacing both.
+const size_t kMaxRecycledBuffers = 2;
+
 }  // namespace
 
-// webrtc::SharedMemory implementation that notifies creating
-// DesktopSessionAgent when it's deleted.
+// webrtc::SharedMemory implementation that hands its memory back to the
+// creating DesktopSessionAgent when it's deleted.
 class DesktopSessionAgent::SharedBuffer : public webrtc::SharedMemory {
  public:
   static scoped_ptr<SharedBuffer> Create(DesktopSessionAgent* agent,
@@ -78,8 +83,17 @@ class DesktopSessionAgent::SharedBuffer : public webrtc::SharedMemory {
         new SharedBuffer(agent, memory.Pass(), size, id));
   }
 
+  // Wraps |memory|, which was previously used by a buffer with the same |id|.
+  static scoped_ptr<SharedBuffer> Reuse(DesktopSessionAgent* agent,
+                                        scoped_ptr<base::SharedMemory> memory,
+                                        size_t size,
+                                        int id) {
+    return scoped_ptr<SharedBuffer>(
+        new SharedBuffer(agent, memory.Pass(), size, id));
+  }
+
   virtual ~SharedBuffer() {
-    agent_->OnSharedBufferDeleted(id());
+    agent_->OnSharedBufferDeleted(id(), size(), shared_memory_.Pass());
   }
 
  private:
@@ -179,6 +193,26 @@ void DesktopSessionAgent::OnChannelError() {
 webrtc::SharedMemory* DesktopSessionAgent::CreateSharedMemory(size_t size) {
   DCHECK(video_capture_task_runner_->BelongsToCurrentThread());
 
+  // Reuse a buffer of the same size, if there is one. The network process
+  // still has it mapped under its old ID, so there is nothing to send.
+  for (std::list<RecycledBuffer>::iterator i = recycled_buffers_.begin();
+       i != recycled_buffers_.end(); ++i) {
+    if (i->size != size)
+      continue;
+    scoped_ptr<base::SharedMemory> memory(i->memory.release());
+    int id = i->id;
+    recycled_buffers_.erase(i);
+    shared_buffers_++;
+    return SharedBuffer::Reuse(this, memory.Pass(), size, id).release();
+  }
+
+  // Buffers of other sizes are left over from before a resolution change, and
+  // won't be used again.
+  while (!recycled_buffers_.empty()) {
+    ReleaseSharedBuffer(recycled_buffers_.front().id);
+    recycled_buffers_.pop_front();
+  }
+
   scoped_ptr<SharedBuffer> buffer =
       SharedBuffer::Create(this, size, next_shared_buffer_id_);
   if (buffer) {
@@ -527,14 +561,41 @@ void DesktopSessionAgent::StopVideoCapturer() {
 
   // Video capturer must delete all buffers.
   DCHECK_EQ(shared_buffers_, 0);
+
+  while (!recycled_buffers_.empty()) {
+    ReleaseSharedBuffer(recycled_buffers_.front().id);
+    recycled_buffers_.pop_front();
+  }
 }
 
-void DesktopSessionAgent::OnSharedBufferDeleted(int id) {
+void DesktopSessionAgent::OnSharedBufferDeleted(
+    int id,
+    size_t size,
+    scoped_ptr<base::SharedMemory> memory) {
   DCHECK(video_capture_task_runner_->BelongsToCurrentThread());
   DCHECK(id != 0);
 
   shared_buffers_--;
   DCHECK_GE(shared_buffers_, 0);
+
+  // Buffers released while the capturer is being stopped won't be reused.
+  if (!video_capturer_) {
+    ReleaseSharedBuffer(id);
+    return;
+  }
+
+  if (recycled_buffers_.size() == kMaxRecycledBuffers) {
+    ReleaseSharedBuffer(recycled_buffers_.front().id);
+    recycled_buffers_.pop_front();
+  }
+  RecycledBuffer buffer;
+  buffer.id = id;
+  buffer.size = size;
+  buffer.memory = make_linked_ptr(memory.release());
+  recycled_buffers_.push_back(buffer);
+}
+
+void DesktopSessionAgent::ReleaseSharedBuffer(int id) {
   SendToNetwork(new ChromotingDesktopNetworkMsg_ReleaseSharedBuffer(id));
 }
 
@@ -5,11 +5,13 @@
 #ifndef REMOTING_HOST_DESKTOP_SESSION_AGENT_H_
 #define REMOTING_HOST_DESKTOP_SESSION_AGENT_H_
 
+#include <list>
 #include <map>
 
 #include "base/basictypes.h"
 #include "base/callback.h"
 #include "base/compiler_specific.h"
+#include "base/memory/linked_ptr.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
@@ -20,6 +22,10 @@
 #include "third_party/webrtc/modules/desktop_capture/desktop_geometry.h"
 #include "third_party/webrtc/modules/desktop_capture/screen_capturer.h"
 
+namespace base {
+class SharedMemory;
+}  // namespace base
+
 namespace IPC {
 class ChannelProxy;
 class Message;
@@ -148,8 +154,14 @@ class DesktopSessionAgent
   class SharedBuffer;
   friend class SharedBuffer;
 
-  // Called by SharedBuffer when it's destroyed.
-  void OnSharedBufferDeleted(int id);
+  // Called by SharedBuffer when it's destroyed. |memory| is kept for reuse by
+  // CreateSharedMemory() or released.
+  void OnSharedBufferDeleted(int id,
+                             size_t size,
+                             scoped_ptr<base::SharedMemory> memory);
+
+  // Tells the network process to drop the shared buffer |id|.
+  void ReleaseSharedBuffer(int id);
 
   // Closes |desktop_pipe_| if it is open.
   void CloseDesktopPipeHandle();
@@ -210,6 +222,17 @@ class DesktopSessionAgent
   // The number of currently allocated shared buffers.
   int shared_buffers_;
 
+  // Shared memory blocks that the capturer no longer uses, but that are still
+  // mapped by the network process. They are handed out again, with the same
+  // IDs, so that recreating a buffer doesn't cost a new allocation, handle
+  // duplication and mapping. The most recently released block is at the back.
+  struct RecycledBuffer {
+    int id;
+    size_t size;
+    linked_ptr<base::SharedMemory> memory;
+  };
+  std::list<RecycledBuffer> recycled_buffers_;
+
   // True if the desktop session agent has been started.
   bool started_;
 
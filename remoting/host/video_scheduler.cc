@@ -8,6 +8,7 @@
 
 #include "base/bind.h"
 #include "base/callback.h"
+#include "base/debug/trace_event.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop/message_loop_proxy.h"
@@ -27,9 +28,16 @@
 
 namespace remoting {
 
-// Maximum number of frames that can be processed simultaneously.
-// TODO(hclam): Move this value to CaptureScheduler.
-static const int kMaxPendingFrames = 2;
+// Maximum number of frames that can be captured or encoded simultaneously:
+// one frame can be captured while the previous one is being encoded.
+static const int kMaxFramesInProgress = 2;
+
+// Maximum number of encoded frames that can wait in the network queue before
+// captures are throttled. Allowing more than one keeps the connection busy
+// while the next frames are captured and encoded, even when the round-trip
+// time is long, without letting the queue, and so the latency, grow
+// unbounded when the network is the bottleneck.
+static const int kMaxQueuedFrames = 2;
 
 VideoScheduler::VideoScheduler(
     scoped_refptr<base::SingleThreadTaskRunner> capture_task_runner,
@@ -46,7 +54,10 @@ VideoScheduler::VideoScheduler(
       encoder_(encoder.Pass()),
       cursor_stub_(cursor_stub),
       video_stub_(video_stub),
-      pending_frames_(0),
+      frames_in_progress_(0),
+      queued_frames_(0),
+      next_frame_id_(0),
+      frame_bytes_(0),
       capture_pending_(false),
       did_skip_frame_(false),
       is_paused_(false),
@@ -76,9 +87,16 @@ void VideoScheduler::OnCaptureCompleted(webrtc::DesktopFrame* frame) {
         base::TimeDelta::FromMilliseconds(frame->capture_time_ms()));
   }
 
+  // Only one capture is pending at a time, so the completed capture is always
+  // the most recent one.
+  int64 frame_id = next_frame_id_ - 1;
+  TRACE_EVENT_ASYNC_END0("remoting", "VideoScheduler::Capture", frame_id);
+  TRACE_EVENT_ASYNC_BEGIN0("remoting", "VideoScheduler::Encode", frame_id);
+
   encode_task_runner_->PostTask(
       FROM_HERE, base::Bind(&VideoScheduler::EncodeFrame, this,
-                            base::Passed(&owned_frame), sequence_number_));
+                            base::Passed(&owned_frame), sequence_number_,
+                            frame_id));
 
   // If a frame was skipped, try to capture it again.
   if (did_skip_frame_) {
@@ -205,10 +223,11 @@ void VideoScheduler::CaptureNextFrame() {
   if (!capturer_ || is_paused_)
     return;
 
-  // Make sure we have at most two outstanding recordings. We can simply return
-  // if we can't make a capture now, the next capture will be started by the
-  // end of an encode operation.
-  if (pending_frames_ >= kMaxPendingFrames || capture_pending_) {
+  // Make sure the capture and encode stages, and the network queue, aren't
+  // full. We can simply return if we can't make a capture now, the next
+  // capture will be started when a frame leaves one of them.
+  if (frames_in_progress_ >= kMaxFramesInProgress ||
+      queued_frames_ >= kMaxQueuedFrames || capture_pending_) {
     did_skip_frame_ = true;
     return;
   }
@@ -216,24 +235,28 @@ void VideoScheduler::CaptureNextFrame() {
   did_skip_frame_ = false;
 
   // At this point we are going to perform one capture so save the current time.
-  pending_frames_++;
-  DCHECK_LE(pending_frames_, kMaxPendingFrames);
+  frames_in_progress_++;
+  DCHECK_LE(frames_in_progress_, kMaxFramesInProgress);
 
   // Before doing a capture schedule for the next one.
   ScheduleNextCapture();
 
   capture_pending_ = true;
+  TRACE_EVENT_ASYNC_BEGIN0("remoting", "VideoScheduler::Capture",
+                           next_frame_id_);
+  next_frame_id_++;
 
   // And finally perform one capture.
   capturer_->Capture(webrtc::DesktopRegion());
 }
 
-void VideoScheduler::FrameCaptureCompleted() {
+void VideoScheduler::FrameEncoded() {
   DCHECK(capture_task_runner_->BelongsToCurrentThread());
 
-  // Decrement the pending capture count.
-  pending_frames_--;
-  DCHECK_GE(pending_frames_, 0);
+  // Move the frame from the encode stage to the network queue.
+  frames_in_progress_--;
+  DCHECK_GE(frames_in_progress_, 0);
+  queued_frames_++;
 
   // If we've skipped a frame capture because too we had too many captures
   // pending then schedule one now.
@@ -241,29 +264,61 @@ void VideoScheduler::FrameCaptureCompleted() {
     CaptureNextFrame();
 }
 
+void VideoScheduler::FrameSent() {
+  DCHECK(capture_task_runner_->BelongsToCurrentThread());
+
+  // Decrement the queued frame count.
+  queued_frames_--;
+  DCHECK_GE(queued_frames_, 0);
+
+  if (did_skip_frame_)
+    CaptureNextFrame();
+}
+
 // Network thread --------------------------------------------------------------
 
-void VideoScheduler::SendVideoPacket(scoped_ptr<VideoPacket> packet) {
+void VideoScheduler::SendVideoPacket(int64 frame_id,
+                                     scoped_ptr<VideoPacket> packet) {
   DCHECK(network_task_runner_->BelongsToCurrentThread());
 
   if (!video_stub_)
     return;
 
+  // Measure from the first packet of the frame reaching the network thread.
+  if (frame_send_start_time_.is_null())
+    frame_send_start_time_ = base::TimeTicks::Now();
+  frame_bytes_ += packet->data().size();
+
   base::Closure callback;
-  if ((packet->flags() & VideoPacket::LAST_PARTITION) != 0)
-    callback = base::Bind(&VideoScheduler::VideoFrameSentCallback, this);
+  if ((packet->flags() & VideoPacket::LAST_PARTITION) != 0) {
+    callback = base::Bind(&VideoScheduler::VideoFrameSentCallback, this,
+                          frame_id, frame_send_start_time_, frame_bytes_);
+    frame_send_start_time_ = base::TimeTicks();
+    frame_bytes_ = 0;
+  }
 
   video_stub_->ProcessVideoPacket(packet.Pass(), callback);
 }
 
-void VideoScheduler::VideoFrameSentCallback() {
+void VideoScheduler::VideoFrameSentCallback(int64 frame_id,
+                                            base::TimeTicks send_start_time,
+                                            int frame_bytes) {
   DCHECK(network_task_runner_->BelongsToCurrentThread());
 
+  TRACE_EVENT_ASYNC_END0("remoting", "VideoScheduler::Send", frame_id);
+
   if (!video_stub_)
     return;
 
+  // Keep-alive packets and unchanged frames carry no data, and say nothing
+  // about the throughput.
+  if (frame_bytes > 0) {
+    scheduler_.RecordSendTime(frame_bytes,
+                              base::TimeTicks::Now() - send_start_time);
+  }
+
   capture_task_runner_->PostTask(
-      FROM_HERE, base::Bind(&VideoScheduler::FrameCaptureCompleted, this));
+      FROM_HERE, base::Bind(&VideoScheduler::FrameSent, this));
 }
 
 void VideoScheduler::SendCursorShape(
@@ -280,29 +335,33 @@ void VideoScheduler::SendCursorShape(
 
 void VideoScheduler::EncodeFrame(
     scoped_ptr<webrtc::DesktopFrame> frame,
-    int64 sequence_number) {
+    int64 sequence_number,
+    int64 frame_id) {
   DCHECK(encode_task_runner_->BelongsToCurrentThread());
 
   // If there is nothing to encode then send an empty keep-alive packet.
   if (!frame || frame->updated_region().is_empty()) {
     scoped_ptr<VideoPacket> packet(new VideoPacket());
     packet->set_flags(VideoPacket::LAST_PARTITION);
-    packet->set_client_sequence_number(sequence_number);
-    network_task_runner_->PostTask(
-        FROM_HERE, base::Bind(&VideoScheduler::SendVideoPacket, this,
-                              base::Passed(&packet)));
+    EncodedDataAvailableCallback(sequence_number, frame_id, packet.Pass());
     capture_task_runner_->DeleteSoon(FROM_HERE, frame.release());
     return;
   }
 
+  // Keep the encoded frames within what the network has been able to send.
+  int target_bitrate = scheduler_.TargetBitrateKbps();
+  if (target_bitrate > 0)
+    encoder_->SetTargetBitrate(target_bitrate);
+
   encoder_->Encode(
       frame.get(), base::Bind(&VideoScheduler::EncodedDataAvailableCallback,
-                              this, sequence_number));
+                              this, sequence_number, frame_id));
   capture_task_runner_->DeleteSoon(FROM_HERE, frame.release());
 }
 
 void VideoScheduler::EncodedDataAvailableCallback(
     int64 sequence_number,
+    int64 frame_id,
     scoped_ptr<VideoPacket> packet) {
   DCHECK(encode_task_runner_->BelongsToCurrentThread());
 
@@ -314,8 +373,18 @@ void VideoScheduler::EncodedDataAvailableCallback(
         base::TimeDelta::FromMilliseconds(packet->encode_time_ms()));
   }
 
+  // Once the last partition is out of the encoder the frame waits for the
+  // network. This is posted before the packet so that the capture thread
+  // sees the frame queued before it sees it sent.
+  if ((packet->flags() & VideoPacket::LAST_PARTITION) != 0) {
+    TRACE_EVENT_ASYNC_END0("remoting", "VideoScheduler::Encode", frame_id);
+    TRACE_EVENT_ASYNC_BEGIN0("remoting", "VideoScheduler::Send", frame_id);
+    capture_task_runner_->PostTask(
+        FROM_HERE, base::Bind(&VideoScheduler::FrameEncoded, this));
+  }
+
   network_task_runner_->PostTask(
-      FROM_HERE, base::Bind(&VideoScheduler::SendVideoPacket, this,
+      FROM_HERE, base::Bind(&VideoScheduler::SendVideoPacket, this, frame_id,
                             base::Passed(&packet)));
 }
 
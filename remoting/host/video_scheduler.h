@@ -72,6 +72,11 @@ class VideoStub;
 // of the capture, encode and network processes.  However, it also needs to
 // rate-limit captures to avoid overloading the host system, either by consuming
 // too much CPU, or hogging the host's graphics subsystem.
+//
+// Captures are also held back while too many encoded frames are waiting to be
+// written to the network, so that a slow connection doesn't build up a queue
+// of stale frames. The capture, encode and send stages of each frame are
+// recorded as asynchronous trace events in the "remoting" category.
 
 class VideoScheduler : public base::RefCountedThreadSafe<VideoScheduler>,
                        public webrtc::DesktopCapturer::Callback,
@@ -131,17 +136,26 @@ class VideoScheduler : public base::RefCountedThreadSafe<VideoScheduler>,
   // Starts the next frame capture, unless there are already too many pending.
   void CaptureNextFrame();
 
-  // Called when a frame capture has been encoded & sent to the client.
-  void FrameCaptureCompleted();
+  // Called when a frame has been encoded and is queued to be sent.
+  void FrameEncoded();
+
+  // Called when a frame has been sent to the client.
+  void FrameSent();
 
   // Network thread -----------------------------------------------------------
 
-  // Send |packet| to the client, unless we are in the process of stopping.
-  void SendVideoPacket(scoped_ptr<VideoPacket> packet);
+  // Send |packet| of frame |frame_id| to the client, unless we are in the
+  // process of stopping.
+  void SendVideoPacket(int64 frame_id, scoped_ptr<VideoPacket> packet);
 
   // Callback passed to |video_stub_| for the last packet in each frame, to
-  // rate-limit frame captures to network throughput.
-  void VideoFrameSentCallback();
+  // rate-limit frame captures to network throughput. It runs when the frame
+  // has left the socket writer's queue. |send_start_time| is when the first
+  // packet of the frame was handed to the network thread, and |frame_bytes|
+  // the size of all its packets.
+  void VideoFrameSentCallback(int64 frame_id,
+                              base::TimeTicks send_start_time,
+                              int frame_bytes);
 
   // Send updated cursor shape to client.
   void SendCursorShape(scoped_ptr<protocol::CursorShapeInfo> cursor_shape);
@@ -150,9 +164,11 @@ class VideoScheduler : public base::RefCountedThreadSafe<VideoScheduler>,
 
   // Encode a frame, passing generated VideoPackets to SendVideoPacket().
   void EncodeFrame(scoped_ptr<webrtc::DesktopFrame> frame,
-                   int64 sequence_number);
+                   int64 sequence_number,
+                   int64 frame_id);
 
   void EncodedDataAvailableCallback(int64 sequence_number,
+                                    int64 frame_id,
                                     scoped_ptr<VideoPacket> packet);
 
   // Task runners used by this class.
@@ -174,10 +190,22 @@ class VideoScheduler : public base::RefCountedThreadSafe<VideoScheduler>,
   // Timer used to schedule CaptureNextFrame().
   scoped_ptr<base::OneShotTimer<VideoScheduler> > capture_timer_;
 
-  // The number of frames being processed, i.e. frames that we are currently
-  // capturing, encoding or sending. The value is capped at 2 to minimize
-  // latency.
-  int pending_frames_;
+  // The number of frames that we are currently capturing or encoding.
+  int frames_in_progress_;
+
+  // The number of encoded frames that are waiting to be sent. The value is
+  // capped to apply backpressure from the network to the capturer.
+  int queued_frames_;
+
+  // Identifies the frames in trace events. Always accessed on the capture
+  // thread.
+  int64 next_frame_id_;
+
+  // When the first packet of the frame being sent reached the network thread,
+  // and the bytes sent for the frame so far. Always accessed on the network
+  // thread.
+  base::TimeTicks frame_send_start_time_;
+  int frame_bytes_;
 
   // Set when the capturer is capturing a frame.
   bool capture_pending_;
@@ -191,7 +219,9 @@ class VideoScheduler : public base::RefCountedThreadSafe<VideoScheduler>,
   // This is a number updated by client to trace performance.
   int64 sequence_number_;
 
-  // An object to schedule capturing.
+  // An object to schedule capturing. It is told about capture, encode and
+  // send times on the respective threads, and steers both the capture interval
+  // and the encoder's bitrate.
   CaptureScheduler scheduler_;
 
   DISALLOW_COPY_AND_ASSIGN(VideoScheduler);
@@ -9,6 +9,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "remoting/proto/event.pb.h"
 #include "remoting/proto/internal.pb.h"
+#include "remoting/proto/video.pb.h"
 #include "remoting/protocol/message_decoder.h"
 #include "remoting/protocol/util.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -121,5 +122,38 @@ TEST(MessageDecoderTest, EmptyReads) {
   SimulateReadSequence(kReads, arraysize(kReads));
 }
 
+// Messages framed with their payload in a separate buffer must decode the
+// same as if they were serialized in one piece.
+TEST(MessageDecoderTest, PayloadInSeparateBuffer) {
+  VideoPacket packet;
+  packet.set_flags(VideoPacket::FIRST_PACKET | VideoPacket::LAST_PACKET);
+  packet.mutable_format()->set_screen_width(640);
+  std::string payload(100000, 'x');
+  payload[0] = 'a';
+  std::string expected_payload = payload;
+
+  scoped_refptr<net::IOBufferWithSize> header;
+  scoped_refptr<net::IOBufferWithSize> data;
+  SerializeAndFrameMessageWithPayload(packet, VideoPacket::kDataFieldNumber,
+                                      &payload, &header, &data);
+  EXPECT_TRUE(payload.empty());
+  ASSERT_EQ(static_cast<int>(expected_payload.size()), data->size());
+
+  MessageDecoder decoder;
+  decoder.AddData(header, header->size());
+  EXPECT_FALSE(decoder.GetNextMessage());
+  decoder.AddData(data, data->size());
+  scoped_ptr<CompoundBuffer> message(decoder.GetNextMessage());
+  ASSERT_TRUE(message.get());
+  EXPECT_FALSE(decoder.GetNextMessage());
+
+  VideoPacket decoded;
+  CompoundBufferInputStream stream(message.get());
+  ASSERT_TRUE(decoded.ParseFromZeroCopyStream(&stream));
+  EXPECT_EQ(packet.flags(), decoded.flags());
+  EXPECT_EQ(640, decoded.format().screen_width());
+  EXPECT_EQ(expected_payload, decoded.data());
+}
+
 }  // namespace protocol
 }  // namespace remoting
@@ -63,7 +63,22 @@ bool ProtobufVideoWriter::is_connected() {
 
 void ProtobufVideoWriter::ProcessVideoPacket(scoped_ptr<VideoPacket> packet,
                                              const base::Closure& done) {
-  buffered_writer_.Write(SerializeAndFrameMessage(*packet), done);
+  if (packet->data().empty()) {
+    buffered_writer_.Write(SerializeAndFrameMessage(*packet), done);
+    return;
+  }
+
+  // Queue the encoded data as a buffer of its own, so that it isn't copied
+  // once more into the serialized message.
+  std::string data;
+  data.swap(*packet->mutable_data());
+  packet->clear_data();
+  scoped_refptr<net::IOBufferWithSize> header;
+  scoped_refptr<net::IOBufferWithSize> data_buffer;
+  SerializeAndFrameMessageWithPayload(*packet, VideoPacket::kDataFieldNumber,
+                                      &data, &header, &data_buffer);
+  buffered_writer_.Write(header, base::Closure());
+  buffered_writer_.Write(data_buffer, done);
 }
 
 }  // namespace protocol
@@ -10,9 +10,46 @@
 #include "net/base/io_buffer.h"
 #include "third_party/libjingle/source/talk/base/byteorder.h"
 
+#if defined(USE_SYSTEM_PROTOBUF)
+#include <google/protobuf/io/coded_stream.h>
+#else
+#include "third_party/protobuf/src/google/protobuf/io/coded_stream.h"
+#endif
+
+using google::protobuf::io::CodedOutputStream;
+
 namespace remoting {
 namespace protocol {
 
+namespace {
+
+// Wire type of strings, bytes and embedded messages.
+const uint32 kLengthDelimitedWireType = 2;
+
+// IOBufferWithSize that takes over the content of a string.
+class StringIOBufferWithSize : public net::IOBufferWithSize {
+ public:
+  explicit StringIOBufferWithSize(std::string* data)
+      : net::IOBufferWithSize(NULL, 0) {
+    string_data_.swap(*data);
+    data_ = const_cast<char*>(string_data_.data());
+    size_ = string_data_.size();
+  }
+
+ private:
+  virtual ~StringIOBufferWithSize() {
+    // The buffer belongs to |string_data_|, so remove it before the base
+    // class destructor tries to delete[] it.
+    data_ = NULL;
+  }
+
+  std::string string_data_;
+
+  DISALLOW_COPY_AND_ASSIGN(StringIOBufferWithSize);
+};
+
+}  // namespace
+
 scoped_refptr<net::IOBufferWithSize> SerializeAndFrameMessage(
     const google::protobuf::MessageLite& msg) {
   // Create a buffer with 4 extra bytes. This is used as prefix to write an
@@ -26,5 +63,33 @@ scoped_refptr<net::IOBufferWithSize> SerializeAndFrameMessage(
   return buffer;
 }
 
+void SerializeAndFrameMessageWithPayload(
+    const google::protobuf::MessageLite& msg,
+    int payload_field_number,
+    std::string* payload,
+    scoped_refptr<net::IOBufferWithSize>* header,
+    scoped_refptr<net::IOBufferWithSize>* data) {
+  // The bytes field is serialized after all the others. Protocol buffers
+  // may have their fields in any order, so the receiver doesn't mind.
+  const int kExtraBytes = sizeof(int32);
+  uint32 tag = (payload_field_number << 3) | kLengthDelimitedWireType;
+  uint32 payload_size = payload->size();
+  int fields_size = msg.ByteSize();
+  int message_size = fields_size + CodedOutputStream::VarintSize32(tag) +
+      CodedOutputStream::VarintSize32(payload_size) + payload_size;
+
+  *header = new net::IOBufferWithSize(
+      kExtraBytes + message_size - payload_size);
+  talk_base::SetBE32((*header)->data(), message_size);
+  uint8* target = reinterpret_cast<uint8*>((*header)->data()) + kExtraBytes;
+  target = msg.SerializeWithCachedSizesToArray(target);
+  target = CodedOutputStream::WriteVarint32ToArray(tag, target);
+  target = CodedOutputStream::WriteVarint32ToArray(payload_size, target);
+  DCHECK_EQ(reinterpret_cast<char*>(target),
+            (*header)->data() + (*header)->size());
+
+  *data = new StringIOBufferWithSize(payload);
+}
+
 }  // namespace protocol
 }  // namespace remoting
@@ -8,6 +8,8 @@
 #ifndef REMOTING_PROTOCOL_UTIL_H_
 #define REMOTING_PROTOCOL_UTIL_H_
 
+#include <string>
+
 #include "net/base/io_buffer.h"
 
 #if defined(USE_SYSTEM_PROTOBUF)
@@ -26,6 +28,19 @@ namespace protocol {
 scoped_refptr<net::IOBufferWithSize> SerializeAndFrameMessage(
     const google::protobuf::MessageLite& msg);
 
+// Same as above, but for messages that carry a large bytes field, e.g. the
+// data of a VideoPacket, which is taken from |payload| rather than from
+// |msg|, where it must be left empty. The framed message is returned in two
+// buffers: |header| holds the size prefix, the other fields and the key of
+// the bytes field, and |data| takes over the content of |payload| without
+// copying it. The receiver parses the result as any other framed message.
+void SerializeAndFrameMessageWithPayload(
+    const google::protobuf::MessageLite& msg,
+    int payload_field_number,
+    std::string* payload,
+    scoped_refptr<net::IOBufferWithSize>* header,
+    scoped_refptr<net::IOBufferWithSize>* data);
+
 }  // namespace protocol
 }  // namespace remoting
 
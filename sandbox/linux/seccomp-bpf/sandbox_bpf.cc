@@ -39,6 +39,74 @@ using playground2::arch_seccomp_data;
 
 const int kExpectedExitCode = 100;
 
+// System calls that sandboxed processes (renderers in particular) make far
+// more often than any others, together with their approximate relative
+// frequencies. Every other system call has a weight of one. The jump table
+// is balanced by these weights, which puts the hot system calls on the
+// shortest paths through the BPF program.
+struct HotSyscall {
+  int sysnum;
+  uint32_t weight;
+};
+
+const HotSyscall kHotSyscalls[] = {
+#if defined(__NR_futex)
+  { __NR_futex,         64 },
+#endif
+#if defined(__NR_read)
+  { __NR_read,          32 },
+#endif
+#if defined(__NR_write)
+  { __NR_write,         32 },
+#endif
+#if defined(__NR_sendmsg)
+  { __NR_sendmsg,       32 },
+#endif
+#if defined(__NR_recvmsg)
+  { __NR_recvmsg,       32 },
+#endif
+#if defined(__NR_mmap)
+  { __NR_mmap,          16 },
+#endif
+#if defined(__NR_mmap2)
+  { __NR_mmap2,         16 },
+#endif
+#if defined(__NR_munmap)
+  { __NR_munmap,        16 },
+#endif
+#if defined(__NR_socketcall)
+  // On i386, sendmsg() and recvmsg() are multiplexed through socketcall().
+  { __NR_socketcall,    64 },
+#endif
+#if defined(__NR_poll)
+  { __NR_poll,           8 },
+#endif
+#if defined(__NR_epoll_wait)
+  { __NR_epoll_wait,     8 },
+#endif
+#if defined(__NR_madvise)
+  { __NR_madvise,        8 },
+#endif
+#if defined(__NR_mprotect)
+  { __NR_mprotect,       8 },
+#endif
+#if defined(__NR_close)
+  { __NR_close,          8 },
+#endif
+};
+
+// Returns the weight of the system call range "from".."to".
+uint32_t RangeWeight(uint32_t from, uint32_t to) {
+  uint32_t weight = 1;
+  for (size_t i = 0; i < arraysize(kHotSyscalls); ++i) {
+    uint32_t sysnum = static_cast<uint32_t>(kHotSyscalls[i].sysnum);
+    if (sysnum >= from && sysnum <= to) {
+      weight += kHotSyscalls[i].weight;
+    }
+  }
+  return weight;
+}
+
 template<class T> int popcount(T x);
 template<> int popcount<unsigned int>(unsigned int x) {
   return __builtin_popcount(x);
@@ -728,6 +796,7 @@ void Sandbox::FindRanges(Ranges *ranges) {
     }
     if (!err.Equals(old_err) || iter.Done()) {
       ranges->push_back(Range(old_sysnum, sysnum - 1, old_err));
+      ranges->back().weight = RangeWeight(old_sysnum, sysnum - 1);
       old_sysnum = sysnum;
       old_err    = err;
     }
@@ -749,11 +818,30 @@ Instruction *Sandbox::AssembleJumpTable(CodeGen *gen,
     return RetExpression(gen, start->err);
   }
 
-  // Pick the range object that is located at the mid point of our list.
+  // Pick the range object that splits the total weight of our list most
+  // evenly. Without any hot system calls, this is the range object that is
+  // located at the mid point of our list. Otherwise, heavily weighted ranges
+  // end up near the root of the tree, and rarely used ones further down.
   // We compare our system call number against the lowest valid system call
   // number in this range object. If our number is lower, it is outside of
   // this range object. If it is greater or equal, it might be inside.
-  Ranges::const_iterator mid = start + (stop - start)/2;
+  uint64_t total = 0;
+  for (Ranges::const_iterator iter = start; iter != stop; ++iter) {
+    total += iter->weight;
+  }
+  Ranges::const_iterator mid = start + 1;
+  uint64_t left = start->weight;
+  uint64_t best = 2*left > total ? 2*left - total : total - 2*left;
+  for (Ranges::const_iterator iter = start + 2; iter != stop; ++iter) {
+    left += (iter - 1)->weight;
+    uint64_t imbalance = 2*left > total ? 2*left - total : total - 2*left;
+    if (imbalance >= best) {
+      // The imbalance only grows from here on.
+      break;
+    }
+    best = imbalance;
+    mid  = iter;
+  }
 
   // Sub-divide the list of ranges and continue recursively.
   Instruction *jf = AssembleJumpTable(gen, start, mid);
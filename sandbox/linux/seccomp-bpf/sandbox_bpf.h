@@ -195,9 +195,15 @@ class Sandbox {
     Range(uint32_t f, uint32_t t, const ErrorCode& e)
         : from(f),
           to(t),
+          weight(1),
           err(e) {
     }
     uint32_t  from, to;
+
+    // Relative frequency with which system calls in this range are expected
+    // to be made. AssembleJumpTable() uses this to keep frequently used
+    // system calls close to the root of the jump table.
+    uint32_t  weight;
     ErrorCode err;
   };
   typedef std::vector<Range> Ranges;
@@ -234,11 +240,14 @@ class Sandbox {
   // Finds all the ranges of system calls that need to be handled. Ranges are
   // sorted in ascending order of system call numbers. There are no gaps in the
   // ranges. System calls with identical ErrorCodes are coalesced into a single
-  // range.
+  // range. Each range is weighted by how often its system calls are made.
   void FindRanges(Ranges *ranges);
 
   // Returns a BPF program snippet that implements a jump table for the
-  // given range of system call numbers. This function runs recursively.
+  // given range of system call numbers. The table is a binary search tree
+  // that is balanced by range weight rather than by number of ranges, so
+  // that the most frequently made system calls need the fewest comparisons.
+  // This function runs recursively.
   Instruction *AssembleJumpTable(CodeGen *gen,
                                  Ranges::const_iterator start,
                                  Ranges::const_iterator stop);
@@ -21,6 +21,7 @@
 #include <ostream>
 
 #include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
 #include "build/build_config.h"
 #include "sandbox/linux/seccomp-bpf/bpf_tests.h"
 #include "sandbox/linux/seccomp-bpf/syscall.h"
@@ -1726,4 +1727,72 @@ BPF_TEST(SandboxBpf, PthreadBitMask, PthreadPolicyBitMask) {
   PthreadTest();
 }
 
+// A policy that alternately allows and denies consecutive system calls. This
+// gives the compiler the largest possible number of ranges to build its jump
+// table from.
+ErrorCode AlternatingPolicy(Sandbox *, int sysno, void *) {
+  if (!Sandbox::IsValidSyscallNumber(sysno)) {
+    return ErrorCode(ENOSYS);
+  }
+  return (sysno & 1) ? ErrorCode(ErrorCode::ERR_ALLOWED) : ErrorCode(EPERM);
+}
+
+// Microbenchmark of the time that the compiled filter takes to evaluate some
+// of the most frequently made system calls, compared to a few rarely made
+// ones. The filter runs in the verifier's BPF interpreter rather than in the
+// kernel, so only the relative numbers are meaningful. Frequently made system
+// calls sit closer to the root of the jump table and should be faster.
+TEST(SandboxBpf, FilterEvaluationCost) {
+  static const struct {
+    const char *name;
+    int sysno;
+  } kSyscalls[] = {
+#if defined(__NR_futex)
+    { "futex",     __NR_futex },
+#endif
+    { "read",      __NR_read },
+    { "write",     __NR_write },
+#if defined(__NR_mmap)
+    { "mmap",      __NR_mmap },
+#endif
+#if defined(__NR_mmap2)
+    { "mmap2",     __NR_mmap2 },
+#endif
+#if defined(__NR_sendmsg)
+    { "sendmsg",   __NR_sendmsg },
+#endif
+    { "getpid",    __NR_getpid },
+    { "nanosleep", __NR_nanosleep },
+    { "uname",     __NR_uname },
+  };
+  const int kIterations = 100000;
+
+  Sandbox sandbox;
+  sandbox.SetSandboxPolicy(AlternatingPolicy, NULL);
+  scoped_ptr<Sandbox::Program> program(
+      sandbox.AssembleFilter(true /* force_verification */));
+  ASSERT_TRUE(program.get());
+
+  for (size_t i = 0; i < arraysize(kSyscalls); ++i) {
+    struct arch_seccomp_data data = { };
+    data.nr   = kSyscalls[i].sysno;
+    data.arch = SECCOMP_ARCH;
+    const uint32_t expected =
+        AlternatingPolicy(&sandbox, kSyscalls[i].sysno, NULL).err();
+
+    const char *err = NULL;
+    uint32_t result = 0;
+    base::TimeTicks start = base::TimeTicks::HighResNow();
+    for (int j = 0; j < kIterations && !err; ++j) {
+      result = Verifier::EvaluateBPF(*program, data, &err);
+    }
+    base::TimeDelta elapsed = base::TimeTicks::HighResNow() - start;
+
+    EXPECT_FALSE(err) << err;
+    EXPECT_EQ(expected, result) << kSyscalls[i].name;
+    std::cout << "Filter evaluation cost for " << kSyscalls[i].name << ": "
+              << elapsed.InMillisecondsF() * 1000000 / kIterations << " ns\n";
+  }
+}
+
 } // namespace
@@ -66,6 +66,11 @@ bool IsFullQuad(const SkDraw& draw,
          draw_bitmap_rect.contains(canvas_rect);
 }
 
+// Ganesh draws these with a software mask that is uploaded for every draw.
+bool IsSlowOnGpu(const SkPaint& paint) {
+  return paint.getMaskFilter() != NULL;
+}
+
 } // namespace
 
 namespace skia {
@@ -76,7 +81,8 @@ AnalysisDevice::AnalysisDevice(const SkBitmap& bitmap)
       is_forced_not_transparent_(false),
       is_solid_color_(true),
       is_transparent_(true),
-      has_text_(false) {}
+      has_text_(false),
+      is_suitable_for_gpu_rasterization_(true) {}
 
 AnalysisDevice::~AnalysisDevice() {}
 
@@ -96,6 +102,14 @@ bool AnalysisDevice::HasText() const {
   return has_text_;
 }
 
+bool AnalysisDevice::SuitableForGpuRasterization() const {
+  return is_suitable_for_gpu_rasterization_;
+}
+
+void AnalysisDevice::SetNotSuitableForGpuRasterization() {
+  is_suitable_for_gpu_rasterization_ = false;
+}
+
 void AnalysisDevice::SetForceNotSolid(bool flag) {
   is_forced_not_solid_ = flag;
   if (is_forced_not_solid_)
@@ -137,6 +151,9 @@ void AnalysisDevice::drawPoints(const SkDraw& draw,
 void AnalysisDevice::drawRect(const SkDraw& draw,
                               const SkRect& rect,
                               const SkPaint& paint) {
+  if (IsSlowOnGpu(paint))
+    is_suitable_for_gpu_rasterization_ = false;
+
   bool does_cover_canvas =
       IsFullQuad(draw, SkRect::MakeWH(width(), height()), rect);
 
@@ -178,6 +195,8 @@ void AnalysisDevice::drawRect(const SkDraw& draw,
 void AnalysisDevice::drawOval(const SkDraw& draw,
                               const SkRect& oval,
                               const SkPaint& paint) {
+  if (IsSlowOnGpu(paint))
+    is_suitable_for_gpu_rasterization_ = false;
   is_solid_color_ = false;
   is_transparent_ = false;
 }
@@ -187,6 +206,9 @@ void AnalysisDevice::drawPath(const SkDraw& draw,
                               const SkPaint& paint,
                               const SkMatrix* pre_path_matrix,
                               bool path_is_mutable) {
+  // Anti-aliased concave paths go through the software path renderer.
+  if (IsSlowOnGpu(paint) || (paint.isAntiAlias() && !path.isConvex()))
+    is_suitable_for_gpu_rasterization_ = false;
   is_solid_color_ = false;
   is_transparent_ = false;
 }
@@ -306,6 +328,11 @@ bool AnalysisCanvas::HasText() const {
   return (static_cast<AnalysisDevice*>(getDevice()))->HasText();
 }
 
+bool AnalysisCanvas::SuitableForGpuRasterization() const {
+  return (static_cast<AnalysisDevice*>(getDevice()))->
+      SuitableForGpuRasterization();
+}
+
 bool AnalysisCanvas::abortDrawing() {
   // Early out as soon as we have detected that the tile has text.
   return HasText();
@@ -359,6 +386,12 @@ int AnalysisCanvas::saveLayer(const SkRect* bounds,
                               SkCanvas::SaveFlags flags) {
   ++saved_stack_size_;
 
+  // Image filters on layers are applied on the CPU.
+  if (paint && paint->getImageFilter()) {
+    (static_cast<AnalysisDevice*>(getDevice()))->
+        SetNotSuitableForGpuRasterization();
+  }
+
   // If after we draw to the saved layer, we have to blend with the current
   // layer, then we can conservatively say that the canvas will not be of
   // solid color.
@@ -28,6 +28,7 @@ class SK_API AnalysisCanvas : public SkCanvas, public SkDrawPictureCallback {
   // Returns true when a SkColor can be used to represent result.
   bool GetColorIfSolid(SkColor* color) const;
   bool HasText() const;
+  bool SuitableForGpuRasterization() const;
 
   // SkDrawPictureCallback override.
   virtual bool abortDrawing() OVERRIDE;
@@ -66,8 +67,14 @@ class SK_API AnalysisDevice : public SkDevice {
   bool GetColorIfSolid(SkColor* color) const;
   bool HasText() const;
 
+  // Returns false once something has been drawn that Ganesh is known to
+  // handle poorly, e.g. anti-aliased concave paths or mask filters, which
+  // it falls back to rasterizing in software and uploading.
+  bool SuitableForGpuRasterization() const;
+
   void SetForceNotSolid(bool flag);
   void SetForceNotTransparent(bool flag);
+  void SetNotSuitableForGpuRasterization();
 
  protected:
   // SkDevice overrides.
@@ -156,6 +163,7 @@ class SK_API AnalysisDevice : public SkDevice {
   SkColor color_;
   bool is_transparent_;
   bool has_text_;
+  bool is_suitable_for_gpu_rasterization_;
 };
 
 }  // namespace skia
@@ -403,4 +403,48 @@ TEST(AnalysisCanvasTest, HasText) {
   }
 }
 
+TEST(AnalysisCanvasTest, SuitableForGpuRasterization) {
+  SkBitmap bitmap;
+  bitmap.setConfig(SkBitmap::kNo_Config, 100, 100);
+
+  SkPath convex_path;
+  convex_path.addRect(SkRect::MakeWH(50, 50));
+
+  SkPath concave_path;
+  concave_path.moveTo(0, 0);
+  concave_path.lineTo(50, 50);
+  concave_path.lineTo(100, 0);
+  concave_path.lineTo(50, 100);
+  concave_path.close();
+
+  SkPaint paint;
+  paint.setAntiAlias(true);
+
+  {
+    skia::AnalysisDevice device(bitmap);
+    skia::AnalysisCanvas canvas(&device);
+    EXPECT_TRUE(canvas.SuitableForGpuRasterization());
+    canvas.drawRect(SkRect::MakeWH(50, 50), paint);
+    canvas.drawPath(convex_path, paint);
+    EXPECT_TRUE(canvas.SuitableForGpuRasterization());
+  }
+  {
+    // Aliased concave paths don't need the software path renderer.
+    skia::AnalysisDevice device(bitmap);
+    skia::AnalysisCanvas canvas(&device);
+    SkPaint aliased_paint;
+    canvas.drawPath(concave_path, aliased_paint);
+    EXPECT_TRUE(canvas.SuitableForGpuRasterization());
+  }
+  {
+    skia::AnalysisDevice device(bitmap);
+    skia::AnalysisCanvas canvas(&device);
+    canvas.drawPath(concave_path, paint);
+    EXPECT_FALSE(canvas.SuitableForGpuRasterization());
+    // Drawing over the path doesn't make the tile suitable again.
+    canvas.clear(SK_ColorWHITE);
+    EXPECT_FALSE(canvas.SuitableForGpuRasterization());
+  }
+}
+
 }  // namespace skia
@@ -8,6 +8,7 @@
 #include "skia/ext/convolver.h"
 #include "skia/ext/convolver_SSE2.h"
 #include "skia/ext/convolver_mips_dspr2.h"
+#include "skia/ext/convolver_neon.h"
 #include "third_party/skia/include/core/SkSize.h"
 #include "third_party/skia/include/core/SkTypes.h"
 
@@ -373,6 +374,11 @@ void SetupSIMD(ConvolveProcs *procs) {
   procs->extra_horizontal_reads = 3;
   procs->convolve_vertically = &ConvolveVertically_mips_dspr2;
   procs->convolve_horizontally = &ConvolveHorizontally_mips_dspr2;
+#elif defined SIMD_NEON
+  // The NEON version doesn't read past the end of the filter.
+  procs->extra_horizontal_reads = 0;
+  procs->convolve_vertically = &ConvolveVertically_Neon;
+  procs->convolve_horizontally = &ConvolveHorizontally_Neon;
 #endif
 }
 
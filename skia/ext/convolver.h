@@ -24,6 +24,10 @@
     defined(__mips_dsp) && (__mips_dsp_rev >= 2)
 #define SIMD_MIPS_DSPR2 1
 #endif
+
+#if defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+#define SIMD_NEON 1
+#endif
 // avoid confusion with Mac OS X's math library (Carbon)
 #if defined(__APPLE__)
 #undef FloatToFixed
@@ -0,0 +1,166 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "skia/ext/convolver_neon.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+
+#include <arm_neon.h>
+
+namespace skia {
+
+namespace {
+
+// Loads the pixel at |src| into the low half of a vector, as 16 bits per
+// channel. Pixels are only 4-byte aligned in the rows of the circular buffer,
+// so this goes through memcpy.
+inline int16x4_t LoadPixel(const unsigned char* src) {
+  uint32_t pixel;
+  memcpy(&pixel, src, sizeof(pixel));
+  uint8x8_t pixel8 = vreinterpret_u8_u32(vdup_n_u32(pixel));
+  return vget_low_s16(vreinterpretq_s16_u16(vmovl_u8(pixel8)));
+}
+
+// Brings the accumulated channels of two pixels back to 8 bits, like
+// BringBackTo8() does for a single channel.
+inline uint8x8_t PackPixels(int32x4_t accum0, int32x4_t accum1) {
+  int32x4_t shifted0 = vshrq_n_s32(accum0, ConvolutionFilter1D::kShiftBits);
+  int32x4_t shifted1 = vshrq_n_s32(accum1, ConvolutionFilter1D::kShiftBits);
+  return vqmovn_u16(vcombine_u16(vqmovun_s32(shifted0),
+                                 vqmovun_s32(shifted1)));
+}
+
+}  // namespace
+
+// Convolves horizontally along a single row. The row data is given in
+// |src_data| and continues for the num_values() of the filter.
+void ConvolveHorizontally_Neon(const unsigned char* src_data,
+                               const ConvolutionFilter1D& filter,
+                               unsigned char* out_row,
+                               bool /*has_alpha*/) {
+  int num_values = filter.num_values();
+
+  // Output one pixel each iteration, calculating all channels (RGBA) together.
+  for (int out_x = 0; out_x < num_values; out_x++) {
+    int filter_offset, filter_length;
+    const ConvolutionFilter1D::Fixed* filter_values =
+        filter.FilterForValue(out_x, &filter_offset, &filter_length);
+
+    // Compute the first pixel in this row that the filter affects. It will
+    // touch |filter_length| pixels (4 bytes each) after this.
+    const unsigned char* row_to_filter = &src_data[filter_offset << 2];
+
+    int32x4_t accum = vdupq_n_s32(0);
+
+    // Four coefficients and four pixels per iteration. Unlike the SSE2
+    // version, nothing past the end of the filter is read, so the last rows
+    // of the image don't need the C++ fallback.
+    int filter_x = 0;
+    for (; filter_x + 4 <= filter_length; filter_x += 4) {
+      int16x4_t coeff = vld1_s16(&filter_values[filter_x]);
+      uint8x16_t src8 = vld1q_u8(&row_to_filter[filter_x << 2]);
+      int16x8_t src16_01 = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(src8)));
+      int16x8_t src16_23 =
+          vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(src8)));
+      accum = vmlal_lane_s16(accum, vget_low_s16(src16_01), coeff, 0);
+      accum = vmlal_lane_s16(accum, vget_high_s16(src16_01), coeff, 1);
+      accum = vmlal_lane_s16(accum, vget_low_s16(src16_23), coeff, 2);
+      accum = vmlal_lane_s16(accum, vget_high_s16(src16_23), coeff, 3);
+    }
+    for (; filter_x < filter_length; filter_x++) {
+      accum = vmlal_n_s16(accum,
+                          LoadPixel(&row_to_filter[filter_x << 2]),
+                          filter_values[filter_x]);
+    }
+
+    // The high half of the packed vector is a copy of the pixel.
+    uint8x8_t pixel = PackPixels(accum, accum);
+    vst1_lane_u32(reinterpret_cast<uint32_t*>(&out_row[out_x << 2]),
+                  vreinterpret_u32_u8(pixel), 0);
+  }
+}
+
+// Does vertical convolution to produce one output row. The filter values and
+// length are given in the first two parameters. These are applied to each
+// of the rows pointed to in the |source_data_rows| array, with each row
+// being |pixel_width| wide.
+//
+// The output must have room for |pixel_width * 4| bytes.
+void ConvolveVertically_Neon(const ConvolutionFilter1D::Fixed* filter_values,
+                             int filter_length,
+                             unsigned char* const* source_data_rows,
+                             int pixel_width,
+                             unsigned char* out_row,
+                             bool has_alpha) {
+  // Output four pixels per iteration (16 bytes).
+  int out_x = 0;
+  for (; out_x + 4 <= pixel_width; out_x += 4) {
+    int byte_offset = out_x << 2;
+    int32x4_t accum0 = vdupq_n_s32(0);
+    int32x4_t accum1 = vdupq_n_s32(0);
+    int32x4_t accum2 = vdupq_n_s32(0);
+    int32x4_t accum3 = vdupq_n_s32(0);
+    for (int filter_y = 0; filter_y < filter_length; filter_y++) {
+      int16_t coeff = filter_values[filter_y];
+      uint8x16_t src8 = vld1q_u8(&source_data_rows[filter_y][byte_offset]);
+      int16x8_t src16_01 = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(src8)));
+      int16x8_t src16_23 =
+          vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(src8)));
+      accum0 = vmlal_n_s16(accum0, vget_low_s16(src16_01), coeff);
+      accum1 = vmlal_n_s16(accum1, vget_high_s16(src16_01), coeff);
+      accum2 = vmlal_n_s16(accum2, vget_low_s16(src16_23), coeff);
+      accum3 = vmlal_n_s16(accum3, vget_high_s16(src16_23), coeff);
+    }
+
+    uint8x16_t result = vcombine_u8(PackPixels(accum0, accum1),
+                                    PackPixels(accum2, accum3));
+    uint32x4_t result32 = vreinterpretq_u32_u8(result);
+    if (has_alpha) {
+      // Make sure the alpha channel doesn't come out smaller than any of the
+      // color channels, as in the C++ version. The lowest byte of each pixel
+      // ends up with max(r, g, b), which is then moved to the alpha byte.
+      uint8x16_t max_color = vmaxq_u8(
+          result, vreinterpretq_u8_u32(vshrq_n_u32(result32, 8)));
+      max_color = vmaxq_u8(
+          max_color, vreinterpretq_u8_u32(vshrq_n_u32(result32, 16)));
+      uint32x4_t min_alpha =
+          vshlq_n_u32(vreinterpretq_u32_u8(max_color), 24);
+      result = vmaxq_u8(result, vreinterpretq_u8_u32(min_alpha));
+    } else {
+      // No alpha channel, the image is opaque.
+      result = vreinterpretq_u8_u32(
+          vorrq_u32(result32, vdupq_n_u32(0xff000000)));
+    }
+    vst1q_u8(&out_row[byte_offset], result);
+  }
+
+  // The remaining pixels, one at a time.
+  for (; out_x < pixel_width; out_x++) {
+    int byte_offset = out_x << 2;
+    int32x4_t accum = vdupq_n_s32(0);
+    for (int filter_y = 0; filter_y < filter_length; filter_y++) {
+      accum = vmlal_n_s16(accum,
+                          LoadPixel(&source_data_rows[filter_y][byte_offset]),
+                          filter_values[filter_y]);
+    }
+
+    unsigned char pixel[8];
+    vst1_u8(pixel, PackPixels(accum, accum));
+    out_row[byte_offset + 0] = pixel[0];
+    out_row[byte_offset + 1] = pixel[1];
+    out_row[byte_offset + 2] = pixel[2];
+    if (has_alpha) {
+      unsigned char max_color_channel =
+          std::max(pixel[0], std::max(pixel[1], pixel[2]));
+      out_row[byte_offset + 3] = std::max(pixel[3], max_color_channel);
+    } else {
+      out_row[byte_offset + 3] = 0xff;
+    }
+  }
+}
+
+}  // namespace skia
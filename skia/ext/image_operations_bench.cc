@@ -12,10 +12,14 @@
 // To present a single number in MB/s, it calculates the 'speed' by taking
 // source surface + destination surface and dividing by the elapsed time.
 // This number is somewhat reasonable way to measure this, given our current
-// implementation which somewhat scales this way.
+// implementation which somewhat scales this way. The same is reported in
+// megapixels per second, which doesn't depend on the pixel format.
+// With "-method all", every resize method is measured in turn.
 
 #include <stdio.h>
 
+#include <vector>
+
 #include "base/basictypes.h"
 #include "base/command_line.h"
 #include "base/format_macros.h"
@@ -81,6 +85,11 @@ void PrintMethods() {
   }
 }
 
+// Returns the number of pixels that the bitmap has.
+int GetBitmapPixels(const SkBitmap* bitmap) {
+  return bitmap->height() * bitmap->width();
+}
+
 // Returns the number of bytes that the bitmap has. This number is different
 // from what SkBitmap::getSize() returns since it does not take into account
 // the stride. The difference between the stride and the width can be large
@@ -140,8 +149,7 @@ class Benchmark {
   static const skia::ImageOperations::ResizeMethod kDefaultResizeMethod;
 
   Benchmark()
-      : num_iterations_(kDefaultNumberIterations),
-        method_(kDefaultResizeMethod) {}
+      : num_iterations_(kDefaultNumberIterations) {}
 
   // Returns true if command line parsing was successful, false otherwise.
   bool ParseArgs(const CommandLine* command_line);
@@ -151,8 +159,11 @@ class Benchmark {
 
   static void Usage();
  private:
+  // Returns true if successful, false otherwise.
+  bool RunMethod(skia::ImageOperations::ResizeMethod method) const;
+
   int num_iterations_;
-  skia::ImageOperations::ResizeMethod method_;
+  std::vector<skia::ImageOperations::ResizeMethod> methods_;
   Dimensions source_;
   Dimensions dest_;
 };
@@ -173,7 +184,7 @@ void Benchmark::Usage() {
          Benchmark::kDefaultNumberIterations,
          MethodToString(Benchmark::kDefaultResizeMethod));
   PrintMethods();
-  printf("\n  -help: prints this help and exits\n");
+  printf(", or all\n  -help: prints this help and exits\n");
 }
 
 bool Benchmark::ParseArgs(const CommandLine* command_line) {
@@ -199,7 +210,13 @@ bool Benchmark::ParseArgs(const CommandLine* command_line) {
         fNeedHelp = true;
       }
     } else if (s == "method") {
-      if (!StringToMethod(value, &method_)) {
+      skia::ImageOperations::ResizeMethod method;
+      if (base::strcasecmp(value.c_str(), "all") == 0) {
+        for (size_t i = 0; i < arraysize(resize_methods); ++i)
+          methods_.push_back(resize_methods[i].method);
+      } else if (StringToMethod(value, &method)) {
+        methods_.push_back(method);
+      } else {
         printf("Invalid method '%s' specified\n", value.c_str());
         fNeedHelp = true;
       }
@@ -223,11 +240,21 @@ bool Benchmark::ParseArgs(const CommandLine* command_line) {
   if (fNeedHelp == true) {
     return false;
   }
+  if (methods_.empty())
+    methods_.push_back(kDefaultResizeMethod);
   return true;
 }
 
-// actual benchmark.
 bool Benchmark::Run() const {
+  for (size_t i = 0; i < methods_.size(); ++i) {
+    if (!RunMethod(methods_[i]))
+      return false;
+  }
+  return true;
+}
+
+// actual benchmark.
+bool Benchmark::RunMethod(skia::ImageOperations::ResizeMethod method) const {
   SkBitmap source;
   source.setConfig(SkBitmap::kARGB_8888_Config,
                    source_.width(), source_.height());
@@ -240,7 +267,7 @@ bool Benchmark::Run() const {
 
   for (int i = 0; i < num_iterations_; ++i) {
     dest = skia::ImageOperations::Resize(source,
-                                         method_,
+                                         method,
                                          dest_.width(), dest_.height());
   }
 
@@ -249,8 +276,15 @@ bool Benchmark::Run() const {
   const uint64 num_bytes = static_cast<uint64>(num_iterations_) *
       (GetBitmapSize(&source) + GetBitmapSize(&dest));
 
-  printf("%" PRIu64 " MB/s,\telapsed = %" PRIu64 " source=%d dest=%d\n",
+  const uint64 num_pixels = static_cast<uint64>(num_iterations_) *
+      (GetBitmapPixels(&source) + GetBitmapPixels(&dest));
+
+  // Bytes and pixels per microsecond are MB/s and MP/s.
+  printf("%s: %" PRIu64 " MB/s, %.1f MP/s,\telapsed = %" PRIu64
+         " source=%d dest=%d\n",
+         MethodToString(method),
          static_cast<uint64>(elapsed_us == 0 ? 0 : num_bytes / elapsed_us),
+         elapsed_us == 0 ? 0. : static_cast<double>(num_pixels) / elapsed_us,
          static_cast<uint64>(elapsed_us),
          GetBitmapSize(&source), GetBitmapSize(&dest));
 
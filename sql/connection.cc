@@ -31,6 +31,17 @@ namespace {
 // TODO(shess): Better story on this.  http://crbug.com/56559
 const int kBusyTimeoutSeconds = 1;
 
+// Number of statements kept by GetUniqueStatement() for reuse.
+const size_t kUniqueStatementCacheSize = 16;
+
+// Returns a histogram of durations in microseconds named |name|.|tag|.
+base::HistogramBase* GetTimingHistogram(const std::string& name,
+                                        const std::string& tag) {
+  return base::Histogram::FactoryGet(
+      name + "." + tag, 1, 1000000, 50,
+      base::HistogramBase::kUmaTargetedHistogramFlag);
+}
+
 class ScopedBusyTimeout {
  public:
   explicit ScopedBusyTimeout(sqlite3* db)
@@ -200,10 +211,16 @@ Connection::Connection()
       cache_size_(0),
       exclusive_locking_(false),
       restrict_to_user_(false),
+      wal_mode_(false),
+      is_wal_mode_(false),
+      unique_statement_cache_(kUniqueStatementCacheSize),
       transaction_nesting_(0),
       needs_rollback_(false),
       in_memory_(false),
-      poisoned_(false) {
+      poisoned_(false),
+      prepare_time_histogram_(NULL),
+      step_time_histogram_(NULL),
+      commit_time_histogram_(NULL) {
 }
 
 Connection::~Connection() {
@@ -251,6 +268,7 @@ void Connection::CloseInternal(bool forced) {
 
   // Release cached statements.
   statement_cache_.clear();
+  unique_statement_cache_.Clear();
 
   // With cached statements released, in-use statements will remain.
   // Closing the database while statements are in use is an API
@@ -280,6 +298,7 @@ void Connection::CloseInternal(bool forced) {
     }
   }
   db_ = NULL;
+  is_wal_mode_ = false;
 }
 
 void Connection::Close() {
@@ -526,16 +545,37 @@ bool Connection::Delete(const base::FilePath& path) {
 
   base::FilePath journal_path(path.value() + FILE_PATH_LITERAL("-journal"));
   base::FilePath wal_path(path.value() + FILE_PATH_LITERAL("-wal"));
+  base::FilePath shm_path(path.value() + FILE_PATH_LITERAL("-shm"));
 
   base::DeleteFile(journal_path, false);
   base::DeleteFile(wal_path, false);
+  base::DeleteFile(shm_path, false);
   base::DeleteFile(path, false);
 
   return !base::PathExists(journal_path) &&
       !base::PathExists(wal_path) &&
+      !base::PathExists(shm_path) &&
       !base::PathExists(path);
 }
 
+bool Connection::CheckpointWAL() {
+  AssertIOAllowed();
+  if (!db_) {
+    DLOG_IF(FATAL, !poisoned_) << "Illegal use of connection without a db";
+    return false;
+  }
+  if (!is_wal_mode_)
+    return false;
+
+  int rc = sqlite3_wal_checkpoint_v2(db_, NULL, SQLITE_CHECKPOINT_PASSIVE,
+                                     NULL, NULL);
+  if (rc != SQLITE_OK) {
+    OnSqliteError(rc, NULL);
+    return false;
+  }
+  return true;
+}
+
 bool Connection::BeginTransaction() {
   if (needs_rollback_) {
     DCHECK_GT(transaction_nesting_, 0);
@@ -591,8 +631,18 @@ bool Connection::CommitTransaction() {
     return false;
   }
 
+  base::TimeTicks start;
+  if (commit_time_histogram_)
+    start = base::TimeTicks::Now();
+
   Statement commit(GetCachedStatement(SQL_FROM_HERE, "COMMIT"));
-  return commit.Run();
+  bool ret = commit.Run();
+
+  if (commit_time_histogram_) {
+    commit_time_histogram_->Add(
+        static_cast<int>((base::TimeTicks::Now() - start).InMicroseconds()));
+  }
+  return ret;
 }
 
 void Connection::RollbackAllTransactions() {
@@ -681,7 +731,13 @@ scoped_refptr<Connection::StatementRef> Connection::GetCachedStatement(
     return i->second;
   }
 
-  scoped_refptr<StatementRef> statement = GetUniqueStatement(sql);
+  AssertIOAllowed();
+
+  // Return inactive statement.
+  if (!db_)
+    return new StatementRef(NULL, NULL, poisoned_);
+
+  scoped_refptr<StatementRef> statement = PrepareStatement(sql);
   if (statement->is_valid())
     statement_cache_[id] = statement;  // Only cache valid statements.
   return statement;
@@ -695,8 +751,40 @@ scoped_refptr<Connection::StatementRef> Connection::GetUniqueStatement(
   if (!db_)
     return new StatementRef(NULL, NULL, poisoned_);
 
+  UniqueStatementCache::iterator i = unique_statement_cache_.Get(sql);
+  if (i != unique_statement_cache_.end()) {
+    // Statements are only closed with the connection, which also empties
+    // the cache.
+    DCHECK(i->second->is_valid());
+
+    // Another Statement is still using it, so compile a separate one.
+    if (!i->second->HasOneRef())
+      return PrepareStatement(sql);
+
+    // The last Statement using it reset it, but don't count on that.
+    sqlite3_reset(i->second->stmt());
+    sqlite3_clear_bindings(i->second->stmt());
+    return i->second;
+  }
+
+  scoped_refptr<StatementRef> statement = PrepareStatement(sql);
+  if (statement->is_valid())
+    unique_statement_cache_.Put(sql, statement);  // Only cache valid ones.
+  return statement;
+}
+
+scoped_refptr<Connection::StatementRef> Connection::PrepareStatement(
+    const char* sql) {
+  base::TimeTicks start;
+  if (prepare_time_histogram_)
+    start = base::TimeTicks::Now();
+
   sqlite3_stmt* stmt = NULL;
   int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, NULL);
+  if (prepare_time_histogram_) {
+    prepare_time_histogram_->Add(
+        static_cast<int>((base::TimeTicks::Now() - start).InMicroseconds()));
+  }
   if (rc != SQLITE_OK) {
     // This is evidence of a syntax error in the incoming SQL.
     DLOG(FATAL) << "SQL compile error " << GetErrorMessage();
@@ -868,8 +956,10 @@ bool Connection::OpenInternal(const std::string& file_name,
       // be fatal unless the file doesn't exist.
       base::FilePath journal_path(file_name + FILE_PATH_LITERAL("-journal"));
       base::FilePath wal_path(file_name + FILE_PATH_LITERAL("-wal"));
+      base::FilePath shm_path(file_name + FILE_PATH_LITERAL("-shm"));
       file_util::SetPosixFilePermissions(journal_path, mode);
       file_util::SetPosixFilePermissions(wal_path, mode);
+      file_util::SetPosixFilePermissions(shm_path, mode);
     }
   }
 #endif  // defined(OS_POSIX)
@@ -925,10 +1015,25 @@ bool Connection::OpenInternal(const std::string& file_name,
   // TRUNCATE - truncate -journal file to commit.
   // PERSIST - zero out header of -journal file to commit.
   // journal_size_limit provides size to trim to in PERSIST.
+  // WAL - append to -wal file to commit, see set_wal_mode().
+  // journal_size_limit provides size to trim to in PERSIST, and the size
+  // to trim the -wal file to after a checkpoint in WAL.
   // TODO(shess): Figure out if PERSIST and journal_size_limit really
   // matter.  In theory, it keeps pages pre-allocated, so if
   // transactions usually fit, it should be faster.
-  ignore_result(Execute("PRAGMA journal_mode = PERSIST"));
+  if (wal_mode_) {
+    // The pragma returns the resulting mode, which stays the same if the
+    // database can't use WAL.
+    Statement s(GetUniqueStatement("PRAGMA journal_mode = WAL"));
+    is_wal_mode_ = s.Step() && LowerCaseEqualsASCII(s.ColumnString(0), "wal");
+  }
+  if (is_wal_mode_) {
+    // In WAL mode, NORMAL only syncs the log at checkpoints, which keeps
+    // the database consistent, though not every commit durable.
+    ignore_result(Execute("PRAGMA synchronous = NORMAL"));
+  } else {
+    ignore_result(Execute("PRAGMA journal_mode = PERSIST"));
+  }
   ignore_result(Execute("PRAGMA journal_size_limit = 16384"));
 
   const base::TimeDelta kBusyTimeout =
@@ -981,6 +1086,22 @@ void Connection::StatementRefDeleted(StatementRef* ref) {
     open_statements_.erase(i);
 }
 
+void Connection::set_histogram_tag(const std::string& tag) {
+  histogram_tag_ = tag;
+  if (histogram_tag_.empty()) {
+    prepare_time_histogram_ = NULL;
+    step_time_histogram_ = NULL;
+    commit_time_histogram_ = NULL;
+  } else {
+    prepare_time_histogram_ =
+        GetTimingHistogram("Sqlite.PrepareMicros", histogram_tag_);
+    step_time_histogram_ =
+        GetTimingHistogram("Sqlite.StepMicros", histogram_tag_);
+    commit_time_histogram_ =
+        GetTimingHistogram("Sqlite.CommitMicros", histogram_tag_);
+  }
+}
+
 void Connection::AddTaggedHistogram(const std::string& name,
                                     size_t sample) const {
   if (histogram_tag_.empty())
@@ -13,6 +13,7 @@
 #include "base/basictypes.h"
 #include "base/callback.h"
 #include "base/compiler_specific.h"
+#include "base/containers/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/threading/thread_restrictions.h"
@@ -24,6 +25,7 @@ struct sqlite3_stmt;
 
 namespace base {
 class FilePath;
+class HistogramBase;
 }
 
 namespace sql {
@@ -123,6 +125,19 @@ class SQL_EXPORT Connection {
   // other platforms.
   void set_restrict_to_user() { restrict_to_user_ = true; }
 
+  // Call to have Open() put the database in write-ahead log mode.  A commit
+  // then appends to the -wal file instead of syncing a rollback journal and
+  // the database, and the log is only synced when its pages are copied back
+  // into the database by a checkpoint.  SQLite checkpoints automatically
+  // once the log reaches 1000 pages; CheckpointWAL() lets callers do it at
+  // a time of their choosing, such as when idle.  A crash may lose the
+  // transactions committed since the last checkpoint, but leaves the
+  // database consistent.  If the database can't be switched to WAL (for
+  // instance because it's in memory), the default journal is used.
+  //
+  // This must be called before Open() to have an effect.
+  void set_wal_mode() { wal_mode_ = true; }
+
   // Set an error-handling callback.  On errors, the error number (and
   // statement, if available) will be passed to the callback.
   //
@@ -140,10 +155,9 @@ class SQL_EXPORT Connection {
   }
 
   // Set this tag to enable additional connection-type histogramming
-  // for SQLite error codes and database version numbers.
-  void set_histogram_tag(const std::string& tag) {
-    histogram_tag_ = tag;
-  }
+  // for SQLite error codes, database version numbers, and the time
+  // spent preparing and stepping statements.
+  void set_histogram_tag(const std::string& tag);
 
   // Record a sparse UMA histogram sample under
   // |name|+"."+|histogram_tag_|.  If |histogram_tag_| is empty, no
@@ -349,9 +363,11 @@ class SQL_EXPORT Connection {
   // valid SQL, returns true.
   bool IsSQLValid(const char* sql);
 
-  // Returns a non-cached statement for the given SQL. Use this for SQL that
-  // is only executed once or only rarely (there is overhead associated with
-  // keeping a statement cached).
+  // Returns a statement for the given SQL which is not shared with any other
+  // Statement. Use this for SQL that is only executed once or only rarely.
+  // The most recently used of these are kept in a small LRU cache keyed by
+  // their SQL, so that calling this again with the same SQL, once the
+  // previous statement has been destroyed, doesn't compile it again.
   //
   // See GetCachedStatement above for examples and error information.
   scoped_refptr<StatementRef> GetUniqueStatement(const char* sql);
@@ -367,6 +383,14 @@ class SQL_EXPORT Connection {
   // Returns true if a column with the given name exists in the given table.
   bool DoesColumnExist(const char* table_name, const char* column_name) const;
 
+  // Returns true if the database is open in write-ahead log mode.
+  bool is_wal_mode() const { return is_wal_mode_; }
+
+  // Copies the pages in the write-ahead log back into the database, without
+  // waiting for readers or writers.  Returns false on error, or if the
+  // database is not in WAL mode.
+  bool CheckpointWAL();
+
   // Returns sqlite's internal ID for the last inserted row. Valid only
   // immediately after an insert.
   int64 GetLastInsertRowId() const;
@@ -514,6 +538,9 @@ class SQL_EXPORT Connection {
   bool ExecuteWithTimeout(const char* sql, base::TimeDelta ms_timeout)
       WARN_UNUSED_RESULT;
 
+  // Compiles |sql| into a new statement, recording the time it took.
+  scoped_refptr<StatementRef> PrepareStatement(const char* sql);
+
   // Internal helper for const functions.  Like GetUniqueStatement(),
   // except the statement is not entered into open_statements_,
   // allowing this function to be const.  Open statements can block
@@ -532,6 +559,10 @@ class SQL_EXPORT Connection {
   int cache_size_;
   bool exclusive_locking_;
   bool restrict_to_user_;
+  bool wal_mode_;
+
+  // True if Open() managed to put the database in WAL mode.
+  bool is_wal_mode_;
 
   // All cached statements. Keeping a reference to these statements means that
   // they'll remain active.
@@ -539,6 +570,13 @@ class SQL_EXPORT Connection {
       CachedStatementMap;
   CachedStatementMap statement_cache_;
 
+  // The most recently used statements returned by GetUniqueStatement(),
+  // keyed by their SQL.  A statement is only reused once the cache holds
+  // the only reference to it.
+  typedef base::MRUCache<std::string, scoped_refptr<StatementRef> >
+      UniqueStatementCache;
+  UniqueStatementCache unique_statement_cache_;
+
   // A list of all StatementRefs we've given out. Each ref must register with
   // us when it's created or destroyed. This allows us to potentially close
   // any open statements when we encounter an error.
@@ -568,6 +606,14 @@ class SQL_EXPORT Connection {
   // Tag for auxiliary histograms.
   std::string histogram_tag_;
 
+  // Histograms of the time in microseconds spent in sqlite3_prepare_v2(),
+  // sqlite3_step() and committing transactions on this connection, or NULL
+  // if |histogram_tag_| is empty.  The commit time is mostly the time spent
+  // syncing the journal or log.
+  base::HistogramBase* prepare_time_histogram_;
+  base::HistogramBase* step_time_histogram_;
+  base::HistogramBase* commit_time_histogram_;
+
   DISALLOW_COPY_AND_ASSIGN(Connection);
 };
 
@@ -0,0 +1,84 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sql/connection_pool.h"
+
+#include "base/logging.h"
+#include "base/stl_util.h"
+#include "sql/connection.h"
+
+namespace sql {
+
+ConnectionPool::ConnectionPool(const base::FilePath& path,
+                               const std::string& histogram_tag,
+                               size_t max_idle_connections)
+    : path_(path),
+      histogram_tag_(histogram_tag),
+      max_idle_connections_(max_idle_connections),
+      acquired_count_(0) {
+}
+
+ConnectionPool::~ConnectionPool() {
+  DCHECK_EQ(0, acquired_count_);
+  CloseIdleConnections();
+}
+
+scoped_ptr<Connection> ConnectionPool::Acquire() {
+  {
+    base::AutoLock lock(lock_);
+    if (!idle_connections_.empty()) {
+      scoped_ptr<Connection> connection(idle_connections_.back());
+      idle_connections_.pop_back();
+      ++acquired_count_;
+      return connection.Pass();
+    }
+  }
+
+  // Open a new connection without holding the lock, since it does IO.
+  scoped_ptr<Connection> connection(new Connection());
+  connection->set_histogram_tag(histogram_tag_);
+  // Without this, Open() would switch the database back to the default
+  // journal.
+  connection->set_wal_mode();
+  if (!connection->Open(path_))
+    return scoped_ptr<Connection>();
+  if (!connection->is_wal_mode()) {
+    DLOG(ERROR) << "Pooled database is not in WAL mode";
+    return scoped_ptr<Connection>();
+  }
+
+  base::AutoLock lock(lock_);
+  ++acquired_count_;
+  return connection.Pass();
+}
+
+void ConnectionPool::Release(scoped_ptr<Connection> connection) {
+  DCHECK(connection);
+  DCHECK_EQ(0, connection->transaction_nesting());
+
+  {
+    base::AutoLock lock(lock_);
+    DCHECK_GT(acquired_count_, 0);
+    --acquired_count_;
+    if (connection->is_open() &&
+        idle_connections_.size() < max_idle_connections_) {
+      idle_connections_.push_back(connection.release());
+      return;
+    }
+  }
+
+  // Close the connection without holding the lock.
+  connection.reset();
+}
+
+void ConnectionPool::CloseIdleConnections() {
+  std::vector<Connection*> idle_connections;
+  {
+    base::AutoLock lock(lock_);
+    idle_connections.swap(idle_connections_);
+  }
+  STLDeleteElements(&idle_connections);
+}
+
+}  // namespace sql
@@ -0,0 +1,83 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SQL_CONNECTION_POOL_H_
+#define SQL_CONNECTION_POOL_H_
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+#include "sql/sql_export.h"
+
+namespace sql {
+
+class Connection;
+
+// A pool of connections to one database file for read-only queries, so that
+// they can run on any thread while the database's own connection writes to
+// it on another.  The database must be in WAL mode (see
+// Connection::set_wal_mode()), where readers see the last committed state
+// without blocking the writer or being blocked by it.  It also must not be
+// opened with exclusive locking by the writer.
+//
+// Acquire() and Release() may be called on any thread.  A connection is
+// used by one thread at a time, and the thread must allow IO.
+//
+// Example:
+//   scoped_ptr<sql::Connection> db = pool->Acquire();
+//   if (!db)
+//     return false;
+//   sql::Statement s(db->GetUniqueStatement("SELECT ..."));
+//   ...
+//   pool->Release(db.Pass());
+class SQL_EXPORT ConnectionPool {
+ public:
+  // |histogram_tag| is given to each connection, see
+  // Connection::set_histogram_tag().  Up to |max_idle_connections|
+  // released connections are kept open for reuse.
+  ConnectionPool(const base::FilePath& path,
+                 const std::string& histogram_tag,
+                 size_t max_idle_connections);
+
+  // Closes the idle connections.  All acquired connections must have been
+  // released.
+  ~ConnectionPool();
+
+  // Returns an idle connection, or opens a new one.  Returns NULL if the
+  // database can't be opened, or is not in WAL mode.  The connection must
+  // only be used to read, and be given back with Release().
+  scoped_ptr<Connection> Acquire();
+
+  // Gives back a connection returned by Acquire(), which must not be in a
+  // transaction.
+  void Release(scoped_ptr<Connection> connection);
+
+  // Closes the idle connections, for instance to free their caches when
+  // the pool won't be used for a while.  Connections in use are unaffected.
+  void CloseIdleConnections();
+
+ private:
+  const base::FilePath path_;
+  const std::string histogram_tag_;
+  const size_t max_idle_connections_;
+
+  // Protects the members below.
+  base::Lock lock_;
+
+  // Open connections waiting to be acquired, most recently released last.
+  std::vector<Connection*> idle_connections_;
+
+  // Number of connections acquired and not yet released.
+  int acquired_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConnectionPool);
+};
+
+}  // namespace sql
+
+#endif  // SQL_CONNECTION_POOL_H_
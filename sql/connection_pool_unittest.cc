@@ -0,0 +1,113 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sql/connection_pool.h"
+
+#include "base/files/scoped_temp_dir.h"
+#include "sql/connection.h"
+#include "sql/statement.h"
+#include "sql/test/scoped_error_ignorer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/sqlite/sqlite3.h"
+
+namespace {
+
+class SQLConnectionPoolTest : public testing::Test {
+ public:
+  SQLConnectionPoolTest() {}
+
+  virtual void SetUp() {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    db_.set_wal_mode();
+    ASSERT_TRUE(db_.Open(db_path()));
+    ASSERT_TRUE(db_.is_wal_mode());
+    ASSERT_TRUE(db_.Execute("CREATE TABLE foo (a)"));
+    ASSERT_TRUE(db_.Execute("INSERT INTO foo (a) VALUES (1)"));
+  }
+
+  virtual void TearDown() {
+    db_.Close();
+  }
+
+  sql::Connection& db() { return db_; }
+
+  base::FilePath db_path() {
+    return temp_dir_.path().AppendASCII("SQLConnectionPoolTest.db");
+  }
+
+ private:
+  base::ScopedTempDir temp_dir_;
+  sql::Connection db_;
+};
+
+int CountRows(sql::Connection* db) {
+  sql::Statement s(db->GetUniqueStatement("SELECT COUNT(*) FROM foo"));
+  return s.Step() ? s.ColumnInt(0) : -1;
+}
+
+// Readers see the last committed state while the writer is in a transaction,
+// without either blocking the other.
+TEST_F(SQLConnectionPoolTest, ReadWhileWriting) {
+  sql::ConnectionPool pool(db_path(), std::string(), 2);
+  scoped_ptr<sql::Connection> reader = pool.Acquire();
+  ASSERT_TRUE(reader);
+  EXPECT_EQ(1, CountRows(reader.get()));
+
+  ASSERT_TRUE(db().BeginTransaction());
+  ASSERT_TRUE(db().Execute("INSERT INTO foo (a) VALUES (2)"));
+  EXPECT_EQ(1, CountRows(reader.get()));
+  ASSERT_TRUE(db().CommitTransaction());
+  EXPECT_EQ(2, CountRows(reader.get()));
+
+  pool.Release(reader.Pass());
+}
+
+// Released connections are reused, up to the idle limit.
+TEST_F(SQLConnectionPoolTest, Reuse) {
+  sql::ConnectionPool pool(db_path(), std::string(), 1);
+  scoped_ptr<sql::Connection> reader1 = pool.Acquire();
+  scoped_ptr<sql::Connection> reader2 = pool.Acquire();
+  ASSERT_TRUE(reader1);
+  ASSERT_TRUE(reader2);
+  EXPECT_NE(reader1.get(), reader2.get());
+
+  sql::Connection* kept = reader1.get();
+  pool.Release(reader1.Pass());
+  pool.Release(reader2.Pass());
+
+  reader1 = pool.Acquire();
+  EXPECT_EQ(kept, reader1.get());
+  EXPECT_EQ(1, CountRows(reader1.get()));
+  pool.Release(reader1.Pass());
+
+  pool.CloseIdleConnections();
+  reader1 = pool.Acquire();
+  ASSERT_TRUE(reader1);
+  EXPECT_EQ(1, CountRows(reader1.get()));
+  pool.Release(reader1.Pass());
+}
+
+// The pool refuses databases which aren't in WAL mode, where readers would
+// block the writer.
+TEST_F(SQLConnectionPoolTest, RequiresWAL) {
+  base::FilePath path = db_path().InsertBeforeExtensionASCII("2");
+  {
+    sql::Connection db;
+    ASSERT_TRUE(db.Open(path));
+    ASSERT_TRUE(db.Execute("CREATE TABLE foo (a)"));
+    ASSERT_TRUE(db.BeginTransaction());
+    ASSERT_TRUE(db.Execute("INSERT INTO foo (a) VALUES (1)"));
+
+    // While the writer holds a lock, the reader can't switch the database
+    // to WAL mode.
+    sql::ScopedErrorIgnorer ignore_errors;
+    ignore_errors.IgnoreError(SQLITE_BUSY);
+    sql::ConnectionPool pool(path, std::string(), 1);
+    EXPECT_FALSE(pool.Acquire());
+    EXPECT_TRUE(ignore_errors.CheckIgnoredErrors());
+    ASSERT_TRUE(db.CommitTransaction());
+  }
+}
+
+}  // namespace
@@ -169,6 +169,42 @@ TEST_F(SQLConnectionTest, CachedStatement) {
   EXPECT_FALSE(db().HasCachedStatement(SQL_FROM_HERE));
 }
 
+TEST_F(SQLConnectionTest, UniqueStatementReuse) {
+  const char kSql[] = "SELECT a FROM foo WHERE b = ?";
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
+  ASSERT_TRUE(db().Execute("INSERT INTO foo(a, b) VALUES (12, 13)"));
+  ASSERT_TRUE(db().Execute("INSERT INTO foo(a, b) VALUES (14, 15)"));
+
+  {
+    sql::Statement s(db().GetUniqueStatement(kSql));
+    s.BindInt(0, 13);
+    ASSERT_TRUE(s.Step());
+    EXPECT_EQ(12, s.ColumnInt(0));
+  }
+
+  // A reused statement must not keep the previous bindings.
+  {
+    sql::Statement s(db().GetUniqueStatement(kSql));
+    ASSERT_TRUE(s.is_valid());
+    EXPECT_FALSE(s.Step());
+  }
+
+  // Statements with the same SQL which are alive at the same time must be
+  // independent.
+  {
+    sql::Statement s1(db().GetUniqueStatement(kSql));
+    sql::Statement s2(db().GetUniqueStatement(kSql));
+    s1.BindInt(0, 13);
+    s2.BindInt(0, 15);
+    ASSERT_TRUE(s1.Step());
+    ASSERT_TRUE(s2.Step());
+    EXPECT_EQ(12, s1.ColumnInt(0));
+    EXPECT_EQ(14, s2.ColumnInt(0));
+    EXPECT_FALSE(s1.Step());
+    EXPECT_FALSE(s2.Step());
+  }
+}
+
 TEST_F(SQLConnectionTest, IsSQLValidTest) {
   ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
   ASSERT_TRUE(db().IsSQLValid("SELECT a FROM foo"));
@@ -683,6 +719,50 @@ TEST_F(SQLConnectionTest, Delete) {
   EXPECT_FALSE(base::PathExists(journal));
 }
 
+TEST_F(SQLConnectionTest, WALMode) {
+  db().Close();
+  sql::Connection::Delete(db_path());
+  db().set_wal_mode();
+  ASSERT_TRUE(db().Open(db_path()));
+  EXPECT_TRUE(db().is_wal_mode());
+
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
+  ASSERT_TRUE(db().BeginTransaction());
+  ASSERT_TRUE(db().Execute("INSERT INTO foo (a, b) VALUES (1, 2)"));
+  ASSERT_TRUE(db().CommitTransaction());
+
+  // The commit went to the log rather than to a rollback journal.
+  base::FilePath journal(db_path().value() + FILE_PATH_LITERAL("-journal"));
+  base::FilePath wal(db_path().value() + FILE_PATH_LITERAL("-wal"));
+  EXPECT_FALSE(base::PathExists(journal));
+  EXPECT_TRUE(base::PathExists(wal));
+  EXPECT_TRUE(db().CheckpointWAL());
+
+  // Raze() works on a database in WAL mode.
+  ASSERT_TRUE(db().Raze());
+  EXPECT_FALSE(db().DoesTableExist("foo"));
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
+
+  // The mode persists in the database, and Delete() removes the log.
+  db().Close();
+  ASSERT_TRUE(db().Open(db_path()));
+  EXPECT_TRUE(db().is_wal_mode());
+  EXPECT_TRUE(db().DoesTableExist("foo"));
+  db().Close();
+  EXPECT_TRUE(sql::Connection::Delete(db_path()));
+  EXPECT_FALSE(base::PathExists(wal));
+}
+
+// In-memory databases can't use WAL, and fall back to the default journal.
+TEST_F(SQLConnectionTest, WALModeInMemory) {
+  sql::Connection db;
+  db.set_wal_mode();
+  ASSERT_TRUE(db.OpenInMemory());
+  EXPECT_FALSE(db.is_wal_mode());
+  EXPECT_FALSE(db.CheckpointWAL());
+  EXPECT_TRUE(db.Execute("CREATE TABLE foo (a, b)"));
+}
+
 #if defined(OS_POSIX)
 // Test that set_restrict_to_user() trims database permissions so that
 // only the owner (and root) can read.
@@ -186,6 +186,44 @@ TEST_F(SQLRecoveryTest, RecoverBasic) {
             ExecuteWithResults(&db(), kXSql, "|", "\n"));
 }
 
+// Recovery attaches the original database through a second handle and
+// restores it with the backup API, both of which work with a database in
+// WAL mode, which it stays in.
+TEST_F(SQLRecoveryTest, RecoverWAL) {
+  db().Close();
+  db().set_wal_mode();
+  ASSERT_TRUE(db().Open(db_path()));
+  ASSERT_TRUE(db().is_wal_mode());
+
+  const char kCreateSql[] = "CREATE TABLE x (t TEXT)";
+  ASSERT_TRUE(db().Execute(kCreateSql));
+  ASSERT_TRUE(db().Execute("INSERT INTO x VALUES ('This is a test')"));
+
+  {
+    scoped_ptr<sql::Recovery> recovery = sql::Recovery::Begin(&db(), db_path());
+    ASSERT_TRUE(recovery.get());
+
+    // The original's contents are visible through the attachment, even
+    // though they haven't been checkpointed.
+    const char kCorruptSql[] = "SELECT t FROM corrupt.x";
+    ASSERT_EQ("This is a test",
+              ExecuteWithResults(recovery->db(), kCorruptSql, "|", "\n"));
+
+    ASSERT_TRUE(recovery->db()->Execute(kCreateSql));
+    ASSERT_TRUE(recovery->db()->Execute(
+        "INSERT INTO x VALUES ('That was a test')"));
+    ASSERT_TRUE(sql::Recovery::Recovered(recovery.Pass()));
+  }
+  EXPECT_FALSE(db().is_open());
+  ASSERT_TRUE(Reopen());
+  EXPECT_TRUE(db().is_wal_mode());
+  ASSERT_EQ("CREATE TABLE x (t TEXT)", GetSchema(&db()));
+
+  const char* kXSql = "SELECT * FROM x ORDER BY 1";
+  ASSERT_EQ("That was a test",
+            ExecuteWithResults(&db(), kXSql, "|", "\n"));
+}
+
 // The recovery virtual table is only supported for Chromium's SQLite.
 #if !defined(USE_SYSTEM_SQLITE)
 
@@ -22,6 +22,8 @@
       'sources': [
         'connection.cc',
         'connection.h',
+        'connection_pool.cc',
+        'connection_pool.h',
         'error_delegate_util.cc',
         'error_delegate_util.h',
         'init_status.h',
@@ -84,6 +86,7 @@
       ],
       'sources': [
         'run_all_unittests.cc',
+        'connection_pool_unittest.cc',
         'connection_unittest.cc',
         'recovery_unittest.cc',
         'sqlite_features_unittest.cc',
@@ -5,6 +5,7 @@
 #include "sql/statement.h"
 
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "third_party/sqlite/sqlite3.h"
@@ -54,7 +55,7 @@ bool Statement::Run() {
   if (!CheckValid())
     return false;
 
-  return CheckError(sqlite3_step(ref_->stmt())) == SQLITE_DONE;
+  return CheckError(StepInternal()) == SQLITE_DONE;
 }
 
 bool Statement::Step() {
@@ -62,7 +63,19 @@ bool Statement::Step() {
   if (!CheckValid())
     return false;
 
-  return CheckError(sqlite3_step(ref_->stmt())) == SQLITE_ROW;
+  return CheckError(StepInternal()) == SQLITE_ROW;
+}
+
+int Statement::StepInternal() {
+  Connection* connection = ref_->connection();
+  if (!connection || !connection->step_time_histogram_)
+    return sqlite3_step(ref_->stmt());
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  int rc = sqlite3_step(ref_->stmt());
+  connection->step_time_histogram_->Add(
+      static_cast<int>((base::TimeTicks::Now() - start).InMicroseconds()));
+  return rc;
 }
 
 void Statement::Reset(bool clear_bound_vars) {
@@ -159,6 +159,10 @@ class SQL_EXPORT Statement {
   // succeeded flag.
   bool CheckOk(int err) const;
 
+  // Calls sqlite3_step() on the statement, recording the time it took if
+  // the connection has a histogram tag.
+  int StepInternal();
+
   // Should be called by all mutating methods to check that the statement is
   // valid. Returns true if the statement is valid. DCHECKS and returns false
   // if it is not.
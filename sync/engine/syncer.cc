@@ -8,6 +8,7 @@
 #include "base/location.h"
 #include "base/logging.h"
 #include "base/message_loop/message_loop.h"
+#include "base/metrics/histogram.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
 #include "sync/engine/apply_control_data_updates.h"
@@ -19,6 +20,7 @@
 #include "sync/engine/net/server_connection_manager.h"
 #include "sync/engine/process_commit_response_command.h"
 #include "sync/engine/syncer_types.h"
+#include "sync/engine/traffic_recorder.h"
 #include "sync/internal_api/public/base/unique_position.h"
 #include "sync/internal_api/public/util/syncer_error.h"
 #include "sync/sessions/nudge_tracker.h"
@@ -44,7 +46,9 @@ using sessions::SyncSession;
 using sessions::NudgeTracker;
 
 Syncer::Syncer()
-    : early_exit_requested_(false) {
+    : early_exit_requested_(false),
+      cycle_start_bytes_sent_(0),
+      cycle_start_bytes_received_(0) {
 }
 
 Syncer::~Syncer() {}
@@ -148,12 +152,25 @@ bool Syncer::DownloadAndApplyUpdates(
 
 void Syncer::HandleCycleBegin(SyncSession* session) {
   session->mutable_status_controller()->UpdateStartTime();
+  TrafficRecorder* traffic_recorder = session->context()->traffic_recorder();
+  cycle_start_bytes_sent_ = traffic_recorder->bytes_sent();
+  cycle_start_bytes_received_ = traffic_recorder->bytes_received();
   session->SendEventNotification(SyncEngineEvent::SYNC_CYCLE_BEGIN);
 }
 
 bool Syncer::HandleCycleEnd(
     SyncSession* session,
     sync_pb::GetUpdatesCallerInfo::GetUpdatesSource source) {
+  // Protocol bytes exchanged with the server during this cycle, which are
+  // costly on mobile connections.
+  TrafficRecorder* traffic_recorder = session->context()->traffic_recorder();
+  UMA_HISTOGRAM_COUNTS("Sync.CycleBytesSent",
+                       traffic_recorder->bytes_sent() -
+                           cycle_start_bytes_sent_);
+  UMA_HISTOGRAM_COUNTS("Sync.CycleBytesReceived",
+                       traffic_recorder->bytes_received() -
+                           cycle_start_bytes_received_);
+
   if (!ExitRequested()) {
     session->SendSyncCycleEndEventNotification(source);
     return true;
@@ -82,6 +82,10 @@ class SYNC_EXPORT_PRIVATE Syncer {
   bool early_exit_requested_;
   base::Lock early_exit_requested_lock_;
 
+  // The TrafficRecorder's byte counts at the start of the current cycle.
+  int64 cycle_start_bytes_sent_;
+  int64 cycle_start_bytes_received_;
+
   friend class SyncerTest;
   FRIEND_TEST_ALL_PREFIXES(SyncerTest, NameClashWithResolver);
   FRIEND_TEST_ALL_PREFIXES(SyncerTest, IllegalAndLegalUpdates);
@@ -41,7 +41,9 @@ TrafficRecorder::TrafficRecord::~TrafficRecord() {
 TrafficRecorder::TrafficRecorder(unsigned int max_messages,
     unsigned int max_message_size)
     : max_messages_(max_messages),
-      max_message_size_(max_message_size) {
+      max_message_size_(max_message_size),
+      bytes_sent_(0),
+      bytes_received_(0) {
 }
 
 TrafficRecorder::~TrafficRecorder() {
@@ -113,12 +115,13 @@ void TrafficRecorder::AddTrafficToQueue(TrafficRecord* record) {
   }
 }
 
-void TrafficRecorder::StoreProtoInQueue(
+int TrafficRecorder::StoreProtoInQueue(
     const ::google::protobuf::MessageLite& msg,
     TrafficMessageType type) {
   bool truncated = false;
   std::string message;
-  if (static_cast<unsigned int>(msg.ByteSize()) >= max_message_size_) {
+  const int size = msg.ByteSize();
+  if (static_cast<unsigned int>(size) >= max_message_size_) {
     // TODO(lipalani): Trim the specifics to fit in size.
     truncated = true;
   } else {
@@ -127,16 +130,17 @@ void TrafficRecorder::StoreProtoInQueue(
 
   TrafficRecord record(message, type, truncated, GetTime());
   AddTrafficToQueue(&record);
+  return size;
 }
 
 void TrafficRecorder::RecordClientToServerMessage(
     const sync_pb::ClientToServerMessage& msg) {
-  StoreProtoInQueue(msg, CLIENT_TO_SERVER_MESSAGE);
+  bytes_sent_ += StoreProtoInQueue(msg, CLIENT_TO_SERVER_MESSAGE);
 }
 
 void TrafficRecorder::RecordClientToServerResponse(
     const sync_pb::ClientToServerResponse& response) {
-  StoreProtoInQueue(response, CLIENT_TO_SERVER_RESPONSE);
+  bytes_received_ += StoreProtoInQueue(response, CLIENT_TO_SERVER_RESPONSE);
 }
 
 }  // namespace syncer
@@ -63,10 +63,17 @@ class SYNC_EXPORT_PRIVATE TrafficRecorder {
     return records_;
   }
 
+  // Serialized size of all the messages and responses recorded so far,
+  // including those that were too big to keep or have been dropped from the
+  // queue.
+  int64 bytes_sent() const { return bytes_sent_; }
+  int64 bytes_received() const { return bytes_received_; }
+
  private:
   void AddTrafficToQueue(TrafficRecord* record);
-  void StoreProtoInQueue(const ::google::protobuf::MessageLite& msg,
-                         TrafficMessageType type);
+  // Stores |msg| in the queue and returns its serialized size.
+  int StoreProtoInQueue(const ::google::protobuf::MessageLite& msg,
+                        TrafficMessageType type);
 
   // Method to get record creation time.
   virtual base::Time GetTime();
@@ -77,6 +84,10 @@ class SYNC_EXPORT_PRIVATE TrafficRecorder {
   // Maximum size of each message.
   unsigned int max_message_size_;
   std::deque<TrafficRecord> records_;
+
+  int64 bytes_sent_;
+  int64 bytes_received_;
+
   DISALLOW_COPY_AND_ASSIGN(TrafficRecorder);
 };
 
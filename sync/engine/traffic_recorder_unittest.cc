@@ -43,6 +43,23 @@ TEST(TrafficRecorderTest, MaxMessageSizeTest) {
   EXPECT_TRUE(record.message.empty());
 }
 
+// Ensure bytes are counted for every message, even ones too big to keep.
+TEST(TrafficRecorderTest, ByteCountsTest) {
+  TrafficRecorder recorder(kMaxMessages, kMaxMessageSize);
+  sync_pb::ClientToServerMessage message;
+  message.set_share("share");
+  sync_pb::ClientToServerResponse response;
+  response.mutable_error()->set_error_description(
+      std::string(kMaxMessageSize * 2, 'a'));
+
+  recorder.RecordClientToServerMessage(message);
+  recorder.RecordClientToServerResponse(response);
+  recorder.RecordClientToServerResponse(response);
+
+  EXPECT_EQ(message.ByteSize(), recorder.bytes_sent());
+  EXPECT_EQ(2 * response.ByteSize(), recorder.bytes_received());
+}
+
 // Test implementation of TrafficRecorder.
 class TestTrafficRecorder : public TrafficRecorder {
  public:
@@ -8,8 +8,10 @@
 
 #include "base/base64.h"
 #include "base/debug/trace_event.h"
+#include "base/metrics/histogram.h"
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
 #include "sync/internal_api/public/base/unique_position.h"
 #include "sync/internal_api/public/util/unrecoverable_error_handler.h"
 #include "sync/syncable/entry.h"
@@ -120,6 +122,7 @@ DirOpenResult Directory::Open(
 }
 
 void Directory::InitializeIndices(MetahandlesMap* handles_map) {
+  base::TimeTicks start = base::TimeTicks::Now();
   kernel_->metahandles_map.swap(*handles_map);
   for (MetahandlesMap::const_iterator it = kernel_->metahandles_map.begin();
        it != kernel_->metahandles_map.end(); ++it) {
@@ -150,6 +153,8 @@ void Directory::InitializeIndices(MetahandlesMap* handles_map) {
     kernel_->ids_map[entry->ref(ID).value()] = entry;
     DCHECK(!entry->is_dirty());
   }
+  UMA_HISTOGRAM_TIMES("Sync.DirectoryIndexTime",
+                      base::TimeTicks::Now() - start);
 }
 
 DirOpenResult Directory::OpenImpl(
@@ -11,6 +11,7 @@
 #include "base/base64.h"
 #include "base/debug/trace_event.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 #include "base/rand_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/time/time.h"
@@ -23,6 +24,7 @@
 #include "sync/syncable/syncable-inl.h"
 #include "sync/syncable/syncable_columns.h"
 #include "sync/syncable/syncable_util.h"
+#include "sync/util/data_type_histogram.h"
 #include "sync/util/time.h"
 
 using std::string;
@@ -102,11 +104,9 @@ scoped_ptr<EntryKernel> UnpackEntry(sql::Statement* statement) {
         statement->ColumnBlob(i), statement->ColumnByteLength(i));
   }
   for ( ; i < UNIQUE_POSITION_FIELDS_END; ++i) {
-    std::string temp;
-    statement->ColumnBlobAsString(i, &temp);
-
     sync_pb::UniquePosition proto;
-    if (!proto.ParseFromString(temp)) {
+    if (!proto.ParseFromArray(statement->ColumnBlob(i),
+                              statement->ColumnByteLength(i))) {
       DVLOG(1) << "Unpacked invalid position.  Assuming the DB is corrupt";
       return scoped_ptr<EntryKernel>();
     }
@@ -503,16 +503,37 @@ bool DirectoryBackingStore::LoadEntries(
 
   sql::Statement s(db_->GetUniqueStatement(select.c_str()));
 
+  // Time spent reading and unpacking the entries of each type, so that the
+  // cost of startup can be attributed to the types with the most data.
+  base::TimeDelta load_times[MODEL_TYPE_COUNT];
+  base::TimeTicks step_start = base::TimeTicks::Now();
   while (s.Step()) {
     scoped_ptr<EntryKernel> kernel = UnpackEntry(&s);
     // A null kernel is evidence of external data corruption.
     if (!kernel)
       return false;
 
+    base::TimeTicks step_end = base::TimeTicks::Now();
+    load_times[kernel->GetModelType()] += step_end - step_start;
+    step_start = step_end;
+
     int64 handle = kernel->ref(META_HANDLE);
     (*handles_map)[handle] = kernel.release();
   }
-  return s.Succeeded();
+  if (!s.Succeeded())
+    return false;
+
+  ModelTypeSet types = ProtocolTypes();
+  for (ModelTypeSet::Iterator it = types.First(); it.Good(); it.Inc()) {
+    if (load_times[it.Get()] == base::TimeDelta())
+      continue;
+#define PER_DATA_TYPE_MACRO(type_str) \
+    UMA_HISTOGRAM_TIMES("Sync." type_str "DirectoryLoadTime", \
+                        load_times[it.Get()]);
+    SYNC_DATA_TYPE_HISTOGRAM(it.Get());
+#undef PER_DATA_TYPE_MACRO
+  }
+  return true;
 }
 
 bool DirectoryBackingStore::LoadDeleteJournals(
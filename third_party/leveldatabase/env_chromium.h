@@ -176,6 +176,7 @@ class ChromiumEnv : public leveldb::Env,
   base::HistogramBase* GetMethodIOErrorHistogram() const;
   base::HistogramBase* GetMaxFDHistogram(const std::string& type) const;
   base::HistogramBase* GetLockFileAncestorHistogram() const;
+  base::HistogramBase* GetCompactionTimeHistogram() const;
 
   // RetrierProvider implementation.
   virtual int MaxRetryTimeMillis() const { return kMaxRetryTimeMillis; }
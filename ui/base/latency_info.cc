@@ -6,15 +6,43 @@
 
 #include <algorithm>
 
+#include "base/debug/trace_event.h"
+
+namespace {
+
+const char* GetComponentName(ui::LatencyComponentType type) {
+#define CASE_TYPE(t) case ui::t:  return #t
+  switch (type) {
+    CASE_TYPE(INPUT_EVENT_LATENCY_RWH_COMPONENT);
+    CASE_TYPE(INPUT_EVENT_LATENCY_SCROLL_UPDATE_RWH_COMPONENT);
+    CASE_TYPE(INPUT_EVENT_LATENCY_SCROLL_UPDATE_ORIGINAL_COMPONENT);
+    CASE_TYPE(INPUT_EVENT_LATENCY_ORIGINAL_COMPONENT);
+    CASE_TYPE(INPUT_EVENT_LATENCY_UI_COMPONENT);
+    CASE_TYPE(INPUT_EVENT_LATENCY_ACKED_COMPONENT);
+    CASE_TYPE(INPUT_EVENT_LATENCY_RENDERER_MAIN_COMPONENT);
+    CASE_TYPE(INPUT_EVENT_LATENCY_COMMIT_COMPONENT);
+    CASE_TYPE(INPUT_EVENT_LATENCY_DRAW_COMPONENT);
+    CASE_TYPE(INPUT_EVENT_LATENCY_GPU_SWAP_COMPONENT);
+    CASE_TYPE(INPUT_EVENT_LATENCY_BROWSER_COMPOSITOR_COMPONENT);
+  }
+#undef CASE_TYPE
+  return "unknown";
+}
+
+}  // namespace
+
 namespace ui {
 
-LatencyInfo::LatencyInfo() {
+LatencyInfo::LatencyInfo() : trace_id(-1) {
 }
 
 LatencyInfo::~LatencyInfo() {
 }
 
 void LatencyInfo::MergeWith(const LatencyInfo& other) {
+  // Merged events are traced as the first one of them.
+  if (trace_id == -1)
+    trace_id = other.trace_id;
   for (LatencyMap::const_iterator it = other.latency_components.begin();
        it != other.latency_components.end();
        ++it) {
@@ -45,6 +73,17 @@ void LatencyInfo::AddLatencyNumber(LatencyComponentType component,
                                    int64 component_sequence_number) {
   AddLatencyNumberWithTimestamp(component, id, component_sequence_number,
                                 base::TimeTicks::HighResNow(), 1);
+  if (trace_id != -1) {
+    TRACE_EVENT_ASYNC_STEP0("benchmark", "InputLatency",
+                            TRACE_ID_DONT_MANGLE(trace_id),
+                            GetComponentName(component));
+  }
+}
+
+void LatencyInfo::AddFirstLatencyNumber(LatencyComponentType component) {
+  if (latency_components.empty() || FindLatency(component, 0, NULL))
+    return;
+  AddLatencyNumber(component, 0, 0);
 }
 
 void LatencyInfo::AddLatencyNumberWithTimestamp(LatencyComponentType component,
@@ -86,6 +125,7 @@ bool LatencyInfo::FindLatency(LatencyComponentType type,
 
 void LatencyInfo::Clear() {
   latency_components.clear();
+  trace_id = -1;
 }
 
 }  // namespace ui
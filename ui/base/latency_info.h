@@ -32,7 +32,18 @@ enum LatencyComponentType {
   INPUT_EVENT_LATENCY_UI_COMPONENT,
   // Timestamp when the event is acked from renderer. This is currently set
   // only for touch events.
-  INPUT_EVENT_LATENCY_ACKED_COMPONENT
+  INPUT_EVENT_LATENCY_ACKED_COMPONENT,
+  // Timestamp when the renderer main thread starts handling the event.
+  INPUT_EVENT_LATENCY_RENDERER_MAIN_COMPONENT,
+  // Timestamp when the main frame that handled the event is committed.
+  INPUT_EVENT_LATENCY_COMMIT_COMPONENT,
+  // Timestamp when the impl thread draws the frame that shows the event.
+  INPUT_EVENT_LATENCY_DRAW_COMPONENT,
+  // Timestamp when the GPU process swaps the frame that shows the event.
+  INPUT_EVENT_LATENCY_GPU_SWAP_COMPONENT,
+  // Timestamp when the browser's ui::Compositor receives the frame that shows
+  // the event, to draw it into the browser window.
+  INPUT_EVENT_LATENCY_BROWSER_COMPOSITOR_COMPONENT
 };
 
 struct UI_EXPORT LatencyInfo {
@@ -76,6 +87,12 @@ struct UI_EXPORT LatencyInfo {
                                      base::TimeTicks time,
                                      uint32 event_count);
 
+  // Adds |component| with id 0 and the current timestamp, for a stage of the
+  // pipeline that a frame can go through more than once, like a commit in the
+  // renderer and again in the browser compositor. Only the first time counts,
+  // and nothing is added if there are no events to track.
+  void AddFirstLatencyNumber(LatencyComponentType component);
+
   // Returns true if the a component with |type| and |id| is found in
   // the latency_components and the component is stored to |output| if
   // |output| is not NULL. Returns false if no such component is found.
@@ -89,6 +106,11 @@ struct UI_EXPORT LatencyInfo {
 
   // This represents the final time that a frame is displayed it.
   base::TimeTicks swap_timestamp;
+
+  // Id of the "InputLatency" async trace event that follows the event through
+  // the pipeline, or -1 if it isn't traced. Each component that is added with
+  // the current timestamp is a step of the trace event.
+  int64 trace_id;
 };
 
 }  // namespace ui
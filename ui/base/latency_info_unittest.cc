@@ -139,4 +139,45 @@ TEST(LatencyInfoTest, ClearEvents) {
   EXPECT_EQ(info.latency_components.size(), 0u);
 }
 
+TEST(LatencyInfoTest, AddFirstLatencyNumber) {
+  LatencyInfo info;
+  info.AddFirstLatencyNumber(INPUT_EVENT_LATENCY_DRAW_COMPONENT);
+  EXPECT_EQ(info.latency_components.size(), 0u);
+
+  info.AddLatencyNumberWithTimestamp(INPUT_EVENT_LATENCY_RWH_COMPONENT,
+                                     0,
+                                     1,
+                                     base::TimeTicks::FromInternalValue(100),
+                                     1);
+  info.AddFirstLatencyNumber(INPUT_EVENT_LATENCY_DRAW_COMPONENT);
+  LatencyInfo::LatencyComponent first;
+  EXPECT_TRUE(
+      info.FindLatency(INPUT_EVENT_LATENCY_DRAW_COMPONENT, 0, &first));
+  EXPECT_EQ(first.event_count, 1u);
+
+  info.AddFirstLatencyNumber(INPUT_EVENT_LATENCY_DRAW_COMPONENT);
+  LatencyInfo::LatencyComponent second;
+  EXPECT_TRUE(
+      info.FindLatency(INPUT_EVENT_LATENCY_DRAW_COMPONENT, 0, &second));
+  EXPECT_EQ(second.event_count, 1u);
+  EXPECT_EQ(second.event_time, first.event_time);
+}
+
+TEST(LatencyInfoTest, TraceId) {
+  LatencyInfo info1;
+  LatencyInfo info2;
+  EXPECT_EQ(info1.trace_id, -1);
+
+  info2.trace_id = 5;
+  info1.MergeWith(info2);
+  EXPECT_EQ(info1.trace_id, 5);
+
+  info2.trace_id = 6;
+  info1.MergeWith(info2);
+  EXPECT_EQ(info1.trace_id, 5);
+
+  info1.Clear();
+  EXPECT_EQ(info1.trace_id, -1);
+}
+
 }  // namespace ui
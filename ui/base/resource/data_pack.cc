@@ -13,6 +13,10 @@
 #include "base/metrics/histogram.h"
 #include "base/strings/string_piece.h"
 
+#if defined(OS_POSIX)
+#include <sys/mman.h>
+#endif
+
 // For details of the file layout, see
 // http://dev.chromium.org/developers/design-documents/linuxresourcesandlocalizedstrings
 
@@ -26,24 +30,17 @@ static const size_t kHeaderLength = 2 * sizeof(uint32) + sizeof(uint8);
 struct DataPackEntry {
   uint16 resource_id;
   uint32 file_offset;
-
-  static int CompareById(const void* void_key, const void* void_entry) {
-    uint16 key = *reinterpret_cast<const uint16*>(void_key);
-    const DataPackEntry* entry =
-        reinterpret_cast<const DataPackEntry*>(void_entry);
-    if (key < entry->resource_id) {
-      return -1;
-    } else if (key > entry->resource_id) {
-      return 1;
-    } else {
-      return 0;
-    }
-  }
 };
 #pragma pack(pop)
 
 COMPILE_ASSERT(sizeof(DataPackEntry) == 6, size_of_entry_must_be_six);
 
+// Maps |resource_id| to a slot of a hash table of 2^(32 - |shift|) slots,
+// using Fibonacci hashing: the top bits of the id times 2^32 / phi.
+size_t HashResourceId(uint16 resource_id, int shift) {
+  return static_cast<uint32>(resource_id * 2654435769U) >> shift;
+}
+
 // We're crashing when trying to load a pak file on Windows.  Add some error
 // codes for logging.
 // http://crbug.com/58056
@@ -65,6 +62,7 @@ namespace ui {
 
 DataPack::DataPack(ui::ScaleFactor scale_factor)
     : resource_count_(0),
+      index_hash_shift_(31),
       text_encoding_type_(BINARY),
       scale_factor_(scale_factor) {
 }
@@ -96,6 +94,17 @@ bool DataPack::LoadFromFile(base::PlatformFile file) {
   return LoadImpl();
 }
 
+void DataPack::Prefetch() {
+  DCHECK(mmap_.get());
+#if defined(OS_POSIX)
+  // The mapping starts on a page boundary, as madvise() requires.
+  if (madvise(const_cast<uint8*>(mmap_->data()), mmap_->length(),
+              MADV_WILLNEED)) {
+    DPLOG(WARNING) << "Failed to prefetch datapack";
+  }
+#endif
+}
+
 bool DataPack::LoadImpl() {
   // Sanity check the header of the file.
   if (kHeaderLength > mmap_->length()) {
@@ -159,12 +168,46 @@ bool DataPack::LoadImpl() {
     }
   }
 
+  // Build the hash table over the entries, leaving out the extra one. Should
+  // an id be listed twice, the first entry wins.
+  index_hash_shift_ = 31;
+  while ((static_cast<size_t>(1) << (32 - index_hash_shift_)) <
+         2 * resource_count_) {
+    --index_hash_shift_;
+  }
+  index_slots_.assign(static_cast<size_t>(1) << (32 - index_hash_shift_), 0);
+  const size_t mask = index_slots_.size() - 1;
+  const DataPackEntry* entries =
+      reinterpret_cast<const DataPackEntry*>(mmap_->data() + kHeaderLength);
+  for (size_t i = 0; i < resource_count_; ++i) {
+    size_t slot = HashResourceId(entries[i].resource_id, index_hash_shift_);
+    while (index_slots_[slot] &&
+           entries[index_slots_[slot] - 1].resource_id !=
+               entries[i].resource_id) {
+      slot = (slot + 1) & mask;
+    }
+    if (!index_slots_[slot])
+      index_slots_[slot] = static_cast<uint32>(i + 1);
+  }
+
   return true;
 }
 
+int DataPack::FindEntry(uint16 resource_id) const {
+  const DataPackEntry* entries =
+      reinterpret_cast<const DataPackEntry*>(mmap_->data() + kHeaderLength);
+  const size_t mask = index_slots_.size() - 1;
+  for (size_t slot = HashResourceId(resource_id, index_hash_shift_);
+       index_slots_[slot]; slot = (slot + 1) & mask) {
+    uint32 position = index_slots_[slot] - 1;
+    if (entries[position].resource_id == resource_id)
+      return static_cast<int>(position);
+  }
+  return -1;
+}
+
 bool DataPack::HasResource(uint16 resource_id) const {
-  return !!bsearch(&resource_id, mmap_->data() + kHeaderLength, resource_count_,
-                   sizeof(DataPackEntry), DataPackEntry::CompareById);
+  return FindEntry(resource_id) != -1;
 }
 
 bool DataPack::GetStringPiece(uint16 resource_id,
@@ -180,12 +223,12 @@ bool DataPack::GetStringPiece(uint16 resource_id,
   #error DataPack assumes little endian
 #endif
 
-  const DataPackEntry* target = reinterpret_cast<const DataPackEntry*>(
-      bsearch(&resource_id, mmap_->data() + kHeaderLength, resource_count_,
-              sizeof(DataPackEntry), DataPackEntry::CompareById));
-  if (!target) {
+  int position = FindEntry(resource_id);
+  if (position == -1)
     return false;
-  }
+
+  const DataPackEntry* target = reinterpret_cast<const DataPackEntry*>(
+      mmap_->data() + kHeaderLength) + position;
 
   const DataPackEntry* next_entry = target + 1;
   size_t length = next_entry->file_offset - target->file_offset;
@@ -10,6 +10,7 @@
 #define UI_BASE_RESOURCE_DATA_PACK_H_
 
 #include <map>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/memory/scoped_ptr.h"
@@ -38,6 +39,11 @@ class UI_EXPORT DataPack : public ResourceHandle {
   // Loads a pack file from |file|, returning false on error.
   bool LoadFromFile(base::PlatformFile file);
 
+  // Asks the OS to start reading the whole loaded pack into memory in the
+  // background. Worth it for small packs most of which is used soon after
+  // loading, like the locale pack, but not for the large image packs.
+  void Prefetch();
+
   // Writes a pack file containing |resources| to |path|. If there are any
   // text resources to be written, their encoding must already agree to the
   // |textEncodingType| specified. If no text resources are present, please
@@ -59,12 +65,24 @@ class UI_EXPORT DataPack : public ResourceHandle {
   // Does the actual loading of a pack file. Called by Load and LoadFromFile.
   bool LoadImpl();
 
+  // Returns the position in the pack's index of the entry of |resource_id|,
+  // or -1 if there's none.
+  int FindEntry(uint16 resource_id) const;
+
   // The memory-mapped data.
   scoped_ptr<base::MemoryMappedFile> mmap_;
 
   // Number of resources in the data.
   size_t resource_count_;
 
+  // Open-addressed hash table from resource id to the position of its entry
+  // in the pack's index, built at load time so that lookups don't binary
+  // search the mapped index. Each slot holds the position plus one, or zero
+  // when empty, and collisions probe linearly. The table is always at least
+  // twice as large as |resource_count_|.
+  std::vector<uint32> index_slots_;
+  int index_hash_shift_;
+
   // Type of encoding for text resources.
   TextEncodingType text_encoding_type_;
 
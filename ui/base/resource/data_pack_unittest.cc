@@ -2,11 +2,15 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <string>
+#include <vector>
+
 #include "base/file_util.h"
 #include "base/files/file_path.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/path_service.h"
 #include "base/strings/string_piece.h"
+#include "base/strings/stringprintf.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "ui/base/resource/data_pack.h"
 
@@ -147,4 +151,30 @@ TEST_P(DataPackTest, Write) {
   EXPECT_EQ(fifteen, data);
 }
 
+TEST(DataPackTest, ManyResources) {
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  base::FilePath file = dir.path().Append(FILE_PATH_LITERAL("data.pak"));
+
+  // Enough resources, with ids spread over the whole range, for the lookups
+  // to collide.
+  std::vector<std::string> values;
+  for (int i = 0; i < 3000; ++i)
+    values.push_back(base::StringPrintf("value of %d", i * 21));
+  std::map<uint16, base::StringPiece> resources;
+  for (int i = 0; i < 3000; ++i)
+    resources[static_cast<uint16>(i * 21)] = base::StringPiece(values[i]);
+  ASSERT_TRUE(DataPack::WritePack(file, resources, DataPack::BINARY));
+
+  DataPack pack(SCALE_FACTOR_100P);
+  ASSERT_TRUE(pack.LoadFromPath(file));
+
+  base::StringPiece data;
+  for (int i = 0; i < 3000; ++i) {
+    ASSERT_TRUE(pack.GetStringPiece(static_cast<uint16>(i * 21), &data));
+    EXPECT_EQ(values[i], data);
+    EXPECT_FALSE(pack.HasResource(static_cast<uint16>(i * 21 + 1)));
+  }
+}
+
 }  // namespace ui
@@ -243,7 +243,8 @@ base::FilePath ResourceBundle::GetLocaleFilePath(const std::string& app_locale,
 
 std::string ResourceBundle::LoadLocaleResources(
     const std::string& pref_locale) {
-  DCHECK(!locale_resources_data_.get()) << "locale.pak already loaded";
+  DCHECK(!locale_resources_data_.get() && pending_locale_file_path_.empty())
+      << "locale.pak already loaded";
   std::string app_locale = l10n_util::GetApplicationLocale(pref_locale);
   base::FilePath locale_file_path = GetOverriddenPakPath();
   if (locale_file_path.empty()) {
@@ -262,6 +263,25 @@ std::string ResourceBundle::LoadLocaleResources(
     return std::string();
   }
 
+  if (!base::PathExists(locale_file_path)) {
+    LOG(ERROR) << "failed to find locale.pak";
+    NOTREACHED();
+    return std::string();
+  }
+
+  // Mapping and checking the pack waits for the first localized string, off
+  // the startup path, and never happens in processes that don't need one.
+  pending_locale_file_path_ = locale_file_path;
+  return app_locale;
+}
+
+void ResourceBundle::LoadPendingLocaleResources() {
+  locale_resources_data_lock_->AssertAcquired();
+  if (pending_locale_file_path_.empty())
+    return;
+  base::FilePath locale_file_path = pending_locale_file_path_;
+  pending_locale_file_path_.clear();
+
   scoped_ptr<DataPack> data_pack(
       new DataPack(SCALE_FACTOR_100P));
   if (!data_pack->LoadFromPath(locale_file_path)) {
@@ -269,11 +289,12 @@ std::string ResourceBundle::LoadLocaleResources(
                               logging::GetLastSystemErrorCode(), 16000);
     LOG(ERROR) << "failed to load locale.pak";
     NOTREACHED();
-    return std::string();
+    return;
   }
 
+  // Most of the strings get used soon, read them all in ahead of the lookups.
+  data_pack->Prefetch();
   locale_resources_data_.reset(data_pack.release());
-  return app_locale;
 }
 
 void ResourceBundle::LoadTestResources(const base::FilePath& path,
@@ -295,6 +316,7 @@ void ResourceBundle::LoadTestResources(const base::FilePath& path,
 
 void ResourceBundle::UnloadLocaleResources() {
   locale_resources_data_.reset();
+  pending_locale_file_path_.clear();
 }
 
 void ResourceBundle::OverrideLocalePakForTest(const base::FilePath& pak_path) {
@@ -431,6 +453,7 @@ string16 ResourceBundle::GetLocalizedString(int message_id) {
   // Ensure that ReloadLocaleResources() doesn't drop the resources while
   // we're using them.
   base::AutoLock lock_scope(*locale_resources_data_lock_);
+  LoadPendingLocaleResources();
 
   // If for some reason we were unable to load the resources , return an empty
   // string (better than crashing).
@@ -293,9 +293,14 @@ class UI_EXPORT ResourceBundle {
   void AddDataPack(DataPack* data_pack);
 
   // Try to load the locale specific strings from an external data module.
-  // Returns the locale that is loaded.
+  // Returns the locale that is loaded. The module itself is only mapped when
+  // the first localized string is looked up.
   std::string LoadLocaleResources(const std::string& pref_locale);
 
+  // Maps the locale data module picked by LoadLocaleResources(), if it hasn't
+  // been yet. Must be called with |locale_resources_data_lock_| held.
+  void LoadPendingLocaleResources();
+
   // Load test resources in given paths. If either path is empty an empty
   // resource pack is loaded.
   void LoadTestResources(const base::FilePath& path,
@@ -369,6 +374,10 @@ class UI_EXPORT ResourceBundle {
   scoped_ptr<ResourceHandle> locale_resources_data_;
   ScopedVector<ResourceHandle> data_packs_;
 
+  // Path of the locale data module waiting to be mapped, empty once it has
+  // been or when there's none. Protected by |locale_resources_data_lock_|.
+  base::FilePath pending_locale_file_path_;
+
   // The maximum scale factor currently loaded.
   ScaleFactor max_scale_factor_;
 
@@ -617,7 +617,10 @@ void Compositor::ScheduleRedrawRect(const gfx::Rect& damage_rect) {
 }
 
 void Compositor::SetLatencyInfo(const ui::LatencyInfo& latency_info) {
-  host_->SetLatencyInfo(latency_info);
+  ui::LatencyInfo info = latency_info;
+  info.AddFirstLatencyNumber(
+      ui::INPUT_EVENT_LATENCY_BROWSER_COMPOSITOR_COMPONENT);
+  host_->SetLatencyInfo(info);
 }
 
 bool Compositor::ReadPixels(SkBitmap* bitmap,
@@ -4,6 +4,8 @@
 
 #include "ui/compositor/layer_animation_element.h"
 
+#include <vector>
+
 #include "base/compiler_specific.h"
 #include "cc/animation/animation.h"
 #include "cc/animation/animation_id_provider.h"
@@ -26,6 +28,10 @@ namespace {
 const int kSlowDurationScaleFactor = 4;
 const int kFastDurationScaleFactor = 4;
 
+// The number of segments an InterpolatedTransform is sampled into when it is
+// animated on the compositor thread.
+const int kInterpolatedTransformSegments = 32;
+
 // Pause -----------------------------------------------------------------------
 class Pause : public LayerAnimationElement {
  public:
@@ -563,6 +569,75 @@ class ThreadedTransformTransition : public ThreadedLayerAnimationElement {
   DISALLOW_COPY_AND_ASSIGN(ThreadedTransformTransition);
 };
 
+// ThreadedInterpolatedTransformTransition -------------------------------------
+
+class ThreadedInterpolatedTransformTransition
+    : public ThreadedLayerAnimationElement {
+ public:
+  ThreadedInterpolatedTransformTransition(
+      InterpolatedTransform* interpolated_transform,
+      base::TimeDelta duration)
+      : ThreadedLayerAnimationElement(GetProperties(), duration),
+        interpolated_transform_(interpolated_transform) {
+  }
+  virtual ~ThreadedInterpolatedTransformTransition() {}
+
+ protected:
+  virtual void OnStart(LayerAnimationDelegate* delegate) OVERRIDE {
+    float device_scale_factor = delegate->GetDeviceScaleFactor();
+    cc_samples_.clear();
+    for (int i = 0; i <= kInterpolatedTransformSegments; ++i) {
+      cc_samples_.push_back(Layer::ConvertTransformToCCTransform(
+          interpolated_transform_->Interpolate(
+              static_cast<float>(i) / kInterpolatedTransformSegments),
+          device_scale_factor));
+    }
+  }
+
+  virtual void OnAbort(LayerAnimationDelegate* delegate) OVERRIDE {
+    if (delegate && Started()) {
+      ThreadedLayerAnimationElement::OnAbort(delegate);
+      delegate->SetTransformFromAnimation(interpolated_transform_->Interpolate(
+          static_cast<float>(Tween::CalculateValue(
+              tween_type(), last_progressed_fraction()))));
+    }
+  }
+
+  virtual void OnEnd(LayerAnimationDelegate* delegate) OVERRIDE {
+    delegate->SetTransformFromAnimation(
+        interpolated_transform_->Interpolate(1.0f));
+  }
+
+  virtual scoped_ptr<cc::Animation> CreateCCAnimation() OVERRIDE {
+    scoped_ptr<cc::AnimationCurve> animation_curve(
+        new InterpolatedTransformAnimationCurveAdapter(tween_type(),
+                                                       cc_samples_,
+                                                       duration()));
+    scoped_ptr<cc::Animation> animation(
+        cc::Animation::Create(animation_curve.Pass(),
+                              animation_id(),
+                              animation_group_id(),
+                              cc::Animation::Transform));
+    return animation.Pass();
+  }
+
+  virtual void OnGetTarget(TargetValue* target) const OVERRIDE {
+    target->transform = interpolated_transform_->Interpolate(1.0f);
+  }
+
+ private:
+  static AnimatableProperties GetProperties() {
+    AnimatableProperties properties;
+    properties.insert(LayerAnimationElement::TRANSFORM);
+    return properties;
+  }
+
+  scoped_ptr<InterpolatedTransform> interpolated_transform_;
+  std::vector<gfx::Transform> cc_samples_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadedInterpolatedTransformTransition);
+};
+
 }  // namespace
 
 // LayerAnimationElement::TargetValue ------------------------------------------
@@ -733,7 +808,8 @@ LayerAnimationElement*
 LayerAnimationElement::CreateInterpolatedTransformElement(
     InterpolatedTransform* interpolated_transform,
     base::TimeDelta duration) {
-  return new InterpolatedTransformTransition(interpolated_transform, duration);
+  return new ThreadedInterpolatedTransformTransition(interpolated_transform,
+                                                     duration);
 }
 
 // static
@@ -4,6 +4,8 @@
 
 #include "ui/compositor/layer_animation_element.h"
 
+#include <vector>
+
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/memory/scoped_ptr.h"
@@ -12,6 +14,8 @@
 #include "ui/compositor/layer_animation_delegate.h"
 #include "ui/compositor/test/test_layer_animation_delegate.h"
 #include "ui/compositor/test/test_utils.h"
+#include "ui/compositor/transform_animation_curve_adapter.h"
+#include "ui/gfx/interpolated_transform.h"
 #include "ui/gfx/rect.h"
 #include "ui/gfx/transform.h"
 
@@ -65,6 +69,59 @@ TEST(LayerAnimationElementTest, TransformElement) {
   CheckApproximatelyEqual(target_transform, target_value.transform);
 }
 
+// Check that the interpolated transform element runs on the compositor thread
+// and leaves the delegate at the interpolated transform's final value.
+TEST(LayerAnimationElementTest, InterpolatedTransformElement) {
+  TestLayerAnimationDelegate delegate;
+  gfx::Transform target_transform;
+  target_transform.Rotate(90.0);
+  base::TimeTicks start_time;
+  base::TimeTicks effective_start_time;
+  base::TimeDelta delta = base::TimeDelta::FromSeconds(1);
+
+  scoped_ptr<LayerAnimationElement> element(
+      LayerAnimationElement::CreateInterpolatedTransformElement(
+          new InterpolatedRotation(0.0f, 90.0f), delta));
+  element->set_animation_group_id(1);
+  EXPECT_TRUE(element->IsThreaded());
+
+  for (int i = 0; i < 2; ++i) {
+    start_time = effective_start_time + delta;
+    element->set_requested_start_time(start_time);
+    delegate.SetTransformFromAnimation(gfx::Transform());
+    element->Start(&delegate, 1);
+    effective_start_time = start_time + delta;
+    element->set_effective_start_time(effective_start_time);
+    element->Progress(effective_start_time + delta/2, &delegate);
+    EXPECT_FLOAT_EQ(0.5, element->last_progressed_fraction());
+
+    element->Progress(effective_start_time + delta, &delegate);
+    EXPECT_FLOAT_EQ(1.0, element->last_progressed_fraction());
+    CheckApproximatelyEqual(target_transform,
+                            delegate.GetTransformForAnimation());
+  }
+
+  LayerAnimationElement::TargetValue target_value(&delegate);
+  element->GetTargetValue(&target_value);
+  CheckApproximatelyEqual(target_transform, target_value.transform);
+}
+
+// Check that the curve run on the compositor thread for an interpolated
+// transform follows the interpolated transform between its samples.
+TEST(LayerAnimationElementTest, InterpolatedTransformCurve) {
+  InterpolatedRotation rotation(0.0f, 90.0f);
+  std::vector<gfx::Transform> samples;
+  for (int i = 0; i <= 4; ++i)
+    samples.push_back(rotation.Interpolate(i / 4.0f));
+  InterpolatedTransformAnimationCurveAdapter curve(
+      Tween::LINEAR, samples, base::TimeDelta::FromSeconds(1));
+
+  CheckApproximatelyEqual(samples.front(), curve.GetValue(0.0));
+  CheckApproximatelyEqual(rotation.Interpolate(0.25f), curve.GetValue(0.25));
+  CheckApproximatelyEqual(rotation.Interpolate(0.6f), curve.GetValue(0.6));
+  CheckApproximatelyEqual(samples.back(), curve.GetValue(1.0));
+}
+
 // Check that the bounds element progresses the delegate as expected and
 // that the element can be reused after it completes.
 TEST(LayerAnimationElementTest, BoundsElement) {
@@ -4,6 +4,10 @@
 
 #include "ui/compositor/transform_animation_curve_adapter.h"
 
+#include <algorithm>
+
+#include "base/logging.h"
+
 namespace ui {
 
 TransformAnimationCurveAdapter::TransformAnimationCurveAdapter(
@@ -51,4 +55,55 @@ gfx::Transform TransformAnimationCurveAdapter::GetValue(
   return gfx::ComposeTransform(to_return);
 }
 
+InterpolatedTransformAnimationCurveAdapter::
+    InterpolatedTransformAnimationCurveAdapter(
+        Tween::Type tween_type,
+        const std::vector<gfx::Transform>& samples,
+        base::TimeDelta duration)
+    : tween_type_(tween_type),
+      samples_(samples),
+      decomposed_samples_(samples.size()),
+      duration_(duration) {
+  DCHECK_GE(samples_.size(), 2u);
+  for (size_t i = 0; i < samples_.size(); ++i)
+    gfx::DecomposeTransform(&decomposed_samples_[i], samples_[i]);
+}
+
+InterpolatedTransformAnimationCurveAdapter::
+    ~InterpolatedTransformAnimationCurveAdapter() {
+}
+
+double InterpolatedTransformAnimationCurveAdapter::Duration() const {
+  return duration_.InSecondsF();
+}
+
+scoped_ptr<cc::AnimationCurve>
+InterpolatedTransformAnimationCurveAdapter::Clone() const {
+  scoped_ptr<InterpolatedTransformAnimationCurveAdapter> to_return(
+      new InterpolatedTransformAnimationCurveAdapter(tween_type_,
+                                                     samples_,
+                                                     duration_));
+  return to_return.PassAs<cc::AnimationCurve>();
+}
+
+gfx::Transform InterpolatedTransformAnimationCurveAdapter::GetValue(
+    double t) const {
+  if (t >= duration_.InSecondsF())
+    return samples_.back();
+  if (t <= 0.0)
+    return samples_.front();
+  double progress = std::max(0.0, std::min(1.0, Tween::CalculateValue(
+      tween_type_, t / duration_.InSecondsF())));
+
+  // Blend between the two samples on either side of |progress|.
+  double position = progress * (samples_.size() - 1);
+  size_t index = std::min(static_cast<size_t>(position), samples_.size() - 2);
+  gfx::DecomposedTransform to_return;
+  gfx::BlendDecomposedTransforms(&to_return,
+                                 decomposed_samples_[index + 1],
+                                 decomposed_samples_[index],
+                                 position - index);
+  return gfx::ComposeTransform(to_return);
+}
+
 }  // namespace ui
@@ -5,6 +5,8 @@
 #ifndef UI_COMPOSITOR_TRANSFORM_ANIMATION_CURVE_ADAPTER_H_
 #define UI_COMPOSITOR_TRANSFORM_ANIMATION_CURVE_ADAPTER_H_
 
+#include <vector>
+
 #include "base/time/time.h"
 #include "cc/animation/animation_curve.h"
 #include "ui/base/animation/tween.h"
@@ -36,6 +38,31 @@ class TransformAnimationCurveAdapter :public cc::TransformAnimationCurve {
   base::TimeDelta duration_;
 };
 
+// Animates through the values of an InterpolatedTransform, which can't be
+// copied to the compositor thread, by blending between |samples| taken at
+// evenly spaced fractions of the animation from 0 to 1 inclusive.
+class InterpolatedTransformAnimationCurveAdapter
+    : public cc::TransformAnimationCurve {
+ public:
+  InterpolatedTransformAnimationCurveAdapter(
+      Tween::Type tween_type,
+      const std::vector<gfx::Transform>& samples,
+      base::TimeDelta duration);
+
+  virtual ~InterpolatedTransformAnimationCurveAdapter();
+
+  // TransformAnimationCurve implementation.
+  virtual double Duration() const OVERRIDE;
+  virtual scoped_ptr<AnimationCurve> Clone() const OVERRIDE;
+  virtual gfx::Transform GetValue(double t) const OVERRIDE;
+
+ private:
+  Tween::Type tween_type_;
+  std::vector<gfx::Transform> samples_;
+  std::vector<gfx::DecomposedTransform> decomposed_samples_;
+  base::TimeDelta duration_;
+};
+
 }  // namespace ui
 
 #endif  // UI_COMPOSITOR_TRANSFORM_ANIMATION_CURVE_ADAPTER_H_
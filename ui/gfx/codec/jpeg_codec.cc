@@ -10,6 +10,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkColorPriv.h"
+#include "ui/gfx/size.h"
 
 extern "C" {
 #if defined(USE_SYSTEM_LIBJPEG)
@@ -455,15 +456,21 @@ class DecompressDestroyer {
   jpeg_decompress_struct* cinfo_;
 };
 
-}  // namespace
-
-bool JPEGCodec::Decode(const unsigned char* input, size_t input_size,
-                       ColorFormat format, std::vector<unsigned char>* output,
-                       int* w, int* h) {
+// Decodes |input| into |output|, or into |bitmap| when |output| is NULL, in
+// which case |format| must be FORMAT_SkBitmap. Unless |min_size| is empty,
+// the image is scaled down while decoding by the smallest of 1/8, 1/4 and 1/2
+// that keeps it at least |min_size|: libjpeg then only computes the pixels
+// that are kept, which saves most of the work and memory for large photos.
+bool DecodeImpl(const unsigned char* input, size_t input_size,
+                JPEGCodec::ColorFormat format, const Size& min_size,
+                std::vector<unsigned char>* output, SkBitmap* bitmap,
+                int* w, int* h) {
+  DCHECK(output || (bitmap && format == JPEGCodec::FORMAT_SkBitmap));
   jpeg_decompress_struct cinfo;
   DecompressDestroyer destroyer;
   destroyer.SetManagedObject(&cinfo);
-  output->clear();
+  if (output)
+    output->clear();
 
   // We set up the normal JPEG error routines, then override error_exit.
   // This must be done before the call to create_decompress.
@@ -509,15 +516,15 @@ bool JPEGCodec::Decode(const unsigned char* input, size_t input_size,
       // Same as JPEGCodec::Encode(), libjpeg-turbo supports all input formats
       // used by Chromium (i.e. RGB, RGBA, and BGRA) and we just map the input
       // parameters to a colorspace.
-      if (format == FORMAT_RGB) {
+      if (format == JPEGCodec::FORMAT_RGB) {
         cinfo.out_color_space = JCS_RGB;
         cinfo.output_components = 3;
-      } else if (format == FORMAT_RGBA ||
-                 (format == FORMAT_SkBitmap && SK_R32_SHIFT == 0)) {
+      } else if (format == JPEGCodec::FORMAT_RGBA ||
+                 (format == JPEGCodec::FORMAT_SkBitmap && SK_R32_SHIFT == 0)) {
         cinfo.out_color_space = JCS_EXT_RGBX;
         cinfo.output_components = 4;
-      } else if (format == FORMAT_BGRA ||
-                 (format == FORMAT_SkBitmap && SK_B32_SHIFT == 0)) {
+      } else if (format == JPEGCodec::FORMAT_BGRA ||
+                 (format == JPEGCodec::FORMAT_SkBitmap && SK_B32_SHIFT == 0)) {
         cinfo.out_color_space = JCS_EXT_BGRX;
         cinfo.output_components = 4;
       } else {
@@ -542,6 +549,20 @@ bool JPEGCodec::Decode(const unsigned char* input, size_t input_size,
   cinfo.output_components = 3;
 #endif
 
+  if (!min_size.IsEmpty()) {
+    const unsigned int min_width = min_size.width();
+    const unsigned int min_height = min_size.height();
+    for (unsigned int denom = 8; denom > 1; denom /= 2) {
+      // libjpeg rounds the scaled dimensions up.
+      if ((cinfo.image_width + denom - 1) / denom >= min_width &&
+          (cinfo.image_height + denom - 1) / denom >= min_height) {
+        cinfo.scale_num = 1;
+        cinfo.scale_denom = denom;
+        break;
+      }
+    }
+  }
+
   jpeg_calc_output_dimensions(&cinfo);
   *w = cinfo.output_width;
   *h = cinfo.output_height;
@@ -552,25 +573,53 @@ bool JPEGCodec::Decode(const unsigned char* input, size_t input_size,
   // how to align row lengths as we do for the compressor.
   int row_read_stride = cinfo.output_width * cinfo.output_components;
 
+  // The decoded rows go to |output|, or straight into the pixels of |bitmap|
+  // without a copy of the whole image on the side.
+  int row_write_stride;
 #ifdef JCS_EXTENSIONS
-  // Create memory for a decoded image and write decoded lines to the memory
-  // without conversions same as JPEGCodec::Encode().
-  int row_write_stride = row_read_stride;
-  output->resize(row_write_stride * cinfo.output_height);
+  row_write_stride = row_read_stride;
+#else
+  void (*converter)(const unsigned char* rgb, int w, unsigned char* out) =
+      NULL;
+  if (format == JPEGCodec::FORMAT_RGB) {
+    // easy case, row needs no conversion
+    row_write_stride = row_read_stride;
+  } else if (format == JPEGCodec::FORMAT_RGBA ||
+             (format == JPEGCodec::FORMAT_SkBitmap && SK_R32_SHIFT == 0)) {
+    row_write_stride = cinfo.output_width * 4;
+    converter = AddAlpha;
+  } else if (format == JPEGCodec::FORMAT_BGRA ||
+             (format == JPEGCodec::FORMAT_SkBitmap && SK_B32_SHIFT == 0)) {
+    row_write_stride = cinfo.output_width * 4;
+    converter = RGBtoBGRA;
+  } else {
+    NOTREACHED() << "Invalid pixel format";
+    return false;
+  }
+#endif
 
+  unsigned char* pixels;
+  if (output) {
+    output->resize(row_write_stride * cinfo.output_height);
+    pixels = &(*output)[0];
+  } else {
+    bitmap->setConfig(SkBitmap::kARGB_8888_Config, *w, *h);
+    if (!bitmap->allocPixels())
+      return false;
+    row_write_stride = static_cast<int>(bitmap->rowBytes());
+    pixels = static_cast<unsigned char*>(bitmap->getPixels());
+  }
+
+#ifdef JCS_EXTENSIONS
   for (int row = 0; row < static_cast<int>(cinfo.output_height); row++) {
-    unsigned char* rowptr = &(*output)[row * row_write_stride];
+    unsigned char* rowptr = pixels + row * row_write_stride;
     if (!jpeg_read_scanlines(&cinfo, &rowptr, 1))
       return false;
   }
 #else
-  if (format == FORMAT_RGB) {
-    // easy case, row needs no conversion
-    int row_write_stride = row_read_stride;
-    output->resize(row_write_stride * cinfo.output_height);
-
+  if (!converter) {
     for (int row = 0; row < static_cast<int>(cinfo.output_height); row++) {
-      unsigned char* rowptr = &(*output)[row * row_write_stride];
+      unsigned char* rowptr = pixels + row * row_write_stride;
       if (!jpeg_read_scanlines(&cinfo, &rowptr, 1))
         return false;
     }
@@ -578,55 +627,45 @@ bool JPEGCodec::Decode(const unsigned char* input, size_t input_size,
     // Rows need conversion to output format: read into a temporary buffer and
     // expand to the final one. Performance: we could avoid the extra
     // allocation by doing the expansion in-place.
-    int row_write_stride;
-    void (*converter)(const unsigned char* rgb, int w, unsigned char* out);
-    if (format == FORMAT_RGBA ||
-        (format == FORMAT_SkBitmap && SK_R32_SHIFT == 0)) {
-      row_write_stride = cinfo.output_width * 4;
-      converter = AddAlpha;
-    } else if (format == FORMAT_BGRA ||
-               (format == FORMAT_SkBitmap && SK_B32_SHIFT == 0)) {
-      row_write_stride = cinfo.output_width * 4;
-      converter = RGBtoBGRA;
-    } else {
-      NOTREACHED() << "Invalid pixel format";
-      jpeg_destroy_decompress(&cinfo);
-      return false;
-    }
-
-    output->resize(row_write_stride * cinfo.output_height);
-
     scoped_ptr<unsigned char[]> row_data(new unsigned char[row_read_stride]);
     unsigned char* rowptr = row_data.get();
     for (int row = 0; row < static_cast<int>(cinfo.output_height); row++) {
       if (!jpeg_read_scanlines(&cinfo, &rowptr, 1))
         return false;
-      converter(rowptr, *w, &(*output)[row * row_write_stride]);
+      converter(rowptr, *w, pixels + row * row_write_stride);
     }
   }
 #endif
 
   jpeg_finish_decompress(&cinfo);
-  jpeg_destroy_decompress(&cinfo);
+  destroyer.DestroyManagedObject();
   return true;
 }
 
+}  // namespace
+
+bool JPEGCodec::Decode(const unsigned char* input, size_t input_size,
+                       ColorFormat format, std::vector<unsigned char>* output,
+                       int* w, int* h) {
+  return DecodeImpl(input, input_size, format, Size(), output, NULL, w, h);
+}
+
 // static
 SkBitmap* JPEGCodec::Decode(const unsigned char* input, size_t input_size) {
+  return DecodeToSize(input, input_size, Size());
+}
+
+// static
+SkBitmap* JPEGCodec::DecodeToSize(const unsigned char* input,
+                                  size_t input_size,
+                                  const Size& min_size) {
   int w, h;
-  std::vector<unsigned char> data_vector;
-  if (!Decode(input, input_size, FORMAT_SkBitmap, &data_vector, &w, &h))
+  scoped_ptr<SkBitmap> bitmap(new SkBitmap());
+  if (!DecodeImpl(input, input_size, FORMAT_SkBitmap, min_size, NULL,
+                  bitmap.get(), &w, &h)) {
     return NULL;
-
-  // Skia only handles 32 bit images.
-  int data_length = w * h * 4;
-
-  SkBitmap* bitmap = new SkBitmap();
-  bitmap->setConfig(SkBitmap::kARGB_8888_Config, w, h);
-  bitmap->allocPixels();
-  memcpy(bitmap->getAddr32(0, 0), &data_vector[0], data_length);
-
-  return bitmap;
+  }
+  return bitmap.release();
 }
 
 }  // namespace gfx
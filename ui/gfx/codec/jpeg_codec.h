@@ -14,6 +14,8 @@ class SkBitmap;
 
 namespace gfx {
 
+class Size;
+
 // Interface for encoding/decoding JPEG data. This is a wrapper around libjpeg,
 // which has an inconvenient interface for callers. This is only used for UI
 // elements, WebKit has its own more complicated JPEG decoder which handles,
@@ -72,6 +74,14 @@ class UI_EXPORT JPEGCodec {
   // successful, a SkBitmap is created and returned. It is up to the caller
   // to delete the returned bitmap.
   static SkBitmap* Decode(const unsigned char* input, size_t input_size);
+
+  // Same as the above, but for callers that are going to shrink the image to
+  // |min_size| or more: the JPEG is scaled down by 1/2, 1/4 or 1/8 while being
+  // decoded, as far as it stays at least |min_size|. This costs a fraction of
+  // the memory and time of decoding large photos at full size. Images smaller
+  // than twice |min_size| in either dimension come out at full size.
+  static SkBitmap* DecodeToSize(const unsigned char* input, size_t input_size,
+                                const Size& min_size);
 };
 
 }  // namespace gfx
@@ -5,8 +5,11 @@
 #include <math.h>
 
 #include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "ui/gfx/codec/jpeg_codec.h"
+#include "ui/gfx/size.h"
 
 namespace {
 
@@ -197,6 +200,46 @@ TEST(JPEGCodec, DecodeCorrupted) {
                                  &outw, &outh));
 }
 
+// Tests that DecodeToSize() scales the image down by the largest factor that
+// still covers the requested size.
+TEST(JPEGCodec, DecodeToSize) {
+  int w = 160, h = 120;
+
+  std::vector<unsigned char> original;
+  MakeRGBImage(w, h, &original);
+  std::vector<unsigned char> encoded;
+  ASSERT_TRUE(JPEGCodec::Encode(&original[0], JPEGCodec::FORMAT_RGB, w, h,
+                                w * 3, jpeg_quality, &encoded));
+
+  // An empty size decodes at full size.
+  scoped_ptr<SkBitmap> bitmap(
+      JPEGCodec::DecodeToSize(&encoded[0], encoded.size(), gfx::Size()));
+  ASSERT_TRUE(bitmap.get());
+  EXPECT_EQ(w, bitmap->width());
+  EXPECT_EQ(h, bitmap->height());
+
+  // 1/4 exactly matches the requested size.
+  bitmap.reset(JPEGCodec::DecodeToSize(&encoded[0], encoded.size(),
+                                       gfx::Size(40, 30)));
+  ASSERT_TRUE(bitmap.get());
+  EXPECT_EQ(40, bitmap->width());
+  EXPECT_EQ(30, bitmap->height());
+
+  // 1/4 would be too narrow, so 1/2 is used.
+  bitmap.reset(JPEGCodec::DecodeToSize(&encoded[0], encoded.size(),
+                                       gfx::Size(50, 30)));
+  ASSERT_TRUE(bitmap.get());
+  EXPECT_EQ(80, bitmap->width());
+  EXPECT_EQ(60, bitmap->height());
+
+  // The image is never scaled below 1/8.
+  bitmap.reset(JPEGCodec::DecodeToSize(&encoded[0], encoded.size(),
+                                       gfx::Size(1, 1)));
+  ASSERT_TRUE(bitmap.get());
+  EXPECT_EQ(20, bitmap->width());
+  EXPECT_EQ(15, bitmap->height());
+}
+
 // Test that we can decode JPEG images without invalid-read errors on valgrind.
 // This test decodes a 1x1 JPEG image and writes the decoded RGB (or RGBA) pixel
 // to the output buffer without OOB reads.
@@ -587,6 +587,22 @@ class CommentWriter {
 };
 #endif  // PNG_TEXT_SUPPORTED
 
+// Returns the libpng flags for the PNGCodec::Filter bits in |filters|.
+int ToLibpngFilters(int filters) {
+  int png_filters = 0;
+  if (filters & PNGCodec::FILTER_NONE)
+    png_filters |= PNG_FILTER_NONE;
+  if (filters & PNGCodec::FILTER_SUB)
+    png_filters |= PNG_FILTER_SUB;
+  if (filters & PNGCodec::FILTER_UP)
+    png_filters |= PNG_FILTER_UP;
+  if (filters & PNGCodec::FILTER_AVG)
+    png_filters |= PNG_FILTER_AVG;
+  if (filters & PNGCodec::FILTER_PAETH)
+    png_filters |= PNG_FILTER_PAETH;
+  return png_filters;
+}
+
 // The type of functions usable for converting between pixel formats.
 typedef void (*FormatConverter)(const unsigned char* in, int w,
                                 unsigned char* out, bool* is_opaque);
@@ -598,7 +614,8 @@ typedef void (*FormatConverter)(const unsigned char* in, int w,
 bool DoLibpngWrite(png_struct* png_ptr, png_info* info_ptr,
                    PngEncoderState* state,
                    int width, int height, int row_byte_width,
-                   const unsigned char* input, int compression_level,
+                   const unsigned char* input,
+                   const PNGCodec::EncodeOptions& options,
                    int png_output_color_type, int output_color_components,
                    FormatConverter converter,
                    const std::vector<PNGCodec::Comment>& comments) {
@@ -615,7 +632,10 @@ bool DoLibpngWrite(png_struct* png_ptr, png_info* info_ptr,
     return false;
   }
 
-  png_set_compression_level(png_ptr, compression_level);
+  png_set_compression_level(png_ptr, options.compression_level);
+  png_set_compression_strategy(png_ptr, options.compression_strategy);
+  png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE,
+                 ToLibpngFilters(options.filters));
 
   // Set our callback for libpng to give us the data.
   png_set_write_fn(png_ptr, state, EncoderWriteCallback, FakeFlushCallback);
@@ -662,11 +682,9 @@ bool PNGCodec::Encode(const unsigned char* input, ColorFormat format,
                       bool discard_transparency,
                       const std::vector<Comment>& comments,
                       std::vector<unsigned char>* output) {
-  return PNGCodec::EncodeWithCompressionLevel(input, format, size,
-                                              row_byte_width,
-                                              discard_transparency,
-                                              comments, Z_DEFAULT_COMPRESSION,
-                                              output);
+  return PNGCodec::EncodeWithOptions(input, format, size, row_byte_width,
+                                     discard_transparency, comments,
+                                     EncodeOptions(), output);
 }
 
 // static
@@ -677,6 +695,21 @@ bool PNGCodec::EncodeWithCompressionLevel(const unsigned char* input,
                                           const std::vector<Comment>& comments,
                                           int compression_level,
                                           std::vector<unsigned char>* output) {
+  EncodeOptions options;
+  options.compression_level = compression_level;
+  return PNGCodec::EncodeWithOptions(input, format, size, row_byte_width,
+                                     discard_transparency, comments, options,
+                                     output);
+}
+
+// static
+bool PNGCodec::EncodeWithOptions(const unsigned char* input,
+                                 ColorFormat format, const Size& size,
+                                 int row_byte_width,
+                                 bool discard_transparency,
+                                 const std::vector<Comment>& comments,
+                                 const EncodeOptions& options,
+                                 std::vector<unsigned char>* output) {
   // Run to convert an input row into the output row format, NULL means no
   // conversion is necessary.
   FormatConverter converter = NULL;
@@ -752,7 +785,7 @@ bool PNGCodec::EncodeWithCompressionLevel(const unsigned char* input,
   PngEncoderState state(output);
   bool success = DoLibpngWrite(png_ptr, info_ptr, &state,
                                size.width(), size.height(), row_byte_width,
-                               input, compression_level, png_output_color_type,
+                               input, options, png_output_color_type,
                                output_color_components, converter, comments);
 
   return success;
@@ -762,6 +795,16 @@ bool PNGCodec::EncodeWithCompressionLevel(const unsigned char* input,
 bool PNGCodec::EncodeBGRASkBitmap(const SkBitmap& input,
                                   bool discard_transparency,
                                   std::vector<unsigned char>* output) {
+  return EncodeBGRASkBitmapWithOptions(input, discard_transparency,
+                                       EncodeOptions(), output);
+}
+
+// static
+bool PNGCodec::EncodeBGRASkBitmapWithOptions(
+    const SkBitmap& input,
+    bool discard_transparency,
+    const EncodeOptions& options,
+    std::vector<unsigned char>* output) {
   static const int bbp = 4;
 
   SkAutoLockPixels lock_input(input);
@@ -770,10 +813,11 @@ bool PNGCodec::EncodeBGRASkBitmap(const SkBitmap& input,
   DCHECK(input.bytesPerPixel() == bbp);
   DCHECK(static_cast<int>(input.rowBytes()) >= input.width() * bbp);
 
-  return Encode(reinterpret_cast<unsigned char*>(input.getAddr32(0, 0)),
-                FORMAT_SkBitmap, Size(input.width(), input.height()),
-                static_cast<int>(input.rowBytes()), discard_transparency,
-                std::vector<Comment>(), output);
+  return EncodeWithOptions(
+      reinterpret_cast<unsigned char*>(input.getAddr32(0, 0)),
+      FORMAT_SkBitmap, Size(input.width(), input.height()),
+      static_cast<int>(input.rowBytes()), discard_transparency,
+      std::vector<Comment>(), options, output);
 }
 
 PNGCodec::Comment::Comment(const std::string& k, const std::string& t)
@@ -783,4 +827,19 @@ PNGCodec::Comment::Comment(const std::string& k, const std::string& t)
 PNGCodec::Comment::~Comment() {
 }
 
+PNGCodec::EncodeOptions::EncodeOptions()
+    : compression_level(Z_DEFAULT_COMPRESSION),
+      compression_strategy(Z_DEFAULT_STRATEGY),
+      filters(FILTER_ALL) {
+}
+
+// static
+PNGCodec::EncodeOptions PNGCodec::EncodeOptions::Fast() {
+  EncodeOptions options;
+  options.compression_level = Z_BEST_SPEED;
+  options.compression_strategy = Z_RLE;
+  options.filters = FILTER_SUB;
+  return options;
+}
+
 }  // namespace gfx
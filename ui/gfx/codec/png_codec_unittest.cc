@@ -2,10 +2,13 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <stdio.h>
+
 #include <algorithm>
 #include <cmath>
 
 #include "base/logging.h"
+#include "base/time/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/libpng/png.h"
 #include "third_party/skia/include/core/SkBitmap.h"
@@ -1158,5 +1161,61 @@ TEST(PNGCodec, EncodeDecodeWithVaryingCompressionLevels) {
   ASSERT_TRUE(original == decoded);
 }
 
+TEST(PNGCodec, EncodeDecodeWithFastOptions) {
+  const int w = 20, h = 20;
+
+  std::vector<unsigned char> original;
+  MakeRGBAImage(w, h, true, &original);
+
+  std::vector<unsigned char> encoded;
+  EXPECT_TRUE(PNGCodec::EncodeWithOptions(
+        &original[0], PNGCodec::FORMAT_RGBA, Size(w, h), w * 4, false,
+        std::vector<PNGCodec::Comment>(), PNGCodec::EncodeOptions::Fast(),
+        &encoded));
+
+  std::vector<unsigned char> decoded;
+  int outw, outh;
+  EXPECT_TRUE(PNGCodec::Decode(&encoded[0], encoded.size(),
+                               PNGCodec::FORMAT_RGBA, &decoded,
+                               &outw, &outh));
+  ASSERT_EQ(w, outw);
+  ASSERT_EQ(h, outh);
+  ASSERT_TRUE(original == decoded);
+}
+
+// Reports how fast screen-sized bitmaps are encoded with the default and the
+// fast options, and how large the results are.
+TEST(PNGCodec, EncodeThroughput) {
+  const int w = 1280, h = 720;
+  const int kIterations = 3;
+
+  SkBitmap bitmap;
+  MakeTestSkBitmap(w, h, &bitmap);
+
+  const struct {
+    const char* name;
+    PNGCodec::EncodeOptions options;
+  } kCases[] = {
+    { "png_encode_default", PNGCodec::EncodeOptions() },
+    { "png_encode_fast", PNGCodec::EncodeOptions::Fast() },
+  };
+  for (size_t i = 0; i < ARRAYSIZE_UNSAFE(kCases); ++i) {
+    std::vector<unsigned char> encoded;
+    base::TimeTicks start = base::TimeTicks::HighResNow();
+    for (int j = 0; j < kIterations; ++j) {
+      ASSERT_TRUE(PNGCodec::EncodeBGRASkBitmapWithOptions(
+          bitmap, false, kCases[i].options, &encoded));
+    }
+    base::TimeDelta elapsed = base::TimeTicks::HighResNow() - start;
+    printf("*RESULT %s: %.2f ms/frame, %d bytes\n", kCases[i].name,
+           elapsed.InMillisecondsF() / kIterations,
+           static_cast<int>(encoded.size()));
+
+    SkBitmap decoded;
+    ASSERT_TRUE(PNGCodec::Decode(&encoded[0], encoded.size(), &decoded));
+    EXPECT_EQ(w, decoded.width());
+    EXPECT_EQ(h, decoded.height());
+  }
+}
 
 }  // namespace gfx
@@ -7,10 +7,18 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <set>
 
+#include "base/bind.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/message_loop/message_loop.h"
+#include "base/metrics/histogram.h"
+#include "base/synchronization/lock.h"
 #include "base/threading/non_thread_safe.h"
+#include "base/threading/platform_thread.h"
 #include "ui/gfx/image/image_skia_operations.h"
 #include "ui/gfx/image/image_skia_source.h"
 #include "ui/gfx/rect.h"
@@ -44,6 +52,63 @@ class Matcher {
   ui::ScaleFactor scale_factor_;
 };
 
+// Drops the image reps that sources generated, on memory pressure, from the
+// storages of the thread that it was created on, so that icons drawn once
+// through a CanvasImageSource don't stay resident at every scale factor. The
+// sources regenerate the reps on the next lookup.
+//
+// The reps are dropped from a task of their own, so no caller is in the
+// middle of a lookup; as before, callers must not hold on to the reps that
+// they look up, since any lookup may add reps and move the others.
+//
+// There is one evictor per thread that runs a message loop, created by the
+// first storage that generates a rep on that thread. It stops listening when
+// the message loop is destroyed but isn't deleted, since storages may still
+// unregister from it.
+class RepEvictor : public base::MessageLoop::DestructionObserver {
+ public:
+  // Returns the evictor of the current thread, creating it if needed, or NULL
+  // if the thread has no message loop to receive memory pressure signals.
+  static RepEvictor* GetForCurrentThread();
+
+  base::PlatformThreadId thread_id() const { return thread_id_; }
+
+  // Incremented each time memory pressure is signalled. Storages remember
+  // the generation in which they were last used, so that moderate pressure
+  // only evicts the reps of the storages unused since the previous signal.
+  int generation() const { return generation_; }
+
+  void Register(ImageSkiaStorage* storage);
+  void Unregister(ImageSkiaStorage* storage);
+
+  // base::MessageLoop::DestructionObserver implementation.
+  virtual void WillDestroyCurrentMessageLoop() OVERRIDE;
+
+ private:
+  RepEvictor();
+  virtual ~RepEvictor();
+
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
+  const base::PlatformThreadId thread_id_;
+  int generation_;
+
+  // Storages may be released on other threads, so |storages_| is guarded.
+  base::Lock lock_;
+  std::set<ImageSkiaStorage*> storages_;
+
+  scoped_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
+  DISALLOW_COPY_AND_ASSIGN(RepEvictor);
+};
+
+// Guards the evictors of the threads, as storages are created on any thread.
+base::LazyInstance<base::Lock>::Leaky g_rep_evictors_lock =
+    LAZY_INSTANCE_INITIALIZER;
+base::LazyInstance<std::set<RepEvictor*> >::Leaky g_rep_evictors =
+    LAZY_INSTANCE_INITIALIZER;
+
 }  // namespace
 
 // A helper class such that ImageSkia can be cheaply copied. ImageSkia holds a
@@ -58,12 +123,16 @@ class ImageSkiaStorage : public base::RefCountedThreadSafe<ImageSkiaStorage>,
   ImageSkiaStorage(ImageSkiaSource* source, const gfx::Size& size)
       : source_(source),
         size_(size),
-        read_only_(false) {
+        read_only_(false),
+        evictor_(NULL),
+        last_used_generation_(0) {
   }
 
   ImageSkiaStorage(ImageSkiaSource* source, ui::ScaleFactor scale_factor)
       : source_(source),
-        read_only_(false) {
+        read_only_(false),
+        evictor_(NULL),
+        last_used_generation_(0) {
     ImageSkia::ImageSkiaReps::iterator it =
         FindRepresentation(scale_factor, true);
     if (it == image_reps_.end() || it->is_null())
@@ -102,6 +171,32 @@ class ImageSkiaStorage : public base::RefCountedThreadSafe<ImageSkiaStorage>,
     return (read_only_ && !source_.get()) || CalledOnValidThread();
   }
 
+  int last_used_generation() const { return last_used_generation_; }
+
+  // Removes the image reps that the source generated, and the null reps
+  // marking the scale factors that it has no image for, so that the source
+  // is asked again on the next lookup. Returns the number of bytes of pixels
+  // released. Does nothing once the source is gone, as the reps could not be
+  // regenerated, or once the storage is read-only, as it may have been
+  // passed to another thread.
+  size_t EvictGeneratedReps() {
+    if (!source_.get() || read_only_)
+      return 0;
+    DCHECK(CalledOnValidThread());
+    size_t evicted_bytes = 0;
+    ImageSkia::ImageSkiaReps::iterator it = image_reps_.begin();
+    while (it != image_reps_.end()) {
+      if (generated_scale_factors_.count(it->scale_factor())) {
+        evicted_bytes += it->sk_bitmap().getSize();
+        it = image_reps_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    generated_scale_factors_.clear();
+    return evicted_bytes;
+  }
+
   // Returns the iterator of the image rep whose density best matches
   // |scale_factor|. If the image for the |scale_factor| doesn't exist
   // in the storage and |storage| is set, it fetches new image by calling
@@ -136,6 +231,9 @@ class ImageSkiaStorage : public base::RefCountedThreadSafe<ImageSkiaStorage>,
       }
     }
 
+    if (evictor_)
+      non_const->last_used_generation_ = evictor_->generation();
+
     if (fetch_new_image && source_.get()) {
       DCHECK(CalledOnValidThread()) <<
           "An ImageSkia with the source must be accessed by the same thread.";
@@ -147,6 +245,7 @@ class ImageSkiaStorage : public base::RefCountedThreadSafe<ImageSkiaStorage>,
           std::find_if(image_reps_.begin(), image_reps_.end(),
                        Matcher(image.scale_factor())) == image_reps_.end()) {
         non_const->image_reps().push_back(image);
+        non_const->generated_scale_factors_.insert(image.scale_factor());
       }
 
       // If the result image's scale factor isn't same as the expected
@@ -155,8 +254,12 @@ class ImageSkiaStorage : public base::RefCountedThreadSafe<ImageSkiaStorage>,
       if (image.is_null() || image.scale_factor() != scale_factor) {
         non_const->image_reps().push_back(
             ImageSkiaRep(SkBitmap(), scale_factor));
+        non_const->generated_scale_factors_.insert(scale_factor);
       }
 
+      if (!evictor_)
+        non_const->RegisterWithEvictor();
+
       // image_reps_ must have the exact much now, so find again.
       return FindRepresentation(scale_factor, false);
     }
@@ -165,11 +268,22 @@ class ImageSkiaStorage : public base::RefCountedThreadSafe<ImageSkiaStorage>,
 
  private:
   virtual ~ImageSkiaStorage() {
+    if (evictor_)
+      evictor_->Unregister(this);
     // We only care if the storage is modified by the same thread.
     // Don't blow up even if someone else deleted the ImageSkia.
     DetachFromThread();
   }
 
+  // Lets the evictor of the current thread drop the generated reps.
+  void RegisterWithEvictor() {
+    evictor_ = RepEvictor::GetForCurrentThread();
+    if (!evictor_)
+      return;
+    last_used_generation_ = evictor_->generation();
+    evictor_->Register(this);
+  }
+
   // Vector of bitmaps and their associated scale factor.
   std::vector<gfx::ImageSkiaRep> image_reps_;
 
@@ -180,9 +294,83 @@ class ImageSkiaStorage : public base::RefCountedThreadSafe<ImageSkiaStorage>,
 
   bool read_only_;
 
+  // Scale factors of the reps in |image_reps_| that came from |source_|.
+  std::set<ui::ScaleFactor> generated_scale_factors_;
+
+  // The evictor that may drop the generated reps, once there are some.
+  RepEvictor* evictor_;
+  int last_used_generation_;
+
   friend class base::RefCountedThreadSafe<ImageSkiaStorage>;
 };
 
+namespace {
+
+// static
+RepEvictor* RepEvictor::GetForCurrentThread() {
+  if (!base::MessageLoop::current())
+    return NULL;
+  base::AutoLock lock(g_rep_evictors_lock.Get());
+  const base::PlatformThreadId thread_id = base::PlatformThread::CurrentId();
+  std::set<RepEvictor*>& evictors = g_rep_evictors.Get();
+  for (std::set<RepEvictor*>::iterator it = evictors.begin();
+       it != evictors.end(); ++it) {
+    if ((*it)->thread_id() == thread_id)
+      return *it;
+  }
+  RepEvictor* evictor = new RepEvictor;
+  evictors.insert(evictor);
+  return evictor;
+}
+
+RepEvictor::RepEvictor()
+    : thread_id_(base::PlatformThread::CurrentId()),
+      generation_(0),
+      memory_pressure_listener_(new base::MemoryPressureListener(
+          base::Bind(&RepEvictor::OnMemoryPressure, base::Unretained(this)))) {
+  base::MessageLoop::current()->AddDestructionObserver(this);
+}
+
+RepEvictor::~RepEvictor() {
+}
+
+void RepEvictor::Register(ImageSkiaStorage* storage) {
+  base::AutoLock lock(lock_);
+  storages_.insert(storage);
+}
+
+void RepEvictor::Unregister(ImageSkiaStorage* storage) {
+  base::AutoLock lock(lock_);
+  storages_.erase(storage);
+}
+
+void RepEvictor::WillDestroyCurrentMessageLoop() {
+  memory_pressure_listener_.reset();
+  base::AutoLock lock(g_rep_evictors_lock.Get());
+  g_rep_evictors.Get().erase(this);
+}
+
+void RepEvictor::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  size_t evicted_bytes = 0;
+  {
+    base::AutoLock lock(lock_);
+    for (std::set<ImageSkiaStorage*>::iterator it = storages_.begin();
+         it != storages_.end(); ++it) {
+      if (level == base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL ||
+          (*it)->last_used_generation() < generation_) {
+        evicted_bytes += (*it)->EvictGeneratedReps();
+      }
+    }
+    ++generation_;
+  }
+  // The pixels are only released if nothing else refers to them, so this is
+  // an upper bound of the memory returned.
+  UMA_HISTOGRAM_MEMORY_KB("ImageSkia.EvictedRepsKB", evicted_bytes / 1024);
+}
+
+}  // namespace
+
 }  // internal
 
 ImageSkia::ImageSkia() : storage_(NULL) {
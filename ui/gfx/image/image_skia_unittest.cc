@@ -5,6 +5,8 @@
 #include "ui/gfx/image/image_skia.h"
 
 #include "base/logging.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/message_loop/message_loop.h"
 #include "base/threading/simple_thread.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/skia/include/core/SkBitmap.h"
@@ -170,6 +172,41 @@ TEST(ImageSkiaTest, DynamicSource) {
   EXPECT_EQ(2U, image_skia.image_reps().size());
 }
 
+// Tests that memory pressure drops the reps generated by the source, which
+// are generated again when needed, and keeps the ones added explicitly.
+TEST(ImageSkiaTest, EvictGeneratedReps) {
+  base::MessageLoop message_loop;
+  ImageSkia image_skia(new DynamicSource(Size(100, 200)), Size(100, 200));
+  image_skia.GetRepresentation(ui::SCALE_FACTOR_100P);
+  EXPECT_EQ(1U, image_skia.image_reps().size());
+
+  // Moderate pressure only evicts the reps of images that haven't been used
+  // since the previous signal.
+  base::MemoryPressureListener::NotifyMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_MODERATE);
+  message_loop.RunUntilIdle();
+  EXPECT_EQ(1U, image_skia.image_reps().size());
+  base::MemoryPressureListener::NotifyMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_MODERATE);
+  message_loop.RunUntilIdle();
+  EXPECT_EQ(0U, image_skia.image_reps().size());
+
+  const ImageSkiaRep& result_100p =
+      image_skia.GetRepresentation(ui::SCALE_FACTOR_100P);
+  EXPECT_EQ(ui::SCALE_FACTOR_100P, result_100p.scale_factor());
+  EXPECT_EQ(1U, image_skia.image_reps().size());
+
+  // Critical pressure evicts all the generated reps.
+  image_skia.AddRepresentation(
+      ImageSkiaRep(Size(100, 200), ui::SCALE_FACTOR_200P));
+  base::MemoryPressureListener::NotifyMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL);
+  message_loop.RunUntilIdle();
+  ASSERT_EQ(1U, image_skia.image_reps().size());
+  EXPECT_EQ(ui::SCALE_FACTOR_200P,
+            image_skia.image_reps()[0].scale_factor());
+}
+
 // Tests that image_reps returns all of the representations in the
 // image when there are multiple representations for a scale factor.
 // This currently is the case with ImageLoader::LoadImages.
@@ -44,6 +44,11 @@ const SkScalar kLineThickness = (SK_Scalar1 / 18);
 // Fraction of the text size to use for a top margin of a diagonal strike.
 const SkScalar kDiagonalStrikeMarginOffset = (SK_Scalar1 / 4);
 
+// Lookups in the shaping cache of the platform implementation that did and
+// didn't find the text already laid out.
+size_t g_shaping_cache_hits = 0;
+size_t g_shaping_cache_misses = 0;
+
 // Converts |gfx::Font::FontStyle| flags to |SkTypeface::Style| flags.
 SkTypeface::Style ConvertFontStyleToSkiaTypefaceStyle(int font_style) {
   int skia_style = SkTypeface::kNormal;
@@ -306,6 +311,12 @@ void StyleIterator::UpdatePosition(size_t position) {
 RenderText::~RenderText() {
 }
 
+// static
+void RenderText::GetShapingCacheStats(size_t* hits, size_t* misses) {
+  *hits = g_shaping_cache_hits;
+  *misses = g_shaping_cache_misses;
+}
+
 void RenderText::SetText(const base::string16& text) {
   DCHECK(!composition_range_.IsValid());
   text_ = text;
@@ -818,6 +829,14 @@ const base::string16& RenderText::GetLayoutText() const {
   return layout_text_.empty() ? text_ : layout_text_;
 }
 
+// static
+void RenderText::RecordShapingCacheLookup(bool hit) {
+  if (hit)
+    ++g_shaping_cache_hits;
+  else
+    ++g_shaping_cache_misses;
+}
+
 void RenderText::ApplyCompositionAndSelectionStyles() {
   // Save the underline and color breaks to undo the temporary styles later.
   DCHECK(!composition_and_selection_styles_applied_);
@@ -124,6 +124,10 @@ class UI_EXPORT RenderText {
   // Creates a platform-specific RenderText instance.
   static RenderText* CreateInstance();
 
+  // Returns how many layouts were found in, and missing from, the
+  // process-wide cache of shaped text kept by the platform implementation.
+  static void GetShapingCacheStats(size_t* hits, size_t* misses);
+
   const base::string16& text() const { return text_; }
   void SetText(const base::string16& text);
 
@@ -415,6 +419,9 @@ class UI_EXPORT RenderText {
   // Returns the text used for layout, which may be obscured or truncated.
   const base::string16& GetLayoutText() const;
 
+  // Counts a lookup in the platform implementation's shaping cache.
+  static void RecordShapingCacheLookup(bool hit);
+
   // Apply (and undo) temporary composition underlines and selection colors.
   void ApplyCompositionAndSelectionStyles();
   void UndoCompositionAndSelectionStyles();
@@ -9,8 +9,12 @@
 #include <string>
 #include <vector>
 
+#include "base/containers/mru_cache.h"
 #include "base/i18n/break_iterator.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
 #include "third_party/skia/include/core/SkTypeface.h"
 #include "ui/base/text/utf16_indexing.h"
 #include "ui/gfx/canvas.h"
@@ -22,6 +26,34 @@ namespace gfx {
 
 namespace {
 
+// The number of laid out strings kept in the process-wide layout cache.
+const size_t kMaxCachedLayouts = 256;
+
+// Releases the reference that the layout cache holds on an evicted layout.
+class LayoutUnreffer {
+ public:
+  void operator()(PangoLayout*& layout) {
+    g_object_unref(layout);
+  }
+};
+
+typedef base::MRUCacheBase<std::string, PangoLayout*, LayoutUnreffer,
+                           base::MRUCacheHashMap> LayoutCacheBase;
+
+// Process-wide cache of recently laid out text, keyed by the text, fonts,
+// direction and font styles that determine its itemization and shaping. Tab
+// strips, omnibox popups and the app list lay out the same strings over and
+// over; since a layout isn't modified once set up, the instances showing the
+// same string share it by reference instead of having Pango shape it again.
+// The font render params are process-wide and aren't part of the key.
+class LayoutCache : public LayoutCacheBase {
+ public:
+  LayoutCache() : LayoutCacheBase(kMaxCachedLayouts) {}
+};
+
+base::LazyInstance<LayoutCache>::Leaky g_layout_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
 // Returns the preceding element in a GSList (O(n)).
 GSList* GSListPrevious(GSList* head, GSList* item) {
   GSList* prev = NULL;
@@ -304,31 +336,45 @@ void RenderTextLinux::ResetLayout() {
 
 void RenderTextLinux::EnsureLayout() {
   if (layout_ == NULL) {
-    cairo_surface_t* surface =
-        cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 0, 0);
-    cairo_t* cr = cairo_create(surface);
-
-    layout_ = pango_cairo_create_layout(cr);
-    cairo_destroy(cr);
-    cairo_surface_destroy(surface);
-
-    SetupPangoLayoutWithFontDescription(layout_,
-                                        GetLayoutText(),
-                                        font_list().GetFontDescriptionString(),
-                                        0,
-                                        GetTextDirection(),
-                                        Canvas::DefaultCanvasTextAlignment());
-
-    // No width set so that the x-axis position is relative to the start of the
-    // text. ToViewPoint and ToTextPoint take care of the position conversion
-    // between text space and view spaces.
-    pango_layout_set_width(layout_, -1);
-    // TODO(xji): If RenderText will be used for displaying purpose, such as
-    // label, we will need to remove the single-line-mode setting.
-    pango_layout_set_single_paragraph_mode(layout_, true);
-
-    layout_text_ = pango_layout_get_text(layout_);
-    SetupPangoAttributes(layout_);
+    const std::string cache_key = GetLayoutCacheKey();
+    LayoutCache* cache = g_layout_cache.Pointer();
+    LayoutCache::iterator cached = cache->Get(cache_key);
+    RecordShapingCacheLookup(cached != cache->end());
+    if (cached != cache->end()) {
+      layout_ = cached->second;
+      g_object_ref(layout_);
+      layout_text_ = pango_layout_get_text(layout_);
+    } else {
+      cairo_surface_t* surface =
+          cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 0, 0);
+      cairo_t* cr = cairo_create(surface);
+
+      layout_ = pango_cairo_create_layout(cr);
+      cairo_destroy(cr);
+      cairo_surface_destroy(surface);
+
+      SetupPangoLayoutWithFontDescription(
+          layout_,
+          GetLayoutText(),
+          font_list().GetFontDescriptionString(),
+          0,
+          GetTextDirection(),
+          Canvas::DefaultCanvasTextAlignment());
+
+      // No width set so that the x-axis position is relative to the start of
+      // the text. ToViewPoint and ToTextPoint take care of the position
+      // conversion between text space and view spaces.
+      pango_layout_set_width(layout_, -1);
+      // TODO(xji): If RenderText will be used for displaying purpose, such as
+      // label, we will need to remove the single-line-mode setting.
+      pango_layout_set_single_paragraph_mode(layout_, true);
+
+      layout_text_ = pango_layout_get_text(layout_);
+      SetupPangoAttributes(layout_);
+
+      g_object_ref(layout_);
+      cache->Put(cache_key, layout_);
+    }
 
     current_line_ = pango_layout_get_line_readonly(layout_, 0);
     pango_layout_line_ref(current_line_);
@@ -337,6 +383,28 @@ void RenderTextLinux::EnsureLayout() {
   }
 }
 
+std::string RenderTextLinux::GetLayoutCacheKey() {
+  std::string key = UTF16ToUTF8(GetLayoutText());
+  base::StringAppendF(&key, "\n%s\n%d",
+                      font_list().GetFontDescriptionString().c_str(),
+                      GetTextDirection());
+  // Only the bold and italic styles affect the layout; see
+  // SetupPangoAttributes().
+  const BreakList<bool>& bold = styles()[BOLD];
+  for (BreakList<bool>::const_iterator it = bold.breaks().begin();
+       it != bold.breaks().end(); ++it) {
+    base::StringAppendF(&key, "\nb%d:%d", static_cast<int>(it->first),
+                        it->second);
+  }
+  const BreakList<bool>& italic = styles()[ITALIC];
+  for (BreakList<bool>::const_iterator it = italic.breaks().begin();
+       it != italic.breaks().end(); ++it) {
+    base::StringAppendF(&key, "\ni%d:%d", static_cast<int>(it->first),
+                        it->second);
+  }
+  return key;
+}
+
 void RenderTextLinux::SetupPangoAttributes(PangoLayout* layout) {
   PangoAttrList* attrs = pango_attr_list_new();
 
@@ -6,6 +6,7 @@
 #define UI_GFX_RENDER_TEXT_LINUX_H_
 
 #include <pango/pango.h>
+#include <string>
 #include <vector>
 
 #include "ui/gfx/render_text.h"
@@ -55,6 +56,9 @@ class RenderTextLinux : public RenderText {
   SelectionModel FirstSelectionModelInsideRun(const PangoItem* run);
   SelectionModel LastSelectionModelInsideRun(const PangoItem* run);
 
+  // Returns the key of the current layout in the process-wide layout cache.
+  std::string GetLayoutCacheKey();
+
   // Setup pango attribute: foreground, background, font, strike.
   void SetupPangoAttributes(PangoLayout* layout);
 
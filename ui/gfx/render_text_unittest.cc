@@ -229,6 +229,40 @@ TEST_F(RenderTextTest, PangoAttributes) {
 }
 #endif
 
+#if !defined(OS_MACOSX)
+TEST_F(RenderTextTest, ShapingCache) {
+  const base::string16 text = ASCIIToUTF16("Shaping cache test");
+  size_t hits = 0, misses = 0;
+  RenderText::GetShapingCacheStats(&hits, &misses);
+
+  // The first layout of the text shapes it.
+  scoped_ptr<RenderText> first(RenderText::CreateInstance());
+  first->SetText(text);
+  const Size first_size = first->GetStringSize();
+  size_t new_hits = 0, new_misses = 0;
+  RenderText::GetShapingCacheStats(&new_hits, &new_misses);
+  EXPECT_EQ(hits, new_hits);
+  EXPECT_LT(misses, new_misses);
+
+  // Another instance laying out the same text finds it in the cache.
+  scoped_ptr<RenderText> second(RenderText::CreateInstance());
+  second->SetText(text);
+  EXPECT_EQ(first_size.ToString(), second->GetStringSize().ToString());
+  hits = new_hits;
+  misses = new_misses;
+  RenderText::GetShapingCacheStats(&new_hits, &new_misses);
+  EXPECT_LT(hits, new_hits);
+  EXPECT_EQ(misses, new_misses);
+
+  // Styles that affect shaping are part of the key.
+  second->ApplyStyle(BOLD, true, ui::Range(0, 7));
+  second->GetStringSize();
+  misses = new_misses;
+  RenderText::GetShapingCacheStats(&new_hits, &new_misses);
+  EXPECT_LT(misses, new_misses);
+}
+#endif  // !defined(OS_MACOSX)
+
 // TODO(asvitkine): Cursor movements tests disabled on Mac because RenderTextMac
 //                  does not implement this yet. http://crbug.com/131618
 #if !defined(OS_MACOSX)
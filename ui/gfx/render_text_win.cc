@@ -6,10 +6,13 @@
 
 #include <algorithm>
 
+#include "base/containers/mru_cache.h"
 #include "base/i18n/break_iterator.h"
 #include "base/i18n/rtl.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/win/windows_version.h"
 #include "ui/base/text/utf16_indexing.h"
@@ -35,6 +38,24 @@ const size_t kMaxRuns = 10000;
 // The maximum number of glyphs per run; ScriptShape fails on larger values.
 const size_t kMaxGlyphs = 65535;
 
+// The number of shaped runs kept in the process-wide shaping cache.
+const size_t kMaxCachedRuns = 1024;
+
+// Process-wide cache of the glyphs and placement of recently laid out runs,
+// keyed by what they were shaped from. Tab strips, omnibox popups and the app
+// list lay out the same strings over and over, and each miss costs a round of
+// ScriptShape() and ScriptPlace(), plus font fallback for missing glyphs.
+class ShapedRunCache : public base::OwningMRUCache<std::string,
+                                                   internal::TextRun*> {
+ public:
+  ShapedRunCache()
+      : base::OwningMRUCache<std::string, internal::TextRun*>(kMaxCachedRuns) {
+  }
+};
+
+base::LazyInstance<ShapedRunCache>::Leaky g_shaped_run_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
 // Callback to |EnumEnhMetaFile()| to intercept font creation.
 int CALLBACK MetaFileEnumProc(HDC hdc,
                               HANDLETABLE* table,
@@ -118,6 +139,53 @@ void DeriveFontIfNecessary(int font_size,
     *font = font->DeriveFont(font_size - current_size, target_style);
 }
 
+// Returns the key of the itemized but not yet shaped |run| of |layout_text| in
+// the shaping cache: its text, script analysis, font and font style.
+std::string GetShapedRunCacheKey(const internal::TextRun& run,
+                                 const base::string16& layout_text) {
+  std::string key(
+      reinterpret_cast<const char*>(&layout_text[run.range.start()]),
+      run.range.length() * sizeof(char16));
+  key.append(reinterpret_cast<const char*>(&run.script_analysis),
+             sizeof(run.script_analysis));
+  base::StringAppendF(&key, "%s:%d:%d:%d", run.font.GetFontName().c_str(),
+                      run.font.GetFontSize(), run.font.GetHeight(),
+                      run.font_style);
+  return key;
+}
+
+// Copies the results of shaping and placing |source| to |dest|, which must
+// span the same text. The Uniscribe cache of |dest| is left as it is.
+void CopyShapedRun(const internal::TextRun& source, internal::TextRun* dest) {
+  DCHECK_EQ(source.range.length(), dest->range.length());
+  const size_t run_length = source.range.length();
+  const size_t glyph_count = source.glyph_count;
+  dest->font = source.font;
+  dest->script_analysis = source.script_analysis;
+  dest->glyph_count = source.glyph_count;
+  dest->glyphs.reset(new WORD[glyph_count]);
+  std::copy(source.glyphs.get(), source.glyphs.get() + glyph_count,
+            dest->glyphs.get());
+  dest->logical_clusters.reset(new WORD[run_length]);
+  std::copy(source.logical_clusters.get(),
+            source.logical_clusters.get() + run_length,
+            dest->logical_clusters.get());
+  dest->visible_attributes.reset(new SCRIPT_VISATTR[glyph_count]);
+  std::copy(source.visible_attributes.get(),
+            source.visible_attributes.get() + glyph_count,
+            dest->visible_attributes.get());
+  if (glyph_count > 0) {
+    dest->advance_widths.reset(new int[glyph_count]);
+    std::copy(source.advance_widths.get(),
+              source.advance_widths.get() + glyph_count,
+              dest->advance_widths.get());
+    dest->offsets.reset(new GOFFSET[glyph_count]);
+    std::copy(source.offsets.get(), source.offsets.get() + glyph_count,
+              dest->offsets.get());
+  }
+  dest->abc_widths = source.abc_widths;
+}
+
 // Returns true if |c| is a Unicode BiDi control character.
 bool IsUnicodeBidiControlCharacter(char16 c) {
   return c == base::i18n::kRightToLeftMark ||
@@ -620,28 +688,41 @@ void RenderTextWin::LayoutVisualText() {
   // ensures that the text baseline does not shift.
   int ascent = font_list().GetBaseline();
   int descent = font_list().GetHeight() - font_list().GetBaseline();
+  ShapedRunCache* cache = g_shaped_run_cache.Pointer();
   for (size_t i = 0; i < runs_.size(); ++i) {
     internal::TextRun* run = runs_[i];
-    LayoutTextRun(run);
+    const std::string cache_key = GetShapedRunCacheKey(*run, GetLayoutText());
+    ShapedRunCache::iterator cached = cache->Get(cache_key);
+    RecordShapingCacheLookup(cached != cache->end());
+    if (cached != cache->end()) {
+      CopyShapedRun(*cached->second, run);
+    } else {
+      LayoutTextRun(run);
+
+      if (run->glyph_count > 0) {
+        run->advance_widths.reset(new int[run->glyph_count]);
+        run->offsets.reset(new GOFFSET[run->glyph_count]);
+        hr = ScriptPlace(cached_hdc_,
+                         &run->script_cache,
+                         run->glyphs.get(),
+                         run->glyph_count,
+                         run->visible_attributes.get(),
+                         &(run->script_analysis),
+                         run->advance_widths.get(),
+                         run->offsets.get(),
+                         &(run->abc_widths));
+        DCHECK(SUCCEEDED(hr));
+      }
+
+      internal::TextRun* shaped_run = new internal::TextRun();
+      shaped_run->range = run->range;
+      CopyShapedRun(*run, shaped_run);
+      cache->Put(cache_key, shaped_run);
+    }
 
     ascent = std::max(ascent, run->font.GetBaseline());
     descent = std::max(descent,
                        run->font.GetHeight() - run->font.GetBaseline());
-
-    if (run->glyph_count > 0) {
-      run->advance_widths.reset(new int[run->glyph_count]);
-      run->offsets.reset(new GOFFSET[run->glyph_count]);
-      hr = ScriptPlace(cached_hdc_,
-                       &run->script_cache,
-                       run->glyphs.get(),
-                       run->glyph_count,
-                       run->visible_attributes.get(),
-                       &(run->script_analysis),
-                       run->advance_widths.get(),
-                       run->offsets.get(),
-                       &(run->abc_widths));
-      DCHECK(SUCCEEDED(hr));
-    }
   }
   string_size_.set_height(ascent + descent);
   common_baseline_ = ascent;
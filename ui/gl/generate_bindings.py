@@ -695,6 +695,10 @@ GL_FUNCTIONS = [
   'names': ['glClientWaitSync'],
   'arguments':
     'GLsync sync, GLbitfield flags, GLuint64 timeout', },
+{ 'return_type': 'void',
+  'names': ['glWaitSync'],
+  'arguments':
+    'GLsync sync, GLbitfield flags, GLuint64 timeout', },
 { 'return_type': 'void',
   'names': ['glDrawArraysInstancedANGLE', 'glDrawArraysInstancedARB'],
   'arguments': 'GLenum mode, GLint first, GLsizei count, GLsizei primcount', },
@@ -930,6 +934,10 @@ EGL_FUNCTIONS = [
   'arguments': 'EGLDisplay dpy, EGLSyncKHR sync, EGLint flags, '
       'EGLTimeKHR timeout',
   'other_extensions': ['EGL_KHR_fence_sync'] },
+{ 'return_type': 'EGLint',
+  'names': ['eglWaitSyncKHR'],
+  'arguments': 'EGLDisplay dpy, EGLSyncKHR sync, EGLint flags',
+  'other_extensions': ['EGL_KHR_wait_sync'] },
 { 'return_type': 'EGLBoolean',
   'names': ['eglGetSyncAttribKHR'],
   'arguments': 'EGLDisplay dpy, EGLSyncKHR sync, EGLint attribute, '
@@ -36,6 +36,10 @@ class GLFenceNVFence: public gfx::GLFence {
     glFinishFenceNV(fence_);
   }
 
+  virtual void ServerWait() OVERRIDE {
+    ClientWait();
+  }
+
  private:
   virtual ~GLFenceNVFence() {
     glDeleteFencesNV(1, &fence_);
@@ -66,6 +70,11 @@ class GLFenceARBSync: public gfx::GLFence {
     glClientWaitSync(sync_, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
   }
 
+  virtual void ServerWait() OVERRIDE {
+    if (sync_)
+      glWaitSync(sync_, 0, GL_TIMEOUT_IGNORED);
+  }
+
  private:
   virtual ~GLFenceARBSync() {
     glDeleteSync(sync_);
@@ -95,6 +104,14 @@ class EGLFenceSync : public gfx::GLFence {
     eglClientWaitSyncKHR(display_, sync_, flags, time);
   }
 
+  virtual void ServerWait() OVERRIDE {
+    if (!gfx::g_driver_egl.ext.b_EGL_KHR_wait_sync) {
+      ClientWait();
+      return;
+    }
+    eglWaitSyncKHR(display_, sync_, 0);
+  }
+
  private:
   virtual ~EGLFenceSync() {
     eglDestroySyncKHR(display_, sync_);
@@ -115,6 +132,27 @@ GLFence::GLFence() {
 GLFence::~GLFence() {
 }
 
+// static
+bool GLFence::IsSupported() {
+#if !defined(OS_MACOSX)
+  if (gfx::g_driver_egl.ext.b_EGL_KHR_fence_sync)
+    return true;
+#endif
+  return gfx::g_driver_gl.ext.b_GL_NV_fence ||
+         gfx::g_driver_gl.ext.b_GL_ARB_sync;
+}
+
+// static
+bool GLFence::IsSupportedAcrossContexts() {
+  // NV fences belong to the context that set them.
+#if !defined(OS_MACOSX)
+  if (gfx::g_driver_egl.ext.b_EGL_KHR_fence_sync)
+    return true;
+#endif
+  return !gfx::g_driver_gl.ext.b_GL_NV_fence &&
+         gfx::g_driver_gl.ext.b_GL_ARB_sync;
+}
+
 // static
 GLFence* GLFence::Create() {
 #if !defined(OS_MACOSX)
@@ -15,9 +15,18 @@ class GL_EXPORT GLFence {
   GLFence();
   virtual ~GLFence();
 
+  // Returns true if Create() can make a fence in the current context.
+  static bool IsSupported();
+  // Returns true if the fences from Create() can be waited on in any context
+  // of the share group, not just in the one that created them.
+  static bool IsSupportedAcrossContexts();
   static GLFence* Create();
   virtual bool HasCompleted() = 0;
   virtual void ClientWait() = 0;
+  // Makes the GPU wait for the fence before it executes the commands issued
+  // afterwards in the current context. Falls back to ClientWait() when the
+  // driver can't wait on the GPU.
+  virtual void ServerWait() = 0;
 
  protected:
   static bool IsContextLost();
@@ -15,6 +15,7 @@
 #include "base/message_loop/message_loop.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
+#include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkRect.h"
 #include "ui/base/accessibility/accessibility_types.h"
 #include "ui/base/dragdrop/drag_drop_types.h"
@@ -176,6 +177,8 @@ View::View()
       focus_border_(FocusBorder::CreateDashedFocusBorder()),
       flip_canvas_on_paint_for_rtl_ui_(false),
       paint_to_layer_(false),
+      paint_cached_(false),
+      paint_cache_scale_factor_(ui::SCALE_FACTOR_NONE),
       accelerator_registration_delayed_(false),
       accelerator_focus_manager_(NULL),
       registered_accelerator_count_(0),
@@ -245,6 +248,7 @@ void View::AddChildViewAt(View* view, int index) {
   // Let's insert the view.
   view->parent_ = this;
   children_.insert(children_.begin() + index, view);
+  InvalidatePaintCache();
 
   ViewHierarchyChangedDetails details(true, this, view, parent);
 
@@ -298,6 +302,7 @@ void View::ReorderChildView(View* view, int index) {
   // Add it in the specified index now.
   InitFocusSiblings(view, index);
   children_.insert(children_.begin() + index, view);
+  InvalidatePaintCache();
 
   if (use_acceleration_when_possible)
     ReorderLayers();
@@ -530,6 +535,13 @@ void View::SetPaintToLayer(bool paint_to_layer) {
   }
 }
 
+void View::SetPaintCached(bool paint_cached) {
+  if (paint_cached == paint_cached_)
+    return;
+  paint_cached_ = paint_cached;
+  InvalidatePaintCache();
+}
+
 ui::Layer* View::RecreateLayer() {
   ui::Layer* layer = AcquireLayer();
   if (!layer)
@@ -763,6 +775,8 @@ void View::SchedulePaint() {
 }
 
 void View::SchedulePaintInRect(const gfx::Rect& rect) {
+  InvalidatePaintCache();
+
   if (!visible_)
     return;
 
@@ -1741,6 +1755,28 @@ void View::PaintCommon(gfx::Canvas* canvas) {
   if (!visible_)
     return;
 
+  if (!paint_cached_) {
+    PaintSelfAndChildren(canvas);
+    return;
+  }
+
+  if (!paint_cache_ || paint_cache_scale_factor_ != canvas->scale_factor()) {
+    TRACE_EVENT1("views", "View::RecordPaint", "class", GetClassName());
+    // The recording is in DIPs; the scale of |canvas| applies on replay, and
+    // its scale factor only selects the image reps to record.
+    paint_cache_ = skia::AdoptRef(new SkPicture);
+    SkCanvas* recording_canvas =
+        paint_cache_->beginRecording(width(), height());
+    scoped_ptr<gfx::Canvas> recording(gfx::Canvas::CreateCanvasWithoutScaling(
+        recording_canvas, canvas->scale_factor()));
+    PaintSelfAndChildren(recording.get());
+    paint_cache_->endRecording();
+    paint_cache_scale_factor_ = canvas->scale_factor();
+  }
+  canvas->sk_canvas()->drawPicture(*paint_cache_);
+}
+
+void View::PaintSelfAndChildren(gfx::Canvas* canvas) {
   {
     // If the View we are about to paint requested the canvas to be flipped, we
     // should change the transform appropriately.
@@ -1759,6 +1795,16 @@ void View::PaintCommon(gfx::Canvas* canvas) {
   PaintChildren(canvas);
 }
 
+void View::InvalidatePaintCache() {
+  // A View painting to a layer paints its subtree there, and is not part of
+  // what its ancestors record.
+  for (View* v = this; v; v = v->parent_) {
+    v->paint_cache_.clear();
+    if (v->layer())
+      break;
+  }
+}
+
 // Tree operations -------------------------------------------------------------
 
 void View::DoRemoveChildView(View* view,
@@ -1790,6 +1836,7 @@ void View::DoRemoveChildView(View* view,
       view_to_be_deleted.reset(view);
 
     children_.erase(i);
+    InvalidatePaintCache();
   }
 
   if (update_tool_tip)
@@ -1868,6 +1915,7 @@ void View::ViewHierarchyChangedImpl(
 void View::PropagateNativeThemeChanged(const ui::NativeTheme* theme) {
   for (int i = 0, count = child_count(); i < count; ++i)
     child_at(i)->PropagateNativeThemeChanged(theme);
+  paint_cache_.clear();
   OnNativeThemeChanged(theme);
 }
 
@@ -2292,6 +2340,7 @@ void View::InitFocusSiblings(View* v, int index) {
 void View::PropagateThemeChanged() {
   for (int i = child_count() - 1; i >= 0; --i)
     child_at(i)->PropagateThemeChanged();
+  paint_cache_.clear();
   OnThemeChanged();
 }
 
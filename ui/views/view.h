@@ -16,6 +16,7 @@
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "build/build_config.h"
+#include "skia/ext/refptr.h"
 #include "ui/base/accelerators/accelerator.h"
 #include "ui/base/accessibility/accessibility_types.h"
 #include "ui/base/dragdrop/drag_drop_types.h"
@@ -38,6 +39,8 @@
 
 using ui::OSExchangeData;
 
+class SkPicture;
+
 namespace gfx {
 class Canvas;
 class Insets;
@@ -312,6 +315,15 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // Compositor.
   void SetPaintToLayer(bool paint_to_layer);
 
+  // Sets whether this view records what it and its descendants paint, and
+  // replays the recording instead of painting again until SchedulePaint() is
+  // called on it or on a descendant. As with views painting to a layer, a
+  // view caching its paint must schedule a paint when its appearance changes.
+  // Caching the individual items of a container, rather than the container,
+  // keeps a hovered item from invalidating its siblings.
+  void SetPaintCached(bool paint_cached);
+  bool paint_cached() const { return paint_cached_; }
+
   // Recreates a layer for the view and returns the old layer. After this call,
   // the View no longer has a pointer to the old layer (so it won't be able to
   // update the old layer or destroy it). The caller must free the returned
@@ -1234,6 +1246,14 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // invoke OnPaint() on the View.
   void PaintCommon(gfx::Canvas* canvas);
 
+  // Invokes OnPaint() and paints the children, which PaintCommon() either
+  // does directly or records when the paint is cached.
+  void PaintSelfAndChildren(gfx::Canvas* canvas);
+
+  // Drops the recorded paint of this View and of its ancestors, which include
+  // it in theirs.
+  void InvalidatePaintCache();
+
   // Tree operations -----------------------------------------------------------
 
   // Removes |view| from the hierarchy tree.  If |update_focus_cycle| is true,
@@ -1501,6 +1521,14 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
 
   bool paint_to_layer_;
 
+  // Paint caching --------------------------------------------------------------
+
+  bool paint_cached_;
+
+  // The recorded paint, if any, and the scale factor it was recorded at.
+  skia::RefPtr<SkPicture> paint_cache_;
+  ui::ScaleFactor paint_cache_scale_factor_;
+
   // Accelerators --------------------------------------------------------------
 
   // true if when we were added to hierarchy we were without focus manager
@@ -775,6 +775,69 @@ void CheckRect(const SkRect& check_rect, const SkRect& target_rect) {
   EXPECT_EQ(target_rect.fBottom, check_rect.fBottom);
 }
 
+// A view that counts the calls to OnPaint().
+class PaintCountView : public View {
+ public:
+  PaintCountView() : paint_count_(0) {}
+  virtual ~PaintCountView() {}
+
+  int paint_count() const { return paint_count_; }
+
+  virtual void OnPaint(gfx::Canvas* canvas) OVERRIDE {
+    ++paint_count_;
+  }
+
+ private:
+  int paint_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(PaintCountView);
+};
+
+// Tests that a view caching its paint replays it until it or a descendant
+// schedules a paint, and that a sibling scheduling a paint doesn't affect it.
+TEST_F(ViewTest, PaintCached) {
+  View root;
+  root.SetBoundsRect(gfx::Rect(0, 0, 100, 100));
+  PaintCountView* cached = new PaintCountView;
+  cached->SetBoundsRect(gfx::Rect(0, 0, 50, 50));
+  cached->SetPaintCached(true);
+  root.AddChildView(cached);
+  PaintCountView* child = new PaintCountView;
+  child->SetBoundsRect(gfx::Rect(10, 10, 20, 20));
+  cached->AddChildView(child);
+  PaintCountView* sibling = new PaintCountView;
+  sibling->SetBoundsRect(gfx::Rect(50, 50, 50, 50));
+  root.AddChildView(sibling);
+
+  gfx::Canvas canvas(gfx::Size(100, 100), ui::SCALE_FACTOR_100P, true);
+  root.Paint(&canvas);
+  EXPECT_EQ(1, cached->paint_count());
+  EXPECT_EQ(1, child->paint_count());
+
+  root.Paint(&canvas);
+  EXPECT_EQ(1, cached->paint_count());
+  EXPECT_EQ(1, child->paint_count());
+
+  sibling->SchedulePaint();
+  root.Paint(&canvas);
+  EXPECT_EQ(1, cached->paint_count());
+  EXPECT_EQ(3, sibling->paint_count());
+
+  child->SchedulePaint();
+  root.Paint(&canvas);
+  EXPECT_EQ(2, cached->paint_count());
+  EXPECT_EQ(2, child->paint_count());
+
+  // Painting at another scale factor records again.
+  gfx::Canvas canvas_2x(gfx::Size(100, 100), ui::SCALE_FACTOR_200P, true);
+  root.Paint(&canvas_2x);
+  EXPECT_EQ(3, cached->paint_count());
+
+  cached->SetPaintCached(false);
+  root.Paint(&canvas);
+  EXPECT_EQ(4, cached->paint_count());
+}
+
 /* This test is disabled because it is flakey on some systems.
 TEST_F(ViewTest, DISABLED_Painting) {
   // Determine if InvalidateRect generates an empty paint rectangle.
@@ -15,6 +15,7 @@
 #include "ui/base/resource/resource_bundle.h"
 #include "ui/compositor/compositor.h"
 #include "ui/compositor/layer.h"
+#include "ui/gfx/canvas.h"
 #include "ui/gfx/screen.h"
 #include "ui/views/focus/focus_manager.h"
 #include "ui/views/focus/focus_manager_factory.h"
@@ -1078,8 +1079,13 @@ bool Widget::OnNativeWidgetPaintAccelerated(const gfx::Rect& dirty_region) {
 void Widget::OnNativeWidgetPaint(gfx::Canvas* canvas) {
   // On Linux Aura, we can get here during Init() because of the
   // SetInitialBounds call.
-  if (native_widget_initialized_)
-    GetRootView()->Paint(canvas);
+  if (!native_widget_initialized_)
+    return;
+  gfx::Rect paint_rect;
+  canvas->GetClipBounds(&paint_rect);
+  TRACE_EVENT1("views", "Widget::OnNativeWidgetPaint",
+               "area", paint_rect.width() * paint_rect.height());
+  GetRootView()->Paint(canvas);
 }
 
 int Widget::GetNonClientComponent(const gfx::Point& point) {
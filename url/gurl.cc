@@ -14,6 +14,7 @@
 #include "url/gurl.h"
 
 #include "base/logging.h"
+#include "url/url_canon.h"
 #include "url/url_canon_stdstring.h"
 #include "url/url_util.h"
 
@@ -95,6 +96,22 @@ GURL::GURL(const GURL& other)
 }
 
 GURL::GURL(const std::string& url_string) : inner_url_(NULL) {
+  // Most URLs are already canonical, and those can share the caller's string
+  // rather than being canonicalized into a new one.
+  if (url_canon::IsCanonicalStandardURL(
+          url_string.data(), static_cast<int>(url_string.length()),
+          &parsed_)) {
+    spec_ = url_string;
+    is_valid_ = true;
+#ifndef NDEBUG
+    std::string canonical;
+    url_parse::Parsed parsed;
+    DCHECK(InitCanonical(url_string, &canonical, &parsed));
+    DCHECK_EQ(canonical, spec_);
+#endif
+    return;
+  }
+
   is_valid_ = InitCanonical(url_string, &spec_, &parsed_);
   if (is_valid_ && SchemeIsFileSystem()) {
     inner_url_ =
@@ -0,0 +1,139 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/perftimer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+#include "url/url_canon.h"
+#include "url/url_canon_stdstring.h"
+#include "url/url_util.h"
+
+namespace {
+
+const int kIterations = 20000;
+
+// URLs of the kind that come back from the renderer: links, subresources and
+// XHRs of popular pages, which are nearly always canonical already.
+const char* const kCanonicalURLs[] = {
+  "http://www.google.com/",
+  "https://www.google.com/search?q=chromium+url+canonicalization&oq=chromium"
+      "&sourceid=chrome&ie=UTF-8",
+  "http://www.gstatic.com/images/branding/product/1x/chrome_48dp.png",
+  "https://ssl.gstatic.com/gb/js/sem_4a5d3a3b1e0c1a3e.js",
+  "http://en.wikipedia.org/wiki/Uniform_resource_locator",
+  "http://en.wikipedia.org/wiki/Special:Search?search=url&go=Go",
+  "http://upload.wikimedia.org/wikipedia/commons/thumb/d/d6/"
+      "URI_syntax_diagram.svg/500px-URI_syntax_diagram.svg.png",
+  "http://bits.wikimedia.org/en.wikipedia.org/load.php?debug=false&lang=en"
+      "&modules=site&only=scripts&skin=vector&*",
+  "https://www.facebook.com/login.php?login_attempt=1",
+  "http://static.ak.fbcdn.net/rsrc.php/v2/yO/r/wlZAHwFMjJH.css",
+  "http://www.youtube.com/watch?v=dQw4w9WgXcQ&feature=related#t=42",
+  "http://i1.ytimg.com/vi/dQw4w9WgXcQ/default.jpg",
+  "http://www.amazon.com/gp/product/B00005JNOG/ref=s9_simh_gw_p14_d0_i1"
+      "?pf_rd_m=ATVPDKIKX0DER&pf_rd_s=center-2",
+  "http://g-ecx.images-amazon.com/images/G/01/gno/beacon/BeaconSprite-US-01"
+      "._V401903535_.png",
+  "http://news.ycombinator.com/item?id=5963398",
+  "http://www.nytimes.com/2013/07/01/technology/browsers.html?hp&_r=0",
+  "http://graphics8.nytimes.com/js/common/screen/DropDown.js",
+  "https://twitter.com/search?q=%23chromium&src=hash",
+  "http://stackoverflow.com/questions/2742813/how-to-validate-a-url/"
+      "2742868#2742868",
+  "http://cdn.sstatic.net/stackoverflow/all.css?v=b3f6e0c0f2ac",
+  "http://ajax.googleapis.com/ajax/libs/jquery/1.7.1/jquery.min.js",
+  "http://www.bing.com/search?q=%E6%97%A5%E6%9C%AC&go=&qs=n&form=QBLH",
+  "http://maps.google.com:8080/maps?ll=37.422,-122.084&z=14",
+  "ws://echo.websocket.org/?encoding=text",
+};
+
+// The same kind of URLs as typed or written in markup, which the full
+// canonicalizer has to rewrite.
+const char* const kNonCanonicalURLs[] = {
+  "HTTP://www.Google.com",
+  "http://www.google.com:80/search?q=chromium url",
+  "http://en.wikipedia.org/wiki/../wiki/Uniform_resource_locator",
+  "http://www.youtube.com/watch?v=dQw4w9WgXcQ&feature=\"related\"",
+  "http://www.amazon.com\\gp\\product\\B00005JNOG",
+  "  http://news.ycombinator.com/item?id=5963398\n",
+  "http://www.nytimes.com/2013/07/01/technology/%62rowsers.html",
+  "http://0x7f.1:8000/index.html",
+};
+
+std::vector<std::string> MakeCorpus(const char* const* urls, size_t count) {
+  std::vector<std::string> corpus;
+  for (size_t i = 0; i < count; ++i)
+    corpus.push_back(urls[i]);
+  return corpus;
+}
+
+void LogRate(const std::string& name, size_t urls, const PerfTimer& timer) {
+  LogPerfResult(name.c_str(),
+                urls * kIterations / 1000.0 / timer.Elapsed().InSecondsF(),
+                "kurls/s");
+}
+
+// Constructs a GURL from every URL of |corpus| kIterations times.
+void RunGURLTest(const std::string& name,
+                 const std::vector<std::string>& corpus) {
+  PerfTimer timer;
+  for (int i = 0; i < kIterations; ++i) {
+    for (size_t j = 0; j < corpus.size(); ++j) {
+      GURL url(corpus[j]);
+      ASSERT_TRUE(url.is_valid());
+    }
+  }
+  LogRate(name, corpus.size(), timer);
+}
+
+// Runs the full canonicalizer over every URL of |corpus| kIterations times,
+// the way GURL does for URLs that aren't known to be canonical.
+void RunCanonicalizeTest(const std::string& name,
+                         const std::vector<std::string>& corpus) {
+  PerfTimer timer;
+  for (int i = 0; i < kIterations; ++i) {
+    for (size_t j = 0; j < corpus.size(); ++j) {
+      std::string canonical;
+      canonical.reserve(corpus[j].size() + 32);
+      url_canon::StdStringCanonOutput output(&canonical);
+      url_parse::Parsed parsed;
+      bool success = url_util::Canonicalize(
+          corpus[j].data(), static_cast<int>(corpus[j].length()), NULL,
+          &output, &parsed);
+      output.Complete();
+      ASSERT_TRUE(success);
+    }
+  }
+  LogRate(name, corpus.size(), timer);
+}
+
+}  // namespace
+
+TEST(GURLPerfTest, CanonicalInput) {
+  std::vector<std::string> corpus =
+      MakeCorpus(kCanonicalURLs, arraysize(kCanonicalURLs));
+  for (size_t i = 0; i < corpus.size(); ++i) {
+    url_parse::Parsed parsed;
+    EXPECT_TRUE(url_canon::IsCanonicalStandardURL(
+        corpus[i].data(), static_cast<int>(corpus[i].length()), &parsed))
+        << corpus[i];
+  }
+
+  RunGURLTest("GURL_canonical_input", corpus);
+  RunCanonicalizeTest("URLCanonicalize_canonical_input", corpus);
+}
+
+TEST(GURLPerfTest, NonCanonicalInput) {
+  std::vector<std::string> corpus =
+      MakeCorpus(kNonCanonicalURLs, arraysize(kNonCanonicalURLs));
+  for (size_t i = 0; i < corpus.size(); ++i)
+    EXPECT_NE(corpus[i], GURL(corpus[i]).spec());
+
+  RunGURLTest("GURL_noncanonical_input", corpus);
+  RunCanonicalizeTest("URLCanonicalize_noncanonical_input", corpus);
+}
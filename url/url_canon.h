@@ -515,6 +515,15 @@ URL_EXPORT bool CanonicalizeStandardURL(const base::char16* spec,
                                         CanonOutput* output,
                                         url_parse::Parsed* new_parsed);
 
+// Returns true if |spec| is a standard URL that CanonicalizeStandardURL would
+// reproduce exactly, in which case |*parsed| is filled with its components and
+// the URL can be used as-is. This only recognizes the common case of a lower
+// case host name, optional port and path using one of the schemes with a
+// default port, so a false return doesn't mean that |spec| isn't canonical.
+URL_EXPORT bool IsCanonicalStandardURL(const char* spec,
+                                       int spec_len,
+                                       url_parse::Parsed* parsed);
+
 // Use for file URLs.
 URL_EXPORT bool CanonicalizeFileURL(const char* spec,
                                     int spec_len,
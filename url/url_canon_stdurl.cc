@@ -5,13 +5,91 @@
 // Functions to canonicalize "standard" URLs, which are ones that have an
 // authority section including a host name.
 
+#include "base/basictypes.h"
+#include "build/build_config.h"
 #include "url/url_canon.h"
 #include "url/url_canon_internal.h"
 
+#if defined(ARCH_CPU_X86_FAMILY) && \
+    (defined(__SSE2__) || defined(_M_X64) || \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define URL_CANON_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace url_canon {
 
 namespace {
 
+// Returns true if |ch| may appear anywhere in a URL accepted by
+// IsCanonicalStandardURL. This excludes whitespace, control and non-ASCII
+// characters, and every printable character that the path or query
+// canonicalizers would escape. The backslash is excluded as well since it
+// is treated as a slash before the query.
+inline bool IsCanonicalSafeChar(unsigned char ch) {
+  if (ch <= ' ' || ch >= 0x7f)
+    return false;
+  switch (ch) {
+    case '"':
+    case '<':
+    case '>':
+    case '\\':
+    case '^':
+    case '`':
+    case '{':
+    case '|':
+    case '}':
+      return false;
+  }
+  return true;
+}
+
+// Returns true if all |spec_len| characters of |spec| are IsCanonicalSafeChar.
+bool HasOnlyCanonicalSafeChars(const char* spec, int spec_len) {
+  int i = 0;
+#if defined(URL_CANON_USE_SSE2)
+  // Bytes compare as signed, so one comparison rejects both the control
+  // characters and the non-ASCII bytes, leaving DEL for the list below.
+  const __m128i space = _mm_set1_epi8(' ');
+  const char kUnsafe[] = { '"', '<', '>', '\\', '^', '`', '{', '|', '}', 0x7f };
+  __m128i unsafe[arraysize(kUnsafe)];
+  for (size_t j = 0; j < arraysize(kUnsafe); ++j)
+    unsafe[j] = _mm_set1_epi8(kUnsafe[j]);
+
+  for (; i + 16 <= spec_len; i += 16) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(spec + i));
+    __m128i bad = _mm_cmpgt_epi8(space, chunk);
+    bad = _mm_or_si128(bad, _mm_cmpeq_epi8(chunk, space));
+    for (size_t j = 0; j < arraysize(kUnsafe); ++j)
+      bad = _mm_or_si128(bad, _mm_cmpeq_epi8(chunk, unsafe[j]));
+    if (_mm_movemask_epi8(bad))
+      return false;
+  }
+#endif
+  for (; i < spec_len; ++i) {
+    if (!IsCanonicalSafeChar(static_cast<unsigned char>(spec[i])))
+      return false;
+  }
+  return true;
+}
+
+// Returns true if the escape sequence at |spec[*begin]| is one that the path
+// canonicalizer copies unchanged, and advances |*begin| to its last
+// character. Escaped unreserved characters get unescaped and an escaped dot
+// may form a directory, so those are rejected along with escaped NULLs.
+bool IsCanonicalPathEscape(const char* spec, int* begin, int end) {
+  unsigned char value;
+  if (!DecodeEscaped(spec, begin, end, &value))
+    return false;
+  if (value == 0 || value == '.' || value == '-' || value == '_' ||
+      value == '~')
+    return false;
+  return !(value >= '0' && value <= '9') &&
+         !(value >= 'a' && value <= 'z') &&
+         !(value >= 'A' && value <= 'Z');
+}
+
 template<typename CHAR, typename UCHAR>
 bool DoCanonicalizeStandardURL(const URLComponentSource<CHAR>& source,
                                const url_parse::Parsed& parsed,
@@ -145,6 +223,88 @@ bool CanonicalizeStandardURL(const base::char16* spec,
       output, new_parsed);
 }
 
+bool IsCanonicalStandardURL(const char* spec,
+                            int spec_len,
+                            url_parse::Parsed* parsed) {
+  // Whitespace and characters that need escaping anywhere in the URL rule it
+  // out before any of the structure is looked at.
+  if (!HasOnlyCanonicalSafeChars(spec, spec_len))
+    return false;
+
+  // Scheme: lower case and followed by "://". Only the schemes with a default
+  // port are handled; they are always standard.
+  int i = 0;
+  while (i < spec_len && spec[i] >= 'a' && spec[i] <= 'z')
+    i++;
+  int scheme_len = i;
+  if (scheme_len == 0 || spec_len - i < 3 || spec[i] != ':' ||
+      spec[i + 1] != '/' || spec[i + 2] != '/')
+    return false;
+  int default_port = DefaultPortForScheme(spec, scheme_len);
+  if (default_port == url_parse::PORT_UNSPECIFIED)
+    return false;
+  i += 3;
+
+  // Host: a non-empty lower case host name. Anything else, including user
+  // info, could be rewritten by the host canonicalizer. A host made only of
+  // IPv4 characters might be a number that gets reformatted, so those are
+  // left to the full canonicalizer too.
+  int host_begin = i;
+  bool may_be_ipv4 = true;
+  for (; i < spec_len; i++) {
+    char ch = spec[i];
+    if (ch == '/' || ch == ':' || ch == '?' || ch == '#')
+      break;
+    if ((ch >= 'a' && ch <= 'z') || ch == '_' || ch == '-') {
+      if (!IsIPv4Char(static_cast<unsigned char>(ch)))
+        may_be_ipv4 = false;
+    } else if (!(ch >= '0' && ch <= '9') && ch != '.') {
+      return false;
+    }
+  }
+  if (i == host_begin || may_be_ipv4)
+    return false;
+
+  // Port: digits without leading zeros, in range, and not the default.
+  if (i < spec_len && spec[i] == ':') {
+    i++;
+    int port_begin = i;
+    int port = 0;
+    for (; i < spec_len && spec[i] >= '0' && spec[i] <= '9'; i++) {
+      port = port * 10 + (spec[i] - '0');
+      if (port > 65535)
+        return false;
+    }
+    if (i == port_begin || spec[port_begin] == '0' || port == default_port)
+      return false;
+  }
+
+  // Path: must be present, since one would be made up otherwise, and must
+  // not contain directories to resolve or escapes to rewrite.
+  if (i == spec_len || spec[i] != '/')
+    return false;
+  int segment_begin = i + 1;
+  for (i++; i <= spec_len; i++) {
+    if (i == spec_len || spec[i] == '/' || spec[i] == '?' || spec[i] == '#') {
+      int segment_len = i - segment_begin;
+      if ((segment_len == 1 && spec[segment_begin] == '.') ||
+          (segment_len == 2 && spec[segment_begin] == '.' &&
+           spec[segment_begin + 1] == '.'))
+        return false;
+      if (i == spec_len || spec[i] != '/')
+        break;
+      segment_begin = i + 1;
+    } else if (spec[i] == '%' && !IsCanonicalPathEscape(spec, &i, spec_len)) {
+      return false;
+    }
+  }
+
+  // The query and ref are copied unchanged once the characters that would be
+  // escaped are excluded, which HasOnlyCanonicalSafeChars did.
+  url_parse::ParseStandardURL(spec, spec_len, parsed);
+  return true;
+}
+
 // It might be nice in the future to optimize this so unchanged components don't
 // need to be recanonicalized. This is especially true since the common case for
 // ReplaceComponents is removing things we don't want, like reference fragments
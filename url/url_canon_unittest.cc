@@ -1296,6 +1296,82 @@ TEST(URLCanonTest, CanonicalizeStandardURL) {
   }
 }
 
+TEST(URLCanonTest, IsCanonicalStandardURL) {
+  struct IsCanonicalCase {
+    const char* input;
+    bool expected;
+  } cases[] = {
+    {"http://www.google.com/", true},
+    {"https://www.google.com:8443/search?q=a+b&ie=UTF-8#top", true},
+    {"http://www.example.com/a/b.c/d..e/f;p=1/%20%2F%C3%A9?x=%zz&y=[]", true},
+    {"ws://chat.example.com:81/socket", true},
+    {"http://foo_bar-1.example.com./", true},
+
+      // Anything the canonicalizer would rewrite.
+    {"HTTP://www.google.com/", false},
+    {"http://www.Google.com/", false},
+    {"http://user@www.google.com/", false},
+    {"http://www.google.com", false},
+    {"http://www.google.com?q", false},
+    {"http://www.google.com:80/", false},
+    {"http://www.google.com:080/", false},
+    {"http://www.google.com:/", false},
+    {"http://www.google.com:99999/", false},
+    {"http://www.google.com/a/./b", false},
+    {"http://www.google.com/a/../b", false},
+    {"http://www.google.com/a/%2e/b", false},
+    {"http://www.google.com/%41", false},
+    {"http://www.google.com/%zz", false},
+    {"http://www.google.com/a\\b", false},
+    {"http://www.google.com/a b", false},
+    {"http://www.google.com/search?q=\"quoted\"", false},
+    {"http://www.google.com/0123456789abcdef{}", false},
+    {"http://www.google.com/0123456789abcdef\xc3\xa9", false},
+    {" http://www.google.com/", false},
+    {"http://www.google.com/\n", false},
+
+      // Hosts that may be reformatted as IPv4 addresses.
+    {"http://192.168.0.1/", false},
+    {"http://0xc0.0xa8.0.1/", false},
+    {"http://cafe.bad/", false},
+
+      // Schemes without a default port.
+    {"file:///tmp/", false},
+    {"filesystem:http://www.google.com/temporary/", false},
+    {"chrome://settings/", false},
+  };
+
+  for (size_t i = 0; i < ARRAYSIZE(cases); i++) {
+    int url_len = static_cast<int>(strlen(cases[i].input));
+    url_parse::Parsed parsed;
+    EXPECT_EQ(cases[i].expected,
+              url_canon::IsCanonicalStandardURL(cases[i].input, url_len,
+                                                &parsed)) << cases[i].input;
+    if (!cases[i].expected)
+      continue;
+
+    // The URL must round-trip through the full canonicalizer unchanged.
+    url_parse::Parsed input_parsed;
+    url_parse::ParseStandardURL(cases[i].input, url_len, &input_parsed);
+    url_parse::Parsed out_parsed;
+    std::string out_str;
+    url_canon::StdStringCanonOutput output(&out_str);
+    EXPECT_TRUE(url_canon::CanonicalizeStandardURL(
+        cases[i].input, url_len, input_parsed, NULL, &output, &out_parsed));
+    output.Complete();
+
+    EXPECT_EQ(cases[i].input, out_str);
+    EXPECT_TRUE(parsed.scheme == out_parsed.scheme);
+    EXPECT_TRUE(parsed.username == out_parsed.username);
+    EXPECT_TRUE(parsed.password == out_parsed.password);
+    EXPECT_TRUE(parsed.host == out_parsed.host);
+    EXPECT_TRUE(parsed.port == out_parsed.port);
+    EXPECT_TRUE(parsed.path == out_parsed.path);
+    EXPECT_TRUE(parsed.query == out_parsed.query);
+    EXPECT_TRUE(parsed.ref == out_parsed.ref);
+  }
+}
+
 // The codepath here is the same as for regular canonicalization, so we just
 // need to test that things are replaced or not correctly.
 TEST(URLCanonTest, ReplaceStandardURL) {
@@ -169,10 +169,20 @@ bool CreateIndex(sql::Connection* db, const IndexInfo& info) {
   return db->Execute(sql.c_str());
 }
 
+// The disk cache backend is recorded along with the experiments because the
+// two backends use different on-disk formats; switching between them has to
+// start over with an empty database and disk cache.
 std::string GetActiveExperimentFlags() {
-  if (CommandLine::ForCurrentProcess()->HasSwitch(kEnableExecutableHandlers))
-    return std::string("executableHandlersEnabled");
-  return std::string();
+  const CommandLine* command_line = CommandLine::ForCurrentProcess();
+  std::string flags;
+  if (command_line->HasSwitch(kEnableExecutableHandlers))
+    flags = "executableHandlersEnabled";
+  if (command_line->HasSwitch(kEnableSimpleCacheBackend)) {
+    if (!flags.empty())
+      flags += ",";
+    flags += "simpleCacheBackendEnabled";
+  }
+  return flags;
 }
 
 }  // anon namespace
@@ -566,6 +576,22 @@ bool AppCacheDatabase::FindEntriesForUrl(
   return statement.Succeeded();
 }
 
+bool AppCacheDatabase::FindAllEntryUrls(std::vector<std::string>* url_specs) {
+  DCHECK(url_specs && url_specs->empty());
+  if (!LazyOpen(false))
+    return false;
+
+  const char* kSql =
+      "SELECT DISTINCT(url) FROM Entries";
+
+  sql::Statement statement(db_->GetUniqueStatement(kSql));
+
+  while (statement.Step())
+    url_specs->push_back(statement.ColumnString(0));
+
+  return statement.Succeeded();
+}
+
 bool AppCacheDatabase::FindEntry(
     int64 cache_id, const GURL& url, EntryRecord* record) {
   DCHECK(record);
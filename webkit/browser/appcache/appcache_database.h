@@ -116,6 +116,7 @@ class WEBKIT_STORAGE_BROWSER_EXPORT AppCacheDatabase {
       int64 cache_id, std::vector<EntryRecord>* records);
   bool FindEntriesForUrl(
       const GURL& url, std::vector<EntryRecord>* records);
+  bool FindAllEntryUrls(std::vector<std::string>* url_specs);
   bool FindEntry(int64 cache_id, const GURL& url, EntryRecord* record);
   bool InsertEntry(const EntryRecord* record);
   bool InsertEntryRecords(
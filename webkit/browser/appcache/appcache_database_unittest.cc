@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/file_util.h"
 #include "base/files/scoped_temp_dir.h"
@@ -172,6 +174,14 @@ TEST(AppCacheDatabaseTest, EntryRecords) {
   EXPECT_EQ(300, found[1].response_size);
   found.clear();
 
+  std::vector<std::string> url_specs;
+  EXPECT_TRUE(db.FindAllEntryUrls(&url_specs));
+  std::sort(url_specs.begin(), url_specs.end());
+  ASSERT_EQ(3U, url_specs.size());
+  EXPECT_EQ("http://blah/1", url_specs[0]);
+  EXPECT_EQ("http://blah/2", url_specs[1]);
+  EXPECT_EQ("http://blah/3", url_specs[2]);
+
   EXPECT_TRUE(db.DeleteEntriesForCache(2));
   EXPECT_TRUE(db.FindEntriesForCache(2, &found));
   EXPECT_TRUE(found.empty());
@@ -6,12 +6,14 @@
 
 #include "base/bind.h"
 #include "base/bind_helpers.h"
+#include "base/command_line.h"
 #include "base/files/file_path.h"
 #include "base/logging.h"
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "net/base/cache_type.h"
 #include "net/base/net_errors.h"
+#include "webkit/common/appcache/appcache_interfaces.h"
 
 namespace appcache {
 
@@ -270,8 +272,16 @@ int AppCacheDiskCache::Init(net::CacheType cache_type,
   is_disabled_ = false;
   create_backend_callback_ = new CreateBackendCallbackShim(this);
 
+  // The simple backend opens and writes entries on worker threads without
+  // blocking the cache thread, but it is still opt-in.
+  net::BackendType backend_type = net::CACHE_BACKEND_DEFAULT;
+  if (cache_type == net::APP_CACHE &&
+      CommandLine::ForCurrentProcess()->HasSwitch(kEnableSimpleCacheBackend)) {
+    backend_type = net::CACHE_BACKEND_SIMPLE;
+  }
+
   int rv = disk_cache::CreateCacheBackend(
-      cache_type, net::CACHE_BACKEND_DEFAULT, cache_directory, cache_size,
+      cache_type, backend_type, cache_directory, cache_size,
       force, cache_thread, NULL, &(create_backend_callback_->backend_ptr_),
       base::Bind(&CreateBackendCallbackShim::Callback,
                  create_backend_callback_));
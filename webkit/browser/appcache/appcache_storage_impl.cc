@@ -12,6 +12,7 @@
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/file_util.h"
+#include "base/hash.h"
 #include "base/logging.h"
 #include "base/message_loop/message_loop.h"
 #include "base/stl_util.h"
@@ -44,6 +45,28 @@ static const base::FilePath::CharType kDiskCacheDirectoryName[] =
 
 namespace {
 
+// Adds the namespaces of |records| to |namespaces_by_origin|, skipping those
+// already in there. Only their url and whether it's a pattern matter to the
+// lookups, so a cache storing the same namespaces again adds nothing.
+void AddNamespacesToIndex(
+    const AppCacheDatabase::NamespaceRecordVector& records,
+    std::map<GURL, NamespaceVector>* namespaces_by_origin) {
+  for (AppCacheDatabase::NamespaceRecordVector::const_iterator record =
+           records.begin();
+       record != records.end(); ++record) {
+    NamespaceVector& namespaces = (*namespaces_by_origin)[record->origin];
+    NamespaceVector::const_iterator it = namespaces.begin();
+    for (; it != namespaces.end(); ++it) {
+      if (it->namespace_url == record->namespace_.namespace_url &&
+          it->is_pattern == record->namespace_.is_pattern) {
+        break;
+      }
+    }
+    if (it == namespaces.end())
+      namespaces.push_back(record->namespace_);
+  }
+}
+
 // Helpers for clearing data from the AppCacheDatabase.
 bool DeleteGroupAndRelatedRecords(AppCacheDatabase* database,
                                   int64 group_id,
@@ -263,6 +286,8 @@ class AppCacheStorageImpl::InitTask : public DatabaseTask {
   int64 last_response_id_;
   int64 last_deletable_response_rowid_;
   std::map<GURL, int64> usage_map_;
+  base::hash_set<uint32> entry_url_hashes_;
+  NamespacesByOrigin namespaces_by_origin_;
 };
 
 void AppCacheStorageImpl::InitTask::Run() {
@@ -270,6 +295,25 @@ void AppCacheStorageImpl::InitTask::Run() {
       &last_group_id_, &last_cache_id_, &last_response_id_,
       &last_deletable_response_rowid_);
   database_->GetAllOriginUsage(&usage_map_);
+
+  // Load the index used to answer main resource lookups that can't hit
+  // without querying the database.
+  std::vector<std::string> url_specs;
+  database_->FindAllEntryUrls(&url_specs);
+  for (std::vector<std::string>::const_iterator it = url_specs.begin();
+       it != url_specs.end(); ++it) {
+    entry_url_hashes_.insert(base::Hash(*it));
+  }
+  for (std::map<GURL, int64>::const_iterator it = usage_map_.begin();
+       it != usage_map_.end(); ++it) {
+    AppCacheDatabase::NamespaceRecordVector intercepts;
+    AppCacheDatabase::NamespaceRecordVector fallbacks;
+    if (database_->FindNamespacesForOrigin(it->first, &intercepts,
+                                           &fallbacks)) {
+      AddNamespacesToIndex(intercepts, &namespaces_by_origin_);
+      AddNamespacesToIndex(fallbacks, &namespaces_by_origin_);
+    }
+  }
 }
 
 void AppCacheStorageImpl::InitTask::RunCompleted() {
@@ -280,6 +324,8 @@ void AppCacheStorageImpl::InitTask::RunCompleted() {
 
   if (!storage_->is_disabled()) {
     storage_->usage_map_.swap(usage_map_);
+    storage_->entry_url_hashes_.swap(entry_url_hashes_);
+    storage_->namespaces_by_origin_.swap(namespaces_by_origin_);
     const base::TimeDelta kDelay = base::TimeDelta::FromMinutes(5);
     base::MessageLoop::current()->PostDelayedTask(
         FROM_HERE,
@@ -753,6 +799,9 @@ void AppCacheStorageImpl::StoreGroupAndCacheTask::RunCompleted() {
   if (success_) {
     storage_->UpdateUsageMapAndNotify(
         group_->manifest_url().GetOrigin(), new_origin_usage_);
+    storage_->AddToMainResponseIndex(entry_records_,
+                                     intercept_namespace_records_,
+                                     fallback_namespace_records_);
     if (cache_.get() != group_->newest_complete_cache()) {
       cache_->set_complete(true);
       group_->AddCache(cache_.get());
@@ -1486,7 +1535,9 @@ void AppCacheStorageImpl::FindResponseForMainRequest(
     }
   }
 
-  if (IsInitTaskComplete() &&  usage_map_.find(origin) == usage_map_.end()) {
+  if (IsInitTaskComplete() &&
+      (usage_map_.find(origin) == usage_map_.end() ||
+       !MayHaveMainResponse(*url_ptr))) {
     // No need to query the database, return async'ly but without going thru
     // the DB thread.
     scoped_refptr<AppCacheGroup> no_group;
@@ -1507,6 +1558,36 @@ void AppCacheStorageImpl::FindResponseForMainRequest(
   task->Schedule();
 }
 
+bool AppCacheStorageImpl::MayHaveMainResponse(const GURL& url) const {
+  if (entry_url_hashes_.find(base::Hash(url.spec())) !=
+          entry_url_hashes_.end()) {
+    return true;
+  }
+  NamespacesByOrigin::const_iterator found =
+      namespaces_by_origin_.find(url.GetOrigin());
+  if (found == namespaces_by_origin_.end())
+    return false;
+  for (NamespaceVector::const_iterator it = found->second.begin();
+       it != found->second.end(); ++it) {
+    if (it->IsMatch(url))
+      return true;
+  }
+  return false;
+}
+
+void AppCacheStorageImpl::AddToMainResponseIndex(
+    const std::vector<AppCacheDatabase::EntryRecord>& entries,
+    const std::vector<AppCacheDatabase::NamespaceRecord>& intercepts,
+    const std::vector<AppCacheDatabase::NamespaceRecord>& fallbacks) {
+  for (std::vector<AppCacheDatabase::EntryRecord>::const_iterator it =
+           entries.begin();
+       it != entries.end(); ++it) {
+    entry_url_hashes_.insert(base::Hash(it->url.spec()));
+  }
+  AddNamespacesToIndex(intercepts, &namespaces_by_origin_);
+  AddNamespacesToIndex(fallbacks, &namespaces_by_origin_);
+}
+
 bool AppCacheStorageImpl::FindResponseForMainRequestInGroup(
     AppCacheGroup* group,  const GURL& url, Delegate* delegate) {
   AppCache* cache = group->newest_complete_cache();
@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "base/callback.h"
+#include "base/containers/hash_tables.h"
 #include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
 #include "base/message_loop/message_loop_proxy.h"
@@ -94,6 +95,7 @@ class AppCacheStorageImpl : public AppCacheStorage {
   typedef std::map<GURL, GroupLoadTask*> PendingGroupLoads;
   typedef std::deque<std::pair<GURL, int64> > PendingForeignMarkings;
   typedef std::set<StoreGroupAndCacheTask*> PendingQuotaQueries;
+  typedef std::map<GURL, NamespaceVector> NamespacesByOrigin;
 
   bool IsInitTaskComplete() {
     return last_cache_id_ != AppCacheStorage::kUnitializedId;
@@ -115,6 +117,14 @@ class AppCacheStorageImpl : public AppCacheStorage {
   void OnDeletedOneResponse(int rv);
   void OnDiskCacheInitialized(int rv);
 
+  // Returns false if no stored entry or namespace can match |url|, in which
+  // case there's no need to query the database for a main resource.
+  bool MayHaveMainResponse(const GURL& url) const;
+  void AddToMainResponseIndex(
+      const std::vector<AppCacheDatabase::EntryRecord>& entries,
+      const std::vector<AppCacheDatabase::NamespaceRecord>& intercepts,
+      const std::vector<AppCacheDatabase::NamespaceRecord>& fallbacks);
+
   // Sometimes we can respond without having to query the database.
   bool FindResponseForMainRequestInGroup(
       AppCacheGroup* group,  const GURL& url, Delegate* delegate);
@@ -166,6 +176,13 @@ class AppCacheStorageImpl : public AppCacheStorage {
 
   scoped_ptr<AppCacheDiskCache> disk_cache_;
 
+  // A superset of the urls of the stored entries, by hash, and of the
+  // intercept and fallback namespaces of each origin. Loaded by the InitTask
+  // and added to as caches are stored, but never pruned; a stale hit only
+  // costs a database query.
+  base::hash_set<uint32> entry_url_hashes_;
+  NamespacesByOrigin namespaces_by_origin_;
+
   // Used to short-circuit certain operations without having to schedule
   // any tasks on the background database thread.
   std::deque<base::Closure> pending_simple_tasks_;
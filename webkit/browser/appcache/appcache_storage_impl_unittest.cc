@@ -867,6 +867,7 @@ class AppCacheStorageImplTest : public testing::Test {
     entry_record.flags = AppCacheEntry::EXPLICIT;
     entry_record.response_id = 1;
     EXPECT_TRUE(database()->InsertEntry(&entry_record));
+    AddEntryToIndex(entry_record);
 
     // Optionally drop the cache/group pair from the working set.
     if (drop_from_working_set) {
@@ -939,6 +940,7 @@ class AppCacheStorageImplTest : public testing::Test {
 
     EXPECT_TRUE(database()->InsertNamespaceRecords(fallbacks));
     EXPECT_TRUE(database()->InsertOnlineWhiteListRecords(whitelists));
+    storage()->AddToMainResponseIndex(entries, intercepts, fallbacks);
     if (drop_from_working_set) {
       EXPECT_TRUE(cache_->HasOneRef());
       cache_ = NULL;
@@ -1013,6 +1015,7 @@ class AppCacheStorageImplTest : public testing::Test {
 
     EXPECT_TRUE(database()->InsertNamespaceRecords(intercepts));
     EXPECT_TRUE(database()->InsertOnlineWhiteListRecords(whitelists));
+    storage()->AddToMainResponseIndex(entries, intercepts, fallbacks);
     if (drop_from_working_set) {
       EXPECT_TRUE(cache_->HasOneRef());
       cache_ = NULL;
@@ -1079,6 +1082,7 @@ class AppCacheStorageImplTest : public testing::Test {
     }
 
     EXPECT_TRUE(database()->InsertNamespaceRecords(intercepts));
+    storage()->AddToMainResponseIndex(entries, intercepts, fallbacks);
     if (drop_from_working_set) {
       EXPECT_TRUE(cache_->HasOneRef());
       cache_ = NULL;
@@ -1165,6 +1169,7 @@ class AppCacheStorageImplTest : public testing::Test {
     }
 
     EXPECT_TRUE(database()->InsertNamespaceRecords(fallbacks));
+    storage()->AddToMainResponseIndex(entries, intercepts, fallbacks);
     if (drop_from_working_set) {
       EXPECT_TRUE(cache_->HasOneRef());
       cache_ = NULL;
@@ -1241,6 +1246,7 @@ class AppCacheStorageImplTest : public testing::Test {
     entry_record.flags = AppCacheEntry::EXPLICIT;
     entry_record.response_id = id;
     EXPECT_TRUE(database()->InsertEntry(&entry_record));
+    AddEntryToIndex(entry_record);
     cache_->AddEntry(
         entry_record.url,
         AppCacheEntry(entry_record.flags, entry_record.response_id));
@@ -1251,6 +1257,7 @@ class AppCacheStorageImplTest : public testing::Test {
     entry_record.flags = AppCacheEntry::MANIFEST;
     entry_record.response_id = id + kManifestEntryIdOffset;
     EXPECT_TRUE(database()->InsertEntry(&entry_record));
+    AddEntryToIndex(entry_record);
     cache_->AddEntry(
         entry_record.url,
         AppCacheEntry(entry_record.flags, entry_record.response_id));
@@ -1261,6 +1268,7 @@ class AppCacheStorageImplTest : public testing::Test {
     entry_record.flags = AppCacheEntry::FALLBACK;
     entry_record.response_id = id + kFallbackEntryIdOffset;
     EXPECT_TRUE(database()->InsertEntry(&entry_record));
+    AddEntryToIndex(entry_record);
     cache_->AddEntry(
         entry_record.url,
         AppCacheEntry(entry_record.flags, entry_record.response_id));
@@ -1270,6 +1278,7 @@ class AppCacheStorageImplTest : public testing::Test {
     fallback_namespace_record.namespace_.namespace_url = kFallbackNamespace;
     fallback_namespace_record.origin = manifest_url.GetOrigin();
     EXPECT_TRUE(database()->InsertNamespace(&fallback_namespace_record));
+    AddFallbackToIndex(fallback_namespace_record);
     cache_->fallback_namespaces_.push_back(
         Namespace(FALLBACK_NAMESPACE, kFallbackNamespace, kEntryUrl2, false));
   }
@@ -1397,6 +1406,7 @@ class AppCacheStorageImplTest : public testing::Test {
     entry_record.flags = AppCacheEntry::EXPLICIT | AppCacheEntry::FOREIGN;
     entry_record.response_id = 1;
     EXPECT_TRUE(database()->InsertEntry(&entry_record));
+    AddEntryToIndex(entry_record);
     AppCacheDatabase::OnlineWhiteListRecord whitelist_record;
     whitelist_record.cache_id = 1;
     whitelist_record.namespace_url = kOnlineNamespace;
@@ -1407,6 +1417,7 @@ class AppCacheStorageImplTest : public testing::Test {
     fallback_namespace_record.namespace_.namespace_url = kFallbackNamespace;
     fallback_namespace_record.origin = kManifestUrl.GetOrigin();
     EXPECT_TRUE(database()->InsertNamespace(&fallback_namespace_record));
+    AddFallbackToIndex(fallback_namespace_record);
     whitelist_record.cache_id = 1;
     whitelist_record.namespace_url = kOnlineNamespaceWithinFallback;
     EXPECT_TRUE(database()->InsertOnlineWhiteList(&whitelist_record));
@@ -1504,12 +1515,29 @@ class AppCacheStorageImplTest : public testing::Test {
       entry_record.response_id = default_entry.response_id();
       entry_record.response_size = default_entry.response_size();
       EXPECT_TRUE(database()->InsertEntry(&entry_record));
+      AddEntryToIndex(entry_record);
 
       storage()->usage_map_[manifest_url.GetOrigin()] =
           default_entry.response_size();
     }
   }
 
+  // The tests insert records into the database directly, these let the
+  // storage know about them as storing a group and cache would have.
+  void AddEntryToIndex(const AppCacheDatabase::EntryRecord& record) {
+    storage()->AddToMainResponseIndex(
+        std::vector<AppCacheDatabase::EntryRecord>(1, record),
+        AppCacheDatabase::NamespaceRecordVector(),
+        AppCacheDatabase::NamespaceRecordVector());
+  }
+
+  void AddFallbackToIndex(const AppCacheDatabase::NamespaceRecord& record) {
+    storage()->AddToMainResponseIndex(
+        std::vector<AppCacheDatabase::EntryRecord>(),
+        AppCacheDatabase::NamespaceRecordVector(),
+        AppCacheDatabase::NamespaceRecordVector(1, record));
+  }
+
   // Data members --------------------------------------------------
 
   scoped_ptr<base::WaitableEvent> test_finished_event_;
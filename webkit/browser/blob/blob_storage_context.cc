@@ -5,12 +5,16 @@
 #include "webkit/browser/blob/blob_storage_context.h"
 
 #include "base/bind.h"
+#include "base/file_util.h"
 #include "base/location.h"
 #include "base/logging.h"
 #include "base/message_loop/message_loop_proxy.h"
+#include "base/task_runner.h"
+#include "base/task_runner_util.h"
 #include "url/gurl.h"
 #include "webkit/browser/blob/blob_data_handle.h"
 #include "webkit/common/blob/blob_data.h"
+#include "webkit/common/blob/shareable_file_reference.h"
 
 namespace webkit_blob {
 
@@ -36,22 +40,53 @@ GURL ClearBlobUrlRef(const GURL& url) {
 // way to come up with a better limit.
 static const int64 kMaxMemoryUsage = 500 * 1024 * 1024;  // Half a gig.
 
+// With disk paging enabled, finished blobs are paged out while their bytes
+// take more memory than this. Smaller blobs aren't worth a file of their own.
+static const int64 kMemoryBudget = 100 * 1024 * 1024;
+static const int64 kMinPageOutSize = 64 * 1024;
+
+// Writes the bytes items of |blob_data| one after another to a new file in
+// |directory|, returning its path or an empty path on failure. Runs on the
+// file thread, which is safe because the items of a finished blob don't
+// change and the caller keeps |blob_data| alive until the reply.
+base::FilePath WriteBytesItemsToFile(const base::FilePath& directory,
+                                     const BlobData* blob_data) {
+  base::FilePath path;
+  if (!file_util::CreateTemporaryFileInDir(directory, &path))
+    return base::FilePath();
+  for (std::vector<BlobData::Item>::const_iterator iter =
+           blob_data->items().begin();
+       iter != blob_data->items().end(); ++iter) {
+    if (iter->type() != BlobData::Item::TYPE_BYTES)
+      continue;
+    int length = static_cast<int>(iter->length());
+    if (file_util::AppendToFile(path, iter->bytes(), length) != length) {
+      base::DeleteFile(path, false);
+      return base::FilePath();
+    }
+  }
+  return path;
+}
+
 }  // namespace
 
 BlobStorageContext::BlobMapEntry::BlobMapEntry()
-    : refcount(0), flags(0) {
+    : refcount(0), flags(0), paged_out_bytes(0) {
 }
 
 BlobStorageContext::BlobMapEntry::BlobMapEntry(
     int refcount, int flags, BlobData* data)
-    : refcount(refcount), flags(flags), data(data) {
+    : refcount(refcount), flags(flags), data(data), paged_out_bytes(0) {
 }
 
 BlobStorageContext::BlobMapEntry::~BlobMapEntry() {
 }
 
 BlobStorageContext::BlobStorageContext()
-    : memory_usage_(0) {
+    : memory_usage_(0),
+      disk_usage_(0),
+      memory_budget_(kMemoryBudget),
+      page_out_pending_(false) {
 }
 
 BlobStorageContext::~BlobStorageContext() {
@@ -66,6 +101,7 @@ scoped_ptr<BlobDataHandle> BlobStorageContext::GetBlobDataFromUUID(
   if (found->second.flags & EXCEEDED_MEMORY)
     return result.Pass();
   DCHECK(!(found->second.flags & BEING_BUILT));
+  found->second.last_access = base::TimeTicks::Now();
   result.reset(new BlobDataHandle(
       found->second.data.get(), this, base::MessageLoopProxy::current().get()));
   return result.Pass();
@@ -94,6 +130,14 @@ scoped_ptr<BlobDataHandle> BlobStorageContext::AddFinishedBlob(
   return handle.Pass();
 }
 
+void BlobStorageContext::EnableDiskPaging(const base::FilePath& directory,
+                                          base::TaskRunner* file_task_runner) {
+  DCHECK(!directory.empty() && file_task_runner);
+  paging_directory_ = directory;
+  file_task_runner_ = file_task_runner;
+  PageOutIfNeeded();
+}
+
 void BlobStorageContext::StartBuildingBlob(const std::string& uuid) {
   DCHECK(!IsInUse(uuid) && !uuid.empty());
   blob_map_[uuid] = BlobMapEntry(1, BEING_BUILT, new BlobData(uuid));
@@ -178,6 +222,8 @@ void BlobStorageContext::FinishBuildingBlob(
     return;
   found->second.data->set_content_type(content_type);
   found->second.flags &= ~BEING_BUILT;
+  found->second.last_access = base::TimeTicks::Now();
+  PageOutIfNeeded();
 }
 
 void BlobStorageContext::CancelBuildingBlob(const std::string& uuid) {
@@ -201,6 +247,7 @@ void BlobStorageContext::DecrementBlobRefCount(const std::string& uuid) {
   DCHECK_EQ(found->second.data->uuid(), uuid);
   if (--(found->second.refcount) == 0) {
     memory_usage_ -= found->second.data->GetMemoryUsage();
+    disk_usage_ -= found->second.paged_out_bytes;
     blob_map_.erase(found);
   }
 }
@@ -304,6 +351,105 @@ void BlobStorageContext::AppendFileSystemFileItem(
                                          expected_modification_time);
 }
 
+void BlobStorageContext::PageOutIfNeeded() {
+  if (!file_task_runner_.get() || page_out_pending_ ||
+      memory_usage_ <= memory_budget_)
+    return;
+
+  BlobMap::iterator least_recently_used = blob_map_.end();
+  for (BlobMap::iterator iter = blob_map_.begin(); iter != blob_map_.end();
+       ++iter) {
+    if (iter->second.flags & (BEING_BUILT | EXCEEDED_MEMORY))
+      continue;
+    if (iter->second.data->GetMemoryUsage() < kMinPageOutSize)
+      continue;
+    if (least_recently_used == blob_map_.end() ||
+        iter->second.last_access < least_recently_used->second.last_access)
+      least_recently_used = iter;
+  }
+  if (least_recently_used == blob_map_.end())
+    return;
+
+  page_out_pending_ = true;
+  BlobData* data = least_recently_used->second.data.get();
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(),
+      FROM_HERE,
+      base::Bind(&WriteBytesItemsToFile,
+                 paging_directory_,
+                 base::Unretained(static_cast<const BlobData*>(data))),
+      base::Bind(&BlobStorageContext::OnPagedOut,
+                 AsWeakPtr(),
+                 least_recently_used->first,
+                 make_scoped_refptr(data)));
+}
+
+void BlobStorageContext::OnPagedOut(const std::string& uuid,
+                                    scoped_refptr<BlobData> paged_data,
+                                    const base::FilePath& path) {
+  page_out_pending_ = false;
+  if (path.empty()) {
+    // Most likely the disk is full, so keep everything in memory from now on.
+    LOG(WARNING) << "Failed to page out blob data.";
+    file_task_runner_ = NULL;
+    return;
+  }
+
+  // Releasing the last reference to the file deletes it, including right
+  // away if the blob went away or changed meanwhile.
+  scoped_refptr<ShareableFileReference> file_reference =
+      ShareableFileReference::GetOrCreate(
+          path, ShareableFileReference::DELETE_ON_FINAL_RELEASE,
+          file_task_runner_.get());
+  BlobMap::iterator found = blob_map_.find(uuid);
+  if (found == blob_map_.end() ||
+      found->second.data.get() != paged_data.get()) {
+    PageOutIfNeeded();
+    return;
+  }
+
+  // Build a new BlobData, since readers may be using the old one. The bytes
+  // items become ranges of the file, in the order they were written.
+  scoped_refptr<BlobData> new_data(new BlobData(uuid));
+  new_data->set_content_type(paged_data->content_type());
+  new_data->set_content_disposition(paged_data->content_disposition());
+  uint64 file_offset = 0;
+  for (std::vector<BlobData::Item>::const_iterator iter =
+           paged_data->items().begin();
+       iter != paged_data->items().end(); ++iter) {
+    switch (iter->type()) {
+      case BlobData::Item::TYPE_BYTES:
+        new_data->AppendFile(path, file_offset, iter->length(), base::Time());
+        file_offset += iter->length();
+        break;
+      case BlobData::Item::TYPE_FILE:
+        AppendFileItem(new_data.get(),
+                       iter->path(),
+                       iter->offset(),
+                       iter->length(),
+                       iter->expected_modification_time());
+        break;
+      case BlobData::Item::TYPE_FILE_FILESYSTEM:
+        AppendFileSystemFileItem(new_data.get(),
+                                 iter->filesystem_url(),
+                                 iter->offset(),
+                                 iter->length(),
+                                 iter->expected_modification_time());
+        break;
+      default:
+        NOTREACHED();
+        break;
+    }
+  }
+  new_data->AttachShareableFileReference(file_reference.get());
+
+  memory_usage_ -= paged_data->GetMemoryUsage();
+  disk_usage_ += file_offset;
+  found->second.paged_out_bytes = file_offset;
+  found->second.data = new_data;
+  PageOutIfNeeded();
+}
+
 bool BlobStorageContext::IsInUse(const std::string& uuid) {
   return blob_map_.find(uuid) != blob_map_.end();
 }
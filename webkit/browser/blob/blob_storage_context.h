@@ -8,17 +8,18 @@
 #include <map>
 #include <string>
 
+#include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "webkit/browser/webkit_storage_browser_export.h"
 #include "webkit/common/blob/blob_data.h"
 
 class GURL;
 
 namespace base {
-class FilePath;
-class Time;
+class TaskRunner;
 }
 
 namespace webkit_blob {
@@ -42,6 +43,23 @@ class WEBKIT_STORAGE_BROWSER_EXPORT BlobStorageContext
   // blob cannot be added due to memory consumption, returns NULL.
   scoped_ptr<BlobDataHandle> AddFinishedBlob(const BlobData* blob_data);
 
+  // Once the bytes held in memory exceed the memory budget, moves the bytes
+  // of finished blobs out to temporary files in |directory|, least recently
+  // used blobs first, and serves them from those files from then on. The
+  // files are written on |file_task_runner| and deleted when the blobs are,
+  // but files being written at shutdown are left behind, so |directory|
+  // should be cleared on startup.
+  void EnableDiskPaging(const base::FilePath& directory,
+                        base::TaskRunner* file_task_runner);
+
+  // Bytes of blob data held in memory, and paged out to disk.
+  int64 memory_usage() const { return memory_usage_; }
+  int64 disk_usage() const { return disk_usage_; }
+
+  void set_memory_budget_for_testing(int64 memory_budget) {
+    memory_budget_ = memory_budget;
+  }
+
  private:
   friend class BlobDataHandle;
   friend class BlobStorageHost;
@@ -55,6 +73,9 @@ class WEBKIT_STORAGE_BROWSER_EXPORT BlobStorageContext
     int refcount;
     int flags;
     scoped_refptr<BlobData> data;
+    base::TimeTicks last_access;
+    // Bytes of |data| that were paged out to disk.
+    int64 paged_out_bytes;
 
     BlobMapEntry();
     BlobMapEntry(int refcount, int flags, BlobData* data);
@@ -90,6 +111,13 @@ class WEBKIT_STORAGE_BROWSER_EXPORT BlobStorageContext
       const GURL& url, uint64 offset, uint64 length,
       const base::Time& expected_modification_time);
 
+  // Starts paging out the least recently used blob if more memory than the
+  // budget is in use and nothing is being paged out already.
+  void PageOutIfNeeded();
+  void OnPagedOut(const std::string& uuid,
+                  scoped_refptr<BlobData> paged_data,
+                  const base::FilePath& path);
+
   bool IsInUse(const std::string& uuid);
   bool IsBeingBuilt(const std::string& uuid);
   bool IsUrlRegistered(const GURL& blob_url);
@@ -101,6 +129,13 @@ class WEBKIT_STORAGE_BROWSER_EXPORT BlobStorageContext
   // we count only the items of TYPE_DATA which are held in memory and not
   // items of TYPE_FILE.
   int64 memory_usage_;
+  int64 disk_usage_;
+  int64 memory_budget_;
+
+  // Set by EnableDiskPaging().
+  base::FilePath paging_directory_;
+  scoped_refptr<base::TaskRunner> file_task_runner_;
+  bool page_out_pending_;
 
   DISALLOW_COPY_AND_ASSIGN(BlobStorageContext);
 };
@@ -2,10 +2,13 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "base/file_util.h"
 #include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop/message_loop.h"
+#include "base/message_loop/message_loop_proxy.h"
 #include "base/time/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webkit/browser/blob/blob_data_handle.h"
@@ -131,6 +134,61 @@ TEST(BlobStorageContextTest, CompoundBlobs) {
   EXPECT_TRUE(*(blob_data_handle->data()) == *canonicalized_blob_data2.get());
 }
 
+TEST(BlobStorageContextTest, DiskPaging) {
+  base::MessageLoop fake_io_message_loop;
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  BlobStorageContext context;
+  context.set_memory_budget_for_testing(0);
+  context.EnableDiskPaging(temp_dir.path(),
+                           base::MessageLoopProxy::current().get());
+
+  const std::string kId("id");
+  const std::string kBytes(100 * 1024, 'x');
+  base::FilePath file_path(FILE_PATH_LITERAL("File1.txt"));
+  scoped_refptr<BlobData> blob_data(new BlobData(kId));
+  blob_data->AppendData(kBytes);
+  blob_data->AppendFile(file_path, 10, 1024, base::Time());
+  blob_data->AppendData(kBytes);
+
+  // Readers that already have the blob keep the bytes in memory.
+  scoped_ptr<BlobDataHandle> old_handle =
+      context.AddFinishedBlob(blob_data.get());
+  ASSERT_TRUE(old_handle.get());
+  EXPECT_EQ(2 * static_cast<int64>(kBytes.size()), context.memory_usage());
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_TRUE(*(old_handle->data()) == *blob_data.get());
+
+  // New readers get both bytes items from the same paged out file.
+  EXPECT_EQ(0, context.memory_usage());
+  EXPECT_EQ(2 * static_cast<int64>(kBytes.size()), context.disk_usage());
+  scoped_ptr<BlobDataHandle> handle = context.GetBlobDataFromUUID(kId);
+  ASSERT_TRUE(handle.get());
+  const std::vector<BlobData::Item>& items = handle->data()->items();
+  ASSERT_EQ(3u, items.size());
+  EXPECT_EQ(BlobData::Item::TYPE_FILE, items[0].type());
+  EXPECT_EQ(0u, items[0].offset());
+  EXPECT_EQ(kBytes.size(), items[0].length());
+  EXPECT_EQ(file_path, items[1].path());
+  EXPECT_EQ(10u, items[1].offset());
+  EXPECT_EQ(BlobData::Item::TYPE_FILE, items[2].type());
+  EXPECT_EQ(items[0].path(), items[2].path());
+  EXPECT_EQ(kBytes.size(), items[2].offset());
+  base::FilePath paged_file = items[0].path();
+  EXPECT_TRUE(temp_dir.path().IsParent(paged_file));
+  std::string contents;
+  EXPECT_TRUE(file_util::ReadFileToString(paged_file, &contents));
+  EXPECT_EQ(kBytes + kBytes, contents);
+
+  // The file goes away with the blob.
+  old_handle.reset();
+  handle.reset();
+  EXPECT_FALSE(context.GetBlobDataFromUUID(kId));
+  EXPECT_EQ(0, context.disk_usage());
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_FALSE(base::PathExists(paged_file));
+}
+
 TEST(BlobStorageContextTest, PublicBlobUrls) {
   BlobStorageContext context;
   BlobStorageHost host(&context);
@@ -34,6 +34,7 @@ const char kURL[] = "URL: ";
 const char kModificationTime[] = "Modification Time: ";
 const char kOffset[] = "Offset: ";
 const char kLength[] = "Length: ";
+const char kMemoryUsage[] = "Memory Usage: ";
 
 void StartHTML(std::string* out) {
   out->append(
@@ -165,6 +166,11 @@ int ViewBlobInternalsJob::GetData(
 }
 
 void ViewBlobInternalsJob::GenerateHTML(std::string* out) const {
+  StartHTMLList(out);
+  AddHTMLListItem(kMemoryUsage, UTF16ToUTF8(base::FormatNumber(
+      blob_storage_controller_->memory_usage_)), out);
+  EndHTMLList(out);
+
   for (BlobStorageController::BlobMap::const_iterator iter =
            blob_storage_controller_->blob_map_.begin();
        iter != blob_storage_controller_->blob_map_.end();
@@ -132,9 +132,12 @@ void CopyOrMoveOperationDelegate::CopyOrMoveFile(
   // Cross filesystem case.
   // Perform CreateSnapshotFile, CopyInForeignFile and then calls
   // copy_callback which removes the source file if operation_type == MOVE.
+  StatusCallback file_callback =
+      base::Bind(&CopyOrMoveOperationDelegate::DidFinishCrossFileSystemFile,
+                 weak_factory_.GetWeakPtr(), url_pair.src, callback);
   StatusCallback copy_callback =
       base::Bind(&CopyOrMoveOperationDelegate::DidFinishCopy,
-                 weak_factory_.GetWeakPtr(), url_pair, callback);
+                 weak_factory_.GetWeakPtr(), url_pair, file_callback);
   operation_runner()->CreateSnapshotFile(
       url_pair.src,
       base::Bind(&CopyOrMoveOperationDelegate::DidCreateSnapshot,
@@ -152,7 +155,6 @@ void CopyOrMoveOperationDelegate::DidCreateSnapshot(
     callback.Run(error);
     return;
   }
-  current_file_ref_ = file_ref;
 
   // For now we assume CreateSnapshotFile always return a valid local file path.
   // TODO(kinuko): Otherwise create a FileStreamReader to perform a copy/move.
@@ -166,16 +168,19 @@ void CopyOrMoveOperationDelegate::DidCreateSnapshot(
     return;
   }
   if (!factory) {
-    DidValidateFile(url_pair.dest, callback, file_info, platform_path, error);
+    DidValidateFile(url_pair.dest, callback, file_info, platform_path,
+                    file_ref, error);
     return;
   }
 
-  validator_.reset(
+  linked_ptr<CopyOrMoveFileValidator> validator(
       factory->CreateCopyOrMoveFileValidator(url_pair.src, platform_path));
-  validator_->StartPreWriteValidation(
+  validators_[url_pair.src] = validator;
+  validator->StartPreWriteValidation(
       base::Bind(&CopyOrMoveOperationDelegate::DidValidateFile,
                  weak_factory_.GetWeakPtr(),
-                 url_pair.dest, callback, file_info, platform_path));
+                 url_pair.dest, callback, file_info, platform_path,
+                 file_ref));
 }
 
 void CopyOrMoveOperationDelegate::DidValidateFile(
@@ -183,13 +188,35 @@ void CopyOrMoveOperationDelegate::DidValidateFile(
     const StatusCallback& callback,
     const base::PlatformFileInfo& file_info,
     const base::FilePath& platform_path,
+    const scoped_refptr<webkit_blob::ShareableFileReference>& file_ref,
     base::PlatformFileError error) {
   if (error != base::PLATFORM_FILE_OK) {
     callback.Run(error);
     return;
   }
 
-  operation_runner()->CopyInForeignFile(platform_path, dest, callback);
+  // |file_ref| keeps the snapshot alive until it has been copied in.
+  operation_runner()->CopyInForeignFile(
+      platform_path, dest,
+      base::Bind(&CopyOrMoveOperationDelegate::DidCopyInForeignFile,
+                 weak_factory_.GetWeakPtr(), callback, file_ref));
+}
+
+// |file_ref| is unused; it is passed here to make sure the snapshot is
+// alive until CopyInForeignFile is complete.
+void CopyOrMoveOperationDelegate::DidCopyInForeignFile(
+    const StatusCallback& callback,
+    const scoped_refptr<webkit_blob::ShareableFileReference>& /*file_ref*/,
+    base::PlatformFileError error) {
+  callback.Run(error);
+}
+
+void CopyOrMoveOperationDelegate::DidFinishCrossFileSystemFile(
+    const FileSystemURL& src,
+    const StatusCallback& callback,
+    base::PlatformFileError error) {
+  validators_.erase(src);
+  callback.Run(error);
 }
 
 void CopyOrMoveOperationDelegate::DidFinishRecursiveCopyDir(
@@ -220,9 +247,9 @@ void CopyOrMoveOperationDelegate::DidFinishCopy(
     return;
   }
 
-  // |validator_| is NULL in the same-filesystem case or when the destination
+  // There is no validator in the same-filesystem case or when the destination
   // filesystem does not do validation.
-  if (!validator_.get()) {
+  if (validators_.find(url_pair.src) == validators_.end()) {
     scoped_refptr<webkit_blob::ShareableFileReference> file_ref;
     DidPostWriteValidation(url_pair, callback, file_ref,
                            base::PLATFORM_FILE_OK);
@@ -251,10 +278,11 @@ void CopyOrMoveOperationDelegate::DoPostWriteValidation(
     return;
   }
 
-  DCHECK(validator_.get());
+  ValidatorMap::iterator found = validators_.find(url_pair.src);
+  DCHECK(found != validators_.end());
   // Note: file_ref passed here to keep the file alive until after
   // the StartPostWriteValidation operation finishes.
-  validator_->StartPostWriteValidation(
+  found->second->StartPostWriteValidation(
       platform_path,
       base::Bind(&CopyOrMoveOperationDelegate::DidPostWriteValidation,
                  weak_factory_.GetWeakPtr(), url_pair, callback, file_ref));
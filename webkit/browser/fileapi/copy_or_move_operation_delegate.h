@@ -5,8 +5,9 @@
 #ifndef WEBKIT_BROWSER_FILEAPI_COPY_OR_MOVE_OPERATION_DELEGATE_H_
 #define WEBKIT_BROWSER_FILEAPI_COPY_OR_MOVE_OPERATION_DELEGATE_H_
 
-#include <stack>
+#include <map>
 
+#include "base/memory/linked_ptr.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "webkit/browser/fileapi/recursive_operation_delegate.h"
@@ -54,6 +55,10 @@ class CopyOrMoveOperationDelegate
     FileSystemURL dest;
   };
 
+  typedef std::map<FileSystemURL,
+                   linked_ptr<CopyOrMoveFileValidator>,
+                   FileSystemURL::Comparator> ValidatorMap;
+
   void DidTryCopyOrMoveFile(base::PlatformFileError error);
   void DidTryRemoveDestRoot(base::PlatformFileError error);
   void CopyOrMoveFile(
@@ -71,6 +76,15 @@ class CopyOrMoveOperationDelegate
       const StatusCallback& callback,
       const base::PlatformFileInfo& file_info,
       const base::FilePath& platform_path,
+      const scoped_refptr<webkit_blob::ShareableFileReference>& file_ref,
+      base::PlatformFileError error);
+  void DidCopyInForeignFile(
+      const StatusCallback& callback,
+      const scoped_refptr<webkit_blob::ShareableFileReference>& file_ref,
+      base::PlatformFileError error);
+  void DidFinishCrossFileSystemFile(
+      const FileSystemURL& src,
+      const StatusCallback& callback,
       base::PlatformFileError error);
   void DidFinishRecursiveCopyDir(
       const FileSystemURL& src,
@@ -108,9 +122,9 @@ class CopyOrMoveOperationDelegate
   OperationType operation_type_;
   StatusCallback callback_;
 
-  scoped_refptr<webkit_blob::ShareableFileReference> current_file_ref_;
-
-  scoped_ptr<CopyOrMoveFileValidator> validator_;
+  // Validators of the files being copied across file systems, keyed by
+  // source URL. Several files of a directory tree are copied at once.
+  ValidatorMap validators_;
 
   base::WeakPtrFactory<CopyOrMoveOperationDelegate> weak_factory_;
 
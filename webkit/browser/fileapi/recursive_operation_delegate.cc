@@ -18,7 +18,8 @@ const int kMaxInflightOperations = 5;
 RecursiveOperationDelegate::RecursiveOperationDelegate(
     FileSystemContext* file_system_context)
     : file_system_context_(file_system_context),
-      inflight_operations_(0) {
+      inflight_operations_(0),
+      processing_directory_(false) {
 }
 
 RecursiveOperationDelegate::~RecursiveOperationDelegate() {
@@ -29,34 +30,14 @@ void RecursiveOperationDelegate::StartRecursiveOperation(
     const StatusCallback& callback) {
   callback_ = callback;
   pending_directories_.push(root);
-  ProcessNextDirectory();
+  ProcessPendingEntries();
 }
 
 FileSystemOperationRunner* RecursiveOperationDelegate::operation_runner() {
   return file_system_context_->operation_runner();
 }
 
-void RecursiveOperationDelegate::ProcessNextDirectory() {
-  DCHECK(pending_files_.empty());
-  if (inflight_operations_ > 0)
-    return;
-  if (pending_directories_.empty()) {
-    callback_.Run(base::PLATFORM_FILE_OK);
-    return;
-  }
-  FileSystemURL url = pending_directories_.front();
-  pending_directories_.pop();
-  inflight_operations_++;
-  ProcessDirectory(
-      url, base::Bind(&RecursiveOperationDelegate::DidProcessDirectory,
-                      AsWeakPtr(), url));
-}
-
-void RecursiveOperationDelegate::ProcessPendingFiles() {
-  if (pending_files_.empty()) {
-    ProcessNextDirectory();
-    return;
-  }
+void RecursiveOperationDelegate::ProcessPendingEntries() {
   while (!pending_files_.empty() &&
          inflight_operations_ < kMaxInflightOperations) {
     FileSystemURL url = pending_files_.front();
@@ -69,6 +50,23 @@ void RecursiveOperationDelegate::ProcessPendingFiles() {
                    base::Bind(&RecursiveOperationDelegate::DidProcessFile,
                               AsWeakPtr())));
   }
+
+  // The next directory is processed and read while the files of the previous
+  // one are still in flight, so that a tree of small directories does not
+  // stall on each of them. Only one directory's entries are queued at a time.
+  if (processing_directory_ || !pending_files_.empty())
+    return;
+  if (pending_directories_.empty()) {
+    if (inflight_operations_ == 0)
+      callback_.Run(base::PLATFORM_FILE_OK);
+    return;
+  }
+  FileSystemURL url = pending_directories_.front();
+  pending_directories_.pop();
+  processing_directory_ = true;
+  ProcessDirectory(
+      url, base::Bind(&RecursiveOperationDelegate::DidProcessDirectory,
+                      AsWeakPtr(), url));
 }
 
 void RecursiveOperationDelegate::DidProcessFile(base::PlatformFileError error) {
@@ -78,7 +76,7 @@ void RecursiveOperationDelegate::DidProcessFile(base::PlatformFileError error) {
     callback_.Run(error);
     return;
   }
-  ProcessPendingFiles();
+  ProcessPendingEntries();
 }
 
 void RecursiveOperationDelegate::DidProcessDirectory(
@@ -101,6 +99,8 @@ void RecursiveOperationDelegate::DidReadDirectory(
   if (error != base::PLATFORM_FILE_OK) {
     if (error == base::PLATFORM_FILE_ERROR_NOT_A_DIRECTORY) {
       // The given path may have been a file, so try RemoveFile now.
+      processing_directory_ = false;
+      inflight_operations_++;
       ProcessFile(parent,
                   base::Bind(&RecursiveOperationDelegate::DidTryProcessFile,
                              AsWeakPtr(), error));
@@ -122,9 +122,8 @@ void RecursiveOperationDelegate::DidReadDirectory(
   if (has_more)
     return;
 
-  inflight_operations_--;
-  DCHECK_GE(inflight_operations_, 0);
-  ProcessPendingFiles();
+  processing_directory_ = false;
+  ProcessPendingEntries();
 }
 
 void RecursiveOperationDelegate::DidTryProcessFile(
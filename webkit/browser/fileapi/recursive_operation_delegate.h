@@ -74,8 +74,7 @@ class RecursiveOperationDelegate
   FileSystemOperationRunner* operation_runner();
 
  private:
-  void ProcessNextDirectory();
-  void ProcessPendingFiles();
+  void ProcessPendingEntries();
   void DidProcessFile(base::PlatformFileError error);
   void DidProcessDirectory(const FileSystemURL& url,
                            base::PlatformFileError error);
@@ -91,7 +90,10 @@ class RecursiveOperationDelegate
   StatusCallback callback_;
   std::queue<FileSystemURL> pending_directories_;
   std::queue<FileSystemURL> pending_files_;
+  // Number of files being processed.
   int inflight_operations_;
+  // True while a directory is being processed and read.
+  bool processing_directory_;
 
   DISALLOW_COPY_AND_ASSIGN(RecursiveOperationDelegate);
 };
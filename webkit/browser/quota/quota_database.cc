@@ -22,11 +22,12 @@ namespace {
 
 // Definitions for database schema.
 
-const int kCurrentVersion = 4;
+const int kCurrentVersion = 5;
 const int kCompatibleVersion = 2;
 
 const char kHostQuotaTable[] = "HostQuotaTable";
 const char kOriginInfoTable[] = "OriginInfoTable";
+const char kOriginUsageTable[] = "OriginUsageTable";
 const char kIsOriginTableBootstrapped[] = "IsOriginTableBootstrapped";
 
 bool VerifyValidQuotaConfig(const char* key) {
@@ -57,6 +58,12 @@ const QuotaDatabase::TableSchema QuotaDatabase::kTables[] = {
     " last_access_time INTEGER DEFAULT 0,"
     " last_modified_time INTEGER DEFAULT 0,"
     " UNIQUE(origin, type))" },
+  { kOriginUsageTable,
+    "(origin TEXT NOT NULL,"
+    " type INTEGER NOT NULL,"
+    " client_id INTEGER NOT NULL,"
+    " usage INTEGER DEFAULT 0,"
+    " UNIQUE(origin, type, client_id))" },
 };
 
 // static
@@ -77,6 +84,10 @@ const QuotaDatabase::IndexSchema QuotaDatabase::kIndexes[] = {
     kOriginInfoTable,
     "(last_modified_time)",
     false },
+  { "OriginUsageClientIndex",
+    kOriginUsageTable,
+    "(type, client_id)",
+    false },
 };
 
 struct QuotaDatabase::QuotaTableImporter {
@@ -310,6 +321,66 @@ bool QuotaDatabase::DeleteOriginInfo(
   return true;
 }
 
+bool QuotaDatabase::GetOriginUsageCache(
+    StorageType type, ClientUsageMap* usage) {
+  DCHECK(usage);
+  usage->clear();
+  if (!LazyOpen(false))
+    return false;
+
+  const char* kSql =
+      "SELECT client_id, origin, usage FROM OriginUsageTable"
+      " WHERE type = ?";
+
+  sql::Statement statement(db_->GetCachedStatement(SQL_FROM_HERE, kSql));
+  statement.BindInt(0, static_cast<int>(type));
+
+  while (statement.Step()) {
+    QuotaClient::ID client_id =
+        static_cast<QuotaClient::ID>(statement.ColumnInt(0));
+    (*usage)[client_id][GURL(statement.ColumnString(1))] =
+        statement.ColumnInt64(2);
+  }
+  return statement.Succeeded();
+}
+
+bool QuotaDatabase::SetOriginUsageCache(
+    StorageType type, const ClientUsageMap& usage) {
+  if (!LazyOpen(true))
+    return false;
+
+  for (ClientUsageMap::const_iterator client_itr = usage.begin();
+       client_itr != usage.end(); ++client_itr) {
+    const char* kDeleteSql =
+        "DELETE FROM OriginUsageTable"
+        " WHERE type = ? AND client_id = ?";
+    sql::Statement delete_statement(
+        db_->GetCachedStatement(SQL_FROM_HERE, kDeleteSql));
+    delete_statement.BindInt(0, static_cast<int>(type));
+    delete_statement.BindInt(1, static_cast<int>(client_itr->first));
+    if (!delete_statement.Run())
+      return false;
+
+    const OriginUsageMap& origins = client_itr->second;
+    for (OriginUsageMap::const_iterator itr = origins.begin();
+         itr != origins.end(); ++itr) {
+      const char* kSql =
+          "INSERT INTO OriginUsageTable"
+          " (origin, type, client_id, usage) VALUES (?, ?, ?, ?)";
+      sql::Statement statement(db_->GetCachedStatement(SQL_FROM_HERE, kSql));
+      statement.BindString(0, itr->first.spec());
+      statement.BindInt(1, static_cast<int>(type));
+      statement.BindInt(2, static_cast<int>(client_itr->first));
+      statement.BindInt64(3, itr->second);
+      if (!statement.Run())
+        return false;
+    }
+  }
+
+  ScheduleCommit();
+  return true;
+}
+
 bool QuotaDatabase::GetQuotaConfigValue(const char* key, int64* value) {
   if (!LazyOpen(false))
     return false;
@@ -585,6 +656,21 @@ bool QuotaDatabase::UpgradeSchema(int current_version) {
     Commit();
     return true;
   }
+  if (current_version == 4) {
+    // Version 5 adds the usage cache, which starts out empty.
+    if (!db_->Execute("CREATE TABLE OriginUsageTable"
+                      "(origin TEXT NOT NULL,"
+                      " type INTEGER NOT NULL,"
+                      " client_id INTEGER NOT NULL,"
+                      " usage INTEGER DEFAULT 0,"
+                      " UNIQUE(origin, type, client_id))") ||
+        !db_->Execute("CREATE INDEX OriginUsageClientIndex"
+                      " ON OriginUsageTable(type, client_id)")) {
+      return false;
+    }
+    meta_table_->SetVersionNumber(kCurrentVersion);
+    return true;
+  }
   return false;
 }
 
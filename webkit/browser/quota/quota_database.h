@@ -5,6 +5,7 @@
 #ifndef WEBKIT_BROWSER_QUOTA_QUOTA_DATABASE_H_
 #define WEBKIT_BROWSER_QUOTA_QUOTA_DATABASE_H_
 
+#include <map>
 #include <set>
 #include <string>
 
@@ -16,6 +17,7 @@
 #include "base/time/time.h"
 #include "base/timer/timer.h"
 #include "url/gurl.h"
+#include "webkit/browser/quota/quota_client.h"
 #include "webkit/browser/webkit_storage_browser_export.h"
 #include "webkit/common/quota/quota_types.h"
 
@@ -37,6 +39,11 @@ class WEBKIT_STORAGE_BROWSER_EXPORT_PRIVATE QuotaDatabase {
   static const char kDesiredAvailableSpaceKey[];
   static const char kTemporaryQuotaOverrideKey[];
 
+  // Usage of each origin, per quota client, as last cached by the usage
+  // tracker of a storage type.
+  typedef std::map<GURL, int64> OriginUsageMap;
+  typedef std::map<QuotaClient::ID, OriginUsageMap> ClientUsageMap;
+
   // If 'path' is empty, an in memory database will be used.
   explicit QuotaDatabase(const base::FilePath& path);
   ~QuotaDatabase();
@@ -63,6 +70,12 @@ class WEBKIT_STORAGE_BROWSER_EXPORT_PRIVATE QuotaDatabase {
 
   bool DeleteOriginInfo(const GURL& origin, StorageType type);
 
+  // Reads the usage cache of |type| saved by SetOriginUsageCache.
+  bool GetOriginUsageCache(StorageType type, ClientUsageMap* usage);
+
+  // Replaces the saved usage cache of |type| for each client in |usage|.
+  bool SetOriginUsageCache(StorageType type, const ClientUsageMap& usage);
+
   bool GetQuotaConfigValue(const char* key, int64* value);
   bool SetQuotaConfigValue(const char* key, int64 value);
 
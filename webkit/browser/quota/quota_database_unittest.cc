@@ -124,6 +124,37 @@ class QuotaDatabaseTest : public testing::Test {
     EXPECT_EQ(kValue2, value);
   }
 
+  void OriginUsageCache(const base::FilePath& kDbFile) {
+    QuotaDatabase db(kDbFile);
+    ASSERT_TRUE(db.LazyOpen(true));
+
+    const GURL kOrigin1("http://a/");
+    const GURL kOrigin2("http://b/");
+    QuotaDatabase::ClientUsageMap usage;
+    EXPECT_TRUE(db.GetOriginUsageCache(kStorageTypeTemporary, &usage));
+    EXPECT_TRUE(usage.empty());
+
+    QuotaDatabase::ClientUsageMap new_usage;
+    new_usage[QuotaClient::kFileSystem][kOrigin1] = 10;
+    new_usage[QuotaClient::kFileSystem][kOrigin2] = 20;
+    new_usage[QuotaClient::kDatabase][kOrigin1] = 30;
+    EXPECT_TRUE(db.SetOriginUsageCache(kStorageTypeTemporary, new_usage));
+    EXPECT_TRUE(db.GetOriginUsageCache(kStorageTypeTemporary, &usage));
+    EXPECT_TRUE(new_usage == usage);
+    EXPECT_TRUE(db.GetOriginUsageCache(kStorageTypePersistent, &usage));
+    EXPECT_TRUE(usage.empty());
+
+    // Only the clients that are passed are replaced.
+    new_usage.clear();
+    new_usage[QuotaClient::kFileSystem][kOrigin2] = 40;
+    EXPECT_TRUE(db.SetOriginUsageCache(kStorageTypeTemporary, new_usage));
+    EXPECT_TRUE(db.GetOriginUsageCache(kStorageTypeTemporary, &usage));
+    EXPECT_EQ(2U, usage.size());
+    EXPECT_EQ(1U, usage[QuotaClient::kFileSystem].size());
+    EXPECT_EQ(40, usage[QuotaClient::kFileSystem][kOrigin2]);
+    EXPECT_EQ(30, usage[QuotaClient::kDatabase][kOrigin1]);
+  }
+
   void OriginLastAccessTimeLRU(const base::FilePath& kDbFile) {
     QuotaDatabase db(kDbFile);
     ASSERT_TRUE(db.LazyOpen(true));
@@ -511,6 +542,14 @@ TEST_F(QuotaDatabaseTest, GlobalQuota) {
   GlobalQuota(base::FilePath());
 }
 
+TEST_F(QuotaDatabaseTest, OriginUsageCache) {
+  base::ScopedTempDir data_dir;
+  ASSERT_TRUE(data_dir.CreateUniqueTempDir());
+  const base::FilePath kDbFile = data_dir.path().AppendASCII("quota_manager.db");
+  OriginUsageCache(kDbFile);
+  OriginUsageCache(base::FilePath());
+}
+
 TEST_F(QuotaDatabaseTest, OriginLastAccessTimeLRU) {
   base::ScopedTempDir data_dir;
   ASSERT_TRUE(data_dir.CreateUniqueTempDir());
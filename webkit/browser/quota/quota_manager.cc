@@ -41,6 +41,10 @@ const int64 kMBytes = 1024 * 1024;
 const int kMinutesInMilliSeconds = 60 * 1000;
 
 const int64 kReportHistogramInterval = 60 * 60 * 1000;  // 1 hour
+const int64 kSaveUsageCacheInterval = 5 * kMinutesInMilliSeconds;
+// Reconciling a seeded usage cache is delayed so that it doesn't compete
+// with the storage work done at startup.
+const int64 kReconcileUsageCacheDelay = 3 * kMinutesInMilliSeconds;
 const double kTemporaryQuotaRatioToAvail = 0.5;  // 50%
 
 }  // namespace
@@ -126,15 +130,34 @@ bool SetPersistentHostQuotaOnDBThread(const std::string& host,
 
 bool InitializeOnDBThread(int64* temporary_quota_override,
                           int64* desired_available_space,
+                          QuotaManager::UsageCacheByType* usage_cache,
                           QuotaDatabase* database) {
   DCHECK(database);
   database->GetQuotaConfigValue(QuotaDatabase::kTemporaryQuotaOverrideKey,
                                 temporary_quota_override);
   database->GetQuotaConfigValue(QuotaDatabase::kDesiredAvailableSpaceKey,
                                 desired_available_space);
+  const StorageType kTypes[] = {
+    kStorageTypeTemporary, kStorageTypePersistent, kStorageTypeSyncable
+  };
+  for (size_t i = 0; i < arraysize(kTypes); ++i)
+    database->GetOriginUsageCache(kTypes[i], &(*usage_cache)[kTypes[i]]);
   return true;
 }
 
+bool SaveUsageCacheOnDBThread(QuotaManager::UsageCacheByType* usage_cache,
+                              QuotaDatabase* database) {
+  DCHECK(database);
+  bool success = true;
+  for (QuotaManager::UsageCacheByType::const_iterator itr =
+           usage_cache->begin();
+       itr != usage_cache->end(); ++itr) {
+    if (!database->SetOriginUsageCache(itr->first, itr->second))
+      success = false;
+  }
+  return success;
+}
+
 bool GetLRUOriginOnDBThread(StorageType type,
                             std::set<GURL>* exceptions,
                             SpecialStoragePolicy* policy,
@@ -1144,8 +1167,10 @@ QuotaManager::~QuotaManager() {
   proxy_->manager_ = NULL;
   std::for_each(clients_.begin(), clients_.end(),
                 std::mem_fun(&QuotaClient::OnQuotaManagerDestroyed));
-  if (database_)
+  if (database_) {
+    SaveUsageCache();
     db_thread_->DeleteSoon(FROM_HERE, database_.release());
+  }
 }
 
 QuotaManager::EvictionContext::EvictionContext()
@@ -1175,15 +1200,18 @@ void QuotaManager::LazyInitialize() {
 
   int64* temporary_quota_override = new int64(-1);
   int64* desired_available_space = new int64(-1);
+  UsageCacheByType* usage_cache = new UsageCacheByType;
   PostTaskAndReplyWithResultForDBThread(
       FROM_HERE,
       base::Bind(&InitializeOnDBThread,
                  base::Unretained(temporary_quota_override),
-                 base::Unretained(desired_available_space)),
+                 base::Unretained(desired_available_space),
+                 base::Unretained(usage_cache)),
       base::Bind(&QuotaManager::DidInitialize,
                  weak_factory_.GetWeakPtr(),
                  base::Owned(temporary_quota_override),
-                 base::Owned(desired_available_space)));
+                 base::Owned(desired_available_space),
+                 base::Owned(usage_cache)));
 }
 
 void QuotaManager::RegisterClient(QuotaClient* client) {
@@ -1311,6 +1339,30 @@ void QuotaManager::DidOriginDataEvicted(QuotaStatusCode status) {
   eviction_context_.evict_origin_data_callback.Reset();
 }
 
+void QuotaManager::SaveUsageCache() {
+  if (is_incognito_ || db_disabled_ || !temporary_usage_tracker_)
+    return;
+
+  UsageCacheByType* usage_cache = new UsageCacheByType;
+  temporary_usage_tracker_->GetModifiedUsageCache(
+      &(*usage_cache)[kStorageTypeTemporary]);
+  persistent_usage_tracker_->GetModifiedUsageCache(
+      &(*usage_cache)[kStorageTypePersistent]);
+  syncable_usage_tracker_->GetModifiedUsageCache(
+      &(*usage_cache)[kStorageTypeSyncable]);
+  PostTaskAndReplyWithResultForDBThread(
+      FROM_HERE,
+      base::Bind(&SaveUsageCacheOnDBThread, base::Owned(usage_cache)),
+      base::Bind(&QuotaManager::DidDatabaseWork,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void QuotaManager::ReconcileUsageCache() {
+  temporary_usage_tracker_->ReconcileUsageCache();
+  persistent_usage_tracker_->ReconcileUsageCache();
+  syncable_usage_tracker_->ReconcileUsageCache();
+}
+
 void QuotaManager::ReportHistogram() {
   GetGlobalUsage(kStorageTypeTemporary,
                  base::Bind(
@@ -1475,16 +1527,37 @@ void QuotaManager::DidSetPersistentHostQuota(const std::string& host,
 
 void QuotaManager::DidInitialize(int64* temporary_quota_override,
                                  int64* desired_available_space,
+                                 UsageCacheByType* usage_cache,
                                  bool success) {
   temporary_quota_override_ = *temporary_quota_override;
   desired_available_space_ = *desired_available_space;
   temporary_quota_initialized_ = true;
   DidDatabaseWork(success);
 
+  // Seed the usage trackers before the queued requests run, so that the
+  // first global usage query doesn't have to visit every origin.
+  temporary_usage_tracker_->SeedUsageCache(
+      (*usage_cache)[kStorageTypeTemporary]);
+  persistent_usage_tracker_->SeedUsageCache(
+      (*usage_cache)[kStorageTypePersistent]);
+  syncable_usage_tracker_->SeedUsageCache(
+      (*usage_cache)[kStorageTypeSyncable]);
+
   histogram_timer_.Start(FROM_HERE,
                          base::TimeDelta::FromMilliseconds(
                              kReportHistogramInterval),
                          this, &QuotaManager::ReportHistogram);
+  if (!is_incognito_) {
+    save_usage_cache_timer_.Start(FROM_HERE,
+                                  base::TimeDelta::FromMilliseconds(
+                                      kSaveUsageCacheInterval),
+                                  this, &QuotaManager::SaveUsageCache);
+    reconcile_usage_cache_timer_.Start(FROM_HERE,
+                                       base::TimeDelta::FromMilliseconds(
+                                           kReconcileUsageCacheDelay),
+                                       this,
+                                       &QuotaManager::ReconcileUsageCache);
+  }
 
   db_initialization_callbacks_.Run(MakeTuple());
   GetTemporaryGlobalQuota(
@@ -110,6 +110,10 @@ class WEBKIT_STORAGE_BROWSER_EXPORT QuotaManager
                               int64 /* quota */)>
       GetUsageAndQuotaCallback;
 
+  // Usage cache of each usage tracker, as saved in the database.
+  typedef std::map<StorageType, QuotaDatabase::ClientUsageMap>
+      UsageCacheByType;
+
   static const int64 kIncognitoDefaultQuotaLimit;
   static const int64 kNoLimit;
 
@@ -325,6 +329,11 @@ class WEBKIT_STORAGE_BROWSER_EXPORT QuotaManager
 
   void DidOriginDataEvicted(QuotaStatusCode status);
 
+  // Saves the usage caches of the usage trackers to the database, and
+  // re-reads the usage of the origins seeded from it.
+  void SaveUsageCache();
+  void ReconcileUsageCache();
+
   void ReportHistogram();
   void DidGetTemporaryGlobalUsageForHistogram(int64 usage,
                                               int64 unlimited_usage);
@@ -354,6 +363,7 @@ class WEBKIT_STORAGE_BROWSER_EXPORT QuotaManager
                                  bool success);
   void DidInitialize(int64* temporary_quota_override,
                      int64* desired_available_space,
+                     UsageCacheByType* usage_cache,
                      bool success);
   void DidGetLRUOrigin(const GURL* origin,
                        bool success);
@@ -413,6 +423,8 @@ class WEBKIT_STORAGE_BROWSER_EXPORT QuotaManager
 
   base::WeakPtrFactory<QuotaManager> weak_factory_;
   base::RepeatingTimer<QuotaManager> histogram_timer_;
+  base::RepeatingTimer<QuotaManager> save_usage_cache_timer_;
+  base::OneShotTimer<QuotaManager> reconcile_usage_cache_timer_;
 
   // Pointer to the function used to get the available disk space. This is
   // overwritten by QuotaManagerTest in order to attain a deterministic reported
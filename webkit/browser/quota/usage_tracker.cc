@@ -214,6 +214,35 @@ void UsageTracker::SetUsageCacheEnabled(QuotaClient::ID client_id,
   client_tracker->SetUsageCacheEnabled(origin, enabled);
 }
 
+void UsageTracker::GetModifiedUsageCache(
+    QuotaDatabase::ClientUsageMap* usage) {
+  DCHECK(usage);
+  usage->clear();
+  for (ClientTrackerMap::iterator iter = client_tracker_map_.begin();
+       iter != client_tracker_map_.end(); ++iter) {
+    QuotaDatabase::OriginUsageMap client_usage;
+    if (iter->second->GetModifiedUsageCache(&client_usage))
+      (*usage)[iter->first].swap(client_usage);
+  }
+}
+
+void UsageTracker::SeedUsageCache(
+    const QuotaDatabase::ClientUsageMap& usage) {
+  for (QuotaDatabase::ClientUsageMap::const_iterator iter = usage.begin();
+       iter != usage.end(); ++iter) {
+    ClientUsageTracker* client_tracker = GetClientTracker(iter->first);
+    if (client_tracker)
+      client_tracker->SeedUsageCache(iter->second);
+  }
+}
+
+void UsageTracker::ReconcileUsageCache() {
+  for (ClientTrackerMap::iterator iter = client_tracker_map_.begin();
+       iter != client_tracker_map_.end(); ++iter) {
+    iter->second->ReconcileUsageCache();
+  }
+}
+
 void UsageTracker::AccumulateClientGlobalLimitedUsage(AccumulateInfo* info,
                                                       int64 limited_usage) {
   info->usage += limited_usage;
@@ -276,6 +305,8 @@ ClientUsageTracker::ClientUsageTracker(
       global_limited_usage_(0),
       global_unlimited_usage_(0),
       global_usage_retrieved_(false),
+      usage_cache_modified_(false),
+      usage_cache_seeded_(false),
       special_storage_policy_(special_storage_policy) {
   DCHECK(tracker_);
   DCHECK(client_);
@@ -356,6 +387,7 @@ void ClientUsageTracker::UpdateUsageCache(
       return;
 
     cached_usage_by_host_[host][origin] += delta;
+    usage_cache_modified_ = true;
     if (IsStorageUnlimited(origin))
       global_unlimited_usage_ += delta;
     else
@@ -405,6 +437,7 @@ void ClientUsageTracker::SetUsageCacheEnabled(const GURL& origin,
         int64 usage = found->second;
         UpdateUsageCache(origin, -usage);
         cached_usage_for_host.erase(found);
+        usage_cache_modified_ = true;
         if (cached_usage_for_host.empty()) {
           cached_usage_by_host_.erase(found_host);
           cached_hosts_.erase(host);
@@ -429,6 +462,46 @@ void ClientUsageTracker::SetUsageCacheEnabled(const GURL& origin,
   }
 }
 
+bool ClientUsageTracker::GetModifiedUsageCache(
+    QuotaDatabase::OriginUsageMap* usage) {
+  DCHECK(usage);
+  if (!global_usage_retrieved_ || !usage_cache_modified_)
+    return false;
+
+  for (HostUsageMap::const_iterator host_iter = cached_usage_by_host_.begin();
+       host_iter != cached_usage_by_host_.end(); ++host_iter) {
+    usage->insert(host_iter->second.begin(), host_iter->second.end());
+  }
+  usage_cache_modified_ = false;
+  return true;
+}
+
+void ClientUsageTracker::SeedUsageCache(
+    const QuotaDatabase::OriginUsageMap& usage) {
+  // Whatever the client has reported already is fresher than the seed.
+  if (global_usage_retrieved_ || !cached_usage_by_host_.empty())
+    return;
+
+  for (QuotaDatabase::OriginUsageMap::const_iterator iter = usage.begin();
+       iter != usage.end(); ++iter) {
+    if (!IsUsageCacheEnabledForOrigin(iter->first))
+      continue;
+    AddCachedOrigin(iter->first, std::max<int64>(iter->second, 0));
+    AddCachedHost(net::GetHostOrSpecFromURL(iter->first));
+  }
+  global_usage_retrieved_ = true;
+  usage_cache_modified_ = false;
+  usage_cache_seeded_ = true;
+}
+
+void ClientUsageTracker::ReconcileUsageCache() {
+  if (!usage_cache_seeded_)
+    return;
+  usage_cache_seeded_ = false;
+  client_->GetOriginsForType(type_, base::Bind(
+      &ClientUsageTracker::DidGetOriginsForReconcile, AsWeakPtr()));
+}
+
 void ClientUsageTracker::AccumulateLimitedOriginUsage(
     AccumulateInfo* info,
     const UsageCallback& callback,
@@ -547,6 +620,37 @@ void ClientUsageTracker::AccumulateOriginUsage(AccumulateInfo* info,
       host, MakeTuple(info->limited_usage, info->unlimited_usage));
 }
 
+void ClientUsageTracker::DidGetOriginsForReconcile(
+    const std::set<GURL>& origins) {
+  // Cached origins that the client no longer has are re-read too, so that
+  // their usage drops to zero.
+  origins_to_reconcile_ = origins;
+  GetCachedOrigins(&origins_to_reconcile_);
+  ReconcileNextOrigin();
+}
+
+void ClientUsageTracker::ReconcileNextOrigin() {
+  // Origins are re-read one at a time so that reconciling doesn't compete
+  // with the requests the client is serving.
+  while (!origins_to_reconcile_.empty()) {
+    GURL origin = *origins_to_reconcile_.begin();
+    origins_to_reconcile_.erase(origins_to_reconcile_.begin());
+    if (!IsUsageCacheEnabledForOrigin(origin))
+      continue;
+    client_->GetOriginUsage(origin, type_, base::Bind(
+        &ClientUsageTracker::DidGetOriginUsageForReconcile, AsWeakPtr(),
+        origin));
+    return;
+  }
+}
+
+void ClientUsageTracker::DidGetOriginUsageForReconcile(const GURL& origin,
+                                                       int64 usage) {
+  if (IsUsageCacheEnabledForOrigin(origin))
+    AddCachedOrigin(origin, std::max<int64>(usage, 0));
+  ReconcileNextOrigin();
+}
+
 void ClientUsageTracker::AddCachedOrigin(
     const GURL& origin, int64 new_usage) {
   DCHECK(IsUsageCacheEnabledForOrigin(origin));
@@ -555,6 +659,7 @@ void ClientUsageTracker::AddCachedOrigin(
   int64* usage = &cached_usage_by_host_[host][origin];
   int64 delta = new_usage - *usage;
   *usage = new_usage;
+  usage_cache_modified_ = true;
   if (delta) {
     if (IsStorageUnlimited(origin))
       global_unlimited_usage_ += delta;
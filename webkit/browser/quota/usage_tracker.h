@@ -17,6 +17,7 @@
 #include "url/gurl.h"
 #include "webkit/browser/quota/quota_callbacks.h"
 #include "webkit/browser/quota/quota_client.h"
+#include "webkit/browser/quota/quota_database.h"
 #include "webkit/browser/quota/quota_task.h"
 #include "webkit/browser/quota/special_storage_policy.h"
 #include "webkit/browser/webkit_storage_browser_export.h"
@@ -55,6 +56,21 @@ class WEBKIT_STORAGE_BROWSER_EXPORT UsageTracker : public QuotaTaskObserver {
                             const GURL& origin,
                             bool enabled);
 
+  // Fills |usage| with the usage cache of each client that holds every
+  // origin of the client and has changed since the last call, for saving
+  // it across sessions.
+  void GetModifiedUsageCache(QuotaDatabase::ClientUsageMap* usage);
+
+  // Seeds the usage cache of each client in |usage| with the cache saved by
+  // an earlier session, so that global and host usage are answered without
+  // asking the client about every origin. Clients that have already
+  // reported usage are left alone.
+  void SeedUsageCache(const QuotaDatabase::ClientUsageMap& usage);
+
+  // Asks the seeded clients for the usage of every origin again, one origin
+  // at a time, to correct the cache for changes that were never saved.
+  void ReconcileUsageCache();
+
  private:
   struct AccumulateInfo {
     AccumulateInfo() : pending_clients(0), usage(0), unlimited_usage(0) {}
@@ -115,6 +131,12 @@ class ClientUsageTracker : public SpecialStoragePolicy::Observer,
   bool IsUsageCacheEnabledForOrigin(const GURL& origin) const;
   void SetUsageCacheEnabled(const GURL& origin, bool enabled);
 
+  // Returns false if the cache doesn't cover every origin of the client or
+  // hasn't changed since the last call.
+  bool GetModifiedUsageCache(QuotaDatabase::OriginUsageMap* usage);
+  void SeedUsageCache(const QuotaDatabase::OriginUsageMap& usage);
+  void ReconcileUsageCache();
+
  private:
   typedef CallbackQueueMap<HostUsageAccumulator, std::string,
                            Tuple2<int64, int64> > HostUsageAccumulatorMap;
@@ -152,6 +174,10 @@ class ClientUsageTracker : public SpecialStoragePolicy::Observer,
                              const GURL& origin,
                              int64 usage);
 
+  void DidGetOriginsForReconcile(const std::set<GURL>& origins);
+  void ReconcileNextOrigin();
+  void DidGetOriginUsageForReconcile(const GURL& origin, int64 usage);
+
   // Methods used by our GatherUsage tasks, as a task makes progress
   // origins and hosts are added incrementally to the cache.
   void AddCachedOrigin(const GURL& origin, int64 usage);
@@ -178,6 +204,15 @@ class ClientUsageTracker : public SpecialStoragePolicy::Observer,
   HostSet cached_hosts_;
   HostUsageMap cached_usage_by_host_;
 
+  // True if the cache changed since GetModifiedUsageCache was last called.
+  bool usage_cache_modified_;
+
+  // True if the cache was seeded and is yet to be reconciled.
+  bool usage_cache_seeded_;
+
+  // Origins whose usage is yet to be re-read by ReconcileUsageCache.
+  std::set<GURL> origins_to_reconcile_;
+
   OriginSetByHost non_cached_limited_origins_by_host_;
   OriginSetByHost non_cached_unlimited_origins_by_host_;
 
@@ -184,6 +184,21 @@ class UsageTrackerTest : public testing::Test {
         quota_client_.id(), origin, enabled);
   }
 
+  void SeedUsageCache(const GURL& origin, int64 usage) {
+    QuotaDatabase::ClientUsageMap usage_cache;
+    usage_cache[quota_client_.id()][origin] = usage;
+    usage_tracker_.SeedUsageCache(usage_cache);
+  }
+
+  void ReconcileUsageCache() {
+    usage_tracker_.ReconcileUsageCache();
+    message_loop_.RunUntilIdle();
+  }
+
+  void GetModifiedUsageCache(QuotaDatabase::ClientUsageMap* usage_cache) {
+    usage_tracker_.GetModifiedUsageCache(usage_cache);
+  }
+
  private:
   QuotaClientList GetUsageTrackerList() {
     QuotaClientList client_list;
@@ -320,5 +335,46 @@ TEST_F(UsageTrackerTest, LimitedGlobalUsageTest) {
   EXPECT_EQ(2 + 32, unlimited_usage);
 }
 
+TEST_F(UsageTrackerTest, SeededUsageCache) {
+  const GURL kOrigin("http://example.com");
+  const GURL kNewOrigin("http://new.example.com");
+  const std::string host(net::GetHostOrSpecFromURL(kOrigin));
+
+  // The usage saved by an earlier session is served without asking the
+  // client, which only knows about changes made since.
+  UpdateUsageWithoutNotification(kOrigin, 150);
+  UpdateUsageWithoutNotification(kNewOrigin, 30);
+  SeedUsageCache(kOrigin, 100);
+
+  int64 usage = 0;
+  int64 unlimited_usage = 0;
+  int64 host_usage = 0;
+  GetGlobalUsage(&usage, &unlimited_usage);
+  GetHostUsage(host, &host_usage);
+  EXPECT_EQ(100, usage);
+  EXPECT_EQ(100, host_usage);
+
+  QuotaDatabase::ClientUsageMap usage_cache;
+  GetModifiedUsageCache(&usage_cache);
+  EXPECT_TRUE(usage_cache.empty());
+
+  UpdateUsage(kOrigin, 10);
+  GetGlobalUsage(&usage, &unlimited_usage);
+  EXPECT_EQ(110, usage);
+
+  ReconcileUsageCache();
+  GetGlobalUsage(&usage, &unlimited_usage);
+  GetHostUsage(host, &host_usage);
+  EXPECT_EQ(160 + 30, usage);
+  EXPECT_EQ(160, host_usage);
+
+  GetModifiedUsageCache(&usage_cache);
+  ASSERT_EQ(1U, usage_cache.size());
+  EXPECT_EQ(160, usage_cache.begin()->second[kOrigin]);
+  EXPECT_EQ(30, usage_cache.begin()->second[kNewOrigin]);
+  GetModifiedUsageCache(&usage_cache);
+  EXPECT_TRUE(usage_cache.empty());
+}
+
 
 }  // namespace quota
@@ -26,6 +26,7 @@ const char kHttpGETMethod[] = "GET";
 const char kHttpHEADMethod[] = "HEAD";
 
 const char kEnableExecutableHandlers[] = "enable-appcache-executable-handlers";
+const char kEnableSimpleCacheBackend[] = "enable-appcache-simple-cache-backend";
 
 const base::FilePath::CharType kAppCacheDatabaseName[] =
     FILE_PATH_LITERAL("Index");
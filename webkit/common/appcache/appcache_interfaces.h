@@ -178,6 +178,10 @@ WEBKIT_STORAGE_COMMON_EXPORT extern const char kHttpHEADMethod[];
 // CommandLine flag to turn this experimental feature on.
 WEBKIT_STORAGE_COMMON_EXPORT extern const char kEnableExecutableHandlers[];
 
+// CommandLine flag to store responses in the simple disk cache backend
+// instead of the blockfile one.
+WEBKIT_STORAGE_COMMON_EXPORT extern const char kEnableSimpleCacheBackend[];
+
 WEBKIT_STORAGE_COMMON_EXPORT void AddSupportedScheme(const char* scheme);
 
 WEBKIT_STORAGE_COMMON_EXPORT bool IsSchemeSupported(const GURL& url);
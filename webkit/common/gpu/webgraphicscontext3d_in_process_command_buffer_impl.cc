@@ -158,7 +158,9 @@ bool WebGraphicsContext3DInProcessCommandBufferImpl::MaybeInitializeGL() {
     gfx::GpuPreference gpu_preference = gfx::PreferDiscreteGpu;
 
     ::gpu::GLInProcessContextAttribs attrib_struct;
-    ConvertAttributes(attributes_, &attrib_struct),
+    ConvertAttributes(attributes_, &attrib_struct);
+    // Onscreen contexts are only created for the browser's compositors.
+    attrib_struct.trusted_client = !is_offscreen_;
 
     context_.reset(GLInProcessContext::CreateContext(
         is_offscreen_,